@@ -0,0 +1,175 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Benchmark of the ghost update (halo exchange) patterns of
+// common::Scatterer, for a range of block sizes and numbers of
+// neighbours. The results are written in JSON format (see README.md).
+
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/version.h>
+#include <dolfinx/la/scatter_tuning.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Benchmark options
+struct Options
+{
+  /// Number of owned indices per process
+  std::int32_t size_local = 100000;
+
+  /// Number of ghost indices per neighbour
+  std::int32_t ghosts = 1000;
+
+  /// Largest block size. Block sizes 1, 2, 4, ... up to `max_bs` are
+  /// timed.
+  int max_bs = 64;
+
+  /// Largest number of neighbours. Numbers of neighbours 1, 2, 4, ...
+  /// up to `max_neighbors` (or the number of processes minus one) are
+  /// timed.
+  int max_neighbors = 64;
+
+  /// Number of timed repetitions
+  int repeats = 10;
+
+  /// JSON output file. The results are written to stdout if empty.
+  std::string output;
+};
+
+/// Parse command line options
+Options parse_options(int argc, char* argv[])
+{
+  Options opts;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (i + 1 == argc)
+      throw std::runtime_error("Missing value for option " + arg);
+    const std::string value = argv[++i];
+    if (arg == "--size-local")
+      opts.size_local = std::stoi(value);
+    else if (arg == "--ghosts")
+      opts.ghosts = std::stoi(value);
+    else if (arg == "--max-bs")
+      opts.max_bs = std::stoi(value);
+    else if (arg == "--max-neighbors")
+      opts.max_neighbors = std::stoi(value);
+    else if (arg == "--repeats")
+      opts.repeats = std::stoi(value);
+    else if (arg == "--output")
+      opts.output = value;
+    else
+      throw std::runtime_error("Unknown option " + arg);
+  }
+
+  if (opts.ghosts > opts.size_local)
+    throw std::runtime_error("More ghosts per neighbour than owned indices");
+
+  return opts;
+}
+
+/// Create an index map where each process ghosts the first `ghosts`
+/// indices of each of the next `num_neighbors` processes
+std::shared_ptr<const common::IndexMap>
+create_index_map(MPI_Comm comm, std::int32_t size_local, std::int32_t ghosts,
+                 int num_neighbors)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<std::int64_t> ghost_indices;
+  std::vector<int> owners;
+  for (int k = 1; k <= num_neighbors; ++k)
+  {
+    const int owner = (rank + k) % size;
+    for (std::int32_t i = 0; i < ghosts; ++i)
+    {
+      ghost_indices.push_back(std::int64_t(owner) * size_local + i);
+      owners.push_back(owner);
+    }
+  }
+
+  return std::make_shared<common::IndexMap>(comm, size_local, ghost_indices,
+                                            owners);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  dolfinx::init_logging(argc, argv);
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const Options opts = parse_options(argc, argv);
+    const int size = dolfinx::MPI::size(comm);
+
+    using type = common::Scatterer<>::type;
+    const std::vector<type> types
+        = {type::neighbor, type::p2p, type::persistent, type::shared};
+    const std::vector<std::string> names
+        = {"neighbor", "p2p", "persistent", "shared"};
+
+    std::ostringstream out;
+    out << "{\n  \"dolfinx_version\": \"" << DOLFINX_VERSION_STRING
+        << "\",\n  \"git_commit\": \"" << DOLFINX_VERSION_GIT
+        << "\",\n  \"num_processes\": " << size
+        << ",\n  \"size_local\": " << opts.size_local
+        << ",\n  \"ghosts_per_neighbor\": " << opts.ghosts
+        << ",\n  \"repeats\": " << opts.repeats << ",\n  \"results\": [";
+    bool first = true;
+    for (int nn = 1; nn <= std::min(opts.max_neighbors, size - 1); nn *= 2)
+    {
+      auto map = create_index_map(comm, opts.size_local, opts.ghosts, nn);
+      for (int bs = 1; bs <= opts.max_bs; bs *= 2)
+      {
+        std::vector<double> times = la::scatter_times(
+            map, bs, sizeof(double), types, opts.repeats);
+        auto fastest = std::ranges::min_element(times);
+        out << (first ? "" : ",") << "\n    {\"neighbors\": " << nn
+            << ", \"bs\": " << bs << ", \"message_bytes\": "
+            << opts.ghosts * bs * sizeof(double) << ", \"times\": {";
+        for (std::size_t i = 0; i < types.size(); ++i)
+        {
+          out << (i == 0 ? "" : ", ") << "\"" << names[i]
+              << "\": " << times[i];
+        }
+        out << "}, \"fastest\": \""
+            << names[std::distance(times.begin(), fastest)] << "\"}";
+        first = false;
+      }
+    }
+    out << "\n  ]\n}\n";
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      if (opts.output.empty())
+        std::cout << out.str();
+      else
+      {
+        std::ofstream file(opts.output);
+        file << out.str();
+      }
+    }
+    la::clear_scatter_timings();
+  }
+  MPI_Finalize();
+
+  return 0;
+}
@@ -0,0 +1,610 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Throughput benchmark of the I/O of meshes and functions with
+// XDMFFile, the HDF5 interface, VTKFile, VTXWriter and FidesWriter. The
+// time and bandwidth of each phase of a write or read, and the memory
+// high-water marks, are written in JSON format (see README.md).
+
+#include <algorithm>
+#include <array>
+#include <basix/finite-element.h>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Table.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/version.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/io/ADIOS2Writers.h>
+#include <dolfinx/io/HDF5Interface.h>
+#include <dolfinx/io/VTKFile.h>
+#include <dolfinx/io/XDMFFile.h>
+#include <dolfinx/io/aggregation.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <hdf5.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mpi.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace dolfinx;
+using T = double;
+
+namespace
+{
+/// Benchmark options
+struct Options
+{
+  /// Number of cells per process (weak scaling). Used if `cells` is
+  /// not positive.
+  std::int64_t cells_per_rank = 100000;
+
+  /// Total number of cells (strong scaling)
+  std::int64_t cells = 0;
+
+  /// Cell type
+  std::string cell = "tetrahedron";
+
+  /// Degree of the vector-valued Lagrange function that is written
+  int degree = 1;
+
+  /// Number of time steps of the function that are written
+  int steps = 1;
+
+  /// Formats: `xdmf`, `hdf5`, `vtk`, `vtx` and `fides`. The ADIOS2
+  /// formats are only available if DOLFINx is built with ADIOS2.
+#ifdef HAS_ADIOS2
+  std::vector<std::string> formats = {"xdmf", "hdf5", "vtk", "vtx", "fides"};
+#else
+  std::vector<std::string> formats = {"xdmf", "hdf5", "vtk"};
+#endif
+
+  /// ADIOS2 engines of the VTX and Fides writers
+  std::vector<std::string> engines = {"BP4", "BP5"};
+
+  /// Number of aggregators per node (HDF5 and ADIOS2). If zero, each
+  /// process writes its own data (HDF5) or the engine default is used
+  /// (ADIOS2).
+  int aggregators = 0;
+
+  /// Compression of the HDF5 datasets (`none` or `deflate`)
+  std::string compression = "none";
+
+  /// Number of timed repetitions
+  int repeats = 3;
+
+  /// Directory of the files that are written
+  std::filesystem::path dir = ".";
+
+  /// JSON output file. The results are written to stdout if empty.
+  std::string output;
+};
+
+/// Split a comma-separated list
+std::vector<std::string> split(const std::string& s)
+{
+  std::vector<std::string> items;
+  std::istringstream in(s);
+  for (std::string item; std::getline(in, item, ',');)
+  {
+    if (!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+/// Parse command line options
+Options parse_options(int argc, char* argv[])
+{
+  Options opts;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (i + 1 == argc)
+      throw std::runtime_error("Missing value for option " + arg);
+    const std::string value = argv[++i];
+    if (arg == "--cells-per-rank")
+      opts.cells_per_rank = std::stoll(value);
+    else if (arg == "--cells")
+      opts.cells = std::stoll(value);
+    else if (arg == "--cell")
+      opts.cell = value;
+    else if (arg == "--degree")
+      opts.degree = std::stoi(value);
+    else if (arg == "--steps")
+      opts.steps = std::stoi(value);
+    else if (arg == "--formats")
+      opts.formats = split(value);
+    else if (arg == "--engines")
+      opts.engines = split(value);
+    else if (arg == "--aggregators")
+      opts.aggregators = std::stoi(value);
+    else if (arg == "--compression")
+      opts.compression = value;
+    else if (arg == "--repeats")
+      opts.repeats = std::stoi(value);
+    else if (arg == "--dir")
+      opts.dir = value;
+    else if (arg == "--output")
+      opts.output = value;
+    else
+      throw std::runtime_error("Unknown option " + arg);
+  }
+
+  if (opts.compression != "none" and opts.compression != "deflate")
+    throw std::runtime_error("Unknown compression " + opts.compression);
+
+  return opts;
+}
+
+/// Result of the benchmark of a format
+struct Result
+{
+  /// Format, variant (e.g. the engine) and operation (`write` or
+  /// `read`)
+  std::string format, variant, operation;
+
+  /// Bytes (global) of mesh and function data written or read
+  double bytes;
+
+  /// Wall time of the metadata, data and close phases of each
+  /// repetition (maximum over processes)
+  std::vector<std::array<double, 3>> times;
+
+  /// Name of the result, under which its memory high-water mark is
+  /// recorded
+  std::string name() const
+  {
+    return format + (variant.empty() ? "" : "/" + variant) + "/" + operation;
+  }
+};
+
+/// Wall time of a collective operation (maximum over processes)
+template <typename Op>
+double measure(MPI_Comm comm, Op&& op)
+{
+  MPI_Barrier(comm);
+  const double t0 = MPI_Wtime();
+  op();
+  double t = MPI_Wtime() - t0;
+  MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return t;
+}
+
+/// @brief Time the phases of each repetition of a write or read.
+/// @param[in] comm Communicator that the operations are collective on
+/// @param[in] repeats Number of timed repetitions
+/// @param[in] open Function that opens the file, and returns it
+/// @param[in] data Function that writes or reads the data of the file
+/// @param[in] close Function that closes the file
+/// @return Wall time of the phases of each repetition
+template <typename Open, typename Data, typename Close>
+std::vector<std::array<double, 3>> measure_phases(MPI_Comm comm, int repeats,
+                                                  Open&& open, Data&& data,
+                                                  Close&& close)
+{
+  std::vector<std::array<double, 3>> times;
+  for (int r = 0; r < repeats; ++r)
+  {
+    decltype(open()) file;
+    std::array<double, 3> t;
+    t[0] = measure(comm, [&]() { file = open(); });
+    t[1] = measure(comm, [&]() { data(file); });
+    t[2] = measure(comm, [&]() { close(file); });
+    times.push_back(t);
+  }
+  return times;
+}
+
+/// Create a mesh of the unit square or cube with approximately
+/// `num_cells` cells
+std::shared_ptr<mesh::Mesh<T>> create_mesh(MPI_Comm comm, mesh::CellType cell,
+                                           std::int64_t num_cells)
+{
+  const int tdim = mesh::cell_dim(cell);
+  const std::map<mesh::CellType, int> cells_per_box
+      = {{mesh::CellType::triangle, 2},
+         {mesh::CellType::quadrilateral, 1},
+         {mesh::CellType::tetrahedron, 6},
+         {mesh::CellType::hexahedron, 1}};
+  const std::int64_t n = std::max<std::int64_t>(
+      std::llround(std::pow(double(num_cells) / cells_per_box.at(cell),
+                            1.0 / tdim)),
+      1);
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::none);
+  if (tdim == 2)
+  {
+    return std::make_shared<mesh::Mesh<T>>(mesh::create_rectangle<T>(
+        comm, {{{0.0, 0.0}, {1.0, 1.0}}}, {n, n}, cell, part));
+  }
+  else
+  {
+    return std::make_shared<mesh::Mesh<T>>(
+        mesh::create_box<T>(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                            {n, n, n}, cell, part));
+  }
+}
+
+/// The mesh data and function values that are written with the HDF5
+/// interface: the owned nodes, the owned cells (global node indices)
+/// and the owned function values, with their global ranges and shapes
+struct HDF5Data
+{
+  std::span<const T> x;
+  std::vector<std::int64_t> cells;
+  std::span<const T> u;
+  std::array<std::array<std::int64_t, 2>, 3> ranges;
+  std::array<std::vector<std::int64_t>, 3> shapes;
+};
+
+/// Extract the data that is written with the HDF5 interface
+HDF5Data hdf5_data(const mesh::Mesh<T>& mesh, const fem::Function<T>& u)
+{
+  const int tdim = mesh.topology()->dim();
+  auto x_map = mesh.geometry().index_map();
+  auto cell_map = mesh.topology()->index_map(tdim);
+  auto x_dofmap = mesh.geometry().dofmap();
+  const std::int64_t num_nodes = x_dofmap.extent(1);
+  std::span<const std::int32_t> cells(
+      x_dofmap.data_handle(), cell_map->size_local() * num_nodes);
+  std::vector<std::int64_t> global_cells(cells.size());
+  x_map->local_to_global(cells, global_cells);
+
+  auto dof_map = u.function_space()->dofmap()->index_map;
+  const int bs = u.function_space()->dofmap()->index_map_bs();
+  HDF5Data data;
+  data.x = mesh.geometry().x().first(3 * x_map->size_local());
+  data.cells = std::move(global_cells);
+  data.u = u.x()->array().first(bs * dof_map->size_local());
+  data.ranges = {x_map->local_range(), cell_map->local_range(),
+                 dof_map->local_range()};
+  data.shapes[0] = {x_map->size_global(), 3};
+  data.shapes[1] = {cell_map->size_global(), num_nodes};
+  data.shapes[2] = {dof_map->size_global(), bs};
+  return data;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  dolfinx::init_logging(argc, argv);
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const Options opts = parse_options(argc, argv);
+    const int size = dolfinx::MPI::size(comm);
+    const std::int64_t num_cells
+        = opts.cells > 0 ? opts.cells : opts.cells_per_rank * size;
+
+    mesh::CellType cell = mesh::to_type(opts.cell);
+    auto mesh = create_mesh(comm, cell, num_cells);
+    const int tdim = mesh::cell_dim(cell);
+    const std::size_t gdim = mesh->geometry().dim();
+
+    // Vector-valued Lagrange function u(x) = x
+    auto V = std::make_shared<fem::FunctionSpace<T>>(fem::create_functionspace(
+        mesh,
+        basix::create_element<T>(
+            basix::element::family::P, mesh::cell_type_to_basix_type(cell),
+            opts.degree, basix::element::lagrange_variant::gll_warped,
+            basix::element::dpc_variant::unset, false),
+        {gdim}));
+    auto u = std::make_shared<fem::Function<T>>(V);
+    u->interpolate(
+        [gdim](auto x) -> std::pair<std::vector<T>, std::vector<std::size_t>>
+        {
+          std::vector<T> f(gdim * x.extent(1));
+          for (std::size_t i = 0; i < gdim; ++i)
+            for (std::size_t p = 0; p < x.extent(1); ++p)
+              f[i * x.extent(1) + p] = x(i, p);
+          return {f, {gdim, x.extent(1)}};
+        });
+
+    // Global bytes of the mesh (node coordinates and cells) and of a
+    // step of the function
+    auto cell_map = mesh->topology()->index_map(tdim);
+    const double mesh_bytes
+        = mesh->geometry().index_map()->size_global() * 3 * sizeof(T)
+          + cell_map->size_global() * mesh->geometry().dofmap().extent(1)
+                * sizeof(std::int64_t);
+    const double function_bytes = V->dofmap()->index_map->size_global()
+                                  * V->dofmap()->index_map_bs() * sizeof(T);
+
+    // XDMF and Fides only support functions in the space of the mesh
+    // geometry
+    const bool geometry_space = opts.degree == 1;
+
+    // HDF5 dataset options
+    io::hdf5::DatasetOptions dataset_options;
+    if (opts.compression == "deflate")
+    {
+      dataset_options.filter = io::hdf5::Filter::deflate;
+      dataset_options.shuffle = true;
+    }
+    if (opts.aggregators > 0)
+    {
+      dataset_options.aggregator
+          = std::make_shared<io::Aggregator>(comm, opts.aggregators);
+    }
+    const bool mpi_io = size > 1;
+
+    if (dolfinx::MPI::rank(comm) == 0)
+      std::filesystem::create_directories(opts.dir);
+    MPI_Barrier(comm);
+
+    common::enable_memory_tracking(true);
+    std::vector<Result> results;
+    auto run = [&](Result result, auto&& open, auto&& data, auto&& close)
+    {
+      common::MemoryTracker tracker(result.name());
+      result.times = measure_phases(comm, opts.repeats, open, data, close);
+      tracker.stop();
+      results.push_back(result);
+    };
+
+    for (auto& format : opts.formats)
+    {
+      if (format == "xdmf")
+      {
+        // HDF5 metadata operations are collective or independent. The
+        // data is always written and read collectively.
+        const std::filesystem::path path = opts.dir / "bench_io.xdmf";
+        for (bool collective : {true, false})
+        {
+          io::hdf5::FileOptions file_options;
+          file_options.collective_metadata = collective;
+          const std::string variant = collective ? "collective" : "independent";
+          run(
+              {format, variant, "write",
+               mesh_bytes + geometry_space * opts.steps * function_bytes,
+               {}},
+              [&]()
+              {
+                auto file = std::make_unique<io::XDMFFile>(
+                    comm, path, "w", io::XDMFFile::Encoding::HDF5,
+                    file_options);
+                file->set_dataset_options(dataset_options);
+                return file;
+              },
+              [&](auto& file)
+              {
+                file->write_mesh(*mesh);
+                if (geometry_space)
+                {
+                  for (int s = 0; s < opts.steps; ++s)
+                    file->write_function(*u, s);
+                }
+              },
+              [](auto& file) { file->close(); });
+          run(
+              {format, variant, "read", mesh_bytes, {}},
+              [&]()
+              {
+                return std::make_unique<io::XDMFFile>(
+                    comm, path, "r", io::XDMFFile::Encoding::HDF5,
+                    file_options);
+              },
+              [&](auto& file)
+              {
+                file->read_mesh(mesh->geometry().cmap(),
+                                mesh::GhostMode::none, mesh->name);
+              },
+              [](auto& file) { file->close(); });
+        }
+      }
+      else if (format == "hdf5")
+      {
+        const std::filesystem::path path = opts.dir / "bench_io.h5";
+        const HDF5Data d = hdf5_data(*mesh, *u);
+        for (bool collective : {true, false})
+        {
+          io::hdf5::FileOptions file_options;
+          file_options.collective_metadata = collective;
+          const std::string variant = collective ? "collective" : "independent";
+          run(
+              {format, variant, "write",
+               mesh_bytes + opts.steps * function_bytes,
+               {}},
+              [&]()
+              {
+                hid_t h5 = io::hdf5::open_file(comm, path, "w", mpi_io,
+                                               file_options);
+                io::hdf5::add_group(h5, "/mesh");
+                io::hdf5::add_group(h5, "/function");
+                return h5;
+              },
+              [&](hid_t h5)
+              {
+                io::hdf5::write_dataset(h5, "/mesh/x", d.x.data(),
+                                        d.ranges[0], d.shapes[0], mpi_io,
+                                        dataset_options);
+                io::hdf5::write_dataset(h5, "/mesh/cells", d.cells.data(),
+                                        d.ranges[1], d.shapes[1], mpi_io,
+                                        dataset_options);
+                for (int s = 0; s < opts.steps; ++s)
+                {
+                  io::hdf5::write_dataset(
+                      h5, "/function/u_" + std::to_string(s), d.u.data(),
+                      d.ranges[2], d.shapes[2], mpi_io, dataset_options);
+                }
+              },
+              [](hid_t h5) { io::hdf5::close_file(h5); });
+          run(
+              {format, variant, "read", mesh_bytes + function_bytes, {}},
+              [&]()
+              {
+                return io::hdf5::open_file(comm, path, "r", mpi_io,
+                                           file_options);
+              },
+              [&](hid_t h5)
+              {
+                auto read = [&]<typename X>(std::string name,
+                                            std::array<std::int64_t, 2> range,
+                                            X)
+                {
+                  hid_t dset = io::hdf5::open_dataset(h5, name);
+                  std::vector<X> data
+                      = io::hdf5::read_dataset<X>(dset, range, false);
+                  if (H5Dclose(dset) < 0)
+                    throw std::runtime_error("Failed to close HDF5 dataset.");
+                  return data;
+                };
+                read("/mesh/x", d.ranges[0], T(0));
+                read("/mesh/cells", d.ranges[1], std::int64_t(0));
+                read("/function/u_0", d.ranges[2], T(0));
+              },
+              [](hid_t h5) { io::hdf5::close_file(h5); });
+        }
+      }
+      else if (format == "vtk")
+      {
+        const std::filesystem::path path = opts.dir / "bench_io.pvd";
+        run(
+            {format, "", "write", mesh_bytes + opts.steps * function_bytes,
+             {}},
+            [&]() { return std::make_unique<io::VTKFile>(comm, path, "w"); },
+            [&](auto& file)
+            {
+              const std::vector<std::reference_wrapper<const fem::Function<T>>>
+                  functions = {*u};
+              for (int s = 0; s < opts.steps; ++s)
+                file->write(functions, s);
+            },
+            [](auto& file) { file->close(); });
+      }
+#ifdef HAS_ADIOS2
+      else if (format == "vtx")
+      {
+        for (auto& engine : opts.engines)
+        {
+          const std::filesystem::path path
+              = opts.dir / ("bench_io_vtx_" + engine + ".bp");
+          run(
+              {format, engine, "write",
+               mesh_bytes + opts.steps * function_bytes,
+               {}},
+              [&]()
+              {
+                return std::make_unique<io::VTXWriter<T>>(
+                    comm, path, io::adios2_writer::U<T>{u}, engine,
+                    io::VTXMeshPolicy::reuse, opts.aggregators);
+              },
+              [&](auto& file)
+              {
+                for (int s = 0; s < opts.steps; ++s)
+                  file->write(s);
+              },
+              [](auto& file) { file->close(); });
+        }
+      }
+      else if (format == "fides")
+      {
+        for (auto& engine : opts.engines)
+        {
+          const std::filesystem::path path
+              = opts.dir / ("bench_io_fides_" + engine + ".bp");
+          run(
+              {format, engine, "write",
+               mesh_bytes + geometry_space * opts.steps * function_bytes,
+               {}},
+              [&]()
+              {
+                if (geometry_space)
+                {
+                  return std::make_unique<io::FidesWriter<T>>(
+                      comm, path, io::adios2_writer::U<T>{u}, engine,
+                      io::FidesMeshPolicy::reuse, opts.aggregators);
+                }
+                else
+                {
+                  return std::make_unique<io::FidesWriter<T>>(
+                      comm, path, mesh, engine, opts.aggregators);
+                }
+              },
+              [&](auto& file)
+              {
+                for (int s = 0; s < (geometry_space ? opts.steps : 1); ++s)
+                  file->write(s);
+              },
+              [](auto& file) { file->close(); });
+        }
+      }
+#endif
+      else
+        throw std::runtime_error("Unknown or unavailable format " + format);
+    }
+
+    // Memory high-water marks (rank 0)
+    const Table memory = common::memory_high_water_marks(comm);
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      std::ofstream file;
+      if (!opts.output.empty())
+        file.open(opts.output);
+      std::ostream& out = opts.output.empty() ? std::cout : file;
+
+      out << "{\n  \"dolfinx_version\": \"" << DOLFINX_VERSION_STRING
+          << "\",\n  \"git_commit\": \"" << DOLFINX_VERSION_GIT
+          << "\",\n  \"num_processes\": " << size << ",\n  \"cell\": \""
+          << opts.cell << "\",\n  \"degree\": " << opts.degree
+          << ",\n  \"num_cells\": " << cell_map->size_global()
+          << ",\n  \"num_dofs\": "
+          << V->dofmap()->index_map->size_global()
+                 * V->dofmap()->index_map_bs()
+          << ",\n  \"steps\": " << opts.steps
+          << ",\n  \"aggregators\": " << opts.aggregators
+          << ",\n  \"compression\": \"" << opts.compression
+          << "\",\n  \"repeats\": " << opts.repeats << ",\n  \"results\": [";
+      const std::array<std::string, 3> phases = {"metadata", "data", "close"};
+      for (std::size_t i = 0; i < results.size(); ++i)
+      {
+        const Result& r = results[i];
+        out << (i == 0 ? "" : ",") << "\n    {\"format\": \"" << r.format
+            << "\", \"variant\": \"" << r.variant << "\", \"operation\": \""
+            << r.operation << "\", \"bytes\": " << r.bytes
+            << ", \"phases\": {";
+        double total = 0;
+        for (std::size_t p = 0; p < phases.size(); ++p)
+        {
+          double tmin = r.times.front()[p];
+          for (auto& t : r.times)
+            tmin = std::min(tmin, t[p]);
+          total += tmin;
+          out << (p == 0 ? "" : ", ") << "\"" << phases[p]
+              << "\": {\"time_min\": " << tmin
+              << ", \"bandwidth_gbs\": " << r.bytes / tmin * 1e-9 << "}";
+        }
+        out << "}, \"time_total\": " << total
+            << ", \"bandwidth_gbs\": " << r.bytes / total * 1e-9
+            << ", \"memory_peak_mb\": "
+            << std::get<double>(memory.get(r.name(), "peak"))
+            << ", \"memory_increase_mb\": "
+            << std::get<double>(memory.get(r.name(), "increase")) << "}";
+      }
+      out << "\n  ]\n}\n";
+    }
+  }
+  MPI_Finalize();
+
+  return 0;
+}
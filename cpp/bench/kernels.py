@@ -0,0 +1,45 @@
+# The forms for the DOLFINx micro-benchmarks.
+#
+# For each cell type and element, a bilinear form `a_<cell>_<element>`
+# and a linear form `L_<cell>_<element>` with a coefficient in the same
+# space are defined. The elements are Lagrange of degree 1 to 4 (`P1`
+# to `P4`), vector-valued Lagrange of degree 1 and 2 (`V1`, `V2`) and
+# first kind Nédélec (N1curl) of degree 1 and 2 (`N1`, `N2`).
+
+from basix.ufl import element
+from ufl import (
+    Coefficient,
+    FunctionSpace,
+    Mesh,
+    TestFunction,
+    TrialFunction,
+    curl,
+    dx,
+    grad,
+    inner,
+)
+
+forms = []
+for cell, gdim in (
+    ("triangle", 2),
+    ("quadrilateral", 2),
+    ("tetrahedron", 3),
+    ("hexahedron", 3),
+):
+    mesh = Mesh(element("Lagrange", cell, 1, shape=(gdim,)))
+    elements = {f"P{k}": element("Lagrange", cell, k) for k in range(1, 5)}
+    elements |= {f"V{k}": element("Lagrange", cell, k, shape=(gdim,)) for k in (1, 2)}
+    elements |= {f"N{k}": element("N1curl", cell, k) for k in (1, 2)}
+    for name, e in elements.items():
+        V = FunctionSpace(mesh, e)
+        u, v = TrialFunction(V), TestFunction(V)
+        f = Coefficient(V)
+        if name.startswith("N"):
+            a = inner(curl(u), curl(v)) * dx + inner(u, v) * dx
+        else:
+            a = inner(grad(u), grad(v)) * dx + inner(u, v) * dx
+        globals()[f"a_{cell}_{name}"] = a
+        globals()[f"L_{cell}_{name}"] = inner(f, v) * dx
+        forms += [globals()[f"a_{cell}_{name}"], globals()[f"L_{cell}_{name}"]]
+
+del mesh, elements, V, u, v, f, a
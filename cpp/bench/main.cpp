@@ -0,0 +1,518 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Micro-benchmarks of the core DOLFINx operations. The results are
+// written in JSON format (see README.md).
+
+#include "kernels.h"
+#include <algorithm>
+#include <basix/finite-element.h>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/version.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace dolfinx;
+using T = double;
+
+namespace
+{
+/// Benchmark options
+struct Options
+{
+  /// Number of cells in each direction of 2D and 3D meshes for degree
+  /// one elements. For elements of degree k, the number of cells is
+  /// divided by k to give a similar number of degrees-of-freedom.
+  std::int64_t n2 = 128, n3 = 16;
+
+  /// Number of timed repetitions of each benchmark
+  int repeats = 5;
+
+  /// Only run benchmarks with an identifier `name/cell/element` that
+  /// contains this string
+  std::string filter;
+
+  /// JSON output file. The results are written to stdout if empty.
+  std::string output;
+};
+
+/// Parse command line options
+Options parse_options(int argc, char* argv[])
+{
+  Options opts;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (i + 1 == argc)
+      throw std::runtime_error("Missing value for option " + arg);
+    const std::string value = argv[++i];
+    if (arg == "--n2")
+      opts.n2 = std::stoll(value);
+    else if (arg == "--n3")
+      opts.n3 = std::stoll(value);
+    else if (arg == "--repeats")
+      opts.repeats = std::stoi(value);
+    else if (arg == "--filter")
+      opts.filter = value;
+    else if (arg == "--output")
+      opts.output = value;
+    else
+      throw std::runtime_error("Unknown option " + arg);
+  }
+
+  return opts;
+}
+
+/// Result of a benchmark
+struct Result
+{
+  /// Operation, cell type and element (empty if the benchmark does not
+  /// use an element)
+  std::string name, cell, element;
+
+  /// Problem size (global) in units of `unit`
+  std::int64_t size;
+  std::string unit;
+
+  /// Bytes (global) written or communicated by a call, or 0 if a
+  /// bandwidth is not meaningful for the operation
+  double bytes;
+
+  /// Wall time of each repetition (maximum over processes)
+  std::vector<double> times;
+};
+
+/// @brief Time an operation.
+/// @param[in] comm Communicator that the operation is collective on
+/// @param[in] repeats Number of timed repetitions
+/// @param[in] setup Function that is called, and not timed, before each
+/// repetition. Its return value is passed to `op`.
+/// @param[in] op Operation to time
+/// @return Wall time of each repetition (maximum over processes)
+template <typename Setup, typename Op>
+std::vector<double> measure(MPI_Comm comm, int repeats, Setup&& setup,
+                            Op&& op)
+{
+  std::vector<double> times;
+  for (int r = 0; r < repeats; ++r)
+  {
+    auto state = setup();
+    MPI_Barrier(comm);
+    const double t0 = MPI_Wtime();
+    op(state);
+    double t = MPI_Wtime() - t0;
+    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, comm);
+    times.push_back(t);
+  }
+  return times;
+}
+
+/// @brief Time an operation that needs no setup.
+template <typename Op>
+std::vector<double> measure(MPI_Comm comm, int repeats, Op&& op)
+{
+  return measure(comm, repeats, [] { return 0; }, [&op](int) { op(); });
+}
+
+/// Sum of a local quantity over processes
+double sum(MPI_Comm comm, double x)
+{
+  MPI_Allreduce(MPI_IN_PLACE, &x, 1, MPI_DOUBLE, MPI_SUM, comm);
+  return x;
+}
+
+/// Create a mesh of the unit square or cube
+std::shared_ptr<mesh::Mesh<T>> create_mesh(MPI_Comm comm,
+                                           mesh::CellType cell,
+                                           std::int64_t n)
+{
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::shared_facet);
+  if (mesh::cell_dim(cell) == 2)
+  {
+    return std::make_shared<mesh::Mesh<T>>(mesh::create_rectangle<T>(
+        comm, {{{0.0, 0.0}, {1.0, 1.0}}}, {n, n}, cell, part));
+  }
+  else
+  {
+    return std::make_shared<mesh::Mesh<T>>(mesh::create_box<T>(
+        comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {n, n, n}, cell, part));
+  }
+}
+
+/// @brief Create the Basix element for an element name in kernels.py.
+///
+/// The element variants are the defaults of `basix.ufl.element`, so
+/// that the elements match the forms.
+basix::FiniteElement<T> create_element(mesh::CellType cell,
+                                       const std::string& element)
+{
+  const int degree = std::stoi(element.substr(1));
+  if (element[0] == 'N')
+  {
+    return basix::create_element<T>(
+        basix::element::family::N1E, mesh::cell_type_to_basix_type(cell),
+        degree, basix::element::lagrange_variant::legendre,
+        basix::element::dpc_variant::unset, false);
+  }
+  else
+  {
+    return basix::create_element<T>(
+        basix::element::family::P, mesh::cell_type_to_basix_type(cell),
+        degree, basix::element::lagrange_variant::gll_warped,
+        basix::element::dpc_variant::unset, false);
+  }
+}
+
+/// Benchmarks of mesh creation, entity computation and bounding box
+/// trees
+void bench_mesh(MPI_Comm comm, const Options& opts, mesh::CellType cell,
+                const std::function<bool(const std::string&,
+                                         const std::string&)>& selected,
+                std::vector<Result>& results)
+{
+  const std::string c = mesh::to_string(cell);
+  const int tdim = mesh::cell_dim(cell);
+  const std::int64_t n = tdim == 2 ? opts.n2 : opts.n3;
+
+  if (selected("create_mesh", ""))
+  {
+    std::shared_ptr<mesh::Mesh<T>> mesh;
+    auto times = measure(
+        comm, opts.repeats,
+        [&]()
+        {
+          mesh.reset();
+          return 0;
+        },
+        [&](int) { mesh = create_mesh(comm, cell, n); });
+    results.push_back({"create_mesh", c, "",
+                       mesh->topology()->index_map(tdim)->size_global(),
+                       "cells", 0, times});
+  }
+
+  for (int dim = 1; dim < tdim; ++dim)
+  {
+    const std::string entities = dim == 1 ? "edges" : "facets";
+    if (!selected("compute_entities", entities))
+      continue;
+    std::int64_t num_entities = 0;
+    auto times = measure(
+        comm, opts.repeats, [&]() { return create_mesh(comm, cell, n); },
+        [&](auto& mesh)
+        {
+          mesh->topology_mutable()->create_entities(dim);
+          num_entities = mesh->topology()->index_map(dim)->size_global();
+        });
+    results.push_back({"compute_entities", c, entities, num_entities,
+                       "entities", 0, times});
+  }
+
+  if (!selected("bounding_box_tree", "")
+      and !selected("compute_collisions", ""))
+  {
+    return;
+  }
+
+  auto mesh = create_mesh(comm, cell, n);
+  auto cell_map = mesh->topology()->index_map(tdim);
+  const std::int64_t num_cells_global = cell_map->size_global();
+  if (selected("bounding_box_tree", ""))
+  {
+    auto times = measure(comm, opts.repeats, [&]()
+                         { geometry::BoundingBoxTree<T> tree(*mesh, tdim); });
+    results.push_back({"bounding_box_tree", c, "", num_cells_global, "cells",
+                       0, times});
+  }
+
+  if (selected("compute_collisions", ""))
+  {
+    // Query the tree with the midpoints of the owned cells
+    std::vector<std::int32_t> cells(cell_map->size_local());
+    std::iota(cells.begin(), cells.end(), 0);
+    std::vector<T> points = mesh::compute_midpoints(*mesh, tdim, cells);
+    geometry::BoundingBoxTree<T> tree(*mesh, tdim);
+    auto times
+        = measure(comm, opts.repeats,
+                  [&]() { geometry::compute_collisions<T>(tree, points); });
+    results.push_back({"compute_collisions", c, "", num_cells_global,
+                       "points", 0, times});
+  }
+}
+
+/// Benchmarks of sparsity pattern creation, assembly, linear algebra
+/// communication and function evaluation for a cell type and element
+void bench_element(MPI_Comm comm, const Options& opts, mesh::CellType cell,
+                   const std::string& element, const ufcx_form& form_a,
+                   const ufcx_form& form_L,
+                   const std::function<bool(const std::string&,
+                                            const std::string&)>& selected,
+                   std::vector<Result>& results)
+{
+  const std::array names
+      = {"sparsity_finalize",  "assemble_matrix",    "matrix_scatter_rev",
+         "pack_coefficients",  "assemble_vector",    "vector_scatter_fwd",
+         "vector_scatter_rev", "function_eval"};
+  if (std::ranges::none_of(names, [&](auto name)
+                           { return selected(name, element); }))
+  {
+    return;
+  }
+
+  const std::string c = mesh::to_string(cell);
+  const int tdim = mesh::cell_dim(cell);
+  const int degree = std::stoi(element.substr(1));
+  const std::int64_t n
+      = std::max<std::int64_t>((tdim == 2 ? opts.n2 : opts.n3) / degree, 1);
+
+  auto mesh = create_mesh(comm, cell, n);
+  std::vector<std::size_t> value_shape;
+  if (element[0] == 'V')
+    value_shape = {static_cast<std::size_t>(mesh->geometry().dim())};
+  auto V = std::make_shared<fem::FunctionSpace<T>>(
+      fem::create_functionspace(mesh, create_element(cell, element),
+                                value_shape));
+  auto f = std::make_shared<fem::Function<T>>(V);
+  f->x()->set(1.0);
+  fem::Form<T> a = fem::create_form<T>(form_a, {V, V}, {}, {}, {}, {});
+  fem::Form<T> L = fem::create_form<T>(form_L, {V}, {{"f", f}}, {}, {}, {});
+
+  auto index_map = V->dofmap()->index_map;
+  const int bs = V->dofmap()->index_map_bs();
+  const std::int64_t num_dofs = index_map->size_global() * bs;
+
+  // Sparsity pattern and matrix
+  std::vector<double> times;
+  if (selected(names[0], element))
+  {
+    times = measure(
+        comm, opts.repeats, [&]() { return fem::create_sparsity_pattern(a); },
+        [&](auto& sp) { sp.finalize(); });
+    results.push_back({names[0], c, element, num_dofs, "dofs", 0, times});
+  }
+
+  if (selected(names[1], element) or selected(names[2], element))
+  {
+    la::SparsityPattern sp = fem::create_sparsity_pattern(a);
+    sp.finalize();
+    la::MatrixCSR<T> A(sp);
+    if (selected(names[1], element))
+    {
+      times = measure(
+          comm, opts.repeats,
+          [&]()
+          {
+            A.set(0);
+            return 0;
+          },
+          [&](int) { fem::assemble_matrix(A.mat_add_values(), a, {}); });
+      results.push_back({names[1], c, element, num_dofs, "dofs",
+                         sum(comm, A.values().size() * sizeof(T)), times});
+    }
+
+    if (selected(names[2], element))
+    {
+      const std::int32_t num_ghost_values
+          = A.values().size() - A.row_ptr()[A.num_owned_rows()];
+      times = measure(comm, opts.repeats, [&]() { A.scatter_rev(); });
+      results.push_back({names[2], c, element, num_dofs, "dofs",
+                         sum(comm, num_ghost_values * sizeof(T)), times});
+    }
+  }
+
+  // Vector assembly and communication
+  auto coeffs = fem::allocate_coefficient_storage(L);
+  double coeff_size = 0;
+  for (auto& [key, coeff] : coeffs)
+    coeff_size += coeff.first.size();
+  if (selected(names[3], element))
+  {
+    times = measure(comm, opts.repeats,
+                    [&]() { fem::pack_coefficients(L, coeffs); });
+    results.push_back({names[3], c, element, num_dofs, "dofs",
+                       sum(comm, coeff_size * sizeof(T)), times});
+  }
+
+  fem::pack_coefficients(L, coeffs);
+  la::Vector<T> b(index_map, bs);
+  if (selected(names[4], element))
+  {
+    std::span<const T> constants = L.packed_constants();
+    times = measure(
+        comm, opts.repeats,
+        [&]()
+        {
+          b.set(0);
+          return 0;
+        },
+        [&](int)
+        {
+          fem::assemble_vector(b.mutable_array(), L, constants,
+                               fem::make_coefficients_span(coeffs));
+        });
+    results.push_back({names[4], c, element, num_dofs, "dofs",
+                       sum(comm, b.array().size() * sizeof(T)), times});
+  }
+
+  const double ghost_bytes
+      = sum(comm, index_map->num_ghosts() * bs * sizeof(T));
+  if (selected(names[5], element))
+  {
+    times = measure(comm, opts.repeats, [&]() { b.scatter_fwd(); });
+    results.push_back(
+        {names[5], c, element, num_dofs, "dofs", ghost_bytes, times});
+  }
+  if (selected(names[6], element))
+  {
+    times = measure(comm, opts.repeats,
+                    [&]() { b.scatter_rev(std::plus<T>()); });
+    results.push_back(
+        {names[6], c, element, num_dofs, "dofs", ghost_bytes, times});
+  }
+
+  // Evaluate the function at the midpoints of the owned cells
+  if (selected(names[7], element))
+  {
+    const std::int32_t num_cells
+        = mesh->topology()->index_map(tdim)->size_local();
+    std::vector<std::int32_t> cells(num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    std::vector<T> x = mesh::compute_midpoints(*mesh, tdim, cells);
+    const std::size_t value_size = V->value_size();
+    std::vector<T> u(num_cells * value_size);
+    times = measure(comm, opts.repeats,
+                    [&]()
+                    {
+                      f->eval(x, {cells.size(), 3}, cells, u,
+                              {cells.size(), value_size});
+                    });
+    results.push_back({names[7], c, element,
+                       mesh->topology()->index_map(tdim)->size_global(),
+                       "points", 0, times});
+  }
+}
+
+/// Write results in JSON format
+void write_json(std::ostream& out, MPI_Comm comm,
+                const std::vector<Result>& results)
+{
+  out << "{\n  \"dolfinx_version\": \"" << DOLFINX_VERSION_STRING
+      << "\",\n  \"git_commit\": \"" << DOLFINX_VERSION_GIT
+      << "\",\n  \"num_processes\": " << dolfinx::MPI::size(comm)
+      << ",\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    const double tmin = std::ranges::min(r.times);
+    const double tmean
+        = std::accumulate(r.times.begin(), r.times.end(), 0.0)
+          / r.times.size();
+    out << (i == 0 ? "" : ",") << "\n    {\"name\": \"" << r.name
+        << "\", \"cell\": \"" << r.cell << "\", \"element\": \""
+        << r.element << "\", \"size\": " << r.size << ", \"unit\": \""
+        << r.unit << "\", \"repeats\": " << r.times.size()
+        << ", \"time_min\": " << tmin << ", \"time_mean\": " << tmean
+        << ", \"rate\": " << r.size / tmin << ", \"bandwidth_gbs\": ";
+    if (r.bytes > 0)
+      out << r.bytes / tmin * 1e-9 << "}";
+    else
+      out << "null}";
+  }
+  out << "\n  ]\n}\n";
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  dolfinx::init_logging(argc, argv);
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const Options opts = parse_options(argc, argv);
+    auto selected = [&opts](const std::string& name, const std::string& cell,
+                            const std::string& element)
+    {
+      return opts.filter.empty()
+             or (name + "/" + cell + "/" + element).find(opts.filter)
+                    != std::string::npos;
+    };
+
+    // Forms for each cell type and element, see kernels.py
+#define KERNEL(cell, element)                                                  \
+  {mesh::CellType::cell, #element, form_kernels_a_##cell##_##element,          \
+   form_kernels_L_##cell##_##element}
+#define KERNELS(cell)                                                          \
+  KERNEL(cell, P1), KERNEL(cell, P2), KERNEL(cell, P3), KERNEL(cell, P4),      \
+      KERNEL(cell, V1), KERNEL(cell, V2), KERNEL(cell, N1), KERNEL(cell, N2)
+    const std::vector<
+        std::tuple<mesh::CellType, std::string, ufcx_form*, ufcx_form*>>
+        kernels = {KERNELS(triangle), KERNELS(quadrilateral),
+                   KERNELS(tetrahedron), KERNELS(hexahedron)};
+#undef KERNELS
+#undef KERNEL
+
+    std::vector<Result> results;
+    for (auto cell :
+         {mesh::CellType::triangle, mesh::CellType::quadrilateral,
+          mesh::CellType::tetrahedron, mesh::CellType::hexahedron})
+    {
+      const std::string c = mesh::to_string(cell);
+      bench_mesh(
+          comm, opts, cell,
+          [&](const std::string& name, const std::string& element)
+          { return selected(name, c, element); },
+          results);
+    }
+
+    for (auto& [cell, element, form_a, form_L] : kernels)
+    {
+      const std::string c = mesh::to_string(cell);
+      bench_element(
+          comm, opts, cell, element, *form_a, *form_L,
+          [&](const std::string& name, const std::string& e)
+          { return selected(name, c, e); },
+          results);
+    }
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      if (opts.output.empty())
+        write_json(std::cout, comm, results);
+      else
+      {
+        std::ofstream file(opts.output);
+        write_json(file, comm, results);
+      }
+    }
+  }
+  MPI_Finalize();
+
+  return 0;
+}
@@ -0,0 +1,446 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Weak and strong scaling benchmark of the full pipeline of a finite
+// element solver: mesh creation and partitioning, topology and dofmap
+// creation, sparsity pattern creation, assembly, solution by the
+// conjugate gradient method and output. The time of each phase and the
+// load balance are written in JSON format (see README.md).
+
+#include "kernels.h"
+#include <algorithm>
+#include <array>
+#include <basix/finite-element.h>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/profiler.h>
+#include <dolfinx/common/version.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/graph/partition.h>
+#include <dolfinx/graph/partitioners.h>
+#include <dolfinx/io/XDMFFile.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/la/krylov.h>
+#include <dolfinx/la/preconditioners.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mpi.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+using T = double;
+
+namespace
+{
+/// Benchmark options
+struct Options
+{
+  /// Number of cells per process (weak scaling). Used if `cells` is
+  /// not positive.
+  std::int64_t cells_per_rank = 100000;
+
+  /// Total number of cells (strong scaling)
+  std::int64_t cells = 0;
+
+  /// Cell type and element name in kernels.py
+  std::string cell = "tetrahedron", element = "P1";
+
+  /// Ghost mode (`none` or `shared_facet`)
+  std::string ghost_mode = "shared_facet";
+
+  /// Graph partitioner (`default`, `scotch`, `parmetis`, `kahip` or
+  /// `hierarchical`)
+  std::string partitioner = "default";
+
+  /// Relative tolerance and maximum number of iterations of the
+  /// conjugate gradient solver
+  double rtol = 1e-8;
+  int max_it = 1000;
+
+  /// XDMF file that the mesh and solution are written to. The I/O
+  /// phase is skipped if empty.
+  std::string io;
+
+  /// JSON output file. The results are written to stdout if empty.
+  std::string output;
+};
+
+/// Parse command line options
+Options parse_options(int argc, char* argv[])
+{
+  Options opts;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (i + 1 == argc)
+      throw std::runtime_error("Missing value for option " + arg);
+    const std::string value = argv[++i];
+    if (arg == "--cells-per-rank")
+      opts.cells_per_rank = std::stoll(value);
+    else if (arg == "--cells")
+      opts.cells = std::stoll(value);
+    else if (arg == "--cell")
+      opts.cell = value;
+    else if (arg == "--element")
+      opts.element = value;
+    else if (arg == "--degree")
+      opts.element = "P" + value;
+    else if (arg == "--ghost-mode")
+      opts.ghost_mode = value;
+    else if (arg == "--partitioner")
+      opts.partitioner = value;
+    else if (arg == "--rtol")
+      opts.rtol = std::stod(value);
+    else if (arg == "--max-it")
+      opts.max_it = std::stoi(value);
+    else if (arg == "--io")
+      opts.io = value;
+    else if (arg == "--output")
+      opts.output = value;
+    else
+      throw std::runtime_error("Unknown option " + arg);
+  }
+
+  return opts;
+}
+
+/// Create the graph partitioner with a name
+graph::partition_fn create_partitioner(const std::string& name)
+{
+  if (name == "default")
+    return &graph::partition_graph;
+#ifdef HAS_PTSCOTCH
+  else if (name == "scotch")
+    return graph::scotch::partitioner();
+#endif
+#ifdef HAS_PARMETIS
+  else if (name == "parmetis")
+    return graph::parmetis::partitioner();
+#endif
+#ifdef HAS_KAHIP
+  else if (name == "kahip")
+    return graph::kahip::partitioner();
+#endif
+  else if (name == "hierarchical")
+    return graph::hierarchical::partitioner();
+  else
+    throw std::runtime_error("Unknown or unavailable partitioner " + name);
+}
+
+/// @brief Create a mesh of the unit square or cube with approximately
+/// `num_cells` cells.
+///
+/// The partitioning of the cells is recorded as the profiler region
+/// "Partition" inside the enclosing region.
+std::shared_ptr<mesh::Mesh<T>>
+create_mesh(MPI_Comm comm, mesh::CellType cell, std::int64_t num_cells,
+            mesh::GhostMode ghost_mode, const graph::partition_fn& partfn)
+{
+  mesh::CellPartitionFunction part
+      = mesh::create_cell_partitioner(ghost_mode, partfn);
+  auto partitioner
+      = [part](MPI_Comm comm, int nparts,
+               const std::vector<mesh::CellType>& cell_types,
+               const std::vector<std::span<const std::int64_t>>& cells)
+  {
+    common::ScopedRegion region("Partition");
+    return part(comm, nparts, cell_types, cells);
+  };
+
+  // Number of cells in each sub-division of the domain into squares or
+  // cubes
+  const int tdim = mesh::cell_dim(cell);
+  const std::map<mesh::CellType, int> cells_per_box
+      = {{mesh::CellType::triangle, 2},
+         {mesh::CellType::quadrilateral, 1},
+         {mesh::CellType::tetrahedron, 6},
+         {mesh::CellType::hexahedron, 1}};
+  const std::int64_t n = std::max<std::int64_t>(
+      std::llround(std::pow(double(num_cells) / cells_per_box.at(cell),
+                            1.0 / tdim)),
+      1);
+  if (tdim == 2)
+  {
+    return std::make_shared<mesh::Mesh<T>>(mesh::create_rectangle<T>(
+        comm, {{{0.0, 0.0}, {1.0, 1.0}}}, {n, n}, cell, partitioner));
+  }
+  else
+  {
+    return std::make_shared<mesh::Mesh<T>>(
+        mesh::create_box<T>(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                            {n, n, n}, cell, partitioner));
+  }
+}
+
+/// @brief Create the Basix element for an element name in kernels.py.
+///
+/// The element variants are the defaults of `basix.ufl.element`, so
+/// that the elements match the forms.
+basix::FiniteElement<T> create_element(mesh::CellType cell,
+                                       const std::string& element)
+{
+  const int degree = std::stoi(element.substr(1));
+  if (element[0] == 'N')
+  {
+    return basix::create_element<T>(
+        basix::element::family::N1E, mesh::cell_type_to_basix_type(cell),
+        degree, basix::element::lagrange_variant::legendre,
+        basix::element::dpc_variant::unset, false);
+  }
+  else
+  {
+    return basix::create_element<T>(
+        basix::element::family::P, mesh::cell_type_to_basix_type(cell),
+        degree, basix::element::lagrange_variant::gll_warped,
+        basix::element::dpc_variant::unset, false);
+  }
+}
+
+/// Number of shared-memory nodes that the processes of a communicator
+/// run on
+int num_nodes(MPI_Comm comm)
+{
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                      &node_comm);
+  int leader = dolfinx::MPI::rank(node_comm) == 0;
+  MPI_Comm_free(&node_comm);
+  MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_SUM, comm);
+  return leader;
+}
+
+/// @brief Minimum, average and maximum over processes of the wall time
+/// of a profiler region.
+///
+/// Collective. Processes that did not enter the region contribute a
+/// time of zero.
+std::array<double, 3> phase_time(MPI_Comm comm,
+                                 const std::vector<common::profiler::Region>&
+                                     regions,
+                                 const std::string& path)
+{
+  double t = 0;
+  for (auto& r : regions)
+  {
+    if (r.path == path)
+      t += r.wall;
+  }
+
+  std::array<double, 3> times;
+  MPI_Allreduce(&t, &times[0], 1, MPI_DOUBLE, MPI_MIN, comm);
+  MPI_Allreduce(&t, &times[1], 1, MPI_DOUBLE, MPI_SUM, comm);
+  MPI_Allreduce(&t, &times[2], 1, MPI_DOUBLE, MPI_MAX, comm);
+  times[1] /= dolfinx::MPI::size(comm);
+  return times;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  dolfinx::init_logging(argc, argv);
+  MPI_Init(&argc, &argv);
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const Options opts = parse_options(argc, argv);
+    const int size = dolfinx::MPI::size(comm);
+    const std::int64_t num_cells
+        = opts.cells > 0 ? opts.cells : opts.cells_per_rank * size;
+
+    mesh::CellType cell = mesh::to_type(opts.cell);
+    mesh::GhostMode ghost_mode;
+    if (opts.ghost_mode == "none")
+      ghost_mode = mesh::GhostMode::none;
+    else if (opts.ghost_mode == "shared_facet")
+      ghost_mode = mesh::GhostMode::shared_facet;
+    else
+      throw std::runtime_error("Unknown ghost mode " + opts.ghost_mode);
+    graph::partition_fn partfn = create_partitioner(opts.partitioner);
+
+    // Forms for each cell type and element, see kernels.py
+#define KERNEL(cell, element)                                                  \
+  {{mesh::CellType::cell, #element},                                           \
+   {form_kernels_a_##cell##_##element, form_kernels_L_##cell##_##element}}
+#define KERNELS(cell)                                                          \
+  KERNEL(cell, P1), KERNEL(cell, P2), KERNEL(cell, P3), KERNEL(cell, P4),      \
+      KERNEL(cell, V1), KERNEL(cell, V2), KERNEL(cell, N1), KERNEL(cell, N2)
+    const std::map<std::pair<mesh::CellType, std::string>,
+                   std::pair<ufcx_form*, ufcx_form*>>
+        kernels = {KERNELS(triangle), KERNELS(quadrilateral),
+                   KERNELS(tetrahedron), KERNELS(hexahedron)};
+#undef KERNELS
+#undef KERNEL
+    auto it = kernels.find({cell, opts.element});
+    if (it == kernels.end())
+    {
+      throw std::runtime_error("No forms for element " + opts.element
+                               + " on " + opts.cell);
+    }
+    auto [form_a, form_L] = it->second;
+
+    common::profiler::reset();
+    MPI_Barrier(comm);
+    const double t0 = MPI_Wtime();
+
+    std::shared_ptr<mesh::Mesh<T>> mesh;
+    {
+      common::ScopedRegion region("Create mesh");
+      mesh = create_mesh(comm, cell, num_cells, ghost_mode, partfn);
+    }
+
+    const int tdim = mesh::cell_dim(cell);
+    {
+      common::ScopedRegion region("Create topology");
+      for (int d = 1; d < tdim; ++d)
+        mesh->topology_mutable()->create_entities(d);
+      mesh->topology_mutable()->create_connectivity(tdim - 1, tdim);
+    }
+
+    std::shared_ptr<fem::FunctionSpace<T>> V;
+    {
+      common::ScopedRegion region("Create dofmap");
+      std::vector<std::size_t> value_shape;
+      if (opts.element[0] == 'V')
+        value_shape = {static_cast<std::size_t>(mesh->geometry().dim())};
+      V = std::make_shared<fem::FunctionSpace<T>>(fem::create_functionspace(
+          mesh, create_element(cell, opts.element), value_shape));
+    }
+
+    // The right-hand side has the coefficient f = 1, and the bilinear
+    // form (stiffness plus mass) is symmetric positive-definite, so no
+    // boundary conditions are needed
+    auto f = std::make_shared<fem::Function<T>>(V);
+    f->x()->set(1.0);
+    fem::Form<T> a = fem::create_form<T>(*form_a, {V, V}, {}, {}, {}, {});
+    fem::Form<T> L
+        = fem::create_form<T>(*form_L, {V}, {{"f", f}}, {}, {}, {});
+
+    std::unique_ptr<la::MatrixCSR<T>> A;
+    {
+      common::ScopedRegion region("Create sparsity");
+      la::SparsityPattern sp = fem::create_sparsity_pattern(a);
+      sp.finalize();
+      A = std::make_unique<la::MatrixCSR<T>>(sp);
+    }
+
+    auto u = std::make_shared<fem::Function<T>>(V);
+    la::Vector<T> b(V->dofmap()->index_map, V->dofmap()->index_map_bs());
+    {
+      common::ScopedRegion region("Assemble");
+      fem::assemble_matrix(A->mat_add_values(), a, {});
+      A->scatter_rev();
+      fem::assemble_vector(b.mutable_array(), L);
+      b.scatter_rev(std::plus<T>());
+    }
+
+    la::KrylovResult<T> result;
+    {
+      common::ScopedRegion region("Solve");
+      la::Jacobi<T> M(*A);
+      auto op = [&A](auto& x, auto& y) { A->mult(x, y); };
+      result = la::cg(op, M, *u->x(), b, opts.rtol, T(0), opts.max_it);
+    }
+
+    if (!opts.io.empty())
+    {
+      // The solution can only be written to XDMF if it is in the
+      // space of the mesh geometry
+      common::ScopedRegion region("I/O");
+      io::XDMFFile file(comm, opts.io, "w");
+      file.write_mesh(*mesh);
+      if (opts.element == "P1" or opts.element == "V1")
+        file.write_function(*u, 0.0);
+    }
+
+    MPI_Barrier(comm);
+    const double total_time = MPI_Wtime() - t0;
+
+    // Load balance of the distributed data
+    auto cell_map = mesh->topology()->index_map(tdim);
+    auto vertex_map = mesh->topology()->index_map(0);
+    auto dof_map = V->dofmap()->index_map;
+    const std::array<std::pair<std::string,
+                               std::shared_ptr<const common::IndexMap>>,
+                     3>
+        maps = {{{"cells", cell_map}, {"vertices", vertex_map},
+                 {"dofs", dof_map}}};
+    std::vector<std::array<double, 2>> imbalance;
+    for (auto& [name, map] : maps)
+      imbalance.push_back(map->imbalance());
+
+    const std::vector<std::string> phases
+        = {"Create mesh",     "Create mesh / Partition",
+           "Create topology", "Create dofmap",
+           "Create sparsity", "Assemble",
+           "Solve",           "I/O"};
+    const std::vector<common::profiler::Region> regions
+        = common::profiler::regions();
+    std::vector<std::array<double, 3>> times;
+    for (auto& phase : phases)
+      times.push_back(phase_time(comm, regions, phase));
+
+    const int nodes = num_nodes(comm);
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      std::ofstream file;
+      if (!opts.output.empty())
+        file.open(opts.output);
+      std::ostream& out = opts.output.empty() ? std::cout : file;
+
+      out << "{\n  \"dolfinx_version\": \"" << DOLFINX_VERSION_STRING
+          << "\",\n  \"git_commit\": \"" << DOLFINX_VERSION_GIT
+          << "\",\n  \"num_processes\": " << size
+          << ",\n  \"num_nodes\": " << nodes << ",\n  \"cell\": \""
+          << opts.cell << "\",\n  \"element\": \"" << opts.element
+          << "\",\n  \"ghost_mode\": \"" << opts.ghost_mode
+          << "\",\n  \"partitioner\": \"" << opts.partitioner
+          << "\",\n  \"num_cells\": " << cell_map->size_global()
+          << ",\n  \"num_dofs\": "
+          << dof_map->size_global() * V->dofmap()->index_map_bs()
+          << ",\n  \"solver\": {\"iterations\": " << result.iterations
+          << ", \"residual_norm\": " << result.residual_norm
+          << ", \"converged\": " << (result.converged ? "true" : "false")
+          << "},\n  \"imbalance\": {";
+      for (std::size_t i = 0; i < maps.size(); ++i)
+      {
+        out << (i == 0 ? "" : ", ") << "\"" << maps[i].first
+            << "\": {\"owned\": " << imbalance[i][0]
+            << ", \"ghost\": " << imbalance[i][1] << "}";
+      }
+      out << "},\n  \"total_time\": " << total_time
+          << ",\n  \"phases\": [";
+      for (std::size_t i = 0; i < phases.size(); ++i)
+      {
+        out << (i == 0 ? "" : ",") << "\n    {\"name\": \"" << phases[i]
+            << "\", \"time_min\": " << times[i][0]
+            << ", \"time_avg\": " << times[i][1]
+            << ", \"time_max\": " << times[i][2] << "}";
+      }
+      out << "\n  ]\n}\n";
+    }
+  }
+  MPI_Finalize();
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+"""Generate batch job scripts for weak and strong scaling runs of
+bench_scaling on 1 to N nodes.
+
+One script is written for each number of nodes (1, 2, 4, ... up to
+--max-nodes), together with a script submit.sh that submits all of
+them. Each job writes its results to a JSON file named after the run,
+e.g. weak_tetrahedron_P1_n4.json.
+"""
+
+import argparse
+import pathlib
+import shlex
+
+templates = {
+    "slurm": """#!/bin/bash
+#SBATCH --job-name={name}
+#SBATCH --nodes={nodes}
+#SBATCH --ntasks-per-node={ranks_per_node}
+#SBATCH --time={time}
+#SBATCH --output={name}.log
+{extra}
+srun {command}
+""",
+    "pbs": """#!/bin/bash
+#PBS -N {name}
+#PBS -l select={nodes}:mpiprocs={ranks_per_node}
+#PBS -l walltime={time}
+#PBS -j oe
+#PBS -o {name}.log
+{extra}
+cd "$PBS_O_WORKDIR"
+mpiexec -n {ranks} {command}
+""",
+}
+
+submit = {"slurm": "sbatch", "pbs": "qsub"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--scheduler", choices=templates.keys(), default="slurm")
+    parser.add_argument("--mode", choices=("weak", "strong"), default="weak")
+    parser.add_argument("--max-nodes", type=int, default=16)
+    parser.add_argument("--ranks-per-node", type=int, default=64)
+    parser.add_argument(
+        "--cells",
+        type=int,
+        default=100000,
+        help="cells per rank (weak scaling) or in total (strong scaling)",
+    )
+    parser.add_argument("--cell", default="tetrahedron")
+    parser.add_argument("--element", default="P1")
+    parser.add_argument("--ghost-mode", default="shared_facet")
+    parser.add_argument("--partitioner", default="default")
+    parser.add_argument("--io", action="store_true", help="include the I/O phase")
+    parser.add_argument("--time", default="00:30:00", help="wall time limit")
+    parser.add_argument(
+        "--extra", default="", help="extra lines, e.g. module loads, for each script"
+    )
+    parser.add_argument("--executable", default="./bench_scaling")
+    parser.add_argument("--directory", type=pathlib.Path, default=pathlib.Path("jobs"))
+    args = parser.parse_args()
+
+    args.directory.mkdir(parents=True, exist_ok=True)
+    scripts = []
+    nodes = 1
+    while nodes <= args.max_nodes:
+        name = f"{args.mode}_{args.cell}_{args.element}_n{nodes}"
+        command = [
+            args.executable,
+            "--cells-per-rank" if args.mode == "weak" else "--cells",
+            str(args.cells),
+            "--cell",
+            args.cell,
+            "--element",
+            args.element,
+            "--ghost-mode",
+            args.ghost_mode,
+            "--partitioner",
+            args.partitioner,
+            "--output",
+            f"{name}.json",
+        ]
+        if args.io:
+            command += ["--io", f"{name}.xdmf"]
+        script = templates[args.scheduler].format(
+            name=name,
+            nodes=nodes,
+            ranks_per_node=args.ranks_per_node,
+            ranks=nodes * args.ranks_per_node,
+            time=args.time,
+            extra=args.extra,
+            command=shlex.join(command),
+        )
+        path = args.directory / f"{name}.sh"
+        path.write_text(script)
+        scripts.append(path.name)
+        nodes *= 2
+
+    lines = ["#!/bin/bash", 'cd "$(dirname "$0")"']
+    lines += [f"{submit[args.scheduler]} {s}" for s in scripts]
+    path = args.directory / "submit.sh"
+    path.write_text("\n".join(lines) + "\n")
+    path.chmod(0o755)
+
+
+if __name__ == "__main__":
+    main()
@@ -141,12 +141,9 @@ double assemble_matrix1(const mesh::Geometry<T>& g, const fem::DofMap& dofmap,
   fem::sparsitybuild::cells(sp, {cells, cells}, {dofmap, dofmap});
   sp.finalize();
   la::MatrixCSR<T> A(sp);
-  auto ident = [](auto, auto, auto, auto) {}; // DOF permutation not required
   common::Timer timer("Assembler1 lambda (matrix)");
-  fem::impl::assemble_cells(A.mat_add_values(), g.dofmap(), g.x(), cells,
-                            {dofmap.map(), 1, cells}, ident,
-                            {dofmap.map(), 1, cells}, ident, {}, {}, kernel,
-                            std::span<const T>(), 0, {}, {}, {});
+  fem::assemble_matrix<T>(A.mat_add_values(), kernel, g, cells, dofmap,
+                          dofmap);
   A.scatter_rev();
   return A.squared_norm();
 }
@@ -168,9 +165,7 @@ double assemble_vector1(const mesh::Geometry<T>& g, const fem::DofMap& dofmap,
 {
   la::Vector<T> b(dofmap.index_map, 1);
   common::Timer timer("Assembler1 lambda (vector)");
-  fem::impl::assemble_cells<T, 1>(
-      [](auto, auto, auto, auto) {}, b.mutable_array(), g.dofmap(), g.x(),
-      cells, {dofmap.map(), 1, cells}, kernel, {}, {}, 0, {});
+  fem::assemble_vector<T>(b.mutable_array(), kernel, g, cells, dofmap);
   b.scatter_rev(std::plus<T>());
   return la::squared_norm(b);
 }
@@ -5,12 +5,16 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "IndexMap.h"
+#include "ThreadPool.h"
 #include "sort.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,6 +49,64 @@ std::array<std::vector<int>, 2> build_src_dest(MPI_Comm comm,
   return {std::move(src), std::move(dest)};
 }
 
+/// @brief Compute the range of indices owned by the calling rank and
+/// the global number of indices.
+/// @param comm MPI communicator.
+/// @param local_size Number of indices owned by the calling rank.
+/// @return (local range, global size).
+std::pair<std::array<std::int64_t, 2>, std::int64_t>
+compute_local_range(MPI_Comm comm, std::int32_t local_size)
+{
+  // Get global offset (index), using partial exclusive reduction
+  std::int64_t offset = 0;
+  const std::int64_t local_size_tmp = local_size;
+  MPI_Request request_scan;
+  int ierr = MPI_Iexscan(&local_size_tmp, &offset, 1, MPI_INT64_T, MPI_SUM,
+                         comm, &request_scan);
+  dolfinx::MPI::check_error(comm, ierr);
+
+  // Send local size to sum reduction to get global size
+  std::int64_t size_global = 0;
+  MPI_Request request;
+  ierr = MPI_Iallreduce(&local_size_tmp, &size_global, 1, MPI_INT64_T,
+                        MPI_SUM, comm, &request);
+  dolfinx::MPI::check_error(comm, ierr);
+
+  // Wait for MPI_Iexscan to complete (get offset)
+  ierr = MPI_Wait(&request_scan, MPI_STATUS_IGNORE);
+  dolfinx::MPI::check_error(comm, ierr);
+
+  // Wait for the MPI_Iallreduce to complete
+  ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
+  dolfinx::MPI::check_error(comm, ierr);
+
+  return {{offset, offset + local_size}, size_global};
+}
+
+/// @brief Create the neighbourhood communicators (ghost -> owner,
+/// owner -> ghost) for given source and destination ranks.
+/// @param comm MPI communicator.
+/// @param src Ranks that own indices ghosted by the caller.
+/// @param dest Ranks that ghost indices owned by the caller.
+/// @return Neighbourhood communicators.
+std::shared_ptr<const std::array<dolfinx::MPI::Comm, 2>>
+create_neighbourhood_comms(MPI_Comm comm, std::span<const int> src,
+                           std::span<const int> dest)
+{
+  MPI_Comm comm0, comm1;
+  int ierr = MPI_Dist_graph_create_adjacent(
+      comm, dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(), src.data(),
+      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
+  dolfinx::MPI::check_error(comm, ierr);
+  ierr = MPI_Dist_graph_create_adjacent(
+      comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
+      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm1);
+  dolfinx::MPI::check_error(comm, ierr);
+  return std::make_shared<const std::array<dolfinx::MPI::Comm, 2>>(
+      std::array{dolfinx::MPI::Comm(comm0, false),
+                 dolfinx::MPI::Comm(comm1, false)});
+}
+
 /// @brief Helper function that sends ghost indices on a given process
 /// to their owning rank, and receives indices owned by this process
 /// that are ghosts on other processes.
@@ -53,6 +115,8 @@ std::array<std::vector<int>, 2> build_src_dest(MPI_Comm comm,
 /// communication pattern.
 ///
 /// @param[in] comm The communicator (global).
+/// @param[in] comm0 Neighbourhood communicator (ghost -> owner), with
+/// `dest` as sources and `src` as destinations.
 /// @param[in] src Source ranks on `comm`.
 /// @param[in] dest Destination ranks on `comm`.
 /// @param[in] ghosts Ghost indices on calling process.
@@ -73,7 +137,8 @@ std::array<std::vector<int>, 2> build_src_dest(MPI_Comm comm,
 std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>,
            std::vector<std::size_t>, std::vector<std::int32_t>,
            std::vector<std::int32_t>, std::vector<int>, std::vector<int>>
-communicate_ghosts_to_owners(MPI_Comm comm, std::span<const int> src,
+communicate_ghosts_to_owners(MPI_Comm comm, MPI_Comm comm0,
+                             std::span<const int> src,
                              std::span<const int> dest,
                              std::span<const std::int64_t> ghosts,
                              std::span<const std::int32_t> owners,
@@ -85,13 +150,6 @@ communicate_ghosts_to_owners(MPI_Comm comm, std::span<const int> src,
   std::vector<std::int32_t> send_sizes, recv_sizes;
   std::vector<int> send_disp, recv_disp;
   {
-    // Create neighbourhood comm (ghost -> owner)
-    MPI_Comm comm0;
-    int ierr = MPI_Dist_graph_create_adjacent(
-        comm, dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(), src.data(),
-        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    dolfinx::MPI::check_error(comm, ierr);
-
     // Pack ghosts indices
     std::vector<std::vector<std::int64_t>> send_data(src.size());
     std::vector<std::vector<std::size_t>> pos_to_ghost(src.size());
@@ -142,13 +200,10 @@ communicate_ghosts_to_owners(MPI_Comm comm, std::span<const int> src,
 
     // Send ghost indices to owner, and receive indices
     recv_indices.resize(recv_disp.back());
-    ierr = MPI_Neighbor_alltoallv(send_indices.data(), send_sizes.data(),
-                                  send_disp.data(), MPI_INT64_T,
-                                  recv_indices.data(), recv_sizes.data(),
-                                  recv_disp.data(), MPI_INT64_T, comm0);
-    dolfinx::MPI::check_error(comm, ierr);
-
-    ierr = MPI_Comm_free(&comm0);
+    int ierr = MPI_Neighbor_alltoallv(
+        send_indices.data(), send_sizes.data(), send_disp.data(), MPI_INT64_T,
+        recv_indices.data(), recv_sizes.data(), recv_disp.data(), MPI_INT64_T,
+        comm0);
     dolfinx::MPI::check_error(comm, ierr);
   }
 
@@ -192,10 +247,12 @@ compute_submap_indices(const IndexMap& imap,
   // --- Step 1 ---: Send ghost indices in `indices` to their owners
   // and receive indices owned by this process that are in `indices`
   // on other processes
+  const std::array<MPI_Comm, 2> comms = imap.neighbourhood_comms();
   const auto [send_indices, recv_indices, ghost_buffer_pos, send_sizes,
               recv_sizes, send_disp, recv_disp]
       = communicate_ghosts_to_owners(
-          imap.comm(), imap.src(), imap.dest(), imap.ghosts(), imap.owners(),
+          imap.comm(), comms[0], imap.src(), imap.dest(), imap.ghosts(),
+          imap.owners(),
           std::span(is_in_submap.cbegin() + imap.size_local(),
                     is_in_submap.cend()));
 
@@ -206,6 +263,7 @@ compute_submap_indices(const IndexMap& imap,
   // other processes must own them in the submap.
 
   std::vector<int> recv_owners(send_disp.back());
+  std::vector<int> submap_dest;
   const int rank = dolfinx::MPI::rank(imap.comm());
   {
     // Flag to track if the owner of any indices have changed in the submap
@@ -269,23 +327,75 @@ compute_submap_indices(const IndexMap& imap,
         send_owners.push_back(-1);
     }
 
-    // Create neighbourhood comm (owner -> ghost)
-    MPI_Comm comm1;
-    int ierr = MPI_Dist_graph_create_adjacent(
-        imap.comm(), src.size(), src.data(), MPI_UNWEIGHTED, dest.size(),
-        dest.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm1);
+    // Send the data (owner -> ghost)
+    int ierr = MPI_Neighbor_alltoallv(
+        send_owners.data(), recv_sizes.data(), recv_disp.data(), MPI_INT,
+        recv_owners.data(), send_sizes.data(), send_disp.data(), MPI_INT,
+        comms[1]);
     dolfinx::MPI::check_error(imap.comm(), ierr);
 
-    // Send the data
-    ierr = MPI_Neighbor_alltoallv(send_owners.data(), recv_sizes.data(),
-                                  recv_disp.data(), MPI_INT, recv_owners.data(),
-                                  send_sizes.data(), send_disp.data(), MPI_INT,
-                                  comm1);
-    dolfinx::MPI::check_error(imap.comm(), ierr);
+    // Compute the submap destination ranks from the parent
+    // neighbourhood. A rank that ghosts an index in the submap is a
+    // destination of the submap owner of the index. If the submap owner
+    // is this rank, the ghosting rank is added to the destinations of
+    // this rank, otherwise it is sent to the new owner, which is a
+    // destination of this rank in the parent map.
+    std::vector<std::vector<int>> owner_dest(dest.size());
+    for (std::size_t i = 0; i < recv_disp.size() - 1; ++i)
+    {
+      for (int j = recv_disp[i]; j < recv_disp[i + 1]; ++j)
+      {
+        if (int owner = send_owners[j]; owner == rank)
+          submap_dest.push_back(dest[i]);
+        else if (owner != -1 and owner != dest[i])
+        {
+          auto it = std::ranges::lower_bound(dest, owner);
+          assert(it != dest.end() and *it == owner);
+          owner_dest[std::distance(dest.begin(), it)].push_back(dest[i]);
+        }
+      }
+    }
 
-    // Free the communicator
-    ierr = MPI_Comm_free(&comm1);
-    dolfinx::MPI::check_error(imap.comm(), ierr);
+    // Owners only change if allowed (on all ranks), in which case the
+    // destinations of the new owners are communicated
+    if (allow_owner_change)
+    {
+      std::vector<int> send_dest_sizes, send_dest_disp = {0};
+      std::vector<int> send_dest;
+      for (std::vector<int>& d : owner_dest)
+      {
+        std::ranges::sort(d);
+        auto [unique_end, range_end] = std::ranges::unique(d);
+        d.erase(unique_end, range_end);
+        send_dest.insert(send_dest.end(), d.begin(), d.end());
+        send_dest_sizes.push_back(d.size());
+        send_dest_disp.push_back(send_dest.size());
+      }
+
+      std::vector<int> recv_dest_sizes(src.size());
+      send_dest_sizes.reserve(1);
+      recv_dest_sizes.reserve(1);
+      ierr = MPI_Neighbor_alltoall(send_dest_sizes.data(), 1, MPI_INT,
+                                   recv_dest_sizes.data(), 1, MPI_INT,
+                                   comms[1]);
+      dolfinx::MPI::check_error(imap.comm(), ierr);
+
+      std::vector<int> recv_dest_disp(src.size() + 1, 0);
+      std::partial_sum(recv_dest_sizes.begin(), recv_dest_sizes.end(),
+                       std::next(recv_dest_disp.begin()));
+      std::vector<int> recv_dest(recv_dest_disp.back());
+      ierr = MPI_Neighbor_alltoallv(
+          send_dest.data(), send_dest_sizes.data(), send_dest_disp.data(),
+          MPI_INT, recv_dest.data(), recv_dest_sizes.data(),
+          recv_dest_disp.data(), MPI_INT, comms[1]);
+      dolfinx::MPI::check_error(imap.comm(), ierr);
+      submap_dest.insert(submap_dest.end(), recv_dest.begin(),
+                         recv_dest.end());
+    }
+
+    std::ranges::sort(submap_dest);
+    auto [unique_end, range_end] = std::ranges::unique(submap_dest);
+    submap_dest.erase(unique_end, range_end);
   }
 
   // --- Step 3 --- : Determine the owned indices, ghost indices, and
@@ -368,12 +478,6 @@ compute_submap_indices(const IndexMap& imap,
     submap_ghost = std::move(submap_ghost1);
   }
 
-  // Compute submap destination ranks
-  // FIXME Remove call to NBX
-  std::vector<int> submap_dest
-      = dolfinx::MPI::compute_graph_edges_nbx(imap.comm(), submap_src);
-  std::ranges::sort(submap_dest);
-
   return {std::move(submap_owned), std::move(submap_ghost),
           std::move(submap_ghost_owners), std::move(submap_src),
           std::move(submap_dest)};
@@ -391,6 +495,8 @@ compute_submap_indices(const IndexMap& imap,
 /// @param[in] submap_offset The global offset for this rank in the
 /// submap
 /// @param[in] imap The original index map
+/// @param[in] comms Neighbourhood communicators (ghost -> owner, owner
+/// -> ghost) for the submap source and destination ranks
 /// @pre submap_owned must be sorted and contain no repeated indices
 std::vector<std::int64_t>
 compute_submap_ghost_indices(std::span<const int> submap_src,
@@ -398,7 +504,8 @@ compute_submap_ghost_indices(std::span<const int> submap_src,
                              std::span<const std::int32_t> submap_owned,
                              std::span<const std::int64_t> submap_ghosts_global,
                              std::span<const std::int32_t> submap_ghost_owners,
-                             int submap_offset, const IndexMap& imap)
+                             std::int64_t submap_offset, const IndexMap& imap,
+                             std::array<MPI_Comm, 2> comms)
 {
   // --- Step 1 ---: Send global ghost indices (w.r.t. original imap) to
   // owning rank
@@ -406,7 +513,7 @@ compute_submap_ghost_indices(std::span<const int> submap_src,
   auto [send_indices, recv_indices, ghost_perm, send_sizes, recv_sizes,
         send_disp, recv_disp]
       = communicate_ghosts_to_owners(
-          imap.comm(), submap_src, submap_dest, submap_ghosts_global,
+          imap.comm(), comms[0], submap_src, submap_dest, submap_ghosts_global,
           submap_ghost_owners,
           std::vector<std::uint8_t>(submap_ghosts_global.size(), 1));
 
@@ -438,22 +545,11 @@ compute_submap_ghost_indices(std::span<const int> submap_src,
 
   std::vector<std::int64_t> recv_gidx(send_disp.back());
   {
-    // Create neighbourhood comm (owner -> ghost)
-    MPI_Comm comm1;
-    int ierr = MPI_Dist_graph_create_adjacent(
-        imap.comm(), submap_src.size(), submap_src.data(), MPI_UNWEIGHTED,
-        submap_dest.size(), submap_dest.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
-        false, &comm1);
-    dolfinx::MPI::check_error(imap.comm(), ierr);
-
-    // Send indices to ghosting ranks
-    ierr = MPI_Neighbor_alltoallv(send_gidx.data(), recv_sizes.data(),
-                                  recv_disp.data(), MPI_INT64_T,
-                                  recv_gidx.data(), send_sizes.data(),
-                                  send_disp.data(), MPI_INT64_T, comm1);
-    dolfinx::MPI::check_error(imap.comm(), ierr);
-
-    ierr = MPI_Comm_free(&comm1);
+    // Send indices to ghosting ranks (owner -> ghost)
+    int ierr = MPI_Neighbor_alltoallv(send_gidx.data(), recv_sizes.data(),
+                                      recv_disp.data(), MPI_INT64_T,
+                                      recv_gidx.data(), send_sizes.data(),
+                                      send_disp.data(), MPI_INT64_T, comms[1]);
     dolfinx::MPI::check_error(imap.comm(), ierr);
   }
 
@@ -520,19 +616,15 @@ common::compute_owned_indices(std::span<const std::int32_t> indices,
       it = end;
   }
 
-  // Create ghost -> owner comm
-  MPI_Comm comm;
-  int ierr = MPI_Dist_graph_create_adjacent(
-      map.comm(), dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(),
-      src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
-  dolfinx::MPI::check_error(map.comm(), ierr);
+  // Ghost -> owner comm
+  MPI_Comm comm = map.neighbourhood_comms()[0];
 
   // Exchange number of indices to send/receive from each rank
   std::vector<int> recv_sizes(dest.size(), 0);
   send_sizes.reserve(1);
   recv_sizes.reserve(1);
-  ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(),
-                               1, MPI_INT, comm);
+  int ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
+                                   recv_sizes.data(), 1, MPI_INT, comm);
   dolfinx::MPI::check_error(comm, ierr);
 
   // Prepare receive displacement array
@@ -548,8 +640,6 @@ common::compute_owned_indices(std::span<const std::int32_t> indices,
                                 recv_buffer.data(), recv_sizes.data(),
                                 recv_disp.data(), MPI_INT64_T, comm);
   dolfinx::MPI::check_error(comm, ierr);
-  ierr = MPI_Comm_free(&comm);
-  dolfinx::MPI::check_error(map.comm(), ierr);
 
   // Remove duplicates from received indices
   {
@@ -758,19 +848,31 @@ common::create_sub_index_map(const IndexMap& imap,
         submap_dest]
       = compute_submap_indices(imap, indices, order, allow_owner_change);
 
-  // Compute submap offset for this rank
-  std::int64_t submap_local_size = submap_owned.size();
-  std::int64_t submap_offset = 0;
-  int ierr = MPI_Exscan(&submap_local_size, &submap_offset, 1, MPI_INT64_T,
-                        MPI_SUM, imap.comm());
-  dolfinx::MPI::check_error(imap.comm(), ierr);
+  // Compute submap range for this rank and the submap size
+  auto [submap_range, submap_size]
+      = compute_local_range(imap.comm(), submap_owned.size());
+
+  // Share the neighbourhood communicators of the parent map if the
+  // neighbourhood is unchanged on all ranks, otherwise create them
+  std::shared_ptr<const std::array<dolfinx::MPI::Comm, 2>> comms
+      = imap._neighbourhood_comms;
+  {
+    int same = std::ranges::equal(submap_src, imap.src())
+               and std::ranges::equal(submap_dest, imap.dest());
+    int ierr = MPI_Allreduce(MPI_IN_PLACE, &same, 1, MPI_INT, MPI_LAND,
+                             imap.comm());
+    dolfinx::MPI::check_error(imap.comm(), ierr);
+    if (!same)
+      comms = create_neighbourhood_comms(imap.comm(), submap_src, submap_dest);
+  }
 
   // Compute the global indices (w.r.t. the submap) of the submap ghosts
   std::vector<std::int64_t> submap_ghost_global(submap_ghost.size());
   imap.local_to_global(submap_ghost, submap_ghost_global);
   std::vector<std::int64_t> submap_ghost_gidxs = compute_submap_ghost_indices(
       submap_src, submap_dest, submap_owned, submap_ghost_global,
-      submap_ghost_owners, submap_offset, imap);
+      submap_ghost_owners, submap_range[0], imap,
+      {(*comms)[0].comm(), (*comms)[1].comm()});
 
   // Create a map from (local) indices in the submap to the corresponding
   // (local) index in the original map
@@ -781,36 +883,20 @@ common::create_sub_index_map(const IndexMap& imap,
   sub_imap_to_imap.insert(sub_imap_to_imap.end(), submap_ghost.begin(),
                           submap_ghost.end());
 
-  return {IndexMap(imap.comm(), submap_local_size, {submap_src, submap_dest},
-                   submap_ghost_gidxs, submap_ghost_owners),
+  return {IndexMap(imap._comm, submap_range, submap_size,
+                   std::move(submap_ghost_gidxs),
+                   std::move(submap_ghost_owners), std::move(submap_src),
+                   std::move(submap_dest), comms),
           std::move(sub_imap_to_imap)};
 }
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
-IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size) : _comm(comm, true)
+IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size)
+    : _comm(std::make_shared<const dolfinx::MPI::Comm>(comm, true))
 {
-  // Get global offset (index), using partial exclusive reduction
-  std::int64_t offset = 0;
-  const std::int64_t local_size_tmp = local_size;
-  MPI_Request request_scan;
-  int ierr = MPI_Iexscan(&local_size_tmp, &offset, 1, MPI_INT64_T, MPI_SUM,
-                         _comm.comm(), &request_scan);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-  // Send local size to sum reduction to get global size
-  MPI_Request request;
-  ierr = MPI_Iallreduce(&local_size_tmp, &_size_global, 1, MPI_INT64_T, MPI_SUM,
-                        comm, &request);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-  ierr = MPI_Wait(&request_scan, MPI_STATUS_IGNORE);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-  _local_range = {offset, offset + local_size};
-
-  // Wait for the MPI_Iallreduce to complete
-  ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
+  std::tie(_local_range, _size_global)
+      = compute_local_range(_comm->comm(), local_size);
 }
 //-----------------------------------------------------------------------------
 IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size,
@@ -825,36 +911,32 @@ IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size,
                    const std::array<std::vector<int>, 2>& src_dest,
                    std::span<const std::int64_t> ghosts,
                    std::span<const int> owners)
-    : _comm(comm, true), _ghosts(ghosts.begin(), ghosts.end()),
+    : _comm(std::make_shared<const dolfinx::MPI::Comm>(comm, true)),
+      _ghosts(ghosts.begin(), ghosts.end()),
       _owners(owners.begin(), owners.end()), _src(src_dest[0]),
       _dest(src_dest[1])
 {
   assert(ghosts.size() == owners.size());
   assert(std::ranges::is_sorted(src_dest[0]));
   assert(std::ranges::is_sorted(src_dest[1]));
-
-  // Get global offset (index), using partial exclusive reduction
-  std::int64_t offset = 0;
-  const std::int64_t local_size_tmp = local_size;
-  MPI_Request request_scan;
-  int ierr = MPI_Iexscan(&local_size_tmp, &offset, 1, MPI_INT64_T, MPI_SUM,
-                         comm, &request_scan);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-  // Send local size to sum reduction to get global size
-  MPI_Request request;
-  ierr = MPI_Iallreduce(&local_size_tmp, &_size_global, 1, MPI_INT64_T, MPI_SUM,
-                        comm, &request);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-  // Wait for MPI_Iexscan to complete (get offset)
-  ierr = MPI_Wait(&request_scan, MPI_STATUS_IGNORE);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-  _local_range = {offset, offset + local_size};
-
-  // Wait for the MPI_Iallreduce to complete
-  ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
+  std::tie(_local_range, _size_global)
+      = compute_local_range(_comm->comm(), local_size);
+}
+//-----------------------------------------------------------------------------
+IndexMap::IndexMap(
+    std::shared_ptr<const dolfinx::MPI::Comm> comm,
+    std::array<std::int64_t, 2> local_range, std::int64_t size_global,
+    std::vector<std::int64_t>&& ghosts, std::vector<int>&& owners,
+    std::vector<int>&& src, std::vector<int>&& dest,
+    std::shared_ptr<const std::array<dolfinx::MPI::Comm, 2>>
+        neighbourhood_comms)
+    : _local_range(local_range), _size_global(size_global), _comm(comm),
+      _neighbourhood_comms(neighbourhood_comms), _ghosts(std::move(ghosts)),
+      _owners(std::move(owners)), _src(std::move(src)), _dest(std::move(dest))
+{
+  assert(_ghosts.size() == _owners.size());
+  assert(std::ranges::is_sorted(_src));
+  assert(std::ranges::is_sorted(_dest));
 }
 //-----------------------------------------------------------------------------
 std::array<std::int64_t, 2> IndexMap::local_range() const noexcept
@@ -896,32 +978,46 @@ void IndexMap::local_to_global(std::span<const std::int32_t> local,
 }
 //-----------------------------------------------------------------------------
 void IndexMap::global_to_local(std::span<const std::int64_t> global,
-                               std::span<std::int32_t> local) const
+                               std::span<std::int32_t> local,
+                               int num_threads) const
 {
-  const std::int32_t local_size = _local_range[1] - _local_range[0];
-  std::vector<std::pair<std::int64_t, std::int32_t>> global_to_local(
-      _ghosts.size());
-  for (std::size_t i = 0; i < _ghosts.size(); ++i)
-    global_to_local[i] = {_ghosts[i], i + local_size};
+  // Build the ghost lookup on first use. Concurrent callers may each
+  // build it, and one of the (identical) arrays is kept.
+  using lookup_t = std::vector<std::pair<std::int64_t, std::int32_t>>;
+  std::shared_ptr<const lookup_t> lookup = std::atomic_load(&_ghost_lookup);
+  if (!lookup)
+  {
+    const std::int32_t local_size = _local_range[1] - _local_range[0];
+    auto _lookup = std::make_shared<lookup_t>(_ghosts.size());
+    for (std::size_t i = 0; i < _ghosts.size(); ++i)
+      (*_lookup)[i] = {_ghosts[i], i + local_size};
+    std::ranges::sort(*_lookup);
+    lookup = _lookup;
+    std::atomic_store(&_ghost_lookup, lookup);
+  }
 
-  std::ranges::sort(global_to_local);
-  std::ranges::transform(
-      global, local.begin(),
-      [range = _local_range,
-       &global_to_local](std::int64_t index) -> std::int32_t
-      {
-        if (index >= range[0] and index < range[1])
-          return index - range[0];
-        else
+  auto translate = [range = _local_range, &ghosts = *lookup, global,
+                    local](std::size_t i0, std::size_t i1)
+  {
+    std::transform(
+        std::next(global.begin(), i0), std::next(global.begin(), i1),
+        std::next(local.begin(), i0),
+        [&](std::int64_t index) -> std::int32_t
         {
-          auto it = std::ranges::lower_bound(global_to_local, index,
-                                             std::ranges::less(),
-                                             [](auto e) { return e.first; });
-          return (it != global_to_local.end() and it->first == index)
-                     ? it->second
-                     : -1;
-        }
-      });
+          if (index >= range[0] and index < range[1])
+            return index - range[0];
+          else
+          {
+            auto it = std::ranges::lower_bound(ghosts, index,
+                                               std::ranges::less(),
+                                               [](auto e) { return e.first; });
+            return (it != ghosts.end() and it->first == index) ? it->second
+                                                               : -1;
+          }
+        });
+  };
+
+  common::parallel_for(global.size(), num_threads, translate);
 }
 //-----------------------------------------------------------------------------
 std::vector<std::int64_t> IndexMap::global_indices() const
@@ -936,19 +1032,26 @@ std::vector<std::int64_t> IndexMap::global_indices() const
   return global;
 }
 //-----------------------------------------------------------------------------
-MPI_Comm IndexMap::comm() const { return _comm.comm(); }
+MPI_Comm IndexMap::comm() const { return _comm->comm(); }
+//----------------------------------------------------------------------------
+std::array<MPI_Comm, 2> IndexMap::neighbourhood_comms() const
+{
+  if (!_neighbourhood_comms)
+  {
+    _neighbourhood_comms
+        = create_neighbourhood_comms(_comm->comm(), _src, _dest);
+  }
+
+  const std::array<dolfinx::MPI::Comm, 2>& comms = *_neighbourhood_comms;
+  return {comms[0].comm(), comms[1].comm()};
+}
 //----------------------------------------------------------------------------
 graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
 {
   const std::int64_t offset = _local_range[0];
-
-  // Build lists of src and dest ranks
-  std::vector<int> src = _owners;
-  std::ranges::sort(src);
-  auto [unique_end, range_end] = std::ranges::unique(src);
-  src.erase(unique_end, range_end);
-  auto dest = dolfinx::MPI::compute_graph_edges_nbx(_comm.comm(), src);
-  std::ranges::sort(dest);
+  std::span<const int> src = _src;
+  std::span<const int> dest = _dest;
+  const std::array<MPI_Comm, 2> comms = neighbourhood_comms();
 
   // Array (local idx, ghosting rank) pairs for owned indices
   std::vector<std::pair<std::int32_t, int>> idx_to_rank;
@@ -972,32 +1075,27 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
     std::ranges::transform(owner_to_ghost, std::back_inserter(send_buffer),
                            [](auto x) { return x.second; });
 
-    // Compute send sizes and displacements
+    // Compute send sizes and displacements for each src rank
     std::vector<int> send_sizes, send_disp{0};
     auto it = owner_to_ghost.begin();
-    while (it != owner_to_ghost.end())
+    for (int r : src)
     {
       auto it1 = std::find_if(it, owner_to_ghost.end(),
-                              [r = it->first](auto x) { return x.first != r; });
+                              [r](auto x) { return x.first != r; });
       send_sizes.push_back(std::distance(it, it1));
       send_disp.push_back(send_disp.back() + send_sizes.back());
       it = it1;
     }
+    assert(it == owner_to_ghost.end());
 
-    // Create ghost -> owner comm
-    MPI_Comm comm0;
-    int ierr = MPI_Dist_graph_create_adjacent(
-        _comm.comm(), dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(),
-        src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-    // Exchange number of indices to send/receive from each rank
+    // Exchange number of indices to send/receive from each rank (ghost
+    // -> owner)
     std::vector<int> recv_sizes(dest.size(), 0);
     send_sizes.reserve(1);
     recv_sizes.reserve(1);
-    ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
-                                 recv_sizes.data(), 1, MPI_INT, comm0);
-    dolfinx::MPI::check_error(_comm.comm(), ierr);
+    int ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
+                                     recv_sizes.data(), 1, MPI_INT, comms[0]);
+    dolfinx::MPI::check_error(_comm->comm(), ierr);
 
     // Prepare receive displacement array
     std::vector<int> recv_disp(dest.size() + 1, 0);
@@ -1009,10 +1107,8 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
     ierr = MPI_Neighbor_alltoallv(send_buffer.data(), send_sizes.data(),
                                   send_disp.data(), MPI_INT64_T,
                                   recv_buffer.data(), recv_sizes.data(),
-                                  recv_disp.data(), MPI_INT64_T, comm0);
-    dolfinx::MPI::check_error(_comm.comm(), ierr);
-    ierr = MPI_Comm_free(&comm0);
-    dolfinx::MPI::check_error(_comm.comm(), ierr);
+                                  recv_disp.data(), MPI_INT64_T, comms[0]);
+    dolfinx::MPI::check_error(_comm->comm(), ierr);
 
     // Build array of (local index, ghosting local rank), and sort
     for (std::size_t r = 0; r < recv_disp.size() - 1; ++r)
@@ -1052,7 +1148,7 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
     std::vector<std::int64_t> send_buffer;
     std::vector<int> send_sizes;
     {
-      const int rank = dolfinx::MPI::rank(_comm.comm());
+      const int rank = dolfinx::MPI::rank(_comm->comm());
       std::vector<std::vector<std::int64_t>> dest_idx_to_rank(dest.size());
       for (std::size_t n = 0; n < offsets.size() - 1; ++n)
       {
@@ -1080,21 +1176,14 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
       for (auto& d : dest_idx_to_rank)
         send_buffer.insert(send_buffer.end(), d.begin(), d.end());
 
-      // Create owner -> ghost comm
-      MPI_Comm comm;
-      int ierr = MPI_Dist_graph_create_adjacent(
-          _comm.comm(), src.size(), src.data(), MPI_UNWEIGHTED, dest.size(),
-          dest.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
-      dolfinx::MPI::check_error(_comm.comm(), ierr);
-
       // Send how many indices I ghost to each owner, and receive how
-      // many of my indices other ranks ghost
+      // many of my indices other ranks ghost (owner -> ghost)
       std::vector<int> recv_sizes(src.size(), 0);
       send_sizes.reserve(1);
       recv_sizes.reserve(1);
-      ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
-                                   recv_sizes.data(), 1, MPI_INT, comm);
-      dolfinx::MPI::check_error(_comm.comm(), ierr);
+      int ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
+                                       recv_sizes.data(), 1, MPI_INT, comms[1]);
+      dolfinx::MPI::check_error(_comm->comm(), ierr);
 
       // Prepare displacement vectors
       std::vector<int> send_disp(dest.size() + 1, 0),
@@ -1108,10 +1197,8 @@ graph::AdjacencyList<int> IndexMap::index_to_dest_ranks() const
       ierr = MPI_Neighbor_alltoallv(send_buffer.data(), send_sizes.data(),
                                     send_disp.data(), MPI_INT64_T,
                                     recv_indices.data(), recv_sizes.data(),
-                                    recv_disp.data(), MPI_INT64_T, comm);
-      dolfinx::MPI::check_error(_comm.comm(), ierr);
-      ierr = MPI_Comm_free(&comm);
-      dolfinx::MPI::check_error(_comm.comm(), ierr);
+                                    recv_disp.data(), MPI_INT64_T, comms[1]);
+      dolfinx::MPI::check_error(_comm->comm(), ierr);
 
       // Build list of (ghost index, ghost position) pairs for indices
       // ghosted by this rank, and sort
@@ -1182,19 +1269,15 @@ std::vector<std::int32_t> IndexMap::shared_indices() const
     it = it1;
   }
 
-  // Create ghost -> owner comm
-  MPI_Comm comm;
-  int ierr = MPI_Dist_graph_create_adjacent(
-      _comm.comm(), _dest.size(), _dest.data(), MPI_UNWEIGHTED, _src.size(),
-      _src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
+  // Ghost -> owner comm
+  MPI_Comm comm = neighbourhood_comms()[0];
 
   std::vector<int> recv_sizes(_dest.size(), 0);
   send_sizes.reserve(1);
   recv_sizes.reserve(1);
-  ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(),
-                               1, MPI_INT, comm);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
+  int ierr = MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT,
+                                   recv_sizes.data(), 1, MPI_INT, comm);
+  dolfinx::MPI::check_error(_comm->comm(), ierr);
 
   // Prepare receive displacement array
   std::vector<int> recv_disp(_dest.size() + 1, 0);
@@ -1207,10 +1290,7 @@ std::vector<std::int32_t> IndexMap::shared_indices() const
                                 send_disp.data(), MPI_INT64_T,
                                 recv_buffer.data(), recv_sizes.data(),
                                 recv_disp.data(), MPI_INT64_T, comm);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
-
-  ierr = MPI_Comm_free(&comm);
-  dolfinx::MPI::check_error(_comm.comm(), ierr);
+  dolfinx::MPI::check_error(_comm->comm(), ierr);
 
   std::vector<std::int32_t> shared;
   shared.reserve(recv_buffer.size());
@@ -1245,14 +1325,14 @@ std::array<double, 2> IndexMap::imbalance() const
   // Find the maximum number of owned indices and the maximum number of ghost
   // indices across all processes.
   MPI_Allreduce(local_sizes.data(), max_count.data(), 2, MPI_INT32_T, MPI_MAX,
-                _comm.comm());
+                _comm->comm());
 
   std::int32_t total_num_ghosts = 0;
   MPI_Allreduce(&local_sizes[1], &total_num_ghosts, 1, MPI_INT32_T, MPI_SUM,
-                _comm.comm());
+                _comm->comm());
 
   // Compute the average number of owned and ghost indices per process.
-  int comm_size = dolfinx::MPI::size(_comm.comm());
+  int comm_size = dolfinx::MPI::size(_comm->comm());
   double avg_owned = static_cast<double>(_size_global) / comm_size;
   double avg_ghosts = static_cast<double>(total_num_ghosts) / comm_size;
 
@@ -1266,3 +1346,15 @@ std::array<double, 2> IndexMap::imbalance() const
   return imbalance;
 }
 //-----------------------------------------------------------------------------
+MemoryUsage IndexMap::memory_usage() const
+{
+  MemoryUsage usage{"IndexMap", sizeof(*this), {}};
+  usage.add("ghosts", capacity_bytes(_ghosts));
+  usage.add("owners", capacity_bytes(_owners));
+  usage.add("src", capacity_bytes(_src));
+  usage.add("dest", capacity_bytes(_dest));
+  if (auto lookup = std::atomic_load(&_ghost_lookup); lookup)
+    usage.add("ghost lookup", capacity_bytes(*lookup));
+  return usage;
+}
+//-----------------------------------------------------------------------------
@@ -7,8 +7,10 @@
 #pragma once
 
 #include "IndexMap.h"
+#include <array>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
 #include <memory>
 #include <span>
 #include <utility>
@@ -177,9 +179,30 @@ public:
   std::span<const std::int64_t> ghosts() const noexcept;
 
   /// @brief Return the MPI communicator that the map is defined on.
+  ///
+  /// The communicator is a duplicate of the communicator that the map
+  /// was created with, and is shared with the maps created from this
+  /// map by create_sub_index_map.
   /// @return Communicator
   MPI_Comm comm() const;
 
+  /// @brief Neighbourhood communicators for the ghost exchange pattern
+  /// of the map.
+  ///
+  /// The communicators are (0) ghost -> owner, with the dest() ranks as
+  /// sources and the src() ranks as destinations, and (1) owner ->
+  /// ghost, with the src() ranks as sources and the dest() ranks as
+  /// destinations. They are created on the first call and are shared
+  /// with maps created by create_sub_index_map that have the same
+  /// neighbourhood on all ranks. The communicators are owned by the
+  /// map.
+  ///
+  /// @note Collective on the first call. Must not be called
+  /// concurrently from different threads.
+  /// @return Neighbourhood communicators (ghost -> owner, owner ->
+  /// ghost)
+  std::array<MPI_Comm, 2> neighbourhood_comms() const;
+
   /// @brief Compute global indices for array of local indices.
   /// @param[in] local Local indices
   /// @param[out] global The global indices
@@ -187,12 +210,20 @@ public:
                        std::span<std::int64_t> global) const;
 
   /// @brief Compute local indices for array of global indices.
+  ///
+  /// Ghost indices are located in a sorted lookup array that is built
+  /// on the first call and re-used by later calls. Building the array
+  /// is thread-safe, and the function can be called concurrently.
+  ///
   /// @param[in] global Global indices
   /// @param[out] local The local of the corresponding global index in
   /// 'global'. Returns -1 if the local index does not exist on this
   /// process.
+  /// @param[in] num_threads Number of threads to translate the indices
+  /// with.
   void global_to_local(std::span<const std::int64_t> global,
-                       std::span<std::int32_t> local) const;
+                       std::span<std::int32_t> local,
+                       int num_threads = 1) const;
 
   /// @brief Build list of indices with global indexing.
   /// @return The global index for all local indices `(0, 1, 2, ...)` on
@@ -251,19 +282,50 @@ public:
   /// element) and the imbalance in ghost indices (second element).
   std::array<double, 2> imbalance() const;
 
+  /// @brief Memory used by the index map.
+  /// @return Memory usage, with the ghost and neighbour rank arrays as
+  /// parts
+  MemoryUsage memory_usage() const;
+
 private:
+  friend std::pair<IndexMap, std::vector<std::int32_t>>
+  create_sub_index_map(const IndexMap& imap,
+                       std::span<const std::int32_t> indices,
+                       IndexMapOrder order, bool allow_owner_change);
+
+  // Create a map on a shared communicator with a computed local range
+  // and neighbourhood
+  IndexMap(std::shared_ptr<const dolfinx::MPI::Comm> comm,
+           std::array<std::int64_t, 2> local_range, std::int64_t size_global,
+           std::vector<std::int64_t>&& ghosts, std::vector<int>&& owners,
+           std::vector<int>&& src, std::vector<int>&& dest,
+           std::shared_ptr<const std::array<dolfinx::MPI::Comm, 2>>
+               neighbourhood_comms);
+
   // Range of indices (global) owned by this process
   std::array<std::int64_t, 2> _local_range;
 
   // Number indices across communicator
   std::int64_t _size_global;
 
-  // MPI communicator that map is defined on
-  dolfinx::MPI::Comm _comm;
+  // MPI communicator that map is defined on, shared with derived maps
+  std::shared_ptr<const dolfinx::MPI::Comm> _comm;
+
+  // Neighbourhood communicators (ghost -> owner, owner -> ghost),
+  // created on demand and shared with derived maps with the same
+  // neighbourhood
+  mutable std::shared_ptr<const std::array<dolfinx::MPI::Comm, 2>>
+      _neighbourhood_comms;
 
   // Local-to-global map for ghost indices
   std::vector<std::int64_t> _ghosts;
 
+  // Sorted (global index, local index) pairs of the ghosts, created on
+  // demand by global_to_local. Accessed atomically.
+  mutable std::shared_ptr<
+      const std::vector<std::pair<std::int64_t, std::int32_t>>>
+      _ghost_lookup;
+
   // Owning rank on _comm for the ith ghost index
   std::vector<int> _owners;
 
@@ -5,8 +5,11 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "MPI.h"
+#include "profiler.h"
 #include <dolfinx/common/log.h>
+#include <cstring>
 #include <iostream>
+#include <numeric>
 
 //-----------------------------------------------------------------------------
 dolfinx::MPI::Comm::Comm(MPI_Comm comm, bool duplicate)
@@ -94,7 +97,7 @@ void dolfinx::MPI::check_error(MPI_Comm comm, int code)
 std::vector<int>
 dolfinx::MPI::compute_graph_edges_pcx(MPI_Comm comm, std::span<const int> edges)
 {
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Computing communication graph edges (using PCX algorithm). Number "
       "of input edges: {}",
       static_cast<int>(edges.size()));
@@ -151,9 +154,10 @@ dolfinx::MPI::compute_graph_edges_pcx(MPI_Comm comm, std::span<const int> edges)
     }
   }
 
-  spdlog::info("Finished graph edge discovery using PCX algorithm. Number "
-               "of discovered edges {}",
-               static_cast<int>(other_ranks.size()));
+  DOLFINX_LOG_INFO("Finished graph edge discovery using PCX algorithm. Number "
+                   "of discovered edges {}",
+                   static_cast<int>(other_ranks.size()));
+  DOLFINX_LOG_EVENT("Graph edges (PCX)", other_ranks.size());
 
   return other_ranks;
 }
@@ -161,11 +165,20 @@ dolfinx::MPI::compute_graph_edges_pcx(MPI_Comm comm, std::span<const int> edges)
 std::vector<int>
 dolfinx::MPI::compute_graph_edges_nbx(MPI_Comm comm, std::span<const int> edges)
 {
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Computing communication graph edges (using NBX algorithm). Number "
       "of input edges: {}",
       static_cast<int>(edges.size()));
 
+  const bool record_comm = common::profiler::comm_enabled();
+  if (record_comm)
+  {
+    std::vector<std::int32_t> counts(edges.size(), 1);
+    common::profiler::record_send("MPI::compute_graph_edges_nbx", edges,
+                                  counts, 1, 0);
+  }
+  const double t0 = record_comm ? MPI_Wtime() : 0;
+
   // Start non-blocking synchronised send
   std::vector<MPI_Request> send_requests(edges.size());
   std::vector<std::byte> send_buffer(edges.size());
@@ -232,10 +245,284 @@ dolfinx::MPI::compute_graph_edges_nbx(MPI_Comm comm, std::span<const int> edges)
     }
   }
 
-  spdlog::info("Finished graph edge discovery using NBX algorithm. Number "
-               "of discovered edges {}",
-               static_cast<int>(other_ranks.size()));
+  if (record_comm)
+  {
+    common::profiler::record_wait("MPI::compute_graph_edges_nbx",
+                                  MPI_Wtime() - t0);
+  }
+
+  DOLFINX_LOG_INFO("Finished graph edge discovery using NBX algorithm. Number "
+                   "of discovered edges {}",
+                   static_cast<int>(other_ranks.size()));
+  DOLFINX_LOG_EVENT("Graph edges (NBX)", other_ranks.size());
 
   return other_ranks;
 }
 //-----------------------------------------------------------------------------
+namespace
+{
+// Routing used by the data distribution functions by default
+dolfinx::MPI::Routing routing_default = dolfinx::MPI::Routing::direct;
+} // namespace
+//-----------------------------------------------------------------------------
+void dolfinx::MPI::set_default_routing(Routing routing)
+{
+  routing_default = routing;
+}
+//-----------------------------------------------------------------------------
+dolfinx::MPI::Routing dolfinx::MPI::default_routing()
+{
+  return routing_default;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<int>, std::vector<std::byte>>
+dolfinx::MPI::route_via_nodes(MPI_Comm comm, std::span<const int> dest,
+                              std::span<const std::byte> data,
+                              std::size_t item_size)
+{
+  assert(data.size() == dest.size() * item_size);
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Communicator for the ranks on a shared memory node, ordered by
+  // rank, and communicator for the node leaders (lowest rank on each
+  // node)
+  MPI_Comm node_comm;
+  int err = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                                MPI_INFO_NULL, &node_comm);
+  dolfinx::MPI::check_error(comm, err);
+  const int node_rank = dolfinx::MPI::rank(node_comm);
+  const int node_size = dolfinx::MPI::size(node_comm);
+  MPI_Comm leader_comm;
+  err = MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+                       &leader_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  // Items are sent with their source and destination rank
+  const std::size_t staged_size = item_size + 2 * sizeof(int);
+  MPI_Datatype item_type;
+  MPI_Type_contiguous(staged_size, MPI_BYTE, &item_type);
+  MPI_Type_commit(&item_type);
+  auto item_src = [staged_size](const std::byte* items, std::size_t i)
+  {
+    int r;
+    std::memcpy(&r, items + i * staged_size, sizeof(int));
+    return r;
+  };
+  auto item_dest = [staged_size](const std::byte* items, std::size_t i)
+  {
+    int r;
+    std::memcpy(&r, items + i * staged_size + sizeof(int), sizeof(int));
+    return r;
+  };
+
+  std::vector<std::byte> send_buffer(dest.size() * staged_size);
+  for (std::size_t i = 0; i < dest.size(); ++i)
+  {
+    std::byte* item = send_buffer.data() + i * staged_size;
+    std::memcpy(item, &rank, sizeof(int));
+    std::memcpy(item + sizeof(int), &dest[i], sizeof(int));
+    std::memcpy(item + 2 * sizeof(int), data.data() + i * item_size,
+                item_size);
+  }
+
+  // 1. Gather the ranks of the node and the items sent from the node
+  //    on the node leader
+  std::vector<int> node_ranks(node_rank == 0 ? node_size : 0);
+  err = MPI_Gather(&rank, 1, MPI_INT, node_ranks.data(), 1, MPI_INT, 0,
+                   node_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  const int num_items = dest.size();
+  std::vector<int> node_counts(node_ranks.size());
+  err = MPI_Gather(&num_items, 1, MPI_INT, node_counts.data(), 1, MPI_INT, 0,
+                   node_comm);
+  dolfinx::MPI::check_error(comm, err);
+  std::vector<int> node_disp(node_counts.size() + 1, 0);
+  std::partial_sum(node_counts.begin(), node_counts.end(),
+                   std::next(node_disp.begin()));
+  std::vector<std::byte> node_items(node_disp.back() * staged_size);
+  err = MPI_Gatherv(send_buffer.data(), num_items, item_type,
+                    node_items.data(), node_counts.data(), node_disp.data(),
+                    item_type, 0, node_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  // 2. Exchange items between the node leaders, and sort the items for
+  //    this node by destination rank
+  std::vector<std::byte> scatter_items;
+  std::vector<int> scatter_counts(node_size, 0);
+  if (leader_comm != MPI_COMM_NULL)
+  {
+    // Build map from rank to node
+    const int num_nodes = dolfinx::MPI::size(leader_comm);
+    const int node = dolfinx::MPI::rank(leader_comm);
+    std::vector<int> node_sizes(num_nodes);
+    err = MPI_Allgather(&node_size, 1, MPI_INT, node_sizes.data(), 1, MPI_INT,
+                        leader_comm);
+    dolfinx::MPI::check_error(comm, err);
+    std::vector<int> node_offsets(num_nodes + 1, 0);
+    std::partial_sum(node_sizes.begin(), node_sizes.end(),
+                     std::next(node_offsets.begin()));
+    std::vector<int> ranks(node_offsets.back());
+    err = MPI_Allgatherv(node_ranks.data(), node_size, MPI_INT, ranks.data(),
+                         node_sizes.data(), node_offsets.data(), MPI_INT,
+                         leader_comm);
+    dolfinx::MPI::check_error(comm, err);
+    std::vector<int> rank_to_node(ranks.size());
+    for (int k = 0; k < num_nodes; ++k)
+    {
+      for (int j = node_offsets[k]; j < node_offsets[k + 1]; ++j)
+        rank_to_node[ranks[j]] = k;
+    }
+
+    // Sort items by destination node, keeping the order of the items
+    // for each node
+    const std::size_t num_node_items = node_disp.back();
+    std::vector<std::int32_t> perm(num_node_items);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::ranges::stable_sort(
+        perm, [&](auto a, auto b)
+        {
+          return rank_to_node[item_dest(node_items.data(), a)]
+                 < rank_to_node[item_dest(node_items.data(), b)];
+        });
+
+    // Pack items for other nodes, and keep items for this node
+    std::vector<int> dest_nodes;
+    std::vector<std::int32_t> send_counts;
+    std::vector<std::byte> send_items, local_items;
+    for (std::int32_t p : perm)
+    {
+      const std::byte* item = node_items.data() + p * staged_size;
+      const int dest_node = rank_to_node[item_dest(node_items.data(), p)];
+      if (dest_node == node)
+        local_items.insert(local_items.end(), item, item + staged_size);
+      else
+      {
+        if (dest_nodes.empty() or dest_nodes.back() != dest_node)
+        {
+          dest_nodes.push_back(dest_node);
+          send_counts.push_back(0);
+        }
+        ++send_counts.back();
+        send_items.insert(send_items.end(), item, item + staged_size);
+      }
+    }
+
+    const std::vector<int> src_nodes
+        = dolfinx::MPI::compute_graph_edges_nbx(leader_comm, dest_nodes);
+    MPI_Comm neigh_comm;
+    err = MPI_Dist_graph_create_adjacent(
+        leader_comm, src_nodes.size(), src_nodes.data(), MPI_UNWEIGHTED,
+        dest_nodes.size(), dest_nodes.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+        false, &neigh_comm);
+    dolfinx::MPI::check_error(comm, err);
+
+    const bool record_comm = common::profiler::comm_enabled();
+    if (record_comm)
+    {
+      std::vector<int> dest_leaders(dest_nodes.size());
+      std::ranges::transform(dest_nodes, dest_leaders.begin(),
+                             [&](auto k) { return ranks[node_offsets[k]]; });
+      common::profiler::record_send("MPI::route_via_nodes", dest_leaders,
+                                    send_counts, staged_size,
+                                    src_nodes.size());
+    }
+    const double t0 = record_comm ? MPI_Wtime() : 0;
+
+    std::vector<int> recv_counts(src_nodes.size());
+    send_counts.reserve(1);
+    recv_counts.reserve(1);
+    err = MPI_Neighbor_alltoall(send_counts.data(), 1, MPI_INT,
+                                recv_counts.data(), 1, MPI_INT, neigh_comm);
+    dolfinx::MPI::check_error(comm, err);
+    std::vector<int> send_disp(send_counts.size() + 1, 0);
+    std::partial_sum(send_counts.begin(), send_counts.end(),
+                     std::next(send_disp.begin()));
+    std::vector<int> recv_disp(recv_counts.size() + 1, 0);
+    std::partial_sum(recv_counts.begin(), recv_counts.end(),
+                     std::next(recv_disp.begin()));
+
+    // Received items are appended to the items for this node
+    const std::size_t num_local = local_items.size() / staged_size;
+    local_items.resize((num_local + recv_disp.back()) * staged_size);
+    err = MPI_Neighbor_alltoallv(
+        send_items.data(), send_counts.data(), send_disp.data(), item_type,
+        local_items.data() + num_local * staged_size, recv_counts.data(),
+        recv_disp.data(), item_type, neigh_comm);
+    dolfinx::MPI::check_error(comm, err);
+    if (record_comm)
+    {
+      common::profiler::record_wait("MPI::route_via_nodes",
+                                    MPI_Wtime() - t0);
+    }
+    err = MPI_Comm_free(&neigh_comm);
+    dolfinx::MPI::check_error(comm, err);
+
+    // Sort items by destination rank on this node (the node ranks are
+    // sorted)
+    const std::size_t num_recv = local_items.size() / staged_size;
+    std::vector<std::int32_t> dest_pos(num_recv);
+    for (std::size_t i = 0; i < num_recv; ++i)
+    {
+      auto it = std::ranges::lower_bound(
+          node_ranks, item_dest(local_items.data(), i));
+      assert(it != node_ranks.end());
+      dest_pos[i] = std::distance(node_ranks.begin(), it);
+      ++scatter_counts[dest_pos[i]];
+    }
+    std::vector<int> offsets(node_size + 1, 0);
+    std::partial_sum(scatter_counts.begin(), scatter_counts.end(),
+                     std::next(offsets.begin()));
+    scatter_items.resize(local_items.size());
+    for (std::size_t i = 0; i < num_recv; ++i)
+    {
+      std::copy_n(local_items.data() + i * staged_size, staged_size,
+                  scatter_items.data() + offsets[dest_pos[i]]++ * staged_size);
+    }
+
+    err = MPI_Comm_free(&leader_comm);
+    dolfinx::MPI::check_error(comm, err);
+  }
+
+  // 3. Scatter the items from the node leader to the destination ranks
+  int num_recv = 0;
+  err = MPI_Scatter(scatter_counts.data(), 1, MPI_INT, &num_recv, 1, MPI_INT,
+                    0, node_comm);
+  dolfinx::MPI::check_error(comm, err);
+  std::vector<int> scatter_disp(scatter_counts.size() + 1, 0);
+  std::partial_sum(scatter_counts.begin(), scatter_counts.end(),
+                   std::next(scatter_disp.begin()));
+  std::vector<std::byte> recv_items(num_recv * staged_size);
+  err = MPI_Scatterv(scatter_items.data(), scatter_counts.data(),
+                     scatter_disp.data(), item_type, recv_items.data(),
+                     num_recv, item_type, 0, node_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  err = MPI_Type_free(&item_type);
+  dolfinx::MPI::check_error(comm, err);
+  err = MPI_Comm_free(&node_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  // Sort received items by source rank, keeping the order of the items
+  // from each source
+  std::vector<std::int32_t> perm(num_recv);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::ranges::stable_sort(
+      perm, [&](auto a, auto b)
+      {
+        return item_src(recv_items.data(), a)
+               < item_src(recv_items.data(), b);
+      });
+
+  std::vector<int> src(num_recv);
+  std::vector<std::byte> recv_data(num_recv * item_size);
+  for (int i = 0; i < num_recv; ++i)
+  {
+    src[i] = item_src(recv_items.data(), perm[i]);
+    std::copy_n(recv_items.data() + perm[i] * staged_size + 2 * sizeof(int),
+                item_size, recv_data.data() + i * item_size);
+  }
+
+  return {std::move(src), std::move(recv_data)};
+}
+//-----------------------------------------------------------------------------
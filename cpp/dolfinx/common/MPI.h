@@ -8,13 +8,17 @@
 
 #include "Timer.h"
 #include "log.h"
+#include "profiler.h"
 #include "types.h"
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <span>
@@ -185,6 +189,52 @@ std::vector<int> compute_graph_edges_pcx(MPI_Comm comm,
 std::vector<int> compute_graph_edges_nbx(MPI_Comm comm,
                                          std::span<const int> edges);
 
+/// @brief Communication pattern for sending data between ranks in
+/// MPI::distribute_to_postoffice, MPI::distribute_from_postoffice,
+/// MPI::distribute_data and graph::build::distribute.
+enum class Routing
+{
+  direct, ///< Send data directly from each rank to its destination ranks
+  node    ///< Send data via a leader rank on each shared memory node
+};
+
+/// @brief Set the routing that is used by the data distribution
+/// functions when a routing is not passed explicitly.
+///
+/// The default is Routing::direct. The routing must be the same on all
+/// ranks of a communicator that data is distributed across.
+/// @param[in] routing Default routing
+void set_default_routing(Routing routing);
+
+/// @brief Routing that is used by the data distribution functions when
+/// a routing is not passed explicitly.
+/// @return Default routing
+Routing default_routing();
+
+/// @brief Send fixed-size items to destination ranks via node leader
+/// ranks.
+///
+/// The items sent by the ranks on a shared memory node are gathered
+/// on the lowest rank of the node (the node leader), the leaders
+/// exchange the items with the leaders of the destination nodes, and
+/// each leader scatters the items it holds to the destination ranks on
+/// its node. Each pair of nodes exchanges at most one message, so for
+/// \f$N\f$ nodes the number of off-node messages is at most
+/// \f$O(N^2)\f$, independent of the number of ranks per node.
+///
+/// @note Collective
+///
+/// @param[in] comm MPI communicator
+/// @param[in] dest Destination rank of each item
+/// @param[in] data Items to send, `item_size` bytes per item
+/// @param[in] item_size Size of an item in bytes
+/// @return (0) Source rank of each received item and (1) the received
+/// items. Items are sorted by source rank, and items from the same
+/// source are in the order in which they were sent.
+std::pair<std::vector<int>, std::vector<std::byte>>
+route_via_nodes(MPI_Comm comm, std::span<const int> dest,
+                std::span<const std::byte> data, std::size_t item_size);
+
 /// @brief Distribute row data to 'post office' ranks.
 ///
 /// This function takes row-wise data that is distributed across
@@ -201,6 +251,7 @@ std::vector<int> compute_graph_edges_nbx(MPI_Comm comm,
 /// @param[in] rank_offset The rank offset such that global index of
 /// local row `i` in `x` is `rank_offset + i`. It is usually computed
 /// using `MPI_Exscan`.
+/// @param[in] routing Communication pattern used to send the rows.
 /// @returns (0) local indices of my post office data and (1) the data
 /// (row-major). It **does not** include rows that are in `x`, i.e. rows
 /// for which the calling process is the post office.
@@ -209,7 +260,8 @@ std::pair<std::vector<std::int32_t>,
           std::vector<typename std::remove_reference_t<typename U::value_type>>>
 distribute_to_postoffice(MPI_Comm comm, const U& x,
                          std::array<std::int64_t, 2> shape,
-                         std::int64_t rank_offset);
+                         std::int64_t rank_offset,
+                         Routing routing = default_routing());
 
 /// @brief Distribute rows of a rectangular data array from post office
 /// ranks to ranks where they are required.
@@ -230,13 +282,16 @@ distribute_to_postoffice(MPI_Comm comm, const U& x,
 /// @param[in] rank_offset The rank offset such that global index of
 /// local row `i` in `x` is `rank_offset + i`. It is usually computed
 /// using `MPI_Exscan` on `comm1` from MPI::distribute_data.
+/// @param[in] routing Communication pattern used to send requests and
+/// rows.
 /// @return The data for each index in `indices` (row-major storage).
 /// @pre `shape1 > 0`.
 template <typename U>
 std::vector<typename std::remove_reference_t<typename U::value_type>>
 distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
                            const U& x, std::array<std::int64_t, 2> shape,
-                           std::int64_t rank_offset);
+                           std::int64_t rank_offset,
+                           Routing routing = default_routing());
 
 /// @brief Distribute rows of a rectangular data array to ranks where
 /// they are required (scalable version).
@@ -256,12 +311,15 @@ distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
 /// rows is assumed to be the local index plus the offset for this rank
 /// on `comm1`.
 /// @param[in] shape1 The number of columns of the data array `x`.
+/// @param[in] routing Communication pattern used to send requests and
+/// rows.
 /// @return The data for each index in `indices` (row-major storage).
 /// @pre `shape1 > 0`
 template <typename U>
 std::vector<typename std::remove_reference_t<typename U::value_type>>
 distribute_data(MPI_Comm comm0, std::span<const std::int64_t> indices,
-                MPI_Comm comm1, const U& x, int shape1);
+                MPI_Comm comm1, const U& x, int shape1,
+                Routing routing = default_routing());
 
 template <typename T>
 struct dependent_false : std::false_type
@@ -298,6 +356,8 @@ constexpr MPI_Datatype mpi_type()
     return MPI_C_BOOL;
   else if constexpr (std::is_same_v<T, std::int8_t>)
     return MPI_INT8_T;
+  else if constexpr (std::is_same_v<T, char>)
+    return MPI_CHAR;
   else
     // Issue compile time error
     static_assert(!std::is_same_v<T, T>);
@@ -309,7 +369,7 @@ std::pair<std::vector<std::int32_t>,
           std::vector<typename std::remove_reference_t<typename U::value_type>>>
 distribute_to_postoffice(MPI_Comm comm, const U& x,
                          std::array<std::int64_t, 2> shape,
-                         std::int64_t rank_offset)
+                         std::int64_t rank_offset, Routing routing)
 {
   assert(rank_offset >= 0 or x.empty());
   using T = typename std::remove_reference_t<typename U::value_type>;
@@ -319,7 +379,49 @@ distribute_to_postoffice(MPI_Comm comm, const U& x,
   assert(x.size() % shape[1] == 0);
   const std::int32_t shape0_local = x.size() / shape[1];
 
-  spdlog::debug("Sending data to post offices (distribute_to_postoffice)");
+  DOLFINX_LOG_DEBUG("Sending data to post offices (distribute_to_postoffice)");
+
+  if (routing == Routing::node)
+  {
+    // Pack (global index, row) items for rows that don't belong to
+    // this rank and send via the node leaders
+    const std::size_t item_size = sizeof(std::int64_t) + shape[1] * sizeof(T);
+    std::vector<int> dest;
+    std::vector<std::byte> send_buffer;
+    for (std::int32_t i = 0; i < shape0_local; ++i)
+    {
+      std::int64_t idx = i + rank_offset;
+      if (int d = MPI::index_owner(size, idx, shape[0]); d != rank)
+      {
+        dest.push_back(d);
+        std::size_t pos = send_buffer.size();
+        send_buffer.resize(pos + item_size);
+        std::memcpy(send_buffer.data() + pos, &idx, sizeof(std::int64_t));
+        std::memcpy(send_buffer.data() + pos + sizeof(std::int64_t),
+                    std::to_address(std::next(x.begin(), i * shape[1])),
+                    shape[1] * sizeof(T));
+      }
+    }
+
+    auto [src, recv_buffer]
+        = MPI::route_via_nodes(comm, dest, send_buffer, item_size);
+
+    // Unpack local indices and data
+    const std::int64_t r0 = MPI::local_range(rank, shape[0], size)[0];
+    std::vector<std::int32_t> index_local(src.size());
+    std::vector<T> recv_buffer_data(shape[1] * src.size());
+    for (std::size_t i = 0; i < src.size(); ++i)
+    {
+      const std::byte* item = recv_buffer.data() + i * item_size;
+      std::int64_t idx;
+      std::memcpy(&idx, item, sizeof(std::int64_t));
+      index_local[i] = idx - r0;
+      std::memcpy(recv_buffer_data.data() + i * shape[1],
+                  item + sizeof(std::int64_t), shape[1] * sizeof(T));
+    }
+
+    return {index_local, recv_buffer_data};
+  }
 
   // Post office ranks will receive data from this rank
   std::vector<int> row_to_dest(shape0_local);
@@ -374,9 +476,10 @@ distribute_to_postoffice(MPI_Comm comm, const U& x,
 
   // Determine source ranks
   const std::vector<int> src = MPI::compute_graph_edges_nbx(comm, dest);
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Number of neighbourhood source ranks in distribute_to_postoffice: {}",
       static_cast<int>(src.size()));
+  DOLFINX_LOG_EVENT("Post office source ranks", src.size());
 
   // Create neighbourhood communicator for sending data to post offices
   MPI_Comm neigh_comm;
@@ -408,6 +511,15 @@ distribute_to_postoffice(MPI_Comm comm, const U& x,
     }
   }
 
+  const bool record_comm = common::profiler::comm_enabled();
+  if (record_comm)
+  {
+    common::profiler::record_send(
+        "MPI::distribute_to_postoffice", dest, num_items_per_dest,
+        sizeof(std::int64_t) + shape[1] * sizeof(T), src.size());
+  }
+  const double t0 = record_comm ? MPI_Wtime() : 0;
+
   // Send number of items to post offices (destination) that I will be
   // sending
   std::vector<int> num_items_recv(src.size());
@@ -440,12 +552,17 @@ distribute_to_postoffice(MPI_Comm comm, const U& x,
       compound_type, recv_buffer_data.data(), num_items_recv.data(),
       recv_disp.data(), compound_type, neigh_comm);
   dolfinx::MPI::check_error(comm, err);
+  if (record_comm)
+  {
+    common::profiler::record_wait("MPI::distribute_to_postoffice",
+                                  MPI_Wtime() - t0);
+  }
   err = MPI_Type_free(&compound_type);
   dolfinx::MPI::check_error(comm, err);
   err = MPI_Comm_free(&neigh_comm);
   dolfinx::MPI::check_error(comm, err);
 
-  spdlog::debug("Completed send data to post offices.");
+  DOLFINX_LOG_DEBUG("Completed send data to post offices.");
 
   // Convert to local indices
   const std::int64_t r0 = MPI::local_range(rank, shape[0], size)[0];
@@ -460,7 +577,7 @@ template <typename U>
 std::vector<typename std::remove_reference_t<typename U::value_type>>
 distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
                            const U& x, std::array<std::int64_t, 2> shape,
-                           std::int64_t rank_offset)
+                           std::int64_t rank_offset, Routing routing)
 {
   assert(rank_offset >= 0 or x.empty());
   using T = typename std::remove_reference_t<typename U::value_type>;
@@ -478,9 +595,41 @@ distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
   // Send receive x data to post office (only for rows that need to be
   // communicated)
   auto [post_indices, post_x] = dolfinx::MPI::distribute_to_postoffice(
-      comm, x, {shape[0], shape[1]}, rank_offset);
+      comm, x, {shape[0], shape[1]}, rank_offset, routing);
   assert(post_indices.size() == post_x.size() / shape[1]);
 
+  // Build map from local index to post_indices position. Set to -1 for
+  // data that was already on this rank and was therefore was not
+  // sent/received via a postoffice.
+  const std::array<std::int64_t, 2> postoffice_range
+      = dolfinx::MPI::local_range(rank, shape[0], size);
+  std::vector<std::int32_t> post_indices_map(
+      postoffice_range[1] - postoffice_range[0], -1);
+  for (std::size_t i = 0; i < post_indices.size(); ++i)
+  {
+    assert(post_indices[i] < (int)post_indices_map.size());
+    post_indices_map[post_indices[i]] = i;
+  }
+
+  // Row of x with global index `index`, for which this rank either
+  // holds the row in x or is the post office
+  auto row = [&](std::int64_t index) -> const T*
+  {
+    if (index >= rank_offset and index < (rank_offset + shape0_local))
+    {
+      // I had this index before any communication
+      return std::to_address(
+          std::next(x.begin(), shape[1] * (index - rank_offset)));
+    }
+    else
+    {
+      // Take from my 'post bag'
+      std::int32_t pos = post_indices_map[index - postoffice_range[0]];
+      assert(pos != -1);
+      return post_x.data() + shape[1] * pos;
+    }
+  };
+
   // 1. Send request to post office ranks for data
 
   // Build list of (src, global index, global, index position) for each
@@ -494,140 +643,164 @@ distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
   }
   std::ranges::sort(src_to_index);
 
-  // Build list is neighbour src ranks and count number of items (rows
-  // of x) to receive from each src post office (by neighbourhood rank)
-  std::vector<std::int32_t> num_items_per_src;
-  std::vector<int> src;
+  std::vector<T> recv_buffer_data;
+  if (routing == Routing::node)
   {
-    auto it = src_to_index.begin();
-    while (it != src_to_index.end())
+    // Send requested global indices to the post offices via the node
+    // leaders
+    std::vector<int> src(src_to_index.size());
+    std::vector<std::byte> send_buffer(src_to_index.size()
+                                       * sizeof(std::int64_t));
+    for (std::size_t i = 0; i < src_to_index.size(); ++i)
     {
-      src.push_back(std::get<0>(*it));
-      auto it1
-          = std::find_if(it, src_to_index.end(), [r = src.back()](auto& idx)
-                         { return std::get<0>(idx) != r; });
-      num_items_per_src.push_back(std::distance(it, it1));
-      it = it1;
+      src[i] = std::get<0>(src_to_index[i]);
+      std::memcpy(send_buffer.data() + i * sizeof(std::int64_t),
+                  &std::get<1>(src_to_index[i]), sizeof(std::int64_t));
     }
+    auto [dest, recv_buffer_index] = MPI::route_via_nodes(
+        comm, src, send_buffer, sizeof(std::int64_t));
+
+    // Send requested rows back. Replies from each post office arrive in
+    // the order of the requests, i.e. in the order of src_to_index.
+    const std::size_t item_size = shape[1] * sizeof(T);
+    send_buffer.resize(dest.size() * item_size);
+    for (std::size_t i = 0; i < dest.size(); ++i)
+    {
+      std::int64_t index;
+      std::memcpy(&index, recv_buffer_index.data() + i * sizeof(std::int64_t),
+                  sizeof(std::int64_t));
+      std::memcpy(send_buffer.data() + i * item_size, row(index), item_size);
+    }
+    auto [reply_src, recv_buffer]
+        = MPI::route_via_nodes(comm, dest, send_buffer, item_size);
+    assert(reply_src.size() == src_to_index.size());
+    recv_buffer_data.resize(shape[1] * reply_src.size());
+    std::memcpy(recv_buffer_data.data(), recv_buffer.data(),
+                recv_buffer.size());
   }
-
-  // Determine 'delivery' destination ranks (ranks that want data from
-  // me)
-  const std::vector<int> dest
-      = dolfinx::MPI::compute_graph_edges_nbx(comm, src);
-  spdlog::info(
-      "Neighbourhood destination ranks from post office in "
-      "distribute_data (rank, num dests, num dests/mpi_size): {}, {}, {}",
-      rank, static_cast<int>(dest.size()),
-      static_cast<double>(dest.size()) / size);
-
-  // Create neighbourhood communicator for sending data to post offices
-  // (src), and receiving data form my send my post office
-  MPI_Comm neigh_comm0;
-  int err = MPI_Dist_graph_create_adjacent(
-      comm, dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(), src.data(),
-      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
-
-  // Communicate number of requests to each source
-  std::vector<int> num_items_recv(dest.size());
-  num_items_per_src.reserve(1);
-  num_items_recv.reserve(1);
-  err = MPI_Neighbor_alltoall(num_items_per_src.data(), 1, MPI_INT,
-                              num_items_recv.data(), 1, MPI_INT, neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
-
-  // Prepare send/receive displacements
-  std::vector<std::int32_t> send_disp = {0};
-  std::partial_sum(num_items_per_src.begin(), num_items_per_src.end(),
-                   std::back_inserter(send_disp));
-  std::vector<std::int32_t> recv_disp = {0};
-  std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                   std::back_inserter(recv_disp));
-
-  // Pack my requested indices (global) in send buffer ready to send to
-  // post offices
-  assert(send_disp.back() == (int)src_to_index.size());
-  std::vector<std::int64_t> send_buffer_index(src_to_index.size());
-  std::ranges::transform(src_to_index, send_buffer_index.begin(),
-                         [](auto x) { return std::get<1>(x); });
-
-  // Prepare the receive buffer
-  std::vector<std::int64_t> recv_buffer_index(recv_disp.back());
-  err = MPI_Neighbor_alltoallv(
-      send_buffer_index.data(), num_items_per_src.data(), send_disp.data(),
-      MPI_INT64_T, recv_buffer_index.data(), num_items_recv.data(),
-      recv_disp.data(), MPI_INT64_T, neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
-
-  err = MPI_Comm_free(&neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
-
-  // 2. Send data (rows of x) from post office back to requesting ranks
-  //    (transpose of the preceding communication pattern operation)
-
-  // Build map from local index to post_indices position. Set to -1 for
-  // data that was already on this rank and was therefore was not
-  // sent/received via a postoffice.
-  const std::array<std::int64_t, 2> postoffice_range
-      = dolfinx::MPI::local_range(rank, shape[0], size);
-  std::vector<std::int32_t> post_indices_map(
-      postoffice_range[1] - postoffice_range[0], -1);
-  for (std::size_t i = 0; i < post_indices.size(); ++i)
-  {
-    assert(post_indices[i] < (int)post_indices_map.size());
-    post_indices_map[post_indices[i]] = i;
-  }
-
-  // Build send buffer
-  std::vector<T> send_buffer_data(shape[1] * recv_disp.back());
-  for (std::size_t p = 0; p < recv_disp.size() - 1; ++p)
+  else
   {
-    int offset = recv_disp[p];
-    for (std::int32_t i = recv_disp[p]; i < recv_disp[p + 1]; ++i)
+    // Build list is neighbour src ranks and count number of items (rows
+    // of x) to receive from each src post office (by neighbourhood rank)
+    std::vector<std::int32_t> num_items_per_src;
+    std::vector<int> src;
     {
-      std::int64_t index = recv_buffer_index[i];
-      if (index >= rank_offset and index < (rank_offset + shape0_local))
-      {
-        // I already had this index before any communication
-        std::int32_t local_index = index - rank_offset;
-        std::copy_n(std::next(x.begin(), shape[1] * local_index), shape[1],
-                    std::next(send_buffer_data.begin(), shape[1] * offset));
-      }
-      else
+      auto it = src_to_index.begin();
+      while (it != src_to_index.end())
       {
-        // Take from my 'post bag'
-        auto local_index = index - postoffice_range[0];
-        std::int32_t pos = post_indices_map[local_index];
-        assert(pos != -1);
-        std::copy_n(std::next(post_x.begin(), shape[1] * pos), shape[1],
-                    std::next(send_buffer_data.begin(), shape[1] * offset));
+        src.push_back(std::get<0>(*it));
+        auto it1
+            = std::find_if(it, src_to_index.end(), [r = src.back()](auto& idx)
+                           { return std::get<0>(idx) != r; });
+        num_items_per_src.push_back(std::distance(it, it1));
+        it = it1;
       }
+    }
 
-      ++offset;
+    // Determine 'delivery' destination ranks (ranks that want data from
+    // me)
+    const std::vector<int> dest
+        = dolfinx::MPI::compute_graph_edges_nbx(comm, src);
+    DOLFINX_LOG_INFO(
+        "Neighbourhood destination ranks from post office in "
+        "distribute_data (rank, num dests, num dests/mpi_size): {}, {}, {}",
+        rank, static_cast<int>(dest.size()),
+        static_cast<double>(dest.size()) / size);
+
+    // Create neighbourhood communicator for sending data to post offices
+    // (src), and receiving data form my send my post office
+    MPI_Comm neigh_comm0;
+    int err = MPI_Dist_graph_create_adjacent(
+        comm, dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(), src.data(),
+        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+
+    const bool record_comm = common::profiler::comm_enabled();
+    double t0 = record_comm ? MPI_Wtime() : 0;
+
+    // Communicate number of requests to each source
+    std::vector<int> num_items_recv(dest.size());
+    num_items_per_src.reserve(1);
+    num_items_recv.reserve(1);
+    err = MPI_Neighbor_alltoall(num_items_per_src.data(), 1, MPI_INT,
+                                num_items_recv.data(), 1, MPI_INT, neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+
+    // Prepare send/receive displacements
+    std::vector<std::int32_t> send_disp = {0};
+    std::partial_sum(num_items_per_src.begin(), num_items_per_src.end(),
+                     std::back_inserter(send_disp));
+    std::vector<std::int32_t> recv_disp = {0};
+    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
+                     std::back_inserter(recv_disp));
+
+    // Pack my requested indices (global) in send buffer ready to send to
+    // post offices
+    assert(send_disp.back() == (int)src_to_index.size());
+    std::vector<std::int64_t> send_buffer_index(src_to_index.size());
+    std::ranges::transform(src_to_index, send_buffer_index.begin(),
+                           [](auto x) { return std::get<1>(x); });
+
+    // Prepare the receive buffer
+    std::vector<std::int64_t> recv_buffer_index(recv_disp.back());
+    err = MPI_Neighbor_alltoallv(
+        send_buffer_index.data(), num_items_per_src.data(), send_disp.data(),
+        MPI_INT64_T, recv_buffer_index.data(), num_items_recv.data(),
+        recv_disp.data(), MPI_INT64_T, neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+    if (record_comm)
+    {
+      common::profiler::record_send("MPI::distribute_from_postoffice", src,
+                                    num_items_per_src, sizeof(std::int64_t),
+                                    dest.size());
+      common::profiler::record_wait("MPI::distribute_from_postoffice",
+                                    MPI_Wtime() - t0);
     }
-  }
 
-  err = MPI_Dist_graph_create_adjacent(
-      comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
-      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
+    err = MPI_Comm_free(&neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
 
-  MPI_Datatype compound_type0;
-  MPI_Type_contiguous(shape[1], dolfinx::MPI::mpi_type<T>(), &compound_type0);
-  MPI_Type_commit(&compound_type0);
+    // 2. Send data (rows of x) from post office back to requesting ranks
+    //    (transpose of the preceding communication pattern operation)
 
-  std::vector<T> recv_buffer_data(shape[1] * send_disp.back());
-  err = MPI_Neighbor_alltoallv(
-      send_buffer_data.data(), num_items_recv.data(), recv_disp.data(),
-      compound_type0, recv_buffer_data.data(), num_items_per_src.data(),
-      send_disp.data(), compound_type0, neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
+    // Build send buffer
+    std::vector<T> send_buffer_data(shape[1] * recv_disp.back());
+    for (std::int32_t i = 0; i < recv_disp.back(); ++i)
+    {
+      std::copy_n(row(recv_buffer_index[i]), shape[1],
+                  std::next(send_buffer_data.begin(), shape[1] * i));
+    }
 
-  err = MPI_Type_free(&compound_type0);
-  dolfinx::MPI::check_error(comm, err);
-  err = MPI_Comm_free(&neigh_comm0);
-  dolfinx::MPI::check_error(comm, err);
+    err = MPI_Dist_graph_create_adjacent(
+        comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
+        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+
+    MPI_Datatype compound_type0;
+    MPI_Type_contiguous(shape[1], dolfinx::MPI::mpi_type<T>(), &compound_type0);
+    MPI_Type_commit(&compound_type0);
+
+    recv_buffer_data.resize(shape[1] * send_disp.back());
+    t0 = record_comm ? MPI_Wtime() : 0;
+    err = MPI_Neighbor_alltoallv(
+        send_buffer_data.data(), num_items_recv.data(), recv_disp.data(),
+        compound_type0, recv_buffer_data.data(), num_items_per_src.data(),
+        send_disp.data(), compound_type0, neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+    if (record_comm)
+    {
+      common::profiler::record_send("MPI::distribute_from_postoffice", dest,
+                                    num_items_recv, shape[1] * sizeof(T),
+                                    src.size());
+      common::profiler::record_wait("MPI::distribute_from_postoffice",
+                                    MPI_Wtime() - t0);
+    }
+
+    err = MPI_Type_free(&compound_type0);
+    dolfinx::MPI::check_error(comm, err);
+    err = MPI_Comm_free(&neigh_comm0);
+    dolfinx::MPI::check_error(comm, err);
+  }
 
   std::vector<std::int32_t> index_pos_to_buffer(indices.size(), -1);
   for (std::size_t i = 0; i < src_to_index.size(); ++i)
@@ -674,7 +847,7 @@ distribute_from_postoffice(MPI_Comm comm, std::span<const std::int64_t> indices,
 template <typename U>
 std::vector<typename std::remove_reference_t<typename U::value_type>>
 distribute_data(MPI_Comm comm0, std::span<const std::int64_t> indices,
-                MPI_Comm comm1, const U& x, int shape1)
+                MPI_Comm comm1, const U& x, int shape1, Routing routing)
 {
   assert(shape1 > 0);
   assert(x.size() % shape1 == 0);
@@ -701,7 +874,7 @@ distribute_data(MPI_Comm comm0, std::span<const std::int64_t> indices,
   }
 
   return distribute_from_postoffice(comm0, indices, x, {shape0, shape1},
-                                    rank_offset);
+                                    rank_offset, routing);
 }
 //---------------------------------------------------------------------------
 
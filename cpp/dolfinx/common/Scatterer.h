@@ -8,6 +8,8 @@
 
 #include "IndexMap.h"
 #include "MPI.h"
+#include "memory.h"
+#include "profiler.h"
 #include "sort.h"
 #include <algorithm>
 #include <functional>
@@ -38,8 +40,12 @@ public:
   /// Types of MPI communication pattern used by the Scatterer.
   enum class type
   {
-    neighbor, // use MPI neighborhood collectives
-    p2p       // use MPI Isend/Irecv for communication
+    neighbor,   // use MPI neighborhood collectives
+    p2p,        // use MPI Isend/Irecv for communication
+    persistent, // use persistent MPI requests for fixed buffers
+    shared      // access the data of ranks on the same node directly in
+                // a shared memory window, and use MPI Isend/Irecv for
+                // other ranks
   };
 
   /// @brief Create a scatterer.
@@ -48,127 +54,40 @@ public:
   /// @param[in] bs The block size of data associated with each index in
   /// `map` that will be scattered/gathered.
   /// @param[in] alloc The memory allocator for indices.
-  Scatterer(const IndexMap& map, int bs, const Allocator& alloc = Allocator())
-      : _bs(bs), _remote_inds(0, alloc), _local_inds(0, alloc),
-        _src(map.src().begin(), map.src().end()),
-        _dest(map.dest().begin(), map.dest().end())
+  /// @param[in] shared_memory If true, the positions of the ghost data
+  /// in the arrays of neighbours on the same node are computed, which
+  /// is required for Scatterer::type::shared. Collective.
+  Scatterer(const IndexMap& map, int bs, const Allocator& alloc = Allocator(),
+            bool shared_memory = false)
+      : Scatterer(map, bs, full_pattern(map), alloc, shared_memory)
   {
-    if (dolfinx::MPI::size(map.comm()) == 1)
-      return;
-
-    // Check that src and dest ranks are unique and sorted
-    assert(std::ranges::is_sorted(_src));
-    assert(std::ranges::is_sorted(_dest));
-
-    // Create communicators with directed edges:
-    // (0) owner -> ghost,
-    // (1) ghost -> owner
-    MPI_Comm comm0;
-    MPI_Dist_graph_create_adjacent(
-        map.comm(), _src.size(), _src.data(), MPI_UNWEIGHTED, _dest.size(),
-        _dest.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    _comm0 = dolfinx::MPI::Comm(comm0, false);
-
-    MPI_Comm comm1;
-    MPI_Dist_graph_create_adjacent(
-        map.comm(), _dest.size(), _dest.data(), MPI_UNWEIGHTED, _src.size(),
-        _src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm1);
-    _comm1 = dolfinx::MPI::Comm(comm1, false);
-
-    // Build permutation array that sorts ghost indices by owning rank
-    std::span owners = map.owners();
-    std::vector<std::int32_t> perm(owners.size());
-    std::iota(perm.begin(), perm.end(), 0);
-    dolfinx::radix_sort(perm, [&owners](auto index) { return owners[index]; });
-
-    // Sort (i) ghost indices and (ii) ghost index owners by rank
-    // (using perm array)
-    std::span ghosts = map.ghosts();
-    std::vector<int> owners_sorted(owners.size());
-    std::vector<std::int64_t> ghosts_sorted(owners.size());
-    std::ranges::transform(perm, owners_sorted.begin(),
-                           [&owners](auto idx) { return owners[idx]; });
-    std::ranges::transform(perm, ghosts_sorted.begin(),
-                           [&ghosts](auto idx) { return ghosts[idx]; });
-
-    // For data associated with ghost indices, packed by owning
-    // (neighbourhood) rank, compute sizes and displacements. I.e.,
-    // when sending ghost index data from this rank to the owning
-    // ranks, disp[i] is the first entry in the buffer sent to
-    // neighbourhood rank i, and disp[i + 1] - disp[i] is the number
-    // of values sent to rank i.
-    _sizes_remote.resize(_src.size(), 0);
-    _displs_remote.resize(_src.size() + 1, 0);
-    std::vector<std::int32_t>::iterator begin = owners_sorted.begin();
-    for (std::size_t i = 0; i < _src.size(); i++)
-    {
-      auto upper = std::upper_bound(begin, owners_sorted.end(), _src[i]);
-      int num_ind = std::distance(begin, upper);
-      _displs_remote[i + 1] = _displs_remote[i] + num_ind;
-      _sizes_remote[i] = num_ind;
-      begin = upper;
-    }
-
-    // For data associated with owned indices that are ghosted by
-    // other ranks, compute the size and displacement arrays. When
-    // sending data associated with ghost indices to the owner, these
-    // size and displacement arrays are for the receive buffer.
-
-    // Compute sizes and displacements of local data (how many local
-    // elements to be sent/received grouped by neighbors)
-    _sizes_local.resize(_dest.size());
-    _displs_local.resize(_sizes_local.size() + 1);
-    _sizes_remote.reserve(1);
-    _sizes_local.reserve(1);
-    MPI_Neighbor_alltoall(_sizes_remote.data(), 1, MPI_INT32_T,
-                          _sizes_local.data(), 1, MPI_INT32_T, _comm1.comm());
-    std::partial_sum(_sizes_local.begin(), _sizes_local.end(),
-                     std::next(_displs_local.begin()));
-
-    assert((std::int32_t)ghosts_sorted.size() == _displs_remote.back());
-    assert((std::int32_t)ghosts_sorted.size() == _displs_remote.back());
-
-    // Send ghost global indices to owning rank, and receive owned
-    // indices that are ghosts on other ranks
-    std::vector<std::int64_t> recv_buffer(_displs_local.back(), 0);
-    MPI_Neighbor_alltoallv(ghosts_sorted.data(), _sizes_remote.data(),
-                           _displs_remote.data(), MPI_INT64_T,
-                           recv_buffer.data(), _sizes_local.data(),
-                           _displs_local.data(), MPI_INT64_T, _comm1.comm());
-
-    const std::array<std::int64_t, 2> range = map.local_range();
-#ifndef NDEBUG
-    // Check that all received indice are within the owned range
-    std::ranges::for_each(recv_buffer, [range](auto idx)
-                          { assert(idx >= range[0] and idx < range[1]); });
-#endif
-
-    // Scale sizes and displacements by block size
-    {
-      auto rescale = [](auto& x, int bs) {
-        std::ranges::transform(x, x.begin(), [bs](auto e) { return e *= bs; });
-      };
-      rescale(_sizes_local, bs);
-      rescale(_displs_local, bs);
-      rescale(_sizes_remote, bs);
-      rescale(_displs_remote, bs);
-    }
-
-    // Expand local indices using block size and convert it from
-    // global to local numbering
-    _local_inds = std::vector<std::int32_t, allocator_type>(
-        recv_buffer.size() * _bs, alloc);
-    std::int64_t offset = range[0] * _bs;
-    for (std::size_t i = 0; i < recv_buffer.size(); i++)
-      for (int j = 0; j < _bs; j++)
-        _local_inds[i * _bs + j] = (recv_buffer[i] * _bs + j) - offset;
+  }
 
-    // Expand remote indices using block size
-    _remote_inds
-        = std::vector<std::int32_t, allocator_type>(perm.size() * _bs, alloc);
-    for (std::size_t i = 0; i < perm.size(); i++)
-      for (int j = 0; j < _bs; j++)
-        _remote_inds[i * _bs + j] = perm[i] * _bs + j;
+  /// @brief Create a scatterer for the ghosts in a subset of the
+  /// indices of an index map, e.g. the degrees-of-freedom on a coupling
+  /// interface.
+  ///
+  /// Only the data of the ghosts in the subset is communicated, and
+  /// only with the ranks that own them, so the cost of a scatter is
+  /// proportional to the size of the subset. The scatter functions take
+  /// the same arrays as for a scatterer of the full map, e.g. the owned
+  /// and ghost parts of a la::Vector, and leave the data of the other
+  /// ghosts unchanged.
+  ///
+  /// @note Collective.
+  /// @param[in] map The index map that describes the parallel layout of
+  /// data.
+  /// @param[in] bs The block size of data associated with each index in
+  /// `map` that will be scattered/gathered.
+  /// @param[in] indices Local indices of the subset on the calling rank.
+  /// Only the ghost indices are used, i.e. a ghost is updated if it is
+  /// in the subset on the rank that ghosts it, whether or not the owner
+  /// lists it.
+  /// @param[in] alloc The memory allocator for indices.
+  Scatterer(const IndexMap& map, int bs, std::span<const std::int32_t> indices,
+            const Allocator& alloc = Allocator())
+      : Scatterer(map, bs, sub_pattern(map, indices), alloc, false)
+  {
   }
 
   /// @brief Start a non-blocking send of owned data to ranks that ghost
@@ -190,7 +109,9 @@ public:
   /// @param requests The MPI request handle for tracking the status of
   /// the non-blocking communication
   /// @param[in] type The type of MPI communication pattern used by the
-  /// Scatterer, either Scatterer::type::neighbor or Scatterer::type::p2p.
+  /// Scatterer. For Scatterer::type::persistent, `requests` must have
+  /// been created by Scatterer::create_persistent_fwd_requests for the
+  /// same buffers.
   template <typename T>
   void scatter_fwd_begin(std::span<const T> send_buffer,
                          std::span<T> recv_buffer,
@@ -201,6 +122,12 @@ public:
     if (_sizes_local.empty() and _sizes_remote.empty())
       return;
 
+    if (profiler::comm_enabled())
+    {
+      profiler::record_send("Scatterer::scatter_fwd", _dest, _sizes_local,
+                            sizeof(T), _src.size());
+    }
+
     switch (type)
     {
     case type::neighbor:
@@ -231,6 +158,15 @@ public:
       }
       break;
     }
+    case type::persistent:
+    {
+      assert(requests.size() == _dest.size() + _src.size());
+      MPI_Startall(requests.size(), requests.data());
+      break;
+    }
+    case type::shared:
+      throw std::runtime_error(
+          "Scatter::type::shared requires a shared memory window");
     default:
       throw std::runtime_error("Scatter::type not recognized");
     }
@@ -251,7 +187,14 @@ public:
       return;
 
     // Wait for communication to complete
-    MPI_Waitall(requests.size(), requests.data(), MPI_STATUS_IGNORE);
+    if (profiler::comm_enabled())
+    {
+      const double t0 = MPI_Wtime();
+      MPI_Waitall(requests.size(), requests.data(), MPI_STATUS_IGNORE);
+      profiler::record_wait("Scatterer::scatter_fwd", MPI_Wtime() - t0);
+    }
+    else
+      MPI_Waitall(requests.size(), requests.data(), MPI_STATUS_IGNORE);
   }
 
   /// @brief Scatter data associated with owned indices to ghosting
@@ -317,7 +260,11 @@ public:
                        std::span<MPI_Request> requests) const
   {
     assert(remote_buffer.size() == _remote_inds.size());
-    assert(remote_data.size() == _remote_inds.size());
+    if (!_remote_inds.empty())
+    {
+      assert(*std::ranges::max_element(_remote_inds)
+             < std::int32_t(remote_data.size()));
+    }
     scatter_fwd_end(requests);
     unpack_fn(remote_buffer, _remote_inds, remote_data,
               [](T /*a*/, T b) { return b; });
@@ -360,6 +307,134 @@ public:
                     std::span<MPI_Request>(requests));
   }
 
+  /// @brief Scatter the data of the modified owned indices to the
+  /// ranks that ghost them (delta scatter).
+  ///
+  /// Only the shared entries of modified indices are sent, as pairs of
+  /// the position in the message and the value. When the fraction of
+  /// modified entries for a neighbour exceeds `threshold`, all entries
+  /// for the neighbour are sent, without positions, as in
+  /// Scatterer::scatter_fwd. The communication volume therefore follows
+  /// the modified entries rather than the size of the interface. Ghost
+  /// data of unmodified indices is not changed, so it must be up to
+  /// date, e.g. from a previous full scatter.
+  ///
+  /// @note Collective. The communication is blocking.
+  ///
+  /// @param[in] local_data All data associated with owned indices, as
+  /// in Scatterer::scatter_fwd.
+  /// @param[in,out] remote_data Data associated with the ghost indices,
+  /// as in Scatterer::scatter_fwd.
+  /// @param[in] modified Marker for each owned index (not multiplied by
+  /// the block size), non-zero if the data of the index has changed.
+  /// @param[in] threshold Fraction of modified shared entries for a
+  /// neighbour above which all entries for the neighbour are sent.
+  template <typename T>
+  void scatter_fwd_delta(std::span<const T> local_data,
+                         std::span<T> remote_data,
+                         std::span<const std::int8_t> modified,
+                         double threshold = 0.5) const
+  {
+    // Return early if there are no incoming or outgoing edges
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    // Pack the positions and values of the modified entries for each
+    // destination. The count sent to a destination is the number of
+    // modified entries, or -1 if all entries are sent.
+    std::vector<int> send_count(_dest.size()), pos_sizes(_dest.size()),
+        val_sizes(_dest.size());
+    std::vector<std::int32_t> pos;
+    std::vector<T> values;
+    for (std::size_t i = 0; i < _dest.size(); ++i)
+    {
+      const std::size_t p0 = pos.size();
+      for (int j = _displs_local[i]; j < _displs_local[i + 1]; ++j)
+      {
+        if (modified[_local_inds[j] / _bs])
+          pos.push_back(j - _displs_local[i]);
+      }
+
+      const int n = pos.size() - p0;
+      if (n > threshold * _sizes_local[i])
+      {
+        pos.resize(p0);
+        send_count[i] = -1;
+        for (int j = _displs_local[i]; j < _displs_local[i + 1]; ++j)
+          values.push_back(local_data[_local_inds[j]]);
+        val_sizes[i] = _sizes_local[i];
+      }
+      else
+      {
+        send_count[i] = n;
+        for (std::size_t k = p0; k < pos.size(); ++k)
+          values.push_back(local_data[_local_inds[_displs_local[i] + pos[k]]]);
+        val_sizes[i] = n;
+      }
+      pos_sizes[i] = pos.size() - p0;
+    }
+
+    if (profiler::comm_enabled())
+    {
+      profiler::record_send("Scatterer::scatter_fwd_delta", _dest, val_sizes,
+                            sizeof(T), _src.size());
+    }
+
+    // Exchange the counts
+    std::vector<int> recv_count(_src.size());
+    send_count.reserve(1);
+    recv_count.reserve(1);
+    MPI_Neighbor_alltoall(send_count.data(), 1, MPI_INT, recv_count.data(), 1,
+                          MPI_INT, _comm0.comm());
+
+    std::vector<int> recv_pos_sizes(_src.size()), recv_val_sizes(_src.size());
+    for (std::size_t i = 0; i < _src.size(); ++i)
+    {
+      recv_pos_sizes[i] = std::max(recv_count[i], 0);
+      recv_val_sizes[i] = recv_count[i] < 0 ? _sizes_remote[i] : recv_count[i];
+    }
+
+    auto displs = [](const std::vector<int>& sizes)
+    {
+      std::vector<int> d(sizes.size() + 1, 0);
+      std::partial_sum(sizes.begin(), sizes.end(), std::next(d.begin()));
+      return d;
+    };
+    std::vector<int> pos_displs = displs(pos_sizes);
+    std::vector<int> val_displs = displs(val_sizes);
+    std::vector<int> recv_pos_displs = displs(recv_pos_sizes);
+    std::vector<int> recv_val_displs = displs(recv_val_sizes);
+
+    // Exchange the positions and values
+    std::vector<std::int32_t> recv_pos(recv_pos_displs.back());
+    std::vector<T> recv_values(recv_val_displs.back());
+    MPI_Neighbor_alltoallv(pos.data(), pos_sizes.data(), pos_displs.data(),
+                           MPI_INT32_T, recv_pos.data(), recv_pos_sizes.data(),
+                           recv_pos_displs.data(), MPI_INT32_T, _comm0.comm());
+    MPI_Neighbor_alltoallv(values.data(), val_sizes.data(), val_displs.data(),
+                           dolfinx::MPI::mpi_type<T>(), recv_values.data(),
+                           recv_val_sizes.data(), recv_val_displs.data(),
+                           dolfinx::MPI::mpi_type<T>(), _comm0.comm());
+
+    // Unpack
+    for (std::size_t i = 0; i < _src.size(); ++i)
+    {
+      const T* v = recv_values.data() + recv_val_displs[i];
+      const std::int32_t* r = _remote_inds.data() + _displs_remote[i];
+      if (recv_count[i] < 0)
+      {
+        for (int k = 0; k < _sizes_remote[i]; ++k)
+          remote_data[r[k]] = v[k];
+      }
+      else
+      {
+        const std::int32_t* p = recv_pos.data() + recv_pos_displs[i];
+        for (int k = 0; k < recv_count[i]; ++k)
+          remote_data[r[p[k]]] = v[k];
+      }
+    }
+  }
+
   /// @brief Start a non-blocking send of ghost data to ranks that own
   /// the data.
   ///
@@ -385,7 +460,9 @@ public:
   /// @param requests The MPI request handle for tracking the status of
   /// the non-blocking communication
   /// @param[in] type The type of MPI communication pattern used by the
-  /// Scatterer, either Scatterer::type::neighbor or Scatterer::type::p2p.
+  /// Scatterer. For Scatterer::type::persistent, `requests` must have
+  /// been created by Scatterer::create_persistent_rev_requests for the
+  /// same buffers.
   template <typename T>
   void scatter_rev_begin(std::span<const T> send_buffer,
                          std::span<T> recv_buffer,
@@ -396,6 +473,12 @@ public:
     if (_sizes_local.empty() and _sizes_remote.empty())
       return;
 
+    if (profiler::comm_enabled())
+    {
+      profiler::record_send("Scatterer::scatter_rev", _src, _sizes_remote,
+                            sizeof(T), _dest.size());
+    }
+
     // // Send and receive data
 
     switch (type)
@@ -431,6 +514,15 @@ public:
       }
       break;
     }
+    case type::persistent:
+    {
+      assert(requests.size() == _dest.size() + _src.size());
+      MPI_Startall(requests.size(), requests.data());
+      break;
+    }
+    case type::shared:
+      throw std::runtime_error(
+          "Scatter::type::shared requires a shared memory window");
     default:
       throw std::runtime_error("Scatter::type not recognized");
     }
@@ -451,7 +543,14 @@ public:
       return;
 
     // Wait for communication to complete
-    MPI_Waitall(request.size(), request.data(), MPI_STATUS_IGNORE);
+    if (profiler::comm_enabled())
+    {
+      const double t0 = MPI_Wtime();
+      MPI_Waitall(request.size(), request.data(), MPI_STATUS_IGNORE);
+      profiler::record_wait("Scatterer::scatter_rev", MPI_Wtime() - t0);
+    }
+    else
+      MPI_Waitall(request.size(), request.data(), MPI_STATUS_IGNORE);
   }
 
   /// @brief Scatter data associated with ghost indices to owning ranks.
@@ -556,6 +655,253 @@ public:
                     std::span<MPI_Request>(request));
   }
 
+  /// @brief Start a forward scatter (owner to ghosts) of data in a
+  /// shared memory window.
+  ///
+  /// Ranks on the same node read the owned data directly from the
+  /// window segment of the caller in Scatterer::scatter_fwd_end, and
+  /// only the data for the other ranks is packed and sent. The
+  /// scatterer must have been created with `shared_memory` true.
+  ///
+  /// @param[in] local_data Data associated with the owned indices, the
+  /// start of the window segment of the caller. It must not be changed
+  /// until after a call to Scatterer::scatter_fwd_end.
+  /// @param local_buffer Working buffer. The required size is given by
+  /// Scatterer::local_buffer_size.
+  /// @param remote_buffer Working buffer. The required size is given by
+  /// Scatterer::remote_buffer_size.
+  /// @param[in] window Shared memory window that holds the data of
+  /// each rank on the node, in the same layout as on the caller.
+  /// @param requests MPI requests created by
+  /// Scatterer::create_request_vector for Scatterer::type::shared.
+  template <typename T>
+  void scatter_fwd_begin(std::span<const T> local_data,
+                         std::span<T> local_buffer, std::span<T> remote_buffer,
+                         const SharedWindow& window,
+                         std::span<MPI_Request> requests) const
+  {
+    // Return early if there are no incoming or outgoing edges
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    assert(_shared_memory);
+    assert(requests.size() == _dest.size() + _src.size());
+    if (profiler::comm_enabled())
+    {
+      profiler::record_send("Scatterer::scatter_fwd",
+                            _dest, message_sizes(_sizes_local, _dest_node),
+                            sizeof(T), _src.size());
+    }
+
+    // Make the owned data visible to the ranks on the node
+    window.sync();
+
+    // Receive the data from owners on other nodes, and a notification
+    // that the data is ready from owners on the node
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      if (_src_node[i] == MPI_UNDEFINED)
+      {
+        MPI_Irecv(remote_buffer.data() + _displs_remote[i], _sizes_remote[i],
+                  dolfinx::MPI::mpi_type<T>(), _src[i], 3, _comm0.comm(),
+                  &requests[i]);
+      }
+      else
+      {
+        MPI_Irecv(nullptr, 0, MPI_BYTE, _src[i], 3, _comm0.comm(),
+                  &requests[i]);
+      }
+    }
+
+    for (std::size_t i = 0; i < _dest.size(); i++)
+    {
+      MPI_Request* r = &requests[i + _src.size()];
+      if (_dest_node[i] == MPI_UNDEFINED)
+      {
+        for (int k = _displs_local[i]; k < _displs_local[i + 1]; ++k)
+          local_buffer[k] = local_data[_local_inds[k]];
+        MPI_Isend(local_buffer.data() + _displs_local[i], _sizes_local[i],
+                  dolfinx::MPI::mpi_type<T>(), _dest[i], 3, _comm0.comm(), r);
+      }
+      else
+        MPI_Isend(nullptr, 0, MPI_BYTE, _dest[i], 3, _comm0.comm(), r);
+    }
+  }
+
+  /// @brief Complete a forward scatter of data in a shared memory
+  /// window.
+  ///
+  /// The ghost data from owners on the same node is copied from their
+  /// window segments, and the data received from other owners is
+  /// unpacked. On return, the ranks on the node have finished reading
+  /// the owned data of the caller, which can then be modified.
+  ///
+  /// @param[in] remote_buffer Working buffer, the buffer passed to
+  /// Scatterer::scatter_fwd_begin.
+  /// @param[out] remote_data Data associated with the ghost indices.
+  /// @param[in] window The window passed to
+  /// Scatterer::scatter_fwd_begin.
+  /// @param requests The requests passed to
+  /// Scatterer::scatter_fwd_begin.
+  template <typename T>
+  void scatter_fwd_end(std::span<const T> remote_buffer,
+                       std::span<T> remote_data, const SharedWindow& window,
+                       std::span<MPI_Request> requests) const
+  {
+    scatter_fwd_end(requests);
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    window.sync();
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      if (_src_node[i] == MPI_UNDEFINED)
+      {
+        for (int k = _displs_remote[i]; k < _displs_remote[i + 1]; ++k)
+          remote_data[_remote_inds[k]] = remote_buffer[k];
+      }
+      else
+      {
+        const T* x = reinterpret_cast<const T*>(window.segment(_src_node[i]));
+        for (int k = _displs_remote[i]; k < _displs_remote[i + 1]; ++k)
+          remote_data[_remote_inds[k]] = x[_remote_offsets[k]];
+      }
+    }
+
+    // Notify the owners on the node that their data has been read, and
+    // wait until the ranks on the node have read the owned data
+    notify_node(_src, _src_node, _dest, _dest_node, 5, requests);
+  }
+
+  /// @brief Start a reverse scatter (ghosts to owner) of data in a
+  /// shared memory window.
+  ///
+  /// Owners on the same node read the ghost data directly from the
+  /// window segment of the caller in Scatterer::scatter_rev_end, and
+  /// only the data for owners on other nodes is packed and sent. See
+  /// Scatterer::scatter_fwd_begin(std::span<const T>, std::span<T>,
+  /// std::span<T>, const SharedWindow&, std::span<MPI_Request>) const.
+  ///
+  /// @param[in] remote_data Data associated with the ghost indices, in
+  /// the window segment of the caller. It must not be changed until
+  /// after a call to Scatterer::scatter_rev_end.
+  /// @param remote_buffer Working buffer. The required size is given
+  /// by Scatterer::remote_buffer_size.
+  /// @param local_buffer Working buffer. The required size is given by
+  /// Scatterer::local_buffer_size.
+  /// @param[in] window Shared memory window that holds the data of
+  /// each rank on the node.
+  /// @param requests MPI requests created by
+  /// Scatterer::create_request_vector for Scatterer::type::shared.
+  template <typename T>
+  void scatter_rev_begin(std::span<const T> remote_data,
+                         std::span<T> remote_buffer, std::span<T> local_buffer,
+                         const SharedWindow& window,
+                         std::span<MPI_Request> requests) const
+  {
+    // Return early if there are no incoming or outgoing edges
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    assert(_shared_memory);
+    assert(requests.size() == _dest.size() + _src.size());
+    if (profiler::comm_enabled())
+    {
+      profiler::record_send("Scatterer::scatter_rev", _src,
+                            message_sizes(_sizes_remote, _src_node),
+                            sizeof(T), _dest.size());
+    }
+
+    // Make the ghost data visible to the ranks on the node
+    window.sync();
+
+    for (std::size_t i = 0; i < _dest.size(); i++)
+    {
+      if (_dest_node[i] == MPI_UNDEFINED)
+      {
+        MPI_Irecv(local_buffer.data() + _displs_local[i], _sizes_local[i],
+                  dolfinx::MPI::mpi_type<T>(), _dest[i], 4, _comm0.comm(),
+                  &requests[i]);
+      }
+      else
+      {
+        MPI_Irecv(nullptr, 0, MPI_BYTE, _dest[i], 4, _comm0.comm(),
+                  &requests[i]);
+      }
+    }
+
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      MPI_Request* r = &requests[i + _dest.size()];
+      if (_src_node[i] == MPI_UNDEFINED)
+      {
+        for (int k = _displs_remote[i]; k < _displs_remote[i + 1]; ++k)
+          remote_buffer[k] = remote_data[_remote_inds[k]];
+        MPI_Isend(remote_buffer.data() + _displs_remote[i], _sizes_remote[i],
+                  dolfinx::MPI::mpi_type<T>(), _src[i], 4, _comm0.comm(), r);
+      }
+      else
+        MPI_Isend(nullptr, 0, MPI_BYTE, _src[i], 4, _comm0.comm(), r);
+    }
+  }
+
+  /// @brief Complete a reverse scatter of data in a shared memory
+  /// window.
+  ///
+  /// The ghost data of ranks on the same node is read from their window
+  /// segments and the received data is unpacked, in the order of
+  /// Scatterer::local_indices. On return, the owners on the node have
+  /// finished reading the ghost data of the caller.
+  ///
+  /// @param[in] local_buffer Working buffer, the buffer passed to
+  /// Scatterer::scatter_rev_begin.
+  /// @param[in,out] local_data Data associated with the owned indices.
+  /// @param[in] op The reduction operation when accumulating received
+  /// values.
+  /// @param[in] window The window passed to
+  /// Scatterer::scatter_rev_begin.
+  /// @param requests The requests passed to
+  /// Scatterer::scatter_rev_begin.
+  template <typename T, typename BinaryOp>
+    requires std::is_invocable_r_v<T, BinaryOp, T, T>
+  void scatter_rev_end(std::span<const T> local_buffer,
+                       std::span<T> local_data, BinaryOp op,
+                       const SharedWindow& window,
+                       std::span<MPI_Request> requests) const
+  {
+    scatter_rev_end(requests);
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return;
+
+    window.sync();
+    for (std::size_t i = 0; i < _dest.size(); i++)
+    {
+      if (_dest_node[i] == MPI_UNDEFINED)
+      {
+        for (int k = _displs_local[i]; k < _displs_local[i + 1]; ++k)
+        {
+          std::int32_t idx = _local_inds[k];
+          local_data[idx] = op(local_data[idx], local_buffer[k]);
+        }
+      }
+      else
+      {
+        const T* x
+            = reinterpret_cast<const T*>(window.segment(_dest_node[i]));
+        for (int k = _displs_local[i]; k < _displs_local[i + 1]; ++k)
+        {
+          std::int32_t idx = _local_inds[k];
+          local_data[idx] = op(local_data[idx], x[_local_offsets[k]]);
+        }
+      }
+    }
+
+    // Notify the ranks on the node that their ghost data has been
+    // read, and wait until the owners on the node have read the ghost
+    // data
+    notify_node(_dest, _dest_node, _src, _src_node, 6, requests);
+  }
+
   /// @brief Size of buffer for local data (owned and shared) used in
   /// forward and reverse communication
   /// @return The required buffer size
@@ -589,10 +935,127 @@ public:
   /// @return The block size
   int bs() const noexcept { return _bs; }
 
+  /// @brief Memory used by the scatterer.
+  ///
+  /// The communication buffers are owned by the caller, e.g.
+  /// la::Vector, and are not included.
+  /// @return Memory usage, with the pack/unpack indices and the
+  /// neighbour data as parts
+  MemoryUsage memory_usage() const
+  {
+    MemoryUsage usage{"Scatterer", sizeof(*this), {}};
+    usage.add("local indices", capacity_bytes(_local_inds)
+                                   + capacity_bytes(_local_offsets));
+    usage.add("remote indices", capacity_bytes(_remote_inds)
+                                    + capacity_bytes(_remote_offsets));
+    usage.add("neighbours",
+              capacity_bytes(_sizes_local) + capacity_bytes(_displs_local)
+                  + capacity_bytes(_sizes_remote)
+                  + capacity_bytes(_displs_remote) + capacity_bytes(_src)
+                  + capacity_bytes(_dest) + capacity_bytes(_src_node)
+                  + capacity_bytes(_dest_node));
+    return usage;
+  }
+
+  /// @brief Create persistent MPI requests for forward scatters
+  /// (owner to ghosts) with fixed buffers.
+  ///
+  /// The requests are started by Scatterer::scatter_fwd_begin with
+  /// Scatterer::type::persistent, which avoids setting up the
+  /// communication for each scatter. The buffers must remain valid and
+  /// must not move while the requests exist, and the requests must be
+  /// freed with `MPI_Request_free` (see Scatterer::free_requests).
+  ///
+  /// @param[in] send_buffer Send buffer (see
+  /// Scatterer::scatter_fwd_begin).
+  /// @param[in] recv_buffer Receive buffer (see
+  /// Scatterer::scatter_fwd_begin).
+  /// @return Inactive persistent requests.
+  template <typename T>
+  std::vector<MPI_Request>
+  create_persistent_fwd_requests(std::span<const T> send_buffer,
+                                 std::span<T> recv_buffer) const
+  {
+    std::vector<MPI_Request> requests(_dest.size() + _src.size(),
+                                      MPI_REQUEST_NULL);
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return requests;
+
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      MPI_Recv_init(recv_buffer.data() + _displs_remote[i], _sizes_remote[i],
+                    dolfinx::MPI::mpi_type<T>(), _src[i], 1, _comm0.comm(),
+                    &requests[i]);
+    }
+
+    for (std::size_t i = 0; i < _dest.size(); i++)
+    {
+      MPI_Send_init(send_buffer.data() + _displs_local[i], _sizes_local[i],
+                    dolfinx::MPI::mpi_type<T>(), _dest[i], 1, _comm0.comm(),
+                    &requests[i + _src.size()]);
+    }
+
+    return requests;
+  }
+
+  /// @brief Create persistent MPI requests for reverse scatters
+  /// (ghosts to owner) with fixed buffers.
+  ///
+  /// See Scatterer::create_persistent_fwd_requests.
+  ///
+  /// @param[in] send_buffer Send buffer (see
+  /// Scatterer::scatter_rev_begin).
+  /// @param[in] recv_buffer Receive buffer (see
+  /// Scatterer::scatter_rev_begin).
+  /// @return Inactive persistent requests.
+  template <typename T>
+  std::vector<MPI_Request>
+  create_persistent_rev_requests(std::span<const T> send_buffer,
+                                 std::span<T> recv_buffer) const
+  {
+    std::vector<MPI_Request> requests(_dest.size() + _src.size(),
+                                      MPI_REQUEST_NULL);
+    if (_sizes_local.empty() and _sizes_remote.empty())
+      return requests;
+
+    for (std::size_t i = 0; i < _dest.size(); i++)
+    {
+      MPI_Recv_init(recv_buffer.data() + _displs_local[i], _sizes_local[i],
+                    dolfinx::MPI::mpi_type<T>(), _dest[i], 2, _comm0.comm(),
+                    &requests[i]);
+    }
+
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      MPI_Send_init(send_buffer.data() + _displs_remote[i], _sizes_remote[i],
+                    dolfinx::MPI::mpi_type<T>(), _src[i], 2, _comm0.comm(),
+                    &requests[i + _dest.size()]);
+    }
+
+    return requests;
+  }
+
+  /// @brief Free persistent requests.
+  /// @param[in,out] requests Requests created by
+  /// Scatterer::create_persistent_fwd_requests or
+  /// Scatterer::create_persistent_rev_requests. The requests must be
+  /// inactive, and are set to `MPI_REQUEST_NULL`.
+  static void free_requests(std::span<MPI_Request> requests)
+  {
+    for (MPI_Request& r : requests)
+    {
+      if (r != MPI_REQUEST_NULL)
+        MPI_Request_free(&r);
+    }
+  }
+
   /// @brief Create a vector of MPI_Requests for a given Scatterer::type
+  /// @note For Scatterer::type::persistent the requests are created by
+  /// Scatterer::create_persistent_fwd_requests and
+  /// Scatterer::create_persistent_rev_requests.
   /// @return A vector of MPI requests
-  std::vector<MPI_Request> create_request_vector(Scatterer::type type
-                                                 = type::neighbor)
+  std::vector<MPI_Request>
+  create_request_vector(Scatterer::type type = type::neighbor) const
   {
     std::vector<MPI_Request> requests;
     switch (type)
@@ -601,6 +1064,8 @@ public:
       requests = {MPI_REQUEST_NULL};
       break;
     case type::p2p:
+    case type::persistent:
+    case type::shared:
       requests.resize(_dest.size() + _src.size(), MPI_REQUEST_NULL);
       break;
     default:
@@ -610,9 +1075,314 @@ public:
   }
 
 private:
+  // Ghosts (positions in IndexMap::ghosts) to communicate, and the
+  // ranks that own them (src) and that ghost owned indices of the
+  // caller (dest), sorted
+  struct pattern_t
+  {
+    std::vector<std::int32_t> ghosts;
+    std::vector<int> src;
+    std::vector<int> dest;
+  };
+
+  // Pattern of all ghosts of an index map
+  static pattern_t full_pattern(const IndexMap& map)
+  {
+    std::vector<std::int32_t> ghosts(map.num_ghosts());
+    std::iota(ghosts.begin(), ghosts.end(), 0);
+    return {std::move(ghosts),
+            std::vector<int>(map.src().begin(), map.src().end()),
+            std::vector<int>(map.dest().begin(), map.dest().end())};
+  }
+
+  // Pattern of the ghosts of an index map in a subset of the local
+  // indices, with the neighbourhood reduced to the ranks that exchange
+  // data of the subset
+  static pattern_t sub_pattern(const IndexMap& map,
+                               std::span<const std::int32_t> indices)
+  {
+    const std::int32_t size_local = map.size_local();
+    std::vector<std::int32_t> ghosts;
+    for (std::int32_t i : indices)
+    {
+      assert(i < size_local + map.num_ghosts());
+      if (i >= size_local)
+        ghosts.push_back(i - size_local);
+    }
+    dolfinx::radix_sort(ghosts);
+    auto [unique_end, range_end] = std::ranges::unique(ghosts);
+    ghosts.erase(unique_end, range_end);
+    if (dolfinx::MPI::size(map.comm()) == 1)
+      return {std::move(ghosts), {}, {}};
+
+    // Number of ghosts in the subset owned by each src rank
+    std::vector<int> src(map.src().begin(), map.src().end());
+    std::vector<int> dest(map.dest().begin(), map.dest().end());
+    std::span owners = map.owners();
+    std::vector<int> num_src(src.size(), 0);
+    for (std::int32_t g : ghosts)
+    {
+      auto it = std::ranges::lower_bound(src, owners[g]);
+      assert(it != src.end() and *it == owners[g]);
+      ++num_src[std::distance(src.begin(), it)];
+    }
+
+    // Send the numbers to the owners (ghost -> owner)
+    MPI_Comm comm;
+    MPI_Dist_graph_create_adjacent(
+        map.comm(), dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(),
+        src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
+    std::vector<int> num_dest(dest.size());
+    num_src.reserve(1);
+    num_dest.reserve(1);
+    MPI_Neighbor_alltoall(num_src.data(), 1, MPI_INT, num_dest.data(), 1,
+                          MPI_INT, comm);
+    MPI_Comm_free(&comm);
+
+    pattern_t pattern{std::move(ghosts), {}, {}};
+    for (std::size_t i = 0; i < src.size(); ++i)
+      if (num_src[i] > 0)
+        pattern.src.push_back(src[i]);
+    for (std::size_t i = 0; i < dest.size(); ++i)
+      if (num_dest[i] > 0)
+        pattern.dest.push_back(dest[i]);
+    return pattern;
+  }
+
+  // Create a scatterer for the ghosts and neighbourhood in `pattern`
+  Scatterer(const IndexMap& map, int bs, pattern_t pattern,
+            const Allocator& alloc, bool shared_memory)
+      : _bs(bs), _shared_memory(shared_memory), _remote_inds(0, alloc),
+        _remote_offsets(0, alloc), _local_inds(0, alloc),
+        _local_offsets(0, alloc), _src(std::move(pattern.src)),
+        _dest(std::move(pattern.dest))
+  {
+    if (dolfinx::MPI::size(map.comm()) == 1)
+      return;
+
+    // Check that src and dest ranks are unique and sorted
+    assert(std::ranges::is_sorted(_src));
+    assert(std::ranges::is_sorted(_dest));
+
+    // Create communicators with directed edges:
+    // (0) owner -> ghost,
+    // (1) ghost -> owner
+    MPI_Comm comm0;
+    MPI_Dist_graph_create_adjacent(
+        map.comm(), _src.size(), _src.data(), MPI_UNWEIGHTED, _dest.size(),
+        _dest.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
+    _comm0 = dolfinx::MPI::Comm(comm0, false);
+
+    MPI_Comm comm1;
+    MPI_Dist_graph_create_adjacent(
+        map.comm(), _dest.size(), _dest.data(), MPI_UNWEIGHTED, _src.size(),
+        _src.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm1);
+    _comm1 = dolfinx::MPI::Comm(comm1, false);
+
+    // Build permutation array that sorts the ghost indices by owning
+    // rank
+    std::span owners = map.owners();
+    std::vector<std::int32_t> perm = std::move(pattern.ghosts);
+    dolfinx::radix_sort(perm, [&owners](auto index) { return owners[index]; });
+
+    // Sort (i) ghost indices and (ii) ghost index owners by rank
+    // (using perm array)
+    std::span ghosts = map.ghosts();
+    std::vector<int> owners_sorted(perm.size());
+    std::vector<std::int64_t> ghosts_sorted(perm.size());
+    std::ranges::transform(perm, owners_sorted.begin(),
+                           [&owners](auto idx) { return owners[idx]; });
+    std::ranges::transform(perm, ghosts_sorted.begin(),
+                           [&ghosts](auto idx) { return ghosts[idx]; });
+
+    // For data associated with ghost indices, packed by owning
+    // (neighbourhood) rank, compute sizes and displacements. I.e.,
+    // when sending ghost index data from this rank to the owning
+    // ranks, disp[i] is the first entry in the buffer sent to
+    // neighbourhood rank i, and disp[i + 1] - disp[i] is the number
+    // of values sent to rank i.
+    _sizes_remote.resize(_src.size(), 0);
+    _displs_remote.resize(_src.size() + 1, 0);
+    std::vector<std::int32_t>::iterator begin = owners_sorted.begin();
+    for (std::size_t i = 0; i < _src.size(); i++)
+    {
+      auto upper = std::upper_bound(begin, owners_sorted.end(), _src[i]);
+      int num_ind = std::distance(begin, upper);
+      _displs_remote[i + 1] = _displs_remote[i] + num_ind;
+      _sizes_remote[i] = num_ind;
+      begin = upper;
+    }
+
+    // For data associated with owned indices that are ghosted by
+    // other ranks, compute the size and displacement arrays. When
+    // sending data associated with ghost indices to the owner, these
+    // size and displacement arrays are for the receive buffer.
+
+    // Compute sizes and displacements of local data (how many local
+    // elements to be sent/received grouped by neighbors)
+    _sizes_local.resize(_dest.size());
+    _displs_local.resize(_sizes_local.size() + 1);
+    _sizes_remote.reserve(1);
+    _sizes_local.reserve(1);
+    MPI_Neighbor_alltoall(_sizes_remote.data(), 1, MPI_INT32_T,
+                          _sizes_local.data(), 1, MPI_INT32_T, _comm1.comm());
+    std::partial_sum(_sizes_local.begin(), _sizes_local.end(),
+                     std::next(_displs_local.begin()));
+
+    assert((std::int32_t)ghosts_sorted.size() == _displs_remote.back());
+    assert((std::int32_t)ghosts_sorted.size() == _displs_remote.back());
+
+    // Send ghost global indices to owning rank, and receive owned
+    // indices that are ghosts on other ranks
+    std::vector<std::int64_t> recv_buffer(_displs_local.back(), 0);
+    MPI_Neighbor_alltoallv(ghosts_sorted.data(), _sizes_remote.data(),
+                           _displs_remote.data(), MPI_INT64_T,
+                           recv_buffer.data(), _sizes_local.data(),
+                           _displs_local.data(), MPI_INT64_T, _comm1.comm());
+
+    const std::array<std::int64_t, 2> range = map.local_range();
+#ifndef NDEBUG
+    // Check that all received indice are within the owned range
+    std::ranges::for_each(recv_buffer, [range](auto idx)
+                          { assert(idx >= range[0] and idx < range[1]); });
+#endif
+
+    if (_shared_memory)
+    {
+      // Ranks of the neighbours on the node (MPI_UNDEFINED if not on
+      // the node), numbered as in common::SharedWindow
+      MPI_Comm node_comm;
+      MPI_Comm_split_type(map.comm(), MPI_COMM_TYPE_SHARED,
+                          dolfinx::MPI::rank(map.comm()), MPI_INFO_NULL,
+                          &node_comm);
+      MPI_Group group, node_group;
+      MPI_Comm_group(map.comm(), &group);
+      MPI_Comm_group(node_comm, &node_group);
+      _src_node.resize(_src.size());
+      _dest_node.resize(_dest.size());
+      MPI_Group_translate_ranks(group, _src.size(), _src.data(), node_group,
+                                _src_node.data());
+      MPI_Group_translate_ranks(group, _dest.size(), _dest.data(),
+                                node_group, _dest_node.data());
+      MPI_Group_free(&group);
+      MPI_Group_free(&node_group);
+      MPI_Comm_free(&node_comm);
+
+      // Receive the start of the owned range of each owner, and compute
+      // the position of the ghosts in the arrays of the owners
+      std::vector<std::int64_t> owned_start(_dest.size(), range[0]);
+      std::vector<std::int64_t> src_start(_src.size());
+      owned_start.reserve(1);
+      src_start.reserve(1);
+      MPI_Neighbor_alltoall(owned_start.data(), 1, MPI_INT64_T,
+                            src_start.data(), 1, MPI_INT64_T, _comm0.comm());
+      _remote_offsets = std::vector<std::int32_t, allocator_type>(
+          ghosts_sorted.size() * _bs, alloc);
+      for (std::size_t i = 0; i < _src.size(); ++i)
+      {
+        for (int k = _displs_remote[i]; k < _displs_remote[i + 1]; ++k)
+        {
+          for (int j = 0; j < _bs; ++j)
+          {
+            _remote_offsets[k * _bs + j]
+                = (ghosts_sorted[k] - src_start[i]) * _bs + j;
+          }
+        }
+      }
+
+      // Send the position of the ghosts in the array of the caller to
+      // the owners, and receive the position of the owned indices in
+      // the arrays of the ranks that ghost them
+      std::vector<std::int64_t> ghost_pos(perm.size());
+      std::ranges::transform(perm, ghost_pos.begin(), [&map](auto idx)
+                             { return map.size_local() + idx; });
+      std::vector<std::int64_t> ghost_pos_recv(recv_buffer.size());
+      MPI_Neighbor_alltoallv(ghost_pos.data(), _sizes_remote.data(),
+                             _displs_remote.data(), MPI_INT64_T,
+                             ghost_pos_recv.data(), _sizes_local.data(),
+                             _displs_local.data(), MPI_INT64_T,
+                             _comm1.comm());
+      _local_offsets = std::vector<std::int32_t, allocator_type>(
+          ghost_pos_recv.size() * _bs, alloc);
+      for (std::size_t i = 0; i < ghost_pos_recv.size(); ++i)
+        for (int j = 0; j < _bs; j++)
+          _local_offsets[i * _bs + j] = ghost_pos_recv[i] * _bs + j;
+    }
+
+    // Scale sizes and displacements by block size
+    {
+      auto rescale = [](auto& x, int bs) {
+        std::ranges::transform(x, x.begin(), [bs](auto e) { return e *= bs; });
+      };
+      rescale(_sizes_local, bs);
+      rescale(_displs_local, bs);
+      rescale(_sizes_remote, bs);
+      rescale(_displs_remote, bs);
+    }
+
+    // Expand local indices using block size and convert it from
+    // global to local numbering
+    _local_inds = std::vector<std::int32_t, allocator_type>(
+        recv_buffer.size() * _bs, alloc);
+    std::int64_t offset = range[0] * _bs;
+    for (std::size_t i = 0; i < recv_buffer.size(); i++)
+      for (int j = 0; j < _bs; j++)
+        _local_inds[i * _bs + j] = (recv_buffer[i] * _bs + j) - offset;
+
+    // Expand remote indices using block size
+    _remote_inds
+        = std::vector<std::int32_t, allocator_type>(perm.size() * _bs, alloc);
+    for (std::size_t i = 0; i < perm.size(); i++)
+      for (int j = 0; j < _bs; j++)
+        _remote_inds[i * _bs + j] = perm[i] * _bs + j;
+  }
+
+  // Number of items sent to each neighbour in messages, i.e. zero for
+  // neighbours on the node
+  static std::vector<std::int32_t> message_sizes(std::span<const int> sizes,
+                                                 std::span<const int> node)
+  {
+    std::vector<std::int32_t> msg(sizes.begin(), sizes.end());
+    for (std::size_t i = 0; i < msg.size(); ++i)
+      msg[i] = node[i] == MPI_UNDEFINED ? msg[i] : 0;
+    return msg;
+  }
+
+  // Send an empty message to the ranks in `to` on the node, and wait
+  // for an empty message from each rank in `from` on the node
+  void notify_node(std::span<const int> to, std::span<const int> to_node,
+                   std::span<const int> from, std::span<const int> from_node,
+                   int tag, std::span<MPI_Request> requests) const
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < to.size(); i++)
+    {
+      if (to_node[i] != MPI_UNDEFINED)
+      {
+        MPI_Isend(nullptr, 0, MPI_BYTE, to[i], tag, _comm0.comm(),
+                  &requests[n++]);
+      }
+    }
+
+    for (std::size_t i = 0; i < from.size(); i++)
+    {
+      if (from_node[i] != MPI_UNDEFINED)
+      {
+        MPI_Irecv(nullptr, 0, MPI_BYTE, from[i], tag, _comm0.comm(),
+                  &requests[n++]);
+      }
+    }
+
+    MPI_Waitall(n, requests.data(), MPI_STATUSES_IGNORE);
+  }
+
   // Block size
   int _bs;
 
+  // True if the positions of the data in the arrays of the neighbours
+  // on the node have been computed
+  bool _shared_memory;
+
   // Communicator where the source ranks own the indices in the callers
   // halo, and the destination ranks 'ghost' indices owned by the
   // caller. I.e.,
@@ -630,6 +1400,10 @@ private:
   // Permutation indices used to pack and unpack ghost data (remote)
   std::vector<std::int32_t, allocator_type> _remote_inds;
 
+  // Position of the ghost data in the arrays of the owners, in the
+  // order of _remote_inds (shared memory only)
+  std::vector<std::int32_t, allocator_type> _remote_offsets;
+
   // Number of remote indices (ghosts) for each neighbor process
   std::vector<int> _sizes_remote;
 
@@ -641,6 +1415,10 @@ private:
   // grouped by neighbor process.
   std::vector<std::int32_t, allocator_type> _local_inds;
 
+  // Position of the data of shared indices in the arrays of the ranks
+  // that ghost them, in the order of _local_inds (shared memory only)
+  std::vector<std::int32_t, allocator_type> _local_offsets;
+
   // Number of local shared indices per neighbor process
   std::vector<int> _sizes_local;
 
@@ -654,5 +1432,9 @@ private:
   // Set of ranks ghost owned indices
   // FIXME: Should we store the index map instead?
   std::vector<int> _dest;
+
+  // Rank on the node of each src and dest rank, or MPI_UNDEFINED if
+  // the rank is on another node (shared memory only)
+  std::vector<int> _src_node, _dest_node;
 };
 } // namespace dolfinx::common
@@ -0,0 +1,253 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "ThreadPool.h"
+#include "log.h"
+#include <cstdlib>
+#include <string>
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+// Default number of threads, or 0 if not set
+std::atomic<int> default_num_threads = 0;
+
+// Pool and index of the worker running on this thread
+thread_local const ThreadPool* worker_pool = nullptr;
+thread_local int worker_id = -1;
+} // namespace
+
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool(int capacity)
+{
+  _queues.reserve(std::max(capacity, 0));
+  for (int i = 0; i < capacity; ++i)
+    _queues.push_back(std::make_unique<Queue>());
+}
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::scoped_lock lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_all();
+  for (std::thread& t : _workers)
+    t.join();
+}
+//-----------------------------------------------------------------------------
+int ThreadPool::capacity() const { return _queues.size(); }
+//-----------------------------------------------------------------------------
+int ThreadPool::num_workers() const { return _num_workers.load(); }
+//-----------------------------------------------------------------------------
+void ThreadPool::reserve(int num_workers)
+{
+  num_workers = std::min(num_workers, capacity());
+  if (num_workers <= _num_workers.load(std::memory_order_acquire))
+    return;
+
+  std::scoped_lock lock(_mutex);
+  for (int i = _workers.size(); i < num_workers; ++i)
+    _workers.emplace_back(&ThreadPool::work, this, i);
+  _num_workers.store(_workers.size(), std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::run(int num_tasks, const std::function<void(int)>& task)
+{
+  if (num_tasks <= 0)
+    return;
+
+  Group group{&task, num_tasks};
+
+  // Distribute tasks 1, 2, ... over the worker queues, starting with the
+  // queue of this thread if it is a worker
+  const int nw = _num_workers.load(std::memory_order_acquire);
+  const int first = worker_pool == this ? worker_id : 0;
+  if (nw > 0)
+  {
+    {
+      // Count the tasks before they are queued, so that the count is
+      // not zero while a task is in a queue, and synchronise with
+      // workers that are about to wait
+      std::scoped_lock lock(_mutex);
+      _num_queued += num_tasks - 1;
+    }
+    for (int i = 1; i < num_tasks; ++i)
+    {
+      Queue& q = *_queues[(first + i - 1) % nw];
+      std::scoped_lock lock(q.mutex);
+      q.tasks.push_back({&group, i});
+    }
+    _cv.notify_all();
+  }
+  else
+  {
+    for (int i = 1; i < num_tasks; ++i)
+      execute({&group, i});
+  }
+
+  // Run the first task and help until the group is complete
+  execute({&group, 0});
+  wait(group, first);
+  if (group.error)
+    std::rethrow_exception(group.error);
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::wait(Group& group, int first)
+{
+  while (true)
+  {
+    {
+      std::scoped_lock lock(group.mutex);
+      if (group.remaining == 0)
+        return;
+    }
+
+    // If no task is queued, the remaining tasks of the group are running
+    // on other threads
+    if (!run_one(first))
+    {
+      std::unique_lock lock(group.mutex);
+      group.cv.wait(lock, [&group] { return group.remaining == 0; });
+      return;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+bool ThreadPool::run_one(int first)
+{
+  const int nw = _num_workers.load(std::memory_order_acquire);
+  if (nw == 0 or _num_queued.load(std::memory_order_acquire) == 0)
+    return false;
+
+  for (int k = 0; k < nw; ++k)
+  {
+    const int i = (first + k) % nw;
+    Queue& q = *_queues[i];
+    std::unique_lock lock(q.mutex);
+    if (q.tasks.empty())
+      continue;
+
+    // Own queue from the front, other queues from the back
+    Task task;
+    if (k == 0)
+    {
+      task = q.tasks.front();
+      q.tasks.pop_front();
+    }
+    else
+    {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+    }
+    lock.unlock();
+    --_num_queued;
+    execute(task);
+    return true;
+  }
+
+  return false;
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::execute(Task task)
+{
+  Group& group = *task.group;
+  try
+  {
+    (*group.task)(task.index);
+  }
+  catch (...)
+  {
+    std::scoped_lock lock(group.mutex);
+    if (!group.error)
+      group.error = std::current_exception();
+  }
+
+  // The owner of the group destroys it once it has observed the count
+  // reaching zero under the lock, so the group is not accessed after the
+  // lock is released
+  std::scoped_lock lock(group.mutex);
+  if (--group.remaining == 0)
+    group.cv.notify_all();
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::work(int id)
+{
+  worker_pool = this;
+  worker_id = id;
+  while (true)
+  {
+    if (run_one(id))
+      continue;
+
+    std::unique_lock lock(_mutex);
+    _cv.wait(lock, [this] { return _stop or _num_queued.load() > 0; });
+    if (_stop)
+      return;
+  }
+}
+//-----------------------------------------------------------------------------
+ThreadPool& common::thread_pool()
+{
+  static ThreadPool pool(
+      std::max(64, 2 * static_cast<int>(std::thread::hardware_concurrency())));
+  return pool;
+}
+//-----------------------------------------------------------------------------
+void common::set_num_threads(int num_threads)
+{
+  default_num_threads = std::max(num_threads, 1);
+}
+//-----------------------------------------------------------------------------
+int common::num_threads()
+{
+  if (int n = default_num_threads.load(); n > 0)
+    return n;
+
+  // Initialise from the environment
+  int n = 1;
+  if (const char* env = std::getenv("DOLFINX_NUM_THREADS"))
+  {
+    try
+    {
+      n = std::max(std::stoi(env), 1);
+    }
+    catch (const std::exception&)
+    {
+      DOLFINX_LOG_WARN("Invalid DOLFINX_NUM_THREADS: {}", env);
+    }
+  }
+  int unset = 0;
+  default_num_threads.compare_exchange_strong(unset, n);
+  return default_num_threads.load();
+}
+//-----------------------------------------------------------------------------
+bool common::check_mpi_thread_level()
+{
+  static const bool supported = []
+  {
+    int initialized = 0, finalized = 0;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (!initialized or finalized)
+      return true;
+
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+      DOLFINX_LOG_WARN("MPI thread support is MPI_THREAD_SINGLE. Threaded "
+                       "functions use threads that do not call MPI, which "
+                       "requires MPI_THREAD_FUNNELED.");
+      return false;
+    }
+    return true;
+  }();
+  return supported;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,226 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MPI.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dolfinx::common
+{
+/// @brief A pool of worker threads that runs groups of tasks, with
+/// work stealing.
+///
+/// Each worker has a queue of tasks. The tasks of a group are
+/// distributed over the queues, a worker takes tasks from the front of
+/// its own queue and steals from the back of the other queues when its
+/// queue is empty. The thread that runs a group executes the first
+/// task itself and then helps with the remaining tasks (of any group)
+/// until the group is complete, so groups can be nested, i.e. a task
+/// may run a group, without deadlock.
+///
+/// Workers are started on demand, up to a fixed capacity, and are not
+/// stopped until the pool is destroyed. Tasks must not call MPI
+/// functions. This makes the pool compatible with
+/// `MPI_THREAD_FUNNELED`.
+///
+/// The library uses a single global pool, see thread_pool().
+class ThreadPool
+{
+public:
+  /// @brief Create a thread pool.
+  /// @param[in] capacity Maximum number of worker threads. The calling
+  /// thread of a group runs tasks too, so at most `capacity + 1` tasks
+  /// run concurrently.
+  explicit ThreadPool(int capacity);
+
+  // Copy constructor (deleted)
+  ThreadPool(const ThreadPool&) = delete;
+
+  // Assignment operator (deleted)
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Destructor. Stops and joins the workers.
+  ~ThreadPool();
+
+  /// @brief Maximum number of worker threads.
+  int capacity() const;
+
+  /// @brief Number of started worker threads.
+  int num_workers() const;
+
+  /// @brief Start workers, so that at least `num_workers` are running
+  /// (capped at the capacity).
+  /// @param[in] num_workers Number of workers
+  void reserve(int num_workers);
+
+  /// @brief Run a group of tasks and wait for all of them to complete.
+  ///
+  /// Task 0 runs on the calling thread. If tasks throw an exception,
+  /// the other tasks are still run and the first exception is
+  /// rethrown.
+  ///
+  /// @param[in] num_tasks Number of tasks
+  /// @param[in] task Function called with the index of each task,
+  /// `task(i)` for `0 <= i < num_tasks`. The tasks may run
+  /// concurrently.
+  void run(int num_tasks, const std::function<void(int)>& task);
+
+private:
+  // Group of tasks
+  struct Group
+  {
+    const std::function<void(int)>* task;
+    int remaining;
+    std::exception_ptr error = nullptr;
+    std::mutex mutex = {};
+    std::condition_variable cv = {};
+  };
+
+  // Task in a queue
+  struct Task
+  {
+    Group* group;
+    int index;
+  };
+
+  // Task queue of a worker
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Take a task, first from the front of queue `first` then from the
+  // back of the other queues, and run it. Returns false if all queues
+  // are empty.
+  bool run_one(int first);
+
+  // Run a task and mark it complete
+  static void execute(Task task);
+
+  // Wait for the tasks of a group to complete, helping with queued
+  // tasks
+  void wait(Group& group, int first);
+
+  // Worker loop
+  void work(int id);
+
+  // Task queues, one for each possible worker
+  std::vector<std::unique_ptr<Queue>> _queues;
+
+  // Number of started workers
+  std::atomic<int> _num_workers = 0;
+
+  // Number of queued tasks
+  std::atomic<std::int64_t> _num_queued = 0;
+
+  // Wake-up of idle workers
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _stop = false;
+
+  // Workers
+  std::vector<std::thread> _workers;
+};
+
+/// @brief The global thread pool used by the threaded functions of the
+/// library.
+///
+/// The pool is created on first use. Its capacity is the larger of
+/// twice the number of hardware threads and 64.
+ThreadPool& thread_pool();
+
+/// @brief Set the default number of threads.
+///
+/// The default is used by parallel_for when the number of threads
+/// passed is zero or negative. It is initialised from the environment
+/// variable `DOLFINX_NUM_THREADS`, and is 1 otherwise.
+/// @param[in] num_threads Number of threads (at least 1)
+void set_num_threads(int num_threads);
+
+/// @brief The default number of threads (see set_num_threads).
+int num_threads();
+
+/// @brief Check if the MPI thread support level allows threads that do
+/// not call MPI, i.e. that it is at least `MPI_THREAD_FUNNELED`.
+///
+/// A warning is logged once if the thread support is lower, e.g. when
+/// MPI was initialised with `MPI_Init` by an MPI implementation that
+/// provides `MPI_THREAD_SINGLE`. Threads are still used in that case,
+/// since no MPI function is called by worker threads.
+/// @return True if MPI is not initialised or provides at least
+/// `MPI_THREAD_FUNNELED`
+bool check_mpi_thread_level();
+
+/// @brief Run tasks on the global thread pool and wait for them to
+/// complete.
+/// @param[in] num_tasks Number of tasks. The pool is grown, if needed,
+/// so that the tasks can run concurrently.
+/// @param[in] task Function called with the index of each task,
+/// `task(i)` for `0 <= i < num_tasks`. Task 0 runs on the calling
+/// thread.
+template <typename F>
+void run_tasks(int num_tasks, F&& task)
+{
+  if (num_tasks <= 1)
+  {
+    if (num_tasks == 1)
+      task(0);
+    return;
+  }
+
+  check_mpi_thread_level();
+  ThreadPool& pool = thread_pool();
+  pool.reserve(num_tasks - 1);
+  pool.run(num_tasks, std::function<void(int)>(std::forward<F>(task)));
+}
+
+/// @brief Run a function over a range in parallel, split into chunks.
+///
+/// The range `[0, n)` is split into `num_threads` contiguous chunks of
+/// (nearly) equal size, as with dolfinx::MPI::local_range, and
+/// `f(i0, i1)` is called for each chunk `[i0, i1)`. The chunks run
+/// concurrently on the global thread pool, with the first chunk on the
+/// calling thread.
+///
+/// @param[in] n Size of the range
+/// @param[in] num_threads Number of chunks. If zero or negative, the
+/// default number of threads (see num_threads()) is used. The number
+/// of chunks is at most `n`.
+/// @param[in] f Function called with the bounds of each chunk.
+template <typename F>
+void parallel_for(std::int64_t n, int num_threads, F&& f)
+{
+  if (num_threads <= 0)
+    num_threads = common::num_threads();
+  const int nt = std::clamp<std::int64_t>(n, 1, num_threads);
+  if (nt == 1)
+  {
+    if (n > 0)
+      f(std::int64_t(0), n);
+    return;
+  }
+
+  run_tasks(nt,
+            [&f, n, nt](int t)
+            {
+              auto [i0, i1] = dolfinx::MPI::local_range(t, n, nt);
+              f(i0, i1);
+            });
+}
+
+} // namespace dolfinx::common
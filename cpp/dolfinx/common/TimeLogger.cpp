@@ -7,6 +7,7 @@
 #include "TimeLogger.h"
 #include "MPI.h"
 #include "log.h"
+#include "profiler.h"
 #include <iostream>
 #include <variant>
 
@@ -25,9 +26,10 @@ void TimeLogger::register_timing(std::string task, double wall, double user,
   std::string line = "Elapsed wall, usr, sys time: " + std::to_string(wall)
                      + ", " + std::to_string(user) + ", "
                      + std::to_string(system) + " (" + task + ")";
-  spdlog::debug(line.c_str());
+  DOLFINX_LOG_DEBUG(line.c_str());
 
   // Store values for summary
+  std::scoped_lock lock(_mutex);
   if (auto it = _timings.find(task); it != _timings.end())
   {
     std::get<0>(it->second) += 1;
@@ -50,6 +52,26 @@ void TimeLogger::list_timings(MPI_Comm comm, std::set<TimingType> type,
   // Print just on rank 0
   if (dolfinx::MPI::rank(comm) == 0)
     std::cout << str << std::endl;
+
+  // Hierarchical summary of the profiled regions
+  std::int64_t num_regions = profiler::regions().size();
+  MPI_Allreduce(MPI_IN_PLACE, &num_regions, 1, MPI_INT64_T, MPI_MAX, comm);
+  if (num_regions > 0)
+  {
+    Table regions = profiler::summary(comm);
+    if (dolfinx::MPI::rank(comm) == 0)
+      std::cout << "\n" << regions.str() << std::endl;
+  }
+
+  // Summary of the recorded MPI communication
+  int comm_recorded = profiler::comm_enabled();
+  MPI_Allreduce(MPI_IN_PLACE, &comm_recorded, 1, MPI_INT, MPI_MAX, comm);
+  if (comm_recorded)
+  {
+    Table table = profiler::comm_summary(comm);
+    if (dolfinx::MPI::rank(comm) == 0)
+      std::cout << "\n" << table.str() << std::endl;
+  }
 }
 //-----------------------------------------------------------------------------
 Table TimeLogger::timings(std::set<TimingType> type)
@@ -61,6 +83,7 @@ Table TimeLogger::timings(std::set<TimingType> type)
   bool time_user = type.find(TimingType::user) != type.end();
   bool time_sys = type.find(TimingType::system) != type.end();
 
+  std::scoped_lock lock(_mutex);
   for (auto& it : _timings)
   {
     const std::string task = it.first;
@@ -92,6 +115,7 @@ Table TimeLogger::timings(std::set<TimingType> type)
 std::tuple<int, double, double, double> TimeLogger::timing(std::string task)
 {
   // Find timing
+  std::scoped_lock lock(_mutex);
   auto it = _timings.find(task);
   if (it == _timings.end())
   {
@@ -10,6 +10,7 @@
 #include "timing.h"
 #include <map>
 #include <mpi.h>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
@@ -17,7 +18,7 @@
 namespace dolfinx::common
 {
 
-/// Timer logging
+/// Timer logging. Timings can be registered from several threads.
 
 class TimeLogger
 {
@@ -59,5 +60,8 @@ private:
   // List of timings for tasks, map from string to (num_timings,
   // total_wall_time, total_user_time, total_system_time)
   std::map<std::string, std::tuple<int, double, double, double>> _timings;
+
+  // Protects _timings
+  std::mutex _mutex;
 };
 } // namespace dolfinx::common
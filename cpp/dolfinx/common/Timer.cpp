@@ -7,6 +7,7 @@
 #include "Timer.h"
 #include "TimeLogManager.h"
 #include "TimeLogger.h"
+#include "profiler.h"
 #include <stdexcept>
 
 using namespace dolfinx;
@@ -20,7 +21,11 @@ Timer::Timer() : Timer::Timer("")
 //-----------------------------------------------------------------------------
 Timer::Timer(const std::string& task) : _task(task)
 {
-  // Do nothing
+  if (!_task.empty())
+  {
+    _region_name = profiler::impl::intern(_task);
+    _region = profiler::impl::begin(_region_name);
+  }
 }
 //-----------------------------------------------------------------------------
 Timer::~Timer()
@@ -29,7 +34,14 @@ Timer::~Timer()
     stop();
 }
 //-----------------------------------------------------------------------------
-void Timer::start() { _timer.start(); }
+void Timer::start()
+{
+  if (_region >= 0)
+    profiler::impl::end(_region, false);
+  if (_region_name)
+    _region = profiler::impl::begin(_region_name);
+  _timer.start();
+}
 //-----------------------------------------------------------------------------
 void Timer::resume()
 {
@@ -45,6 +57,11 @@ void Timer::resume()
 double Timer::stop()
 {
   _timer.stop();
+  if (_region >= 0)
+  {
+    profiler::impl::end(_region);
+    _region = -1;
+  }
   const auto [wall, user, system] = this->elapsed();
   if (!_task.empty())
     TimeLogManager::logger().register_timing(_task, wall, user, system);
@@ -8,6 +8,7 @@
 
 #include <array>
 #include <boost/timer/timer.hpp>
+#include <cstdint>
 #include <string>
 
 namespace dolfinx::common
@@ -26,6 +27,11 @@ namespace dolfinx::common
 /// Timings are stored globally and a summary may be printed by calling
 ///
 ///   list_timings();
+///
+/// A timer with a task name is also recorded as a profiler region (see
+/// common::ScopedRegion), so that timers appear in the hierarchical
+/// profile. For short code regions, common::ScopedRegion has a much
+/// lower overhead.
 
 class Timer
 {
@@ -58,5 +64,9 @@ private:
 
   // Implementation of timer
   boost::timer::cpu_timer _timer;
+
+  // Profiler region name and handle of the open region (-1 if none)
+  const char* _region_name = nullptr;
+  std::int32_t _region = -1;
 };
 } // namespace dolfinx::common
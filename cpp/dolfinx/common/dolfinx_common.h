@@ -14,5 +14,7 @@ namespace dolfinx::common
 #include <dolfinx/common/Table.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/defines.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/profiler.h>
 #include <dolfinx/common/timing.h>
 #include <dolfinx/common/version.h>
@@ -6,8 +6,78 @@
 
 #pragma once
 
+#include <cstdint>
 #include <spdlog/spdlog.h>
 
+/// @file log.h
+/// @brief Logging macros with a compile-time level floor.
+///
+/// `DOLFINX_LOG_LEVEL` is the lowest level that is compiled in, using
+/// the spdlog numbering (`SPDLOG_LEVEL_TRACE` = 0, ...,
+/// `SPDLOG_LEVEL_OFF` = 6), and is set by the CMake option of the same
+/// name. Messages below the floor are removed by the preprocessor,
+/// including the evaluation of their arguments. Messages above the
+/// floor are filtered by the run-time level, which is checked before
+/// the arguments are evaluated.
+#ifndef DOLFINX_LOG_LEVEL
+#define DOLFINX_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/// @cond
+#define DOLFINX_LOG_IMPL(lvl, ...)                                             \
+  do                                                                           \
+  {                                                                            \
+    if (spdlog::should_log(spdlog::level::lvl))                                \
+      spdlog::lvl(__VA_ARGS__);                                                \
+  } while (false)
+/// @endcond
+
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+/// Log a message at level trace
+#define DOLFINX_LOG_TRACE(...) DOLFINX_LOG_IMPL(trace, __VA_ARGS__)
+#else
+#define DOLFINX_LOG_TRACE(...) (void)0
+#endif
+
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+/// Log a message at level debug
+#define DOLFINX_LOG_DEBUG(...) DOLFINX_LOG_IMPL(debug, __VA_ARGS__)
+#else
+#define DOLFINX_LOG_DEBUG(...) (void)0
+#endif
+
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_INFO
+/// Log a message at level info
+#define DOLFINX_LOG_INFO(...) DOLFINX_LOG_IMPL(info, __VA_ARGS__)
+#else
+#define DOLFINX_LOG_INFO(...) (void)0
+#endif
+
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_WARN
+/// Log a message at level warn
+#define DOLFINX_LOG_WARN(...) DOLFINX_LOG_IMPL(warn, __VA_ARGS__)
+#else
+#define DOLFINX_LOG_WARN(...) (void)0
+#endif
+
+/// @brief Record a structured event, a name and an integer value, with
+/// the profiler instead of formatting a message.
+///
+/// Events are counted in the profiler summary as regions with no
+/// duration, with the name as the last component of the region path,
+/// and are written as instant events with the value to the profiler
+/// trace (see common::profiler::enable_trace). Events are compiled in
+/// if `DOLFINX_LOG_LEVEL` is debug or lower.
+///
+/// @param name Event name (string literal)
+/// @param value Integer value of the event, e.g. a size
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define DOLFINX_LOG_EVENT(name, value)                                         \
+  dolfinx::common::profiler::impl::event(name, value)
+#else
+#define DOLFINX_LOG_EVENT(name, value) (void)0
+#endif
+
 namespace dolfinx
 {
 
@@ -25,3 +95,13 @@ namespace dolfinx
 void init_logging(int argc, char* argv[]);
 
 } // namespace dolfinx
+
+namespace dolfinx::common::profiler::impl
+{
+/// @brief Record an event on the calling thread (see
+/// DOLFINX_LOG_EVENT).
+/// @param[in] name Event name. The string must remain valid until the
+/// profiler data is discarded, e.g. a string literal.
+/// @param[in] value Value of the event
+void event(const char* name, std::int64_t value);
+} // namespace dolfinx::common::profiler::impl
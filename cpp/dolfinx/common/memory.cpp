@@ -0,0 +1,409 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "memory.h"
+#include "MPI.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <sstream>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#include <unistd.h>
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+// Tracker on the stack of running trackers (bytes)
+struct Frame
+{
+  std::size_t start, peak;
+};
+
+// Recorded high-water marks of a tracker name
+struct HighWaterMark
+{
+  std::int64_t calls = 0;
+  std::size_t peak = 0, increase = 0;
+};
+
+std::atomic<bool> tracking = false;
+std::mutex tracker_mutex;
+std::vector<Frame> tracker_stack;
+std::map<std::string, HighWaterMark> high_water_marks;
+
+// Value of a field, in kB, of /proc/self/status. Returns zero if not
+// available.
+std::size_t proc_status_kb(const std::string& field)
+{
+  std::ifstream file("/proc/self/status");
+  for (std::string line; std::getline(file, line);)
+  {
+    if (line.starts_with(field + ":"))
+    {
+      std::stringstream ss(line.substr(field.size() + 1));
+      std::size_t kb = 0;
+      ss >> kb;
+      return kb;
+    }
+  }
+  return 0;
+}
+
+// Reset the peak resident memory of the process (Linux >= 4.0)
+void reset_peak_resident_memory()
+{
+  std::ofstream file("/proc/self/clear_refs");
+  if (file)
+    file << "5";
+}
+
+// Gather data to rank 0, with the data of each rank as a separate
+// container
+template <typename T>
+std::vector<std::vector<T>> gather(MPI_Comm comm, std::span<const T> x)
+{
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<int> counts(size), offsets(size + 1, 0);
+  const int local_size = x.size();
+  int err = MPI_Gather(&local_size, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+                       comm);
+  dolfinx::MPI::check_error(comm, err);
+  std::partial_sum(counts.begin(), counts.end(), std::next(offsets.begin()));
+  std::vector<T> data(offsets.back());
+  err = MPI_Gatherv(x.data(), x.size(), dolfinx::MPI::mpi_type<T>(),
+                    data.data(), counts.data(), offsets.data(),
+                    dolfinx::MPI::mpi_type<T>(), 0, comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  std::vector<std::vector<T>> all;
+  if (dolfinx::MPI::rank(comm) == 0)
+  {
+    for (int p = 0; p < size; ++p)
+      all.emplace_back(data.data() + offsets[p], data.data() + offsets[p + 1]);
+  }
+  return all;
+}
+
+// Gather keyed rows of N values to rank 0. On rank 0, returns for each
+// key the values of each rank that has the key.
+template <std::size_t N>
+std::map<std::vector<std::string>, std::vector<std::array<double, N>>>
+gather_rows(
+    MPI_Comm comm,
+    const std::vector<std::pair<std::vector<std::string>,
+                                std::array<double, N>>>& rows)
+{
+  // Path components are separated by the unit separator, and keys by
+  // null characters
+  std::string keys;
+  std::vector<double> values;
+  for (auto& [path, v] : rows)
+  {
+    for (std::size_t i = 0; i < path.size(); ++i)
+      keys += (i > 0 ? "\x1f" : "") + path[i];
+    keys += '\0';
+    values.insert(values.end(), v.begin(), v.end());
+  }
+
+  std::vector<std::vector<char>> keys_all
+      = gather(comm, std::span<const char>(keys));
+  std::vector<std::vector<double>> values_all
+      = gather(comm, std::span<const double>(values));
+
+  std::map<std::vector<std::string>, std::vector<std::array<double, N>>> out;
+  for (std::size_t p = 0; p < keys_all.size(); ++p)
+  {
+    std::stringstream ss(
+        std::string(keys_all[p].begin(), keys_all[p].end()));
+    const double* v = values_all[p].data();
+    for (std::string key; std::getline(ss, key, '\0'); v += N)
+    {
+      std::vector<std::string> path;
+      std::stringstream sk(key);
+      for (std::string name; std::getline(sk, name, '\x1f');)
+        path.push_back(name);
+      std::array<double, N> r;
+      std::copy_n(v, N, r.begin());
+      out[path].push_back(r);
+    }
+  }
+
+  return out;
+}
+
+// Append the total of each node of a memory usage tree. Nodes with the
+// same path, e.g. the parts of several objects of the same type, are
+// summed.
+void flatten(const MemoryUsage& usage, std::vector<std::string>& path,
+             std::map<std::vector<std::string>, double>& totals)
+{
+  path.push_back(usage.name);
+  totals[path] += static_cast<double>(usage.total());
+  for (const MemoryUsage& c : usage.children)
+    flatten(c, path, totals);
+  path.pop_back();
+}
+
+// Join the components of a path
+std::string join(const std::vector<std::string>& path)
+{
+  std::string s;
+  for (std::size_t i = 0; i < path.size(); ++i)
+    s += (i > 0 ? " / " : "") + path[i];
+  return s;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+void* FirstTouchResource::do_allocate(std::size_t bytes,
+                                      std::size_t alignment)
+{
+  void* p = _upstream->allocate(bytes, this->alignment(bytes, alignment));
+  if (bytes < _threshold)
+    return p;
+
+#ifdef __linux__
+  // The hint is advisory, so failure (e.g. transparent huge pages
+  // disabled) is ignored
+  if (_huge_pages and bytes >= huge_page_size)
+    madvise(p, bytes - bytes % huge_page_size, MADV_HUGEPAGE);
+#endif
+
+  // Zero-fill contiguous chunks of the allocation, each on one thread
+  std::byte* data = static_cast<std::byte*>(p);
+  common::parallel_for(bytes, _num_threads,
+                       [data](std::int64_t b0, std::int64_t b1)
+                       { std::memset(data + b0, 0, b1 - b0); });
+  ++_num_touched;
+  return p;
+}
+//-----------------------------------------------------------------------------
+SharedWindow::SharedWindow(MPI_Comm comm, std::size_t bytes) : _bytes(bytes)
+{
+  // Segments are padded so that the start of each segment can be
+  // aligned. Shared memory is mapped at page boundaries, so the
+  // alignment of an address is the same on all ranks of the node.
+  constexpr std::size_t align = 64;
+
+  int err = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED,
+                                dolfinx::MPI::rank(comm), MPI_INFO_NULL,
+                                &_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "alloc_shared_noncontig", "true");
+  void* base = nullptr;
+  err = MPI_Win_allocate_shared(bytes + align, 1, info, _comm, &base, &_win);
+  dolfinx::MPI::check_error(comm, err);
+  MPI_Info_free(&info);
+
+  const int size = dolfinx::MPI::size(_comm);
+  _segments.resize(size);
+  for (int r = 0; r < size; ++r)
+  {
+    MPI_Aint segment_size;
+    int disp_unit;
+    void* p = nullptr;
+    err = MPI_Win_shared_query(_win, r, &segment_size, &disp_unit, &p);
+    dolfinx::MPI::check_error(comm, err);
+    std::size_t space = segment_size;
+    _segments[r] = static_cast<std::byte*>(
+        std::align(align, space - align, p, space));
+  }
+
+  err = MPI_Win_lock_all(MPI_MODE_NOCHECK, _win);
+  dolfinx::MPI::check_error(comm, err);
+}
+//-----------------------------------------------------------------------------
+SharedWindow::~SharedWindow()
+{
+  MPI_Win_unlock_all(_win);
+  MPI_Win_free(&_win);
+  MPI_Comm_free(&_comm);
+}
+//-----------------------------------------------------------------------------
+void SharedWindow::sync() const { MPI_Win_sync(_win); }
+//-----------------------------------------------------------------------------
+void* SharedWindow::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  const int rank = dolfinx::MPI::rank(_comm);
+  if (_allocated or bytes > _bytes
+      or reinterpret_cast<std::uintptr_t>(_segments[rank]) % alignment != 0)
+  {
+    throw std::bad_alloc();
+  }
+
+  _allocated = true;
+  return _segments[rank];
+}
+//-----------------------------------------------------------------------------
+Table common::memory_report(MPI_Comm comm, const MemoryUsage& usage)
+{
+  std::map<std::vector<std::string>, double> totals;
+  std::vector<std::string> path;
+  flatten(usage, path, totals);
+
+  std::vector<std::pair<std::vector<std::string>, std::array<double, 1>>>
+      rows;
+  for (auto& [p, bytes] : totals)
+    rows.push_back({p, {bytes * 1e-6}});
+  auto all = gather_rows(comm, rows);
+
+  Table table("Summary of memory usage (MB)");
+  if (dolfinx::MPI::rank(comm) > 0)
+    return table;
+
+  // Nodes are sorted so that children follow their parent
+  const std::size_t size = dolfinx::MPI::size(comm);
+  for (auto& [p, values] : all)
+  {
+    // Ranks without the node have zero
+    double min = values.size() < size ? 0
+                                      : std::numeric_limits<double>::max();
+    double max = 0, sum = 0;
+    for (auto& v : values)
+    {
+      min = std::min(min, v[0]);
+      max = std::max(max, v[0]);
+      sum += v[0];
+    }
+
+    const std::string row = join(p);
+    table.set(row, "min", min);
+    table.set(row, "max", max);
+    table.set(row, "sum", sum);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+std::size_t common::resident_memory()
+{
+  std::ifstream file("/proc/self/statm");
+  std::size_t size = 0, resident = 0;
+  if (file >> size >> resident)
+    return resident * sysconf(_SC_PAGESIZE);
+  else
+    return 0;
+}
+//-----------------------------------------------------------------------------
+std::size_t common::peak_resident_memory()
+{
+  if (std::size_t kb = proc_status_kb("VmHWM"); kb > 0)
+    return kb * 1024;
+
+  // Fall back to the peak since the start of the process (in kB on
+  // Linux)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+  else
+    return 0;
+}
+//-----------------------------------------------------------------------------
+void common::enable_memory_tracking(bool state) { tracking = state; }
+//-----------------------------------------------------------------------------
+bool common::memory_tracking_enabled() { return tracking; }
+//-----------------------------------------------------------------------------
+Table common::memory_high_water_marks(MPI_Comm comm)
+{
+  std::vector<std::pair<std::vector<std::string>, std::array<double, 3>>>
+      rows;
+  {
+    std::scoped_lock lock(tracker_mutex);
+    for (auto& [name, hwm] : high_water_marks)
+    {
+      rows.push_back({{name},
+                      {static_cast<double>(hwm.calls), hwm.peak * 1e-6,
+                       hwm.increase * 1e-6}});
+    }
+  }
+  auto all = gather_rows(comm, rows);
+
+  Table table("Summary of memory high-water marks (MB)");
+  if (dolfinx::MPI::rank(comm) > 0)
+    return table;
+
+  for (auto& [p, values] : all)
+  {
+    std::array<double, 3> r = {0, 0, 0};
+    for (auto& v : values)
+      for (std::size_t i = 0; i < 3; ++i)
+        r[i] = std::max(r[i], v[i]);
+
+    table.set(p.front(), "calls", static_cast<int>(r[0]));
+    table.set(p.front(), "peak", r[1]);
+    table.set(p.front(), "increase", r[2]);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void common::reset_memory_high_water_marks()
+{
+  std::scoped_lock lock(tracker_mutex);
+  high_water_marks.clear();
+}
+//-----------------------------------------------------------------------------
+MemoryTracker::MemoryTracker(std::string name)
+    : _name(std::move(name)), _handle(-1)
+{
+  if (!tracking)
+    return;
+
+  std::scoped_lock lock(tracker_mutex);
+
+  // Propagate the peak so far to the enclosing tracker before the peak
+  // is reset
+  if (!tracker_stack.empty())
+  {
+    tracker_stack.back().peak
+        = std::max(tracker_stack.back().peak, peak_resident_memory());
+  }
+
+  reset_peak_resident_memory();
+  const std::size_t start = resident_memory();
+  _handle = tracker_stack.size();
+  tracker_stack.push_back({start, start});
+}
+//-----------------------------------------------------------------------------
+MemoryTracker::~MemoryTracker() { stop(); }
+//-----------------------------------------------------------------------------
+void MemoryTracker::stop()
+{
+  if (_handle < 0)
+    return;
+
+  std::scoped_lock lock(tracker_mutex);
+  assert(_handle == static_cast<int>(tracker_stack.size()) - 1);
+  Frame frame = tracker_stack.back();
+  tracker_stack.pop_back();
+  _handle = -1;
+
+  const std::size_t peak = std::max(frame.peak, peak_resident_memory());
+  if (!tracker_stack.empty())
+    tracker_stack.back().peak = std::max(tracker_stack.back().peak, peak);
+
+  HighWaterMark& hwm = high_water_marks[_name];
+  ++hwm.calls;
+  hwm.peak = std::max(hwm.peak, peak);
+  hwm.increase = std::max(hwm.increase, peak - std::min(peak, frame.start));
+}
+//-----------------------------------------------------------------------------
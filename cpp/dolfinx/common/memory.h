@@ -0,0 +1,487 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Table.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <mpi.h>
+#include <new>
+#include <string>
+#include <vector>
+
+/// @file memory.h
+/// @brief Memory resources for the allocation of data and scratch
+/// buffers.
+///
+/// Data structures that take a container type, e.g. la::Vector, can
+/// use a container with a `std::pmr::polymorphic_allocator`, e.g.
+/// `la::Vector<T, std::pmr::vector<T>>`, and allocate their data and
+/// communication buffers from a memory resource.
+///
+/// The scratch buffers that the finite element assemblers create for
+/// each call are allocated from `std::pmr::get_default_resource()`.
+/// Setting the default resource to a pool, e.g.
+/// `std::pmr::synchronized_pool_resource`, re-uses the scratch memory
+/// across assembly calls. The default resource must be thread-safe if
+/// the threaded assemblers are used.
+///
+/// FirstTouchResource places large allocations on the NUMA nodes of
+/// the threads that work on them.
+///
+/// CountingResource can be used to check that a part of a program,
+/// e.g. a time step, performs no allocations. SharedWindow holds the
+/// data of a la::Vector in node-local shared memory for ghost updates
+/// without messages between ranks on the same node.
+///
+/// The memory held by the main data structures (mesh::Mesh,
+/// fem::DofMap, la::MatrixCSR, ...) is reported by their
+/// `memory_usage()` member functions as a MemoryUsage tree, and can be
+/// summarised over processes with memory_report(). MemoryTracker
+/// records the high-water mark of the process memory during, e.g.,
+/// mesh creation and assembly.
+
+namespace dolfinx::common
+{
+/// @brief Memory resource that counts the allocations that are passed
+/// to an upstream resource.
+///
+/// The counters are atomic, so the resource is thread-safe if the
+/// upstream resource is.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  /// @brief Create a counting resource.
+  /// @param[in] upstream Resource to allocate from. It must outlive this
+  /// resource.
+  explicit CountingResource(
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : _upstream(upstream)
+  {
+  }
+
+  /// Number of allocations
+  std::size_t num_allocations() const { return _num_allocations; }
+
+  /// Number of deallocations
+  std::size_t num_deallocations() const { return _num_deallocations; }
+
+  /// Number of bytes currently allocated
+  std::size_t bytes_allocated() const { return _bytes; }
+
+  /// Peak number of bytes allocated
+  std::size_t peak_bytes_allocated() const { return _peak_bytes; }
+
+  /// Reset the number of allocations and deallocations to zero
+  void reset()
+  {
+    _num_allocations = 0;
+    _num_deallocations = 0;
+  }
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    void* p = _upstream->allocate(bytes, alignment);
+    ++_num_allocations;
+    std::size_t b = _bytes += bytes;
+    std::size_t peak = _peak_bytes;
+    while (b > peak and !_peak_bytes.compare_exchange_weak(peak, b))
+      ;
+    return p;
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override
+  {
+    _upstream->deallocate(p, bytes, alignment);
+    ++_num_deallocations;
+    _bytes -= bytes;
+  }
+
+  bool
+  do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  // Upstream resource
+  std::pmr::memory_resource* _upstream;
+
+  // Counters
+  std::atomic<std::size_t> _num_allocations = 0, _num_deallocations = 0,
+                           _bytes = 0, _peak_bytes = 0;
+};
+
+/// @brief Memory resource that allocates with `MPI_Alloc_mem`.
+///
+/// MPI implementations can return memory that is registered
+/// (page-locked) with the network interface, which avoids copies or
+/// registration of communication buffers, e.g. for the ghost updates of
+/// a la::Vector with a `std::pmr::vector` container.
+///
+/// @note MPI must be initialized when memory is allocated and released.
+class MPIResource : public std::pmr::memory_resource
+{
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    // MPI_Alloc_mem does not guarantee an alignment, so allocate
+    // extra bytes and store the pointer returned by MPI before the
+    // aligned block
+    const std::size_t extra = alignment + sizeof(void*);
+    void* p = nullptr;
+    if (MPI_Alloc_mem(bytes + extra, MPI_INFO_NULL, &p) != MPI_SUCCESS)
+      throw std::bad_alloc();
+    std::size_t space = bytes + extra - sizeof(void*);
+    void* aligned = static_cast<std::byte*>(p) + sizeof(void*);
+    std::align(alignment, bytes, aligned, space);
+    std::memcpy(static_cast<std::byte*>(aligned) - sizeof(void*), &p,
+                sizeof(void*));
+    return aligned;
+  }
+
+  void do_deallocate(void* p, std::size_t, std::size_t) override
+  {
+    void* base = nullptr;
+    std::memcpy(&base, static_cast<std::byte*>(p) - sizeof(void*),
+                sizeof(void*));
+    MPI_Free_mem(base);
+  }
+
+  bool
+  do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return dynamic_cast<const MPIResource*>(&other) != nullptr;
+  }
+};
+
+/// @brief Memory resource that places large allocations on the NUMA
+/// nodes of the threads that later work on them (first touch).
+///
+/// Operating systems place a page on the NUMA node of the thread that
+/// first writes to it. Containers that are value-initialised by the
+/// main thread therefore have all their pages on one node, which
+/// limits the memory bandwidth of threaded loops on multi-socket
+/// nodes. This resource zero-fills each allocation of at least
+/// `threshold` bytes from `num_threads` threads, with the bytes split
+/// into contiguous chunks as by parallel_for. The pages of a container
+/// of `n` elements then reside where the chunks of `parallel_for(n,
+/// num_threads, ...)` run (up to the pages that straddle chunk
+/// boundaries), provided the threads are pinned to cores. The
+/// subsequent value-initialisation by the container does not move the
+/// pages.
+///
+/// Allocations of at least `huge_page_size` bytes can be aligned to
+/// the huge page size and marked for transparent huge pages
+/// (`madvise(MADV_HUGEPAGE)`, Linux only), which reduces TLB misses
+/// for large arrays.
+///
+/// For example, the data of a
+/// `la::Vector<T, std::pmr::vector<T>>` is placed by passing
+/// `std::pmr::polymorphic_allocator<T>(&resource)` to the constructor,
+/// and that of a `la::MatrixCSR<T, std::pmr::vector<T>>` by passing
+/// an allocator with the matrix layout. Smaller allocations, e.g. the
+/// communication buffers, are passed to the upstream resource
+/// unchanged, so the resource can also be set as the default resource.
+class FirstTouchResource : public std::pmr::memory_resource
+{
+public:
+  /// @brief Create a first touch resource.
+  /// @param[in] num_threads Number of threads that touch the memory.
+  /// If zero or negative, the default number of threads (see
+  /// common::num_threads) is used at each allocation.
+  /// @param[in] threshold Allocations of fewer bytes are not touched.
+  /// @param[in] huge_pages If true, allocations of at least
+  /// `huge_page_size` bytes are aligned to the huge page size and
+  /// marked for transparent huge pages.
+  /// @param[in] upstream Resource to allocate from. It must outlive
+  /// this resource.
+  explicit FirstTouchResource(
+      int num_threads = 0, std::size_t threshold = 1 << 20,
+      bool huge_pages = false,
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : _num_threads(num_threads), _threshold(threshold),
+        _huge_pages(huge_pages), _upstream(upstream)
+  {
+  }
+
+  /// Size of a (transparent) huge page in bytes
+  static constexpr std::size_t huge_page_size = 1 << 21;
+
+  /// Number of allocations that were touched
+  std::size_t num_touched() const { return _num_touched; }
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override
+  {
+    _upstream->deallocate(p, bytes, this->alignment(bytes, alignment));
+  }
+
+  bool
+  do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  // Alignment of an allocation from the upstream resource
+  std::size_t alignment(std::size_t bytes, std::size_t alignment) const
+  {
+    return (_huge_pages and bytes >= huge_page_size)
+               ? std::max(alignment, huge_page_size)
+               : alignment;
+  }
+
+  // Number of threads
+  int _num_threads;
+
+  // Smallest allocation that is touched
+  std::size_t _threshold;
+
+  // Use transparent huge pages
+  bool _huge_pages;
+
+  // Upstream resource
+  std::pmr::memory_resource* _upstream;
+
+  // Number of touched allocations
+  std::atomic<std::size_t> _num_touched = 0;
+};
+
+/// @brief Memory resource backed by an MPI-3 shared memory window
+/// (`MPI_Win_allocate_shared`) on the ranks of a node.
+///
+/// Each rank has a segment of the window, which is returned by the
+/// first allocation from the resource. The segments of the other ranks
+/// on the node can be accessed directly with SharedWindow::segment,
+/// e.g. by common::Scatterer to read ghost values from the array of the
+/// owning rank instead of exchanging messages. The ranks of a node are
+/// numbered in the order of their rank on the communicator that the
+/// window is created on.
+///
+/// A passive target access epoch (`MPI_Win_lock_all`) is open for the
+/// lifetime of the window. Ranks that access each others segments must
+/// synchronise, e.g. by messages, and call SharedWindow::sync after
+/// writing and before reading.
+///
+/// @note The constructor and destructor are collective.
+class SharedWindow : public std::pmr::memory_resource
+{
+public:
+  /// @brief Create a window.
+  /// @param[in] comm Communicator. The window is created for the ranks
+  /// of `comm` on the node of the caller.
+  /// @param[in] bytes Size of the segment of the caller in bytes
+  SharedWindow(MPI_Comm comm, std::size_t bytes);
+
+  // Copy constructor (deleted)
+  SharedWindow(const SharedWindow&) = delete;
+
+  // Assignment operator (deleted)
+  SharedWindow& operator=(const SharedWindow&) = delete;
+
+  /// Destructor (collective)
+  ~SharedWindow();
+
+  /// @brief Segment of a rank on the node.
+  /// @param[in] node_rank Rank on the node communicator
+  /// @return Pointer to the start of the segment
+  std::byte* segment(int node_rank) const { return _segments[node_rank]; }
+
+  /// Size of the segment of the caller in bytes
+  std::size_t size() const { return _bytes; }
+
+  /// @brief Synchronise the public and private copies of the window
+  /// (`MPI_Win_sync`), which is a memory barrier for the accesses of
+  /// ranks on the node.
+  void sync() const;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void*, std::size_t, std::size_t) override
+  {
+    _allocated = false;
+  }
+
+  bool
+  do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  // Communicator of the ranks on the node
+  MPI_Comm _comm;
+
+  // Window
+  MPI_Win _win;
+
+  // Segment size of the caller
+  std::size_t _bytes;
+
+  // Start of the segment of each rank on the node
+  std::vector<std::byte*> _segments;
+
+  // True if the segment of the caller has been allocated
+  bool _allocated = false;
+};
+
+/// @brief Memory used by a data structure, with a breakdown into the
+/// memory used by its parts.
+struct MemoryUsage
+{
+  /// Name of the data structure or part
+  std::string name;
+
+  /// Bytes used directly by the data structure, excluding children
+  std::size_t bytes = 0;
+
+  /// Parts of the data structure
+  std::vector<MemoryUsage> children;
+
+  /// @brief Total number of bytes, including all children.
+  std::size_t total() const
+  {
+    std::size_t b = bytes;
+    for (const MemoryUsage& c : children)
+      b += c.total();
+    return b;
+  }
+
+  /// @brief Add a part.
+  /// @param[in] child Memory usage of the part
+  /// @return Reference to the added part
+  MemoryUsage& add(MemoryUsage child)
+  {
+    return children.emplace_back(std::move(child));
+  }
+
+  /// @brief Add a part without children.
+  /// @param[in] child_name Name of the part
+  /// @param[in] child_bytes Bytes used by the part
+  /// @return Reference to the added part
+  MemoryUsage& add(std::string child_name, std::size_t child_bytes)
+  {
+    return add(MemoryUsage{std::move(child_name), child_bytes, {}});
+  }
+};
+
+/// @brief Number of bytes allocated by a container, based on its
+/// capacity. The memory allocated by nested containers, e.g.
+/// `std::vector<std::vector<int>>`, is included.
+/// @param[in] c Container
+/// @return Allocated bytes
+template <typename C>
+std::size_t capacity_bytes(const C& c)
+{
+  std::size_t b = c.capacity() * sizeof(typename C::value_type);
+  if constexpr (requires(const typename C::value_type& v) { v.capacity(); })
+  {
+    for (auto& v : c)
+      b += capacity_bytes(v);
+  }
+  return b;
+}
+
+/// @brief Summary of a memory usage tree in a Table, with the minimum,
+/// maximum and sum over the processes of the total of each node.
+///
+/// Rows are the node paths, the names of the enclosing nodes and of the
+/// node separated by " / ", and values are in megabytes (10^6 bytes).
+/// Processes without a node count as using no memory for it. Objects
+/// shared by several data structures, e.g. common::IndexMap, are
+/// counted for each. Collective. The table is returned on rank 0;
+/// other ranks receive an empty table.
+/// @param[in] comm MPI communicator
+/// @param[in] usage Memory usage on this process
+/// @return Table with a row per node
+Table memory_report(MPI_Comm comm, const MemoryUsage& usage);
+
+/// @brief Current resident memory of the process.
+/// @return Resident memory in bytes, or zero if not available
+std::size_t resident_memory();
+
+/// @brief Peak resident memory (high-water mark) of the process.
+///
+/// The peak is reset by MemoryTracker, if the operating system
+/// supports this (Linux).
+/// @return Peak resident memory in bytes, or zero if not available
+std::size_t peak_resident_memory();
+
+/// @brief Enable or disable the recording of memory high-water marks by
+/// MemoryTracker.
+///
+/// Recording is disabled by default.
+/// @param[in] state True to record high-water marks
+void enable_memory_tracking(bool state);
+
+/// @brief Check if memory high-water marks are recorded.
+/// @return True if high-water marks are recorded
+bool memory_tracking_enabled();
+
+/// @brief Summary of the recorded high-water marks in a Table.
+///
+/// For each tracker name, the columns are the maximum number of calls
+/// over processes, and the maximum over calls and processes of the
+/// peak resident memory and of its increase over the resident memory
+/// at the start of the call (both in megabytes). Collective. The table
+/// is returned on rank 0; other ranks receive an empty table.
+/// @param[in] comm MPI communicator
+/// @return Table with a row per tracker name
+Table memory_high_water_marks(MPI_Comm comm);
+
+/// @brief Discard all recorded high-water marks.
+void reset_memory_high_water_marks();
+
+/// @brief Record the high-water mark of the resident memory of the
+/// process for the lifetime of the object.
+///
+/// The basic usage is
+///
+///   {
+///     common::MemoryTracker tracker("Assemble matrix");
+///     ...
+///   }
+///
+/// Nothing is recorded unless enable_memory_tracking() has been called.
+/// The peak resident memory of the process is reset when a tracker is
+/// started, and the peaks of nested trackers are propagated to the
+/// enclosing trackers. If the peak cannot be reset, the recorded peak
+/// is the peak since the start of the process. Trackers measure the
+/// whole process and should be created on the main thread only.
+class MemoryTracker
+{
+public:
+  /// @brief Start a tracker.
+  /// @param[in] name Name under which the high-water mark is recorded
+  explicit MemoryTracker(std::string name);
+
+  // Copy constructor (deleted)
+  MemoryTracker(const MemoryTracker&) = delete;
+
+  // Assignment operator (deleted)
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  /// Stop the tracker
+  ~MemoryTracker();
+
+  /// @brief Stop the tracker and record the high-water mark.
+  void stop();
+
+private:
+  std::string _name;
+  int _handle;
+};
+
+} // namespace dolfinx::common
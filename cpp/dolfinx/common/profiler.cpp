@@ -0,0 +1,602 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "profiler.h"
+#include "MPI.h"
+#include "log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+// Node of the call tree of a thread
+struct Node
+{
+  const char* name;
+  std::int32_t parent;
+  std::vector<std::int32_t> children = {};
+  std::int64_t count = 0;
+  std::int64_t ns = 0;
+};
+
+// Open region on the stack of a thread
+struct Frame
+{
+  std::int32_t node;
+  std::int64_t start;
+  bool open;
+};
+
+// Instance of a region in a trace (times in ns), or an instant event
+// (see DOLFINX_LOG_EVENT) with a value
+struct Event
+{
+  std::int32_t node;
+  std::int64_t start, end;
+  std::int64_t value = 0;
+  bool instant = false;
+};
+
+// Profiling data of a thread. Node 0 is the root of the call tree.
+struct ThreadData
+{
+  int id;
+  std::atomic<bool> in_use;
+  ThreadData* next = nullptr;
+  std::vector<Node> nodes = {Node{"", -1}};
+  std::vector<Frame> stack = {};
+  std::vector<Event> events = {};
+};
+
+std::atomic<bool> recording = true;
+std::atomic<bool> tracing = false;
+
+// Data of all threads that have recorded regions. The list only grows
+// and entries are re-used by new threads once a thread has exited.
+std::atomic<ThreadData*> threads = nullptr;
+std::atomic<int> num_threads = 0;
+
+// Communication statistics of a call site
+struct CommSite
+{
+  std::int64_t calls = 0;
+  std::int64_t messages = 0;
+  std::int64_t bytes = 0;
+  std::int64_t max_neighbours = 0;
+  double wait = 0;
+};
+
+std::atomic<bool> comm_recording = false;
+
+// Communication statistics by call site, and messages and bytes sent
+// to each rank. Communication calls are not on hot paths, so the data
+// is protected by a mutex.
+std::mutex comm_mutex;
+std::map<std::string, CommSite> comm_sites;
+std::map<int, std::array<std::int64_t, 2>> comm_matrix;
+
+// Monotonic clock in nanoseconds
+std::int64_t now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Claim the data of an exited thread, or append new thread data to the
+// list without locking
+ThreadData* acquire()
+{
+  for (ThreadData* t = threads.load(std::memory_order_acquire); t;
+       t = t->next)
+  {
+    bool unused = false;
+    if (t->in_use.compare_exchange_strong(unused, true,
+                                          std::memory_order_acquire))
+    {
+      t->stack.clear();
+      return t;
+    }
+  }
+
+  ThreadData* t = new ThreadData{num_threads++, true};
+  t->next = threads.load(std::memory_order_relaxed);
+  while (!threads.compare_exchange_weak(t->next, t, std::memory_order_release,
+                                        std::memory_order_relaxed))
+  {
+  }
+  return t;
+}
+
+// Release the thread data when the thread exits
+struct ThreadHandle
+{
+  ThreadData* data = acquire();
+  ~ThreadHandle() { data->in_use.store(false, std::memory_order_release); }
+};
+
+ThreadData& local_data()
+{
+  thread_local ThreadHandle handle;
+  return *handle.data;
+}
+
+// Region timings of this process, keyed by the region path
+std::map<std::vector<std::string>, std::pair<std::int64_t, std::int64_t>>
+merge_threads()
+{
+  std::map<std::vector<std::string>, std::pair<std::int64_t, std::int64_t>>
+      merged;
+  for (ThreadData* t = threads.load(std::memory_order_acquire); t;
+       t = t->next)
+  {
+    // Parents precede their children in the list of nodes
+    std::vector<std::vector<std::string>> paths(t->nodes.size());
+    for (std::size_t i = 1; i < t->nodes.size(); ++i)
+    {
+      const Node& node = t->nodes[i];
+      paths[i] = paths[node.parent];
+      paths[i].push_back(node.name);
+      if (node.count > 0)
+      {
+        auto& [count, ns] = merged[paths[i]];
+        count += node.count;
+        ns += node.ns;
+      }
+    }
+  }
+  return merged;
+}
+
+// Name of a communication call site: the path of the innermost open
+// region on the calling thread and the function name
+std::string comm_site(const char* name)
+{
+  ThreadData& t = local_data();
+  std::string site = name;
+  if (!t.stack.empty())
+  {
+    for (std::int32_t n = t.stack.back().node; n > 0; n = t.nodes[n].parent)
+      site = std::string(t.nodes[n].name) + " / " + site;
+  }
+  return site;
+}
+
+// Find the child with a name of the innermost open region on a thread,
+// or add it
+std::int32_t child(ThreadData& t, const char* name)
+{
+  const std::int32_t parent = t.stack.empty() ? 0 : t.stack.back().node;
+  auto& children = t.nodes[parent].children;
+  auto it = std::ranges::find_if(children, [&t, name](std::int32_t c)
+                                 { return t.nodes[c].name == name; });
+  if (it != children.end())
+    return *it;
+
+  std::int32_t node = t.nodes.size();
+  children.push_back(node);
+  t.nodes.push_back(Node{name, parent});
+  return node;
+}
+
+std::string join(const std::vector<std::string>& path, const std::string& sep)
+{
+  std::string s;
+  for (std::size_t i = 0; i < path.size(); ++i)
+    s += (i > 0 ? sep : "") + path[i];
+  return s;
+}
+
+std::vector<std::string> split(const std::string& s, char sep)
+{
+  std::vector<std::string> parts;
+  std::stringstream ss(s);
+  for (std::string part; std::getline(ss, part, sep);)
+    parts.push_back(part);
+  return parts;
+}
+
+// Escape a string for JSON
+std::string escape(const std::string& s)
+{
+  std::string out;
+  for (char c : s)
+  {
+    if (c == '"' or c == '\\')
+      out += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      out += c;
+  }
+  return out;
+}
+
+// Gather data to rank 0, with the data of each rank as a separate
+// container
+template <typename T>
+std::vector<std::vector<T>> gather(MPI_Comm comm, std::span<const T> x)
+{
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<int> counts(size), offsets(size + 1, 0);
+  const int local_size = x.size();
+  int err = MPI_Gather(&local_size, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+                       comm);
+  dolfinx::MPI::check_error(comm, err);
+  std::partial_sum(counts.begin(), counts.end(), std::next(offsets.begin()));
+  std::vector<T> data(offsets.back());
+  err = MPI_Gatherv(x.data(), x.size(), dolfinx::MPI::mpi_type<T>(),
+                    data.data(), counts.data(), offsets.data(),
+                    dolfinx::MPI::mpi_type<T>(), 0, comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  std::vector<std::vector<T>> all;
+  if (dolfinx::MPI::rank(comm) == 0)
+  {
+    for (int p = 0; p < size; ++p)
+      all.emplace_back(data.data() + offsets[p], data.data() + offsets[p + 1]);
+  }
+  return all;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+void profiler::enable(bool state) { recording = state; }
+//-----------------------------------------------------------------------------
+bool profiler::enabled() { return recording; }
+//-----------------------------------------------------------------------------
+void profiler::enable_trace(bool state) { tracing = state; }
+//-----------------------------------------------------------------------------
+void profiler::reset()
+{
+  // The call trees are kept since regions may be open
+  for (ThreadData* t = threads.load(std::memory_order_acquire); t;
+       t = t->next)
+  {
+    for (Node& node : t->nodes)
+      node.count = node.ns = 0;
+    t->events.clear();
+  }
+
+  std::scoped_lock lock(comm_mutex);
+  comm_sites.clear();
+  comm_matrix.clear();
+}
+//-----------------------------------------------------------------------------
+std::vector<profiler::Region> profiler::regions()
+{
+  std::vector<Region> regions;
+  for (auto& [path, timing] : merge_threads())
+  {
+    regions.push_back({join(path, " / "), static_cast<int>(path.size()) - 1,
+                       timing.first,
+                       static_cast<double>(timing.second) * 1e-9});
+  }
+  return regions;
+}
+//-----------------------------------------------------------------------------
+Table profiler::summary(MPI_Comm comm)
+{
+  // Pack the region paths, with the components separated by '\x1f',
+  // and the count and time of each region
+  std::string keys;
+  std::vector<double> values;
+  for (auto& [path, timing] : merge_threads())
+  {
+    keys += join(path, "\x1f") + '\0';
+    values.push_back(timing.first);
+    values.push_back(static_cast<double>(timing.second) * 1e-9);
+  }
+
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<std::vector<char>> keys_all
+      = gather(comm, std::span<const char>(keys));
+  std::vector<std::vector<double>> values_all
+      = gather(comm, std::span<const double>(values));
+
+  Table table("Summary of profiled regions");
+  if (dolfinx::MPI::rank(comm) > 0)
+    return table;
+
+  // Reduce over processes: (max count, min, sum, max)
+  std::map<std::vector<std::string>, std::array<double, 4>> reduced;
+  for (int p = 0; p < size; ++p)
+  {
+    std::stringstream ss(
+        std::string(keys_all[p].begin(), keys_all[p].end()));
+    const double* v = values_all[p].data();
+    for (std::string key; std::getline(ss, key, '\0'); v += 2)
+    {
+      auto [it, inserted] = reduced.insert(
+          {split(key, '\x1f'),
+           {0, std::numeric_limits<double>::max(), 0, 0}});
+      auto& r = it->second;
+      r[0] = std::max(r[0], v[0]);
+      r[1] = std::min(r[1], v[1]);
+      r[2] += v[1];
+      r[3] = std::max(r[3], v[1]);
+    }
+  }
+
+  // Regions are sorted so that children follow their parent
+  for (auto& [path, r] : reduced)
+  {
+    const std::string row = join(path, " / ");
+    table.set(row, "reps", static_cast<int>(r[0]));
+    table.set(row, "wall min", r[1]);
+    table.set(row, "wall avg", r[2] / size);
+    table.set(row, "wall max", r[3]);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void profiler::write_trace(MPI_Comm comm, const std::string& filename)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Time origin of this process
+  std::int64_t t0 = std::numeric_limits<std::int64_t>::max();
+  for (ThreadData* t = threads.load(std::memory_order_acquire); t;
+       t = t->next)
+  {
+    for (const Event& e : t->events)
+      t0 = std::min(t0, e.start);
+  }
+
+  std::stringstream ss;
+  ss.precision(15);
+  for (ThreadData* t = threads.load(std::memory_order_acquire); t;
+       t = t->next)
+  {
+    for (const Event& e : t->events)
+    {
+      ss << ",\n{\"name\": \"" << escape(t->nodes[e.node].name)
+         << "\", \"cat\": \"dolfinx\", ";
+      if (e.instant)
+      {
+        ss << "\"ph\": \"i\", \"s\": \"t\", \"ts\": "
+           << static_cast<double>(e.start - t0) * 1e-3
+           << ", \"args\": {\"value\": " << e.value << "}";
+      }
+      else
+      {
+        ss << "\"ph\": \"X\", \"ts\": "
+           << static_cast<double>(e.start - t0) * 1e-3
+           << ", \"dur\": " << static_cast<double>(e.end - e.start) * 1e-3;
+      }
+      ss << ", \"pid\": " << rank << ", \"tid\": " << t->id << "}";
+    }
+  }
+
+  const std::string local = ss.str();
+  std::vector<std::vector<char>> events
+      = gather(comm, std::span<const char>(local));
+  if (rank == 0)
+  {
+    std::ofstream file(filename);
+    if (!file)
+      throw std::runtime_error("Unable to open file: " + filename);
+
+    // Drop the leading comma of the first event
+    std::string all;
+    for (auto& e : events)
+      all.append(e.begin(), e.end());
+    file << "{\"traceEvents\": [" << (all.empty() ? all : all.substr(1))
+         << "\n]}\n";
+  }
+}
+//-----------------------------------------------------------------------------
+void profiler::enable_comm(bool state) { comm_recording = state; }
+//-----------------------------------------------------------------------------
+bool profiler::comm_enabled()
+{
+  return comm_recording.load(std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+void profiler::record_send(const char* name, std::span<const int> dest,
+                           std::span<const std::int32_t> counts,
+                           std::size_t item_size, std::size_t num_src)
+{
+  assert(dest.size() == counts.size());
+  const std::string site = comm_site(name);
+  std::scoped_lock lock(comm_mutex);
+  CommSite& data = comm_sites[site];
+  ++data.calls;
+  data.messages += dest.size();
+  data.max_neighbours = std::max<std::int64_t>(data.max_neighbours,
+                                               dest.size() + num_src);
+  for (std::size_t i = 0; i < dest.size(); ++i)
+  {
+    const std::int64_t bytes = counts[i] * item_size;
+    data.bytes += bytes;
+    auto& [messages_to, bytes_to] = comm_matrix[dest[i]];
+    ++messages_to;
+    bytes_to += bytes;
+  }
+}
+//-----------------------------------------------------------------------------
+void profiler::record_wait(const char* name, double seconds)
+{
+  const std::string site = comm_site(name);
+  std::scoped_lock lock(comm_mutex);
+  comm_sites[site].wait += seconds;
+}
+//-----------------------------------------------------------------------------
+Table profiler::comm_summary(MPI_Comm comm)
+{
+  // Pack the call site names and the statistics of each site
+  std::string keys;
+  std::vector<double> values;
+  {
+    std::scoped_lock lock(comm_mutex);
+    for (auto& [site, data] : comm_sites)
+    {
+      keys += site + '\0';
+      values.insert(values.end(),
+                    {static_cast<double>(data.calls),
+                     static_cast<double>(data.messages),
+                     static_cast<double>(data.bytes),
+                     static_cast<double>(data.max_neighbours), data.wait});
+    }
+  }
+
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<std::vector<char>> keys_all
+      = gather(comm, std::span<const char>(keys));
+  std::vector<std::vector<double>> values_all
+      = gather(comm, std::span<const double>(values));
+
+  Table table("Summary of MPI communication");
+  if (dolfinx::MPI::rank(comm) > 0)
+    return table;
+
+  // Reduce over processes: max calls, (sum, max) messages, (min, sum,
+  // max) bytes, max neighbours and (min, sum, max) wait time
+  constexpr double dmax = std::numeric_limits<double>::max();
+  std::map<std::string, std::array<double, 10>> reduced;
+  for (int p = 0; p < size; ++p)
+  {
+    std::stringstream ss(
+        std::string(keys_all[p].begin(), keys_all[p].end()));
+    const double* v = values_all[p].data();
+    for (std::string key; std::getline(ss, key, '\0'); v += 5)
+    {
+      auto [it, inserted]
+          = reduced.insert({key, {0, 0, 0, dmax, 0, 0, 0, dmax, 0, 0}});
+      auto& r = it->second;
+      r[0] = std::max(r[0], v[0]);
+      r[1] += v[1];
+      r[2] = std::max(r[2], v[1]);
+      r[3] = std::min(r[3], v[2]);
+      r[4] += v[2];
+      r[5] = std::max(r[5], v[2]);
+      r[6] = std::max(r[6], v[3]);
+      r[7] = std::min(r[7], v[4]);
+      r[8] += v[4];
+      r[9] = std::max(r[9], v[4]);
+    }
+  }
+
+  for (auto& [site, r] : reduced)
+  {
+    table.set(site, "calls", static_cast<int>(r[0]));
+    table.set(site, "msgs avg", r[1] / size);
+    table.set(site, "msgs max", static_cast<int>(r[2]));
+    table.set(site, "bytes min", r[3]);
+    table.set(site, "bytes avg", r[4] / size);
+    table.set(site, "bytes max", r[5]);
+    table.set(site, "neighbours max", static_cast<int>(r[6]));
+    table.set(site, "wait min", r[7]);
+    table.set(site, "wait avg", r[8] / size);
+    table.set(site, "wait max", r[9]);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void profiler::write_comm_matrix(MPI_Comm comm, const std::string& filename)
+{
+  // Pack (dest, messages, bytes) for each destination rank
+  std::vector<std::int64_t> local;
+  {
+    std::scoped_lock lock(comm_mutex);
+    for (auto& [dest, data] : comm_matrix)
+      local.insert(local.end(), {dest, data[0], data[1]});
+  }
+  std::vector<std::vector<std::int64_t>> all
+      = gather(comm, std::span<const std::int64_t>(local));
+
+  if (dolfinx::MPI::rank(comm) == 0)
+  {
+    std::ofstream file(filename);
+    if (!file)
+      throw std::runtime_error("Unable to open file: " + filename);
+    file << "rank,dest,messages,bytes\n";
+    for (std::size_t p = 0; p < all.size(); ++p)
+    {
+      for (std::size_t i = 0; i < all[p].size(); i += 3)
+      {
+        file << p << "," << all[p][i] << "," << all[p][i + 1] << ","
+             << all[p][i + 2] << "\n";
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::int32_t profiler::impl::begin(const char* name)
+{
+  if (!recording.load(std::memory_order_relaxed))
+    return -1;
+
+  ThreadData& t = local_data();
+  const std::int32_t node = child(t, name);
+  t.stack.push_back({node, now(), true});
+  return t.stack.size() - 1;
+}
+//-----------------------------------------------------------------------------
+void profiler::impl::event(const char* name, std::int64_t value)
+{
+  if (!recording.load(std::memory_order_relaxed))
+    return;
+
+  ThreadData& t = local_data();
+  const std::int32_t node = child(t, name);
+  ++t.nodes[node].count;
+  if (tracing.load(std::memory_order_relaxed))
+  {
+    const std::int64_t t0 = now();
+    t.events.push_back({node, t0, t0, value, true});
+  }
+}
+//-----------------------------------------------------------------------------
+void profiler::impl::end(std::int32_t region, bool record)
+{
+  const std::int64_t t1 = now();
+  ThreadData& t = local_data();
+
+  // Ignore regions that were not opened on this thread
+  if (region < 0 or region >= static_cast<std::int32_t>(t.stack.size()))
+    return;
+
+  Frame& frame = t.stack[region];
+  if (record and frame.open)
+  {
+    Node& node = t.nodes[frame.node];
+    ++node.count;
+    node.ns += t1 - frame.start;
+    if (tracing.load(std::memory_order_relaxed))
+      t.events.push_back({frame.node, frame.start, t1});
+  }
+  frame.open = false;
+
+  // Regions that are not closed in reverse order (e.g. Timers) stay on
+  // the stack until the regions opened after them are closed
+  while (!t.stack.empty() and !t.stack.back().open)
+    t.stack.pop_back();
+}
+//-----------------------------------------------------------------------------
+const char* profiler::impl::intern(const std::string& name)
+{
+  static std::mutex mutex;
+  static std::set<std::string> names;
+  std::scoped_lock lock(mutex);
+  return names.insert(name).first->c_str();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,222 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Table.h"
+#include <cstdint>
+#include <mpi.h>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief Low-overhead hierarchical profiling of code regions.
+///
+/// Regions are opened and closed with ScopedRegion (and by logging
+/// common::Timer objects). Each thread records the regions it enters
+/// in its own call tree, so recording a region does not need locks or
+/// atomic operations. The call trees of all threads are merged when a
+/// summary or trace is created.
+///
+/// Functions that create summaries or traces, and reset(), must not be
+/// called while other threads are inside profiled regions.
+namespace dolfinx::common::profiler
+{
+/// @brief Timing of a region, accumulated over all threads of a
+/// process.
+struct Region
+{
+  /// Region path, the names of the enclosing regions and of the region
+  /// separated by " / "
+  std::string path;
+
+  /// Nesting depth (0 for a top-level region)
+  int depth;
+
+  /// Number of times the region was entered
+  std::int64_t count;
+
+  /// Total wall time in seconds
+  double wall;
+};
+
+/// @brief Enable or disable the recording of regions.
+///
+/// Recording is enabled by default. Regions that are open when
+/// recording is disabled are still closed.
+/// @param[in] state True to record regions
+void enable(bool state);
+
+/// @brief Check if regions are recorded.
+/// @return True if regions are recorded
+bool enabled();
+
+/// @brief Enable or disable the recording of a trace with an event
+/// for each time a region is entered.
+///
+/// Tracing is disabled by default. The memory for the trace grows with
+/// the number of region instances, so tracing should not be enabled
+/// with regions on per-entity code paths.
+/// @param[in] state True to record a trace
+void enable_trace(bool state);
+
+/// @brief Discard all recorded regions, trace events and communication
+/// statistics.
+void reset();
+
+/// @brief Region timings on this process, merged over threads.
+/// @return Regions sorted by path, so that each region follows its
+/// parent
+std::vector<Region> regions();
+
+/// @brief Summary of the region timings in a Table, with the minimum,
+/// average and maximum over the processes of the wall time and the
+/// maximum number of repetitions.
+///
+/// Collective. The table is returned on rank 0; other ranks receive an
+/// empty table.
+/// @param[in] comm MPI communicator
+/// @return Table with a row per region path
+Table summary(MPI_Comm comm);
+
+/// @brief Write the recorded trace events of all processes to a file
+/// in the Chrome trace event (JSON) format, which can be viewed with
+/// Perfetto or `chrome://tracing`.
+///
+/// Collective. Each process is shown with its rank as process id and
+/// each thread as a separate track. Times are relative to the first
+/// profiled region on each process.
+/// @param[in] comm MPI communicator
+/// @param[in] filename Name of the file written by rank 0
+void write_trace(MPI_Comm comm, const std::string& filename);
+
+/// @brief Enable or disable the recording of MPI communication
+/// statistics.
+///
+/// When enabled, common::Scatterer, MPI::distribute_to_postoffice,
+/// MPI::distribute_from_postoffice (and so MPI::distribute_data),
+/// MPI::route_via_nodes and MPI::compute_graph_edges_nbx record the
+/// messages and bytes they send, their number of neighbours and the
+/// time spent waiting for communication to complete. Recording is
+/// disabled by default.
+/// @param[in] state True to record communication
+void enable_comm(bool state);
+
+/// @brief Check if MPI communication statistics are recorded.
+/// @return True if communication is recorded
+bool comm_enabled();
+
+/// @brief Record the messages sent by a communication call.
+///
+/// The call site is identified by `name` and the path of the innermost
+/// open region on the calling thread. Usually called only if
+/// comm_enabled() is true.
+/// @param[in] name Name of the communication function (string literal)
+/// @param[in] dest Destination ranks
+/// @param[in] counts Number of items sent to each destination rank
+/// @param[in] item_size Size of an item in bytes
+/// @param[in] num_src Number of ranks that data is received from
+void record_send(const char* name, std::span<const int> dest,
+                 std::span<const std::int32_t> counts, std::size_t item_size,
+                 std::size_t num_src);
+
+/// @brief Record time spent waiting for the communication of a call
+/// site to complete.
+/// @param[in] name Name of the communication function, as passed to
+/// record_send()
+/// @param[in] seconds Wait time in seconds
+void record_wait(const char* name, double seconds);
+
+/// @brief Summary of the recorded communication in a Table, with a
+/// row for each call site.
+///
+/// The columns are the maximum number of calls over processes, the
+/// average and maximum of the messages sent, the minimum, average and
+/// maximum of the bytes sent, the maximum number of neighbours (source
+/// and destination ranks) of a call, and the minimum, average and
+/// maximum of the wait time. Collective. The table is returned on rank
+/// 0; other ranks receive an empty table.
+/// @param[in] comm MPI communicator
+/// @return Table with a row per call site
+Table comm_summary(MPI_Comm comm);
+
+/// @brief Write the communication matrix, the number of messages and
+/// bytes sent from each rank to each other rank summed over all call
+/// sites, to a file.
+///
+/// The file has a line `rank,dest,messages,bytes` for each pair of
+/// ranks that communicated. Ranks are the ranks on the communicators
+/// of the recorded calls, so the matrix is meaningful if these are
+/// congruent with `comm`. Collective.
+/// @param[in] comm MPI communicator
+/// @param[in] filename Name of the file written by rank 0
+void write_comm_matrix(MPI_Comm comm, const std::string& filename);
+
+namespace impl
+{
+/// @brief Open a region on the calling thread.
+/// @param[in] name Region name. The string must remain valid until
+/// the profiler data is discarded, e.g. a string literal.
+/// @return Handle to pass to end(), or -1 if recording is disabled
+std::int32_t begin(const char* name);
+
+/// @brief Close a region on the calling thread.
+/// @param[in] region Handle returned by begin()
+/// @param[in] record If false, the region is closed without recording
+/// its timing
+void end(std::int32_t region, bool record = true);
+
+/// @brief Return a copy of a name with storage that remains valid for
+/// the lifetime of the program.
+/// @param[in] name Name to store
+/// @return Stored name
+const char* intern(const std::string& name);
+} // namespace impl
+} // namespace dolfinx::common::profiler
+
+namespace dolfinx::common
+{
+/// @brief Profiled region that is open for the lifetime of the object.
+///
+/// The basic usage is
+///
+///   {
+///     common::ScopedRegion region("Pack coefficients");
+///     ...
+///   }
+///
+/// Regions opened inside the scope, on the same thread, are recorded as
+/// children. The cost of a region is dominated by two reads of the
+/// monotonic clock, so regions can be placed in hot loops. The name
+/// must be a string with static storage duration, e.g. a string
+/// literal.
+class ScopedRegion
+{
+public:
+  /// @brief Open a region.
+  /// @param[in] name Region name (string literal)
+  explicit ScopedRegion(const char* name)
+      : _region(profiler::impl::begin(name))
+  {
+  }
+
+  // Copy constructor (deleted)
+  ScopedRegion(const ScopedRegion&) = delete;
+
+  // Assignment operator (deleted)
+  ScopedRegion& operator=(const ScopedRegion&) = delete;
+
+  /// Close the region
+  ~ScopedRegion()
+  {
+    if (_region >= 0)
+      profiler::impl::end(_region);
+  }
+
+private:
+  std::int32_t _region;
+};
+} // namespace dolfinx::common
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <barrier>
 #include <cassert>
 #include <concepts>
 #include <cstdint>
@@ -14,12 +16,101 @@
 #include <iterator>
 #include <numeric>
 #include <span>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace dolfinx
 {
+namespace impl
+{
+/// @brief Radix sort of a range using several threads.
+///
+/// Each pass of the LSD radix sort computes a histogram of the buckets
+/// for a contiguous chunk of the range per thread. A prefix sum over
+/// the buckets and threads gives the insertion position of each thread
+/// in each bucket, so that the threads can scatter their chunks
+/// independently and the sort is stable.
+///
+/// @param[in,out] range The range to sort.
+/// @param[in] proj Element projection.
+/// @param[in] its Number of passes.
+/// @param[in] num_threads Number of threads.
+template <int BITS, typename T, typename P>
+void radix_sort_threaded(std::span<T> range, P proj, int its, int num_threads)
+{
+  using I = std::remove_cvref_t<std::invoke_result_t<P, T>>;
+  constexpr std::size_t bucket_size = std::size_t(1) << BITS;
+  const std::size_t n = range.size();
+  const int nt = std::min<std::size_t>(num_threads, n);
+
+  // Histogram and then insertion position for each thread and bucket
+  std::vector<std::size_t> offsets(nt * bucket_size);
+
+  std::vector<T> buffer(n);
+  std::span<T> current_perm = range;
+  std::span<T> next_perm = buffer;
+  int shift = 0;
+
+  auto prefix_sum = [&]() noexcept
+  {
+    std::size_t pos = 0;
+    for (std::size_t b = 0; b < bucket_size; ++b)
+    {
+      for (int t = 0; t < nt; ++t)
+      {
+        std::size_t count = offsets[t * bucket_size + b];
+        offsets[t * bucket_size + b] = pos;
+        pos += count;
+      }
+    }
+  };
+  auto next_pass = [&]() noexcept
+  {
+    std::swap(current_perm, next_perm);
+    shift += BITS;
+  };
+  std::barrier counted(nt, prefix_sum);
+  std::barrier scattered(nt, next_pass);
+
+  auto sort = [&](int t)
+  {
+    const std::size_t r0 = n * t / nt;
+    const std::size_t r1 = n * (t + 1) / nt;
+    std::span<std::size_t> offset(offsets.data() + t * bucket_size,
+                                  bucket_size);
+    for (int i = 0; i < its; ++i)
+    {
+      const I mask = (I(1) << BITS) - 1;
+      std::ranges::fill(offset, 0);
+      for (std::size_t j = r0; j < r1; ++j)
+        ++offset[(proj(current_perm[j]) >> shift) & mask];
+      counted.arrive_and_wait();
+
+      for (std::size_t j = r0; j < r1; ++j)
+      {
+        const T& c = current_perm[j];
+        next_perm[offset[(proj(c) >> shift) & mask]++] = c;
+      }
+      scattered.arrive_and_wait();
+    }
+  };
+
+  {
+    // Run first chunk on the calling thread
+    std::vector<std::jthread> threads;
+    threads.reserve(nt - 1);
+    for (int t = 1; t < nt; ++t)
+      threads.emplace_back(sort, t);
+    sort(0);
+  }
+
+  // Copy data back to array
+  if (its % 2 != 0)
+    std::ranges::copy(buffer, range.begin());
+}
+} // namespace impl
 
 struct __radix_sort
 {
@@ -48,12 +139,14 @@ struct __radix_sort
   /// @tparam BITS The number of bits to sort at a time.
   /// @param[in, out] range The range to sort.
   /// @param[in] P Element projection.
+  /// @param[in] num_threads Number of threads to use. With more than one
+  /// thread the range must be contiguous.
   template <
       std::ranges::random_access_range R, typename P = std::identity,
       std::remove_cvref_t<std::invoke_result_t<P, std::iter_value_t<R>>> BITS
       = 8>
     requires std::integral<decltype(BITS)>
-  constexpr void operator()(R&& range, P proj = {}) const
+  constexpr void operator()(R&& range, P proj = {}, int num_threads = 1) const
   {
     // value type
     using T = std::iter_value_t<R>;
@@ -64,11 +157,11 @@ struct __radix_sort
     if (range.size() <= 1)
       return;
 
-    T max_value = proj(*std::ranges::max_element(range, std::less{}, proj));
+    I max_value = proj(*std::ranges::max_element(range, std::less{}, proj));
 
     // Sort N bits at a time
     constexpr I bucket_size = 1 << BITS;
-    T mask = (T(1) << BITS) - 1;
+    I mask = (I(1) << BITS) - 1;
 
     // Compute number of iterations, most significant digit (N bits) of
     // maxvalue
@@ -79,6 +172,13 @@ struct __radix_sort
       its++;
     }
 
+    if (num_threads > 1)
+    {
+      impl::radix_sort_threaded<BITS>(std::span<T>(range), proj, its,
+                                      num_threads);
+      return;
+    }
+
     // Adjacency list arrays for computing insertion position
     std::array<I, bucket_size> counter;
     std::array<I, bucket_size + 1> offset;
@@ -128,12 +228,14 @@ inline constexpr __radix_sort radix_sort{};
 /// @param[in] x The flattened 2D array to compute the permutation array
 /// for.
 /// @param[in] shape1 The number of columns of `x`.
+/// @param[in] num_threads Number of threads to use for sorting.
 /// @return The permutation array such that `x[perm[i]] <= x[perm[i +1]].
 /// @pre `x.size()` must be a multiple of `shape1`.
 /// @note This function is suitable for small values of `shape1`. Each
 /// column of `x` is copied into an array that is then sorted.
 template <typename T, int BITS = 16>
-std::vector<std::int32_t> sort_by_perm(std::span<const T> x, std::size_t shape1)
+std::vector<std::int32_t> sort_by_perm(std::span<const T> x, std::size_t shape1,
+                                       int num_threads = 1)
 {
   static_assert(std::is_integral_v<T>, "Integral required.");
   assert(shape1 > 0);
@@ -151,7 +253,8 @@ std::vector<std::int32_t> sort_by_perm(std::span<const T> x, std::size_t shape1)
     for (std::size_t j = 0; j < shape0; ++j)
       column[j] = x[j * shape1 + col];
 
-    radix_sort(perm, [&column](auto index) { return column[index]; });
+    radix_sort(perm, [&column](auto index) { return column[index]; },
+               num_threads);
   }
 
   return perm;
@@ -0,0 +1,292 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DirichletBC.h"
+#include "Form.h"
+#include "assembler.h"
+#include "utils.h"
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+/// @brief Handle of an assembly started by assemble_vector_async or
+/// assemble_matrix_async.
+///
+/// An asynchronous assembly has two stages. The local stage, i.e. the
+/// packing of the coefficients and the assembly of the owned and
+/// ghost entries, runs in the background, using the global thread
+/// pool when assembling with more than one thread, and does not call
+/// MPI. The communication stage sends the ghost contributions to the
+/// owners (reverse scatter) and is started and completed by wait() on
+/// the calling thread.
+///
+/// Several forms, e.g. the blocks of the residual of a multi-field
+/// problem, can be assembled concurrently by starting them one after
+/// the other and waiting with wait_all, which starts the communication
+/// of each assembly as soon as its local stage is complete and
+/// overlaps it with the local stages of the following assemblies.
+///
+/// @note The form, the output tensor and the coefficients must not be
+/// modified or used by another assembly until the handle has been
+/// waited for. The handles of an assembly must be waited for in the
+/// same order on all processes.
+class AssemblyHandle
+{
+public:
+  /// @brief Create a handle.
+  /// @param[in] local Future of the local stage.
+  /// @param[in] begin Function that starts the communication stage.
+  /// @param[in] end Function that completes the communication stage.
+  AssemblyHandle(std::future<void> local, std::function<void()> begin,
+                 std::function<void()> end)
+      : _local(std::move(local)), _begin(std::move(begin)),
+        _end(std::move(end))
+  {
+  }
+
+  /// Move constructor
+  AssemblyHandle(AssemblyHandle&& h) noexcept
+      : _local(std::move(h._local)), _begin(std::move(h._begin)),
+        _end(std::move(h._end)), _state(std::exchange(h._state, state::done))
+  {
+  }
+
+  /// Move assignment
+  AssemblyHandle& operator=(AssemblyHandle&& h) noexcept
+  {
+    if (this != &h)
+    {
+      finish();
+      _local = std::move(h._local);
+      _begin = std::move(h._begin);
+      _end = std::move(h._end);
+      _state = std::exchange(h._state, state::done);
+    }
+    return *this;
+  }
+
+  /// @brief Destructor. Waits for the local stage if it is still
+  /// running. If the communication stage has been started but not
+  /// completed, it is completed and a warning is logged, since the
+  /// output tensor was not waited for.
+  ~AssemblyHandle() { finish(); }
+
+  /// @brief Check if the local stage is complete, without blocking.
+  /// @note Not collective.
+  bool ready() const
+  {
+    return !_local.valid()
+           or _local.wait_for(std::chrono::seconds(0))
+                  == std::future_status::ready;
+  }
+
+  /// @brief Check if the assembly is complete, i.e. if wait() has
+  /// returned.
+  bool done() const { return _state == state::done; }
+
+  /// @brief Wait for the local stage and start the communication
+  /// stage. Exceptions raised by the local stage are rethrown.
+  /// @note Collective. Does nothing if communication has already been
+  /// started.
+  void start()
+  {
+    if (_state != state::local)
+      return;
+    if (_local.valid())
+      _local.get();
+    _begin();
+    _state = state::communication;
+  }
+
+  /// @brief Wait for the assembly to complete.
+  ///
+  /// On return, the owned entries of the output tensor hold the
+  /// summed contributions of all processes.
+  /// @note Collective.
+  void wait()
+  {
+    start();
+    if (_state == state::communication)
+    {
+      _end();
+      _state = state::done;
+    }
+  }
+
+private:
+  enum class state
+  {
+    local,
+    communication,
+    done
+  };
+
+  // Complete a started communication stage, which would otherwise
+  // leave the reverse scatter requests of the output tensor active
+  void finish() noexcept
+  {
+    if (_state != state::communication)
+      return;
+    spdlog::warn("AssemblyHandle destroyed after start() without wait(). "
+                 "Completing the communication stage.");
+    try
+    {
+      _end();
+    }
+    catch (const std::exception& e)
+    {
+      spdlog::error("Failed to complete assembly communication: {}",
+                    e.what());
+    }
+    _state = state::done;
+  }
+
+  // Local stage
+  std::future<void> _local;
+
+  // Start and end of the communication stage
+  std::function<void()> _begin, _end;
+
+  // Stage of the assembly
+  state _state = state::local;
+};
+
+/// @brief Wait for several assemblies to complete.
+///
+/// The communication stage of each assembly is started, in order, as
+/// soon as its local stage is complete, so that it overlaps with the
+/// local stages of the later assemblies.
+/// @note Collective.
+/// @param[in,out] handles The handles of the assemblies.
+inline void wait_all(std::span<AssemblyHandle> handles)
+{
+  for (AssemblyHandle& h : handles)
+    h.start();
+  for (AssemblyHandle& h : handles)
+    h.wait();
+}
+
+/// @brief Start the assembly of a linear form into a vector.
+///
+/// The returned handle completes the assembly. After
+/// AssemblyHandle::wait, the result is the same as from
+/// assemble_vector(b.mutable_array(), L, num_threads) followed by
+/// `b.scatter_rev(std::plus<T>())`.
+///
+/// @param[in,out] b The vector to assemble into. It will not be zeroed
+/// before assembly. It must not be accessed until the handle has been
+/// waited for.
+/// @param[in] L The linear form. It must outlive the handle.
+/// @param[in] num_threads Number of threads to use for the local
+/// assembly
+/// @return Handle of the assembly
+template <dolfinx::scalar T, std::floating_point U>
+AssemblyHandle assemble_vector_async(la::Vector<T>& b, const Form<T, U>& L,
+                                     int num_threads = 1)
+{
+  std::span<T> x = b.mutable_array();
+  std::future<void> local = std::async(
+      std::launch::async,
+      [x, &L, num_threads]()
+      {
+        auto coefficients = allocate_coefficient_storage(L);
+        pack_coefficients(L, coefficients, num_threads);
+        std::span<const T> constants = L.packed_constants();
+        impl::assemble_vector(x, L, constants,
+                              make_coefficients_span(coefficients),
+                              num_threads);
+      });
+
+  return AssemblyHandle(
+      std::move(local), [&b]() { b.scatter_rev_begin(); },
+      [&b]() { b.scatter_rev_end(std::plus<T>()); });
+}
+
+/// @brief Start the assembly of a bilinear form into a matrix.
+///
+/// The returned handle completes the assembly. After
+/// AssemblyHandle::wait, the result is the same as from
+/// assemble_matrix(A.mat_add_values(), a, bcs, num_threads) followed
+/// by `A.scatter_rev()`. The diagonal of constrained rows is not set
+/// (see set_diagonal).
+///
+/// @param[in,out] A The matrix to assemble into. It will not be zeroed
+/// before assembly. It must not be accessed until the handle has been
+/// waited for.
+/// @param[in] a The bilinear form. It must outlive the handle.
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed.
+/// @param[in] num_threads Number of threads to use for the local
+/// assembly
+/// @return Handle of the assembly
+template <dolfinx::scalar T, std::floating_point U>
+AssemblyHandle assemble_matrix_async(
+    la::MatrixCSR<T>& A, const Form<T, U>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    int num_threads = 1)
+{
+  // Boundary condition markers, computed on the calling thread since
+  // the markers of a condition are cached on first use
+  struct markers_t
+  {
+    std::vector<std::int8_t> data0, data1;
+    std::span<const std::int8_t> markers0, markers1;
+  };
+  auto markers = std::make_shared<markers_t>();
+  markers->markers0
+      = impl::bc_dof_markers(*a.function_spaces().at(0), bcs, markers->data0);
+  markers->markers1
+      = impl::bc_dof_markers(*a.function_spaces().at(1), bcs, markers->data1);
+
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+  std::future<void> local = std::async(
+      std::launch::async,
+      [&A, &a, mesh, markers, num_threads]()
+      {
+        auto coefficients = allocate_coefficient_storage(a);
+        pack_coefficients(a, coefficients, num_threads);
+        std::span<const T> constants = a.packed_constants();
+        auto assemble = [&](std::span<const scalar_value_type_t<T>> x)
+        {
+          impl::assemble_matrix(A.mat_add_values(), a,
+                                mesh->geometry().dofmap(), x, constants,
+                                make_coefficients_span(coefficients),
+                                markers->markers0, markers->markers1,
+                                num_threads);
+        };
+
+        if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+          assemble(mesh->geometry().x());
+        else
+        {
+          auto x = mesh->geometry().x();
+          std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+          assemble(_x);
+        }
+      });
+
+  return AssemblyHandle(
+      std::move(local), [&A]() { A.scatter_rev_begin(); },
+      [&A]() { A.scatter_rev_end(); });
+}
+} // namespace dolfinx::fem
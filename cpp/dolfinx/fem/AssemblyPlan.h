@@ -0,0 +1,201 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "CoefficientCache.h"
+#include "DirichletBC.h"
+#include "Form.h"
+#include "assembler.h"
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// @brief Data for repeated assembly of a bilinear form into a
+/// la::MatrixCSR.
+///
+/// The plan holds the data that does not change between assemblies of
+/// a form with the same boundary conditions: the boundary condition
+/// dof markers, the rows for the diagonal entries of constrained dofs,
+/// the packed coefficients (a CoefficientCache, repacked only when the
+/// coefficients change) and the position in la::MatrixCSR::values of
+/// each entry added by the assembler. The positions are recorded by
+/// the first assembly into a matrix (see
+/// la::MatrixCSR::mat_add_values_record), and later assemblies into
+/// the same matrix add the element matrices at the recorded positions
+/// without searching the sparsity pattern.
+///
+/// @note The positions are recorded again when assembling into a
+/// matrix with different storage. Call AssemblyPlan::reset if a matrix
+/// is destroyed and another matrix may have been allocated at the same
+/// address.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class AssemblyPlan
+{
+public:
+  /// @brief Create an assembly plan.
+  /// @param[in] a The bilinear form.
+  /// @param[in] bcs Boundary conditions to apply. For boundary
+  /// condition dofs the row and column are zeroed.
+  /// @param[in] num_threads Number of threads to use for packing
+  /// coefficients.
+  AssemblyPlan(std::shared_ptr<const Form<T, U>> a,
+               const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+               int num_threads = 1)
+      : _form(a), _coefficients(a, num_threads), _num_threads(num_threads)
+  {
+    if (a->rank() != 2)
+      throw std::runtime_error("Form must be bilinear.");
+
+    const std::array<std::shared_ptr<const FunctionSpace<U>>, 2> V
+        = {a->function_spaces().at(0), a->function_spaces().at(1)};
+    _bs = V[0]->dofmap()->index_map_bs();
+    if (_bs != V[1]->dofmap()->index_map_bs())
+      throw std::runtime_error("Non-square block size not supported.");
+
+    // Copy the markers, since the cached markers of a boundary
+    // condition may be modified
+    std::vector<std::int8_t> markers;
+    std::span<const std::int8_t> m0
+        = impl::bc_dof_markers(*V[0], bcs, markers);
+    _markers0.assign(m0.begin(), m0.end());
+    std::span<const std::int8_t> m1
+        = impl::bc_dof_markers(*V[1], bcs, markers);
+    _markers1.assign(m1.begin(), m1.end());
+
+    // Owned rows to set the diagonal of, for diagonal blocks
+    if (V[0] == V[1])
+    {
+      for (auto& bc : bcs)
+      {
+        if (V[0]->contains(*bc->function_space()))
+        {
+          const auto [dofs, range] = bc->dof_indices();
+          _rows.insert(_rows.end(), dofs.begin(), dofs.begin() + range);
+        }
+      }
+    }
+  }
+
+  /// @brief Assemble the form into a matrix.
+  ///
+  /// Coefficients that have changed since the last assembly are
+  /// repacked. Does not zero or finalise the matrix. If the form test
+  /// and trial spaces are the same, `diagonal` is set on the diagonal
+  /// of the rows with a boundary condition.
+  ///
+  /// @param[in,out] A The matrix to assemble into. It must have the
+  /// sparsity pattern of the form.
+  /// @param[in] diagonal The value to set on the diagonal of
+  /// constrained rows.
+  void assemble(la::MatrixCSR<T>& A, T diagonal = 1)
+  {
+    _coefficients.update(_num_threads);
+    std::span<const T> constants = _form->packed_constants();
+    auto coeffs = _coefficients.coefficients();
+    if (A.values().data() == _values and A.cols().data() == _cols
+        and A.values().size() == _num_values)
+    {
+      auto mat_add = A.mat_add_values(std::span<const std::int64_t>(_offsets));
+      assemble_matrix(mat_add, *_form, constants, coeffs, _markers0,
+                      _markers1);
+    }
+    else
+    {
+      _offsets.clear();
+      impl::dispatch_bs(
+          _bs,
+          [&](auto _bs0)
+          {
+            constexpr int bs = decltype(_bs0)::value;
+            if constexpr (bs < 0)
+            {
+              throw std::runtime_error(
+                  "Block size not supported by AssemblyPlan.");
+            }
+            else
+            {
+              auto mat_add
+                  = A.template mat_add_values_record<bs, bs>(_offsets);
+              assemble_matrix(mat_add, *_form, constants, coeffs, _markers0,
+                              _markers1);
+            }
+          });
+      _values = A.values().data();
+      _cols = A.cols().data();
+      _num_values = A.values().size();
+    }
+
+    if (!_rows.empty())
+      set_diagonal<T>(A.mat_set_values(), _rows, diagonal);
+  }
+
+  /// @brief Discard the recorded matrix entry positions. The next
+  /// assembly records them again.
+  void reset()
+  {
+    _offsets.clear();
+    _values = nullptr;
+    _cols = nullptr;
+    _num_values = 0;
+  }
+
+  /// The form
+  std::shared_ptr<const Form<T, U>> form() const { return _form; }
+
+  /// The packed coefficients
+  const CoefficientCache<T, U>& coefficients() const { return _coefficients; }
+
+  /// @brief Memory used by the plan.
+  /// @return Memory usage, with the packed coefficients as a part
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"AssemblyPlan", sizeof(*this), {}};
+    usage.add("dof markers", common::capacity_bytes(_markers0)
+                                 + common::capacity_bytes(_markers1)
+                                 + common::capacity_bytes(_rows));
+    usage.add("insertion offsets", common::capacity_bytes(_offsets));
+    usage.add(_coefficients.memory_usage());
+    return usage;
+  }
+
+private:
+  // Form
+  std::shared_ptr<const Form<T, U>> _form;
+
+  // Packed coefficients
+  CoefficientCache<T, U> _coefficients;
+
+  // Number of threads for coefficient packing
+  int _num_threads;
+
+  // Dofmap block size
+  int _bs;
+
+  // Boundary condition markers for the rows and columns
+  std::vector<std::int8_t> _markers0, _markers1;
+
+  // Owned constrained rows, for setting the diagonal
+  std::vector<std::int32_t> _rows;
+
+  // Position in the matrix values of each entry added by the
+  // assembler, and the matrix storage they were recorded for
+  std::vector<std::int64_t> _offsets;
+  const T* _values = nullptr;
+  const std::int32_t* _cols = nullptr;
+  std::size_t _num_values = 0;
+};
+
+} // namespace dolfinx::fem
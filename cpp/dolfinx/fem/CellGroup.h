@@ -0,0 +1,131 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include <algorithm>
+#include <array>
+#include <basix/mdspan.hpp>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// @brief The cells of one cell type of a (mixed-topology) mesh,
+/// together with the data for executing a cell kernel over them.
+///
+/// In a mixed-topology mesh the cells of each type are numbered
+/// contiguously, with the index map `Topology::index_maps(tdim)[i]`,
+/// and the geometry dofmap `Geometry::dofmap(i)` and the dofmaps of
+/// function spaces on the cells of type `i` follow the same numbering.
+/// Assembling over a list of groups (see fem::assemble_vector and
+/// fem::assemble_matrix) executes one loop per group, with the kernel
+/// and the dofmap shapes fixed within the loop.
+///
+/// @tparam T Scalar type of the kernel.
+/// @tparam U Geometry type.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+struct CellGroup
+{
+  /// Kernel type
+  using kernel_type = std::function<void(T*, const T*, const T*, const U*,
+                                         const int*, const std::uint8_t*)>;
+
+  /// Dofmap type
+  using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const std::int32_t,
+      MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+
+  /// Geometry dofmap of the cells of this type
+  mdspan2_t x_dofmap;
+
+  /// Cells (local indices of cells of this type) to execute the kernel
+  /// over
+  std::vector<std::int32_t> cells;
+
+  /// Test and trial function dofmaps of the cells of this type. Only
+  /// the first is used for linear forms.
+  std::array<mdspan2_t, 2> dofmaps;
+
+  /// Block sizes of `dofmaps`
+  std::array<int, 2> bs = {1, 1};
+
+  /// Cell kernel
+  kernel_type kernel;
+
+  /// Batched cell kernel (see integral_data::batch_kernel). If set, it
+  /// is used instead of `kernel`.
+  kernel_type batch_kernel;
+
+  /// Number of cells computed by one call of `batch_kernel`
+  int batch_size = 0;
+
+  /// Packed coefficients of `cells`, with shape `(cells.size(),
+  /// cstride)`
+  std::span<const T> coeffs;
+
+  /// Coefficient stride
+  int cstride = 0;
+};
+
+/// @brief Create the cell groups of a form on a mixed-topology mesh,
+/// one for each cell type.
+///
+/// Each group contains the owned cells of its type.
+///
+/// @param[in] mesh The mesh.
+/// @param[in] kernels Cell kernel for each cell type.
+/// @param[in] dofmaps Dofmaps for each cell type, as created by
+/// fem::create_dofmaps; one list (test function) for linear forms and
+/// two lists (test and trial functions) for bilinear forms.
+/// @return Cell group for each cell type.
+template <dolfinx::scalar T, std::floating_point U>
+std::vector<CellGroup<T, U>> create_cell_groups(
+    const mesh::Mesh<U>& mesh,
+    const std::vector<typename CellGroup<T, U>::kernel_type>& kernels,
+    const std::vector<std::vector<std::reference_wrapper<const DofMap>>>&
+        dofmaps)
+{
+  auto topology = mesh.topology();
+  const int tdim = topology->dim();
+  std::vector cell_maps = topology->index_maps(tdim);
+  if (kernels.size() != cell_maps.size())
+    throw std::runtime_error("Number of kernels and cell types differ.");
+  if (dofmaps.empty() or dofmaps.size() > 2)
+    throw std::runtime_error("Cell groups require one or two dofmap lists.");
+
+  std::vector<CellGroup<T, U>> groups(cell_maps.size());
+  for (std::size_t i = 0; i < groups.size(); ++i)
+  {
+    CellGroup<T, U>& g = groups[i];
+    g.x_dofmap = mesh.geometry().dofmap(i);
+    g.cells.resize(cell_maps[i]->size_local());
+    std::iota(g.cells.begin(), g.cells.end(), 0);
+    for (std::size_t j = 0; j < 2; ++j)
+    {
+      const DofMap& dofmap = dofmaps[std::min(j, dofmaps.size() - 1)]
+                                 .at(i)
+                                 .get();
+      g.dofmaps[j] = dofmap.map();
+      g.bs[j] = dofmap.bs();
+    }
+    g.kernel = kernels[i];
+  }
+
+  return groups;
+}
+
+} // namespace dolfinx::fem
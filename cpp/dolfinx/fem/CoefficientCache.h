@@ -0,0 +1,150 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include "Function.h"
+#include "utils.h"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/Vector.h>
+#include <map>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// @brief Packed coefficients of a Form that are repacked only when
+/// the coefficients change.
+///
+/// The cache records the la::Vector::version of each coefficient when
+/// it is packed. CoefficientCache::update repacks the coefficients with
+/// a changed version and leaves the packed data of the other
+/// coefficients untouched. This avoids repacking the coefficients that
+/// do not change between assemblies, e.g. in a Newton solver where
+/// only the solution coefficient changes.
+///
+/// @note Modifications of a coefficient are detected through the
+/// version of its vector, see la::Vector::version.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class CoefficientCache
+{
+public:
+  /// @brief Create the cache and pack all coefficients of a form.
+  /// @param[in] form The form
+  /// @param[in] num_threads Number of threads to use for packing
+  explicit CoefficientCache(std::shared_ptr<const Form<T, U>> form,
+                            int num_threads = 1)
+      : _form(form), _coeffs(allocate_coefficient_storage(*form)),
+        _versions(form->coefficients().size(), 0),
+        _packed(form->coefficients().size(), false)
+  {
+    update(num_threads);
+  }
+
+  /// @brief Repack the coefficients that have changed since they were
+  /// last packed.
+  /// @param[in] num_threads Number of threads to use for packing
+  /// @return Number of coefficients that were repacked
+  int update(int num_threads = 1)
+  {
+    const std::vector<std::shared_ptr<const Function<T, U>>>& coefficients
+        = _form->coefficients();
+    std::vector<std::int8_t> changed(coefficients.size(), false);
+    for (std::size_t i = 0; i < coefficients.size(); ++i)
+    {
+      if (!_packed[i] or coefficients[i]->x()->version() != _versions[i])
+        changed[i] = true;
+    }
+
+    const int num_changed = std::ranges::count(changed, true);
+    if (num_changed == 0)
+      return 0;
+
+    for (auto& [key, val] : _coeffs)
+    {
+      auto [integral_type, id] = key;
+      impl::pack_coefficients(
+          *_form, integral_type, id, std::span(val.first), val.second,
+          [&form = *_form, integral_type, id](auto& mesh)
+          { return form.domain(integral_type, id, mesh); },
+          [&changed](std::size_t i) { return changed[i]; }, num_threads);
+    }
+
+    // Record versions after packing, since packing does not modify the
+    // coefficient vectors
+    for (std::size_t i = 0; i < coefficients.size(); ++i)
+    {
+      if (changed[i])
+      {
+        _versions[i] = coefficients[i]->x()->version();
+        _packed[i] = true;
+      }
+    }
+
+    return num_changed;
+  }
+
+  /// @brief Packed coefficients, in the format expected by the
+  /// assemblers.
+  ///
+  /// The spans are valid for the lifetime of the cache and are updated
+  /// by CoefficientCache::update.
+  std::map<std::pair<IntegralType, int>, std::pair<std::span<const T>, int>>
+  coefficients() const
+  {
+    std::map<std::pair<IntegralType, int>, std::pair<std::span<const T>, int>>
+        c;
+    for (auto& [key, val] : _coeffs)
+      c.emplace_hint(c.end(), key, std::pair(std::span(val.first), val.second));
+    return c;
+  }
+
+  /// @brief Packed coefficient data.
+  /// @return Map from a form `(integral_type, domain_id)` pair to a
+  /// `(coeffs, cstride)` pair
+  const std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>&
+  data() const
+  {
+    return _coeffs;
+  }
+
+  /// The form
+  std::shared_ptr<const Form<T, U>> form() const { return _form; }
+
+  /// @brief Memory used by the cache.
+  /// @return Memory usage, with the packed coefficients as a part
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"CoefficientCache", sizeof(*this), {}};
+    std::size_t packed = 0;
+    for (auto& [key, val] : _coeffs)
+      packed += common::capacity_bytes(val.first);
+    usage.add("packed coefficients", packed);
+    return usage;
+  }
+
+private:
+  // Form
+  std::shared_ptr<const Form<T, U>> _form;
+
+  // Packed coefficients for each (integral type, id) pair
+  std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>
+      _coeffs;
+
+  // Vector version of each coefficient when it was last packed, and
+  // indicator for coefficients that have been packed
+  std::vector<std::uint64_t> _versions;
+  std::vector<std::int8_t> _packed;
+};
+
+} // namespace dolfinx::fem
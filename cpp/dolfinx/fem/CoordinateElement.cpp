@@ -6,8 +6,10 @@
 
 #include "CoordinateElement.h"
 #include <algorithm>
+#include <basix/cell.h>
 #include <basix/finite-element.h>
 #include <cmath>
+#include <numeric>
 #include <dolfinx/common/math.h>
 #include <dolfinx/mesh/cell_types.h>
 
@@ -23,6 +25,27 @@ CoordinateElement<T>::CoordinateElement(
   int degree = _element->degree();
   mesh::CellType cell = this->cell_shape();
   _is_affine = mesh::is_simplex(cell) and degree == 1;
+
+  // Precompute the tables at the points that are used for every cell,
+  // i.e. the reference origin, the midpoint and the vertices
+  const auto [v, vshape] = basix::cell::geometry<T>(_element->cell_type());
+  const std::size_t tdim = vshape[1];
+  assert(tdim == (std::size_t)mesh::cell_dim(cell));
+  std::vector<T> midpoint(tdim, 0);
+  for (std::size_t i = 0; i < vshape[0]; ++i)
+    for (std::size_t j = 0; j < tdim; ++j)
+      midpoint[j] += v[i * tdim + j] / vshape[0];
+  auto pin = [this](int nd, std::span<const T> X,
+                    std::array<std::size_t, 2> shape)
+  {
+    std::array<std::size_t, 4> s = _element->tabulate_shape(nd, shape[0]);
+    _tabulation_cache->pin(nd, X, shape, s[0] * s[1] * s[2] * s[3],
+                           [&](std::span<T> basis)
+                           { _element->tabulate(nd, X, shape, basis); });
+  };
+  pin(1, std::vector<T>(tdim, 0), {1, tdim});
+  pin(1, midpoint, {1, tdim});
+  pin(0, v, vshape);
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
@@ -54,10 +77,17 @@ CoordinateElement<T>::tabulate_shape(std::size_t nd,
 template <std::floating_point T>
 void CoordinateElement<T>::tabulate(int nd, std::span<const T> X,
                                     std::array<std::size_t, 2> shape,
-                                    std::span<T> basis) const
+                                    std::span<T> basis, bool cache) const
 {
   assert(_element);
-  _element->tabulate(nd, X, shape, basis);
+  if (!cache)
+  {
+    _element->tabulate(nd, X, shape, basis);
+    return;
+  }
+
+  _tabulation_cache->tabulate(nd, X, shape, basis, [&](std::span<T> basis)
+                              { _element->tabulate(nd, X, shape, basis); });
 }
 //--------------------------------------------------------------------------------
 template <std::floating_point T>
@@ -79,99 +109,153 @@ ElementDofLayout CoordinateElement<T>::create_dof_layout() const
                           _element->entity_closure_dofs(), {}, {});
 }
 //-----------------------------------------------------------------------------
-template <std::floating_point T>
-void CoordinateElement<T>::pull_back_nonaffine(mdspan2_t<T> X,
-                                               mdspan2_t<const T> x,
-                                               mdspan2_t<const T> cell_geometry,
-                                               double tol, int maxit) const
+namespace
 {
-  // Number of points
-  std::size_t num_points = x.extent(0);
-  if (num_points == 0)
-    return;
+/// Newton iterations for the pull-back of points `x` to reference
+/// coordinates `X`, with `cell_geometry(p)` the node coordinates of the
+/// cell of point `p`. All unconverged points are tabulated together.
+template <std::floating_point T, typename U, typename V, typename G>
+void pull_back_newton(const basix::FiniteElement<T>& element, U X, V x,
+                      G&& cell_geometry, std::span<std::uint8_t> converged,
+                      double tol, int maxit)
+{
+  namespace md = MDSPAN_IMPL_STANDARD_NAMESPACE;
+  using mdspan2_t = md::mdspan<T, md::dextents<std::size_t, 2>>;
+  using cmdspan4_t = md::mdspan<const T, md::dextents<std::size_t, 4>>;
 
-  const std::size_t tdim = mesh::cell_dim(this->cell_shape());
+  const std::size_t num_points = x.extent(0);
+  const std::size_t tdim = X.extent(1);
   const std::size_t gdim = x.extent(1);
-  const std::size_t num_xnodes = cell_geometry.extent(0);
-  assert(cell_geometry.extent(1) == gdim);
-  assert(X.extent(0) == num_points);
-  assert(X.extent(1) == tdim);
-
-  std::vector<T> dphi_b(tdim * num_xnodes);
-  mdspan2_t<T> dphi(dphi_b.data(), tdim, num_xnodes);
+  for (std::size_t p = 0; p < num_points; ++p)
+    for (std::size_t i = 0; i < tdim; ++i)
+      X(p, i) = 0;
+  std::ranges::fill(converged, 0);
 
-  std::vector<T> Xk_b(tdim);
-  mdspan2_t<T> Xk(Xk_b.data(), 1, tdim);
+  // Points that have not converged
+  std::vector<std::int32_t> active(num_points);
+  std::iota(active.begin(), active.end(), 0);
 
-  std::array<T, 3> xk = {0, 0, 0};
-  std::vector<T> dX(tdim);
+  // Workspace, sized for all points and reused in each iteration
+  std::vector<T> Xa_b(num_points * tdim);
+  const std::array<std::size_t, 4> bshape
+      = element.tabulate_shape(1, num_points);
+  std::vector<T> basis_b(
+      std::reduce(bshape.begin(), bshape.end(), 1, std::multiplies{}));
+  const std::size_t num_xnodes = bshape[2];
+  std::vector<T> dphi_b(tdim * num_xnodes);
+  mdspan2_t dphi(dphi_b.data(), tdim, num_xnodes);
   std::vector<T> J_b(gdim * tdim);
-  mdspan2_t<T> J(J_b.data(), gdim, tdim);
+  mdspan2_t J(J_b.data(), gdim, tdim);
   std::vector<T> K_b(tdim * gdim);
-  mdspan2_t<T> K(K_b.data(), tdim, gdim);
-
-  using mdspan4_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-      T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>;
+  mdspan2_t K(K_b.data(), tdim, gdim);
+  std::array<T, 3> xk, dX;
 
-  const std::array<std::size_t, 4> bsize = _element->tabulate_shape(1, 1);
-  std::vector<T> basis_b(
-      std::reduce(bsize.begin(), bsize.end(), 1, std::multiplies{}));
-  mdspan4_t basis(basis_b.data(), bsize);
-  std::vector<T> phi(basis.extent(2));
-  for (std::size_t p = 0; p < num_points; ++p)
+  for (int k = 0; k < maxit and !active.empty(); ++k)
   {
-    std::ranges::fill(Xk_b, 0.0);
-    int k;
-    for (k = 0; k < maxit; ++k)
+    // Tabulate the basis and derivatives at the current iterates
+    const std::size_t na = active.size();
+    for (std::size_t a = 0; a < na; ++a)
+      for (std::size_t i = 0; i < tdim; ++i)
+        Xa_b[a * tdim + i] = X(active[a], i);
+    const std::array<std::size_t, 4> shape = element.tabulate_shape(1, na);
+    const std::size_t size = shape[0] * shape[1] * shape[2] * shape[3];
+    element.tabulate(1, std::span<const T>(Xa_b.data(), na * tdim),
+                     {na, tdim}, std::span<T>(basis_b.data(), size));
+    cmdspan4_t basis(basis_b.data(), shape);
+
+    std::size_t num_active = 0;
+    for (std::size_t a = 0; a < na; ++a)
     {
-      _element->tabulate(1, Xk_b, {1, tdim}, basis_b);
+      const std::int32_t p = active[a];
+      auto g = cell_geometry(p);
 
       // x = cell_geometry * phi
       std::ranges::fill(xk, 0.0);
-      for (std::size_t i = 0; i < cell_geometry.extent(0); ++i)
-        for (std::size_t j = 0; j < cell_geometry.extent(1); ++j)
-          xk[j] += cell_geometry(i, j) * basis(0, 0, i, 0);
+      for (std::size_t i = 0; i < g.extent(0); ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
+          xk[j] += g(i, j) * basis(0, a, i, 0);
 
-      // Compute Jacobian, its inverse and determinant
-      std::ranges::fill(J_b, 0.0);
+      // Compute Jacobian and its inverse
       for (std::size_t i = 0; i < tdim; ++i)
-        for (std::size_t j = 0; j < basis.extent(2); ++j)
-          dphi(i, j) = basis(i + 1, 0, j, 0);
-
-      compute_jacobian(dphi, cell_geometry, J);
-      compute_jacobian_inverse(J, K);
+        for (std::size_t j = 0; j < num_xnodes; ++j)
+          dphi(i, j) = basis(i + 1, a, j, 0);
+      std::ranges::fill(J_b, 0.0);
+      CoordinateElement<T>::compute_jacobian(dphi, g, J);
+      CoordinateElement<T>::compute_jacobian_inverse(J, K);
 
-      // Compute dX = K * (x_p - x_k)
-      std::ranges::fill(dX, 0);
-      for (std::size_t i = 0; i < K.extent(0); ++i)
-        for (std::size_t j = 0; j < K.extent(1); ++j)
+      // Compute dX = K * (x_p - x_k) and Xk += dX
+      std::ranges::fill(dX, 0.0);
+      for (std::size_t i = 0; i < tdim; ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
           dX[i] += K(i, j) * (x(p, j) - xk[j]);
-
-      // Compute Xk += dX
-      std::ranges::transform(dX, Xk_b, Xk_b.begin(),
-                             [](auto a, auto b) { return a + b; });
-
-      // Compute norm(dX)
-      if (auto dX_squared
-          = std::transform_reduce(dX.cbegin(), dX.cend(), 0.0, std::plus{},
-                                  [](auto v) { return v * v; });
-          std::sqrt(dX_squared) < tol)
+      T dX_squared = 0;
+      for (std::size_t i = 0; i < tdim; ++i)
       {
-        break;
+        X(p, i) += dX[i];
+        dX_squared += dX[i] * dX[i];
       }
-    }
 
-    std::copy(Xk_b.cbegin(), std::next(Xk_b.cbegin(), tdim),
-              X.data_handle() + p * tdim);
-    if (k == maxit)
-    {
-      throw std::runtime_error(
-          "Newton method failed to converge for non-affine geometry");
+      if (std::sqrt(dX_squared) < tol)
+        converged[p] = 1;
+      else
+        active[num_active++] = p;
     }
+    active.resize(num_active);
+  }
+}
+} // namespace
+//-----------------------------------------------------------------------------
+template <std::floating_point T>
+void CoordinateElement<T>::pull_back_nonaffine(mdspan2_t<T> X,
+                                               mdspan2_t<const T> x,
+                                               mdspan2_t<const T> cell_geometry,
+                                               double tol, int maxit) const
+{
+  // Number of points
+  std::size_t num_points = x.extent(0);
+  if (num_points == 0)
+    return;
+
+  assert(cell_geometry.extent(1) == x.extent(1));
+  assert(X.extent(0) == num_points);
+  assert(X.extent(1) == (std::size_t)mesh::cell_dim(this->cell_shape()));
+
+  std::vector<std::uint8_t> converged(num_points);
+  pull_back_newton<T>(
+      *_element, X, x, [&cell_geometry](auto) { return cell_geometry; },
+      converged, tol, maxit);
+  if (std::ranges::find(converged, 0) != converged.end())
+  {
+    throw std::runtime_error(
+        "Newton method failed to converge for non-affine geometry");
   }
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
+void CoordinateElement<T>::pull_back_nonaffine(
+    mdspan2_t<T> X, mdspan2_t<const T> x, mdspan3_t<const T> cell_geometry,
+    std::span<std::uint8_t> converged, double tol, int maxit) const
+{
+  assert(cell_geometry.extent(0) == x.extent(0));
+  assert(cell_geometry.extent(2) == x.extent(1));
+  assert(X.extent(0) == x.extent(0));
+  assert(X.extent(1) == (std::size_t)mesh::cell_dim(this->cell_shape()));
+  assert(converged.size() == x.extent(0));
+  if (x.extent(0) == 0)
+    return;
+
+  pull_back_newton<T>(
+      *_element, X, x,
+      [&cell_geometry](std::size_t p)
+      {
+        return MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            cell_geometry, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      },
+      converged, tol, maxit);
+}
+//-----------------------------------------------------------------------------
+template <std::floating_point T>
 void CoordinateElement<T>::permute(std::span<std::int32_t> dofs,
                                    std::uint32_t cell_perm) const
 {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "ElementDofLayout.h"
+#include "TabulationCache.h"
 #include <algorithm>
 #include <array>
 #include <basix/element-families.h>
@@ -90,8 +91,16 @@ public:
   /// @param[in] shape The shape of `X`.
   /// @param[out] basis The array to fill with the basis function
   /// values. The shape can be computed using `tabulate_shape`.
+  /// @param[in] cache If true, tables for small sets of points are
+  /// cached, so repeated tabulation at the same points copies the
+  /// cached table. Use `false` for points that are unlikely to be
+  /// repeated, e.g. physical points pulled back to the reference cell.
+  ///
+  /// @note The first derivatives at the reference origin and at the
+  /// cell midpoint, and the basis at the cell vertices, are
+  /// precomputed. Copies of a coordinate element share the cache.
   void tabulate(int nd, std::span<const T> X, std::array<std::size_t, 2> shape,
-                std::span<T> basis) const;
+                std::span<T> basis, bool cache = true) const;
 
   /// @brief Given the closure DOFs \f$\tilde{d}\f$ of a cell sub-entity in
   /// reference ordering, this function computes the permuted degrees-of-freedom
@@ -243,6 +252,33 @@ public:
                            mdspan2_t<const T> cell_geometry,
                            double tol = 1.0e-6, int maxit = 15) const;
 
+  /// mdspan typedef
+  template <typename X>
+  using mdspan3_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      X, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 3>>;
+
+  /// @brief Compute reference coordinates `X` for physical coordinates
+  /// `x` in different cells for a non-affine map.
+  ///
+  /// The Newton iterations for all points are performed together, so
+  /// that the geometry basis functions are tabulated for all
+  /// unconverged points at once in each iteration.
+  ///
+  /// @param [out] X The reference coordinates to compute
+  /// (shape=`(num_points, tdim)`).
+  /// @param [in] x Physical coordinates (`shape=(num_points, gdim)`).
+  /// @param [in] cell_geometry Node coordinates of the cell of each
+  /// point (`shape=(num_points, num geometry nodes, gdim)`).
+  /// @param [out] converged Set to 1 for the points for which the
+  /// Newton method converged within `maxit` iterations, and to 0
+  /// otherwise (`shape=(num_points,)`).
+  /// @param [in] tol Tolerance for termination of Newton method.
+  /// @param [in] maxit Maximum number of Newton iterations
+  void pull_back_nonaffine(mdspan2_t<T> X, mdspan2_t<const T> x,
+                           mdspan3_t<const T> cell_geometry,
+                           std::span<std::uint8_t> converged,
+                           double tol = 1.0e-6, int maxit = 15) const;
+
   /// @brief Permute a list of DOF numbers on a cell.
   void permute(std::span<std::int32_t> dofs, std::uint32_t cell_perm) const;
 
@@ -266,5 +302,9 @@ private:
 
   // Basix Element
   std::shared_ptr<const basix::FiniteElement<T>> _element;
+
+  // Tables of repeated tabulations
+  std::shared_ptr<impl::TabulationCache<T>> _tabulation_cache
+      = std::make_shared<impl::TabulationCache<T>>();
 };
 } // namespace dolfinx::fem
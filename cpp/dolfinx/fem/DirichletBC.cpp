@@ -73,18 +73,36 @@ find_local_entity_index(const mesh::Topology& topology,
 }
 //-----------------------------------------------------------------------------
 
+/// Create a 'symmetric' neighbourhood communicator from the src and
+/// dest ranks of an index map
+MPI_Comm create_symmetric_comm(const common::IndexMap& map)
+{
+  std::span src = map.src();
+  std::span dest = map.dest();
+  std::vector<int> ranks;
+  std::ranges::set_union(src, dest, std::back_inserter(ranks));
+  auto [unique_end, range_end] = std::ranges::unique(ranks);
+  ranks.erase(unique_end, range_end);
+  MPI_Comm comm;
+  MPI_Dist_graph_create_adjacent(map.comm(), ranks.size(), ranks.data(),
+                                 MPI_UNWEIGHTED, ranks.size(), ranks.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
+  return comm;
+}
+//-----------------------------------------------------------------------------
+
 /// Find all DOFs on this process that have been detected on another
-/// process
+/// process, for a number of lists of DOFs
 /// @param[in] comm A symmetric communicator
 /// @param[in] map The index map with the dof layout
 /// @param[in] bs_map The block size of the index map, i.e. the dof
 /// array. It should be set to 1 if `dofs_local` contains block indices.
-/// @param[in] dofs_local List of degrees of freedom on this rank
-/// @returns Degrees of freedom found on the other ranks that exist on
-/// this rank
-std::vector<std::int32_t>
+/// @param[in] dofs_local Lists of degrees of freedom on this rank
+/// @returns For each list in `dofs_local`, the degrees of freedom in
+/// the corresponding list on the other ranks that exist on this rank
+std::vector<std::vector<std::int32_t>>
 get_remote_dofs(MPI_Comm comm, const common::IndexMap& map, int bs_map,
-                std::span<const std::int32_t> dofs_local)
+                std::span<const std::span<const std::int32_t>> dofs_local)
 {
   int num_neighbors(-1);
   {
@@ -94,38 +112,57 @@ get_remote_dofs(MPI_Comm comm, const common::IndexMap& map, int bs_map,
   }
 
   // Return early if there are no neighbors
+  std::vector<std::vector<std::int32_t>> dofs(dofs_local.size());
   if (num_neighbors == 0)
-    return {};
+    return dofs;
+
+  // When there is more than one list, each dof is sent with the index
+  // of its list
+  const int stride = dofs_local.size() > 1 ? 2 : 1;
 
   // Figure out how many entries to receive from each neighbor
-  const int num_dofs_block = dofs_local.size();
+  std::size_t num_dofs_local = 0;
+  for (auto d : dofs_local)
+    num_dofs_local += d.size();
+  const int num_dofs_block = stride * num_dofs_local;
   std::vector<int> num_dofs_recv(num_neighbors);
   MPI_Request request;
   MPI_Ineighbor_allgather(&num_dofs_block, 1, MPI_INT, num_dofs_recv.data(), 1,
                           MPI_INT, comm, &request);
 
-  std::vector<std::int64_t> dofs_global(dofs_local.size());
-  if (bs_map == 1)
+  std::vector<std::int64_t> dofs_global;
+  dofs_global.reserve(num_dofs_block);
+  std::vector<std::int64_t> dofs_global_g;
+  for (std::size_t g = 0; g < dofs_local.size(); ++g)
   {
-    dofs_global.resize(dofs_local.size());
-    map.local_to_global(dofs_local, dofs_global);
-  }
-  else
-  {
-    // Convert dofs indices to 'block' map indices
-    std::vector<std::int32_t> dofs_local_m;
-    dofs_local_m.reserve(dofs_local.size());
-    std::ranges::transform(dofs_local, std::back_inserter(dofs_local_m),
-                           [bs_map](auto dof) { return dof / bs_map; });
-
-    // Compute global index of each block
-    map.local_to_global(dofs_local_m, dofs_global);
-
-    // Add offset
-    std::ranges::transform(
-        dofs_global, dofs_local, dofs_global.begin(),
-        [bs_map](auto global_block, auto local_dof)
-        { return bs_map * global_block + (local_dof % bs_map); });
+    std::span<const std::int32_t> dofs_local_g = dofs_local[g];
+    dofs_global_g.resize(dofs_local_g.size());
+    if (bs_map == 1)
+      map.local_to_global(dofs_local_g, dofs_global_g);
+    else
+    {
+      // Convert dofs indices to 'block' map indices
+      std::vector<std::int32_t> dofs_local_m;
+      dofs_local_m.reserve(dofs_local_g.size());
+      std::ranges::transform(dofs_local_g, std::back_inserter(dofs_local_m),
+                             [bs_map](auto dof) { return dof / bs_map; });
+
+      // Compute global index of each block
+      map.local_to_global(dofs_local_m, dofs_global_g);
+
+      // Add offset
+      std::ranges::transform(
+          dofs_global_g, dofs_local_g, dofs_global_g.begin(),
+          [bs_map](auto global_block, auto local_dof)
+          { return bs_map * global_block + (local_dof % bs_map); });
+    }
+
+    for (std::int64_t dof : dofs_global_g)
+    {
+      if (stride == 2)
+        dofs_global.push_back(g);
+      dofs_global.push_back(dof);
+    }
   }
 
   MPI_Wait(&request, MPI_STATUS_IGNORE);
@@ -161,19 +198,22 @@ get_remote_dofs(MPI_Comm comm, const common::IndexMap& map, int bs_map,
       global_local_ghosts.begin(), global_local_ghosts.end());
 
   MPI_Wait(&request, MPI_STATUS_IGNORE);
-  std::vector<std::int32_t> dofs;
-  for (auto dof_global : dofs_received)
+  for (std::size_t i = 0; i < dofs_received.size(); i += stride)
   {
+    std::vector<std::int32_t>& dofs_g
+        = stride == 2 ? dofs[dofs_received[i]] : dofs.front();
+    std::int64_t dof_global = dofs_received[i + stride - 1];
+
     // Insert owned dofs, else search in ghosts
     std::int64_t block = dof_global / bs_map;
     if (block >= range[0] and block < range[1])
-      dofs.push_back(dof_global - bs_map * range[0]);
+      dofs_g.push_back(dof_global - bs_map * range[0]);
     else
     {
       if (auto it = global_to_local.find(block); it != global_to_local.end())
       {
         int offset = dof_global % bs_map;
-        dofs.push_back(bs_map * it->second + offset);
+        dofs_g.push_back(bs_map * it->second + offset);
       }
     }
   }
@@ -181,118 +221,154 @@ get_remote_dofs(MPI_Comm comm, const common::IndexMap& map, int bs_map,
   return dofs;
 }
 //-----------------------------------------------------------------------------
-} // namespace
 
-//-----------------------------------------------------------------------------
-std::vector<std::int32_t> fem::locate_dofs_topological(
-    const mesh::Topology& topology, const DofMap& dofmap, int dim,
-    std::span<const std::int32_t> entities, bool remote)
+/// Find all DOFs on this process that have been detected on another
+/// process
+/// @param[in] comm A symmetric communicator
+/// @param[in] map The index map with the dof layout
+/// @param[in] bs_map The block size of the index map, i.e. the dof
+/// array. It should be set to 1 if `dofs_local` contains block indices.
+/// @param[in] dofs_local List of degrees of freedom on this rank
+/// @returns Degrees of freedom found on the other ranks that exist on
+/// this rank
+std::vector<std::int32_t>
+get_remote_dofs(MPI_Comm comm, const common::IndexMap& map, int bs_map,
+                std::span<const std::int32_t> dofs_local)
 {
-  mesh::CellType cell_type = topology.cell_type();
+  std::vector<std::vector<std::int32_t>> dofs
+      = get_remote_dofs(comm, map, bs_map, std::span(&dofs_local, 1));
+  return std::move(dofs.front());
+}
+//-----------------------------------------------------------------------------
 
-  // Prepare an element - local dof layout for dofs on entities of the
-  // entity_dim
-  const int num_cell_entities = mesh::cell_num_entities(cell_type, dim);
-  std::vector<std::vector<int>> entity_dofs;
-  for (int i = 0; i < num_cell_entities; ++i)
-  {
-    entity_dofs.push_back(
-        dofmap.element_dof_layout().entity_closure_dofs(dim, i));
-  }
+/// Find degrees-of-freedom which belong to groups of mesh entities.
+/// The entities of group `i` are `entities[offsets[i]:offsets[i +
+/// 1]]`.
+std::vector<std::vector<std::int32_t>>
+locate_dofs_groups(const mesh::Topology& topology, const fem::DofMap& dofmap,
+                   int dim, std::span<const std::int32_t> entities,
+                   std::span<const std::int32_t> offsets, bool remote)
+{
+  // Element-local dof layout for dofs on entities of dimension dim
+  const std::vector<std::vector<int>>& entity_dofs
+      = dofmap.element_dof_layout().entity_closure_dofs_all()[dim];
 
   // Get cell index and local entity index
   std::vector<std::pair<std::int32_t, int>> entity_indices
       = find_local_entity_index(topology, entities, dim);
 
-  std::vector<std::int32_t> dofs;
-  dofs.reserve(entities.size()
-               * dofmap.element_dof_layout().num_entity_closure_dofs(dim));
-
   // V is a sub space we need to take the block size of the dofmap and
   // the index map into account as they can differ
   const int bs = dofmap.bs();
   const int element_bs = dofmap.element_dof_layout().block_size();
+  if (element_bs != bs and bs != 1)
+    throw std::runtime_error("Block size combination not supported");
 
-  // Iterate over marked facets
-  if (element_bs == bs)
+  const int num_entity_dofs
+      = dofmap.element_dof_layout().num_entity_closure_dofs(dim);
+  std::vector<std::vector<std::int32_t>> dofs(offsets.size() - 1);
+  for (std::size_t g = 0; g < dofs.size(); ++g)
   {
-    // Work with blocks
-    for (auto [cell, entity_local_index] : entity_indices)
+    std::vector<std::int32_t>& dofs_g = dofs[g];
+    std::span entity_indices_g(entity_indices.data() + offsets[g],
+                               offsets[g + 1] - offsets[g]);
+
+    // Iterate over marked facets
+    if (element_bs == bs)
     {
-      // Get cell dofmap and loop over entity dofs
-      auto cell_dofs = dofmap.cell_dofs(cell);
-      for (int index : entity_dofs[entity_local_index])
-        dofs.push_back(cell_dofs[index]);
+      // Work with blocks
+      dofs_g.reserve(entity_indices_g.size() * num_entity_dofs);
+      for (auto [cell, entity_local_index] : entity_indices_g)
+      {
+        // Get cell dofmap and loop over entity dofs
+        auto cell_dofs = dofmap.cell_dofs(cell);
+        for (int index : entity_dofs[entity_local_index])
+          dofs_g.push_back(cell_dofs[index]);
+      }
     }
-  }
-  else if (bs == 1)
-  {
-    // Space is not blocked, unroll dofs
-    for (auto [cell, entity_local_index] : entity_indices)
+    else
     {
-      // Get cell dofmap and loop over facet dofs and 'unpack' blocked
-      // dofs
-      std::span<const std::int32_t> cell_dofs = dofmap.cell_dofs(cell);
-      for (int index : entity_dofs[entity_local_index])
+      // Space is not blocked, unroll dofs
+      dofs_g.reserve(entity_indices_g.size() * num_entity_dofs
+                     * element_bs);
+      for (auto [cell, entity_local_index] : entity_indices_g)
       {
-        for (int k = 0; k < element_bs; ++k)
+        // Get cell dofmap and loop over facet dofs and 'unpack' blocked
+        // dofs
+        std::span<const std::int32_t> cell_dofs = dofmap.cell_dofs(cell);
+        for (int index : entity_dofs[entity_local_index])
         {
-          const std::div_t pos = std::div(element_bs * index + k, bs);
-          dofs.push_back(bs * cell_dofs[pos.quot] + pos.rem);
+          for (int k = 0; k < element_bs; ++k)
+          {
+            const std::div_t pos = std::div(element_bs * index + k, bs);
+            dofs_g.push_back(bs * cell_dofs[pos.quot] + pos.rem);
+          }
         }
       }
     }
-  }
-  else
-    throw std::runtime_error("Block size combination not supported");
 
-  // TODO: is removing duplicates at this point worth the effort?
-  // Remove duplicates
-  std::ranges::sort(dofs);
-  auto [unique_end, range_end] = std::ranges::unique(dofs);
-  dofs.erase(unique_end, range_end);
+    // TODO: is removing duplicates at this point worth the effort?
+    // Remove duplicates
+    std::ranges::sort(dofs_g);
+    auto [unique_end, range_end] = std::ranges::unique(dofs_g);
+    dofs_g.erase(unique_end, range_end);
+  }
 
   if (remote)
   {
     // Get bc dof indices (local) in V spaces on this process that were
     // found by other processes, e.g. a vertex dof on this process that
-    // has no connected facets on the boundary.
+    // has no connected facets on the boundary. The dofs of all groups
+    // are exchanged together.
     auto map = dofmap.index_map;
     assert(map);
+    MPI_Comm comm = create_symmetric_comm(*map);
 
-    // Create 'symmetric' neighbourhood communicator
-    MPI_Comm comm;
-    {
-      std::span src = map->src();
-      std::span dest = map->dest();
-      std::vector<int> ranks;
-      std::ranges::set_union(src, dest, std::back_inserter(ranks));
-      auto [unique_end, range_end] = std::ranges::unique(ranks);
-      ranks.erase(unique_end, range_end);
-      MPI_Dist_graph_create_adjacent(
-          map->comm(), ranks.size(), ranks.data(), MPI_UNWEIGHTED, ranks.size(),
-          ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
-    }
-
-    std::vector<std::int32_t> dofs_remote;
-    if (int map_bs = dofmap.index_map_bs(); map_bs == bs)
-      dofs_remote = get_remote_dofs(comm, *map, 1, dofs);
-    else
-      dofs_remote = get_remote_dofs(comm, *map, map_bs, dofs);
+    std::vector<std::span<const std::int32_t>> dofs_local(dofs.begin(),
+                                                          dofs.end());
+    const int map_bs = dofmap.index_map_bs();
+    std::vector<std::vector<std::int32_t>> dofs_remote = get_remote_dofs(
+        comm, *map, map_bs == bs ? 1 : map_bs, dofs_local);
 
     MPI_Comm_free(&comm);
 
     // Add received bc indices to dofs_local, sort, and remove
     // duplicates
-    dofs.insert(dofs.end(), dofs_remote.begin(), dofs_remote.end());
-    std::ranges::sort(dofs);
-    auto [unique_end, range_end] = std::ranges::unique(dofs);
-    dofs.erase(unique_end, range_end);
+    for (std::size_t g = 0; g < dofs.size(); ++g)
+    {
+      dofs[g].insert(dofs[g].end(), dofs_remote[g].begin(),
+                     dofs_remote[g].end());
+      std::ranges::sort(dofs[g]);
+      auto [unique_end, range_end] = std::ranges::unique(dofs[g]);
+      dofs[g].erase(unique_end, range_end);
+    }
   }
 
   return dofs;
 }
 //-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t> fem::locate_dofs_topological(
+    const mesh::Topology& topology, const DofMap& dofmap, int dim,
+    std::span<const std::int32_t> entities, bool remote)
+{
+  const std::array<std::int32_t, 2> offsets
+      = {0, static_cast<std::int32_t>(entities.size())};
+  std::vector<std::vector<std::int32_t>> dofs
+      = locate_dofs_groups(topology, dofmap, dim, entities, offsets, remote);
+  return std::move(dofs.front());
+}
+//-----------------------------------------------------------------------------
+std::vector<std::vector<std::int32_t>> fem::locate_dofs_topological(
+    const mesh::Topology& topology, const DofMap& dofmap, int dim,
+    const graph::AdjacencyList<std::int32_t>& entities, bool remote)
+{
+  return locate_dofs_groups(topology, dofmap, dim, entities.array(),
+                            entities.offsets(), remote);
+}
+//-----------------------------------------------------------------------------
 std::array<std::vector<std::int32_t>, 2> fem::locate_dofs_topological(
     const mesh::Topology& topology,
     std::array<std::reference_wrapper<const DofMap>, 2> dofmaps, const int dim,
@@ -305,16 +381,9 @@ std::array<std::vector<std::int32_t>, 2> fem::locate_dofs_topological(
   // Check that dof layouts are the same
   assert(dofmap0.element_dof_layout() == dofmap1.element_dof_layout());
 
-  mesh::CellType cell_type = topology.cell_type();
-
-  // Build vector of local dofs for each cell entity
-  const int num_cell_entities = mesh::cell_num_entities(cell_type, dim);
-  std::vector<std::vector<int>> entity_dofs;
-  for (int i = 0; i < num_cell_entities; ++i)
-  {
-    entity_dofs.push_back(
-        dofmap0.element_dof_layout().entity_closure_dofs(dim, i));
-  }
+  // Local dofs for each cell entity
+  const std::vector<std::vector<int>>& entity_dofs
+      = dofmap0.element_dof_layout().entity_closure_dofs_all()[dim];
 
   const std::array bs = {dofmap0.bs(), dofmap1.bs()};
 
@@ -383,19 +452,7 @@ std::array<std::vector<std::int32_t>, 2> fem::locate_dofs_topological(
     assert(map0);
 
     // Create 'symmetric' neighbourhood communicator
-    MPI_Comm comm;
-    {
-      std::span src = map0->src();
-      std::span dest = map0->dest();
-      std::vector<int> ranks;
-      std::ranges::set_union(src, dest, std::back_inserter(ranks));
-      auto [unique_end, range_end] = std::ranges::unique(ranks);
-      ranks.erase(unique_end, range_end);
-      MPI_Dist_graph_create_adjacent(map0->comm(), ranks.size(), ranks.data(),
-                                     MPI_UNWEIGHTED, ranks.size(), ranks.data(),
-                                     MPI_UNWEIGHTED, MPI_INFO_NULL, false,
-                                     &comm);
-    }
+    MPI_Comm comm = create_symmetric_comm(*map0);
 
     std::vector<std::int32_t> dofs_remote = get_remote_dofs(
         comm, *map0, dofmap0.index_map_bs(), sorted_bc_dofs[0]);
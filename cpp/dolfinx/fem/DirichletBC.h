@@ -15,9 +15,13 @@
 #include <array>
 #include <concepts>
 #include <dolfinx/common/types.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/MeshTags.h>
 #include <functional>
+#include <numeric>
 #include <memory>
 #include <span>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -56,6 +60,97 @@ locate_dofs_topological(const mesh::Topology& topology, const DofMap& dofmap,
                         int dim, std::span<const std::int32_t> entities,
                         bool remote = true);
 
+/// @brief Find degrees-of-freedom which belong to groups of mesh
+/// entities (topological).
+///
+/// The DOFs of all groups are located together, with one exchange of
+/// remotely located DOFs for all groups. This is cheaper than calling
+/// ::locate_dofs_topological for each group when DOFs are located for
+/// many boundary regions.
+///
+/// @param[in] topology Mesh topology.
+/// @param[in] dofmap Dofmap that associated DOFs with cells.
+/// @param[in] dim Topological dimension of mesh entities on which
+/// degrees-of-freedom will be located
+/// @param[in] entities Indices of mesh entities for each group, i.e.
+/// `entities.links(i)` are the entities of group `i`.
+/// @param[in] remote True to return also "remotely located"
+/// degree-of-freedom indices, see ::locate_dofs_topological.
+/// @return Array of DOF index blocks (local to the MPI rank) for each
+/// group. The arrays use the block size of the dofmap.
+/// @pre The topology cell->entity and entity->cell connectivity must
+/// have been computed before calling this function.
+std::vector<std::vector<std::int32_t>>
+locate_dofs_topological(const mesh::Topology& topology, const DofMap& dofmap,
+                        int dim,
+                        const graph::AdjacencyList<std::int32_t>& entities,
+                        bool remote = true);
+
+/// @brief Find degrees-of-freedom which belong to mesh entities with
+/// given tag values (topological).
+///
+/// The mesh tags are traversed once to group the entities by value,
+/// and the DOFs of all groups are located together (see
+/// ::locate_dofs_topological for groups of entities).
+///
+/// @param[in] topology Mesh topology.
+/// @param[in] dofmap Dofmap that associated DOFs with cells.
+/// @param[in] tags Mesh tags.
+/// @param[in] values Tag values to locate DOFs for. The values must be
+/// unique.
+/// @param[in] remote True to return also "remotely located"
+/// degree-of-freedom indices, see ::locate_dofs_topological.
+/// @return Array of DOF index blocks (local to the MPI rank) for each
+/// value in `values`. The arrays use the block size of the dofmap.
+/// @pre The topology cell->entity and entity->cell connectivity must
+/// have been computed before calling this function.
+template <typename T>
+std::vector<std::vector<std::int32_t>>
+locate_dofs_topological(const mesh::Topology& topology, const DofMap& dofmap,
+                        const mesh::MeshTags<T>& tags,
+                        std::span<const T> values, bool remote = true)
+{
+  // Sort the requested values, keeping their position
+  std::vector<std::int32_t> perm(values.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::ranges::sort(perm, [&values](auto a, auto b)
+                    { return values[a] < values[b]; });
+  std::vector<T> sorted_values(values.size());
+  std::ranges::transform(perm, sorted_values.begin(),
+                         [&values](auto p) { return values[p]; });
+  if (std::ranges::adjacent_find(sorted_values) != sorted_values.end())
+    throw std::runtime_error("Tag values must be unique.");
+
+  // Find position of the value of each tagged entity in `values`
+  std::span<const std::int32_t> indices = tags.indices();
+  std::span<const T> tag_values = tags.values();
+  std::vector<std::int32_t> group(indices.size(), -1);
+  std::vector<std::int32_t> offsets(values.size() + 1, 0);
+  for (std::size_t i = 0; i < tag_values.size(); ++i)
+  {
+    auto it = std::ranges::lower_bound(sorted_values, tag_values[i]);
+    if (it != sorted_values.end() and *it == tag_values[i])
+    {
+      group[i] = perm[std::distance(sorted_values.begin(), it)];
+      ++offsets[group[i] + 1];
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  // Group entities by value
+  std::vector<std::int32_t> entities(offsets.back());
+  std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    if (group[i] >= 0)
+      entities[pos[group[i]]++] = indices[i];
+  }
+
+  return locate_dofs_topological(
+      topology, dofmap, tags.dim(),
+      graph::AdjacencyList(std::move(entities), std::move(offsets)), remote);
+}
+
 /// @brief Find degrees-of-freedom which belong to the provided mesh
 /// entities (topological).
 ///
@@ -98,14 +193,13 @@ std::array<std::vector<std::int32_t>, 2> locate_dofs_topological(
 /// @return Array of DOF index blocks (local to the MPI rank) in the
 /// space V. The array uses the block size of the dofmap associated
 /// with V.
+/// @note Tabulating the coordinates of all dofs is expensive. Use the
+/// version that takes a list of cells when only dofs in some cells,
+/// e.g. cells on the boundary, can be marked.
 template <std::floating_point T, typename U>
 std::vector<std::int32_t> locate_dofs_geometrical(const FunctionSpace<T>& V,
                                                   U marker_fn)
 {
-  // FIXME: Calling V.tabulate_dof_coordinates() is very expensive,
-  // especially when we usually want the boundary dofs only. Add
-  // interface that computes dofs coordinates only for specified cell.
-
   assert(V.element());
   if (V.element()->is_mixed())
   {
@@ -136,82 +230,91 @@ std::vector<std::int32_t> locate_dofs_geometrical(const FunctionSpace<T>& V,
   return dofs;
 }
 
-/// Finds degrees of freedom whose geometric coordinate is true for the
-/// provided marking function.
+/// @brief Find degrees of freedom in a subset of cells whose geometric
+/// coordinate is true for the provided marking function.
 ///
-/// @attention This function is slower than the topological version
+/// Only the coordinates of the dofs of `cells` are tabulated and
+/// passed to the marking function, which is much cheaper than
+/// tabulating all dof coordinates when the cells are a small part of
+/// the mesh, e.g. the cells attached to the boundary facets.
 ///
-/// @param[in] V The function (sub)space(s) on which degrees of freedom
-/// will be located. The spaces must share the same mesh and element
-/// type.
+/// @param[in] V The function (sub)space on which degrees of freedom
+/// will be located.
 /// @param[in] marker_fn Function marking tabulated degrees of freedom
-/// @return Array of DOF indices (local to the MPI rank) in the spaces
-/// V[0] and V[1]. The array[0](i) entry is the DOF index in the space
-/// V[0] and array[1](i) is the corresponding DOF entry in the space
-/// V[1]. The returned dofs are 'unrolled', i.e. block size = 1.
+/// @param[in] cells Cells (local to process) in which degrees of
+/// freedom will be located.
+/// @return Array of DOF index blocks (local to the MPI rank) in the
+/// space V. The array uses the block size of the dofmap associated
+/// with V.
 template <std::floating_point T, typename U>
-std::array<std::vector<std::int32_t>, 2> locate_dofs_geometrical(
-    const std::array<std::reference_wrapper<const FunctionSpace<T>>, 2>& V,
-    U marker_fn)
+std::vector<std::int32_t>
+locate_dofs_geometrical(const FunctionSpace<T>& V, U marker_fn,
+                        std::span<const std::int32_t> cells)
 {
-  // FIXME: Calling V.tabulate_dof_coordinates() is very expensive,
-  // especially when we usually want the boundary dofs only. Add
-  // interface that computes dofs coordinates only for specified cell.
-
-  // Get function spaces
-  const FunctionSpace<T>& V0 = V.at(0).get();
-  const FunctionSpace<T>& V1 = V.at(1).get();
-
-  // Get mesh
-  auto mesh = V0.mesh();
-  assert(mesh);
-  assert(V1.mesh());
-  if (mesh != V1.mesh())
-    throw std::runtime_error("Meshes are not the same.");
-  const int tdim = mesh->topology()->dim();
-
-  assert(V0.element());
-  assert(V1.element());
-  if (*V0.element() != *V1.element())
-    throw std::runtime_error("Function spaces must have the same element.");
+  assert(V.element());
+  if (V.element()->is_mixed())
+  {
+    throw std::runtime_error(
+        "Cannot locate dofs geometrically for mixed space. Use subspaces.");
+  }
 
-  // Compute dof coordinates
-  const std::vector<T> dof_coordinates = V1.tabulate_dof_coordinates(true);
+  // Compute coordinates of the dofs in the cells
+  const auto [cell_dofs, dof_coordinates] = V.tabulate_dof_coordinates(cells);
 
   using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
       const T,
       MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
           std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>;
 
-  // Evaluate marker for each dof coordinate
-  cmdspan3x_t x(dof_coordinates.data(), 3, dof_coordinates.size() / 3);
+  // Compute marker for each dof coordinate
+  cmdspan3x_t x(dof_coordinates.data(), 3, cell_dofs.size());
   const std::vector<std::int8_t> marked_dofs = marker_fn(x);
 
-  // Get dofmaps
-  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
-  assert(dofmap0);
-  const int bs0 = dofmap0->bs();
-  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
-  assert(dofmap1);
-  const int bs1 = dofmap1->bs();
+  std::vector<std::int32_t> dofs;
+  dofs.reserve(std::count(marked_dofs.begin(), marked_dofs.end(), true));
+  for (std::size_t i = 0; i < marked_dofs.size(); ++i)
+  {
+    if (marked_dofs[i])
+      dofs.push_back(cell_dofs[i]);
+  }
 
-  const int element_bs = dofmap0->element_dof_layout().block_size();
-  assert(element_bs == dofmap1->element_dof_layout().block_size());
+  return dofs;
+}
+
+namespace impl
+{
+/// @brief Unroll the marked dofs in a list of cells for two spaces
+/// with the same element.
+/// @param[in] dofmap0 Dofmap of the first space.
+/// @param[in] dofmap1 Dofmap of the second space.
+/// @param[in] cells Cells (local to process) to look for marked dofs
+/// in.
+/// @param[in] is_marked Function that returns true if a dof (block)
+/// of `dofmap1` is marked.
+/// @return Array of unrolled DOF indices (local to the MPI rank) in
+/// the two spaces.
+template <typename F>
+std::array<std::vector<std::int32_t>, 2>
+unroll_marked_dofs(const DofMap& dofmap0, const DofMap& dofmap1,
+                   std::span<const std::int32_t> cells, F is_marked)
+{
+  const int bs0 = dofmap0.bs();
+  const int bs1 = dofmap1.bs();
+  const int element_bs = dofmap0.element_dof_layout().block_size();
+  assert(element_bs == dofmap1.element_dof_layout().block_size());
 
   // Iterate over cells
-  auto topology = mesh->topology();
-  assert(topology);
   std::vector<std::array<std::int32_t, 2>> bc_dofs;
-  for (int c = 0; c < topology->connectivity(tdim, 0)->num_nodes(); ++c)
+  for (std::int32_t c : cells)
   {
     // Get cell dofmaps
-    auto cell_dofs0 = dofmap0->cell_dofs(c);
-    auto cell_dofs1 = dofmap1->cell_dofs(c);
+    auto cell_dofs0 = dofmap0.cell_dofs(c);
+    auto cell_dofs1 = dofmap1.cell_dofs(c);
 
     // Loop over cell dofs and add to bc_dofs if marked.
     for (std::size_t i = 0; i < cell_dofs1.size(); ++i)
     {
-      if (marked_dofs[cell_dofs1[i]])
+      if (is_marked(cell_dofs1[i]))
       {
         // Unroll over blocks
         for (int k = 0; k < element_bs; ++k)
@@ -245,6 +348,122 @@ std::array<std::vector<std::int32_t>, 2> locate_dofs_geometrical(
   return dofs;
 }
 
+/// Check that two function spaces have the same mesh and element
+template <std::floating_point T>
+void check_same_mesh_and_element(const FunctionSpace<T>& V0,
+                                 const FunctionSpace<T>& V1)
+{
+  assert(V0.mesh());
+  assert(V1.mesh());
+  if (V0.mesh() != V1.mesh())
+    throw std::runtime_error("Meshes are not the same.");
+
+  assert(V0.element());
+  assert(V1.element());
+  if (*V0.element() != *V1.element())
+    throw std::runtime_error("Function spaces must have the same element.");
+}
+} // namespace impl
+
+/// Finds degrees of freedom whose geometric coordinate is true for the
+/// provided marking function.
+///
+/// @attention This function is slower than the topological version
+///
+/// @param[in] V The function (sub)space(s) on which degrees of freedom
+/// will be located. The spaces must share the same mesh and element
+/// type.
+/// @param[in] marker_fn Function marking tabulated degrees of freedom
+/// @return Array of DOF indices (local to the MPI rank) in the spaces
+/// V[0] and V[1]. The array[0](i) entry is the DOF index in the space
+/// V[0] and array[1](i) is the corresponding DOF entry in the space
+/// V[1]. The returned dofs are 'unrolled', i.e. block size = 1.
+template <std::floating_point T, typename U>
+std::array<std::vector<std::int32_t>, 2> locate_dofs_geometrical(
+    const std::array<std::reference_wrapper<const FunctionSpace<T>>, 2>& V,
+    U marker_fn)
+{
+  // Get function spaces
+  const FunctionSpace<T>& V0 = V.at(0).get();
+  const FunctionSpace<T>& V1 = V.at(1).get();
+  impl::check_same_mesh_and_element(V0, V1);
+
+  // Compute dof coordinates
+  const std::vector<T> dof_coordinates = V1.tabulate_dof_coordinates(true);
+
+  using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const T,
+      MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+          std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>;
+
+  // Evaluate marker for each dof coordinate
+  cmdspan3x_t x(dof_coordinates.data(), 3, dof_coordinates.size() / 3);
+  const std::vector<std::int8_t> marked_dofs = marker_fn(x);
+
+  // Iterate over all cells
+  auto topology = V0.mesh()->topology();
+  assert(topology);
+  auto map = topology->index_map(topology->dim());
+  assert(map);
+  std::vector<std::int32_t> cells(map->size_local() + map->num_ghosts());
+  std::iota(cells.begin(), cells.end(), 0);
+
+  assert(V0.dofmap());
+  assert(V1.dofmap());
+  return impl::unroll_marked_dofs(*V0.dofmap(), *V1.dofmap(), cells,
+                                  [&marked_dofs](std::int32_t dof)
+                                  { return marked_dofs[dof]; });
+}
+
+/// @brief Find degrees of freedom in a subset of cells whose geometric
+/// coordinate is true for the provided marking function.
+///
+/// Only the coordinates of the dofs of `cells` are tabulated, see
+/// ::locate_dofs_geometrical for a single space.
+///
+/// @param[in] V The function (sub)space(s) on which degrees of freedom
+/// will be located. The spaces must share the same mesh and element
+/// type.
+/// @param[in] marker_fn Function marking tabulated degrees of freedom
+/// @param[in] cells Cells (local to process) in which degrees of
+/// freedom will be located.
+/// @return Array of DOF indices (local to the MPI rank) in the spaces
+/// V[0] and V[1]. The array[0](i) entry is the DOF index in the space
+/// V[0] and array[1](i) is the corresponding DOF entry in the space
+/// V[1]. The returned dofs are 'unrolled', i.e. block size = 1.
+template <std::floating_point T, typename U>
+std::array<std::vector<std::int32_t>, 2> locate_dofs_geometrical(
+    const std::array<std::reference_wrapper<const FunctionSpace<T>>, 2>& V,
+    U marker_fn, std::span<const std::int32_t> cells)
+{
+  // Get function spaces
+  const FunctionSpace<T>& V0 = V.at(0).get();
+  const FunctionSpace<T>& V1 = V.at(1).get();
+  impl::check_same_mesh_and_element(V0, V1);
+
+  // Compute coordinates of the dofs in the cells
+  const auto [cell_dofs, dof_coordinates] = V1.tabulate_dof_coordinates(cells);
+
+  using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const T,
+      MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+          std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>;
+
+  // Evaluate marker for each dof coordinate
+  cmdspan3x_t x(dof_coordinates.data(), 3, cell_dofs.size());
+  const std::vector<std::int8_t> marked_dofs = marker_fn(x);
+
+  assert(V0.dofmap());
+  assert(V1.dofmap());
+  return impl::unroll_marked_dofs(
+      *V0.dofmap(), *V1.dofmap(), cells,
+      [&cell_dofs, &marked_dofs](std::int32_t dof)
+      {
+        auto it = std::ranges::lower_bound(cell_dofs, dof);
+        return marked_dofs[std::distance(cell_dofs.begin(), it)];
+      });
+}
+
 /// Object for setting (strong) Dirichlet boundary conditions
 /// \f[u = g \ \text{on} \ G,\f]
 /// where \f$u\f$ is the solution to be computed, \f$g\f$ is a function
@@ -482,34 +701,33 @@ public:
   /// @param[in] scale The scaling value to apply
   void set(std::span<T> x, T scale = 1) const
   {
-    if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
+    if (!_values.empty())
+    {
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
+        x[_dofs0[i]] = scale * _values[i];
+    }
+    else if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
     {
       auto g = std::get<std::shared_ptr<const Function<T, U>>>(_g);
       assert(g);
       std::span<const T> values = g->x()->array();
       auto dofs1_g = _dofs1_g.empty() ? std::span(_dofs0) : std::span(_dofs1_g);
-      std::int32_t x_size = x.size();
-      for (std::size_t i = 0; i < _dofs0.size(); ++i)
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
       {
-        if (_dofs0[i] < x_size)
-        {
-          assert(dofs1_g[i] < (std::int32_t)values.size());
-          x[_dofs0[i]] = scale * values[dofs1_g[i]];
-        }
+        assert(dofs1_g[i] < (std::int32_t)values.size());
+        x[_dofs0[i]] = scale * values[dofs1_g[i]];
       }
     }
     else if (std::holds_alternative<std::shared_ptr<const Constant<T>>>(_g))
     {
       auto g = std::get<std::shared_ptr<const Constant<T>>>(_g);
-      std::vector<T> value = g->value;
+      const std::vector<T>& value = g->value;
       int bs = _function_space->dofmap()->bs();
-      std::int32_t x_size = x.size();
-      std::ranges::for_each(_dofs0,
-                            [x_size, bs, scale, &value, &x](auto dof)
-                            {
-                              if (dof < x_size)
-                                x[dof] = scale * value[dof % bs];
-                            });
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
+        x[_dofs0[i]] = scale * value[_dofs0[i] % bs];
     }
   }
 
@@ -519,21 +737,25 @@ public:
   /// @param[in] scale The scaling value to apply
   void set(std::span<T> x, std::span<const T> x0, T scale = 1) const
   {
-    if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
+    if (!_values.empty())
+    {
+      assert(x.size() <= x0.size());
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
+        x[_dofs0[i]] = scale * (_values[i] - x0[_dofs0[i]]);
+    }
+    else if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
     {
       auto g = std::get<std::shared_ptr<const Function<T, U>>>(_g);
       assert(g);
       std::span<const T> values = g->x()->array();
       assert(x.size() <= x0.size());
       auto dofs1_g = _dofs1_g.empty() ? std::span(_dofs0) : std::span(_dofs1_g);
-      std::int32_t x_size = x.size();
-      for (std::size_t i = 0; i < _dofs0.size(); ++i)
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
       {
-        if (_dofs0[i] < x_size)
-        {
-          assert(dofs1_g[i] < (std::int32_t)values.size());
-          x[_dofs0[i]] = scale * (values[dofs1_g[i]] - x0[_dofs0[i]]);
-        }
+        assert(dofs1_g[i] < (std::int32_t)values.size());
+        x[_dofs0[i]] = scale * (values[dofs1_g[i]] - x0[_dofs0[i]]);
       }
     }
     else if (std::holds_alternative<std::shared_ptr<const Constant<T>>>(_g))
@@ -541,12 +763,12 @@ public:
       auto g = std::get<std::shared_ptr<const Constant<T>>>(_g);
       const std::vector<T>& value = g->value;
       std::int32_t bs = _function_space->dofmap()->bs();
-      std::ranges::for_each(_dofs0,
-                            [&x, &x0, &value, scale, bs](auto dof)
-                            {
-                              if (dof < (std::int32_t)x.size())
-                                x[dof] = scale * (value[dof % bs] - x0[dof]);
-                            });
+      const std::size_t num_dofs = num_dofs_in(x.size());
+      for (std::size_t i = 0; i < num_dofs; ++i)
+      {
+        const std::int32_t dof = _dofs0[i];
+        x[dof] = scale * (value[dof % bs] - x0[dof]);
+      }
     }
   }
 
@@ -560,7 +782,12 @@ public:
   /// (the space of the function that provides the dof values)
   void dof_values(std::span<T> values) const
   {
-    if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
+    if (!_values.empty())
+    {
+      for (std::size_t i = 0; i < _dofs0.size(); ++i)
+        values[_dofs0[i]] = _values[i];
+    }
+    else if (std::holds_alternative<std::shared_ptr<const Function<T, U>>>(_g))
     {
       auto g = std::get<std::shared_ptr<const Function<T, U>>>(_g);
       assert(g);
@@ -595,7 +822,184 @@ public:
     }
   }
 
+  /// @brief Markers for the dofs that have a boundary condition
+  /// applied.
+  ///
+  /// The markers are computed on the first call and cached, so
+  /// repeated assembly with the same boundary condition does not
+  /// rebuild them.
+  ///
+  /// @note The first call is not thread-safe.
+  /// @return Array with an entry for each dof (unrolled, including
+  /// ghosts) in the function space, with value true if a boundary
+  /// condition is applied to the dof.
+  std::span<const std::int8_t> dof_markers() const
+  {
+    if (_dof_markers.empty())
+    {
+      std::shared_ptr<const DofMap> dofmap = _function_space->dofmap();
+      assert(dofmap);
+      std::shared_ptr<const common::IndexMap> map = dofmap->index_map;
+      assert(map);
+      _dof_markers.resize(
+          dofmap->index_map_bs() * (map->size_local() + map->num_ghosts()),
+          false);
+      mark_dofs(_dof_markers);
+    }
+
+    return _dof_markers;
+  }
+
+  /// @brief Physical coordinates of the constrained dofs.
+  ///
+  /// The coordinates are computed on the first call from the cells
+  /// that contain the constrained dofs only, and cached. The points are
+  /// the dofs of the space of the boundary value Function `g`, or, for
+  /// a Constant, of the constrained space, by dof block.
+  ///
+  /// @note The first call is not thread-safe.
+  /// @return Coordinates of the points, with shape `(3, num_points)`.
+  /// Storage is row-major.
+  std::span<const U> dof_coordinates() const
+  {
+    if (_value_index.empty() and !_dofs0.empty())
+      tabulate_coordinates();
+    return _x;
+  }
+
+  /// @brief Set the boundary values from values at the dof
+  /// coordinates.
+  ///
+  /// The values are stored by the boundary condition and are used by
+  /// set and dof_values instead of the boundary value Function or
+  /// Constant, which is not modified, until reset_values is called.
+  ///
+  /// @param[in] values Values at the points of dof_coordinates, with
+  /// shape `(bs, num_points)`, where `bs` is the block size of the
+  /// points. Storage is row-major.
+  void set_values(std::span<const T> values)
+  {
+    const std::size_t num_points = dof_coordinates().size() / 3;
+    if (values.size() != _x_bs * num_points)
+    {
+      throw std::runtime_error("Size of the boundary values does not match "
+                               "the number of dof coordinates.");
+    }
+
+    _values.resize(_dofs0.size());
+    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+      _values[i] = values[_value_index[i]];
+  }
+
+  /// @brief Set the boundary values by evaluating a function at the
+  /// dof coordinates.
+  ///
+  /// Only the constrained dofs are evaluated, so the cost of updating
+  /// time-dependent boundary values is proportional to the number of
+  /// constrained dofs, rather than to the size of the space as for
+  /// interpolation into the boundary value Function.
+  ///
+  /// @param[in] f Function that takes the points of dof_coordinates,
+  /// with shape `(3, num_points)`, and returns the values (row-major,
+  /// shape `(bs, num_points)`) and their shape, as for
+  /// Function::interpolate.
+  void interpolate(
+      const std::function<std::pair<std::vector<T>, std::vector<std::size_t>>(
+          MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+              const U,
+              MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+                  std::size_t, 3,
+                  MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>)>& f)
+  {
+    std::span<const U> x = dof_coordinates();
+    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const U,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+            std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>
+        _x(x.data(), 3, x.size() / 3);
+    auto [fx, fshape] = f(_x);
+    set_values(fx);
+  }
+
+  /// @brief Remove the boundary values set by set_values or
+  /// interpolate, so that the values of the boundary value Function or
+  /// Constant are used again.
+  void reset_values() { _values.clear(); }
+
 private:
+  // Number of entries in the (sorted) dof array that are less than
+  // `size`, i.e. that are set in an array of length `size`
+  std::size_t num_dofs_in(std::size_t size) const
+  {
+    auto it = std::ranges::lower_bound(_dofs0, std::int32_t(size));
+    return std::distance(_dofs0.begin(), it);
+  }
+
+  // Compute the coordinates of the points of the constrained dofs, see
+  // dof_coordinates()
+  void tabulate_coordinates() const
+  {
+    // Space and (unrolled) dof indices of the points
+    std::shared_ptr<const FunctionSpace<U>> V = _function_space;
+    std::span<const std::int32_t> dofs = _dofs0;
+    if (auto g = std::get_if<std::shared_ptr<const Function<T, U>>>(&_g);
+        g and !_dofs1_g.empty())
+    {
+      V = (*g)->function_space();
+      dofs = _dofs1_g;
+    }
+    assert(V);
+
+    const int bs = V->dofmap()->bs();
+    std::vector<std::int32_t> blocks(dofs.size());
+    std::ranges::transform(dofs, blocks.begin(),
+                           [bs](auto d) { return d / bs; });
+    std::ranges::sort(blocks);
+    auto [unique_end, range_end] = std::ranges::unique(blocks);
+    blocks.erase(unique_end, range_end);
+
+    // Cells that contain a constrained dof
+    std::shared_ptr<const DofMap> dofmap = V->dofmap();
+    std::shared_ptr<const common::IndexMap> map = dofmap->index_map;
+    std::vector<std::int8_t> marker(map->size_local() + map->num_ghosts(),
+                                    false);
+    for (std::int32_t b : blocks)
+      marker[b] = true;
+    std::vector<std::int32_t> cells;
+    for (std::size_t c = 0; c < dofmap->map().extent(0); ++c)
+    {
+      auto cell_dofs = dofmap->cell_dofs(c);
+      if (std::ranges::any_of(cell_dofs, [&marker](auto d)
+                              { return marker[d]; }))
+      {
+        cells.push_back(c);
+      }
+    }
+
+    auto [cell_blocks, x] = V->tabulate_dof_coordinates(cells);
+    const std::size_t num_points = blocks.size();
+    const std::size_t num_cell_blocks = cell_blocks.size();
+    _x.assign(3 * num_points, 0);
+    for (std::size_t i = 0; i < num_points; ++i)
+    {
+      auto it = std::ranges::lower_bound(cell_blocks, blocks[i]);
+      assert(it != cell_blocks.end() and *it == blocks[i]);
+      const std::size_t pos = std::distance(cell_blocks.begin(), it);
+      for (std::size_t j = 0; j < 3; ++j)
+        _x[j * num_points + i] = x[j * num_cell_blocks + pos];
+    }
+
+    // Position of the value of each dof in the values at the points
+    _x_bs = bs;
+    _value_index.resize(dofs.size());
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+    {
+      auto it = std::ranges::lower_bound(blocks, dofs[i] / bs);
+      _value_index[i]
+          = (dofs[i] % bs) * num_points + std::distance(blocks.begin(), it);
+    }
+  }
+
   // The function space (possibly a sub function space)
   std::shared_ptr<const FunctionSpace<U>> _function_space;
 
@@ -610,5 +1014,70 @@ private:
 
   // The first _owned_indices in _dofs are owned by this process
   std::int32_t _owned_indices0 = -1;
+
+  // Cached dof markers, see dof_markers()
+  mutable std::vector<std::int8_t> _dof_markers;
+
+  // Coordinates of the points of the constrained dofs (shape (3,
+  // num_points)), their block size, and the position of the value of
+  // each entry of _dofs0 in an array of values at the points. Computed
+  // on first use, see dof_coordinates()
+  mutable std::vector<U> _x;
+  mutable std::size_t _x_bs = 1;
+  mutable std::vector<std::int32_t> _value_index;
+
+  // Boundary values set by set_values, one for each entry of _dofs0.
+  // If empty, the values of _g are used.
+  std::vector<T> _values;
 };
+
+namespace impl
+{
+/// @brief Dof markers for the boundary conditions applied to a space.
+///
+/// If one boundary condition is applied to `V`, its cached markers
+/// (see DirichletBC::dof_markers) are returned and no array is built.
+/// Otherwise the markers of the boundary conditions are combined in
+/// `markers`.
+///
+/// @param[in] V The function space.
+/// @param[in] bcs Boundary conditions. Boundary conditions on spaces
+/// that are not contained in `V` are ignored.
+/// @param[out] markers Storage for combined markers.
+/// @return Markers with an entry for each dof (unrolled, including
+/// ghosts) in `V`. Empty if no boundary condition is applied to `V`.
+template <dolfinx::scalar T, std::floating_point U>
+std::span<const std::int8_t> bc_dof_markers(
+    const FunctionSpace<U>& V,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    std::vector<std::int8_t>& markers)
+{
+  std::vector<const DirichletBC<T, U>*> bcs_V;
+  for (auto& bc : bcs)
+  {
+    assert(bc);
+    assert(bc->function_space());
+    if (V.contains(*bc->function_space()))
+      bcs_V.push_back(bc.get());
+  }
+
+  if (bcs_V.empty())
+    return {};
+  else if (bcs_V.size() == 1)
+    return bcs_V.front()->dof_markers();
+  else
+  {
+    std::shared_ptr<const DofMap> dofmap = V.dofmap();
+    assert(dofmap);
+    std::shared_ptr<const common::IndexMap> map = dofmap->index_map;
+    assert(map);
+    markers.assign(
+        dofmap->index_map_bs() * (map->size_local() + map->num_ghosts()),
+        false);
+    for (auto bc : bcs_V)
+      bc->mark_dofs(markers);
+    return markers;
+  }
+}
+} // namespace impl
 } // namespace dolfinx::fem
@@ -8,6 +8,7 @@
 #include "ElementDofLayout.h"
 #include "dofmapbuilder.h"
 #include "utils.h"
+#include <algorithm>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
@@ -167,7 +168,8 @@ graph::AdjacencyList<std::int32_t> fem::transpose_dofmap(
 bool DofMap::operator==(const DofMap& map) const
 {
   return this->_index_map_bs == map._index_map_bs
-         and this->_dofmap == map._dofmap and this->_bs == map._bs;
+         and std::ranges::equal(this->_dofs, map._dofs)
+         and this->_bs == map._bs;
 }
 //-----------------------------------------------------------------------------
 int DofMap::bs() const noexcept { return _bs; }
@@ -181,7 +183,7 @@ DofMap DofMap::extract_sub_dofmap(std::span<const int> component) const
       = this->element_dof_layout().sub_view(component);
 
   // Build dofmap by extracting from parent
-  const std::int32_t num_cells = this->_dofmap.size() / this->_shape1;
+  const std::int32_t num_cells = this->_dofs.size() / this->_shape1;
 
   // FIXME X: how does sub_element_map_view hand block sizes?
   const std::int32_t dofs_per_cell = sub_element_map_view.size();
@@ -280,8 +282,21 @@ DofMap::map() const
   return MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
       const std::int32_t,
       MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>(
-      _dofmap.data(), _dofmap.size() / _shape1, _shape1);
+      _dofs.data(), _dofs.size() / _shape1, _shape1);
 }
 //-----------------------------------------------------------------------------
 int DofMap::index_map_bs() const { return _index_map_bs; }
 //-----------------------------------------------------------------------------
+common::MemoryUsage DofMap::memory_usage() const
+{
+  common::MemoryUsage usage{"DofMap", sizeof(*this), {}};
+  usage.add("cell dofs", common::capacity_bytes(_dofmap));
+
+  // Data shared with a mesh topology is accounted for by the topology
+  if (_shared_dofmap)
+    return usage;
+  if (index_map)
+    usage.add(index_map->memory_usage()).name = "index map";
+  return usage;
+}
+//-----------------------------------------------------------------------------
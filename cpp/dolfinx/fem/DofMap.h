@@ -11,9 +11,11 @@
 
 #include "ElementDofLayout.h"
 #include <basix/mdspan.hpp>
+#include <cassert>
 #include <concepts>
 #include <cstdlib>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/graph/ordering.h>
 #include <functional>
@@ -97,13 +99,47 @@ public:
          int index_map_bs, U&& dofmap, int bs)
       : index_map(index_map), _index_map_bs(index_map_bs),
         _element_dof_layout(std::forward<E>(element)),
-        _dofmap(std::forward<U>(dofmap)), _bs(bs),
+        _dofmap(std::forward<U>(dofmap)), _dofs(_dofmap), _bs(bs),
         _shape1(_element_dof_layout.num_dofs()
                 * _element_dof_layout.block_size() / _bs)
   {
     // Do nothing
   }
 
+  /// @brief Create a DofMap that shares its cell degrees-of-freedom
+  /// with an adjacency list, e.g. the cell-to-vertex connectivity of a
+  /// mesh topology for a degree-1 Lagrange space.
+  ///
+  /// The adjacency list is not copied. The links of each node are the
+  /// degrees-of-freedom of a cell, and each node must have the same
+  /// number of links.
+  ///
+  /// @param[in] element The layout of the degrees of freedom on an
+  /// element
+  /// @param[in] index_map The map describing the parallel distribution
+  /// of the degrees of freedom.
+  /// @param[in] index_map_bs The block size associated with the
+  /// `index_map`.
+  /// @param[in] dofmap Adjacency list with the degrees-of-freedom for
+  /// each cell.
+  /// @param[in] bs The block size of the `dofmap`.
+  template <typename E>
+    requires std::is_convertible_v<std::remove_cvref_t<E>,
+                                   fem::ElementDofLayout>
+  DofMap(E&& element, std::shared_ptr<const common::IndexMap> index_map,
+         int index_map_bs,
+         std::shared_ptr<const graph::AdjacencyList<std::int32_t>> dofmap,
+         int bs)
+      : index_map(index_map), _index_map_bs(index_map_bs),
+        _element_dof_layout(std::forward<E>(element)),
+        _shared_dofmap(dofmap), _dofs(_shared_dofmap->array()), _bs(bs),
+        _shape1(_element_dof_layout.num_dofs()
+                * _element_dof_layout.block_size() / _bs)
+  {
+    assert(_dofs.size()
+           == std::size_t(_shape1 * _shared_dofmap->num_nodes()));
+  }
+
   // Copy constructor
   DofMap(const DofMap& dofmap) = delete;
 
@@ -129,7 +165,7 @@ public:
   /// indices)
   std::span<const std::int32_t> cell_dofs(std::int32_t c) const
   {
-    return std::span<const std::int32_t>(_dofmap.data() + _shape1 * c, _shape1);
+    return std::span<const std::int32_t>(_dofs.data() + _shape1 * c, _shape1);
   }
 
   /// @brief Return the block size for the dofmap
@@ -172,6 +208,11 @@ public:
   /// @brief Block size associated with the index_map
   int index_map_bs() const;
 
+  /// @brief Memory used by the dofmap.
+  /// @return Memory usage, with the cell dofs and the index map as
+  /// parts
+  common::MemoryUsage memory_usage() const;
+
 private:
   // Block size for the IndexMap
   int _index_map_bs = -1;
@@ -182,6 +223,15 @@ private:
   // Cell local-to-dof map
   std::vector<std::int32_t> _dofmap;
 
+  // Adjacency list that the cell local-to-dof map is shared with.
+  // nullptr if the map is owned (_dofmap).
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> _shared_dofmap;
+
+  // Cell local-to-dof map, either _dofmap or the array of
+  // _shared_dofmap. The buffer of _dofmap is not changed by a move, so
+  // the view remains valid when a DofMap is moved.
+  std::span<const std::int32_t> _dofs;
+
   // Block size for the dofmap
   int _bs = -1;
 
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <array>
 #include <concepts>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/types.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <functional>
@@ -148,15 +149,60 @@ public:
   /// @param[in] mesh Cells on which to evaluate the Expression.
   /// @param[in] entities List of entities to evaluate the expression
   /// on. This could be either a list of cells or a list of (cell, local
+  /// facet index) tuples. Array is flattened per entity.
   /// @param[out] values A 2D array to store the result. Caller is
   /// responsible for correct sizing which should be `(num_cells,
   /// num_points * value_size * num_all_argument_dofs columns)`.
-  /// facet index) tuples. Array is flattened per entity.
   /// @param[in] vshape The shape of `values` (row-major storage).
+  /// @param[in] tile_size Number of entities for which coefficients
+  /// are packed at a time.
+  /// @param[in] num_threads Number of threads to use.
   void eval(const mesh::Mesh<geometry_type>& mesh,
             std::span<const std::int32_t> entities,
-            std::span<scalar_type> values,
-            std::array<std::size_t, 2> vshape) const
+            std::span<scalar_type> values, std::array<std::size_t, 2> vshape,
+            std::size_t tile_size = 1024, int num_threads = 1) const
+  {
+    eval(mesh, entities,
+         [values, vshape](std::size_t e0, std::span<const scalar_type> v,
+                          std::array<std::size_t, 2> shape)
+         {
+           for (std::size_t e = 0; e < shape[0]; ++e)
+           {
+             std::copy_n(std::next(v.begin(), e * shape[1]), shape[1],
+                         std::next(values.begin(), (e0 + e) * vshape[1]));
+           }
+         },
+         tile_size, num_threads);
+  }
+
+  /// @brief Evaluate Expression on cells or facets in tiles, passing
+  /// the values of each tile to a callback.
+  ///
+  /// The coefficients are packed for one tile of entities at a time and
+  /// the packing and value buffers are reused for the next tile, so
+  /// the memory use is independent of the number of entities. The
+  /// values can be, e.g., written out or reduced by the callback
+  /// without storing the values for all entities.
+  ///
+  /// @param[in] mesh Cells on which to evaluate the Expression.
+  /// @param[in] entities List of entities to evaluate the expression
+  /// on. This could be either a list of cells or a list of (cell, local
+  /// facet index) tuples. Array is flattened per entity.
+  /// @param[in] f Callback `f(e0, values, vshape)` that is called for
+  /// each tile with the position `e0` in `entities` of the first
+  /// entity of the tile and the values for the entities of the tile
+  /// (`shape=vshape=(num_tile_entities, num_points * value_size *
+  /// num_all_argument_dofs)`, row-major storage). `values` is only
+  /// valid for the duration of the call. With more than one thread, `f`
+  /// is called concurrently for different tiles.
+  /// @param[in] tile_size Number of entities in a tile.
+  /// @param[in] num_threads Number of threads to use. The tiles are
+  /// distributed between the threads.
+  void eval(const mesh::Mesh<geometry_type>& mesh,
+            std::span<const std::int32_t> entities,
+            const std::function<void(std::size_t, std::span<const scalar_type>,
+                                     std::array<std::size_t, 2>)>& f,
+            std::size_t tile_size = 1024, int num_threads = 1) const
   {
     std::size_t estride;
     if (mesh.topology()->dim() == _x_ref.second[1])
@@ -165,11 +211,14 @@ public:
       estride = 2;
     else
       throw std::runtime_error("Invalid dimension of evaluation points.");
+    if (tile_size == 0)
+      throw std::runtime_error("Tile size must be positive.");
 
-    // Prepare coefficients and constants
-    auto [coeffs, cstride] = pack_coefficients(*this, entities, estride);
+    // Pack coefficients for no entities to create the entity
+    // permutations of the coefficient meshes (collective), so that
+    // packing tiles on different threads only reads the mesh data
+    const int cstride = pack_coefficients(*this, {}, estride).second;
     std::vector<scalar_type> constant_data = pack_constants(*this);
-    auto fn = this->get_tabulate_expression();
 
     // Prepare cell geometry
     auto x_dofmap = mesh.geometry().dofmap();
@@ -180,9 +229,6 @@ public:
     std::size_t num_dofs_g = cmap.dim();
     auto x_g = mesh.geometry().x();
 
-    // Create data structures used in evaluation
-    std::vector<geometry_type> coord_dofs(3 * num_dofs_g);
-
     int num_argument_dofs = 1;
     std::span<const std::uint32_t> cell_info;
     std::function<void(std::span<scalar_type>, std::span<const std::uint32_t>,
@@ -211,44 +257,57 @@ public:
       }
     }
 
-    // Create get entity index function
-    std::function<const std::int32_t*(std::span<const std::int32_t>,
-                                      std::size_t)>
-        get_entity_index
-        = []([[maybe_unused]] std::span<const std::int32_t> entities,
-             [[maybe_unused]] std::size_t idx) { return nullptr; };
-    if (estride == 2)
-    {
-      get_entity_index
-          = [](std::span<const std::int32_t> entities, std::size_t idx)
-      { return entities.data() + 2 * idx + 1; };
-    }
+    const int size0 = _x_ref.second[0] * value_size();
+    const std::size_t num_entities = entities.size() / estride;
+    const std::size_t num_tiles = (num_entities + tile_size - 1) / tile_size;
+    const std::size_t vstride = size0 * num_argument_dofs;
 
-    // Iterate over cells and 'assemble' into values
-    int size0 = _x_ref.second[0] * value_size();
-    std::vector<scalar_type> values_local(size0 * num_argument_dofs, 0);
-    for (std::size_t e = 0; e < entities.size() / estride; ++e)
+    // Evaluate tiles t0, t0 + step, t0 + 2 * step, ...
+    auto eval_tiles = [&](std::size_t t0, std::size_t step)
     {
-      std::int32_t entity = entities[e * estride];
-      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          x_dofmap, entity, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      std::vector<geometry_type> coord_dofs(3 * num_dofs_g);
+      std::vector<scalar_type> values(tile_size * vstride);
+      for (std::size_t t = t0; t < num_tiles; t += step)
       {
-        std::copy_n(std::next(x_g.begin(), 3 * x_dofs[i]), 3,
-                    std::next(coord_dofs.begin(), 3 * i));
+        const std::size_t e0 = t * tile_size;
+        const std::size_t n = std::min(tile_size, num_entities - e0);
+        std::span<const std::int32_t> tile
+            = entities.subspan(e0 * estride, n * estride);
+        auto [coeffs, _cstride] = pack_coefficients(*this, tile, estride);
+        assert(_cstride == cstride);
+
+        std::ranges::fill(values, 0);
+        for (std::size_t e = 0; e < n; ++e)
+        {
+          std::int32_t entity = tile[e * estride];
+          auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+              x_dofmap, entity, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+          for (std::size_t i = 0; i < x_dofs.size(); ++i)
+          {
+            std::copy_n(std::next(x_g.begin(), 3 * x_dofs[i]), 3,
+                        std::next(coord_dofs.begin(), 3 * i));
+          }
+
+          const int* entity_index
+              = estride == 2 ? tile.data() + 2 * e + 1 : nullptr;
+          std::span<scalar_type> values_local(values.data() + e * vstride,
+                                              vstride);
+          _fn(values_local.data(), coeffs.data() + e * cstride,
+              constant_data.data(), coord_dofs.data(), entity_index, nullptr);
+          post_dof_transform(values_local, cell_info, entity, size0);
+        }
+
+        f(e0, std::span<const scalar_type>(values.data(), n * vstride),
+          {n, vstride});
       }
+    };
 
-      const scalar_type* coeff_cell = coeffs.data() + e * cstride;
-      const int* entity_index = get_entity_index(entities, e);
-
-      std::ranges::fill(values_local, 0);
-      _fn(values_local.data(), coeff_cell, constant_data.data(),
-          coord_dofs.data(), entity_index, nullptr);
-
-      post_dof_transform(values_local, cell_info, e, size0);
-      for (std::size_t j = 0; j < values_local.size(); ++j)
-        values[e * vshape[1] + j] = values_local[j];
-    }
+    const std::size_t nt
+        = std::min<std::size_t>(std::max(num_threads, 1), num_tiles);
+    if (nt <= 1)
+      eval_tiles(0, 1);
+    else
+      common::run_tasks(nt, [&](int t) { eval_tiles(t, nt); });
   }
 
   /// @brief Get function for tabulate_expression.
@@ -134,6 +134,18 @@ FiniteElement<T>::FiniteElement(const basix::FiniteElement<T>& element,
   }
 
   _signature = "Basix element " + family + " " + std::to_string(_bs);
+
+  // Precompute the basis at the interpolation points
+  const auto& [X, Xshape] = _element->points();
+  if (Xshape[0] > 0)
+  {
+    std::span<const T> Xp(X);
+    std::array<std::size_t, 2> shape = Xshape;
+    std::array<std::size_t, 4> s = _element->tabulate_shape(0, shape[0]);
+    _tabulation_cache->pin(0, Xp, shape, s[0] * s[1] * s[2] * s[3],
+                           [&](std::span<T> values)
+                           { _element->tabulate(0, Xp, shape, values); });
+  }
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
@@ -267,11 +279,19 @@ int FiniteElement<T>::block_size() const noexcept
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
 void FiniteElement<T>::tabulate(std::span<T> values, std::span<const T> X,
-                                std::array<std::size_t, 2> shape,
-                                int order) const
+                                std::array<std::size_t, 2> shape, int order,
+                                bool cache) const
 {
   assert(_element);
-  _element->tabulate(order, X, shape, values);
+  if (!cache)
+  {
+    _element->tabulate(order, X, shape, values);
+    return;
+  }
+
+  _tabulation_cache->tabulate(order, X, shape, values,
+                              [&](std::span<T> values)
+                              { _element->tabulate(order, X, shape, values); });
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
@@ -280,7 +300,11 @@ FiniteElement<T>::tabulate(std::span<const T> X,
                            std::array<std::size_t, 2> shape, int order) const
 {
   assert(_element);
-  return _element->tabulate(order, X, shape);
+  std::array<std::size_t, 4> tshape
+      = _element->tabulate_shape(order, shape[0]);
+  std::vector<T> values(tshape[0] * tshape[1] * tshape[2] * tshape[3]);
+  tabulate(values, X, shape, order);
+  return {std::move(values), tshape};
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
@@ -308,8 +332,8 @@ FiniteElement<T>::extract_sub_element(const std::vector<int>& component) const
 {
   // Recursively extract sub element
   auto sub_finite_element = _extract_sub_element(*this, component);
-  spdlog::debug("Extracted finite element for sub-system: {}",
-                sub_finite_element->signature().c_str());
+  DOLFINX_LOG_DEBUG("Extracted finite element for sub-system: {}",
+                    sub_finite_element->signature().c_str());
   return sub_finite_element;
 }
 //-----------------------------------------------------------------------------
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "TabulationCache.h"
 #include "traits.h"
+#include <algorithm>
 #include <array>
 #include <basix/finite-element.h>
 #include <concepts>
@@ -139,9 +141,16 @@ public:
   /// @param[in] shape The shape of `X`
   /// @param[in] order The number of derivatives (up to and including
   /// this order) to tabulate for
+  /// @param[in] cache If true, tables for small sets of points are
+  /// cached, so repeated tabulation at the same points copies the
+  /// cached table. Use `false` for points that are unlikely to be
+  /// repeated, e.g. physical points pulled back to the reference cell.
+  ///
+  /// @note The table at the interpolation points is precomputed.
   void tabulate(std::span<geometry_type> values,
                 std::span<const geometry_type> X,
-                std::array<std::size_t, 2> shape, int order) const;
+                std::array<std::size_t, 2> shape, int order,
+                bool cache = true) const;
 
   /// Evaluate all derivatives of the basis functions up to given order
   /// at given points in reference cell
@@ -501,6 +510,136 @@ public:
     }
   }
 
+  /// @brief Return a function that applies a DOF transformation
+  /// operator to some data, using operators that are precomputed for
+  /// the cells of a mesh.
+  ///
+  /// The returned function applies the same transformation as the
+  /// function returned by dof_transformation_fn(). Instead of applying
+  /// the transformations of the sub-entities of a cell in turn, the
+  /// operator of each distinct cell permutation value in `cell_info` is
+  /// computed once and stored as a sparse matrix, and cells for which
+  /// the operator is the identity are skipped. This is cheaper in
+  /// kernels that apply the transformation for every cell, e.g. in
+  /// assembly.
+  ///
+  /// The `cell_info` argument of the returned function is not used,
+  /// and the cell argument must be a cell of the mesh that `cell_info`
+  /// is from.
+  ///
+  /// The operators are computed when this function is called and are
+  /// not cached, e.g. the assemblers compute them once per assembly
+  /// call. The cost is a sort of `cell_info` and the application of
+  /// the transformation to the identity matrix for each distinct
+  /// permutation value, which is small compared to assembly.
+  ///
+  /// @param[in] ttype The transformation type. See
+  /// dof_transformation_fn().
+  /// @param[in] cell_info Permutation data for all cells of a mesh. Can
+  /// be empty if the element does not need DOF transformations.
+  /// @param[in] scalar_element Indicates whether the scalar
+  /// transformations should be returned for a vector element
+  template <typename U>
+  std::function<void(std::span<U>, std::span<const std::uint32_t>, std::int32_t,
+                     int)>
+  precomputed_dof_transformation_fn(doftransform ttype,
+                                    std::span<const std::uint32_t> cell_info,
+                                    bool scalar_element = false) const
+  {
+    if (!needs_dof_transformations())
+      return dof_transformation_fn<U>(ttype, scalar_element);
+
+    if (!_sub_elements.empty())
+    {
+      if (_is_mixed)
+      {
+        // Mixed element
+        std::vector<std::function<void(
+            std::span<U>, std::span<const std::uint32_t>, std::int32_t, int)>>
+            sub_element_fns;
+        std::vector<int> dims;
+        for (std::size_t i = 0; i < _sub_elements.size(); ++i)
+        {
+          sub_element_fns.push_back(
+              _sub_elements[i]
+                  ->template precomputed_dof_transformation_fn<U>(ttype,
+                                                                  cell_info));
+          dims.push_back(_sub_elements[i]->space_dimension());
+        }
+
+        return [dims, sub_element_fns](std::span<U> data,
+                                       std::span<const std::uint32_t> cell_info,
+                                       std::int32_t cell, int block_size)
+        {
+          std::size_t offset = 0;
+          for (std::size_t e = 0; e < sub_element_fns.size(); ++e)
+          {
+            const std::size_t width = dims[e] * block_size;
+            sub_element_fns[e](data.subspan(offset, width), cell_info, cell,
+                               block_size);
+            offset += width;
+          }
+        };
+      }
+      else if (!scalar_element)
+      {
+        // Blocked element
+        std::function<void(std::span<U>, std::span<const std::uint32_t>,
+                           std::int32_t, int)>
+            sub_fn = _sub_elements[0]
+                         ->template precomputed_dof_transformation_fn<U>(
+                             ttype, cell_info);
+        const int ebs = _bs;
+        return [ebs, sub_fn](std::span<U> data,
+                             std::span<const std::uint32_t> cell_info,
+                             std::int32_t cell, int data_block_size)
+        { sub_fn(data, cell_info, cell, ebs * data_block_size); };
+      }
+    }
+
+    std::function<void(std::span<U>, std::int32_t, int, std::size_t)> fn
+        = precompute_transformation<U>(dof_transformation_fn<U>(ttype, true),
+                                       cell_info, false);
+    return [fn](std::span<U> data, std::span<const std::uint32_t>,
+                std::int32_t cell, int n) { fn(data, cell, n, 0); };
+  }
+
+  /// @brief Return a function that applies DOF transformation to some
+  /// transposed data, using operators that are precomputed for the
+  /// cells of a mesh.
+  ///
+  /// The returned function applies the same transformation as the
+  /// function returned by dof_transformation_right_fn(). See
+  /// precomputed_dof_transformation_fn() for how the operators are
+  /// precomputed.
+  ///
+  /// @param[in] ttype Transformation type. See dof_transformation_fn().
+  /// @param[in] cell_info Permutation data for all cells of a mesh. Can
+  /// be empty if the element does not need DOF transformations.
+  /// @param[in] scalar_element Indicate if the scalar transformations
+  /// should be returned for a vector element.
+  template <typename U>
+  std::function<void(std::span<U>, std::span<const std::uint32_t>, std::int32_t,
+                     int)>
+  precomputed_dof_transformation_right_fn(
+      doftransform ttype, std::span<const std::uint32_t> cell_info,
+      bool scalar_element = false) const
+  {
+    if (!needs_dof_transformations())
+      return dof_transformation_right_fn<U>(ttype, scalar_element);
+
+    // The data has n rows. The row stride is found from the size of
+    // the data, as in dof_transformation_right_fn(), e.g. the rows of
+    // the element tensor of an interior facet integral hold the dofs of
+    // two cells.
+    std::function<void(std::span<U>, std::int32_t, int, std::size_t)> fn
+        = precomputed_right_transformation<U>(ttype, cell_info,
+                                              scalar_element);
+    return [fn](std::span<U> data, std::span<const std::uint32_t>,
+                std::int32_t cell, int n)
+    { fn(data, cell, n, data.size() / n); };
+  }
+
   /// @brief Transform basis functions from the reference element
   /// ordering and orientation to the globally consistent physical
   /// element ordering and orientation.
@@ -716,6 +855,176 @@ public:
   dof_permutation_fn(bool inverse = false, bool scalar_element = false) const;
 
 private:
+  // Return a function fn(data, cell, n, stride) that applies the
+  // precomputed right transformation of cell `cell` to the first
+  // space_dimension() entries of the n rows of `data`, which have row
+  // stride `stride`. Passing the stride explicitly allows the
+  // sub-elements of a mixed element to transform their part of the
+  // rows of the data of the mixed element.
+  template <typename U>
+  std::function<void(std::span<U>, std::int32_t, int, std::size_t)>
+  precomputed_right_transformation(doftransform ttype,
+                                   std::span<const std::uint32_t> cell_info,
+                                   bool scalar_element) const
+  {
+    if (!needs_dof_transformations())
+      return [](std::span<U>, std::int32_t, int, std::size_t) {};
+
+    if (!_sub_elements.empty())
+    {
+      if (_is_mixed)
+      {
+        // Mixed element
+        std::vector<
+            std::function<void(std::span<U>, std::int32_t, int, std::size_t)>>
+            sub_element_fns;
+        std::vector<int> dims;
+        for (std::size_t i = 0; i < _sub_elements.size(); ++i)
+        {
+          sub_element_fns.push_back(
+              _sub_elements[i]->template precomputed_right_transformation<U>(
+                  ttype, cell_info, false));
+          dims.push_back(_sub_elements[i]->space_dimension());
+        }
+
+        return [dims, sub_element_fns](std::span<U> data, std::int32_t cell,
+                                       int n, std::size_t stride)
+        {
+          std::size_t offset = 0;
+          for (std::size_t e = 0; e < sub_element_fns.size(); ++e)
+          {
+            sub_element_fns[e](data.subspan(offset), cell, n, stride);
+            offset += dims[e];
+          }
+        };
+      }
+      else if (!scalar_element)
+      {
+        // Blocked element. Each row is transformed as data of shape
+        // (num_dofs, block_size), see dof_transformation_right_fn().
+        std::function<void(std::span<U>, std::span<const std::uint32_t>,
+                           std::int32_t, int)>
+            sub_fn = _sub_elements[0]
+                         ->template precomputed_dof_transformation_fn<U>(
+                             ttype, cell_info);
+        const int ebs = _bs;
+        const std::size_t width = _space_dim;
+        return [ebs, width, sub_fn](std::span<U> data, std::int32_t cell,
+                                    int n, std::size_t stride)
+        {
+          for (int j = 0; j < n; ++j)
+            sub_fn(data.subspan(j * stride, width), {}, cell, ebs);
+        };
+      }
+    }
+
+    return precompute_transformation<U>(
+        dof_transformation_right_fn<U>(ttype, true), cell_info, true);
+  }
+
+  // Precompute the operator of the transformation function `fn` of a
+  // scalar element for each distinct value in `cell_info`, and return
+  // a function fn(data, cell, n, stride) that applies the precomputed
+  // operators. The operators are found by applying `fn` to the
+  // identity matrix, and are stored as sparse matrices. For `right`
+  // transformations the data has n rows with row stride `stride`, of
+  // which the first dim entries are transformed, and the operators are
+  // stored transposed. Otherwise the data has shape (dim, n) and
+  // `stride` is not used.
+  template <typename U>
+  std::function<void(std::span<U>, std::int32_t, int, std::size_t)>
+  precompute_transformation(
+      const std::function<void(std::span<U>, std::span<const std::uint32_t>,
+                               std::int32_t, int)>& fn,
+      std::span<const std::uint32_t> cell_info, bool right) const
+  {
+    const int dim = _space_dim / _bs;
+    std::vector<std::uint32_t> values(cell_info.begin(), cell_info.end());
+    std::ranges::sort(values);
+    auto [unique_end, range_end] = std::ranges::unique(values);
+    values.erase(unique_end, range_end);
+
+    // Operator index for each distinct value (-1 for the identity), and
+    // the rows of the operators
+    std::vector<std::int32_t> value_to_op(values.size(), -1);
+    std::vector<std::int32_t> row_ptr = {0}, cols;
+    std::vector<U> vals;
+    std::vector<U> M(dim * dim);
+    std::int32_t num_ops = 0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      std::ranges::fill(M, 0);
+      for (int j = 0; j < dim; ++j)
+        M[j * dim + j] = 1;
+      fn(M, std::span(values.data() + i, 1), 0, dim);
+
+      bool identity = true;
+      for (int r = 0; r < dim and identity; ++r)
+        for (int c = 0; c < dim and identity; ++c)
+          identity = M[r * dim + c] == U(r == c ? 1 : 0);
+      if (identity)
+        continue;
+
+      value_to_op[i] = num_ops++;
+      for (int r = 0; r < dim; ++r)
+      {
+        for (int c = 0; c < dim; ++c)
+        {
+          if (U a = right ? M[c * dim + r] : M[r * dim + c]; a != U(0))
+          {
+            cols.push_back(c);
+            vals.push_back(a);
+          }
+        }
+        row_ptr.push_back(cols.size());
+      }
+    }
+
+    std::vector<std::int32_t> cell_to_op(cell_info.size());
+    for (std::size_t c = 0; c < cell_info.size(); ++c)
+    {
+      auto it = std::ranges::lower_bound(values, cell_info[c]);
+      cell_to_op[c] = value_to_op[std::distance(values.begin(), it)];
+    }
+
+    return [dim, right, cell_to_op = std::move(cell_to_op),
+            row_ptr = std::move(row_ptr), cols = std::move(cols),
+            vals = std::move(vals)](std::span<U> data, std::int32_t cell,
+                                    int n, std::size_t stride)
+    {
+      const std::int32_t op = cell_to_op[cell];
+      if (op < 0)
+        return;
+
+      // Apply the operator to each column (left) or row (right) of the
+      // data, using a copy of the column or row
+      std::array<U, 64> w_stack;
+      std::vector<U> w_heap;
+      U* w = w_stack.data();
+      if (dim > (int)w_stack.size())
+      {
+        w_heap.resize(dim);
+        w = w_heap.data();
+      }
+      const std::int32_t* rows = row_ptr.data() + op * dim;
+      const std::size_t stride0 = right ? 1 : n;
+      const std::size_t stride1 = right ? stride : 1;
+      for (int j = 0; j < n; ++j)
+      {
+        U* d = data.data() + j * stride1;
+        for (int k = 0; k < dim; ++k)
+          w[k] = d[k * stride0];
+        for (int i = 0; i < dim; ++i)
+        {
+          U acc = 0;
+          for (std::int32_t q = rows[i]; q < rows[i + 1]; ++q)
+            acc += vals[q] * w[cols[q]];
+          d[i * stride0] = acc;
+        }
+      }
+    };
+  }
+
   std::string _signature;
 
   int _space_dim;
@@ -737,6 +1046,10 @@ private:
   // Basix Element (nullptr for mixed elements)
   std::unique_ptr<basix::FiniteElement<geometry_type>> _element;
 
+  // Tables of repeated tabulations
+  std::unique_ptr<impl::TabulationCache<geometry_type>> _tabulation_cache
+      = std::make_unique<impl::TabulationCache<geometry_type>>();
+
   // Indicate whether this element represents a symmetric 2-tensor
   bool _symmetric;
 
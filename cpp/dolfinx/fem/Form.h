@@ -13,10 +13,14 @@
 #include <concepts>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/common/types.h>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <tuple>
@@ -104,6 +108,57 @@ struct integral_data
   /// @brief Indices of coefficients (from the form) that are in this
   /// integral.
   std::vector<int> coeffs;
+
+  /// @brief Optional batched integration kernel for cell integrals.
+  ///
+  /// The kernel has the same signature as `kernel`, but computes the
+  /// element tensors for `batch_size` cells in one call. The element
+  /// tensor, coefficient and coordinate data are in structure-of-arrays
+  /// layout, i.e. entry `i` for cell `b` of the batch is at position `i
+  /// * batch_size + b`. Constants are not batched. If empty, `kernel`
+  /// is used.
+  std::function<void(T*, const T*, const T*, const U*, const int*,
+                     const uint8_t*)>
+      batch_kernel;
+
+  /// @brief Number of cells computed by one call of `batch_kernel`.
+  int batch_size = 0;
+
+  /// @brief Estimated number of floating point operations of one call
+  /// of `kernel`, or zero if unknown. Used by the assembly counters
+  /// (see set_assembly_profiling) to report the achieved flop rate.
+  double flops = 0;
+};
+
+/// @brief Integrals of a Form that are assembled in one pass over
+/// their entities (see Form::integral_groups).
+struct integral_group
+{
+  /// @brief Integral IDs, in ascending order.
+  std::vector<int> ids;
+
+  /// @brief The entities of the integrals, concatenated in the order of
+  /// `ids`. Empty if the group has a single integral, in which case the
+  /// entities are Form::domain(type, ids.front()).
+  std::vector<std::int32_t> entities;
+};
+
+/// @brief Per-facet data of a group of interior facet integrals,
+/// stored contiguously in the order of the group entities (see
+/// Form::facet_pairs).
+struct facet_pair_data
+{
+  /// @brief Dofs of the two cells of each facet for the test (0) and
+  /// trial (1) functions, with the dofs of the first cell followed by
+  /// the dofs of the second cell. Flattened row-major with
+  /// `shape=(num_facets, 2 * num_cell_dofs)`. The trial function dofs
+  /// are empty for linear forms.
+  std::array<std::vector<std::int32_t>, 2> dofs;
+
+  /// @brief Permutations of each facet relative to the two cells,
+  /// `shape=(num_facets, 2)`. Empty if the form does not need facet
+  /// permutations.
+  std::vector<std::uint8_t> perms;
 };
 
 /// @brief A representation of finite element variational forms.
@@ -218,13 +273,89 @@ public:
 
       std::vector<integral_data<scalar_type, geometry_type>>& itg
           = _integrals[static_cast<std::size_t>(domain_type)];
-      for (auto&& [id, kern, e, c] : data)
-        itg.emplace_back(id, kern, std::move(e), std::move(c));
+      for (auto&& d : data)
+        itg.push_back(std::move(d));
     }
 
     // Store entity maps
     for (auto [msh, map] : entity_maps)
       _entity_maps.insert({msh, std::vector(map.begin(), map.end())});
+
+    // Group integrals with the same kernel. Cell integrals are not
+    // grouped, since they use per-integral geometry data and batched
+    // kernels.
+    using kern_t = void (*)(scalar_type*, const scalar_type*,
+                            const scalar_type*, const geometry_type*,
+                            const int*, const std::uint8_t*);
+    for (std::size_t t = 0; t < _integrals.size(); ++t)
+    {
+      const std::vector<integral_data<scalar_type, geometry_type>>& itg
+          = _integrals[t];
+      std::vector<integral_group>& groups = _integral_groups[t];
+      const bool fuse = static_cast<IntegralType>(t) != IntegralType::cell;
+      std::vector<std::size_t> first;
+      for (std::size_t i = 0; i < itg.size(); ++i)
+      {
+        const kern_t* k = itg[i].kernel.template target<kern_t>();
+        auto same_kernel = [&](std::size_t j)
+        {
+          const kern_t* kj = itg[j].kernel.template target<kern_t>();
+          return k and kj and *k == *kj and !itg[i].batch_kernel
+                 and !itg[j].batch_kernel and itg[i].coeffs == itg[j].coeffs;
+        };
+        auto it = fuse ? std::ranges::find_if(first, same_kernel) : first.end();
+        if (it == first.end())
+        {
+          first.push_back(i);
+          groups.push_back({{itg[i].id}, {}});
+        }
+        else
+          groups[std::distance(first.begin(), it)].ids.push_back(itg[i].id);
+      }
+
+      for (integral_group& g : groups)
+      {
+        if (g.ids.size() > 1)
+        {
+          for (int id : g.ids)
+          {
+            std::span<const std::int32_t> e
+                = domain(static_cast<IntegralType>(t), id);
+            g.entities.insert(g.entities.end(), e.begin(), e.end());
+          }
+        }
+      }
+    }
+
+    // Translate the integration entities to the numbering of each mesh
+    // in the entity maps, so that assemblers of mixed-dimensional forms
+    // use contiguous arrays with no per-call translation
+    for (auto& [msh, map] : _entity_maps)
+    {
+      for (std::size_t t = 0; t < _integrals.size(); ++t)
+      {
+        const IntegralType type = static_cast<IntegralType>(t);
+        for (auto& itg : _integrals[t])
+        {
+          _mapped_entities[{msh.get(), type, itg.id}]
+              = map_entities(type, itg.entities, *msh, map);
+        }
+        for (integral_group& g : _integral_groups[t])
+        {
+          if (g.ids.size() > 1)
+          {
+            _mapped_group_entities[{msh.get(), type, g.ids.front()}]
+                = map_entities(type, g.entities, *msh, map);
+          }
+        }
+      }
+    }
+
+    // Allocate storage for the packed constants
+    std::size_t num_constant_values = 0;
+    for (auto& c : _constants)
+      num_constant_values += c->value.size();
+    _packed_constants.resize(num_constant_values);
   }
 
   /// Copy constructor
@@ -276,6 +407,67 @@ public:
       throw std::runtime_error("No kernel for requested domain index.");
   }
 
+  /// @brief Get the batched kernel function for integral `i` on given
+  /// domain type.
+  /// @param[in] type Integral type.
+  /// @param[in] i Domain identifier (index).
+  /// @return Batched kernel (see integral_data::batch_kernel) and the
+  /// batch size. The kernel is empty if the integral has no batched
+  /// kernel.
+  std::pair<std::function<void(scalar_type*, const scalar_type*,
+                               const scalar_type*, const geometry_type*,
+                               const int*, const uint8_t*)>,
+            int>
+  batch_kernel(IntegralType type, int i) const
+  {
+    const auto& integrals = _integrals[static_cast<std::size_t>(type)];
+    auto it = std::ranges::lower_bound(integrals, i, std::less<>{},
+                                       [](const auto& a) { return a.id; });
+    if (it != integrals.end() and it->id == i)
+      return {it->batch_kernel, it->batch_size};
+    else
+      throw std::runtime_error("No kernel for requested domain index.");
+  }
+
+  /// @brief Get the flop estimate of the kernel for integral `i` on
+  /// given domain type.
+  /// @param[in] type Integral type.
+  /// @param[in] i Domain identifier (index).
+  /// @return Estimated number of floating point operations of one
+  /// kernel call (see integral_data::flops), or zero if unknown.
+  double kernel_flops(IntegralType type, int i) const
+  {
+    const auto& integrals = _integrals[static_cast<std::size_t>(type)];
+    auto it = std::ranges::lower_bound(integrals, i, std::less<>{},
+                                       [](const auto& a) { return a.id; });
+    if (it != integrals.end() and it->id == i)
+      return it->flops;
+    else
+      throw std::runtime_error("No kernel for requested domain index.");
+  }
+
+  /// @brief Set the flop estimate of the kernel for integral `i` on
+  /// given domain type.
+  ///
+  /// UFCx does not provide flop counts, so the estimate is zero for
+  /// forms created from UFCx forms. It can be set from, e.g., an
+  /// operation count of the generated code.
+  ///
+  /// @param[in] type Integral type.
+  /// @param[in] i Domain identifier (index).
+  /// @param[in] flops Number of floating point operations of one
+  /// kernel call.
+  void set_kernel_flops(IntegralType type, int i, double flops)
+  {
+    auto& integrals = _integrals[static_cast<std::size_t>(type)];
+    auto it = std::ranges::lower_bound(integrals, i, std::less<>{},
+                                       [](const auto& a) { return a.id; });
+    if (it != integrals.end() and it->id == i)
+      it->flops = flops;
+    else
+      throw std::runtime_error("No kernel for requested domain index.");
+  }
+
   /// @brief Get types of integrals in the form.
   /// @return Integrals types.
   std::set<IntegralType> integral_types() const
@@ -358,90 +550,320 @@ public:
       throw std::runtime_error("No mesh entities for requested domain index.");
   }
 
-  /// @brief Compute the list of entity indices in `mesh` for the ith
-  /// integral (kernel) of a given type (i.e. cell, exterior facet, or
-  /// interior facet).
+  /// @brief List of entity indices in `mesh` for the ith integral
+  /// (kernel) of a given type (i.e. cell, exterior facet, or interior
+  /// facet).
+  ///
+  /// The entities in the numbering of each mesh in the entity maps are
+  /// computed when the form is created, so this function does not
+  /// allocate.
   ///
   /// @param type Integral type.
   /// @param i Integral ID, i.e. the (sub)domain index.
   /// @param mesh The mesh the entities are numbered with respect to.
   /// @return List of active entities in `mesh` for the given integral.
-  std::vector<std::int32_t> domain(IntegralType type, int i,
-                                   const mesh::Mesh<geometry_type>& mesh) const
+  std::span<const std::int32_t>
+  domain(IntegralType type, int i, const mesh::Mesh<geometry_type>& mesh) const
+  {
+    if (&mesh == _mesh.get())
+      return domain(type, i);
+    else if (auto it = _mapped_entities.find({&mesh, type, i});
+             it != _mapped_entities.end())
+    {
+      return it->second;
+    }
+    else
+    {
+      throw std::runtime_error(
+          "No mesh entities for requested domain index and mesh.");
+    }
+  }
+
+  /// @brief Groups of integrals of a given type that are assembled in
+  /// one pass.
+  ///
+  /// Facet integrals with the same kernel (the same function pointer,
+  /// e.g. when the generated code shares a kernel between subdomains
+  /// with the same integrand), the same active coefficients and no
+  /// batched kernel are grouped, and the entities of the integrals in
+  /// a group are concatenated. Assemblers execute one loop for each
+  /// group, rather than for each integral, which removes the setup cost
+  /// of the loops for forms with many small integrals, e.g. `ds(1) +
+  /// ... + ds(n)` with the same integrand. Each cell integral is a
+  /// group of its own.
+  ///
+  /// @param[in] type Integral type.
+  /// @return Groups, ordered by their first integral ID.
+  const std::vector<integral_group>& integral_groups(IntegralType type) const
   {
-    // Hack to avoid passing shared pointer to this function
-    std::shared_ptr<const mesh::Mesh<geometry_type>> msh_ptr(
-        &mesh, [](const mesh::Mesh<geometry_type>*) {});
+    return _integral_groups[static_cast<std::size_t>(type)];
+  }
 
-    std::span<const std::int32_t> entities = domain(type, i);
-    if (msh_ptr == _mesh)
-      return std::vector(entities.begin(), entities.end());
+  /// @brief Entities of a group of integrals (see integral_groups).
+  /// @param[in] type Integral type.
+  /// @param[in] group The group.
+  /// @return The entities of the integrals in the group, concatenated
+  /// with the layout of domain().
+  std::span<const std::int32_t> domain(IntegralType type,
+                                       const integral_group& group) const
+  {
+    if (group.ids.size() == 1)
+      return domain(type, group.ids.front());
     else
+      return group.entities;
+  }
+
+  /// @brief Entities of a group of integrals (see integral_groups),
+  /// numbered with respect to `mesh`.
+  /// @param[in] type Integral type.
+  /// @param[in] group The group.
+  /// @param[in] mesh The mesh the entities are numbered with respect to.
+  /// @return The entities in `mesh` of the integrals in the group.
+  std::span<const std::int32_t>
+  domain(IntegralType type, const integral_group& group,
+         const mesh::Mesh<geometry_type>& mesh) const
+  {
+    if (group.ids.size() == 1)
+      return domain(type, group.ids.front(), mesh);
+    else if (&mesh == _mesh.get())
+      return group.entities;
+    else if (auto it = _mapped_group_entities.find(
+                 {&mesh, type, group.ids.front()});
+             it != _mapped_group_entities.end())
     {
-      std::span<const std::int32_t> entity_map = _entity_maps.at(msh_ptr);
-      std::vector<std::int32_t> mapped_entities;
-      mapped_entities.reserve(entities.size());
-      switch (type)
-      {
-      case IntegralType::cell:
+      return it->second;
+    }
+    else
+    {
+      throw std::runtime_error(
+          "No mesh entities for requested integral group and mesh.");
+    }
+  }
+
+  /// @brief Enable or disable caching of packed cell coordinate dofs.
+  ///
+  /// When caching is enabled, the coordinate dofs of the cells of a
+  /// cell integral are packed contiguously, in the order of domain(),
+  /// the first time they are requested via coordinate_dofs() and are
+  /// re-used by later calls. Assemblers use the packed data instead of
+  /// gathering the coordinate dofs through the geometry dofmap. The
+  /// cache is cleared when the mesh geometry has been modified (see
+  /// mesh::Geometry::x_version).
+  ///
+  /// @param[in] max_bytes Maximum memory (in bytes) used by the cache.
+  /// Integrals whose data would exceed the limit are not cached. A
+  /// limit of zero disables caching and releases cached data.
+  void set_geometry_cache(std::size_t max_bytes)
+  {
+    _geometry_cache_max_bytes = max_bytes;
+    _geometry_cache.clear();
+  }
+
+  /// @brief Packed coordinate dofs for the cells of a cell integral.
+  ///
+  /// @note This function is not thread-safe.
+  ///
+  /// @param[in] i Integral ID, i.e. (sub)domain index.
+  /// @return Coordinate dofs of the cells `domain(IntegralType::cell,
+  /// i)`, flattened row-major with `shape=(num_cells, 3 *
+  /// num_dofs_g)`. Empty if caching is disabled (see
+  /// set_geometry_cache) or the data for the integral does not fit in
+  /// the cache.
+  std::span<const geometry_type> coordinate_dofs(int i) const
+  {
+    if (_geometry_cache_max_bytes == 0)
+      return {};
+
+    const mesh::Geometry<geometry_type>& geometry = _mesh->geometry();
+    if (geometry.x_version() != _geometry_cache_version)
+    {
+      _geometry_cache.clear();
+      _geometry_cache_version = geometry.x_version();
+    }
+
+    if (auto it = _geometry_cache.find(i); it != _geometry_cache.end())
+      return it->second;
+
+    // Check that the data fits in the cache
+    std::span<const std::int32_t> cells = domain(IntegralType::cell, i);
+    auto x_dofmap = geometry.dofmap();
+    const std::size_t num_dofs_g = x_dofmap.extent(1);
+    std::size_t size = 3 * num_dofs_g * cells.size();
+    for (auto& [id, data] : _geometry_cache)
+      size += data.size();
+    if (size * sizeof(geometry_type) > _geometry_cache_max_bytes)
+      return {};
+
+    std::span<const geometry_type> x = geometry.x();
+    std::vector<geometry_type> coordinate_dofs(3 * num_dofs_g * cells.size());
+    for (std::size_t index = 0; index < cells.size(); ++index)
+    {
+      for (std::size_t j = 0; j < num_dofs_g; ++j)
       {
-        std::ranges::transform(entities, std::back_inserter(mapped_entities),
-                               [&entity_map](auto e) { return entity_map[e]; });
-        break;
+        std::copy_n(std::next(x.begin(), 3 * x_dofmap(cells[index], j)), 3,
+                    std::next(coordinate_dofs.begin(),
+                              3 * (index * num_dofs_g + j)));
       }
-      case IntegralType::exterior_facet:
-      {
-        // Get the codimension of the mesh
-        const int tdim = _mesh->topology()->dim();
-        const int codim = tdim - mesh.topology()->dim();
-        assert(codim >= 0);
-        if (codim == 0)
-        {
-          for (std::size_t i = 0; i < entities.size(); i += 2)
-          {
-            // Add cell and the local facet index
-            mapped_entities.insert(mapped_entities.end(),
-                                   {entity_map[entities[i]], entities[i + 1]});
-          }
-        }
-        else if (codim == 1)
-        {
-          // In this case, the entity maps take facets in (`_mesh`) to cells in
-          // `mesh`, so we need to get the facet number from the (cell,
-          // local_facet pair) first.
-          auto c_to_f = _mesh->topology()->connectivity(tdim, tdim - 1);
-          assert(c_to_f);
-          for (std::size_t i = 0; i < entities.size(); i += 2)
-          {
-            // Get the facet index
-            const std::int32_t facet
-                = c_to_f->links(entities[i])[entities[i + 1]];
-            // Add cell and the local facet index
-            mapped_entities.insert(mapped_entities.end(),
-                                   {entity_map[facet], entities[i + 1]});
-          }
-        }
-        else
-          throw std::runtime_error("Codimension > 1 not supported.");
+    }
 
-        break;
-      }
-      case IntegralType::interior_facet:
+    return _geometry_cache.insert({i, std::move(coordinate_dofs)})
+        .first->second;
+  }
+
+  /// @brief Enable or disable compact geometry storage for assembly.
+  ///
+  /// When enabled, cell integrals gather the cell coordinate dofs from a
+  /// copy of the mesh geometry that stores `gdim` components per point
+  /// in single precision (see mesh::CompactCoordinates and
+  /// compact_coordinates). Kernels receive coordinates of type
+  /// `geometry_type` with three components per point. Packed coordinate
+  /// dofs (see set_geometry_cache) are used in preference to the
+  /// compact geometry.
+  ///
+  /// @note For `geometry_type = double` the coordinates passed to the
+  /// kernels are rounded to single precision.
+  ///
+  /// @param[in] compact True to use compact geometry storage.
+  void set_compact_geometry(bool compact)
+  {
+    _compact_geometry = compact;
+    _x_compact.reset();
+  }
+
+  /// @brief Compact copy of the mesh geometry used by assemblers.
+  ///
+  /// The copy is created the first time it is requested and is
+  /// re-created when the mesh geometry has been modified (see
+  /// mesh::Geometry::x_version).
+  ///
+  /// @note This function is not thread-safe.
+  ///
+  /// @return Compact geometry, or `nullptr` if compact geometry storage
+  /// is not enabled (see set_compact_geometry).
+  const mesh::CompactCoordinates<float>* compact_coordinates() const
+  {
+    if (!_compact_geometry)
+      return nullptr;
+
+    const mesh::Geometry<geometry_type>& geometry = _mesh->geometry();
+    if (!_x_compact or geometry.x_version() != _x_compact_version)
+    {
+      _x_compact.emplace(geometry.x(), geometry.dim());
+      _x_compact_version = geometry.x_version();
+    }
+
+    return &*_x_compact;
+  }
+
+  /// @brief Enable or disable caching of interior facet data.
+  ///
+  /// When caching is enabled, the joined cell dofs and the facet
+  /// permutations of the facets of a group of interior facet integrals
+  /// are computed the first time they are requested via facet_pairs()
+  /// and are re-used by later calls. Assemblers use the cached data
+  /// instead of concatenating the cell dofs of each facet.
+  ///
+  /// @param[in] cache True to enable caching. Disabling caching
+  /// releases cached data.
+  void set_facet_pair_cache(bool cache)
+  {
+    _facet_pair_cache_enabled = cache;
+    _facet_pair_cache.clear();
+  }
+
+  /// @brief Cached data for the facets of a group of interior facet
+  /// integrals.
+  ///
+  /// @note This function is not thread-safe.
+  ///
+  /// @param[in] group A group of interior facet integrals (see
+  /// integral_groups).
+  /// @return Data for the facets `domain(IntegralType::interior_facet,
+  /// group)`, or `nullptr` if caching is disabled (see
+  /// set_facet_pair_cache).
+  const facet_pair_data* facet_pairs(const integral_group& group) const
+  {
+    if (!_facet_pair_cache_enabled)
+      return nullptr;
+
+    if (auto it = _facet_pair_cache.find(group.ids);
+        it != _facet_pair_cache.end())
+    {
+      return &it->second;
+    }
+
+    facet_pair_data data;
+    for (std::size_t k = 0; k < _function_spaces.size(); ++k)
+    {
+      const FunctionSpace<geometry_type>& V = *_function_spaces[k];
+      std::span<const std::int32_t> facets
+          = domain(IntegralType::interior_facet, group, *V.mesh());
+      auto dofmap = V.dofmap()->map();
+      const std::size_t num_dofs = dofmap.extent(1);
+      std::vector<std::int32_t>& dofs = data.dofs[k];
+      dofs.resize(facets.size() / 2 * num_dofs);
+      for (std::size_t f = 0; f < facets.size() / 2; ++f)
       {
-        for (std::size_t i = 0; i < entities.size(); i += 2)
-        {
-          // Add cell and the local facet index
-          mapped_entities.insert(mapped_entities.end(),
-                                 {entity_map[entities[i]], entities[i + 1]});
-        }
-        break;
+        for (std::size_t j = 0; j < num_dofs; ++j)
+          dofs[f * num_dofs + j] = dofmap(facets[2 * f], j);
       }
-      default:
-        throw std::runtime_error("Integral type not supported.");
+    }
+
+    if (_needs_facet_permutations)
+    {
+      auto topology = _mesh->topology_mutable();
+      topology->create_entity_permutations();
+      const std::vector<std::uint8_t>& perms
+          = topology->get_facet_permutations();
+      const int num_facets_per_cell = mesh::cell_num_entities(
+          topology->cell_type(), topology->dim() - 1);
+      std::span<const std::int32_t> facets
+          = domain(IntegralType::interior_facet, group);
+      data.perms.resize(facets.size() / 2);
+      for (std::size_t f = 0; f < facets.size() / 2; ++f)
+      {
+        data.perms[f] = perms[facets[2 * f] * num_facets_per_cell
+                              + facets[2 * f + 1]];
       }
+    }
 
-      return mapped_entities;
+    return &_facet_pair_cache.insert({group.ids, std::move(data)})
+                .first->second;
+  }
+
+  /// @brief Colouring of the integration entities of an integral for
+  /// threaded assembly (see impl::assemble_threaded).
+  ///
+  /// The colouring is computed by `colour` on first use and is re-used
+  /// by later calls, i.e. by later assembly calls on the form.
+  ///
+  /// @note This function is not thread-safe.
+  ///
+  /// @param[in] type Integral type.
+  /// @param[in] i Integral ID. For a group of integrals (see
+  /// integral_groups), the ID of the first integral of the group.
+  /// @param[in] num_entities Number of integration entities. The
+  /// colouring is re-computed if it does not colour this number of
+  /// entities.
+  /// @param[in] colour Function called as `colour()` that returns the
+  /// colouring.
+  /// @return The colouring, where `links(c)` are the positions of the
+  /// entities with colour `c`.
+  template <typename F>
+  const graph::AdjacencyList<std::int32_t>&
+  entity_colouring(IntegralType type, int i, std::size_t num_entities,
+                   F&& colour) const
+  {
+    auto it = _colouring_cache.find({type, i});
+    if (it != _colouring_cache.end()
+        and it->second.array().size() == num_entities)
+    {
+      return it->second;
     }
+
+    if (it != _colouring_cache.end())
+      _colouring_cache.erase(it);
+    return _colouring_cache.insert({{type, i}, colour()}).first->second;
   }
 
   /// @brief Access coefficients.
@@ -480,7 +902,171 @@ public:
     return _constants;
   }
 
+  /// @brief Packed values of the form constants.
+  ///
+  /// The values are copied into a buffer that is owned by the form, so
+  /// packing the constants does not allocate memory when a form is
+  /// assembled repeatedly. The returned data has the same layout as
+  /// the data returned by pack_constants. Constant values can be
+  /// modified in-place, so the values are copied on every call and the
+  /// returned span is valid until the next call.
+  ///
+  /// @note Calling this function concurrently for the same form is not
+  /// thread-safe.
+  /// @return Packed constant values.
+  std::span<const scalar_type> packed_constants() const
+  {
+    std::size_t size = 0;
+    for (auto& c : _constants)
+      size += c->value.size();
+    _packed_constants.resize(size);
+
+    auto it = _packed_constants.begin();
+    for (auto& c : _constants)
+      it = std::ranges::copy(c->value, it).out;
+    return _packed_constants;
+  }
+
+  /// @brief Memory used by the form.
+  ///
+  /// The mesh, function spaces, coefficients and constants, which are
+  /// owned by other objects, are not included.
+  /// @return Memory usage, with the integration domains, entity maps,
+  /// packed constants, cached geometry data, cached interior facet
+  /// data and cached entity colourings as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"Form", sizeof(*this), {}};
+    std::size_t domains = 0;
+    for (auto& integrals : _integrals)
+    {
+      domains += common::capacity_bytes(integrals);
+      for (auto& itg : integrals)
+        domains += common::capacity_bytes(itg.entities);
+    }
+    for (auto& groups : _integral_groups)
+    {
+      domains += common::capacity_bytes(groups);
+      for (auto& g : groups)
+      {
+        domains += common::capacity_bytes(g.ids)
+                   + common::capacity_bytes(g.entities);
+      }
+    }
+    usage.add("integration domains", domains);
+
+    std::size_t entity_maps = 0;
+    for (auto& [mesh, map] : _entity_maps)
+      entity_maps += common::capacity_bytes(map);
+    for (auto& [key, e] : _mapped_entities)
+      entity_maps += common::capacity_bytes(e);
+    for (auto& [key, e] : _mapped_group_entities)
+      entity_maps += common::capacity_bytes(e);
+    usage.add("entity maps", entity_maps);
+
+    usage.add("packed constants", common::capacity_bytes(_packed_constants));
+
+    std::size_t geometry = 0;
+    for (auto& [id, x] : _geometry_cache)
+      geometry += common::capacity_bytes(x);
+    if (_x_compact)
+      geometry += _x_compact->x().size() * sizeof(float);
+    usage.add("geometry cache", geometry);
+
+    std::size_t facet_pairs = 0;
+    for (auto& [ids, data] : _facet_pair_cache)
+    {
+      facet_pairs += common::capacity_bytes(data.dofs[0])
+                     + common::capacity_bytes(data.dofs[1])
+                     + common::capacity_bytes(data.perms);
+    }
+    usage.add("facet pair cache", facet_pairs);
+
+    std::size_t colourings = 0;
+    for (auto& [key, colours] : _colouring_cache)
+    {
+      colourings += common::capacity_bytes(colours.array())
+                    + common::capacity_bytes(colours.offsets());
+    }
+    usage.add("colouring cache", colourings);
+    return usage;
+  }
+
 private:
+  // Map integration entities (with the layout of domain()) to the
+  // numbering of `mesh`, where `entity_map[e]` is the entity in `mesh`
+  // of entity `e` of the integration domain mesh
+  std::vector<std::int32_t>
+  map_entities(IntegralType type, std::span<const std::int32_t> entities,
+               const mesh::Mesh<geometry_type>& mesh,
+               std::span<const std::int32_t> entity_map) const
+  {
+    std::vector<std::int32_t> mapped_entities;
+    mapped_entities.reserve(entities.size());
+    switch (type)
+    {
+    case IntegralType::cell:
+    {
+      std::ranges::transform(entities, std::back_inserter(mapped_entities),
+                             [&entity_map](auto e) { return entity_map[e]; });
+      break;
+    }
+    case IntegralType::exterior_facet:
+    {
+      // Get the codimension of the mesh
+      const int tdim = _mesh->topology()->dim();
+      const int codim = tdim - mesh.topology()->dim();
+      assert(codim >= 0);
+      if (codim == 0)
+      {
+        for (std::size_t i = 0; i < entities.size(); i += 2)
+        {
+          // Add cell and the local facet index
+          mapped_entities.insert(mapped_entities.end(),
+                                 {entity_map[entities[i]], entities[i + 1]});
+        }
+      }
+      else if (codim == 1)
+      {
+        // In this case, the entity maps take facets in (`_mesh`) to
+        // cells in `mesh`, so we need to get the facet number from the
+        // (cell, local_facet pair) first.
+        if (!entities.empty())
+          _mesh->topology_mutable()->create_connectivity(tdim, tdim - 1);
+        auto c_to_f = _mesh->topology()->connectivity(tdim, tdim - 1);
+        for (std::size_t i = 0; i < entities.size(); i += 2)
+        {
+          // Get the facet index
+          assert(c_to_f);
+          const std::int32_t facet
+              = c_to_f->links(entities[i])[entities[i + 1]];
+          // Add cell and the local facet index
+          mapped_entities.insert(mapped_entities.end(),
+                                 {entity_map[facet], entities[i + 1]});
+        }
+      }
+      else
+        throw std::runtime_error("Codimension > 1 not supported.");
+
+      break;
+    }
+    case IntegralType::interior_facet:
+    {
+      for (std::size_t i = 0; i < entities.size(); i += 2)
+      {
+        // Add cell and the local facet index
+        mapped_entities.insert(mapped_entities.end(),
+                               {entity_map[entities[i]], entities[i + 1]});
+      }
+      break;
+    }
+    default:
+      throw std::runtime_error("Integral type not supported.");
+    }
+
+    return mapped_entities;
+  }
+
   // Function spaces (one for each argument)
   std::vector<std::shared_ptr<const FunctionSpace<geometry_type>>>
       _function_spaces;
@@ -490,6 +1076,10 @@ private:
   std::array<std::vector<integral_data<scalar_type, geometry_type>>, 4>
       _integrals;
 
+  // Groups of integrals that are assembled in one pass (see
+  // integral_groups)
+  std::array<std::vector<integral_group>, 4> _integral_groups;
+
   // Form coefficients
   std::vector<std::shared_ptr<const Function<scalar_type, geometry_type>>>
       _coefficients;
@@ -497,6 +1087,9 @@ private:
   // Constants associated with the Form
   std::vector<std::shared_ptr<const Constant<scalar_type>>> _constants;
 
+  // Storage for the packed constant values (see packed_constants)
+  mutable std::vector<scalar_type> _packed_constants;
+
   // The mesh
   std::shared_ptr<const mesh::Mesh<geometry_type>> _mesh;
 
@@ -507,5 +1100,50 @@ private:
   std::map<std::shared_ptr<const mesh::Mesh<geometry_type>>,
            std::vector<std::int32_t>>
       _entity_maps;
+
+  // Integration entities of each integral, numbered with respect to
+  // each mesh in the entity maps. Key is (mesh, integral type,
+  // integral ID).
+  std::map<std::tuple<const mesh::Mesh<geometry_type>*, IntegralType, int>,
+           std::vector<std::int32_t>>
+      _mapped_entities;
+
+  // Entities of each group with more than one integral, numbered with
+  // respect to each mesh in the entity maps. Key is (mesh, integral
+  // type, first integral ID of the group).
+  std::map<std::tuple<const mesh::Mesh<geometry_type>*, IntegralType, int>,
+           std::vector<std::int32_t>>
+      _mapped_group_entities;
+
+  // Maximum size (bytes) of the geometry cache. Zero if caching is
+  // disabled.
+  std::size_t _geometry_cache_max_bytes = 0;
+
+  // Geometry version that the cached data was computed for
+  mutable std::uint64_t _geometry_cache_version = 0;
+
+  // Packed cell coordinate dofs for cell integrals (integral ID ->
+  // data)
+  mutable std::map<int, std::vector<geometry_type>> _geometry_cache;
+
+  // True if assemblers use the compact geometry
+  bool _compact_geometry = false;
+
+  // Compact geometry (see compact_coordinates) and the geometry version
+  // that it was created for
+  mutable std::optional<mesh::CompactCoordinates<float>> _x_compact;
+  mutable std::uint64_t _x_compact_version = 0;
+
+  // True if interior facet data is cached (see facet_pairs)
+  bool _facet_pair_cache_enabled = false;
+
+  // Cached interior facet data (group integral IDs -> data)
+  mutable std::map<std::vector<int>, facet_pair_data> _facet_pair_cache;
+
+  // Colourings of the integration entities for threaded assembly
+  // ((integral type, integral ID) -> colouring)
+  mutable std::map<std::pair<IntegralType, int>,
+                   graph::AdjacencyList<std::int32_t>>
+      _colouring_cache;
 }; // namespace dolfinx::fem
 } // namespace dolfinx::fem
@@ -192,47 +192,30 @@ public:
         = fem::interpolation_coords<geometry_type>(
             *_function_space->element(), _function_space->mesh()->geometry(),
             cells);
-    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-        const geometry_type,
-        MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
-            std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>
-        _x(x.data(), 3, x.size() / 3);
-
-    const auto [fx, fshape] = f(_x);
-    assert(fshape.size() <= 2);
-    if (int vs = _function_space->value_size(); vs == 1 and fshape.size() == 1)
-    {
-      // Check for scalar-valued functions
-      if (fshape.front() != x.size() / 3)
-        throw std::runtime_error("Data returned by callable has wrong length");
-    }
-    else
-    {
-      // Check for vector/tensor value
-      if (fshape.size() != 2)
-        throw std::runtime_error("Expected 2D array of data");
-
-      if (fshape[0] != vs)
-      {
-        throw std::runtime_error(
-            "Data returned by callable has wrong shape(0) size");
-      }
-
-      if (fshape[1] != x.size() / 3)
-      {
-        throw std::runtime_error(
-            "Data returned by callable has wrong shape(1) size");
-      }
-    }
-
-    std::array<std::size_t, 2> _fshape;
-    if (fshape.size() == 1)
-      _fshape = {1, fshape[0]};
-    else
-      _fshape = {fshape[0], fshape[1]};
+    const auto [fx, fshape] = evaluate(f, x);
+    fem::interpolate(*this, std::span<const value_type>(fx.data(), fx.size()),
+                     fshape, cells);
+  }
 
+  /// @brief Interpolate an expression f(x) using cached interpolation
+  /// operators.
+  /// @param[in] f Expression function to be interpolated.
+  /// @param[in] interpolator Interpolator for the function space of
+  /// `this`. The expression is evaluated at the interpolation points
+  /// stored by the interpolator.
+  void interpolate(
+      const std::function<
+          std::pair<std::vector<value_type>, std::vector<std::size_t>>(
+              MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+                  const geometry_type,
+                  MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+                      std::size_t, 3,
+                      MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>)>& f,
+      const Interpolator<geometry_type>& interpolator)
+  {
+    const auto [fx, fshape] = evaluate(f, interpolator.points());
     fem::interpolate(*this, std::span<const value_type>(fx.data(), fx.size()),
-                     _fshape, cells);
+                     fshape, interpolator);
   }
 
   /// @brief Interpolate a Function over all cells.
@@ -427,6 +410,45 @@ public:
     fem::interpolate(*this, v, cells, interpolation_data);
   }
 
+  /// @brief Interpolate a Function defined on a different mesh using a
+  /// plan.
+  ///
+  /// @param[in] v Function to be interpolated.
+  /// @param[in] cells Cells in the mesh associated with `this` to
+  /// interpolate into.
+  /// @param[in] plan Interpolation plan for the function space of `v`.
+  void interpolate(const Function<value_type, geometry_type>& v,
+                   std::span<const std::int32_t> cells,
+                   const NonmatchingInterpolationPlan<geometry_type>& plan)
+  {
+    fem::interpolate(*this, v, cells, plan);
+  }
+
+  /// @brief Evaluate the Function at points using an evaluation plan.
+  ///
+  /// @param[in] plan Evaluation plan for the function space of `this`.
+  /// @param[out] u Values at the points of the plan (shape=(num_points,
+  /// value_size)).
+  /// @param[in] num_threads Number of threads to use.
+  void eval(const EvaluationPlan<geometry_type>& plan,
+            std::span<value_type> u, int num_threads = 1) const
+  {
+    plan.eval(*this, u, num_threads);
+  }
+
+  /// @brief Evaluate the Function at points on any process using an
+  /// evaluation plan.
+  /// @note Collective.
+  /// @param[in] plan Evaluation plan for the function space of `this`.
+  /// @param[out] u Values at the points passed to the plan by this
+  /// process (shape=(num_points, value_size)).
+  /// @param[in] num_threads Number of threads to use.
+  void eval(const DistributedEvaluationPlan<geometry_type>& plan,
+            std::span<value_type> u, int num_threads = 1) const
+  {
+    plan.eval(*this, u, num_threads);
+  }
+
   /// @brief Evaluate the Function at points.
   ///
   /// @param[in] x The coordinates of the points. It has shape
@@ -535,16 +557,6 @@ public:
         phi0, std::pair(1, tdim + 1), 0,
         MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
 
-    // Data structure for evaluating geometry basis at specific points.
-    // Used in non-affine case.
-    std::array<std::size_t, 4> phi_shape = cmap.tabulate_shape(1, 1);
-    std::vector<geometry_type> phi_b(
-        std::reduce(phi_shape.begin(), phi_shape.end(), 1, std::multiplies{}));
-    impl::mdspan_t<const geometry_type, 4> phi(phi_b.data(), phi_shape);
-    auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        phi, std::pair(1, tdim + 1), 0,
-        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
-
     // Reference coordinates for each point
     std::vector<geometry_type> Xb(xshape[0] * tdim);
     impl::mdspan_t<geometry_type, 2> X(Xb.data(), xshape[0], tdim);
@@ -558,45 +570,45 @@ public:
     std::vector<geometry_type> det_scratch(2 * gdim * tdim);
 
     // Prepare geometry data in each cell
-    for (std::size_t p = 0; p < cells.size(); ++p)
+    if (cmap.is_affine())
     {
-      const int cell_index = cells[p];
+      for (std::size_t p = 0; p < cells.size(); ++p)
+      {
+        const int cell_index = cells[p];
 
-      // Skip negative cell indices
-      if (cell_index < 0)
-        continue;
+        // Skip negative cell indices
+        if (cell_index < 0)
+          continue;
+
+        // Get cell geometry (coordinate dofs)
+        auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            x_dofmap, cell_index, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        assert(x_dofs.size() == num_dofs_g);
+        for (std::size_t i = 0; i < num_dofs_g; ++i)
+        {
+          const int pos = 3 * x_dofs[i];
+          for (std::size_t j = 0; j < gdim; ++j)
+            coord_dofs(i, j) = x_g[pos + j];
+        }
 
-      // Get cell geometry (coordinate dofs)
-      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          x_dofmap, cell_index, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      assert(x_dofs.size() == num_dofs_g);
-      for (std::size_t i = 0; i < num_dofs_g; ++i)
-      {
-        const int pos = 3 * x_dofs[i];
         for (std::size_t j = 0; j < gdim; ++j)
-          coord_dofs(i, j) = x_g[pos + j];
-      }
+          xp(0, j) = x[p * xshape[1] + j];
 
-      for (std::size_t j = 0; j < gdim; ++j)
-        xp(0, j) = x[p * xshape[1] + j];
-
-      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-
-      std::array<geometry_type, 3> Xpb = {0, 0, 0};
-      MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-          geometry_type,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
-              std::size_t, 1, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>
-          Xp(Xpb.data(), 1, tdim);
-
-      // Compute reference coordinates X, and J, detJ and K
-      if (cmap.is_affine())
-      {
+        auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        std::array<geometry_type, 3> Xpb = {0, 0, 0};
+        MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+            geometry_type,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+                std::size_t, 1,
+                MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>
+            Xp(Xpb.data(), 1, tdim);
+
+        // Compute reference coordinates X, and J, detJ and K
         CoordinateElement<geometry_type>::compute_jacobian(dphi0, coord_dofs,
                                                            _J);
         CoordinateElement<geometry_type>::compute_jacobian_inverse(_J, _K);
@@ -607,22 +619,81 @@ public:
         detJ[p]
             = CoordinateElement<geometry_type>::compute_jacobian_determinant(
                 _J, det_scratch);
+
+        for (std::size_t j = 0; j < X.extent(1); ++j)
+          X(p, j) = Xpb[j];
       }
-      else
+    }
+    else
+    {
+      // Pull back all points together, and tabulate the geometry basis
+      // at all points at once to compute J, detJ and K
+      std::vector<std::int32_t> points;
+      for (std::size_t p = 0; p < cells.size(); ++p)
+        if (cells[p] >= 0)
+          points.push_back(p);
+      const std::size_t num_points = points.size();
+
+      std::vector<geometry_type> cdofs_b(num_points * num_dofs_g * gdim);
+      impl::mdspan_t<geometry_type, 3> cdofs(cdofs_b.data(), num_points,
+                                             num_dofs_g, gdim);
+      std::vector<geometry_type> xb(num_points * gdim);
+      for (std::size_t a = 0; a < num_points; ++a)
       {
-        // Pull-back physical point xp to reference coordinate Xp
-        cmap.pull_back_nonaffine(Xp, xp, coord_dofs);
-        cmap.tabulate(1, std::span(Xpb.data(), tdim), {1, tdim}, phi_b);
-        CoordinateElement<geometry_type>::compute_jacobian(dphi, coord_dofs,
-                                                           _J);
+        auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            x_dofmap, cells[points[a]],
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        assert(x_dofs.size() == num_dofs_g);
+        for (std::size_t i = 0; i < num_dofs_g; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            cdofs(a, i, j) = x_g[3 * x_dofs[i] + j];
+        for (std::size_t j = 0; j < gdim; ++j)
+          xb[a * gdim + j] = x[points[a] * xshape[1] + j];
+      }
+
+      std::vector<geometry_type> Xpb(num_points * tdim);
+      std::vector<std::uint8_t> converged(num_points);
+      cmap.pull_back_nonaffine(
+          impl::mdspan_t<geometry_type, 2>(Xpb.data(), num_points, tdim),
+          impl::mdspan_t<const geometry_type, 2>(xb.data(), num_points, gdim),
+          impl::mdspan_t<const geometry_type, 3>(cdofs_b.data(), num_points,
+                                                 num_dofs_g, gdim),
+          converged);
+      if (std::ranges::find(converged, 0) != converged.end())
+      {
+        throw std::runtime_error(
+            "Newton method failed to converge for non-affine geometry");
+      }
+
+      std::array<std::size_t, 4> phi_shape
+          = cmap.tabulate_shape(1, num_points);
+      std::vector<geometry_type> phi_b(std::reduce(
+          phi_shape.begin(), phi_shape.end(), 1, std::multiplies{}));
+      impl::mdspan_t<const geometry_type, 4> phi(phi_b.data(), phi_shape);
+      cmap.tabulate(1, Xpb, {num_points, tdim}, phi_b, false);
+      for (std::size_t a = 0; a < num_points; ++a)
+      {
+        const std::int32_t p = points[a];
+        auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            phi, std::pair(1, tdim + 1), a,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+        auto _cdofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            cdofs, a, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        CoordinateElement<geometry_type>::compute_jacobian(dphi, _cdofs, _J);
         CoordinateElement<geometry_type>::compute_jacobian_inverse(_J, _K);
         detJ[p]
             = CoordinateElement<geometry_type>::compute_jacobian_determinant(
                 _J, det_scratch);
+        for (std::size_t j = 0; j < tdim; ++j)
+          X(p, j) = Xpb[a * tdim + j];
       }
-
-      for (std::size_t j = 0; j < X.extent(1); ++j)
-        X(p, j) = Xpb[j];
     }
 
     // Prepare basis function data structures
@@ -637,7 +708,7 @@ public:
 
     // Compute basis on reference element
     element->tabulate(basis_derivatives_reference_values_b, Xb,
-                      {X.extent(0), X.extent(1)}, 0);
+                      {X.extent(0), X.extent(1)}, 0, false);
 
     using xu_t = impl::mdspan_t<geometry_type, 2>;
     using xU_t = impl::mdspan_t<const geometry_type, 2>;
@@ -747,6 +818,61 @@ public:
   std::string name = "u";
 
 private:
+  // Evaluate an expression f(x) at points x (shape=(3, num_points)) and
+  // check the shape of the returned data, which is returned with its
+  // shape as (value_size, num_points)
+  std::pair<std::vector<value_type>, std::array<std::size_t, 2>> evaluate(
+      const std::function<
+          std::pair<std::vector<value_type>, std::vector<std::size_t>>(
+              MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+                  const geometry_type,
+                  MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+                      std::size_t, 3,
+                      MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>)>& f,
+      std::span<const geometry_type> x) const
+  {
+    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const geometry_type,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+            std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>
+        _x(x.data(), 3, x.size() / 3);
+
+    auto [fx, fshape] = f(_x);
+    assert(fshape.size() <= 2);
+    if (int vs = _function_space->value_size(); vs == 1 and fshape.size() == 1)
+    {
+      // Check for scalar-valued functions
+      if (fshape.front() != x.size() / 3)
+        throw std::runtime_error("Data returned by callable has wrong length");
+    }
+    else
+    {
+      // Check for vector/tensor value
+      if (fshape.size() != 2)
+        throw std::runtime_error("Expected 2D array of data");
+
+      if (fshape[0] != vs)
+      {
+        throw std::runtime_error(
+            "Data returned by callable has wrong shape(0) size");
+      }
+
+      if (fshape[1] != x.size() / 3)
+      {
+        throw std::runtime_error(
+            "Data returned by callable has wrong shape(1) size");
+      }
+    }
+
+    std::array<std::size_t, 2> _fshape;
+    if (fshape.size() == 1)
+      _fshape = {1, fshape[0]};
+    else
+      _fshape = {fshape[0], fshape[1]};
+
+    return {std::move(fx), _fshape};
+  }
+
   // Function space
   std::shared_ptr<const FunctionSpace<geometry_type>> _function_space;
 
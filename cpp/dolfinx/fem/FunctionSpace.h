@@ -9,6 +9,7 @@
 #include "CoordinateElement.h"
 #include "DofMap.h"
 #include "FiniteElement.h"
+#include <algorithm>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <concepts>
@@ -20,6 +21,10 @@
 #include <dolfinx/mesh/Topology.h>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::fem
@@ -47,7 +52,8 @@ public:
                 std::vector<std::size_t> value_shape)
       : _mesh(mesh), _element(element), _dofmap(dofmap),
         _id(boost::uuids::random_generator()()), _root_space_id(_id),
-        _value_shape(value_shape)
+        _value_shape(value_shape),
+        _collapse_cache(std::make_shared<CollapseCache>())
   {
     // Do nothing
   }
@@ -98,8 +104,10 @@ public:
                                                 _mesh->topology()->dim(),
                                                 _mesh->geometry().dim()));
 
-    // Set root space id and component w.r.t. root
+    // Set root space id and component w.r.t. root, and share the
+    // collapsed dofmaps of the root space
     sub_space._root_space_id = _root_space_id;
+    sub_space._collapse_cache = _collapse_cache;
     sub_space._component = _component;
     sub_space._component.insert(sub_space._component.end(), component.begin(),
                                 component.end());
@@ -143,23 +151,40 @@ public:
 
   /// Collapse a subspace and return a new function space and a map from
   /// new to old dofs
+  ///
+  /// The collapsed dofmap and the map are computed once for each
+  /// component of a root space and are shared by all subspaces of the
+  /// root space with that component, e.g. `V.sub({0}).collapse()`
+  /// returns spaces with the same dofmap each time it is called.
+  ///
   /// @return The new function space and a map from new to old dofs
   std::pair<FunctionSpace, std::vector<std::int32_t>> collapse() const
   {
     if (_component.empty())
       throw std::runtime_error("Function space is not a subspace");
 
-    // Create collapsed DofMap
-    auto [_collapsed_dofmap, collapsed_dofs]
-        = _dofmap->collapse(_mesh->comm(), *_mesh->topology());
-    auto collapsed_dofmap
-        = std::make_shared<DofMap>(std::move(_collapsed_dofmap));
+    assert(_collapse_cache);
+    std::scoped_lock lock(_collapse_cache->mutex);
+    auto it = _collapse_cache->entries.find(_component);
+    if (it == _collapse_cache->entries.end())
+    {
+      // Create collapsed DofMap
+      auto [_collapsed_dofmap, collapsed_dofs]
+          = _dofmap->collapse(_mesh->comm(), *_mesh->topology());
+      auto collapsed_dofmap
+          = std::make_shared<const DofMap>(std::move(_collapsed_dofmap));
+      it = _collapse_cache->entries
+               .emplace(_component, std::pair(std::move(collapsed_dofmap),
+                                              std::move(collapsed_dofs)))
+               .first;
+    }
 
+    auto& [collapsed_dofmap, collapsed_dofs] = it->second;
     return {
         FunctionSpace(_mesh, _element, collapsed_dofmap,
                       compute_value_shape(_element, _mesh->topology()->dim(),
                                           _mesh->geometry().dim())),
-        std::move(collapsed_dofs)};
+        collapsed_dofs};
   }
 
   /// @brief Get the component with respect to the root superspace.
@@ -188,6 +213,138 @@ public:
   /// if `transpose` is false, and otherwise the returned data is
   /// transposed. Storage is row-major.
   std::vector<geometry_type> tabulate_dof_coordinates(bool transpose) const
+  {
+    // Get dofmap local size
+    assert(_dofmap);
+    std::shared_ptr<const common::IndexMap> index_map = _dofmap->index_map;
+    assert(index_map);
+    const int index_map_bs = _dofmap->index_map_bs();
+    const int dofmap_bs = _dofmap->bs();
+    const std::int32_t num_dofs
+        = index_map_bs * (index_map->size_local() + index_map->num_ghosts())
+          / dofmap_bs;
+
+    assert(_mesh);
+    auto map = _mesh->topology()->index_map(_mesh->topology()->dim());
+    assert(map);
+    std::vector<std::int32_t> cells(map->size_local() + map->num_ghosts());
+    std::iota(cells.begin(), cells.end(), 0);
+
+    // Array to hold coordinates to return
+    const std::size_t shape_c0 = transpose ? 3 : num_dofs;
+    const std::size_t shape_c1 = transpose ? num_dofs : 3;
+    std::vector<geometry_type> coords(shape_c0 * shape_c1, 0);
+
+    // Copy dof coordinates into vector
+    const std::size_t gdim = _mesh->geometry().dim();
+    tabulate_cell_dof_coordinates(
+        cells,
+        [&](std::span<const std::int32_t> dofs, auto x)
+        {
+          if (!transpose)
+          {
+            for (std::size_t i = 0; i < dofs.size(); ++i)
+              for (std::size_t j = 0; j < gdim; ++j)
+                coords[dofs[i] * 3 + j] = x(i, j);
+          }
+          else
+          {
+            for (std::size_t i = 0; i < dofs.size(); ++i)
+              for (std::size_t j = 0; j < gdim; ++j)
+                coords[j * num_dofs + dofs[i]] = x(i, j);
+          }
+        });
+
+    return coords;
+  }
+
+  /// @brief Tabulate the physical coordinates of the dofs of a subset
+  /// of cells.
+  ///
+  /// Computing the coordinates of only the dofs of some cells, e.g.
+  /// the cells attached to boundary facets, is much cheaper than
+  /// tabulating the coordinates of all dofs.
+  ///
+  /// @param[in] cells Cell indices (local to process).
+  /// @return Dof (block) indices in the dofmap of the cells, sorted and
+  /// without duplicates, and the coordinates of the dofs with shape
+  /// `(3, num_dofs)`. Storage is row-major.
+  std::pair<std::vector<std::int32_t>, std::vector<geometry_type>>
+  tabulate_dof_coordinates(std::span<const std::int32_t> cells) const
+  {
+    // Collect the dofs of the cells
+    assert(_dofmap);
+    std::vector<std::int32_t> dofs;
+    dofs.reserve(cells.size() * _dofmap->map().extent(1));
+    for (std::int32_t c : cells)
+    {
+      auto cell_dofs = _dofmap->cell_dofs(c);
+      dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+    }
+    std::ranges::sort(dofs);
+    auto [unique_end, range_end] = std::ranges::unique(dofs);
+    dofs.erase(unique_end, range_end);
+
+    // Copy dof coordinates into vector, at the position of the dof in
+    // the dof list
+    const std::size_t num_dofs = dofs.size();
+    std::vector<geometry_type> coords(3 * num_dofs, 0);
+    const std::size_t gdim = _mesh->geometry().dim();
+    tabulate_cell_dof_coordinates(
+        cells,
+        [&](std::span<const std::int32_t> cell_dofs, auto x)
+        {
+          for (std::size_t i = 0; i < cell_dofs.size(); ++i)
+          {
+            auto it = std::ranges::lower_bound(dofs, cell_dofs[i]);
+            std::size_t pos = std::distance(dofs.begin(), it);
+            for (std::size_t j = 0; j < gdim; ++j)
+              coords[j * num_dofs + pos] = x(i, j);
+          }
+        });
+
+    return {std::move(dofs), std::move(coords)};
+  }
+
+  /// The mesh
+  std::shared_ptr<const mesh::Mesh<geometry_type>> mesh() const
+  {
+    return _mesh;
+  }
+
+  /// The finite element
+  std::shared_ptr<const FiniteElement<geometry_type>> element() const
+  {
+    return _element;
+  }
+
+  /// The dofmap
+  std::shared_ptr<const DofMap> dofmap() const { return _dofmap; }
+
+  /// The shape of the value space
+  std::span<const std::size_t> value_shape() const noexcept
+  {
+    return _value_shape;
+  }
+
+  /// The value size, e.g. 1 for a scalar-valued function, 2 for a 2D vector, 9
+  /// for a second-order tensor in 3D.
+  /// @note The return value of this function is equivalent to
+  /// `std::accumulate(value_shape().begin(), value_shape().end(), 1,
+  /// std::multiplies{})`.
+  int value_size() const
+  {
+    return std::accumulate(_value_shape.begin(), _value_shape.end(), 1,
+                           std::multiplies{});
+  }
+
+private:
+  // Tabulate the physical coordinates of the dofs of `cells`. For each
+  // cell, `set_coordinates(dofs, x)` is called with the cell dofs and
+  // the coordinates `x` of the dofs, which has shape (num_dofs, gdim).
+  template <typename F>
+  void tabulate_cell_dof_coordinates(std::span<const std::int32_t> cells,
+                                     F&& set_coordinates) const
   {
     if (!_component.empty())
     {
@@ -206,21 +363,10 @@ public:
     assert(_mesh);
     assert(_element);
     const std::size_t gdim = _mesh->geometry().dim();
-    const int tdim = _mesh->topology()->dim();
-
-    // Get dofmap local size
-    assert(_dofmap);
-    std::shared_ptr<const common::IndexMap> index_map = _dofmap->index_map;
-    assert(index_map);
-    const int index_map_bs = _dofmap->index_map_bs();
-    const int dofmap_bs = _dofmap->bs();
 
     const int element_block_size = _element->block_size();
     const std::size_t scalar_dofs
         = _element->space_dimension() / element_block_size;
-    const std::int32_t num_dofs
-        = index_map_bs * (index_map->size_local() + index_map->num_ghosts())
-          / dofmap_bs;
 
     // Get the dof coordinates on the reference element
     if (!_element->interpolation_ident())
@@ -238,11 +384,6 @@ public:
     const std::size_t num_dofs_g = cmap.dim();
     std::span<const geometry_type> x_g = _mesh->geometry().x();
 
-    // Array to hold coordinates to return
-    const std::size_t shape_c0 = transpose ? 3 : num_dofs;
-    const std::size_t shape_c1 = transpose ? num_dofs : 3;
-    std::vector<geometry_type> coords(shape_c0 * shape_c1, 0);
-
     using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
         geometry_type,
         MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
@@ -257,10 +398,6 @@ public:
     std::vector<geometry_type> coordinate_dofs_b(num_dofs_g * gdim);
     mdspan2_t coordinate_dofs(coordinate_dofs_b.data(), num_dofs_g, gdim);
 
-    auto map = _mesh->topology()->index_map(tdim);
-    assert(map);
-    const int num_cells = map->size_local() + map->num_ghosts();
-
     std::span<const std::uint32_t> cell_info;
     if (_element->needs_dof_transformations())
     {
@@ -284,7 +421,7 @@ public:
         = _element->template dof_transformation_fn<geometry_type>(
             doftransform::standard);
 
-    for (int c = 0; c < num_cells; ++c)
+    for (std::int32_t c : cells)
     {
       // Extract cell geometry 'dofs'
       auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
@@ -298,60 +435,11 @@ public:
       apply_dof_transformation(
           x_b, std::span(cell_info.data(), cell_info.size()), c, x.extent(1));
 
-      // Get cell dofmap
-      auto dofs = _dofmap->cell_dofs(c);
-
-      // Copy dof coordinates into vector
-      if (!transpose)
-      {
-        for (std::size_t i = 0; i < dofs.size(); ++i)
-          for (std::size_t j = 0; j < gdim; ++j)
-            coords[dofs[i] * 3 + j] = x(i, j);
-      }
-      else
-      {
-        for (std::size_t i = 0; i < dofs.size(); ++i)
-          for (std::size_t j = 0; j < gdim; ++j)
-            coords[j * num_dofs + dofs[i]] = x(i, j);
-      }
+      // Pass cell dofs and coordinates to the caller
+      set_coordinates(_dofmap->cell_dofs(c), x);
     }
-
-    return coords;
-  }
-
-  /// The mesh
-  std::shared_ptr<const mesh::Mesh<geometry_type>> mesh() const
-  {
-    return _mesh;
   }
 
-  /// The finite element
-  std::shared_ptr<const FiniteElement<geometry_type>> element() const
-  {
-    return _element;
-  }
-
-  /// The dofmap
-  std::shared_ptr<const DofMap> dofmap() const { return _dofmap; }
-
-  /// The shape of the value space
-  std::span<const std::size_t> value_shape() const noexcept
-  {
-    return _value_shape;
-  }
-
-  /// The value size, e.g. 1 for a scalar-valued function, 2 for a 2D vector, 9
-  /// for a second-order tensor in 3D.
-  /// @note The return value of this function is equivalent to
-  /// `std::accumulate(value_shape().begin(), value_shape().end(), 1,
-  /// std::multiplies{})`.
-  int value_size() const
-  {
-    return std::accumulate(_value_shape.begin(), _value_shape.end(), 1,
-                           std::multiplies{});
-  }
-
-private:
   // The mesh
   std::shared_ptr<const mesh::Mesh<geometry_type>> _mesh;
 
@@ -369,6 +457,20 @@ private:
   boost::uuids::uuid _root_space_id;
 
   std::vector<std::size_t> _value_shape;
+
+  // Collapsed dofmaps of the subspaces of a root space, and the maps
+  // from collapsed to original dofs, keyed by the component w.r.t. the
+  // root space
+  struct CollapseCache
+  {
+    std::mutex mutex;
+    std::map<std::vector<int>, std::pair<std::shared_ptr<const DofMap>,
+                                         std::vector<std::int32_t>>>
+        entries;
+  };
+
+  // Cache shared by a root space and its subspaces
+  std::shared_ptr<CollapseCache> _collapse_cache;
 };
 
 /// Extract FunctionSpaces for (0) rows blocks and (1) columns blocks
@@ -0,0 +1,369 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "FiniteElement.h"
+#include "FunctionSpace.h"
+#include "interpolate.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+/// @brief Matrix-free interpolation between two finite element spaces
+/// on the same mesh, e.g. for the prolongation and restriction of
+/// p-multigrid.
+///
+/// The interpolation from a space \f$V_0\f$ into a space \f$V_1\f$ on
+/// the same mesh is the operator \f$A\f$ with \f$u_1 = A u_0\f$ (see
+/// interpolation_matrix). When the elements have the same map, the
+/// cell matrices of \f$A\f$ are the reference interpolation matrix
+/// (FiniteElement::create_interpolation_operator) up to the dof
+/// transformations of the cell. The reference matrix is computed once,
+/// and apply() and apply_transpose() apply it to batches of cells
+/// without building the global matrix.
+///
+/// When the elements have different maps, e.g. for the interpolation
+/// of an N1curl or Raviart-Thomas function into a vector-valued
+/// discontinuous Lagrange space for output, the cell matrices depend
+/// on the geometry of the cell through the push-forward and pull-back
+/// of the maps. They are computed for all cells when the operator is
+/// created (see impl::nonmatching_maps_matrices) and stored, so that
+/// apply() is a small matrix-vector product per cell. The matrices are
+/// recomputed when the mesh geometry has changed since they were
+/// computed (see mesh::Geometry::x_version).
+///
+/// The transpose, e.g. the restriction of a residual from a fine to a
+/// coarse space, is applied as the sum of the transposed cell
+/// matrices, with the values of the degrees-of-freedom of \f$V_1\f$
+/// divided by the number of cells that share them so that each entry of
+/// \f$A\f$ is counted once. This requires \f$V_0\f$ to be conforming,
+/// i.e. a basis function of \f$V_0\f$ that is non-zero at an
+/// interpolation point of \f$V_1\f$ belongs to all cells that share
+/// the point.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class InterpolationOperator
+{
+public:
+  /// @brief Create the interpolation operator.
+  /// @note Collective.
+  /// @param[in] V0 The space to interpolate from.
+  /// @param[in] V1 The space to interpolate to. It must be on the same
+  /// mesh as `V0`.
+  InterpolationOperator(std::shared_ptr<const FunctionSpace<U>> V0,
+                        std::shared_ptr<const FunctionSpace<U>> V1)
+      : _V0(V0), _V1(V1)
+  {
+    auto mesh = V0->mesh();
+    assert(mesh);
+    if (mesh != V1->mesh())
+      throw std::runtime_error("Function spaces must have the same mesh.");
+
+    std::shared_ptr<const FiniteElement<U>> e0 = V0->element();
+    std::shared_ptr<const FiniteElement<U>> e1 = V1->element();
+    assert(e0);
+    assert(e1);
+    if (e0->is_mixed() or e1->is_mixed())
+      throw std::runtime_error("Mixed elements are not supported.");
+
+    const int tdim = mesh->topology()->dim();
+    _num_cells = mesh->topology()->index_map(tdim)->size_local();
+    if (e0->map_type() != e1->map_type())
+    {
+      // Cell matrices, computed in for_each_batch
+      _shape = {static_cast<std::size_t>(e1->space_dimension()),
+                static_cast<std::size_t>(e0->space_dimension())};
+      _nonmatching = true;
+    }
+    else
+    {
+      // Reference interpolation matrix (num_dofs1, num_dofs0), with the
+      // block size unrolled
+      auto [A, shape] = e1->create_interpolation_operator(*e0);
+      _A.assign(A.begin(), A.end());
+      _shape = shape;
+    }
+
+    if (!_nonmatching
+        and (e0->needs_dof_transformations()
+             or e1->needs_dof_transformations()))
+    {
+      mesh->topology_mutable()->create_entity_permutations();
+      _cell_info = std::span(mesh->topology()->get_cell_permutation_info());
+      _transform0 = e0->template dof_transformation_right_fn<T>(
+          doftransform::transpose);
+      _transform1 = e1->template dof_transformation_fn<T>(
+          doftransform::inverse_transpose);
+    }
+
+    // Weights of the dofs of V1, as the inverse of the number of
+    // (owned) cells that share the dof
+    std::shared_ptr<const DofMap> dofmap1 = V1->dofmap();
+    const int bs1 = dofmap1->bs();
+    la::Vector<T> m(dofmap1->index_map, bs1);
+    std::span<T> _m = m.mutable_array();
+    for (std::int32_t c = 0; c < _num_cells; ++c)
+      for (std::int32_t dof : dofmap1->cell_dofs(c))
+        for (int k = 0; k < bs1; ++k)
+          _m[bs1 * dof + k] += 1;
+    m.scatter_rev(std::plus<T>());
+    m.scatter_fwd();
+    _weights.resize(_m.size());
+    std::ranges::transform(m.array(), _weights.begin(),
+                           [](auto x) { return x > 0 ? T(1) / x : T(0); });
+  }
+
+  /// @brief Interpolate, \f$u_1 = A u_0\f$.
+  ///
+  /// The owned and ghost entries of `u1` are set.
+  ///
+  /// @note Collective.
+  /// @param[in] u0 Degrees-of-freedom in `V0`. The ghost entries must
+  /// be up to date.
+  /// @param[in,out] u1 Degrees-of-freedom in `V1`.
+  void apply(const la::Vector<T>& u0, la::Vector<T>& u1) const
+  {
+    std::span<const T> x0 = u0.array();
+    std::span<T> x1 = u1.mutable_array();
+    for_each_batch(
+        [&](std::int32_t c0, std::span<const std::int32_t> dofs0,
+            std::span<const std::int32_t> dofs1, std::size_t n)
+        {
+          // Gather batch values U0 (n, num_dofs0)
+          const auto [N1, N0] = _shape;
+          gather(x0, dofs0, _V0->dofmap()->bs(), n, N0, _X0);
+
+          // U1 = U0 A^T
+          for (std::size_t b = 0; b < n; ++b)
+          {
+            std::span<const T> A = cell_matrix(c0, b);
+            const T* u = _X0.data() + b * N0;
+            T* v = _X1.data() + b * N1;
+            for (std::size_t i = 0; i < N1; ++i)
+            {
+              T s = 0;
+              for (std::size_t j = 0; j < N0; ++j)
+                s += A[i * N0 + j] * u[j];
+              v[i] = s;
+            }
+          }
+
+          // Set values. Values of shared dofs are the same in all
+          // cells.
+          const int bs1 = _V1->dofmap()->bs();
+          for (std::size_t b = 0; b < n; ++b)
+          {
+            const std::int32_t* dofs = dofs1.data() + b * (N1 / bs1);
+            for (std::size_t i = 0; i < N1 / bs1; ++i)
+              for (int k = 0; k < bs1; ++k)
+                x1[bs1 * dofs[i] + k] = _X1[b * N1 + i * bs1 + k];
+          }
+        });
+    u1.scatter_fwd();
+  }
+
+  /// @brief Apply the transpose, \f$r_0 = A^{T} r_1\f$.
+  ///
+  /// The owned entries of `r0` are computed. The ghost entries are not
+  /// updated.
+  ///
+  /// @note Collective.
+  /// @param[in] r1 Vector on `V1`. The ghost entries must be up to
+  /// date.
+  /// @param[in,out] r0 Vector on `V0`.
+  void apply_transpose(const la::Vector<T>& r1, la::Vector<T>& r0) const
+  {
+    std::span<const T> x1 = r1.array();
+    std::span<T> x0 = r0.mutable_array();
+    std::ranges::fill(x0, T(0));
+    for_each_batch(
+        [&](std::int32_t c0, std::span<const std::int32_t> dofs0,
+            std::span<const std::int32_t> dofs1, std::size_t n)
+        {
+          // Gather weighted batch values R1 (n, num_dofs1)
+          const auto [N1, N0] = _shape;
+          const int bs1 = _V1->dofmap()->bs();
+          gather(x1, dofs1, bs1, n, N1, _X1);
+          for (std::size_t b = 0; b < n; ++b)
+          {
+            const std::int32_t* dofs = dofs1.data() + b * (N1 / bs1);
+            for (std::size_t i = 0; i < N1 / bs1; ++i)
+              for (int k = 0; k < bs1; ++k)
+                _X1[b * N1 + i * bs1 + k] *= _weights[bs1 * dofs[i] + k];
+          }
+
+          // R0 = R1 A
+          std::ranges::fill(_X0, T(0));
+          for (std::size_t b = 0; b < n; ++b)
+          {
+            std::span<const T> A = cell_matrix(c0, b);
+            const T* r = _X1.data() + b * N1;
+            T* v = _X0.data() + b * N0;
+            for (std::size_t i = 0; i < N1; ++i)
+              for (std::size_t j = 0; j < N0; ++j)
+                v[j] += r[i] * A[i * N0 + j];
+          }
+
+          // Add values
+          const int bs0 = _V0->dofmap()->bs();
+          for (std::size_t b = 0; b < n; ++b)
+          {
+            const std::int32_t* dofs = dofs0.data() + b * (N0 / bs0);
+            for (std::size_t i = 0; i < N0 / bs0; ++i)
+              for (int k = 0; k < bs0; ++k)
+                x0[bs0 * dofs[i] + k] += _X0[b * N0 + i * bs0 + k];
+          }
+        });
+    r0.scatter_rev(std::plus<T>());
+  }
+
+  /// @brief The reference interpolation matrix.
+  /// @return The matrix (row-major) and its shape `(num_dofs1,
+  /// num_dofs0)`, with the block sizes unrolled. The matrix is empty
+  /// if the elements have different maps.
+  std::pair<std::span<const T>, std::array<std::size_t, 2>> matrix() const
+  {
+    return {_A, _shape};
+  }
+
+  /// @brief Check if the cell matrices depend on the cell geometry,
+  /// i.e. if the elements have different maps.
+  bool nonmatching_maps() const { return _nonmatching; }
+
+private:
+  // Number of cells in a batch
+  static constexpr std::size_t _batch_size = 32;
+
+  // Apply f(c0, dofs0, dofs1, n) to batches of n owned cells starting
+  // at cell c0, with the cell dofs of the batch listed contiguously.
+  // The cell matrices of the batch are available through cell_matrix.
+  template <typename F>
+  void for_each_batch(F&& f) const
+  {
+    const auto [N1, N0] = _shape;
+    const DofMap& dofmap0 = *_V0->dofmap();
+    const DofMap& dofmap1 = *_V1->dofmap();
+    const std::size_t n0 = dofmap0.map().extent(1);
+    const std::size_t n1 = dofmap1.map().extent(1);
+    _X0.resize(_batch_size * N0);
+    _X1.resize(_batch_size * N1);
+    if (!_cell_info.empty())
+      _Ac.resize(_batch_size * _A.size());
+    if (_nonmatching)
+      update_cell_matrices();
+
+    for (std::int32_t c0 = 0; c0 < _num_cells; c0 += _batch_size)
+    {
+      const std::size_t n
+          = std::min<std::size_t>(_batch_size, _num_cells - c0);
+      if (!_cell_info.empty())
+      {
+        // Transformed cell matrices T1^{-t} A T0^{t}
+        for (std::size_t b = 0; b < n; ++b)
+        {
+          std::span Ac(_Ac.data() + b * _A.size(), _A.size());
+          std::ranges::copy(_A, Ac.begin());
+          _transform0(Ac, _cell_info, c0 + b, N1);
+          _transform1(Ac, _cell_info, c0 + b, N0);
+        }
+      }
+
+      f(c0, std::span(dofmap0.map().data_handle() + c0 * n0, n * n0),
+        std::span(dofmap1.map().data_handle() + c0 * n1, n * n1), n);
+    }
+  }
+
+  // Matrix of cell b of the current batch, starting at cell c0
+  std::span<const T> cell_matrix(std::int32_t c0, std::size_t b) const
+  {
+    if (_nonmatching)
+    {
+      const std::size_t size = _shape[0] * _shape[1];
+      return std::span<const T>(_cell_A.data() + (c0 + b) * size, size);
+    }
+    else if (_cell_info.empty())
+      return _A;
+    else
+      return std::span<const T>(_Ac.data() + b * _A.size(), _A.size());
+  }
+
+  // Compute the cell matrices for elements with different maps, if
+  // the geometry has changed since they were computed
+  void update_cell_matrices() const
+  {
+    const mesh::Geometry<U>& geometry = _V0->mesh()->geometry();
+    if (!_cell_A.empty() and geometry.x_version() == _x_version)
+      return;
+
+    std::vector<std::int32_t> cells(_num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    std::vector<U> A
+        = impl::nonmatching_maps_matrices<U>(*_V1, cells, *_V0, cells);
+    _cell_A.assign(A.begin(), A.end());
+    _x_version = geometry.x_version();
+  }
+
+  // Gather the values of n cells into X (n, N)
+  static void gather(std::span<const T> x, std::span<const std::int32_t> dofs,
+                     int bs, std::size_t n, std::size_t N, std::vector<T>& X)
+  {
+    for (std::size_t b = 0; b < n; ++b)
+    {
+      const std::int32_t* d = dofs.data() + b * (N / bs);
+      for (std::size_t i = 0; i < N / bs; ++i)
+        for (int k = 0; k < bs; ++k)
+          X[b * N + i * bs + k] = x[bs * d[i] + k];
+    }
+  }
+
+  // Function spaces
+  std::shared_ptr<const FunctionSpace<U>> _V0, _V1;
+
+  // Reference interpolation matrix and its shape (num_dofs1,
+  // num_dofs0)
+  std::vector<T> _A;
+  std::array<std::size_t, 2> _shape;
+
+  // Number of owned cells
+  std::int32_t _num_cells;
+
+  // Cell permutation data and dof transformations, if the elements
+  // need dof transformations
+  std::span<const std::uint32_t> _cell_info;
+  std::function<void(std::span<T>, std::span<const std::uint32_t>,
+                     std::int32_t, int)>
+      _transform0, _transform1;
+
+  // True if the elements have different maps
+  bool _nonmatching = false;
+
+  // Cell matrices (num_cells, num_dofs1, num_dofs0) for elements with
+  // different maps, and the geometry version they were computed for
+  mutable std::vector<T> _cell_A;
+  mutable std::uint64_t _x_version = 0;
+
+  // Inverse multiplicity of the dofs of V1
+  std::vector<T> _weights;
+
+  // Work arrays for a batch
+  mutable std::vector<T> _X0, _X1, _Ac;
+};
+} // namespace dolfinx::fem
@@ -0,0 +1,307 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include "StaticCondensation.h"
+#include "assembler.h"
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+/// @brief Approximation of a mass matrix by its inverse.
+enum class MassLumping : std::int8_t
+{
+  none,    ///< Exact inverse of cell blocks (discontinuous spaces)
+  row_sum, ///< Diagonal of row sums
+  diagonal ///< Diagonal entries, e.g. with nodal quadrature
+};
+
+/// @brief Inverse of a mass matrix for explicit time stepping.
+///
+/// With MassLumping::none, the degrees-of-freedom of each cell must not
+/// be shared with other cells (e.g. a discontinuous space), so that the
+/// mass matrix is block diagonal with one block per cell. The inverse
+/// of each cell block is computed once and stored contiguously, and
+/// apply() multiplies the cell values by the inverse blocks.
+///
+/// With MassLumping::row_sum or MassLumping::diagonal, for any space,
+/// the mass matrix is replaced by a diagonal matrix with the row sums
+/// or the diagonal entries of the mass matrix (the latter is exact for
+/// a diagonal mass matrix computed with nodal quadrature, e.g. for a
+/// spectral element space). The inverse diagonal is stored and apply()
+/// scales each entry.
+///
+/// The cell matrices are computed by the matrix assembler, so any
+/// integrals of the mass form are included. apply() only reads and
+/// writes contiguous arrays, and can use threads.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class InverseMass
+{
+public:
+  /// @brief Compute the inverse of a mass matrix.
+  /// @note Collective for lumped mass matrices.
+  /// @param[in] m The mass bilinear form. The test and trial spaces
+  /// must have the same dofmap.
+  /// @param[in] lumping Approximation of the mass matrix
+  InverseMass(const Form<T, U>& m, MassLumping lumping = MassLumping::none)
+      : _lumping(lumping)
+  {
+    if (m.rank() != 2)
+      throw std::runtime_error("Mass form must be bilinear.");
+    auto V = m.function_spaces().at(0);
+    if (V->dofmap() != m.function_spaces().at(1)->dofmap())
+    {
+      throw std::runtime_error(
+          "Test and trial spaces must have the same dofmap.");
+    }
+
+    const DofMap& dofmap = *V->dofmap();
+    _bs = dofmap.bs();
+    _size = _bs * dofmap.index_map->size_local();
+    if (lumping == MassLumping::none)
+      create_blocks(m);
+    else
+      create_diagonal(m);
+  }
+
+  /// @brief Apply the inverse mass matrix, `y = M^{-1} x`.
+  ///
+  /// The entries of `y` for the owned degrees-of-freedom are computed.
+  /// The same array can be passed as `x` and `y`.
+  ///
+  /// @param[in] x Values, indexed by the (unrolled) local
+  /// degrees-of-freedom
+  /// @param[out] y Result, with the same layout as `x`
+  /// @param[in] num_threads Number of threads
+  void apply(std::span<const T> x, std::span<T> y, int num_threads = 1) const
+  {
+    if (_lumping != MassLumping::none)
+    {
+      common::parallel_for(_size, num_threads,
+                           [&](std::int64_t i0, std::int64_t i1)
+                           {
+                             for (std::int64_t i = i0; i < i1; ++i)
+                               y[i] = _diag[i] * x[i];
+                           });
+      return;
+    }
+
+    // Cells do not share degrees-of-freedom, so the values of a cell
+    // can be gathered and then overwritten
+    const int n = _ndofs;
+    common::parallel_for(
+        num_cells(), num_threads,
+        [&](std::int64_t c0, std::int64_t c1)
+        {
+          std::vector<T> xc(n);
+          for (std::int64_t c = c0; c < c1; ++c)
+          {
+            const T* Minv = _blocks.data() + c * n * n;
+            std::span<const std::int32_t> dofs = cell_dofs(c);
+            for (std::size_t d = 0; d < dofs.size(); ++d)
+              for (int k = 0; k < _bs; ++k)
+                xc[_bs * d + k] = x[_bs * dofs[d] + k];
+            for (int i = 0; i < n; ++i)
+            {
+              T s = 0;
+              for (int j = 0; j < n; ++j)
+                s += Minv[i * n + j] * xc[j];
+              y[_bs * dofs[i / _bs] + i % _bs] = s;
+            }
+          }
+        });
+  }
+
+  /// @brief Apply the inverse mass matrix in place, `x = M^{-1} x`.
+  ///
+  /// The owned entries of `x` are updated. The ghost values must be
+  /// updated afterwards (la::Vector::scatter_fwd) if they are needed.
+  ///
+  /// @param[in,out] x Vector to apply the inverse mass matrix to
+  /// @param[in] num_threads Number of threads
+  void apply(la::Vector<T>& x, int num_threads = 1) const
+  {
+    apply(x.array(), x.mutable_array(), num_threads);
+  }
+
+  /// @brief Approximation of the mass matrix.
+  MassLumping lumping() const { return _lumping; }
+
+  /// @brief Number of cell blocks (zero for lumped mass matrices).
+  std::size_t num_cells() const
+  {
+    return _ndofs == 0 ? 0 : _blocks.size() / (_ndofs * _ndofs);
+  }
+
+  /// @brief Inverse diagonal of a lumped mass matrix, for the owned
+  /// (unrolled) degrees-of-freedom (empty for MassLumping::none).
+  std::span<const T> diagonal() const { return _diag; }
+
+  /// @brief Memory used by the cached inverse.
+  /// @return Memory usage, with the cell blocks, cell dofs and diagonal
+  /// as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"InverseMass", sizeof(*this), {}};
+    usage.add("cell blocks", common::capacity_bytes(_blocks));
+    usage.add("cell dofs", common::capacity_bytes(_dofs));
+    usage.add("diagonal", common::capacity_bytes(_diag));
+    return usage;
+  }
+
+private:
+  // Compute and invert the cell blocks of a block diagonal mass matrix
+  void create_blocks(const Form<T, U>& m)
+  {
+    if (m.integral_types() != std::set{IntegralType::cell})
+    {
+      throw std::runtime_error(
+          "Mass form for cell block inverse must have only cell integrals.");
+    }
+    const DofMap& dofmap = *m.function_spaces().at(0)->dofmap();
+    const int num_cell_dofs = dofmap.map().extent(1);
+    _ndofs = _bs * num_cell_dofs;
+
+    // Block of each degree-of-freedom, to check that they are not
+    // shared between cells
+    const std::int32_t num_dofs
+        = dofmap.index_map->size_local() + dofmap.index_map->num_ghosts();
+    std::vector<std::int32_t> block(num_dofs, -1);
+    auto add = [&](std::span<const std::int32_t> rows,
+                   std::span<const std::int32_t>, std::span<const T> vals)
+    {
+      std::int32_t b = block[rows.front()];
+      if (b != -1 and !std::ranges::equal(rows, cell_dofs(b)))
+      {
+        throw std::runtime_error(
+            "Mass matrix dofs must not be shared between cells.");
+      }
+      if (b == -1)
+      {
+        b = _dofs.size() / num_cell_dofs;
+        for (std::int32_t dof : rows)
+        {
+          if (block[dof] != -1)
+          {
+            throw std::runtime_error(
+                "Mass matrix dofs must not be shared between cells.");
+          }
+          block[dof] = b;
+        }
+        _dofs.insert(_dofs.end(), rows.begin(), rows.end());
+        _blocks.resize(_blocks.size() + vals.size(), 0);
+      }
+      T* Mc = _blocks.data() + b * vals.size();
+      for (std::size_t i = 0; i < vals.size(); ++i)
+        Mc[i] += vals[i];
+    };
+    fem::assemble_matrix(add, m, std::span<const std::int8_t>(),
+                         std::span<const std::int8_t>());
+
+    // Replace each block by its inverse, X = M_c^{-1} I
+    const int n = _ndofs;
+    std::vector<T> LU(n * n);
+    std::vector<int> piv(n);
+    for (std::size_t c = 0; c < num_cells(); ++c)
+    {
+      std::span<T> Minv(_blocks.data() + c * n * n, n * n);
+      std::ranges::copy(Minv, LU.begin());
+      impl::lu_factor<T>(LU, piv, n);
+      std::ranges::fill(Minv, 0);
+      for (int i = 0; i < n; ++i)
+        Minv[i * n + i] = 1;
+      impl::lu_solve<T>(LU, piv, n, Minv, n);
+    }
+  }
+
+  // Compute the inverse of a lumped mass matrix
+  void create_diagonal(const Form<T, U>& m)
+  {
+    auto V = m.function_spaces().at(0);
+    const DofMap& dofmap = *V->dofmap();
+    la::Vector<T> d(dofmap.index_map, dofmap.index_map_bs());
+    std::span<T> _d = d.mutable_array();
+    if (_lumping == MassLumping::diagonal)
+    {
+      std::span<const T> constants = m.packed_constants();
+      auto coefficients = allocate_coefficient_storage(m);
+      pack_coefficients(m, coefficients);
+      assemble_diagonal(_d, m, constants,
+                        make_coefficients_span(coefficients),
+                        std::span<const std::int8_t>(),
+                        std::span<const std::int8_t>());
+    }
+    else
+    {
+      const int bs = _bs;
+      auto add_row_sums = [_d, bs](std::span<const std::int32_t> rows,
+                                   std::span<const std::int32_t> cols,
+                                   std::span<const T> vals)
+      {
+        const std::size_t num_cols = bs * cols.size();
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+          for (int k = 0; k < bs; ++k)
+          {
+            std::span<const T> row
+                = vals.subspan((bs * i + k) * num_cols, num_cols);
+            _d[bs * rows[i] + k] += std::reduce(row.begin(), row.end());
+          }
+        }
+      };
+      fem::assemble_matrix(add_row_sums, m, std::span<const std::int8_t>(),
+                           std::span<const std::int8_t>());
+    }
+    d.scatter_rev(std::plus<T>());
+
+    _diag.resize(_size);
+    for (std::size_t i = 0; i < _diag.size(); ++i)
+    {
+      if (_d[i] == T(0))
+        throw std::runtime_error("Lumped mass matrix has a zero entry.");
+      _diag[i] = T(1) / _d[i];
+    }
+  }
+
+  // Degrees-of-freedom of a cell block
+  std::span<const std::int32_t> cell_dofs(std::size_t c) const
+  {
+    const std::size_t num_cell_dofs = _ndofs / _bs;
+    return std::span(_dofs.data() + c * num_cell_dofs, num_cell_dofs);
+  }
+
+  // Approximation of the mass matrix
+  MassLumping _lumping;
+
+  // Dofmap block size, number of (unrolled) cell dofs and number of
+  // owned (unrolled) dofs
+  int _bs = 1;
+  int _ndofs = 0;
+  std::size_t _size = 0;
+
+  // Inverse cell blocks, shape (num_cells, _ndofs, _ndofs), and the
+  // (blocked) dofs of each cell
+  std::vector<T> _blocks;
+  std::vector<std::int32_t> _dofs;
+
+  // Inverse lumped diagonal of the owned dofs
+  std::vector<T> _diag;
+};
+
+} // namespace dolfinx::fem
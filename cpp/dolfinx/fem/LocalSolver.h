@@ -0,0 +1,254 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "Function.h"
+#include "StaticCondensation.h"
+#include "assembler.h"
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/Vector.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+/// @brief Solver for problems whose matrix is block diagonal with one
+/// block per cell, e.g. projection into a discontinuous space.
+///
+/// When the degrees-of-freedom of the test and trial spaces are not
+/// shared between cells, the matrix of the bilinear form `a` is block
+/// diagonal. The cell blocks are assembled and LU factorised once, and
+/// solve() assembles the right-hand side and solves with the cell
+/// factors, without a sparsity pattern, a global matrix or a linear
+/// solver.
+///
+/// The factors are recomputed by solve() when the inputs of `a` have
+/// changed, i.e. the la::Vector::version of a coefficient, the values
+/// of the constants or the mesh::Geometry::x_version of the mesh.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class LocalSolver
+{
+public:
+  /// @brief Create the solver and factorise the cell matrices.
+  /// @param[in] a The bilinear form. The test and trial spaces must
+  /// have the same dofmap, with degrees-of-freedom that are not shared
+  /// between cells.
+  /// @param[in] num_threads Number of threads
+  explicit LocalSolver(std::shared_ptr<const Form<T, U>> a,
+                       int num_threads = 1)
+      : _a(a)
+  {
+    if (a->rank() != 2)
+      throw std::runtime_error("Form must be bilinear.");
+    auto V = a->function_spaces();
+    if (V[0]->dofmap() != V[1]->dofmap())
+    {
+      throw std::runtime_error(
+          "Test and trial spaces must have the same dofmap.");
+    }
+    if (a->integral_types().contains(IntegralType::interior_facet))
+    {
+      throw std::runtime_error(
+          "Bilinear form must not have interior facet integrals.");
+    }
+    factorise(num_threads);
+  }
+
+  /// @brief Solve `A u = b`, where `A` is the matrix of the bilinear
+  /// form and `b` the vector of the linear form `L`.
+  ///
+  /// The owned entries of `u` are set. The ghost values must be
+  /// updated afterwards (la::Vector::scatter_fwd) if they are needed.
+  ///
+  /// @note Collective if `L` has interior facet integrals, in which case
+  /// the contributions to ghost entries are sent to the owners.
+  /// @param[in] L The linear form. Its test space must be the test
+  /// space of the bilinear form.
+  /// @param[in,out] u The solution.
+  /// @param[in] num_threads Number of threads
+  void solve(const Form<T, U>& L, Function<T, U>& u, int num_threads = 1)
+  {
+    if (create_stamp() != _stamp)
+      factorise(num_threads);
+
+    const DofMap& dofmap = *_a->function_spaces().at(0)->dofmap();
+    la::Vector<T> b(dofmap.index_map, dofmap.index_map_bs());
+    assemble_vector(b.mutable_array(), L, num_threads);
+    if (L.integral_types().contains(IntegralType::interior_facet))
+      b.scatter_rev(std::plus<T>());
+    solve(b.array(), u.x()->mutable_array(), num_threads);
+  }
+
+  /// @brief Solve with the cell factors, `y = A^{-1} x`.
+  ///
+  /// The entries of `y` for the degrees-of-freedom of the owned cells
+  /// are computed. The same array can be passed as `x` and `y`.
+  ///
+  /// @param[in] x Right-hand side, indexed by the (unrolled) local
+  /// degrees-of-freedom
+  /// @param[out] y Solution, with the same layout as `x`
+  /// @param[in] num_threads Number of threads
+  void solve(std::span<const T> x, std::span<T> y, int num_threads = 1) const
+  {
+    const int n = _ndofs;
+    const DofMap& dofmap = *_a->function_spaces().at(0)->dofmap();
+    const int bs = dofmap.bs();
+    common::parallel_for(
+        _num_cells, num_threads,
+        [&](std::int64_t c0, std::int64_t c1)
+        {
+          std::vector<T> xc(n);
+          for (std::int64_t c = c0; c < c1; ++c)
+          {
+            std::span<const std::int32_t> dofs = dofmap.cell_dofs(c);
+            for (std::size_t d = 0; d < dofs.size(); ++d)
+              for (int k = 0; k < bs; ++k)
+                xc[bs * d + k] = x[bs * dofs[d] + k];
+            impl::lu_solve<T>(
+                std::span<const T>(_LU.data() + c * n * n, n * n),
+                std::span<const int>(_piv.data() + c * n, n), n, xc, 1);
+            for (std::size_t d = 0; d < dofs.size(); ++d)
+              for (int k = 0; k < bs; ++k)
+                y[bs * dofs[d] + k] = xc[bs * d + k];
+          }
+        });
+  }
+
+  /// @brief The bilinear form.
+  std::shared_ptr<const Form<T, U>> form() const { return _a; }
+
+  /// @brief Memory used by the solver.
+  /// @return Memory usage, with the cell factors as a part
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"LocalSolver", sizeof(*this), {}};
+    usage.add("cell factors", common::capacity_bytes(_LU)
+                                  + common::capacity_bytes(_piv));
+    return usage;
+  }
+
+private:
+  // State of the inputs of the bilinear form
+  struct Stamp
+  {
+    std::vector<std::uint64_t> coefficient_versions;
+    std::vector<T> constants;
+    std::uint64_t x_version = 0;
+
+    bool operator==(const Stamp&) const = default;
+  };
+
+  Stamp create_stamp() const
+  {
+    Stamp stamp;
+    for (auto& c : _a->coefficients())
+      stamp.coefficient_versions.push_back(c->x()->version());
+    std::span<const T> constants = _a->packed_constants();
+    stamp.constants.assign(constants.begin(), constants.end());
+    stamp.x_version = _a->mesh()->geometry().x_version();
+    return stamp;
+  }
+
+  // Assemble and factorise the cell matrices
+  void factorise(int num_threads)
+  {
+    const DofMap& dofmap = *_a->function_spaces().at(0)->dofmap();
+    auto mesh = _a->mesh();
+    const int tdim = mesh->topology()->dim();
+    _num_cells = mesh->topology()->index_map(tdim)->size_local();
+    _ndofs = dofmap.bs() * dofmap.map().extent(1);
+    const int n = _ndofs;
+
+    // Owning cell of each degree-of-freedom, to add the cell matrices
+    // and to check that the dofs are not shared between cells
+    const std::int32_t num_dofs
+        = dofmap.index_map->size_local() + dofmap.index_map->num_ghosts();
+    std::vector<std::int32_t> cell(num_dofs, -1);
+    for (std::int32_t c = _num_cells - 1; c >= 0; --c)
+      for (std::int32_t dof : dofmap.cell_dofs(c))
+        cell[dof] = c;
+    for (std::int32_t c = 0; c < _num_cells; ++c)
+    {
+      for (std::int32_t dof : dofmap.cell_dofs(c))
+      {
+        if (cell[dof] != c)
+        {
+          throw std::runtime_error(
+              "Degrees-of-freedom must not be shared between cells.");
+        }
+      }
+    }
+
+    _LU.assign(_num_cells * n * n, 0);
+    _piv.resize(_num_cells * n);
+    auto add = [&](std::span<const std::int32_t> rows,
+                   std::span<const std::int32_t>, std::span<const T> vals)
+    {
+      std::int32_t c = cell[rows.front()];
+      if (c < 0)
+        return;
+      T* Ac = _LU.data() + c * n * n;
+      for (std::size_t i = 0; i < vals.size(); ++i)
+        Ac[i] += vals[i];
+    };
+    fem::assemble_matrix(add, *_a, std::span<const std::int8_t>(),
+                         std::span<const std::int8_t>());
+
+    common::parallel_for(
+        _num_cells, num_threads,
+        [&](std::int64_t c0, std::int64_t c1)
+        {
+          for (std::int64_t c = c0; c < c1; ++c)
+          {
+            impl::lu_factor<T>(std::span(_LU.data() + c * n * n, n * n),
+                               std::span(_piv.data() + c * n, n), n);
+          }
+        });
+
+    _stamp = create_stamp();
+  }
+
+  // Bilinear form
+  std::shared_ptr<const Form<T, U>> _a;
+
+  // Number of cells and of (unrolled) dofs per cell
+  std::int32_t _num_cells = 0;
+  int _ndofs = 0;
+
+  // LU factors and pivots of the cell matrices
+  std::vector<T> _LU;
+  std::vector<int> _piv;
+
+  // Inputs of the bilinear form when the factors were computed
+  Stamp _stamp;
+};
+
+/// @brief Solve a problem with a block diagonal matrix (one block per
+/// cell), e.g. a projection into a discontinuous space.
+///
+/// See LocalSolver. Create a LocalSolver to re-use the cell factors for
+/// several right-hand sides.
+///
+/// @param[in] a The bilinear form.
+/// @param[in] L The linear form.
+/// @param[in,out] u The solution. The owned entries are set.
+/// @param[in] num_threads Number of threads
+template <dolfinx::scalar T, std::floating_point U>
+void local_solve(std::shared_ptr<const Form<T, U>> a, const Form<T, U>& L,
+                 Function<T, U>& u, int num_threads = 1)
+{
+  LocalSolver<T, U>(a, num_threads).solve(L, u, num_threads);
+}
+} // namespace dolfinx::fem
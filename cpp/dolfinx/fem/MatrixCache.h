@@ -0,0 +1,257 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DirichletBC.h"
+#include "Form.h"
+#include "Function.h"
+#include "assembler.h"
+#include "utils.h"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <limits>
+#include <list>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// @brief Cache of assembled matrices of bilinear forms whose inputs
+/// have not changed.
+///
+/// Matrices of forms with unchanged coefficients and constants, e.g.
+/// mass and stiffness matrices, are often re-assembled in every step
+/// of a time-stepping or multiphysics loop. MatrixCache::assemble
+/// returns the cached matrix of a form if none of its inputs has
+/// changed since the matrix was assembled, and assembles (and caches)
+/// the matrix otherwise.
+///
+/// A cached matrix is identified by the form and the boundary
+/// conditions (by identity) and the diagonal value, and is valid while
+/// - the la::Vector::version of each coefficient,
+/// - the values of the constants,
+/// - the mesh::Geometry::x_version and mesh::Topology::version of the
+/// form mesh
+///
+/// are unchanged. The least recently used matrices are evicted when
+/// the memory used by the cached matrices exceeds the budget.
+///
+/// @note Changes of the inputs that are not recorded by the version
+/// counters, e.g. in-place modification of a coefficient through a
+/// previously obtained span, are not detected. Call mark_modified on
+/// the modified object, or clear the cache, in these cases.
+/// @note The degrees-of-freedom of a boundary condition are assumed to
+/// not change.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class MatrixCache
+{
+public:
+  /// @brief Create an empty cache.
+  /// @param[in] budget Memory budget for the cached matrices in bytes.
+  explicit MatrixCache(
+      std::size_t budget = std::numeric_limits<std::size_t>::max())
+      : _budget(budget)
+  {
+  }
+
+  /// @brief Assembled matrix of a bilinear form.
+  ///
+  /// If the matrix of the form is cached and its inputs are unchanged,
+  /// the cached matrix is returned without assembly. Otherwise the
+  /// matrix is created and assembled, the rows and columns of the
+  /// boundary condition dofs are zeroed, `diagonal` is set on the
+  /// diagonal of these rows if the test and trial spaces are the same,
+  /// and the ghost rows are sent to the owners.
+  ///
+  /// @note Collective if the matrix is assembled. All processes must
+  /// call this function for the same forms in the same order, so that
+  /// they hit or miss the cache together.
+  /// @param[in] a The bilinear form.
+  /// @param[in] bcs Boundary conditions to apply.
+  /// @param[in] diagonal Value to set on the diagonal of constrained
+  /// rows.
+  /// @return The assembled matrix. It must not be modified, since it
+  /// can be returned again.
+  std::shared_ptr<const la::MatrixCSR<T>> assemble(
+      std::shared_ptr<const Form<T, U>> a,
+      const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs = {},
+      T diagonal = 1)
+  {
+    assert(a);
+    if (a->rank() != 2)
+      throw std::runtime_error("Form must be a bilinear form.");
+
+    Stamp stamp = create_stamp(*a, bcs, diagonal);
+    auto it = std::ranges::find_if(
+        _entries, [&a](const Entry& e) { return e.form.lock() == a; });
+    if (it != _entries.end())
+    {
+      if (it->stamp == stamp)
+      {
+        // Hit: move to front (most recently used)
+        ++_num_hits;
+        _entries.splice(_entries.begin(), _entries, it);
+        return _entries.front().A;
+      }
+
+      // Stale entry
+      _bytes -= it->bytes;
+      _entries.erase(it);
+    }
+
+    ++_num_misses;
+    la::SparsityPattern pattern = create_sparsity_pattern(*a);
+    pattern.finalize();
+    auto A = std::make_shared<la::MatrixCSR<T>>(pattern);
+    assemble_matrix(A->mat_add_values(), *a, bcs);
+    A->scatter_rev();
+    auto V = a->function_spaces();
+    if (V[0] == V[1])
+      set_diagonal(A->mat_set_values(), *V[0], bcs, diagonal);
+
+    const std::size_t bytes = A->memory_usage().total();
+    _entries.push_front({a, std::move(stamp), A, bytes});
+    _bytes += bytes;
+    evict();
+
+    return A;
+  }
+
+  /// @brief Remove the cached matrix of a form.
+  /// @param[in] a The form.
+  void erase(const Form<T, U>& a)
+  {
+    auto it = std::ranges::find_if(
+        _entries, [&a](const Entry& e) { return e.form.lock().get() == &a; });
+    if (it != _entries.end())
+    {
+      _bytes -= it->bytes;
+      _entries.erase(it);
+    }
+  }
+
+  /// @brief Remove all cached matrices.
+  void clear()
+  {
+    _entries.clear();
+    _bytes = 0;
+  }
+
+  /// @brief Number of cached matrices.
+  std::size_t size() const { return _entries.size(); }
+
+  /// @brief Memory used by the cached matrices in bytes.
+  std::size_t bytes() const { return _bytes; }
+
+  /// @brief Memory budget for the cached matrices in bytes.
+  std::size_t budget() const { return _budget; }
+
+  /// @brief Set the memory budget for the cached matrices.
+  ///
+  /// The least recently used matrices are evicted until the budget is
+  /// met. The most recently used matrix is always kept.
+  /// @param[in] bytes Budget in bytes.
+  void set_budget(std::size_t bytes)
+  {
+    _budget = bytes;
+    evict();
+  }
+
+  /// @brief Number of calls to assemble that returned a cached matrix.
+  std::size_t num_hits() const { return _num_hits; }
+
+  /// @brief Number of calls to assemble that assembled the matrix.
+  std::size_t num_misses() const { return _num_misses; }
+
+private:
+  // State of the inputs of a form when its matrix was assembled
+  struct Stamp
+  {
+    std::vector<std::uint64_t> coefficient_versions;
+    std::vector<T> constants;
+    std::uint64_t x_version;
+    std::uint64_t topology_version;
+    std::vector<const DirichletBC<T, U>*> bcs;
+    T diagonal;
+
+    bool operator==(const Stamp&) const = default;
+  };
+
+  // Cached matrix
+  struct Entry
+  {
+    std::weak_ptr<const Form<T, U>> form;
+    Stamp stamp;
+    std::shared_ptr<const la::MatrixCSR<T>> A;
+    std::size_t bytes;
+  };
+
+  static Stamp
+  create_stamp(const Form<T, U>& a,
+               const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+               T diagonal)
+  {
+    Stamp stamp;
+    for (auto& c : a.coefficients())
+    {
+      if (!c)
+        throw std::runtime_error("Not all form coefficients have been set.");
+      stamp.coefficient_versions.push_back(c->x()->version());
+    }
+    std::span<const T> constants = a.packed_constants();
+    stamp.constants.assign(constants.begin(), constants.end());
+    auto mesh = a.mesh();
+    assert(mesh);
+    stamp.x_version = mesh->geometry().x_version();
+    stamp.topology_version = mesh->topology()->version();
+    for (auto& bc : bcs)
+      stamp.bcs.push_back(bc.get());
+    stamp.diagonal = diagonal;
+    return stamp;
+  }
+
+  // Evict least recently used matrices until the budget is met,
+  // keeping the most recently used matrix
+  void evict()
+  {
+    while (_bytes > _budget and _entries.size() > 1)
+    {
+      _bytes -= _entries.back().bytes;
+      _entries.pop_back();
+    }
+
+    // Discard entries of destroyed forms
+    std::erase_if(_entries,
+                  [this](const Entry& e)
+                  {
+                    if (!e.form.expired())
+                      return false;
+                    _bytes -= e.bytes;
+                    return true;
+                  });
+  }
+
+  // Cached matrices, most recently used first
+  std::list<Entry> _entries;
+
+  // Memory used by the cached matrices and budget (bytes)
+  std::size_t _bytes = 0;
+  std::size_t _budget;
+
+  // Cache statistics
+  std::size_t _num_hits = 0;
+  std::size_t _num_misses = 0;
+};
+
+} // namespace dolfinx::fem
@@ -0,0 +1,261 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include "traits.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <map>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+/// @brief Values at the quadrature points of the cells of an
+/// integration domain, e.g. the state of a history-dependent material.
+///
+/// The values are stored contiguously with shape `(num_cells,
+/// num_points, value_size)`, with the cells in the order of the
+/// integration domain (see Form::domain). Since this is the layout of
+/// packed coefficients, the values of a cell are copied into the
+/// coefficients passed to a kernel without a dofmap or dof
+/// transformations (see pack_coefficients), and are updated in place
+/// by a kernel (see update).
+///
+/// @tparam T Scalar type.
+template <dolfinx::scalar T>
+class QuadratureData
+{
+public:
+  /// Value type
+  using value_type = T;
+
+  /// @brief Create quadrature data.
+  /// @param[in] cells Cells of the integration domain, in the order of
+  /// Form::domain.
+  /// @param[in] num_points Number of quadrature points of a cell.
+  /// @param[in] value_size Number of values at a quadrature point.
+  /// @param[in] value Initial value.
+  QuadratureData(std::vector<std::int32_t> cells, int num_points,
+                 int value_size, T value = 0)
+      : _cells(std::move(cells)), _num_points(num_points),
+        _value_size(value_size),
+        _values(_cells.size() * num_points * value_size, value)
+  {
+  }
+
+  /// @brief Create quadrature data for a cell integral of a form.
+  /// @param[in] form The form.
+  /// @param[in] id Domain identifier of the cell integral.
+  /// @param[in] num_points Number of quadrature points of a cell.
+  /// @param[in] value_size Number of values at a quadrature point.
+  /// @param[in] value Initial value.
+  template <std::floating_point U>
+  QuadratureData(const Form<T, U>& form, int id, int num_points,
+                 int value_size, T value = 0)
+      : _num_points(num_points), _value_size(value_size)
+  {
+    std::span<const std::int32_t> cells = form.domain(IntegralType::cell, id);
+    _cells.assign(cells.begin(), cells.end());
+    _values.resize(_cells.size() * stride(), value);
+  }
+
+  /// @brief Cells of the integration domain.
+  std::span<const std::int32_t> cells() const { return _cells; }
+
+  /// @brief Number of quadrature points of a cell.
+  int num_points() const { return _num_points; }
+
+  /// @brief Number of values at a quadrature point.
+  int value_size() const { return _value_size; }
+
+  /// @brief Number of values of a cell, `num_points() * value_size()`.
+  int stride() const { return _num_points * _value_size; }
+
+  /// @brief All values, with shape `(num_cells, num_points,
+  /// value_size)`.
+  std::span<T> values() { return _values; }
+
+  /// @brief All values (const version).
+  std::span<const T> values() const { return _values; }
+
+  /// @brief Values of a cell.
+  /// @param[in] index Position of the cell in cells().
+  /// @return The values of the cell, with shape `(num_points,
+  /// value_size)`.
+  std::span<T> values(std::size_t index)
+  {
+    return std::span(_values.data() + index * stride(), stride());
+  }
+
+  /// @brief Values of a cell (const version).
+  std::span<const T> values(std::size_t index) const
+  {
+    return std::span(_values.data() + index * stride(), stride());
+  }
+
+  /// @brief Update the values in place with a kernel.
+  ///
+  /// The kernel is called for each cell as `kernel(v, w, c, x, nullptr,
+  /// nullptr)`, where `v` points to the values of the cell, which hold
+  /// the current values on entry, `w` to the coefficients of the cell,
+  /// `c` to the constants and `x` to the coordinate dofs of the cell.
+  /// With more than one thread the kernel is called concurrently for
+  /// different cells.
+  ///
+  /// @param[in] kernel Kernel that updates the values of a cell.
+  /// @param[in] geometry Mesh geometry.
+  /// @param[in] constants Constants passed to the kernel.
+  /// @param[in] coeffs Coefficients passed to the kernel, with shape
+  /// `(num_cells, cstride)`.
+  /// @param[in] cstride Coefficient stride.
+  /// @param[in] num_threads Number of threads.
+  void update(FEkernel<T> auto kernel,
+              const mesh::Geometry<scalar_value_type_t<T>>& geometry,
+              std::span<const T> constants = {},
+              std::span<const T> coeffs = {}, int cstride = 0,
+              int num_threads = 1)
+  {
+    auto x_dofmap = geometry.dofmap();
+    std::span<const scalar_value_type_t<T>> x = geometry.x();
+    common::parallel_for(
+        _cells.size(), num_threads,
+        [&](std::int64_t i0, std::int64_t i1)
+        {
+          std::vector<scalar_value_type_t<T>> coordinate_dofs(
+              3 * x_dofmap.extent(1));
+          for (std::int64_t index = i0; index < i1; ++index)
+          {
+            auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+                x_dofmap, _cells[index],
+                MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+            for (std::size_t i = 0; i < x_dofs.size(); ++i)
+            {
+              std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                          std::next(coordinate_dofs.begin(), 3 * i));
+            }
+            kernel(_values.data() + index * stride(),
+                   coeffs.data() + index * cstride, constants.data(),
+                   coordinate_dofs.data(), nullptr, nullptr);
+          }
+        });
+  }
+
+  /// @brief Copy the values into packed coefficients.
+  /// @param[in,out] c Packed coefficients for the cells, with shape
+  /// `(num_cells, cstride)`.
+  /// @param[in] cstride Coefficient stride.
+  /// @param[in] offset Position of the values of a cell in a row of
+  /// `c`.
+  void pack(std::span<T> c, int cstride, int offset) const
+  {
+    const int n = stride();
+    for (std::size_t index = 0; index < _cells.size(); ++index)
+    {
+      std::copy_n(std::next(_values.begin(), index * n), n,
+                  std::next(c.begin(), index * cstride + offset));
+    }
+  }
+
+  /// @brief Memory used by the quadrature data.
+  /// @return Memory usage, with the cells and values as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"QuadratureData", sizeof(*this), {}};
+    usage.add("cells", common::capacity_bytes(_cells));
+    usage.add("values", common::capacity_bytes(_values));
+    return usage;
+  }
+
+private:
+  // Cells of the integration domain
+  std::vector<std::int32_t> _cells;
+
+  // Number of quadrature points of a cell and number of values at a
+  // point
+  int _num_points;
+  int _value_size;
+
+  // Values, shape (num_cells, num_points, value_size)
+  std::vector<T> _values;
+};
+
+/// @brief Pack coefficients of a Form, taking the values of some
+/// coefficients from quadrature data.
+///
+/// The coefficients of the form with quadrature data are not packed
+/// from their Function for cell integrals. The quadrature data is
+/// copied into their columns instead, without a dofmap or dof
+/// transformations. The coefficient (e.g. a Function on a quadrature
+/// element space) is only used to define the kernel. Other integral
+/// types are packed from the Functions.
+///
+/// @param[in] form The Form.
+/// @param[in,out] coeffs Packed coefficients (see
+/// allocate_coefficient_storage).
+/// @param[in] data Map from the index of a coefficient of the form to
+/// its quadrature data. The cells of the data must be the integration
+/// domain of each cell integral in which the coefficient is active.
+/// @param[in] num_threads Number of threads to use for packing.
+template <dolfinx::scalar T, std::floating_point U>
+void pack_coefficients(
+    const Form<T, U>& form,
+    std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>&
+        coeffs,
+    const std::map<int, std::shared_ptr<const QuadratureData<T>>>& data,
+    int num_threads = 1)
+{
+  const std::vector<int> offsets = form.coefficient_offsets();
+  const std::vector<int> ids = form.integral_ids(IntegralType::cell);
+  for (auto& [key, val] : coeffs)
+  {
+    auto [type, id] = key;
+    if (type != IntegralType::cell)
+    {
+      pack_coefficients<T>(form, type, id, std::span(val.first), val.second,
+                           num_threads);
+      continue;
+    }
+
+    impl::pack_coefficients(
+        form, type, id, std::span(val.first), val.second,
+        [&form, type, id](auto& mesh) { return form.domain(type, id, mesh); },
+        [&data](std::size_t i) { return !data.contains(i); }, num_threads);
+
+    auto it = std::ranges::find(ids, id);
+    assert(it != ids.end());
+    for (int i : form.active_coeffs(type, std::distance(ids.begin(), it)))
+    {
+      auto q = data.find(i);
+      if (q == data.end())
+        continue;
+      assert(q->second);
+      if (offsets[i + 1] - offsets[i] != q->second->stride())
+      {
+        throw std::runtime_error(
+            "Size of quadrature data does not match the coefficient.");
+      }
+      if (!std::ranges::equal(q->second->cells(), form.domain(type, id)))
+      {
+        throw std::runtime_error(
+            "Quadrature data cells do not match the integration domain.");
+      }
+      q->second->pack(std::span(val.first), val.second, offsets[i]);
+    }
+  }
+}
+
+} // namespace dolfinx::fem
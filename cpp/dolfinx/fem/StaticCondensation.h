@@ -0,0 +1,421 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include "assembler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/utils.h>
+#include <memory>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+namespace impl
+{
+/// @brief LU factorisation with partial pivoting of a dense matrix,
+/// in-place.
+/// @param[in,out] A Row-major matrix of shape `(n, n)`. On exit it
+/// holds the unit lower triangular factor (below the diagonal) and the
+/// upper triangular factor.
+/// @param[out] piv Row interchanges, row `k` is swapped with row
+/// `piv[k]` at step `k`.
+/// @param[in] n Matrix size.
+template <dolfinx::scalar T>
+void lu_factor(std::span<T> A, std::span<int> piv, int n)
+{
+  for (int k = 0; k < n; ++k)
+  {
+    int p = k;
+    auto amax = std::abs(A[k * n + k]);
+    for (int i = k + 1; i < n; ++i)
+    {
+      if (auto a = std::abs(A[i * n + k]); a > amax)
+      {
+        amax = a;
+        p = i;
+      }
+    }
+    if (amax == 0)
+      throw std::runtime_error("Singular cell matrix.");
+
+    piv[k] = p;
+    if (p != k)
+    {
+      std::swap_ranges(std::next(A.begin(), k * n),
+                       std::next(A.begin(), (k + 1) * n),
+                       std::next(A.begin(), p * n));
+    }
+    for (int i = k + 1; i < n; ++i)
+    {
+      T l = A[i * n + k] /= A[k * n + k];
+      for (int j = k + 1; j < n; ++j)
+        A[i * n + j] -= l * A[k * n + j];
+    }
+  }
+}
+
+/// @brief Solve `A X = B` using the LU factors computed by lu_factor.
+/// @param[in] LU LU factors of `A`.
+/// @param[in] piv Row interchanges.
+/// @param[in] n Matrix size.
+/// @param[in,out] B Row-major right-hand sides of shape `(n, m)`. On
+/// exit holds the solution.
+/// @param[in] m Number of right-hand sides.
+template <dolfinx::scalar T>
+void lu_solve(std::span<const T> LU, std::span<const int> piv, int n,
+              std::span<T> B, int m)
+{
+  for (int k = 0; k < n; ++k)
+  {
+    if (piv[k] != k)
+    {
+      std::swap_ranges(std::next(B.begin(), k * m),
+                       std::next(B.begin(), (k + 1) * m),
+                       std::next(B.begin(), piv[k] * m));
+    }
+  }
+
+  for (int i = 1; i < n; ++i)
+    for (int k = 0; k < i; ++k)
+      for (int j = 0; j < m; ++j)
+        B[i * m + j] -= LU[i * n + k] * B[k * m + j];
+
+  for (int i = n - 1; i >= 0; --i)
+  {
+    for (int k = i + 1; k < n; ++k)
+      for (int j = 0; j < m; ++j)
+        B[i * m + j] -= LU[i * n + k] * B[k * m + j];
+    for (int j = 0; j < m; ++j)
+      B[i * m + j] /= LU[i * n + i];
+  }
+}
+} // namespace impl
+
+/// @brief Static condensation of a 2x2 block bilinear form.
+///
+/// For the block system
+///
+///     | A00 A01 | |u0|   |b0|
+///     | A10 A11 | |u1| = |b1|
+///
+/// in which the dofs of the space of `u0` are local to a cell (e.g. a
+/// discontinuous or cell-interior space), `A00` is block diagonal with
+/// one block per cell. The `u0` dofs are eliminated cell-by-cell,
+/// leaving the smaller global system
+///
+///     (A11 - A10 A00^{-1} A01) u1 = b1 - A10 A00^{-1} b0.
+///
+/// assemble_matrix assembles the condensed matrix and caches the
+/// factorised `A00` blocks and the `A01` and `A10` blocks of each cell,
+/// which are used by condense_vector to compute the condensed
+/// right-hand side and by back_substitute to recover `u0`.
+///
+/// @note The forms must each have one cell integral over the same cells
+/// and no other integrals.
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+class StaticCondensation
+{
+public:
+  /// @brief Create a static condensation of a block bilinear form.
+  /// @param[in] a The blocks `a[i][j]` of the bilinear form, with test
+  /// function in the space `i` and trial function in the space `j`.
+  /// Space 0 is condensed.
+  StaticCondensation(
+      const std::array<std::array<std::shared_ptr<const Form<T, U>>, 2>, 2>&
+          a)
+      : _a(a)
+  {
+    std::array<std::shared_ptr<const FunctionSpace<U>>, 2> V;
+    for (int i = 0; i < 2; ++i)
+    {
+      V[i] = a[i][i]->function_spaces().at(0);
+      for (int j = 0; j < 2; ++j)
+      {
+        const Form<T, U>& aij = *a[i][j];
+        if (aij.rank() != 2)
+          throw std::runtime_error("Forms must be bilinear.");
+        if (aij.integral_types() != std::set{IntegralType::cell}
+            or aij.integral_ids(IntegralType::cell).size() != 1)
+        {
+          throw std::runtime_error(
+              "Static condensation requires forms with one cell integral.");
+        }
+      }
+    }
+
+    std::span<const std::int32_t> cells = domain(*a[0][0]);
+    for (int i = 0; i < 2; ++i)
+    {
+      for (int j = 0; j < 2; ++j)
+      {
+        if (a[i][j]->function_spaces().at(0) != V[i]
+            or a[i][j]->function_spaces().at(1) != V[j])
+        {
+          throw std::runtime_error("Incompatible block function spaces.");
+        }
+        std::span<const std::int32_t> cells_ij = domain(*a[i][j]);
+        if (!std::ranges::equal(cells_ij, cells))
+          throw std::runtime_error("Block forms have different cells.");
+      }
+    }
+
+    // Check that the condensed dofs are not shared between cells
+    const DofMap& dofmap0 = *V[0]->dofmap();
+    std::vector<std::int8_t> marker(dofmap0.index_map->size_local()
+                                        + dofmap0.index_map->num_ghosts(),
+                                    0);
+    for (std::int32_t c : cells)
+    {
+      for (std::int32_t dof : dofmap0.cell_dofs(c))
+      {
+        if (marker[dof]++ > 0)
+        {
+          throw std::runtime_error(
+              "Condensed space dofs must not be shared between cells.");
+        }
+      }
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+      _bs[i] = V[i]->dofmap()->bs();
+      _ndofs[i] = _bs[i] * V[i]->dofmap()->map().extent(1);
+    }
+  }
+
+  /// @brief Assemble the condensed matrix `A11 - A10 A00^{-1} A01`.
+  ///
+  /// The element matrices of the blocks are computed, and the
+  /// factorised `A00` blocks and the `A01` and `A10` blocks are cached
+  /// for condense_vector and back_substitute. The matrix is not zeroed
+  /// or finalised.
+  ///
+  /// @param[in] mat_add Function that accumulates the cell matrices of
+  /// the condensed matrix into a matrix, with the dofs of space 1.
+  /// @param[in] bc1 Marker for the space 1 dofs with Dirichlet boundary
+  /// conditions. Rows and columns of the condensed matrix for marked
+  /// dofs are zeroed.
+  void assemble_matrix(la::MatSet<T> auto mat_add,
+                       std::span<const std::int8_t> bc1 = {})
+  {
+    std::vector<T> A11;
+    std::vector<std::int32_t> dofs;
+    tabulate(*_a[0][0], _A00, _dofs[0]);
+    tabulate(*_a[0][1], _A01, dofs);
+    tabulate(*_a[1][0], _A10, dofs);
+    tabulate(*_a[1][1], A11, _dofs[1]);
+
+    const auto [n0, n1] = _ndofs;
+    const std::size_t ncells = _A00.size() / (n0 * n0);
+    const int bs1 = _bs[1];
+    const std::size_t num_dofs1 = n1 / bs1;
+    _piv.resize(ncells * n0);
+    std::vector<T> X(n0 * n1);
+    for (std::size_t c = 0; c < ncells; ++c)
+    {
+      // Factorise A00 and compute X = A00^{-1} A01
+      std::span<T> A00(_A00.data() + c * n0 * n0, n0 * n0);
+      std::span<int> piv(_piv.data() + c * n0, n0);
+      impl::lu_factor(A00, piv, n0);
+      std::copy_n(std::next(_A01.begin(), c * n0 * n1), n0 * n1, X.begin());
+      impl::lu_solve<T>(A00, piv, n0, X, n1);
+
+      // S = A11 - A10 X
+      std::span<T> S(A11.data() + c * n1 * n1, n1 * n1);
+      const T* A10 = _A10.data() + c * n1 * n0;
+      for (int i = 0; i < n1; ++i)
+        for (int k = 0; k < n0; ++k)
+          for (int j = 0; j < n1; ++j)
+            S[i * n1 + j] -= A10[i * n0 + k] * X[k * n1 + j];
+
+      std::span<const std::int32_t> dofs1(
+          _dofs[1].data() + c * num_dofs1, num_dofs1);
+      if (!bc1.empty())
+      {
+        for (std::size_t d = 0; d < num_dofs1; ++d)
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            if (bc1[bs1 * dofs1[d] + k])
+            {
+              const int row = bs1 * d + k;
+              std::fill_n(std::next(S.begin(), n1 * row), n1, 0);
+              for (int i = 0; i < n1; ++i)
+                S[i * n1 + row] = 0;
+            }
+          }
+        }
+      }
+
+      mat_add(dofs1, dofs1, S);
+    }
+  }
+
+  /// @brief Compute the condensed right-hand side `b1 - A10 A00^{-1}
+  /// b0`.
+  ///
+  /// Requires the cell data of assemble_matrix.
+  ///
+  /// @param[in] b0 Assembled vector of the space 0 linear form
+  /// (including ghost entries).
+  /// @param[in,out] b1 Assembled vector of the space 1 linear form, to
+  /// which the contributions are added. The ghost contributions must be
+  /// accumulated afterwards, as for assembled vectors.
+  void condense_vector(std::span<const T> b0, std::span<T> b1) const
+  {
+    const auto [n0, n1] = _ndofs;
+    std::vector<T> x(n0), y(n1);
+    for (std::size_t c = 0; c < num_cells(); ++c)
+    {
+      gather(0, c, b0, x);
+      impl::lu_solve<T>(std::span(_A00.data() + c * n0 * n0, n0 * n0),
+                        std::span(_piv.data() + c * n0, n0), n0, x, 1);
+      std::ranges::fill(y, 0);
+      const T* A10 = _A10.data() + c * n1 * n0;
+      for (int i = 0; i < n1; ++i)
+        for (int k = 0; k < n0; ++k)
+          y[i] -= A10[i * n0 + k] * x[k];
+      scatter(1, c, y, b1);
+    }
+  }
+
+  /// @brief Recover the condensed solution `u0 = A00^{-1} (b0 - A01
+  /// u1)`.
+  ///
+  /// Requires the cell data of assemble_matrix.
+  ///
+  /// @param[in] b0 Assembled vector of the space 0 linear form
+  /// (including ghost entries).
+  /// @param[in] u1 Solution for space 1, with up-to-date ghost values.
+  /// @param[out] u0 Solution for space 0. The entries for the dofs of
+  /// the cells are set.
+  void back_substitute(std::span<const T> b0, std::span<const T> u1,
+                       std::span<T> u0) const
+  {
+    const auto [n0, n1] = _ndofs;
+    std::vector<T> x(n0), y(n1);
+    for (std::size_t c = 0; c < num_cells(); ++c)
+    {
+      gather(0, c, b0, x);
+      gather(1, c, u1, y);
+      const T* A01 = _A01.data() + c * n0 * n1;
+      for (int i = 0; i < n0; ++i)
+        for (int j = 0; j < n1; ++j)
+          x[i] -= A01[i * n1 + j] * y[j];
+      impl::lu_solve<T>(std::span(_A00.data() + c * n0 * n0, n0 * n0),
+                        std::span(_piv.data() + c * n0, n0), n0, x, 1);
+
+      std::span<const std::int32_t> dofs0(
+          _dofs[0].data() + c * n0 / _bs[0], n0 / _bs[0]);
+      for (std::size_t d = 0; d < dofs0.size(); ++d)
+        for (int k = 0; k < _bs[0]; ++k)
+          u0[_bs[0] * dofs0[d] + k] = x[_bs[0] * d + k];
+    }
+  }
+
+  /// Number of cells with cached data
+  std::size_t num_cells() const
+  {
+    return _ndofs[0] == 0 ? 0 : _piv.size() / _ndofs[0];
+  }
+
+  /// @brief Memory used by the cached cell data.
+  /// @return Memory usage, with the cell blocks and dofs as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"StaticCondensation", sizeof(*this), {}};
+    usage.add("cell blocks", common::capacity_bytes(_A00)
+                                 + common::capacity_bytes(_A01)
+                                 + common::capacity_bytes(_A10)
+                                 + common::capacity_bytes(_piv));
+    usage.add("cell dofs", common::capacity_bytes(_dofs[0])
+                               + common::capacity_bytes(_dofs[1]));
+    return usage;
+  }
+
+private:
+  // Cells of the single cell integral of a form
+  static std::span<const std::int32_t> domain(const Form<T, U>& a)
+  {
+    return a.domain(IntegralType::cell,
+                    a.integral_ids(IntegralType::cell).front());
+  }
+
+  // Compute the element matrices of a form, in the order of the cells,
+  // and the test function dofs of each cell
+  static void tabulate(const Form<T, U>& a, std::vector<T>& Ae,
+                       std::vector<std::int32_t>& dofs)
+  {
+    Ae.clear();
+    dofs.clear();
+    auto record = [&Ae, &dofs](std::span<const std::int32_t> rows,
+                               std::span<const std::int32_t>,
+                               std::span<const T> vals)
+    {
+      Ae.insert(Ae.end(), vals.begin(), vals.end());
+      dofs.insert(dofs.end(), rows.begin(), rows.end());
+      return 0;
+    };
+    fem::assemble_matrix(record, a, std::span<const std::int8_t>(),
+                         std::span<const std::int8_t>());
+  }
+
+  // Copy the (blocked) entries of the dofs of cell c of space i
+  void gather(int i, std::size_t c, std::span<const T> u,
+              std::span<T> x) const
+  {
+    const int bs = _bs[i];
+    const std::size_t num_dofs = _ndofs[i] / bs;
+    const std::int32_t* dofs = _dofs[i].data() + c * num_dofs;
+    for (std::size_t d = 0; d < num_dofs; ++d)
+      for (int k = 0; k < bs; ++k)
+        x[bs * d + k] = u[bs * dofs[d] + k];
+  }
+
+  // Add the (blocked) entries of the dofs of cell c of space i
+  void scatter(int i, std::size_t c, std::span<const T> x,
+               std::span<T> u) const
+  {
+    const int bs = _bs[i];
+    const std::size_t num_dofs = _ndofs[i] / bs;
+    const std::int32_t* dofs = _dofs[i].data() + c * num_dofs;
+    for (std::size_t d = 0; d < num_dofs; ++d)
+      for (int k = 0; k < bs; ++k)
+        u[bs * dofs[d] + k] += x[bs * d + k];
+  }
+
+  // Block forms
+  std::array<std::array<std::shared_ptr<const Form<T, U>>, 2>, 2> _a;
+
+  // Dofmap block sizes and number of (blocked) cell dofs of the spaces
+  std::array<int, 2> _bs;
+  std::array<int, 2> _ndofs;
+
+  // Cell dofs of the spaces, shape (num_cells, num_cell_dofs)
+  std::array<std::vector<std::int32_t>, 2> _dofs;
+
+  // LU factors of the A00 cell blocks and their row interchanges
+  std::vector<T> _A00;
+  std::vector<int> _piv;
+
+  // A01 and A10 cell blocks
+  std::vector<T> _A01, _A10;
+};
+
+} // namespace dolfinx::fem
@@ -0,0 +1,433 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "CoordinateElement.h"
+#include "DofMap.h"
+#include "FiniteElement.h"
+#include "FunctionSpace.h"
+#include <algorithm>
+#include <array>
+#include <basix/finite-element.h>
+#include <basix/mdspan.hpp>
+#include <basix/quadrature.h>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::fem
+{
+namespace impl
+{
+/// @brief Contract a tensor with a matrix along one axis.
+///
+/// The tensor `in` has shape `(n[0], n[1], n[2])` and is stored with
+/// the first index running fastest. The output tensor has the same
+/// shape, except that extent `n[axis]` is replaced by `m`.
+///
+/// @param[in] A Matrix with shape `(m, n[axis])`, or shape `(n[axis],
+/// m)` if `transpose` is `true` (row-major).
+/// @param[in] transpose If `true`, contract with the transpose of `A`.
+/// @param[in] m Extent of the contracted axis in the output.
+/// @param[in] n Shape of the input tensor.
+/// @param[in] axis Axis to contract.
+/// @param[in] in Input tensor.
+/// @param[out] out Output tensor.
+template <typename T, typename S>
+void contract(std::span<const S> A, bool transpose, std::size_t m,
+              std::array<std::size_t, 3> n, int axis, std::span<const T> in,
+              std::span<T> out)
+{
+  const std::size_t na = n[axis];
+  std::size_t before = 1, after = 1;
+  for (int k = 0; k < axis; ++k)
+    before *= n[k];
+  for (int k = axis + 1; k < 3; ++k)
+    after *= n[k];
+
+  assert(in.size() == before * na * after);
+  assert(out.size() == before * m * after);
+  for (std::size_t a = 0; a < after; ++a)
+  {
+    for (std::size_t k = 0; k < m; ++k)
+    {
+      T* y = out.data() + before * (k + m * a);
+      std::fill_n(y, before, 0);
+      for (std::size_t j = 0; j < na; ++j)
+      {
+        const S c = transpose ? A[j * m + k] : A[k * na + j];
+        const T* x = in.data() + before * (j + na * a);
+        for (std::size_t b = 0; b < before; ++b)
+          y[b] += c * x[b];
+      }
+    }
+  }
+}
+} // namespace impl
+
+/// @brief Matrix-free operator for tensor-product Lagrange elements on
+/// quadrilateral and hexahedral meshes, with the operator action
+/// computed by sum factorisation.
+///
+/// The operator is the action of the bilinear form
+///
+///  \f[ a(u, v) = \int_{\Omega} \kappa \nabla u \cdot \nabla v + \mu u v
+///  \, {\rm d}x, \f]
+///
+/// with constant \f$\kappa\f$ and \f$\mu\f$. For blocked (vector)
+/// spaces the operator is applied to each component. Geometric data
+/// (the Jacobian factors at quadrature points) is computed on creation
+/// and stored for each cell, so a cell application costs
+/// \f$O(p^{d+1})\f$ operations for degree \f$p\f$ in dimension
+/// \f$d\f$, rather than \f$O(p^{2d})\f$ for an element matrix.
+///
+/// @tparam T Scalar type.
+/// @tparam U Geometry type (real).
+template <dolfinx::scalar T,
+          std::floating_point U = dolfinx::scalar_value_type_t<T>>
+class SumFactorisedOperator
+{
+public:
+  /// Scalar type
+  using value_type = T;
+
+  /// @brief Create a sum-factorised operator.
+  /// @param[in] V Function space. The element must be a (continuous
+  /// or discontinuous) Lagrange element on a quadrilateral or
+  /// hexahedral mesh.
+  /// @param[in] kappa Coefficient of the stiffness term.
+  /// @param[in] mu Coefficient of the mass term.
+  /// @param[in] qdegree Degree of the (Gauss-Jacobi) quadrature. If
+  /// negative, `2 * p` is used, where `p` is the element degree.
+  SumFactorisedOperator(std::shared_ptr<const FunctionSpace<U>> V, T kappa,
+                        T mu, int qdegree = -1)
+      : _V(V), _kappa(kappa), _mu(mu)
+  {
+    assert(V);
+    auto mesh = V->mesh();
+    assert(mesh);
+    auto topology = mesh->topology();
+    assert(topology);
+    mesh::CellType cell_type = topology->cell_type();
+    if (cell_type != mesh::CellType::quadrilateral
+        and cell_type != mesh::CellType::hexahedron)
+    {
+      throw std::runtime_error(
+          "Sum factorisation requires a quadrilateral or hexahedral mesh.");
+    }
+
+    auto element = V->element();
+    assert(element);
+    if (element->is_mixed() or element->needs_dof_transformations())
+      throw std::runtime_error("Unsupported element for sum factorisation.");
+    const basix::FiniteElement<U>& e = element->basix_element();
+    if (e.family() != basix::element::family::P)
+      throw std::runtime_error("Sum factorisation requires Lagrange element.");
+
+    _tdim = topology->dim();
+    const int degree = e.degree();
+    if (qdegree < 0)
+      qdegree = 2 * degree;
+
+    // Create 1D element and quadrature rule
+    basix::FiniteElement<U> e1 = basix::create_element<U>(
+        basix::element::family::P, basix::cell::type::interval, degree,
+        e.lagrange_variant(), basix::element::dpc_variant::unset,
+        e.discontinuous());
+    _nd = e1.dim();
+    auto [xq, wq] = basix::quadrature::make_quadrature<U>(
+        basix::quadrature::type::gauss_jacobi, basix::cell::type::interval,
+        basix::polyset::type::standard, qdegree);
+    _nq = wq.size();
+
+    // Tabulate 1D basis functions and derivatives at quadrature points
+    auto [tab, tshape] = e1.tabulate(1, xq, {_nq, 1});
+    _B.resize(_nq * _nd);
+    _D.resize(_nq * _nd);
+    for (std::size_t q = 0; q < _nq; ++q)
+    {
+      for (std::size_t i = 0; i < _nd; ++i)
+      {
+        _B[q * _nd + i] = tab[q * _nd + i];
+        _D[q * _nd + i] = tab[_nq * _nd + q * _nd + i];
+      }
+    }
+
+    // Map from tensor-product index (first index fastest) to element
+    // dof, computed by matching the dof points
+    {
+      const auto& [X, Xshape] = e.points();
+      const auto& [X1, X1shape] = e1.points();
+      std::size_t num_dofs = 1;
+      for (int k = 0; k < _tdim; ++k)
+        num_dofs *= _nd;
+      if (Xshape[0] != num_dofs)
+        throw std::runtime_error("Element is not a tensor-product element.");
+
+      _perm.assign(num_dofs, -1);
+      for (std::size_t i = 0; i < Xshape[0]; ++i)
+      {
+        std::size_t t = 0, stride = 1;
+        for (int k = 0; k < _tdim; ++k)
+        {
+          auto it = std::ranges::find_if(
+              X1, [x = X[i * Xshape[1] + k]](auto x1)
+              { return std::abs(x - x1) < 1.0e-10; });
+          if (it == X1.end())
+            throw std::runtime_error("Could not match element dof points.");
+          t += stride * std::distance(X1.begin(), it);
+          stride *= _nd;
+        }
+        _perm[t] = i;
+      }
+
+      if (std::ranges::find(_perm, -1) != _perm.end())
+        throw std::runtime_error("Could not match element dof points.");
+    }
+
+    // Tensor-product quadrature points and weights
+    std::size_t num_points = 1;
+    for (int k = 0; k < _tdim; ++k)
+      num_points *= _nq;
+    _num_points = num_points;
+    std::vector<U> X(num_points * _tdim), weights(num_points, 1);
+    for (std::size_t q = 0; q < num_points; ++q)
+    {
+      std::size_t r = q;
+      for (int k = 0; k < _tdim; ++k)
+      {
+        X[q * _tdim + k] = xq[r % _nq];
+        weights[q] *= wq[r % _nq];
+        r /= _nq;
+      }
+    }
+
+    // Compute geometric factors at quadrature points
+    const CoordinateElement<U>& cmap = mesh->geometry().cmap();
+    auto x_dofmap = mesh->geometry().dofmap();
+    std::span<const U> x_g = mesh->geometry().x();
+    const std::size_t gdim = mesh->geometry().dim();
+    const std::size_t tdim = _tdim;
+
+    std::array<std::size_t, 4> phi_shape = cmap.tabulate_shape(1, num_points);
+    std::vector<U> phi_b(std::reduce(phi_shape.begin(), phi_shape.end(), 1,
+                                     std::multiplies{}));
+    cmap.tabulate(1, X, {num_points, tdim}, phi_b);
+
+    using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+    using cmdspan4_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>;
+    cmdspan4_t phi(phi_b.data(), phi_shape);
+
+    const std::size_t num_dofs_g = cmap.dim();
+    std::vector<U> coord_dofs_b(num_dofs_g * gdim);
+    mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+    std::vector<U> J_b(gdim * tdim), K_b(tdim * gdim), det_scratch(2 * gdim
+                                                                  * tdim);
+    mdspan2_t J(J_b.data(), gdim, tdim);
+    mdspan2_t K(K_b.data(), tdim, gdim);
+
+    const std::int32_t num_cells = topology->index_map(tdim)->size_local();
+    _num_cells = num_cells;
+    const std::size_t gsize = tdim * tdim + 1;
+    _G.resize(num_cells * num_points * gsize);
+    for (std::int32_t c = 0; c < num_cells; ++c)
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
+          coord_dofs(i, j) = x_g[3 * x_dofs[i] + j];
+
+      for (std::size_t q = 0; q < num_points; ++q)
+      {
+        auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            phi, std::pair(1, tdim + 1), q,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+        std::ranges::fill(J_b, 0);
+        cmap.compute_jacobian(dphi, coord_dofs, J);
+        cmap.compute_jacobian_inverse(J, K);
+        const U scale = std::abs(cmap.compute_jacobian_determinant(
+                            J, std::span(det_scratch)))
+                        * weights[q];
+
+        // G = |det J| w K K^T, followed by the mass factor |det J| w
+        U* G = _G.data() + (c * num_points + q) * gsize;
+        for (std::size_t i = 0; i < tdim; ++i)
+        {
+          for (std::size_t j = 0; j < tdim; ++j)
+          {
+            U g = 0;
+            for (std::size_t k = 0; k < gdim; ++k)
+              g += K(i, k) * K(j, k);
+            G[i * tdim + j] = scale * g;
+          }
+        }
+        G[tdim * tdim] = scale;
+      }
+    }
+  }
+
+  /// @brief Compute the operator action `y = A x`.
+  ///
+  /// Ghost values of `x` are updated before the action is computed.
+  /// `y` is zeroed, and after the computation ghost contributions are
+  /// accumulated on the owning process.
+  ///
+  /// @param[in,out] x Vector to apply the operator to.
+  /// @param[out] y Result vector.
+  void apply(la::Vector<T>& x, la::Vector<T>& y) const
+  {
+    x.scatter_fwd();
+    std::ranges::fill(y.mutable_array(), 0);
+
+    std::shared_ptr<const DofMap> dofmap = _V->dofmap();
+    assert(dofmap);
+    auto dofs = dofmap->map();
+    const int bs = dofmap->bs();
+    std::span<const T> _x = x.array();
+    std::span<T> _y = y.mutable_array();
+
+    const std::size_t tdim = _tdim;
+    const std::size_t num_points = _num_points;
+    const std::size_t gsize = tdim * tdim + 1;
+
+    // Work arrays. Data at quadrature points is stored for the value
+    // (field 0) and the reference gradient (fields 1 to tdim).
+    const std::size_t num_dofs = _perm.size();
+    const std::size_t size = std::max(num_dofs, num_points);
+    std::vector<T> ue(num_dofs), ye(num_dofs), w0(size), w1(size);
+    std::vector<T> uq((tdim + 1) * num_points);
+
+    // Apply 1D operators (basis functions or derivatives) along each
+    // axis of the tensor in w0. The result is left in w0.
+    auto apply_1d = [&](const std::array<bool, 3>& deriv, bool transpose)
+    {
+      const std::size_t n0 = transpose ? _nq : _nd;
+      const std::size_t m = transpose ? _nd : _nq;
+      std::array<std::size_t, 3> n = {1, 1, 1};
+      std::fill_n(n.begin(), tdim, n0);
+      for (std::size_t k = 0; k < tdim; ++k)
+      {
+        const std::size_t size_in = n[0] * n[1] * n[2];
+        const std::size_t size_out = size_in / n0 * m;
+        impl::contract<T, U>(deriv[k] ? _D : _B, transpose, m, n, k,
+                             std::span<const T>(w0.data(), size_in),
+                             std::span<T>(w1.data(), size_out));
+        n[k] = m;
+        std::swap(w0, w1);
+      }
+    };
+
+    for (std::int32_t c = 0; c < _num_cells; ++c)
+    {
+      auto cell_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          dofs, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      const U* G = _G.data() + c * num_points * gsize;
+      for (int comp = 0; comp < bs; ++comp)
+      {
+        // Gather cell values in tensor-product ordering
+        for (std::size_t t = 0; t < num_dofs; ++t)
+          ue[t] = _x[bs * cell_dofs[_perm[t]] + comp];
+
+        // Interpolate values and reference gradient to quadrature points
+        for (std::size_t f = 0; f <= tdim; ++f)
+        {
+          std::array<bool, 3> deriv = {false, false, false};
+          if (f > 0)
+            deriv[f - 1] = true;
+          std::copy(ue.begin(), ue.end(), w0.begin());
+          apply_1d(deriv, false);
+          std::copy_n(w0.begin(), num_points,
+                      std::next(uq.begin(), f * num_points));
+        }
+
+        // Apply geometric factors
+        for (std::size_t q = 0; q < num_points; ++q)
+        {
+          const U* Gq = G + q * gsize;
+          std::array<T, 3> g = {0, 0, 0};
+          for (std::size_t i = 0; i < tdim; ++i)
+            for (std::size_t j = 0; j < tdim; ++j)
+              g[i] += Gq[i * tdim + j] * uq[(j + 1) * num_points + q];
+          uq[q] *= _mu * Gq[tdim * tdim];
+          for (std::size_t i = 0; i < tdim; ++i)
+            uq[(i + 1) * num_points + q] = _kappa * g[i];
+        }
+
+        // Integrate against test functions
+        std::ranges::fill(ye, 0);
+        for (std::size_t f = 0; f <= tdim; ++f)
+        {
+          std::array<bool, 3> deriv = {false, false, false};
+          if (f > 0)
+            deriv[f - 1] = true;
+          std::copy_n(std::next(uq.begin(), f * num_points), num_points,
+                      w0.begin());
+          apply_1d(deriv, true);
+          for (std::size_t t = 0; t < num_dofs; ++t)
+            ye[t] += w0[t];
+        }
+
+        // Scatter cell contribution
+        for (std::size_t t = 0; t < num_dofs; ++t)
+          _y[bs * cell_dofs[_perm[t]] + comp] += ye[t];
+      }
+    }
+
+    y.scatter_rev(std::plus<T>());
+  }
+
+  /// @brief The function space of the operator.
+  std::shared_ptr<const FunctionSpace<U>> function_space() const
+  {
+    return _V;
+  }
+
+private:
+  // Function space
+  std::shared_ptr<const FunctionSpace<U>> _V;
+
+  // Form coefficients
+  T _kappa, _mu;
+
+  // Topological dimension
+  int _tdim;
+
+  // Number of 1D basis functions and quadrature points
+  std::size_t _nd, _nq;
+
+  // Number of quadrature points and number of cells
+  std::size_t _num_points;
+  std::int32_t _num_cells;
+
+  // 1D basis functions (B) and derivatives (D) at quadrature points,
+  // shape=(_nq, _nd)
+  std::vector<U> _B, _D;
+
+  // Element dof for each tensor-product index
+  std::vector<std::int32_t> _perm;
+
+  // Geometric factors for each cell and quadrature point, shape=(num
+  // cells, num points, tdim * tdim + 1)
+  std::vector<U> _G;
+};
+
+} // namespace dolfinx::fem
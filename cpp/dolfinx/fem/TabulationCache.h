@@ -0,0 +1,171 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace dolfinx::fem::impl
+{
+/// @brief Cache of basis function tables for repeated sets of
+/// reference points.
+///
+/// Elements are often tabulated at the same points many times, e.g. at
+/// the reference origin for every call of Function::eval, or at the
+/// interpolation points for every interpolation. The tables for such
+/// points are precomputed with pin() and are never discarded. Other
+/// tables are kept in a least recently used cache, keyed by the
+/// derivative order and the points. Point sets are compared exactly,
+/// with a hash of the points as a quick check. Only small point sets
+/// are cached, so that tabulation at many arbitrary points does not
+/// fill the cache. Points that are unlikely to be repeated, e.g.
+/// physical points pulled back to the reference cell, should be
+/// tabulated without the cache.
+///
+/// The cache can be used concurrently by several threads, once all
+/// tables have been pinned.
+///
+/// @tparam T Floating point type of the points and tables.
+template <std::floating_point T>
+class TabulationCache
+{
+public:
+  /// @brief Create a cache.
+  /// @param[in] max_entries Maximum number of cached tables, excluding
+  /// pinned tables. The least recently used table is discarded when
+  /// the cache is full.
+  /// @param[in] max_points Maximum number of points of a cached table.
+  TabulationCache(std::size_t max_entries = 16, std::size_t max_points = 256)
+      : _max_entries(max_entries), _max_points(max_points)
+  {
+  }
+
+  /// @brief Tabulate a table and keep it for the lifetime of the cache.
+  /// @note Not thread-safe. Tables must be pinned before the cache is
+  /// used concurrently.
+  /// @param[in] nd Derivative order.
+  /// @param[in] X Points, with shape `shape`.
+  /// @param[in] shape Shape of `X`, `(num_points, tdim)`.
+  /// @param[in] size Size of the table.
+  /// @param[in] tabulate Function that tabulates the basis at the
+  /// points into a span of size `size`.
+  template <typename F>
+  void pin(int nd, std::span<const T> X, std::array<std::size_t, 2> shape,
+           std::size_t size, F&& tabulate)
+  {
+    std::vector<T> basis(size);
+    tabulate(std::span<T>(basis));
+    _pinned.push_back({hash(X), nd, shape, std::vector<T>(X.begin(), X.end()),
+                       std::move(basis)});
+  }
+
+  /// @brief Fill a basis array from the cache, or tabulate it and add
+  /// it to the cache.
+  /// @param[in] nd Derivative order.
+  /// @param[in] X Points, with shape `shape`.
+  /// @param[in] shape Shape of `X`, `(num_points, tdim)`.
+  /// @param[out] basis Array to fill with the table.
+  /// @param[in] tabulate Function that tabulates the basis at the
+  /// points into `basis` if the table is not cached.
+  template <typename F>
+  void tabulate(int nd, std::span<const T> X, std::array<std::size_t, 2> shape,
+                std::span<T> basis, F&& tabulate)
+  {
+    if (shape[0] > _max_points)
+    {
+      tabulate(basis);
+      return;
+    }
+
+    const std::size_t h = hash(X);
+    auto match = [&](const Entry& e)
+    {
+      return e.hash == h and e.nd == nd and e.shape == shape
+             and e.basis.size() == basis.size() and std::ranges::equal(e.X, X);
+    };
+
+    // Pinned tables are not modified, and are read without locking
+    if (auto it = std::ranges::find_if(_pinned, match); it != _pinned.end())
+    {
+      std::ranges::copy(it->basis, basis.begin());
+      return;
+    }
+
+    if (_max_entries == 0)
+    {
+      tabulate(basis);
+      return;
+    }
+
+    {
+      std::scoped_lock lock(_mutex);
+      if (auto it = std::ranges::find_if(_entries, match);
+          it != _entries.end())
+      {
+        // Move the table to the front, i.e. most recently used
+        _entries.splice(_entries.begin(), _entries, it);
+        std::ranges::copy(it->basis, basis.begin());
+        return;
+      }
+    }
+
+    tabulate(basis);
+
+    std::scoped_lock lock(_mutex);
+    if (_entries.size() == _max_entries)
+      _entries.pop_back();
+    _entries.push_front({h, nd, shape, std::vector<T>(X.begin(), X.end()),
+                         std::vector<T>(basis.begin(), basis.end())});
+  }
+
+  /// @brief Number of cached tables, excluding pinned tables.
+  std::size_t size() const
+  {
+    std::scoped_lock lock(_mutex);
+    return _entries.size();
+  }
+
+  /// @brief Number of pinned tables.
+  std::size_t num_pinned() const { return _pinned.size(); }
+
+private:
+  // Cached table
+  struct Entry
+  {
+    std::size_t hash;
+    int nd;
+    std::array<std::size_t, 2> shape;
+    std::vector<T> X;
+    std::vector<T> basis;
+  };
+
+  // Hash of the bytes of a point set
+  static std::size_t hash(std::span<const T> X)
+  {
+    return std::hash<std::string_view>{}(std::string_view(
+        reinterpret_cast<const char*>(X.data()), X.size_bytes()));
+  }
+
+  std::size_t _max_entries;
+  std::size_t _max_points;
+
+  // Precomputed tables
+  std::vector<Entry> _pinned;
+
+  // Cached tables, most recently used first
+  mutable std::mutex _mutex;
+  std::list<Entry> _entries;
+};
+} // namespace dolfinx::fem::impl
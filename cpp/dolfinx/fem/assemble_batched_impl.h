@@ -0,0 +1,100 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <basix/mdspan.hpp>
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+/// @file assemble_batched_impl.h
+/// @brief Packing of cell data for batched kernels.
+///
+/// A batched kernel is called for `N` cells at a time, with the data
+/// for each cell stored in structure-of-arrays layout: entry `i` of
+/// the data for cell (lane) `b` of a batch is stored at position `i * N
+/// + b`. This applies to the element tensor, the coefficients and the
+/// coordinate dofs. Constants are shared by all cells and are not
+/// batched.
+///
+/// If the number of cells is not a multiple of `N`, the last batch is
+/// padded by repeating the data of the last cell. The kernel output for
+/// padded lanes is ignored.
+
+namespace dolfinx::fem::impl
+{
+/// @cond
+using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+    const std::int32_t,
+    MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+/// @endcond
+
+/// @brief Pack the coordinate dofs for a batch of cells.
+/// @param[out] coordinate_dofs Packed coordinate dofs for the batch,
+/// `size=3 * x_dofmap.extent(1) * N`.
+/// @param[in] x_dofmap Dofmap for the mesh geometry.
+/// @param[in] x Mesh geometry (coordinates).
+/// @param[in] cells Cells in the batch, `size <= N`.
+/// @param[in] N Batch size.
+template <typename U>
+void pack_batch_geometry(std::span<U> coordinate_dofs, mdspan2_t x_dofmap,
+                         std::span<const U> x,
+                         std::span<const std::int32_t> cells, int N)
+{
+  assert(!cells.empty());
+  assert((int)cells.size() <= N);
+  const std::size_t num_dofs_g = x_dofmap.extent(1);
+  for (int b = 0; b < N; ++b)
+  {
+    std::int32_t c = cells[std::min<std::size_t>(b, cells.size() - 1)];
+    for (std::size_t i = 0; i < num_dofs_g; ++i)
+    {
+      const U* xi = x.data() + 3 * x_dofmap(c, i);
+      for (int k = 0; k < 3; ++k)
+        coordinate_dofs[(3 * i + k) * N + b] = xi[k];
+    }
+  }
+}
+
+/// @brief Pack the coefficients for a batch of cells.
+/// @param[out] w Packed coefficients for the batch, `size=cstride *
+/// N`.
+/// @param[in] coeffs Coefficients for the batch of cells, with shape
+/// `(num_cells, cstride)`, where `num_cells <= N`.
+/// @param[in] cstride Number of coefficient values per cell.
+/// @param[in] N Batch size.
+template <typename T>
+void pack_batch_coeffs(std::span<T> w, std::span<const T> coeffs, int cstride,
+                       int N)
+{
+  if (cstride == 0)
+    return;
+  const int num_cells = coeffs.size() / cstride;
+  assert(num_cells > 0 and num_cells <= N);
+  for (int b = 0; b < N; ++b)
+  {
+    const T* wb = coeffs.data() + std::min(b, num_cells - 1) * cstride;
+    for (int i = 0; i < cstride; ++i)
+      w[i * N + b] = wb[i];
+  }
+}
+
+/// @brief Extract the element tensor for one cell from the element
+/// tensors for a batch of cells.
+/// @param[out] Ae Element tensor for cell `b` of the batch.
+/// @param[in] Ab Element tensors for the batch, `size=Ae.size() * N`.
+/// @param[in] b Position of the cell in the batch.
+/// @param[in] N Batch size.
+template <typename T>
+void unpack_batch_tensor(std::span<T> Ae, std::span<const T> Ab, int b, int N)
+{
+  for (std::size_t i = 0; i < Ae.size(); ++i)
+    Ae[i] = Ab[i * N + b];
+}
+
+} // namespace dolfinx::fem::impl
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include "CellGroup.h"
 #include "DofMap.h"
 #include "Form.h"
 #include "FunctionSpace.h"
+#include "assemble_batched_impl.h"
+#include "assemble_threaded_impl.h"
+#include "assembly_profiling.h"
 #include "traits.h"
 #include "utils.h"
 #include <algorithm>
@@ -18,6 +22,7 @@
 #include <dolfinx/mesh/Topology.h>
 #include <functional>
 #include <iterator>
+#include <memory_resource>
 #include <span>
 #include <tuple>
 #include <vector>
@@ -57,6 +62,12 @@ using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
 /// mesh
 /// @param cell_info1 The cell permutation information for the trial function
 /// mesh
+/// @param packed_x Packed coordinate dofs of `cells` (see
+/// Form::coordinate_dofs). If empty, the coordinate dofs are gathered
+/// from `x`.
+/// @param x_compact Compact copy of the geometry (see
+/// Form::compact_coordinates). If not null and `packed_x` is empty,
+/// the coordinate dofs are gathered from `x_compact` instead of `x`.
 template <dolfinx::scalar T>
 void assemble_cells(
     la::MatSet<T> auto mat_set, mdspan2_t x_dofmap,
@@ -69,7 +80,9 @@ void assemble_cells(
     std::span<const std::int8_t> bc1, FEkernel<T> auto kernel,
     std::span<const T> coeffs, int cstride, std::span<const T> constants,
     std::span<const std::uint32_t> cell_info0,
-    std::span<const std::uint32_t> cell_info1)
+    std::span<const std::uint32_t> cell_info1,
+    std::span<const scalar_value_type_t<T>> packed_x = {},
+    const mesh::CompactCoordinates<float>* x_compact = nullptr)
 {
   if (cells.empty())
     return;
@@ -82,9 +95,10 @@ void assemble_cells(
   const int num_dofs1 = dmap1.extent(1);
   const int ndim0 = bs0 * num_dofs0;
   const int ndim1 = bs1 * num_dofs1;
-  std::vector<T> Ae(ndim0 * ndim1);
+  std::pmr::vector<T> Ae(ndim0 * ndim1);
   std::span<T> _Ae(Ae);
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
 
   // Iterate over active cells
   assert(cells0.size() == cells.size());
@@ -98,18 +112,31 @@ void assemble_cells(
     std::int32_t c1 = cells1[index];
 
     // Get cell coordinates/geometry
-    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    const scalar_value_type_t<T>* cdofs = coordinate_dofs.data();
+    if (!packed_x.empty())
+      cdofs = packed_x.data() + index * coordinate_dofs.size();
+    else if (x_compact)
     {
-      std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
+      const std::size_t num_dofs_g = x_dofmap.extent(1);
+      x_compact->gather(
+          std::span(x_dofmap.data_handle() + c * num_dofs_g, num_dofs_g),
+          std::span(coordinate_dofs));
+    }
+    else
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
     }
 
     // Tabulate tensor
     std::ranges::fill(Ae, 0);
     kernel(Ae.data(), coeffs.data() + index * cstride, constants.data(),
-           coordinate_dofs.data(), nullptr, nullptr);
+           cdofs, nullptr, nullptr);
 
     // Compute A = P_0 \tilde{A} P_1^T (dof transformation)
     P0(_Ae, cell_info0, c0, ndim1);  // B = P0 \tilde{A}
@@ -156,6 +183,113 @@ void assemble_cells(
   }
 }
 
+/// @brief Execute a batched kernel over cells and accumulate result in
+/// matrix.
+///
+/// The kernel is called for batches of `batch_size` cells, with data
+/// packed as described in assemble_batched_impl.h. The element tensor
+/// of each cell is then transformed, has boundary conditions applied
+/// and is inserted as in assemble_cells.
+///
+/// @param batch_size Number of cells computed by one call of `kernel`.
+/// @note See assemble_cells for a description of the other arguments.
+template <dolfinx::scalar T>
+void assemble_cells_batched(
+    la::MatSet<T> auto mat_set, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x,
+    std::span<const std::int32_t> cells,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap0,
+    fem::DofTransformKernel<T> auto P0,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap1,
+    fem::DofTransformKernel<T> auto P1T, std::span<const std::int8_t> bc0,
+    std::span<const std::int8_t> bc1, FEkernel<T> auto kernel, int batch_size,
+    std::span<const T> coeffs, int cstride, std::span<const T> constants,
+    std::span<const std::uint32_t> cell_info0,
+    std::span<const std::uint32_t> cell_info1)
+{
+  if (cells.empty())
+    return;
+
+  const auto [dmap0, bs0, cells0] = dofmap0;
+  const auto [dmap1, bs1, cells1] = dofmap1;
+
+  const int N = batch_size;
+  const int num_dofs0 = dmap0.extent(1);
+  const int num_dofs1 = dmap1.extent(1);
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  std::pmr::vector<T> Ab(ndim0 * ndim1 * N), wb(cstride * N),
+      Ae(ndim0 * ndim1);
+  std::span<T> _Ae(Ae);
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1) * N);
+
+  // Iterate over batches of active cells
+  assert(cells0.size() == cells.size());
+  assert(cells1.size() == cells.size());
+  for (std::size_t index0 = 0; index0 < cells.size(); index0 += N)
+  {
+    const std::size_t num = std::min<std::size_t>(N, cells.size() - index0);
+
+    // Pack batch data and tabulate tensors
+    pack_batch_geometry(std::span(coordinate_dofs), x_dofmap, x,
+                        cells.subspan(index0, num), N);
+    pack_batch_coeffs(std::span(wb), coeffs.subspan(index0 * cstride,
+                                                    num * cstride),
+                      cstride, N);
+    std::ranges::fill(Ab, 0);
+    kernel(Ab.data(), wb.data(), constants.data(), coordinate_dofs.data(),
+           nullptr, nullptr);
+
+    for (std::size_t b = 0; b < num; ++b)
+    {
+      std::int32_t c0 = cells0[index0 + b];
+      std::int32_t c1 = cells1[index0 + b];
+      unpack_batch_tensor(_Ae, std::span<const T>(Ab), b, N);
+
+      // Compute A = P_0 \tilde{A} P_1^T (dof transformation)
+      P0(_Ae, cell_info0, c0, ndim1);  // B = P0 \tilde{A}
+      P1T(_Ae, cell_info1, c1, ndim0); // A =  B P1_T
+
+      // Zero rows/columns for essential bcs
+      auto dofs0 = std::span(dmap0.data_handle() + c0 * num_dofs0, num_dofs0);
+      auto dofs1 = std::span(dmap1.data_handle() + c1 * num_dofs1, num_dofs1);
+      if (!bc0.empty())
+      {
+        for (int i = 0; i < num_dofs0; ++i)
+        {
+          for (int k = 0; k < bs0; ++k)
+          {
+            if (bc0[bs0 * dofs0[i] + k])
+            {
+              const int row = bs0 * i + k;
+              std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0);
+            }
+          }
+        }
+      }
+
+      if (!bc1.empty())
+      {
+        for (int j = 0; j < num_dofs1; ++j)
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            if (bc1[bs1 * dofs1[j] + k])
+            {
+              const int col = bs1 * j + k;
+              for (int row = 0; row < ndim0; ++row)
+                Ae[row * ndim1 + col] = 0;
+            }
+          }
+        }
+      }
+
+      mat_set(dofs0, dofs1, Ae);
+    }
+  }
+}
+
 /// @brief Execute kernel over exterior facets and accumulate result in
 /// a matrix.
 /// @tparam T Matrix/form scalar type.
@@ -213,12 +347,13 @@ void assemble_exterior_facets(
   const auto [dmap1, bs1, facets1] = dofmap1;
 
   // Data structures used in assembly
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
   const int num_dofs0 = dmap0.extent(1);
   const int num_dofs1 = dmap1.extent(1);
   const int ndim0 = bs0 * num_dofs0;
   const int ndim1 = bs1 * num_dofs1;
-  std::vector<T> Ae(ndim0 * ndim1);
+  std::pmr::vector<T> Ae(ndim0 * ndim1);
   std::span<T> _Ae(Ae);
   assert(facets.size() % 2 == 0);
   assert(facets0.size() == facets.size());
@@ -330,6 +465,15 @@ void assemble_exterior_facets(
 /// function mesh.
 /// @param[in] perms Facet permutation integer. Empty if facet
 /// permutations are not required.
+/// @param[in] joint_dofs0 Joined test function dofs of the two cells of
+/// each facet in `facets` (see Form::facet_pairs). If empty, the dofs
+/// are joined during assembly.
+/// @param[in] joint_dofs1 Joined trial function dofs of the two cells
+/// of each facet in `facets`. If empty, the dofs are joined during
+/// assembly.
+/// @param[in] facet_perms Permutations of each facet in `facets`
+/// relative to its two cells. If empty, the permutations are read from
+/// `perms`.
 template <dolfinx::scalar T>
 void assemble_interior_facets(
     la::MatSet<T> auto mat_set, mdspan2_t x_dofmap,
@@ -343,27 +487,35 @@ void assemble_interior_facets(
     std::span<const T> coeffs, int cstride, std::span<const int> offsets,
     std::span<const T> constants, std::span<const std::uint32_t> cell_info0,
     std::span<const std::uint32_t> cell_info1,
-    std::span<const std::uint8_t> perms)
+    std::span<const std::uint8_t> perms,
+    std::span<const std::int32_t> joint_dofs0 = {},
+    std::span<const std::int32_t> joint_dofs1 = {},
+    std::span<const std::uint8_t> facet_perms = {})
 {
   if (facets.empty())
     return;
 
   const auto [dmap0, bs0, facets0] = dofmap0;
   const auto [dmap1, bs1, facets1] = dofmap1;
+  assert(facet_perms.empty() or facet_perms.size() == facets.size() / 2);
 
   // Data structures used in assembly
   using X = scalar_value_type_t<T>;
-  std::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
+  std::pmr::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
   std::span<X> cdofs0(coordinate_dofs.data(), x_dofmap.extent(1) * 3);
   std::span<X> cdofs1(coordinate_dofs.data() + x_dofmap.extent(1) * 3,
                       x_dofmap.extent(1) * 3);
 
-  std::vector<T> Ae, be;
-  std::vector<T> coeff_array(2 * offsets.back());
+  std::pmr::vector<T> Ae, be;
+  std::pmr::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
 
+  // Number of dofs of a cell
+  const std::size_t num_dofs0 = dmap0.map().extent(1);
+  const std::size_t num_dofs1 = dmap1.map().extent(1);
+
   // Temporaries for joint dofmaps
-  std::vector<std::int32_t> dmapjoint0, dmapjoint1;
+  std::vector<std::int32_t> _dmapjoint0, _dmapjoint1;
   assert(facets.size() % 4 == 0);
   assert(facets0.size() == facets.size());
   assert(facets1.size() == facets.size());
@@ -394,20 +546,33 @@ void assemble_interior_facets(
                   std::next(cdofs1.begin(), 3 * i));
     }
 
-    // Get dof maps for cells and pack
-    std::span<const std::int32_t> dmap0_cell0 = dmap0.cell_dofs(cells0[0]);
-    std::span<const std::int32_t> dmap0_cell1 = dmap0.cell_dofs(cells0[1]);
-    dmapjoint0.resize(dmap0_cell0.size() + dmap0_cell1.size());
-    std::ranges::copy(dmap0_cell0, dmapjoint0.begin());
-    std::ranges::copy(dmap0_cell1,
-                      std::next(dmapjoint0.begin(), dmap0_cell0.size()));
-
-    std::span<const std::int32_t> dmap1_cell0 = dmap1.cell_dofs(cells1[0]);
-    std::span<const std::int32_t> dmap1_cell1 = dmap1.cell_dofs(cells1[1]);
-    dmapjoint1.resize(dmap1_cell0.size() + dmap1_cell1.size());
-    std::ranges::copy(dmap1_cell0, dmapjoint1.begin());
-    std::ranges::copy(dmap1_cell1,
-                      std::next(dmapjoint1.begin(), dmap1_cell0.size()));
+    // Get dof maps for cells, packed if not precomputed
+    std::span<const std::int32_t> dmapjoint0, dmapjoint1;
+    if (!joint_dofs0.empty())
+      dmapjoint0 = joint_dofs0.subspan(index / 2 * num_dofs0, 2 * num_dofs0);
+    else
+    {
+      std::span<const std::int32_t> dmap0_cell0 = dmap0.cell_dofs(cells0[0]);
+      std::span<const std::int32_t> dmap0_cell1 = dmap0.cell_dofs(cells0[1]);
+      _dmapjoint0.resize(2 * num_dofs0);
+      std::ranges::copy(dmap0_cell0, _dmapjoint0.begin());
+      std::ranges::copy(dmap0_cell1,
+                        std::next(_dmapjoint0.begin(), num_dofs0));
+      dmapjoint0 = _dmapjoint0;
+    }
+
+    if (!joint_dofs1.empty())
+      dmapjoint1 = joint_dofs1.subspan(index / 2 * num_dofs1, 2 * num_dofs1);
+    else
+    {
+      std::span<const std::int32_t> dmap1_cell0 = dmap1.cell_dofs(cells1[0]);
+      std::span<const std::int32_t> dmap1_cell1 = dmap1.cell_dofs(cells1[1]);
+      _dmapjoint1.resize(2 * num_dofs1);
+      std::ranges::copy(dmap1_cell0, _dmapjoint1.begin());
+      std::ranges::copy(dmap1_cell1,
+                        std::next(_dmapjoint1.begin(), num_dofs1));
+      dmapjoint1 = _dmapjoint1;
+    }
 
     const int num_rows = bs0 * dmapjoint0.size();
     const int num_cols = bs1 * dmapjoint1.size();
@@ -416,12 +581,14 @@ void assemble_interior_facets(
     Ae.resize(num_rows * num_cols);
     std::ranges::fill(Ae, 0);
 
-    std::array perm
-        = perms.empty()
-              ? std::array<std::uint8_t, 2>{0, 0}
-              : std::array{
-                    perms[cells[0] * num_facets_per_cell + local_facet[0]],
-                    perms[cells[1] * num_facets_per_cell + local_facet[1]]};
+    std::array<std::uint8_t, 2> perm = {0, 0};
+    if (!facet_perms.empty())
+      perm = {facet_perms[index / 2], facet_perms[index / 2 + 1]};
+    else if (!perms.empty())
+    {
+      perm = {perms[cells[0] * num_facets_per_cell + local_facet[0]],
+              perms[cells[1] * num_facets_per_cell + local_facet[1]]};
+    }
     kernel(Ae.data(), coeffs.data() + index / 2 * cstride, constants.data(),
            coordinate_dofs.data(), local_facet.data(), perm.data());
 
@@ -433,8 +600,8 @@ void assemble_interior_facets(
     // where each block is element tensor of size (dmap0, dmap1).
 
     std::span<T> _Ae(Ae);
-    std::span<T> sub_Ae0 = _Ae.subspan(bs0 * dmap0_cell0.size() * num_cols,
-                                       bs0 * dmap0_cell1.size() * num_cols);
+    std::span<T> sub_Ae0
+        = _Ae.subspan(bs0 * num_dofs0 * num_cols, bs0 * num_dofs0 * num_cols);
 
     P0(_Ae, cell_info0, cells0[0], num_cols);
     P0(sub_Ae0, cell_info0, cells0[1], num_cols);
@@ -444,8 +611,8 @@ void assemble_interior_facets(
     {
       // DOFs for dmap1 and cell1 are not stored contiguously in
       // the block matrix, so each row needs a separate span access
-      std::span<T> sub_Ae1 = _Ae.subspan(
-          row * num_cols + bs1 * dmap1_cell0.size(), bs1 * dmap1_cell1.size());
+      std::span<T> sub_Ae1
+          = _Ae.subspan(row * num_cols + bs1 * num_dofs1, bs1 * num_dofs1);
       P1T(sub_Ae1, cell_info1, cells1[1], 1);
     }
 
@@ -485,18 +652,30 @@ void assemble_interior_facets(
   }
 }
 
-/// The matrix A must already be initialised. The matrix may be a proxy,
-/// i.e. a view into a larger matrix, and assembly is performed using
-/// local indices. Rows (bc0) and columns (bc1) with Dirichlet
-/// conditions are zeroed. Markers (bc0 and bc1) can be empty if no bcs
-/// are applied. Matrix is not finalised.
-template <dolfinx::scalar T, std::floating_point U>
-void assemble_matrix(
+/// @brief Assemble bilinear form into a matrix, with the execution of
+/// each integral delegated to a function.
+///
+/// For each integral, `execute(type, id, dofmap0, entities, coeffs,
+/// assemble)` is called, where `dofmap0` is the test function dofmap,
+/// `entities` holds the integration entities in the integration domain
+/// mesh, the test function mesh and the trial function mesh, and
+/// `coeffs` are the packed coefficients. The function `assemble(e, c)`
+/// assembles the entities `e` (with the layout of `entities`) with
+/// packed coefficients `c`.
+///
+/// If `fuse` is true, the facet integrals of each group of
+/// Form::integral_groups are executed together (see
+/// assemble_vector_integrals).
+///
+/// @note See assemble_matrix for a description of the other arguments.
+template <dolfinx::scalar T, std::floating_point U, typename E>
+void assemble_matrix_integrals(
     la::MatSet<T> auto mat_set, const Form<T, U>& a, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
     const std::map<std::pair<IntegralType, int>,
                    std::pair<std::span<const T>, int>>& coefficients,
-    std::span<const std::int8_t> bc0, std::span<const std::int8_t> bc1)
+    std::span<const std::int8_t> bc0, std::span<const std::int8_t> bc1,
+    E execute, bool fuse = false)
 {
   // Integration domain mesh
   std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
@@ -524,12 +703,6 @@ void assemble_matrix(
   assert(element0);
   auto element1 = a.function_spaces().at(1)->element();
   assert(element1);
-  fem::DofTransformKernel<T> auto P0
-      = element0->template dof_transformation_fn<T>(doftransform::standard);
-  fem::DofTransformKernel<T> auto P1T
-      = element1->template dof_transformation_right_fn<T>(
-          doftransform::transpose);
-
   std::span<const std::uint32_t> cell_info0;
   std::span<const std::uint32_t> cell_info1;
   if (element0->needs_dof_transformations()
@@ -541,16 +714,74 @@ void assemble_matrix(
     cell_info1 = std::span(mesh1->topology()->get_cell_permutation_info());
   }
 
+  fem::DofTransformKernel<T> auto P0
+      = element0->template precomputed_dof_transformation_fn<T>(
+          doftransform::standard, cell_info0);
+  fem::DofTransformKernel<T> auto P1T
+      = element1->template precomputed_dof_transformation_right_fn<T>(
+          doftransform::transpose, cell_info1);
+
   for (int i : a.integral_ids(IntegralType::cell))
   {
     auto fn = a.kernel(IntegralType::cell, i);
     assert(fn);
     auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
-    impl::assemble_cells(
-        mat_set, x_dofmap, x, a.domain(IntegralType::cell, i),
-        {dofs0, bs0, a.domain(IntegralType::cell, i, *mesh0)}, P0,
-        {dofs1, bs1, a.domain(IntegralType::cell, i, *mesh1)}, P1T, bc0, bc1,
-        fn, coeffs, cstride, constants, cell_info0, cell_info1);
+    std::span<const std::int32_t> cells = a.domain(IntegralType::cell, i);
+    std::span<const std::int32_t> cells0
+        = a.domain(IntegralType::cell, i, *mesh0);
+    std::span<const std::int32_t> cells1
+        = a.domain(IntegralType::cell, i, *mesh1);
+    auto batch = a.batch_kernel(IntegralType::cell, i);
+
+    // Cached coordinate dofs are ordered as the (unpermuted) cells
+    std::span<const U> packed_x;
+    const mesh::CompactCoordinates<float>* x_compact = nullptr;
+    if (x.data() == mesh->geometry().x().data())
+    {
+      packed_x = a.coordinate_dofs(i);
+      x_compact = a.compact_coordinates();
+    }
+
+    KernelCost cost = impl::kernel_cost<T, U>(
+        a.kernel_flops(IntegralType::cell, i), 1,
+        {{dofs0.extent(1), bs0}, {dofs1.extent(1), bs1}}, cstride,
+        x_dofmap.extent(1));
+    if (batch.first)
+      cost = {batch.second * cost.flops, batch.second * cost.bytes};
+    impl::profile_integral(
+        "matrix", "cell", i, cost,
+        [&](auto kernel, auto transformation, auto insertion)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 3> e,
+                              std::span<const T> c)
+          {
+            if (batch.first)
+            {
+              impl::assemble_cells_batched(
+                  insertion(mat_set), x_dofmap, x, e[0], {dofs0, bs0, e[1]},
+                  transformation(P0), {dofs1, bs1, e[2]},
+                  transformation(P1T), bc0, bc1, kernel(batch.first),
+                  batch.second, c, cstride, constants, cell_info0,
+                  cell_info1);
+            }
+            else
+            {
+              impl::assemble_cells(
+                  insertion(mat_set), x_dofmap, x, e[0], {dofs0, bs0, e[1]},
+                  transformation(P0), {dofs1, bs1, e[2]},
+                  transformation(P1T), bc0, bc1, kernel(fn), c, cstride,
+                  constants, cell_info0, cell_info1,
+                  e[0].data() == cells.data() ? packed_x
+                                              : std::span<const U>(),
+                  x_compact);
+            }
+          };
+
+          execute(IntegralType::cell, i, dofs0,
+                  std::array<std::span<const std::int32_t>, 3>{cells, cells0,
+                                                               cells1},
+                  coeffs, assemble);
+        });
   }
 
   std::span<const std::uint8_t> perms;
@@ -563,35 +794,326 @@ void assemble_matrix(
   mesh::CellType cell_type = mesh->topology()->cell_type();
   int num_facets_per_cell
       = mesh::cell_num_entities(cell_type, mesh->topology()->dim() - 1);
-  for (int i : a.integral_ids(IntegralType::exterior_facet))
+
+  // Storage for the concatenated coefficients of groups of integrals
+  std::vector<T> group_coeffs;
+  auto exterior_facets = [&](const integral_group& g)
   {
+    const int i = g.ids.front();
     auto fn = a.kernel(IntegralType::exterior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
-        = coefficients.at({IntegralType::exterior_facet, i});
-    impl::assemble_exterior_facets(
-        mat_set, x_dofmap, x, num_facets_per_cell,
-        a.domain(IntegralType::exterior_facet, i),
-        {dofs0, bs0, a.domain(IntegralType::exterior_facet, i, *mesh0)}, P0,
-        {dofs1, bs1, a.domain(IntegralType::exterior_facet, i, *mesh1)}, P1T,
-        bc0, bc1, fn, coeffs, cstride, constants, cell_info0, cell_info1,
-        perms);
-  }
+    auto [coeffs, cstride] = group_coefficients(
+        IntegralType::exterior_facet, g, coefficients, group_coeffs);
+    std::span<const std::int32_t> facets
+        = a.domain(IntegralType::exterior_facet, g);
+    std::span<const std::int32_t> facets0
+        = a.domain(IntegralType::exterior_facet, g, *mesh0);
+    std::span<const std::int32_t> facets1
+        = a.domain(IntegralType::exterior_facet, g, *mesh1);
+    KernelCost cost = impl::kernel_cost<T, U>(
+        a.kernel_flops(IntegralType::exterior_facet, i), 1,
+        {{dofs0.extent(1), bs0}, {dofs1.extent(1), bs1}}, cstride,
+        x_dofmap.extent(1));
+    impl::profile_integral(
+        "matrix", "exterior facet", i, cost,
+        [&](auto kernel, auto transformation, auto insertion)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 3> e,
+                              std::span<const T> c)
+          {
+            impl::assemble_exterior_facets(
+                insertion(mat_set), x_dofmap, x, num_facets_per_cell, e[0],
+                {dofs0, bs0, e[1]}, transformation(P0), {dofs1, bs1, e[2]},
+                transformation(P1T), bc0, bc1, kernel(fn), c, cstride,
+                constants, cell_info0, cell_info1, perms);
+          };
+
+          execute(IntegralType::exterior_facet, i, dofs0,
+                  std::array<std::span<const std::int32_t>, 3>{
+                      facets, facets0, facets1},
+                  coeffs, assemble);
+        });
+  };
+  for_each_integral_group(a, IntegralType::exterior_facet, fuse,
+                          exterior_facets);
 
-  for (int i : a.integral_ids(IntegralType::interior_facet))
+  const std::vector<int> c_offsets = a.coefficient_offsets();
+  auto interior_facets = [&](const integral_group& g)
   {
-    const std::vector<int> c_offsets = a.coefficient_offsets();
+    const int i = g.ids.front();
     auto fn = a.kernel(IntegralType::interior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
-        = coefficients.at({IntegralType::interior_facet, i});
-    impl::assemble_interior_facets(
-        mat_set, x_dofmap, x, num_facets_per_cell,
-        a.domain(IntegralType::interior_facet, i),
-        {*dofmap0, bs0, a.domain(IntegralType::interior_facet, i, *mesh0)}, P0,
-        {*dofmap1, bs1, a.domain(IntegralType::interior_facet, i, *mesh1)}, P1T,
-        bc0, bc1, fn, coeffs, cstride, c_offsets, constants, cell_info0,
-        cell_info1, perms);
+    auto [coeffs, cstride] = group_coefficients(
+        IntegralType::interior_facet, g, coefficients, group_coeffs);
+    std::span<const std::int32_t> facets
+        = a.domain(IntegralType::interior_facet, g);
+    std::span<const std::int32_t> facets0
+        = a.domain(IntegralType::interior_facet, g, *mesh0);
+    std::span<const std::int32_t> facets1
+        = a.domain(IntegralType::interior_facet, g, *mesh1);
+
+    // Cached facet data is ordered as the (unpermuted) facets
+    const facet_pair_data* pairs = a.facet_pairs(g);
+    const std::vector<std::int32_t> no_dofs;
+    const std::vector<std::uint8_t> no_perms;
+    KernelCost cost = impl::kernel_cost<T, U>(
+        a.kernel_flops(IntegralType::interior_facet, i), 2,
+        {{dofs0.extent(1), bs0}, {dofs1.extent(1), bs1}}, cstride,
+        x_dofmap.extent(1));
+    impl::profile_integral(
+        "matrix", "interior facet", i, cost,
+        [&](auto kernel, auto transformation, auto insertion)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 3> e,
+                              std::span<const T> c)
+          {
+            const bool cached = pairs and e[0].data() == facets.data();
+            impl::assemble_interior_facets(
+                insertion(mat_set), x_dofmap, x, num_facets_per_cell, e[0],
+                {*dofmap0, bs0, e[1]}, transformation(P0),
+                {*dofmap1, bs1, e[2]}, transformation(P1T), bc0, bc1,
+                kernel(fn), c, cstride, c_offsets, constants, cell_info0,
+                cell_info1, perms, cached ? pairs->dofs[0] : no_dofs,
+                cached ? pairs->dofs[1] : no_dofs,
+                cached ? pairs->perms : no_perms);
+          };
+
+          execute(IntegralType::interior_facet, i, dofs0,
+                  std::array<std::span<const std::int32_t>, 3>{
+                      facets, facets0, facets1},
+                  coeffs, assemble);
+        });
+  };
+  for_each_integral_group(a, IntegralType::interior_facet, fuse,
+                          interior_facets);
+}
+
+/// The matrix A must already be initialised. The matrix may be a proxy,
+/// i.e. a view into a larger matrix, and assembly is performed using
+/// local indices. Rows (bc0) and columns (bc1) with Dirichlet
+/// conditions are zeroed. Markers (bc0 and bc1) can be empty if no bcs
+/// are applied. Matrix is not finalised.
+///
+/// If `num_threads` is greater than one, the integration entities are
+/// coloured and entities of the same colour are assembled concurrently
+/// (see impl::assemble_threaded). In this case `mat_set` must support
+/// concurrent calls that insert into different rows.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_matrix(
+    la::MatSet<T> auto mat_set, const Form<T, U>& a, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    std::span<const std::int8_t> bc0, std::span<const std::int8_t> bc1,
+    int num_threads = 1)
+{
+  assemble_matrix_integrals(
+      mat_set, a, x_dofmap, x, constants, coefficients, bc0, bc1,
+      [&a, num_threads](
+          IntegralType type, int id, mdspan2_t dofmap0,
+          std::array<std::span<const std::int32_t>, 3> entities,
+          std::span<const T> coeffs, auto&& assemble)
+      {
+        if (num_threads > 1)
+        {
+          // The colouring is cached on the form
+          const graph::AdjacencyList<std::int32_t>& colours
+              = a.entity_colouring(
+                  type, id, entities[1].size() / entity_stride(type),
+                  [&]()
+                  { return colour_entities(dofmap0, entities[1], type); });
+          impl::assemble_threaded<T, 3>(type, colours, entities, coeffs,
+                                        num_threads, assemble);
+        }
+        else
+          assemble(entities, coeffs);
+      },
+      true);
+}
+
+/// @brief Assemble a subset of the entities of each integral of a
+/// bilinear form into a matrix.
+///
+/// @param[in] partition Partition of the entities computed by
+/// interface_partition, e.g. for a linear form with the same test space
+/// and integration domains as `a`.
+/// @param[in] interface If `true` assemble the entities that contribute
+/// to ghost rows, otherwise assemble the remaining entities.
+/// @note See assemble_matrix for a description of the other arguments.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_matrix(
+    la::MatSet<T> auto mat_set, const Form<T, U>& a, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    std::span<const std::int8_t> bc0, std::span<const std::int8_t> bc1,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::vector<std::int32_t>, std::int32_t>>&
+        partition,
+    bool interface)
+{
+  assemble_matrix_integrals(
+      mat_set, a, x_dofmap, x, constants, coefficients, bc0, bc1,
+      [&partition, interface](
+          IntegralType type, int id, mdspan2_t,
+          std::array<std::span<const std::int32_t>, 3> entities,
+          std::span<const T> coeffs, auto&& assemble)
+      {
+        const int stride = entity_stride(type);
+        auto& [perm, num_interface] = partition.at({type, id});
+        if (perm.size() * stride != entities[0].size())
+          throw std::runtime_error("Partition does not match form domain.");
+        std::span<const std::int32_t> pos(perm);
+        pos = interface ? pos.first(num_interface) : pos.subspan(num_interface);
+        if (pos.empty())
+          return;
+
+        const std::size_t cstride = coeffs.size() / perm.size();
+        std::array<std::vector<std::int32_t>, 3> e;
+        for (std::size_t k = 0; k < 3; ++k)
+          e[k] = gather_rows(entities[k], stride, pos);
+        std::vector<T> c = gather_rows(coeffs, cstride, pos);
+        assemble({e[0], e[1], e[2]}, c);
+      });
+}
+
+/// @brief Assemble the integration entities of a bilinear form that
+/// are attached to a subset of cells into a matrix.
+///
+/// For each integral, the integration entities with at least one
+/// attached cell in `cells` are assembled. The coefficients are packed
+/// for these entities only. Element tensors are scaled by `scale`
+/// before insertion, which allows the contribution of the cells to be
+/// removed (`scale=-1`) before their data is modified and added
+/// (`scale=1`) afterwards.
+///
+/// @param[in] mat_set Function for adding values into the matrix.
+/// @param[in] a The bilinear form.
+/// @param[in] x_dofmap Mesh geometry dofmap.
+/// @param[in] x Mesh coordinates.
+/// @param[in] constants Packed constants that appear in `a`.
+/// @param[in] cells Cells (local indices in the integration domain
+/// mesh) to assemble over.
+/// @param[in] scale Scaling applied to the element tensors.
+/// @param[in] bc0 Marker for rows with Dirichlet boundary conditions.
+/// @param[in] bc1 Marker for columns with Dirichlet boundary
+/// conditions.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_matrix_subset(la::MatSet<T> auto mat_set, const Form<T, U>& a,
+                            mdspan2_t x_dofmap,
+                            std::span<const scalar_value_type_t<T>> x,
+                            std::span<const T> constants,
+                            std::span<const std::int32_t> cells, T scale,
+                            std::span<const std::int8_t> bc0,
+                            std::span<const std::int8_t> bc1)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+  auto cell_map = mesh->topology()->index_map(mesh->topology()->dim());
+  assert(cell_map);
+  std::vector<std::int8_t> marker(
+      cell_map->size_local() + cell_map->num_ghosts(), false);
+  for (std::int32_t c : cells)
+    marker[c] = true;
+
+  // Coefficients are packed by the executor for the selected entities
+  // only
+  const int cstride
+      = a.coefficients().empty() ? 0 : a.coefficient_offsets().back();
+  std::map<std::pair<IntegralType, int>, std::pair<std::span<const T>, int>>
+      coefficients;
+  for (IntegralType type : a.integral_types())
+    for (int i : a.integral_ids(type))
+      coefficients.insert({{type, i}, {std::span<const T>(), cstride}});
+
+  std::pmr::vector<T> Ae;
+  auto mat_set_scaled
+      = [&mat_set, &Ae, scale](std::span<const std::int32_t> rows,
+                               std::span<const std::int32_t> cols,
+                               std::span<const T> data)
+  {
+    Ae.resize(data.size());
+    std::ranges::transform(data, Ae.begin(),
+                           [scale](auto v) { return scale * v; });
+    return mat_set(rows, cols, std::span<const T>(Ae));
+  };
+
+  assemble_matrix_integrals(
+      mat_set_scaled, a, x_dofmap, x, constants, coefficients, bc0, bc1,
+      [&a, &marker, cstride](
+          IntegralType type, int id, mdspan2_t,
+          std::array<std::span<const std::int32_t>, 3> entities,
+          std::span<const T>, auto&& assemble)
+      {
+        const int stride = entity_stride(type);
+        const int num_cells = type == IntegralType::interior_facet ? 2 : 1;
+        std::vector<std::int32_t> pos;
+        for (std::size_t e = 0; e < entities[0].size() / stride; ++e)
+        {
+          for (int k = 0; k < num_cells; ++k)
+          {
+            if (marker[entities[0][e * stride + 2 * k]])
+            {
+              pos.push_back(e);
+              break;
+            }
+          }
+        }
+
+        if (pos.empty())
+          return;
+
+        std::array<std::vector<std::int32_t>, 3> e;
+        for (std::size_t k = 0; k < 3; ++k)
+          e[k] = gather_rows(entities[k], stride, pos);
+        std::vector<T> c(pos.size() * num_cells * cstride);
+        fem::pack_coefficients(a, type, id, pos, std::span(c), cstride);
+        assemble({e[0], e[1], e[2]}, c);
+      });
+}
+
+/// @brief Assemble a bilinear form over groups of cells of the same
+/// cell type into a matrix.
+///
+/// One loop is executed for each group. The kernels must not require
+/// dof transformations.
+///
+/// @param[in] mat_set The function for adding values into the matrix.
+/// @param[in] groups Cell groups, e.g. one for each cell type of a
+/// mixed-topology mesh (see create_cell_groups).
+/// @param[in] x Mesh geometry (coordinates).
+/// @param[in] constants The constant data.
+/// @param[in] bc0 Marker for rows with Dirichlet boundary conditions
+/// applied.
+/// @param[in] bc1 Marker for columns with Dirichlet boundary conditions
+/// applied.
+template <dolfinx::scalar T>
+void assemble_matrix(la::MatSet<T> auto mat_set,
+                     const std::vector<CellGroup<T>>& groups,
+                     std::span<const scalar_value_type_t<T>> x,
+                     std::span<const T> constants,
+                     std::span<const std::int8_t> bc0,
+                     std::span<const std::int8_t> bc1)
+{
+  auto P = [](std::span<T>, std::span<const std::uint32_t>, std::int32_t,
+              int) {};
+  for (const CellGroup<T>& g : groups)
+  {
+    std::span<const std::int32_t> cells(g.cells);
+    if (g.batch_kernel)
+    {
+      impl::assemble_cells_batched(
+          mat_set, g.x_dofmap, x, cells, {g.dofmaps[0], g.bs[0], cells}, P,
+          {g.dofmaps[1], g.bs[1], cells}, P, bc0, bc1, g.batch_kernel,
+          g.batch_size, g.coeffs, g.cstride, constants, {}, {});
+    }
+    else
+    {
+      impl::assemble_cells(mat_set, g.x_dofmap, x, cells,
+                           {g.dofmaps[0], g.bs[0], cells}, P,
+                           {g.dofmaps[1], g.bs[1], cells}, P, bc0, bc1,
+                           g.kernel, g.coeffs, g.cstride, constants, {}, {});
+    }
   }
 }
 
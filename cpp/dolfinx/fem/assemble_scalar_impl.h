@@ -9,31 +9,44 @@
 #include "Constant.h"
 #include "Form.h"
 #include "FunctionSpace.h"
+#include "assemble_batched_impl.h"
+#include "assembly_profiling.h"
 #include "utils.h"
 #include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <vector>
 
 namespace dolfinx::fem::impl
 {
 
-/// Assemble functional over cells
+/// Assemble functional over cells. If `packed_x` is not empty it holds
+/// the packed coordinate dofs of `cells` (see Form::coordinate_dofs),
+/// which are used instead of gathering the coordinate dofs from `x`.
+/// Otherwise, if `x_compact` is not null, the coordinate dofs are
+/// gathered from the compact geometry (see Form::compact_coordinates).
 template <dolfinx::scalar T>
 T assemble_cells(mdspan2_t x_dofmap, std::span<const scalar_value_type_t<T>> x,
                  std::span<const std::int32_t> cells, FEkernel<T> auto fn,
                  std::span<const T> constants, std::span<const T> coeffs,
-                 int cstride)
+                 int cstride,
+                 std::span<const scalar_value_type_t<T>> packed_x = {},
+                 const mesh::CompactCoordinates<float>* x_compact = nullptr)
 {
   T value(0);
   if (cells.empty())
     return value;
 
   // Create data structures used in assembly
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
 
   // Iterate over all cells
   for (std::size_t index = 0; index < cells.size(); ++index)
@@ -41,17 +54,69 @@ T assemble_cells(mdspan2_t x_dofmap, std::span<const scalar_value_type_t<T>> x,
     std::int32_t c = cells[index];
 
     // Get cell coordinates/geometry
-    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    const scalar_value_type_t<T>* cdofs = coordinate_dofs.data();
+    if (!packed_x.empty())
+      cdofs = packed_x.data() + index * coordinate_dofs.size();
+    else if (x_compact)
     {
-      std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
+      const std::size_t num_dofs_g = x_dofmap.extent(1);
+      x_compact->gather(
+          std::span(x_dofmap.data_handle() + c * num_dofs_g, num_dofs_g),
+          std::span(coordinate_dofs));
+    }
+    else
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
     }
 
     const T* coeff_cell = coeffs.data() + index * cstride;
-    fn(&value, coeff_cell, constants.data(), coordinate_dofs.data(), nullptr,
-       nullptr);
+    fn(&value, coeff_cell, constants.data(), cdofs, nullptr, nullptr);
+  }
+
+  return value;
+}
+
+/// @brief Assemble functional over cells using a batched kernel.
+///
+/// The kernel is called for batches of `batch_size` cells, with data
+/// packed as described in assemble_batched_impl.h.
+template <dolfinx::scalar T>
+T assemble_cells_batched(mdspan2_t x_dofmap,
+                         std::span<const scalar_value_type_t<T>> x,
+                         std::span<const std::int32_t> cells,
+                         FEkernel<T> auto fn, int batch_size,
+                         std::span<const T> constants,
+                         std::span<const T> coeffs, int cstride)
+{
+  T value(0);
+  if (cells.empty())
+    return value;
+
+  // Create data structures used in assembly
+  const int N = batch_size;
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1) * N);
+  std::pmr::vector<T> vb(N), wb(cstride * N);
+
+  // Iterate over batches of cells
+  for (std::size_t index0 = 0; index0 < cells.size(); index0 += N)
+  {
+    const std::size_t num = std::min<std::size_t>(N, cells.size() - index0);
+    pack_batch_geometry(std::span(coordinate_dofs), x_dofmap, x,
+                        cells.subspan(index0, num), N);
+    pack_batch_coeffs(std::span(wb), coeffs.subspan(index0 * cstride,
+                                                    num * cstride),
+                      cstride, N);
+    std::ranges::fill(vb, 0);
+    fn(vb.data(), wb.data(), constants.data(), coordinate_dofs.data(),
+       nullptr, nullptr);
+    value = std::accumulate(vb.begin(), std::next(vb.begin(), num), value);
   }
 
   return value;
@@ -72,7 +137,8 @@ T assemble_exterior_facets(mdspan2_t x_dofmap,
     return value;
 
   // Create data structures used in assembly
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
 
   // Iterate over all facets
   assert(facets.size() % 2 == 0);
@@ -118,12 +184,12 @@ T assemble_interior_facets(mdspan2_t x_dofmap,
 
   // Create data structures used in assembly
   using X = scalar_value_type_t<T>;
-  std::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
+  std::pmr::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
   std::span<X> cdofs0(coordinate_dofs.data(), x_dofmap.extent(1) * 3);
   std::span<X> cdofs1(coordinate_dofs.data() + x_dofmap.extent(1) * 3,
                       x_dofmap.extent(1) * 3);
 
-  std::vector<T> coeff_array(2 * offsets.back());
+  std::pmr::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
 
   // Iterate over all facets
@@ -163,9 +229,10 @@ T assemble_interior_facets(mdspan2_t x_dofmap,
   return value;
 }
 
-/// Assemble functional into an scalar with provided mesh geometry.
+/// Assemble the facet integrals of a functional with provided mesh
+/// geometry.
 template <dolfinx::scalar T, std::floating_point U>
-T assemble_scalar(
+T assemble_scalar_facets(
     const fem::Form<T, U>& M, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
     const std::map<std::pair<IntegralType, int>,
@@ -175,16 +242,6 @@ T assemble_scalar(
   assert(mesh);
 
   T value = 0;
-  for (int i : M.integral_ids(IntegralType::cell))
-  {
-    auto fn = M.kernel(IntegralType::cell, i);
-    assert(fn);
-    auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
-    std::span<const std::int32_t> cells = M.domain(IntegralType::cell, i);
-    value += impl::assemble_cells(x_dofmap, x, cells, fn, constants, coeffs,
-                                  cstride);
-  }
-
   std::span<const std::uint8_t> perms;
   if (M.needs_facet_permutations())
   {
@@ -199,12 +256,22 @@ T assemble_scalar(
   {
     auto fn = M.kernel(IntegralType::exterior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
+    const auto& [coeffs, cstride]
         = coefficients.at({IntegralType::exterior_facet, i});
-    value += impl::assemble_exterior_facets(
-        x_dofmap, x, num_facets_per_cell,
-        M.domain(IntegralType::exterior_facet, i), fn, constants, coeffs,
-        cstride, perms);
+    std::span<const T> _coeffs = coeffs;
+    const int _cstride = cstride;
+    KernelCost cost = impl::kernel_cost<T, U>(
+        M.kernel_flops(IntegralType::exterior_facet, i), 1, {}, _cstride,
+        x_dofmap.extent(1));
+    impl::profile_integral(
+        "scalar", "exterior facet", i, cost,
+        [&](auto kernel, auto, auto)
+        {
+          value += impl::assemble_exterior_facets(
+              x_dofmap, x, num_facets_per_cell,
+              M.domain(IntegralType::exterior_facet, i), kernel(fn),
+              constants, _coeffs, _cstride, perms);
+        });
   }
 
   for (int i : M.integral_ids(IntegralType::interior_facet))
@@ -212,15 +279,249 @@ T assemble_scalar(
     const std::vector<int> c_offsets = M.coefficient_offsets();
     auto fn = M.kernel(IntegralType::interior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
+    const auto& [coeffs, cstride]
         = coefficients.at({IntegralType::interior_facet, i});
-    value += impl::assemble_interior_facets(
-        x_dofmap, x, num_facets_per_cell,
-        M.domain(IntegralType::interior_facet, i), fn, constants, coeffs,
-        cstride, c_offsets, perms);
+    std::span<const T> _coeffs = coeffs;
+    const int _cstride = cstride;
+    KernelCost cost = impl::kernel_cost<T, U>(
+        M.kernel_flops(IntegralType::interior_facet, i), 2, {}, _cstride,
+        x_dofmap.extent(1));
+    impl::profile_integral(
+        "scalar", "interior facet", i, cost,
+        [&](auto kernel, auto, auto)
+        {
+          value += impl::assemble_interior_facets(
+              x_dofmap, x, num_facets_per_cell,
+              M.domain(IntegralType::interior_facet, i), kernel(fn),
+              constants, _coeffs, _cstride, c_offsets, perms);
+        });
   }
 
   return value;
 }
 
+/// Assemble functional into an scalar with provided mesh geometry.
+template <dolfinx::scalar T, std::floating_point U>
+T assemble_scalar(
+    const fem::Form<T, U>& M, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = M.mesh();
+  assert(mesh);
+
+  T value = 0;
+  for (int i : M.integral_ids(IntegralType::cell))
+  {
+    auto fn = M.kernel(IntegralType::cell, i);
+    assert(fn);
+    const auto& coeffs_cell = coefficients.at({IntegralType::cell, i});
+    std::span<const T> coeffs = coeffs_cell.first;
+    int cstride = coeffs_cell.second;
+    std::span<const std::int32_t> cells = M.domain(IntegralType::cell, i);
+    auto batch = M.batch_kernel(IntegralType::cell, i);
+    KernelCost cost
+        = impl::kernel_cost<T, U>(M.kernel_flops(IntegralType::cell, i), 1,
+                                  {}, cstride, x_dofmap.extent(1));
+    if (batch.first)
+      cost = {batch.second * cost.flops, batch.second * cost.bytes};
+    impl::profile_integral(
+        "scalar", "cell", i, cost,
+        [&](auto kernel, auto, auto)
+        {
+          if (batch.first)
+          {
+            value += impl::assemble_cells_batched(
+                x_dofmap, x, cells, kernel(batch.first), batch.second,
+                constants, coeffs, cstride);
+          }
+          else
+          {
+            std::span<const U> packed_x;
+            const mesh::CompactCoordinates<float>* x_compact = nullptr;
+            if (x.data() == mesh->geometry().x().data())
+            {
+              packed_x = M.coordinate_dofs(i);
+              x_compact = M.compact_coordinates();
+            }
+            value += impl::assemble_cells(x_dofmap, x, cells, kernel(fn),
+                                          constants, coeffs, cstride, packed_x,
+                                          x_compact);
+          }
+        });
+  }
+
+  return value + assemble_scalar_facets(M, x_dofmap, x, constants,
+                                        coefficients);
+}
+
+/// @brief Cell kernel of a functional with its data, for
+/// assemble_cells_multi.
+template <dolfinx::scalar T, std::floating_point U>
+struct ScalarCellIntegral
+{
+  /// Kernel
+  std::function<void(T*, const T*, const T*, const U*, const int*,
+                     const std::uint8_t*)>
+      fn;
+
+  /// Constants of the functional
+  std::span<const T> constants;
+
+  /// Packed coefficients of the cells
+  std::span<const T> coeffs;
+
+  /// Number of coefficient values of a cell
+  int cstride;
+
+  /// Index of the functional
+  std::size_t index;
+};
+
+/// @brief Assemble several functionals over the same cells.
+///
+/// The coordinate dofs of each cell are gathered once, and the kernels
+/// of all integrals are called for the cell.
+///
+/// @param[in,out] values Values of the functionals. The contribution of
+/// an integral is added to `values[integral.index]`.
+/// @param[in] x_dofmap Geometry dofmap
+/// @param[in] x Geometry coordinates
+/// @param[in] cells Cells to integrate over
+/// @param[in] integrals Integrals over `cells`
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_cells_multi(std::span<T> values, mdspan2_t x_dofmap,
+                          std::span<const U> x,
+                          std::span<const std::int32_t> cells,
+                          std::span<const ScalarCellIntegral<T, U>> integrals)
+{
+  if (cells.empty())
+    return;
+
+  // Create data structures used in assembly
+  std::pmr::vector<U> coordinate_dofs(3 * x_dofmap.extent(1));
+
+  // Iterate over all cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    // Get cell coordinates/geometry
+    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        x_dofmap, cells[index], MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+
+    for (auto& integral : integrals)
+    {
+      integral.fn(&values[integral.index],
+                  integral.coeffs.data() + index * integral.cstride,
+                  integral.constants.data(), coordinate_dofs.data(), nullptr,
+                  nullptr);
+    }
+  }
+}
+
+/// @brief Assemble several functionals.
+///
+/// The cell integrals of all functionals with the same mesh and cells
+/// are assembled in one pass over the cells (see assemble_cells_multi).
+/// Batched cell integrals and facet integrals are assembled for each
+/// functional.
+///
+/// @param[in,out] values Values of the functionals. The contribution of
+/// `M[k]` is added to `values[k]`.
+/// @param[in] M Functionals
+/// @param[in] constants Constants of each functional
+/// @param[in] coefficients Coefficients of each functional
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_scalars(
+    std::span<T> values, std::span<const Form<T, U>* const> M,
+    std::span<const std::span<const T>> constants,
+    std::span<const std::map<std::pair<IntegralType, int>,
+                             std::pair<std::span<const T>, int>>>
+        coefficients)
+{
+  // Cell integrals with the same mesh and cells
+  struct Group
+  {
+    const mesh::Mesh<U>* mesh;
+    std::span<const std::int32_t> cells;
+    std::vector<ScalarCellIntegral<T, U>> integrals;
+    KernelCost cost;
+  };
+  std::vector<Group> groups;
+
+  for (std::size_t k = 0; k < M.size(); ++k)
+  {
+    assert(M[k]);
+    const Form<T, U>& form = *M[k];
+    std::shared_ptr<const mesh::Mesh<U>> mesh = form.mesh();
+    assert(mesh);
+    mdspan2_t x_dofmap = mesh->geometry().dofmap();
+    std::span<const U> x = mesh->geometry().x();
+    for (int i : form.integral_ids(IntegralType::cell))
+    {
+      const auto& [coeffs, cstride]
+          = coefficients[k].at({IntegralType::cell, i});
+      std::span<const T> _coeffs = coeffs;
+      const int _cstride = cstride;
+      std::span<const std::int32_t> cells = form.domain(IntegralType::cell, i);
+      KernelCost cost = impl::kernel_cost<T, U>(
+          form.kernel_flops(IntegralType::cell, i), 1, {}, cstride,
+          x_dofmap.extent(1));
+      auto batch = form.batch_kernel(IntegralType::cell, i);
+      if (batch.first)
+      {
+        cost = {batch.second * cost.flops, batch.second * cost.bytes};
+        impl::profile_integral(
+            "scalar", "cell", i, cost,
+            [&](auto kernel, auto, auto)
+            {
+              values[k] += impl::assemble_cells_batched(
+                  x_dofmap, x, cells, kernel(batch.first), batch.second,
+                  constants[k], _coeffs, _cstride);
+            });
+        continue;
+      }
+
+      auto it = std::ranges::find_if(
+          groups,
+          [&](const Group& g)
+          {
+            return g.mesh == mesh.get()
+                   and std::ranges::equal(g.cells, cells);
+          });
+      if (it == groups.end())
+        it = groups.insert(groups.end(), {mesh.get(), cells, {}, {}});
+      it->integrals.push_back({form.kernel(IntegralType::cell, i),
+                               constants[k], coeffs, cstride, k});
+      it->cost.flops += cost.flops;
+      it->cost.bytes += cost.bytes;
+    }
+
+    values[k] += assemble_scalar_facets(form, x_dofmap, x, constants[k],
+                                        coefficients[k]);
+  }
+
+  for (std::size_t g = 0; g < groups.size(); ++g)
+  {
+    const Group& group = groups[g];
+    impl::profile_integral(
+        "scalars", "cell", g, group.cost,
+        [&](auto kernel, auto, auto)
+        {
+          std::vector<ScalarCellIntegral<T, U>> integrals = group.integrals;
+          for (auto& integral : integrals)
+            integral.fn = kernel(integral.fn);
+          impl::assemble_cells_multi(
+              values, group.mesh->geometry().dofmap(),
+              group.mesh->geometry().x(), group.cells,
+              std::span<const ScalarCellIntegral<T, U>>(integrals));
+        });
+  }
+}
+
 } // namespace dolfinx::fem::impl
@@ -0,0 +1,336 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "assemble_matrix_impl.h"
+#include "assemble_vector_impl.h"
+#include "traits.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/la/utils.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace dolfinx::fem::impl
+{
+/// @brief Execute bilinear and linear form kernels over cells,
+/// accumulating the results in a matrix and a vector.
+///
+/// For each cell the geometry is gathered once and both element
+/// tensors are computed. Dirichlet boundary conditions are applied
+/// locally: the contributions of the columns with a boundary
+/// condition are moved to the cell vector (lifting), after which the
+/// rows and columns with boundary conditions are zeroed in the element
+/// matrix.
+///
+/// @param mat_set Function that accumulates the element matrix into
+/// the matrix.
+/// @param b Vector to accumulate into.
+/// @param x_dofmap Dofmap for the mesh geometry.
+/// @param x Mesh geometry (coordinates).
+/// @param cells Cell indices (in the integration domain mesh) to
+/// execute the kernels over.
+/// @param dofmap0 Test function (row) degree-of-freedom data holding
+/// the (0) dofmap, (1) dofmap block size and (2) dofmap cell indices.
+/// @param P0 Function that applies the transformation P_0 to test
+/// degrees-of-freedom.
+/// @param dofmap1 Trial function (column) degree-of-freedom data
+/// holding the (0) dofmap, (1) dofmap block size and (2) dofmap cell
+/// indices.
+/// @param P1T Function that applies the transformation P_1^T to trial
+/// degrees-of-freedom.
+/// @param bc0 Marker for rows with Dirichlet boundary conditions.
+/// @param bc1 Marker for columns with Dirichlet boundary conditions.
+/// @param bc_values1 Boundary condition values for the columns.
+/// @param x0 Vector used in the lifting. May be empty.
+/// @param scale Scaling applied to the lifting.
+/// @param kernel_a Bilinear form kernel.
+/// @param constants_a Constant data for the bilinear form.
+/// @param coeffs_a Coefficient data for the bilinear form, of shape
+/// `(cells.size(), cstride_a)`.
+/// @param cstride_a Coefficient stride for the bilinear form.
+/// @param kernel_L Linear form kernel.
+/// @param constants_L Constant data for the linear form.
+/// @param coeffs_L Coefficient data for the linear form, of shape
+/// `(cells.size(), cstride_L)`.
+/// @param cstride_L Coefficient stride for the linear form.
+/// @param cell_info0 Cell permutation information for the test
+/// function mesh.
+/// @param cell_info1 Cell permutation information for the trial
+/// function mesh.
+template <dolfinx::scalar T>
+void assemble_system_cells(
+    la::MatSet<T> auto mat_set, std::span<T> b, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x,
+    std::span<const std::int32_t> cells,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap0,
+    fem::DofTransformKernel<T> auto P0,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap1,
+    fem::DofTransformKernel<T> auto P1T, std::span<const std::int8_t> bc0,
+    std::span<const std::int8_t> bc1, std::span<const T> bc_values1,
+    std::span<const T> x0, T scale, FEkernel<T> auto kernel_a,
+    std::span<const T> constants_a, std::span<const T> coeffs_a,
+    int cstride_a, FEkernel<T> auto kernel_L, std::span<const T> constants_L,
+    std::span<const T> coeffs_L, int cstride_L,
+    std::span<const std::uint32_t> cell_info0,
+    std::span<const std::uint32_t> cell_info1)
+{
+  if (cells.empty())
+    return;
+
+  const auto [dmap0, bs0, cells0] = dofmap0;
+  const auto [dmap1, bs1, cells1] = dofmap1;
+
+  const int num_dofs0 = dmap0.extent(1);
+  const int num_dofs1 = dmap1.extent(1);
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  std::pmr::vector<T> Ae(ndim0 * ndim1), be(ndim0);
+  std::span<T> _Ae(Ae), _be(be);
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+
+  assert(cells0.size() == cells.size());
+  assert(cells1.size() == cells.size());
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    // Cell index in integration domain mesh (c), test function mesh
+    // (c0) and trial function mesh (c1)
+    std::int32_t c = cells[index];
+    std::int32_t c0 = cells0[index];
+    std::int32_t c1 = cells1[index];
+
+    // Get cell coordinates/geometry
+    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+
+    // Tabulate element matrix and vector
+    std::ranges::fill(Ae, 0);
+    kernel_a(Ae.data(), coeffs_a.data() + index * cstride_a,
+             constants_a.data(), coordinate_dofs.data(), nullptr, nullptr);
+    P0(_Ae, cell_info0, c0, ndim1);
+    P1T(_Ae, cell_info1, c1, ndim0);
+
+    std::ranges::fill(be, 0);
+    kernel_L(be.data(), coeffs_L.data() + index * cstride_L,
+             constants_L.data(), coordinate_dofs.data(), nullptr, nullptr);
+    P0(_be, cell_info0, c0, 1);
+
+    auto dofs0 = std::span(dmap0.data_handle() + c0 * num_dofs0, num_dofs0);
+    auto dofs1 = std::span(dmap1.data_handle() + c1 * num_dofs1, num_dofs1);
+
+    // Lift boundary condition columns into the cell vector and zero
+    // the columns
+    if (!bc1.empty())
+    {
+      for (int j = 0; j < num_dofs1; ++j)
+      {
+        for (int k = 0; k < bs1; ++k)
+        {
+          const std::int32_t jj = bs1 * dofs1[j] + k;
+          if (bc1[jj])
+          {
+            const T g = scale * (bc_values1[jj] - (x0.empty() ? 0 : x0[jj]));
+            const int col = bs1 * j + k;
+            for (int row = 0; row < ndim0; ++row)
+            {
+              be[row] -= Ae[row * ndim1 + col] * g;
+              Ae[row * ndim1 + col] = 0;
+            }
+          }
+        }
+      }
+    }
+
+    // Zero rows for essential bcs
+    if (!bc0.empty())
+    {
+      for (int i = 0; i < num_dofs0; ++i)
+      {
+        for (int k = 0; k < bs0; ++k)
+        {
+          if (bc0[bs0 * dofs0[i] + k])
+          {
+            const int row = bs0 * i + k;
+            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0);
+          }
+        }
+      }
+    }
+
+    mat_set(dofs0, dofs1, Ae);
+    for (int i = 0; i < num_dofs0; ++i)
+      for (int k = 0; k < bs0; ++k)
+        b[bs0 * dofs0[i] + k] += be[bs0 * i + k];
+  }
+}
+
+/// @brief Assemble a bilinear form into a matrix and a linear form
+/// into a vector, with Dirichlet boundary conditions applied to the
+/// vector by lifting.
+///
+/// Cell integrals that appear in both forms with the same integration
+/// domain are assembled in a single pass over the cells (see
+/// assemble_system_cells). All other integrals are assembled
+/// separately, using impl::assemble_matrix, impl::assemble_vector and
+/// impl::lift_bc.
+///
+/// @param[in] mat_set Function that accumulates values into the matrix.
+/// @param[in,out] b The vector to assemble into. It is not zeroed.
+/// @param[in] a The bilinear form.
+/// @param[in] L The linear form. It must have the same test space as
+/// `a`.
+/// @param[in] x_dofmap Mesh geometry dofmap.
+/// @param[in] x Mesh coordinates.
+/// @param[in] constants_a Packed constants that appear in `a`.
+/// @param[in] coefficients_a Packed coefficients that appear in `a`.
+/// @param[in] constants_L Packed constants that appear in `L`.
+/// @param[in] coefficients_L Packed coefficients that appear in `L`.
+/// @param[in] bc0 Marker for rows with Dirichlet boundary conditions.
+/// @param[in] bc1 Marker for columns with Dirichlet boundary
+/// conditions.
+/// @param[in] bc_values1 Boundary condition values for the columns.
+/// @param[in] x0 Vector used in the lifting. May be empty.
+/// @param[in] scale Scaling applied to the lifting.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_system(
+    la::MatSet<T> auto mat_set, std::span<T> b, const Form<T, U>& a,
+    const Form<T, U>& L, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants_a,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients_a,
+    std::span<const T> constants_L,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients_L,
+    std::span<const std::int8_t> bc0, std::span<const std::int8_t> bc1,
+    std::span<const T> bc_values1, std::span<const T> x0, T scale)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+  auto mesh0 = a.function_spaces().at(0)->mesh();
+  assert(mesh0);
+  auto mesh1 = a.function_spaces().at(1)->mesh();
+  assert(mesh1);
+
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+
+  // Cell integrals of the two forms that can be assembled together
+  std::set<int> fused;
+  if (L.mesh() == mesh and L.function_spaces().at(0)->dofmap() == dofmap0)
+  {
+    const std::vector<int> ids_L = L.integral_ids(IntegralType::cell);
+    for (int i : a.integral_ids(IntegralType::cell))
+    {
+      if (std::ranges::find(ids_L, i) != ids_L.end()
+          and !a.batch_kernel(IntegralType::cell, i).first
+          and !L.batch_kernel(IntegralType::cell, i).first
+          and std::ranges::equal(a.domain(IntegralType::cell, i),
+                                 L.domain(IntegralType::cell, i)))
+      {
+        fused.insert(i);
+      }
+    }
+  }
+
+  if (!fused.empty())
+  {
+    auto element0 = a.function_spaces().at(0)->element();
+    assert(element0);
+    auto element1 = a.function_spaces().at(1)->element();
+    assert(element1);
+    std::span<const std::uint32_t> cell_info0;
+    std::span<const std::uint32_t> cell_info1;
+    if (element0->needs_dof_transformations()
+        or element1->needs_dof_transformations())
+    {
+      mesh0->topology_mutable()->create_entity_permutations();
+      mesh1->topology_mutable()->create_entity_permutations();
+      cell_info0 = std::span(mesh0->topology()->get_cell_permutation_info());
+      cell_info1 = std::span(mesh1->topology()->get_cell_permutation_info());
+    }
+
+    fem::DofTransformKernel<T> auto P0
+        = element0->template precomputed_dof_transformation_fn<T>(
+            doftransform::standard, cell_info0);
+    fem::DofTransformKernel<T> auto P1T
+        = element1->template precomputed_dof_transformation_right_fn<T>(
+            doftransform::transpose, cell_info1);
+
+    for (int i : fused)
+    {
+      auto kernel_a = a.kernel(IntegralType::cell, i);
+      assert(kernel_a);
+      auto kernel_L = L.kernel(IntegralType::cell, i);
+      assert(kernel_L);
+      auto& [coeffs_a, cstride_a] = coefficients_a.at({IntegralType::cell, i});
+      auto& [coeffs_L, cstride_L] = coefficients_L.at({IntegralType::cell, i});
+      std::span<const std::int32_t> cells = a.domain(IntegralType::cell, i);
+      std::span<const std::int32_t> cells0
+          = a.domain(IntegralType::cell, i, *mesh0);
+      std::span<const std::int32_t> cells1
+          = a.domain(IntegralType::cell, i, *mesh1);
+      assemble_system_cells(mat_set, b, x_dofmap, x, cells,
+                            {dofmap0->map(), dofmap0->bs(), cells0}, P0,
+                            {dofmap1->map(), dofmap1->bs(), cells1}, P1T, bc0,
+                            bc1, bc_values1, x0, scale, kernel_a, constants_a,
+                            coeffs_a, cstride_a, kernel_L, constants_L,
+                            coeffs_L, cstride_L, cell_info0, cell_info1);
+    }
+  }
+
+  // Assemble the remaining integrals separately
+  auto include = [&fused](IntegralType type, int id)
+  { return type != IntegralType::cell or !fused.contains(id); };
+  assemble_matrix_integrals(
+      mat_set, a, x_dofmap, x, constants_a, coefficients_a, bc0, bc1,
+      [&include](IntegralType type, int id, mdspan2_t,
+                 std::array<std::span<const std::int32_t>, 3> entities,
+                 std::span<const T> coeffs, auto&& assemble)
+      {
+        if (include(type, id))
+          assemble(entities, coeffs);
+      },
+      true);
+  assemble_vector_integrals(
+      b, L, x_dofmap, x, constants_L, coefficients_L,
+      [&include](IntegralType type, int id, mdspan2_t,
+                 std::array<std::span<const std::int32_t>, 2> entities,
+                 std::span<const T> coeffs, auto&& assemble)
+      {
+        if (include(type, id))
+          assemble(entities, coeffs);
+      },
+      true);
+  if (!bc1.empty())
+  {
+    lift_bc(b, a, x_dofmap, x, constants_a, coefficients_a, bc_values1, bc1,
+            x0, scale, include);
+  }
+}
+
+} // namespace dolfinx::fem::impl
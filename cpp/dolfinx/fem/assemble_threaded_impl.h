@@ -0,0 +1,240 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include <algorithm>
+#include <array>
+#include <basix/mdspan.hpp>
+#include <cassert>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/ordering.h>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem::impl
+{
+/// @cond
+using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+    const std::int32_t,
+    MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+/// @endcond
+
+/// @brief Number of entries per integration entity in the entity
+/// lists returned by Form::domain.
+/// @param[in] type Integral type.
+/// @return Stride of the entity data.
+constexpr int entity_stride(IntegralType type)
+{
+  switch (type)
+  {
+  case IntegralType::cell:
+    return 1;
+  case IntegralType::exterior_facet:
+    return 2;
+  case IntegralType::interior_facet:
+    return 4;
+  default:
+    throw std::runtime_error("Integral type not supported.");
+  }
+}
+
+/// @brief Colour integration entities such that no two entities with
+/// the same colour share a degree-of-freedom.
+///
+/// @param[in] dofmap Dofmap for the cells in `entities`.
+/// @param[in] entities Integration entities, with the layout of
+/// Form::domain for the integral type.
+/// @param[in] type Integral type.
+/// @return Colouring, where `links(c)` are the (integration entity)
+/// positions in `entities` with colour `c`.
+inline graph::AdjacencyList<std::int32_t>
+colour_entities(mdspan2_t dofmap, std::span<const std::int32_t> entities,
+                IntegralType type)
+{
+  // For interior facets both attached cells write to the tensor
+  const int stride = entity_stride(type);
+  const int num_cells = type == IntegralType::interior_facet ? 2 : 1;
+  const std::size_t num_dofs = dofmap.extent(1);
+  const std::size_t num_entities = entities.size() / stride;
+
+  std::vector<std::int32_t> dofs, offsets(1, 0);
+  dofs.reserve(num_entities * num_cells * num_dofs);
+  offsets.reserve(num_entities + 1);
+  for (std::size_t e = 0; e < num_entities; ++e)
+  {
+    for (int k = 0; k < num_cells; ++k)
+    {
+      std::int32_t c = entities[e * stride + 2 * k];
+      for (std::size_t i = 0; i < num_dofs; ++i)
+        dofs.push_back(dofmap(c, i));
+    }
+    offsets.push_back(dofs.size());
+  }
+
+  return graph::colour_greedy(
+      graph::AdjacencyList<std::int32_t>(std::move(dofs), std::move(offsets)));
+}
+
+/// @brief Gather rows of a row-major array.
+/// @param[in] data Array with row-major storage.
+/// @param[in] stride Number of entries per row in `data`.
+/// @param[in] rows Indices of the rows to gather.
+/// @return Array with `rows.size()` rows, where row `i` is row
+/// `rows[i]` of `data`.
+template <typename T>
+std::vector<T> gather_rows(std::span<const T> data, std::size_t stride,
+                           std::span<const std::int32_t> rows)
+{
+  std::vector<T> out(rows.size() * stride);
+  for (std::size_t i = 0; i < rows.size(); ++i)
+  {
+    std::copy_n(std::next(data.begin(), rows[i] * stride), stride,
+                std::next(out.begin(), i * stride));
+  }
+  return out;
+}
+
+/// @brief Packed coefficients of a group of integrals (see
+/// Form::integral_groups).
+///
+/// For a group with a single integral, the packed coefficients of the
+/// integral are returned. Otherwise the packed coefficients of the
+/// integrals are concatenated into `storage`, in the order of the
+/// entities of the group.
+///
+/// @param[in] type Integral type.
+/// @param[in] group The group of integrals.
+/// @param[in] coefficients Packed coefficients for each integral.
+/// @param[in,out] storage Storage for concatenated coefficients. It
+/// is re-used for each group, so the spans returned for earlier
+/// groups are invalidated.
+/// @return The packed coefficients of the group and the coefficient
+/// stride.
+template <dolfinx::scalar T>
+std::pair<std::span<const T>, int> group_coefficients(
+    IntegralType type, const integral_group& group,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    std::vector<T>& storage)
+{
+  if (group.ids.size() == 1)
+    return coefficients.at({type, group.ids.front()});
+
+  storage.clear();
+  int cstride = 0;
+  for (int id : group.ids)
+  {
+    auto& [c, cs] = coefficients.at({type, id});
+    storage.insert(storage.end(), c.begin(), c.end());
+    cstride = cs;
+  }
+  return {std::span<const T>(storage), cstride};
+}
+
+/// @brief Call a function for each assembly loop over the integrals
+/// of a given type.
+///
+/// If `fuse` is true, `f(group)` is called for each group of
+/// Form::integral_groups. Otherwise it is called for each integral,
+/// with a group holding the integral only.
+///
+/// @param[in] a The form.
+/// @param[in] type Integral type.
+/// @param[in] fuse True to execute one loop for each group of
+/// integrals.
+/// @param[in] f Function called as `f(group)`.
+template <typename Form, typename F>
+void for_each_integral_group(const Form& a, IntegralType type, bool fuse,
+                             F&& f)
+{
+  for (const integral_group& g : a.integral_groups(type))
+  {
+    if (fuse or g.ids.size() == 1)
+      f(g);
+    else
+    {
+      for (int id : g.ids)
+        f(integral_group{{id}, {}});
+    }
+  }
+}
+
+/// @brief Assemble an integral concurrently using multiple threads.
+///
+/// The integration entities are coloured such that entities with the
+/// same colour do not share a test function (row) degree-of-freedom
+/// (see colour_entities). The entity and coefficient data is permuted
+/// such that the entities of each colour are stored contiguously.
+/// Colours are processed in turn, and the entities of a colour are
+/// split into `num_threads` contiguous chunks that are assembled
+/// concurrently.
+///
+/// @param[in] type Integral type.
+/// @param[in] colours Colouring of the integration entities, e.g.
+/// computed by colour_entities and cached by Form::entity_colouring.
+/// @param[in] entities Lists of integration entities to be permuted,
+/// each with the layout of Form::domain for the integral type.
+/// @param[in] coeffs Packed coefficients for the integration entities.
+/// @param[in] num_threads Number of threads.
+/// @param[in] fn Function called as `fn(e, c)`, where `e` contains a
+/// chunk of each permuted entity list and `c` is the corresponding
+/// chunk of the permuted coefficients. It is called concurrently for
+/// entities of the same colour.
+template <dolfinx::scalar T, std::size_t N, typename F>
+void assemble_threaded(IntegralType type,
+                       const graph::AdjacencyList<std::int32_t>& colours,
+                       std::array<std::span<const std::int32_t>, N> entities,
+                       std::span<const T> coeffs, int num_threads, F fn)
+{
+  const int stride = entity_stride(type);
+  const std::size_t num_entities = entities[0].size() / stride;
+  if (num_entities == 0)
+    return;
+
+  // Permute data into colour-major order
+  std::span<const std::int32_t> perm = colours.array();
+  assert(perm.size() == num_entities);
+  std::array<std::vector<std::int32_t>, N> _entities;
+  for (std::size_t k = 0; k < N; ++k)
+    _entities[k] = gather_rows(entities[k], stride, perm);
+  const std::size_t cstride = coeffs.size() / num_entities;
+  const std::vector<T> _coeffs = gather_rows(coeffs, cstride, perm);
+
+  // Assemble entities in range [e0, e1) of the permuted data
+  auto assemble_range = [&](std::int64_t e0, std::int64_t e1)
+  {
+    std::array<std::span<const std::int32_t>, N> e;
+    for (std::size_t k = 0; k < N; ++k)
+    {
+      e[k] = std::span<const std::int32_t>(_entities[k])
+                 .subspan(e0 * stride, (e1 - e0) * stride);
+    }
+    fn(e, std::span<const T>(_coeffs).subspan(e0 * cstride,
+                                              (e1 - e0) * cstride));
+  };
+
+  const std::vector<std::int32_t>& offsets = colours.offsets();
+  for (std::int32_t c = 0; c < colours.num_nodes(); ++c)
+  {
+    const std::int64_t size = offsets[c + 1] - offsets[c];
+    common::parallel_for(size, num_threads,
+                         [&, c](std::int64_t r0, std::int64_t r1)
+                         {
+                           assemble_range(offsets[c] + r0,
+                                          offsets[c] + r1);
+                         });
+  }
+}
+
+} // namespace dolfinx::fem::impl
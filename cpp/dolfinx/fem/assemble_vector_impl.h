@@ -11,6 +11,10 @@
 #include "DofMap.h"
 #include "Form.h"
 #include "FunctionSpace.h"
+#include "CellGroup.h"
+#include "assemble_batched_impl.h"
+#include "assemble_threaded_impl.h"
+#include "assembly_profiling.h"
 #include "traits.h"
 #include "utils.h"
 #include <algorithm>
@@ -22,7 +26,9 @@
 #include <dolfinx/mesh/Topology.h>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace dolfinx::fem::impl
@@ -34,6 +40,55 @@ using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
     MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
 /// @endcond
 
+/// @brief Call a function with a dofmap block size as a compile-time
+/// constant.
+///
+/// Calls `f(std::integral_constant<int, bs>())` if `bs` is 1, 2 or 3,
+/// and `f(std::integral_constant<int, -1>())` otherwise, for which the
+/// block size must be determined at runtime.
+/// @param[in] bs Block size.
+/// @param[in] f Function to call.
+template <typename F>
+void dispatch_bs(int bs, F&& f)
+{
+  switch (bs)
+  {
+  case 1:
+    f(std::integral_constant<int, 1>());
+    break;
+  case 2:
+    f(std::integral_constant<int, 2>());
+    break;
+  case 3:
+    f(std::integral_constant<int, 3>());
+    break;
+  default:
+    f(std::integral_constant<int, -1>());
+  }
+}
+
+/// @brief Call a function with a pair of dofmap block sizes as
+/// compile-time constants.
+///
+/// If both `bs0` and `bs1` are 1, 2 or 3, `f` is called with the
+/// block sizes as `std::integral_constant`s. Otherwise both are passed
+/// as `std::integral_constant<int, -1>`, for which the block sizes
+/// must be determined at runtime.
+/// @param[in] bs0 Test function block size.
+/// @param[in] bs1 Trial function block size.
+/// @param[in] f Function to call as `f(bs0, bs1)`.
+template <typename F>
+void dispatch_bs(int bs0, int bs1, F&& f)
+{
+  if (bs0 < 1 or bs0 > 3 or bs1 < 1 or bs1 > 3)
+    f(std::integral_constant<int, -1>(), std::integral_constant<int, -1>());
+  else
+  {
+    dispatch_bs(bs0, [bs1, &f](auto _bs0)
+                { dispatch_bs(bs1, [&](auto _bs1) { f(_bs0, _bs1); }); });
+  }
+}
+
 /// @brief Apply boundary condition lifting for cell integrals.
 /// @tparam T The scalar type.
 /// @tparam _bs0 The block size of the form test function dof map. If
@@ -94,8 +149,9 @@ void _lift_bc_cells(
   assert(_bs1 < 0 or _bs1 == bs1);
 
   // Data structures used in bc application
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
-  std::vector<T> Ae, be;
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+  std::pmr::vector<T> Ae, be;
   assert(cells0.size() == cells.size());
   assert(cells1.size() == cells.size());
   for (std::size_t index = 0; index < cells.size(); ++index)
@@ -225,7 +281,12 @@ void _lift_bc_cells(
 
 /// @brief Apply lifting for exterior facet integrals.
 /// @tparam T The scalar type
-/// @tparam _bs FIXME This is unused
+/// @tparam _bs0 Block size of the test function dofmap. If less than
+/// zero the block size is determined at runtime, otherwise it is used
+/// as a compile-time constant.
+/// @tparam _bs1 Block size of the trial function dofmap. If less than
+/// zero the block size is determined at runtime, otherwise it is used
+/// as a compile-time constant.
 /// @param[in,out] b The vector to modify
 /// @param[in] x_dofmap Dofmap for the mesh geometry.
 /// @param[in] x Mesh geometry (coordinates).
@@ -258,7 +319,7 @@ void _lift_bc_cells(
 /// @param[in] scale The scaling to apply.
 /// @param[in] perms Facet permutation integer. Empty if facet
 /// permutations are not required.
-template <dolfinx::scalar T, int _bs = -1>
+template <dolfinx::scalar T, int _bs0 = -1, int _bs1 = -1>
 void _lift_bc_exterior_facets(
     std::span<T> b, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, int num_facets_per_cell,
@@ -276,12 +337,17 @@ void _lift_bc_exterior_facets(
   if (facets.empty())
     return;
 
-  const auto [dmap0, bs0, facets0] = dofmap0;
-  const auto [dmap1, bs1, facets1] = dofmap1;
+  const auto [dmap0, _bs0_rt, facets0] = dofmap0;
+  const auto [dmap1, _bs1_rt, facets1] = dofmap1;
+  assert(_bs0 < 0 or _bs0 == _bs0_rt);
+  assert(_bs1 < 0 or _bs1 == _bs1_rt);
+  const int bs0 = _bs0 > 0 ? _bs0 : _bs0_rt;
+  const int bs1 = _bs1 > 0 ? _bs1 : _bs1_rt;
 
   // Data structures used in bc application
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
-  std::vector<T> Ae, be;
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+  std::pmr::vector<T> Ae, be;
   assert(facets.size() % 2 == 0);
   assert(facets0.size() == facets.size());
   assert(facets1.size() == facets.size());
@@ -373,7 +439,12 @@ void _lift_bc_exterior_facets(
 
 /// @brief Apply lifting for interior facet integrals.
 /// @tparam T Scalar type.
-/// @tparam _bs FIXME This is unused.
+/// @tparam _bs0 Block size of the test function dofmap. If less than
+/// zero the block size is determined at runtime, otherwise it is used
+/// as a compile-time constant.
+/// @tparam _bs1 Block size of the trial function dofmap. If less than
+/// zero the block size is determined at runtime, otherwise it is used
+/// as a compile-time constant.
 /// @param[in,out] b The vector to modify
 /// @param[in] x_dofmap Dofmap for the mesh geometry.
 /// @param[in] x Mesh geometry (coordinates).
@@ -407,7 +478,7 @@ void _lift_bc_exterior_facets(
 /// conditions applied.
 /// @param[in] x0 The vector used in the lifting.
 /// @param[in] scale The scaling to apply
-template <dolfinx::scalar T, int _bs = -1>
+template <dolfinx::scalar T, int _bs0 = -1, int _bs1 = -1>
 void _lift_bc_interior_facets(
     std::span<T> b, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, int num_facets_per_cell,
@@ -425,16 +496,20 @@ void _lift_bc_interior_facets(
   if (facets.empty())
     return;
 
-  const auto [dmap0, bs0, facets0] = dofmap0;
-  const auto [dmap1, bs1, facets1] = dofmap1;
+  const auto [dmap0, _bs0_rt, facets0] = dofmap0;
+  const auto [dmap1, _bs1_rt, facets1] = dofmap1;
+  assert(_bs0 < 0 or _bs0 == _bs0_rt);
+  assert(_bs1 < 0 or _bs1 == _bs1_rt);
+  const int bs0 = _bs0 > 0 ? _bs0 : _bs0_rt;
+  const int bs1 = _bs1 > 0 ? _bs1 : _bs1_rt;
 
   // Data structures used in assembly
   using X = scalar_value_type_t<T>;
-  std::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
+  std::pmr::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
   std::span<X> cdofs0(coordinate_dofs.data(), x_dofmap.extent(1) * 3);
   std::span<X> cdofs1(coordinate_dofs.data() + x_dofmap.extent(1) * 3,
                       x_dofmap.extent(1) * 3);
-  std::vector<T> Ae, be;
+  std::pmr::vector<T> Ae, be;
 
   // Temporaries for joint dofmaps
   std::vector<std::int32_t> dmapjoint0, dmapjoint1;
@@ -629,15 +704,23 @@ void _lift_bc_interior_facets(
 /// @param cstride The coefficient stride
 /// @param cell_info0 The cell permutation information for the test function
 /// mesh
-template <dolfinx::scalar T, int _bs = -1>
+/// @param packed_x Packed coordinate dofs of `cells` (see
+/// Form::coordinate_dofs). If empty, the coordinate dofs are gathered
+/// from `x`.
+/// @param x_compact Compact copy of the geometry (see
+/// Form::compact_coordinates). If not null and `packed_x` is empty,
+/// the coordinate dofs are gathered from `x_compact` instead of `x`.
+template <dolfinx::scalar T, int _bs = -1, dolfinx::scalar V = T>
 void assemble_cells(
-    fem::DofTransformKernel<T> auto P0, std::span<T> b, mdspan2_t x_dofmap,
+    fem::DofTransformKernel<T> auto P0, std::span<V> b, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x,
     std::span<const std::int32_t> cells,
     std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap,
     FEkernel<T> auto kernel, std::span<const T> constants,
     std::span<const T> coeffs, int cstride,
-    std::span<const std::uint32_t> cell_info0)
+    std::span<const std::uint32_t> cell_info0,
+    std::span<const scalar_value_type_t<T>> packed_x = {},
+    const mesh::CompactCoordinates<float>* x_compact = nullptr)
 {
   if (cells.empty())
     return;
@@ -646,8 +729,9 @@ void assemble_cells(
   assert(_bs < 0 or _bs == bs);
 
   // Create data structures used in assembly
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
-  std::vector<T> be(bs * dmap.extent(1));
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+  std::pmr::vector<T> be(bs * dmap.extent(1));
   std::span<T> _be(be);
 
   // Iterate over active cells
@@ -658,18 +742,31 @@ void assemble_cells(
     std::int32_t c0 = cells0[index];
 
     // Get cell coordinates/geometry
-    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    const scalar_value_type_t<T>* cdofs = coordinate_dofs.data();
+    if (!packed_x.empty())
+      cdofs = packed_x.data() + index * coordinate_dofs.size();
+    else if (x_compact)
     {
-      std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
+      const std::size_t num_dofs_g = x_dofmap.extent(1);
+      x_compact->gather(
+          std::span(x_dofmap.data_handle() + c * num_dofs_g, num_dofs_g),
+          std::span(coordinate_dofs));
+    }
+    else
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
     }
 
     // Tabulate vector for cell
     std::ranges::fill(be, 0);
     kernel(be.data(), coeffs.data() + index * cstride, constants.data(),
-           coordinate_dofs.data(), nullptr, nullptr);
+           cdofs, nullptr, nullptr);
     P0(_be, cell_info0, c0, 1);
 
     // Scatter cell vector to 'global' vector array
@@ -690,6 +787,170 @@ void assemble_cells(
   }
 }
 
+/// @brief Execute a batched kernel over cells and accumulate result in
+/// vector.
+///
+/// The kernel is called for batches of `batch_size` cells, with data
+/// packed as described in assemble_batched_impl.h.
+///
+/// @param batch_size Number of cells computed by one call of `kernel`.
+/// @note See assemble_cells for a description of the other arguments.
+template <dolfinx::scalar T, int _bs = -1, dolfinx::scalar V = T>
+void assemble_cells_batched(
+    fem::DofTransformKernel<T> auto P0, std::span<V> b, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x,
+    std::span<const std::int32_t> cells,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap,
+    FEkernel<T> auto kernel, int batch_size, std::span<const T> constants,
+    std::span<const T> coeffs, int cstride,
+    std::span<const std::uint32_t> cell_info0)
+{
+  if (cells.empty())
+    return;
+
+  const auto [dmap, bs, cells0] = dofmap;
+  assert(_bs < 0 or _bs == bs);
+
+  // Create data structures used in assembly
+  const int N = batch_size;
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1) * N);
+  std::pmr::vector<T> be(bs * dmap.extent(1)), bb(be.size() * N),
+      wb(cstride * N);
+  std::span<T> _be(be);
+
+  // Iterate over batches of active cells
+  for (std::size_t index0 = 0; index0 < cells.size(); index0 += N)
+  {
+    const std::size_t num = std::min<std::size_t>(N, cells.size() - index0);
+
+    // Pack batch data and tabulate vectors
+    pack_batch_geometry(std::span(coordinate_dofs), x_dofmap, x,
+                        cells.subspan(index0, num), N);
+    pack_batch_coeffs(std::span(wb), coeffs.subspan(index0 * cstride,
+                                                    num * cstride),
+                      cstride, N);
+    std::ranges::fill(bb, 0);
+    kernel(bb.data(), wb.data(), constants.data(), coordinate_dofs.data(),
+           nullptr, nullptr);
+
+    for (std::size_t k0 = 0; k0 < num; ++k0)
+    {
+      std::int32_t c0 = cells0[index0 + k0];
+      unpack_batch_tensor(_be, std::span<const T>(bb), k0, N);
+      P0(_be, cell_info0, c0, 1);
+
+      // Scatter cell vector to 'global' vector array
+      auto dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          dmap, c0, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      if constexpr (_bs > 0)
+      {
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < _bs; ++k)
+            b[_bs * dofs[i] + k] += be[_bs * i + k];
+      }
+      else
+      {
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < bs; ++k)
+            b[bs * dofs[i] + k] += be[bs * i + k];
+      }
+    }
+  }
+}
+
+/// @brief Execute a kernel over cells for several sets of coefficient
+/// values and accumulate the results in interleaved vectors.
+///
+/// The coordinate dofs and the dofmap of a cell are fetched once, and
+/// the kernel is called for each set of coefficients. The element
+/// vectors are stored as the columns of an array of shape `(bs *
+/// num_dofs, num_rhs)`, so that the dof transformation is applied once
+/// for all sets, and the entries of all vectors for a degree-of-freedom
+/// are added to contiguous positions of `b`.
+///
+/// @param[in,out] b Vectors to accumulate into. Entry `i` of vector `j`
+/// is at position `i * coeffs.size() + j` (see la::MultiVector).
+/// @param[in] coeffs Coefficient data for each set of coefficient
+/// values, each of shape `(cells.size(), cstride)`.
+/// @note See assemble_cells for a description of the other arguments.
+template <dolfinx::scalar T>
+void assemble_cells_multi(
+    fem::DofTransformKernel<T> auto P0, std::span<T> b, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x,
+    std::span<const std::int32_t> cells,
+    std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap,
+    FEkernel<T> auto kernel, std::span<const T> constants,
+    std::span<const std::span<const T>> coeffs, int cstride,
+    std::span<const std::uint32_t> cell_info0,
+    std::span<const scalar_value_type_t<T>> packed_x = {},
+    const mesh::CompactCoordinates<float>* x_compact = nullptr)
+{
+  if (cells.empty() or coeffs.empty())
+    return;
+
+  const auto [dmap, bs, cells0] = dofmap;
+  const std::size_t num_rhs = coeffs.size();
+  const std::size_t bs_rhs = bs * num_rhs;
+
+  // Create data structures used in assembly
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+  std::pmr::vector<T> be(bs * dmap.extent(1));
+  std::pmr::vector<T> bk(be.size() * num_rhs);
+  std::span<T> _bk(bk);
+
+  // Iterate over active cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    // Integration domain cell and test function cell
+    std::int32_t c = cells[index];
+    std::int32_t c0 = cells0[index];
+
+    // Get cell coordinates/geometry
+    const scalar_value_type_t<T>* cdofs = coordinate_dofs.data();
+    if (!packed_x.empty())
+      cdofs = packed_x.data() + index * coordinate_dofs.size();
+    else if (x_compact)
+    {
+      const std::size_t num_dofs_g = x_dofmap.extent(1);
+      x_compact->gather(
+          std::span(x_dofmap.data_handle() + c * num_dofs_g, num_dofs_g),
+          std::span(coordinate_dofs));
+    }
+    else
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(std::next(x.begin(), 3 * x_dofs[i]), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
+    }
+
+    // Tabulate the cell vector for each set of coefficients
+    for (std::size_t j = 0; j < num_rhs; ++j)
+    {
+      std::ranges::fill(be, 0);
+      kernel(be.data(), coeffs[j].data() + index * cstride, constants.data(),
+             cdofs, nullptr, nullptr);
+      for (std::size_t i = 0; i < be.size(); ++i)
+        bk[i * num_rhs + j] = be[i];
+    }
+    P0(_bk, cell_info0, c0, num_rhs);
+
+    // Scatter cell vectors to 'global' vector array
+    auto dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        dmap, c0, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+    {
+      for (std::size_t k = 0; k < bs_rhs; ++k)
+        b[bs_rhs * dofs[i] + k] += bk[bs_rhs * i + k];
+    }
+  }
+}
+
 /// @brief Execute kernel over cells and accumulate result in vector.
 /// @tparam T The scalar type
 /// @tparam _bs The block size of the form test function dof map. If
@@ -715,9 +976,9 @@ void assemble_cells(
 /// function mesh.
 /// @param[in] perms Facet permutation integer. Empty if facet
 /// permutations are not required.
-template <dolfinx::scalar T, int _bs = -1>
+template <dolfinx::scalar T, int _bs = -1, dolfinx::scalar V = T>
 void assemble_exterior_facets(
-    fem::DofTransformKernel<T> auto P0, std::span<T> b, mdspan2_t x_dofmap,
+    fem::DofTransformKernel<T> auto P0, std::span<V> b, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, int num_facets_per_cell,
     std::span<const std::int32_t> facets,
     std::tuple<mdspan2_t, int, std::span<const std::int32_t>> dofmap,
@@ -735,8 +996,9 @@ void assemble_exterior_facets(
   // FIXME: Add proper interface for num_dofs
   // Create data structures used in assembly
   const int num_dofs = dmap.extent(1);
-  std::vector<scalar_value_type_t<T>> coordinate_dofs(3 * x_dofmap.extent(1));
-  std::vector<T> be(bs * num_dofs);
+  std::pmr::vector<scalar_value_type_t<T>> coordinate_dofs(
+      3 * x_dofmap.extent(1));
+  std::pmr::vector<T> be(bs * num_dofs);
   std::span<T> _be(be);
   assert(facets.size() % 2 == 0);
   assert(facets0.size() == facets.size());
@@ -811,30 +1073,40 @@ void assemble_exterior_facets(
 /// function mesh.
 /// @param[in] perms Facet permutation integer. Empty if facet
 /// permutations are not required.
-template <dolfinx::scalar T, int _bs = -1>
+/// @param[in] joint_dofs Joined test function dofs of the two cells of
+/// each facet in `facets` (see Form::facet_pairs). If empty, the dofs
+/// are read from the dofmap.
+/// @param[in] facet_perms Permutations of each facet in `facets`
+/// relative to its two cells. If empty, the permutations are read from
+/// `perms`.
+template <dolfinx::scalar T, int _bs = -1, dolfinx::scalar V = T>
 void assemble_interior_facets(
-    fem::DofTransformKernel<T> auto P0, std::span<T> b, mdspan2_t x_dofmap,
+    fem::DofTransformKernel<T> auto P0, std::span<V> b, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, int num_facets_per_cell,
     std::span<const std::int32_t> facets,
     std::tuple<const DofMap&, int, std::span<const std::int32_t>> dofmap,
     FEkernel<T> auto fn, std::span<const T> constants,
     std::span<const T> coeffs, int cstride,
     std::span<const std::uint32_t> cell_info0,
-    std::span<const std::uint8_t> perms)
+    std::span<const std::uint8_t> perms,
+    std::span<const std::int32_t> joint_dofs = {},
+    std::span<const std::uint8_t> facet_perms = {})
 {
   if (facets.empty())
     return;
 
   const auto [dmap, bs, facets0] = dofmap;
   assert(_bs < 0 or _bs == bs);
+  assert(facet_perms.empty() or facet_perms.size() == facets.size() / 2);
+  const std::size_t num_dofs = dmap.map().extent(1);
 
   // Create data structures used in assembly
   using X = scalar_value_type_t<T>;
-  std::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
+  std::pmr::vector<X> coordinate_dofs(2 * x_dofmap.extent(1) * 3);
   std::span<X> cdofs0(coordinate_dofs.data(), x_dofmap.extent(1) * 3);
   std::span<X> cdofs1(coordinate_dofs.data() + x_dofmap.extent(1) * 3,
                       x_dofmap.extent(1) * 3);
-  std::vector<T> be;
+  std::pmr::vector<T> be;
 
   assert(facets.size() % 4 == 0);
   assert(facets0.size() == facets.size());
@@ -865,18 +1137,29 @@ void assemble_interior_facets(
     }
 
     // Get dofmaps for cells
-    std::span<const std::int32_t> dmap0 = dmap.cell_dofs(cells0[0]);
-    std::span<const std::int32_t> dmap1 = dmap.cell_dofs(cells0[1]);
+    std::span<const std::int32_t> dmap0, dmap1;
+    if (!joint_dofs.empty())
+    {
+      dmap0 = joint_dofs.subspan(index / 2 * num_dofs, num_dofs);
+      dmap1 = joint_dofs.subspan((index / 2 + 1) * num_dofs, num_dofs);
+    }
+    else
+    {
+      dmap0 = dmap.cell_dofs(cells0[0]);
+      dmap1 = dmap.cell_dofs(cells0[1]);
+    }
 
     // Tabulate element vector
     be.resize(bs * (dmap0.size() + dmap1.size()));
     std::ranges::fill(be, 0);
-    std::array perm
-        = perms.empty()
-              ? std::array<std::uint8_t, 2>{0, 0}
-              : std::array{
-                    perms[cells[0] * num_facets_per_cell + local_facet[0]],
-                    perms[cells[1] * num_facets_per_cell + local_facet[1]]};
+    std::array<std::uint8_t, 2> perm = {0, 0};
+    if (!facet_perms.empty())
+      perm = {facet_perms[index / 2], facet_perms[index / 2 + 1]};
+    else if (!perms.empty())
+    {
+      perm = {perms[cells[0] * num_facets_per_cell + local_facet[0]],
+              perms[cells[1] * num_facets_per_cell + local_facet[1]]};
+    }
     fn(be.data(), coeffs.data() + index / 2 * cstride, constants.data(),
        coordinate_dofs.data(), local_facet.data(), perm.data());
 
@@ -924,6 +1207,8 @@ void assemble_interior_facets(
 /// @param[in] x0 The array used in the lifting, typically a 'current
 /// solution' in a Newton method
 /// @param[in] scale Scaling to apply
+/// @param[in] include Function called as `include(type, id)` that
+/// returns `true` if the integral `(type, id)` should be applied.
 template <dolfinx::scalar T, std::floating_point U>
 void lift_bc(std::span<T> b, const Form<T, U>& a, mdspan2_t x_dofmap,
              std::span<const scalar_value_type_t<T>> x,
@@ -932,7 +1217,7 @@ void lift_bc(std::span<T> b, const Form<T, U>& a, mdspan2_t x_dofmap,
                             std::pair<std::span<const T>, int>>& coefficients,
              std::span<const T> bc_values1,
              std::span<const std::int8_t> bc_markers1, std::span<const T> x0,
-             T scale)
+             T scale, auto&& include)
 {
   // Integration domain mesh
   std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
@@ -968,44 +1253,34 @@ void lift_bc(std::span<T> b, const Form<T, U>& a, mdspan2_t x_dofmap,
   }
 
   fem::DofTransformKernel<T> auto P0
-      = element0->template dof_transformation_fn<T>(doftransform::standard);
+      = element0->template precomputed_dof_transformation_fn<T>(
+          doftransform::standard, cell_info0);
   fem::DofTransformKernel<T> auto P1T
-      = element1->template dof_transformation_right_fn<T>(
-          doftransform::transpose);
+      = element1->template precomputed_dof_transformation_right_fn<T>(
+          doftransform::transpose, cell_info1);
 
   for (int i : a.integral_ids(IntegralType::cell))
   {
+    if (!include(IntegralType::cell, i))
+      continue;
+
     auto kernel = a.kernel(IntegralType::cell, i);
     assert(kernel);
     auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
     std::span<const std::int32_t> cells = a.domain(IntegralType::cell, i);
-    if (bs0 == 1 and bs1 == 1)
-    {
-      _lift_bc_cells<T, 1, 1>(
-          b, x_dofmap, x, kernel, cells,
-          {dofmap0, bs0, a.domain(IntegralType::cell, i, *mesh0)}, P0,
-          {dofmap1, bs1, a.domain(IntegralType::cell, i, *mesh1)}, P1T,
-          constants, coeffs, cstride, cell_info0, cell_info1, bc_values1,
-          bc_markers1, x0, scale);
-    }
-    else if (bs0 == 3 and bs1 == 3)
-    {
-      _lift_bc_cells<T, 3, 3>(
-          b, x_dofmap, x, kernel, cells,
-          {dofmap0, bs0, a.domain(IntegralType::cell, i, *mesh0)}, P0,
-          {dofmap1, bs1, a.domain(IntegralType::cell, i, *mesh1)}, P1T,
-          constants, coeffs, cstride, cell_info0, cell_info1, bc_values1,
-          bc_markers1, x0, scale);
-    }
-    else
-    {
-      _lift_bc_cells(b, x_dofmap, x, kernel, cells,
-                     {dofmap0, bs0, a.domain(IntegralType::cell, i, *mesh0)},
-                     P0,
-                     {dofmap1, bs1, a.domain(IntegralType::cell, i, *mesh1)},
-                     P1T, constants, coeffs, cstride, cell_info0, cell_info1,
-                     bc_values1, bc_markers1, x0, scale);
-    }
+    std::span<const std::int32_t> cells0
+        = a.domain(IntegralType::cell, i, *mesh0);
+    std::span<const std::int32_t> cells1
+        = a.domain(IntegralType::cell, i, *mesh1);
+    dispatch_bs(
+        bs0, bs1,
+        [&](auto _bs0, auto _bs1)
+        {
+          _lift_bc_cells<T, decltype(_bs0)::value, decltype(_bs1)::value>(
+              b, x_dofmap, x, kernel, cells, {dofmap0, bs0, cells0}, P0,
+              {dofmap1, bs1, cells1}, P1T, constants, coeffs, cstride,
+              cell_info0, cell_info1, bc_values1, bc_markers1, x0, scale);
+        });
   }
 
   std::span<const std::uint8_t> perms;
@@ -1020,35 +1295,80 @@ void lift_bc(std::span<T> b, const Form<T, U>& a, mdspan2_t x_dofmap,
       = mesh::cell_num_entities(cell_type, mesh->topology()->dim() - 1);
   for (int i : a.integral_ids(IntegralType::exterior_facet))
   {
+    if (!include(IntegralType::exterior_facet, i))
+      continue;
+
     auto kernel = a.kernel(IntegralType::exterior_facet, i);
     assert(kernel);
     auto& [coeffs, cstride]
         = coefficients.at({IntegralType::exterior_facet, i});
-    _lift_bc_exterior_facets(
-        b, x_dofmap, x, num_facets_per_cell, kernel,
-        a.domain(IntegralType::exterior_facet, i),
-        {dofmap0, bs0, a.domain(IntegralType::exterior_facet, i, *mesh0)}, P0,
-        {dofmap1, bs1, a.domain(IntegralType::exterior_facet, i, *mesh1)}, P1T,
-        constants, coeffs, cstride, cell_info0, cell_info1, bc_values1,
-        bc_markers1, x0, scale, perms);
+    std::span<const std::int32_t> facets
+        = a.domain(IntegralType::exterior_facet, i);
+    std::span<const std::int32_t> facets0
+        = a.domain(IntegralType::exterior_facet, i, *mesh0);
+    std::span<const std::int32_t> facets1
+        = a.domain(IntegralType::exterior_facet, i, *mesh1);
+    dispatch_bs(
+        bs0, bs1,
+        [&](auto _bs0, auto _bs1)
+        {
+          _lift_bc_exterior_facets<T, decltype(_bs0)::value,
+                                   decltype(_bs1)::value>(
+              b, x_dofmap, x, num_facets_per_cell, kernel, facets,
+              {dofmap0, bs0, facets0}, P0, {dofmap1, bs1, facets1}, P1T,
+              constants, coeffs, cstride, cell_info0, cell_info1, bc_values1,
+              bc_markers1, x0, scale, perms);
+        });
   }
 
   for (int i : a.integral_ids(IntegralType::interior_facet))
   {
+    if (!include(IntegralType::interior_facet, i))
+      continue;
+
     auto kernel = a.kernel(IntegralType::interior_facet, i);
     assert(kernel);
     auto& [coeffs, cstride]
         = coefficients.at({IntegralType::interior_facet, i});
-    _lift_bc_interior_facets(
-        b, x_dofmap, x, num_facets_per_cell, kernel,
-        a.domain(IntegralType::interior_facet, i),
-        {dofmap0, bs0, a.domain(IntegralType::interior_facet, i, *mesh0)}, P0,
-        {dofmap1, bs1, a.domain(IntegralType::interior_facet, i, *mesh1)}, P1T,
-        constants, coeffs, cstride, cell_info0, cell_info1, perms, bc_values1,
-        bc_markers1, x0, scale);
+    std::span<const std::int32_t> facets
+        = a.domain(IntegralType::interior_facet, i);
+    std::span<const std::int32_t> facets0
+        = a.domain(IntegralType::interior_facet, i, *mesh0);
+    std::span<const std::int32_t> facets1
+        = a.domain(IntegralType::interior_facet, i, *mesh1);
+    dispatch_bs(
+        bs0, bs1,
+        [&](auto _bs0, auto _bs1)
+        {
+          _lift_bc_interior_facets<T, decltype(_bs0)::value,
+                                   decltype(_bs1)::value>(
+              b, x_dofmap, x, num_facets_per_cell, kernel, facets,
+              {dofmap0, bs0, facets0}, P0, {dofmap1, bs1, facets1}, P1T,
+              constants, coeffs, cstride, cell_info0, cell_info1, perms,
+              bc_values1, bc_markers1, x0, scale);
+        });
   }
 }
 
+/// Modify RHS vector to account for boundary condition such that:
+///
+/// b <- b - scale * A (x_bc - x0)
+///
+/// @note See lift_bc above for a description of the arguments.
+template <dolfinx::scalar T, std::floating_point U>
+void lift_bc(std::span<T> b, const Form<T, U>& a, mdspan2_t x_dofmap,
+             std::span<const scalar_value_type_t<T>> x,
+             std::span<const T> constants,
+             const std::map<std::pair<IntegralType, int>,
+                            std::pair<std::span<const T>, int>>& coefficients,
+             std::span<const T> bc_values1,
+             std::span<const std::int8_t> bc_markers1, std::span<const T> x0,
+             T scale)
+{
+  lift_bc(b, a, x_dofmap, x, constants, coefficients, bc_values1, bc_markers1,
+          x0, scale, [](IntegralType, int) { return true; });
+}
+
 /// Modify b such that:
 ///
 ///   b <- b - scale * A_j (g_j - x0_j)
@@ -1092,7 +1412,7 @@ void apply_lifting(
 
   for (std::size_t j = 0; j < a.size(); ++j)
   {
-    std::vector<std::int8_t> bc_markers1;
+    std::vector<std::int8_t> markers1;
     std::vector<T> bc_values1;
     if (a[j] and !bcs1[j].empty())
     {
@@ -1111,13 +1431,21 @@ void apply_lifting(
       const int bs1 = V1->dofmap()->index_map_bs();
       assert(map1);
       const int crange = bs1 * (map1->size_local() + map1->num_ghosts());
-      bc_markers1.assign(crange, false);
+      // Use the cached markers of a single boundary condition
+      std::span<const std::int8_t> bc_markers1;
+      if (bcs1[j].size() == 1)
+        bc_markers1 = bcs1[j].front()->dof_markers();
+      else
+      {
+        markers1.assign(crange, false);
+        for (const std::shared_ptr<const DirichletBC<T, U>>& bc : bcs1[j])
+          bc->mark_dofs(markers1);
+        bc_markers1 = markers1;
+      }
+
       bc_values1.assign(crange, 0);
       for (const std::shared_ptr<const DirichletBC<T, U>>& bc : bcs1[j])
-      {
-        bc->mark_dofs(bc_markers1);
         bc->dof_values(bc_values1);
-      }
 
       if (!x0.empty())
       {
@@ -1133,7 +1461,25 @@ void apply_lifting(
   }
 }
 
-/// Assemble linear form into a vector
+/// @brief Assemble linear form into a vector, with the execution of
+/// each integral delegated to a function.
+///
+/// For each integral, `execute(type, id, dofmap0, entities, coeffs,
+/// assemble)` is called, where `dofmap0` is the test function dofmap,
+/// `entities` holds the integration entities in the integration domain
+/// mesh and in the test function mesh, and `coeffs` are the packed
+/// coefficients. The function `assemble(e, c)` assembles the entities
+/// `e` (with the layout of `entities`) with packed coefficients `c`.
+/// The executor can, for example, assemble subsets of the entities or
+/// assemble concurrently.
+///
+/// If `fuse` is true, the facet integrals of each group of
+/// Form::integral_groups are executed together: `execute` is called
+/// once for the group with the ID of its first integral, the entities
+/// of the group and the concatenated coefficients. Executors that use
+/// the ID to look up data for the entities of an integral must not be
+/// used with `fuse`.
+///
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
 /// @param[in] L The linear forms to assemble into b
@@ -1141,12 +1487,18 @@ void apply_lifting(
 /// @param[in] x Mesh coordinates
 /// @param[in] constants Packed constants that appear in `L`
 /// @param[in] coefficients Packed coefficients that appear in `L`
-template <dolfinx::scalar T, std::floating_point U>
-void assemble_vector(
-    std::span<T> b, const Form<T, U>& L, mdspan2_t x_dofmap,
+/// @param[in] execute Function that executes the assembly of an
+/// integral.
+/// @param[in] fuse True to execute groups of facet integrals with the
+/// same kernel together.
+template <dolfinx::scalar T, std::floating_point U, typename E,
+          dolfinx::scalar V = T>
+void assemble_vector_integrals(
+    std::span<V> b, const Form<T, U>& L, mdspan2_t x_dofmap,
     std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
     const std::map<std::pair<IntegralType, int>,
-                   std::pair<std::span<const T>, int>>& coefficients)
+                   std::pair<std::span<const T>, int>>& coefficients,
+    E execute, bool fuse = false)
 {
   // Integration domain mesh
   std::shared_ptr<const mesh::Mesh<U>> mesh = L.mesh();
@@ -1166,9 +1518,6 @@ void assemble_vector(
   auto dofs = dofmap->map();
   const int bs = dofmap->bs();
 
-  fem::DofTransformKernel<T> auto P0
-      = element->template dof_transformation_fn<T>(doftransform::standard);
-
   std::span<const std::uint32_t> cell_info0;
   if (element->needs_dof_transformations() or L.needs_facet_permutations())
   {
@@ -1176,32 +1525,68 @@ void assemble_vector(
     cell_info0 = std::span(mesh0->topology()->get_cell_permutation_info());
   }
 
+  fem::DofTransformKernel<T> auto P0
+      = element->template precomputed_dof_transformation_fn<T>(
+          doftransform::standard, cell_info0);
+
   for (int i : L.integral_ids(IntegralType::cell))
   {
     auto fn = L.kernel(IntegralType::cell, i);
     assert(fn);
     auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
     std::span<const std::int32_t> cells = L.domain(IntegralType::cell, i);
-    if (bs == 1)
-    {
-      impl::assemble_cells<T, 1>(
-          P0, b, x_dofmap, x, cells,
-          {dofs, bs, L.domain(IntegralType::cell, i, *mesh0)}, fn, constants,
-          coeffs, cstride, cell_info0);
-    }
-    else if (bs == 3)
-    {
-      impl::assemble_cells<T, 3>(
-          P0, b, x_dofmap, x, cells,
-          {dofs, bs, L.domain(IntegralType::cell, i, *mesh0)}, fn, constants,
-          coeffs, cstride, cell_info0);
-    }
-    else
+    std::span<const std::int32_t> cells0
+        = L.domain(IntegralType::cell, i, *mesh0);
+    auto batch = L.batch_kernel(IntegralType::cell, i);
+
+    // Cached coordinate dofs are ordered as the (unpermuted) cells
+    std::span<const U> packed_x;
+    const mesh::CompactCoordinates<float>* x_compact = nullptr;
+    if (x.data() == mesh->geometry().x().data())
     {
-      impl::assemble_cells(P0, b, x_dofmap, x, cells,
-                           {dofs, bs, L.domain(IntegralType::cell, i, *mesh0)},
-                           fn, constants, coeffs, cstride, cell_info0);
+      packed_x = L.coordinate_dofs(i);
+      x_compact = L.compact_coordinates();
     }
+
+    KernelCost cost = impl::kernel_cost<T, U>(
+        L.kernel_flops(IntegralType::cell, i), 1,
+        {{dofs.extent(1), bs}}, cstride, x_dofmap.extent(1));
+    if (batch.first)
+      cost = {batch.second * cost.flops, batch.second * cost.bytes};
+    impl::profile_integral(
+        "vector", "cell", i, cost,
+        [&](auto kernel, auto transformation, auto)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 2> e,
+                              std::span<const T> c)
+          {
+            std::span<const U> _x = e[0].data() == cells.data()
+                                        ? packed_x
+                                        : std::span<const U>();
+            if (batch.first)
+            {
+              impl::assemble_cells_batched(
+                  transformation(P0), b, x_dofmap, x, e[0], {dofs, bs, e[1]},
+                  kernel(batch.first), batch.second, constants, c, cstride,
+                  cell_info0);
+            }
+            else
+            {
+              dispatch_bs(bs,
+                          [&](auto _bs)
+                          {
+                            impl::assemble_cells<T, decltype(_bs)::value>(
+                                transformation(P0), b, x_dofmap, x, e[0],
+                                {dofs, bs, e[1]}, kernel(fn), constants, c,
+                                cstride, cell_info0, _x, x_compact);
+                          });
+            }
+          };
+
+          execute(IntegralType::cell, i, dofs,
+                  std::array<std::span<const std::int32_t>, 2>{cells, cells0},
+                  coeffs, assemble);
+        });
   }
 
   std::span<const std::uint8_t> perms;
@@ -1214,92 +1599,467 @@ void assemble_vector(
   mesh::CellType cell_type = mesh->topology()->cell_type();
   int num_facets_per_cell
       = mesh::cell_num_entities(cell_type, mesh->topology()->dim() - 1);
-  for (int i : L.integral_ids(IntegralType::exterior_facet))
+
+  // Storage for the concatenated coefficients of groups of integrals
+  std::vector<T> group_coeffs;
+  auto exterior_facets = [&](const integral_group& g)
   {
+    const int i = g.ids.front();
     auto fn = L.kernel(IntegralType::exterior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
-        = coefficients.at({IntegralType::exterior_facet, i});
+    auto [coeffs, cstride] = group_coefficients(
+        IntegralType::exterior_facet, g, coefficients, group_coeffs);
     std::span<const std::int32_t> facets
-        = L.domain(IntegralType::exterior_facet, i);
-    if (bs == 1)
-    {
-      impl::assemble_exterior_facets<T, 1>(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {dofs, bs, L.domain(IntegralType::exterior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
-    }
-    else if (bs == 3)
-    {
-      impl::assemble_exterior_facets<T, 3>(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {dofs, bs, L.domain(IntegralType::exterior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
-    }
-    else
-    {
-      impl::assemble_exterior_facets(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {dofs, bs, L.domain(IntegralType::exterior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
-    }
-  }
-
-  for (int i : L.integral_ids(IntegralType::interior_facet))
+        = L.domain(IntegralType::exterior_facet, g);
+    std::span<const std::int32_t> facets0
+        = L.domain(IntegralType::exterior_facet, g, *mesh0);
+    KernelCost cost = impl::kernel_cost<T, U>(
+        L.kernel_flops(IntegralType::exterior_facet, i), 1,
+        {{dofs.extent(1), bs}}, cstride, x_dofmap.extent(1));
+    impl::profile_integral(
+        "vector", "exterior facet", i, cost,
+        [&](auto kernel, auto transformation, auto)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 2> e,
+                              std::span<const T> c)
+          {
+            dispatch_bs(
+                bs,
+                [&](auto _bs)
+                {
+                  impl::assemble_exterior_facets<T, decltype(_bs)::value>(
+                      transformation(P0), b, x_dofmap, x, num_facets_per_cell,
+                      e[0], {dofs, bs, e[1]}, kernel(fn), constants, c,
+                      cstride, cell_info0, perms);
+                });
+          };
+
+          execute(IntegralType::exterior_facet, i, dofs,
+                  std::array<std::span<const std::int32_t>, 2>{facets,
+                                                               facets0},
+                  coeffs, assemble);
+        });
+  };
+  for_each_integral_group(L, IntegralType::exterior_facet, fuse,
+                          exterior_facets);
+
+  auto interior_facets = [&](const integral_group& g)
   {
+    const int i = g.ids.front();
     auto fn = L.kernel(IntegralType::interior_facet, i);
     assert(fn);
-    auto& [coeffs, cstride]
-        = coefficients.at({IntegralType::interior_facet, i});
+    auto [coeffs, cstride] = group_coefficients(
+        IntegralType::interior_facet, g, coefficients, group_coeffs);
     std::span<const std::int32_t> facets
-        = L.domain(IntegralType::interior_facet, i);
-    if (bs == 1)
-    {
-      impl::assemble_interior_facets<T, 1>(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {*dofmap, bs, L.domain(IntegralType::interior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
-    }
-    else if (bs == 3)
-    {
-      impl::assemble_interior_facets<T, 3>(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {*dofmap, bs, L.domain(IntegralType::interior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
-    }
-    else
+        = L.domain(IntegralType::interior_facet, g);
+    std::span<const std::int32_t> facets0
+        = L.domain(IntegralType::interior_facet, g, *mesh0);
+
+    // Cached facet data is ordered as the (unpermuted) facets
+    const facet_pair_data* pairs = L.facet_pairs(g);
+    const std::vector<std::int32_t> no_dofs;
+    const std::vector<std::uint8_t> no_perms;
+    KernelCost cost = impl::kernel_cost<T, U>(
+        L.kernel_flops(IntegralType::interior_facet, i), 2,
+        {{dofs.extent(1), bs}}, cstride, x_dofmap.extent(1));
+    impl::profile_integral(
+        "vector", "interior facet", i, cost,
+        [&](auto kernel, auto transformation, auto)
+        {
+          auto assemble = [&](std::array<std::span<const std::int32_t>, 2> e,
+                              std::span<const T> c)
+          {
+            const bool cached = pairs and e[0].data() == facets.data();
+            dispatch_bs(
+                bs,
+                [&](auto _bs)
+                {
+                  impl::assemble_interior_facets<T, decltype(_bs)::value>(
+                      transformation(P0), b, x_dofmap, x, num_facets_per_cell,
+                      e[0], {*dofmap, bs, e[1]}, kernel(fn), constants, c,
+                      cstride, cell_info0, perms,
+                      cached ? pairs->dofs[0] : no_dofs,
+                      cached ? pairs->perms : no_perms);
+                });
+          };
+
+          execute(IntegralType::interior_facet, i, dofs,
+                  std::array<std::span<const std::int32_t>, 2>{facets,
+                                                               facets0},
+                  coeffs, assemble);
+        });
+  };
+  for_each_integral_group(L, IntegralType::interior_facet, fuse,
+                          interior_facets);
+}
+
+/// Assemble linear form into a vector
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] x_dofmap Mesh geometry dofmap
+/// @param[in] x Mesh coordinates
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Packed coefficients that appear in `L`
+/// @param[in] num_threads Number of threads. If greater than one, the
+/// integration entities are coloured and entities of the same colour
+/// are assembled concurrently (see impl::assemble_threaded).
+template <dolfinx::scalar T, std::floating_point U, dolfinx::scalar V = T>
+void assemble_vector(
+    std::span<V> b, const Form<T, U>& L, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    int num_threads = 1)
+{
+  assemble_vector_integrals(
+      b, L, x_dofmap, x, constants, coefficients,
+      [&L, num_threads](
+          IntegralType type, int id, mdspan2_t dofmap0,
+          std::array<std::span<const std::int32_t>, 2> entities,
+          std::span<const T> coeffs, auto&& assemble)
+      {
+        if (num_threads > 1)
+        {
+          // The colouring is cached on the form
+          const graph::AdjacencyList<std::int32_t>& colours
+              = L.entity_colouring(
+                  type, id, entities[1].size() / entity_stride(type),
+                  [&]()
+                  { return colour_entities(dofmap0, entities[1], type); });
+          impl::assemble_threaded<T, 2>(type, colours, entities, coeffs,
+                                        num_threads, assemble);
+        }
+        else
+          assemble(entities, coeffs);
+      },
+      true);
+}
+
+/// @brief Compute a split of the integration entities of a linear
+/// form into entities that contribute to ghost entries of the vector
+/// and entities that only contribute to owned entries.
+///
+/// @param[in] L The linear form.
+/// @return For each integral `(type, id)`, positions of the entities
+/// in Form::domain, ordered such that the entities contributing to
+/// ghost entries come first, and the number of such entities.
+template <dolfinx::scalar T, std::floating_point U>
+std::map<std::pair<IntegralType, int>,
+         std::pair<std::vector<std::int32_t>, std::int32_t>>
+interface_partition(const Form<T, U>& L)
+{
+  auto mesh0 = L.function_spaces().at(0)->mesh();
+  assert(mesh0);
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  auto dofs = dofmap->map();
+  const std::int32_t size_local = dofmap->index_map->size_local();
+
+  std::map<std::pair<IntegralType, int>,
+           std::pair<std::vector<std::int32_t>, std::int32_t>>
+      partition;
+  for (IntegralType type : {IntegralType::cell, IntegralType::exterior_facet,
+                            IntegralType::interior_facet})
+  {
+    const int stride = entity_stride(type);
+    const int num_cells = type == IntegralType::interior_facet ? 2 : 1;
+    for (int i : L.integral_ids(type))
     {
-      impl::assemble_interior_facets(
-          P0, b, x_dofmap, x, num_facets_per_cell, facets,
-          {*dofmap, bs, L.domain(IntegralType::interior_facet, i, *mesh0)}, fn,
-          constants, coeffs, cstride, cell_info0, perms);
+      std::span<const std::int32_t> entities0 = L.domain(type, i, *mesh0);
+      std::vector<std::int32_t> interface, interior;
+      for (std::size_t e = 0; e < entities0.size() / stride; ++e)
+      {
+        bool ghost = false;
+        for (int k = 0; k < num_cells; ++k)
+        {
+          std::int32_t c = entities0[e * stride + 2 * k];
+          for (std::size_t j = 0; j < dofs.extent(1); ++j)
+            ghost = ghost or dofs(c, j) >= size_local;
+        }
+
+        if (ghost)
+          interface.push_back(e);
+        else
+          interior.push_back(e);
+      }
+
+      const std::int32_t num_interface = interface.size();
+      interface.insert(interface.end(), interior.begin(), interior.end());
+      partition.insert({{type, i}, {std::move(interface), num_interface}});
     }
   }
+
+  return partition;
 }
 
-/// @brief Assemble linear form into a vector
+/// @brief Assemble a subset of the entities of each integral of a
+/// linear form into a vector.
+///
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
 /// @param[in] L The linear forms to assemble into b
+/// @param[in] x_dofmap Mesh geometry dofmap
+/// @param[in] x Mesh coordinates
 /// @param[in] constants Packed constants that appear in `L`
 /// @param[in] coefficients Packed coefficients that appear in `L`
+/// @param[in] partition Partition of the entities computed by
+/// interface_partition.
+/// @param[in] interface If `true` assemble the entities that contribute
+/// to ghost entries, otherwise assemble the remaining entities.
 template <dolfinx::scalar T, std::floating_point U>
 void assemble_vector(
-    std::span<T> b, const Form<T, U>& L, std::span<const T> constants,
+    std::span<T> b, const Form<T, U>& L, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
     const std::map<std::pair<IntegralType, int>,
-                   std::pair<std::span<const T>, int>>& coefficients)
+                   std::pair<std::vector<std::int32_t>, std::int32_t>>&
+        partition,
+    bool interface)
+{
+  assemble_vector_integrals(
+      b, L, x_dofmap, x, constants, coefficients,
+      [&partition, interface](
+          IntegralType type, int id, mdspan2_t,
+          std::array<std::span<const std::int32_t>, 2> entities,
+          std::span<const T> coeffs, auto&& assemble)
+      {
+        auto& [perm, num_interface] = partition.at({type, id});
+        std::span<const std::int32_t> pos(perm);
+        pos = interface ? pos.first(num_interface) : pos.subspan(num_interface);
+        if (pos.empty())
+          return;
+
+        const int stride = entity_stride(type);
+        const std::size_t cstride = coeffs.size() / perm.size();
+        std::vector<std::int32_t> e0 = gather_rows(entities[0], stride, pos);
+        std::vector<std::int32_t> e1 = gather_rows(entities[1], stride, pos);
+        std::vector<T> c = gather_rows(coeffs, cstride, pos);
+        assemble({e0, e1}, c);
+      });
+}
+
+/// @brief Assemble linear form into a vector
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Packed coefficients that appear in `L`
+/// @param[in] num_threads Number of threads used for assembly
+template <dolfinx::scalar T, std::floating_point U, dolfinx::scalar V = T>
+void assemble_vector(
+    std::span<V> b, const Form<T, U>& L, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    int num_threads = 1)
 {
   std::shared_ptr<const mesh::Mesh<U>> mesh = L.mesh();
   assert(mesh);
   if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
     assemble_vector(b, L, mesh->geometry().dofmap(), mesh->geometry().x(),
-                    constants, coefficients);
+                    constants, coefficients, num_threads);
   else
   {
     auto x = mesh->geometry().x();
     std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
     assemble_vector(b, L, mesh->geometry().dofmap(), _x, constants,
-                    coefficients);
+                    coefficients, num_threads);
+  }
+}
+
+/// @brief Assemble a linear form for several sets of coefficient
+/// values into interleaved vectors.
+///
+/// Cell integrals are assembled in one traversal of the cells (see
+/// assemble_cells_multi), and batched kernels are not used. Facet
+/// integrals are assembled for each set of coefficients in turn.
+///
+/// @param[in,out] b Vectors to accumulate into. Entry `i` of vector `j`
+/// is at position `i * coefficients.size() + j`.
+/// @param[in] L The linear form.
+/// @param[in] x_dofmap Mesh geometry dofmap.
+/// @param[in] x Mesh coordinates.
+/// @param[in] constants Packed constants that appear in `L`, which are
+/// the same for all vectors.
+/// @param[in] coefficients Packed coefficients that appear in `L`, for
+/// each vector.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_vectors(
+    std::span<T> b, const Form<T, U>& L, mdspan2_t x_dofmap,
+    std::span<const scalar_value_type_t<T>> x, std::span<const T> constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<std::span<const T>, int>>>&
+        coefficients)
+{
+  const std::size_t num_rhs = coefficients.size();
+  if (num_rhs == 0)
+    return;
+
+  // Integration domain mesh
+  std::shared_ptr<const mesh::Mesh<U>> mesh = L.mesh();
+  assert(mesh);
+
+  // Test function mesh
+  auto mesh0 = L.function_spaces().at(0)->mesh();
+  assert(mesh0);
+
+  // Get dofmap data
+  auto element = L.function_spaces().at(0)->element();
+  assert(element);
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  auto dofs = dofmap->map();
+  const int bs = dofmap->bs();
+
+  std::span<const std::uint32_t> cell_info0;
+  if (element->needs_dof_transformations() or L.needs_facet_permutations())
+  {
+    mesh0->topology_mutable()->create_entity_permutations();
+    cell_info0 = std::span(mesh0->topology()->get_cell_permutation_info());
+  }
+
+  fem::DofTransformKernel<T> auto P0
+      = element->template precomputed_dof_transformation_fn<T>(
+          doftransform::standard, cell_info0);
+
+  for (int i : L.integral_ids(IntegralType::cell))
+  {
+    auto fn = L.kernel(IntegralType::cell, i);
+    assert(fn);
+    std::vector<std::span<const T>> coeffs;
+    int cstride = 0;
+    for (auto& c : coefficients)
+    {
+      auto& [coeffs_j, cstride_j] = c.at({IntegralType::cell, i});
+      coeffs.push_back(coeffs_j);
+      cstride = cstride_j;
+    }
+    std::span<const std::int32_t> cells = L.domain(IntegralType::cell, i);
+    std::span<const std::int32_t> cells0
+        = L.domain(IntegralType::cell, i, *mesh0);
+
+    // Cached coordinate dofs are ordered as the (unpermuted) cells
+    std::span<const U> packed_x;
+    const mesh::CompactCoordinates<float>* x_compact = nullptr;
+    if (x.data() == mesh->geometry().x().data())
+    {
+      packed_x = L.coordinate_dofs(i);
+      x_compact = L.compact_coordinates();
+    }
+
+    KernelCost cost = impl::kernel_cost<T, U>(
+        L.kernel_flops(IntegralType::cell, i), 1, {{dofs.extent(1), bs}},
+        cstride, x_dofmap.extent(1));
+    impl::profile_integral(
+        "vectors", "cell", i, cost,
+        [&](auto kernel, auto transformation, auto)
+        {
+          impl::assemble_cells_multi<T>(
+              transformation(P0), b, x_dofmap, x, cells, {dofs, bs, cells0},
+              kernel(fn), constants,
+              std::span<const std::span<const T>>(coeffs), cstride,
+              cell_info0, packed_x, x_compact);
+        });
+  }
+
+  // Facet integrals, for each set of coefficients
+  if (L.integral_ids(IntegralType::exterior_facet).empty()
+      and L.integral_ids(IntegralType::interior_facet).empty())
+  {
+    return;
+  }
+
+  std::vector<T> bj(b.size() / num_rhs);
+  for (std::size_t j = 0; j < num_rhs; ++j)
+  {
+    std::ranges::fill(bj, 0);
+    assemble_vector_integrals(
+        std::span(bj), L, x_dofmap, x, constants, coefficients[j],
+        [](IntegralType type, int, mdspan2_t,
+           std::array<std::span<const std::int32_t>, 2> entities,
+           std::span<const T> coeffs, auto&& assemble)
+        {
+          if (type != IntegralType::cell)
+            assemble(entities, coeffs);
+        },
+        true);
+    for (std::size_t k = 0; k < bj.size(); ++k)
+      b[k * num_rhs + j] += bj[k];
+  }
+}
+
+/// @brief Assemble a linear form for several sets of coefficient
+/// values into interleaved vectors.
+/// @note See assemble_vectors above for a description of the arguments.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_vectors(
+    std::span<T> b, const Form<T, U>& L, std::span<const T> constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<std::span<const T>, int>>>&
+        coefficients)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = L.mesh();
+  assert(mesh);
+  if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+  {
+    assemble_vectors(b, L, mesh->geometry().dofmap(), mesh->geometry().x(),
+                     constants, coefficients);
+  }
+  else
+  {
+    auto x = mesh->geometry().x();
+    std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+    assemble_vectors(b, L, mesh->geometry().dofmap(), _x, constants,
+                     coefficients);
+  }
+}
+/// @brief Assemble a linear form over groups of cells of the same cell
+/// type into a vector.
+///
+/// One loop is executed for each group, with the block size of the
+/// test function dofmap as a compile-time constant when possible. The
+/// kernels must not require dof transformations.
+///
+/// @param[in,out] b The vector to accumulate into.
+/// @param[in] groups Cell groups, e.g. one for each cell type of a
+/// mixed-topology mesh (see create_cell_groups).
+/// @param[in] x Mesh geometry (coordinates).
+/// @param[in] constants The constant data.
+template <dolfinx::scalar T>
+void assemble_vector(std::span<T> b, const std::vector<CellGroup<T>>& groups,
+                     std::span<const scalar_value_type_t<T>> x,
+                     std::span<const T> constants)
+{
+  auto P0 = [](std::span<T>, std::span<const std::uint32_t>, std::int32_t,
+               int) {};
+  for (const CellGroup<T>& g : groups)
+  {
+    std::span<const std::int32_t> cells(g.cells);
+    if (g.batch_kernel)
+    {
+      dispatch_bs(g.bs[0],
+                  [&](auto _bs)
+                  {
+                    impl::assemble_cells_batched<T, decltype(_bs)::value>(
+                        P0, b, g.x_dofmap, x, cells,
+                        {g.dofmaps[0], g.bs[0], cells}, g.batch_kernel,
+                        g.batch_size, constants, g.coeffs, g.cstride, {});
+                  });
+    }
+    else
+    {
+      dispatch_bs(g.bs[0],
+                  [&](auto _bs)
+                  {
+                    impl::assemble_cells<T, decltype(_bs)::value>(
+                        P0, b, g.x_dofmap, x, cells,
+                        {g.dofmaps[0], g.bs[0], cells}, g.kernel, constants,
+                        g.coeffs, g.cstride, {});
+                  });
+    }
   }
 }
 } // namespace dolfinx::fem::impl
@@ -6,16 +6,29 @@
 
 #pragma once
 
+#include "CellGroup.h"
+#include "DofMap.h"
 #include "assemble_matrix_impl.h"
 #include "assemble_scalar_impl.h"
+#include "assemble_system_impl.h"
 #include "assemble_vector_impl.h"
 #include "traits.h"
 #include "utils.h"
 #include <algorithm>
 #include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/common/types.h>
+#include <dolfinx/la/BlockMatrixCSR.h>
+#include <dolfinx/la/MultiVector.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <functional>
+#include <map>
 #include <memory>
 #include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::fem
@@ -87,13 +100,103 @@ T assemble_scalar(
 template <dolfinx::scalar T, std::floating_point U>
 T assemble_scalar(const Form<T, U>& M)
 {
-  const std::vector<T> constants = pack_constants(M);
+  std::span<const T> constants = M.packed_constants();
   auto coefficients = allocate_coefficient_storage(M);
   pack_coefficients(M, coefficients);
   return assemble_scalar(M, std::span(constants),
                          make_coefficients_span(coefficients));
 }
 
+/// @brief Assemble several functionals into scalars.
+///
+/// The cell integrals of all functionals with the same mesh and
+/// integration cells are assembled in one pass over the cells, i.e.
+/// the cell geometry is gathered once for all kernels. Facet integrals
+/// are assembled for each functional.
+///
+/// @note Caller is responsible for accumulation across processes (see
+/// assemble_scalars_begin).
+/// @param[in] M The forms (functionals) to assemble
+/// @return The contribution to each form (functional) from the local
+/// process
+template <dolfinx::scalar T, std::floating_point U>
+std::vector<T> assemble_scalars(std::span<const Form<T, U>* const> M)
+{
+  std::vector<std::span<const T>> constants;
+  std::vector<decltype(allocate_coefficient_storage(*M.front()))> coeffs;
+  std::vector<decltype(make_coefficients_span(coeffs.front()))> coeff_spans;
+  constants.reserve(M.size());
+  coeffs.reserve(M.size());
+  coeff_spans.reserve(M.size());
+  for (const Form<T, U>* form : M)
+  {
+    assert(form);
+    constants.push_back(form->packed_constants());
+    pack_coefficients(*form, coeffs.emplace_back(
+                                 allocate_coefficient_storage(*form)));
+    coeff_spans.push_back(make_coefficients_span(coeffs.back()));
+  }
+
+  std::vector<T> values(M.size(), 0);
+  impl::assemble_scalars(std::span(values), M,
+                         std::span<const std::span<const T>>(constants),
+                         std::span(std::as_const(coeff_spans)));
+  return values;
+}
+
+/// @brief Start the assembly of several functionals, summed over
+/// processes.
+///
+/// The local contributions are assembled (see assemble_scalars) and a
+/// single nonblocking sum over all processes is started, so that the
+/// caller can do other work while the values are reduced.
+///
+/// @note Collective.
+/// @param[out] values The functional values, of size `M.size()`. They
+/// must not be accessed until assemble_scalars_end has been called.
+/// @param[in] comm Communicator to sum over
+/// @param[in] M The forms (functionals) to assemble
+/// @return Request to pass to assemble_scalars_end
+template <dolfinx::scalar T, std::floating_point U>
+MPI_Request assemble_scalars_begin(std::span<T> values, MPI_Comm comm,
+                                   std::span<const Form<T, U>* const> M)
+{
+  if (values.size() != M.size())
+    throw std::runtime_error("Number of values and functionals differ.");
+  std::vector<T> local = assemble_scalars(M);
+  std::ranges::copy(local, values.begin());
+  MPI_Request request;
+  MPI_Iallreduce(MPI_IN_PLACE, values.data(), values.size(),
+                 dolfinx::MPI::mpi_type<T>(), MPI_SUM, comm, &request);
+  return request;
+}
+
+/// @brief Complete the sum of functional values started by
+/// assemble_scalars_begin.
+/// @param[in,out] request Request returned by assemble_scalars_begin
+inline void assemble_scalars_end(MPI_Request& request)
+{
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
+/// @brief Assemble several functionals, summed over processes.
+///
+/// The values of all functionals are summed with a single reduction.
+///
+/// @note Collective.
+/// @param[in] comm Communicator to sum over
+/// @param[in] M The forms (functionals) to assemble
+/// @return The value of each form (functional)
+template <dolfinx::scalar T, std::floating_point U>
+std::vector<T> assemble_scalars(MPI_Comm comm,
+                                std::span<const Form<T, U>* const> M)
+{
+  std::vector<T> values = assemble_scalars(M);
+  MPI_Allreduce(MPI_IN_PLACE, values.data(), values.size(),
+                dolfinx::MPI::mpi_type<T>(), MPI_SUM, comm);
+  return values;
+}
+
 // -- Vectors ----------------------------------------------------------------
 
 /// @brief Assemble linear form into a vector.
@@ -101,32 +204,234 @@ T assemble_scalar(const Form<T, U>& M)
 /// The caller supplies the form constants and coefficients for this
 /// version, which has efficiency benefits if the data can be re-used
 /// for multiple calls.
+/// @tparam V Scalar type of `b`. The element vectors are computed in
+/// the scalar type `T` of the form and converted when they are added
+/// to `b`, e.g. to accumulate the vectors of a `float` form in a
+/// `double` vector.
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
 /// @param[in] L The linear forms to assemble into b
 /// @param[in] constants The constants that appear in `L`
 /// @param[in] coefficients The coefficients that appear in `L`
-template <dolfinx::scalar T, std::floating_point U>
+/// @param[in] num_threads Number of threads to use for assembly. If
+/// greater than one, cells (facets) that do not share a test function
+/// degree-of-freedom are assembled concurrently.
+template <dolfinx::scalar T, std::floating_point U, dolfinx::scalar V = T>
 void assemble_vector(
-    std::span<T> b, const Form<T, U>& L, std::span<const T> constants,
+    std::span<V> b, const Form<T, U>& L, std::span<const T> constants,
     const std::map<std::pair<IntegralType, int>,
-                   std::pair<std::span<const T>, int>>& coefficients)
+                   std::pair<std::span<const T>, int>>& coefficients,
+    int num_threads = 1)
 {
-  impl::assemble_vector(b, L, constants, coefficients);
+  common::MemoryTracker memory_tracker("Assemble vector");
+  impl::assemble_vector(b, L, constants, coefficients, num_threads);
 }
 
 /// @brief Assemble linear form into a vector
+/// @tparam V Scalar type of `b`. The element vectors are converted
+/// from the scalar type `T` of the form when they are added to `b`.
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
 /// @param[in] L The linear forms to assemble into b
-template <dolfinx::scalar T, std::floating_point U>
-void assemble_vector(std::span<T> b, const Form<T, U>& L)
+/// @param[in] num_threads Number of threads to use for assembly
+template <dolfinx::scalar T, std::floating_point U, dolfinx::scalar V = T>
+void assemble_vector(std::span<V> b, const Form<T, U>& L,
+                     int num_threads = 1)
 {
   auto coefficients = allocate_coefficient_storage(L);
-  pack_coefficients(L, coefficients);
-  const std::vector<T> constants = pack_constants(L);
+  pack_coefficients(L, coefficients, num_threads);
+  std::span<const T> constants = L.packed_constants();
   assemble_vector(b, L, std::span(constants),
-                  make_coefficients_span(coefficients));
+                  make_coefficients_span(coefficients), num_threads);
+}
+
+/// @brief Assemble a linear form for several sets of coefficient
+/// values, e.g. the realisations of a random coefficient, into
+/// interleaved vectors.
+///
+/// Cell integrals are assembled in one traversal of the cells: the
+/// geometry and dofmap of a cell are fetched once and the kernel is
+/// called for each set of coefficients. Facet integrals are assembled
+/// for each set in turn. The coefficient sets are packed with
+/// pack_coefficients, e.g.
+///
+///     std::vector<decltype(allocate_coefficient_storage(L))> c(k);
+///     std::vector<decltype(make_coefficients_span(c[0]))> coeffs;
+///     for (int j = 0; j < k; ++j)
+///     {
+///       // Set the coefficient values of realisation j, then
+///       c[j] = allocate_coefficient_storage(L);
+///       pack_coefficients(L, c[j]);
+///       coeffs.push_back(make_coefficients_span(c[j]));
+///     }
+///
+/// @param[in,out] b Vectors to assemble into, which are not zeroed.
+/// Entry `i` of vector `j` is at position `i * coefficients.size() +
+/// j`, as in la::MultiVector.
+/// @param[in] L The linear form.
+/// @param[in] constants The constants that appear in `L`, which are the
+/// same for all vectors.
+/// @param[in] coefficients The coefficients that appear in `L`, for
+/// each vector.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_vectors(
+    std::span<T> b, const Form<T, U>& L, std::span<const T> constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<std::span<const T>, int>>>&
+        coefficients)
+{
+  common::MemoryTracker memory_tracker("Assemble vectors");
+  impl::assemble_vectors(b, L, constants, coefficients);
+}
+
+/// @brief Assemble a linear form for several sets of coefficient
+/// values into a la::MultiVector.
+/// @param[in,out] b Vectors to assemble into, which are not zeroed.
+/// The number of vectors must be the number of coefficient sets.
+/// @param[in] L The linear form.
+/// @param[in] coefficients Packed coefficients for each vector (see
+/// assemble_vectors).
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_vector(
+    la::MultiVector<T>& b, const Form<T, U>& L,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<std::span<const T>, int>>>&
+        coefficients)
+{
+  if (static_cast<std::size_t>(b.num_vectors()) != coefficients.size())
+  {
+    throw std::runtime_error(
+        "Number of vectors and coefficient sets do not match");
+  }
+  assemble_vectors(b.mutable_array(), L, L.packed_constants(),
+                   coefficients);
+}
+
+/// @brief Assemble a linear form on a mixed-topology mesh into a
+/// vector, with one assembly loop for each cell type.
+///
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] groups Cell kernels, dofmaps and coefficients for each
+/// cell type (see create_cell_groups).
+/// @param[in] x Mesh geometry (coordinates), see mesh::Geometry::x.
+/// @param[in] constants The constants that appear in the form.
+template <dolfinx::scalar T>
+void assemble_vector(std::span<T> b, const std::vector<CellGroup<T>>& groups,
+                     std::span<const scalar_value_type_t<T>> x,
+                     std::span<const T> constants)
+{
+  common::MemoryTracker memory_tracker("Assemble vector");
+  impl::assemble_vector(b, groups, x, constants);
+}
+
+/// @brief Assemble a cell kernel into a vector, without a Form.
+///
+/// The kernel is any callable with the signature of Form::kernel, e.g.
+/// a lambda function. It is called directly rather than through a
+/// `std::function`, so a small kernel can be inlined by the compiler
+/// into the assembly loop over the cells. No dof transformations are
+/// applied, i.e. the element must not need them or the kernel must
+/// apply them.
+///
+/// @tparam T Scalar type.
+/// @param[in,out] b The vector to assemble into. It is not zeroed
+/// before assembly.
+/// @param[in] kernel Cell kernel.
+/// @param[in] geometry Mesh geometry.
+/// @param[in] cells Cells to execute the kernel over.
+/// @param[in] dofmap Test function dofmap.
+/// @param[in] constants Constants passed to the kernel.
+/// @param[in] coeffs Coefficient data passed to the kernel, with shape
+/// `(cells.size(), cstride)`.
+/// @param[in] cstride Coefficient stride.
+template <dolfinx::scalar T>
+void assemble_vector(std::span<T> b, FEkernel<T> auto kernel,
+                     const mesh::Geometry<scalar_value_type_t<T>>& geometry,
+                     std::span<const std::int32_t> cells,
+                     const DofMap& dofmap, std::span<const T> constants = {},
+                     std::span<const T> coeffs = {}, int cstride = 0)
+{
+  auto P0 = [](std::span<T>, std::span<const std::uint32_t>, std::int32_t,
+               int) {};
+  impl::dispatch_bs(dofmap.bs(),
+                    [&](auto _bs)
+                    {
+                      impl::assemble_cells<T, decltype(_bs)::value>(
+                          P0, b, geometry.dofmap(), geometry.x(), cells,
+                          {dofmap.map(), dofmap.bs(), cells}, kernel,
+                          constants, coeffs, cstride, {});
+                    });
+}
+
+/// @brief Compute a split of the integration entities of a linear
+/// form into entities that contribute to ghost entries of the vector
+/// and entities that only contribute to owned entries.
+///
+/// The split is used by assemble_vector_overlap and can be re-used for
+/// as long as the integration domains of `L` are unchanged. It depends
+/// only on the test space and the integration domains, and can also be
+/// passed to assemble_matrix_overlap for a bilinear form with the same
+/// test space and integration domains, where it splits the entities
+/// into those that contribute to ghost rows and the rest.
+///
+/// @param[in] L The linear form.
+/// @return For each integral `(type, id)`, positions of the entities
+/// in Form::domain, ordered such that entities that contribute to
+/// ghost entries come first, and the number of such entities.
+template <dolfinx::scalar T, std::floating_point U>
+std::map<std::pair<IntegralType, int>,
+         std::pair<std::vector<std::int32_t>, std::int32_t>>
+compute_interface_partition(const Form<T, U>& L)
+{
+  return impl::interface_partition(L);
+}
+
+/// @brief Assemble linear form into a distributed vector, overlapping
+/// the reverse scatter of ghost contributions with assembly.
+///
+/// Entities that contribute to ghost entries of `b` are assembled
+/// first, Vector::scatter_rev_begin is called, and then the remaining
+/// entities are assembled before completing the scatter. On return the
+/// owned entries of `b` hold the summed contributions, as after calling
+/// assemble_vector followed by `b.scatter_rev(std::plus<T>())`.
+///
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants The constants that appear in `L`
+/// @param[in] coefficients The coefficients that appear in `L`
+/// @param[in] partition Partition of the integration entities, computed
+/// by compute_interface_partition.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_vector_overlap(
+    la::Vector<T>& b, const Form<T, U>& L, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::vector<std::int32_t>, std::int32_t>>&
+        partition)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = L.mesh();
+  assert(mesh);
+  auto assemble = [&](std::span<const scalar_value_type_t<T>> x)
+  {
+    impl::assemble_vector(b.mutable_array(), L, mesh->geometry().dofmap(), x,
+                          constants, coefficients, partition, true);
+    b.scatter_rev_begin();
+    impl::assemble_vector(b.mutable_array(), L, mesh->geometry().dofmap(), x,
+                          constants, coefficients, partition, false);
+    b.scatter_rev_end(std::plus<T>());
+  };
+
+  if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+    assemble(mesh->geometry().x());
+  else
+  {
+    auto x = mesh->geometry().x();
+    std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+    assemble(_x);
+  }
 }
 
 // FIXME: clarify how x0 is used
@@ -186,7 +491,7 @@ void apply_lifting(
   std::vector<
       std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>>
       coeffs;
-  std::vector<std::vector<T>> constants;
+  std::vector<std::span<const T>> constants;
   for (auto _a : a)
   {
     if (_a)
@@ -194,7 +499,7 @@ void apply_lifting(
       auto coefficients = allocate_coefficient_storage(*_a);
       pack_coefficients(*_a, coefficients);
       coeffs.push_back(coefficients);
-      constants.push_back(pack_constants(*_a));
+      constants.push_back(_a->packed_constants());
     }
     else
     {
@@ -202,16 +507,13 @@ void apply_lifting(
       constants.emplace_back();
     }
   }
-
-  std::vector<std::span<const T>> _constants(constants.begin(),
-                                             constants.end());
   std::vector<std::map<std::pair<IntegralType, int>,
                        std::pair<std::span<const T>, int>>>
       _coeffs;
   std::ranges::transform(coeffs, std::back_inserter(_coeffs),
                          [](auto& c) { return make_coefficients_span(c); });
 
-  apply_lifting(b, a, _constants, _coeffs, bcs1, x0, scale);
+  apply_lifting(b, a, constants, _coeffs, bcs1, x0, scale);
 }
 
 // -- Matrices ---------------------------------------------------------------
@@ -228,6 +530,18 @@ void apply_lifting(
 /// @param[in] dof_marker1 Boundary condition markers for the columns.
 /// If bc[i] is true then rows i in A will be zeroed. The index i is a
 /// local index.
+/// @param[in] num_threads Number of threads to use for assembly. If
+/// greater than one, cells (facets) that do not share a row
+/// degree-of-freedom are assembled concurrently and `mat_add` must be
+/// safe to call concurrently for distinct rows (which is the case for
+/// la::MatrixCSR::mat_add_values, but not for PETSc matrices).
+///
+/// @note The element matrices are passed to `mat_add` in the scalar
+/// type `T` of the form. To assemble into a matrix of another
+/// precision, e.g. a `float` form into a `double` matrix or a `double`
+/// form into a `float` preconditioner matrix, use an insertion function
+/// that converts the values, such as `A.mat_add_values<1, 1, T>()` for
+/// a la::MatrixCSR `A`.
 template <dolfinx::scalar T, std::floating_point U>
 void assemble_matrix(
     la::MatSet<T> auto mat_add, const Form<T, U>& a,
@@ -235,23 +549,25 @@ void assemble_matrix(
     const std::map<std::pair<IntegralType, int>,
                    std::pair<std::span<const T>, int>>& coefficients,
     std::span<const std::int8_t> dof_marker0,
-    std::span<const std::int8_t> dof_marker1)
+    std::span<const std::int8_t> dof_marker1, int num_threads = 1)
 
 {
+  common::MemoryTracker memory_tracker("Assemble matrix");
   std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
   assert(mesh);
   if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
   {
     impl::assemble_matrix(mat_add, a, mesh->geometry().dofmap(),
                           mesh->geometry().x(), constants, coefficients,
-                          dof_marker0, dof_marker1);
+                          dof_marker0, dof_marker1, num_threads);
   }
   else
   {
     auto x = mesh->geometry().x();
     std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
     impl::assemble_matrix(mat_add, a, mesh->geometry().dofmap(), _x, constants,
-                          coefficients, dof_marker0, dof_marker1);
+                          coefficients, dof_marker0, dof_marker1,
+                          num_threads);
   }
 }
 
@@ -262,45 +578,26 @@ void assemble_matrix(
 /// @param[in] coefficients Coefficients that appear in `a`
 /// @param[in] bcs Boundary conditions to apply. For boundary condition
 ///  dofs the row and column are zeroed. The diagonal  entry is not set.
+/// @param[in] num_threads Number of threads to use for assembly
 template <dolfinx::scalar T, std::floating_point U>
 void assemble_matrix(
     auto mat_add, const Form<T, U>& a, std::span<const T> constants,
     const std::map<std::pair<IntegralType, int>,
                    std::pair<std::span<const T>, int>>& coefficients,
-    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs)
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    int num_threads = 1)
 {
-  // Index maps for dof ranges
-  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
-  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
-  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
-  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
-
-  // Build dof markers
-  std::vector<std::int8_t> dof_marker0, dof_marker1;
-  assert(map0);
-  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
-  assert(map1);
-  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
-  for (std::size_t k = 0; k < bcs.size(); ++k)
-  {
-    assert(bcs[k]);
-    assert(bcs[k]->function_space());
-    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker0.resize(dim0, false);
-      bcs[k]->mark_dofs(dof_marker0);
-    }
-
-    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker1.resize(dim1, false);
-      bcs[k]->mark_dofs(dof_marker1);
-    }
-  }
+  // Get dof markers. The cached markers of the boundary conditions
+  // are used when a single condition is applied to a space.
+  std::vector<std::int8_t> markers0, markers1;
+  std::span<const std::int8_t> dof_marker0
+      = impl::bc_dof_markers(*a.function_spaces().at(0), bcs, markers0);
+  std::span<const std::int8_t> dof_marker1
+      = impl::bc_dof_markers(*a.function_spaces().at(1), bcs, markers1);
 
   // Assemble
   assemble_matrix(mat_add, a, constants, coefficients, dof_marker0,
-                  dof_marker1);
+                  dof_marker1, num_threads);
 }
 
 /// Assemble bilinear form into a matrix
@@ -308,19 +605,21 @@ void assemble_matrix(
 /// @param[in] a The bilinear from to assemble
 /// @param[in] bcs Boundary conditions to apply. For boundary condition
 ///  dofs the row and column are zeroed. The diagonal  entry is not set.
+/// @param[in] num_threads Number of threads to use for assembly
 template <dolfinx::scalar T, std::floating_point U>
 void assemble_matrix(
     auto mat_add, const Form<T, U>& a,
-    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs)
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    int num_threads = 1)
 {
   // Prepare constants and coefficients
-  const std::vector<T> constants = pack_constants(a);
+  std::span<const T> constants = a.packed_constants();
   auto coefficients = allocate_coefficient_storage(a);
-  pack_coefficients(a, coefficients);
+  pack_coefficients(a, coefficients, num_threads);
 
   // Assemble
   assemble_matrix(mat_add, a, std::span(constants),
-                  make_coefficients_span(coefficients), bcs);
+                  make_coefficients_span(coefficients), bcs, num_threads);
 }
 
 /// @brief Assemble bilinear form into a matrix. Matrix must already be
@@ -333,21 +632,310 @@ void assemble_matrix(
 /// @param[in] dof_marker1 Boundary condition markers for the columns.
 /// If bc[i] is true then rows i in A will be zeroed. The index i is a
 /// local index.
+/// @param[in] num_threads Number of threads to use for assembly
 template <dolfinx::scalar T, std::floating_point U>
 void assemble_matrix(auto mat_add, const Form<T, U>& a,
                      std::span<const std::int8_t> dof_marker0,
-                     std::span<const std::int8_t> dof_marker1)
+                     std::span<const std::int8_t> dof_marker1,
+                     int num_threads = 1)
 
 {
   // Prepare constants and coefficients
-  const std::vector<T> constants = pack_constants(a);
+  std::span<const T> constants = a.packed_constants();
   auto coefficients = allocate_coefficient_storage(a);
-  pack_coefficients(a, coefficients);
+  pack_coefficients(a, coefficients, num_threads);
 
   // Assemble
   assemble_matrix(mat_add, a, std::span(constants),
                   make_coefficients_span(coefficients), dof_marker0,
-                  dof_marker1);
+                  dof_marker1, num_threads);
+}
+
+/// @brief Assemble a bilinear form on a mixed-topology mesh into a
+/// matrix, with one assembly loop for each cell type.
+///
+/// @param[in] mat_add The function for adding values into the matrix.
+/// @param[in] groups Cell kernels, dofmaps and coefficients for each
+/// cell type (see create_cell_groups).
+/// @param[in] x Mesh geometry (coordinates), see mesh::Geometry::x.
+/// @param[in] constants The constants that appear in the form.
+/// @param[in] dof_marker0 Boundary condition markers for the rows. If
+/// bc[i] is true then rows i in A will be zeroed.
+/// @param[in] dof_marker1 Boundary condition markers for the columns.
+/// If bc[i] is true then columns i in A will be zeroed.
+template <dolfinx::scalar T>
+void assemble_matrix(la::MatSet<T> auto mat_add,
+                     const std::vector<CellGroup<T>>& groups,
+                     std::span<const scalar_value_type_t<T>> x,
+                     std::span<const T> constants,
+                     std::span<const std::int8_t> dof_marker0 = {},
+                     std::span<const std::int8_t> dof_marker1 = {})
+{
+  common::MemoryTracker memory_tracker("Assemble matrix");
+  impl::assemble_matrix(mat_add, groups, x, constants, dof_marker0,
+                        dof_marker1);
+}
+
+/// @brief Assemble a cell kernel into a matrix, without a Form.
+///
+/// The kernel is any callable with the signature of Form::kernel, e.g.
+/// a lambda function. It is called directly rather than through a
+/// `std::function`, so a small kernel can be inlined by the compiler
+/// into the assembly loop over the cells. No dof transformations are
+/// applied, i.e. the elements must not need them or the kernel must
+/// apply them.
+///
+/// @tparam T Scalar type.
+/// @param[in] mat_add The function for adding values into the matrix.
+/// @param[in] kernel Cell kernel.
+/// @param[in] geometry Mesh geometry.
+/// @param[in] cells Cells to execute the kernel over.
+/// @param[in] dofmap0 Test function (row) dofmap.
+/// @param[in] dofmap1 Trial function (column) dofmap.
+/// @param[in] dof_marker0 Boundary condition markers for the rows. If
+/// bc[i] is true then rows i in A will be zeroed.
+/// @param[in] dof_marker1 Boundary condition markers for the columns.
+/// If bc[i] is true then columns i in A will be zeroed.
+/// @param[in] constants Constants passed to the kernel.
+/// @param[in] coeffs Coefficient data passed to the kernel, with shape
+/// `(cells.size(), cstride)`.
+/// @param[in] cstride Coefficient stride.
+template <dolfinx::scalar T>
+void assemble_matrix(la::MatSet<T> auto mat_add, FEkernel<T> auto kernel,
+                     const mesh::Geometry<scalar_value_type_t<T>>& geometry,
+                     std::span<const std::int32_t> cells,
+                     const DofMap& dofmap0, const DofMap& dofmap1,
+                     std::span<const std::int8_t> dof_marker0 = {},
+                     std::span<const std::int8_t> dof_marker1 = {},
+                     std::span<const T> constants = {},
+                     std::span<const T> coeffs = {}, int cstride = 0)
+{
+  auto P = [](std::span<T>, std::span<const std::uint32_t>, std::int32_t,
+              int) {};
+  impl::assemble_cells(mat_add, geometry.dofmap(), geometry.x(), cells,
+                       {dofmap0.map(), dofmap0.bs(), cells}, P,
+                       {dofmap1.map(), dofmap1.bs(), cells}, P, dof_marker0,
+                       dof_marker1, kernel, coeffs, cstride, constants, {},
+                       {});
+}
+
+/// @brief Re-assemble the contribution of a subset of cells to a
+/// matrix.
+///
+/// Adds `scale` times the contribution of the integration entities
+/// attached to `cells` to the matrix, i.e. the cells, their exterior
+/// facets and the interior facets with at least one attached cell in
+/// `cells`. Coefficients are packed for these entities only. A matrix
+/// can be updated after the data of a form (e.g. the coefficients)
+/// changes on a small number of cells by calling this function with
+/// `scale=-1` before the change and `scale=1` after the change.
+///
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form
+/// @param[in] cells Cells (local indices) to re-assemble
+/// @param[in] scale Scaling applied to the contributions
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+template <dolfinx::scalar T, std::floating_point U>
+void reassemble_matrix(la::MatSet<T> auto mat_add, const Form<T, U>& a,
+                       std::span<const std::int32_t> cells, T scale,
+                       std::span<const std::int8_t> dof_marker0,
+                       std::span<const std::int8_t> dof_marker1)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+  std::span<const T> constants = a.packed_constants();
+  if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+  {
+    impl::assemble_matrix_subset(mat_add, a, mesh->geometry().dofmap(),
+                                 mesh->geometry().x(), std::span(constants),
+                                 cells, scale, dof_marker0, dof_marker1);
+  }
+  else
+  {
+    auto x = mesh->geometry().x();
+    std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+    impl::assemble_matrix_subset(mat_add, a, mesh->geometry().dofmap(), _x,
+                                 std::span(constants), cells, scale,
+                                 dof_marker0, dof_marker1);
+  }
+}
+
+/// @brief Re-assemble the contribution of a subset of cells to a
+/// matrix.
+///
+/// See reassemble_matrix for details.
+///
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form
+/// @param[in] cells Cells (local indices) to re-assemble
+/// @param[in] scale Scaling applied to the contributions
+/// @param[in] bcs Boundary conditions to apply. These must be the same
+/// as the boundary conditions used to assemble the matrix.
+template <dolfinx::scalar T, std::floating_point U>
+void reassemble_matrix(
+    la::MatSet<T> auto mat_add, const Form<T, U>& a,
+    std::span<const std::int32_t> cells, T scale,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs)
+{
+  // Get dof markers. The cached markers of the boundary conditions
+  // are used when a single condition is applied to a space.
+  std::vector<std::int8_t> markers0, markers1;
+  std::span<const std::int8_t> dof_marker0
+      = impl::bc_dof_markers(*a.function_spaces().at(0), bcs, markers0);
+  std::span<const std::int8_t> dof_marker1
+      = impl::bc_dof_markers(*a.function_spaces().at(1), bcs, markers1);
+
+  reassemble_matrix(mat_add, a, cells, scale, dof_marker0, dof_marker1);
+}
+
+/// @brief Assemble bilinear form into a la::MatrixCSR, overlapping
+/// the reverse scatter of ghost rows with assembly.
+///
+/// Entities that contribute to ghost rows of `A` are assembled first,
+/// la::MatrixCSR::scatter_rev_begin is called, and then the remaining
+/// entities are assembled before completing the scatter. On return the
+/// owned rows of `A` hold the summed contributions, as after calling
+/// assemble_matrix followed by `A.scatter_rev()`. The diagonal of
+/// constrained rows is not set (see set_diagonal).
+///
+/// @param[in,out] A The matrix to assemble into. It will not be zeroed
+/// before assembly.
+/// @param[in] a The bilinear form to assemble
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coefficients Coefficients that appear in `a`
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed.
+/// @param[in] partition Partition of the integration entities, computed
+/// by compute_interface_partition for `a` or for a linear form with the
+/// same test space and integration domains.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_matrix_overlap(
+    la::MatrixCSR<T>& A, const Form<T, U>& a, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::vector<std::int32_t>, std::int32_t>>&
+        partition)
+{
+  std::vector<std::int8_t> markers0, markers1;
+  std::span<const std::int8_t> dof_marker0
+      = impl::bc_dof_markers(*a.function_spaces().at(0), bcs, markers0);
+  std::span<const std::int8_t> dof_marker1
+      = impl::bc_dof_markers(*a.function_spaces().at(1), bcs, markers1);
+
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+  auto assemble = [&](std::span<const scalar_value_type_t<T>> x)
+  {
+    impl::assemble_matrix(A.mat_add_values(), a, mesh->geometry().dofmap(),
+                          x, constants, coefficients, dof_marker0,
+                          dof_marker1, partition, true);
+    A.scatter_rev_begin();
+    impl::assemble_matrix(A.mat_add_values(), a, mesh->geometry().dofmap(),
+                          x, constants, coefficients, dof_marker0,
+                          dof_marker1, partition, false);
+    A.scatter_rev_end();
+  };
+
+  if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+    assemble(mesh->geometry().x());
+  else
+  {
+    auto x = mesh->geometry().x();
+    std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+    assemble(_x);
+  }
+}
+
+// -- Systems ----------------------------------------------------------------
+
+/// @brief Assemble a bilinear form into a matrix and a linear form
+/// into a vector, with Dirichlet boundary conditions applied to the
+/// vector by lifting.
+///
+/// The result is the same as from assemble_matrix(mat_add, a, bcs),
+/// assemble_vector(b, L) and apply_lifting(b, {a}, {bcs}, {x0},
+/// scale). Cell integrals that appear in both forms with the same
+/// integration domain are assembled in one pass over the cells, with
+/// the geometry gathered once per cell and the lifting applied
+/// locally per cell.
+///
+/// As for the separate functions, the matrix and vector are not zeroed
+/// or finalised, ghost contributions to `b` are not accumulated, the
+/// boundary condition values are not inserted into `b` (see set_bc)
+/// and the diagonal of `A` is not set (see set_diagonal).
+///
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in,out] b The vector to assemble into
+/// @param[in] a The bilinear form
+/// @param[in] L The linear form, with the same test space as `a`
+/// @param[in] bcs Boundary conditions to apply
+/// @param[in] x0 Vector used in the lifting. May be empty.
+/// @param[in] scale Scaling applied to the lifting
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_system(
+    la::MatSet<T> auto mat_add, std::span<T> b, const Form<T, U>& a,
+    const Form<T, U>& L,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    std::span<const T> x0 = {}, T scale = 1)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = a.mesh();
+  assert(mesh);
+
+  // Prepare constants and coefficients
+  std::span<const T> constants_a = a.packed_constants();
+  auto coefficients_a = allocate_coefficient_storage(a);
+  pack_coefficients(a, coefficients_a);
+  std::span<const T> constants_L = L.packed_constants();
+  auto coefficients_L = allocate_coefficient_storage(L);
+  pack_coefficients(L, coefficients_L);
+
+  // Build dof markers and boundary condition values
+  auto V0 = a.function_spaces().at(0);
+  auto V1 = a.function_spaces().at(1);
+  std::int32_t dim1 = V1->dofmap()->index_map_bs()
+                      * (V1->dofmap()->index_map->size_local()
+                         + V1->dofmap()->index_map->num_ghosts());
+  std::vector<std::int8_t> markers0, markers1;
+  std::span<const std::int8_t> dof_marker0
+      = impl::bc_dof_markers(*V0, bcs, markers0);
+  std::span<const std::int8_t> dof_marker1
+      = impl::bc_dof_markers(*V1, bcs, markers1);
+  std::vector<T> bc_values1;
+  for (auto& bc : bcs)
+  {
+    if (V1->contains(*bc->function_space()))
+    {
+      bc_values1.resize(dim1, 0);
+      bc->dof_values(bc_values1);
+    }
+  }
+
+  if constexpr (std::is_same_v<U, scalar_value_type_t<T>>)
+  {
+    impl::assemble_system(mat_add, b, a, L, mesh->geometry().dofmap(),
+                          mesh->geometry().x(), std::span(constants_a),
+                          make_coefficients_span(coefficients_a),
+                          std::span(constants_L),
+                          make_coefficients_span(coefficients_L),
+                          dof_marker0, dof_marker1,
+                          std::span<const T>(bc_values1), x0, scale);
+  }
+  else
+  {
+    auto x = mesh->geometry().x();
+    std::vector<scalar_value_type_t<T>> _x(x.begin(), x.end());
+    impl::assemble_system(mat_add, b, a, L, mesh->geometry().dofmap(),
+                          std::span<const scalar_value_type_t<T>>(_x),
+                          std::span(constants_a),
+                          make_coefficients_span(coefficients_a),
+                          std::span(constants_L),
+                          make_coefficients_span(coefficients_L),
+                          dof_marker0, dof_marker1,
+                          std::span<const T>(bc_values1), x0, scale);
+  }
 }
 
 /// @brief Sets a value to the diagonal of a matrix for specified rows.
@@ -405,6 +993,199 @@ void set_diagonal(
   }
 }
 
+/// @brief Assemble the diagonal of the matrix of a bilinear form into
+/// an array, without assembling the matrix.
+///
+/// The element matrices are computed as for assemble_matrix, and only
+/// the entries on the diagonal of the global matrix are added to
+/// `diag`. Rows and columns with a boundary condition marker are zeroed,
+/// as for assemble_matrix. Values for ghost degrees-of-freedom are not
+/// communicated.
+///
+/// @param[in,out] diag The array to add the diagonal to, indexed by
+/// the (unrolled) local degrees-of-freedom, including ghosts
+/// @param[in] a The bilinear form. The test and trial spaces must have
+/// the same dofmap.
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coefficients Coefficients that appear in `a`
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+/// @param[in] num_threads Number of threads to use for assembly
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_diagonal(
+    std::span<T> diag, const Form<T, U>& a, std::span<const T> constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<std::span<const T>, int>>& coefficients,
+    std::span<const std::int8_t> dof_marker0,
+    std::span<const std::int8_t> dof_marker1, int num_threads = 1)
+{
+  auto V0 = a.function_spaces().at(0);
+  auto V1 = a.function_spaces().at(1);
+  if (V0->dofmap() != V1->dofmap())
+  {
+    throw std::runtime_error(
+        "Test and trial spaces must have the same dofmap.");
+  }
+  const int bs = V0->dofmap()->bs();
+
+  // Add the entries of the element matrices whose row and column are
+  // the same degree-of-freedom. With threads, concurrently assembled
+  // entities do not share a row, and hence a diagonal entry.
+  auto diag_add = [diag, bs](std::span<const std::int32_t> rows,
+                             std::span<const std::int32_t> cols,
+                             std::span<const T> Ae)
+  {
+    const std::size_t num_cols = bs * cols.size();
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      for (std::size_t j = 0; j < cols.size(); ++j)
+      {
+        if (rows[i] != cols[j])
+          continue;
+        for (int k = 0; k < bs; ++k)
+          diag[bs * rows[i] + k] += Ae[(bs * i + k) * num_cols + bs * j + k];
+      }
+    }
+  };
+
+  assemble_matrix(diag_add, a, constants, coefficients, dof_marker0,
+                  dof_marker1, num_threads);
+}
+
+/// @brief Assemble the diagonal of the matrix of a bilinear form into
+/// a vector, without assembling the matrix.
+///
+/// This is the diagonal of the matrix that is computed by
+/// assemble_matrix followed by set_diagonal with the same boundary
+/// conditions, e.g. for Jacobi or Chebyshev smoothing in matrix-free
+/// solvers. The ghost contributions are sent to the owners
+/// (`diag.scatter_rev`), and the owned entries for
+/// degrees-of-freedom with a boundary condition are set to `diagonal`.
+/// The ghost entries of `diag` are not updated.
+///
+/// @note MPI Collective
+/// @param[in,out] diag The vector to assemble the diagonal into. It is
+/// zeroed first.
+/// @param[in] a The bilinear form. The test and trial spaces must have
+/// the same dofmap.
+/// @param[in] bcs Boundary conditions. For degrees-of-freedom with a
+/// condition, the row and column are zeroed and the diagonal entry is
+/// set to `diagonal`.
+/// @param[in] diagonal The value of the diagonal entries for
+/// degrees-of-freedom with a boundary condition
+/// @param[in] num_threads Number of threads to use for assembly
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_diagonal(
+    la::Vector<T>& diag, const Form<T, U>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    T diagonal = 1, int num_threads = 1)
+{
+  // Prepare constants and coefficients
+  std::span<const T> constants = a.packed_constants();
+  auto coefficients = allocate_coefficient_storage(a);
+  pack_coefficients(a, coefficients, num_threads);
+
+  const FunctionSpace<U>& V = *a.function_spaces().at(0);
+  std::vector<std::int8_t> markers;
+  std::span<const std::int8_t> dof_marker
+      = impl::bc_dof_markers(V, bcs, markers);
+
+  std::ranges::fill(diag.mutable_array(), T(0));
+  assemble_diagonal(diag.mutable_array(), a, std::span(constants),
+                    make_coefficients_span(coefficients), dof_marker,
+                    dof_marker, num_threads);
+  diag.scatter_rev(std::plus<T>());
+
+  std::span<T> d = diag.mutable_array();
+  for (auto& bc : bcs)
+  {
+    assert(bc);
+    if (V.contains(*bc->function_space()))
+    {
+      const auto [dofs, range] = bc->dof_indices();
+      for (std::int32_t dof : dofs.first(range))
+        d[dof] = diagonal;
+    }
+  }
+}
+
+// -- Block matrices ---------------------------------------------------------
+
+/// @brief Create a block matrix for a block bilinear form.
+///
+/// A block is created for each form `a[i][j]`, with the sparsity
+/// pattern of the form. The blocks of a block row (column) share the
+/// test (trial) function space, so that no combined index map or
+/// sparsity pattern is built.
+///
+/// @param[in] a Blocks of the bilinear form, with `a[i][j]` the form
+/// with the test function in space `i` and the trial function in space
+/// `j`. A null form denotes an empty block.
+/// @return Block matrix with zero entries.
+template <dolfinx::scalar T, std::floating_point U>
+la::BlockMatrixCSR<la::MatrixCSR<T>>
+create_block_matrix(const std::vector<std::vector<const Form<T, U>*>>& a)
+{
+  std::vector<std::unique_ptr<la::SparsityPattern>> storage;
+  std::vector<std::vector<const la::SparsityPattern*>> patterns;
+  for (auto& row : a)
+  {
+    patterns.emplace_back();
+    for (const Form<T, U>* form : row)
+    {
+      if (form)
+      {
+        storage.push_back(std::make_unique<la::SparsityPattern>(
+            create_sparsity_pattern(*form)));
+        storage.back()->finalize();
+        patterns.back().push_back(storage.back().get());
+      }
+      else
+        patterns.back().push_back(nullptr);
+    }
+  }
+
+  return la::BlockMatrixCSR<la::MatrixCSR<T>>(patterns);
+}
+
+/// @brief Assemble a block bilinear form into a block matrix.
+///
+/// Each form `a[i][j]` is assembled into the block `(i, j)` of `A`,
+/// with the rows and columns of boundary condition dofs zeroed. The
+/// diagonal of the constrained rows of the diagonal blocks whose test
+/// and trial spaces are the same is set to `diagonal`. The matrix is
+/// not zeroed or finalised, i.e. la::BlockMatrixCSR::scatter_rev must
+/// be called after assembly.
+///
+/// @param[in,out] A Block matrix, e.g. created by create_block_matrix.
+/// @param[in] a Blocks of the bilinear form. A null form denotes an
+/// empty block.
+/// @param[in] bcs Boundary conditions to apply.
+/// @param[in] diagonal Value to set on the diagonal of constrained
+/// rows.
+template <dolfinx::scalar T, std::floating_point U>
+void assemble_matrix_block(
+    la::BlockMatrixCSR<la::MatrixCSR<T>>& A,
+    const std::vector<std::vector<const Form<T, U>*>>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T, U>>>& bcs,
+    T diagonal = 1)
+{
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    for (std::size_t j = 0; j < a[i].size(); ++j)
+    {
+      if (const Form<T, U>* form = a[i][j]; form)
+      {
+        la::MatrixCSR<T>& Aij = A.block(i, j);
+        assemble_matrix(Aij.mat_add_values(), *form, bcs);
+        auto V = form->function_spaces();
+        if (i == j and V[0] == V[1])
+          set_diagonal(Aij.mat_set_values(), *V[0], bcs, diagonal);
+      }
+    }
+  }
+}
+
 // -- Setting bcs ------------------------------------------------------------
 
 // FIXME: Move these function elsewhere?
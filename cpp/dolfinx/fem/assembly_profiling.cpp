@@ -0,0 +1,93 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "assembly_profiling.h"
+#include <dolfinx/common/TimeLogManager.h>
+#include <dolfinx/common/TimeLogger.h>
+#include <map>
+#include <mutex>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Accumulated counters for an integral
+struct Counters
+{
+  int calls = 0;
+  std::int64_t num_entities = 0;
+  double total = 0;
+  double kernel = 0;
+  double transformation = 0;
+  double insertion = 0;
+  double flops = 0;
+  double bytes = 0;
+};
+
+std::atomic<bool> profiling_enabled = false;
+std::mutex counters_mutex;
+
+std::map<std::string, Counters>& counters()
+{
+  static std::map<std::string, Counters> c;
+  return c;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+void fem::set_assembly_profiling(bool enable) { profiling_enabled = enable; }
+//-----------------------------------------------------------------------------
+bool fem::assembly_profiling() { return profiling_enabled; }
+//-----------------------------------------------------------------------------
+Table fem::assembly_profile()
+{
+  std::scoped_lock lock(counters_mutex);
+  Table table("Summary of assembly counters");
+  for (auto& [name, c] : counters())
+  {
+    table.set(name, "calls", c.calls);
+    table.set(name, "entities", static_cast<double>(c.num_entities));
+    table.set(name, "total [s]", c.total);
+    table.set(name, "kernel [s]", c.kernel);
+    table.set(name, "transformation [s]", c.transformation);
+    table.set(name, "insertion [s]", c.insertion);
+    table.set(name, "entities/s", c.total > 0 ? c.num_entities / c.total : 0.0);
+    table.set(name, "GFLOP/s", c.total > 0 ? 1e-9 * c.flops / c.total : 0.0);
+    table.set(name, "GB/s", c.total > 0 ? 1e-9 * c.bytes / c.total : 0.0);
+    table.set(name, "flop/byte", c.bytes > 0 ? c.flops / c.bytes : 0.0);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void fem::reset_assembly_profile()
+{
+  std::scoped_lock lock(counters_mutex);
+  counters().clear();
+}
+//-----------------------------------------------------------------------------
+void fem::impl::add_assembly_profile(const std::string& name,
+                                     std::int64_t num_entities, double total,
+                                     double kernel, double transformation,
+                                     double insertion, KernelCost cost)
+{
+  {
+    std::scoped_lock lock(counters_mutex);
+    Counters& c = counters()[name];
+    c.calls += 1;
+    c.num_entities += num_entities;
+    c.total += total;
+    c.kernel += kernel;
+    c.transformation += transformation;
+    c.insertion += insertion;
+    c.flops += num_entities * cost.flops;
+    c.bytes += num_entities * cost.bytes;
+  }
+
+  common::TimeLogManager::logger().register_timing("Assemble " + name, total,
+                                                   0, 0);
+}
+//-----------------------------------------------------------------------------
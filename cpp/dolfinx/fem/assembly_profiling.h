@@ -0,0 +1,191 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <dolfinx/common/Table.h>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+/// @file assembly_profiling.h
+/// @brief Per-integral counters for the assemblers.
+///
+/// When enabled, the matrix, vector and scalar assemblers record for
+/// each integral the number of integration entities, the total time,
+/// and the time spent in the kernel, in dof transformations and in
+/// inserting into the global tensor. The time not accounted for by
+/// these phases is mainly gathering of the geometry and application of
+/// boundary conditions. Totals are also registered with
+/// common::TimeLogger.
+///
+/// For a roofline analysis, the number of floating point operations
+/// and the bytes moved are estimated for each integral, and the
+/// achieved flop rate and bandwidth are reported. The flop count is
+/// the kernel estimate (see Form::set_kernel_flops) and the bytes are
+/// derived from the dofmaps, the coefficient stride and the geometry
+/// dofs of the integration entities.
+///
+/// Counters are disabled by default. When disabled, the assemblers run
+/// the same code as without profiling support.
+
+namespace dolfinx::fem
+{
+/// @brief Enable or disable the collection of per-integral assembly
+/// counters.
+/// @param[in] enable `true` to enable collection.
+void set_assembly_profiling(bool enable);
+
+/// @brief Check if per-integral assembly counters are collected.
+/// @return `true` if collection is enabled.
+bool assembly_profiling();
+
+/// @brief Summary of the per-integral assembly counters.
+///
+/// There is one row for each assembler and integral, and the columns
+/// hold the number of assembly calls, the number of entities, the
+/// total and per phase times (in seconds), the number of entities
+/// assembled per second, the achieved GFLOP/s and GB/s over the total
+/// time, and the arithmetic intensity (flops per byte).
+///
+/// @return Table with the counters.
+Table assembly_profile();
+
+/// @brief Reset all per-integral assembly counters.
+void reset_assembly_profile();
+
+/// @brief Estimated cost of one call of an integration kernel.
+struct KernelCost
+{
+  /// Number of floating point operations
+  double flops = 0;
+
+  /// Number of bytes read and written
+  double bytes = 0;
+};
+
+namespace impl
+{
+/// @brief Add counters for one assembly of an integral.
+/// @param[in] name Name of the assembler and integral.
+/// @param[in] num_entities Number of entities assembled.
+/// @param[in] total Total time.
+/// @param[in] kernel Time spent in kernels.
+/// @param[in] transformation Time spent in dof transformations.
+/// @param[in] insertion Time spent inserting into the global tensor.
+/// @param[in] cost Estimated cost of one kernel call.
+void add_assembly_profile(const std::string& name, std::int64_t num_entities,
+                          double total, double kernel, double transformation,
+                          double insertion, KernelCost cost);
+
+/// @brief Estimate the cost of one kernel call.
+///
+/// The bytes are those of the dofmap and geometry dofmap entries, the
+/// coordinates and the coefficients passed to the kernel, and the
+/// entries of the global tensor, which are read and written. Constants
+/// are neglected.
+///
+/// @tparam T Scalar type.
+/// @tparam U Geometry type.
+/// @param[in] flops Flop estimate of the kernel.
+/// @param[in] num_cells Number of cells of an integration entity, i.e.
+/// two for interior facets and one otherwise.
+/// @param[in] dofs Number of dofs per cell and block size of each
+/// argument.
+/// @param[in] cstride Number of coefficient values of an entity.
+/// @param[in] num_xdofs Number of geometry dofs per cell.
+/// @return Estimated cost.
+template <typename T, typename U>
+KernelCost kernel_cost(double flops, int num_cells,
+                       std::initializer_list<std::pair<std::size_t, int>> dofs,
+                       int cstride, std::size_t num_xdofs)
+{
+  double bytes
+      = cstride * sizeof(T)
+        + num_cells * num_xdofs * (sizeof(std::int32_t) + 3 * sizeof(U));
+  double tensor = dofs.size() > 0 ? 2 * sizeof(T) : 0;
+  for (auto [n, bs] : dofs)
+  {
+    bytes += num_cells * n * sizeof(std::int32_t);
+    tensor *= num_cells * n * bs;
+  }
+
+  return {flops, bytes + tensor};
+}
+
+/// @brief Wrap a function such that the time spent in calls is added
+/// to a counter.
+/// @param[in] f Function to wrap.
+/// @param[in,out] t Counter (seconds).
+/// @param[in,out] n Counter for the number of calls.
+/// @return Wrapped function.
+template <typename F>
+auto timed(F f, std::atomic<double>& t, std::atomic<std::int64_t>& n)
+{
+  return [f, &t, &n](auto&&... args) -> decltype(auto)
+  {
+    ++n;
+    struct Scope
+    {
+      std::atomic<double>& t;
+      std::chrono::steady_clock::time_point t0
+          = std::chrono::steady_clock::now();
+      ~Scope()
+      {
+        t += std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                           - t0)
+                 .count();
+      }
+    } scope{t};
+    return f(std::forward<decltype(args)>(args)...);
+  };
+}
+
+/// @brief Execute the assembly of an integral, with profiling if
+/// enabled.
+///
+/// Calls `f(kernel, transformation, insertion)`, where each argument is
+/// a function that takes a callable and returns the callable to use
+/// for the respective phase. If profiling is disabled these functions
+/// return their argument, otherwise they return a wrapped callable
+/// that records the time spent in it (see timed). The number of
+/// entities is the number of calls of the kernel.
+///
+/// @param[in] name Name of the assembler (e.g. "matrix").
+/// @param[in] type Name of the integral type (e.g. "cell").
+/// @param[in] id Integral ID.
+/// @param[in] cost Estimated cost of one kernel call (see kernel_cost).
+/// @param[in] f Function that executes the assembly.
+template <typename F>
+void profile_integral(const std::string& name, const std::string& type,
+                      int id, KernelCost cost, F&& f)
+{
+  if (!assembly_profiling())
+  {
+    auto identity = [](auto&& g) { return g; };
+    f(identity, identity, identity);
+  }
+  else
+  {
+    std::atomic<double> kernel = 0, transformation = 0, insertion = 0;
+    std::atomic<std::int64_t> num_entities = 0, num_other = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    f([&](auto&& g) { return timed(g, kernel, num_entities); },
+      [&](auto&& g) { return timed(g, transformation, num_other); },
+      [&](auto&& g) { return timed(g, insertion, num_other); });
+    double total
+        = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+              .count();
+    add_assembly_profile(name + ": " + type + " " + std::to_string(id),
+                         num_entities, total, kernel, transformation,
+                         insertion, cost);
+  }
+}
+} // namespace impl
+} // namespace dolfinx::fem
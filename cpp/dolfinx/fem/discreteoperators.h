@@ -9,19 +9,89 @@
 #include "DofMap.h"
 #include "FiniteElement.h"
 #include "FunctionSpace.h"
+#include "sparsitybuild.h"
 #include <algorithm>
 #include <array>
 #include <concepts>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/math.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <span>
 #include <vector>
 
 namespace dolfinx::fem
 {
 
+namespace impl
+{
+/// @brief Compute the discrete gradient matrix on the reference cell.
+/// @param[in] e0 Lagrange element
+/// @param[in] e1 Nédélec (first kind) element
+/// @param[in] tdim Topological dimension of the cell
+/// @return The reference matrix (row-major), with shape
+/// `(e1.space_dimension(), e0.space_dimension())`
+template <dolfinx::scalar T, std::floating_point U>
+std::vector<T> discrete_gradient_reference(const FiniteElement<U>& e0,
+                                           const FiniteElement<U>& e1,
+                                           int tdim)
+{
+  using cmdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+  using cmdspan4_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>;
+
+  // Check elements
+  if (e0.map_type() != basix::maps::type::identity)
+    throw std::runtime_error("Wrong finite element space for V0.");
+  if (e0.block_size() != 1)
+    throw std::runtime_error("Block size is greater than 1 for V0.");
+  if (e0.reference_value_size() != 1)
+    throw std::runtime_error("Wrong value size for V0.");
+
+  if (e1.map_type() != basix::maps::type::covariantPiola)
+    throw std::runtime_error("Wrong finite element space for V1.");
+  if (e1.block_size() != 1)
+    throw std::runtime_error("Block size is greater than 1 for V1.");
+
+  // Get V0 (H(curl)) space interpolation points
+  const auto [X, Xshape] = e1.interpolation_points();
+
+  // Tabulate first order derivatives of Lagrange space at H(curl)
+  // interpolation points
+  const int ndofs0 = e0.space_dimension();
+  std::vector<U> phi0_b((tdim + 1) * Xshape[0] * ndofs0 * 1);
+  cmdspan4_t phi0(phi0_b.data(), tdim + 1, Xshape[0], ndofs0, 1);
+  e0.tabulate(phi0_b, X, Xshape, 1);
+
+  // Reshape lagrange basis derivatives as a matrix of shape (tdim *
+  // num_points, num_dofs_per_cell)
+  cmdspan2_t dphi_reshaped(
+      phi0_b.data() + phi0.extent(3) * phi0.extent(2) * phi0.extent(1),
+      tdim * phi0.extent(1), phi0.extent(2));
+
+  // Build the element interpolation matrix
+  std::vector<T> Ab(e1.space_dimension() * ndofs0);
+  {
+    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>
+        A(Ab.data(), e1.space_dimension(), ndofs0);
+    const auto [Pi, shape] = e1.interpolation_operator();
+    cmdspan2_t _Pi(Pi.data(), shape);
+    math::dot(_Pi, dphi_reshaped, A);
+  }
+
+  return Ab;
+}
+} // namespace impl
+
 /// @brief Assemble a discrete gradient operator.
 ///
 /// The discrete gradient operator \f$A\f$ interpolates the gradient of
@@ -64,42 +134,10 @@ void discrete_gradient(mesh::Topology& topology,
   auto& e1 = V1.first.get();
   const DofMap& dofmap1 = V1.second.get();
 
-  using cmdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-      const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
-  using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-      U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
-  using cmdspan4_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-      const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>;
-
-  // Check elements
-  if (e0.map_type() != basix::maps::type::identity)
-    throw std::runtime_error("Wrong finite element space for V0.");
-  if (e0.block_size() != 1)
-    throw std::runtime_error("Block size is greater than 1 for V0.");
-  if (e0.reference_value_size() != 1)
-    throw std::runtime_error("Wrong value size for V0.");
-
-  if (e1.map_type() != basix::maps::type::covariantPiola)
-    throw std::runtime_error("Wrong finite element space for V1.");
-  if (e1.block_size() != 1)
-    throw std::runtime_error("Block size is greater than 1 for V1.");
-
-  // Get V0 (H(curl)) space interpolation points
-  const auto [X, Xshape] = e1.interpolation_points();
-
-  // Tabulate first order derivatives of Lagrange space at H(curl)
-  // interpolation points
+  // Build the element interpolation matrix
   const int ndofs0 = e0.space_dimension();
   const int tdim = topology.dim();
-  std::vector<U> phi0_b((tdim + 1) * Xshape[0] * ndofs0 * 1);
-  cmdspan4_t phi0(phi0_b.data(), tdim + 1, Xshape[0], ndofs0, 1);
-  e0.tabulate(phi0_b, X, Xshape, 1);
-
-  // Reshape lagrange basis derivatives as a matrix of shape (tdim *
-  // num_points, num_dofs_per_cell)
-  cmdspan2_t dphi_reshaped(
-      phi0_b.data() + phi0.extent(3) * phi0.extent(2) * phi0.extent(1),
-      tdim * phi0.extent(1), phi0.extent(2));
+  const std::vector<T> Ab = impl::discrete_gradient_reference<T>(e0, e1, tdim);
 
   // Get inverse DOF transform function
   auto apply_inverse_dof_transform = e1.template dof_transformation_fn<T>(
@@ -110,19 +148,6 @@ void discrete_gradient(mesh::Topology& topology,
   const std::vector<std::uint32_t>& cell_info
       = topology.get_cell_permutation_info();
 
-  // Create element kernel function
-
-  // Build the element interpolation matrix
-  std::vector<T> Ab(e1.space_dimension() * ndofs0);
-  {
-    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-        T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>
-        A(Ab.data(), e1.space_dimension(), ndofs0);
-    const auto [Pi, shape] = e1.interpolation_operator();
-    cmdspan2_t _Pi(Pi.data(), shape);
-    math::dot(_Pi, dphi_reshaped, A);
-  }
-
   // Insert local interpolation matrix for each cell
   auto cell_map = topology.index_map(tdim);
   assert(cell_map);
@@ -136,6 +161,148 @@ void discrete_gradient(mesh::Topology& topology,
   }
 }
 
+/// @brief Create a discrete gradient operator matrix.
+///
+/// See ::discrete_gradient for the operator. This function builds the
+/// sparsity pattern and the matrix. For the lowest-order spaces, where
+/// each edge has one Nédélec degree-of-freedom and each vertex one
+/// Lagrange degree-of-freedom, the operator has exactly two non-zero
+/// entries (+1 and -1) in each row. The sparsity pattern is then built
+/// directly from these entries, with the values of a row computed once
+/// from a cell that contains the edge. For higher degree spaces the
+/// sparsity pattern is built from the cell dofmaps.
+///
+/// @note Only rows that are owned by the calling process are set in
+/// the lowest-order case. Ghost rows are empty. The matrix should not
+/// be reverse scattered.
+///
+/// @param[in] V0 Lagrange space to interpolate the gradient from
+/// @param[in] V1 Nédélec (first kind) space to interpolate into
+/// @return Discrete gradient matrix. Rows are for `V1` and columns
+/// for `V0`.
+template <dolfinx::scalar T,
+          std::floating_point U = dolfinx::scalar_value_type_t<T>>
+la::MatrixCSR<T> discrete_gradient(const FunctionSpace<U>& V0,
+                                   const FunctionSpace<U>& V1)
+{
+  std::shared_ptr<const mesh::Mesh<U>> mesh = V0.mesh();
+  assert(mesh);
+  if (mesh != V1.mesh())
+    throw std::runtime_error("Function spaces must have the same mesh.");
+  std::shared_ptr<mesh::Topology> topology = mesh->topology_mutable();
+  assert(topology);
+
+  std::shared_ptr<const FiniteElement<U>> e0 = V0.element();
+  assert(e0);
+  std::shared_ptr<const FiniteElement<U>> e1 = V1.element();
+  assert(e1);
+  std::shared_ptr<const DofMap> dofmap0 = V0.dofmap();
+  assert(dofmap0);
+  std::shared_ptr<const DofMap> dofmap1 = V1.dofmap();
+  assert(dofmap1);
+
+  const int tdim = topology->dim();
+  auto cell_map = topology->index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells = cell_map->size_local();
+
+  la::SparsityPattern sp(mesh->comm(),
+                         {dofmap1->index_map, dofmap0->index_map},
+                         {dofmap1->index_map_bs(), dofmap0->index_map_bs()});
+
+  // Check for lowest-order spaces
+  const mesh::CellType cell_type = topology->cell_type();
+  const int num_edges = mesh::cell_num_entities(cell_type, 1);
+  const int num_vertices = mesh::cell_num_entities(cell_type, 0);
+  const ElementDofLayout& layout0 = dofmap0->element_dof_layout();
+  const ElementDofLayout& layout1 = dofmap1->element_dof_layout();
+  const bool lowest_order
+      = layout0.num_dofs() == num_vertices and layout0.num_entity_dofs(0) == 1
+        and layout1.num_dofs() == num_edges
+        and layout1.num_entity_dofs(1) == 1 and dofmap0->index_map_bs() == 1
+        and dofmap1->index_map_bs() == 1;
+  if (!lowest_order)
+  {
+    std::vector<std::int32_t> cells(num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    sparsitybuild::cells(sp, {cells, cells}, {*dofmap1, *dofmap0});
+    sp.finalize();
+    la::MatrixCSR<T> A(sp);
+    discrete_gradient<T, U>(*topology, {*e0, *dofmap0}, {*e1, *dofmap1},
+                            A.mat_set_values());
+    return A;
+  }
+
+  // Build the element interpolation matrix
+  const std::vector<T> Ab
+      = impl::discrete_gradient_reference<T>(*e0, *e1, tdim);
+  auto apply_inverse_dof_transform = e1->template dof_transformation_fn<T>(
+      doftransform::inverse_transpose, false);
+  topology->create_entity_permutations();
+  const std::vector<std::uint32_t>& cell_info
+      = topology->get_cell_permutation_info();
+
+  // Compute the two columns and values of each owned row, from the
+  // first cell that contains the edge. Ghost cells are included since
+  // an owned edge may not be in an owned cell.
+  const graph::AdjacencyList<int> edge_vertices
+      = mesh::get_entity_vertices(cell_type, 1);
+  const std::int32_t num_rows = dofmap1->index_map->size_local();
+  std::vector<std::int32_t> cols(2 * num_rows, -1);
+  std::vector<T> values(2 * num_rows, 0);
+  std::vector<T> Ae(Ab.size());
+  for (std::int32_t c = 0; c < num_cells + cell_map->num_ghosts(); ++c)
+  {
+    std::span<const std::int32_t> dofs0 = dofmap0->cell_dofs(c);
+    std::span<const std::int32_t> dofs1 = dofmap1->cell_dofs(c);
+    bool transformed = false;
+    for (int e = 0; e < num_edges; ++e)
+    {
+      const int i = layout1.entity_dofs(1, e).front();
+      const std::int32_t row = dofs1[i];
+      if (row >= num_rows or cols[2 * row] >= 0)
+        continue;
+
+      if (!transformed)
+      {
+        std::ranges::copy(Ab, Ae.begin());
+        apply_inverse_dof_transform(Ae, cell_info, c, num_vertices);
+        transformed = true;
+      }
+
+      auto vertices = edge_vertices.links(e);
+      for (int k = 0; k < 2; ++k)
+      {
+        const int j = layout0.entity_dofs(0, vertices[k]).front();
+        cols[2 * row + k] = dofs0[j];
+        values[2 * row + k] = Ae[i * num_vertices + j];
+      }
+    }
+  }
+
+  // Build sparsity pattern with the two entries of each row
+  for (std::int32_t row = 0; row < num_rows; ++row)
+  {
+    if (cols[2 * row] >= 0)
+      sp.insert(std::span(&row, 1), std::span(cols.data() + 2 * row, 2));
+  }
+  sp.finalize();
+
+  // Set values
+  la::MatrixCSR<T> A(sp);
+  for (std::int32_t row = 0; row < num_rows; ++row)
+  {
+    if (cols[2 * row] < 0)
+      continue;
+    A.template set<1, 1>(std::span<const T>(values.data() + 2 * row, 2),
+                         std::span(&row, 1),
+                         std::span<const std::int32_t>(cols.data() + 2 * row,
+                                                       2));
+  }
+
+  return A;
+}
+
 /// @brief Assemble an interpolation operator matrix.
 ///
 /// The interpolation operator \f$A\f$ interpolates a function in the
@@ -148,12 +315,19 @@ void discrete_gradient(mesh::Topology& topology,
 /// initialised using sparsitybuild::cells. The space `V1` should be
 /// used for the rows of the sparsity pattern, `V0` for the columns.
 ///
+/// @note The reference basis and the interpolation points are
+/// tabulated once. When `num_threads > 1`, the cells are split between
+/// threads, which compute the cell matrices concurrently. The calls
+/// to `mat_set` are serialised.
+///
 /// @param[in] V0 The space to interpolate from
 /// @param[in] V1 The space to interpolate to
 /// @param[in] mat_set A functor that sets values in a matrix
+/// @param[in] num_threads Number of threads to use
 template <dolfinx::scalar T, std::floating_point U>
 void interpolation_matrix(const FunctionSpace<U>& V0,
-                          const FunctionSpace<U>& V1, auto&& mat_set)
+                          const FunctionSpace<U>& V1, auto&& mat_set,
+                          int num_threads = 1)
 {
   // Get mesh
   auto mesh = V0.mesh();
@@ -235,17 +409,6 @@ void interpolation_matrix(const FunctionSpace<U>& V0,
       basis_derivatives_reference0_b, basis_derivatives_reference0_b.begin(),
       [atol = 1e-14](auto x) { return std::abs(x) < atol ? 0.0 : x; });
 
-  // Create working arrays
-  std::vector<U> basis_reference0_b(Xshape[0] * dim0 * value_size_ref0);
-  mdspan3_t basis_reference0(basis_reference0_b.data(), Xshape[0], dim0,
-                             value_size_ref0);
-  std::vector<U> J_b(Xshape[0] * gdim * tdim);
-  mdspan3_t J(J_b.data(), Xshape[0], gdim, tdim);
-  std::vector<U> K_b(Xshape[0] * tdim * gdim);
-  mdspan3_t K(K_b.data(), Xshape[0], tdim, gdim);
-  std::vector<U> detJ(Xshape[0]);
-  std::vector<U> det_scratch(2 * tdim * gdim);
-
   // Get the interpolation operator (matrix) `Pi` that maps a function
   // evaluated at the interpolation points to the element degrees of
   // freedom, i.e. dofs = Pi f_x
@@ -265,145 +428,172 @@ void interpolation_matrix(const FunctionSpace<U>& V0,
   auto push_forward_fn0
       = e0->basix_element().template map_fn<u_t, U_t, J_t, K_t>();
 
-  // Basis values of Lagrange space unrolled for block size
-  // (num_quadrature_points, Lagrange dof, value_size)
-  std::vector<U> basis_values_b(Xshape[0] * bs0 * dim0 * V1.value_size());
-  mdspan3_t basis_values(basis_values_b.data(), Xshape[0], bs0 * dim0,
-                         V1.value_size());
-  std::vector<U> mapped_values_b(Xshape[0] * bs0 * dim0 * V1.value_size());
-  mdspan3_t mapped_values(mapped_values_b.data(), Xshape[0], bs0 * dim0,
-                          V1.value_size());
-
   auto pull_back_fn1
       = e1->basix_element().template map_fn<u_t, U_t, K_t, J_t>();
 
-  std::vector<U> coord_dofs_b(num_dofs_g * gdim);
-  mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
-  std::vector<U> basis0_b(Xshape[0] * dim0 * value_size0);
-  mdspan3_t basis0(basis0_b.data(), Xshape[0], dim0, value_size0);
-
-  // Buffers
-  std::vector<T> Ab(space_dim0 * space_dim1);
-  std::vector<T> local1(space_dim1);
-
-  // Iterate over mesh and interpolate on each cell
-  auto cell_map = mesh->topology()->index_map(tdim);
-  assert(cell_map);
-  std::int32_t num_cells = cell_map->size_local();
-  for (std::int32_t c = 0; c < num_cells; ++c)
+  // Interpolate on the cells in [c0, c1). Insertion into the matrix
+  // is serialised when more than one thread is used.
+  std::mutex mat_set_mutex;
+  auto interpolate_cells = [&](std::int32_t c0, std::int32_t c1)
   {
-    // Get cell geometry (coordinate dofs)
-    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      for (std::size_t j = 0; j < gdim; ++j)
-        coord_dofs(i, j) = x_g[3 * x_dofs[i] + j];
-    }
-
-    // Compute Jacobians and reference points for current cell
-    std::ranges::fill(J_b, 0);
-    for (std::size_t p = 0; p < Xshape[0]; ++p)
+    // Create working arrays
+    std::vector<U> basis_reference0_b(Xshape[0] * dim0 * value_size_ref0);
+    mdspan3_t basis_reference0(basis_reference0_b.data(), Xshape[0], dim0,
+                               value_size_ref0);
+    std::vector<U> J_b(Xshape[0] * gdim * tdim);
+    mdspan3_t J(J_b.data(), Xshape[0], gdim, tdim);
+    std::vector<U> K_b(Xshape[0] * tdim * gdim);
+    mdspan3_t K(K_b.data(), Xshape[0], tdim, gdim);
+    std::vector<U> detJ(Xshape[0]);
+    std::vector<U> det_scratch(2 * tdim * gdim);
+
+    // Basis values of Lagrange space unrolled for block size
+    // (num_quadrature_points, Lagrange dof, value_size)
+    std::vector<U> basis_values_b(Xshape[0] * bs0 * dim0 * V1.value_size());
+    mdspan3_t basis_values(basis_values_b.data(), Xshape[0], bs0 * dim0,
+                           V1.value_size());
+    std::vector<U> mapped_values_b(Xshape[0] * bs0 * dim0 * V1.value_size());
+    mdspan3_t mapped_values(mapped_values_b.data(), Xshape[0], bs0 * dim0,
+                            V1.value_size());
+
+    std::vector<U> coord_dofs_b(num_dofs_g * gdim);
+    mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+    std::vector<U> basis0_b(Xshape[0] * dim0 * value_size0);
+    mdspan3_t basis0(basis0_b.data(), Xshape[0], dim0, value_size0);
+
+    // Buffers
+    std::vector<T> Ab(space_dim0 * space_dim1);
+    std::vector<T> local1(space_dim1);
+
+    for (std::int32_t c = c0; c < c1; ++c)
     {
-      auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          phi, std::pair(1, tdim + 1), p,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
-      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      cmap.compute_jacobian(dphi, coord_dofs, _J);
-      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      cmap.compute_jacobian_inverse(_J, _K);
-      detJ[p] = cmap.compute_jacobian_determinant(_J, det_scratch);
-    }
+      // Get cell geometry (coordinate dofs)
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        for (std::size_t j = 0; j < gdim; ++j)
+          coord_dofs(i, j) = x_g[3 * x_dofs[i] + j];
+      }
 
-    // Copy evaluated basis on reference, apply DOF transformations, and
-    // push forward to physical element
-    for (std::size_t k0 = 0; k0 < basis_reference0.extent(0); ++k0)
-      for (std::size_t k1 = 0; k1 < basis_reference0.extent(1); ++k1)
-        for (std::size_t k2 = 0; k2 < basis_reference0.extent(2); ++k2)
-          basis_reference0(k0, k1, k2)
-              = basis_derivatives_reference0(0, k0, k1, k2);
-    for (std::size_t p = 0; p < Xshape[0]; ++p)
-    {
-      apply_dof_transformation0(
-          std::span(basis_reference0.data_handle() + p * dim0 * value_size_ref0,
-                    dim0 * value_size_ref0),
-          cell_info, c, value_size_ref0);
-    }
+      // Compute Jacobians and reference points for current cell
+      std::ranges::fill(J_b, 0);
+      for (std::size_t p = 0; p < Xshape[0]; ++p)
+      {
+        auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            phi, std::pair(1, tdim + 1), p,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+        auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        cmap.compute_jacobian(dphi, coord_dofs, _J);
+        auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        cmap.compute_jacobian_inverse(_J, _K);
+        detJ[p] = cmap.compute_jacobian_determinant(_J, det_scratch);
+      }
 
-    for (std::size_t p = 0; p < basis0.extent(0); ++p)
-    {
-      auto _u = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          basis0, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _U = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          basis_reference0, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      push_forward_fn0(_u, _U, _J, detJ[p], _K);
-    }
+      // Copy evaluated basis on reference, apply DOF transformations, and
+      // push forward to physical element
+      for (std::size_t k0 = 0; k0 < basis_reference0.extent(0); ++k0)
+        for (std::size_t k1 = 0; k1 < basis_reference0.extent(1); ++k1)
+          for (std::size_t k2 = 0; k2 < basis_reference0.extent(2); ++k2)
+            basis_reference0(k0, k1, k2)
+                = basis_derivatives_reference0(0, k0, k1, k2);
+      for (std::size_t p = 0; p < Xshape[0]; ++p)
+      {
+        apply_dof_transformation0(
+            std::span(basis_reference0.data_handle()
+                          + p * dim0 * value_size_ref0,
+                      dim0 * value_size_ref0),
+            cell_info, c, value_size_ref0);
+      }
 
-    // Unroll basis function for input space for block size
-    for (std::size_t p = 0; p < Xshape[0]; ++p)
-      for (std::size_t i = 0; i < dim0; ++i)
-        for (std::size_t j = 0; j < value_size0; ++j)
-          for (int k = 0; k < bs0; ++k)
-            basis_values(p, i * bs0 + k, j * bs0 + k) = basis0(p, i, j);
+      for (std::size_t p = 0; p < basis0.extent(0); ++p)
+      {
+        auto _u = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            basis0, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _U = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            basis_reference0, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        push_forward_fn0(_u, _U, _J, detJ[p], _K);
+      }
 
-    // Pull back the physical values to the reference of output space
-    for (std::size_t p = 0; p < basis_values.extent(0); ++p)
-    {
-      auto _u = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          basis_values, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _U = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          mapped_values, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
-          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      pull_back_fn1(_U, _u, _K, 1.0 / detJ[p], _J);
-    }
+      // Unroll basis function for input space for block size
+      for (std::size_t p = 0; p < Xshape[0]; ++p)
+        for (std::size_t i = 0; i < dim0; ++i)
+          for (std::size_t j = 0; j < value_size0; ++j)
+            for (int k = 0; k < bs0; ++k)
+              basis_values(p, i * bs0 + k, j * bs0 + k) = basis0(p, i, j);
 
-    // Apply interpolation matrix to basis values of V0 at the
-    // interpolation points of V1
-    if (interpolation_ident)
-    {
-      MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
-          T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 3>>
-          A(Ab.data(), Xshape[0], V1.value_size(), space_dim0);
-      for (std::size_t i = 0; i < mapped_values.extent(0); ++i)
-        for (std::size_t j = 0; j < mapped_values.extent(1); ++j)
-          for (std::size_t k = 0; k < mapped_values.extent(2); ++k)
-            A(i, k, j) = mapped_values(i, j, k);
-    }
-    else
-    {
-      for (std::size_t i = 0; i < mapped_values.extent(1); ++i)
+      // Pull back the physical values to the reference of output space
+      for (std::size_t p = 0; p < basis_values.extent(0); ++p)
       {
-        auto values = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-            mapped_values, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, i,
+        auto _u = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            basis_values, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _U = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            mapped_values, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
             MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-        impl::interpolation_apply(Pi_1, values, std::span(local1), bs1);
-        for (std::size_t j = 0; j < local1.size(); j++)
-          Ab[space_dim0 * j + i] = local1[j];
+        auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        pull_back_fn1(_U, _u, _K, 1.0 / detJ[p], _J);
       }
+
+      // Apply interpolation matrix to basis values of V0 at the
+      // interpolation points of V1
+      if (interpolation_ident)
+      {
+        MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+            T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 3>>
+            A(Ab.data(), Xshape[0], V1.value_size(), space_dim0);
+        for (std::size_t i = 0; i < mapped_values.extent(0); ++i)
+          for (std::size_t j = 0; j < mapped_values.extent(1); ++j)
+            for (std::size_t k = 0; k < mapped_values.extent(2); ++k)
+              A(i, k, j) = mapped_values(i, j, k);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < mapped_values.extent(1); ++i)
+        {
+          auto values = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+              mapped_values, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, i,
+              MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+          impl::interpolation_apply(Pi_1, values, std::span(local1), bs1);
+          for (std::size_t j = 0; j < local1.size(); j++)
+            Ab[space_dim0 * j + i] = local1[j];
+        }
+      }
+
+      apply_inverse_dof_transform1(Ab, cell_info, c, space_dim0);
+      if (num_threads > 1)
+      {
+        std::lock_guard<std::mutex> lock(mat_set_mutex);
+        mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ab);
+      }
+      else
+        mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ab);
     }
+  };
 
-    apply_inverse_dof_transform1(Ab, cell_info, c, space_dim0);
-    mat_set(dofmap1->cell_dofs(c), dofmap0->cell_dofs(c), Ab);
-  }
+  // Iterate over mesh and interpolate on each cell
+  auto cell_map = mesh->topology()->index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells = cell_map->size_local();
+  common::parallel_for(num_cells, std::max(num_threads, 1),
+                       interpolate_cells);
 }
 
 } // namespace dolfinx::fem
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Topology.h>
@@ -36,6 +37,7 @@ struct dofmap_t
 };
 //-----------------------------------------------------------------------------
 
+
 /// Build a graph for owned dofs and apply graph reordering function with
 /// multiple dofmaps. The dofmaps are 2D arrays, of fixed width, stored in
 /// `dofmap_t` format. The dofmaps all refer to dof indices in the same range
@@ -54,7 +56,7 @@ reorder_owned(const std::vector<dofmap_t>& dofmaps, std::int32_t owned_size,
               const std::function<std::vector<int>(
                   const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
 {
-  std::vector<std::int32_t> graph_data, graph_offsets;
+  common::Timer t0("Reorder owned dofs");
 
   // Compute maximum number of graph out edges edges per dof
   std::vector<int> num_edges(owned_size);
@@ -111,8 +113,10 @@ reorder_owned(const std::vector<dofmap_t>& dofmaps, std::int32_t owned_size,
     }
   }
 
-  // Eliminate duplicate edges and create AdjacencyList
-  graph_offsets.resize(num_edges.size() + 1, 0);
+  // Eliminate duplicate edges and create AdjacencyList. The unique
+  // edges are moved to the front of the edge array, so that no second
+  // array of graph edges is created.
+  std::vector<std::int32_t> graph_offsets(num_edges.size() + 1, 0);
   std::int32_t current_offset = 0;
   for (std::size_t i = 0; i < num_edges.size(); ++i)
   {
@@ -122,15 +126,21 @@ reorder_owned(const std::vector<dofmap_t>& dofmaps, std::int32_t owned_size,
     std::ranges::sort(edge_range);
     auto it = std::ranges::unique(edge_range).begin();
 
-    graph_data.insert(graph_data.end(), range_begin, it);
+    for (auto e = range_begin, out = std::next(edges.begin(), graph_offsets[i]);
+         e != it; ++e, ++out)
+    {
+      *out = *e;
+    }
     graph_offsets[i + 1] = graph_offsets[i] + std::distance(range_begin, it);
     current_offset += num_edges[i];
   }
+  edges.resize(graph_offsets.back());
+  edges.shrink_to_fit();
 
   // Re-order graph and return re-odering
   assert(reorder_fn);
   return reorder_fn(
-      graph::AdjacencyList(std::move(graph_data), std::move(graph_offsets)));
+      graph::AdjacencyList(std::move(edges), std::move(graph_offsets)));
 }
 
 //-----------------------------------------------------------------------------
@@ -140,6 +150,7 @@ reorder_owned(const std::vector<dofmap_t>& dofmaps, std::int32_t owned_size,
 /// @param [in] mesh The mesh to build the dofmap on
 /// @param [in] topology The mesh topology
 /// @param [in] element_dof_layout The layout of dofs on each cell type
+/// @param [in] num_threads Number of threads to use
 /// @return Returns: * dofmaps for each cell type (local to the process)
 ///                  * local-to-global map for each local dof
 ///                  * local-to-entity map for each local dof
@@ -152,7 +163,8 @@ std::tuple<std::vector<dofmap_t>, std::vector<std::int64_t>,
            std::vector<std::shared_ptr<const common::IndexMap>>, std::int64_t>
 build_basic_dofmaps(
     const mesh::Topology& topology,
-    const std::vector<fem::ElementDofLayout>& element_dof_layouts)
+    const std::vector<fem::ElementDofLayout>& element_dof_layouts,
+    int num_threads)
 {
   // Start timer for dofmap initialization
   common::Timer t0("Init dofmap from element dofmap");
@@ -161,7 +173,7 @@ build_basic_dofmaps(
   const std::size_t D = topology.dim();
   const std::size_t num_cell_types = topology.entity_types(D).size();
 
-  spdlog::info("Checking required entities per dimension");
+  DOLFINX_LOG_INFO("Checking required entities per dimension");
 
   // Find which dimensions (d) and entity types (et) are required
   // and the number of dofs which are required for each (d, et) combination.
@@ -240,7 +252,7 @@ build_basic_dofmaps(
         << (int)required_dim_et[i].second << ")=" << num_entity_dofs_et[i]
         << " ";
     }
-    spdlog::info("{}", s.str());
+    DOLFINX_LOG_INFO("{}", s.str());
   }
 #endif
 
@@ -249,7 +261,7 @@ build_basic_dofmaps(
   for (std::size_t i = 0; i < num_cell_types; ++i)
   {
     mesh::CellType cell_type = topology.entity_types(D)[i];
-    const std::vector<std::vector<std::vector<int>>> entity_dofs
+    const std::vector<std::vector<std::vector<int>>>& entity_dofs
         = element_dof_layouts[i].entity_dofs_all();
     assert(entity_dofs.size() == D + 1);
 
@@ -259,62 +271,66 @@ build_basic_dofmaps(
     std::int32_t dofmap_width = element_dof_layouts[i].num_dofs();
     dofs[i].width = dofmap_width;
     dofs[i].array.resize(num_cells * dofmap_width);
-    spdlog::info("Cell type: {} dofmap: {}x{}", i, num_cells, dofmap_width);
+    DOLFINX_LOG_INFO("Cell type: {} dofmap: {}x{}", i, num_cells, dofmap_width);
 
-    std::int32_t dofmap_offset = 0;
-    for (std::int32_t c = 0; c < num_cells; ++c)
+    // Cells are independent, so blocks of cells are processed
+    // concurrently
+    auto build_cells = [&, i](std::int32_t c0, std::int32_t c1)
     {
-      // Wrap dofs for cell c
-      std::span<std::int32_t> dofs_c(dofs[i].array.data() + dofmap_offset,
-                                     dofmap_width);
-      dofmap_offset += dofmap_width;
-
-      // Iterate over required entities for this element, dimension and type
-      for (std::size_t k = 0; k < required_dim_et.size(); ++k)
+      for (std::int32_t c = c0; c < c1; ++c)
       {
-        // Get dimension d and entity type et
-        std::size_t d = required_dim_et[k].first;
-        std::size_t et = required_dim_et[k].second;
-        mesh::CellType e_type = topology.entity_types(d)[et];
+        // Wrap dofs for cell c
+        std::span<std::int32_t> dofs_c(dofs[i].array.data() + c * dofmap_width,
+                                       dofmap_width);
+
+        // Iterate over required entities for this element, dimension and type
+        for (std::size_t k = 0; k < required_dim_et.size(); ++k)
+        {
+          // Get dimension d and entity type et
+          std::size_t d = required_dim_et[k].first;
+          std::size_t et = required_dim_et[k].second;
+          mesh::CellType e_type = topology.entity_types(d)[et];
 
-        const std::vector<std::vector<int>>& e_dofs_d = entity_dofs[d];
+          const std::vector<std::vector<int>>& e_dofs_d = entity_dofs[d];
 
-        // Iterate over each entity of current dimension d and type et
-        std::span<const std::int32_t> c_to_e
-            = d < D ? topology.connectivity({D, i}, {d, et})->links(c)
-                    : std::span<const std::int32_t>(&c, 1);
+          // Iterate over each entity of current dimension d and type et
+          std::span<const std::int32_t> c_to_e
+              = d < D ? topology.connectivity({D, i}, {d, et})->links(c)
+                      : std::span<const std::int32_t>(&c, 1);
 
-        int w = 0;
-        for (std::size_t e = 0; e < e_dofs_d.size(); ++e)
-        {
-          // Skip entities of wrong type (e.g. for facets of prism)
-          // Use separate connectivity index 'w' which only advances for
-          // correct entities
-          if (mesh::cell_entity_type(cell_type, d, e) == e_type)
+          int w = 0;
+          for (std::size_t e = 0; e < e_dofs_d.size(); ++e)
           {
-            const std::vector<int>& e_dofs_d_e = e_dofs_d[e];
-            std::size_t num_entity_dofs = e_dofs_d_e.size();
-            assert((int)num_entity_dofs == num_entity_dofs_et[k]);
-            std::int32_t e_index_local = c_to_e[w];
-            ++w;
-
-            // Loop over dofs belonging to entity e of dimension d (d, e)
-            // d: topological dimension
-            // e: local entity index
-            // dof_local: local index of dof at (d, e)
-            for (std::size_t j = 0; j < num_entity_dofs; ++j)
+            // Skip entities of wrong type (e.g. for facets of prism)
+            // Use separate connectivity index 'w' which only advances for
+            // correct entities
+            if (mesh::cell_entity_type(cell_type, d, e) == e_type)
             {
-              int dof_local = e_dofs_d_e[j];
-              dofs_c[dof_local] = local_entity_offsets[k]
-                                  + num_entity_dofs * e_index_local + j;
+              const std::vector<int>& e_dofs_d_e = e_dofs_d[e];
+              std::size_t num_entity_dofs = e_dofs_d_e.size();
+              assert((int)num_entity_dofs == num_entity_dofs_et[k]);
+              std::int32_t e_index_local = c_to_e[w];
+              ++w;
+
+              // Loop over dofs belonging to entity e of dimension d (d, e)
+              // d: topological dimension
+              // e: local entity index
+              // dof_local: local index of dof at (d, e)
+              for (std::size_t j = 0; j < num_entity_dofs; ++j)
+              {
+                int dof_local = e_dofs_d_e[j];
+                dofs_c[dof_local] = local_entity_offsets[k]
+                                    + num_entity_dofs * e_index_local + j;
+              }
             }
           }
         }
       }
-    }
+    };
+    common::parallel_for(num_cells, num_threads, build_cells);
   }
 
-  spdlog::info("Global index computation");
+  DOLFINX_LOG_INFO("Global index computation");
 
   // TODO: Put Global index computations in separate function
   // Global index computations
@@ -337,20 +353,34 @@ build_basic_dofmaps(
     const int num_entity_dofs = num_entity_dofs_et[k];
     auto map = topo_index_maps[k];
     assert(map);
-    std::vector<std::int64_t> global_indices = map->global_indices();
 
-    for (std::size_t e_index = 0; e_index < global_indices.size(); ++e_index)
+    // Global entity indices are computed from the local range and the
+    // ghosts, to avoid creating the array of all global indices
+    const std::int32_t size_local = map->size_local();
+    const std::int64_t range0 = map->local_range()[0];
+    std::span<const std::int64_t> ghosts = map->ghosts();
+    auto build_entities = [&, k, num_entity_dofs, size_local, range0,
+                           global_entity_offsets](std::int32_t e0,
+                                                  std::int32_t e1)
     {
-      auto e_index_global = global_indices[e_index];
-      for (std::int32_t count = 0; count < num_entity_dofs; ++count)
+      for (std::int32_t e_index = e0; e_index < e1; ++e_index)
       {
-        std::int32_t dof
-            = local_entity_offsets[k] + num_entity_dofs * e_index + count;
-        local_to_global[dof]
-            = global_entity_offsets + num_entity_dofs * e_index_global + count;
-        dof_entity[dof] = {k, e_index};
+        std::int64_t e_index_global
+            = e_index < size_local ? range0 + e_index
+                                   : ghosts[e_index - size_local];
+        for (std::int32_t count = 0; count < num_entity_dofs; ++count)
+        {
+          std::int32_t dof
+              = local_entity_offsets[k] + num_entity_dofs * e_index + count;
+          local_to_global[dof] = global_entity_offsets
+                                 + num_entity_dofs * e_index_global + count;
+          dof_entity[dof] = {k, e_index};
+        }
       }
-    }
+    };
+    common::parallel_for(size_local + map->num_ghosts(), num_threads,
+                         build_entities);
+
     global_entity_offsets += num_entity_dofs * map->size_global();
     global_start += num_entity_dofs * map->local_range()[0];
   }
@@ -403,7 +433,7 @@ std::pair<std::vector<std::int32_t>, std::int32_t> compute_reordering_map(
   // owned dofs. Set to -1 for unowned dofs.
   std::vector<int> original_to_contiguous(dof_entity.size(), -1);
   std::int32_t counter_owned(0), counter_unowned(owned_size);
-  for (auto dofmap : dofmaps)
+  for (const dofmap_t& dofmap : dofmaps)
   {
     for (std::int32_t dof : dofmap.array)
     {
@@ -470,6 +500,7 @@ std::pair<std::vector<std::int64_t>, std::vector<int>> get_global_indices(
     const std::vector<std::int32_t>& old_to_new,
     const std::vector<std::pair<std::int8_t, std::int32_t>>& dof_entity)
 {
+  common::Timer t0("Compute global indices of unowned dofs");
   assert(dof_entity.size() == global_indices_old.size());
 
   // Build list of flags for owned mesh entities that are shared, i.e.
@@ -618,7 +649,8 @@ fem::build_dofmap_data(
     MPI_Comm comm, const mesh::Topology& topology,
     const std::vector<ElementDofLayout>& element_dof_layouts,
     const std::function<std::vector<int>(
-        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
+    int num_threads)
 {
   common::Timer t0("Build dofmap data");
 
@@ -626,18 +658,17 @@ fem::build_dofmap_data(
   // a local dofmap, (ii) local-to-global map for dof indices, and (iii)
   // pair {dimension, mesh entity index} giving the mesh entity that dof
   // i is associated with.
-  const auto [node_graphs, local_to_global0, dof_entity0, topo_index_maps,
-              offset]
-      = build_basic_dofmaps(topology, element_dof_layouts);
+  auto [node_graphs, local_to_global0, dof_entity0, topo_index_maps, offset]
+      = build_basic_dofmaps(topology, element_dof_layouts, num_threads);
 
-  spdlog::info("Got {} index_maps", topo_index_maps.size());
+  DOLFINX_LOG_INFO("Got {} index_maps", topo_index_maps.size());
 
   // Build re-ordering map for data locality and get number of owned
   // nodes
   const auto [old_to_new, num_owned] = compute_reordering_map(
       node_graphs, dof_entity0, topo_index_maps, reorder_fn);
 
-  spdlog::info("Get global indices");
+  DOLFINX_LOG_INFO("Get global indices");
 
   // Get global indices for unowned dofs
   const auto [local_to_global_unowned, local_to_global_owner]
@@ -649,19 +680,23 @@ fem::build_dofmap_data(
   common::IndexMap index_map(comm, num_owned, local_to_global_unowned,
                              local_to_global_owner);
 
-  // Build re-ordered dofmaps
-  std::vector<std::vector<std::int32_t>> dofmaps(node_graphs.size());
-  for (std::size_t i = 0; i < dofmaps.size(); ++i)
+  // Build re-ordered dofmaps, re-using the storage of the basic
+  // dofmaps
+  common::Timer t1("Build re-ordered dofmaps");
+  std::vector<std::vector<std::int32_t>> dofmaps;
+  dofmaps.reserve(node_graphs.size());
+  for (dofmap_t& node_graph : node_graphs)
   {
-    const std::vector<std::int32_t>& node_graphs_i = node_graphs[i].array;
-    dofmaps[i].resize(node_graphs_i.size());
-    std::vector<std::int32_t>& dofmaps_i = dofmaps[i];
-    for (std::size_t j = 0; j < node_graphs_i.size(); ++j)
-    {
-      std::int32_t old_node = node_graphs_i[j];
-      dofmaps_i[j] = old_to_new[old_node];
-    }
+    std::vector<std::int32_t>& dofmap = node_graph.array;
+    common::parallel_for(dofmap.size(), num_threads,
+                 [&dofmap, &old_to_new](std::size_t j0, std::size_t j1)
+                 {
+                   for (std::size_t j = j0; j < j1; ++j)
+                     dofmap[j] = old_to_new[dofmap[j]];
+                 });
+    dofmaps.push_back(std::move(dofmap));
   }
+  t1.stop();
 
   return {std::move(index_map), element_dof_layouts.front().block_size(),
           std::move(dofmaps)};
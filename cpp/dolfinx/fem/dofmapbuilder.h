@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <functional>
 #include <mpi.h>
 #include <tuple>
@@ -22,12 +23,6 @@ namespace dolfinx::mesh
 class Topology;
 }
 
-namespace dolfinx::graph
-{
-template <typename T>
-class AdjacencyList;
-}
-
 namespace dolfinx::fem
 {
 class ElementDofLayout;
@@ -38,12 +33,18 @@ class ElementDofLayout;
 /// @param[in] element_dof_layouts The element dof layouts for each cell type in
 /// @p topology
 /// @param[in] reorder_fn Graph reordering function that is applied to
-/// the dofmaps
+/// the dofmaps. If empty, the graph of owned dofs is not created and
+/// owned dofs are numbered in the order that they are first reached
+/// when iterating over cells. This preserves the locality of the cell
+/// ordering, e.g. when cells are ordered along a space-filling curve,
+/// and is cheaper than a graph reordering.
+/// @param[in] num_threads Number of threads to use
 /// @return The index map, block size, and dofmaps for each element type
 std::tuple<common::IndexMap, int, std::vector<std::vector<std::int32_t>>>
 build_dofmap_data(MPI_Comm comm, const mesh::Topology& topology,
                   const std::vector<ElementDofLayout>& element_dof_layouts,
                   const std::function<std::vector<int>(
-                      const graph::AdjacencyList<std::int32_t>&)>& reorder_fn);
+                      const graph::AdjacencyList<std::int32_t>&)>& reorder_fn,
+                  int num_threads = 1);
 
 } // namespace dolfinx::fem
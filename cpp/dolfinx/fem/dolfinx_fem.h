@@ -10,6 +10,10 @@ namespace dolfinx::fem
 
 // DOLFINx fem interface
 
+#include <dolfinx/fem/AssemblyHandle.h>
+#include <dolfinx/fem/AssemblyPlan.h>
+#include <dolfinx/fem/CellGroup.h>
+#include <dolfinx/fem/CoefficientCache.h>
 #include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/DofMap.h>
@@ -17,7 +21,16 @@ namespace dolfinx::fem
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/InterpolationOperator.h>
+#include <dolfinx/fem/InverseMass.h>
+#include <dolfinx/fem/LocalSolver.h>
+#include <dolfinx/fem/MatrixCache.h>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/fem/StaticCondensation.h>
+#include <dolfinx/fem/SumFactorisedOperator.h>
+#include <dolfinx/fem/TabulationCache.h>
 #include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/assembly_profiling.h>
 #include <dolfinx/fem/discreteoperators.h>
 #include <dolfinx/fem/sparsitybuild.h>
 #include <dolfinx/fem/utils.h>
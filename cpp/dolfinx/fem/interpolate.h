@@ -15,10 +15,13 @@
 #include <basix/mdspan.hpp>
 #include <concepts>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/types.h>
 #include <dolfinx/geometry/utils.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <span>
 #include <vector>
@@ -667,13 +670,214 @@ void interpolate_nonmatching_maps(Function<T, U>& u1,
 
     // Copy local coefficients to the correct position in u dof array
     const int dof_bs1 = dofmap1->bs();
-    std::span<const std::int32_t> dofs1 = dofmap1->cell_dofs(c);
+    std::span<const std::int32_t> dofs1 = dofmap1->cell_dofs(cells1[c]);
     for (std::size_t i = 0; i < dofs1.size(); ++i)
       for (int k = 0; k < dof_bs1; ++k)
         array1[dof_bs1 * dofs1[i] + k] = local1[dof_bs1 * i + k];
   }
 }
 
+/// @brief Compute the cell matrices of the interpolation between
+/// finite element spaces whose elements have different maps.
+///
+/// The matrix of a cell maps the degrees-of-freedom of `V0` on the cell
+/// to the degrees-of-freedom of `V1`, as computed by
+/// interpolate_nonmatching_maps. It includes the dof transformations,
+/// the push-forward of the basis of `V0` and the pull-back to the
+/// reference element of `V1`, i.e. everything that depends on the cell
+/// geometry.
+///
+/// @param[in] V1 Space to interpolate to.
+/// @param[in] cells1 Cells to interpolate on.
+/// @param[in] V0 Space to interpolate from.
+/// @param[in] cells0 Equivalent cell in `V0` for each cell in `V1`.
+/// @return The matrices (row-major), with shape `(cells0.size(),
+/// num_dofs1, num_dofs0)` where `num_dofs1` and `num_dofs0` are the
+/// space dimensions of the elements (with the block size unrolled).
+/// @pre The spaces `V1` and `V0` must share the same mesh.
+template <std::floating_point U>
+std::vector<U> nonmatching_maps_matrices(const FunctionSpace<U>& V1,
+                                         std::span<const std::int32_t> cells1,
+                                         const FunctionSpace<U>& V0,
+                                         std::span<const std::int32_t> cells0)
+{
+  namespace md = MDSPAN_IMPL_STANDARD_NAMESPACE;
+
+  auto mesh = V0.mesh();
+  assert(mesh);
+  const int tdim = mesh->topology()->dim();
+  const int gdim = mesh->geometry().dim();
+
+  auto element0 = V0.element();
+  assert(element0);
+  auto element1 = V1.element();
+  assert(element1);
+
+  std::span<const std::uint32_t> cell_info;
+  if (element1->needs_dof_transformations()
+      or element0->needs_dof_transformations())
+  {
+    mesh->topology_mutable()->create_entity_permutations();
+    cell_info = std::span(mesh->topology()->get_cell_permutation_info());
+  }
+
+  const auto [X, Xshape] = element1->interpolation_points();
+
+  const int bs0 = element0->block_size();
+  const int bs1 = element1->block_size();
+  auto apply_dof_transformation0 = element0->template dof_transformation_fn<U>(
+      doftransform::standard, false);
+  auto apply_inverse_dof_transform1
+      = element1->template dof_transformation_fn<U>(
+          doftransform::inverse_transpose, false);
+
+  // Sizes of the elements
+  const std::size_t num_dofs0 = element0->space_dimension();
+  const std::size_t num_dofs1 = element1->space_dimension();
+  const std::size_t dim0 = num_dofs0 / bs0;
+  const std::size_t value_size_ref0 = element0->reference_value_size() / bs0;
+  const std::size_t value_size0 = V0.value_size() / bs0;
+  const std::size_t value_size1 = V1.value_size();
+
+  const CoordinateElement<U>& cmap = mesh->geometry().cmap();
+  auto x_dofmap = mesh->geometry().dofmap();
+  const std::size_t num_dofs_g = cmap.dim();
+  std::span<const U> x_g = mesh->geometry().x();
+
+  // Evaluate coordinate map basis at reference interpolation points
+  const std::array<std::size_t, 4> phi_shape
+      = cmap.tabulate_shape(1, Xshape[0]);
+  std::vector<U> phi_b(
+      std::reduce(phi_shape.begin(), phi_shape.end(), 1, std::multiplies{}));
+  mdspan_t<const U, 4> phi(phi_b.data(), phi_shape);
+  cmap.tabulate(1, X, Xshape, phi_b);
+
+  // Evaluate basis functions of V0 at reference interpolation points
+  const auto [_basis_reference0, b0shape] = element0->tabulate(X, Xshape, 0);
+  mdspan_t<const U, 4> basis_derivatives_reference0(_basis_reference0.data(),
+                                                    b0shape);
+
+  // Interpolation operator of V1
+  const auto [_Pi_1, pi_shape] = element1->interpolation_operator();
+  mdspan_t<const U, 2> Pi_1(_Pi_1.data(), pi_shape);
+
+  using u_t = mdspan_t<U, 2>;
+  using U_t = mdspan_t<const U, 2>;
+  using J_t = mdspan_t<const U, 2>;
+  using K_t = mdspan_t<const U, 2>;
+  auto push_forward_fn0
+      = element0->basix_element().template map_fn<u_t, U_t, J_t, K_t>();
+  auto pull_back_fn1
+      = element1->basix_element().template map_fn<u_t, U_t, K_t, J_t>();
+
+  // Working arrays
+  std::vector<U> basis_reference0_b(Xshape[0] * dim0 * value_size_ref0);
+  mdspan_t<U, 3> basis_reference0(basis_reference0_b.data(), Xshape[0], dim0,
+                                  value_size_ref0);
+  std::vector<U> basis0_b(Xshape[0] * dim0 * value_size0);
+  mdspan_t<U, 3> basis0(basis0_b.data(), Xshape[0], dim0, value_size0);
+  std::vector<U> values_b(Xshape[0] * value_size1);
+  mdspan_t<U, 2> values(values_b.data(), Xshape[0], value_size1);
+  std::vector<U> mapped_values_b(Xshape[0] * value_size1);
+  mdspan_t<const U, 2> mapped_values(mapped_values_b.data(), Xshape[0],
+                                     value_size1);
+  std::vector<U> column(num_dofs1);
+
+  std::vector<U> coord_dofs_b(num_dofs_g * gdim);
+  mdspan_t<U, 2> coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+  std::vector<U> J_b(Xshape[0] * gdim * tdim);
+  mdspan_t<U, 3> J(J_b.data(), Xshape[0], gdim, tdim);
+  std::vector<U> K_b(Xshape[0] * tdim * gdim);
+  mdspan_t<U, 3> K(K_b.data(), Xshape[0], tdim, gdim);
+  std::vector<U> detJ(Xshape[0]);
+  std::vector<U> det_scratch(2 * gdim * tdim);
+
+  const std::size_t size = num_dofs1 * num_dofs0;
+  std::vector<U> matrices(cells0.size() * size);
+  for (std::size_t c = 0; c < cells0.size(); ++c)
+  {
+    // Cell geometry and Jacobians at the interpolation points
+    auto x_dofs = md::submdspan(x_dofmap, cells0[c], md::full_extent);
+    for (std::size_t i = 0; i < num_dofs_g; ++i)
+    {
+      const int pos = 3 * x_dofs[i];
+      for (int j = 0; j < gdim; ++j)
+        coord_dofs(i, j) = x_g[pos + j];
+    }
+
+    std::ranges::fill(J_b, 0);
+    for (std::size_t p = 0; p < Xshape[0]; ++p)
+    {
+      auto dphi = md::submdspan(phi, std::pair(1, tdim + 1), p,
+                                md::full_extent, 0);
+      auto _J = md::submdspan(J, p, md::full_extent, md::full_extent);
+      cmap.compute_jacobian(dphi, coord_dofs, _J);
+      auto _K = md::submdspan(K, p, md::full_extent, md::full_extent);
+      cmap.compute_jacobian_inverse(_J, _K);
+      detJ[p] = cmap.compute_jacobian_determinant(_J, det_scratch);
+    }
+
+    // Transformed basis of V0, pushed forward to the cell
+    for (std::size_t p = 0; p < Xshape[0]; ++p)
+      for (std::size_t i = 0; i < dim0; ++i)
+        for (std::size_t j = 0; j < value_size_ref0; ++j)
+          basis_reference0(p, i, j) = basis_derivatives_reference0(0, p, i, j);
+    for (std::size_t p = 0; p < Xshape[0]; ++p)
+    {
+      apply_dof_transformation0(
+          std::span(basis_reference0_b.data() + p * dim0 * value_size_ref0,
+                    dim0 * value_size_ref0),
+          cell_info, cells0[c], value_size_ref0);
+    }
+    for (std::size_t p = 0; p < Xshape[0]; ++p)
+    {
+      auto _u = md::submdspan(basis0, p, md::full_extent, md::full_extent);
+      auto _U = md::submdspan(basis_reference0, p, md::full_extent,
+                              md::full_extent);
+      auto _K = md::submdspan(K, p, md::full_extent, md::full_extent);
+      auto _J = md::submdspan(J, p, md::full_extent, md::full_extent);
+      push_forward_fn0(_u, _U, _J, detJ[p], _K);
+    }
+
+    // Column (bs0 * i + k) of the cell matrix is the interpolant of
+    // component k of basis function i of V0
+    std::span A(matrices.data() + c * size, size);
+    for (std::size_t i = 0; i < dim0; ++i)
+    {
+      for (int k = 0; k < bs0; ++k)
+      {
+        std::ranges::fill(values_b, 0);
+        for (std::size_t p = 0; p < Xshape[0]; ++p)
+          for (std::size_t j = 0; j < value_size0; ++j)
+            values(p, j * bs0 + k) = basis0(p, i, j);
+
+        // Pull back to the reference element of V1 and interpolate
+        for (std::size_t p = 0; p < Xshape[0]; ++p)
+        {
+          mdspan_t<const U, 2> _u(values_b.data() + p * value_size1, 1,
+                                  value_size1);
+          mdspan_t<U, 2> _U(mapped_values_b.data() + p * value_size1, 1,
+                            value_size1);
+          auto _K = md::submdspan(K, p, md::full_extent, md::full_extent);
+          auto _J = md::submdspan(J, p, md::full_extent, md::full_extent);
+          pull_back_fn1(_U, _u, _K, 1.0 / detJ[p], _J);
+        }
+        interpolation_apply(Pi_1, mapped_values, std::span(column), bs1);
+
+        const std::size_t col = bs0 * i + k;
+        for (std::size_t r = 0; r < num_dofs1; ++r)
+          A[r * num_dofs0 + col] = column[r];
+      }
+    }
+
+    // Inverse transpose dof transformation of V1, applied to each
+    // column
+    apply_inverse_dof_transform1(A, cell_info, cells1[c], num_dofs0);
+  }
+
+  return matrices;
+}
+
 //----------------------------------------------------------------------------
 } // namespace impl
 
@@ -1035,6 +1239,348 @@ void interpolate(Function<T, U>& u, std::span<const T> f,
   }
 }
 
+/// @brief Cached interpolation operators for interpolating evaluated
+/// expressions into a finite element space on a fixed set of cells.
+///
+/// Interpolating `f(x)` with fem::interpolate tabulates the coordinate
+/// element, computes the Jacobians of the cells and pulls back the
+/// values each time it is called. An Interpolator does this once
+/// and stores, for each cell, the matrix that maps the values of `f`
+/// at the interpolation points of the cell to the degrees-of-freedom
+/// of the cell. The matrix includes the pull-back, the element
+/// interpolation operator and the degree-of-freedom transformations.
+/// Interpolation with an Interpolator, e.g. of time-dependent data at
+/// each time step, is then a gather, a matrix-vector product and a
+/// scatter per cell.
+///
+/// A single matrix is stored for all cells when it does not depend on
+/// the cell, i.e. for elements with the identity map and no
+/// degree-of-freedom transformations, and no matrix is stored for
+/// point evaluation elements for which it is the identity.
+///
+/// The mesh of the function space must not move while the Interpolator
+/// is in use.
+///
+/// @tparam U mesh::Mesh geometry scalar type.
+template <std::floating_point U>
+class Interpolator
+{
+public:
+  /// @brief Create an Interpolator.
+  /// @param[in] V Space to interpolate into.
+  /// @param[in] cells Indices of the cells in the mesh of `V` on which
+  /// to interpolate.
+  Interpolator(std::shared_ptr<const FunctionSpace<U>> V,
+               std::span<const std::int32_t> cells)
+      : _V(V), _cells(cells.begin(), cells.end())
+  {
+    assert(_V);
+    auto element = _V->element();
+    assert(element);
+    _bs = element->block_size();
+    if (int num_sub = element->num_sub_elements();
+        num_sub > 0 and num_sub != _bs)
+    {
+      throw std::runtime_error("Cannot directly interpolate a mixed space. "
+                               "Interpolate into subspaces.");
+    }
+    if (_V->symmetric())
+    {
+      throw std::runtime_error(
+          "Interpolators are not supported for symmetric spaces.");
+    }
+
+    auto mesh = _V->mesh();
+    assert(mesh);
+    _x = interpolation_coords<U>(*element, mesh->geometry(), _cells);
+
+    const auto [X, Xshape] = element->interpolation_points();
+    if (X.empty())
+    {
+      throw std::runtime_error(
+          "Interpolation into this space is not yet supported.");
+    }
+
+    _num_dofs = element->space_dimension() / _bs;
+    _num_points = Xshape[0];
+    _value_size = _V->value_size() / _bs;
+    const std::size_t num_cols = _num_points * _value_size;
+
+    const auto [_Pi, pi_shape] = element->interpolation_operator();
+    if (pi_shape[0] != _num_dofs or pi_shape[1] != num_cols)
+    {
+      throw std::runtime_error(
+          "Interpolation into this element not supported.");
+    }
+
+    const bool needs_transformations = element->needs_dof_transformations();
+    if (element->map_ident() and !needs_transformations)
+    {
+      // The operator is the same for all cells
+      if (!element->interpolation_ident())
+      {
+        _num_operators = 1;
+        _operators = _Pi;
+      }
+      return;
+    }
+
+    std::span<const std::uint32_t> cell_info;
+    if (needs_transformations)
+    {
+      mesh->topology_mutable()->create_entity_permutations();
+      cell_info = std::span(mesh->topology()->get_cell_permutation_info());
+    }
+    auto apply_inverse_transpose_dof_transformation
+        = element->template dof_transformation_fn<U>(
+            doftransform::inverse_transpose, true);
+
+    _num_operators = _cells.size();
+    const std::size_t op_size = _num_dofs * num_cols;
+    _operators.resize(_num_operators * op_size);
+    if (element->map_ident())
+    {
+      for (std::size_t c = 0; c < _cells.size(); ++c)
+      {
+        std::span A(_operators.data() + c * op_size, op_size);
+        std::ranges::copy(_Pi, A.begin());
+        apply_inverse_transpose_dof_transformation(A, cell_info, _cells[c],
+                                                   num_cols);
+      }
+      return;
+    }
+
+    using cmdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+    using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+    cmdspan2_t Pi(_Pi.data(), pi_shape);
+
+    const CoordinateElement<U>& cmap = mesh->geometry().cmap();
+    auto x_dofmap = mesh->geometry().dofmap();
+    std::span<const U> x_g = mesh->geometry().x();
+    const std::size_t num_dofs_g = cmap.dim();
+    const std::size_t gdim = mesh->geometry().dim();
+    const std::size_t tdim = mesh->topology()->dim();
+
+    // Tabulate 1st derivative of shape functions at interpolation
+    // coords
+    std::array<std::size_t, 4> phi_shape = cmap.tabulate_shape(1, Xshape[0]);
+    std::vector<U> phi_b(
+        std::reduce(phi_shape.begin(), phi_shape.end(), 1, std::multiplies{}));
+    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const U, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>
+        phi(phi_b.data(), phi_shape);
+    cmap.tabulate(1, X, Xshape, phi_b);
+    auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        phi, std::pair(1, tdim + 1),
+        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+
+    std::vector<U> coord_dofs_b(num_dofs_g * gdim);
+    mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+    std::vector<U> J_b(gdim * tdim);
+    mdspan2_t J(J_b.data(), gdim, tdim);
+    std::vector<U> K_b(tdim * gdim);
+    mdspan2_t K(K_b.data(), tdim, gdim);
+    std::vector<U> det_scratch(2 * gdim * tdim);
+
+    // Pull-back of the values at a point, as a (value_size,
+    // value_size) matrix M with the pull-back of the jth unit vector in
+    // column j
+    std::vector<U> M_b(_value_size * _value_size);
+    mdspan2_t M(M_b.data(), _value_size, _value_size);
+    std::vector<U> e_b(_value_size), Me_b(_value_size);
+    cmdspan2_t e(e_b.data(), 1, _value_size);
+    mdspan2_t Me(Me_b.data(), 1, _value_size);
+
+    auto pull_back_fn = element->basix_element()
+                            .template map_fn<mdspan2_t, cmdspan2_t,
+                                             cmdspan2_t, cmdspan2_t>();
+    for (std::size_t c = 0; c < _cells.size(); ++c)
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, _cells[c], MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
+      {
+        const int pos = 3 * x_dofs[i];
+        for (std::size_t j = 0; j < gdim; ++j)
+          coord_dofs(i, j) = x_g[pos + j];
+      }
+
+      // A(i, m * num_points + p) = sum_n Pi(i, n * num_points + p) *
+      // M_p(n, m)
+      std::span A(_operators.data() + c * op_size, op_size);
+      for (std::size_t p = 0; p < _num_points; ++p)
+      {
+        auto _dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            dphi, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, p,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        std::ranges::fill(J_b, 0);
+        cmap.compute_jacobian(_dphi, coord_dofs, J);
+        cmap.compute_jacobian_inverse(J, K);
+        const U detJ = cmap.compute_jacobian_determinant(J, det_scratch);
+        for (std::size_t m = 0; m < _value_size; ++m)
+        {
+          std::ranges::fill(e_b, 0);
+          e_b[m] = 1;
+          pull_back_fn(Me, e, K, 1.0 / detJ, J);
+          for (std::size_t n = 0; n < _value_size; ++n)
+            M(n, m) = Me(0, n);
+        }
+
+        for (std::size_t i = 0; i < _num_dofs; ++i)
+        {
+          for (std::size_t m = 0; m < _value_size; ++m)
+          {
+            U acc = 0;
+            for (std::size_t n = 0; n < _value_size; ++n)
+              acc += Pi(i, n * _num_points + p) * M(n, m);
+            A[i * num_cols + m * _num_points + p] = acc;
+          }
+        }
+      }
+
+      apply_inverse_transpose_dof_transformation(A, cell_info, _cells[c],
+                                                 num_cols);
+    }
+  }
+
+  /// Space to interpolate into
+  std::shared_ptr<const FunctionSpace<U>> function_space() const
+  {
+    return _V;
+  }
+
+  /// Cells to interpolate on
+  std::span<const std::int32_t> cells() const { return _cells; }
+
+  /// @brief Physical coordinates of the interpolation points, as
+  /// computed by fem::interpolation_coords for the cells of the
+  /// Interpolator.
+  ///
+  /// The shape is (3, num_points) and storage is row-major.
+  std::span<const U> points() const { return _x; }
+
+  /// @brief Compute the degrees-of-freedom of a Function from values at
+  /// the interpolation points.
+  /// @param[in] f Evaluation of the function `f(x)` at points(). The
+  /// shape of `f` is `(value_size, num_points)`, with row-major
+  /// storage.
+  /// @param[in] fshape Shape of `f`.
+  /// @param[in,out] coeffs Degree-of-freedom vector of a Function in
+  /// the space of the Interpolator. The entries for the
+  /// degrees-of-freedom of the cells are set.
+  template <dolfinx::scalar T>
+  void apply(std::span<const T> f, std::array<std::size_t, 2> fshape,
+             std::span<T> coeffs) const
+  {
+    using X = typename dolfinx::scalar_value_type_t<T>;
+    if (fshape[0] != _value_size * _bs
+        or fshape[1] != _cells.size() * _num_points)
+    {
+      throw std::runtime_error("Interpolation data has the wrong shape/size.");
+    }
+    assert(f.size() == fshape[0] * fshape[1]);
+
+    auto dofmap = _V->dofmap();
+    assert(dofmap);
+    const int dofmap_bs = dofmap->bs();
+    const std::size_t num_cols = _num_points * _value_size;
+    const std::size_t op_size = _num_dofs * num_cols;
+    std::vector<T> values(num_cols), _coeffs(_num_dofs);
+    for (std::size_t c = 0; c < _cells.size(); ++c)
+    {
+      std::span<const std::int32_t> dofs = dofmap->cell_dofs(_cells[c]);
+      for (int k = 0; k < _bs; ++k)
+      {
+        // Gather the values of block k at the points of the cell
+        for (std::size_t m = 0; m < _value_size; ++m)
+        {
+          std::copy_n(std::next(f.begin(), (k * _value_size + m) * fshape[1]
+                                               + c * _num_points),
+                      _num_points,
+                      std::next(values.begin(), m * _num_points));
+        }
+
+        if (_num_operators == 0)
+          std::ranges::copy(values, _coeffs.begin());
+        else
+        {
+          std::span<const U> A(_operators.data()
+                                   + (_num_operators == 1 ? 0 : c) * op_size,
+                               op_size);
+          for (std::size_t i = 0; i < _num_dofs; ++i)
+          {
+            T acc = 0;
+            for (std::size_t j = 0; j < num_cols; ++j)
+              acc += static_cast<X>(A[i * num_cols + j]) * values[j];
+            _coeffs[i] = acc;
+          }
+        }
+
+        for (std::size_t i = 0; i < _num_dofs; ++i)
+        {
+          const int dof = i * _bs + k;
+          std::div_t pos = std::div(dof, dofmap_bs);
+          coeffs[dofmap_bs * dofs[pos.quot] + pos.rem] = _coeffs[i];
+        }
+      }
+    }
+  }
+
+private:
+  // Space to interpolate into
+  std::shared_ptr<const FunctionSpace<U>> _V;
+
+  // Cells to interpolate on
+  std::vector<std::int32_t> _cells;
+
+  // Physical coordinates of the interpolation points (shape=(3,
+  // num_points))
+  std::vector<U> _x;
+
+  // Block size, and the dimension, number of interpolation points and
+  // value size of the (unblocked) element
+  int _bs;
+  std::size_t _num_dofs, _num_points, _value_size;
+
+  // Number of stored operators: 0 if the operator is the identity, 1
+  // if the same operator is used for all cells, and otherwise the
+  // number of cells
+  std::size_t _num_operators = 0;
+
+  // Operators mapping (value_size * num_points) values to the
+  // degrees-of-freedom of a cell (shape=(_num_operators, _num_dofs,
+  // _value_size * _num_points))
+  std::vector<U> _operators;
+};
+
+/// @brief Interpolate an evaluated expression f(x) in a finite element
+/// space using cached interpolation operators.
+///
+/// @tparam T Scalar type
+/// @tparam U Mesh geometry type
+/// @param[out] u Function object to interpolate into. It must be in the
+/// function space of `interpolator`.
+/// @param[in] f Evaluation of the function `f(x)` at the physical
+/// points Interpolator::points(). The shape of `f` is `(value_size,
+/// num_points)`, with row-major storage.
+/// @param[in] fshape Shape of `f`.
+/// @param[in] interpolator Interpolator for the space of `u`.
+template <dolfinx::scalar T, std::floating_point U>
+void interpolate(Function<T, U>& u, std::span<const T> f,
+                 std::array<std::size_t, 2> fshape,
+                 const Interpolator<U>& interpolator)
+{
+  if (u.function_space() != interpolator.function_space())
+  {
+    throw std::runtime_error(
+        "Function is not in the space of the interpolator.");
+  }
+  interpolator.apply(f, fshape, u.x()->mutable_array());
+}
+
 /// @brief Generate data needed to interpolate finite element Functions
 /// across different meshes.
 ///
@@ -1073,6 +1619,704 @@ geometry::PointOwnershipData<T> create_interpolation_data(
   return geometry::determine_point_ownership<T>(mesh1, x, padding);
 }
 
+/// @brief Plan for repeated evaluation of Functions at a fixed set of
+/// points.
+///
+/// Function::eval pulls back each point to the reference cell and
+/// tabulates the element basis every time it is called. A plan stores
+/// the basis values at the points, mapped to the physical cells, so
+/// that evaluating a Function from the space, e.g. at sensor points at
+/// each time step, is only a contraction of the cached basis values
+/// with the degrees-of-freedom. The points are grouped by cell, so that
+/// the degrees-of-freedom of a cell are gathered once for all points in
+/// the cell.
+///
+/// The mesh of the function space must not move while the plan is in
+/// use.
+///
+/// @tparam U mesh::Mesh geometry scalar type.
+template <std::floating_point U>
+class EvaluationPlan
+{
+public:
+  /// @brief Create a plan.
+  /// @param[in] V Space of the Functions to evaluate.
+  /// @param[in] x Points to evaluate at (shape=(num_points, 3)).
+  /// @param[in] cells Cell that each point is located in. Points with a
+  /// negative cell index are not evaluated, and the values at these
+  /// points are zero.
+  EvaluationPlan(std::shared_ptr<const FunctionSpace<U>> V,
+                 std::span<const U> x, std::span<const std::int32_t> cells)
+      : _V(V), _cells(cells.begin(), cells.end())
+  {
+    assert(_V);
+    assert(x.size() == 3 * cells.size());
+    auto element = _V->element();
+    assert(element);
+    const int bs = element->block_size();
+    const int num_sub_elements = element->num_sub_elements();
+    if (num_sub_elements > 1 and num_sub_elements != bs)
+    {
+      throw std::runtime_error("Evaluation plans are not supported for "
+                               "mixed elements. Extract subspaces.");
+    }
+    if (element->symmetric())
+    {
+      throw std::runtime_error(
+          "Evaluation plans are not supported for symmetric elements.");
+    }
+
+    _space_dim = element->space_dimension() / bs;
+    _value_size = _V->value_size() / bs;
+    std::vector<U> basis = tabulate(x);
+
+    // Group the located points by cell
+    for (std::size_t p = 0; p < _cells.size(); ++p)
+      if (_cells[p] >= 0)
+        _points.push_back(p);
+    std::ranges::stable_sort(_points, std::less{},
+                             [this](auto p) { return _cells[p]; });
+    _offsets.push_back(0);
+    for (std::size_t a = 1; a < _points.size(); ++a)
+      if (_cells[_points[a]] != _cells[_points[a - 1]])
+        _offsets.push_back(a);
+    if (!_points.empty())
+      _offsets.push_back(_points.size());
+
+    const std::size_t num_basis_values = _space_dim * _value_size;
+    _basis.resize(_points.size() * num_basis_values);
+    for (std::size_t a = 0; a < _points.size(); ++a)
+    {
+      std::copy_n(std::next(basis.begin(), _points[a] * num_basis_values),
+                  num_basis_values,
+                  std::next(_basis.begin(), a * num_basis_values));
+    }
+  }
+
+  /// Space of the Functions to evaluate
+  std::shared_ptr<const FunctionSpace<U>> function_space() const
+  {
+    return _V;
+  }
+
+  /// Number of points
+  std::size_t num_points() const { return _cells.size(); }
+
+  /// Cell that each point is located in (negative for points that are
+  /// not evaluated)
+  std::span<const std::int32_t> cells() const { return _cells; }
+
+  /// @brief Evaluate a Function at the points.
+  /// @param[in] v Function to evaluate. It must be in the space of the
+  /// plan.
+  /// @param[out] values Values at the points (shape=(num_points,
+  /// value_size)).
+  /// @param[in] num_threads Number of threads to use. The cells are
+  /// split between the threads.
+  template <dolfinx::scalar T>
+  void eval(const Function<T, U>& v, std::span<T> values,
+            int num_threads = 1) const
+  {
+    if (v.function_space() != _V)
+    {
+      throw std::runtime_error(
+          "Function is not in the space of the evaluation plan.");
+    }
+
+    auto dofmap = _V->dofmap();
+    assert(dofmap);
+    const int bs_dof = dofmap->bs();
+    const int bs = _V->element()->block_size();
+    const std::size_t shape1 = _value_size * bs;
+    if (values.size() != _cells.size() * shape1)
+      throw std::runtime_error("Array for Function values has wrong size.");
+
+    std::span<const T> x = v.x()->array();
+    const std::size_t num_basis_values = _space_dim * _value_size;
+    auto eval_cells = [&](std::size_t c0, std::size_t c1)
+    {
+      std::vector<T> coefficients(_space_dim * bs);
+      for (std::size_t c = c0; c < c1; ++c)
+      {
+        std::span<const std::int32_t> dofs
+            = dofmap->cell_dofs(_cells[_points[_offsets[c]]]);
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < bs_dof; ++k)
+            coefficients[bs_dof * i + k] = x[bs_dof * dofs[i] + k];
+
+        // Contract the cached basis values at all points in the cell
+        // with the cell coefficients
+        for (std::int32_t a = _offsets[c]; a < _offsets[c + 1]; ++a)
+        {
+          impl::mdspan_t<const U, 2> phi(_basis.data() + a * num_basis_values,
+                                         _space_dim, _value_size);
+          std::span<T> u = values.subspan(_points[a] * shape1, shape1);
+          std::ranges::fill(u, T(0));
+          for (std::size_t i = 0; i < _space_dim; ++i)
+            for (std::size_t j = 0; j < _value_size; ++j)
+              for (int k = 0; k < bs; ++k)
+                u[j * bs + k] += coefficients[bs * i + k] * phi(i, j);
+        }
+      }
+    };
+
+    for (std::size_t p = 0; p < _cells.size(); ++p)
+    {
+      if (_cells[p] < 0)
+        std::fill_n(std::next(values.begin(), p * shape1), shape1, T(0));
+    }
+
+    // Split the cells between the threads, balancing the number of
+    // points
+    const std::size_t num_cells = _offsets.empty() ? 0 : _offsets.size() - 1;
+    const int nt = std::max(num_threads, 1);
+    std::vector<std::size_t> ranges(nt + 1, num_cells);
+    ranges[0] = 0;
+    for (int t = 1; t < nt; ++t)
+    {
+      auto it = std::ranges::lower_bound(_offsets, t * _points.size() / nt);
+      ranges[t] = std::min<std::size_t>(std::distance(_offsets.begin(), it),
+                                        num_cells);
+    }
+    common::run_tasks(nt, [&](int t)
+                      { eval_cells(ranges[t], ranges[t + 1]); });
+  }
+
+  /// @brief Add values at the points to a Function, with the transpose
+  /// of the evaluation.
+  ///
+  /// The basis function values at the points are weighted by the values
+  /// and added to the degrees-of-freedom of the Function, i.e. `v_i +=
+  /// sum_p phi_i(x_p) values_p`. This is the deposition of point data
+  /// onto a mesh, e.g. of particle charges. Only the local entries
+  /// (owned and ghost) of `v` are updated; the ghost contributions must
+  /// be sent to the owners with a reverse scatter.
+  /// @param[in] values Values at the points (shape=(num_points,
+  /// value_size)).
+  /// @param[in,out] v Function to add to. It must be in the space of
+  /// the plan.
+  template <dolfinx::scalar T>
+  void eval_adjoint(std::span<const T> values, Function<T, U>& v) const
+  {
+    if (v.function_space() != _V)
+    {
+      throw std::runtime_error(
+          "Function is not in the space of the evaluation plan.");
+    }
+
+    auto dofmap = _V->dofmap();
+    assert(dofmap);
+    const int bs_dof = dofmap->bs();
+    const int bs = _V->element()->block_size();
+    const std::size_t shape1 = _value_size * bs;
+    if (values.size() != _cells.size() * shape1)
+      throw std::runtime_error("Array of point values has wrong size.");
+
+    std::span<T> x = v.x()->mutable_array();
+    const std::size_t num_basis_values = _space_dim * _value_size;
+    std::vector<T> coefficients(_space_dim * bs);
+    for (std::size_t c = 0; c + 1 < _offsets.size(); ++c)
+    {
+      // Sum the contributions of all points in the cell
+      std::ranges::fill(coefficients, T(0));
+      for (std::int32_t a = _offsets[c]; a < _offsets[c + 1]; ++a)
+      {
+        impl::mdspan_t<const U, 2> phi(_basis.data() + a * num_basis_values,
+                                       _space_dim, _value_size);
+        std::span<const T> u = values.subspan(_points[a] * shape1, shape1);
+        for (std::size_t i = 0; i < _space_dim; ++i)
+          for (std::size_t j = 0; j < _value_size; ++j)
+            for (int k = 0; k < bs; ++k)
+              coefficients[bs * i + k] += u[j * bs + k] * phi(i, j);
+      }
+
+      std::span<const std::int32_t> dofs
+          = dofmap->cell_dofs(_cells[_points[_offsets[c]]]);
+      for (std::size_t i = 0; i < dofs.size(); ++i)
+        for (int k = 0; k < bs_dof; ++k)
+          x[bs_dof * dofs[i] + k] += coefficients[bs_dof * i + k];
+    }
+  }
+
+private:
+  // Compute the basis values at the points, mapped to the physical
+  // cells (shape=(num_points, _space_dim, _value_size))
+  std::vector<U> tabulate(std::span<const U> x) const
+  {
+    auto mesh = _V->mesh();
+    assert(mesh);
+    const std::size_t gdim = mesh->geometry().dim();
+    const std::size_t tdim = mesh->topology()->dim();
+    const CoordinateElement<U>& cmap = mesh->geometry().cmap();
+    auto x_dofmap = mesh->geometry().dofmap();
+    const std::size_t num_dofs_g = cmap.dim();
+    std::span<const U> x_g = mesh->geometry().x();
+
+    auto element = _V->element();
+    const std::size_t reference_value_size
+        = element->reference_value_size() / element->block_size();
+
+    std::span<const std::uint32_t> cell_info;
+    if (element->needs_dof_transformations())
+    {
+      mesh->topology_mutable()->create_entity_permutations();
+      cell_info = std::span(mesh->topology()->get_cell_permutation_info());
+    }
+
+    // Affine case: geometry basis derivatives at the reference origin
+    std::array<std::size_t, 4> phi0_shape = cmap.tabulate_shape(1, 1);
+    std::vector<U> phi0_b(std::reduce(phi0_shape.begin(), phi0_shape.end(),
+                                      1, std::multiplies{}));
+    impl::mdspan_t<const U, 4> phi0(phi0_b.data(), phi0_shape);
+    cmap.tabulate(1, std::vector<U>(tdim), {1, tdim}, phi0_b);
+    auto dphi0 = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        phi0, std::pair(1, tdim + 1), 0,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+
+    // Reference coordinates and geometry data at each point
+    const std::size_t num_points = _cells.size();
+    std::vector<U> Xb(num_points * tdim);
+    std::vector<U> J_b(num_points * gdim * tdim);
+    impl::mdspan_t<U, 3> J(J_b.data(), num_points, gdim, tdim);
+    std::vector<U> K_b(num_points * tdim * gdim);
+    impl::mdspan_t<U, 3> K(K_b.data(), num_points, tdim, gdim);
+    std::vector<U> detJ(num_points);
+    std::vector<U> det_scratch(2 * gdim * tdim);
+
+    // Points in a cell, and the coordinates of their cell nodes
+    std::vector<std::int32_t> points;
+    for (std::size_t p = 0; p < num_points; ++p)
+      if (_cells[p] >= 0)
+        points.push_back(p);
+    std::vector<U> coord_dofs_b(points.size() * num_dofs_g * gdim);
+    impl::mdspan_t<U, 3> coord_dofs(coord_dofs_b.data(), points.size(),
+                                    num_dofs_g, gdim);
+    std::vector<U> xp_b(points.size() * gdim);
+    for (std::size_t a = 0; a < points.size(); ++a)
+    {
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, _cells[points[a]],
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
+          coord_dofs(a, i, j) = x_g[3 * x_dofs[i] + j];
+      for (std::size_t j = 0; j < gdim; ++j)
+        xp_b[a * gdim + j] = x[3 * points[a] + j];
+    }
+
+    // Non-affine case: pull back all points together, and tabulate the
+    // geometry basis derivatives at all points at once
+    const std::array<std::size_t, 4> phi_shape
+        = cmap.tabulate_shape(1, points.size());
+    std::vector<U> phi_b;
+    if (!cmap.is_affine())
+    {
+      std::vector<U> Xp_b(points.size() * tdim);
+      std::vector<std::uint8_t> converged(points.size());
+      cmap.pull_back_nonaffine(
+          impl::mdspan_t<U, 2>(Xp_b.data(), points.size(), tdim),
+          impl::mdspan_t<const U, 2>(xp_b.data(), points.size(), gdim),
+          impl::mdspan_t<const U, 3>(coord_dofs_b.data(), points.size(),
+                                     num_dofs_g, gdim),
+          converged);
+      if (std::ranges::find(converged, 0) != converged.end())
+      {
+        throw std::runtime_error(
+            "Newton method failed to converge for non-affine geometry");
+      }
+      for (std::size_t a = 0; a < points.size(); ++a)
+        for (std::size_t j = 0; j < tdim; ++j)
+          Xb[points[a] * tdim + j] = Xp_b[a * tdim + j];
+
+      phi_b.resize(std::reduce(phi_shape.begin(), phi_shape.end(), 1,
+                               std::multiplies{}));
+      cmap.tabulate(1, Xp_b, {points.size(), tdim}, phi_b, false);
+    }
+    impl::mdspan_t<const U, 4> phi(phi_b.data(), phi_shape);
+
+    for (std::size_t a = 0; a < points.size(); ++a)
+    {
+      const std::int32_t p = points[a];
+      auto _coord_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          coord_dofs, a, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      if (cmap.is_affine())
+      {
+        CoordinateElement<U>::compute_jacobian(dphi0, _coord_dofs, _J);
+        CoordinateElement<U>::compute_jacobian_inverse(_J, _K);
+        std::array<U, 3> x0 = {0, 0, 0};
+        for (std::size_t i = 0; i < gdim; ++i)
+          x0[i] = _coord_dofs(0, i);
+        impl::mdspan_t<U, 2> Xp(Xb.data() + p * tdim, 1, tdim);
+        impl::mdspan_t<const U, 2> xp(xp_b.data() + a * gdim, 1, gdim);
+        CoordinateElement<U>::pull_back_affine(Xp, _K, x0, xp);
+      }
+      else
+      {
+        auto dphi = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+            phi, std::pair(1, tdim + 1), a,
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+        CoordinateElement<U>::compute_jacobian(dphi, _coord_dofs, _J);
+        CoordinateElement<U>::compute_jacobian_inverse(_J, _K);
+      }
+      detJ[p] = CoordinateElement<U>::compute_jacobian_determinant(
+          _J, det_scratch);
+    }
+
+    // Tabulate the basis at all points on the reference cell
+    std::vector<U> ref_values_b(num_points * _space_dim
+                                * reference_value_size);
+    impl::mdspan_t<const U, 4> ref_values(ref_values_b.data(), 1, num_points,
+                                          _space_dim, reference_value_size);
+    element->tabulate(ref_values_b, Xb, {num_points, tdim}, 0, false);
+
+    using xu_t = impl::mdspan_t<U, 2>;
+    using xU_t = impl::mdspan_t<const U, 2>;
+    using xJ_t = impl::mdspan_t<const U, 2>;
+    using xK_t = impl::mdspan_t<const U, 2>;
+    auto push_forward_fn
+        = element->basix_element().template map_fn<xu_t, xU_t, xJ_t, xK_t>();
+    auto apply_dof_transformation
+        = element->template dof_transformation_fn<U>(doftransform::standard);
+
+    // Map the basis to the physical cells
+    std::vector<U> basis(num_points * _space_dim * _value_size, 0);
+    const std::size_t num_ref_values = _space_dim * reference_value_size;
+    for (std::size_t p = 0; p < num_points; ++p)
+    {
+      if (_cells[p] < 0)
+        continue;
+
+      apply_dof_transformation(
+          std::span(ref_values_b.data() + p * num_ref_values, num_ref_values),
+          cell_info, _cells[p], reference_value_size);
+      xu_t basis_values(basis.data() + p * _space_dim * _value_size,
+                        _space_dim, _value_size);
+      auto _U = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          ref_values, 0, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      auto _J = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          J, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      auto _K = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          K, p, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      push_forward_fn(basis_values, _U, _J, detJ[p], _K);
+    }
+
+    return basis;
+  }
+
+  // Space of the Functions to evaluate
+  std::shared_ptr<const FunctionSpace<U>> _V;
+
+  // Cell that each point is located in (negative if the point is not
+  // evaluated)
+  std::vector<std::int32_t> _cells;
+
+  // Dimension and value size of the (unblocked) element
+  std::size_t _space_dim, _value_size;
+
+  // Located points, grouped by cell, and the offset of the points of
+  // each cell into _points
+  std::vector<std::int32_t> _points, _offsets;
+
+  // Basis values at the points in the order of _points
+  // (shape=(_points.size(), _space_dim, _value_size))
+  std::vector<U> _basis;
+};
+
+/// @brief Plan for repeated interpolation of Functions between
+/// non-matching meshes.
+///
+/// Interpolating with the geometry::PointOwnershipData from
+/// fem::create_interpolation_data pulls back each point to the
+/// reference cell, tabulates the basis and creates a neighbourhood
+/// communicator on every call. A plan does this once for a function
+/// space, so that interpolating a Function from the space, e.g. at
+/// each time step, only evaluates the Function using the cached basis
+/// values and exchanges the values with the point owners.
+///
+/// The mesh of the function space must not move while the plan is in
+/// use.
+///
+/// @tparam U mesh::Mesh geometry scalar type.
+template <std::floating_point U>
+class NonmatchingInterpolationPlan
+{
+public:
+  /// @brief Create a plan.
+  /// @param[in] V Space of the Functions to interpolate from.
+  /// @param[in] interpolation_data Data associating interpolation
+  /// points with cells of the mesh of `V`. This is computed by
+  /// fem::create_interpolation_data.
+  NonmatchingInterpolationPlan(
+      std::shared_ptr<const FunctionSpace<U>> V,
+      const geometry::PointOwnershipData<U>& interpolation_data)
+      : _V(V), _evaluation_plan(V, interpolation_data.dest_points,
+                                interpolation_data.dest_cells),
+        _num_points(interpolation_data.src_owner.size()),
+        _comm(MPI_COMM_NULL)
+  {
+    create_communication(interpolation_data.dest_owners,
+                         interpolation_data.src_owner);
+  }
+
+  /// Space of the Functions to interpolate from
+  std::shared_ptr<const FunctionSpace<U>> function_space() const
+  {
+    return _V;
+  }
+
+  /// Number of interpolation points (points owned by this process)
+  std::size_t num_points() const { return _num_points; }
+
+  /// Cells that the points evaluated on this process are located in
+  /// (-1 for points that are not located in the mesh)
+  std::span<const std::int32_t> cells() const
+  {
+    return _evaluation_plan.cells();
+  }
+
+  /// @brief Evaluate a Function at the points that are located in the
+  /// mesh on this process.
+  /// @param[in] v Function to evaluate. It must be in the space of the
+  /// plan.
+  /// @param[out] values Values at the points (shape=(cells().size(),
+  /// value_size)).
+  /// @param[in] num_threads Number of threads to use.
+  template <dolfinx::scalar T>
+  void eval(const Function<T, U>& v, std::span<T> values,
+            int num_threads = 1) const
+  {
+    _evaluation_plan.eval(v, values, num_threads);
+  }
+
+  /// @brief Send point values to the processes that own the points.
+  /// @param[in] send_values Values at the points that are located in
+  /// the mesh on this process, as computed by eval
+  /// (shape=(cells().size(), block_size)).
+  /// @param[out] recv_values Values at the points owned by this process
+  /// (shape=(num_points, block_size)). Values at points that are not
+  /// located in the mesh are zero.
+  /// @param[in] block_size Number of values per point.
+  template <dolfinx::scalar T>
+  void scatter(std::span<const T> send_values, std::span<T> recv_values,
+               int block_size) const
+  {
+    assert(send_values.size() == cells().size() * block_size);
+    assert(recv_values.size() == _num_points * block_size);
+    auto scale = [block_size](auto& v)
+    {
+      std::vector<int> w(v.size());
+      std::ranges::transform(v, w.begin(),
+                             [block_size](auto x) { return x * block_size; });
+      return w;
+    };
+    std::vector<int> send_sizes = scale(_send_sizes);
+    std::vector<int> send_offsets = scale(_send_offsets);
+    std::vector<int> recv_sizes = scale(_recv_sizes);
+    std::vector<int> recv_offsets = scale(_recv_offsets);
+
+    std::vector<T> values(recv_offsets.back());
+    values.reserve(1);
+    send_sizes.reserve(1);
+    recv_sizes.reserve(1);
+    MPI_Neighbor_alltoallv(send_values.data(), send_sizes.data(),
+                           send_offsets.data(), dolfinx::MPI::mpi_type<T>(),
+                           values.data(), recv_sizes.data(),
+                           recv_offsets.data(), dolfinx::MPI::mpi_type<T>(),
+                           _comm.comm());
+
+    std::ranges::fill(recv_values, T(0));
+    for (std::size_t i = 0; i < _comm_to_output.size(); ++i)
+    {
+      std::copy_n(std::next(values.begin(), i * block_size), block_size,
+                  std::next(recv_values.begin(),
+                            _comm_to_output[i] * block_size));
+    }
+  }
+
+private:
+  // Create the neighbourhood communicator and the per-point counts for
+  // sending values to the point owners. See impl::scatter_values.
+  void create_communication(std::span<const std::int32_t> src_ranks,
+                            std::span<const std::int32_t> dest_ranks)
+  {
+    MPI_Comm comm = _V->mesh()->comm();
+
+    std::vector<std::int32_t> out_ranks(src_ranks.begin(), src_ranks.end());
+    {
+      auto [unique_end, range_end] = std::ranges::unique(out_ranks);
+      out_ranks.erase(unique_end, range_end);
+    }
+    std::vector<std::int32_t> in_ranks;
+    std::ranges::copy_if(dest_ranks, std::back_inserter(in_ranks),
+                         [](auto rank) { return rank >= 0; });
+    {
+      std::ranges::sort(in_ranks);
+      auto [unique_end, range_end] = std::ranges::unique(in_ranks);
+      in_ranks.erase(unique_end, range_end);
+    }
+    out_ranks.reserve(1);
+    in_ranks.reserve(1);
+
+    MPI_Comm reverse_comm;
+    MPI_Dist_graph_create_adjacent(
+        comm, in_ranks.size(), in_ranks.data(), MPI_UNWEIGHTED,
+        out_ranks.size(), out_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+        false, &reverse_comm);
+    _comm = dolfinx::MPI::Comm(reverse_comm, false);
+
+    // Receive counts and position of each received value in the output
+    _recv_sizes.assign(in_ranks.size(), 0);
+    for (std::int32_t rank : dest_ranks)
+    {
+      if (rank >= 0)
+      {
+        auto it = std::ranges::lower_bound(in_ranks, rank);
+        ++_recv_sizes[std::distance(in_ranks.begin(), it)];
+      }
+    }
+    _recv_offsets.assign(in_ranks.size() + 1, 0);
+    std::partial_sum(_recv_sizes.begin(), _recv_sizes.end(),
+                     std::next(_recv_offsets.begin()));
+    _comm_to_output.resize(_recv_offsets.back());
+    {
+      std::vector<std::int32_t> pos(_recv_offsets.begin(),
+                                    std::prev(_recv_offsets.end()));
+      for (std::size_t i = 0; i < dest_ranks.size(); ++i)
+      {
+        if (dest_ranks[i] >= 0)
+        {
+          auto it = std::ranges::lower_bound(in_ranks, dest_ranks[i]);
+          _comm_to_output[pos[std::distance(in_ranks.begin(), it)]++] = i;
+        }
+      }
+    }
+
+    // Send counts. Values are sent in the order of src_ranks, which is
+    // sorted.
+    _send_sizes.assign(out_ranks.size(), 0);
+    for (std::int32_t rank : src_ranks)
+    {
+      auto it = std::ranges::lower_bound(out_ranks, rank);
+      ++_send_sizes[std::distance(out_ranks.begin(), it)];
+    }
+    _send_offsets.assign(out_ranks.size() + 1, 0);
+    std::partial_sum(_send_sizes.begin(), _send_sizes.end(),
+                     std::next(_send_offsets.begin()));
+  }
+
+  // Space of the Functions to interpolate from
+  std::shared_ptr<const FunctionSpace<U>> _V;
+
+  // Cached basis values at the points evaluated on this process
+  EvaluationPlan<U> _evaluation_plan;
+
+  // Number of interpolation points owned by this process
+  std::size_t _num_points;
+
+  // Neighbourhood communicator from the evaluating processes to the
+  // point owners
+  dolfinx::MPI::Comm _comm;
+
+  // Number of points sent to/received from each neighbour, and offsets
+  std::vector<int> _send_sizes, _send_offsets, _recv_sizes, _recv_offsets;
+
+  // Owned point index of each received value
+  std::vector<std::int32_t> _comm_to_output;
+};
+
+/// @brief Plan for repeated evaluation of Functions at points that may
+/// be located on any process.
+///
+/// Each process passes its own points, e.g. probe locations, without
+/// knowing the cells or processes that contain them. The owner of each
+/// point is computed once with geometry::determine_point_ownership,
+/// and the basis values at the points are cached on the owners (see
+/// NonmatchingInterpolationPlan). Evaluating a Function is then a
+/// contraction of the cached basis values on the owners and one
+/// neighbourhood exchange of the values, with a single message per
+/// pair of processes. The values are returned in the order of the input
+/// points.
+///
+/// The mesh of the function space must not move while the plan is in
+/// use.
+///
+/// @tparam U mesh::Mesh geometry scalar type.
+template <std::floating_point U>
+class DistributedEvaluationPlan
+{
+public:
+  /// @brief Create a plan.
+  /// @note Collective.
+  /// @param[in] V Space of the Functions to evaluate.
+  /// @param[in] x Points to evaluate at on this process
+  /// (shape=(num_points, 3)).
+  /// @param[in] padding Padding of the cell bounding boxes used to
+  /// locate the points (see geometry::determine_point_ownership).
+  DistributedEvaluationPlan(std::shared_ptr<const FunctionSpace<U>> V,
+                            std::span<const U> x, U padding)
+      : DistributedEvaluationPlan(
+            V, geometry::determine_point_ownership<U>(*V->mesh(), x, padding))
+  {
+  }
+
+  /// Space of the Functions to evaluate
+  std::shared_ptr<const FunctionSpace<U>> function_space() const
+  {
+    return _plan.function_space();
+  }
+
+  /// Number of points passed by this process
+  std::size_t num_points() const { return _owners.size(); }
+
+  /// Rank of the process that owns each point passed by this process,
+  /// or -1 if the point is not located in the mesh
+  std::span<const int> owners() const { return _owners; }
+
+  /// @brief Evaluate a Function at the points.
+  /// @note Collective.
+  /// @param[in] v Function to evaluate. It must be in the space of the
+  /// plan.
+  /// @param[out] values Values at the points passed by this process
+  /// (shape=(num_points, value_size)). Values at points that are not
+  /// located in the mesh are zero.
+  /// @param[in] num_threads Number of threads to use for evaluating
+  /// the points owned by this process.
+  template <dolfinx::scalar T>
+  void eval(const Function<T, U>& v, std::span<T> values,
+            int num_threads = 1) const
+  {
+    const int value_size = function_space()->value_size();
+    if (values.size() != _owners.size() * value_size)
+      throw std::runtime_error("Array for Function values has wrong size.");
+    std::vector<T> owned_values(_plan.cells().size() * value_size);
+    _plan.eval(v, std::span(owned_values), num_threads);
+    _plan.scatter(std::span<const T>(owned_values), values, value_size);
+  }
+
+private:
+  DistributedEvaluationPlan(std::shared_ptr<const FunctionSpace<U>> V,
+                            geometry::PointOwnershipData<U>&& ownership)
+      : _plan(V, ownership), _owners(std::move(ownership.src_owner))
+  {
+  }
+
+  // Evaluation on the owners and communication of the values
+  NonmatchingInterpolationPlan<U> _plan;
+
+  // Owner of each point passed by this process
+  std::vector<int> _owners;
+};
+
 /// @brief Interpolate a finite element Function defined on a mesh to a
 /// finite element Function defined on different (non-matching) mesh.
 /// @tparam T Function scalar type.
@@ -1145,6 +2389,51 @@ void interpolate(Function<T, U>& u, const Function<T, U>& v,
                       cells);
 }
 
+/// @brief Interpolate a finite element Function defined on a mesh to a
+/// finite element Function defined on different (non-matching) mesh,
+/// using a plan.
+///
+/// This is faster than interpolating with the interpolation data that
+/// the plan was created from when interpolating repeatedly, as the point
+/// pull-backs, basis tabulation and communicator creation are done once
+/// when the plan is created.
+/// @tparam T Function scalar type.
+/// @tparam U mesh::Mesh geometry scalar type.
+/// @param u Function to interpolate into.
+/// @param v Function to interpolate from. It must be in the function
+/// space of `plan`.
+/// @param cells Cells indices relative to the mesh associated with `u`
+/// that will be interpolated into. Must be the cells used to create the
+/// interpolation data of the plan.
+/// @param plan Interpolation plan.
+template <dolfinx::scalar T, std::floating_point U>
+void interpolate(Function<T, U>& u, const Function<T, U>& v,
+                 std::span<const std::int32_t> cells,
+                 const NonmatchingInterpolationPlan<U>& plan)
+{
+  const std::size_t value_size = u.function_space()->value_size();
+  if (std::size_t(v.function_space()->value_size()) != value_size)
+    throw std::runtime_error("Functions must have the same value size.");
+
+  // Evaluate the interpolating function where possible and send the
+  // values back to the owning processes
+  std::vector<T> send_values(plan.cells().size() * value_size);
+  plan.eval(v, std::span(send_values));
+  const std::size_t num_points = plan.num_points();
+  std::vector<T> values(num_points * value_size);
+  plan.scatter(std::span<const T>(send_values), std::span(values),
+               value_size);
+
+  // Transpose received data
+  std::vector<T> valuesT(values.size());
+  for (std::size_t i = 0; i < num_points; ++i)
+    for (std::size_t j = 0; j < value_size; ++j)
+      valuesT[j * num_points + i] = values[i * value_size + j];
+
+  // Call local interpolation operator
+  fem::interpolate<T>(u, valuesT, {value_size, num_points}, cells);
+}
+
 /// @brief Interpolate from one finite element Function to another
 /// Function on the same (sub)mesh.
 ///
@@ -8,9 +8,13 @@
 
 #ifdef HAS_PETSC
 
+#include "DirichletBC.h"
 #include "Form.h"
 #include "assembler.h"
 #include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <concepts>
 #include <dolfinx/la/petsc.h>
 #include <map>
@@ -18,6 +22,7 @@
 #include <petscmat.h>
 #include <petscvec.h>
 #include <span>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -236,6 +241,170 @@ Mat create_matrix_nest(
   return A;
 }
 
+/// @brief Assembly of a bilinear form into a PETSc matrix using the
+/// PETSc COO (coordinate) interface.
+///
+/// The (row, column) indices of the entries that the assembler adds
+/// are recorded once, in the order they are added (cell by cell), and
+/// passed to `MatSetPreallocationCOOLocal` for each matrix that is
+/// assembled into. An assembly then packs all element matrices into
+/// one array of values, in the same order, and sets them with a single
+/// `MatSetValuesCOO`. This avoids the searches of `MatSetValuesLocal`
+/// for each cell, and allows device matrix types such as
+/// `aijcusparse` and `aijkokkos` to receive the values in one
+/// transfer.
+///
+/// @note The entry indices are passed to a matrix again when
+/// assembling into a different Mat. Call MatrixCOOAssembler::reset if
+/// a matrix is destroyed and another matrix may have been created at
+/// the same address.
+template <std::floating_point T>
+class MatrixCOOAssembler
+{
+public:
+  /// @brief Record the matrix entries of a bilinear form.
+  ///
+  /// The form is assembled once, with the values discarded, to record
+  /// the entries.
+  ///
+  /// @param[in] a The bilinear form.
+  /// @param[in] bcs Boundary conditions to apply. For boundary
+  /// condition dofs the row and column are zeroed.
+  /// @param[in] diagonal The value to set on the diagonal of rows
+  /// with a boundary condition, if the form test and trial spaces are
+  /// the same.
+  MatrixCOOAssembler(
+      std::shared_ptr<const Form<PetscScalar, T>> a,
+      const std::vector<std::shared_ptr<const DirichletBC<PetscScalar, T>>>&
+          bcs,
+      PetscScalar diagonal = 1)
+      : _a(a), _bcs(bcs), _diagonal(diagonal)
+  {
+    if (a->rank() != 2)
+      throw std::runtime_error("Form must be bilinear.");
+
+    // Record the unrolled (row, column) index of each entry added by
+    // the assembler
+    const std::array<std::shared_ptr<const FunctionSpace<T>>, 2> V
+        = {a->function_spaces().at(0), a->function_spaces().at(1)};
+    const int bs0 = V[0]->dofmap()->bs();
+    const int bs1 = V[1]->dofmap()->bs();
+    auto record = [&](std::span<const std::int32_t> rows,
+                      std::span<const std::int32_t> cols,
+                      std::span<const PetscScalar>) -> int
+    {
+      for (std::int32_t r : rows)
+      {
+        for (int k0 = 0; k0 < bs0; ++k0)
+        {
+          for (std::int32_t c : cols)
+          {
+            for (int k1 = 0; k1 < bs1; ++k1)
+            {
+              _rows.push_back(bs0 * r + k0);
+              _cols.push_back(bs1 * c + k1);
+            }
+          }
+        }
+      }
+      return 0;
+    };
+    fem::assemble_matrix(record, *a, bcs);
+    _num_entries = _rows.size();
+
+    // Owned constrained rows, for the diagonal entries
+    if (V[0] == V[1])
+    {
+      for (auto& bc : bcs)
+      {
+        if (V[0]->contains(*bc->function_space()))
+        {
+          const auto [dofs, range] = bc->dof_indices();
+          _rows.insert(_rows.end(), dofs.begin(), dofs.begin() + range);
+          _cols.insert(_cols.end(), dofs.begin(), dofs.begin() + range);
+        }
+      }
+    }
+
+    _values.resize(_rows.size());
+  }
+
+  /// @brief Assemble the form into a matrix.
+  ///
+  /// The matrix values are replaced by the assembled values, including
+  /// the ghost contributions, and the matrix is ready for use on
+  /// return. Coefficients and constants are packed by the form.
+  ///
+  /// @param[in,out] A The matrix to assemble into. It must have the
+  /// layout and local-to-global maps of the form, e.g. from
+  /// create_matrix. Its nonzero structure is set by the COO entries.
+  void assemble(Mat A)
+  {
+    PetscErrorCode ierr;
+    if (A != _mat)
+    {
+      // PETSc overwrites the indices
+      std::vector<PetscInt> rows = _rows, cols = _cols;
+      ierr = MatSetPreallocationCOOLocal(A, rows.size(), rows.data(),
+                                         cols.data());
+      if (ierr != 0)
+        la::petsc::error(ierr, __FILE__, "MatSetPreallocationCOOLocal");
+      _mat = A;
+    }
+
+    std::size_t pos = 0;
+    auto pack = [&](std::span<const std::int32_t>,
+                    std::span<const std::int32_t>,
+                    std::span<const PetscScalar> vals) -> int
+    {
+      assert(pos + vals.size() <= _num_entries);
+      std::ranges::copy(vals, std::next(_values.begin(), pos));
+      pos += vals.size();
+      return 0;
+    };
+    fem::assemble_matrix(pack, *_a, _bcs);
+    assert(pos == _num_entries);
+    std::fill(std::next(_values.begin(), _num_entries), _values.end(),
+              _diagonal);
+
+    ierr = MatSetValuesCOO(A, _values.data(), INSERT_VALUES);
+    if (ierr != 0)
+      la::petsc::error(ierr, __FILE__, "MatSetValuesCOO");
+  }
+
+  /// @brief Forget the matrix that the entries were last passed to.
+  /// The next assembly passes them to the matrix again.
+  void reset() { _mat = nullptr; }
+
+  /// The form
+  std::shared_ptr<const Form<PetscScalar, T>> form() const { return _a; }
+
+  /// Number of COO entries, including the diagonal entries of
+  /// constrained rows
+  std::size_t num_entries() const { return _rows.size(); }
+
+private:
+  // Form and boundary conditions
+  std::shared_ptr<const Form<PetscScalar, T>> _a;
+  std::vector<std::shared_ptr<const DirichletBC<PetscScalar, T>>> _bcs;
+
+  // Value on the diagonal of constrained rows
+  PetscScalar _diagonal;
+
+  // Local (row, column) indices of the entries, with the entries from
+  // the assembler followed by the diagonal entries
+  std::vector<PetscInt> _rows, _cols;
+
+  // Number of entries added by the assembler
+  std::size_t _num_entries = 0;
+
+  // Values of the entries
+  std::vector<PetscScalar> _values;
+
+  // Matrix the entries were last passed to
+  Mat _mat = nullptr;
+};
+
 /// Initialise monolithic vector. Vector is not zeroed.
 ///
 /// The caller is responsible for destroying the Mat object
@@ -7,7 +7,11 @@
 #include "sparsitybuild.h"
 #include "DofMap.h"
 #include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <numeric>
+#include <vector>
 
 using namespace dolfinx;
 using namespace dolfinx::fem;
@@ -58,3 +62,89 @@ void sparsitybuild::interior_facets(
   }
 }
 //-----------------------------------------------------------------------------
+void sparsitybuild::cell_pairs(
+    la::SparsityPattern& pattern, std::span<const std::int32_t> pairs,
+    std::array<std::reference_wrapper<const DofMap>, 2> dofmaps,
+    int num_threads)
+{
+  assert(pairs.size() % 2 == 0);
+  const DofMap& dofmap0 = dofmaps[0];
+  const DofMap& dofmap1 = dofmaps[1];
+
+  // Group the coupled cells by row cell (cell -> coupled cells)
+  const std::size_t num_cells0 = dofmap0.map().extent(0);
+  std::vector<std::int32_t> offsets(num_cells0 + 1, 0);
+  auto valid = [&pairs](std::size_t i)
+  { return pairs[i] >= 0 and pairs[i + 1] >= 0; };
+  for (std::size_t i = 0; i < pairs.size(); i += 2)
+  {
+    if (valid(i))
+      ++offsets[pairs[i] + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::int32_t> coupled(offsets.back());
+  {
+    std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+    for (std::size_t i = 0; i < pairs.size(); i += 2)
+    {
+      if (valid(i))
+        coupled[pos[pairs[i]]++] = pairs[i + 1];
+    }
+  }
+
+  // Remove duplicate couplings, e.g. a cell coupled to itself by a cell
+  // integral and by the interior facet integrals of its facets
+  {
+    std::int32_t num_coupled = 0;
+    for (std::size_t c = 0; c < num_cells0; ++c)
+    {
+      auto first = std::next(coupled.begin(), offsets[c]);
+      auto last = std::next(coupled.begin(), offsets[c + 1]);
+      std::sort(first, last);
+      last = std::unique(first, last);
+      offsets[c] = num_coupled;
+      num_coupled = std::copy(first, last,
+                              std::next(coupled.begin(), num_coupled))
+                    - coupled.begin();
+    }
+    offsets[num_cells0] = num_coupled;
+    coupled.resize(num_coupled);
+  }
+
+  // Insert the rows of each thread's range. Rows inserted by different
+  // threads are distinct.
+  auto map0 = dofmap0.index_map;
+  assert(map0);
+  const std::int64_t num_rows = map0->size_local() + map0->num_ghosts();
+  const int nt = std::max(num_threads, 1);
+  common::run_tasks(
+      nt,
+      [&](int t)
+      {
+        const std::int64_t r0 = (t * num_rows) / nt;
+        const std::int64_t r1 = ((t + 1) * num_rows) / nt;
+        std::vector<std::int32_t> rows, cols;
+        for (std::size_t c = 0; c < num_cells0; ++c)
+        {
+          if (offsets[c] == offsets[c + 1])
+            continue;
+
+          rows.clear();
+          std::ranges::copy_if(dofmap0.cell_dofs(c), std::back_inserter(rows),
+                               [r0, r1](auto r) { return r >= r0 and r < r1; });
+          if (rows.empty())
+            continue;
+
+          cols.clear();
+          for (std::int32_t i = offsets[c]; i < offsets[c + 1]; ++i)
+          {
+            auto dofs = dofmap1.cell_dofs(coupled[i]);
+            cols.insert(cols.end(), dofs.begin(), dofs.end());
+          }
+          std::ranges::sort(cols);
+          cols.erase(std::ranges::unique(cols).begin(), cols.end());
+          pattern.insert(rows, cols);
+        }
+      });
+}
+//-----------------------------------------------------------------------------
@@ -58,5 +58,34 @@ void interior_facets(
     std::array<std::span<const std::int32_t>, 2> cells,
     std::array<std::reference_wrapper<const DofMap>, 2> dofmaps);
 
+/// @brief Insert the entries of a list of couplings of cells into a
+/// sparsity pattern, each entry once per row cell.
+///
+/// For each pair `(cell0, cell1)`, the block `dofmap[0][cell0] x
+/// dofmap[1][cell1]` is inserted. The pairs are grouped by `cell0`, and
+/// the dofs of the coupled `cell1` cells are merged and made unique
+/// before the rows of `cell0` are inserted. This avoids the duplicate
+/// entries that are inserted by calling cells and interior_facets for
+/// the same cells, e.g. for the cell and interior facet integrals of a
+/// discontinuous Galerkin form, where every facet re-inserts the
+/// entries of its two cells.
+///
+/// The rows are split into `num_threads` ranges that are inserted
+/// concurrently.
+///
+/// @param[in,out] pattern Sparsity pattern to insert into.
+/// @param[in] pairs Couplings `(cell0, cell1)` (flattened), where
+/// `cell0` indexes into `dofmap[0]` and `cell1` into `dofmap[1]`.
+/// Duplicate pairs are permitted, and pairs with a negative cell index
+/// (no cell in one of the meshes) are ignored.
+/// @param[in] dofmaps Dofmaps to use in building the sparsity pattern.
+/// @param[in] num_threads Number of threads to use.
+///
+/// @note The sparsity pattern is not finalised.
+void cell_pairs(la::SparsityPattern& pattern,
+                std::span<const std::int32_t> pairs,
+                std::array<std::reference_wrapper<const DofMap>, 2> dofmaps,
+                int num_threads = 1);
+
 } // namespace sparsitybuild
 } // namespace dolfinx::fem
@@ -21,7 +21,9 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/topologycomputation.h>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <ufcx.h>
 
@@ -32,18 +34,44 @@ fem::DofMap fem::create_dofmap(
     MPI_Comm comm, const ElementDofLayout& layout, mesh::Topology& topology,
     std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv,
     std::function<std::vector<int>(const graph::AdjacencyList<std::int32_t>&)>
-        reorder_fn)
+        reorder_fn,
+    int num_threads)
 {
-  // Create required mesh entities
   const int D = topology.dim();
+
+  // If each vertex has one dof, in the order of the cell vertices, and
+  // there are no other dofs, the cell-to-vertex connectivity is the
+  // dofmap. Share it, and the vertex index map, with the topology
+  // rather than building a copy.
+  if (!permute_inv and !reorder_fn and topology.entity_types(D).size() == 1
+      and layout.num_entity_dofs(0) == 1)
+  {
+    auto c_to_v = topology.connectivity(D, 0);
+    assert(c_to_v);
+    bool vertex_dofs = c_to_v->num_nodes() == 0
+                       or c_to_v->num_links(0) == layout.num_dofs();
+    for (int d = 1; d <= D; ++d)
+      vertex_dofs = vertex_dofs and layout.num_entity_dofs(d) == 0;
+    for (int v = 0; vertex_dofs and v < layout.num_dofs(); ++v)
+      vertex_dofs = layout.entity_dofs(0, v) == std::vector{v};
+    if (vertex_dofs)
+    {
+      const int bs = layout.block_size();
+      return DofMap(layout, topology.index_map(0), bs, c_to_v, bs);
+    }
+  }
+
+  // Create required mesh entities
+  std::vector<int> dims;
   for (int d = 0; d < D; ++d)
   {
     if (layout.num_entity_dofs(d) > 0)
-      topology.create_entities(d);
+      dims.push_back(d);
   }
+  topology.create_entities(dims, mesh::EntityComputation::sort, num_threads);
 
   auto [_index_map, bs, dofmaps]
-      = build_dofmap_data(comm, topology, {layout}, reorder_fn);
+      = build_dofmap_data(comm, topology, {layout}, reorder_fn, num_threads);
   auto index_map = std::make_shared<common::IndexMap>(std::move(_index_map));
 
   // If the element's DOF transformations are permutations, permute the
@@ -70,20 +98,23 @@ std::vector<fem::DofMap> fem::create_dofmaps(
     mesh::Topology& topology,
     std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv,
     std::function<std::vector<int>(const graph::AdjacencyList<std::int32_t>&)>
-        reorder_fn)
+        reorder_fn,
+    int num_threads)
 {
   std::int32_t D = topology.dim();
   assert(layouts.size() == topology.entity_types(D).size());
 
   // Create required mesh entities
+  std::vector<int> dims;
   for (std::int32_t d = 0; d < D; ++d)
   {
     if (layouts.front().num_entity_dofs(d) > 0)
-      topology.create_entities(d);
+      dims.push_back(d);
   }
+  topology.create_entities(dims, mesh::EntityComputation::sort, num_threads);
 
   auto [_index_map, bs, dofmaps]
-      = build_dofmap_data(comm, topology, layouts, reorder_fn);
+      = build_dofmap_data(comm, topology, layouts, reorder_fn, num_threads);
   auto index_map = std::make_shared<common::IndexMap>(std::move(_index_map));
 
   // If the element's DOF transformations are permutations, permute the
@@ -130,7 +161,7 @@ std::vector<std::string> fem::get_constant_names(const ufcx_form& ufcx_form)
 //-----------------------------------------------------------------------------
 std::vector<std::int32_t> fem::compute_integration_domains(
     fem::IntegralType integral_type, const mesh::Topology& topology,
-    std::span<const std::int32_t> entities, int dim)
+    std::span<const std::int32_t> entities, int dim, bool sort)
 {
   const int tdim = topology.dim();
   if ((integral_type == IntegralType::cell ? tdim : tdim - 1) != dim)
@@ -170,17 +201,27 @@ std::vector<std::int32_t> fem::compute_integration_domains(
     {
     case IntegralType::exterior_facet:
     {
-      // Create list of tagged boundary facets
-      const std::vector bfacets = mesh::exterior_facet_indices(topology);
-      std::vector<std::int32_t> facets;
-      std::ranges::set_intersection(entities, bfacets,
-                                    std::back_inserter(facets));
-      for (auto f : facets)
+      // Get the tagged boundary facets as (cell, local facet) pairs,
+      // using the exterior facet pairs cached by the topology
+      std::shared_ptr<const std::vector<std::int32_t>> bfacets_ptr
+          = topology.exterior_facets();
+      std::shared_ptr<const std::vector<std::int32_t>> bpairs_ptr
+          = topology.exterior_facet_pairs();
+      std::span<const std::int32_t> bfacets(*bfacets_ptr);
+      std::span<const std::int32_t> bpairs(*bpairs_ptr);
+      auto it = bfacets.begin();
+      for (auto f : entities)
       {
-        // Get the facet as a pair of (cell, local facet)
-        auto facet
-            = impl::get_cell_facet_pairs<1>(f, f_to_c->links(f), *c_to_f);
-        entity_data.insert(entity_data.end(), facet.begin(), facet.end());
+        it = std::lower_bound(it, bfacets.end(), f);
+        if (it == bfacets.end())
+          break;
+        if (*it == f)
+        {
+          std::size_t pos = std::distance(bfacets.begin(), it);
+          entity_data.insert(entity_data.end(),
+                             std::next(bpairs.begin(), 2 * pos),
+                             std::next(bpairs.begin(), 2 * pos + 2));
+        }
       }
     }
     break;
@@ -205,6 +246,52 @@ std::vector<std::int32_t> fem::compute_integration_domains(
           "Cannot compute integration domains. Integral type not supported.");
     }
   }
+
+  if (sort)
+    fem::sort_integration_entities(integral_type, entity_data);
+
   return entity_data;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+fem::sort_integration_entities(fem::IntegralType integral_type,
+                               std::span<std::int32_t> entities)
+{
+  std::size_t n = 0;
+  switch (integral_type)
+  {
+  case IntegralType::cell:
+    n = 1;
+    break;
+  case IntegralType::exterior_facet:
+    n = 2;
+    break;
+  case IntegralType::interior_facet:
+    n = 4;
+    break;
+  default:
+    throw std::runtime_error(
+        "Cannot sort integration entities. Integral type not supported.");
+  }
+
+  if (entities.size() % n != 0)
+    throw std::runtime_error("Invalid size of integration entities.");
+
+  // Order the entities by (first) cell index, keeping the input order
+  // of entities of the same cell
+  std::vector<std::int32_t> perm(entities.size() / n);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::ranges::stable_sort(perm, std::less<>{},
+                           [&entities, n](auto e) { return entities[n * e]; });
+
+  std::vector<std::int32_t> sorted(entities.size());
+  for (std::size_t e = 0; e < perm.size(); ++e)
+  {
+    std::copy_n(std::next(entities.begin(), n * perm[e]), n,
+                std::next(sorted.begin(), n * e));
+  }
+  std::ranges::copy(sorted, entities.begin());
+
+  return perm;
+}
+//-----------------------------------------------------------------------------
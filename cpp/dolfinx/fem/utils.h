@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <array>
 #include <concepts>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/types.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/Topology.h>
@@ -30,6 +31,8 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <ufcx.h>
 #include <utility>
 #include <vector>
@@ -101,6 +104,9 @@ get_cell_facet_pairs(std::int32_t f, std::span<const std::int32_t> cells,
 /// @param[in] topology Mesh topology
 /// @param[in] entities List of mesh entities
 /// @param[in] dim Topological dimension of entities
+/// @param[in] sort If `true`, the integration entities are ordered by
+/// cell index (see sort_integration_entities). Otherwise they are in
+/// the order of `entities`.
 /// @return List of integration entities
 /// @pre For facet integrals, the topology facet-to-cell and
 /// cell-to-facet connectivity must be computed before calling this
@@ -108,7 +114,30 @@ get_cell_facet_pairs(std::int32_t f, std::span<const std::int32_t> cells,
 std::vector<std::int32_t>
 compute_integration_domains(IntegralType integral_type,
                             const mesh::Topology& topology,
-                            std::span<const std::int32_t> entities, int dim);
+                            std::span<const std::int32_t> entities, int dim,
+                            bool sort = false);
+
+/// @brief Order a list of integration entities by cell index.
+///
+/// Facet integration entities computed from mesh tags are in facet
+/// order, which is unrelated to the order of the cells. Assembly over
+/// entities ordered by cell accesses the geometry, the dofmaps and the
+/// packed coefficients of the cells in storage order, which improves
+/// data locality. Interior facets are ordered by the first cell of the
+/// facet. Entities of the same cell keep their input order.
+///
+/// Coefficients packed for a form (pack_coefficients) follow the order
+/// of the integration entities of the form. Assembled tensors do not
+/// depend on the order.
+///
+/// @param[in] integral_type Integral type
+/// @param[in,out] entities Integration entities, as returned by
+/// compute_integration_domains. They are sorted in-place.
+/// @return Permutation `p` from the sorted to the input order, i.e.
+/// sorted entity `i` is input entity `p[i]`.
+std::vector<std::int32_t>
+sort_integration_entities(IntegralType integral_type,
+                          std::span<std::int32_t> entities);
 
 /// @brief Extract test (0) and trial (1) function spaces pairs for each
 /// bilinear form for a rectangular array of forms.
@@ -139,12 +168,21 @@ extract_function_spaces(const std::vector<std::vector<const Form<T, U>*>>& a)
 }
 
 /// @brief Create a sparsity pattern for a given form.
+///
+/// The cells coupled by all integrals of the form are collected first
+/// and inserted by sparsitybuild::cell_pairs, so that entries that are
+/// shared by several integrals, e.g. by the cell and interior facet
+/// integrals of a discontinuous Galerkin form, are inserted once.
+///
 /// @note The pattern is not finalised, i.e. the caller is responsible
 /// for calling SparsityPattern::assemble.
 /// @param[in] a A bilinear form
+/// @param[in] num_threads Number of threads to use for inserting the
+/// entries
 /// @return The corresponding sparsity pattern
 template <dolfinx::scalar T, std::floating_point U>
-la::SparsityPattern create_sparsity_pattern(const Form<T, U>& a)
+la::SparsityPattern create_sparsity_pattern(const Form<T, U>& a,
+                                            int num_threads = 1)
 {
   if (a.rank() != 2)
   {
@@ -182,55 +220,46 @@ la::SparsityPattern create_sparsity_pattern(const Form<T, U>& a)
   const std::array bs
       = {dofmaps[0].get().index_map_bs(), dofmaps[1].get().index_map_bs()};
 
-  auto extract_cells = [](std::span<const std::int32_t> facets)
-  {
-    assert(facets.size() % 2 == 0);
-    std::vector<std::int32_t> cells;
-    cells.reserve(facets.size() / 2);
-    for (std::size_t i = 0; i < facets.size(); i += 2)
-      cells.push_back(facets[i]);
-    return cells;
-  };
-
-  // Create and build sparsity pattern
-  la::SparsityPattern pattern(mesh->comm(), index_maps, bs);
+  // Couplings (cell0, cell1) of the cells of the two spaces by the
+  // integrals. An interior facet couples each of its cells to both
+  // cells.
+  std::vector<std::int32_t> pairs;
   for (auto type : types)
   {
-    std::vector<int> ids = a.integral_ids(type);
-    switch (type)
+    for (int id : a.integral_ids(type))
     {
-    case IntegralType::cell:
-      for (int id : ids)
-      {
-        sparsitybuild::cells(
-            pattern, {a.domain(type, id, *mesh0), a.domain(type, id, *mesh1)},
-            {{dofmaps[0], dofmaps[1]}});
-      }
-      break;
-    case IntegralType::interior_facet:
-      for (int id : ids)
+      std::span<const std::int32_t> e0 = a.domain(type, id, *mesh0);
+      std::span<const std::int32_t> e1 = a.domain(type, id, *mesh1);
+      assert(e0.size() == e1.size());
+      switch (type)
       {
-        sparsitybuild::interior_facets(
-            pattern,
-            {extract_cells(a.domain(type, id, *mesh0)),
-             extract_cells(a.domain(type, id, *mesh1))},
-            {{dofmaps[0], dofmaps[1]}});
-      }
-      break;
-    case IntegralType::exterior_facet:
-      for (int id : ids)
-      {
-        sparsitybuild::cells(pattern,
-                             {extract_cells(a.domain(type, id, *mesh0)),
-                              extract_cells(a.domain(type, id, *mesh1))},
-                             {{dofmaps[0], dofmaps[1]}});
+      case IntegralType::cell:
+        for (std::size_t i = 0; i < e0.size(); ++i)
+          pairs.insert(pairs.end(), {e0[i], e1[i]});
+        break;
+      case IntegralType::exterior_facet:
+        for (std::size_t i = 0; i < e0.size(); i += 2)
+          pairs.insert(pairs.end(), {e0[i], e1[i]});
+        break;
+      case IntegralType::interior_facet:
+        for (std::size_t i = 0; i < e0.size(); i += 4)
+        {
+          for (int k0 : {0, 2})
+            for (int k1 : {0, 2})
+              pairs.insert(pairs.end(), {e0[i + k0], e1[i + k1]});
+        }
+        break;
+      default:
+        throw std::runtime_error("Unsupported integral type");
       }
-      break;
-    default:
-      throw std::runtime_error("Unsupported integral type");
     }
   }
 
+  // Create and build sparsity pattern
+  la::SparsityPattern pattern(mesh->comm(), index_maps, bs);
+  sparsitybuild::cell_pairs(pattern, pairs, {{dofmaps[0], dofmaps[1]}},
+                            num_threads);
+
   t0.stop();
 
   return pattern;
@@ -277,13 +306,23 @@ ElementDofLayout create_element_dof_layout(const fem::FiniteElement<T>& element,
 /// @param[in] topology Mesh topology
 /// @param[in] permute_inv Function to un-permute dofs. `nullptr`
 /// when transformation is not required.
-/// @param[in] reorder_fn Graph reordering function called on the dofmap
+/// @param[in] reorder_fn Graph reordering function called on the
+/// dofmap. If empty, the dofs are not reordered (see
+/// build_dofmap_data).
+/// @param[in] num_threads Number of threads to use
 /// @return A new dof map
+///
+/// @note If the layout has one dof on each vertex, in the order of the
+/// cell vertices, and no other dofs (e.g. a degree-1 Lagrange element),
+/// and there is no reordering or permutation of the dofs, the dofmap
+/// shares the cell-to-vertex connectivity and the vertex index map of
+/// the topology instead of building a copy.
 DofMap create_dofmap(
     MPI_Comm comm, const ElementDofLayout& layout, mesh::Topology& topology,
     std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv,
     std::function<std::vector<int>(const graph::AdjacencyList<std::int32_t>&)>
-        reorder_fn);
+        reorder_fn,
+    int num_threads = 1);
 
 /// @brief Create a set of dofmaps on a given topology
 /// @param[in] comm MPI communicator
@@ -291,7 +330,10 @@ DofMap create_dofmap(
 /// @param[in] topology Mesh topology
 /// @param[in] permute_inv Function to un-permute dofs. `nullptr`
 /// when transformation is not required.
-/// @param[in] reorder_fn Graph reordering function called on the dofmaps
+/// @param[in] reorder_fn Graph reordering function called on the
+/// dofmaps. If empty, the dofs are not reordered (see
+/// build_dofmap_data).
+/// @param[in] num_threads Number of threads to use
 /// @return The list of new dof maps
 /// @note The number of layouts must match the number of cell types in the
 /// topology
@@ -300,7 +342,8 @@ std::vector<DofMap> create_dofmaps(
     mesh::Topology& topology,
     std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv,
     std::function<std::vector<int>(const graph::AdjacencyList<std::int32_t>&)>
-        reorder_fn);
+        reorder_fn,
+    int num_threads = 1);
 
 /// Get the name of each coefficient in a UFC form
 /// @param[in] ufcx_form The UFC form
@@ -530,23 +573,10 @@ Form<T, U> create_form_factory(
       assert(k);
 
       // Build list of entities to assembler over
-      const std::vector bfacets = mesh::exterior_facet_indices(*topology);
-      auto f_to_c = topology->connectivity(tdim - 1, tdim);
-      assert(f_to_c);
-      auto c_to_f = topology->connectivity(tdim, tdim - 1);
-      assert(c_to_f);
       if (id == -1)
       {
         // Default kernel, operates on all (owned) exterior facets
-        default_facets_ext.reserve(2 * bfacets.size());
-        for (std::int32_t f : bfacets)
-        {
-          // There will only be one pair for an exterior facet integral
-          auto pair
-              = impl::get_cell_facet_pairs<1>(f, f_to_c->links(f), *c_to_f);
-          default_facets_ext.insert(default_facets_ext.end(), pair.begin(),
-                                    pair.end());
-        }
+        default_facets_ext = *topology->exterior_facet_pairs();
         itg.first->second.emplace_back(id, k, default_facets_ext,
                                        active_coeffs);
       }
@@ -759,6 +789,76 @@ Form<T, U> create_form(
   return L;
 }
 
+/// @brief Create the dofmap of an element on a mesh topology, or get
+/// the dofmap of an identical element on the same topology.
+///
+/// The dofmaps created by this function are held by the topology (see
+/// mesh::Topology::dofmap_cache), keyed on the element (see
+/// FiniteElement::operator==) and its block size, so that function
+/// spaces with identical elements on the same topology share a DofMap
+/// and its IndexMap. The dofmaps are released when the topology is
+/// destroyed or clear_dofmap_cache is called. Dofmaps of mixed
+/// elements are not cached.
+///
+/// @note Collective. The dofmap is found in the cache on all processes
+/// or on none, provided that all processes create the same dofmaps
+/// and clear the cache at the same points.
+/// @param[in] comm MPI communicator
+/// @param[in] topology Mesh topology
+/// @param[in] element Finite element
+/// @param[in] layout Dof layout of the element
+/// @param[in] permute_inv Function to un-permute dofs. `nullptr` when
+/// transformation is not required.
+/// @return The dofmap
+template <std::floating_point T>
+std::shared_ptr<const DofMap> create_shared_dofmap(
+    MPI_Comm comm, mesh::Topology& topology,
+    std::shared_ptr<const FiniteElement<T>> element,
+    const ElementDofLayout& layout,
+    std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv)
+{
+  assert(element);
+  if (element->is_mixed())
+  {
+    return std::make_shared<const DofMap>(
+        create_dofmap(comm, layout, topology, permute_inv, nullptr));
+  }
+
+  std::vector<mesh::Topology::DofMapCacheEntry>& cache
+      = topology.dofmap_cache();
+  const std::type_index type(typeid(FiniteElement<T>));
+  auto it = std::ranges::find_if(
+      cache,
+      [&](auto& entry)
+      {
+        if (entry.type != type)
+          return false;
+        auto e = std::static_pointer_cast<const FiniteElement<T>>(
+            entry.element);
+        return e->block_size() == element->block_size() and *e == *element;
+      });
+  if (it != cache.end())
+    return it->dofmap;
+
+  auto dofmap = std::make_shared<const DofMap>(
+      create_dofmap(comm, layout, topology, permute_inv, nullptr));
+  cache.push_back({type, element, dofmap});
+  return dofmap;
+}
+
+/// @brief Release the dofmaps of a topology held by the cache of
+/// create_shared_dofmap.
+///
+/// Function spaces that use a cached dofmap keep it. Dofmaps created
+/// after this call are not shared with dofmaps created before.
+///
+/// @note Collective. Must be called on all processes of the topology.
+/// @param[in] topology Mesh topology
+inline void clear_dofmap_cache(mesh::Topology& topology)
+{
+  topology.dofmap_cache().clear();
+}
+
 /// @brief Create a function space from a Basix element.
 /// @param[in] mesh Mesh
 /// @param[in] e Basix finite element.
@@ -768,7 +868,9 @@ Form<T, U> create_form(
 /// 3D will have `value_shape` equal to `{3}`, and for a second-order
 /// tensor element in 2D `value_shape` equal to `{2, 2}`.
 /// @param[in] reorder_fn The graph reordering function to call on the
-/// dofmap. If `nullptr`, the default re-ordering is used.
+/// dofmap. If `nullptr`, the dofs are not re-ordered (see
+/// build_dofmap_data), and the dofmap is shared with spaces with an
+/// identical element on the same mesh (see create_shared_dofmap).
 /// @return The created function space
 template <std::floating_point T>
 FunctionSpace<T> create_functionspace(
@@ -826,8 +928,17 @@ FunctionSpace<T> create_functionspace(
     permute_inv = _e->dof_permutation_fn(true, true);
   assert(mesh);
   assert(mesh->topology());
-  auto dofmap = std::make_shared<const DofMap>(create_dofmap(
-      mesh->comm(), layout, *mesh->topology(), permute_inv, reorder_fn));
+  std::shared_ptr<const DofMap> dofmap;
+  if (reorder_fn)
+  {
+    dofmap = std::make_shared<const DofMap>(create_dofmap(
+        mesh->comm(), layout, *mesh->topology(), permute_inv, reorder_fn));
+  }
+  else
+  {
+    dofmap = create_shared_dofmap(mesh->comm(), *mesh->topology(), _e, layout,
+                                  permute_inv);
+  }
   return FunctionSpace(mesh, _e, dofmap, _value_shape);
 }
 
@@ -900,13 +1011,14 @@ concept FetchCells = requires(F&& f, std::span<const std::int32_t> v) {
 /// @param[in] fetch_cells Function that fetches the cell index for an
 /// entity in active_entities.
 /// @param[in] offset The offset for c.
+/// @param[in] num_threads Number of threads to use for packing.
 template <dolfinx::scalar T, std::floating_point U>
 void pack_coefficient_entity(std::span<T> c, int cstride,
                              const Function<T, U>& u,
                              std::span<const std::uint32_t> cell_info,
                              std::span<const std::int32_t> entities,
                              std::size_t estride, FetchCells auto&& fetch_cells,
-                             std::int32_t offset)
+                             std::int32_t offset, int num_threads = 1)
 {
   // Read data from coefficient Function u
   std::span<const T> v = u.x()->array();
@@ -920,59 +1032,75 @@ void pack_coefficient_entity(std::span<T> c, int cstride,
   auto transformation
       = element->template dof_transformation_fn<T>(doftransform::transpose);
   const int bs = dofmap.bs();
-  switch (bs)
+
+  // Pack entities [e0, e1), with entity positions in units of estride
+  auto pack_range = [&](auto _bs, std::size_t e0, std::size_t e1)
   {
-  case 1:
-    for (std::size_t e = 0; e < entities.size(); e += estride)
+    for (std::size_t e = e0 * estride; e < e1 * estride; e += estride)
     {
       auto entity = entities.subspan(e, estride);
       std::int32_t cell = fetch_cells(entity);
       auto cell_coeff = c.subspan((e / estride) * cstride + offset, space_dim);
-      pack<T, 1>(cell_coeff, cell, bs, v, cell_info, dofmap, transformation);
+      pack<T, decltype(_bs)::value>(cell_coeff, cell, bs, v, cell_info, dofmap,
+                                    transformation);
     }
-    break;
-  case 2:
-    for (std::size_t e = 0; e < entities.size(); e += estride)
-    {
-      auto entity = entities.subspan(e, estride);
-      std::int32_t cell = fetch_cells(entity);
-      auto cell_coeff = c.subspan((e / estride) * cstride + offset, space_dim);
-      pack<T, 2>(cell_coeff, cell, bs, v, cell_info, dofmap, transformation);
-    }
-    break;
-  case 3:
-    for (std::size_t e = 0; e < entities.size(); e += estride)
-    {
-      auto entity = entities.subspan(e, estride);
-      std::int32_t cell = fetch_cells(entity);
-      auto cell_coeff = c.subspan(e / estride * cstride + offset, space_dim);
-      pack<T, 3>(cell_coeff, cell, bs, v, cell_info, dofmap, transformation);
-    }
-    break;
-  default:
-    for (std::size_t e = 0; e < entities.size(); e += estride)
+  };
+
+  auto pack_entities = [&](std::size_t e0, std::size_t e1)
+  {
+    switch (bs)
     {
-      auto entity = entities.subspan(e, estride);
-      std::int32_t cell = fetch_cells(entity);
-      auto cell_coeff = c.subspan((e / estride) * cstride + offset, space_dim);
-      pack<T, -1>(cell_coeff, cell, bs, v, cell_info, dofmap, transformation);
+    case 1:
+      pack_range(std::integral_constant<int, 1>(), e0, e1);
+      break;
+    case 2:
+      pack_range(std::integral_constant<int, 2>(), e0, e1);
+      break;
+    case 3:
+      pack_range(std::integral_constant<int, 3>(), e0, e1);
+      break;
+    default:
+      pack_range(std::integral_constant<int, -1>(), e0, e1);
+      break;
     }
-    break;
+  };
+
+  const std::size_t num_entities = entities.size() / estride;
+  if (num_threads <= 1 or num_entities < 2)
+    pack_entities(0, num_entities);
+  else
+  {
+    // Entities write to distinct rows of c, so blocks of entities can be
+    // packed concurrently. The first block is packed by the calling
+    // thread.
+    const std::size_t nt
+        = std::min<std::size_t>(num_threads, num_entities);
+    common::run_tasks(nt,
+                      [&](std::size_t i)
+                      {
+                        pack_entities((i * num_entities) / nt,
+                                      ((i + 1) * num_entities) / nt);
+                      });
   }
 }
 
 } // namespace impl
 
-/// @brief Allocate storage for coefficients of a pair `(integral_type,
-/// id)` from a Form.
+/// @brief Shape of the packed coefficient array of a Form for a given
+/// integral type and domain id.
+///
+/// Arrays of this shape can be passed to pack_coefficients, e.g. for
+/// packing into storage that is owned by the caller.
+///
 /// @param[in] form The Form
 /// @param[in] integral_type Type of integral
 /// @param[in] id The id of the integration domain
-/// @return A storage container and the column stride
+/// @return The number of rows (integration entities) and the column
+/// stride
 template <dolfinx::scalar T, std::floating_point U>
-std::pair<std::vector<T>, int>
-allocate_coefficient_storage(const Form<T, U>& form, IntegralType integral_type,
-                             int id)
+std::array<std::size_t, 2> coefficient_storage_shape(const Form<T, U>& form,
+                                                     IntegralType integral_type,
+                                                     int id)
 {
   // Get form coefficient offsets and dofmaps
   const std::vector<std::shared_ptr<const Function<T, U>>>& coefficients
@@ -980,7 +1108,7 @@ allocate_coefficient_storage(const Form<T, U>& form, IntegralType integral_type,
   const std::vector<int> offsets = form.coefficient_offsets();
 
   std::size_t num_entities = 0;
-  int cstride = 0;
+  std::size_t cstride = 0;
   if (!coefficients.empty())
   {
     cstride = offsets.back();
@@ -992,6 +1120,22 @@ allocate_coefficient_storage(const Form<T, U>& form, IntegralType integral_type,
     }
   }
 
+  return {num_entities, cstride};
+}
+
+/// @brief Allocate storage for coefficients of a pair `(integral_type,
+/// id)` from a Form.
+/// @param[in] form The Form
+/// @param[in] integral_type Type of integral
+/// @param[in] id The id of the integration domain
+/// @return A storage container and the column stride
+template <dolfinx::scalar T, std::floating_point U>
+std::pair<std::vector<T>, int>
+allocate_coefficient_storage(const Form<T, U>& form, IntegralType integral_type,
+                             int id)
+{
+  auto [num_entities, cstride]
+      = coefficient_storage_shape(form, integral_type, id);
   return {std::vector<T>(num_entities * cstride), cstride};
 }
 
@@ -1017,16 +1161,26 @@ allocate_coefficient_storage(const Form<T, U>& form)
   return coeffs;
 }
 
+namespace impl
+{
 /// @brief Pack coefficients of a Form for a given integral type and
-/// domain id
+/// domain id.
 /// @param[in] form The Form
 /// @param[in] integral_type Type of integral
 /// @param[in] id The id of the integration domain
 /// @param[in,out] c The coefficient array
 /// @param[in] cstride The coefficient stride
+/// @param[in] domain Function called as `domain(mesh)` that returns
+/// the integration entities to pack for, with the layout of
+/// Form::domain and numbered with respect to `mesh`.
+/// @param[in] include Function called as `include(i)` that returns
+/// `true` if the ith coefficient of the form should be packed. The
+/// columns of `c` for other coefficients are not modified.
+/// @param[in] num_threads Number of threads to use for packing.
 template <dolfinx::scalar T, std::floating_point U>
 void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
-                       int id, std::span<T> c, int cstride)
+                       int id, std::span<T> c, int cstride, auto&& domain,
+                       auto&& include, int num_threads)
 {
   // Get form coefficient offsets and dofmaps
   const std::vector<std::shared_ptr<const Function<T, U>>>& coefficients
@@ -1052,7 +1206,7 @@ void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
       // Iterate over coefficients
       for (std::size_t coeff = 0; coeff < coefficients.size(); ++coeff)
       {
-        if (!active_coefficient[coeff])
+        if (!active_coefficient[coeff] or !include(coeff))
           continue;
 
         // Get coefficient mesh
@@ -1070,13 +1224,13 @@ void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
                                    "codim>0 in a cell integral");
         }
 
-        std::vector<std::int32_t> cells
-            = form.domain(IntegralType::cell, id, *mesh);
+        auto cells = domain(*mesh);
         std::span<const std::uint32_t> cell_info
             = impl::get_cell_orientation_info(*coefficients[coeff]);
         impl::pack_coefficient_entity(
             c, cstride, *coefficients[coeff], cell_info, cells, 1,
-            [](auto entity) { return entity.front(); }, offsets[coeff]);
+            [](auto entity) { return entity.front(); }, offsets[coeff],
+            num_threads);
       }
       break;
     }
@@ -1094,17 +1248,17 @@ void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
       // Iterate over coefficients
       for (std::size_t coeff = 0; coeff < coefficients.size(); ++coeff)
       {
-        if (!active_coefficient[coeff])
+        if (!active_coefficient[coeff] or !include(coeff))
           continue;
 
         auto mesh = coefficients[coeff]->function_space()->mesh();
-        std::vector<std::int32_t> facets
-            = form.domain(IntegralType::exterior_facet, id, *mesh);
+        auto facets = domain(*mesh);
         std::span<const std::uint32_t> cell_info
             = impl::get_cell_orientation_info(*coefficients[coeff]);
         impl::pack_coefficient_entity(
             c, cstride, *coefficients[coeff], cell_info, facets, 2,
-            [](auto entity) { return entity.front(); }, offsets[coeff]);
+            [](auto entity) { return entity.front(); }, offsets[coeff],
+            num_threads);
       }
       break;
     }
@@ -1122,25 +1276,25 @@ void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
       // Iterate over coefficients
       for (std::size_t coeff = 0; coeff < coefficients.size(); ++coeff)
       {
-        if (!active_coefficient[coeff])
+        if (!active_coefficient[coeff] or !include(coeff))
           continue;
 
         auto mesh = coefficients[coeff]->function_space()->mesh();
-        std::vector<std::int32_t> facets
-            = form.domain(IntegralType::interior_facet, id, *mesh);
+        auto facets = domain(*mesh);
         std::span<const std::uint32_t> cell_info
             = impl::get_cell_orientation_info(*coefficients[coeff]);
 
         // Pack coefficient ['+']
         impl::pack_coefficient_entity(
             c, 2 * cstride, *coefficients[coeff], cell_info, facets, 4,
-            [](auto entity) { return entity[0]; }, 2 * offsets[coeff]);
+            [](auto entity) { return entity[0]; }, 2 * offsets[coeff],
+            num_threads);
 
         // Pack coefficient ['-']
         impl::pack_coefficient_entity(
             c, 2 * cstride, *coefficients[coeff], cell_info, facets, 4,
             [](auto entity) { return entity[2]; },
-            offsets[coeff] + offsets[coeff + 1]);
+            offsets[coeff] + offsets[coeff + 1], num_threads);
       }
       break;
     }
@@ -1150,6 +1304,67 @@ void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
     }
   }
 }
+} // namespace impl
+
+/// @brief Pack coefficients of a Form for a given integral type and
+/// domain id
+/// @param[in] form The Form
+/// @param[in] integral_type Type of integral
+/// @param[in] id The id of the integration domain
+/// @param[in,out] c The coefficient array
+/// @param[in] cstride The coefficient stride
+/// @param[in] num_threads Number of threads to use for packing
+template <dolfinx::scalar T, std::floating_point U>
+void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
+                       int id, std::span<T> c, int cstride,
+                       int num_threads = 1)
+{
+  impl::pack_coefficients(
+      form, integral_type, id, c, cstride,
+      [&form, integral_type, id](auto& mesh)
+      { return form.domain(integral_type, id, mesh); },
+      [](std::size_t) { return true; }, num_threads);
+}
+
+/// @brief Pack coefficients of a Form for a subset of the integration
+/// entities of a given integral type and domain id.
+///
+/// @param[in] form The Form
+/// @param[in] integral_type Type of integral
+/// @param[in] id The id of the integration domain
+/// @param[in] entities Positions in `form.domain(integral_type, id)`
+/// of the entities to pack coefficients for.
+/// @param[in,out] c The coefficient array, with the data for
+/// `entities[i]` stored in the ith row.
+/// @param[in] cstride The coefficient stride
+template <dolfinx::scalar T, std::floating_point U>
+void pack_coefficients(const Form<T, U>& form, IntegralType integral_type,
+                       int id, std::span<const std::int32_t> entities,
+                       std::span<T> c, int cstride)
+{
+  int stride = 1;
+  if (integral_type == IntegralType::exterior_facet)
+    stride = 2;
+  else if (integral_type == IntegralType::interior_facet)
+    stride = 4;
+
+  impl::pack_coefficients(
+      form, integral_type, id, c, cstride,
+      [&form, integral_type, id, entities, stride](auto& mesh)
+      {
+        std::span<const std::int32_t> all
+            = form.domain(integral_type, id, mesh);
+        std::vector<std::int32_t> subset;
+        subset.reserve(entities.size() * stride);
+        for (std::int32_t e : entities)
+        {
+          subset.insert(subset.end(), std::next(all.begin(), e * stride),
+                        std::next(all.begin(), (e + 1) * stride));
+        }
+        return subset;
+      },
+      [](std::size_t) { return true; }, 1);
+}
 
 /// @brief Create Expression from UFC
 template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
@@ -1261,13 +1476,18 @@ Expression<T, U> create_expression(
 /// being integrated over and cstride is the number of coefficient data
 /// entries per integration entity. `coeffs` is flattened into row-major
 /// layout.
+/// @param[in] num_threads Number of threads to use for packing
 template <dolfinx::scalar T, std::floating_point U>
 void pack_coefficients(const Form<T, U>& form,
                        std::map<std::pair<IntegralType, int>,
-                                std::pair<std::vector<T>, int>>& coeffs)
+                                std::pair<std::vector<T>, int>>& coeffs,
+                       int num_threads = 1)
 {
   for (auto& [key, val] : coeffs)
-    pack_coefficients<T>(form, key.first, key.second, val.first, val.second);
+  {
+    pack_coefficients<T>(form, key.first, key.second, std::span(val.first),
+                         val.second, num_threads);
+  }
 }
 
 /// @brief Pack coefficients of a Expression u for a give list of active
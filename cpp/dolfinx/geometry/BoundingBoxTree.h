@@ -10,9 +10,13 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/mesh/utils.h>
+#include <limits>
 #include <mpi.h>
+#include <numeric>
 #include <span>
 #include <string>
 #include <vector>
@@ -22,11 +26,12 @@ namespace dolfinx::geometry
 namespace impl_bb
 {
 //-----------------------------------------------------------------------------
-// Compute bounding box of mesh entity. The bounding box is defined by (lower
-// left corner, top right corner). Storage flattened row-major
+// Compute bounding box of mesh entity, extended by `padding`. The
+// bounding box is defined by (lower left corner, top right corner).
+// Storage flattened row-major
 template <std::floating_point T>
 std::array<T, 6> compute_bbox_of_entity(const mesh::Mesh<T>& mesh, int dim,
-                                        std::int32_t index)
+                                        std::int32_t index, T padding = 0)
 {
   // Get the geometrical indices for the mesh entity
   std::span<const T> xg = mesh.geometry().x();
@@ -52,6 +57,12 @@ std::array<T, 6> compute_bbox_of_entity(const mesh::Mesh<T>& mesh, int dim,
     }
   }
 
+  for (std::size_t j = 0; j < 3; ++j)
+  {
+    b0[j] -= padding;
+    b1[j] += padding;
+  }
+
   return b;
 }
 //-----------------------------------------------------------------------------
@@ -76,68 +87,233 @@ std::array<T, 6> compute_bbox_of_bboxes(
   return b;
 }
 //------------------------------------------------------------------------------
+// Surface measure of a bounding box used by the surface area heuristic.
+// The measure is the (half) surface area of boxes in d = 3 and d = 2,
+// and the length for boxes that are flat in two directions (`dim` =
+// 1).
 template <std::floating_point T>
-std::int32_t _build_from_leaf(
-    std::span<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes,
-    std::vector<int>& bboxes, std::vector<T>& bbox_coordinates)
+T bbox_measure(const std::array<T, 6>& b, int dim)
 {
-  if (leaf_bboxes.size() == 1)
+  const T dx = b[3] - b[0], dy = b[4] - b[1], dz = b[5] - b[2];
+  return dim == 1 ? dx + dy + dz : dx * dy + dy * dz + dz * dx;
+}
+//------------------------------------------------------------------------------
+// Expand bounding box b to contain bounding box c
+template <std::floating_point T>
+void bbox_expand(std::array<T, 6>& b, const std::array<T, 6>& c)
+{
+  for (std::size_t j = 0; j < 3; ++j)
+  {
+    b[j] = std::min(b[j], c[j]);
+    b[3 + j] = std::max(b[3 + j], c[3 + j]);
+  }
+}
+//------------------------------------------------------------------------------
+// Split leaf bounding boxes in place into two non-empty groups using a
+// binned surface area heuristic (SAH). The boxes are binned by their
+// midpoint along the axis with the largest extent of midpoints, and
+// the split between bins that minimises the sum over the two groups of
+// (number of boxes) x (measure of the group bounding box) is chosen. A
+// median split is used when no such split exists, e.g. when all
+// midpoints coincide. Returns the number of boxes in the first group.
+template <std::floating_point T>
+std::size_t
+sah_split(std::span<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes,
+          const std::array<T, 6>& b)
+{
+  constexpr int num_bins = 16;
+  auto midpoint = [](auto& p, std::size_t axis)
+  { return T(0.5) * p.first[axis] + T(0.5) * p.first[3 + axis]; };
+
+  // Bounding box of the midpoints
+  std::array<T, 3> c0 = {std::numeric_limits<T>::max(),
+                         std::numeric_limits<T>::max(),
+                         std::numeric_limits<T>::max()};
+  std::array<T, 3> c1 = {std::numeric_limits<T>::lowest(),
+                         std::numeric_limits<T>::lowest(),
+                         std::numeric_limits<T>::lowest()};
+  for (auto& p : leaf_bboxes)
   {
-    // Reached leaf
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      c0[j] = std::min(c0[j], midpoint(p, j));
+      c1[j] = std::max(c1[j], midpoint(p, j));
+    }
+  }
 
-    // Get bounding box coordinates for leaf
-    const auto [b, entity_index] = leaf_bboxes.front();
+  std::array<T, 3> c_diff;
+  std::ranges::transform(c1, c0, c_diff.begin(), std::minus<T>());
+  const std::size_t axis
+      = std::distance(c_diff.begin(), std::ranges::max_element(c_diff));
 
-    // Store bounding box data
-    bboxes.push_back(entity_index);
-    bboxes.push_back(entity_index);
-    std::copy_n(b.begin(), 6, std::back_inserter(bbox_coordinates));
-    return bboxes.size() / 2 - 1;
+  std::size_t part = 0;
+  if (c_diff[axis] > 0 and std::isfinite(c_diff[axis]))
+  {
+    // Measure of boxes with a surface area, or else a length
+    const int dim = bbox_measure(b, 2) > 0 ? 2 : 1;
+
+    const T scale = T(num_bins) / c_diff[axis];
+    auto bin = [&](auto& p)
+    {
+      int k = (midpoint(p, axis) - c0[axis]) * scale;
+      return std::clamp(k, 0, num_bins - 1);
+    };
+
+    // Count boxes and compute the bounding box of each bin
+    std::array<std::size_t, num_bins> count{};
+    std::array<std::array<T, 6>, num_bins> bin_bbox;
+    for (auto& p : leaf_bboxes)
+    {
+      const int k = bin(p);
+      if (count[k]++ == 0)
+        bin_bbox[k] = p.first;
+      else
+        bbox_expand(bin_bbox[k], p.first);
+    }
+
+    // Sweep from the right to get the cost of the right-hand groups
+    std::array<T, num_bins> right_cost;
+    std::array<T, 6> br;
+    std::size_t nr = 0;
+    for (int k = num_bins - 1; k > 0; --k)
+    {
+      if (count[k] > 0)
+      {
+        if (nr == 0)
+          br = bin_bbox[k];
+        else
+          bbox_expand(br, bin_bbox[k]);
+        nr += count[k];
+      }
+      right_cost[k] = nr > 0 ? nr * bbox_measure(br, dim) : 0;
+    }
+
+    // Sweep from the left and find the lowest cost split
+    std::array<T, 6> bl;
+    std::size_t nl = 0;
+    T best_cost = std::numeric_limits<T>::infinity();
+    int best_bin = -1;
+    for (int k = 0; k < num_bins - 1; ++k)
+    {
+      if (count[k] > 0)
+      {
+        if (nl == 0)
+          bl = bin_bbox[k];
+        else
+          bbox_expand(bl, bin_bbox[k]);
+        nl += count[k];
+      }
+      if (nl == 0 or nl == leaf_bboxes.size())
+        continue;
+      const T cost = nl * bbox_measure(bl, dim) + right_cost[k + 1];
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        best_bin = k;
+      }
+    }
+
+    if (best_bin >= 0)
+    {
+      auto it = std::partition(leaf_bboxes.begin(), leaf_bboxes.end(),
+                               [&](auto& p) { return bin(p) <= best_bin; });
+      part = std::distance(leaf_bboxes.begin(), it);
+    }
+  }
+
+  if (part == 0 or part == leaf_bboxes.size())
+  {
+    // Median split
+    part = leaf_bboxes.size() / 2;
+    std::nth_element(leaf_bboxes.begin(), std::next(leaf_bboxes.begin(), part),
+                     leaf_bboxes.end(), [&](auto& p0, auto& p1)
+                     { return midpoint(p0, axis) < midpoint(p1, axis); });
+  }
+
+  return part;
+}
+//------------------------------------------------------------------------------
+// Build the bounding box tree of leaf bounding boxes, storing the nodes
+// in post-order. The subtree of n leaves occupies the 2n - 1 nodes
+// starting at `node`, with its root last. The two subtrees of a node
+// are built concurrently when `num_threads > 1`.
+template <std::floating_point T>
+void _build_from_leaf(
+    std::span<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes,
+    std::int32_t node, std::span<std::int32_t> bboxes,
+    std::span<T> bbox_coordinates, int num_threads)
+{
+  const std::int32_t root = node + 2 * leaf_bboxes.size() - 2;
+  if (leaf_bboxes.size() == 1)
+  {
+    // Reached leaf: store bounding box data
+    const auto& [b, entity_index] = leaf_bboxes.front();
+    bboxes[2 * root] = entity_index;
+    bboxes[2 * root + 1] = entity_index;
+    std::ranges::copy(b, std::next(bbox_coordinates.begin(), 6 * root));
   }
   else
   {
     // Compute bounding box of all bounding boxes
-    std::array b = compute_bbox_of_bboxes<T>(leaf_bboxes);
-
-    // Sort bounding boxes along longest axis
-    std::array<T, 3> b_diff;
-    std::transform(std::next(b.cbegin(), 3), b.cend(), b.cbegin(),
-                   b_diff.begin(), std::minus<T>());
-    const std::size_t axis = std::distance(
-        b_diff.begin(), std::max_element(b_diff.begin(), b_diff.end()));
-
-    auto middle = std::next(leaf_bboxes.begin(), leaf_bboxes.size() / 2);
-    std::nth_element(leaf_bboxes.begin(), middle, leaf_bboxes.end(),
-                     [axis](auto& p0, auto& p1) -> bool
-                     {
-                       auto x0 = p0.first[axis] + p0.first[3 + axis];
-                       auto x1 = p1.first[axis] + p1.first[3 + axis];
-                       return x0 < x1;
-                     });
-
-    // Split bounding boxes into two groups and call recursively
-    assert(!leaf_bboxes.empty());
-    std::size_t part = leaf_bboxes.size() / 2;
-    std::int32_t bbox0
-        = _build_from_leaf(leaf_bboxes.first(part), bboxes, bbox_coordinates);
-    std::int32_t bbox1 = _build_from_leaf(
-        leaf_bboxes.last(leaf_bboxes.size() - part), bboxes, bbox_coordinates);
-
-    // Store bounding box data. Note that root box will be added last.
-    bboxes.push_back(bbox0);
-    bboxes.push_back(bbox1);
-    std::copy_n(b.begin(), 6, std::back_inserter(bbox_coordinates));
-    return bboxes.size() / 2 - 1;
+    std::array<T, 6> b = compute_bbox_of_bboxes<T>(leaf_bboxes);
+
+    // Split bounding boxes into two groups and build the subtrees
+    const std::size_t part = sah_split(leaf_bboxes, b);
+    const std::int32_t node1 = node + 2 * part - 1;
+    auto build0 = [&, node, part, nt = num_threads / 2]()
+    {
+      _build_from_leaf(leaf_bboxes.first(part), node, bboxes,
+                       bbox_coordinates, std::max(nt, 1));
+    };
+
+    // Threads are not worth starting for small subtrees
+    constexpr std::size_t min_parallel_size = 1024;
+    if (num_threads > 1 and leaf_bboxes.size() >= min_parallel_size)
+    {
+      // Build the subtrees as two tasks on the thread pool, which is
+      // grown for all threads of the recursion
+      common::thread_pool().reserve(num_threads - 1);
+      common::run_tasks(2,
+                        [&](int i)
+                        {
+                          if (i == 0)
+                            build0();
+                          else
+                          {
+                            _build_from_leaf(leaf_bboxes.subspan(part),
+                                             node1, bboxes, bbox_coordinates,
+                                             num_threads - num_threads / 2);
+                          }
+                        });
+    }
+    else
+    {
+      build0();
+      _build_from_leaf(leaf_bboxes.subspan(part), node1, bboxes,
+                       bbox_coordinates, 1);
+    }
+
+    // Store bounding box data. Note that the root box is stored last.
+    bboxes[2 * root] = node1 - 1;
+    bboxes[2 * root + 1] = root - 1;
+    std::ranges::copy(b, std::next(bbox_coordinates.begin(), 6 * root));
   }
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point T>
 std::pair<std::vector<std::int32_t>, std::vector<T>> build_from_leaf(
-    std::vector<std::pair<std::array<T, 6>, std::int32_t>>& leaf_bboxes)
+    std::vector<std::pair<std::array<T, 6>, std::int32_t>>& leaf_bboxes,
+    int num_threads = 1)
 {
-  std::vector<std::int32_t> bboxes;
-  std::vector<T> bbox_coordinates;
-  impl_bb::_build_from_leaf<T>(leaf_bboxes, bboxes, bbox_coordinates);
+  if (leaf_bboxes.empty())
+    return {};
+
+  // A binary tree with n leaves has 2n - 1 nodes
+  const std::size_t num_nodes = 2 * leaf_bboxes.size() - 1;
+  std::vector<std::int32_t> bboxes(2 * num_nodes);
+  std::vector<T> bbox_coordinates(6 * num_nodes);
+  impl_bb::_build_from_leaf<T>(leaf_bboxes, 0, bboxes, bbox_coordinates,
+                               num_threads);
   return {std::move(bboxes), std::move(bbox_coordinates)};
 }
 //-----------------------------------------------------------------------------
@@ -164,9 +340,16 @@ _build_from_point(std::span<std::pair<std::array<T, 3>, std::int32_t>> points,
   }
 
   // Compute bounding box of all points
-  auto [min, max] = std::ranges::minmax_element(points);
-  std::array<T, 3> b0 = min->first;
-  std::array<T, 3> b1 = max->first;
+  std::array<T, 3> b0 = points[0].first;
+  std::array<T, 3> b1 = points[0].first;
+  for (auto& p : points)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      b0[j] = std::min(b0[j], p.first[j]);
+      b1[j] = std::max(b1[j], p.first[j]);
+    }
+  }
 
   // Sort bounding boxes along longest axis
   std::array<T, 3> b_diff;
@@ -195,6 +378,94 @@ _build_from_point(std::span<std::pair<std::array<T, 3>, std::int32_t>> points,
   return bboxes.size() / 2 - 1;
 }
 //-----------------------------------------------------------------------------
+// Gather bounding boxes (flattened, shape (num_boxes, 6)) from all
+// processes in `comm`. The boxes are first gathered on the lowest rank
+// of each shared-memory node, which exchange them with each other and
+// then broadcast them on their node, so that only one process per node
+// takes part in the global collective. Returns the boxes with the rank
+// of the process that they came from, ordered by rank.
+template <std::floating_point T>
+std::vector<std::pair<std::array<T, 6>, std::int32_t>>
+gather_bboxes(MPI_Comm comm, std::span<const T> bboxes)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+                      &node_comm);
+  const int node_rank = dolfinx::MPI::rank(node_comm);
+  const int node_size = dolfinx::MPI::size(node_comm);
+  MPI_Comm leader_comm;
+  MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+                 &leader_comm);
+
+  // Gather the boxes, and the rank of each box, on the node leader
+  const int num_values = bboxes.size();
+  std::vector<int> node_counts(node_size), node_ranks(node_size);
+  MPI_Gather(&num_values, 1, MPI_INT, node_counts.data(), 1, MPI_INT, 0,
+             node_comm);
+  MPI_Gather(&rank, 1, MPI_INT, node_ranks.data(), 1, MPI_INT, 0, node_comm);
+  std::vector<int> node_offsets(node_size + 1, 0);
+  std::partial_sum(node_counts.begin(), node_counts.end(),
+                   std::next(node_offsets.begin()));
+  std::vector<T> coords(node_offsets.back());
+  MPI_Gatherv(bboxes.data(), num_values, dolfinx::MPI::mpi_type<T>(),
+              coords.data(), node_counts.data(), node_offsets.data(),
+              dolfinx::MPI::mpi_type<T>(), 0, node_comm);
+  std::vector<std::int32_t> owners;
+  for (int i = 0; i < node_size; ++i)
+    owners.insert(owners.end(), node_counts[i] / 6, node_ranks[i]);
+
+  // Exchange the boxes between the node leaders
+  if (leader_comm != MPI_COMM_NULL)
+  {
+    const int num_leaders = dolfinx::MPI::size(leader_comm);
+    std::vector<int> counts(num_leaders);
+    const int num_boxes = owners.size();
+    MPI_Allgather(&num_boxes, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                  leader_comm);
+    std::vector<int> offsets(num_leaders + 1, 0);
+    std::partial_sum(counts.begin(), counts.end(),
+                     std::next(offsets.begin()));
+    std::vector<std::int32_t> recv_owners(offsets.back());
+    MPI_Allgatherv(owners.data(), num_boxes, MPI_INT32_T, recv_owners.data(),
+                   counts.data(), offsets.data(), MPI_INT32_T, leader_comm);
+
+    std::ranges::transform(counts, counts.begin(), [](int c) { return 6 * c; });
+    std::ranges::transform(offsets, offsets.begin(),
+                           [](int c) { return 6 * c; });
+    std::vector<T> recv_coords(offsets.back());
+    MPI_Allgatherv(coords.data(), coords.size(), dolfinx::MPI::mpi_type<T>(),
+                   recv_coords.data(), counts.data(), offsets.data(),
+                   dolfinx::MPI::mpi_type<T>(), leader_comm);
+    owners = std::move(recv_owners);
+    coords = std::move(recv_coords);
+    MPI_Comm_free(&leader_comm);
+  }
+
+  // Broadcast the boxes on the node
+  std::int64_t num_boxes = owners.size();
+  MPI_Bcast(&num_boxes, 1, MPI_INT64_T, 0, node_comm);
+  owners.resize(num_boxes);
+  coords.resize(6 * num_boxes);
+  MPI_Bcast(owners.data(), owners.size(), MPI_INT32_T, 0, node_comm);
+  MPI_Bcast(coords.data(), coords.size(), dolfinx::MPI::mpi_type<T>(), 0,
+            node_comm);
+  MPI_Comm_free(&node_comm);
+
+  // Node leaders are ordered by rank, but the ranks of different nodes
+  // can interleave
+  std::vector<std::pair<std::array<T, 6>, std::int32_t>> leaves(num_boxes);
+  for (std::size_t i = 0; i < leaves.size(); ++i)
+  {
+    std::copy_n(std::next(coords.begin(), 6 * i), 6, leaves[i].first.begin());
+    leaves[i].second = owners[i];
+  }
+  std::ranges::stable_sort(leaves, std::less<>(),
+                           [](auto& leaf) { return leaf.second; });
+
+  return leaves;
+}
+//-----------------------------------------------------------------------------
 } // namespace impl_bb
 
 /// Axis-Aligned bounding box binary tree. It is used to find entities
@@ -223,9 +494,11 @@ public:
   /// compute the bounding box for (may be empty, if none).
   /// @param[in] padding Value to pad (extend) the the bounding box of
   /// each entity by.
+  /// @param[in] num_threads Number of threads used to build the tree.
   BoundingBoxTree(const mesh::Mesh<T>& mesh, int tdim,
-                  std::span<const std::int32_t> entities, double padding = 0)
-      : _tdim(tdim)
+                  std::span<const std::int32_t> entities, double padding = 0,
+                  int num_threads = 1)
+      : _tdim(tdim), _padding(padding)
   {
     if (tdim < 0 or tdim > mesh.topology()->dim())
     {
@@ -239,25 +512,35 @@ public:
     mesh.topology_mutable()->create_connectivity(tdim, mesh.topology()->dim());
 
     // Create bounding boxes for all mesh entities (leaves)
-    std::vector<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes;
-    leaf_bboxes.reserve(entities.size());
-    for (std::int32_t e : entities)
+    std::vector<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes(
+        entities.size());
+    auto compute_leaves = [&](std::size_t i0, std::size_t i1)
+    {
+      for (std::size_t i = i0; i < i1; ++i)
+      {
+        leaf_bboxes[i] = {impl_bb::compute_bbox_of_entity<T>(
+                              mesh, tdim, entities[i], padding),
+                          entities[i]};
+      }
+    };
     {
-      std::array<T, 6> b = impl_bb::compute_bbox_of_entity(mesh, tdim, e);
-      std::transform(b.cbegin(), std::next(b.cbegin(), 3), b.begin(),
-                     [padding](auto x) { return x - padding; });
-      std::transform(std::next(b.begin(), 3), b.end(), std::next(b.begin(), 3),
-                     [padding](auto x) { return x + padding; });
-      leaf_bboxes.emplace_back(b, e);
+      const int nt = std::max(num_threads, 1);
+      common::run_tasks(nt,
+                        [&](int t)
+                        {
+                          compute_leaves(t * entities.size() / nt,
+                                         (t + 1) * entities.size() / nt);
+                        });
     }
 
     // Recursively build the bounding box tree from the leaves
     if (!leaf_bboxes.empty())
       std::tie(_bboxes, _bbox_coordinates)
-          = impl_bb::build_from_leaf(leaf_bboxes);
+          = impl_bb::build_from_leaf(leaf_bboxes, num_threads);
+    _build_cost = sah_cost();
 
-    spdlog::info("Computed bounding box tree with {} nodes for {} entities",
-                 num_bboxes(), entities.size());
+    DOLFINX_LOG_INFO("Computed bounding box tree with {} nodes for {} entities",
+                     num_bboxes(), entities.size());
   }
 
   /// Constructor
@@ -266,9 +549,12 @@ public:
   /// build the bounding box tree for
   /// @param[in] padding Value to pad (extend) the the bounding box of
   /// each entity by.
-  BoundingBoxTree(const mesh::Mesh<T>& mesh, int tdim, T padding = 0)
-      : BoundingBoxTree::BoundingBoxTree(
-            mesh, tdim, range(mesh.topology_mutable(), tdim), padding)
+  /// @param[in] num_threads Number of threads used to build the tree.
+  BoundingBoxTree(const mesh::Mesh<T>& mesh, int tdim, T padding = 0,
+                  int num_threads = 1)
+      : BoundingBoxTree::BoundingBoxTree(mesh, tdim,
+                                         range(*mesh.topology_mutable(), tdim),
+                                         padding, num_threads)
   {
     // Do nothing
   }
@@ -285,8 +571,25 @@ public:
       impl_bb::_build_from_point(std::span(points), _bboxes, _bbox_coordinates);
     }
 
-    spdlog::info("Computed bounding box tree with {} nodes for {} points.",
-                 num_bboxes(), points.size());
+    DOLFINX_LOG_INFO("Computed bounding box tree with {} nodes for {} points.",
+                     num_bboxes(), points.size());
+  }
+
+  /// @brief Create a tree from leaf bounding boxes.
+  /// @param[in] leaf_bboxes The bounding box (lower corner, upper
+  /// corner) of each leaf, with the leaf (entity) index
+  /// @param[in] num_threads Number of threads used to build the tree.
+  BoundingBoxTree(
+      std::vector<std::pair<std::array<T, 6>, std::int32_t>> leaf_bboxes,
+      int num_threads = 1)
+      : _tdim(0)
+  {
+    if (!leaf_bboxes.empty())
+    {
+      std::tie(_bboxes, _bbox_coordinates)
+          = impl_bb::build_from_leaf(leaf_bboxes, num_threads);
+    }
+    _build_cost = sah_cost();
   }
 
   /// Move constructor
@@ -316,46 +619,123 @@ public:
     return x;
   }
 
-  /// Compute a global bounding tree (collective on comm)
-  /// This can be used to find which process a point might have a
-  /// collision with.
+  /// @brief Compute a global bounding box tree (collective on comm).
+  ///
+  /// The leaves of the global tree are bounding boxes of the entities
+  /// on each process, with the rank of the process as the leaf
+  /// (entity) index. It can be used to find which processes a point
+  /// might collide with.
+  ///
+  /// A process can contribute more than one box, which are the boxes
+  /// of disjoint subtrees that together cover the root box of the
+  /// process. This reduces the number of false positive processes for
+  /// processes with non-convex partitions, but the rank of a process can
+  /// then appear more than once in the collisions of a point.
+  ///
+  /// The boxes are aggregated on each shared-memory node before they
+  /// are exchanged between the nodes.
+  ///
   /// @param[in] comm MPI Communicator for collective communication
-  /// @return BoundingBoxTree where each node represents a process
-  BoundingBoxTree create_global_tree(MPI_Comm comm) const
+  /// @param[in] num_boxes Maximum number of boxes per process
+  /// @return BoundingBoxTree where each leaf represents (part of) a
+  /// process
+  BoundingBoxTree create_global_tree(MPI_Comm comm, int num_boxes = 1) const
   {
-    // Build tree for each rank
-    const int mpi_size = dolfinx::MPI::size(comm);
-
-    // Send root node coordinates to all processes
-    // This is to counteract the fact that a process might have 0 bounding box
-    // causing false positives on process collisions around (0,0,0)
-    constexpr T max_val = std::numeric_limits<T>::max();
-    std::array<T, 6> send_bbox
-        = {max_val, max_val, max_val, max_val, max_val, max_val};
+    // Choose the subtrees by repeatedly splitting the subtree with the
+    // largest box, starting from the root. Processes with no boxes send
+    // nothing.
+    std::vector<std::int32_t> nodes;
     if (num_bboxes() > 0)
-      std::copy_n(std::prev(_bbox_coordinates.end(), 6), 6, send_bbox.begin());
-    std::vector<T> recv_bbox(mpi_size * 6);
-    MPI_Allgather(send_bbox.data(), 6, dolfinx::MPI::mpi_type<T>(),
-                  recv_bbox.data(), 6, dolfinx::MPI::mpi_type<T>(), comm);
+      nodes.push_back(num_bboxes() - 1);
+    auto measure = [this](std::int32_t n)
+    {
+      if (is_leaf(n))
+        return T(-1);
+      std::array<T, 6> b = get_bbox(n);
+      return (b[3] - b[0]) + (b[4] - b[1]) + (b[5] - b[2]);
+    };
+    while (nodes.size() < std::size_t(std::max(num_boxes, 1)))
+    {
+      auto it = std::ranges::max_element(nodes, std::less<>(), measure);
+      if (it == nodes.end() or is_leaf(*it))
+        break;
+      std::array<std::int32_t, 2> c = bbox(*it);
+      *it = c[0];
+      nodes.push_back(c[1]);
+    }
 
-    std::vector<std::pair<std::array<T, 6>, std::int32_t>> _recv_bbox(mpi_size);
-    for (std::size_t i = 0; i < _recv_bbox.size(); ++i)
+    std::vector<T> send_bboxes(6 * nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
     {
-      std::copy_n(std::next(recv_bbox.begin(), 6 * i), 6,
-                  _recv_bbox[i].first.begin());
-      _recv_bbox[i].second = i;
+      std::copy_n(std::next(_bbox_coordinates.begin(), 6 * nodes[i]), 6,
+                  std::next(send_bboxes.begin(), 6 * i));
     }
 
-    auto [global_bboxes, global_coords] = impl_bb::build_from_leaf(_recv_bbox);
+    std::vector leaves = impl_bb::gather_bboxes<T>(comm, send_bboxes);
+    auto [global_bboxes, global_coords] = impl_bb::build_from_leaf(leaves);
     BoundingBoxTree global_tree(std::move(global_bboxes),
                                 std::move(global_coords));
 
-    spdlog::info("Computed global bounding box tree with {} boxes.",
-                 global_tree.num_bboxes());
+    DOLFINX_LOG_INFO("Computed global bounding box tree with {} boxes.",
+                     global_tree.num_bboxes());
 
     return global_tree;
   }
 
+  /// @brief Update the bounding boxes for new mesh coordinates.
+  ///
+  /// The hierarchy of the tree is kept. The bounding boxes of the
+  /// leaves are recomputed from the geometry of `mesh` and the boxes of
+  /// the other nodes are recomputed bottom-up, which costs `O(n)`
+  /// rather than the `O(n log n)` of building a new tree. This is
+  /// suitable when the mesh geometry changes but the topology does not,
+  /// e.g. for moving meshes.
+  ///
+  /// Refitting preserves the correctness of collision queries, but the
+  /// tree becomes less efficient as entities move relative to each
+  /// other. The returned ratio of sah_cost() after refitting to its
+  /// value when the tree was built measures this; a new tree should be
+  /// built when it grows large (say above 1.5).
+  ///
+  /// @param[in] mesh Mesh that the tree was built for, with updated
+  /// geometry.
+  /// @param[in] num_threads Number of threads to use.
+  /// @return Ratio of the SAH cost of the refitted tree to the cost of
+  /// the tree when it was built.
+  T refit(const mesh::Mesh<T>& mesh, int num_threads = 1)
+  {
+    if (num_bboxes() > 0)
+      refit(mesh, 0, num_bboxes() - 1, num_threads);
+    return _build_cost > 0 ? sah_cost() / _build_cost : T(1);
+  }
+
+  /// @brief Surface area heuristic (SAH) cost of the tree.
+  ///
+  /// The cost is the sum over the non-leaf nodes of the (half) surface
+  /// area of the node bounding box, relative to the surface area of
+  /// the root bounding box. This estimates the number of nodes that are
+  /// visited by a query for a random point in the root bounding box,
+  /// and is lower for trees with less overlap between nodes. The length
+  /// of the boxes is used in place of the area if the root box is flat
+  /// in two directions.
+  T sah_cost() const
+  {
+    if (num_bboxes() == 0)
+      return 0;
+
+    const std::array<T, 6> root = get_bbox(num_bboxes() - 1);
+    const int dim = impl_bb::bbox_measure(root, 2) > 0 ? 2 : 1;
+    const T root_measure = impl_bb::bbox_measure(root, dim);
+    if (root_measure <= 0)
+      return 0;
+
+    T cost = 0;
+    for (std::int32_t i = 0; i < num_bboxes(); ++i)
+      if (_bboxes[2 * i] != _bboxes[2 * i + 1])
+        cost += impl_bb::bbox_measure(get_bbox(i), dim);
+    return cost / root_measure;
+  }
+
   /// Return number of bounding boxes
   std::int32_t num_bboxes() const { return _bboxes.size() / 2; }
 
@@ -384,6 +764,12 @@ public:
   }
 
 private:
+  // True if node is a leaf
+  bool is_leaf(std::int32_t node) const
+  {
+    return _bboxes[2 * node] == _bboxes[2 * node + 1];
+  }
+
   // Constructor
   BoundingBoxTree(std::vector<std::int32_t>&& bboxes,
                   std::vector<T>&& bbox_coords)
@@ -392,9 +778,61 @@ private:
     // Do nothing
   }
 
+  // Recompute the bounding boxes of the subtree with root `node`, which
+  // occupies the nodes [first, node] (recursive)
+  void refit(const mesh::Mesh<T>& mesh, std::int32_t first,
+             std::int32_t node, int num_threads)
+  {
+    std::span<T, 6> b(_bbox_coordinates.data() + 6 * node, 6);
+    const std::int32_t c0 = _bboxes[2 * node], c1 = _bboxes[2 * node + 1];
+    if (c0 == c1)
+    {
+      std::ranges::copy(
+          impl_bb::compute_bbox_of_entity<T>(mesh, _tdim, c0, _padding),
+          b.begin());
+      return;
+    }
+
+    // Refit the children. The right child is stored just before the
+    // node and its subtree follows the subtree of the left child.
+    constexpr std::int32_t min_parallel_size = 1024;
+    if (num_threads > 1 and node - first >= min_parallel_size)
+    {
+      common::thread_pool().reserve(num_threads - 1);
+      common::run_tasks(2,
+                        [&](int i)
+                        {
+                          if (i == 0)
+                            refit(mesh, first, c0, num_threads / 2);
+                          else
+                            refit(mesh, c0 + 1, c1,
+                                  num_threads - num_threads / 2);
+                        });
+    }
+    else
+    {
+      refit(mesh, first, c0, 1);
+      refit(mesh, c0 + 1, c1, 1);
+    }
+
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      b[j] = std::min(_bbox_coordinates[6 * c0 + j],
+                      _bbox_coordinates[6 * c1 + j]);
+      b[3 + j] = std::max(_bbox_coordinates[6 * c0 + 3 + j],
+                          _bbox_coordinates[6 * c1 + 3 + j]);
+    }
+  }
+
   // Topological dimension of leaf entities
   int _tdim;
 
+  // Padding of the leaf bounding boxes
+  T _padding = 0;
+
+  // SAH cost of the tree when it was built
+  T _build_cost = 0;
+
   // Print out recursively, for debugging
   void tree_print(std::stringstream& s, std::int32_t i) const
   {
@@ -0,0 +1,350 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "BoundingBoxTree.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/utils.h>
+#include <limits>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::geometry
+{
+
+/// @brief Uniform grid of buckets of the bounding boxes of mesh
+/// entities, for finding the entities whose bounding box collides with
+/// a point.
+///
+/// The bounding box of all entities is divided into a grid of equal
+/// buckets and each entity is listed in the buckets that its bounding
+/// box overlaps. The candidate entities for a point are found in its
+/// bucket in constant time, which is faster than traversing a
+/// BoundingBoxTree for meshes with entities of similar size. For
+/// strongly graded meshes a BoundingBoxTree should be preferred, as the
+/// number of entities per bucket is not bounded.
+///
+/// The bucket size is the mean of the size (mesh::h) of the
+/// entities plus twice the padding, and is increased if needed to limit
+/// the number of buckets to a few times the number of entities.
+///
+/// @tparam T Floating point type
+template <std::floating_point T>
+class GridLocator
+{
+private:
+  static std::vector<std::int32_t> range(mesh::Topology& topology, int dim)
+  {
+    topology.create_entities(dim);
+    auto map = topology.index_map(dim);
+    assert(map);
+    const std::int32_t num_entities = map->size_local() + map->num_ghosts();
+    std::vector<std::int32_t> r(num_entities);
+    std::iota(r.begin(), r.end(), 0);
+    return r;
+  }
+
+public:
+  /// @brief Create a grid locator.
+  /// @param[in] mesh Mesh of the entities.
+  /// @param[in] dim Topological dimension of the entities.
+  /// @param[in] entities Entity indices (local to process), may be
+  /// empty.
+  /// @param[in] padding Value to pad (extend) the bounding box of each
+  /// entity by.
+  /// @param[in] num_threads Number of threads used to build the grid.
+  GridLocator(const mesh::Mesh<T>& mesh, int dim,
+              std::span<const std::int32_t> entities, T padding = 0,
+              int num_threads = 1)
+      : _tdim(dim), _entities(entities.begin(), entities.end()),
+        _entity_bboxes(6 * entities.size())
+  {
+    if (dim < 0 or dim > mesh.topology()->dim())
+    {
+      throw std::runtime_error(
+          "Dimension must be non-negative and less than or "
+          "equal to the topological dimension of the mesh");
+    }
+
+    mesh.topology_mutable()->create_entities(dim);
+    mesh.topology_mutable()->create_connectivity(dim, mesh.topology()->dim());
+
+    // Compute the bounding box of each entity
+    parallel_for(num_threads, entities.size(),
+                 [&](int, std::size_t i0, std::size_t i1)
+                 {
+                   for (std::size_t i = i0; i < i1; ++i)
+                   {
+                     std::array<T, 6> b = impl_bb::compute_bbox_of_entity<T>(
+                         mesh, dim, entities[i], padding);
+                     std::ranges::copy(
+                         b, std::next(_entity_bboxes.begin(), 6 * i));
+                   }
+                 });
+
+    std::vector<T> h = mesh::h(mesh, entities, dim);
+    const T h_mean = entities.empty() ? 0
+                                      : std::reduce(h.begin(), h.end(), T(0))
+                                            / entities.size();
+    build(h_mean + 2 * padding, num_threads);
+
+    DOLFINX_LOG_INFO("Computed grid locator with {}x{}x{} buckets for {} "
+                     "entities",
+                     _shape[0], _shape[1], _shape[2], entities.size());
+  }
+
+  /// @brief Create a grid locator for all entities of a dimension.
+  /// @param[in] mesh Mesh of the entities.
+  /// @param[in] dim Topological dimension of the entities.
+  /// @param[in] padding Value to pad (extend) the bounding box of each
+  /// entity by.
+  /// @param[in] num_threads Number of threads used to build the grid.
+  GridLocator(const mesh::Mesh<T>& mesh, int dim, T padding = 0,
+              int num_threads = 1)
+      : GridLocator(mesh, dim, range(*mesh.topology_mutable(), dim), padding,
+                    num_threads)
+  {
+    // Do nothing
+  }
+
+  /// Topological dimension of the entities
+  int tdim() const { return _tdim; }
+
+  /// @brief Bounding box of all entities.
+  /// @return Bounding box coordinates (lower_corner, upper_corner)
+  std::array<T, 6> bbox() const { return _bbox; }
+
+  /// Number of buckets in each direction
+  std::array<std::size_t, 3> shape() const { return _shape; }
+
+  /// Number of entities
+  std::int32_t num_entities() const { return _entities.size(); }
+
+  /// Entity indices (local to process), in the order of the input
+  std::span<const std::int32_t> entities() const { return _entities; }
+
+  /// @brief Bounding box of an entity.
+  /// @param[in] i Position of the entity in entities()
+  /// @return Bounding box coordinates (lower_corner, upper_corner)
+  std::array<T, 6> get_bbox(std::int32_t i) const
+  {
+    std::array<T, 6> b;
+    std::copy_n(std::next(_entity_bboxes.begin(), 6 * i), 6, b.begin());
+    return b;
+  }
+
+  /// @brief Candidate entities for a point.
+  ///
+  /// Points outside the grid are assigned to the nearest bucket.
+  /// @param[in] x The point
+  /// @return Positions in entities() of the entities in the bucket of
+  /// the point, in increasing order
+  std::span<const std::int32_t> bucket(std::span<const T, 3> x) const
+  {
+    if (_bucket_entities.empty())
+      return {};
+
+    std::size_t b = 0;
+    for (int j = 2; j >= 0; --j)
+      b = b * _shape[j] + index(j, x[j]);
+    return std::span(_bucket_entities.data() + _offsets[b],
+                     _offsets[b + 1] - _offsets[b]);
+  }
+
+  /// @brief Create a bounding box tree of the bounding boxes of the
+  /// entities on all processes.
+  ///
+  /// Collective.
+  /// @param[in] comm MPI communicator
+  /// @return Tree with one leaf per process, see
+  /// BoundingBoxTree::create_global_tree
+  BoundingBoxTree<T> create_global_tree(MPI_Comm comm) const
+  {
+    // The tree of the corners of the bounding box has the same root
+    // box as a tree of the entities
+    std::vector<std::pair<std::array<T, 3>, std::int32_t>> corners;
+    if (!_entities.empty())
+    {
+      corners = {{{_bbox[0], _bbox[1], _bbox[2]}, 0},
+                 {{_bbox[3], _bbox[4], _bbox[5]}, 1}};
+    }
+    return BoundingBoxTree<T>(std::move(corners)).create_global_tree(comm);
+  }
+
+private:
+  // Call f(t, i0, i1) for task t = 0, ..., num_threads - 1 with a
+  // range [i0, i1) of [0, n), on the thread pool. Task 0 runs on the
+  // calling thread.
+  template <typename F>
+  static void parallel_for(int num_threads, std::size_t n, F&& f)
+  {
+    const int nt = std::max(num_threads, 1);
+    common::run_tasks(nt, [&f, n, nt](int t)
+                      { f(t, t * n / nt, (t + 1) * n / nt); });
+  }
+
+  // Create the grid, with a target bucket size h, and insert the
+  // entities from their bounding boxes
+  void build(T h, int num_threads)
+  {
+    const std::size_t num_entities = _entities.size();
+    constexpr T max_val = std::numeric_limits<T>::max();
+    _bbox = {max_val, max_val, max_val, -max_val, -max_val, -max_val};
+    for (std::size_t i = 0; i < num_entities; ++i)
+    {
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        _bbox[j] = std::min(_bbox[j], _entity_bboxes[6 * i + j]);
+        _bbox[3 + j] = std::max(_bbox[3 + j], _entity_bboxes[6 * i + 3 + j]);
+      }
+    }
+    if (num_entities == 0)
+      _bbox.fill(0);
+    create_grid(h);
+
+    // Count the entities in each bucket, per thread
+    const int nt = std::max(num_threads, 1);
+    const std::size_t num_buckets = _shape[0] * _shape[1] * _shape[2];
+    std::vector<std::int32_t> counts(nt * num_buckets, 0);
+    parallel_for(nt, num_entities,
+                 [&](int t, std::size_t i0, std::size_t i1)
+                 {
+                   std::span<std::int32_t> c(counts.data() + t * num_buckets,
+                                             num_buckets);
+                   for (std::size_t i = i0; i < i1; ++i)
+                     for_each_bucket(i, [&c](std::size_t b) { ++c[b]; });
+                 });
+
+    // Offsets of the buckets, and the position of the first entity of
+    // each thread in each bucket. Entities are stored in input order
+    // within each bucket.
+    _offsets.assign(num_buckets + 1, 0);
+    for (std::size_t b = 0; b < num_buckets; ++b)
+    {
+      std::int32_t pos = _offsets[b];
+      for (int t = 0; t < nt; ++t)
+        pos += std::exchange(counts[t * num_buckets + b], pos);
+      _offsets[b + 1] = pos;
+    }
+
+    // Insert the entities into the buckets
+    _bucket_entities.resize(_offsets.back());
+    parallel_for(nt, num_entities,
+                 [&](int t, std::size_t i0, std::size_t i1)
+                 {
+                   std::span<std::int32_t> pos(counts.data() + t * num_buckets,
+                                               num_buckets);
+                   for (std::size_t i = i0; i < i1; ++i)
+                   {
+                     for_each_bucket(i, [this, &pos, i](std::size_t b)
+                                     { _bucket_entities[pos[b]++] = i; });
+                   }
+                 });
+  }
+
+  // Choose the number of buckets and bucket sizes for a target bucket
+  // size h
+  void create_grid(T h)
+  {
+    std::array<T, 3> extent;
+    int num_dirs = 0;
+    T volume = 1;
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      extent[j] = std::max(_bbox[3 + j] - _bbox[j], T(0));
+      if (extent[j] > 0)
+      {
+        ++num_dirs;
+        volume *= extent[j];
+      }
+    }
+
+    // Limit the number of buckets relative to the number of entities
+    const T max_buckets = 4 * T(_entities.size()) + 1;
+    if (num_dirs > 0)
+    {
+      const T h_min = std::pow(volume / max_buckets, T(1) / num_dirs);
+      if (!(h > h_min))
+        h = h_min;
+    }
+
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      _shape[j] = extent[j] > 0
+                      ? std::max<std::size_t>(std::ceil(extent[j] / h), 1)
+                      : 1;
+      _h[j] = extent[j] > 0 ? extent[j] / _shape[j] : 1;
+    }
+  }
+
+  // Bucket index in direction j of coordinate x, clamped to the grid
+  std::size_t index(int j, T x) const
+  {
+    const T i = std::floor((x - _bbox[j]) / _h[j]);
+    if (!(i > 0))
+      return 0;
+    return std::min(static_cast<std::size_t>(i), _shape[j] - 1);
+  }
+
+  // Call f for each bucket that the bounding box of entity i overlaps.
+  // The bounding box is extended by the tolerance of
+  // impl::point_in_bbox, so that every point in the box (with
+  // tolerance) is in one of the buckets.
+  template <typename F>
+  void for_each_bucket(std::size_t i, F&& f) const
+  {
+    constexpr T rtol = 1e-14;
+    std::array<std::size_t, 3> i0, i1;
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      const T b0 = _entity_bboxes[6 * i + j];
+      const T b1 = _entity_bboxes[6 * i + 3 + j];
+      const T eps = rtol * (b1 - b0);
+      i0[j] = index(j, b0 - eps);
+      i1[j] = index(j, b1 + eps);
+    }
+
+    for (std::size_t k = i0[2]; k <= i1[2]; ++k)
+      for (std::size_t l = i0[1]; l <= i1[1]; ++l)
+        for (std::size_t m = i0[0]; m <= i1[0]; ++m)
+          f((k * _shape[1] + l) * _shape[0] + m);
+  }
+
+  // Topological dimension of the entities
+  int _tdim;
+
+  // Entity indices
+  std::vector<std::int32_t> _entities;
+
+  // Bounding box of each entity, shape (num_entities, 6)
+  std::vector<T> _entity_bboxes;
+
+  // Bounding box of all entities
+  std::array<T, 6> _bbox;
+
+  // Number of buckets and bucket size in each direction
+  std::array<std::size_t, 3> _shape;
+  std::array<T, 3> _h;
+
+  // Positions (in _entities) of the entities in each bucket, with
+  // bucket b in [_offsets[b], _offsets[b + 1])
+  std::vector<std::int32_t> _offsets, _bucket_entities;
+};
+
+} // namespace dolfinx::geometry
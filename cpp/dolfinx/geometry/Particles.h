@@ -0,0 +1,626 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "BoundingBoxTree.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <functional>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dolfinx::geometry
+{
+/// @brief Particles in the cells of a mesh, e.g. for particle-in-cell
+/// methods.
+///
+/// Each particle is owned by the process that owns the cell that
+/// contains it. The particles of a process are stored sorted by cell,
+/// as a structure of arrays: the positions (`shape=(num_particles,
+/// 3)`, row-major), the cells and the reference coordinates of the
+/// particles in their cells, and a separate array for each named
+/// field, e.g. velocity or charge.
+///
+/// The positions can be modified, e.g. to advance the particles in
+/// time, after which relocate() must be called to find the new cells
+/// of the particles and send them to the processes that own the cells.
+/// The cells are found by walking from the previous cell of each
+/// particle (see geometry::locate_points), so the cost per particle is
+/// independent of the mesh size when the particles move by less than a
+/// few cells. For meshes with a layer of ghost cells (e.g.
+/// mesh::GhostMode::shared_facet), particles that move into a ghost
+/// cell are sent to the owner of the cell over the neighbourhood
+/// communicator of the cell index map. Other particles that leave the
+/// cells of a process are located with
+/// geometry::determine_point_ownership. Particles that are not in a
+/// cell on any process, e.g. that left the domain, are removed.
+///
+/// Functions are evaluated at the particles, and values at the
+/// particles deposited onto Functions, with evaluation plans
+/// (fem::EvaluationPlan) that are cached for each function space until
+/// the particles are relocated.
+///
+/// @note The mesh must not move while the particles are in use.
+/// @tparam T Scalar type of the mesh geometry, positions and fields.
+template <std::floating_point T>
+class Particles
+{
+public:
+  /// @brief Create particles at points.
+  /// @note Collective.
+  /// @param[in] mesh The mesh
+  /// @param[in] x Positions of the particles created by this process
+  /// (`shape=(num_points, 3)`, row-major). The particles are sent to
+  /// the processes that own their cells. Points that are not in a cell
+  /// of the mesh are ignored.
+  /// @param[in] max_steps Maximum number of cells to walk through when
+  /// locating a particle (see relocate).
+  Particles(std::shared_ptr<const mesh::Mesh<T>> mesh, std::span<const T> x,
+            int max_steps = 16)
+      : _mesh(mesh), _x(x.begin(), x.end()), _cells(x.size() / 3, -1),
+        _tree(create_tree(*mesh))
+  {
+    if (x.size() % 3 != 0)
+      throw std::runtime_error("Particle positions must have shape (n, 3).");
+    relocate(max_steps);
+  }
+
+  // Copy constructor (deleted)
+  Particles(const Particles&) = delete;
+
+  /// Move constructor
+  Particles(Particles&&) = default;
+
+  /// Destructor
+  ~Particles() = default;
+
+  // Copy assignment (deleted)
+  Particles& operator=(const Particles&) = delete;
+
+  /// Move assignment
+  Particles& operator=(Particles&&) = default;
+
+  /// The mesh
+  std::shared_ptr<const mesh::Mesh<T>> mesh() const { return _mesh; }
+
+  /// Number of particles on this process
+  std::size_t num_particles() const { return _cells.size(); }
+
+  /// @brief Positions of the particles (`shape=(num_particles, 3)`,
+  /// row-major).
+  std::span<const T> x() const { return _x; }
+
+  /// @brief Positions of the particles (`shape=(num_particles, 3)`,
+  /// row-major).
+  ///
+  /// After the positions are modified, relocate() must be called before
+  /// the cells, reference coordinates or evaluations are used.
+  std::span<T> x() { return _x; }
+
+  /// @brief The (owned) cell that contains each particle. The cells
+  /// are sorted.
+  std::span<const std::int32_t> cells() const { return _cells; }
+
+  /// @brief Offsets of the particles of each owned cell, i.e. the
+  /// particles in cell `c` are `[cell_offsets()[c], cell_offsets()[c +
+  /// 1])`.
+  std::span<const std::int32_t> cell_offsets() const { return _cell_offsets; }
+
+  /// @brief Reference coordinates of the particles in their cells
+  /// (`shape=(num_particles, tdim)`, row-major).
+  std::span<const T> reference_coordinates() const { return _X; }
+
+  /// @brief Add a field with a value per particle, initialised to zero.
+  /// @param[in] name Name of the field
+  /// @param[in] value_size Number of values per particle
+  void add_field(const std::string& name, int value_size)
+  {
+    if (std::ranges::find(_fields, name, &field_t::name) != _fields.end())
+      throw std::runtime_error("Particle field already exists: " + name);
+    if (value_size < 1)
+      throw std::runtime_error("Field value size must be positive.");
+    _fields.push_back(
+        {name, value_size, std::vector<T>(_cells.size() * value_size, 0)});
+  }
+
+  /// @brief Values of a field (`shape=(num_particles, value_size)`,
+  /// row-major).
+  /// @param[in] name Name of the field
+  std::span<T> field(const std::string& name)
+  {
+    return find_field(name).values;
+  }
+
+  /// @brief Values of a field (`shape=(num_particles, value_size)`,
+  /// row-major).
+  /// @param[in] name Name of the field
+  std::span<const T> field(const std::string& name) const
+  {
+    return const_cast<Particles*>(this)->find_field(name).values;
+  }
+
+  /// @brief Number of values per particle of a field.
+  /// @param[in] name Name of the field
+  int field_value_size(const std::string& name) const
+  {
+    return const_cast<Particles*>(this)->find_field(name).value_size;
+  }
+
+  /// @brief Find the cells of the particles after their positions were
+  /// modified, and send the particles to the processes that own the
+  /// cells.
+  ///
+  /// The particles are then sorted by cell, and their reference
+  /// coordinates are recomputed. Particles that are not in a cell on
+  /// any process are removed, with their field values.
+  ///
+  /// @note Collective.
+  /// @param[in] max_steps Maximum number of cells to walk through from
+  /// the previous cell of a particle before the bounding box tree is
+  /// searched.
+  void relocate(int max_steps = 16)
+  {
+    auto topology = _mesh->topology();
+    assert(topology);
+    auto cell_map = topology->index_map(topology->dim());
+    assert(cell_map);
+    const std::int32_t num_owned = cell_map->size_local();
+    MPI_Comm comm = _mesh->comm();
+    const int rank = dolfinx::MPI::rank(comm);
+    const std::size_t num_particles = _cells.size();
+
+    // Locate the particles in the owned and ghost cells, walking from
+    // their previous cells
+    std::vector<std::int32_t> cells
+        = locate_points<T>(*_mesh, _tree, _x, _cells, max_steps).first;
+
+    // Destination rank of each particle, and the global index of the
+    // cell of the particles that are in ghost cells
+    std::vector<int> dest(num_particles, rank);
+    std::vector<std::int64_t> guess(num_particles, -1);
+    std::vector<std::int32_t> lost;
+    std::span<const int> owners = cell_map->owners();
+    std::span<const std::int64_t> ghosts = cell_map->ghosts();
+    for (std::size_t p = 0; p < num_particles; ++p)
+    {
+      if (cells[p] >= num_owned)
+      {
+        dest[p] = owners[cells[p] - num_owned];
+        guess[p] = ghosts[cells[p] - num_owned];
+      }
+      else if (cells[p] < 0)
+        lost.push_back(p);
+    }
+
+    // Find the owners of the particles that are not in a cell or ghost
+    // cell of this process. The particles are sent over a
+    // communicator with edges to the owners, since these are not
+    // neighbours in general.
+    std::int64_t num_lost = lost.size();
+    MPI_Allreduce(MPI_IN_PLACE, &num_lost, 1, MPI_INT64_T, MPI_SUM, comm);
+    std::optional<dolfinx::MPI::Comm> lost_comm;
+    if (num_lost > 0)
+    {
+      std::vector<T> x_lost(3 * lost.size());
+      for (std::size_t i = 0; i < lost.size(); ++i)
+      {
+        std::copy_n(std::next(_x.begin(), 3 * lost[i]), 3,
+                    std::next(x_lost.begin(), 3 * i));
+      }
+      PointOwnershipData<T> ownership
+          = determine_point_ownership<T>(*_mesh, x_lost, T(0));
+      for (std::size_t i = 0; i < lost.size(); ++i)
+        dest[lost[i]] = ownership.src_owner[i];
+
+      std::vector<int> out_ranks;
+      std::ranges::copy_if(dest, std::back_inserter(out_ranks),
+                           [rank](int r) { return r >= 0 and r != rank; });
+      std::ranges::sort(out_ranks);
+      auto [last, end] = std::ranges::unique(out_ranks);
+      out_ranks.erase(last, end);
+      std::vector<int> in_ranks
+          = dolfinx::MPI::compute_graph_edges_nbx(comm, out_ranks);
+      std::ranges::sort(in_ranks);
+
+      MPI_Comm c;
+      MPI_Dist_graph_create_adjacent(
+          comm, in_ranks.size(), in_ranks.data(), MPI_UNWEIGHTED,
+          out_ranks.size(), out_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+          false, &c);
+      lost_comm.emplace(c, false);
+    }
+
+    migrate(lost_comm ? lost_comm->comm() : cell_map->neighbourhood_comms()[0],
+            dest, guess, cells, max_steps);
+  }
+
+  /// @brief Evaluate a Function at the particles.
+  /// @note Not collective. The evaluation plan of the function space is
+  /// created on the first call and cached until the particles are
+  /// relocated, so this function must not be called concurrently.
+  /// @param[in] u Function on the mesh of the particles
+  /// @param[out] values Values at the particles (`shape=(num_particles,
+  /// value_size)`, row-major).
+  /// @param[in] num_threads Number of threads to use.
+  template <dolfinx::scalar S>
+  void eval(const fem::Function<S, T>& u, std::span<S> values,
+            int num_threads = 1) const
+  {
+    plan(u.function_space()).eval(u, values, num_threads);
+  }
+
+  /// @brief Deposit values at the particles onto a Function.
+  ///
+  /// The basis function values at the particles, weighted by the values,
+  /// are added to the degrees-of-freedom of `u`, i.e. `u_i += sum_p
+  /// phi_i(x_p) values_p`, and the contributions to ghost
+  /// degrees-of-freedom are summed on their owners. This is the
+  /// right-hand side of the L2 projection of the particle values, e.g.
+  /// a charge density.
+  ///
+  /// @note Collective. On return, the ghost entries of `u` are updated.
+  /// @param[in] values Values at the particles (`shape=(num_particles,
+  /// value_size)`, row-major).
+  /// @param[in,out] u Function on the mesh of the particles
+  template <dolfinx::scalar S>
+  void scatter_rev(std::span<const S> values, fem::Function<S, T>& u) const
+  {
+    la::Vector<S>& x = *u.x();
+    const std::int32_t size_local = x.bs() * x.index_map()->size_local();
+    std::ranges::fill(x.mutable_array().subspan(size_local), S(0));
+    plan(u.function_space()).eval_adjoint(values, u);
+    x.scatter_rev(std::plus<S>());
+    x.scatter_fwd();
+  }
+
+private:
+  // Named field of values at the particles
+  struct field_t
+  {
+    std::string name;
+    int value_size;
+    std::vector<T> values;
+  };
+
+  // Bounding box tree of the owned and ghost cells
+  static BoundingBoxTree<T> create_tree(const mesh::Mesh<T>& mesh)
+  {
+    const int tdim = mesh.topology()->dim();
+    auto cell_map = mesh.topology()->index_map(tdim);
+    std::vector<std::int32_t> cells(cell_map->size_local()
+                                    + cell_map->num_ghosts());
+    std::iota(cells.begin(), cells.end(), 0);
+    return BoundingBoxTree<T>(mesh, tdim, cells);
+  }
+
+  field_t& find_field(const std::string& name)
+  {
+    auto it = std::ranges::find(_fields, name, &field_t::name);
+    if (it == _fields.end())
+      throw std::runtime_error("Particle field not found: " + name);
+    return *it;
+  }
+
+  // Cached evaluation plan of a function space
+  const fem::EvaluationPlan<T>&
+  plan(std::shared_ptr<const fem::FunctionSpace<T>> V) const
+  {
+    if (V->mesh() != _mesh)
+      throw std::runtime_error("Function is not on the particle mesh.");
+    auto it = std::ranges::find_if(
+        _plans, [&V](auto& p) { return p.function_space() == V; });
+    if (it != _plans.end())
+      return *it;
+    return _plans.emplace_back(V, std::span<const T>(_x), _cells);
+  }
+
+  // Send the particles to their destination ranks over a neighbourhood
+  // communicator, and locate the received particles. `dest` is the
+  // destination rank of each particle (-1 to remove it), `guess` the
+  // global index of its cell if known, and `cells` the local cell of
+  // the particles that stay on this process (-1 if not known).
+  void migrate(MPI_Comm comm, std::span<const int> dest,
+               std::span<const std::int64_t> guess,
+               std::span<const std::int32_t> cells, int max_steps)
+  {
+    const int rank = dolfinx::MPI::rank(_mesh->comm());
+    auto cell_map = _mesh->topology()->index_map(_mesh->topology()->dim());
+    const std::int32_t num_owned = cell_map->size_local();
+    const std::int64_t offset = cell_map->local_range()[0];
+    const std::size_t num_particles = _cells.size();
+
+    int indegree(-1), outdegree(-2), weighted(-1);
+    MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+    std::vector<int> src(indegree), dst(outdegree);
+    MPI_Dist_graph_neighbors(comm, indegree, src.data(), MPI_UNWEIGHTED,
+                             outdegree, dst.data(), MPI_UNWEIGHTED);
+    assert(std::ranges::is_sorted(dst));
+
+    // Number of values of a particle: the position and field values
+    std::size_t stride = 3;
+    for (const field_t& f : _fields)
+      stride += f.value_size;
+
+    // Neighbour that each particle is sent to
+    std::vector<int> nbr(num_particles, -1);
+    std::vector<std::int32_t> send_sizes(outdegree, 0);
+    for (std::size_t p = 0; p < num_particles; ++p)
+    {
+      if (dest[p] >= 0 and dest[p] != rank)
+      {
+        auto it = std::ranges::lower_bound(dst, dest[p]);
+        assert(it != dst.end() and *it == dest[p]);
+        nbr[p] = std::distance(dst.begin(), it);
+        ++send_sizes[nbr[p]];
+      }
+    }
+
+    std::vector<std::int32_t> recv_sizes(indegree);
+    send_sizes.reserve(1);
+    recv_sizes.reserve(1);
+    MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT32_T,
+                          recv_sizes.data(), 1, MPI_INT32_T, comm);
+    std::vector<std::int32_t> send_offsets(outdegree + 1, 0),
+        recv_offsets(indegree + 1, 0);
+    std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                     std::next(send_offsets.begin()));
+    std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                     std::next(recv_offsets.begin()));
+
+    // Values of particle p, packed at the pointer v, or unpacked from
+    // the pointer v if `pack` is false
+    auto copy_values = [this](std::vector<std::vector<T>>& fields,
+                              std::vector<T>& x, std::size_t p, T* v,
+                              bool pack)
+    {
+      auto copy = [pack](T* a, T* b, std::size_t n)
+      { pack ? std::copy_n(a, n, b) : std::copy_n(b, n, a); };
+      copy(x.data() + 3 * p, v, 3);
+      v += 3;
+      for (std::size_t i = 0; i < _fields.size(); ++i)
+      {
+        const std::size_t vs = _fields[i].value_size;
+        copy(fields[i].data() + vs * p, v, vs);
+        v += vs;
+      }
+    };
+
+    std::vector<std::vector<T>> fields(_fields.size());
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+      fields[i] = std::move(_fields[i].values);
+
+    std::vector<std::int64_t> send_guess(send_offsets.back());
+    std::vector<T> send_values(stride * send_offsets.back());
+    {
+      std::vector<std::int32_t> pos(send_offsets.begin(),
+                                    std::prev(send_offsets.end()));
+      for (std::size_t p = 0; p < num_particles; ++p)
+      {
+        if (nbr[p] >= 0)
+        {
+          const std::int32_t k = pos[nbr[p]]++;
+          send_guess[k] = guess[p];
+          copy_values(fields, _x, p, send_values.data() + stride * k, true);
+        }
+      }
+    }
+
+    std::vector<std::int64_t> recv_guess(recv_offsets.back());
+    MPI_Neighbor_alltoallv(send_guess.data(), send_sizes.data(),
+                           send_offsets.data(), MPI_INT64_T,
+                           recv_guess.data(), recv_sizes.data(),
+                           recv_offsets.data(), MPI_INT64_T, comm);
+    for (auto s : {&send_sizes, &send_offsets, &recv_sizes, &recv_offsets})
+      std::ranges::transform(*s, s->begin(), [stride](auto n)
+                             { return n * stride; });
+    std::vector<T> recv_values(recv_offsets.back());
+    MPI_Neighbor_alltoallv(send_values.data(), send_sizes.data(),
+                           send_offsets.data(), dolfinx::MPI::mpi_type<T>(),
+                           recv_values.data(), recv_sizes.data(),
+                           recv_offsets.data(), dolfinx::MPI::mpi_type<T>(),
+                           comm);
+
+    // The particles that stay on this process, followed by the
+    // received particles
+    std::vector<std::int32_t> keep;
+    for (std::size_t p = 0; p < num_particles; ++p)
+      if (dest[p] == rank)
+        keep.push_back(p);
+    const std::size_t num_recv = recv_guess.size();
+    const std::size_t num_new = keep.size() + num_recv;
+    std::vector<T> x(3 * num_new);
+    std::vector<std::vector<T>> new_fields(_fields.size());
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+      new_fields[i].resize(num_new * _fields[i].value_size);
+    std::vector<std::int32_t> new_cells(num_new, -1);
+    std::vector<T> v(stride);
+    for (std::size_t a = 0; a < keep.size(); ++a)
+    {
+      copy_values(fields, _x, keep[a], v.data(), true);
+      copy_values(new_fields, x, a, v.data(), false);
+      new_cells[a] = cells[keep[a]];
+    }
+    for (std::size_t r = 0; r < num_recv; ++r)
+    {
+      const std::size_t a = keep.size() + r;
+      copy_values(new_fields, x, a, recv_values.data() + stride * r, false);
+      if (recv_guess[r] >= 0)
+        new_cells[a] = recv_guess[r] - offset;
+    }
+
+    // Locate the received particles, and the particles that stay on
+    // this process without a known cell, in the owned cells
+    std::vector<std::int32_t> unlocated;
+    for (std::size_t a = 0; a < num_new; ++a)
+      if (a >= keep.size() or new_cells[a] < 0)
+        unlocated.push_back(a);
+    if (!unlocated.empty())
+    {
+      std::vector<T> xu(3 * unlocated.size());
+      std::vector<std::int32_t> gu(unlocated.size());
+      for (std::size_t i = 0; i < unlocated.size(); ++i)
+      {
+        std::copy_n(std::next(x.begin(), 3 * unlocated[i]), 3,
+                    std::next(xu.begin(), 3 * i));
+        gu[i] = new_cells[unlocated[i]];
+      }
+      std::vector<std::int32_t> cu
+          = locate_points<T>(*_mesh, _tree, xu, gu, max_steps).first;
+      for (std::size_t i = 0; i < unlocated.size(); ++i)
+        new_cells[unlocated[i]] = cu[i];
+    }
+
+    // Sort the particles by cell (counting sort), removing the
+    // particles that are not in an owned cell
+    _cell_offsets.assign(num_owned + 1, 0);
+    for (std::int32_t c : new_cells)
+      if (c >= 0 and c < num_owned)
+        ++_cell_offsets[c + 1];
+    std::partial_sum(_cell_offsets.begin(), _cell_offsets.end(),
+                     _cell_offsets.begin());
+    const std::size_t num_sorted = _cell_offsets.back();
+    _x.resize(3 * num_sorted);
+    _cells.resize(num_sorted);
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+      _fields[i].values.resize(num_sorted * _fields[i].value_size);
+    {
+      std::vector<std::int32_t> pos(_cell_offsets.begin(),
+                                    std::prev(_cell_offsets.end()));
+      for (std::size_t a = 0; a < num_new; ++a)
+      {
+        const std::int32_t c = new_cells[a];
+        if (c < 0 or c >= num_owned)
+          continue;
+        const std::int32_t p = pos[c]++;
+        _cells[p] = c;
+        std::copy_n(std::next(x.begin(), 3 * a), 3,
+                    std::next(_x.begin(), 3 * p));
+        for (std::size_t i = 0; i < _fields.size(); ++i)
+        {
+          const std::size_t vs = _fields[i].value_size;
+          std::copy_n(std::next(new_fields[i].begin(), vs * a), vs,
+                      std::next(_fields[i].values.begin(), vs * p));
+        }
+      }
+    }
+
+    compute_reference_coordinates();
+    _plans.clear();
+  }
+
+  // Pull back the particles to the reference cell, one cell at a time
+  void compute_reference_coordinates()
+  {
+    namespace md = MDSPAN_IMPL_STANDARD_NAMESPACE;
+    using cmap_t = fem::CoordinateElement<T>;
+    using mdspan2_t = typename cmap_t::template mdspan2_t<T>;
+    using cmdspan2_t = typename cmap_t::template mdspan2_t<const T>;
+
+    const mesh::Geometry<T>& geometry = _mesh->geometry();
+    const std::size_t gdim = geometry.dim();
+    const std::size_t tdim = _mesh->topology()->dim();
+    const cmap_t& cmap = geometry.cmap();
+    std::span<const T> x_g = geometry.x();
+    auto x_dofmap = geometry.dofmap();
+    const std::size_t num_dofs_g = x_dofmap.extent(1);
+    std::vector<T> coord_dofs_b(num_dofs_g * gdim);
+    mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+
+    // Derivatives of the geometry basis at the reference origin, for
+    // affine maps
+    std::array<std::size_t, 4> phi0_shape = cmap.tabulate_shape(1, 1);
+    std::vector<T> phi0_b(std::reduce(phi0_shape.begin(), phi0_shape.end(),
+                                      1, std::multiplies{}));
+    md::mdspan<const T, md::dextents<std::size_t, 4>> phi0(phi0_b.data(),
+                                                            phi0_shape);
+    if (cmap.is_affine())
+      cmap.tabulate(1, std::vector<T>(tdim), {1, tdim}, phi0_b);
+    auto dphi0
+        = md::submdspan(phi0, std::pair(1, tdim + 1), 0, md::full_extent, 0);
+    std::vector<T> J_b(gdim * tdim), K_b(tdim * gdim);
+    mdspan2_t J(J_b.data(), gdim, tdim);
+    mdspan2_t K(K_b.data(), tdim, gdim);
+
+    _X.assign(_cells.size() * tdim, 0);
+    std::vector<T> xp_b;
+    for (std::size_t c = 0; c + 1 < _cell_offsets.size(); ++c)
+    {
+      const std::int32_t p0 = _cell_offsets[c];
+      const std::size_t np = _cell_offsets[c + 1] - p0;
+      if (np == 0)
+        continue;
+
+      auto x_dofs = md::submdspan(x_dofmap, c, md::full_extent);
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
+          coord_dofs(i, j) = x_g[3 * x_dofs[i] + j];
+      xp_b.resize(np * gdim);
+      for (std::size_t p = 0; p < np; ++p)
+        for (std::size_t j = 0; j < gdim; ++j)
+          xp_b[p * gdim + j] = _x[3 * (p0 + p) + j];
+
+      mdspan2_t X(_X.data() + p0 * tdim, np, tdim);
+      cmdspan2_t xp(xp_b.data(), np, gdim);
+      if (cmap.is_affine())
+      {
+        cmap_t::compute_jacobian(dphi0, coord_dofs, J);
+        cmap_t::compute_jacobian_inverse(J, K);
+        std::array<T, 3> x0 = {0, 0, 0};
+        for (std::size_t j = 0; j < gdim; ++j)
+          x0[j] = coord_dofs(0, j);
+        cmap_t::pull_back_affine(X, K, x0, xp);
+      }
+      else
+      {
+        cmap.pull_back_nonaffine(
+            X, xp, cmdspan2_t(coord_dofs_b.data(), num_dofs_g, gdim));
+      }
+    }
+  }
+
+  // The mesh
+  std::shared_ptr<const mesh::Mesh<T>> _mesh;
+
+  // Positions (shape=(num_particles, 3))
+  std::vector<T> _x;
+
+  // Cell of each particle
+  std::vector<std::int32_t> _cells;
+
+  // Offsets of the particles of each owned cell
+  std::vector<std::int32_t> _cell_offsets;
+
+  // Reference coordinates (shape=(num_particles, tdim))
+  std::vector<T> _X;
+
+  // Named fields
+  std::vector<field_t> _fields;
+
+  // Bounding box tree of the owned and ghost cells
+  BoundingBoxTree<T> _tree;
+
+  // Evaluation plans, cached until the particles are relocated
+  mutable std::vector<fem::EvaluationPlan<T>> _plans;
+};
+} // namespace dolfinx::geometry
@@ -0,0 +1,302 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "BoundingBoxTree.h"
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dolfinx::geometry
+{
+
+/// @brief Axis-aligned bounding box tree where each node has up to `W`
+/// children.
+///
+/// The tree is created by collapsing the levels of a (binary)
+/// BoundingBoxTree. The bounding boxes of the children of a node are
+/// stored contiguously by coordinate (structure-of-arrays), so a point
+/// or a box is tested against all children of a node in one pass of
+/// fixed length `W` that the compiler can vectorise. The tree is
+/// shallower than the binary tree and its nodes are visited with fewer
+/// memory accesses, which makes it faster for large numbers of point
+/// queries.
+///
+/// @tparam T Floating point type
+/// @tparam W Maximum number of children of a node
+template <std::floating_point T, int W = 4>
+  requires(W >= 2)
+class WideBoundingBoxTree
+{
+public:
+  /// @brief A node of the tree.
+  struct Node
+  {
+    /// Lower corner of the bounding box of each child, by coordinate
+    std::array<std::array<T, W>, 3> x0;
+
+    /// Upper corner of the bounding box of each child, by coordinate
+    std::array<std::array<T, W>, 3> x1;
+
+    /// Index of each child node, or `-(entity + 1)` for a leaf
+    std::array<std::int32_t, W> child;
+
+    /// Number of children
+    int size;
+  };
+
+  /// @brief Create a wide tree from a binary tree.
+  /// @param[in] tree Binary bounding box tree
+  explicit WideBoundingBoxTree(const BoundingBoxTree<T>& tree)
+      : _tdim(tree.tdim()), _bbox{}
+  {
+    if (tree.num_bboxes() > 0)
+    {
+      _bbox = tree.get_bbox(tree.num_bboxes() - 1);
+      _nodes.reserve(tree.num_bboxes() / (W - 1) + 1);
+      collapse(tree, tree.num_bboxes() - 1);
+    }
+  }
+
+  /// @brief Bounding box of the tree.
+  /// @return Bounding box coordinates (lower_corner, upper_corner)
+  std::array<T, 6> bbox() const { return _bbox; }
+
+  /// Nodes of the tree. The root node is the first node.
+  std::span<const Node> nodes() const { return _nodes; }
+
+  /// Number of nodes
+  std::int32_t num_nodes() const { return _nodes.size(); }
+
+  /// Topological dimension of leaf entities
+  int tdim() const { return _tdim; }
+
+private:
+  // Create the node for binary node `node` (which is not a leaf),
+  // collapsing the W - 1 internal nodes below it with the largest boxes.
+  // Returns the index of the new node.
+  std::int32_t collapse(const BoundingBoxTree<T>& tree, std::int32_t node)
+  {
+    // Binary nodes of the children, in order
+    std::vector<std::int32_t> children;
+    if (std::array<std::int32_t, 2> b = tree.bbox(node); b[0] == b[1])
+      children = {node};
+    else
+      children = {b[0], b[1]};
+
+    auto measure = [&tree](std::int32_t n)
+    {
+      std::array<T, 6> b = tree.get_bbox(n);
+      return (b[3] - b[0]) + (b[4] - b[1]) + (b[5] - b[2]);
+    };
+    while (children.size() < W)
+    {
+      // Expand the internal child with the largest box
+      int k = -1;
+      for (std::size_t i = 0; i < children.size(); ++i)
+      {
+        std::array<std::int32_t, 2> b = tree.bbox(children[i]);
+        if (b[0] != b[1]
+            and (k < 0 or measure(children[i]) > measure(children[k])))
+        {
+          k = i;
+        }
+      }
+      if (k < 0)
+        break;
+
+      std::array<std::int32_t, 2> b = tree.bbox(children[k]);
+      children[k] = b[1];
+      children.insert(std::next(children.begin(), k), b[0]);
+    }
+
+    const std::int32_t index = _nodes.size();
+    _nodes.push_back({});
+    Node wnode{};
+    wnode.size = children.size();
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+      std::array<T, 6> b = tree.get_bbox(children[i]);
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        wnode.x0[j][i] = b[j];
+        wnode.x1[j][i] = b[3 + j];
+      }
+
+      std::array<std::int32_t, 2> c = tree.bbox(children[i]);
+      wnode.child[i]
+          = c[0] == c[1] ? -(c[1] + 1) : collapse(tree, children[i]);
+    }
+    _nodes[index] = wnode;
+
+    return index;
+  }
+
+  // Topological dimension of leaf entities
+  int _tdim;
+
+  // Bounding box of the root
+  std::array<T, 6> _bbox;
+
+  // Nodes, with the root first
+  std::vector<Node> _nodes;
+};
+
+namespace impl_wide
+{
+/// @brief Test a point against the child boxes of a node.
+///
+/// Uses the same relative tolerance as impl::point_in_bbox.
+/// @return `in[i]` is non-zero if the point is in the box of child `i`
+template <std::floating_point T, int W>
+std::array<std::int8_t, W>
+point_in_bboxes(const typename WideBoundingBoxTree<T, W>::Node& node,
+                std::span<const T, 3> x)
+{
+  constexpr T rtol = 1e-14;
+  std::array<std::int8_t, W> in;
+  for (int i = 0; i < W; ++i)
+  {
+    bool hit = i < node.size;
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      const T eps = rtol * (node.x1[j][i] - node.x0[j][i]);
+      hit &= x[j] >= node.x0[j][i] - eps;
+      hit &= x[j] <= node.x1[j][i] + eps;
+    }
+    in[i] = hit;
+  }
+  return in;
+}
+
+/// @brief Test a box against the child boxes of a node.
+///
+/// Uses the same relative tolerance as impl::bbox_in_bbox, where the
+/// tolerance is relative to the size of the child boxes if
+/// `child_tolerance` is true and else to the size of `b`.
+/// @return `in[i]` is non-zero if box `b` overlaps the box of child `i`
+template <std::floating_point T, int W>
+std::array<std::int8_t, W>
+bbox_in_bboxes(const typename WideBoundingBoxTree<T, W>::Node& node,
+               const std::array<T, 6>& b, bool child_tolerance)
+{
+  constexpr T rtol = 1e-14;
+  std::array<std::int8_t, W> in;
+  for (int i = 0; i < W; ++i)
+  {
+    bool hit = i < node.size;
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      const T eps = child_tolerance
+                        ? rtol * (node.x1[j][i] - node.x0[j][i])
+                        : rtol * (b[3 + j] - b[j]);
+      hit &= node.x1[j][i] >= b[j] - eps;
+      hit &= node.x0[j][i] <= b[3 + j] + eps;
+    }
+    in[i] = hit;
+  }
+  return in;
+}
+
+/// @brief Compute the leaves of a tree that collide with a point.
+///
+/// Leaves are found in the same order as for the binary tree that the
+/// wide tree was created from.
+/// @param[in] tree The tree
+/// @param[in] p The point
+/// @param[in, out] stack Workspace
+/// @param[in, out] entities The list of colliding entities
+template <std::floating_point T, int W>
+void compute_collisions_point(const WideBoundingBoxTree<T, W>& tree,
+                              std::span<const T, 3> p,
+                              std::vector<std::int32_t>& stack,
+                              std::vector<std::int32_t>& entities)
+{
+  std::span nodes = tree.nodes();
+  stack.assign(1, 0);
+  while (!stack.empty())
+  {
+    const std::int32_t n = stack.back();
+    stack.pop_back();
+    if (n < 0)
+    {
+      // Leaf
+      entities.push_back(-(n + 1));
+      continue;
+    }
+
+    // Visit colliding children in order
+    const std::array<std::int8_t, W> in = point_in_bboxes<T, W>(nodes[n], p);
+    for (int i = W - 1; i >= 0; --i)
+      if (in[i])
+        stack.push_back(nodes[n].child[i]);
+  }
+}
+
+/// @brief Compute collisions between the subtrees of two trees
+/// (recursive).
+///
+/// A subtree is given by a child index, i.e. a node index or `-(entity
+/// + 1)` for a leaf, and its bounding box. The bounding boxes must
+/// collide.
+template <std::floating_point T, int W>
+void compute_collisions_tree(const WideBoundingBoxTree<T, W>& A,
+                             const WideBoundingBoxTree<T, W>& B,
+                             std::int32_t a, const std::array<T, 6>& box_a,
+                             std::int32_t b, const std::array<T, 6>& box_b,
+                             std::vector<std::int32_t>& entities)
+{
+  auto bbox = [](auto& node, int i)
+  {
+    return std::array<T, 6>{node.x0[0][i], node.x0[1][i], node.x0[2][i],
+                            node.x1[0][i], node.x1[1][i], node.x1[2][i]};
+  };
+
+  if (a < 0 and b < 0)
+  {
+    // Both are leaves
+    entities.push_back(-(a + 1));
+    entities.push_back(-(b + 1));
+  }
+  else if (b < 0 or (a >= 0 and a < b))
+  {
+    // Descend A. Nodes are stored in pre-order, so the subtree with the
+    // lower index is the larger one.
+    auto& node = A.nodes()[a];
+    const std::array<std::int8_t, W> in
+        = bbox_in_bboxes<T, W>(node, box_b, false);
+    for (int i = 0; i < W; ++i)
+    {
+      if (in[i])
+      {
+        compute_collisions_tree(A, B, node.child[i], bbox(node, i), b, box_b,
+                                entities);
+      }
+    }
+  }
+  else
+  {
+    // Descend B
+    auto& node = B.nodes()[b];
+    const std::array<std::int8_t, W> in
+        = bbox_in_bboxes<T, W>(node, box_a, true);
+    for (int i = 0; i < W; ++i)
+    {
+      if (in[i])
+      {
+        compute_collisions_tree(A, B, a, box_a, node.child[i], bbox(node, i),
+                                entities);
+      }
+    }
+  }
+}
+} // namespace impl_wide
+
+} // namespace dolfinx::geometry
@@ -10,4 +10,7 @@ namespace dolfinx::geometry
 // DOLFINx geometry interface
 
 #include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/GridLocator.h>
+#include <dolfinx/geometry/Particles.h>
+#include <dolfinx/geometry/WideBoundingBoxTree.h>
 #include <dolfinx/geometry/gjk.h>
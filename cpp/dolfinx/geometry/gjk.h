@@ -8,13 +8,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <cmath>
 #include <concepts>
 #include <dolfinx/common/math.h>
 #include <limits>
 #include <numeric>
+#include <optional>
 #include <span>
+#include <stdexcept>
 #include <utility>
-#include <vector>
 
 namespace dolfinx::geometry
 {
@@ -22,12 +25,35 @@ namespace dolfinx::geometry
 namespace impl_gjk
 {
 
+/// @brief Simplex with up to four vertices, stored without heap
+/// allocation.
+template <std::floating_point T>
+struct Simplex
+{
+  /// @brief Create a simplex from a list of vertices.
+  /// @param[in] s Vertex coordinates, shape (size, 3). Row-major
+  /// storage.
+  explicit Simplex(std::span<const T> s) : size(s.size() / 3)
+  {
+    assert(s.size() <= x.size());
+    std::ranges::copy(s, x.begin());
+  }
+
+  /// Vertex coordinates, shape (size, 3). Row-major storage.
+  std::span<const T> vertices() const { return std::span(x.data(), 3 * size); }
+
+  /// Vertex storage
+  std::array<T, 12> x;
+
+  /// Number of vertices
+  std::size_t size;
+};
+
 /// @brief Find the resulting sub-simplex of the input simplex which is
 /// nearest to the origin. Also, return the shortest vector from the
 /// origin to the resulting simplex.
 template <std::floating_point T>
-std::pair<std::vector<T>, std::array<T, 3>>
-nearest_simplex(std::span<const T> s)
+std::pair<Simplex<T>, std::array<T, 3>> nearest_simplex(std::span<const T> s)
 {
   assert(s.size() % 3 == 0);
   const std::size_t s_rows = s.size() / 3;
@@ -47,13 +73,13 @@ nearest_simplex(std::span<const T> s)
       // v = s0 + lm * (s1 - s0);
       std::array v
           = {s0[0] + lm * ds[0], s0[1] + lm * ds[1], s0[2] + lm * ds[2]};
-      return {std::vector<T>(s.begin(), s.end()), v};
+      return {Simplex<T>(s), v};
     }
 
     if (lm < 0.0)
-      return {std::vector<T>(s0.begin(), s0.end()), {s0[0], s0[1], s0[2]}};
+      return {Simplex<T>(s0), {s0[0], s0[1], s0[2]}};
     else
-      return {std::vector<T>(s1.begin(), s1.end()), {s1[0], s1[1], s1[2]}};
+      return {Simplex<T>(s1), {s1[0], s1[1], s1[2]}};
   }
   case 3:
   {
@@ -107,7 +133,7 @@ nearest_simplex(std::span<const T> s)
       for (std::size_t i = 0; i < 3; ++i)
         v[i] *= sum / vnorm2;
 
-      return {std::vector(s.begin(), s.end()), v};
+      return {Simplex<T>(s), v};
     }
 
     // Get closest point
@@ -131,7 +157,7 @@ nearest_simplex(std::span<const T> s)
     for (std::size_t k = 0; k < 3; ++k)
       qmin += vmin[k] * vmin[k];
 
-    std::vector smin = {vmin[0], vmin[1], vmin[2]};
+    Simplex<T> smin(std::span<const T>(vmin.data(), 3));
 
     // Check if edges are closer
     constexpr int f[3][2] = {{0, 1}, {0, 2}, {1, 2}};
@@ -151,15 +177,13 @@ nearest_simplex(std::span<const T> s)
         {
           std::ranges::copy(v, vmin.begin());
           qmin = qnorm;
-          smin.resize(2 * 3);
-          std::span<T, 3> smin0(smin.data(), 3);
-          std::ranges::copy(s0, smin0.begin());
-          std::span<T, 3> smin1(smin.data() + 3, 3);
-          std::ranges::copy(s1, smin1.begin());
+          smin.size = 2;
+          std::ranges::copy(s0, smin.x.begin());
+          std::ranges::copy(s1, std::next(smin.x.begin(), 3));
         }
       }
     }
-    return {std::move(smin), vmin};
+    return {smin, vmin};
   }
   case 4:
   {
@@ -184,17 +208,17 @@ nearest_simplex(std::span<const T> s)
     if (f_inside[1] and f_inside[2] and f_inside[3])
     {
       if (f_inside[0]) // The origin is inside the tetrahedron
-        return {std::vector<T>(s.begin(), s.end()), {0, 0, 0}};
+        return {Simplex<T>(s), {0, 0, 0}};
       else // The origin projection P faces BCD
         return nearest_simplex<T>(s.template subspan<0, 3 * 3>());
     }
 
     // Test ACD, ABD and/or ABC
-    std::vector<T> smin;
+    Simplex<T> smin(std::span<const T>{});
     std::array<T, 3> vmin = {0, 0, 0};
     constexpr int facets[3][3] = {{0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
     T qmin = std::numeric_limits<T>::max();
-    std::vector<T> M(9);
+    std::array<T, 9> M;
     for (int i = 0; i < 3; ++i)
     {
       if (f_inside[i + 1] == false)
@@ -205,7 +229,7 @@ nearest_simplex(std::span<const T> s)
         std::copy_n(std::next(s.begin(), 3 * facets[i][2]), 3,
                     std::next(M.begin(), 6));
 
-        const auto [snew, v] = nearest_simplex<T>(M);
+        const auto [snew, v] = nearest_simplex<T>(std::span<const T>(M));
         T q = std::transform_reduce(v.begin(), v.end(), v.begin(), 0);
         if (q < qmin)
         {
@@ -266,7 +290,7 @@ std::array<T, 3> compute_distance_gjk(std::span<const T> p,
 
   // Initialise vector and simplex
   std::array<T, 3> v = {p[0] - q[0], p[1] - q[1], p[2] - q[2]};
-  std::vector<T> s = {v[0], v[1], v[2]};
+  impl_gjk::Simplex<T> s(std::span<const T>(v.data(), 3));
 
   // Begin GJK iteration
   int k;
@@ -278,16 +302,15 @@ std::array<T, 3> compute_distance_gjk(std::span<const T> p,
     const std::array w = {w1[0] - w0[0], w1[1] - w0[1], w1[2] - w0[2]};
 
     // Break if any existing points are the same as w
-    assert(s.size() % 3 == 0);
     std::size_t m;
-    for (m = 0; m < s.size() / 3; ++m)
+    for (m = 0; m < s.size; ++m)
     {
-      auto it = std::next(s.begin(), 3 * m);
+      auto it = std::next(s.x.begin(), 3 * m);
       if (std::equal(it, std::next(it, 3), w.begin(), w.end()))
         break;
     }
 
-    if (m != s.size() / 3)
+    if (m != s.size)
       break;
 
     // 1st exit condition (v - w).v = 0
@@ -297,12 +320,13 @@ std::array<T, 3> compute_distance_gjk(std::span<const T> p,
       break;
 
     // Add new vertex to simplex
-    s.insert(s.end(), w.begin(), w.end());
+    std::ranges::copy(w, std::next(s.x.begin(), 3 * s.size));
+    ++s.size;
 
     // Find nearest subset of simplex
-    auto [snew, vnew] = impl_gjk::nearest_simplex<T>(s);
-    s.assign(snew.data(), snew.data() + snew.size());
-    v = {vnew[0], vnew[1], vnew[2]};
+    auto [snew, vnew] = impl_gjk::nearest_simplex<T>(s.vertices());
+    s = snew;
+    v = vnew;
 
     // 2nd exit condition - intersecting or touching
     if ((v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) < eps * eps)
@@ -315,4 +339,205 @@ std::array<T, 3> compute_distance_gjk(std::span<const T> p,
   return v;
 }
 
+namespace impl_gjk
+{
+/// @brief Compute the point of a triangle that is nearest to the
+/// origin, in closed form.
+///
+/// Classifies the origin by the Voronoi regions of the vertices, edges
+/// and interior of the triangle, see C. Ericson, Real-Time Collision
+/// Detection, Section 5.1.5.
+/// @return The nearest point, or no value if the triangle is degenerate
+template <std::floating_point T>
+std::optional<std::array<T, 3>> nearest_point_triangle(std::span<const T> a,
+                                                       std::span<const T> b,
+                                                       std::span<const T> c)
+{
+  std::array<T, 3> ab, ac;
+  T d1 = 0, d2 = 0, d3 = 0, d4 = 0, d5 = 0, d6 = 0;
+  for (std::size_t k = 0; k < 3; ++k)
+  {
+    ab[k] = b[k] - a[k];
+    ac[k] = c[k] - a[k];
+    d1 -= ab[k] * a[k];
+    d2 -= ac[k] * a[k];
+    d3 -= ab[k] * b[k];
+    d4 -= ac[k] * b[k];
+    d5 -= ab[k] * c[k];
+    d6 -= ac[k] * c[k];
+  }
+
+  auto point = [&a, &ab, &ac](T v, T w)
+  {
+    return std::array<T, 3>{a[0] + v * ab[0] + w * ac[0],
+                            a[1] + v * ab[1] + w * ac[1],
+                            a[2] + v * ab[2] + w * ac[2]};
+  };
+
+  // Vertex regions
+  if (d1 <= 0 and d2 <= 0)
+    return point(0, 0);
+  if (d3 >= 0 and d4 <= d3)
+    return point(1, 0);
+  if (d6 >= 0 and d5 <= d6)
+    return point(0, 1);
+
+  // Edge regions
+  const T vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 and d1 >= 0 and d3 <= 0)
+    return point(d1 / (d1 - d3), 0);
+  const T vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 and d2 >= 0 and d6 <= 0)
+    return point(0, d2 / (d2 - d6));
+  const T va = d3 * d6 - d5 * d4;
+  if (va <= 0 and d4 - d3 >= 0 and d5 - d6 >= 0)
+  {
+    const T w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return point(1 - w, w);
+  }
+
+  // Interior
+  const T sum = va + vb + vc;
+  if (!(sum > 0))
+    return std::nullopt;
+  return point(vb / sum, vc / sum);
+}
+
+/// @brief Compute the shortest vector from the convex hull of up to
+/// four points to the origin, in closed form.
+///
+/// @param[in] s Points, shape (num_points, 3). Row-major storage.
+/// @return The shortest vector, or no value if the points are
+/// degenerate, e.g. four points that are (nearly) coplanar, in which
+/// case their hull is not a tetrahedron.
+template <std::floating_point T>
+std::optional<std::array<T, 3>> nearest_point_simplex(std::span<const T> s)
+{
+  assert(s.size() % 3 == 0);
+  auto x = [s](int i) { return s.subspan(3 * i, 3); };
+  switch (s.size() / 3)
+  {
+  case 1:
+    return std::array<T, 3>{s[0], s[1], s[2]};
+  case 2:
+    return nearest_simplex<T>(s).second;
+  case 3:
+    return nearest_point_triangle<T>(x(0), x(1), x(2));
+  case 4:
+  {
+    // Signed volume of the tetrahedron (a, b, c, d), times six
+    auto orient = [](auto a, auto b, auto c, auto d)
+    {
+      std::array<T, 3> ab, ac, ad;
+      for (std::size_t k = 0; k < 3; ++k)
+      {
+        ab[k] = b[k] - a[k];
+        ac[k] = c[k] - a[k];
+        ad[k] = d[k] - a[k];
+      }
+      std::array<T, 3> n = math::cross(ac, ad);
+      return ab[0] * n[0] + ab[1] * n[1] + ab[2] * n[2];
+    };
+
+    // Reject (nearly) flat tetrahedra
+    T h2 = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+      T l2 = 0;
+      for (std::size_t k = 0; k < 3; ++k)
+        l2 += (s[3 * i + k] - s[k]) * (s[3 * i + k] - s[k]);
+      h2 = std::max(h2, l2);
+    }
+    const T vol = orient(x(0), x(1), x(2), x(3));
+    constexpr T rtol = 1e4 * std::numeric_limits<T>::epsilon();
+    if (std::abs(vol) <= rtol * h2 * std::sqrt(h2))
+      return std::nullopt;
+
+    // The origin is outside of facet i (opposite vertex i) if replacing
+    // vertex i by the origin changes the sign of the volume. If it is
+    // outside of any facet, the nearest point is on a facet that it is
+    // outside of.
+    constexpr std::array<T, 3> o = {0, 0, 0};
+    const std::array<T, 4> vol_o = {orient(o, x(1), x(2), x(3)),
+                                    orient(x(0), o, x(2), x(3)),
+                                    orient(x(0), x(1), o, x(3)),
+                                    orient(x(0), x(1), x(2), o)};
+    constexpr int facets[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+    std::array<T, 3> vmin = {0, 0, 0};
+    T qmin = std::numeric_limits<T>::max();
+    for (int i = 0; i < 4; ++i)
+    {
+      if (vol_o[i] != 0 and std::signbit(vol_o[i]) != std::signbit(vol))
+      {
+        std::optional<std::array<T, 3>> v = nearest_point_triangle<T>(
+            x(facets[i][0]), x(facets[i][1]), x(facets[i][2]));
+        if (!v)
+          return std::nullopt;
+        auto& _v = *v;
+        if (T q = _v[0] * _v[0] + _v[1] * _v[1] + _v[2] * _v[2]; q < qmin)
+        {
+          qmin = q;
+          vmin = _v;
+        }
+      }
+    }
+    return vmin;
+  }
+  default:
+    return std::nullopt;
+  }
+}
+} // namespace impl_gjk
+
+/// @brief Compute the shortest vectors between points and convex
+/// bodies.
+///
+/// For each point `p[i]` and body `q[i]` this computes
+/// `compute_distance_gjk(p[i], q[i])`, i.e. the shortest vector from
+/// body `q[i]` to the point. Bodies with up to three points and bodies
+/// that are tetrahedra, e.g. the cells of an affine simplex mesh, are
+/// handled in closed form. Other bodies use GJK iteration to a fixed
+/// maximum number of steps. No memory is allocated.
+///
+/// @param[in] p Points, shape (num_pairs, 3). Row-major storage.
+/// @param[in] q Bodies, each with the same number of points, shape
+/// (num_pairs, num_body_points, 3). Row-major storage.
+/// @param[out] d Shortest vectors, shape (num_pairs, 3). Row-major
+/// storage.
+template <std::floating_point T>
+void compute_distances_gjk(std::span<const T> p, std::span<const T> q,
+                           std::span<T> d)
+{
+  assert(p.size() % 3 == 0);
+  assert(d.size() == p.size());
+  const std::size_t num_pairs = p.size() / 3;
+  if (num_pairs == 0)
+    return;
+  assert(q.size() % p.size() == 0);
+  const std::size_t num_body_points = q.size() / num_pairs / 3;
+  assert(num_body_points > 0);
+
+  std::array<T, 12> s;
+  for (std::size_t i = 0; i < num_pairs; ++i)
+  {
+    std::span<const T> pi = p.subspan(3 * i, 3);
+    std::span<const T> qi
+        = q.subspan(3 * num_body_points * i, 3 * num_body_points);
+    std::optional<std::array<T, 3>> v;
+    if (num_body_points <= 4)
+    {
+      // The Minkowski difference of a point and a simplex is a simplex
+      for (std::size_t j = 0; j < num_body_points; ++j)
+        for (std::size_t k = 0; k < 3; ++k)
+          s[3 * j + k] = pi[k] - qi[3 * j + k];
+      v = impl_gjk::nearest_point_simplex<T>(
+          std::span<const T>(s.data(), 3 * num_body_points));
+    }
+
+    if (!v)
+      v = compute_distance_gjk<T>(pi, qi);
+    std::ranges::copy(*v, std::next(d.begin(), 3 * i));
+  }
+}
+
 } // namespace dolfinx::geometry
@@ -7,17 +7,27 @@
 #pragma once
 
 #include "BoundingBoxTree.h"
+#include "GridLocator.h"
+#include "WideBoundingBoxTree.h"
 #include "gjk.h"
 #include <algorithm>
 #include <array>
 #include <concepts>
 #include <cstdint>
 #include <deque>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/utils.h>
+#include <limits>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::geometry
@@ -38,6 +48,22 @@ struct PointOwnershipData
                   ///< `dest_points` is located
 };
 
+/// @brief Search structure used to find candidate cells for points.
+enum class CellSearch : std::int8_t
+{
+  bounding_box_tree, ///< geometry::BoundingBoxTree
+  grid,              ///< geometry::GridLocator, for quasi-uniform meshes
+};
+
+/// @brief How a point was located by geometry::locate_points.
+enum class PointLocation : std::int8_t
+{
+  guess,     ///< The point is in the guessed cell
+  walk,      ///< The point was found by walking from the guessed cell
+  tree,      ///< The point was found using the bounding box tree
+  not_found, ///< The point is not in a cell on this process
+};
+
 /// @brief Compute the shortest vector from a mesh entity to a point.
 ///
 /// @param[in] mesh The mesh
@@ -58,10 +84,17 @@ std::vector<T> shortest_vector(const mesh::Mesh<T>& mesh, int dim,
 
   std::span<const T> geom_dofs = geometry.x();
   auto x_dofmap = geometry.dofmap();
-  std::vector<T> shortest_vectors;
-  shortest_vectors.reserve(3 * entities.size());
+  std::vector<T> shortest_vectors(3 * entities.size());
+  if (entities.empty())
+    return shortest_vectors;
+
+  std::vector<T> nodes;
   if (dim == tdim)
   {
+    // Coordinates of the nodes of each cell, to compute all distances
+    // in one batch
+    const std::size_t num_nodes = x_dofmap.extent(1);
+    nodes.resize(3 * num_nodes * entities.size());
     for (std::size_t e = 0; e < entities.size(); e++)
     {
       // Check that we have sent in valid entities, i.e. that they exist in the
@@ -69,18 +102,16 @@ std::vector<T> shortest_vector(const mesh::Mesh<T>& mesh, int dim,
       assert(entities[e] >= 0);
       auto dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
           x_dofmap, entities[e], MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      std::vector<T> nodes(3 * dofs.size());
       for (std::size_t i = 0; i < dofs.size(); ++i)
       {
         const std::int32_t pos = 3 * dofs[i];
         for (std::size_t j = 0; j < 3; ++j)
-          nodes[3 * i + j] = geom_dofs[pos + j];
+          nodes[3 * (e * num_nodes + i) + j] = geom_dofs[pos + j];
       }
-
-      std::array<T, 3> d
-          = compute_distance_gjk<T>(points.subspan(3 * e, 3), nodes);
-      shortest_vectors.insert(shortest_vectors.end(), d.begin(), d.end());
     }
+
+    compute_distances_gjk<T>(points.first(3 * entities.size()), nodes,
+                             shortest_vectors);
   }
   else
   {
@@ -110,7 +141,7 @@ std::vector<T> shortest_vector(const mesh::Mesh<T>& mesh, int dim,
       const std::vector<int> entity_dofs
           = geometry.cmap().create_dof_layout().entity_closure_dofs(
               dim, local_cell_entity);
-      std::vector<T> nodes(3 * entity_dofs.size());
+      nodes.resize(3 * entity_dofs.size());
       for (std::size_t i = 0; i < entity_dofs.size(); i++)
       {
         const std::int32_t pos = 3 * dofs[entity_dofs[i]];
@@ -118,9 +149,10 @@ std::vector<T> shortest_vector(const mesh::Mesh<T>& mesh, int dim,
           nodes[3 * i + j] = geom_dofs[pos + j];
       }
 
-      std::array<T, 3> d
-          = compute_distance_gjk<T>(points.subspan(3 * e, 3), nodes);
-      shortest_vectors.insert(shortest_vectors.end(), d.begin(), d.end());
+      // Entities can have different numbers of nodes (e.g. the facets
+      // of a prism), so compute the distances one at a time
+      compute_distances_gjk<T>(points.subspan(3 * e, 3), nodes,
+                               std::span(shortest_vectors).subspan(3 * e, 3));
     }
   }
 
@@ -358,6 +390,33 @@ void _compute_collisions_point(const geometry::BoundingBoxTree<T>& tree,
   }
 }
 
+/// @brief Compute collisions with an axis-aligned box.
+/// @param[in] tree The bounding box tree
+/// @param[in] b The box (`shape=(2, 3)`), lower then upper corner
+/// @param[in, out] entities The list of colliding entities (local to
+/// process)
+template <std::floating_point T>
+void _compute_collisions_bbox(const geometry::BoundingBoxTree<T>& tree,
+                              std::span<const T, 6> b,
+                              std::vector<std::int32_t>& entities)
+{
+  std::vector<std::int32_t> stack = {tree.num_bboxes() - 1};
+  while (!stack.empty())
+  {
+    const std::int32_t node = stack.back();
+    stack.pop_back();
+    const std::array<T, 6> node_bbox = tree.get_bbox(node);
+    if (!bbox_in_bbox<T>(node_bbox, b))
+      continue;
+
+    const std::array<int, 2> bbox = tree.bbox(node);
+    if (is_leaf(bbox))
+      entities.push_back(bbox[1]);
+    else
+      stack.insert(stack.end(), {bbox[1], bbox[0]});
+  }
+}
+
 // Compute collisions with tree (recursive)
 template <std::floating_point T>
 void _compute_collisions_tree(const geometry::BoundingBoxTree<T>& A,
@@ -414,6 +473,241 @@ void _compute_collisions_tree(const geometry::BoundingBoxTree<T>& A,
   // the logic is easier to follow.
 }
 
+/// @brief Split the traversal of two trees into pairs of colliding
+/// nodes.
+///
+/// The pairs are expanded level by level, in the order that
+/// _compute_collisions_tree visits them, until there are at least
+/// `min_pairs` pairs or only pairs of leaves are left. Traversing the
+/// pairs in order gives the same collisions as traversing the trees
+/// from the roots.
+template <std::floating_point T>
+std::vector<std::array<std::int32_t, 2>>
+_split_collisions_tree(const geometry::BoundingBoxTree<T>& A,
+                       const geometry::BoundingBoxTree<T>& B,
+                       std::size_t min_pairs)
+{
+  std::vector<std::array<std::int32_t, 2>> pairs
+      = {{A.num_bboxes() - 1, B.num_bboxes() - 1}};
+  std::vector<std::array<std::int32_t, 2>> next;
+  bool expanded = true;
+  while (expanded and pairs.size() < min_pairs)
+  {
+    expanded = false;
+    next.clear();
+    for (auto [node_A, node_B] : pairs)
+    {
+      if (!bbox_in_bbox<T>(A.get_bbox(node_A), B.get_bbox(node_B)))
+        continue;
+
+      const std::array<std::int32_t, 2> bbox_A = A.bbox(node_A);
+      const std::array<std::int32_t, 2> bbox_B = B.bbox(node_B);
+      const bool is_leaf_A = is_leaf(bbox_A);
+      const bool is_leaf_B = is_leaf(bbox_B);
+      if (is_leaf_A and is_leaf_B)
+        next.push_back({node_A, node_B});
+      else if (is_leaf_B or (!is_leaf_A and node_A > node_B))
+      {
+        next.insert(next.end(),
+                    {{bbox_A[0], node_B}, {bbox_A[1], node_B}});
+        expanded = true;
+      }
+      else
+      {
+        next.insert(next.end(),
+                    {{node_A, bbox_B[0]}, {node_A, bbox_B[1]}});
+        expanded = true;
+      }
+    }
+    pairs.swap(next);
+  }
+
+  return pairs;
+}
+
+
+/// Squared distance between a point and the entity of leaf `node`
+template <std::floating_point T>
+T _leaf_squared_distance(const geometry::BoundingBoxTree<T>& tree,
+                         const mesh::Mesh<T>& mesh, std::int32_t node,
+                         std::span<const T, 3> point)
+{
+  if (tree.tdim() == 0)
+  {
+    // Point cloud tree
+    std::array<T, 6> diff = tree.get_bbox(node);
+    for (std::size_t k = 0; k < 3; ++k)
+      diff[k] -= point[k];
+    return diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
+  }
+  else
+  {
+    const std::array<int, 2> bbox = tree.bbox(node);
+    return squared_distance<T>(mesh, tree.tdim(),
+                               std::span(std::next(bbox.begin(), 1), 1), point)
+        .front();
+  }
+}
+
+/// @brief Compute the `k` closest entities to a point (best-first
+/// branch-and-bound).
+///
+/// Nodes are visited in order of the distance to their bounding box,
+/// and the search stops when the next box is further away than the
+/// `k`th closest entity found so far.
+/// @param[in] tree The bounding box tree
+/// @param[in] mesh The mesh
+/// @param[in] point The point
+/// @param[in] k Number of entities
+/// @param[in, out] queue Workspace
+/// @param[out] nearest The closest entities (squared distance, entity),
+/// sorted by distance
+template <std::floating_point T>
+void _compute_nearest_entities(
+    const geometry::BoundingBoxTree<T>& tree, const mesh::Mesh<T>& mesh,
+    std::span<const T, 3> point, std::size_t k,
+    std::vector<std::pair<T, std::int32_t>>& queue,
+    std::vector<std::pair<T, std::int32_t>>& nearest)
+{
+  // 'queue' is a min-heap of nodes by box distance and 'nearest' is a
+  // max-heap of entities by distance
+  auto box_distance = [&tree, point](std::int32_t node)
+  {
+    std::array<T, 6> b = tree.get_bbox(node);
+    return compute_squared_distance_bbox<T>(b, point);
+  };
+  const std::int32_t root = tree.num_bboxes() - 1;
+  queue.assign(1, {box_distance(root), root});
+  nearest.clear();
+  while (!queue.empty())
+  {
+    std::ranges::pop_heap(queue, std::greater<>());
+    auto [r2, node] = queue.back();
+    queue.pop_back();
+    if (nearest.size() == k and r2 > nearest.front().first)
+      break;
+
+    const std::array<int, 2> bbox = tree.bbox(node);
+    if (is_leaf(bbox))
+    {
+      const T d2 = _leaf_squared_distance(tree, mesh, node, point);
+      if (nearest.size() < k)
+      {
+        nearest.emplace_back(d2, bbox[1]);
+        std::ranges::push_heap(nearest);
+      }
+      else if (d2 < nearest.front().first)
+      {
+        std::ranges::pop_heap(nearest);
+        nearest.back() = {d2, bbox[1]};
+        std::ranges::push_heap(nearest);
+      }
+    }
+    else
+    {
+      for (std::int32_t c : bbox)
+      {
+        if (T r2c = box_distance(c);
+            nearest.size() < k or r2c <= nearest.front().first)
+        {
+          queue.emplace_back(r2c, c);
+          std::ranges::push_heap(queue, std::greater<>());
+        }
+      }
+    }
+  }
+
+  std::ranges::sort_heap(nearest);
+}
+
+/// @brief Compute the entities within a distance of a point.
+/// @param[in] tree The bounding box tree
+/// @param[in] mesh The mesh
+/// @param[in] point The point
+/// @param[in] r2 Squared distance
+/// @param[in, out] stack Workspace
+/// @param[out] entities The entities (squared distance, entity) with
+/// squared distance less than or equal to `r2`, sorted by distance
+template <std::floating_point T>
+void _compute_entities_in_radius(
+    const geometry::BoundingBoxTree<T>& tree, const mesh::Mesh<T>& mesh,
+    std::span<const T, 3> point, T r2, std::vector<std::int32_t>& stack,
+    std::vector<std::pair<T, std::int32_t>>& entities)
+{
+  stack.assign(1, tree.num_bboxes() - 1);
+  entities.clear();
+  while (!stack.empty())
+  {
+    const std::int32_t node = stack.back();
+    stack.pop_back();
+    if (std::array<T, 6> b = tree.get_bbox(node);
+        compute_squared_distance_bbox<T>(b, point) > r2)
+    {
+      continue;
+    }
+
+    const std::array<int, 2> bbox = tree.bbox(node);
+    if (is_leaf(bbox))
+    {
+      if (T d2 = _leaf_squared_distance(tree, mesh, node, point); d2 <= r2)
+        entities.emplace_back(d2, bbox[1]);
+    }
+    else
+    {
+      stack.push_back(bbox[1]);
+      stack.push_back(bbox[0]);
+    }
+  }
+
+  std::ranges::sort(entities);
+}
+
+/// @brief Compute a list of entities for each point, using threads.
+/// @param[in] num_points Number of points
+/// @param[in] num_threads Number of threads
+/// @param[in] f Function `f(p, entities)` that appends the entities of
+/// point `p` to `entities`. Each thread uses its own copy of `f`, which
+/// can hold workspace.
+/// @return The entities of each point
+template <typename F>
+graph::AdjacencyList<std::int32_t>
+_compute_point_entities(std::size_t num_points, int num_threads, const F& f)
+{
+  const int nt = std::max(num_threads, 1);
+  std::vector<std::vector<std::int32_t>> entities(nt);
+  std::vector<std::int32_t> offsets(num_points + 1, 0);
+  auto compute = [&](int t, std::size_t p0, std::size_t p1)
+  {
+    F ft = f;
+    for (std::size_t p = p0; p < p1; ++p)
+    {
+      ft(p, entities[t]);
+      offsets[p + 1] = entities[t].size();
+    }
+  };
+  common::run_tasks(nt,
+                    [&](int t)
+                    {
+                      compute(t, t * num_points / nt,
+                              (t + 1) * num_points / nt);
+                    });
+
+  // Offsets are relative to the start of each thread's range
+  std::vector<std::int32_t> array;
+  for (int t = 0; t < nt; ++t)
+  {
+    const std::int32_t shift = array.size();
+    for (std::size_t p = t * num_points / nt; p < (t + 1) * num_points / nt;
+         ++p)
+    {
+      offsets[p + 1] += shift;
+    }
+    array.insert(array.end(), entities[t].begin(), entities[t].end());
+  }
+
+  return graph::AdjacencyList(std::move(array), std::move(offsets));
+}
+
 } // namespace impl
 
 /// @brief Create a bounding box tree for the midpoints of a subset of
@@ -426,8 +720,9 @@ template <std::floating_point T>
 BoundingBoxTree<T> create_midpoint_tree(const mesh::Mesh<T>& mesh, int tdim,
                                         std::span<const std::int32_t> entities)
 {
-  spdlog::info("Building point search tree to accelerate distance queries for "
-               "a given topological dimension and subset of entities.");
+  DOLFINX_LOG_INFO("Building point search tree to accelerate distance "
+                   "queries for a given topological dimension and subset of "
+                   "entities.");
 
   const std::vector<T> midpoints
       = mesh::compute_midpoints(mesh, tdim, entities);
@@ -445,22 +740,267 @@ BoundingBoxTree<T> create_midpoint_tree(const mesh::Mesh<T>& mesh, int tdim,
 }
 
 /// @brief Compute all collisions between two bounding box trees.
+///
+/// With more than one thread, the traversal of the trees is split into
+/// pairs of colliding subtrees that are traversed by the threads into
+/// separate buffers. The result does not depend on the number of
+/// threads.
+///
 /// @param[in] tree0 First BoundingBoxTree
 /// @param[in] tree1 Second BoundingBoxTree
+/// @param[in] num_threads Number of threads
 /// @return List of pairs of intersecting box indices from each tree,
 /// flattened as a vector of size num_intersections*2
 template <std::floating_point T>
 std::vector<std::int32_t> compute_collisions(const BoundingBoxTree<T>& tree0,
-                                             const BoundingBoxTree<T>& tree1)
+                                             const BoundingBoxTree<T>& tree1,
+                                             int num_threads = 1)
 {
-  // Call recursive find function
   std::vector<std::int32_t> entities;
-  if (tree0.num_bboxes() > 0 and tree1.num_bboxes() > 0)
+  if (tree0.num_bboxes() == 0 or tree1.num_bboxes() == 0)
+    return entities;
+
+  // Call recursive find function
+  if (num_threads <= 1)
   {
     impl::_compute_collisions_tree(tree0, tree1, tree0.num_bboxes() - 1,
                                    tree1.num_bboxes() - 1, entities);
+    return entities;
   }
 
+  // Split the traversal into enough subtree pairs to balance the work
+  // between the threads
+  const std::vector<std::array<std::int32_t, 2>> pairs
+      = impl::_split_collisions_tree(tree0, tree1, 16 * num_threads);
+  if (pairs.empty())
+    return entities;
+  const int nt = std::min<std::size_t>(num_threads, pairs.size());
+  std::vector<std::vector<std::int32_t>> buffers(nt);
+  auto traverse = [&](int t)
+  {
+    auto [i0, i1] = dolfinx::MPI::local_range(t, pairs.size(), nt);
+    for (std::int64_t i = i0; i < i1; ++i)
+    {
+      impl::_compute_collisions_tree(tree0, tree1, pairs[i][0], pairs[i][1],
+                                     buffers[t]);
+    }
+  };
+  common::run_tasks(nt, traverse);
+
+  std::size_t size = 0;
+  for (auto& b : buffers)
+    size += b.size();
+  entities.reserve(size);
+  for (auto& b : buffers)
+    entities.insert(entities.end(), b.begin(), b.end());
+  return entities;
+}
+
+/// @brief Compute the collisions between the leaves of a tree on this
+/// process and the leaves of trees on all processes (collective).
+///
+/// This is the broad phase for, e.g., contact between two distributed
+/// bodies. The processes whose `tree1` may collide with the local
+/// `tree0` are found from a global tree of `tree1` (see
+/// BoundingBoxTree::create_global_tree). Only the leaf boxes of `tree0`
+/// that collide with the global tree boxes of a process are sent to
+/// that process, which computes their collisions with its `tree1` and
+/// sends the colliding leaves back.
+///
+/// @param[in] comm MPI communicator
+/// @param[in] tree0 Tree on this process whose leaves are checked
+/// @param[in] tree1 Tree on this process that (together with `tree1` on
+/// the other processes) the leaves of `tree0` are checked against
+/// @param[in] num_boxes Maximum number of boxes per process in the
+/// global tree of `tree1`
+/// @param[in] num_threads Number of threads for the tree traversals
+/// @return The `tree0` leaves (entity indices) that collide with a
+/// leaf of `tree1` on some process, sorted, and for each the colliding
+/// `(rank, tree1 entity index)` pairs, sorted and flattened.
+template <std::floating_point T>
+std::pair<std::vector<std::int32_t>, graph::AdjacencyList<std::int32_t>>
+compute_distributed_collisions(MPI_Comm comm, const BoundingBoxTree<T>& tree0,
+                               const BoundingBoxTree<T>& tree1,
+                               int num_boxes = 1, int num_threads = 1)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Candidate (rank, entity0) pairs on other processes
+  const BoundingBoxTree<T> global_tree
+      = tree1.create_global_tree(comm, num_boxes);
+  std::vector<std::array<std::int32_t, 2>> candidates;
+  {
+    std::vector<std::int32_t> c
+        = compute_collisions(tree0, global_tree, num_threads);
+    for (std::size_t i = 0; i < c.size(); i += 2)
+      if (c[i + 1] != rank)
+        candidates.push_back({c[i + 1], c[i]});
+    std::ranges::sort(candidates);
+    auto [unique_end, range_end] = std::ranges::unique(candidates);
+    candidates.erase(unique_end, range_end);
+  }
+
+  // Leaf node of each entity of tree0, sorted by entity
+  std::vector<std::array<std::int32_t, 2>> leaves;
+  for (std::int32_t n = 0; n < tree0.num_bboxes(); ++n)
+  {
+    std::array<std::int32_t, 2> b = tree0.bbox(n);
+    if (impl::is_leaf(b))
+      leaves.push_back({b[1], n});
+  }
+  std::ranges::sort(leaves);
+
+  // Pack the leaf boxes to send to each candidate process
+  std::vector<int> dest;
+  std::vector<int> send_sizes;
+  std::vector<T> send_bboxes(6 * candidates.size());
+  std::vector<std::int32_t> send_entities(candidates.size());
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    auto [r, e] = candidates[i];
+    if (dest.empty() or dest.back() != r)
+    {
+      dest.push_back(r);
+      send_sizes.push_back(0);
+    }
+    send_sizes.back() += 6;
+    auto it = std::ranges::lower_bound(leaves, std::array{e, 0});
+    assert(it != leaves.end() and (*it)[0] == e);
+    std::array<T, 6> b = tree0.get_bbox((*it)[1]);
+    std::ranges::copy(b, std::next(send_bboxes.begin(), 6 * i));
+    send_entities[i] = e;
+  }
+
+  std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+  std::ranges::sort(src);
+  MPI_Comm forward_comm, reverse_comm;
+  MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
+                                 dest.size(), dest.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &forward_comm);
+  MPI_Dist_graph_create_adjacent(comm, dest.size(), dest.data(),
+                                 MPI_UNWEIGHTED, src.size(), src.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                 &reverse_comm);
+
+  // Send the leaf boxes
+  std::vector<int> recv_sizes(src.size());
+  send_sizes.reserve(1);
+  recv_sizes.reserve(1);
+  MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1,
+                        MPI_INT, forward_comm);
+  std::vector<int> send_disp(send_sizes.size() + 1, 0);
+  std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                   std::next(send_disp.begin()));
+  std::vector<int> recv_disp(recv_sizes.size() + 1, 0);
+  std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                   std::next(recv_disp.begin()));
+  std::vector<T> recv_bboxes(recv_disp.back());
+  MPI_Neighbor_alltoallv(send_bboxes.data(), send_sizes.data(),
+                         send_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                         recv_bboxes.data(), recv_sizes.data(),
+                         recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+                         forward_comm);
+
+  // Collide the received boxes with the local tree1, and send back
+  // (index of the box from the source, tree1 entity) pairs
+  std::vector<std::int32_t> reply;
+  std::vector<int> reply_sizes(src.size(), 0);
+  {
+    std::vector<std::pair<std::array<T, 6>, std::int32_t>> boxes(
+        recv_bboxes.size() / 6);
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+      std::copy_n(std::next(recv_bboxes.begin(), 6 * i), 6,
+                  boxes[i].first.begin());
+      boxes[i].second = i;
+    }
+    const BoundingBoxTree<T> recv_tree(std::move(boxes), num_threads);
+    std::vector<std::int32_t> c
+        = compute_collisions(recv_tree, tree1, num_threads);
+    std::vector<std::array<std::int32_t, 2>> pairs(c.size() / 2);
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+      pairs[i] = {c[2 * i], c[2 * i + 1]};
+    std::ranges::sort(pairs);
+
+    reply.reserve(c.size());
+    for (auto [box, e1] : pairs)
+    {
+      auto it = std::ranges::upper_bound(recv_disp, 6 * box);
+      const std::size_t p = std::distance(recv_disp.begin(), it) - 1;
+      reply.insert(reply.end(), {box - recv_disp[p] / 6, e1});
+      reply_sizes[p] += 2;
+    }
+  }
+
+  std::vector<int> result_sizes(dest.size());
+  reply_sizes.reserve(1);
+  result_sizes.reserve(1);
+  MPI_Neighbor_alltoall(reply_sizes.data(), 1, MPI_INT, result_sizes.data(),
+                        1, MPI_INT, reverse_comm);
+  std::vector<int> reply_disp(reply_sizes.size() + 1, 0);
+  std::partial_sum(reply_sizes.begin(), reply_sizes.end(),
+                   std::next(reply_disp.begin()));
+  std::vector<int> result_disp(result_sizes.size() + 1, 0);
+  std::partial_sum(result_sizes.begin(), result_sizes.end(),
+                   std::next(result_disp.begin()));
+  std::vector<std::int32_t> result(result_disp.back());
+  MPI_Neighbor_alltoallv(reply.data(), reply_sizes.data(), reply_disp.data(),
+                         MPI_INT32_T, result.data(), result_sizes.data(),
+                         result_disp.data(), MPI_INT32_T, reverse_comm);
+  MPI_Comm_free(&forward_comm);
+  MPI_Comm_free(&reverse_comm);
+
+  // Collect the (entity0, rank, entity1) collisions, including those
+  // with the local tree1
+  std::vector<std::array<std::int32_t, 3>> collisions;
+  {
+    std::vector<std::int32_t> c = compute_collisions(tree0, tree1, num_threads);
+    collisions.reserve(c.size() / 2 + result.size() / 2);
+    for (std::size_t i = 0; i < c.size(); i += 2)
+      collisions.push_back({c[i], rank, c[i + 1]});
+  }
+  for (std::size_t p = 0; p < dest.size(); ++p)
+  {
+    for (int i = result_disp[p]; i < result_disp[p + 1]; i += 2)
+    {
+      const std::int32_t e0 = send_entities[send_disp[p] / 6 + result[i]];
+      collisions.push_back({e0, dest[p], result[i + 1]});
+    }
+  }
+  std::ranges::sort(collisions);
+
+  std::vector<std::int32_t> entities, data, offsets(1, 0);
+  data.reserve(2 * collisions.size());
+  for (auto [e0, r, e1] : collisions)
+  {
+    if (entities.empty() or entities.back() != e0)
+    {
+      entities.push_back(e0);
+      offsets.push_back(offsets.back());
+    }
+    data.insert(data.end(), {r, e1});
+    offsets.back() += 2;
+  }
+
+  return {std::move(entities),
+          graph::AdjacencyList(std::move(data), std::move(offsets))};
+}
+
+/// @brief Compute collisions between an axis-aligned box and the leaf
+/// bounding boxes of a tree.
+///
+/// @param[in] tree The bounding box tree
+/// @param[in] bbox The box (`shape=(2, 3)`), the lower corner followed
+/// by the upper corner. Storage is row-major.
+/// @return The leaves that collide with the box, in tree order.
+template <std::floating_point T>
+std::vector<std::int32_t>
+compute_bbox_collisions(const BoundingBoxTree<T>& tree,
+                        std::span<const T, 6> bbox)
+{
+  std::vector<std::int32_t> entities;
+  if (tree.num_bboxes() > 0)
+    impl::_compute_collisions_bbox(tree, bbox, entities);
   return entities;
 }
 
@@ -499,6 +1039,260 @@ compute_collisions(const BoundingBoxTree<T>& tree, std::span<const T> points)
   }
 }
 
+/// @brief Compute collisions between points and the entities of a
+/// grid locator.
+///
+/// The colliding entities of each point are the same as for a
+/// BoundingBoxTree of the same entities with the same padding, in the
+/// order of GridLocator::entities.
+///
+/// @param[in] grid The grid locator
+/// @param[in] points The points (`shape=(num_points, 3)`). Storage is
+/// row-major.
+/// @return For each point, the entities whose bounding box collides
+/// with the point.
+template <std::floating_point T>
+graph::AdjacencyList<std::int32_t>
+compute_collisions(const GridLocator<T>& grid, std::span<const T> points)
+{
+  std::vector<std::int32_t> entities, offsets(points.size() / 3 + 1, 0);
+  entities.reserve(points.size() / 3);
+  std::span<const std::int32_t> grid_entities = grid.entities();
+  for (std::size_t p = 0; p < points.size() / 3; ++p)
+  {
+    std::span<const T, 3> x(points.data() + 3 * p, 3);
+    for (std::int32_t i : grid.bucket(x))
+      if (impl::point_in_bbox(grid.get_bbox(i), x))
+        entities.push_back(grid_entities[i]);
+    offsets[p + 1] = entities.size();
+  }
+
+  return graph::AdjacencyList(std::move(entities), std::move(offsets));
+}
+
+/// @brief Compute all collisions between two wide bounding box trees.
+/// @param[in] tree0 First tree
+/// @param[in] tree1 Second tree
+/// @return List of pairs of intersecting leaf entities from each tree,
+/// flattened as a vector of size num_intersections*2
+template <std::floating_point T, int W>
+std::vector<std::int32_t>
+compute_collisions(const WideBoundingBoxTree<T, W>& tree0,
+                   const WideBoundingBoxTree<T, W>& tree1)
+{
+  std::vector<std::int32_t> entities;
+  if (tree0.num_nodes() > 0 and tree1.num_nodes() > 0
+      and impl::bbox_in_bbox<T>(tree0.bbox(), tree1.bbox()))
+  {
+    impl_wide::compute_collisions_tree(tree0, tree1, 0, tree0.bbox(), 0,
+                                       tree1.bbox(), entities);
+  }
+
+  return entities;
+}
+
+/// @brief Compute collisions between points and the leaves of a wide
+/// bounding box tree.
+///
+/// The result is the same as for the binary tree that the wide tree
+/// was created from.
+///
+/// @param[in] tree The wide bounding box tree
+/// @param[in] points The points (`shape=(num_points, 3)`). Storage is
+/// row-major.
+/// @return For each point, the leaves that collide with the point.
+template <std::floating_point T, int W>
+graph::AdjacencyList<std::int32_t>
+compute_collisions(const WideBoundingBoxTree<T, W>& tree,
+                   std::span<const T> points)
+{
+  std::vector<std::int32_t> entities, offsets(points.size() / 3 + 1, 0);
+  if (tree.num_nodes() > 0)
+  {
+    entities.reserve(points.size() / 3);
+    std::vector<std::int32_t> stack;
+    for (std::size_t p = 0; p < points.size() / 3; ++p)
+    {
+      impl_wide::compute_collisions_point(
+          tree, std::span<const T, 3>(points.data() + 3 * p, 3), stack,
+          entities);
+      offsets[p + 1] = entities.size();
+    }
+  }
+
+  return graph::AdjacencyList(std::move(entities), std::move(offsets));
+}
+
+/// @brief Compute indices of the mesh entities in a region that
+/// evaluate to true for a geometric marking function.
+///
+/// An entity is marked if the marker evaluates to true for all of its
+/// vertices. Unlike mesh::locate_entities, the marker is evaluated only
+/// on the vertices of the entities whose bounding box collides with
+/// the region, which are found with a bounding box tree. For markers
+/// that select a small part of a large mesh this avoids evaluating the
+/// marker on all vertices.
+///
+/// @param[in] mesh Mesh to mark entities on.
+/// @param[in] tree Bounding box tree for the entities to consider. The
+/// dimension of the entities is the tree dimension.
+/// @param[in] region Axis-aligned box (`shape=(2, 3)`), the lower
+/// corner followed by the upper corner, that contains all points that
+/// are marked.
+/// @param[in] marker Marking function, returns `true` for a point that
+/// is 'marked', and `false` otherwise. It must return `false` for
+/// points outside `region`.
+/// @returns Sorted list of marked entity indices, including any ghost
+/// indices (indices local to the process)
+template <std::floating_point T, mesh::MarkerFn<T> U>
+std::vector<std::int32_t> locate_entities(const mesh::Mesh<T>& mesh,
+                                          const BoundingBoxTree<T>& tree,
+                                          std::array<T, 6> region, U marker)
+{
+  using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+      const T,
+      MDSPAN_IMPL_STANDARD_NAMESPACE::extents<
+          std::size_t, 3, MDSPAN_IMPL_STANDARD_NAMESPACE::dynamic_extent>>;
+
+  auto topology = mesh.topology_mutable();
+  assert(topology);
+  const int dim = tree.tdim();
+  const int tdim = topology->dim();
+  topology->create_connectivity(tdim, 0);
+  if (dim < tdim)
+  {
+    topology->create_connectivity(dim, 0);
+    topology->create_connectivity(dim, tdim);
+  }
+
+  // Entities with a bounding box that collides with the region
+  std::vector<std::int32_t> candidates
+      = compute_bbox_collisions(tree, std::span<const T, 6>(region));
+  std::ranges::sort(candidates);
+
+  auto e_to_v = topology->connectivity(dim, 0);
+  auto c_to_v = topology->connectivity(tdim, 0);
+  auto e_to_c = dim < tdim ? topology->connectivity(dim, tdim) : nullptr;
+  assert(e_to_v);
+  assert(c_to_v);
+
+  // Vertices of the candidate entities
+  std::vector<std::int32_t> vertices;
+  for (std::int32_t e : candidates)
+  {
+    auto e_vertices = e_to_v->links(e);
+    vertices.insert(vertices.end(), e_vertices.begin(), e_vertices.end());
+  }
+  std::ranges::sort(vertices);
+  auto [unique_end, range_end] = std::ranges::unique(vertices);
+  vertices.erase(unique_end, range_end);
+
+  // Pack the vertex coordinates, using a cell of each entity to find
+  // the geometry node of its vertices
+  auto x_dofmap = mesh.geometry().dofmap();
+  std::span<const T> x_nodes = mesh.geometry().x();
+  const std::size_t num_vertices = vertices.size();
+  std::vector<T> xdata(3 * num_vertices);
+  for (std::int32_t e : candidates)
+  {
+    const std::int32_t c = e_to_c ? e_to_c->links(e).front() : e;
+    auto cell_vertices = c_to_v->links(c);
+    for (std::int32_t v : e_to_v->links(e))
+    {
+      auto it = std::ranges::find(cell_vertices, v);
+      assert(it != cell_vertices.end());
+      const std::int32_t node
+          = x_dofmap(c, std::distance(cell_vertices.begin(), it));
+      const std::size_t pos = std::distance(
+          vertices.begin(), std::ranges::lower_bound(vertices, v));
+      for (std::size_t j = 0; j < 3; ++j)
+        xdata[j * num_vertices + pos] = x_nodes[3 * node + j];
+    }
+  }
+
+  const std::vector<std::int8_t> marked
+      = marker(cmdspan3x_t(xdata.data(), 3, num_vertices));
+  if (marked.size() != num_vertices)
+    throw std::runtime_error("Length of array of markers is wrong.");
+
+  std::vector<std::int32_t> entities;
+  for (std::int32_t e : candidates)
+  {
+    auto e_vertices = e_to_v->links(e);
+    if (std::ranges::all_of(
+            e_vertices,
+            [&](auto v)
+            {
+              return marked[std::distance(
+                  vertices.begin(), std::ranges::lower_bound(vertices, v))];
+            }))
+    {
+      entities.push_back(e);
+    }
+  }
+
+  return entities;
+}
+
+/// @brief Compute indices of the mesh entities with all vertices in an
+/// axis-aligned box.
+///
+/// @param[in] mesh Mesh to mark entities on.
+/// @param[in] tree Bounding box tree for the entities to consider.
+/// @param[in] region The box (`shape=(2, 3)`), the lower corner
+/// followed by the upper corner.
+/// @returns Sorted list of entity indices, including any ghost indices
+/// (indices local to the process)
+template <std::floating_point T>
+std::vector<std::int32_t> locate_entities(const mesh::Mesh<T>& mesh,
+                                          const BoundingBoxTree<T>& tree,
+                                          std::array<T, 6> region)
+{
+  return locate_entities(
+      mesh, tree, region,
+      [&region](auto x)
+      {
+        std::vector<std::int8_t> marked(x.extent(1), true);
+        for (std::size_t i = 0; i < x.extent(1); ++i)
+          for (std::size_t j = 0; j < 3; ++j)
+            marked[i] &= x(j, i) >= region[j] and x(j, i) <= region[3 + j];
+        return marked;
+      });
+}
+
+/// @brief Compute indices of the mesh entities with all vertices in
+/// the region where a signed distance function is non-positive.
+///
+/// @param[in] mesh Mesh to mark entities on.
+/// @param[in] tree Bounding box tree for the entities to consider.
+/// @param[in] region Axis-aligned box (`shape=(2, 3)`), the lower
+/// corner followed by the upper corner, that contains the points where
+/// `distance` is non-positive.
+/// @param[in] distance Signed distance function, evaluated at a point.
+/// @param[in] tol Points with a distance less than or equal to `tol`
+/// are marked.
+/// @returns Sorted list of entity indices, including any ghost indices
+/// (indices local to the process)
+template <std::floating_point T, typename U>
+  requires std::is_invocable_r_v<T, U, std::span<const T, 3>>
+std::vector<std::int32_t>
+locate_entities(const mesh::Mesh<T>& mesh, const BoundingBoxTree<T>& tree,
+                std::array<T, 6> region, U distance, T tol)
+{
+  return locate_entities(
+      mesh, tree, region,
+      [&distance, tol](auto x)
+      {
+        std::vector<std::int8_t> marked(x.extent(1));
+        for (std::size_t i = 0; i < x.extent(1); ++i)
+        {
+          const std::array<T, 3> p = {x(0, i), x(1, i), x(2, i)};
+          marked[i] = distance(std::span<const T, 3>(p)) <= tol;
+        }
+        return marked;
+      });
+}
+
 /// @brief Given a set of cells, find the first one that collides with a
 /// point.
 ///
@@ -529,23 +1323,31 @@ std::int32_t compute_first_colliding_cell(const mesh::Mesh<T>& mesh,
     std::span<const T> geom_dofs = geometry.x();
     auto x_dofmap = geometry.dofmap();
     const std::size_t num_nodes = x_dofmap.extent(1);
-    std::vector<T> coordinate_dofs(num_nodes * 3);
-    for (auto cell : cells)
+
+    // Compute the distances to all candidate cells in one batch
+    std::vector<T> coordinate_dofs(cells.size() * num_nodes * 3);
+    std::vector<T> _point(3 * cells.size());
+    for (std::size_t c = 0; c < cells.size(); ++c)
     {
       auto dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          x_dofmap, cell, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+          x_dofmap, cells[c], MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
       for (std::size_t i = 0; i < num_nodes; ++i)
       {
         std::copy_n(std::next(geom_dofs.begin(), 3 * dofs[i]), 3,
-                    std::next(coordinate_dofs.begin(), 3 * i));
+                    std::next(coordinate_dofs.begin(),
+                              3 * (c * num_nodes + i)));
       }
+      std::ranges::copy(point, std::next(_point.begin(), 3 * c));
+    }
 
-      std::array<T, 3> shortest_vector
-          = compute_distance_gjk<T>(point, coordinate_dofs);
-      T d2 = std::reduce(shortest_vector.begin(), shortest_vector.end(), T(0),
-                         [](auto d, auto e) { return d + e * e; });
+    std::vector<T> shortest_vectors(3 * cells.size());
+    compute_distances_gjk<T>(_point, coordinate_dofs, shortest_vectors);
+    for (std::size_t c = 0; c < cells.size(); ++c)
+    {
+      auto v = std::next(shortest_vectors.begin(), 3 * c);
+      T d2 = std::transform_reduce(v, std::next(v, 3), v, T(0));
       if (d2 < tol)
-        return cell;
+        return cells[c];
     }
 
     return -1;
@@ -610,6 +1412,91 @@ compute_closest_entity(const BoundingBoxTree<T>& tree,
   return entities;
 }
 
+/// @brief Compute the `k` closest mesh entities to points.
+///
+/// Uses a best-first branch-and-bound search of the tree, where the
+/// exact distance (see geometry::squared_distance) is only computed
+/// for entities whose bounding box is closer than the `k`th closest
+/// entity found so far.
+///
+/// @param[in] tree The bounding box tree for the entities
+/// @param[in] mesh The mesh
+/// @param[in] points The set of points (`shape=(num_points, 3)`).
+/// Storage is row-major.
+/// @param[in] k Number of entities to find for each point
+/// @param[in] num_threads Number of threads to use
+/// @return For each point, the indices of the `k` closest entities
+/// (fewer if the tree has less than `k` entities), sorted by increasing
+/// distance.
+template <std::floating_point T>
+graph::AdjacencyList<std::int32_t>
+compute_nearest_entities(const BoundingBoxTree<T>& tree,
+                         const mesh::Mesh<T>& mesh, std::span<const T> points,
+                         int k, int num_threads = 1)
+{
+  if (k < 0)
+    throw std::runtime_error("Number of entities must be non-negative.");
+  if (tree.num_bboxes() == 0 or k == 0)
+  {
+    return graph::AdjacencyList(
+        std::vector<std::int32_t>(),
+        std::vector<std::int32_t>(points.size() / 3 + 1, 0));
+  }
+
+  return impl::_compute_point_entities(
+      points.size() / 3, num_threads,
+      [&tree, &mesh, points, k,
+       queue = std::vector<std::pair<T, std::int32_t>>(),
+       nearest = std::vector<std::pair<T, std::int32_t>>()](
+          std::size_t p, std::vector<std::int32_t>& entities) mutable
+      {
+        impl::_compute_nearest_entities(
+            tree, mesh, std::span<const T, 3>(points.data() + 3 * p, 3), k,
+            queue, nearest);
+        for (auto& e : nearest)
+          entities.push_back(e.second);
+      });
+}
+
+/// @brief Compute the mesh entities within a distance of points.
+///
+/// @param[in] tree The bounding box tree for the entities
+/// @param[in] mesh The mesh
+/// @param[in] points The set of points (`shape=(num_points, 3)`).
+/// Storage is row-major.
+/// @param[in] radius The distance
+/// @param[in] num_threads Number of threads to use
+/// @return For each point, the indices of the entities with distance
+/// (see geometry::squared_distance) less than or equal to `radius`,
+/// sorted by increasing distance.
+template <std::floating_point T>
+graph::AdjacencyList<std::int32_t>
+compute_entities_in_radius(const BoundingBoxTree<T>& tree,
+                           const mesh::Mesh<T>& mesh,
+                           std::span<const T> points, T radius,
+                           int num_threads = 1)
+{
+  if (tree.num_bboxes() == 0 or radius < 0)
+  {
+    return graph::AdjacencyList(
+        std::vector<std::int32_t>(),
+        std::vector<std::int32_t>(points.size() / 3 + 1, 0));
+  }
+
+  return impl::_compute_point_entities(
+      points.size() / 3, num_threads,
+      [&tree, &mesh, points, radius, stack = std::vector<std::int32_t>(),
+       found = std::vector<std::pair<T, std::int32_t>>()](
+          std::size_t p, std::vector<std::int32_t>& entities) mutable
+      {
+        impl::_compute_entities_in_radius(
+            tree, mesh, std::span<const T, 3>(points.data() + 3 * p, 3),
+            radius * radius, stack, found);
+        for (auto& e : found)
+          entities.push_back(e.second);
+      });
+}
+
 /// @brief Compute which cells collide with a point.
 ///
 /// @note Uses the GJK algorithm, see geometry::compute_distance_gjk for
@@ -655,6 +1542,241 @@ graph::AdjacencyList<std::int32_t> compute_colliding_cells(
   return graph::AdjacencyList(std::move(colliding_cells), std::move(offsets));
 }
 
+namespace impl
+{
+/// @brief Distance outside the reference cell of a point in reference
+/// coordinates, through each facet of the cell.
+///
+/// @param[in] cell_type Cell type, not a prism or pyramid
+/// @param[in] X The point (reference coordinates)
+/// @return `d[i]` is positive if the point is on the outside of
+/// reference facet `i`. Entries beyond the number of facets are
+/// `-infinity`.
+template <std::floating_point T>
+std::array<T, 6> reference_facet_distance(mesh::CellType cell_type,
+                                          std::span<const T> X)
+{
+  std::array<T, 6> d;
+  d.fill(-std::numeric_limits<T>::infinity());
+  switch (cell_type)
+  {
+  case mesh::CellType::interval:
+    d[0] = -X[0];
+    d[1] = X[0] - 1;
+    break;
+  case mesh::CellType::triangle:
+    // Facet i is opposite vertex i
+    d[0] = X[0] + X[1] - 1;
+    d[1] = -X[0];
+    d[2] = -X[1];
+    break;
+  case mesh::CellType::tetrahedron:
+    d[0] = X[0] + X[1] + X[2] - 1;
+    d[1] = -X[0];
+    d[2] = -X[1];
+    d[3] = -X[2];
+    break;
+  case mesh::CellType::quadrilateral:
+    d[0] = -X[1];
+    d[1] = -X[0];
+    d[2] = X[0] - 1;
+    d[3] = X[1] - 1;
+    break;
+  case mesh::CellType::hexahedron:
+    d[0] = -X[2];
+    d[1] = -X[1];
+    d[2] = -X[0];
+    d[3] = X[0] - 1;
+    d[4] = X[1] - 1;
+    d[5] = X[2] - 1;
+    break;
+  default:
+    throw std::runtime_error("Unsupported cell type for point location.");
+  }
+  return d;
+}
+} // namespace impl
+
+/// @brief Locate points in the cells of a mesh, starting from a guess
+/// of the cell that contains each point.
+///
+/// This is intended for points that move by a small distance relative
+/// to the cell size between calls, e.g. particles. For each point,
+/// the guessed cell is tested first by pulling back the point to the
+/// reference cell. If the point is outside, the search walks to the
+/// neighbour across the facet that the point is furthest outside of,
+/// for up to `max_steps` cells. If the walk leaves the cells of this
+/// process or does not find the point, the bounding box tree is
+/// searched and the candidate cells are tested by
+/// geometry::compute_first_colliding_cell. The cost per point is
+/// independent of the mesh size when the guesses are good.
+///
+/// Points with status PointLocation::not_found are not in a cell on
+/// this process. They can be passed (as a single batch) to
+/// geometry::determine_point_ownership to find the process that owns
+/// them.
+///
+/// @note Walking is used for meshes with `gdim == tdim` and cells that
+/// are not prisms or pyramids. Otherwise only the tree is searched.
+///
+/// @param[in] mesh The mesh
+/// @param[in] tree Bounding box tree for the cells of the mesh
+/// @param[in] points Points to locate (`shape=(num_points, 3)`).
+/// Storage is row-major.
+/// @param[in] guesses Guess of the cell (local index) that contains
+/// each point, or -1 if there is no guess.
+/// @param[in] max_steps Maximum number of cells to walk through from
+/// the guessed cell
+/// @return (cell containing each point or -1, how each point was
+/// located)
+template <std::floating_point T>
+std::pair<std::vector<std::int32_t>, std::vector<PointLocation>>
+locate_points(const mesh::Mesh<T>& mesh, const BoundingBoxTree<T>& tree,
+              std::span<const T> points,
+              std::span<const std::int32_t> guesses, int max_steps = 16)
+{
+  namespace md = MDSPAN_IMPL_STANDARD_NAMESPACE;
+  using cmap_t = fem::CoordinateElement<T>;
+  using mdspan2_t = typename cmap_t::template mdspan2_t<T>;
+  using cmdspan2_t = typename cmap_t::template mdspan2_t<const T>;
+
+  const std::size_t num_points = points.size() / 3;
+  if (guesses.size() != num_points)
+    throw std::runtime_error("Number of guesses and points do not match.");
+
+  auto topology = mesh.topology();
+  assert(topology);
+  const int tdim = topology->dim();
+  const mesh::Geometry<T>& geometry = mesh.geometry();
+  const std::size_t gdim = geometry.dim();
+  const mesh::CellType cell_type = topology->cell_type();
+  const bool walk = tdim > 0 and static_cast<int>(gdim) == tdim
+                    and cell_type != mesh::CellType::prism
+                    and cell_type != mesh::CellType::pyramid;
+
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> c_to_f, f_to_c;
+  if (walk)
+  {
+    mesh.topology_mutable()->create_connectivity(tdim, tdim - 1);
+    mesh.topology_mutable()->create_connectivity(tdim - 1, tdim);
+    c_to_f = topology->connectivity(tdim, tdim - 1);
+    f_to_c = topology->connectivity(tdim - 1, tdim);
+  }
+
+  const cmap_t& cmap = geometry.cmap();
+  std::span<const T> x_g = geometry.x();
+  auto x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.extent(1);
+  std::vector<T> coord_dofs_b(num_dofs_g * gdim);
+  mdspan2_t coord_dofs(coord_dofs_b.data(), num_dofs_g, gdim);
+
+  // Derivatives of the geometry basis at the reference origin, for
+  // affine maps
+  std::array<std::size_t, 4> phi0_shape = cmap.tabulate_shape(1, 1);
+  std::vector<T> phi0_b(
+      std::reduce(phi0_shape.begin(), phi0_shape.end(), 1, std::multiplies{}));
+  md::mdspan<const T, md::dextents<std::size_t, 4>> phi0(phi0_b.data(),
+                                                          phi0_shape);
+  if (walk and cmap.is_affine())
+  {
+    cmap.tabulate(1, std::vector<T>(tdim), {1, std::size_t(tdim)}, phi0_b);
+  }
+  auto dphi0
+      = md::submdspan(phi0, std::pair(1, tdim + 1), 0, md::full_extent, 0);
+  std::vector<T> J_b(gdim * tdim), K_b(tdim * gdim);
+  mdspan2_t J(J_b.data(), gdim, tdim);
+  mdspan2_t K(K_b.data(), tdim, gdim);
+
+  // Distance of point p outside cell c through each facet, in the
+  // reference cell. Returns std::nullopt if the point cannot be pulled
+  // back.
+  auto facet_distance = [&](std::size_t p,
+                            std::int32_t c) -> std::optional<std::array<T, 6>>
+  {
+    auto x_dofs = md::submdspan(x_dofmap, c, md::full_extent);
+    for (std::size_t i = 0; i < num_dofs_g; ++i)
+      for (std::size_t j = 0; j < gdim; ++j)
+        coord_dofs(i, j) = x_g[3 * x_dofs[i] + j];
+
+    std::array<T, 3> X = {0, 0, 0};
+    mdspan2_t _X(X.data(), 1, tdim);
+    cmdspan2_t x(points.data() + 3 * p, 1, gdim);
+    if (cmap.is_affine())
+    {
+      cmap_t::compute_jacobian(dphi0, coord_dofs, J);
+      cmap_t::compute_jacobian_inverse(J, K);
+      std::array<T, 3> x0 = {0, 0, 0};
+      for (std::size_t j = 0; j < gdim; ++j)
+        x0[j] = coord_dofs(0, j);
+      cmap_t::pull_back_affine(_X, K, x0, x);
+    }
+    else
+    {
+      // The Newton method may not converge, e.g. for a point far
+      // outside the cell
+      std::uint8_t converged = 0;
+      cmap.pull_back_nonaffine(
+          _X, x,
+          typename cmap_t::template mdspan3_t<const T>(coord_dofs_b.data(), 1,
+                                                       num_dofs_g, gdim),
+          std::span(&converged, 1));
+      if (!converged)
+        return std::nullopt;
+    }
+
+    return impl::reference_facet_distance<T>(cell_type,
+                                             std::span<const T>(X.data(), 3));
+  };
+
+  // Tolerance (in reference coordinates) for a point on a facet
+  const T tol = 100 * std::numeric_limits<T>::epsilon();
+
+  std::vector<std::int32_t> cells(num_points, -1);
+  std::vector<PointLocation> status(num_points, PointLocation::not_found);
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    // Walk from the guessed cell
+    std::int32_t c = guesses[p];
+    for (int step = 0; walk and c >= 0 and step <= max_steps; ++step)
+    {
+      std::optional<std::array<T, 6>> d = facet_distance(p, c);
+      if (!d)
+        break;
+
+      auto it = std::ranges::max_element(*d);
+      if (*it <= tol)
+      {
+        cells[p] = c;
+        status[p] = step == 0 ? PointLocation::guess : PointLocation::walk;
+        break;
+      }
+
+      // Move to the neighbour across the facet, if there is one
+      const std::int32_t f = c_to_f->links(c)[std::distance(d->begin(), it)];
+      auto fc = f_to_c->links(f);
+      c = fc.size() == 2 ? (fc[0] == c ? fc[1] : fc[0]) : -1;
+    }
+
+    if (cells[p] == -1)
+    {
+      // Search the bounding box tree
+      std::span<const T, 3> x(points.data() + 3 * p, 3);
+      std::vector<std::int32_t> candidates;
+      impl::_compute_collisions_point(tree, x, candidates);
+      std::int32_t cell = compute_first_colliding_cell(
+          mesh, candidates, std::array<T, 3>{x[0], x[1], x[2]},
+          10 * std::numeric_limits<T>::epsilon());
+      if (cell >= 0)
+      {
+        cells[p] = cell;
+        status[p] = PointLocation::tree;
+      }
+    }
+  }
+
+  return {std::move(cells), std::move(status)};
+}
+
 /// @brief Given a set of points, determine which process is colliding,
 /// using the GJK algorithm on cells to determine collisions.
 ///
@@ -667,6 +1789,8 @@ graph::AdjacencyList<std::int32_t> compute_colliding_cells(
 /// Each bounding box of the mesh is padded with this amount, to increase
 /// the number of candidates, avoiding rounding errors in determining the owner
 /// of a point if the point is on the surface of a cell in the mesh.
+/// @param[in] search Search structure for the candidate cells of the
+/// points. The result does not depend on the choice.
 /// @return Tuple `(src_owner, dest_owner, dest_points, dest_cells)`,
 /// where src_owner is a list of ranks corresponding to the input
 /// points. dest_owner is a list of ranks corresponding to dest_points,
@@ -683,9 +1807,9 @@ graph::AdjacencyList<std::int32_t> compute_colliding_cells(
 /// one has to determine the closest cell among all processes with an
 /// intersecting bounding box, which is an expensive operation to perform.
 template <std::floating_point T>
-PointOwnershipData<T> determine_point_ownership(const mesh::Mesh<T>& mesh,
-                                                std::span<const T> points,
-                                                T padding)
+PointOwnershipData<T> determine_point_ownership(
+    const mesh::Mesh<T>& mesh, std::span<const T> points, T padding,
+    CellSearch search = CellSearch::bounding_box_tree)
 {
   MPI_Comm comm = mesh.comm();
 
@@ -697,13 +1821,40 @@ PointOwnershipData<T> determine_point_ownership(const mesh::Mesh<T>& mesh,
   // NOTE: Should we send the cells in as input?
   std::vector<std::int32_t> cells(num_cells, 0);
   std::iota(cells.begin(), cells.end(), 0);
-  BoundingBoxTree bb(mesh, tdim, cells, padding);
-  BoundingBoxTree global_bbtree = bb.create_global_tree(comm);
+  std::optional<BoundingBoxTree<T>> bb;
+  std::optional<GridLocator<T>> grid;
+  if (search == CellSearch::grid)
+    grid.emplace(mesh, tdim, cells, padding);
+  else
+    bb.emplace(mesh, tdim, cells, padding);
+  // A few boxes per process are used for the global tree, which
+  // reduces the number of processes that the points are sent to for
+  // non-convex partitions
+  constexpr int num_global_boxes = 4;
+  BoundingBoxTree global_bbtree
+      = grid ? grid->create_global_tree(comm)
+             : bb->create_global_tree(comm, num_global_boxes);
 
   // Compute collisions:
   // For each point in `points` get the processes it should be sent to
   graph::AdjacencyList collisions = compute_collisions(global_bbtree, points);
 
+  // Remove repeated processes (from processes with more than one box)
+  {
+    std::vector<std::int32_t> ranks, offsets(1, 0);
+    ranks.reserve(collisions.array().size());
+    offsets.reserve(collisions.num_nodes() + 1);
+    for (std::int32_t i = 0; i < collisions.num_nodes(); ++i)
+    {
+      auto links = collisions.links(i);
+      auto it = ranks.insert(ranks.end(), links.begin(), links.end());
+      std::sort(it, ranks.end());
+      ranks.erase(std::unique(it, ranks.end()), ranks.end());
+      offsets.push_back(ranks.size());
+    }
+    collisions = graph::AdjacencyList(std::move(ranks), std::move(offsets));
+  }
+
   // Get unique list of outgoing ranks
   std::vector<std::int32_t> out_ranks = collisions.array();
   std::ranges::sort(out_ranks);
@@ -780,9 +1931,11 @@ PointOwnershipData<T> determine_point_ownership(const mesh::Mesh<T>& mesh,
   auto x_dofmap = geometry.dofmap();
 
   // Compute candidate cells for collisions (and extrapolation)
+  std::span<const T> _received_points(received_points.data(),
+                                      received_points.size());
   const graph::AdjacencyList<std::int32_t> candidate_collisions
-      = compute_collisions(bb, std::span<const T>(received_points.data(),
-                                                  received_points.size()));
+      = grid ? compute_collisions(*grid, _received_points)
+             : compute_collisions(*bb, _received_points);
 
   // Each process checks which points collide with a cell on the process
   const int rank = dolfinx::MPI::rank(comm);
@@ -862,6 +2015,7 @@ PointOwnershipData<T> determine_point_ownership(const mesh::Mesh<T>& mesh,
 
   std::vector<T> squared_distances(received_points.size() / 3, -1);
 
+  std::vector<T> gjk_points, gjk_nodes, gjk_vectors;
   for (std::size_t i = 0; i < dest_extrapolate.size(); i++)
   {
     if (dest_extrapolate[i] == 1)
@@ -870,27 +2024,38 @@ PointOwnershipData<T> determine_point_ownership(const mesh::Mesh<T>& mesh,
       std::array<T, 3> point;
       std::copy_n(std::next(received_points.begin(), 3 * i), 3, point.begin());
 
-      // Find shortest distance among cells with colldiing bounding box
-      T shortest_distance = std::numeric_limits<T>::max();
-      std::int32_t closest_cell = -1;
-      for (auto cell : candidate_collisions.links(i))
+      // Find shortest distance among cells with colliding bounding box,
+      // computing the distances to all candidates in one batch
+      auto candidates = candidate_collisions.links(i);
+      const std::size_t num_nodes = x_dofmap.extent(1);
+      gjk_points.resize(3 * candidates.size());
+      gjk_nodes.resize(3 * num_nodes * candidates.size());
+      gjk_vectors.resize(3 * candidates.size());
+      for (std::size_t c = 0; c < candidates.size(); ++c)
       {
         auto dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-            x_dofmap, cell, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-        std::vector<T> nodes(3 * dofs.size());
-        for (std::size_t j = 0; j < dofs.size(); ++j)
+            x_dofmap, candidates[c],
+            MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+        for (std::size_t j = 0; j < num_nodes; ++j)
         {
           const int pos = 3 * dofs[j];
           for (std::size_t k = 0; k < 3; ++k)
-            nodes[3 * j + k] = geom_dofs[pos + k];
+            gjk_nodes[3 * (c * num_nodes + j) + k] = geom_dofs[pos + k];
         }
-        const std::array<T, 3> d = compute_distance_gjk<T>(
-            std::span<const T>(point.data(), point.size()), nodes);
+        std::ranges::copy(point, std::next(gjk_points.begin(), 3 * c));
+      }
+      compute_distances_gjk<T>(gjk_points, gjk_nodes, gjk_vectors);
+
+      T shortest_distance = std::numeric_limits<T>::max();
+      std::int32_t closest_cell = -1;
+      for (std::size_t c = 0; c < candidates.size(); ++c)
+      {
+        auto d = std::next(gjk_vectors.begin(), 3 * c);
         if (T current_distance = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
             current_distance < shortest_distance)
         {
           shortest_distance = current_distance;
-          closest_cell = cell;
+          closest_cell = candidates[c];
         }
       }
       closest_cells[i] = closest_cell;
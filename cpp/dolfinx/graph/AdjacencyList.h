@@ -9,6 +9,7 @@
 #include <cassert>
 #include <concepts>
 #include <cstdint>
+#include <dolfinx/common/memory.h>
 #include <numeric>
 #include <span>
 #include <sstream>
@@ -22,10 +23,21 @@ namespace dolfinx::graph
 /// contiguous list of nodes [0, 1, 2, ..., n) it stores the connected
 /// nodes. The representation is strictly local, i.e. it is not parallel
 /// aware.
-template <typename T>
+///
+/// @tparam T Link (edge) type.
+/// @tparam O Offset type. The total number of links must be
+/// representable by `O`, so `std::int64_t` offsets are needed for
+/// lists with more than 2^31 - 1 links.
+template <typename T, std::signed_integral O = std::int32_t>
 class AdjacencyList
 {
 public:
+  /// Link type
+  using value_type = T;
+
+  /// Offset type
+  using offset_type = O;
+
   /// Construct trivial adjacency list where each of the n nodes is
   /// connected to itself
   /// @param [in] n Number of nodes
@@ -42,12 +54,12 @@ public:
   template <typename U, typename V>
     requires std::is_convertible_v<std::remove_cvref_t<U>, std::vector<T>>
                  and std::is_convertible_v<std::remove_cvref_t<V>,
-                                           std::vector<std::int32_t>>
+                                           std::vector<O>>
   AdjacencyList(U&& data, V&& offsets)
       : _array(std::forward<U>(data)), _offsets(std::forward<V>(offsets))
   {
     _array.reserve(_offsets.back());
-    assert(_offsets.back() == (std::int32_t)_array.size());
+    assert(_offsets.back() == (O)_array.size());
   }
 
   /// Set all connections for all entities (T is a '2D' container, e.g.
@@ -131,10 +143,20 @@ public:
   std::vector<T>& array() { return _array; }
 
   /// Offset for each node in array() (const version)
-  const std::vector<std::int32_t>& offsets() const { return _offsets; }
+  const std::vector<O>& offsets() const { return _offsets; }
 
   /// Offset for each node in array()
-  std::vector<std::int32_t>& offsets() { return _offsets; }
+  std::vector<O>& offsets() { return _offsets; }
+
+  /// @brief Memory used by the adjacency list.
+  /// @return Memory usage, with the links and offsets as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"AdjacencyList", sizeof(*this), {}};
+    usage.add("array", common::capacity_bytes(_array));
+    usage.add("offsets", common::capacity_bytes(_offsets));
+    return usage;
+  }
 
   /// Informal string representation (pretty-print)
   /// @return String representation of the adjacency list
@@ -158,12 +180,13 @@ private:
   std::vector<T> _array;
 
   // Position of first connection for each entity (using local index)
-  std::vector<std::int32_t> _offsets;
+  std::vector<O> _offsets;
 };
 
 /// @private Deduction
 template <typename T, typename U>
-AdjacencyList(T, U) -> AdjacencyList<typename T::value_type>;
+AdjacencyList(T, U)
+    -> AdjacencyList<typename T::value_type, typename U::value_type>;
 
 /// @brief Construct a constant degree (valency) adjacency list.
 ///
@@ -0,0 +1,165 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "AdjacencyList.h"
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/memory.h>
+#include <iterator>
+#include <vector>
+
+namespace dolfinx::graph
+{
+/// @brief A read-only adjacency list with the links of each node stored
+/// in compressed form.
+///
+/// The links of a node are stored as the differences between
+/// consecutive links (the first link is stored as is), zigzag encoded
+/// and written as variable length (LEB128) integers, following the
+/// number of links of the node. Connectivity such as cell-to-vertex
+/// links, where the links of a node are numerically close, typically
+/// needs one or two bytes per link instead of four or eight.
+///
+/// The links of a node are decoded on access, so the compressed list is
+/// intended for connectivity that is stored for a long time but
+/// accessed rarely. Use AdjacencyList for connectivity that is
+/// traversed often.
+///
+/// @tparam T Link (edge) type.
+template <std::integral T>
+class CompressedAdjacencyList
+{
+public:
+  /// Link type
+  using value_type = T;
+
+  /// @brief Compress an adjacency list.
+  /// @param[in] list The adjacency list to compress. The order of the
+  /// links of each node is preserved.
+  template <std::signed_integral O>
+  explicit CompressedAdjacencyList(const AdjacencyList<T, O>& list)
+  {
+    _offsets.reserve(list.num_nodes() + 1);
+    _offsets.push_back(0);
+    _data.reserve(list.array().size() + list.num_nodes());
+    for (std::int32_t n = 0; n < list.num_nodes(); ++n)
+    {
+      auto links = list.links(n);
+      write(links.size());
+      std::int64_t prev = 0;
+      for (T link : links)
+      {
+        std::int64_t d = static_cast<std::int64_t>(link) - prev;
+        write((static_cast<std::uint64_t>(d) << 1) ^ (d < 0 ? ~0ull : 0ull));
+        prev = link;
+      }
+      _offsets.push_back(_data.size());
+    }
+    _data.shrink_to_fit();
+  }
+
+  /// @brief Number of nodes.
+  std::int32_t num_nodes() const { return _offsets.size() - 1; }
+
+  /// @brief Number of links of a node.
+  /// @param[in] node Node index
+  int num_links(std::size_t node) const
+  {
+    assert(node + 1 < _offsets.size());
+    const std::uint8_t* p = _data.data() + _offsets[node];
+    return read(p);
+  }
+
+  /// @brief Decode the links of a node.
+  /// @param[in] node Node index
+  /// @param[out] links The links of the node. It is resized to the
+  /// number of links.
+  void links(std::size_t node, std::vector<T>& links) const
+  {
+    assert(node + 1 < _offsets.size());
+    const std::uint8_t* p = _data.data() + _offsets[node];
+    links.resize(read(p));
+    std::int64_t prev = 0;
+    for (T& link : links)
+    {
+      std::uint64_t z = read(p);
+      prev += static_cast<std::int64_t>(z >> 1)
+              ^ -static_cast<std::int64_t>(z & 1);
+      link = static_cast<T>(prev);
+    }
+  }
+
+  /// @brief Decode all links.
+  /// @return The uncompressed adjacency list.
+  template <std::signed_integral O = std::int32_t>
+  AdjacencyList<T, O> decompress() const
+  {
+    std::vector<O> offsets(1, 0);
+    offsets.reserve(_offsets.size());
+    for (std::size_t n = 0; n + 1 < _offsets.size(); ++n)
+      offsets.push_back(offsets.back() + num_links(n));
+
+    std::vector<T> array(offsets.back());
+    std::vector<T> links;
+    for (std::size_t n = 0; n + 1 < _offsets.size(); ++n)
+    {
+      this->links(n, links);
+      std::copy(links.begin(), links.end(),
+                std::next(array.begin(), offsets[n]));
+    }
+    return AdjacencyList<T, O>(std::move(array), std::move(offsets));
+  }
+
+  /// @brief Equality operator
+  bool operator==(const CompressedAdjacencyList& list) const = default;
+
+  /// @brief Memory used by the compressed adjacency list.
+  /// @return Memory usage, with the encoded links and offsets as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"CompressedAdjacencyList", sizeof(*this), {}};
+    usage.add("data", common::capacity_bytes(_data));
+    usage.add("offsets", common::capacity_bytes(_offsets));
+    return usage;
+  }
+
+private:
+  // Append a variable length integer to the data
+  void write(std::uint64_t v)
+  {
+    while (v >= 0x80)
+    {
+      _data.push_back(static_cast<std::uint8_t>(v | 0x80));
+      v >>= 7;
+    }
+    _data.push_back(static_cast<std::uint8_t>(v));
+  }
+
+  // Read a variable length integer and advance the data pointer
+  static std::uint64_t read(const std::uint8_t*& p)
+  {
+    std::uint64_t v = 0;
+    for (int shift = 0;; shift += 7)
+    {
+      std::uint8_t b = *p++;
+      v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+      if (b < 0x80)
+        return v;
+    }
+  }
+
+  // Encoded number of links and links of all nodes
+  std::vector<std::uint8_t> _data;
+
+  // Position in the data of each node
+  std::vector<std::int64_t> _offsets;
+};
+
+} // namespace dolfinx::graph
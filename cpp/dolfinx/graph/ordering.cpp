@@ -7,10 +7,15 @@
 #include "ordering.h"
 #include "AdjacencyList.h"
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <atomic>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/sort.h>
 #include <limits>
+#include <numeric>
 #include <span>
 
 using namespace dolfinx;
@@ -201,7 +206,7 @@ gps_reorder_unlabelled(const graph::AdjacencyList<std::int32_t>& graph,
 
   assert(lv.num_nodes() == lu.num_nodes());
   const int k = lv.num_nodes();
-  spdlog::info("GPS pseudo-diameter:({}) {}-{}", k, u, v);
+  DOLFINX_LOG_INFO("GPS pseudo-diameter:({}) {}-{}", k, u, v);
 
   // ALGORITHM II. Minimizing level width.
 
@@ -353,6 +358,172 @@ gps_reorder_unlabelled(const graph::AdjacencyList<std::int32_t>& graph,
   return rv;
 }
 
+//-----------------------------------------------------------------------------
+/// @brief Transform integer coordinates to the 'transposed' Hilbert
+/// index (J. Skilling, Programming the Hilbert curve, AIP Conference
+/// Proceedings 707, 2004).
+/// @param[in,out] x Coordinates in `[0, 2^b)` in each direction
+/// @param[in] n Number of directions
+/// @param[in] b Number of bits per direction
+void hilbert_transpose(std::array<std::uint64_t, 3>& x, int n, int b)
+{
+  const std::uint64_t m = std::uint64_t(1) << (b - 1);
+
+  // Inverse undo
+  for (std::uint64_t q = m; q > 1; q >>= 1)
+  {
+    const std::uint64_t p = q - 1;
+    for (int i = 0; i < n; ++i)
+    {
+      if (x[i] & q)
+        x[0] ^= p;
+      else
+      {
+        const std::uint64_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (int i = 1; i < n; ++i)
+    x[i] ^= x[i - 1];
+  std::uint64_t t = 0;
+  for (std::uint64_t q = m; q > 1; q >>= 1)
+    if (x[n - 1] & q)
+      t ^= q - 1;
+  for (int i = 0; i < n; ++i)
+    x[i] ^= t;
+}
+//-----------------------------------------------------------------------------
+// Find a pseudo-peripheral node in the connected component that
+// contains node s by repeatedly moving to a node of minimum degree in
+// the last level of the level structure while the depth increases
+int pseudo_peripheral_node(const graph::AdjacencyList<int>& graph, int s)
+{
+  graph::AdjacencyList<int> ls = create_level_structure(graph, s);
+  while (true)
+  {
+    auto last = ls.links(ls.num_nodes() - 1);
+    int x = *std::ranges::min_element(last, std::less{}, [&graph](int v)
+                                      { return graph.num_links(v); });
+    graph::AdjacencyList<int> lx = create_level_structure(graph, x);
+    if (lx.num_nodes() <= ls.num_nodes())
+      return s;
+    s = x;
+    ls = std::move(lx);
+  }
+}
+//-----------------------------------------------------------------------------
+// Append the Cuthill-McKee ordering of the connected component that
+// contains node s to `order`, and set pos[v] to the position of each
+// node v of the component in `order`. The nodes of each level are
+// ordered by (lowest position of a neighbour in the previous level,
+// degree, node index). Levels with at least `min_parallel_width` nodes
+// are processed using `num_threads` threads. `parent` is workspace of
+// size graph.num_nodes() with all entries equal to -1.
+void cuthill_mckee(const graph::AdjacencyList<std::int32_t>& graph,
+                   std::int32_t s, std::vector<std::int32_t>& order,
+                   std::vector<std::int32_t>& pos,
+                   std::vector<std::int32_t>& parent, int num_threads)
+{
+  constexpr std::int32_t min_parallel_width = 4096;
+  auto degree = [&graph](std::int32_t v) { return graph.num_links(v); };
+
+  std::int32_t l0 = order.size();
+  pos[s] = l0;
+  order.push_back(s);
+
+  const int nt = std::max(num_threads, 1);
+  std::vector<std::vector<std::int32_t>> next(nt);
+  std::vector<std::int32_t> level;
+  while (l0 < static_cast<std::int32_t>(order.size()))
+  {
+    const std::int32_t l1 = order.size();
+    if (nt == 1 or l1 - l0 < min_parallel_width)
+    {
+      // Number the unnumbered neighbours of each node in turn
+      for (std::int32_t p = l0; p < l1; ++p)
+      {
+        level.clear();
+        for (std::int32_t w : graph.links(order[p]))
+        {
+          if (pos[w] == -1)
+          {
+            pos[w] = l1; // Mark as visited
+            level.push_back(w);
+          }
+        }
+        std::ranges::sort(level, [&degree](auto a, auto b)
+                          { return std::pair(degree(a), a)
+                                   < std::pair(degree(b), b); });
+        for (std::int32_t w : level)
+        {
+          pos[w] = order.size();
+          order.push_back(w);
+        }
+      }
+    }
+    else
+    {
+      // Find the unnumbered neighbours of the level, assigning each the
+      // lowest position of its neighbours in the level. The thread that
+      // first reaches a node collects it.
+      auto visit = [&, l0, l1](int t)
+      {
+        next[t].clear();
+        const std::int64_t n = l1 - l0;
+        for (std::int32_t p = l0 + t * n / nt; p < l0 + (t + 1) * n / nt;
+             ++p)
+        {
+          for (std::int32_t w : graph.links(order[p]))
+          {
+            if (pos[w] != -1)
+              continue;
+            std::atomic_ref<std::int32_t> pw(parent[w]);
+            std::int32_t q = pw.load(std::memory_order_relaxed);
+            if (q == -1 and pw.compare_exchange_strong(q, p))
+              next[t].push_back(w);
+            else
+            {
+              while (q > p and !pw.compare_exchange_weak(q, p))
+                ;
+            }
+          }
+        }
+      };
+
+      common::run_tasks(nt, visit);
+
+      level.clear();
+      for (auto& n : next)
+        level.insert(level.end(), n.begin(), n.end());
+
+      // Sort by node index and then (stable) by (parent, degree)
+      std::int64_t max_degree = 0;
+      for (std::int32_t v : level)
+        max_degree = std::max<std::int64_t>(max_degree, degree(v));
+      std::vector<std::pair<std::int64_t, std::int32_t>> keys(level.size());
+      for (std::size_t i = 0; i < level.size(); ++i)
+      {
+        std::int32_t v = level[i];
+        keys[i] = {(parent[v] - l0) * (max_degree + 1) + degree(v), v};
+        parent[v] = -1;
+      }
+      radix_sort(keys, [](const auto& k) { return k.second; }, nt);
+      radix_sort(keys, [](const auto& k) { return k.first; }, nt);
+      for (auto [k, v] : keys)
+      {
+        pos[v] = order.size();
+        order.push_back(v);
+      }
+    }
+
+    l0 = l1;
+  }
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -380,3 +551,136 @@ graph::reorder_gps(const graph::AdjacencyList<std::int32_t>& graph)
   return r;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+graph::reorder_rcm(const graph::AdjacencyList<std::int32_t>& graph,
+                   int num_threads)
+{
+  common::Timer t("RCM: reorder");
+
+  const std::int32_t n = graph.num_nodes();
+  std::vector<std::int32_t> pos(n, -1), parent(n, -1);
+  std::vector<std::int32_t> order;
+  order.reserve(n);
+
+  // Repeat for each disconnected part of the graph
+  for (std::int32_t s = 0; s < n; ++s)
+  {
+    if (pos[s] == -1)
+    {
+      cuthill_mckee(graph, pseudo_peripheral_node(graph, s), order, pos,
+                    parent, num_threads);
+    }
+  }
+  assert(static_cast<std::int32_t>(order.size()) == n);
+
+  // Reverse the ordering
+  std::vector<std::int32_t> r(n);
+  for (std::int32_t i = 0; i < n; ++i)
+    r[order[i]] = n - 1 - i;
+  return r;
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+graph::colour_greedy(const graph::AdjacencyList<std::int32_t>& graph)
+{
+  const std::int32_t num_nodes = graph.num_nodes();
+  const std::vector<std::int32_t>& links = graph.array();
+
+  // Build inverse map (link -> nodes)
+  const std::int32_t num_links
+      = links.empty() ? 0 : *std::ranges::max_element(links) + 1;
+  std::vector<std::int32_t> offsets(num_links + 1, 0);
+  for (std::int32_t l : links)
+    ++offsets[l + 1];
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::int32_t> link_to_node(offsets.back());
+  {
+    std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+    for (std::int32_t n = 0; n < num_nodes; ++n)
+      for (std::int32_t l : graph.links(n))
+        link_to_node[pos[l]++] = n;
+  }
+
+  // Assign to each node the lowest colour that is not used by a node
+  // that shares a link. marker[c] == n if colour c is used by a
+  // neighbour of node n.
+  std::vector<std::int32_t> colours(num_nodes, -1);
+  std::vector<std::int32_t> marker;
+  for (std::int32_t n = 0; n < num_nodes; ++n)
+  {
+    for (std::int32_t l : graph.links(n))
+    {
+      for (std::int32_t i = offsets[l]; i < offsets[l + 1]; ++i)
+      {
+        if (std::int32_t c = colours[link_to_node[i]]; c >= 0)
+          marker[c] = n;
+      }
+    }
+
+    auto it = std::ranges::find_if(marker, [n](auto m) { return m != n; });
+    colours[n] = std::distance(marker.begin(), it);
+    if (it == marker.end())
+      marker.push_back(-1);
+  }
+
+  // Build colour -> nodes list
+  std::vector<std::int32_t> colour_offsets(marker.size() + 1, 0);
+  for (std::int32_t c : colours)
+    ++colour_offsets[c + 1];
+  std::partial_sum(colour_offsets.begin(), colour_offsets.end(),
+                   colour_offsets.begin());
+  std::vector<std::int32_t> nodes(num_nodes);
+  {
+    std::vector<std::int32_t> pos(colour_offsets.begin(),
+                                  std::prev(colour_offsets.end()));
+    for (std::int32_t n = 0; n < num_nodes; ++n)
+      nodes[pos[colours[n]]++] = n;
+  }
+
+  return graph::AdjacencyList<std::int32_t>(std::move(nodes),
+                                            std::move(colour_offsets));
+}
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+std::vector<std::uint64_t>
+graph::space_filling_curve_index(std::span<const double> x,
+                                 std::array<std::array<double, 3>, 2> box,
+                                 SpaceFillingCurve curve)
+{
+  const std::size_t num_points = x.size() / 3;
+  auto [x0, x1] = box;
+
+  // Directions with a non-zero extent
+  std::vector<int> dirs;
+  for (int j = 0; j < 3; ++j)
+    if (x1[j] > x0[j])
+      dirs.push_back(j);
+  const int n = std::max<int>(dirs.size(), 1);
+  const int b = n == 3 ? 21 : 31;
+
+  // Index of each point along the curve
+  std::vector<std::uint64_t> keys(num_points, 0);
+  const double scale = double((std::uint64_t(1) << b) - 1);
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    std::array<std::uint64_t, 3> c = {0, 0, 0};
+    for (std::size_t i = 0; i < dirs.size(); ++i)
+    {
+      const int j = dirs[i];
+      c[i] = (x[3 * p + j] - x0[j]) / (x1[j] - x0[j]) * scale;
+    }
+
+    if (curve == SpaceFillingCurve::hilbert)
+      hilbert_transpose(c, n, b);
+
+    // Interleave the bits, most significant first
+    std::uint64_t key = 0;
+    for (int bit = b - 1; bit >= 0; --bit)
+      for (int i = 0; i < n; ++i)
+        key = (key << 1) | ((c[i] >> bit) & 1);
+    keys[p] = key;
+  }
+
+  return keys;
+}
+//-----------------------------------------------------------------------------
@@ -6,14 +6,14 @@
 
 #pragma once
 
+#include "AdjacencyList.h"
+#include <array>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace dolfinx::graph
 {
-template <typename T>
-class AdjacencyList;
-
 /// @brief Re-order a graph using the Gibbs-Poole-Stockmeyer algorithm.
 ///
 /// The algorithm is described in *An Algorithm for Reducing the
@@ -26,4 +26,73 @@ class AdjacencyList;
 std::vector<std::int32_t>
 reorder_gps(const graph::AdjacencyList<std::int32_t>& graph);
 
+/// @brief Re-order a graph using the reverse Cuthill-McKee algorithm.
+///
+/// Each connected component is numbered breadth-first from a
+/// pseudo-peripheral node, found with the algorithm in N. E. Gibbs, W.
+/// G. Poole and P. K. Stockmeyer (see ::reorder_gps), with the nodes of
+/// each level sorted by the lowest number of their neighbours in the
+/// previous level and then by degree. The numbering is then reversed.
+///
+/// The ordering is cheaper to compute than ::reorder_gps but typically
+/// gives a slightly larger bandwidth. The nodes of each level are
+/// processed in parallel when `num_threads > 1`, and the result does
+/// not depend on the number of threads.
+///
+/// @note For a dofmap, passing no reordering function to the dofmap
+/// builder retains the numbering obtained by iterating over the cells,
+/// which is the cheapest ordering and inherits the locality of the cell
+/// ordering.
+///
+/// @param[in] graph The graph to compute a re-ordering for
+/// @param[in] num_threads Number of threads used to build each level
+/// @return Reordering array `map`, where `map[i]` is the new index of
+/// node `i`
+std::vector<std::int32_t>
+reorder_rcm(const graph::AdjacencyList<std::int32_t>& graph,
+            int num_threads = 1);
+
+/// @brief Compute a greedy colouring of nodes such that no two nodes
+/// that share a link have the same colour.
+///
+/// The links of a node are interpreted as resources used by the node,
+/// e.g. the degrees-of-freedom that a cell writes to during assembly.
+/// Two nodes conflict if they share at least one link. Nodes are
+/// visited in order and each is assigned the lowest colour not already
+/// used by a conflicting node. Nodes with the same colour can be
+/// processed concurrently without write conflicts.
+///
+/// @param[in] graph Graph where `graph.links(i)` are the (non-negative)
+/// resources used by node `i`.
+/// @return Adjacency list where `links(c)` are the nodes with colour
+/// `c`, sorted in ascending order.
+graph::AdjacencyList<std::int32_t>
+colour_greedy(const graph::AdjacencyList<std::int32_t>& graph);
+
+/// Space-filling curves for ordering points
+enum class SpaceFillingCurve : int
+{
+  hilbert,
+  morton
+};
+
+/// @brief Compute the index of points along a space-filling curve.
+///
+/// The points are mapped to an integer grid over a box in the
+/// directions in which the box has a non-zero extent, with `2^31`
+/// points per direction in one and two dimensions and `2^21` in three
+/// dimensions. The Hilbert index is computed using the transform in J.
+/// Skilling, *Programming the Hilbert curve*, AIP Conference
+/// Proceedings 707, 2004.
+///
+/// @param[in] x Points (row-major, shape `(num_points, 3)`).
+/// @param[in] box Lower and upper corners of a box that contains the
+/// points.
+/// @param[in] curve The space-filling curve.
+/// @return Index of each point along the curve, in `[0, 2^63)`.
+std::vector<std::uint64_t>
+space_filling_curve_index(std::span<const double> x,
+                          std::array<std::array<double, 3>, 2> box,
+                          SpaceFillingCurve curve);
+
 } // namespace dolfinx::graph
@@ -8,14 +8,247 @@
 #include "AdjacencyList.h"
 #include "partitioners.h"
 #include <algorithm>
+#include <cstring>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 using namespace dolfinx;
 
+namespace
+{
+/// Send rows of a 2D array to destination ranks via the node leaders
+/// (see dolfinx::MPI::route_via_nodes). The rows for each destination
+/// are contiguous in `send_buffer`.
+/// @return (0) Source ranks, sorted, (1) displacement of the rows
+/// received from each source rank and (2) the received rows
+std::tuple<std::vector<int>, std::vector<std::int32_t>,
+           std::vector<std::int64_t>>
+send_rows_via_nodes(MPI_Comm comm, std::span<const int> dest,
+                    std::span<const std::int32_t> num_items_per_dest,
+                    std::span<const std::int64_t> send_buffer,
+                    std::size_t shape1)
+{
+  std::vector<int> row_dest;
+  row_dest.reserve(send_buffer.size() / shape1);
+  for (std::size_t p = 0; p < dest.size(); ++p)
+    row_dest.insert(row_dest.end(), num_items_per_dest[p], dest[p]);
+
+  auto [row_src, recv_bytes] = dolfinx::MPI::route_via_nodes(
+      comm, row_dest, std::as_bytes(send_buffer),
+      shape1 * sizeof(std::int64_t));
+  std::vector<std::int64_t> recv_buffer(shape1 * row_src.size());
+  std::memcpy(recv_buffer.data(), recv_bytes.data(), recv_bytes.size());
+
+  // Received rows are sorted by source rank
+  std::vector<int> src;
+  std::vector<std::int32_t> recv_disp = {0};
+  for (int r : row_src)
+  {
+    if (src.empty() or src.back() != r)
+    {
+      src.push_back(r);
+      recv_disp.push_back(recv_disp.back());
+    }
+    ++recv_disp.back();
+  }
+
+  return {std::move(src), std::move(recv_disp), std::move(recv_buffer)};
+}
+
+/// Build the (dest, index, owning rank) list of the rows to send,
+/// sorted, the list of unique dest ranks and the number of rows to send
+/// to each dest (by neighbourhood rank)
+std::tuple<std::vector<std::array<int, 3>>, std::vector<int>,
+           std::vector<std::int32_t>>
+sort_by_destination(const graph::AdjacencyList<std::int32_t>& destinations)
+{
+  std::vector<std::array<int, 3>> dest_to_index;
+  dest_to_index.reserve(destinations.array().size());
+  for (std::int32_t i = 0; i < destinations.num_nodes(); ++i)
+  {
+    auto di = destinations.links(i);
+    for (auto d : di)
+      dest_to_index.push_back({d, i, di[0]});
+  }
+  std::ranges::sort(dest_to_index);
+
+  std::vector<int> dest;
+  std::vector<std::int32_t> num_items_per_dest;
+  {
+    auto it = dest_to_index.begin();
+    while (it != dest_to_index.end())
+    {
+      // Store global rank and find iterator to next global rank
+      dest.push_back((*it)[0]);
+      auto it1
+          = std::find_if(it, dest_to_index.end(),
+                         [r = dest.back()](auto& idx) { return idx[0] != r; });
+
+      // Store number of items for current rank
+      num_items_per_dest.push_back(std::distance(it, it1));
+
+      // Advance iterator
+      it = it1;
+    }
+  }
+
+  return {std::move(dest_to_index), std::move(dest),
+          std::move(num_items_per_dest)};
+}
+
+/// Send rows of a 2D array to the destination ranks of a neighbourhood
+/// communicator in rounds, with at most `max_rows` rows sent to each
+/// destination in a round. The rows of the next round are packed, and
+/// the rows received in the previous round are unpacked, while a round
+/// is being communicated.
+/// @param[in] pack Function `pack(i, row)` that packs row `i` of the
+/// rows to send, which are ordered by destination, into `row`
+/// @param[in] unpack Function `unpack(p, row)` that is called for each
+/// received row, with `p` the neighbourhood index of the source rank.
+/// The rows from a source rank are unpacked in the order they were
+/// sent.
+template <typename P, typename U>
+void send_rows_in_rounds(MPI_Comm comm, MPI_Comm neigh_comm,
+                         std::span<const std::int32_t> num_send,
+                         std::span<const std::int32_t> num_recv,
+                         std::size_t shape1, std::int32_t max_rows, P pack,
+                         U unpack)
+{
+  // Number of rounds, which must be the same on all ranks
+  auto rounds = [max_rows](auto n)
+  {
+    std::int32_t m = n.empty() ? 0 : *std::ranges::max_element(n);
+    return (m + max_rows - 1) / max_rows;
+  };
+  int num_rounds = std::max(rounds(num_send), rounds(num_recv));
+  MPI_Allreduce(MPI_IN_PLACE, &num_rounds, 1, MPI_INT, MPI_MAX, comm);
+
+  std::vector<std::int32_t> send_offsets(num_send.size() + 1, 0);
+  std::partial_sum(num_send.begin(), num_send.end(),
+                   std::next(send_offsets.begin()));
+
+  // Buffers for a round
+  struct round_buffers
+  {
+    std::vector<std::int64_t> send, recv;
+    std::vector<int> send_sizes, send_disp, recv_sizes, recv_disp;
+  };
+  std::array<round_buffers, 2> buffers;
+
+  // Number of rows in round r out of n rows
+  auto round_size = [max_rows](std::int32_t n, int r) -> int
+  { return std::clamp(n - r * max_rows, 0, max_rows); };
+
+  auto pack_round = [&](int r, round_buffers& b)
+  {
+    b.send_sizes.resize(num_send.size());
+    std::ranges::transform(num_send, b.send_sizes.begin(),
+                           [&](auto n) { return round_size(n, r); });
+    b.send_disp.assign(num_send.size() + 1, 0);
+    std::partial_sum(b.send_sizes.begin(), b.send_sizes.end(),
+                     std::next(b.send_disp.begin()));
+    b.recv_sizes.resize(num_recv.size());
+    std::ranges::transform(num_recv, b.recv_sizes.begin(),
+                           [&](auto n) { return round_size(n, r); });
+    b.recv_disp.assign(num_recv.size() + 1, 0);
+    std::partial_sum(b.recv_sizes.begin(), b.recv_sizes.end(),
+                     std::next(b.recv_disp.begin()));
+
+    b.send.assign(shape1 * b.send_disp.back(), -1);
+    b.recv.resize(shape1 * b.recv_disp.back());
+    for (std::size_t j = 0; j < num_send.size(); ++j)
+    {
+      for (int k = 0; k < b.send_sizes[j]; ++k)
+      {
+        pack(send_offsets[j] + r * max_rows + k,
+             std::span(b.send.data() + (b.send_disp[j] + k) * shape1,
+                       shape1));
+      }
+    }
+
+    b.send_sizes.reserve(1);
+    b.recv_sizes.reserve(1);
+  };
+
+  MPI_Datatype compound_type;
+  MPI_Type_contiguous(shape1, MPI_INT64_T, &compound_type);
+  MPI_Type_commit(&compound_type);
+  auto start_round = [&](round_buffers& b, MPI_Request& request)
+  {
+    MPI_Ineighbor_alltoallv(b.send.data(), b.send_sizes.data(),
+                            b.send_disp.data(), compound_type, b.recv.data(),
+                            b.recv_sizes.data(), b.recv_disp.data(),
+                            compound_type, neigh_comm, &request);
+  };
+
+  MPI_Request request;
+  if (num_rounds > 0)
+  {
+    pack_round(0, buffers[0]);
+    start_round(buffers[0], request);
+  }
+  for (int r = 0; r < num_rounds; ++r)
+  {
+    round_buffers& current = buffers[r % 2];
+    round_buffers& next = buffers[(r + 1) % 2];
+    if (r + 1 < num_rounds)
+      pack_round(r + 1, next);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    if (r + 1 < num_rounds)
+      start_round(next, request);
+
+    for (std::size_t p = 0; p < num_recv.size(); ++p)
+    {
+      for (int k = 0; k < current.recv_sizes[p]; ++k)
+      {
+        unpack(p, std::span<const std::int64_t>(
+                      current.recv.data() + (current.recv_disp[p] + k) * shape1,
+                      shape1));
+      }
+    }
+  }
+
+  MPI_Type_free(&compound_type);
+}
+
+/// Create a neighbourhood communicator from this rank to the dest
+/// ranks. The source ranks are sorted to make the distribution
+/// deterministic.
+/// @return The communicator and the source ranks
+std::pair<MPI_Comm, std::vector<int>>
+create_neighbourhood(MPI_Comm comm, std::span<const int> dest)
+{
+  std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+  std::ranges::sort(src);
+  MPI_Comm neigh_comm;
+  MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
+                                 dest.size(), dest.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &neigh_comm);
+  return {neigh_comm, std::move(src)};
+}
+
+/// Exchange a fixed number of per-destination counts over a
+/// neighbourhood communicator.
+/// @param[in] send_counts `n` counts for each destination
+/// @return `n` counts from each source
+std::vector<std::int64_t>
+exchange_counts(MPI_Comm neigh_comm, std::vector<std::int64_t> send_counts,
+                std::size_t num_src, int n)
+{
+  std::vector<std::int64_t> recv_counts(n * num_src);
+  send_counts.reserve(1);
+  recv_counts.reserve(1);
+  MPI_Neighbor_alltoall(send_counts.data(), n, MPI_INT64_T, recv_counts.data(),
+                        n, MPI_INT64_T, neigh_comm);
+  return recv_counts;
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 graph::AdjacencyList<std::int32_t>
 graph::partition_graph(MPI_Comm comm, int nparts,
@@ -33,11 +266,177 @@ graph::partition_graph(MPI_Comm comm, int nparts,
 #endif
 }
 //-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> graph::partition_graph_weighted(
+    MPI_Comm comm, int nparts, const AdjacencyList<std::int64_t>& local_graph,
+    std::span<const std::int32_t> node_weights, bool ghosting)
+{
+#if HAS_PARMETIS
+  return graph::parmetis::weighted_partitioner()(comm, nparts, local_graph,
+                                                 node_weights, ghosting);
+#elif HAS_PTSCOTCH
+  return graph::scotch::weighted_partitioner()(comm, nparts, local_graph,
+                                               node_weights, ghosting);
+#elif HAS_KAHIP
+  return graph::kahip::weighted_partitioner()(comm, nparts, local_graph,
+                                              node_weights, ghosting);
+#else
+// Should never reach this point
+#endif
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+graph::extend_ghost_layers(MPI_Comm comm,
+                           const AdjacencyList<std::int64_t>& local_graph,
+                           const AdjacencyList<std::int32_t>& dest,
+                           int num_layers)
+{
+  common::Timer timer("Extend graph destination ranks by ghost layers");
+
+  if (dest.num_nodes() != local_graph.num_nodes())
+    throw std::runtime_error("Number of graph nodes and destinations differ.");
+
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  // Distribution of the graph nodes across ranks
+  std::vector<std::int64_t> node_disp(size + 1, 0);
+  {
+    const std::int64_t num_nodes = local_graph.num_nodes();
+    MPI_Allgather(&num_nodes, 1, MPI_INT64_T, node_disp.data() + 1, 1,
+                  MPI_INT64_T, comm);
+    std::partial_sum(node_disp.begin(), node_disp.end(), node_disp.begin());
+  }
+  const std::int64_t offset = node_disp[rank];
+
+  // Rank holding the target of each edge, and the neighbourhood of
+  // ranks holding off-process targets
+  std::span<const std::int64_t> edges = local_graph.array();
+  std::vector<int> edge_rank(edges.size());
+  std::ranges::transform(
+      edges, edge_rank.begin(),
+      [&node_disp](auto node)
+      {
+        auto it = std::ranges::upper_bound(node_disp, node);
+        return std::distance(node_disp.begin(), it) - 1;
+      });
+  std::vector<int> neighbours(edge_rank.begin(), edge_rank.end());
+  std::ranges::sort(neighbours);
+  {
+    auto [unique_end, range_end] = std::ranges::unique(neighbours);
+    neighbours.erase(unique_end, range_end);
+    auto it = std::ranges::lower_bound(neighbours, rank);
+    if (it != neighbours.end() and *it == rank)
+      neighbours.erase(it);
+  }
+  const std::vector<int> src
+      = dolfinx::MPI::compute_graph_edges_nbx(comm, neighbours);
+  MPI_Comm neigh_comm;
+  MPI_Dist_graph_create_adjacent(
+      comm, src.size(), src.data(), MPI_UNWEIGHTED, neighbours.size(),
+      neighbours.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, false, &neigh_comm);
+
+  std::vector<std::int32_t> data(dest.array().begin(), dest.array().end());
+  std::vector<std::int32_t> offsets(dest.offsets().begin(),
+                                    dest.offsets().end());
+  for (int layer = 0; layer < num_layers; ++layer)
+  {
+    // Wherever a node goes, so must the nodes connected to it. Collect
+    // (node, rank) pairs for local nodes and for each neighbour.
+    std::vector<std::array<std::int64_t, 2>> local;
+    std::vector<std::vector<std::array<std::int64_t, 2>>> send(
+        neighbours.size());
+    for (std::int32_t node0 = 0; node0 < local_graph.num_nodes(); ++node0)
+    {
+      std::span d0(data.data() + offsets[node0],
+                   offsets[node0 + 1] - offsets[node0]);
+      for (int r : d0)
+        local.push_back({node0, r});
+      for (std::int32_t e = local_graph.offsets()[node0];
+           e < local_graph.offsets()[node0 + 1]; ++e)
+      {
+        if (edge_rank[e] == rank)
+        {
+          for (int r : d0)
+            local.push_back({edges[e] - offset, r});
+        }
+        else
+        {
+          auto it = std::ranges::lower_bound(neighbours, edge_rank[e]);
+          auto& buffer = send[std::distance(neighbours.begin(), it)];
+          for (int r : d0)
+            buffer.push_back({edges[e], r});
+        }
+      }
+    }
+
+    std::vector<std::int64_t> send_buffer;
+    std::vector<int> send_sizes(neighbours.size());
+    for (std::size_t p = 0; p < send.size(); ++p)
+    {
+      std::ranges::sort(send[p]);
+      auto [unique_end, range_end] = std::ranges::unique(send[p]);
+      send[p].erase(unique_end, range_end);
+      for (auto [node, r] : send[p])
+        send_buffer.insert(send_buffer.end(), {node, r});
+      send_sizes[p] = 2 * send[p].size();
+    }
+    std::vector<int> send_disp(send_sizes.size() + 1, 0);
+    std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                     std::next(send_disp.begin()));
+
+    std::vector<int> recv_sizes(src.size());
+    send_sizes.reserve(1);
+    recv_sizes.reserve(1);
+    MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1,
+                          MPI_INT, neigh_comm);
+    std::vector<int> recv_disp(recv_sizes.size() + 1, 0);
+    std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                     std::next(recv_disp.begin()));
+    std::vector<std::int64_t> recv_buffer(recv_disp.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), send_sizes.data(),
+                           send_disp.data(), MPI_INT64_T, recv_buffer.data(),
+                           recv_sizes.data(), recv_disp.data(), MPI_INT64_T,
+                           neigh_comm);
+    for (std::size_t i = 0; i < recv_buffer.size(); i += 2)
+    {
+      assert(recv_buffer[i] >= offset and recv_buffer[i] < node_disp[rank + 1]);
+      local.push_back({recv_buffer[i] - offset, recv_buffer[i + 1]});
+    }
+
+    std::ranges::sort(local);
+    auto [unique_end, range_end] = std::ranges::unique(local);
+    local.erase(unique_end, range_end);
+
+    // Rebuild the destinations, keeping the owning rank first
+    std::vector<std::int32_t> owners(local_graph.num_nodes());
+    for (std::size_t i = 0; i < owners.size(); ++i)
+      owners[i] = data[offsets[i]];
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (auto [node, r] : local)
+      ++offsets[node + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    data.resize(offsets.back());
+    std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+    for (auto [node, r] : local)
+      data[pos[node]++] = r;
+    for (std::size_t i = 0; i < owners.size(); ++i)
+    {
+      auto d = std::span(data.data() + offsets[i], offsets[i + 1] - offsets[i]);
+      std::iter_swap(d.begin(), std::ranges::find(d, owners[i]));
+    }
+  }
+
+  MPI_Comm_free(&neigh_comm);
+
+  return AdjacencyList<std::int32_t>(std::move(data), std::move(offsets));
+}
+//-----------------------------------------------------------------------------
 std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
            std::vector<std::int64_t>, std::vector<int>>
 graph::build::distribute(MPI_Comm comm,
                          const graph::AdjacencyList<std::int64_t>& list,
-                         const graph::AdjacencyList<std::int32_t>& destinations)
+                         const graph::AdjacencyList<std::int32_t>& destinations,
+                         dolfinx::MPI::Routing routing)
 {
   common::Timer timer("Distribute AdjacencyList nodes to destination ranks");
 
@@ -56,7 +455,9 @@ graph::build::distribute(MPI_Comm comm,
   // Get the maximum number of edges for a node
   int shape1 = 0;
   {
-    int shape1_local = list.num_nodes() > 0 ? list.links(0).size() : 0;
+    int shape1_local = 0;
+    for (std::int32_t i = 0; i < list.num_nodes(); ++i)
+      shape1_local = std::max(shape1_local, list.num_links(i));
     MPI_Allreduce(&shape1_local, &shape1, 1, MPI_INT, MPI_MAX, comm);
   }
 
@@ -64,68 +465,16 @@ graph::build::distribute(MPI_Comm comm,
   // and node global index)
   const std::size_t buffer_shape1 = shape1 + 3;
 
-  // Build (dest, index, owning rank) list and sort
-  std::vector<std::array<int, 3>> dest_to_index;
-  dest_to_index.reserve(destinations.array().size());
-  for (std::int32_t i = 0; i < destinations.num_nodes(); ++i)
-  {
-    auto di = destinations.links(i);
-    for (auto d : di)
-      dest_to_index.push_back({d, i, di[0]});
-  }
-  std::ranges::sort(dest_to_index);
-
-  // Build list of unique dest ranks and count number of rows to send to
-  // each dest (by neighbourhood rank)
-  std::vector<int> dest;
-  std::vector<std::int32_t> num_items_per_dest;
-  {
-    auto it = dest_to_index.begin();
-    while (it != dest_to_index.end())
-    {
-      // Store global rank and find iterator to next global rank
-      dest.push_back((*it)[0]);
-      auto it1
-          = std::find_if(it, dest_to_index.end(),
-                         [r = dest.back()](auto& idx) { return idx[0] != r; });
-
-      // Store number of items for current rank
-      num_items_per_dest.push_back(std::distance(it, it1));
-
-      // Advance iterator
-      it = it1;
-    }
-  }
-
-  // Determine source ranks. Sort ranks to make distribution
-  // deterministic.
-  std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
-  std::ranges::sort(src);
-
-  // Create neighbourhood communicator
-  MPI_Comm neigh_comm;
-  MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
-                                 dest.size(), dest.data(), MPI_UNWEIGHTED,
-                                 MPI_INFO_NULL, false, &neigh_comm);
-
-  // Send number of nodes to receivers
-  std::vector<int> num_items_recv(src.size());
-  num_items_per_dest.reserve(1);
-  num_items_recv.reserve(1);
-  MPI_Request request_size;
-  MPI_Ineighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
-                         num_items_recv.data(), 1, MPI_INT, neigh_comm,
-                         &request_size);
-
-  // Compute send displacements
-  std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
-  std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
-                   std::next(send_disp.begin()));
+  // Build (dest, index, owning rank) list, the unique dest ranks and
+  // the number of rows to send to each dest
+  auto [dest_to_index, dest, num_items_per_dest]
+      = sort_by_destination(destinations);
 
   // Pack send buffer
-  std::vector<std::int64_t> send_buffer(buffer_shape1 * send_disp.back(), -1);
+  auto pack_send_buffer = [&]()
   {
-    assert(send_disp.back() == (std::int32_t)dest_to_index.size());
+    std::vector<std::int64_t> send_buffer(
+        buffer_shape1 * dest_to_index.size(), -1);
     for (std::size_t i = 0; i < dest_to_index.size(); ++i)
     {
       const std::array<int, 3>& dest_data = dest_to_index[i];
@@ -140,25 +489,64 @@ graph::build::distribute(MPI_Comm comm,
       info[1] = dest_data[2];        // Owning rank
       info[2] = pos + offset_global; // Original global index
     }
-  }
-
-  // Prepare receive displacement
-  MPI_Wait(&request_size, MPI_STATUS_IGNORE);
-  std::vector<std::int32_t> recv_disp(num_items_recv.size() + 1, 0);
-  std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                   std::next(recv_disp.begin()));
+    return send_buffer;
+  };
 
-  // Send/receive data facet
-  MPI_Datatype compound_type;
-  MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
-  MPI_Type_commit(&compound_type);
-  std::vector<std::int64_t> recv_buffer(buffer_shape1 * recv_disp.back());
-  MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
-                         send_disp.data(), compound_type, recv_buffer.data(),
-                         num_items_recv.data(), recv_disp.data(), compound_type,
-                         neigh_comm);
-  MPI_Type_free(&compound_type);
-  MPI_Comm_free(&neigh_comm);
+  std::vector<int> src;
+  std::vector<std::int32_t> recv_disp;
+  std::vector<std::int64_t> recv_buffer;
+  if (routing == dolfinx::MPI::Routing::node)
+  {
+    std::tie(src, recv_disp, recv_buffer) = send_rows_via_nodes(
+        comm, dest, num_items_per_dest, pack_send_buffer(), buffer_shape1);
+  }
+  else
+  {
+    // Determine source ranks. Sort ranks to make distribution
+    // deterministic.
+    src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+    std::ranges::sort(src);
+
+    // Create neighbourhood communicator
+    MPI_Comm neigh_comm;
+    MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
+                                   dest.size(), dest.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, false, &neigh_comm);
+
+    // Send number of nodes to receivers
+    std::vector<int> num_items_recv(src.size());
+    num_items_per_dest.reserve(1);
+    num_items_recv.reserve(1);
+    MPI_Request request_size;
+    MPI_Ineighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
+                           num_items_recv.data(), 1, MPI_INT, neigh_comm,
+                           &request_size);
+
+    // Compute send displacements
+    std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
+    std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
+                     std::next(send_disp.begin()));
+
+    std::vector<std::int64_t> send_buffer = pack_send_buffer();
+
+    // Prepare receive displacement
+    MPI_Wait(&request_size, MPI_STATUS_IGNORE);
+    recv_disp.assign(num_items_recv.size() + 1, 0);
+    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
+                     std::next(recv_disp.begin()));
+
+    // Send/receive data facet
+    MPI_Datatype compound_type;
+    MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
+    MPI_Type_commit(&compound_type);
+    recv_buffer.resize(buffer_shape1 * recv_disp.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
+                           send_disp.data(), compound_type, recv_buffer.data(),
+                           num_items_recv.data(), recv_disp.data(),
+                           compound_type, neigh_comm);
+    MPI_Type_free(&compound_type);
+    MPI_Comm_free(&neigh_comm);
+  }
 
   // Unpack receive buffer
   std::vector<int> src_ranks0, src_ranks1, ghost_index_owner;
@@ -228,7 +616,8 @@ std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>,
            std::vector<int>>
 graph::build::distribute(MPI_Comm comm, std::span<const std::int64_t> list,
                          std::array<std::size_t, 2> shape,
-                         const graph::AdjacencyList<std::int32_t>& destinations)
+                         const graph::AdjacencyList<std::int32_t>& destinations,
+                         dolfinx::MPI::Routing routing)
 {
   common::Timer timer("Distribute fixed size nodes to destination ranks");
 
@@ -246,68 +635,16 @@ graph::build::distribute(MPI_Comm comm, std::span<const std::int64_t> list,
   // and node global index)
   const std::size_t buffer_shape1 = shape[1] + 2;
 
-  // Build (dest, index, owning rank) list and sort
-  std::vector<std::array<int, 3>> dest_to_index;
-  dest_to_index.reserve(destinations.array().size());
-  for (std::int32_t i = 0; i < destinations.num_nodes(); ++i)
-  {
-    auto di = destinations.links(i);
-    for (auto d : di)
-      dest_to_index.push_back({d, i, di[0]});
-  }
-  std::ranges::sort(dest_to_index);
-
-  // Build list of unique dest ranks and count number of rows to send to
-  // each dest (by neighbourhood rank)
-  std::vector<int> dest;
-  std::vector<std::int32_t> num_items_per_dest;
-  {
-    auto it = dest_to_index.begin();
-    while (it != dest_to_index.end())
-    {
-      // Store global rank and find iterator to next global rank
-      dest.push_back((*it)[0]);
-      auto it1
-          = std::find_if(it, dest_to_index.end(),
-                         [r = dest.back()](auto& idx) { return idx[0] != r; });
-
-      // Store number of items for current rank
-      num_items_per_dest.push_back(std::distance(it, it1));
-
-      // Advance iterator
-      it = it1;
-    }
-  }
-
-  // Determine source ranks. Sort ranks to make distribution
-  // deterministic.
-  std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
-  std::ranges::sort(src);
-
-  // Create neighbourhood communicator
-  MPI_Comm neigh_comm;
-  MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
-                                 dest.size(), dest.data(), MPI_UNWEIGHTED,
-                                 MPI_INFO_NULL, false, &neigh_comm);
-
-  // Send number of nodes to receivers
-  std::vector<int> num_items_recv(src.size());
-  num_items_per_dest.reserve(1);
-  num_items_recv.reserve(1);
-  MPI_Request request_size;
-  MPI_Ineighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
-                         num_items_recv.data(), 1, MPI_INT, neigh_comm,
-                         &request_size);
-
-  // Compute send displacements
-  std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
-  std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
-                   std::next(send_disp.begin()));
+  // Build (dest, index, owning rank) list, the unique dest ranks and
+  // the number of rows to send to each dest
+  auto [dest_to_index, dest, num_items_per_dest]
+      = sort_by_destination(destinations);
 
   // Pack send buffer
-  std::vector<std::int64_t> send_buffer(buffer_shape1 * send_disp.back(), -1);
+  auto pack_send_buffer = [&]()
   {
-    assert(send_disp.back() == (std::int32_t)dest_to_index.size());
+    std::vector<std::int64_t> send_buffer(
+        buffer_shape1 * dest_to_index.size(), -1);
     for (std::size_t i = 0; i < dest_to_index.size(); ++i)
     {
       const std::array<int, 3>& dest_data = dest_to_index[i];
@@ -321,28 +658,67 @@ graph::build::distribute(MPI_Comm comm, std::span<const std::int64_t> list,
       info[0] = dest_data[2];        // Owning rank
       info[1] = pos + offset_global; // Original global index
     }
-  }
-
-  // Prepare receive displacement
-  MPI_Wait(&request_size, MPI_STATUS_IGNORE);
-  std::vector<std::int32_t> recv_disp(num_items_recv.size() + 1, 0);
-  std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                   std::next(recv_disp.begin()));
+    return send_buffer;
+  };
 
-  // Send/receive data facet
-  MPI_Datatype compound_type;
-  MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
-  MPI_Type_commit(&compound_type);
-  std::vector<std::int64_t> recv_buffer(buffer_shape1 * recv_disp.back());
-  MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
-                         send_disp.data(), compound_type, recv_buffer.data(),
-                         num_items_recv.data(), recv_disp.data(), compound_type,
-                         neigh_comm);
-  MPI_Type_free(&compound_type);
-  MPI_Comm_free(&neigh_comm);
+  std::vector<int> src;
+  std::vector<std::int32_t> recv_disp;
+  std::vector<std::int64_t> recv_buffer;
+  if (routing == dolfinx::MPI::Routing::node)
+  {
+    std::tie(src, recv_disp, recv_buffer) = send_rows_via_nodes(
+        comm, dest, num_items_per_dest, pack_send_buffer(), buffer_shape1);
+  }
+  else
+  {
+    // Determine source ranks. Sort ranks to make distribution
+    // deterministic.
+    src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+    std::ranges::sort(src);
+
+    // Create neighbourhood communicator
+    MPI_Comm neigh_comm;
+    MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
+                                   dest.size(), dest.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, false, &neigh_comm);
+
+    // Send number of nodes to receivers
+    std::vector<int> num_items_recv(src.size());
+    num_items_per_dest.reserve(1);
+    num_items_recv.reserve(1);
+    MPI_Request request_size;
+    MPI_Ineighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
+                           num_items_recv.data(), 1, MPI_INT, neigh_comm,
+                           &request_size);
+
+    // Compute send displacements
+    std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
+    std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
+                     std::next(send_disp.begin()));
+
+    std::vector<std::int64_t> send_buffer = pack_send_buffer();
+
+    // Prepare receive displacement
+    MPI_Wait(&request_size, MPI_STATUS_IGNORE);
+    recv_disp.assign(num_items_recv.size() + 1, 0);
+    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
+                     std::next(recv_disp.begin()));
+
+    // Send/receive data facet
+    MPI_Datatype compound_type;
+    MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
+    MPI_Type_commit(&compound_type);
+    recv_buffer.resize(buffer_shape1 * recv_disp.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
+                           send_disp.data(), compound_type, recv_buffer.data(),
+                           num_items_recv.data(), recv_disp.data(),
+                           compound_type, neigh_comm);
+    MPI_Type_free(&compound_type);
+    MPI_Comm_free(&neigh_comm);
+  }
 
-  spdlog::debug("Received {} data on {} [{}]", recv_disp.back(), rank,
-                shape[1]);
+  DOLFINX_LOG_DEBUG("Received {} data on {} [{}]", recv_disp.back(), rank,
+                    shape[1]);
 
   // Count number of owned entries
   std::int32_t num_owned_r = 0;
@@ -386,17 +762,249 @@ graph::build::distribute(MPI_Comm comm, std::span<const std::int64_t> list,
   }
   assert(i_owned == num_owned_r);
 
-  spdlog::debug("data.size = {}", data.size());
+  DOLFINX_LOG_DEBUG("data.size = {}", data.size());
   return {data, global_indices, ghost_index_owner};
 }
 //-----------------------------------------------------------------------------
+std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
+           std::vector<std::int64_t>, std::vector<int>>
+graph::build::distribute(MPI_Comm comm,
+                         const graph::AdjacencyList<std::int64_t>& list,
+                         const graph::AdjacencyList<std::int32_t>& destinations,
+                         std::int32_t max_rows)
+{
+  common::Timer timer(
+      "Distribute AdjacencyList nodes to destination ranks in rounds");
+
+  if (max_rows < 1)
+    throw std::runtime_error("Number of rows per round must be positive.");
+  assert(list.num_nodes() == (int)destinations.num_nodes());
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Get global offset for converting local index to global index for
+  // nodes in 'list'
+  std::int64_t offset_global = 0;
+  {
+    const std::int64_t num_owned = list.num_nodes();
+    MPI_Exscan(&num_owned, &offset_global, 1, MPI_INT64_T, MPI_SUM, comm);
+  }
+
+  // Get the maximum number of edges for a node
+  int shape1 = 0;
+  for (std::int32_t i = 0; i < list.num_nodes(); ++i)
+    shape1 = std::max(shape1, list.num_links(i));
+  MPI_Allreduce(MPI_IN_PLACE, &shape1, 1, MPI_INT, MPI_MAX, comm);
+
+  // Row size (max number of edges + 3 for num_edges, owning rank, and
+  // node global index)
+  const std::size_t buffer_shape1 = shape1 + 3;
+
+  auto [dest_to_index, dest, num_items_per_dest]
+      = sort_by_destination(destinations);
+  auto [neigh_comm, src] = create_neighbourhood(comm, dest);
+
+  // Send the number of rows, owned rows, owned edges and ghost edges
+  // for each dest, so that receivers can place the rows of each round
+  // in the final arrays
+  std::vector<std::int64_t> recv_counts;
+  {
+    std::vector<std::int64_t> counts(4 * dest.size(), 0);
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < dest_to_index.size(); ++i)
+    {
+      auto [d, pos, owner] = dest_to_index[i];
+      while (dest[j] != d)
+        ++j;
+      counts[4 * j] += 1;
+      if (d == owner)
+      {
+        counts[4 * j + 1] += 1;
+        counts[4 * j + 2] += list.num_links(pos);
+      }
+      else
+        counts[4 * j + 3] += list.num_links(pos);
+    }
+    recv_counts = exchange_counts(neigh_comm, std::move(counts), src.size(), 4);
+  }
+
+  // Position of the next owned and ghost row and edge from each source.
+  // Owned rows come first, and rows are ordered by source.
+  std::vector<std::int32_t> num_recv(src.size());
+  std::int64_t num_owned_r = 0, num_owned_edges = 0;
+  for (std::size_t p = 0; p < src.size(); ++p)
+  {
+    num_recv[p] = recv_counts[4 * p];
+    num_owned_r += recv_counts[4 * p + 1];
+    num_owned_edges += recv_counts[4 * p + 2];
+  }
+  std::vector<std::int64_t> row_pos(src.size()), edge_pos(src.size()),
+      ghost_row_pos(src.size()), ghost_edge_pos(src.size());
+  std::int64_t num_rows = num_owned_r, num_edges = num_owned_edges;
+  for (std::size_t p = 0, r = 0, e = 0; p < src.size(); ++p)
+  {
+    row_pos[p] = r;
+    edge_pos[p] = e;
+    ghost_row_pos[p] = num_rows;
+    ghost_edge_pos[p] = num_edges;
+    r += recv_counts[4 * p + 1];
+    e += recv_counts[4 * p + 2];
+    num_rows += recv_counts[4 * p] - recv_counts[4 * p + 1];
+    num_edges += recv_counts[4 * p + 3];
+  }
+
+  std::vector<std::int64_t> data(num_edges);
+  std::vector<std::int32_t> offsets(num_rows + 1);
+  offsets.back() = num_edges;
+  std::vector<int> src_ranks(num_rows);
+  std::vector<int> ghost_index_owner(num_rows - num_owned_r);
+  std::vector<std::int64_t> global_indices(num_rows);
+  send_rows_in_rounds(
+      comm, neigh_comm, num_items_per_dest, num_recv, buffer_shape1, max_rows,
+      [&](std::size_t i, std::span<std::int64_t> b)
+      {
+        const std::array<int, 3>& dest_data = dest_to_index[i];
+        const std::size_t pos = dest_data[1];
+        auto row = list.links(pos);
+        std::ranges::copy(row, b.begin());
+
+        auto info = b.last(3);
+        info[0] = row.size();          // Number of edges for node
+        info[1] = dest_data[2];        // Owning rank
+        info[2] = pos + offset_global; // Original global index
+      },
+      [&](std::size_t p, std::span<const std::int64_t> row)
+      {
+        auto info = row.last(3);
+        const bool owned = info[1] == rank;
+        std::int64_t& r = owned ? row_pos[p] : ghost_row_pos[p];
+        std::int64_t& e = owned ? edge_pos[p] : ghost_edge_pos[p];
+        std::copy_n(row.begin(), info[0], std::next(data.begin(), e));
+        offsets[r] = e;
+        src_ranks[r] = src[p];
+        global_indices[r] = info[2];
+        if (!owned)
+          ghost_index_owner[r - num_owned_r] = info[1];
+        ++r;
+        e += info[0];
+      });
+
+  MPI_Comm_free(&neigh_comm);
+
+  return {graph::AdjacencyList<std::int64_t>(std::move(data),
+                                             std::move(offsets)),
+          std::move(src_ranks), std::move(global_indices),
+          std::move(ghost_index_owner)};
+}
+//-----------------------------------------------------------------------------
+std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>,
+           std::vector<int>>
+graph::build::distribute(MPI_Comm comm, std::span<const std::int64_t> list,
+                         std::array<std::size_t, 2> shape,
+                         const graph::AdjacencyList<std::int32_t>& destinations,
+                         std::int32_t max_rows)
+{
+  common::Timer timer(
+      "Distribute fixed size nodes to destination ranks in rounds");
+
+  if (max_rows < 1)
+    throw std::runtime_error("Number of rows per round must be positive.");
+  assert(list.size() == shape[0] * shape[1]);
+  assert(destinations.num_nodes() == (std::int32_t)shape[0]);
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Get global offset for converting local index to global index for
+  // nodes in 'list'
+  std::int64_t offset_global = 0;
+  {
+    const std::int64_t num_owned = destinations.num_nodes();
+    MPI_Exscan(&num_owned, &offset_global, 1, MPI_INT64_T, MPI_SUM, comm);
+  }
+
+  // Row size (number of edges + 2 for owning rank and node global
+  // index)
+  const std::size_t buffer_shape1 = shape[1] + 2;
+
+  auto [dest_to_index, dest, num_items_per_dest]
+      = sort_by_destination(destinations);
+  auto [neigh_comm, src] = create_neighbourhood(comm, dest);
+
+  // Send the number of rows and owned rows for each dest
+  std::vector<std::int64_t> recv_counts;
+  {
+    std::vector<std::int64_t> counts(2 * dest.size(), 0);
+    std::size_t j = 0;
+    for (auto [d, pos, owner] : dest_to_index)
+    {
+      while (dest[j] != d)
+        ++j;
+      counts[2 * j] += 1;
+      if (d == owner)
+        counts[2 * j + 1] += 1;
+    }
+    recv_counts = exchange_counts(neigh_comm, std::move(counts), src.size(), 2);
+  }
+
+  // Position of the next owned and ghost row from each source. Owned
+  // rows come first, and rows are ordered by source.
+  std::vector<std::int32_t> num_recv(src.size());
+  std::int64_t num_owned_r = 0;
+  for (std::size_t p = 0; p < src.size(); ++p)
+  {
+    num_recv[p] = recv_counts[2 * p];
+    num_owned_r += recv_counts[2 * p + 1];
+  }
+  std::vector<std::int64_t> row_pos(src.size()), ghost_row_pos(src.size());
+  std::int64_t num_rows = num_owned_r;
+  for (std::size_t p = 0, r = 0; p < src.size(); ++p)
+  {
+    row_pos[p] = r;
+    ghost_row_pos[p] = num_rows;
+    r += recv_counts[2 * p + 1];
+    num_rows += recv_counts[2 * p] - recv_counts[2 * p + 1];
+  }
+
+  std::vector<std::int64_t> data(shape[1] * num_rows);
+  std::vector<std::int64_t> global_indices(num_rows);
+  std::vector<int> ghost_index_owner(num_rows - num_owned_r);
+  send_rows_in_rounds(
+      comm, neigh_comm, num_items_per_dest, num_recv, buffer_shape1, max_rows,
+      [&](std::size_t i, std::span<std::int64_t> b)
+      {
+        const std::array<int, 3>& dest_data = dest_to_index[i];
+        const std::size_t pos = dest_data[1];
+        std::span row(list.data() + pos * shape[1], shape[1]);
+        std::ranges::copy(row, b.begin());
+
+        auto info = b.last(2);
+        info[0] = dest_data[2];        // Owning rank
+        info[1] = pos + offset_global; // Original global index
+      },
+      [&](std::size_t p, std::span<const std::int64_t> row)
+      {
+        auto info = row.last(2);
+        const bool owned = info[0] == rank;
+        std::int64_t& r = owned ? row_pos[p] : ghost_row_pos[p];
+        std::ranges::copy(row.first(shape[1]),
+                          std::next(data.begin(), r * shape[1]));
+        global_indices[r] = info[1];
+        if (!owned)
+          ghost_index_owner[r - num_owned_r] = info[0];
+        ++r;
+      });
+
+  MPI_Comm_free(&neigh_comm);
+
+  return {std::move(data), std::move(global_indices),
+          std::move(ghost_index_owner)};
+}
+//-----------------------------------------------------------------------------
 std::vector<std::int64_t>
 graph::build::compute_ghost_indices(MPI_Comm comm,
                                     std::span<const std::int64_t> owned_indices,
                                     std::span<const std::int64_t> ghost_indices,
                                     std::span<const int> ghost_owners)
 {
-  spdlog::info("Compute ghost indices");
+  DOLFINX_LOG_INFO("Compute ghost indices");
 
   // Get number of local cells determine global offset
   std::int64_t offset_local = 0;
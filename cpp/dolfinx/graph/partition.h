@@ -9,6 +9,7 @@
 #include "AdjacencyList.h"
 #include <algorithm>
 #include <cstdint>
+#include <dolfinx/common/MPI.h>
 #include <functional>
 #include <mpi.h>
 #include <span>
@@ -31,6 +32,21 @@ namespace dolfinx::graph
 using partition_fn = std::function<graph::AdjacencyList<std::int32_t>(
     MPI_Comm, int, const AdjacencyList<std::int64_t>&, bool)>;
 
+/// @brief Signature of functions for computing the parallel
+/// partitioning of a distributed graph with node weights.
+/// @param[in] comm MPI Communicator that the graph is distributed
+/// across
+/// @param[in] nparts Number of partitions to divide graph nodes into
+/// @param[in] local_graph Node connectivity graph
+/// @param[in] node_weights Weight of each node in `local_graph`. If
+/// empty on all ranks, nodes have unit weight.
+/// @param[in] ghosting Flag to enable ghosting of the output node
+/// distribution
+/// @return Destination rank for each input node
+using weighted_partition_fn = std::function<graph::AdjacencyList<std::int32_t>(
+    MPI_Comm, int, const AdjacencyList<std::int64_t>&,
+    std::span<const std::int32_t>, bool)>;
+
 /// @brief Partition graph across processes using the default graph
 /// partitioner.
 ///
@@ -45,6 +61,48 @@ AdjacencyList<std::int32_t>
 partition_graph(MPI_Comm comm, int nparts,
                 const AdjacencyList<std::int64_t>& local_graph, bool ghosting);
 
+/// @brief Partition graph with node weights across processes using the
+/// default graph partitioner.
+///
+/// @param[in] comm MPI communicator that the graph is distributed
+/// across.
+/// @param[in] nparts Number of partitions to divide graph nodes into.
+/// @param[in] local_graph Node connectivity graph.
+/// @param[in] node_weights Weight of each node in `local_graph`. If
+/// empty on all ranks, nodes have unit weight.
+/// @param[in] ghosting Flag to enable ghosting of the output node
+/// distribution.
+/// @return Destination rank for each input node.
+AdjacencyList<std::int32_t>
+partition_graph_weighted(MPI_Comm comm, int nparts,
+                         const AdjacencyList<std::int64_t>& local_graph,
+                         std::span<const std::int32_t> node_weights,
+                         bool ghosting);
+
+/// @brief Extend the destination ranks of graph nodes by layers of
+/// neighbouring nodes.
+///
+/// A node is sent to every rank that is the destination of a node
+/// connected to it by at most `num_layers` edges. Applied to the
+/// destinations of a partitioner computed with ghosting, which ghosts
+/// the nodes adjacent to the owned nodes of a rank, this gives
+/// `num_layers + 1` layers of ghost nodes.
+///
+/// @note Collective.
+///
+/// @param[in] comm MPI communicator that the graph is distributed
+/// across.
+/// @param[in] local_graph Node connectivity graph, using global indices
+/// for the edges. The graph must be symmetric.
+/// @param[in] dest Destination ranks of each node of `local_graph`,
+/// with the owning rank first.
+/// @param[in] num_layers Number of layers to add.
+/// @return Destination ranks of each node, with the owning rank first.
+AdjacencyList<std::int32_t>
+extend_ghost_layers(MPI_Comm comm,
+                    const AdjacencyList<std::int64_t>& local_graph,
+                    const AdjacencyList<std::int32_t>& dest, int num_layers);
+
 /// Tools for distributed graphs
 ///
 /// @todo Add a function that sends data to the 'owner'
@@ -59,6 +117,7 @@ namespace build
 /// @param[in] list The adjacency list to distribute
 /// @param[in] destinations Destination ranks for the ith node in the
 /// adjacency list. The first rank is the 'owner' of the node.
+/// @param[in] routing Communication pattern used to send the nodes
 /// @return
 /// 1. Received adjacency list for this process
 /// 2. Source ranks for each node in the adjacency list
@@ -67,7 +126,37 @@ namespace build
 std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
            std::vector<std::int64_t>, std::vector<int>>
 distribute(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& list,
-           const graph::AdjacencyList<std::int32_t>& destinations);
+           const graph::AdjacencyList<std::int32_t>& destinations,
+           dolfinx::MPI::Routing routing
+           = dolfinx::MPI::default_routing());
+
+/// @brief Distribute adjacency list nodes to destination ranks in
+/// rounds of bounded size.
+///
+/// Gives the same result as the distribute function that sends all
+/// nodes at once, but sends at most `max_rows` nodes to each
+/// destination rank in a round, so that the send and receive buffers
+/// are bounded. The nodes of the next round are packed, and the nodes
+/// received in the previous round are unpacked into the returned
+/// arrays, while a round is being communicated. Nodes are sent
+/// directly to the destination ranks.
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] list The adjacency list to distribute
+/// @param[in] destinations Destination ranks for the ith node in the
+/// adjacency list. The first rank is the 'owner' of the node.
+/// @param[in] max_rows Maximum number of nodes sent to a destination
+/// rank in a round
+/// @return
+/// 1. Received adjacency list for this process
+/// 2. Source ranks for each node in the adjacency list
+/// 3. Original global index for each node in the adjacency list
+/// 4. Owner rank of ghost nodes
+std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
+           std::vector<std::int64_t>, std::vector<int>>
+distribute(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& list,
+           const graph::AdjacencyList<std::int32_t>& destinations,
+           std::int32_t max_rows);
 
 /// @brief Distribute fixed size nodes to destination ranks.
 ///
@@ -79,6 +168,33 @@ distribute(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& list,
 /// @param[in] shape The shape of the array
 /// @param[in] destinations Destination ranks for the ith row of the
 /// array. The first rank is the 'owner' of the node.
+/// @param[in] routing Communication pattern used to send the nodes
+/// @return
+/// 1. Received list for this process
+/// 2. Original global index for each node
+/// 3. Owner rank of ghost nodes
+std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>,
+           std::vector<int>>
+distribute(MPI_Comm comm, std::span<const std::int64_t> list,
+           std::array<std::size_t, 2> shape,
+           const graph::AdjacencyList<std::int32_t>& destinations,
+           dolfinx::MPI::Routing routing
+           = dolfinx::MPI::default_routing());
+
+/// @brief Distribute fixed size nodes to destination ranks in rounds
+/// of bounded size.
+///
+/// Gives the same result as the distribute function that sends all
+/// nodes at once, with at most `max_rows` rows sent to each
+/// destination rank in a round (see the adjacency list version).
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] list A flattened 2D row major array
+/// @param[in] shape The shape of the array
+/// @param[in] destinations Destination ranks for the ith row of the
+/// array. The first rank is the 'owner' of the node.
+/// @param[in] max_rows Maximum number of rows sent to a destination
+/// rank in a round
 /// @return
 /// 1. Received list for this process
 /// 2. Original global index for each node
@@ -87,7 +203,8 @@ std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>,
            std::vector<int>>
 distribute(MPI_Comm comm, std::span<const std::int64_t> list,
            std::array<std::size_t, 2> shape,
-           const graph::AdjacencyList<std::int32_t>& destinations);
+           const graph::AdjacencyList<std::int32_t>& destinations,
+           std::int32_t max_rows);
 
 /// @brief Take a set of distributed input global indices, including
 /// ghosts, and determine the new global indices after remapping.
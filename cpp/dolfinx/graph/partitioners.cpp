@@ -5,14 +5,19 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "partitioners.h"
+#include "ordering.h"
 #include <algorithm>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/sort.h>
+#include <limits>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <set>
+#include <span>
 #include <vector>
 
 #ifdef HAS_PTSCOTCH
@@ -37,6 +42,32 @@ using namespace dolfinx;
 
 namespace
 {
+/// @brief Prepare node weights for a partitioner.
+///
+/// @param[in] comm The communicator
+/// @param[in] num_nodes Number of local graph nodes
+/// @param[in] node_weights Weight of each local node, or empty
+/// @return Node weights converted to the partitioner integer type, or
+/// `std::nullopt` if no rank has node weights. Ranks that do not provide
+/// weights when other ranks do are given unit weights.
+template <typename T>
+std::optional<std::vector<T>>
+prepare_node_weights(MPI_Comm comm, std::int32_t num_nodes,
+                     std::span<const std::int32_t> node_weights)
+{
+  if (!node_weights.empty() and (int)node_weights.size() != num_nodes)
+    throw std::runtime_error("Number of node weights and graph nodes differ.");
+
+  int weighted = !node_weights.empty();
+  MPI_Allreduce(MPI_IN_PLACE, &weighted, 1, MPI_INT, MPI_LOR, comm);
+  if (!weighted)
+    return std::nullopt;
+  else if (node_weights.empty())
+    return std::vector<T>(num_nodes, 1);
+  else
+    return std::vector<T>(node_weights.begin(), node_weights.end());
+}
+
 /// @todo Is it un-documented that the owning rank must come first in
 /// reach list of edges?
 ///
@@ -47,11 +78,14 @@ namespace
 /// node_disp[my_rank]`.
 /// @param[in] part The destination rank for owned nodes, i.e. `dest[i]`
 /// is the destination of the node with local index `i`.
+/// @param[in] scalable Use the scalable (NBX) algorithm to discover the
+/// source ranks.
 /// @return Destination ranks for each local node.
 template <typename T>
 graph::AdjacencyList<int> compute_destination_ranks(
     MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& graph,
-    const std::vector<T>& node_disp, const std::vector<T>& part)
+    const std::vector<T>& node_disp, const std::vector<T>& part,
+    bool scalable = false)
 {
   common::Timer timer("Extend graph destination ranks for halo");
 
@@ -121,7 +155,8 @@ graph::AdjacencyList<int> compute_destination_ranks(
   // non-scalable neighbourhood detection (which might be faster for
   // small rank counts).
   const std::vector<int> src
-      = dolfinx::MPI::compute_graph_edges_pcx(comm, dest);
+      = scalable ? dolfinx::MPI::compute_graph_edges_nbx(comm, dest)
+                 : dolfinx::MPI::compute_graph_edges_pcx(comm, dest);
 
   // Create neighbourhood communicator
   MPI_Comm neigh_comm;
@@ -306,16 +341,330 @@ std::vector<int> refine(MPI_Comm comm, const graph::AdjacencyList<T>& adj_graph)
 #endif
 } // namespace
 
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> graph::geometric::partition(
+    MPI_Comm comm, int nparts, std::span<const double> x,
+    std::span<const std::int32_t> weights,
+    const graph::AdjacencyList<std::int64_t>& graph, bool ghosting)
+{
+  DOLFINX_LOG_INFO("Compute geometric partition along Hilbert curve");
+  common::Timer timer("Compute geometric partition");
+
+  const std::int32_t num_points = x.size() / 3;
+  if (ghosting and graph.num_nodes() != num_points)
+    throw std::runtime_error("Number of graph nodes and points differ.");
+  std::optional<std::vector<std::int64_t>> node_weights
+      = prepare_node_weights<std::int64_t>(comm, num_points, weights);
+
+  // Bounding box of the points on all ranks (the upper corner is
+  // negated to reduce with a single MPI_MIN)
+  std::array<double, 6> box;
+  box.fill(std::numeric_limits<double>::max());
+  for (std::int32_t p = 0; p < num_points; ++p)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      box[j] = std::min(box[j], x[3 * p + j]);
+      box[3 + j] = std::min(box[3 + j], -x[3 * p + j]);
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, box.data(), box.size(), MPI_DOUBLE, MPI_MIN,
+                comm);
+  std::vector<std::uint64_t> keys = graph::space_filling_curve_index(
+      x, {{{box[0], box[1], box[2]}, {-box[3], -box[4], -box[5]}}},
+      graph::SpaceFillingCurve::hilbert);
+
+  // Sort the points along the curve and compute the cumulative weight
+  std::vector<std::int32_t> perm(num_points);
+  std::iota(perm.begin(), perm.end(), 0);
+  dolfinx::radix_sort(perm, [&keys](auto p) { return keys[p]; });
+  std::vector<std::uint64_t> sorted_keys(num_points);
+  std::vector<std::int64_t> cum_weight(num_points + 1, 0);
+  for (std::int32_t i = 0; i < num_points; ++i)
+  {
+    sorted_keys[i] = keys[perm[i]];
+    cum_weight[i + 1]
+        = cum_weight[i] + (node_weights ? (*node_weights)[perm[i]] : 1);
+  }
+
+  std::int64_t total_weight = cum_weight.back();
+  MPI_Allreduce(MPI_IN_PLACE, &total_weight, 1, MPI_INT64_T, MPI_SUM, comm);
+
+  // Split the curve at the smallest index s_p for which the weight of
+  // the points before s_p is at least p/nparts of the total weight,
+  // p = 1, ..., nparts - 1. The splitting indices are computed by
+  // simultaneous bisection, with one reduction per bit of the curve
+  // index.
+  std::vector<std::int64_t> target(nparts - 1);
+  for (int p = 1; p < nparts; ++p)
+  {
+    target[p - 1] = (total_weight / nparts) * p
+                    + ((total_weight % nparts) * p) / nparts;
+  }
+  std::vector<std::uint64_t> lo(nparts - 1, 0);
+  std::vector<std::uint64_t> hi(nparts - 1, std::uint64_t(1) << 63);
+  std::vector<std::uint64_t> mid(nparts - 1);
+  std::vector<std::int64_t> weight_below(nparts - 1);
+  while (lo != hi)
+  {
+    for (std::size_t p = 0; p < mid.size(); ++p)
+    {
+      mid[p] = lo[p] + (hi[p] - lo[p]) / 2;
+      auto it = std::ranges::lower_bound(sorted_keys, mid[p]);
+      weight_below[p] = cum_weight[std::distance(sorted_keys.begin(), it)];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, weight_below.data(), weight_below.size(),
+                  MPI_INT64_T, MPI_SUM, comm);
+    for (std::size_t p = 0; p < mid.size(); ++p)
+    {
+      if (weight_below[p] >= target[p])
+        hi[p] = mid[p];
+      else
+        lo[p] = mid[p] + 1;
+    }
+  }
+
+  // The part of a point is the number of splitting indices that are
+  // not greater than its curve index
+  std::vector<std::int64_t> part(num_points);
+  for (std::int32_t i = 0; i < num_points; ++i)
+    part[i] = std::distance(lo.begin(), std::ranges::upper_bound(lo, keys[i]));
+
+  if (ghosting)
+  {
+    std::vector<std::int64_t> node_disp(dolfinx::MPI::size(comm) + 1, 0);
+    const std::int64_t num_local_nodes = num_points;
+    MPI_Allgather(&num_local_nodes, 1, MPI_INT64_T, node_disp.data() + 1, 1,
+                  MPI_INT64_T, comm);
+    std::partial_sum(node_disp.begin(), node_disp.end(), node_disp.begin());
+    return compute_destination_ranks(comm, graph, node_disp, part, true);
+  }
+  else
+  {
+    return regular_adjacency_list(std::vector<int>(part.begin(), part.end()),
+                                  1);
+  }
+}
+//-----------------------------------------------------------------------------
+graph::partition_fn
+graph::hierarchical::partitioner(const graph::partition_fn& inter_node,
+                                 const graph::partition_fn& intra_node,
+                                 int ranks_per_node)
+{
+  return [inter_node, intra_node, ranks_per_node](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             bool ghosting) -> graph::AdjacencyList<std::int32_t>
+  {
+    DOLFINX_LOG_INFO("Compute hierarchical (node-aware) graph partition");
+    common::Timer timer("Compute hierarchical graph partition");
+
+    const int rank = dolfinx::MPI::rank(comm);
+    const int size = dolfinx::MPI::size(comm);
+
+    // Create communicator for the ranks on the same node, ordered by
+    // rank
+    MPI_Comm node_comm;
+    if (ranks_per_node > 0)
+      MPI_Comm_split(comm, rank / ranks_per_node, rank, &node_comm);
+    else
+    {
+      MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+                          &node_comm);
+    }
+
+    // Number the nodes by their lowest rank
+    const int is_leader = dolfinx::MPI::rank(node_comm) == 0;
+    int node = 0, num_nodes = 0;
+    MPI_Exscan(&is_leader, &node, 1, MPI_INT, MPI_SUM, comm);
+    if (rank == 0)
+      node = 0;
+    MPI_Bcast(&node, 1, MPI_INT, 0, node_comm);
+    MPI_Allreduce(&is_leader, &num_nodes, 1, MPI_INT, MPI_SUM, comm);
+
+    // Ranks on each node
+    std::vector<int> rank_to_node(size);
+    MPI_Allgather(&node, 1, MPI_INT, rank_to_node.data(), 1, MPI_INT, comm);
+    std::vector<std::vector<int>> node_ranks(num_nodes);
+    for (int r = 0; r < size; ++r)
+      node_ranks[rank_to_node[r]].push_back(r);
+
+    // Partition in one level if there is only one level, if the parts
+    // are not the ranks, or if the nodes have different numbers of
+    // ranks (the nodes would need parts of different size)
+    if (num_nodes == 1 or num_nodes == size or nparts != size
+        or std::ranges::any_of(node_ranks, [&node_ranks](auto& r)
+                               { return r.size() != node_ranks[0].size(); }))
+    {
+      MPI_Comm_free(&node_comm);
+      if (num_nodes == 1)
+        return intra_node(comm, nparts, graph, ghosting);
+      else
+        return inter_node(comm, nparts, graph, ghosting);
+    }
+
+    // Partition the graph across nodes
+    const std::int32_t num_local_nodes = graph.num_nodes();
+    std::vector<int> node_part(num_local_nodes);
+    {
+      graph::AdjacencyList<std::int32_t> dest
+          = inter_node(comm, num_nodes, graph, false);
+      for (std::int32_t i = 0; i < num_local_nodes; ++i)
+        node_part[i] = dest.links(i).front();
+    }
+
+    // Number the graph nodes on each node contiguously, in the order of
+    // their global index
+    std::vector<std::int64_t> count(num_nodes, 0);
+    for (int m : node_part)
+      ++count[m];
+    std::vector<std::int64_t> offset(num_nodes, 0), total(num_nodes);
+    MPI_Exscan(count.data(), offset.data(), num_nodes, MPI_INT64_T, MPI_SUM,
+               comm);
+    if (rank == 0)
+      std::ranges::fill(offset, 0);
+    MPI_Allreduce(count.data(), total.data(), num_nodes, MPI_INT64_T, MPI_SUM,
+                  comm);
+    std::vector<std::int64_t> node_data(2 * num_local_nodes);
+    for (std::int32_t i = 0; i < num_local_nodes; ++i)
+    {
+      node_data[2 * i] = node_part[i];
+      node_data[2 * i + 1] = offset[node_part[i]]++;
+    }
+
+    // Get the (node, index on node) of the graph node neighbours
+    std::vector<std::int64_t> nbrs(graph.array().begin(), graph.array().end());
+    {
+      std::ranges::sort(nbrs);
+      auto [unique_end, range_end] = std::ranges::unique(nbrs);
+      nbrs.erase(unique_end, range_end);
+    }
+    const std::vector<std::int64_t> nbr_data
+        = dolfinx::MPI::distribute_data(comm, nbrs, comm, node_data, 2);
+
+    // Build the graph of each node, with the edges between graph nodes
+    // on different nodes removed. The first entry of each row is the
+    // index of the graph node on the node. Rows are sent to the ranks of
+    // the node in blocks, so that the graph of a node is distributed by
+    // index across its ranks.
+    std::vector<std::int64_t> rank_offset(size + 1, 0);
+    for (int m = 0; m < num_nodes; ++m)
+    {
+      const int n = node_ranks[m].size();
+      for (int k = 0; k < n; ++k)
+      {
+        auto [r0, r1] = dolfinx::MPI::local_range(k, total[m], n);
+        rank_offset[node_ranks[m][k] + 1] = r1 - r0;
+      }
+    }
+    std::partial_sum(rank_offset.begin(), rank_offset.end(),
+                     rank_offset.begin());
+
+    std::vector<std::int64_t> sub_data;
+    std::vector<std::int32_t> sub_offsets{0}, sub_dest(num_local_nodes);
+    std::vector<std::int64_t> rows(num_local_nodes);
+    for (std::int32_t i = 0; i < num_local_nodes; ++i)
+    {
+      const int m = node_part[i];
+      const std::int64_t idx = node_data[2 * i + 1];
+      sub_data.push_back(idx);
+      for (std::int64_t nbr : graph.links(i))
+      {
+        auto it = std::ranges::lower_bound(nbrs, nbr);
+        std::size_t pos = std::distance(nbrs.begin(), it);
+        if (nbr_data[2 * pos] == m)
+          sub_data.push_back(nbr_data[2 * pos + 1]);
+      }
+      sub_offsets.push_back(sub_data.size());
+
+      const int n = node_ranks[m].size();
+      const int k = dolfinx::MPI::index_owner(n, idx, total[m]);
+      sub_dest[i] = node_ranks[m][k];
+      rows[i] = rank_offset[sub_dest[i]] + idx
+                - dolfinx::MPI::local_range(k, total[m], n)[0];
+    }
+
+    auto [recv_graph, src, original_idx, ghost_owners]
+        = graph::build::distribute(
+            comm,
+            graph::AdjacencyList<std::int64_t>(std::move(sub_data),
+                                               std::move(sub_offsets)),
+            graph::regular_adjacency_list(std::move(sub_dest), 1));
+
+    // Order the received rows by their index on the node
+    const std::int64_t range0
+        = dolfinx::MPI::local_range(dolfinx::MPI::rank(node_comm),
+                                    total[node], dolfinx::MPI::size(node_comm))
+              .front();
+    std::vector<std::int32_t> perm(recv_graph.num_nodes());
+    for (std::int32_t i = 0; i < recv_graph.num_nodes(); ++i)
+      perm[recv_graph.links(i).front() - range0] = i;
+    std::vector<std::int64_t> node_graph_data;
+    std::vector<std::int32_t> node_graph_offsets{0};
+    for (std::int32_t i : perm)
+    {
+      auto links = recv_graph.links(i).subspan(1);
+      node_graph_data.insert(node_graph_data.end(), links.begin(),
+                             links.end());
+      node_graph_offsets.push_back(node_graph_data.size());
+    }
+
+    // Partition the graph of each node across its ranks
+    std::vector<std::int32_t> node_dest;
+    {
+      graph::AdjacencyList<std::int32_t> dest = intra_node(
+          node_comm, dolfinx::MPI::size(node_comm),
+          graph::AdjacencyList<std::int64_t>(std::move(node_graph_data),
+                                             std::move(node_graph_offsets)),
+          false);
+      for (std::int32_t i = 0; i < dest.num_nodes(); ++i)
+        node_dest.push_back(node_ranks[node][dest.links(i).front()]);
+    }
+    MPI_Comm_free(&node_comm);
+
+    // Get the destination rank of the local graph nodes
+    const std::vector<std::int32_t> part
+        = dolfinx::MPI::distribute_data(comm, rows, comm, node_dest, 1);
+
+    if (ghosting)
+    {
+      std::vector<std::int64_t> node_disp(size + 1, 0);
+      const std::int64_t num_local = num_local_nodes;
+      MPI_Allgather(&num_local, 1, MPI_INT64_T, node_disp.data() + 1, 1,
+                    MPI_INT64_T, comm);
+      std::partial_sum(node_disp.begin(), node_disp.end(), node_disp.begin());
+      return compute_destination_ranks(
+          comm, graph, node_disp,
+          std::vector<std::int64_t>(part.begin(), part.end()), true);
+    }
+    else
+    {
+      return regular_adjacency_list(std::vector<int>(part.begin(), part.end()),
+                                    1);
+    }
+  };
+}
 //-----------------------------------------------------------------------------
 #ifdef HAS_PTSCOTCH
 graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
                                                double imbalance, int seed)
 {
-  return [imbalance, strategy, seed](MPI_Comm comm, int nparts,
-                                     const AdjacencyList<std::int64_t>& graph,
-                                     bool ghosting)
+  return [partfn = weighted_partitioner(strategy, imbalance, seed)](
+             MPI_Comm comm, int nparts,
+             const AdjacencyList<std::int64_t>& graph, bool ghosting)
+  { return partfn(comm, nparts, graph, {}, ghosting); };
+}
+//-----------------------------------------------------------------------------
+graph::weighted_partition_fn
+graph::scotch::weighted_partitioner(graph::scotch::strategy strategy,
+                                    double imbalance, int seed)
+{
+  return [imbalance, strategy, seed](
+             MPI_Comm comm, int nparts,
+             const AdjacencyList<std::int64_t>& graph,
+             std::span<const std::int32_t> node_weights, bool ghosting)
   {
-    spdlog::info("Compute graph partition using PT-SCOTCH");
+    DOLFINX_LOG_INFO("Compute graph partition using PT-SCOTCH");
     common::Timer timer("Compute graph partition (SCOTCH)");
 
     std::int64_t offset_global = 0;
@@ -339,14 +688,14 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
     if (err != 0)
       throw std::runtime_error("Error initializing SCOTCH graph");
 
-    // FIXME: If the nodes have weights but this rank has no nodes, then
-    //        SCOTCH may deadlock since vload.data() will be nullptr on
-    //        this rank but not null on all other ranks.
-    // Handle node weights (disabled for now)
-    std::vector<SCOTCH_Num> node_weights;
-    std::vector<SCOTCH_Num> vload;
-    if (!node_weights.empty())
-      vload.assign(node_weights.begin(), node_weights.end());
+    // Handle node weights. If the nodes have weights but this rank has
+    // no nodes, SCOTCH may deadlock if the weight array is nullptr on
+    // this rank but not on other ranks, so storage is always allocated.
+    std::optional<std::vector<SCOTCH_Num>> vload
+        = prepare_node_weights<SCOTCH_Num>(comm, graph.num_nodes(),
+                                           node_weights);
+    if (vload)
+      vload->reserve(1);
 
     // Set seed and reset SCOTCH random number generator to produce
     // deterministic partitions on repeated calls
@@ -358,7 +707,8 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
     common::Timer timer1("SCOTCH: call SCOTCH_dgraphBuild");
     err = SCOTCH_dgraphBuild(
         &dgrafdat, baseval, graph.num_nodes(), graph.num_nodes(),
-        vertloctab.data(), nullptr, vload.data(), nullptr, edgeloctab.size(),
+        vertloctab.data(), nullptr, vload ? vload->data() : nullptr, nullptr,
+        edgeloctab.size(),
         edgeloctab.size(), edgeloctab.data(), nullptr, nullptr);
     if (err != 0)
       throw std::runtime_error("Error building SCOTCH graph");
@@ -515,12 +865,23 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
 #ifdef HAS_PARMETIS
 graph::partition_fn graph::parmetis::partitioner(double imbalance,
                                                  std::array<int, 3> options)
+{
+  return [partfn = weighted_partitioner(imbalance, options)](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph, bool ghosting)
+  { return partfn(comm, nparts, graph, {}, ghosting); };
+}
+//-----------------------------------------------------------------------------
+graph::weighted_partition_fn
+graph::parmetis::weighted_partitioner(double imbalance,
+                                      std::array<int, 3> options)
 {
   return [imbalance, options](MPI_Comm comm, idx_t nparts,
                               const graph::AdjacencyList<std::int64_t>& graph,
+                              std::span<const std::int32_t> node_weights,
                               bool ghosting)
   {
-    spdlog::info("Compute graph partition using ParMETIS");
+    DOLFINX_LOG_INFO("Compute graph partition using ParMETIS");
     common::Timer timer("Compute graph partition (ParMETIS)");
 
     if (nparts == 1 and dolfinx::MPI::size(comm) == 1)
@@ -530,6 +891,10 @@ graph::partition_fn graph::parmetis::partitioner(double imbalance,
           std::vector<std::int32_t>(graph.num_nodes(), 0), 1);
     }
 
+    // Node weights (collective on comm, so prepared before splitting)
+    std::optional<std::vector<idx_t>> vwgt
+        = prepare_node_weights<idx_t>(comm, graph.num_nodes(), node_weights);
+
     // Note: ParMETIS fails (crashes) if a rank does not have any graph
     // data. Therefore we split the communicator such that ParMETIS
     // partitioning happens only on ranks that have data. Ideallt we
@@ -565,8 +930,8 @@ graph::partition_fn graph::parmetis::partitioner(double imbalance,
       // Options and data for ParMETIS
       std::array<idx_t, 3> opts = {options[0], options[1], options[2]};
       idx_t ncon = 1;
-      idx_t* elmwgt = nullptr;
-      idx_t wgtflag(0), edgecut(0), numflag(0);
+      idx_t* elmwgt = vwgt ? vwgt->data() : nullptr;
+      idx_t wgtflag(vwgt ? 2 : 0), edgecut(0), numflag(0);
       std::vector<real_t> tpwgts(ncon * nparts,
                                  1.0 / static_cast<real_t>(nparts));
       real_t ubvec = static_cast<real_t>(imbalance);
@@ -612,20 +977,38 @@ graph::partition_fn graph::kahip::partitioner(int mode, int seed,
                                               double imbalance,
                                               bool suppress_output)
 {
-  return [mode, seed, imbalance, suppress_output](
+  return [partfn = weighted_partitioner(mode, seed, imbalance,
+                                        suppress_output)](
              MPI_Comm comm, int nparts,
              const graph::AdjacencyList<std::int64_t>& graph, bool ghosting)
+  { return partfn(comm, nparts, graph, {}, ghosting); };
+}
+//----------------------------------------------------------------------------
+graph::weighted_partition_fn
+graph::kahip::weighted_partitioner(int mode, int seed, double imbalance,
+                                   bool suppress_output)
+{
+  return [mode, seed, imbalance, suppress_output](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             std::span<const std::int32_t> node_weights, bool ghosting)
   {
-    spdlog::info("Compute graph partition using (parallel) KaHIP");
+    DOLFINX_LOG_INFO("Compute graph partition using (parallel) KaHIP");
 
     // KaHIP integer type
     using T = unsigned long long;
 
     common::Timer timer("Compute graph partition (KaHIP)");
 
-    // Graph does not have vertex or adjacency weights, so we use null
-    // pointers as arguments
-    T *vwgt(nullptr), *adjcwgt(nullptr);
+    // Graph does not have adjacency weights, so we use a null pointer.
+    // Vertex weight storage is allocated on all ranks if any rank has
+    // vertex weights.
+    std::optional<std::vector<T>> node_vwgt
+        = prepare_node_weights<T>(comm, graph.num_nodes(), node_weights);
+    if (node_vwgt)
+      node_vwgt->reserve(1);
+    T* vwgt = node_vwgt ? node_vwgt->data() : nullptr;
+    T* adjcwgt = nullptr;
 
     // Build adjacency list data
     common::Timer timer1("KaHIP: build adjacency data");
@@ -37,6 +37,18 @@ enum class strategy
 /// @return A graph partitioning function
 graph::partition_fn partitioner(scotch::strategy strategy = strategy::none,
                                 double imbalance = 0.025, int seed = 0);
+
+/// @brief Create a graph partitioning function with node weights that
+/// uses PT-SCOTCH.
+///
+/// @param[in] strategy The SCOTCH strategy
+/// @param[in] imbalance The allowable imbalance (between 0 and 1). The
+/// smaller value the more balanced the partitioning must be.
+/// @param[in] seed Random number generator seed
+/// @return A graph partitioning function
+graph::weighted_partition_fn
+weighted_partitioner(scotch::strategy strategy = strategy::none,
+                     double imbalance = 0.025, int seed = 0);
 #endif
 
 } // namespace scotch
@@ -58,6 +70,18 @@ namespace parmetis
 graph::partition_fn partitioner(double imbalance = 1.02,
                                 std::array<int, 3> options = {1, 0, 5});
 
+/// @brief Create a graph partitioning function with node weights that
+/// uses ParMETIS.
+///
+/// @param[in] imbalance Imbalance tolerance. See ParMETIS manual for
+/// details.
+/// @param[in] options The ParMETIS option. See ParMETIS manual for
+/// details.
+/// @return A graph partitioning function
+graph::weighted_partition_fn
+weighted_partitioner(double imbalance = 1.02,
+                     std::array<int, 3> options = {1, 0, 5});
+
 #endif
 } // namespace parmetis
 
@@ -77,7 +101,82 @@ namespace kahip
 graph::partition_fn partitioner(int mode = 1, int seed = 1,
                                 double imbalance = 0.03,
                                 bool suppress_output = true);
+
+/// @brief Create a graph partitioning function with node weights that
+/// uses KaHIP.
+///
+/// @param[in] mode The KaHiP partitioning mode
+/// @param[in] seed The KaHiP random number generator seed
+/// @param[in] imbalance The allowable imbalance
+/// @param[in] suppress_output Suppresses KaHIP output if true
+/// @return A KaHIP graph partitioning function
+graph::weighted_partition_fn
+weighted_partitioner(int mode = 1, int seed = 1, double imbalance = 0.03,
+                     bool suppress_output = true);
 #endif
 } // namespace kahip
 
+/// Geometric partitioner
+namespace geometric
+{
+/// @brief Partition points across processes by splitting a Hilbert
+/// curve through the points.
+///
+/// The curve is split into `nparts` segments of (approximately) equal
+/// weight. The splitting points are computed by a parallel bisection
+/// over the curve index, which requires at most 64 reductions of
+/// `nparts - 1` values, and the local work is `O(n log n)` for `n`
+/// local points. No graph partitioning library is required and the
+/// cost is much lower than for a graph partitioner, but the edge cut of
+/// the partition is in general larger.
+///
+/// @param[in] comm MPI communicator that the points are distributed
+/// across.
+/// @param[in] nparts Number of partitions to divide the points into.
+/// @param[in] x Points (row-major, shape `(num_points, 3)`).
+/// @param[in] weights Weight of each point. If empty on all ranks,
+/// points have unit weight.
+/// @param[in] graph Graph of the points (using global indices), used to
+/// compute the ghost destinations. Unused if `ghosting` is false.
+/// @param[in] ghosting Flag to enable ghosting of the output node
+/// distribution.
+/// @return Destination ranks for each point. The owning rank comes
+/// first.
+AdjacencyList<std::int32_t>
+partition(MPI_Comm comm, int nparts, std::span<const double> x,
+          std::span<const std::int32_t> weights,
+          const AdjacencyList<std::int64_t>& graph, bool ghosting);
+} // namespace geometric
+
+/// Node-aware two-level partitioner
+namespace hierarchical
+{
+/// @brief Create a graph partitioning function that partitions a graph
+/// first across the (shared-memory) nodes of a machine and then across
+/// the ranks of each node.
+///
+/// The graph is partitioned into one part per node, the parts are
+/// moved to the ranks of their node, and the graph of each node, with
+/// edges to other nodes removed, is partitioned across the ranks of the
+/// node. This reduces the inter-node edge cut at the expense of the
+/// intra-node edge cut, which suits networks where intra-node
+/// communication is much faster than inter-node communication. If the
+/// number of parts is not the number of ranks, if the nodes have
+/// different numbers of ranks, or if the ranks are on a single node or
+/// all on different nodes, the graph is partitioned in one level.
+///
+/// @param[in] inter_node Graph partitioner for the partition across
+/// nodes.
+/// @param[in] intra_node Graph partitioner for the partition within a
+/// node. It is called with the communicator of the node.
+/// @param[in] ranks_per_node Number of consecutive ranks that are
+/// grouped as a node. If not positive, the ranks that share memory
+/// (`MPI_COMM_TYPE_SHARED`) are a node.
+/// @return A graph partitioning function
+graph::partition_fn
+partitioner(const graph::partition_fn& inter_node = &graph::partition_graph,
+            const graph::partition_fn& intra_node = &graph::partition_graph,
+            int ranks_per_node = 0);
+} // namespace hierarchical
+
 } // namespace dolfinx::graph
@@ -7,9 +7,12 @@
 #ifdef HAS_ADIOS2
 
 #include "ADIOS2Writers.h"
+#include "aggregation.h"
 #include "cells.h"
 #include <pugixml.hpp>
+#include <spdlog/spdlog.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace dolfinx;
@@ -48,13 +51,31 @@ std::string to_fides_cell(mesh::CellType type)
 
 } // namespace
 
+//-----------------------------------------------------------------------------
+void impl_adios2::set_aggregation(adios2::IO& io, MPI_Comm comm,
+                                  int num_aggregators)
+{
+  if (num_aggregators == 0)
+    return;
+
+  const Aggregator aggregator(comm, num_aggregators);
+  const int n = aggregator.num_aggregators();
+  const int size = dolfinx::MPI::size(comm);
+  io.SetParameters({{"AggregationType", "TwoLevelShm"},
+                    {"NumAggregators", std::to_string(n)},
+                    {"AggregatorRatio", std::to_string((size + n - 1) / n)}});
+}
 //-----------------------------------------------------------------------------
 ADIOS2Writer::ADIOS2Writer(MPI_Comm comm, const std::filesystem::path& filename,
-                           std::string tag, std::string engine)
+                           std::string tag, std::string engine,
+                           int num_aggregators,
+                           const adios2::Params& engine_parameters)
     : _adios(std::make_unique<adios2::ADIOS>(comm)),
       _io(std::make_unique<adios2::IO>(_adios->DeclareIO(tag)))
 {
   _io->SetEngine(engine);
+  impl_adios2::set_aggregation(*_io, comm, num_aggregators);
+  _io->SetParameters(engine_parameters);
   _engine = std::make_unique<adios2::Engine>(
       _io->Open(filename, adios2::Mode::Write));
 }
@@ -64,12 +85,154 @@ ADIOS2Writer::~ADIOS2Writer() { close(); }
 void ADIOS2Writer::close()
 {
   assert(_engine);
+  if (_thread)
+    _thread->wait();
+
   // The reason this looks odd is that ADIOS2 uses `operator bool()`
   // to test if the engine is open
   if (*_engine)
     _engine->Close();
 }
 //-----------------------------------------------------------------------------
+void ADIOS2Writer::set_asynchronous(bool async)
+{
+  if (async and !_thread)
+  {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE)
+    {
+      spdlog::warn("MPI does not support MPI_THREAD_MULTIPLE. ADIOS2 output "
+                   "will be synchronous.");
+    }
+    else
+      _thread = std::make_unique<impl_adios2::StepThread>();
+  }
+  else if (!async and _thread)
+  {
+    _thread->wait();
+    _thread.reset();
+  }
+}
+//-----------------------------------------------------------------------------
+bool ADIOS2Writer::asynchronous() const { return _thread != nullptr; }
+//-----------------------------------------------------------------------------
+void ADIOS2Writer::set_nonblocking(bool nonblocking)
+{
+  _nonblocking = nonblocking;
+}
+//-----------------------------------------------------------------------------
+bool ADIOS2Writer::nonblocking() const { return _nonblocking; }
+//-----------------------------------------------------------------------------
+std::size_t ADIOS2Writer::num_dropped_steps() const
+{
+  return _num_dropped_steps;
+}
+//-----------------------------------------------------------------------------
+bool ADIOS2Writer::begin_step()
+{
+  assert(_engine);
+  if (_thread)
+    _thread->wait();
+  if (!_nonblocking)
+  {
+    _engine->BeginStep();
+    return true;
+  }
+
+  if (_engine->BeginStep(adios2::StepMode::Append, 0.0f)
+      == adios2::StepStatus::OK)
+  {
+    return true;
+  }
+  else
+  {
+    ++_num_dropped_steps;
+    DOLFINX_LOG_INFO("ADIOS2 engine not ready, output step dropped.");
+    return false;
+  }
+}
+//-----------------------------------------------------------------------------
+void ADIOS2Writer::end_step()
+{
+  assert(_engine);
+  if (_thread)
+  {
+    // All Puts in a step are completed (Sync mode or PerformPuts)
+    // before the step is ended, so the step data is held by ADIOS2 and
+    // the background thread does not access DOLFINx data
+    _thread->submit([engine = _engine.get()] { engine->EndStep(); });
+  }
+  else
+    _engine->EndStep();
+}
+//-----------------------------------------------------------------------------
+impl_adios2::StepThread::StepThread()
+    : _thread(
+          [this]()
+          {
+            while (true)
+            {
+              std::function<void()> step;
+              {
+                std::unique_lock lock(_mutex);
+                _cv.wait(lock, [this] { return _step or _stop; });
+                if (!_step)
+                  return;
+                step = std::move(_step);
+                _step = nullptr;
+              }
+
+              std::exception_ptr error;
+              try
+              {
+                step();
+              }
+              catch (...)
+              {
+                error = std::current_exception();
+              }
+
+              {
+                std::scoped_lock lock(_mutex);
+                _error = error;
+                _busy = false;
+              }
+              _cv.notify_all();
+            }
+          })
+{
+}
+//-----------------------------------------------------------------------------
+impl_adios2::StepThread::~StepThread()
+{
+  {
+    std::scoped_lock lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_all();
+  _thread.join();
+}
+//-----------------------------------------------------------------------------
+void impl_adios2::StepThread::submit(std::function<void()> step)
+{
+  wait();
+  {
+    std::scoped_lock lock(_mutex);
+    _step = std::move(step);
+    _busy = true;
+  }
+  _cv.notify_all();
+}
+//-----------------------------------------------------------------------------
+void impl_adios2::StepThread::wait()
+{
+  std::unique_lock lock(_mutex);
+  _cv.wait(lock, [this] { return !_busy; });
+  if (_error)
+    std::rethrow_exception(std::exchange(_error, nullptr));
+}
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 void impl_fides::initialize_mesh_attributes(adios2::IO& io, mesh::CellType type)
 {
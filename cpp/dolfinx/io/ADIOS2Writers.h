@@ -15,6 +15,8 @@
 #include <cassert>
 #include <complex>
 #include <concepts>
+#include <condition_variable>
+#include <exception>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -22,10 +24,16 @@
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <mpi.h>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -51,6 +59,57 @@ using U = std::vector<std::variant<
     std::shared_ptr<const fem::Function<std::complex<double>, T>>>>;
 } // namespace adios2_writer
 
+/// @privatesection
+namespace impl_adios2
+{
+/// @brief Thread that finishes ADIOS2 output steps in the background.
+///
+/// One step is processed at a time. Submitting a step waits for the
+/// previously submitted step to finish.
+class StepThread
+{
+public:
+  /// Start the thread
+  StepThread();
+
+  /// Wait for the last step to finish and stop the thread
+  ~StepThread();
+
+  /// @brief Run a step on the thread. Waits for the previously
+  /// submitted step to finish.
+  /// @param[in] step The function to run
+  void submit(std::function<void()> step);
+
+  /// @brief Wait for the last submitted step to finish.
+  /// @note An exception thrown by the step is re-thrown here.
+  void wait();
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::function<void()> _step;
+  std::exception_ptr _error;
+  bool _busy = false;
+  bool _stop = false;
+
+  // Declared last so that the thread starts after the other members
+  // are initialised
+  std::jthread _thread;
+};
+/// @brief Set the ADIOS2 engine parameters for aggregation of the
+/// output onto a number of ranks per node (collective).
+///
+/// The BP5 engine aggregates over shared-memory communicators
+/// (`TwoLevelShm`) with the total number of aggregators. For the BP4
+/// engine the corresponding ratio of ranks to aggregators is set.
+/// @param[in,out] io The ADIOS2 IO object, before the engine is opened
+/// @param[in] comm The communicator of the engine
+/// @param[in] num_aggregators Number of aggregators per node. If zero,
+/// the engine default is used.
+void set_aggregation(adios2::IO& io, MPI_Comm comm, int num_aggregators);
+
+} // namespace impl_adios2
+
 /// Base class for ADIOS2-based writers
 class ADIOS2Writer
 {
@@ -61,8 +120,16 @@ protected:
   /// @param[in] tag The ADIOS2 object name
   /// @param[in] engine ADIOS2 engine type. See
   /// https://adios2.readthedocs.io/en/latest/engines/engines.html.
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data, see impl_adios2::set_aggregation. If zero, the engine
+  /// default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters, e.g.
+  /// `{"RendezvousReaderCount", "0"}` and `{"QueueFullPolicy",
+  /// "Discard"}` for in-situ streaming with the SST engine where the
+  /// writer should not wait for readers.
   ADIOS2Writer(MPI_Comm comm, const std::filesystem::path& filename,
-               std::string tag, std::string engine);
+               std::string tag, std::string engine, int num_aggregators = 0,
+               const adios2::Params& engine_parameters = {});
 
   /// @brief Move constructor
   ADIOS2Writer(ADIOS2Writer&& writer) = default;
@@ -83,10 +150,65 @@ public:
   /// @brief  Close the file
   void close();
 
+  /// @brief Enable or disable asynchronous output.
+  ///
+  /// In asynchronous mode the end of an output step, which flushes the
+  /// step data to file, is performed by a background thread and
+  /// `write` returns once the data of the step has been copied into
+  /// ADIOS2 buffers. The next call to `write`, and `close`, wait for
+  /// the step to finish. The data being written can therefore be
+  /// modified as soon as `write` returns.
+  ///
+  /// @note The background thread calls MPI. Asynchronous output is
+  /// only enabled if MPI has been initialised with
+  /// `MPI_THREAD_MULTIPLE` support, otherwise a warning is logged and
+  /// output remains synchronous.
+  /// @param[in] async True to enable asynchronous output
+  void set_asynchronous(bool async);
+
+  /// @brief Check if output is asynchronous.
+  /// @return True if output steps are finished in the background
+  bool asynchronous() const;
+
+  /// @brief Enable or disable non-blocking output steps.
+  ///
+  /// In non-blocking mode an output step is started with a zero
+  /// timeout. If the engine is not ready to accept a step, e.g. when a
+  /// reader of an SST stream lags behind and the step queue is full,
+  /// the step is dropped and `write` returns without writing data.
+  /// @param[in] nonblocking True to enable non-blocking steps
+  void set_nonblocking(bool nonblocking);
+
+  /// @brief Check if output steps are non-blocking.
+  bool nonblocking() const;
+
+  /// @brief Number of output steps that have been dropped in
+  /// non-blocking mode.
+  std::size_t num_dropped_steps() const;
+
 protected:
+  /// @brief Begin an output step. Waits for an unfinished
+  /// asynchronous step.
+  /// @return True if the step was started. False if the step has been
+  /// dropped in non-blocking mode, in which case no data should be
+  /// written and end_step must not be called.
+  bool begin_step();
+
+  /// @brief End an output step. In asynchronous mode the step is ended
+  /// by the background thread.
+  void end_step();
+
   std::unique_ptr<adios2::ADIOS> _adios;
   std::unique_ptr<adios2::IO> _io;
   std::unique_ptr<adios2::Engine> _engine;
+
+  // Background thread for asynchronous output (nullptr if output is
+  // synchronous)
+  std::unique_ptr<impl_adios2::StepThread> _thread;
+
+  // Non-blocking output steps, and the number of dropped steps
+  bool _nonblocking = false;
+  std::size_t _num_dropped_steps = 0;
 };
 
 /// @privatesection
@@ -127,6 +249,21 @@ adios2::Variable<T> define_variable(adios2::IO& io, std::string name,
     return io.DefineVariable<T>(name, shape, start, count);
 }
 
+/// Attach ADIOS2 operators (e.g. compressors), given by their type and
+/// parameters, to a variable. Variables that already have operators
+/// attached, e.g. in an earlier step, are left unchanged.
+template <class T>
+void add_operations(
+    adios2::Variable<T>& var,
+    const std::vector<std::pair<std::string, adios2::Params>>& operators)
+{
+  if (var.Operations().empty())
+  {
+    for (auto& [type, params] : operators)
+      var.AddOperation(type, params);
+  }
+}
+
 /// Extract common mesh from list of Functions
 template <std::floating_point T>
 std::shared_ptr<const mesh::Mesh<T>>
@@ -382,9 +519,12 @@ void write_data(adios2::IO& io, adios2::Engine& engine,
 /// @param[in] io The ADIOS2 IO
 /// @param[in] engine The ADIOS2 engine
 /// @param[in] mesh The mesh
+/// @param[in] vtkcells The mesh connectivity in VTK ordering, see
+/// io::extract_vtk_connectivity
 template <std::floating_point T>
 void write_mesh(adios2::IO& io, adios2::Engine& engine,
-                const mesh::Mesh<T>& mesh)
+                const mesh::Mesh<T>& mesh,
+                std::span<const std::int64_t> vtkcells)
 {
   const mesh::Geometry<T>& geometry = mesh.geometry();
   auto topology = mesh.topology();
@@ -397,24 +537,33 @@ void write_mesh(adios2::IO& io, adios2::Engine& engine,
       io, "points", {}, {}, {num_vertices, 3});
   engine.Put(local_geometry, geometry.x().data());
 
-  // TODO: The DOLFINx and VTK topology are the same for some cell types
-  // - no need to repack via extract_vtk_connectivity in these cases
-
   // Get topological dimension, number of cells and number of 'nodes' per
-  // cell, and compute 'VTK' connectivity
+  // cell
   int tdim = topology->dim();
   std::int32_t num_cells = topology->index_map(tdim)->size_local();
   int num_nodes = geometry.cmap().dim();
-  auto [cells, shape] = io::extract_vtk_connectivity(mesh.geometry().dofmap(),
-                                                     topology->cell_type());
+  assert(vtkcells.size() == std::size_t(num_cells * num_nodes));
 
   // "Put" topology data in the result in the ADIOS2 file
   adios2::Variable local_topology = impl_adios2::define_variable<std::int64_t>(
       io, "connectivity", {}, {}, {std::size_t(num_cells * num_nodes)});
-  engine.Put(local_topology, cells.data());
+  engine.Put(local_topology, vtkcells.data());
   engine.PerformPuts();
 }
 
+/// @brief  Write mesh geometry and connectivity (topology) for Fides.
+/// @param[in] io The ADIOS2 IO
+/// @param[in] engine The ADIOS2 engine
+/// @param[in] mesh The mesh
+template <std::floating_point T>
+void write_mesh(adios2::IO& io, adios2::Engine& engine,
+                const mesh::Mesh<T>& mesh)
+{
+  auto [vtkcells, shape] = io::extract_vtk_connectivity(
+      mesh.geometry().dofmap(), mesh.topology()->cell_type());
+  write_mesh(io, engine, mesh, vtkcells);
+}
+
 } // namespace impl_fides
 
 /// Mesh reuse policy
@@ -438,12 +587,17 @@ public:
   /// @param[in] mesh The mesh. The mesh must a degree 1 mesh.
   /// @param[in] engine ADIOS2 engine type. See
   /// https://adios2.readthedocs.io/en/latest/engines/engines.html.
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data. If zero, the engine default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters.
   /// @note The mesh geometry can be updated between write steps but the
   /// topology should not be changed between write steps.
   FidesWriter(MPI_Comm comm, const std::filesystem::path& filename,
               std::shared_ptr<const mesh::Mesh<T>> mesh,
-              std::string engine = "BPFile")
-      : ADIOS2Writer(comm, filename, "Fides mesh writer", engine),
+              std::string engine = "BPFile", int num_aggregators = 0,
+              const adios2::Params& engine_parameters = {})
+      : ADIOS2Writer(comm, filename, "Fides mesh writer", engine,
+                     num_aggregators, engine_parameters),
         _mesh_reuse_policy(FidesMeshPolicy::update), _mesh(mesh)
   {
     assert(_io);
@@ -469,10 +623,16 @@ public:
   /// @param[in] mesh_policy Controls if the mesh is written to file at
   /// the first time step only or is re-written (updated) at each time
   /// step.
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data. If zero, the engine default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters.
   FidesWriter(MPI_Comm comm, const std::filesystem::path& filename,
               const typename adios2_writer::U<T>& u, std::string engine,
-              const FidesMeshPolicy mesh_policy = FidesMeshPolicy::update)
-      : ADIOS2Writer(comm, filename, "Fides function writer", engine),
+              const FidesMeshPolicy mesh_policy = FidesMeshPolicy::update,
+              int num_aggregators = 0,
+              const adios2::Params& engine_parameters = {})
+      : ADIOS2Writer(comm, filename, "Fides function writer", engine,
+                     num_aggregators, engine_parameters),
         _mesh_reuse_policy(mesh_policy),
         _mesh(impl_adios2::extract_common_mesh<T>(u)), _u(u)
   {
@@ -600,14 +760,24 @@ public:
   {
     assert(_io);
     assert(_engine);
-    _engine->BeginStep();
+    if (!begin_step())
+      return;
     adios2::Variable var_step
         = impl_adios2::define_variable<double>(*_io, "step");
     _engine->template Put<double>(var_step, t);
     if (auto v = _io->template InquireVariable<std::int64_t>("connectivity");
         !v or _mesh_reuse_policy == FidesMeshPolicy::update)
     {
-      impl_fides::write_mesh(*_io, *_engine, *_mesh);
+      // The connectivity does not change between steps and is computed
+      // once
+      if (!_vtkcells)
+      {
+        _vtkcells = io::extract_vtk_connectivity(
+                        _mesh->geometry().dofmap(),
+                        _mesh->topology()->cell_type())
+                        .first;
+      }
+      impl_fides::write_mesh(*_io, *_engine, *_mesh, *_vtkcells);
     }
 
     for (auto& v : _u)
@@ -616,7 +786,7 @@ public:
                  { impl_fides::write_data(*_io, *_engine, *u); }, v);
     }
 
-    _engine->EndStep();
+    end_step();
   }
 
 private:
@@ -626,6 +796,36 @@ private:
 
   std::shared_ptr<const mesh::Mesh<T>> _mesh;
   adios2_writer::U<T> _u;
+
+  // Mesh connectivity in VTK ordering, computed at the first write
+  std::optional<std::vector<std::int64_t>> _vtkcells;
+};
+
+/// @brief Options to reduce the size of VTX output.
+struct VTXOutputOptions
+{
+  /// Write the values of functions in single precision
+  bool float32_fields = false;
+
+  /// Write the cell connectivity as 32-bit integers. The connectivity
+  /// holds process-local node indices, which always fit in 32 bits.
+  bool int32_connectivity = false;
+
+  /// ADIOS2 operators, as pairs of operator type and parameters, that
+  /// are applied to the values of functions, e.g. `{"zfp",
+  /// {{"accuracy", "1e-6"}}}`, `"mgard"` or `"bigwhoop"`. See the
+  /// ADIOS2 documentation for the available operators.
+  std::vector<std::pair<std::string, adios2::Params>> field_operators;
+
+  /// ADIOS2 operators that are applied to the cell connectivity. Only
+  /// lossless operators, e.g. `"blosc"`, should be used.
+  std::vector<std::pair<std::string, adios2::Params>> connectivity_operators;
+
+  /// Process-local indices of the cells to write, e.g. the cells of a
+  /// subdomain or a decimated subset of the cells. Only the nodes of
+  /// these cells, or for piecewise constant functions the values on
+  /// these cells, are written. If not set, all cells are written.
+  std::optional<std::vector<std::int32_t>> cells = std::nullopt;
 };
 
 /// @privatesection
@@ -672,9 +872,14 @@ extract_function_names(const typename adios2_writer::U<T>& u)
 /// @param[in] io ADIOS2 io object.
 /// @param[in] engine ADIOS2 engine object.
 /// @param[in] u Function to write.
+/// @param[in] options Output options.
+/// @param[in] nodes Nodes (degree-of-freedom blocks) to write, see
+/// vtx_write_mesh_from_space. If not set, all nodes are written.
 template <typename T, std::floating_point X>
-void vtx_write_data(adios2::IO& io, adios2::Engine& engine,
-                    const fem::Function<T, X>& u)
+void vtx_write_data(
+    adios2::IO& io, adios2::Engine& engine, const fem::Function<T, X>& u,
+    const VTXOutputOptions& options = {},
+    std::optional<std::span<const std::int32_t>> nodes = std::nullopt)
 {
   // Get function data array and information about layout
   assert(u.x());
@@ -698,60 +903,178 @@ void vtx_write_data(adios2::IO& io, adios2::Engine& engine,
   std::uint32_t num_dofs = index_map_bs
                            * (index_map->size_local() + index_map->num_ghosts())
                            / dofmap_bs;
-  if constexpr (std::is_scalar_v<T>)
+  if (nodes)
+    num_dofs = nodes->size();
+  // Pack a part (real or imaginary) of the values as type S, padded
+  // to num_comp components, and put it
+  auto put = [&]<typename S>(std::string name, S, auto part)
   {
-    // ---- Real
-    std::vector<T> data(num_dofs * num_comp, 0);
+    std::vector<S> data(num_dofs * num_comp, 0);
     for (std::size_t i = 0; i < num_dofs; ++i)
+    {
+      const std::size_t dof = nodes ? (*nodes)[i] : i;
       for (int j = 0; j < index_map_bs; ++j)
-        data[i * num_comp + j] = u_vector[i * index_map_bs + j];
+        data[i * num_comp + j] = part(u_vector[dof * index_map_bs + j]);
+    }
 
-    adios2::Variable output = impl_adios2::define_variable<T>(
-        io, u.name, {}, {}, {num_dofs, num_comp});
+    adios2::Variable output = impl_adios2::define_variable<S>(
+        io, name, {}, {}, {num_dofs, num_comp});
+    impl_adios2::add_operations(output, options.field_operators);
     engine.Put(output, data.data(), adios2::Mode::Sync);
-  }
-  else
+  };
+
+  auto put_parts = [&](auto type)
   {
-    // ---- Complex
-    using U = typename T::value_type;
+    if constexpr (std::is_scalar_v<T>)
+      put(u.name, type, [](T v) { return v; });
+    else
+    {
+      // ---- Complex
+      put(u.name + impl_adios2::field_ext[0], type,
+          [](T v) { return std::real(v); });
+      put(u.name + impl_adios2::field_ext[1], type,
+          [](T v) { return std::imag(v); });
+    }
+  };
 
-    std::vector<U> data(num_dofs * num_comp, 0);
-    for (std::size_t i = 0; i < num_dofs; ++i)
-      for (int j = 0; j < index_map_bs; ++j)
-        data[i * num_comp + j] = std::real(u_vector[i * index_map_bs + j]);
+  if (options.float32_fields)
+    put_parts(float());
+  else
+    put_parts(dolfinx::scalar_value_type_t<T>());
+}
+
+/// @brief Pack VTK cells with integer type `I` and put the connectivity.
+///
+/// The connectivity is written as [N0, v0_0,...., v0_N0, N1,
+/// v1_0,...., v1_N1,....], where N is the number of cell nodes and v0,
+/// etc, is the node index.
+/// @param[in] io ADIOS2 io object.
+/// @param[in] engine ADIOS2 engine object.
+/// @param[in] vtkcells VTK cell nodes (row-major storage).
+/// @param[in] shape Shape of `vtkcells`.
+/// @param[in] options Output options.
+template <std::integral I>
+void vtx_put_connectivity(adios2::IO& io, adios2::Engine& engine,
+                          std::span<const std::int64_t> vtkcells,
+                          std::array<std::size_t, 2> shape,
+                          const VTXOutputOptions& options)
+{
+  std::vector<I> cells(shape[0] * (shape[1] + 1), shape[1]);
+  for (std::size_t c = 0; c < shape[0]; ++c)
+  {
+    std::span vtkcell(vtkcells.data() + c * shape[1], shape[1]);
+    std::span cell(cells.data() + c * (shape[1] + 1), shape[1] + 1);
+    std::ranges::copy(vtkcell, std::next(cell.begin()));
+  }
 
-    adios2::Variable output_real = impl_adios2::define_variable<U>(
-        io, u.name + impl_adios2::field_ext[0], {}, {}, {num_dofs, num_comp});
-    engine.Put(output_real, data.data(), adios2::Mode::Sync);
+  adios2::Variable local_topology = impl_adios2::define_variable<I>(
+      io, "connectivity", {}, {}, {shape[0], shape[1] + 1});
+  impl_adios2::add_operations(local_topology, options.connectivity_operators);
+  engine.Put(local_topology, cells.data(), adios2::Mode::Sync);
+}
 
-    std::ranges::fill(data, 0);
-    for (std::size_t i = 0; i < num_dofs; ++i)
-      for (int j = 0; j < index_map_bs; ++j)
-        data[i * num_comp + j] = std::imag(u_vector[i * index_map_bs + j]);
-    adios2::Variable output_imag = impl_adios2::define_variable<U>(
-        io, u.name + impl_adios2::field_ext[1], {}, {}, {num_dofs, num_comp});
-    engine.Put(output_imag, data.data(), adios2::Mode::Sync);
+/// @brief Restrict VTK cells to a subset of the cells.
+/// @param[in] vtkcells VTK cell nodes (row-major storage), one row per
+/// cell.
+/// @param[in] num_cell_nodes Number of nodes per cell.
+/// @param[in] cells Rows of `vtkcells` to keep.
+/// @return (0) Sorted list of the nodes of the subset and (1) the VTK
+/// cell nodes of the subset, with nodes numbered by their position in
+/// (0).
+inline std::pair<std::vector<std::int32_t>, std::vector<std::int64_t>>
+vtx_restrict_cells(std::span<const std::int64_t> vtkcells,
+                   std::size_t num_cell_nodes,
+                   std::span<const std::int32_t> cells)
+{
+  std::vector<std::int64_t> cell_nodes;
+  cell_nodes.reserve(cells.size() * num_cell_nodes);
+  for (std::int32_t c : cells)
+  {
+    auto nodes = vtkcells.subspan(c * num_cell_nodes, num_cell_nodes);
+    cell_nodes.insert(cell_nodes.end(), nodes.begin(), nodes.end());
   }
+
+  std::vector<std::int32_t> nodes(cell_nodes.begin(), cell_nodes.end());
+  std::ranges::sort(nodes);
+  auto [unique_end, range_end] = std::ranges::unique(nodes);
+  nodes.erase(unique_end, range_end);
+  for (std::int64_t& n : cell_nodes)
+    n = std::distance(nodes.begin(), std::ranges::lower_bound(nodes, n));
+
+  return {std::move(nodes), std::move(cell_nodes)};
+}
+
+/// Put the connectivity as 32- or 64-bit integers, see
+/// VTXOutputOptions::int32_connectivity
+inline void vtx_write_connectivity(adios2::IO& io, adios2::Engine& engine,
+                                   std::span<const std::int64_t> vtkcells,
+                                   std::array<std::size_t, 2> shape,
+                                   const VTXOutputOptions& options)
+{
+  if (options.int32_connectivity)
+    vtx_put_connectivity<std::int32_t>(io, engine, vtkcells, shape, options);
+  else
+    vtx_put_connectivity<std::int64_t>(io, engine, vtkcells, shape, options);
 }
 
 /// Write mesh to file using VTX format
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] mesh The mesh
+/// @param[in] options Output options
+/// @param[in] vtkcells The mesh connectivity in VTK ordering, see
+/// io::extract_vtk_connectivity
 template <std::floating_point T>
 void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
-                    const mesh::Mesh<T>& mesh)
+                    const mesh::Mesh<T>& mesh, const VTXOutputOptions& options,
+                    std::span<const std::int64_t> vtkcells)
 {
   const mesh::Geometry<T>& geometry = mesh.geometry();
   auto topology = mesh.topology();
   assert(topology);
 
-  // "Put" geometry
   std::shared_ptr<const common::IndexMap> x_map = geometry.index_map();
   std::uint32_t num_vertices = x_map->size_local() + x_map->num_ghosts();
+  std::span<const T> x = geometry.x();
+  std::span<const std::int64_t> x_id = geometry.input_global_indices();
+  std::vector<std::uint8_t> x_ghost(num_vertices, 0);
+  std::fill(std::next(x_ghost.begin(), x_map->size_local()), x_ghost.end(), 1);
+
+  std::array<std::size_t, 2> shape
+      = {geometry.dofmap().extent(0), geometry.dofmap().extent(1)};
+  assert(vtkcells.size() == shape[0] * shape[1]);
+
+  // Restrict the output to a subset of cells and their nodes
+  std::vector<T> x_sub;
+  std::vector<std::int64_t> x_id_sub, vtkcells_sub;
+  if (options.cells)
+  {
+    auto [nodes, cells_sub]
+        = vtx_restrict_cells(vtkcells, shape[1], *options.cells);
+    x_sub.resize(nodes.size() * 3);
+    x_id_sub.resize(nodes.size());
+    std::vector<std::uint8_t> x_ghost_sub(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      std::copy_n(std::next(x.begin(), 3 * nodes[i]), 3,
+                  std::next(x_sub.begin(), 3 * i));
+      x_id_sub[i] = x_id[nodes[i]];
+      x_ghost_sub[i] = x_ghost[nodes[i]];
+    }
+
+    num_vertices = nodes.size();
+    x = x_sub;
+    x_id = x_id_sub;
+    x_ghost = std::move(x_ghost_sub);
+    vtkcells_sub = std::move(cells_sub);
+    vtkcells = vtkcells_sub;
+    shape[0] = options.cells->size();
+  }
+
+  // "Put" geometry
   adios2::Variable local_geometry = impl_adios2::define_variable<T>(
       io, "geometry", {}, {}, {num_vertices, 3});
-  engine.Put(local_geometry, geometry.x().data());
+  engine.Put(local_geometry, x.data());
 
   // Put number of nodes. The mesh data is written with local indices,
   // therefore we need the ghost vertices.
@@ -759,9 +1082,6 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
       io, "NumberOfNodes", {adios2::LocalValueDim});
   engine.Put<std::uint32_t>(vertices, num_vertices);
 
-  auto [vtkcells, shape]
-      = io::extract_vtk_connectivity(geometry.dofmap(), topology->cell_type());
-
   // Add cell metadata
   int tdim = topology->dim();
   adios2::Variable cell_var = impl_adios2::define_variable<std::uint32_t>(
@@ -772,35 +1092,35 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
   engine.Put<std::uint32_t>(
       celltype_var, cells::get_vtk_cell_type(topology->cell_type(), tdim));
 
-  // Pack mesh 'nodes'. Output is written as [N0, v0_0,...., v0_N0, N1,
-  // v1_0,...., v1_N1,....], where N is the number of cell nodes and v0,
-  // etc, is the node index
-  std::vector<std::int64_t> cells(shape[0] * (shape[1] + 1), shape[1]);
-  for (std::size_t c = 0; c < shape[0]; ++c)
-  {
-    std::span vtkcell(vtkcells.data() + c * shape[1], shape[1]);
-    std::span cell(cells.data() + c * (shape[1] + 1), shape[1] + 1);
-    std::ranges::copy(vtkcell, std::next(cell.begin()));
-  }
-
   // Put topology (nodes)
-  adios2::Variable local_topology = impl_adios2::define_variable<std::int64_t>(
-      io, "connectivity", {}, {}, {shape[0], shape[1] + 1});
-  engine.Put(local_topology, cells.data());
+  vtx_write_connectivity(io, engine, vtkcells, shape, options);
 
   // Vertex global ids and ghost markers
   adios2::Variable orig_id = impl_adios2::define_variable<std::int64_t>(
       io, "vtkOriginalPointIds", {}, {}, {num_vertices});
-  engine.Put(orig_id, geometry.input_global_indices().data());
+  engine.Put(orig_id, x_id.data());
 
-  std::vector<std::uint8_t> x_ghost(num_vertices, 0);
-  std::fill(std::next(x_ghost.begin(), x_map->size_local()), x_ghost.end(), 1);
   adios2::Variable ghost = impl_adios2::define_variable<std::uint8_t>(
       io, "vtkGhostType", {}, {}, {x_ghost.size()});
   engine.Put(ghost, x_ghost.data());
   engine.PerformPuts();
 }
 
+/// Write mesh to file using VTX format
+/// @param[in] io The ADIOS2 io object
+/// @param[in] engine The ADIOS2 engine object
+/// @param[in] mesh The mesh
+/// @param[in] options Output options
+template <std::floating_point T>
+void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
+                    const mesh::Mesh<T>& mesh,
+                    const VTXOutputOptions& options = {})
+{
+  auto [vtkcells, shape] = io::extract_vtk_connectivity(
+      mesh.geometry().dofmap(), mesh.topology()->cell_type());
+  vtx_write_mesh(io, engine, mesh, options, vtkcells);
+}
+
 /// @brief Given a FunctionSpace, create a topology and geometry based
 /// on the function space dof coordinates. Writes the topology and
 /// geometry using ADIOS2 in VTX format.
@@ -808,10 +1128,16 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] V The function space
+/// @param[in] options Output options
+/// @return (0) The global ids, (1) the ghost markers of the written
+/// nodes and (2) if VTXOutputOptions::cells is set, the written nodes
+/// (degree-of-freedom blocks of `V`).
 template <std::floating_point T>
-std::pair<std::vector<std::int64_t>, std::vector<std::uint8_t>>
+std::tuple<std::vector<std::int64_t>, std::vector<std::uint8_t>,
+           std::optional<std::vector<std::int32_t>>>
 vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
-                          const fem::FunctionSpace<T>& V)
+                          const fem::FunctionSpace<T>& V,
+                          const VTXOutputOptions& options = {})
 {
   auto mesh = V.mesh();
   assert(mesh);
@@ -822,29 +1148,38 @@ vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
   // Get a VTK mesh with points at the 'nodes'
   auto [x, xshape, x_id, x_ghost, vtk, vtkshape] = io::vtk_mesh_from_space(V);
 
-  std::uint32_t num_dofs = xshape[0];
-
-  // -- Pack mesh 'nodes'. Output is written as [N0, v0_0,...., v0_N0, N1,
-  // v1_0,...., v1_N1,....], where N is the number of cell nodes and v0,
-  // etc, is the node index.
-
-  // Create vector, setting all entries to nodes per cell (vtk.shape(1))
-  std::vector<std::int64_t> cells(vtkshape[0] * (vtkshape[1] + 1), vtkshape[1]);
-
-  // Set the [v0_0,...., v0_N0, v1_0,...., v1_N1,....] data
-  for (std::size_t c = 0; c < vtkshape[0]; ++c)
+  // Restrict the output to a subset of cells and their nodes
+  std::optional<std::vector<std::int32_t>> nodes;
+  if (options.cells)
   {
-    std::span vtkcell(vtk.data() + c * vtkshape[1], vtkshape[1]);
-    std::span cell(cells.data() + c * (vtkshape[1] + 1), vtkshape[1] + 1);
-    std::ranges::copy(vtkcell, std::next(cell.begin()));
+    auto [nodes_sub, vtk_sub]
+        = vtx_restrict_cells(vtk, vtkshape[1], *options.cells);
+    std::vector<T> x_sub(nodes_sub.size() * 3);
+    std::vector<std::int64_t> x_id_sub(nodes_sub.size());
+    std::vector<std::uint8_t> x_ghost_sub(nodes_sub.size());
+    for (std::size_t i = 0; i < nodes_sub.size(); ++i)
+    {
+      std::copy_n(std::next(x.begin(), 3 * nodes_sub[i]), 3,
+                  std::next(x_sub.begin(), 3 * i));
+      x_id_sub[i] = x_id[nodes_sub[i]];
+      x_ghost_sub[i] = x_ghost[nodes_sub[i]];
+    }
+
+    x = std::move(x_sub);
+    x_id = std::move(x_id_sub);
+    x_ghost = std::move(x_ghost_sub);
+    vtk = std::move(vtk_sub);
+    xshape[0] = nodes_sub.size();
+    vtkshape[0] = options.cells->size();
+    nodes = std::move(nodes_sub);
   }
 
-  // Define ADIOS2 variables for geometry, topology, celltypes and
-  // corresponding VTK data
+  std::uint32_t num_dofs = xshape[0];
+
+  // Define ADIOS2 variables for geometry, celltypes and corresponding
+  // VTK data
   adios2::Variable local_geometry
       = impl_adios2::define_variable<T>(io, "geometry", {}, {}, {num_dofs, 3});
-  adios2::Variable local_topology = impl_adios2::define_variable<std::int64_t>(
-      io, "connectivity", {}, {}, {vtkshape[0], vtkshape[1] + 1});
   adios2::Variable cell_type
       = impl_adios2::define_variable<std::uint32_t>(io, "types");
   adios2::Variable vertices = impl_adios2::define_variable<std::uint32_t>(
@@ -858,7 +1193,7 @@ vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
   engine.Put<std::uint32_t>(
       cell_type, cells::get_vtk_cell_type(topology->cell_type(), tdim));
   engine.Put(local_geometry, x.data());
-  engine.Put(local_topology, cells.data());
+  vtx_write_connectivity(io, engine, vtk, vtkshape, options);
 
   // Node global ids
   adios2::Variable orig_id = impl_adios2::define_variable<std::int64_t>(
@@ -869,7 +1204,7 @@ vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
   engine.Put(ghost, x_ghost.data());
 
   engine.PerformPuts();
-  return {std::move(x_id), std::move(x_ghost)};
+  return {std::move(x_id), std::move(x_ghost), std::move(nodes)};
 }
 } // namespace impl_vtx
 
@@ -898,13 +1233,19 @@ public:
   /// @param[in] filename Name of output file.
   /// @param[in] mesh Mesh to write.
   /// @param[in] engine ADIOS2 engine type.
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data. If zero, the engine default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters.
   /// @note This format supports arbitrary degree meshes.
   /// @note The mesh geometry can be updated between write steps but the
   /// topology should not be changed between write steps.
   VTXWriter(MPI_Comm comm, const std::filesystem::path& filename,
             std::shared_ptr<const mesh::Mesh<T>> mesh,
-            std::string engine = "BPFile")
-      : ADIOS2Writer(comm, filename, "VTX mesh writer", engine), _mesh(mesh),
+            std::string engine = "BPFile", int num_aggregators = 0,
+            const adios2::Params& engine_parameters = {})
+      : ADIOS2Writer(comm, filename, "VTX mesh writer", engine,
+                     num_aggregators, engine_parameters),
+        _mesh(mesh),
         _mesh_reuse_policy(VTXMeshPolicy::update), _is_piecewise_constant(false)
   {
     // Define VTK scheme attribute for mesh
@@ -926,11 +1267,17 @@ public:
   /// @param[in] mesh_policy Controls if the mesh is written to file at
   /// the first time step only or is re-written (updated) at each time
   /// step.
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data. If zero, the engine default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters.
   /// @note This format supports arbitrary degree meshes.
   VTXWriter(MPI_Comm comm, const std::filesystem::path& filename,
             const typename adios2_writer::U<T>& u, std::string engine,
-            VTXMeshPolicy mesh_policy = VTXMeshPolicy::update)
-      : ADIOS2Writer(comm, filename, "VTX function writer", engine),
+            VTXMeshPolicy mesh_policy = VTXMeshPolicy::update,
+            int num_aggregators = 0,
+            const adios2::Params& engine_parameters = {})
+      : ADIOS2Writer(comm, filename, "VTX function writer", engine,
+                     num_aggregators, engine_parameters),
         _mesh(impl_adios2::extract_common_mesh<T>(u)),
         _mesh_reuse_policy(mesh_policy), _u(u), _is_piecewise_constant(false)
   {
@@ -1041,6 +1388,18 @@ public:
   // Copy assignment
   VTXWriter& operator=(const VTXWriter&) = delete;
 
+  /// @brief Set options to reduce the size of the output, e.g. the
+  /// precision of function values and compression operators.
+  /// @param[in] options The output options
+  /// @note The options must be set before the first call to `write`.
+  void set_output_options(const VTXOutputOptions& options)
+  {
+    _output_options = options;
+  }
+
+  /// The options of the output
+  const VTXOutputOptions& output_options() const { return _output_options; }
+
   /// @brief Write data with a given time stamp.
   /// @param[in] t Time stamp to associate with output.
   void write(double t)
@@ -1050,34 +1409,72 @@ public:
         = impl_adios2::define_variable<double>(*_io, "step");
 
     assert(_engine);
-    _engine->BeginStep();
+    if (!begin_step())
+      return;
     _engine->template Put<double>(var_step, t);
 
     // If we have no functions or DG functions write the mesh to file
     if (_is_piecewise_constant or _u.empty())
     {
-      impl_vtx::vtx_write_mesh(*_io, *_engine, *_mesh);
+      // The connectivity does not change between steps and is computed
+      // once
+      if (!_vtkcells)
+      {
+        _vtkcells = io::extract_vtk_connectivity(
+                        _mesh->geometry().dofmap(),
+                        _mesh->topology()->cell_type())
+                        .first;
+      }
+      impl_vtx::vtx_write_mesh(*_io, *_engine, *_mesh, _output_options,
+                               *_vtkcells);
       if (_is_piecewise_constant)
       {
+        // The written values are the dofs of the written cells, in the
+        // order of the cells, and are computed once
+        if (_output_options.cells and !_nodes)
+        {
+          _nodes = std::visit(
+              [&cells = *_output_options.cells](auto& u)
+              {
+                auto dofmap = u->function_space()->dofmap();
+                assert(dofmap);
+                std::vector<std::int32_t> nodes(cells.size());
+                std::ranges::transform(cells, nodes.begin(),
+                                       [&dofmap](auto c)
+                                       { return dofmap->cell_dofs(c)[0]; });
+                return nodes;
+              },
+              _u[0]);
+        }
+
         for (auto& v : _u)
         {
-          std::visit([&](auto& u)
-                     { impl_vtx::vtx_write_data(*_io, *_engine, *u); }, v);
+          std::visit(
+              [&](auto& u)
+              {
+                impl_vtx::vtx_write_data(
+                    *_io, *_engine, *u, _output_options,
+                    _nodes
+                        ? std::optional<std::span<const std::int32_t>>(*_nodes)
+                        : std::nullopt);
+              },
+              v);
         }
       }
     }
     else
     {
       if (_mesh_reuse_policy == VTXMeshPolicy::update
-          or !(_io->template InquireVariable<std::int64_t>("connectivity")))
+          or !(_io->template InquireVariable<std::int64_t>("connectivity")
+               or _io->template InquireVariable<std::int32_t>("connectivity")))
       {
         // Write a single mesh for functions as they share finite
         // element
-        std::tie(_x_id, _x_ghost) = std::visit(
+        std::tie(_x_id, _x_ghost, _nodes) = std::visit(
             [&](auto& u)
             {
-              return impl_vtx::vtx_write_mesh_from_space(*_io, *_engine,
-                                                         *u->function_space());
+              return impl_vtx::vtx_write_mesh_from_space(
+                  *_io, *_engine, *u->function_space(), _output_options);
             },
             _u[0]);
       }
@@ -1096,12 +1493,19 @@ public:
       // Write function data for each function to file
       for (auto& v : _u)
       {
-        std::visit([&](auto& u)
-                   { impl_vtx::vtx_write_data(*_io, *_engine, *u); }, v);
+        std::visit(
+            [&](auto& u)
+            {
+              impl_vtx::vtx_write_data(
+                  *_io, *_engine, *u, _output_options,
+                  _nodes ? std::optional<std::span<const std::int32_t>>(*_nodes)
+                         : std::nullopt);
+            },
+            v);
       }
     }
 
-    _engine->EndStep();
+    end_step();
   }
 
 private:
@@ -1114,8 +1518,19 @@ private:
   std::vector<std::int64_t> _x_id;
   std::vector<std::uint8_t> _x_ghost;
 
+  // Written nodes, if a subset of the cells is written. For piecewise
+  // constant functions, the dofs of the written cells.
+  std::optional<std::vector<std::int32_t>> _nodes;
+
+  // Mesh connectivity in VTK ordering, computed at the first write of
+  // the mesh geometry
+  std::optional<std::vector<std::int64_t>> _vtkcells;
+
   // Special handling of piecewise constant functions
   bool _is_piecewise_constant;
+
+  // Options to reduce the size of the output
+  VTXOutputOptions _output_options;
 };
 
 /// Type deduction
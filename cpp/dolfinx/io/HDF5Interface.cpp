@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "HDF5Interface.h"
+#include <algorithm>
 #include <filesystem>
 
 using namespace dolfinx;
@@ -49,11 +50,32 @@ bool has_group(hid_t handle, const std::string& group_name)
   return object_info.type == H5O_TYPE_GROUP;
 }
 
+/// Get the HDF5 identifier of a plugin filter
+H5Z_filter_t filter_id(io::hdf5::Filter filter)
+{
+  switch (filter)
+  {
+  case io::hdf5::Filter::deflate:
+    return H5Z_FILTER_DEFLATE;
+  case io::hdf5::Filter::zstd:
+    return 32015;
+  case io::hdf5::Filter::blosc:
+    return 32001;
+  case io::hdf5::Filter::sz:
+    return 32017;
+  case io::hdf5::Filter::zfp:
+    return 32013;
+  default:
+    throw std::runtime_error("Unknown HDF5 filter.");
+  }
+}
+
 } // namespace
 
 //-----------------------------------------------------------------------------
 hid_t io::hdf5::open_file(MPI_Comm comm, const std::filesystem::path& filename,
-                          const std::string& mode, bool use_mpi_io)
+                          const std::string& mode, bool use_mpi_io,
+                          const FileOptions& options)
 {
   // Set parallel access with communicator
   const hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
@@ -65,6 +87,22 @@ hid_t io::hdf5::open_file(MPI_Comm comm, const std::filesystem::path& filename,
     if (H5Pset_fapl_mpio(plist_id, comm, info) < 0)
       throw std::runtime_error("Call to H5Pset_fapl_mpio unsuccessful");
     MPI_Info_free(&info);
+
+    if (options.collective_metadata)
+    {
+      if (H5Pset_all_coll_metadata_ops(plist_id, true) < 0)
+        throw std::runtime_error("Call to H5Pset_all_coll_metadata_ops failed");
+      if (H5Pset_coll_metadata_write(plist_id, true) < 0)
+        throw std::runtime_error("Call to H5Pset_coll_metadata_write failed");
+    }
+  }
+
+  if (options.alignment[0] < 0 or options.alignment[1] < 1)
+    throw std::runtime_error("Invalid HDF5 alignment.");
+  if (H5Pset_alignment(plist_id, options.alignment[0], options.alignment[1])
+      < 0)
+  {
+    throw std::runtime_error("Call to H5Pset_alignment unsuccessful");
   }
 
   hid_t file_id = -1;
@@ -116,6 +154,103 @@ hid_t io::hdf5::open_file(MPI_Comm comm, const std::filesystem::path& filename,
   return file_id;
 }
 //-----------------------------------------------------------------------------
+hid_t io::hdf5::create_dataset_properties(std::span<const hsize_t> shape,
+                                          bool floating_point,
+                                          const DatasetOptions& options,
+                                          bool use_mpi_io)
+{
+  // Lossy filters are applied to floating point data only
+  const bool lossy
+      = options.filter == Filter::sz or options.filter == Filter::zfp;
+  const bool use_filter
+      = options.filter != Filter::none and (!lossy or floating_point);
+  if (!options.chunking and !use_filter)
+    return H5P_DEFAULT;
+
+  // Chunks cannot be empty, so store empty datasets contiguously
+  if (std::ranges::find(shape, 0) != shape.end())
+    return H5P_DEFAULT;
+
+  std::vector<hsize_t> chunk(shape.begin(), shape.end());
+  if (options.chunk_shape.empty())
+  {
+    // Set chunk size and limit to 1kB min/1MB max
+    chunk[0] = std::clamp<hsize_t>(shape[0] / 2, 1024, 1048576);
+  }
+  else
+  {
+    if (options.chunk_shape.size() != shape.size())
+    {
+      throw std::runtime_error(
+          "HDF5 chunk shape does not match the rank of the dataset.");
+    }
+
+    for (std::size_t i = 0; i < chunk.size(); ++i)
+    {
+      if (options.chunk_shape[i] < 1)
+        throw std::runtime_error("HDF5 chunk dimensions must be positive.");
+      chunk[i] = options.chunk_shape[i];
+    }
+  }
+
+  // Chunks cannot be larger than a fixed-size dataset
+  for (std::size_t i = 0; i < chunk.size(); ++i)
+    chunk[i] = std::min(chunk[i], shape[i]);
+
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+  if (plist_id == H5I_INVALID_HID)
+    throw std::runtime_error("Failed to create HDF5 property list.");
+  if (H5Pset_chunk(plist_id, chunk.size(), chunk.data()) < 0)
+    throw std::runtime_error("Failed to set HDF5 chunk shape.");
+
+  if (use_filter)
+  {
+#if !H5_VERSION_GE(1, 10, 2)
+    if (use_mpi_io)
+    {
+      throw std::runtime_error("Parallel writes of compressed HDF5 datasets "
+                               "require HDF5 1.10.2 or later.");
+    }
+#endif
+
+    const H5Z_filter_t id = filter_id(options.filter);
+    if (H5Zfilter_avail(id) <= 0)
+    {
+      throw std::runtime_error("HDF5 filter " + std::to_string(id)
+                               + " is not available.");
+    }
+
+    if (options.shuffle and H5Pset_shuffle(plist_id) < 0)
+      throw std::runtime_error("Failed to set HDF5 shuffle filter.");
+
+    if (options.filter == Filter::deflate)
+    {
+      const unsigned int level = options.filter_parameters.empty()
+                                     ? 4
+                                     : options.filter_parameters.front();
+      if (H5Pset_deflate(plist_id, level) < 0)
+        throw std::runtime_error("Failed to set HDF5 deflate filter.");
+    }
+    else
+    {
+      if (H5Pset_filter(plist_id, id, H5Z_FLAG_MANDATORY,
+                        options.filter_parameters.size(),
+                        options.filter_parameters.data())
+          < 0)
+      {
+        throw std::runtime_error("Failed to set HDF5 filter.");
+      }
+    }
+  }
+
+  // Chunks are written in full by the collective write, so filling
+  // them with the fill value first is redundant
+  if (use_mpi_io and H5Pset_fill_time(plist_id, H5D_FILL_TIME_NEVER) < 0)
+    throw std::runtime_error("Failed to set HDF5 fill time.");
+
+  return plist_id;
+}
+//-----------------------------------------------------------------------------
 void io::hdf5::close_file(hid_t handle)
 {
   if (H5Fclose(handle) < 0)
@@ -6,16 +6,23 @@
 
 #pragma once
 
+#include "aggregation.h"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
 #include <dolfinx/common/log.h>
 #include <filesystem>
+#include <functional>
 #include <hdf5.h>
+#include <memory>
 #include <mpi.h>
 #include <numeric>
+#include <span>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace dolfinx::io::hdf5
@@ -50,13 +57,77 @@ hid_t hdf5_type()
   }
 }
 
+/// @brief Compression filters for HDF5 datasets.
+///
+/// Filters other than Filter::deflate are HDF5 plugins that must be
+/// available at runtime (see `H5Zfilter_avail`). Filter::sz and
+/// Filter::zfp are lossy and are applied to floating point data only.
+enum class Filter
+{
+  none,    ///< No compression
+  deflate, ///< gzip (built into HDF5)
+  zstd,    ///< Zstandard (registered filter 32015)
+  blosc,   ///< Blosc (registered filter 32001)
+  sz,      ///< SZ, lossy (registered filter 32017)
+  zfp      ///< ZFP, lossy (registered filter 32013)
+};
+
+/// @brief Options for the creation of HDF5 datasets.
+struct DatasetOptions
+{
+  /// Use chunked storage. Chunked storage is always used if a filter
+  /// is set.
+  bool chunking = false;
+
+  /// Shape of a chunk. If empty, the number of rows in a chunk is
+  /// computed from the number of rows in the dataset and a chunk holds
+  /// complete rows. Entries larger than the dataset shape are clamped.
+  std::vector<std::int64_t> chunk_shape = {};
+
+  /// Compression filter
+  Filter filter = Filter::none;
+
+  /// Filter parameters (the `cd_values` of `H5Pset_filter`). For
+  /// Filter::deflate the first entry is the compression level (default
+  /// 4). The meaning of the parameters of the plugin filters is defined
+  /// by the plugin.
+  std::vector<unsigned int> filter_parameters = {};
+
+  /// Apply the byte shuffle filter before compression, which improves
+  /// the compression of floating point data
+  bool shuffle = false;
+
+  /// If set, the data of the ranks in an aggregation group is gathered
+  /// onto the aggregator of the group, and only the aggregators write
+  /// data. The aggregator must be created on the communicator of the
+  /// file.
+  std::shared_ptr<const Aggregator> aggregator = nullptr;
+};
+
+/// @brief File access options for HDF5 files.
+struct FileOptions
+{
+  /// Objects with size greater than or equal to `alignment[0]` bytes
+  /// are aligned on `alignment[1]` byte boundaries in the file, see
+  /// `H5Pset_alignment`. Aligning to the file system stripe size can
+  /// improve parallel write performance.
+  std::array<std::int64_t, 2> alignment = {1, 1};
+
+  /// Perform metadata reads and writes collectively, see
+  /// `H5Pset_all_coll_metadata_ops` and `H5Pset_coll_metadata_write`.
+  /// Only used with MPI-IO.
+  bool collective_metadata = false;
+};
+
 /// Open HDF5 and return file descriptor
 /// @param[in] comm MPI communicator
 /// @param[in] filename Name of the HDF5 file to open
 /// @param[in] mode Mode in which to open the file (w, r, a)
 /// @param[in] use_mpi_io True if MPI-IO should be used
+/// @param[in] options File access options
 hid_t open_file(MPI_Comm comm, const std::filesystem::path& filename,
-                const std::string& mode, bool use_mpi_io);
+                const std::string& mode, bool use_mpi_io,
+                const FileOptions& options = {});
 
 /// Close HDF5 file
 /// @param[in] handle HDF5 file handle
@@ -109,6 +180,20 @@ bool get_mpi_atomicity(hid_t handle);
 /// @param[in] dataset_path Data set path to add
 void add_group(hid_t handle, const std::string& dataset_path);
 
+/// @brief Create a dataset creation property list.
+/// @param[in] shape The global shape of the dataset
+/// @param[in] floating_point True if the dataset holds floating point
+/// data. Lossy filters are not applied to other data.
+/// @param[in] options The dataset creation options
+/// @param[in] use_mpi_io True if the dataset will be written using
+/// MPI-IO
+/// @return The property list, or `H5P_DEFAULT` if no options are
+/// required. Should be closed by caller using `H5Pclose` if not
+/// `H5P_DEFAULT`.
+hid_t create_dataset_properties(std::span<const hsize_t> shape,
+                                bool floating_point,
+                                const DatasetOptions& options, bool use_mpi_io);
+
 /// Write data to existing HDF file as defined by range blocks on each
 /// process
 /// @param[in] file_handle HDF5 file handle
@@ -118,12 +203,13 @@ void add_group(hid_t handle, const std::string& dataset_path);
 /// @param[in] range The local range on this processor
 /// @param[in] global_size The global shape shape of the array
 /// @param[in] use_mpi_io True if MPI-IO should be used
-/// @param[in] use_chunking True if chunking should be used
+/// @param[in] options Dataset creation options, e.g. chunking and
+/// compression
 template <typename T>
 void write_dataset(hid_t file_handle, const std::string& dataset_path,
                    const T* data, std::array<std::int64_t, 2> range,
                    const std::vector<int64_t>& global_size, bool use_mpi_io,
-                   bool use_chunking)
+                   const DatasetOptions& options = {})
 {
   // Data rank
   const int rank = global_size.size();
@@ -137,9 +223,29 @@ void write_dataset(hid_t file_handle, const std::string& dataset_path,
   // Get HDF5 data type
   const hid_t h5type = hdf5::hdf5_type<T>();
 
+  // Blocks of rows written by this rank. With aggregation, the
+  // aggregators write the rows of their group.
+  std::vector<std::array<std::int64_t, 2>> blocks = {range};
+  std::vector<T> buffer;
+  if (options.aggregator)
+  {
+    const std::size_t row_size = std::reduce(
+        std::next(global_size.begin()), global_size.end(), std::int64_t(1),
+        std::multiplies{});
+    std::tie(buffer, blocks) = options.aggregator->gather(
+        std::span(data, (range[1] - range[0]) * row_size), range);
+    data = buffer.data();
+  }
+
   // Hyperslab selection parameters
   std::vector<hsize_t> count(global_size.begin(), global_size.end());
   count[0] = range[1] - range[0];
+  if (options.aggregator)
+  {
+    count[0] = std::transform_reduce(blocks.begin(), blocks.end(),
+                                     std::int64_t(0), std::plus{},
+                                     [](auto b) { return b[1] - b[0]; });
+  }
 
   // Data offsets
   std::vector<hsize_t> offset(rank, 0);
@@ -153,23 +259,9 @@ void write_dataset(hid_t file_handle, const std::string& dataset_path,
   if (filespace0 == H5I_INVALID_HID)
     throw std::runtime_error("Failed to create HDF5 data space");
 
-  // Set chunking parameters
-  hid_t chunking_properties;
-  if (use_chunking)
-  {
-    // Set chunk size and limit to 1kB min/1MB max
-    hsize_t chunk_size = dimsf[0] / 2;
-    if (chunk_size > 1048576)
-      chunk_size = 1048576;
-    if (chunk_size < 1024)
-      chunk_size = 1024;
-
-    hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
-    chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(chunking_properties, rank, chunk_dims);
-  }
-  else
-    chunking_properties = H5P_DEFAULT;
+  // Set chunking and filter parameters
+  const hid_t chunking_properties = create_dataset_properties(
+      dimsf, std::is_floating_point_v<T>, options, use_mpi_io);
 
   // Check that group exists and recursively create if required
   const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
@@ -193,8 +285,29 @@ void write_dataset(hid_t file_handle, const std::string& dataset_path,
 
   // Create a file dataspace within the global space - a hyperslab
   const hid_t filespace1 = H5Dget_space(dset_id);
-  herr_t status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset.data(),
-                                      nullptr, count.data(), nullptr);
+  herr_t status = 0;
+  if (!options.aggregator)
+  {
+    status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset.data(),
+                                 nullptr, count.data(), nullptr);
+  }
+  else if (blocks.empty())
+    status = H5Sselect_none(filespace1);
+  else
+  {
+    // Union of the hyperslabs of the blocks, which are ordered by
+    // position as the data in memory
+    for (std::size_t i = 0; i < blocks.size() and status >= 0; ++i)
+    {
+      std::vector<hsize_t> block_count = count;
+      block_count[0] = blocks[i][1] - blocks[i][0];
+      offset[0] = blocks[i][0];
+      status = H5Sselect_hyperslab(filespace1,
+                                   i == 0 ? H5S_SELECT_SET : H5S_SELECT_OR,
+                                   offset.data(), nullptr, block_count.data(),
+                                   nullptr);
+    }
+  }
   if (status < 0)
     throw std::runtime_error("Failed to create HDF5 dataspace.");
 
@@ -217,7 +330,7 @@ void write_dataset(hid_t file_handle, const std::string& dataset_path,
         "Failed to write HDF5 local dataset into hyperslab.");
   }
 
-  if (use_chunking)
+  if (chunking_properties != H5P_DEFAULT)
   {
     // Close chunking properties
     if (H5Pclose(chunking_properties) < 0)
@@ -345,8 +458,82 @@ std::vector<T> read_dataset(hid_t dset_id, std::array<std::int64_t, 2> range,
   auto timer_end = std::chrono::system_clock::now();
   std::chrono::duration<double> dt = (timer_end - timer_start);
   double data_rate = data.size() * sizeof(T) / (1e6 * dt.count());
-  spdlog::info("HDF5 Read data rate: {} MB/s", data_rate);
+  DOLFINX_LOG_INFO("HDF5 Read data rate: {} MB/s", data_rate);
 
   return data;
 }
+
+/// @brief Read a range of rows of a HDF5 dataset in blocks of bounded
+/// size.
+///
+/// The rows are read in consecutive blocks into a buffer of at most
+/// `buffer_size` bytes (but at least one row) that is reused for each
+/// block. Each block is passed to `f` before the next block is read.
+/// This bounds the transient memory that is used for reading when the
+/// data is copied or transformed into its final storage by `f`.
+///
+/// @tparam T The data type to read into.
+/// @param[in] dset_id HDF5 dataset handle.
+/// @param[in] range The range of rows to read on this process.
+/// @param[in] buffer_size Maximum size (bytes) of the read buffer.
+/// @param[in] f Callable with signature `f(std::span<const T> block,
+/// std::int64_t row)`, where `block` holds the rows (row-major storage)
+/// beginning at row `range[0] + row`.
+template <typename T, typename F>
+void read_dataset_blocks(hid_t dset_id, std::array<std::int64_t, 2> range,
+                         std::size_t buffer_size, F&& f)
+{
+  hid_t dataspace = H5Dget_space(dset_id);
+  if (dataspace == H5I_INVALID_HID)
+    throw std::runtime_error("Failed to open HDF5 data space.");
+
+  int rank = H5Sget_simple_extent_ndims(dataspace);
+  if (rank < 1)
+    throw std::runtime_error("Failed to get rank of data space.");
+  std::vector<hsize_t> shape(rank);
+  if (int ndims = H5Sget_simple_extent_dims(dataspace, shape.data(), nullptr);
+      ndims != rank)
+  {
+    throw std::runtime_error("Failed to get dimensionality of dataspace.");
+  }
+
+  // Number of rows per block
+  const std::size_t row_size = std::reduce(
+      std::next(shape.begin()), shape.end(), 1, std::multiplies{});
+  const std::int64_t max_rows = std::max<std::int64_t>(
+      1, buffer_size / (std::max<std::size_t>(row_size, 1) * sizeof(T)));
+
+  std::vector<T> buffer;
+  std::vector<hsize_t> offset(rank, 0), count = shape;
+  for (std::int64_t r0 = range[0]; r0 < range[1]; r0 += max_rows)
+  {
+    offset[0] = r0;
+    count[0] = std::min(max_rows, range[1] - r0);
+    if (herr_t status
+        = H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, offset.data(),
+                              nullptr, count.data(), nullptr);
+        status < 0)
+    {
+      throw std::runtime_error("Failed to select HDF5 hyperslab.");
+    }
+
+    hid_t memspace = H5Screate_simple(rank, count.data(), nullptr);
+    if (memspace == H5I_INVALID_HID)
+      throw std::runtime_error("Failed to create HDF5 dataspace.");
+    buffer.resize(count[0] * row_size);
+    if (herr_t status = H5Dread(dset_id, hdf5::hdf5_type<T>(), memspace,
+                                dataspace, H5P_DEFAULT, buffer.data());
+        status < 0)
+    {
+      throw std::runtime_error("Failed to read HDF5 data.");
+    }
+    if (herr_t status = H5Sclose(memspace); status < 0)
+      throw std::runtime_error("Failed to close HDF5 memory space.");
+
+    f(std::span<const T>(buffer), r0 - range[0]);
+  }
+
+  if (herr_t status = H5Sclose(dataspace); status < 0)
+    throw std::runtime_error("Failed to close HDF5 dataspace.");
+}
 } // namespace dolfinx::io::hdf5
@@ -9,6 +9,7 @@
 #include "vtk_utils.h"
 #include "xdmf_utils.h"
 #include <algorithm>
+#include <bit>
 #include <concepts>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
@@ -20,11 +21,16 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <filesystem>
+#include <fstream>
 #include <iterator>
+#include <numeric>
 #include <pugixml.hpp>
 #include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 using namespace dolfinx;
 
@@ -63,11 +69,158 @@ std::stringstream container_to_string(const T& x, int precision)
 {
   std::stringstream s;
   s.precision(precision);
-  std::ranges::for_each(x, [&s](auto e) { s << e << " "; });
+  std::ranges::for_each(x,
+                        [&s](auto e)
+                        {
+                          // Write 8-bit integers as numbers, not characters
+                          if constexpr (sizeof(e) == 1)
+                            s << static_cast<int>(e) << " ";
+                          else
+                            s << e << " ";
+                        });
   return s;
 }
 //----------------------------------------------------------------------------
 
+/// VTK name of the data type `T`
+template <typename T>
+std::string vtk_type()
+{
+  const std::string size = std::to_string(8 * sizeof(T));
+  if constexpr (std::is_floating_point_v<T>)
+    return "Float" + size;
+  else if constexpr (std::is_signed_v<T>)
+    return "Int" + size;
+  else
+    return "UInt" + size;
+}
+//----------------------------------------------------------------------------
+
+/// Encode bytes in base64
+std::string base64_encode(std::span<const char> data)
+{
+  constexpr std::string_view chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                     "abcdefghijklmnopqrstuvwxyz"
+                                     "0123456789+/";
+  std::string s;
+  s.reserve(4 * ((data.size() + 2) / 3));
+  for (std::size_t i = 0; i < data.size(); i += 3)
+  {
+    std::uint32_t b = std::uint32_t(std::uint8_t(data[i])) << 16;
+    if (i + 1 < data.size())
+      b |= std::uint32_t(std::uint8_t(data[i + 1])) << 8;
+    if (i + 2 < data.size())
+      b |= std::uint8_t(data[i + 2]);
+    s += chars[(b >> 18) & 63];
+    s += chars[(b >> 12) & 63];
+    s += i + 1 < data.size() ? chars[(b >> 6) & 63] : '=';
+    s += i + 2 < data.size() ? chars[b & 63] : '=';
+  }
+  return s;
+}
+//----------------------------------------------------------------------------
+
+/// @brief Writer of the values of the DataArray nodes of a VTK XML
+/// file.
+///
+/// For binary encodings each array is preceded by its size in bytes as
+/// a UInt64. With io::VTKFile::Encoding::Raw the arrays are collected
+/// in a buffer that is written in the AppendedData section of the file
+/// by save, which avoids formatting the values as text.
+class DataWriter
+{
+public:
+  explicit DataWriter(io::VTKFile::Encoding encoding) : _encoding(encoding) {}
+
+  /// Add the attributes required by the encoding to the VTKFile node
+  void add_header(pugi::xml_node& vtk_node) const
+  {
+    if (_encoding == io::VTKFile::Encoding::ASCII)
+      return;
+    vtk_node.append_attribute("byte_order")
+        = std::endian::native == std::endian::little ? "LittleEndian"
+                                                     : "BigEndian";
+    vtk_node.append_attribute("header_type") = "UInt64";
+  }
+
+  /// Add `values` to a DataArray node
+  template <typename T>
+  void add(pugi::xml_node& node, std::span<const T> values)
+  {
+    switch (_encoding)
+    {
+    case io::VTKFile::Encoding::ASCII:
+      node.append_attribute("format") = "ascii";
+      node.append_child(pugi::node_pcdata)
+          .set_value(container_to_string(values, 16).str().c_str());
+      break;
+    case io::VTKFile::Encoding::Base64:
+    {
+      node.append_attribute("format") = "binary";
+      std::vector<char> bytes;
+      append(values, bytes);
+      node.append_child(pugi::node_pcdata)
+          .set_value(base64_encode(bytes).c_str());
+      break;
+    }
+    case io::VTKFile::Encoding::Raw:
+      node.append_attribute("format") = "appended";
+      node.append_attribute("offset") = _data.size();
+      append(values, _data);
+      break;
+    }
+  }
+
+  /// Save the XML document, followed by the appended data, to file
+  void save(pugi::xml_document& doc, const std::filesystem::path& filename)
+  {
+    if (_encoding != io::VTKFile::Encoding::Raw)
+    {
+      doc.save_file(filename.c_str(), "  ");
+      return;
+    }
+
+    // The raw data is preceded by an underscore, which is used to
+    // locate the data in the XML text
+    pugi::xml_node data_node
+        = doc.child("VTKFile").append_child("AppendedData");
+    data_node.append_attribute("encoding") = "raw";
+    data_node.append_child(pugi::node_pcdata).set_value("_");
+    std::ostringstream s;
+    doc.save(s, "  ");
+    const std::string xml = s.str();
+    const std::size_t pos = xml.rfind("_</AppendedData>") + 1;
+    assert(pos != 0);
+
+    std::ofstream file(filename, std::ios::binary);
+    file.write(xml.data(), pos);
+    file.write(_data.data(), _data.size());
+    file.write(xml.data() + pos, xml.size() - pos);
+    if (!file)
+      throw std::runtime_error("Failed to write VTK file.");
+  }
+
+private:
+  // Append the size in bytes of `values` and the bytes of `values` to
+  // `bytes`
+  template <typename T>
+  static void append(std::span<const T> values, std::vector<char>& bytes)
+  {
+    const std::uint64_t size = values.size_bytes();
+    auto header = reinterpret_cast<const char*>(&size);
+    bytes.insert(bytes.end(), header, header + sizeof(size));
+    auto data = reinterpret_cast<const char*>(values.data());
+    bytes.insert(bytes.end(), data, data + size);
+  }
+
+  io::VTKFile::Encoding _encoding;
+
+  // Data of the AppendedData section
+  std::vector<char> _data;
+};
+//----------------------------------------------------------------------------
+
+template <typename U>
 void add_pvtu_mesh(pugi::xml_node& node)
 {
   // -- Cell data (PCellData)
@@ -104,7 +257,7 @@ void add_pvtu_mesh(pugi::xml_node& node)
   if (x_data_node.empty())
     x_data_node = node.append_child("PPoints");
   pugi::xml_node data_node = x_data_node.append_child("PDataArray");
-  data_node.append_attribute("type") = "Float64";
+  data_node.append_attribute("type") = vtk_type<U>().c_str();
   data_node.append_attribute("NumberOfComponents") = "3";
 }
 //----------------------------------------------------------------------------
@@ -114,25 +267,21 @@ void add_pvtu_mesh(pugi::xml_node& node)
 /// @param[in] num_components An array indicating the value shape of `values`
 /// @param[in] values The data array to add
 /// @param[in,out] data_node The XML node to add data to
+/// @param[in,out] writer The writer of the data values
 template <typename T>
 void add_data_float(const std::string& name,
                     std::span<const std::size_t> num_components,
-                    std::span<const T> values, pugi::xml_node& node)
+                    std::span<const T> values, pugi::xml_node& node,
+                    DataWriter& writer)
 {
   static_assert(std::is_floating_point_v<T>, "Scalar must be a float");
 
-  constexpr int size = 8 * sizeof(T);
-  std::string type = std::string("Float") + std::to_string(size);
-
   pugi::xml_node field_node = node.append_child("DataArray");
-  field_node.append_attribute("type") = type.c_str();
+  field_node.append_attribute("type") = vtk_type<T>().c_str();
   field_node.append_attribute("Name") = name.c_str();
-  field_node.append_attribute("format") = "ascii";
   if (!num_components.empty())
     field_node.append_attribute("NumberOfComponents") = num_components.front();
-
-  field_node.append_child(pugi::node_pcdata)
-      .set_value(container_to_string(values, 16).str().c_str());
+  writer.add(field_node, values);
 }
 //----------------------------------------------------------------------------
 
@@ -144,23 +293,25 @@ void add_data_float(const std::string& name,
 /// @param[in] num_components An array indicating the value shape of `values`
 /// @param[in] values The data array to add
 /// @param[in,out] data_node The XML node to add data to
+/// @param[in,out] writer The writer of the data values
 template <typename T>
 void add_data(const std::string& name,
               std::span<const std::size_t> num_components,
-              std::span<const T> values, pugi::xml_node& node)
+              std::span<const T> values, pugi::xml_node& node,
+              DataWriter& writer)
 {
   if constexpr (std::is_scalar_v<T>)
-    add_data_float(name, num_components, values, node);
+    add_data_float(name, num_components, values, node, writer);
   else
   {
     using U = typename T::value_type;
     std::vector<U> v(values.size());
     std::ranges::transform(values, v.begin(), [](auto x) { return x.real(); });
     add_data_float(name + field_ext[0], num_components, std::span<const U>(v),
-                   node);
+                   node, writer);
     std::ranges::transform(values, v.begin(), [](auto x) { return x.imag(); });
     add_data_float(name + field_ext[1], num_components, std::span<const U>(v),
-                   node);
+                   node, writer);
   }
 }
 //----------------------------------------------------------------------------
@@ -177,6 +328,7 @@ void add_data(const std::string& name,
 /// @param[in] celltype The cell type
 /// @param[in] tdim Topological dimension of the cells
 /// @param[in,out] piece_node The XML node to add data to
+/// @param[in,out] writer The writer of the data values
 template <typename U>
 void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
               std::span<const std::int64_t> x_id,
@@ -184,54 +336,41 @@ void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
               std::span<const std::int64_t> cells,
               std::array<std::size_t, 2> cshape,
               const common::IndexMap& cellmap, mesh::CellType celltype,
-              int tdim, pugi::xml_node& piece_node)
+              int tdim, pugi::xml_node& piece_node, DataWriter& writer)
 {
   // -- Add geometry (points)
 
   pugi::xml_node points_node = piece_node.append_child("Points");
   pugi::xml_node x_node = points_node.append_child("DataArray");
-  x_node.append_attribute("type") = "Float64";
+  x_node.append_attribute("type") = vtk_type<U>().c_str();
   x_node.append_attribute("NumberOfComponents") = "3";
-  x_node.append_attribute("format") = "ascii";
-  x_node.append_child(pugi::node_pcdata)
-      .set_value(container_to_string(x, 16).str().c_str());
+  writer.add(x_node, x);
 
   // -- Add topology (cells)
 
   pugi::xml_node cells_node = piece_node.append_child("Cells");
   pugi::xml_node connectivity_node = cells_node.append_child("DataArray");
-  connectivity_node.append_attribute("type") = "Int32";
+  connectivity_node.append_attribute("type") = "Int64";
   connectivity_node.append_attribute("Name") = "connectivity";
-  connectivity_node.append_attribute("format") = "ascii";
-  {
-    std::stringstream ss;
-    std::ranges::for_each(cells, [&ss](auto& v) { ss << v << " "; });
-    connectivity_node.append_child(pugi::node_pcdata)
-        .set_value(ss.str().c_str());
-  }
+  writer.add(connectivity_node, cells);
 
   pugi::xml_node offsets_node = cells_node.append_child("DataArray");
-  offsets_node.append_attribute("type") = "Int32";
+  offsets_node.append_attribute("type") = "Int64";
   offsets_node.append_attribute("Name") = "offsets";
-  offsets_node.append_attribute("format") = "ascii";
   {
-    std::stringstream ss;
-    int num_nodes = cshape[1];
+    std::vector<std::int64_t> offsets(cshape[0]);
     for (std::size_t i = 0; i < cshape[0]; ++i)
-      ss << (i + 1) * num_nodes << " ";
-    offsets_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+      offsets[i] = (i + 1) * cshape[1];
+    writer.add(offsets_node, std::span<const std::int64_t>(offsets));
   }
 
   pugi::xml_node type_node = cells_node.append_child("DataArray");
   type_node.append_attribute("type") = "Int8";
   type_node.append_attribute("Name") = "types";
-  type_node.append_attribute("format") = "ascii";
-  int vtk_celltype = io::cells::get_vtk_cell_type(celltype, tdim);
   {
-    std::stringstream ss;
-    for (std::size_t c = 0; c < cshape[0]; ++c)
-      ss << vtk_celltype << " ";
-    type_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+    std::vector<std::int8_t> types(
+        cshape[0], io::cells::get_vtk_cell_type(celltype, tdim));
+    writer.add(type_node, std::span<const std::int8_t>(types));
   }
 
   // Ghost cell markers
@@ -240,16 +379,12 @@ void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
   pugi::xml_node ghost_cell_node = cells_data_node.append_child("DataArray");
   ghost_cell_node.append_attribute("type") = "UInt8";
   ghost_cell_node.append_attribute("Name") = "vtkGhostType";
-  ghost_cell_node.append_attribute("format") = "ascii";
   ghost_cell_node.append_attribute("RangeMin") = "0";
   ghost_cell_node.append_attribute("RangeMax") = "1";
   {
-    std::stringstream ss;
-    for (std::int32_t c = 0; c < cellmap.size_local(); ++c)
-      ss << 0 << " ";
-    for (std::size_t c = cellmap.size_local(); c < cshape[0]; ++c)
-      ss << 1 << " ";
-    ghost_cell_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+    std::vector<std::uint8_t> ghosts(cshape[0], 1);
+    std::fill_n(ghosts.begin(), cellmap.size_local(), 0);
+    writer.add(ghost_cell_node, std::span<const std::uint8_t>(ghosts));
   }
 
   // Original cell IDs
@@ -257,15 +392,14 @@ void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
   cell_id_node.append_attribute("type") = "Int64";
   cell_id_node.append_attribute("IdType") = "1";
   cell_id_node.append_attribute("Name") = "vtkOriginalCellIds";
-  cell_id_node.append_attribute("format") = "ascii";
   {
-    std::stringstream ss;
-    const std::int64_t cell_offset = cellmap.local_range()[0];
-    for (std::int32_t c = 0; c < cellmap.size_local(); ++c)
-      ss << cell_offset + c << " ";
-    std::ranges::for_each(cellmap.ghosts(),
-                          [&ss](auto& idx) { ss << idx << " "; });
-    cell_id_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+    std::vector<std::int64_t> ids(cellmap.size_local()
+                                  + cellmap.ghosts().size());
+    std::iota(ids.begin(), std::next(ids.begin(), cellmap.size_local()),
+              cellmap.local_range()[0]);
+    std::ranges::copy(cellmap.ghosts(),
+                      std::next(ids.begin(), cellmap.size_local()));
+    writer.add(cell_id_node, std::span<const std::int64_t>(ids));
   }
 
   auto [min_idx, max_idx] = cellmap.local_range();
@@ -287,12 +421,7 @@ void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
   point_id_node.append_attribute("type") = "Int64";
   point_id_node.append_attribute("IdType") = "1";
   point_id_node.append_attribute("Name") = "vtkOriginalPointIds";
-  point_id_node.append_attribute("format") = "ascii";
-  {
-    std::stringstream ss;
-    std::ranges::for_each(x_id, [&ss](auto idx) { ss << idx << " "; });
-    point_id_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
-  }
+  writer.add(point_id_node, x_id);
   if (!x_id.empty())
   {
     auto [min, max] = std::ranges::minmax_element(x_id);
@@ -304,13 +433,7 @@ void add_mesh(std::span<const U> x, std::array<std::size_t, 2> /*xshape*/,
   pugi::xml_node point_ghost_node = points_data_node.append_child("DataArray");
   point_ghost_node.append_attribute("type") = "UInt8";
   point_ghost_node.append_attribute("Name") = "vtkGhostType";
-  point_ghost_node.append_attribute("format") = "ascii";
-  {
-    std::stringstream ss;
-    std::ranges::for_each(x_ghost, [&ss](int ghost) { ss << ghost << " "; });
-    point_ghost_node.append_child(pugi::node_pcdata)
-        .set_value(ss.str().c_str());
-  }
+  writer.add(point_ghost_node, x_ghost);
   if (!x_ghost.empty())
   {
     auto [min, max] = std::ranges::minmax_element(x_ghost);
@@ -323,7 +446,7 @@ template <dolfinx::scalar T, std::floating_point U>
 void write_function(
     const std::vector<std::reference_wrapper<const fem::Function<T, U>>>& u,
     double time, pugi::xml_document* xml_doc,
-    const std::filesystem::path& filename)
+    const std::filesystem::path& filename, io::VTKFile::Encoding encoding)
 {
   if (!xml_doc)
     throw std::runtime_error("VTKFile has been closed");
@@ -400,6 +523,8 @@ void write_function(
   pugi::xml_node vtk_node_vtu = xml_vtu.append_child("VTKFile");
   vtk_node_vtu.append_attribute("type") = "UnstructuredGrid";
   vtk_node_vtu.append_attribute("version") = "2.2";
+  DataWriter writer(encoding);
+  writer.add_header(vtk_node_vtu);
   pugi::xml_node grid_node_vtu = vtk_node_vtu.append_child("UnstructuredGrid");
 
   auto topology0 = mesh0->topology();
@@ -444,7 +569,7 @@ void write_function(
   int tdim = topology0->dim();
   add_mesh<U>(x, xshape, x_id, x_ghost, cells, cshape,
               *topology0->index_map(tdim), cell_type, topology0->dim(),
-              piece_node);
+              piece_node, writer);
 
   // FIXME: is this actually setting the first?
   // Set last scalar/vector/tensor Functions in u to be the 'active'
@@ -506,7 +631,7 @@ void write_function(
       }
 
       add_data(_u.get().name, std::span<const std::size_t>(component_vector),
-               std::span<const T>(data), data_node);
+               std::span<const T>(data), data_node, writer);
     }
     else
     {
@@ -540,14 +665,14 @@ void write_function(
         if (mesh0->geometry().dim() == 3)
           add_data(_u.get().name,
                    std::span<const std::size_t>(component_vector),
-                   _u.get().x()->array(), data_node);
+                   _u.get().x()->array(), data_node, writer);
         else
         {
           // Pad with zeros and then add
           auto data = pad_data(*V, _u.get().x()->array());
           add_data(_u.get().name,
                    std::span<const std::size_t>(component_vector),
-                   std::span<const T>(data), data_node);
+                   std::span<const T>(data), data_node, writer);
         }
       }
       else if (*e == *element0)
@@ -583,14 +708,14 @@ void write_function(
         if (mesh0->geometry().dim() == 3)
           add_data(_u.get().name,
                    std::span<const std::size_t>(component_vector),
-                   std::span<const T>(u), data_node);
+                   std::span<const T>(u), data_node, writer);
         else
         {
           // Pad with zeros and then add
           auto data = pad_data(*V, _u.get().x()->array());
           add_data(_u.get().name,
                    std::span<const std::size_t>(component_vector),
-                   std::span<const T>(data), data_node);
+                   std::span<const T>(data), data_node, writer);
         }
       }
       else
@@ -616,7 +741,7 @@ void write_function(
   std::filesystem::path vtu = create_vtu_path(mpi_rank);
   if (vtu.has_parent_path())
     std::filesystem::create_directories(vtu.parent_path());
-  xml_vtu.save_file(vtu.c_str(), "  ");
+  writer.save(xml_vtu, vtu);
 
   // -- Create a PVTU XML object on rank 0
   std::filesystem::path p_pvtu = filename.parent_path() / filename.stem();
@@ -646,7 +771,7 @@ void write_function(
     }
 
     // Add mesh metadata to PVTU object
-    add_pvtu_mesh(grid_node);
+    add_pvtu_mesh<U>(grid_node);
 
     const int mpi_size = dolfinx::MPI::size(mesh0->comm());
     for (auto _u : u)
@@ -715,8 +840,8 @@ void write_function(
 
 //----------------------------------------------------------------------------
 io::VTKFile::VTKFile(MPI_Comm comm, const std::filesystem::path& filename,
-                     const std::string&)
-    : _filename(filename), _comm(comm)
+                     const std::string&, Encoding encoding)
+    : _filename(filename), _comm(comm), _encoding(encoding)
 {
   _pvd_xml = std::make_unique<pugi::xml_document>();
   assert(_pvd_xml);
@@ -797,6 +922,8 @@ void io::VTKFile::write(const mesh::Mesh<U>& mesh, double time)
   pugi::xml_node vtk_node_vtu = xml_vtu.append_child("VTKFile");
   vtk_node_vtu.append_attribute("type") = "UnstructuredGrid";
   vtk_node_vtu.append_attribute("version") = "2.2";
+  DataWriter writer(_encoding);
+  writer.add_header(vtk_node_vtu);
   pugi::xml_node grid_node_vtu = vtk_node_vtu.append_child("UnstructuredGrid");
 
   // Add "Piece" node and required metadata
@@ -814,7 +941,7 @@ void io::VTKFile::write(const mesh::Mesh<U>& mesh, double time)
   std::fill(std::next(x_ghost.begin(), xmap->size_local()), x_ghost.end(), 1);
   add_mesh(geometry.x(), xshape, geometry.input_global_indices(), x_ghost,
            cells, cshape, *topology->index_map(tdim), cell_type,
-           topology->dim(), piece_node);
+           topology->dim(), piece_node, writer);
 
   // Create filepath for a .vtu file
   auto create_vtu_path = [file_root = _filename.parent_path(),
@@ -831,7 +958,7 @@ void io::VTKFile::write(const mesh::Mesh<U>& mesh, double time)
   std::filesystem::path vtu = create_vtu_path(mpi_rank);
   if (vtu.has_parent_path())
     std::filesystem::create_directories(vtu.parent_path());
-  xml_vtu.save_file(vtu.c_str(), "  ");
+  writer.save(xml_vtu, vtu);
 
   // Create a PVTU XML object on rank 0
   std::filesystem::path p_pvtu = _filename.parent_path() / _filename.stem();
@@ -847,7 +974,7 @@ void io::VTKFile::write(const mesh::Mesh<U>& mesh, double time)
     grid_node.append_attribute("GhostLevel") = 1;
 
     // Add mesh metadata to PVTU object
-    add_pvtu_mesh(grid_node);
+    add_pvtu_mesh<U>(grid_node);
 
     // Add data for each process to the PVTU object
     const int mpi_size = dolfinx::MPI::size(_comm.comm());
@@ -876,7 +1003,7 @@ void io::VTKFile::write(
     const std::vector<std::reference_wrapper<const fem::Function<T, U>>>& u,
     double time)
 {
-  write_function<T, U>(u, time, _pvd_xml.get(), _filename);
+  write_function<T, U>(u, time, _pvd_xml.get(), _filename, _encoding);
 }
 //-----------------------------------------------------------------------------
 // Instantiation for different types
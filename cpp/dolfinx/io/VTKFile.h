@@ -46,9 +46,20 @@ namespace dolfinx::io
 class VTKFile
 {
 public:
+  /// Encoding of the data arrays in the `.vtu` files
+  enum class Encoding
+  {
+    ASCII,  ///< Plain text
+    Base64, ///< Binary, base64 encoded in the XML elements
+    Raw     ///< Binary, appended to the file after the XML elements
+  };
+
+  /// Default encoding type
+  static const Encoding default_encoding = Encoding::Raw;
+
   /// Create VTK file
   VTKFile(MPI_Comm comm, const std::filesystem::path& filename,
-          const std::string& file_mode);
+          const std::string& file_mode, Encoding encoding = default_encoding);
 
   /// Destructor
   ~VTKFile();
@@ -92,5 +103,8 @@ private:
 
   // MPI communicator
   dolfinx::MPI::Comm _comm;
+
+  // Encoding of the data arrays
+  Encoding _encoding;
 };
 } // namespace dolfinx::io
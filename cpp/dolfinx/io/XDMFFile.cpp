@@ -25,7 +25,8 @@ using namespace dolfinx::io;
 
 //-----------------------------------------------------------------------------
 XDMFFile::XDMFFile(MPI_Comm comm, const std::filesystem::path& filename,
-                   std::string file_mode, Encoding encoding)
+                   std::string file_mode, Encoding encoding,
+                   const hdf5::FileOptions& file_options)
     : _comm(comm), _filename(filename), _file_mode(file_mode),
       _xml_doc(new pugi::xml_document), _encoding(encoding)
 {
@@ -42,10 +43,10 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::filesystem::path& filename,
     const std::filesystem::path hdf5_filename
         = xdmf_utils::get_hdf5_filename(_filename);
     const bool mpi_io = dolfinx::MPI::size(_comm.comm()) > 1 ? true : false;
-    _h5_id
-        = io::hdf5::open_file(_comm.comm(), hdf5_filename, file_mode, mpi_io);
+    _h5_id = io::hdf5::open_file(_comm.comm(), hdf5_filename, file_mode,
+                                 mpi_io, file_options);
     assert(_h5_id > 0);
-    spdlog::info("Opened HDF5 file with id \"{}\"", _h5_id);
+    DOLFINX_LOG_INFO("Opened HDF5 file with id \"{}\"", _h5_id);
   }
   else
   {
@@ -126,23 +127,44 @@ void XDMFFile::close()
   _h5_id = -1;
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::set_dataset_options(const hdf5::DatasetOptions& options)
+{
+  _dataset_options = options;
+}
+//-----------------------------------------------------------------------------
+const hdf5::DatasetOptions& XDMFFile::dataset_options() const
+{
+  return _dataset_options;
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::set_read_buffer_size(std::size_t size)
+{
+  _read_buffer_size = size;
+}
+//-----------------------------------------------------------------------------
+std::size_t XDMFFile::read_buffer_size() const { return _read_buffer_size; }
+//-----------------------------------------------------------------------------
 template <std::floating_point U>
-void XDMFFile::write_mesh(const mesh::Mesh<U>& mesh, std::string xpath)
+void XDMFFile::write_mesh(const mesh::Mesh<U>& mesh, std::string xpath,
+                          bool partition)
 {
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
 
   // Add the mesh Grid to the domain
-  xdmf_mesh::add_mesh(_comm.comm(), node, _h5_id, mesh, mesh.name);
+  xdmf_mesh::add_mesh(_comm.comm(), node, _h5_id, mesh, mesh.name,
+                      partition, _dataset_options);
 
   // Save XML file (on process 0 only)
   if (MPI::rank(_comm.comm()) == 0)
     _xml_doc->save_file(_filename.c_str(), "  ");
 }
 /// @cond
-template void XDMFFile::write_mesh(const mesh::Mesh<double>&, std::string);
-template void XDMFFile::write_mesh(const mesh::Mesh<float>&, std::string);
+template void XDMFFile::write_mesh(const mesh::Mesh<double>&, std::string,
+                                   bool);
+template void XDMFFile::write_mesh(const mesh::Mesh<float>&, std::string,
+                                   bool);
 /// @endcond
 //-----------------------------------------------------------------------------
 void XDMFFile::write_geometry(const mesh::Geometry<double>& geometry,
@@ -160,7 +182,7 @@ void XDMFFile::write_geometry(const mesh::Geometry<double>& geometry,
 
   const std::string path_prefix = "/Geometry/" + name;
   xdmf_mesh::add_geometry_data(_comm.comm(), grid_node, _h5_id, path_prefix,
-                               geometry);
+                               geometry, _dataset_options);
 
   // Save XML file (on process 0 only)
   if (MPI::rank(_comm.comm()) == 0)
@@ -176,10 +198,23 @@ XDMFFile::read_mesh(const fem::CoordinateElement<double>& element,
   auto [cells, cshape] = XDMFFile::read_topology_data(name, xpath);
   auto [x, xshape] = XDMFFile::read_geometry_data(name, xpath);
 
+  // Use the stored partition if the number of processes is unchanged
+  auto [owners, num_parts] = XDMFFile::read_partition(name, xpath);
+  mesh::CellPartitionFunction partitioner;
+  if (num_parts == MPI::size(_comm.comm()))
+  {
+    DOLFINX_LOG_INFO("Use stored partition of mesh \"{}\"", name);
+    partitioner
+        = mesh::create_precomputed_cell_partitioner(mode, std::move(owners));
+  }
+  else if (MPI::size(_comm.comm()) > 1)
+    partitioner = mesh::create_cell_partitioner(mode);
+
   // Create mesh
   const std::vector<double>& _x = std::get<std::vector<double>>(x);
   mesh::Mesh<double> mesh
-      = mesh::create_mesh(_comm.comm(), cells, element, _x, xshape, mode);
+      = mesh::create_mesh(_comm.comm(), _comm.comm(), cells, element,
+                          _comm.comm(), _x, xshape, partitioner);
   mesh.name = name;
   return mesh;
 }
@@ -196,8 +231,24 @@ XDMFFile::read_topology_data(std::string name, std::string xpath) const
   if (!grid_node)
     throw std::runtime_error("<Grid> with name '" + name + "' not found.");
 
-  spdlog::info("Read topology data \"{}\" at {}", name, xpath);
-  return xdmf_mesh::read_topology_data(_comm.comm(), _h5_id, grid_node);
+  DOLFINX_LOG_INFO("Read topology data \"{}\" at {}", name, xpath);
+  return xdmf_mesh::read_topology_data(_comm.comm(), _h5_id, grid_node,
+                                       _read_buffer_size);
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<std::int32_t>, int>
+XDMFFile::read_partition(std::string name, std::string xpath) const
+{
+  pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
+  if (!node)
+    throw std::runtime_error("XML node '" + xpath + "' not found.");
+
+  pugi::xml_node grid_node
+      = node.select_node(("Grid[@Name='" + name + "']").c_str()).node();
+  if (!grid_node)
+    throw std::runtime_error("<Grid> with name '" + name + "' not found.");
+
+  return xdmf_mesh::read_partition(_comm.comm(), _h5_id, grid_node);
 }
 //-----------------------------------------------------------------------------
 std::pair<std::variant<std::vector<float>, std::vector<double>>,
@@ -213,8 +264,9 @@ XDMFFile::read_geometry_data(std::string name, std::string xpath) const
   if (!grid_node)
     throw std::runtime_error("<Grid> with name '" + name + "' not found.");
 
-  spdlog::info("Read geometry data \"{}\" at {}", name, xpath);
-  return xdmf_mesh::read_geometry_data(_comm.comm(), _h5_id, grid_node);
+  DOLFINX_LOG_INFO("Read geometry data \"{}\" at {}", name, xpath);
+  return xdmf_mesh::read_geometry_data(_comm.comm(), _h5_id, grid_node,
+                                       _read_buffer_size);
 }
 //-----------------------------------------------------------------------------
 template <dolfinx::scalar T, std::floating_point U>
@@ -239,24 +291,49 @@ void XDMFFile::write_function(const fem::Function<T, U>& u, double t,
 
   assert(timegrid_node);
 
+  // The Grid of the first time step holds the dof Topology and Geometry
+  // of functions that are not written on the mesh Grid
+  pugi::xml_node first_grid_node = timegrid_node.child("Grid");
+
   pugi::xml_node grid_node = timegrid_node.append_child("Grid");
   assert(grid_node);
   grid_node.append_attribute("Name") = u.name.c_str();
   grid_node.append_attribute("GridType") = "Uniform";
 
-  pugi::xml_node mesh_node = _xml_doc->select_node(mesh_xpath.c_str()).node();
-  if (!mesh_node)
+  assert(u.function_space());
+  if (xdmf_function::has_mesh_layout(*u.function_space()))
   {
-    spdlog::warn("No mesh found at '{}'. Write mesh before function!",
-                 mesh_xpath);
-  }
+    pugi::xml_node mesh_node
+        = _xml_doc->select_node(mesh_xpath.c_str()).node();
+    if (!mesh_node)
+    {
+      spdlog::warn("No mesh found at '{}'. Write mesh before function!",
+                   mesh_xpath);
+    }
 
-  const std::string ref_path
-      = "xpointer(" + mesh_xpath + "/*[self::Topology or self::Geometry])";
+    const std::string ref_path
+        = "xpointer(" + mesh_xpath + "/*[self::Topology or self::Geometry])";
 
-  pugi::xml_node topo_geo_ref = grid_node.append_child("xi:include");
-  topo_geo_ref.append_attribute("xpointer") = ref_path.c_str();
-  assert(topo_geo_ref);
+    pugi::xml_node topo_geo_ref = grid_node.append_child("xi:include");
+    topo_geo_ref.append_attribute("xpointer") = ref_path.c_str();
+    assert(topo_geo_ref);
+  }
+  else if (first_grid_node and first_grid_node.child("Topology"))
+  {
+    const std::string ref_path
+        = "xpointer(" + timegrid_xpath
+          + "/Grid[1]/*[self::Topology or self::Geometry])";
+    pugi::xml_node topo_geo_ref = grid_node.append_child("xi:include");
+    topo_geo_ref.append_attribute("xpointer") = ref_path.c_str();
+    assert(topo_geo_ref);
+  }
+  else
+  {
+    // Write the dofs of the space once, with the first time step
+    xdmf_function::add_dof_mesh(_comm.comm(), *u.function_space(), grid_node,
+                                _h5_id, "/Function/" + u.name + "/mesh",
+                                _dataset_options);
+  }
 
   std::string t_str = boost::lexical_cast<std::string>(t);
   pugi::xml_node time_node = grid_node.append_child("Time");
@@ -264,7 +341,8 @@ void XDMFFile::write_function(const fem::Function<T, U>& u, double t,
   assert(time_node);
 
   // Add the mesh Grid to the domain
-  xdmf_function::add_function(_comm.comm(), u, t, grid_node, _h5_id);
+  xdmf_function::add_function(_comm.comm(), u, t, grid_node, _h5_id,
+                              _dataset_options);
 
   // Save XML file (on process 0 only)
   if (dolfinx::MPI::rank(_comm.comm()) == 0)
@@ -304,7 +382,7 @@ void XDMFFile::write_meshtags(const mesh::MeshTags<std::int32_t>& meshtags,
   geo_ref_node.append_attribute("xpointer") = geo_ref_path.c_str();
   assert(geo_ref_node);
   xdmf_mesh::add_meshtags(_comm.comm(), meshtags, x, grid_node, _h5_id,
-                          meshtags.name);
+                          meshtags.name, _dataset_options);
 
   // Save XML file (on process 0 only)
   if (MPI::rank(_comm.comm()) == 0)
@@ -325,7 +403,7 @@ mesh::MeshTags<std::int32_t>
 XDMFFile::read_meshtags(const mesh::Mesh<double>& mesh, std::string name,
                         std::string xpath)
 {
-  spdlog::info("XDMF read meshtags ({})", name);
+  DOLFINX_LOG_INFO("XDMF read meshtags ({})", name);
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -334,7 +412,7 @@ XDMFFile::read_meshtags(const mesh::Mesh<double>& mesh, std::string name,
   if (!grid_node)
     throw std::runtime_error("<Grid> with name '" + name + "' not found.");
 
-  const auto [entities, eshape] = read_topology_data(name, xpath);
+  auto [entities, eshape] = read_topology_data(name, xpath);
 
   pugi::xml_node values_data_node
       = grid_node.child("Attribute").child("DataItem");
@@ -346,13 +424,13 @@ XDMFFile::read_meshtags(const mesh::Mesh<double>& mesh, std::string name,
   mesh::CellType cell_type = mesh::to_type(cell_type_str.first);
 
   // Permute entities from VTK to DOLFINx ordering
-  std::vector<std::int64_t> entities1 = io::cells::apply_permutation(
-      entities, eshape, io::cells::perm_vtk(cell_type, eshape[1]));
+  io::cells::apply_permutation_inplace(
+      entities, eshape[1], io::cells::perm_vtk(cell_type, eshape[1]));
 
   MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
       const std::int64_t,
       MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>
-      entities_span(entities1.data(), eshape);
+      entities_span(entities.data(), eshape);
   std::pair<std::vector<std::int32_t>, std::vector<std::int32_t>>
       entities_values = xdmf_utils::distribute_entity_data<std::int32_t>(
           *mesh.topology(), mesh.geometry().input_global_indices(),
@@ -360,7 +438,7 @@ XDMFFile::read_meshtags(const mesh::Mesh<double>& mesh, std::string name,
           mesh.geometry().cmap().create_dof_layout(), mesh.geometry().dofmap(),
           mesh::cell_dim(cell_type), entities_span, values);
 
-  spdlog::info("XDMF create meshtags");
+  DOLFINX_LOG_INFO("XDMF create meshtags");
   std::size_t num_vertices_per_entity = mesh::cell_num_entities(
       mesh::cell_entity_type(mesh.topology()->cell_type(),
                              mesh::cell_dim(cell_type), 0),
@@ -67,8 +67,16 @@ public:
   static const Encoding default_encoding = Encoding::HDF5;
 
   /// Constructor
+  /// @param[in] comm MPI communicator
+  /// @param[in] filename Name of the XDMF file
+  /// @param[in] file_mode Mode in which to open the file (w, r, a)
+  /// @param[in] encoding Storage of the heavy data
+  /// @param[in] file_options Access options of the HDF5 file, e.g.
+  /// alignment and collective metadata operations. Only used with
+  /// Encoding::HDF5.
   XDMFFile(MPI_Comm comm, const std::filesystem::path& filename,
-           std::string file_mode, Encoding encoding = default_encoding);
+           std::string file_mode, Encoding encoding = default_encoding,
+           const hdf5::FileOptions& file_options = {});
 
   /// Move constructor
   XDMFFile(XDMFFile&&) = default;
@@ -83,12 +91,37 @@ public:
   /// no effect.
   void close();
 
+  /// @brief Set the creation options of the HDF5 datasets, e.g.
+  /// chunking and compression, that are used by subsequent writes.
+  /// @param[in] options The dataset creation options
+  void set_dataset_options(const hdf5::DatasetOptions& options);
+
+  /// The creation options of the HDF5 datasets
+  const hdf5::DatasetOptions& dataset_options() const;
+
+  /// @brief Set the maximum size (bytes) of the buffer used to read
+  /// blocks of HDF5 mesh data.
+  ///
+  /// When greater than zero, the topology and geometry data of a mesh
+  /// are read in blocks of at most this size and each block is moved to
+  /// its final storage as it is read. This bounds the transient memory
+  /// used to read a mesh. If zero (default), the data of each process
+  /// is read in one block.
+  /// @param[in] size The buffer size in bytes
+  void set_read_buffer_size(std::size_t size);
+
+  /// The maximum size (bytes) of the buffer used to read mesh data
+  std::size_t read_buffer_size() const;
+
   /// Save Mesh
   /// @param[in] mesh
   /// @param[in] xpath XPath where Mesh Grid will be written
+  /// @param[in] partition If true, store the owning rank of each cell.
+  /// XDMFFile::read_mesh then skips graph partitioning when the mesh is
+  /// read on the same number of processes.
   template <std::floating_point U>
   void write_mesh(const mesh::Mesh<U>& mesh,
-                  std::string xpath = "/Xdmf/Domain");
+                  std::string xpath = "/Xdmf/Domain", bool partition = false);
 
   /// Save Geometry
   /// @param[in] geometry
@@ -98,6 +131,12 @@ public:
                       std::string xpath = "/Xdmf/Domain");
 
   /// Read in Mesh
+  ///
+  /// If the mesh was written with its partition and is read on the same
+  /// number of processes, the cells are sent to their stored owners and
+  /// no graph partitioning is performed. Otherwise, the cells are
+  /// partitioned using the default graph partitioner.
+  ///
   /// @param[in] element Element that describes the geometry of a cell
   /// @param[in] mode The type of ghosting/halo to use for the mesh when
   ///   distributed in parallel
@@ -126,6 +165,16 @@ public:
   read_geometry_data(std::string name,
                      std::string xpath = "/Xdmf/Domain") const;
 
+  /// Read the cell partition stored with a mesh
+  /// @param[in] name Name of the mesh (Grid)
+  /// @param[in] xpath XPath where Mesh Grid data is located
+  /// @return The owning rank of each cell returned by
+  /// XDMFFile::read_topology_data on this process, and the number of
+  /// ranks that the mesh was partitioned across (zero if no partition
+  /// is stored)
+  std::pair<std::vector<std::int32_t>, int>
+  read_partition(std::string name, std::string xpath = "/Xdmf/Domain") const;
+
   /// Read information about cell type
   /// @param[in] grid_name Name of Grid for which cell type is needed
   /// @param[in] xpath XPath where Grid is stored
@@ -134,15 +183,19 @@ public:
 
   /// @brief Write a fem::Function to file.
   ///
-  /// @pre The fem::Function `u` must be (i) a lowest-order (P0)
-  /// discontinuous Lagrange element or (ii) a continuous Lagrange
-  /// element where the element 'nodes' are the same as the nodes of its
-  /// mesh::Mesh. Otherwise an exception is raised.
+  /// @pre The fem::Function `u` must be a (discontinuous) Lagrange
+  /// function. Otherwise an exception is raised.
   ///
-  /// @note User interpolation to a suitable Lagrange space may be
-  /// required to satisfy the precondition on `u`. The VTX output
-  /// (io::VTXWriter) format is recommended over XDMF for discontinuous
-  /// and/or high-order spaces.
+  /// If `u` is (i) a lowest-order (P0) discontinuous Lagrange function
+  /// or (ii) a continuous Lagrange function whose element 'nodes' are
+  /// the same as the nodes of its mesh::Mesh, its values are attached
+  /// to the mesh Grid at `mesh_xpath`. Otherwise one value per dof is
+  /// written on a Grid of the dofs, with a cell type of the degree of
+  /// `u`, whose Topology and Geometry are written with the first time
+  /// step and shared by the later ones.
+  ///
+  /// @note The VTX output (io::VTXWriter) format is recommended over
+  /// XDMF for high-order spaces that have no XDMF cell type.
   ///
   /// @param[in] u Function to write to file.
   /// @param[in] t Time stamp to associate with `u`.
@@ -207,6 +260,12 @@ private:
   std::unique_ptr<pugi::xml_document> _xml_doc;
 
   Encoding _encoding;
+
+  // Creation options of HDF5 datasets
+  hdf5::DatasetOptions _dataset_options;
+
+  // Maximum size (bytes) of the buffer for reading mesh data
+  std::size_t _read_buffer_size = 0;
 };
 
 } // namespace dolfinx::io
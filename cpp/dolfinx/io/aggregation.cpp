@@ -0,0 +1,53 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "aggregation.h"
+
+using namespace dolfinx;
+
+namespace
+{
+/// Split `comm` into shared memory (node) groups, and split each node
+/// group into `num_aggregators` groups of consecutive ranks
+MPI_Comm create_group_comm(MPI_Comm comm, int num_aggregators)
+{
+  if (num_aggregators < 1)
+    throw std::runtime_error("Number of aggregators must be positive.");
+
+  // Node groups, ordered by rank in comm
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, dolfinx::MPI::rank(comm),
+                      MPI_INFO_NULL, &node_comm);
+  const int node_rank = dolfinx::MPI::rank(node_comm);
+  const int node_size = dolfinx::MPI::size(node_comm);
+
+  const int n = std::min(num_aggregators, node_size);
+  const int color = static_cast<std::int64_t>(node_rank) * n / node_size;
+  MPI_Comm group_comm;
+  MPI_Comm_split(node_comm, color, node_rank, &group_comm);
+  MPI_Comm_free(&node_comm);
+  return group_comm;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+io::Aggregator::Aggregator(MPI_Comm comm, int num_aggregators)
+    : _comm(create_group_comm(comm, num_aggregators), false),
+      _num_aggregators(0)
+{
+  const int aggregator = is_aggregator();
+  MPI_Allreduce(&aggregator, &_num_aggregators, 1, MPI_INT, MPI_SUM, comm);
+}
+//-----------------------------------------------------------------------------
+MPI_Comm io::Aggregator::comm() const { return _comm.comm(); }
+//-----------------------------------------------------------------------------
+bool io::Aggregator::is_aggregator() const
+{
+  return dolfinx::MPI::rank(_comm.comm()) == 0;
+}
+//-----------------------------------------------------------------------------
+int io::Aggregator::num_aggregators() const { return _num_aggregators; }
+//-----------------------------------------------------------------------------
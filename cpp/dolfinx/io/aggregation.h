@@ -0,0 +1,119 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::io
+{
+
+/// @brief Aggregation of output data onto a subset of ranks.
+///
+/// The ranks of a communicator are split into groups of ranks that
+/// share memory (ranks on the same node), see `MPI_Comm_split_type`.
+/// Each node group is split into `num_aggregators` groups of
+/// consecutive ranks. The data of a group is gathered onto the lowest
+/// rank of the group (the aggregator), which writes it as one large
+/// block. This reduces the number of ranks that access the file system.
+class Aggregator
+{
+public:
+  /// @brief Create the aggregation groups (collective).
+  /// @param[in] comm Communicator of the ranks that write data
+  /// @param[in] num_aggregators Number of aggregators per node
+  Aggregator(MPI_Comm comm, int num_aggregators);
+
+  /// @brief Communicator of the aggregation group of this rank. The
+  /// aggregator is rank 0 of the communicator.
+  MPI_Comm comm() const;
+
+  /// @brief Check if this rank is an aggregator.
+  bool is_aggregator() const;
+
+  /// @brief Total number of aggregators across all nodes.
+  int num_aggregators() const;
+
+  /// @brief Gather blocks of rows onto the aggregator (collective on
+  /// the aggregation group).
+  ///
+  /// @param[in] data Rows of this rank (row-major storage)
+  /// @param[in] range Global range of the rows in `data`
+  /// @return On the aggregator, the rows of the group and the global
+  /// range of each non-empty block of rows, both sorted by the start of
+  /// the range. Empty on other ranks.
+  template <typename T>
+  std::pair<std::vector<T>, std::vector<std::array<std::int64_t, 2>>>
+  gather(std::span<const T> data, std::array<std::int64_t, 2> range) const
+  {
+    MPI_Comm comm = _comm.comm();
+    const int size = dolfinx::MPI::size(comm);
+    const bool aggregator = is_aggregator();
+
+    if (data.size() > INT_MAX)
+      throw std::runtime_error("Aggregated data block is too large.");
+    const int num_values = data.size();
+    std::vector<std::int64_t> ranges(aggregator ? 2 * size : 0);
+    std::vector<int> sizes(aggregator ? size : 0);
+    MPI_Gather(range.data(), 2, MPI_INT64_T, ranges.data(), 2, MPI_INT64_T, 0,
+               comm);
+    MPI_Gather(&num_values, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, comm);
+
+    std::vector<int> offsets(sizes.size() + 1, 0);
+    std::partial_sum(sizes.begin(), sizes.end(), std::next(offsets.begin()));
+    if (aggregator and offsets.back() < 0)
+      throw std::runtime_error("Aggregated data is too large.");
+
+    std::vector<T> buffer(offsets.back());
+    MPI_Gatherv(data.data(), num_values, dolfinx::MPI::mpi_type<T>(),
+                buffer.data(), sizes.data(), offsets.data(),
+                dolfinx::MPI::mpi_type<T>(), 0, comm);
+    if (!aggregator)
+      return {};
+
+    // Order the non-empty blocks by their global position
+    std::vector<int> order;
+    for (int r = 0; r < size; ++r)
+    {
+      if (ranges[2 * r + 1] > ranges[2 * r])
+        order.push_back(r);
+    }
+    std::ranges::stable_sort(order, std::less{},
+                             [&ranges](int r) { return ranges[2 * r]; });
+
+    std::vector<std::array<std::int64_t, 2>> blocks;
+    blocks.reserve(order.size());
+    std::vector<T> values;
+    values.reserve(buffer.size());
+    for (int r : order)
+    {
+      blocks.push_back({ranges[2 * r], ranges[2 * r + 1]});
+      values.insert(values.end(), std::next(buffer.begin(), offsets[r]),
+                    std::next(buffer.begin(), offsets[r + 1]));
+    }
+
+    return {std::move(values), std::move(blocks)};
+  }
+
+private:
+  // Communicator of the aggregation group
+  dolfinx::MPI::Comm _comm;
+
+  // Total number of aggregators
+  int _num_aggregators;
+};
+
+} // namespace dolfinx::io
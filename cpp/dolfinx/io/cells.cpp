@@ -659,6 +659,16 @@ io::cells::transpose(std::span<const std::uint16_t> map)
   return transpose;
 }
 //-----------------------------------------------------------------------------
+bool io::cells::is_identity(std::span<const std::uint16_t> map)
+{
+  for (std::size_t i = 0; i < map.size(); ++i)
+  {
+    if (map[i] != i)
+      return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
 std::vector<std::int64_t>
 io::cells::apply_permutation(std::span<const std::int64_t> cells,
                              std::array<std::size_t, 2> shape,
@@ -667,7 +677,10 @@ io::cells::apply_permutation(std::span<const std::int64_t> cells,
   assert(cells.size() == shape[0] * shape[1]);
   assert(shape[1] == p.size());
 
-  spdlog::info("IO permuting cells");
+  if (is_identity(p))
+    return std::vector<std::int64_t>(cells.begin(), cells.end());
+
+  DOLFINX_LOG_INFO("IO permuting cells");
   std::vector<std::int64_t> cells_new(cells.size());
   for (std::size_t c = 0; c < shape[0]; ++c)
   {
@@ -679,6 +692,50 @@ io::cells::apply_permutation(std::span<const std::int64_t> cells,
   return cells_new;
 }
 //-----------------------------------------------------------------------------
+void io::cells::apply_permutation_inplace(std::span<std::int64_t> cells,
+                                          std::size_t num_nodes,
+                                          std::span<const std::uint16_t> p)
+{
+  assert(num_nodes == p.size());
+  if (is_identity(p))
+    return;
+  assert(cells.size() % num_nodes == 0);
+
+  DOLFINX_LOG_INFO("IO permuting cells in-place");
+
+  // Decompose the permutation into cycles (c_0, ..., c_{k-1}), with
+  // c_{m+1} = p[c_m]. Fixed points are skipped.
+  std::vector<std::uint16_t> cycles;
+  std::vector<std::size_t> offsets = {0};
+  std::vector<std::int8_t> visited(p.size(), false);
+  for (std::size_t i = 0; i < p.size(); ++i)
+  {
+    if (visited[i] or p[i] == i)
+      continue;
+    for (std::size_t j = i; !visited[j]; j = p[j])
+    {
+      visited[j] = true;
+      cycles.push_back(j);
+    }
+    offsets.push_back(cycles.size());
+  }
+
+  // Shift the entries of each cell along the cycles
+  for (std::size_t c = 0; c < cells.size(); c += num_nodes)
+  {
+    std::int64_t* cell = cells.data() + c;
+    for (std::size_t k = 0; k < offsets.size() - 1; ++k)
+    {
+      const std::size_t c0 = cycles[offsets[k]];
+      const std::int64_t tmp = cell[c0];
+      std::size_t m = offsets[k];
+      for (; m < offsets[k + 1] - 1; ++m)
+        cell[cycles[m]] = cell[cycles[m + 1]];
+      cell[cycles[m]] = tmp;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 std::int8_t io::cells::get_vtk_cell_type(mesh::CellType cell, int dim)
 {
   if (cell == mesh::CellType::prism and dim == 2)
@@ -145,6 +145,11 @@ std::vector<std::uint16_t> perm_gmsh(mesh::CellType type, int num_nodes);
 /// transpose will be `{3 , 0, 1, 2 }`.
 std::vector<std::uint16_t> transpose(std::span<const std::uint16_t> map);
 
+/// @brief Check if a re-ordering map is the identity.
+/// @param[in] map A re-ordering map
+/// @return True if `map[i] == i` for all `i`
+bool is_identity(std::span<const std::uint16_t> map);
+
 /// Permute cell topology by applying a permutation array for each cell
 /// @param[in] cells Array of cell topologies, with each row
 /// representing a cell (row-major storage)
@@ -158,6 +163,23 @@ std::vector<std::int64_t> apply_permutation(std::span<const std::int64_t> cells,
                                             std::array<std::size_t, 2> shape,
                                             std::span<const std::uint16_t> p);
 
+/// @brief Permute cell topology in-place by applying a permutation
+/// array for each cell.
+///
+/// The permutation is decomposed into cycles once, and each cell is
+/// permuted by shifting its entries along the cycles. No memory
+/// proportional to the number of cells is allocated, which makes this
+/// suitable for large arrays of cells.
+///
+/// @param[in,out] cells Array of cell topologies, with each row
+/// representing a cell (row-major storage)
+/// @param[in] num_nodes Number of nodes per cell (row size)
+/// @param[in] p The permutation array that maps `a_p[i] = a[p[i]]`,
+/// see apply_permutation
+void apply_permutation_inplace(std::span<std::int64_t> cells,
+                               std::size_t num_nodes,
+                               std::span<const std::uint16_t> p);
+
 /// Get VTK cell identifier
 /// @param[in] cell The cell type
 /// @param[in] dim The topological dimension of the cell
@@ -0,0 +1,733 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#ifdef HAS_ADIOS2
+
+#include "ADIOS2Writers.h"
+#include <adios2.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/utils.h>
+#include <filesystem>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+/// @file checkpointing.h
+/// @brief ADIOS2-based checkpointing of meshes and functions
+///
+/// A checkpoint stores the mesh and (discontinuous) Lagrange functions
+/// in the native DOLFINx layout, such that they can be read back on the
+/// same or on a different number of processes. The data is stored in
+/// ADIOS2 global arrays, with the cells and the geometry nodes in the
+/// order of their index maps when written:
+///
+/// - `mesh/x`: Coordinates of the geometry nodes, shape `(num_nodes,
+///   gdim)`.
+/// - `mesh/input_global_indices`: Input global index of each geometry
+///   node.
+/// - `mesh/cells`: Geometry nodes of each cell, shape `(num_cells,
+///   num_cell_nodes)`.
+/// - `mesh/original_cell_index`: Original (input) index of each cell.
+/// - `mesh/cell_offsets`: Index of the first cell owned by each
+///   process.
+/// - `<name>/values`: Degree-of-freedom values of a function, shape
+///   `(num_dofs, bs)`.
+/// - `<name>/cell_dofs`: Global (block) degree-of-freedom indices of
+///   each cell, shape `(num_cells, num_cell_dofs)`.
+
+namespace dolfinx::io::checkpointing
+{
+/// @privatesection
+namespace impl
+{
+/// @brief Read a block of rows of a global array.
+/// @param[in] io The ADIOS2 IO
+/// @param[in] engine The ADIOS2 engine
+/// @param[in] name Name of the variable
+/// @param[in] range Range of rows to read
+/// @return The data (row-major) and the number of columns
+template <typename T>
+std::pair<std::vector<T>, std::size_t>
+read_rows(adios2::IO& io, adios2::Engine& engine, const std::string& name,
+          std::array<std::int64_t, 2> range)
+{
+  adios2::Variable<T> var = io.InquireVariable<T>(name);
+  if (!var)
+    throw std::runtime_error("Checkpoint variable \"" + name + "\" not found.");
+
+  adios2::Dims shape = var.Shape();
+  const std::size_t num_rows = range[1] - range[0];
+  if (shape.size() == 1)
+    var.SetSelection({{std::size_t(range[0])}, {num_rows}});
+  else
+    var.SetSelection({{std::size_t(range[0]), 0}, {num_rows, shape[1]}});
+  const std::size_t num_cols = shape.size() == 1 ? 1 : shape[1];
+
+  std::vector<T> data(num_rows * num_cols);
+  engine.Get(var, data.data(), adios2::Mode::Sync);
+  return {std::move(data), num_cols};
+}
+
+/// @brief Number of rows of a global array.
+template <typename T>
+std::int64_t num_rows(adios2::IO& io, const std::string& name)
+{
+  adios2::Variable<T> var = io.InquireVariable<T>(name);
+  if (!var)
+    throw std::runtime_error("Checkpoint variable \"" + name + "\" not found.");
+  return var.Shape().front();
+}
+
+/// @brief Write the mesh to a checkpoint.
+/// @param[in] io The ADIOS2 IO
+/// @param[in] engine The ADIOS2 engine
+/// @param[in] mesh The mesh
+template <std::floating_point T>
+void write_mesh(adios2::IO& io, adios2::Engine& engine,
+                const mesh::Mesh<T>& mesh)
+{
+  const mesh::Geometry<T>& geometry = mesh.geometry();
+  auto topology = mesh.topology();
+  assert(topology);
+  const int tdim = topology->dim();
+  if (topology->entity_types(tdim).size() != 1)
+    throw std::runtime_error("Checkpointing of mixed meshes not supported.");
+
+  const fem::CoordinateElement<T>& cmap = geometry.cmap();
+  impl_adios2::define_attribute<std::string>(
+      io, "mesh/cell_type", mesh::to_string(cmap.cell_shape()));
+  impl_adios2::define_attribute<int>(io, "mesh/degree", cmap.degree());
+  impl_adios2::define_attribute<int>(io, "mesh/lagrange_variant",
+                                     static_cast<int>(cmap.variant()));
+  impl_adios2::define_attribute<int>(io, "mesh/gdim", geometry.dim());
+
+  // Owned geometry nodes and their input global indices
+  auto x_map = geometry.index_map();
+  assert(x_map);
+  const std::size_t num_nodes = x_map->size_local();
+  const std::size_t gdim = geometry.dim();
+  std::span<const T> x = geometry.x();
+  std::vector<T> x_owned(num_nodes * gdim);
+  for (std::size_t i = 0; i < num_nodes; ++i)
+    std::copy_n(std::next(x.begin(), 3 * i), gdim,
+                std::next(x_owned.begin(), i * gdim));
+
+  const std::size_t num_nodes_global = x_map->size_global();
+  const std::size_t node_offset = x_map->local_range()[0];
+  adios2::Variable var_x = impl_adios2::define_variable<T>(
+      io, "mesh/x", {num_nodes_global, gdim}, {node_offset, 0},
+      {num_nodes, gdim});
+  engine.Put(var_x, x_owned.data(), adios2::Mode::Sync);
+
+  adios2::Variable var_input = impl_adios2::define_variable<std::int64_t>(
+      io, "mesh/input_global_indices", {num_nodes_global}, {node_offset},
+      {num_nodes});
+  engine.Put(var_input, geometry.input_global_indices().data(),
+             adios2::Mode::Sync);
+
+  // Owned cells, with the geometry nodes in the global node numbering
+  auto cell_map = topology->index_map(tdim);
+  assert(cell_map);
+  const std::size_t num_cells = cell_map->size_local();
+  const std::size_t num_cells_global = cell_map->size_global();
+  const std::size_t cell_offset = cell_map->local_range()[0];
+  auto dofmap = geometry.dofmap();
+  const std::size_t num_cell_nodes = dofmap.extent(1);
+  std::vector<std::int64_t> cells(num_cells * num_cell_nodes);
+  x_map->local_to_global(
+      std::span(dofmap.data_handle(), num_cells * num_cell_nodes), cells);
+
+  adios2::Variable var_cells = impl_adios2::define_variable<std::int64_t>(
+      io, "mesh/cells", {num_cells_global, num_cell_nodes}, {cell_offset, 0},
+      {num_cells, num_cell_nodes});
+  engine.Put(var_cells, cells.data(), adios2::Mode::Sync);
+
+  adios2::Variable var_orig = impl_adios2::define_variable<std::int64_t>(
+      io, "mesh/original_cell_index", {num_cells_global}, {cell_offset},
+      {num_cells});
+  engine.Put(var_orig, topology->original_cell_index.front().data(),
+             adios2::Mode::Sync);
+
+  // Cell ownership, as the first cell owned by each process
+  const int rank = dolfinx::MPI::rank(mesh.comm());
+  const int size = dolfinx::MPI::size(mesh.comm());
+  adios2::Variable var_offsets = impl_adios2::define_variable<std::int64_t>(
+      io, "mesh/cell_offsets", {std::size_t(size)}, {std::size_t(rank)}, {1});
+  engine.Put(var_offsets, std::int64_t(cell_offset), adios2::Mode::Sync);
+}
+
+/// @brief Write a function to a checkpoint.
+/// @param[in] io The ADIOS2 IO
+/// @param[in] engine The ADIOS2 engine
+/// @param[in] u The function
+template <dolfinx::scalar T, std::floating_point U>
+void write_function(adios2::IO& io, adios2::Engine& engine,
+                    const fem::Function<T, U>& u)
+{
+  auto V = u.function_space();
+  assert(V);
+  auto mesh = V->mesh();
+  assert(mesh);
+  auto dofmap = V->dofmap();
+  assert(dofmap);
+  if (V->element()->needs_dof_transformations())
+  {
+    throw std::runtime_error("Checkpointing of functions with elements that "
+                             "require DOF transformations not supported.");
+  }
+
+  // Owned degree-of-freedom values
+  auto index_map = dofmap->index_map;
+  assert(index_map);
+  const std::size_t bs = dofmap->index_map_bs();
+  const std::size_t num_dofs = index_map->size_local();
+  std::span<const T> values = u.x()->array();
+  adios2::Variable var_values = impl_adios2::define_variable<T>(
+      io, u.name + "/values", {std::size_t(index_map->size_global()), bs},
+      {std::size_t(index_map->local_range()[0]), 0}, {num_dofs, bs});
+  engine.Put(var_values, values.data(), adios2::Mode::Sync);
+
+  // Global degree-of-freedom indices of the owned cells
+  const int tdim = mesh->topology()->dim();
+  auto cell_map = mesh->topology()->index_map(tdim);
+  assert(cell_map);
+  const std::size_t num_cells = cell_map->size_local();
+  const std::size_t num_cell_dofs = dofmap->map().extent(1);
+  std::vector<std::int64_t> cell_dofs(num_cells * num_cell_dofs);
+  index_map->local_to_global(
+      std::span(dofmap->map().data_handle(), cell_dofs.size()), cell_dofs);
+
+  adios2::Variable var_dofs = impl_adios2::define_variable<std::int64_t>(
+      io, u.name + "/cell_dofs",
+      {std::size_t(cell_map->size_global()), num_cell_dofs},
+      {std::size_t(cell_map->local_range()[0]), 0},
+      {num_cells, num_cell_dofs});
+  engine.Put(var_dofs, cell_dofs.data(), adios2::Mode::Sync);
+}
+
+/// @brief Read a mesh from the current step of a checkpoint
+/// (collective).
+/// @param[in] io The ADIOS2 IO
+/// @param[in] reader The ADIOS2 engine, in a step
+/// @param[in] comm The MPI communicator
+/// @param[in] ghost_mode The type of cell ghosting
+/// @return The mesh
+template <std::floating_point T>
+mesh::Mesh<T> read_mesh(adios2::IO& io, adios2::Engine& reader, MPI_Comm comm,
+                        mesh::GhostMode ghost_mode)
+{
+  auto read_int = [&io](std::string name)
+  {
+    adios2::Attribute<int> attr = io.InquireAttribute<int>(name);
+    if (!attr)
+      throw std::runtime_error("Checkpoint attribute not found: " + name);
+    return attr.Data().front();
+  };
+  adios2::Attribute<std::string> cell_type
+      = io.InquireAttribute<std::string>("mesh/cell_type");
+  if (!cell_type)
+    throw std::runtime_error("Checkpoint does not contain a mesh.");
+  fem::CoordinateElement<T> cmap(
+      mesh::to_type(cell_type.Data().front()), read_int("mesh/degree"),
+      static_cast<basix::element::lagrange_variant>(
+          read_int("mesh/lagrange_variant")));
+  const std::size_t gdim = read_int("mesh/gdim");
+
+  // Cells to read on this process
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  const std::int64_t num_cells_global
+      = impl::num_rows<std::int64_t>(io, "mesh/cells");
+  const bool same_size
+      = impl::num_rows<std::int64_t>(io, "mesh/cell_offsets") == size;
+  std::array<std::int64_t, 2> cell_range;
+  if (same_size)
+  {
+    auto [offsets, ncols] = impl::read_rows<std::int64_t>(
+        io, reader, "mesh/cell_offsets", {0, size});
+    cell_range = {offsets[rank],
+                  rank + 1 < size ? offsets[rank + 1] : num_cells_global};
+  }
+  else
+    cell_range = dolfinx::MPI::local_range(rank, num_cells_global, size);
+
+  auto [cells, num_cell_nodes]
+      = impl::read_rows<std::int64_t>(io, reader, "mesh/cells", cell_range);
+  auto [original_cell_index, ncols0] = impl::read_rows<std::int64_t>(
+      io, reader, "mesh/original_cell_index", cell_range);
+
+  // Geometry nodes to read on this process
+  const std::array<std::int64_t, 2> node_range = dolfinx::MPI::local_range(
+      rank, impl::num_rows<T>(io, "mesh/x"), size);
+  auto [x, ncols1] = impl::read_rows<T>(io, reader, "mesh/x", node_range);
+  auto [input_global_indices, ncols2] = impl::read_rows<std::int64_t>(
+      io, reader, "mesh/input_global_indices", node_range);
+
+  // Keep the written cell distribution when possible
+  const std::array<std::size_t, 2> xshape = {x.size() / gdim, gdim};
+  mesh::CellPartitionFunction partitioner;
+  if (same_size)
+  {
+    partitioner = mesh::create_precomputed_cell_partitioner(
+        ghost_mode,
+        std::vector<std::int32_t>(cells.size() / num_cell_nodes, rank));
+  }
+  else
+    partitioner = mesh::create_cell_partitioner(ghost_mode);
+
+  mesh::Mesh<T> mesh0 = mesh::create_mesh(comm, comm, cells, cmap, comm, x,
+                                          xshape, partitioner);
+
+  // Restore the original cell indices. The original cell index of the
+  // new mesh is the position of the cell in the checkpoint.
+  std::shared_ptr<mesh::Topology> topology = mesh0.topology_mutable();
+  std::vector<std::int64_t>& cell_index = topology->original_cell_index[0];
+  cell_index = dolfinx::MPI::distribute_data(comm, cell_index, comm,
+                                             original_cell_index, 1);
+
+  // Restore the input global indices of the geometry nodes. The input
+  // index of a node of the new mesh is its position in the checkpoint.
+  mesh::Geometry<T>& geometry0 = mesh0.geometry();
+  std::vector<std::int64_t> input_indices = dolfinx::MPI::distribute_data(
+      comm, geometry0.input_global_indices(), comm, input_global_indices, 1);
+  auto dofmap0 = geometry0.dofmap();
+  std::span<const T> x0 = geometry0.x();
+  mesh::Geometry<T> geometry(
+      geometry0.index_map(),
+      std::vector<std::int32_t>(dofmap0.data_handle(),
+                                dofmap0.data_handle() + dofmap0.size()),
+      cmap, std::vector<T>(x0.begin(), x0.end()), geometry0.dim(),
+      std::move(input_indices));
+
+  return mesh::Mesh<T>(comm, topology, std::move(geometry));
+}
+
+/// @brief Read a function from the current step of a checkpoint
+/// (collective).
+/// @param[in] io The ADIOS2 IO
+/// @param[in] reader The ADIOS2 engine, in a step
+/// @param[in,out] u The function to read the values into
+/// @param[in] name Name of the function in the checkpoint
+template <dolfinx::scalar T, std::floating_point U>
+void read_function(adios2::IO& io, adios2::Engine& reader,
+                   fem::Function<T, U>& u, std::string name)
+{
+  auto V = u.function_space();
+  assert(V);
+  auto mesh = V->mesh();
+  assert(mesh);
+  auto dofmap = V->dofmap();
+  assert(dofmap);
+  if (V->element()->needs_dof_transformations())
+  {
+    throw std::runtime_error("Checkpointing of functions with elements that "
+                             "require DOF transformations not supported.");
+  }
+
+  MPI_Comm comm = mesh->comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  const std::int64_t num_cells_global
+      = impl::num_rows<std::int64_t>(io, "mesh/original_cell_index");
+  const std::array<std::int64_t, 2> cell_range
+      = dolfinx::MPI::local_range(rank, num_cells_global, size);
+  auto [original_cell_index, ncols0] = impl::read_rows<std::int64_t>(
+      io, reader, "mesh/original_cell_index", cell_range);
+  auto [cell_dofs, num_cell_dofs] = impl::read_rows<std::int64_t>(
+      io, reader, name + "/cell_dofs", cell_range);
+  const std::array<std::int64_t, 2> dof_range = dolfinx::MPI::local_range(
+      rank, impl::num_rows<T>(io, name + "/values"), size);
+  auto [values, bs]
+      = impl::read_rows<T>(io, reader, name + "/values", dof_range);
+
+  if (num_cell_dofs != dofmap->map().extent(1)
+      or int(bs) != dofmap->index_map_bs())
+  {
+    throw std::runtime_error("Function space of \"" + name
+                             + "\" does not match the checkpoint.");
+  }
+
+  // Build the map from original cell index to position in the
+  // checkpoint, distributed in blocks of original cell indices
+  std::int64_t num_original = 0;
+  {
+    std::int64_t max_index = -1;
+    if (!original_cell_index.empty())
+      max_index = std::ranges::max(original_cell_index);
+    MPI_Allreduce(&max_index, &num_original, 1, MPI_INT64_T, MPI_MAX, comm);
+    ++num_original;
+  }
+
+  std::vector<std::int64_t> cell_pos;
+  {
+    std::vector<int> send_sizes(size, 0), recv_sizes(size);
+    for (std::int64_t c : original_cell_index)
+      send_sizes[dolfinx::MPI::index_owner(size, c, num_original)] += 2;
+    MPI_Alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT,
+                 comm);
+    std::vector<int> send_disp(size + 1, 0), recv_disp(size + 1, 0);
+    std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                     std::next(send_disp.begin()));
+    std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                     std::next(recv_disp.begin()));
+
+    std::vector<std::int64_t> send_data(send_disp.back());
+    std::vector<int> pos(send_disp.begin(), std::prev(send_disp.end()));
+    for (std::size_t i = 0; i < original_cell_index.size(); ++i)
+    {
+      std::int64_t c = original_cell_index[i];
+      int dest = dolfinx::MPI::index_owner(size, c, num_original);
+      send_data[pos[dest]++] = c;
+      send_data[pos[dest]++] = cell_range[0] + i;
+    }
+
+    std::vector<std::int64_t> recv_data(recv_disp.back());
+    MPI_Alltoallv(send_data.data(), send_sizes.data(), send_disp.data(),
+                  MPI_INT64_T, recv_data.data(), recv_sizes.data(),
+                  recv_disp.data(), MPI_INT64_T, comm);
+
+    std::array<std::int64_t, 2> range
+        = dolfinx::MPI::local_range(rank, num_original, size);
+    cell_pos.resize(range[1] - range[0], -1);
+    for (std::size_t i = 0; i < recv_data.size(); i += 2)
+      cell_pos[recv_data[i] - range[0]] = recv_data[i + 1];
+  }
+
+  // Position in the checkpoint of the owned cells
+  const int tdim = mesh->topology()->dim();
+  auto cell_map = mesh->topology()->index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells = cell_map->size_local();
+  std::span<const std::int64_t> cells(
+      mesh->topology()->original_cell_index.front().data(), num_cells);
+  std::vector<std::int64_t> positions
+      = dolfinx::MPI::distribute_data(comm, cells, comm, cell_pos, 1);
+  if (std::ranges::find(positions, -1) != positions.end())
+    throw std::runtime_error("Mesh cell not found in checkpoint.");
+
+  // Fetch the checkpoint degrees-of-freedom of the owned cells, and
+  // their values
+  std::vector<std::int64_t> dofs0 = dolfinx::MPI::distribute_data(
+      comm, positions, comm, cell_dofs, num_cell_dofs);
+  std::vector<std::int64_t> dofs0_unique = dofs0;
+  std::ranges::sort(dofs0_unique);
+  auto [unique_end, range_end] = std::ranges::unique(dofs0_unique);
+  dofs0_unique.erase(unique_end, range_end);
+  std::vector<T> values0
+      = dolfinx::MPI::distribute_data(comm, dofs0_unique, comm, values, bs);
+
+  std::span<T> x = u.x()->mutable_array();
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    std::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+    {
+      auto it = std::ranges::lower_bound(dofs0_unique,
+                                         dofs0[c * num_cell_dofs + i]);
+      std::size_t pos = std::distance(dofs0_unique.begin(), it);
+      std::copy_n(std::next(values0.begin(), pos * bs), bs,
+                  std::next(x.begin(), dofs[i] * bs));
+    }
+  }
+
+  u.x()->scatter_fwd();
+}
+
+/// @brief Write a mesh and functions defined on it in the current
+/// step.
+/// @param[in] io The ADIOS2 IO
+/// @param[in] writer The ADIOS2 engine, in a step
+/// @param[in] mesh The mesh
+/// @param[in] u Functions on `mesh`
+template <std::floating_point T>
+void write_step(adios2::IO& io, adios2::Engine& writer,
+                const mesh::Mesh<T>& mesh, const adios2_writer::U<T>& u)
+{
+  write_mesh(io, writer, mesh);
+  for (auto& v : u)
+  {
+    std::visit(
+        [&](auto& u)
+        {
+          if (u->function_space()->mesh().get() != &mesh)
+          {
+            throw std::runtime_error(
+                "Checkpoint functions must be defined on the mesh.");
+          }
+          write_function(io, writer, *u);
+        },
+        v);
+  }
+}
+
+} // namespace impl
+
+/// @brief Write a mesh and functions defined on it to a checkpoint
+/// (collective).
+///
+/// The checkpoint can be read with read_mesh and read_function on the
+/// same or on a different number of processes.
+///
+/// @param[in] comm The MPI communicator
+/// @param[in] filename Name of the checkpoint file
+/// @param[in] mesh The mesh
+/// @param[in] u Functions to write. The functions must be defined on
+/// `mesh`, have unique names, and use elements that do not require DOF
+/// transformations, e.g. (discontinuous) Lagrange elements.
+/// @param[in] engine ADIOS2 engine type
+/// @param[in] num_aggregators Number of ranks per node that write data,
+/// see impl_adios2::set_aggregation. If zero, the engine default is
+/// used.
+template <std::floating_point T>
+void write(MPI_Comm comm, const std::filesystem::path& filename,
+           const mesh::Mesh<T>& mesh, const adios2_writer::U<T>& u,
+           std::string engine = "BPFile", int num_aggregators = 0)
+{
+  adios2::ADIOS adios(comm);
+  adios2::IO io = adios.DeclareIO("DOLFINx checkpoint writer");
+  io.SetEngine(engine);
+  impl_adios2::set_aggregation(io, comm, num_aggregators);
+  adios2::Engine writer = io.Open(filename, adios2::Mode::Write);
+  writer.BeginStep();
+  impl::write_step(io, writer, mesh, u);
+  writer.EndStep();
+  writer.Close();
+}
+
+/// @brief Read a mesh from a checkpoint (collective).
+///
+/// When the checkpoint is read on the same number of processes as it
+/// was written on, each process reads the cells that it owned when the
+/// checkpoint was written and no repartitioning is performed.
+/// Otherwise, the cells are read in blocks and partitioned using the
+/// default graph partitioner.
+///
+/// The input global indices of the geometry nodes and the original
+/// cell indices of the written mesh are restored.
+///
+/// @param[in] comm The MPI communicator
+/// @param[in] filename Name of the checkpoint file
+/// @param[in] ghost_mode The type of cell ghosting
+/// @param[in] engine ADIOS2 engine type
+/// @return The mesh
+template <std::floating_point T>
+mesh::Mesh<T> read_mesh(MPI_Comm comm, const std::filesystem::path& filename,
+                        mesh::GhostMode ghost_mode,
+                        std::string engine = "BPFile")
+{
+  adios2::ADIOS adios(comm);
+  adios2::IO io = adios.DeclareIO("DOLFINx checkpoint reader");
+  io.SetEngine(engine);
+  adios2::Engine reader = io.Open(filename, adios2::Mode::Read);
+  reader.BeginStep();
+
+  mesh::Mesh<T> mesh = impl::read_mesh<T>(io, reader, comm, ghost_mode);
+  reader.EndStep();
+  reader.Close();
+  return mesh;
+}
+
+/// @brief Read a function from a checkpoint (collective).
+///
+/// The function space of `u` must use the same element as the written
+/// function, and be defined on a mesh with the same cells (identified
+/// by their original cell index and with the same node ordering) as
+/// the written mesh, e.g. a mesh read using read_mesh. The mesh can be
+/// distributed differently from the written mesh.
+///
+/// @param[in] filename Name of the checkpoint file
+/// @param[in,out] u The function to read the values into
+/// @param[in] name Name of the function in the checkpoint
+/// @param[in] engine ADIOS2 engine type
+template <dolfinx::scalar T, std::floating_point U>
+void read_function(const std::filesystem::path& filename,
+                   fem::Function<T, U>& u, std::string name,
+                   std::string engine = "BPFile")
+{
+  MPI_Comm comm = u.function_space()->mesh()->comm();
+  adios2::ADIOS adios(comm);
+  adios2::IO io = adios.DeclareIO("DOLFINx checkpoint reader");
+  io.SetEngine(engine);
+  adios2::Engine reader = io.Open(filename, adios2::Mode::Read);
+  reader.BeginStep();
+  impl::read_function(io, reader, u, name);
+  reader.EndStep();
+  reader.Close();
+}
+
+/// @brief Writer of a sequence of checkpoints, one per ADIOS2 step.
+///
+/// Each step holds a mesh and functions on it in the checkpoint layout.
+/// With the SST engine the steps are streamed to a concurrently running
+/// consumer job (in-situ analysis), which can use Reader to reconstruct
+/// the mesh and functions on a different, e.g. smaller, number of
+/// processes. Non-blocking steps (ADIOS2Writer::set_nonblocking) drop
+/// steps instead of waiting for a lagging consumer.
+class Writer : public ADIOS2Writer
+{
+public:
+  /// @brief Create a checkpoint writer (collective).
+  /// @param[in] comm The MPI communicator
+  /// @param[in] filename Name of the checkpoint file or stream
+  /// @param[in] engine ADIOS2 engine type
+  /// @param[in] num_aggregators Number of ranks per node that write
+  /// data, see impl_adios2::set_aggregation. If zero, the engine
+  /// default is used.
+  /// @param[in] engine_parameters ADIOS2 engine parameters
+  Writer(MPI_Comm comm, const std::filesystem::path& filename,
+         std::string engine = "BPFile", int num_aggregators = 0,
+         const adios2::Params& engine_parameters = {})
+      : ADIOS2Writer(comm, filename, "DOLFINx checkpoint writer", engine,
+                     num_aggregators, engine_parameters)
+  {
+  }
+
+  /// @brief Write a mesh and functions defined on it as a new step
+  /// (collective).
+  /// @param[in] mesh The mesh
+  /// @param[in] u Functions to write, see checkpointing::write
+  template <std::floating_point T>
+  void write(const mesh::Mesh<T>& mesh, const adios2_writer::U<T>& u)
+  {
+    assert(_io);
+    assert(_engine);
+    if (!begin_step())
+      return;
+    impl::write_step(*_io, *_engine, mesh, u);
+    end_step();
+  }
+};
+
+/// @brief Reader of a sequence of checkpoints written by Writer, e.g.
+/// an SST stream from a running simulation.
+///
+/// The steps are read in order. The mesh and the functions of a step
+/// can be read on a different number of processes than they were
+/// written on.
+class Reader
+{
+public:
+  /// @brief Open a checkpoint file or stream for reading (collective).
+  /// @param[in] comm The MPI communicator
+  /// @param[in] filename Name of the checkpoint file or stream
+  /// @param[in] engine ADIOS2 engine type
+  /// @param[in] engine_parameters ADIOS2 engine parameters
+  Reader(MPI_Comm comm, const std::filesystem::path& filename,
+         std::string engine = "BPFile",
+         const adios2::Params& engine_parameters = {})
+      : _comm(comm), _adios(std::make_unique<adios2::ADIOS>(comm)),
+        _io(std::make_unique<adios2::IO>(
+            _adios->DeclareIO("DOLFINx checkpoint reader")))
+  {
+    _io->SetEngine(engine);
+    _io->SetParameters(engine_parameters);
+    _engine = std::make_unique<adios2::Engine>(
+        _io->Open(filename, adios2::Mode::Read));
+  }
+
+  /// @brief Move constructor
+  Reader(Reader&& reader) = default;
+
+  /// @brief Destructor
+  ~Reader() { close(); }
+
+  /// @brief Move assignment
+  Reader& operator=(Reader&& reader) = default;
+
+  /// @brief Begin reading the next step (collective).
+  /// @param[in] timeout Time (seconds) to wait for the next step. If
+  /// negative, wait until a step is available or the stream ends.
+  /// @return True if a step has begun. False at the end of the stream,
+  /// see end_of_stream, or if no step became available within
+  /// `timeout`.
+  bool begin_step(float timeout = -1.0f)
+  {
+    assert(_engine);
+    adios2::StepStatus status
+        = _engine->BeginStep(adios2::StepMode::Read, timeout);
+    if (status == adios2::StepStatus::EndOfStream)
+      _end_of_stream = true;
+    else if (status == adios2::StepStatus::OtherError)
+      throw std::runtime_error("Failed to begin ADIOS2 checkpoint step.");
+    return status == adios2::StepStatus::OK;
+  }
+
+  /// @brief End reading the current step (collective).
+  void end_step()
+  {
+    assert(_engine);
+    _engine->EndStep();
+  }
+
+  /// @brief Check if the end of the stream has been reached.
+  bool end_of_stream() const { return _end_of_stream; }
+
+  /// @brief Read the mesh of the current step (collective).
+  /// @param[in] ghost_mode The type of cell ghosting
+  /// @return The mesh, see checkpointing::read_mesh
+  template <std::floating_point T>
+  mesh::Mesh<T> read_mesh(mesh::GhostMode ghost_mode)
+  {
+    assert(_io);
+    assert(_engine);
+    return impl::read_mesh<T>(*_io, *_engine, _comm.comm(), ghost_mode);
+  }
+
+  /// @brief Read a function of the current step (collective).
+  /// @param[in,out] u The function to read the values into, see
+  /// checkpointing::read_function
+  /// @param[in] name Name of the function in the checkpoint
+  template <dolfinx::scalar T, std::floating_point U>
+  void read_function(fem::Function<T, U>& u, std::string name)
+  {
+    assert(_io);
+    assert(_engine);
+    impl::read_function(*_io, *_engine, u, name);
+  }
+
+  /// @brief Close the file or stream.
+  void close()
+  {
+    // ADIOS2 uses `operator bool()` to test if the engine is open
+    if (_engine and *_engine)
+      _engine->Close();
+  }
+
+private:
+  dolfinx::MPI::Comm _comm;
+  std::unique_ptr<adios2::ADIOS> _adios;
+  std::unique_ptr<adios2::IO> _io;
+  std::unique_ptr<adios2::Engine> _engine;
+  bool _end_of_stream = false;
+};
+
+} // namespace dolfinx::io::checkpointing
+
+#endif
@@ -10,4 +10,8 @@ namespace dolfinx::io
 // DOLFINx io interface
 
 #include <dolfinx/io/ADIOS2Writers.h>
+#include <dolfinx/io/aggregation.h>
+#include <dolfinx/io/checkpointing.h>
+#include <dolfinx/io/gmsh.h>
+#include <dolfinx/io/snapshot.h>
 #include <dolfinx/io/VTKFile.h>
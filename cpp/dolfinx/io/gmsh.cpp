@@ -0,0 +1,624 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "gmsh.h"
+#include "cells.h"
+#include "xdmf_utils.h"
+#include <algorithm>
+#include <array>
+#include <basix/finite-element.h>
+#include <basix/mdspan.hpp>
+#include <cstdint>
+#include <dolfinx/common/log.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/ElementDofLayout.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// DOLFINx cell type, degree and number of nodes of a Gmsh element
+/// type
+struct ElementType
+{
+  mesh::CellType cell;
+  int degree;
+  int num_nodes;
+};
+
+/// Get the DOLFINx cell of a Gmsh element type (see
+/// https://gmsh.info/doc/texinfo/gmsh.html#MSH-file-format)
+ElementType element_type(int type)
+{
+  switch (type)
+  {
+  case 1:
+    return {mesh::CellType::interval, 1, 2};
+  case 2:
+    return {mesh::CellType::triangle, 1, 3};
+  case 3:
+    return {mesh::CellType::quadrilateral, 1, 4};
+  case 4:
+    return {mesh::CellType::tetrahedron, 1, 4};
+  case 5:
+    return {mesh::CellType::hexahedron, 1, 8};
+  case 6:
+    return {mesh::CellType::prism, 1, 6};
+  case 7:
+    return {mesh::CellType::pyramid, 1, 5};
+  case 8:
+    return {mesh::CellType::interval, 2, 3};
+  case 9:
+    return {mesh::CellType::triangle, 2, 6};
+  case 10:
+    return {mesh::CellType::quadrilateral, 2, 9};
+  case 11:
+    return {mesh::CellType::tetrahedron, 2, 10};
+  case 12:
+    return {mesh::CellType::hexahedron, 2, 27};
+  case 15:
+    return {mesh::CellType::point, 0, 1};
+  case 21:
+    return {mesh::CellType::triangle, 3, 10};
+  case 26:
+    return {mesh::CellType::interval, 3, 4};
+  case 29:
+    return {mesh::CellType::tetrahedron, 3, 20};
+  case 36:
+    return {mesh::CellType::quadrilateral, 3, 16};
+  default:
+    throw std::runtime_error("Unsupported Gmsh element type "
+                             + std::to_string(type) + ".");
+  }
+}
+
+/// Entity block of the $Nodes or $Elements section of a file
+struct Block
+{
+  int dim;            // Dimension of the Gmsh entity
+  int entity;         // Tag of the Gmsh entity
+  int type;           // Element type, or number of parametric node
+                      // coordinates for a node block
+  std::int64_t size;  // Number of nodes or elements
+  std::streamoff pos; // Position of the block data in the file
+};
+
+/// Headers of a file, with the positions of the node and element data
+struct Header
+{
+  // First physical tag of each Gmsh entity (dim, tag)
+  std::map<std::array<int, 2>, std::int32_t> physical;
+
+  // Number of nodes and range of node tags
+  std::int64_t num_nodes = 0;
+  std::int64_t min_node = 0;
+  std::int64_t max_node = -1;
+
+  std::vector<Block> nodes;
+  std::vector<Block> elements;
+};
+
+/// Read a value at the current position of a binary stream
+template <typename U>
+U read_value(std::istream& in)
+{
+  U v;
+  in.read(reinterpret_cast<char*>(&v), sizeof(U));
+  return v;
+}
+
+/// Read an array at the current position of a binary stream
+template <typename U>
+std::vector<U> read_array(std::istream& in, std::size_t n)
+{
+  std::vector<U> v(n);
+  in.read(reinterpret_cast<char*>(v.data()), n * sizeof(U));
+  if (!in)
+    throw std::runtime_error("Failed to read data from Gmsh file.");
+  return v;
+}
+
+/// Read the entities and the block headers of a binary MSH 4.1 file.
+/// The node and element data is skipped.
+Header read_header(const std::filesystem::path& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+  {
+    throw std::runtime_error("Failed to open Gmsh file " + filename.string()
+                             + ".");
+  }
+
+  auto next_line = [&in](std::string& line)
+  {
+    if (!std::getline(in, line))
+      return false;
+    if (!line.empty() and line.back() == '\r')
+      line.pop_back();
+    return true;
+  };
+
+  std::string line;
+  if (!next_line(line) or line != "$MeshFormat")
+    throw std::runtime_error(filename.string() + " is not a Gmsh MSH file.");
+  {
+    next_line(line);
+    std::istringstream s(line);
+    std::string version;
+    int file_type = -1, data_size = 0;
+    s >> version >> file_type >> data_size;
+    if (version != "4.1")
+    {
+      throw std::runtime_error("Unsupported Gmsh MSH version " + version
+                               + " (version 4.1 is required).");
+    }
+    if (file_type != 1)
+    {
+      throw std::runtime_error(
+          "ASCII Gmsh files are not supported (save the mesh in binary).");
+    }
+    if (data_size != sizeof(std::uint64_t))
+      throw std::runtime_error("Unsupported data size in Gmsh file.");
+    if (read_value<int>(in) != 1)
+      throw std::runtime_error("Gmsh file has a different byte order.");
+  }
+
+  Header header;
+  bool has_nodes = false, has_elements = false;
+  while (!(has_nodes and has_elements) and next_line(line))
+  {
+    if (line == "$Entities")
+    {
+      std::array<std::uint64_t, 4> num;
+      for (auto& n : num)
+        n = read_value<std::uint64_t>(in);
+      for (int dim = 0; dim < 4; ++dim)
+      {
+        for (std::uint64_t e = 0; e < num[dim]; ++e)
+        {
+          // Tag, coordinates (points) or bounding box, physical tags
+          // and bounding entities (not points)
+          int tag = read_value<int>(in);
+          in.seekg((dim == 0 ? 3 : 6) * sizeof(double), std::ios::cur);
+          std::vector<int> physical
+              = read_array<int>(in, read_value<std::uint64_t>(in));
+          if (!physical.empty())
+            header.physical[{dim, tag}] = physical.front();
+          if (dim > 0)
+          {
+            std::uint64_t num_bounding = read_value<std::uint64_t>(in);
+            in.seekg(num_bounding * sizeof(int), std::ios::cur);
+          }
+        }
+      }
+    }
+    else if (line == "$PartitionedEntities")
+      throw std::runtime_error("Partitioned Gmsh files are not supported.");
+    else if (line == "$Nodes")
+    {
+      std::uint64_t num_blocks = read_value<std::uint64_t>(in);
+      header.num_nodes = read_value<std::uint64_t>(in);
+      header.min_node = read_value<std::uint64_t>(in);
+      header.max_node = read_value<std::uint64_t>(in);
+      for (std::uint64_t b = 0; b < num_blocks; ++b)
+      {
+        Block block;
+        block.dim = read_value<int>(in);
+        block.entity = read_value<int>(in);
+        block.type = read_value<int>(in) == 0 ? 0 : block.dim;
+        block.size = read_value<std::uint64_t>(in);
+        block.pos = in.tellg();
+
+        // Skip the node tags and coordinates
+        in.seekg(block.size * (sizeof(std::uint64_t)
+                               + (3 + block.type) * sizeof(double)),
+                 std::ios::cur);
+        header.nodes.push_back(block);
+      }
+      has_nodes = true;
+    }
+    else if (line == "$Elements")
+    {
+      std::uint64_t num_blocks = read_value<std::uint64_t>(in);
+      in.seekg(3 * sizeof(std::uint64_t), std::ios::cur);
+      for (std::uint64_t b = 0; b < num_blocks; ++b)
+      {
+        Block block;
+        block.dim = read_value<int>(in);
+        block.entity = read_value<int>(in);
+        block.type = read_value<int>(in);
+        block.size = read_value<std::uint64_t>(in);
+        block.pos = in.tellg();
+
+        // Skip the element tags and nodes
+        const int num_nodes = element_type(block.type).num_nodes;
+        in.seekg(block.size * (1 + num_nodes) * sizeof(std::uint64_t),
+                 std::ios::cur);
+        header.elements.push_back(block);
+      }
+      has_elements = true;
+    }
+
+    if (!in)
+      throw std::runtime_error("Failed to read Gmsh file headers.");
+  }
+
+  if (!has_nodes or !has_elements)
+    throw std::runtime_error("Gmsh file has no $Nodes or $Elements section.");
+
+  return header;
+}
+
+/// Call `f(block, i0, i1)` for the rows `[i0, i1)` of each block that
+/// are in the range `[r0, r1)` of the rows of all blocks, in file order
+template <typename F>
+void for_each_range(std::span<const Block> blocks, std::int64_t r0,
+                    std::int64_t r1, F&& f)
+{
+  std::int64_t offset = 0;
+  for (const Block& b : blocks)
+  {
+    std::int64_t i0 = std::max<std::int64_t>(r0 - offset, 0);
+    std::int64_t i1 = std::min<std::int64_t>(r1 - offset, b.size);
+    if (i0 < i1)
+      f(b, i0, i1);
+    offset += b.size;
+  }
+}
+
+/// Send rows of `width` values to the given ranks. Returns the source
+/// rank of each received row and the received rows, ordered by source
+/// rank and then in the order in which they were sent.
+template <typename U>
+std::pair<std::vector<int>, std::vector<U>>
+send_rows(MPI_Comm comm, std::span<const int> dest, std::span<const U> data,
+          std::size_t width)
+{
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<int> send_sizes(size, 0), recv_sizes(size);
+  for (int d : dest)
+    send_sizes[d] += width;
+  MPI_Alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT,
+               comm);
+  std::vector<int> send_disp(size + 1, 0), recv_disp(size + 1, 0);
+  std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                   std::next(send_disp.begin()));
+  std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                   std::next(recv_disp.begin()));
+
+  std::vector<U> send_data(send_disp.back());
+  std::vector<int> pos(send_disp.begin(), std::prev(send_disp.end()));
+  for (std::size_t i = 0; i < dest.size(); ++i)
+  {
+    std::copy_n(std::next(data.begin(), i * width), width,
+                std::next(send_data.begin(), pos[dest[i]]));
+    pos[dest[i]] += width;
+  }
+
+  std::vector<U> recv_data(recv_disp.back());
+  MPI_Alltoallv(send_data.data(), send_sizes.data(), send_disp.data(),
+                dolfinx::MPI::mpi_type<U>(), recv_data.data(),
+                recv_sizes.data(), recv_disp.data(),
+                dolfinx::MPI::mpi_type<U>(), comm);
+
+  std::vector<int> src(recv_data.size() / width);
+  for (int r = 0; r < size; ++r)
+  {
+    std::fill(std::next(src.begin(), recv_disp[r] / width),
+              std::next(src.begin(), recv_disp[r + 1] / width), r);
+  }
+
+  return {std::move(src), std::move(recv_data)};
+}
+
+/// Compute the global indices of nodes from their tags. The nodes are
+/// numbered in the order of their tags, and the tags in
+/// `[min_tag, min_tag + num_tags)` are distributed in contiguous
+/// ranges (see dolfinx::MPI::index_owner).
+/// @param[in] comm MPI communicator
+/// @param[in] tags Tags to compute the indices of
+/// @param[in] owned Sorted tags of the nodes of the calling process
+/// @param[in] offset Global index of the first node of the calling
+/// process
+/// @param[in] min_tag Smallest node tag
+/// @param[in] num_tags Size of the range of the node tags
+std::vector<std::int64_t> node_indices(MPI_Comm comm,
+                                       std::span<const std::int64_t> tags,
+                                       std::span<const std::int64_t> owned,
+                                       std::int64_t offset,
+                                       std::int64_t min_tag,
+                                       std::int64_t num_tags)
+{
+  const int size = dolfinx::MPI::size(comm);
+  std::vector<int> dest(tags.size());
+  for (std::size_t i = 0; i < tags.size(); ++i)
+    dest[i] = dolfinx::MPI::index_owner(size, tags[i] - min_tag, num_tags);
+
+  // Look up the index of the tags received by the owner
+  auto [src, requests] = send_rows(comm, std::span<const int>(dest), tags, 1);
+  for (std::int64_t& t : requests)
+  {
+    auto it = std::ranges::lower_bound(owned, t);
+    if (it == owned.end() or *it != t)
+    {
+      throw std::runtime_error("Node " + std::to_string(t)
+                               + " of a Gmsh element not found.");
+    }
+    t = offset + std::distance(owned.begin(), it);
+  }
+  std::vector<std::int64_t> replies
+      = send_rows(comm, std::span<const int>(src),
+                  std::span<const std::int64_t>(requests), 1)
+            .second;
+
+  // Replies are grouped by owner, in the order of the requests
+  std::vector<std::int64_t> pos(size + 1, 0);
+  for (int d : dest)
+    ++pos[d + 1];
+  std::partial_sum(pos.begin(), pos.end(), pos.begin());
+  std::vector<std::int64_t> indices(tags.size());
+  for (std::size_t i = 0; i < tags.size(); ++i)
+    indices[i] = replies[pos[dest[i]]++];
+
+  return indices;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+template <std::floating_point T>
+std::tuple<mesh::Mesh<T>, mesh::MeshTags<std::int32_t>,
+           mesh::MeshTags<std::int32_t>>
+io::gmsh::read_mesh(MPI_Comm comm, const std::filesystem::path& filename,
+                    int gdim, mesh::GhostMode ghost_mode)
+{
+  DOLFINX_LOG_INFO("Read Gmsh mesh ({})", filename.string());
+  if (gdim < 1 or gdim > 3)
+    throw std::runtime_error("Invalid geometric dimension.");
+
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  // All processes read the (small) headers
+  const Header header = read_header(filename);
+  std::ifstream in(filename, std::ios::binary);
+
+  // The cells are the elements of the highest dimension, and the
+  // facets the elements one dimension lower
+  if (header.elements.empty())
+    throw std::runtime_error("Gmsh file has no elements.");
+  int tdim = 0;
+  for (const Block& b : header.elements)
+    tdim = std::max(tdim, b.dim);
+  if (tdim == 0)
+    throw std::runtime_error("Gmsh file has no cells.");
+  auto blocks_of_dim = [&header](int dim)
+  {
+    std::vector<Block> blocks;
+    std::ranges::copy_if(header.elements, std::back_inserter(blocks),
+                         [dim](const Block& b) { return b.dim == dim; });
+    if (std::ranges::any_of(blocks, [&blocks](const Block& b)
+                            { return b.type != blocks.front().type; }))
+    {
+      throw std::runtime_error("Gmsh files with more than one element type "
+                               "of a dimension are not supported.");
+    }
+    return blocks;
+  };
+  const std::vector<Block> cell_blocks = blocks_of_dim(tdim);
+  const std::vector<Block> facet_blocks = blocks_of_dim(tdim - 1);
+  const ElementType cell_type = element_type(cell_blocks.front().type);
+  const int num_facet_nodes
+      = facet_blocks.empty()
+            ? 0
+            : element_type(facet_blocks.front().type).num_nodes;
+
+  // Read a range of the nodes, in file order
+  std::vector<std::int64_t> node_tags;
+  std::vector<T> node_x;
+  {
+    auto [r0, r1] = dolfinx::MPI::local_range(rank, header.num_nodes, size);
+    for_each_range(
+        header.nodes, r0, r1,
+        [&](const Block& b, std::int64_t i0, std::int64_t i1)
+        {
+          const std::size_t stride = 3 + b.type;
+          in.seekg(b.pos + i0 * sizeof(std::uint64_t));
+          std::vector tags = read_array<std::uint64_t>(in, i1 - i0);
+          in.seekg(b.pos + b.size * sizeof(std::uint64_t)
+                   + i0 * stride * sizeof(double));
+          std::vector x = read_array<double>(in, (i1 - i0) * stride);
+          node_tags.insert(node_tags.end(), tags.begin(), tags.end());
+          for (std::size_t i = 0; i < tags.size(); ++i)
+            for (int j = 0; j < gdim; ++j)
+              node_x.push_back(x[i * stride + j]);
+        });
+  }
+
+  // Distribute the nodes by tag, so that each process holds a
+  // contiguous range of the tags, sorted
+  const std::int64_t num_tags = header.max_node - header.min_node + 1;
+  std::vector<std::int64_t> owned_tags;
+  std::vector<T> x;
+  {
+    std::vector<int> dest(node_tags.size());
+    for (std::size_t i = 0; i < node_tags.size(); ++i)
+    {
+      dest[i] = dolfinx::MPI::index_owner(
+          size, node_tags[i] - header.min_node, num_tags);
+    }
+    std::vector tags = send_rows(comm, std::span<const int>(dest),
+                                 std::span<const std::int64_t>(node_tags), 1)
+                           .second;
+    std::vector xr = send_rows(comm, std::span<const int>(dest),
+                               std::span<const T>(node_x), gdim)
+                         .second;
+
+    std::vector<std::int32_t> perm(tags.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    std::ranges::sort(perm, [&tags](auto a, auto b)
+                      { return tags[a] < tags[b]; });
+    owned_tags.reserve(tags.size());
+    x.reserve(xr.size());
+    for (std::int32_t p : perm)
+    {
+      owned_tags.push_back(tags[p]);
+      x.insert(x.end(), std::next(xr.begin(), p * gdim),
+               std::next(xr.begin(), (p + 1) * gdim));
+    }
+  }
+  std::int64_t offset = 0;
+  const std::int64_t num_owned = owned_tags.size();
+  MPI_Exscan(&num_owned, &offset, 1, MPI_INT64_T, MPI_SUM, comm);
+
+  // Read a range of the elements of a dimension, in file order, with
+  // the physical tags of their entities
+  auto read_elements = [&](std::span<const Block> blocks, int num_nodes)
+  {
+    std::int64_t num = 0;
+    for (const Block& b : blocks)
+      num += b.size;
+
+    std::vector<std::int64_t> nodes;
+    std::vector<std::int32_t> values;
+    std::vector<std::int8_t> tagged;
+    auto [r0, r1] = dolfinx::MPI::local_range(rank, num, size);
+    for_each_range(
+        blocks, r0, r1,
+        [&](const Block& b, std::int64_t i0, std::int64_t i1)
+        {
+          const std::size_t width = 1 + num_nodes;
+          in.seekg(b.pos + i0 * width * sizeof(std::uint64_t));
+          std::vector data = read_array<std::uint64_t>(in, (i1 - i0) * width);
+          auto it = header.physical.find({b.dim, b.entity});
+          for (std::int64_t e = 0; e < i1 - i0; ++e)
+          {
+            nodes.insert(nodes.end(), std::next(data.begin(), e * width + 1),
+                         std::next(data.begin(), (e + 1) * width));
+            values.push_back(it == header.physical.end() ? 0 : it->second);
+            tagged.push_back(it != header.physical.end());
+          }
+        });
+
+    // Map the node tags to global node indices
+    if (num_tags == header.num_nodes)
+    {
+      for (std::int64_t& n : nodes)
+        n -= header.min_node;
+    }
+    else
+    {
+      nodes = node_indices(comm, nodes, owned_tags, offset, header.min_node,
+                           num_tags);
+    }
+
+    return std::tuple(std::move(nodes), std::move(values), std::move(tagged));
+  };
+
+  auto [cells, cell_values, cell_tagged]
+      = read_elements(cell_blocks, cell_type.num_nodes);
+  auto [facets, facet_values, facet_tagged]
+      = read_elements(facet_blocks, num_facet_nodes);
+
+  // Permute the element nodes from Gmsh to DOLFINx ordering
+  io::cells::apply_permutation_inplace(
+      cells, cell_type.num_nodes,
+      io::cells::perm_gmsh(cell_type.cell, cell_type.num_nodes));
+  if (!facet_blocks.empty())
+  {
+    io::cells::apply_permutation_inplace(
+        facets, num_facet_nodes,
+        io::cells::perm_gmsh(element_type(facet_blocks.front().type).cell,
+                             num_facet_nodes));
+  }
+
+  fem::CoordinateElement<T> element(
+      cell_type.cell, cell_type.degree,
+      basix::element::lagrange_variant::equispaced);
+  mesh::Mesh<T> mesh = mesh::create_mesh(
+      comm, std::span<const std::int64_t>(cells), element, x,
+      {owned_tags.size(), std::size_t(gdim)}, ghost_mode);
+
+  // Create the tags of the (tagged) entities of a dimension
+  auto create_tags = [&mesh, &header](int dim, std::span<const std::int64_t> e,
+                                      std::span<const std::int32_t> values,
+                                      std::span<const std::int8_t> tagged)
+  {
+    const std::size_t num_nodes
+        = mesh.geometry().cmap().create_dof_layout().entity_closure_dofs(dim, 0)
+              .size();
+    if (e.size() != tagged.size() * num_nodes)
+      throw std::runtime_error("Gmsh elements do not match the mesh cells.");
+    std::vector<std::int64_t> entities;
+    std::vector<std::int32_t> entity_values;
+    for (std::size_t i = 0; i < tagged.size(); ++i)
+    {
+      if (tagged[i])
+      {
+        entities.insert(entities.end(), std::next(e.begin(), i * num_nodes),
+                        std::next(e.begin(), (i + 1) * num_nodes));
+        entity_values.push_back(values[i]);
+      }
+    }
+
+    MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const std::int64_t,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>
+        entities_span(entities.data(), entity_values.size(), num_nodes);
+    std::pair<std::vector<std::int32_t>, std::vector<std::int32_t>>
+        entities_local = io::xdmf_utils::distribute_entity_data<std::int32_t>(
+            *mesh.topology(), mesh.geometry().input_global_indices(),
+            header.num_nodes, mesh.geometry().cmap().create_dof_layout(),
+            mesh.geometry().dofmap(), dim, entities_span,
+            std::span<const std::int32_t>(entity_values));
+
+    std::size_t num_vertices_per_entity = mesh::cell_num_entities(
+        mesh::cell_entity_type(mesh.topology()->cell_type(), dim, 0), 0);
+    const graph::AdjacencyList<std::int32_t> entities_adj
+        = graph::regular_adjacency_list(std::move(entities_local.first),
+                                        num_vertices_per_entity);
+    return mesh::create_meshtags(
+        mesh.topology(), dim, entities_adj,
+        std::span<const std::int32_t>(entities_local.second));
+  };
+
+  mesh::MeshTags<std::int32_t> cell_tags
+      = create_tags(tdim, cells, cell_values, cell_tagged);
+  cell_tags.name = "cell_tags";
+
+  mesh.topology_mutable()->create_connectivity(tdim - 1, tdim);
+  mesh::MeshTags<std::int32_t> facet_tags
+      = create_tags(tdim - 1, facets, facet_values, facet_tagged);
+  facet_tags.name = "facet_tags";
+
+  return {std::move(mesh), std::move(cell_tags), std::move(facet_tags)};
+}
+//-----------------------------------------------------------------------------
+/// @cond
+template std::tuple<mesh::Mesh<float>, mesh::MeshTags<std::int32_t>,
+                    mesh::MeshTags<std::int32_t>>
+io::gmsh::read_mesh(MPI_Comm, const std::filesystem::path&, int,
+                    mesh::GhostMode);
+template std::tuple<mesh::Mesh<double>, mesh::MeshTags<std::int32_t>,
+                    mesh::MeshTags<std::int32_t>>
+io::gmsh::read_mesh(MPI_Comm, const std::filesystem::path&, int,
+                    mesh::GhostMode);
+/// @endcond
+//-----------------------------------------------------------------------------
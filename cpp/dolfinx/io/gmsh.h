@@ -0,0 +1,54 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/MeshTags.h>
+#include <dolfinx/mesh/utils.h>
+#include <filesystem>
+#include <tuple>
+
+/// @brief Reading of meshes in the Gmsh MSH format.
+namespace dolfinx::io::gmsh
+{
+/// @brief Read a mesh and its physical groups from a Gmsh MSH file.
+///
+/// The file must be in the binary MSH 4.1 format with 8-byte sizes
+/// (the default binary output of Gmsh 4). The file is read in parallel
+/// without a root process: each process reads the (small) entity and
+/// block headers, and then seeks to and reads a contiguous range of
+/// the nodes and of the elements. The nodes are distributed by their
+/// tags, the element nodes are mapped to the node indices and permuted
+/// to the DOLFINx ordering (see io::cells::perm_gmsh), and the mesh is
+/// created from the distributed data by mesh::create_mesh.
+///
+/// The elements of the highest dimension in the file are the cells of
+/// the mesh, and the elements of one dimension lower are its facets.
+/// The cells and the facets must each have a single element type.
+/// Elements of lower dimensions are ignored. Each cell or facet is
+/// tagged with the (first) physical group of the Gmsh entity that it
+/// belongs to. Elements on entities without a physical group are not
+/// tagged.
+///
+/// @note Collective.
+/// @param[in] comm MPI communicator to create the mesh on.
+/// @param[in] filename Name of the `.msh` file.
+/// @param[in] gdim Geometric dimension of the mesh. The first `gdim`
+/// node coordinates are used.
+/// @param[in] ghost_mode Ghost mode of the mesh.
+/// @return (0) The mesh, (1) the tags of the cells and (2) the tags of
+/// the facets.
+template <std::floating_point T>
+std::tuple<mesh::Mesh<T>, mesh::MeshTags<std::int32_t>,
+           mesh::MeshTags<std::int32_t>>
+read_mesh(MPI_Comm comm, const std::filesystem::path& filename, int gdim = 3,
+          mesh::GhostMode ghost_mode = mesh::GhostMode::none);
+
+} // namespace dolfinx::io::gmsh
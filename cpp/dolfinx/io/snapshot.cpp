@@ -0,0 +1,459 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "snapshot.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// File signature and format version
+constexpr std::array<char, 8> magic = {'D', 'O', 'L', 'F', 'S', 'N', 'A', 'P'};
+constexpr std::uint64_t version = 1;
+
+// Alignment of the arrays in a file (bytes)
+constexpr std::uint64_t alignment = 64;
+
+/// Round up to a multiple of the array alignment
+constexpr std::uint64_t align(std::uint64_t n)
+{
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+/// Snapshot file of a process
+std::filesystem::path rank_file(const std::filesystem::path& dir, int rank)
+{
+  return dir / ("rank_" + std::to_string(rank) + ".bin");
+}
+
+/// Writer of a snapshot file. The arrays are not copied and must be
+/// alive until write is called.
+///
+/// The file starts with the signature, the format version, the number
+/// of arrays and the (offset, size in bytes) of each array, followed by
+/// the aligned arrays.
+class Writer
+{
+public:
+  /// Add an array
+  template <typename U>
+  void add(std::span<const U> x)
+  {
+    _arrays.push_back(std::as_bytes(x));
+  }
+
+  /// Add an array
+  template <typename U>
+  void add(const std::vector<U>& x)
+  {
+    add(std::span<const U>(x));
+  }
+
+  /// Write the arrays to a file
+  void write(const std::filesystem::path& filename) const
+  {
+    std::vector<std::uint64_t> toc = {version, _arrays.size()};
+    std::uint64_t offset
+        = align(magic.size() + (2 + 2 * _arrays.size()) * sizeof(toc[0]));
+    for (std::span<const std::byte> a : _arrays)
+    {
+      toc.push_back(offset);
+      toc.push_back(a.size());
+      offset = align(offset + a.size());
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      throw std::runtime_error("Failed to open mesh snapshot file "
+                               + filename.string() + ".");
+    }
+    out.write(magic.data(), magic.size());
+    out.write(reinterpret_cast<const char*>(toc.data()),
+              toc.size() * sizeof(toc[0]));
+    const std::array<char, alignment> padding{};
+    std::uint64_t pos = magic.size() + toc.size() * sizeof(toc[0]);
+    for (std::size_t i = 0; i < _arrays.size(); ++i)
+    {
+      std::uint64_t start = toc[2 + 2 * i];
+      out.write(padding.data(), start - pos);
+      out.write(reinterpret_cast<const char*>(_arrays[i].data()),
+                _arrays[i].size());
+      pos = start + _arrays[i].size();
+    }
+    if (!out)
+    {
+      throw std::runtime_error("Failed to write mesh snapshot file "
+                               + filename.string() + ".");
+    }
+  }
+
+private:
+  std::vector<std::span<const std::byte>> _arrays;
+};
+
+/// Read-only memory map of a file
+class MappedFile
+{
+public:
+  /// Map a file into memory
+  explicit MappedFile(const std::filesystem::path& filename)
+  {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+      throw std::runtime_error("Failed to open mesh snapshot file "
+                               + filename.string() + ".");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == 0 and st.st_size > 0)
+    {
+      _size = st.st_size;
+      _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (_data == MAP_FAILED or _size == 0)
+    {
+      _data = nullptr;
+      throw std::runtime_error("Failed to map mesh snapshot file "
+                               + filename.string() + ".");
+    }
+  }
+
+  // Copy constructor (deleted)
+  MappedFile(const MappedFile&) = delete;
+
+  // Assignment operator (deleted)
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// Destructor. Unmaps the file.
+  ~MappedFile()
+  {
+    if (_data)
+      ::munmap(_data, _size);
+  }
+
+  /// Contents of the file
+  std::span<const std::byte> data() const
+  {
+    return std::span(static_cast<const std::byte*>(_data), _size);
+  }
+
+private:
+  void* _data = nullptr;
+  std::size_t _size = 0;
+};
+
+/// Reader of a snapshot file, see Writer. The arrays are returned in
+/// the order in which they were added to the writer.
+class Reader
+{
+public:
+  /// Map a snapshot file and read its table of contents
+  explicit Reader(const std::filesystem::path& filename) : _file(filename)
+  {
+    std::span<const std::byte> data = _file.data();
+    const std::size_t header = magic.size() + 2 * sizeof(std::uint64_t);
+    if (data.size() < header
+        or std::memcmp(data.data(), magic.data(), magic.size()) != 0)
+    {
+      throw std::runtime_error(filename.string()
+                               + " is not a mesh snapshot file.");
+    }
+    std::array<std::uint64_t, 2> v;
+    std::memcpy(v.data(), data.data() + magic.size(), sizeof(v));
+    if (v[0] != version)
+      throw std::runtime_error("Unsupported mesh snapshot version.");
+    if (data.size() < header + 2 * v[1] * sizeof(std::uint64_t))
+      throw std::runtime_error("Mesh snapshot file is truncated.");
+    _toc.resize(2 * v[1]);
+    std::memcpy(_toc.data(), data.data() + header,
+                _toc.size() * sizeof(std::uint64_t));
+  }
+
+  /// Copy the next array from the file
+  template <typename U>
+  std::vector<U> next()
+  {
+    if (2 * _next >= _toc.size())
+      throw std::runtime_error("Mesh snapshot file has too few arrays.");
+    std::uint64_t offset = _toc[2 * _next];
+    std::uint64_t size = _toc[2 * _next + 1];
+    ++_next;
+
+    std::span<const std::byte> data = _file.data();
+    if (offset + size > data.size() or size % sizeof(U) != 0)
+      throw std::runtime_error("Mesh snapshot file is corrupt.");
+    std::vector<U> x(size / sizeof(U));
+    std::memcpy(x.data(), data.data() + offset, size);
+    return x;
+  }
+
+private:
+  MappedFile _file;
+  std::vector<std::uint64_t> _toc;
+  std::size_t _next = 0;
+};
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+template <std::floating_point T>
+void io::write_mesh_snapshot(const mesh::Mesh<T>& mesh,
+                             const std::filesystem::path& dir)
+{
+  DOLFINX_LOG_INFO("Write mesh snapshot ({})", dir.string());
+  MPI_Comm comm = mesh.comm();
+  const int rank = dolfinx::MPI::rank(comm);
+
+  const mesh::Topology& topology = *mesh.topology();
+  const mesh::Geometry<T>& geometry = mesh.geometry();
+  const int tdim = topology.dim();
+  if (topology.entity_types(tdim).size() != 1)
+  {
+    throw std::runtime_error(
+        "Mesh snapshots of mixed-topology meshes are not supported.");
+  }
+
+  // Index maps, with maps that are shared (e.g. by the topology and the
+  // geometry) stored once
+  std::vector<std::shared_ptr<const common::IndexMap>> maps;
+  auto map_id = [&maps](std::shared_ptr<const common::IndexMap> map)
+  {
+    if (!map)
+      return std::int64_t(-1);
+    auto it = std::ranges::find(maps, map);
+    if (it == maps.end())
+      it = maps.insert(maps.end(), map);
+    return std::int64_t(std::distance(maps.begin(), it));
+  };
+  std::vector<std::int64_t> topology_maps;
+  for (int d = 0; d <= tdim; ++d)
+    topology_maps.push_back(map_id(topology.index_map(d)));
+  const std::int64_t geometry_map = map_id(geometry.index_map());
+  std::vector<std::int32_t> local_sizes;
+  for (auto& map : maps)
+    local_sizes.push_back(map->size_local());
+
+  const fem::CoordinateElement<T>& cmap = geometry.cmap();
+  const std::vector<std::int64_t> meta
+      = {dolfinx::MPI::size(comm),
+         rank,
+         sizeof(T),
+         tdim,
+         geometry.dim(),
+         static_cast<std::int64_t>(topology.cell_type()),
+         cmap.degree(),
+         static_cast<std::int64_t>(cmap.variant()),
+         static_cast<std::int64_t>(maps.size()),
+         geometry_map,
+         topology.has_entity_permutations()};
+  const std::vector<char> name(mesh.name.begin(), mesh.name.end());
+
+  // Computed connectivities
+  std::vector<std::int8_t> has_connectivity;
+  std::vector<std::shared_ptr<const graph::AdjacencyList<std::int32_t>>>
+      connectivities;
+  for (int d0 = 0; d0 <= tdim; ++d0)
+  {
+    for (int d1 = 0; d1 <= tdim; ++d1)
+    {
+      auto c = topology.connectivity(d0, d1);
+      has_connectivity.push_back(c != nullptr);
+      if (c)
+        connectivities.push_back(c);
+    }
+  }
+
+  const std::vector<std::int64_t> no_index;
+  const std::vector<std::int64_t>& original_cell_index
+      = topology.original_cell_index.empty()
+            ? no_index
+            : topology.original_cell_index.front();
+
+  const std::vector<std::uint8_t> no_facet_permutations;
+  const std::vector<std::uint32_t> no_cell_permutations;
+  const bool has_permutations = topology.has_entity_permutations();
+
+  auto x_dofmap = geometry.dofmap();
+
+  Writer writer;
+  writer.add(meta);
+  writer.add(topology_maps);
+  writer.add(name);
+  writer.add(local_sizes);
+  for (auto& map : maps)
+  {
+    writer.add(map->src());
+    writer.add(map->dest());
+    writer.add(map->ghosts());
+    writer.add(map->owners());
+  }
+  writer.add(has_connectivity);
+  for (auto& c : connectivities)
+  {
+    writer.add(c->offsets());
+    writer.add(c->array());
+  }
+  writer.add(original_cell_index);
+  writer.add(has_permutations ? topology.get_facet_permutations()
+                              : no_facet_permutations);
+  writer.add(has_permutations ? topology.get_cell_permutation_info()
+                              : no_cell_permutations);
+  writer.add(topology.interprocess_facets());
+  writer.add(
+      std::span<const std::int32_t>(x_dofmap.data_handle(), x_dofmap.size()));
+  writer.add(geometry.x());
+  writer.add(geometry.input_global_indices());
+
+  if (rank == 0)
+    std::filesystem::create_directories(dir);
+  MPI_Barrier(comm);
+  writer.write(rank_file(dir, rank));
+  MPI_Barrier(comm);
+}
+//-----------------------------------------------------------------------------
+template <std::floating_point T>
+mesh::Mesh<T> io::read_mesh_snapshot(MPI_Comm comm,
+                                     const std::filesystem::path& dir)
+{
+  DOLFINX_LOG_INFO("Read mesh snapshot ({})", dir.string());
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  Reader reader(rank_file(dir, rank));
+  const std::vector meta = reader.next<std::int64_t>();
+  if (meta.size() != 11 or meta[1] != rank)
+    throw std::runtime_error("Invalid mesh snapshot.");
+  if (meta[0] != size)
+  {
+    throw std::runtime_error("Mesh snapshot was written on "
+                             + std::to_string(meta[0])
+                             + " processes and must be read on the same "
+                               "number of processes.");
+  }
+  if (meta[2] != sizeof(T))
+  {
+    throw std::runtime_error(
+        "Mesh snapshot geometry has a different floating point type.");
+  }
+  const int tdim = meta[3];
+  const int gdim = meta[4];
+  const auto cell_type = static_cast<mesh::CellType>(meta[5]);
+  const int degree = meta[6];
+  const auto variant = static_cast<basix::element::lagrange_variant>(meta[7]);
+  const std::int64_t geometry_map = meta[9];
+  const bool has_permutations = meta[10];
+
+  const std::vector topology_maps = reader.next<std::int64_t>();
+  const std::vector name = reader.next<char>();
+
+  // Index maps, created from the stored neighbourhoods so that no
+  // communication (other than in creating their communicators) is
+  // needed
+  const std::vector local_sizes = reader.next<std::int32_t>();
+  if (local_sizes.size() != std::size_t(meta[8]))
+    throw std::runtime_error("Invalid mesh snapshot.");
+  std::vector<std::shared_ptr<const common::IndexMap>> maps;
+  for (std::int32_t local_size : local_sizes)
+  {
+    std::vector src = reader.next<int>();
+    std::vector dest = reader.next<int>();
+    std::vector ghosts = reader.next<std::int64_t>();
+    std::vector owners = reader.next<int>();
+    maps.push_back(std::make_shared<common::IndexMap>(
+        comm, local_size,
+        std::array<std::vector<int>, 2>{std::move(src), std::move(dest)},
+        ghosts, owners));
+  }
+
+  // Topology
+  auto topology = std::make_shared<mesh::Topology>(comm, cell_type);
+  if (topology->dim() != tdim or topology_maps.size() != std::size_t(tdim + 1))
+    throw std::runtime_error("Invalid mesh snapshot.");
+  for (int d = 0; d <= tdim; ++d)
+  {
+    if (topology_maps[d] >= 0)
+      topology->set_index_map(d, maps.at(topology_maps[d]));
+  }
+  const std::vector has_connectivity = reader.next<std::int8_t>();
+  if (has_connectivity.size() != std::size_t((tdim + 1) * (tdim + 1)))
+    throw std::runtime_error("Invalid mesh snapshot.");
+  for (int d0 = 0; d0 <= tdim; ++d0)
+  {
+    for (int d1 = 0; d1 <= tdim; ++d1)
+    {
+      if (has_connectivity[d0 * (tdim + 1) + d1])
+      {
+        std::vector offsets = reader.next<std::int32_t>();
+        std::vector array = reader.next<std::int32_t>();
+        topology->set_connectivity(
+            std::make_shared<graph::AdjacencyList<std::int32_t>>(
+                std::move(array), std::move(offsets)),
+            d0, d1);
+      }
+    }
+  }
+  topology->original_cell_index = {reader.next<std::int64_t>()};
+  std::vector facet_permutations = reader.next<std::uint8_t>();
+  std::vector cell_permutations = reader.next<std::uint32_t>();
+  if (has_permutations)
+  {
+    topology->set_entity_permutations(std::move(facet_permutations),
+                                      std::move(cell_permutations));
+  }
+  std::vector interprocess_facets = reader.next<std::int32_t>();
+  if (tdim > 0 and topology->index_map(tdim - 1))
+    topology->set_interprocess_facets(0, std::move(interprocess_facets));
+
+  // Geometry
+  std::vector x_dofmap = reader.next<std::int32_t>();
+  std::vector x = reader.next<T>();
+  std::vector input_global_indices = reader.next<std::int64_t>();
+  fem::CoordinateElement<T> cmap(cell_type, degree, variant);
+  mesh::Geometry<T> geometry(maps.at(geometry_map), std::move(x_dofmap), cmap,
+                             std::move(x), gdim,
+                             std::move(input_global_indices));
+
+  mesh::Mesh<T> mesh(comm, topology, std::move(geometry));
+  mesh.name = std::string(name.begin(), name.end());
+  return mesh;
+}
+//-----------------------------------------------------------------------------
+/// @cond
+template void io::write_mesh_snapshot(const mesh::Mesh<float>&,
+                                      const std::filesystem::path&);
+template void io::write_mesh_snapshot(const mesh::Mesh<double>&,
+                                      const std::filesystem::path&);
+template mesh::Mesh<float>
+io::read_mesh_snapshot(MPI_Comm, const std::filesystem::path&);
+template mesh::Mesh<double>
+io::read_mesh_snapshot(MPI_Comm, const std::filesystem::path&);
+/// @endcond
+//-----------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <concepts>
+#include <dolfinx/common/MPI.h>
+#include <filesystem>
+
+namespace dolfinx::mesh
+{
+template <std::floating_point T>
+class Mesh;
+}
+
+namespace dolfinx::io
+{
+/// @brief Write a snapshot of a mesh, as it is distributed and set up
+/// on each process.
+///
+/// A snapshot stores the data held by the mesh topology and geometry on
+/// each process: the index maps, all computed connectivities, the
+/// entity permutations, the inter-process facets, the original cell
+/// indices, the geometry dofmap, coordinates and input global indices.
+/// Reading a snapshot with read_mesh_snapshot restores the mesh without
+/// partitioning, building the topology or computing entities,
+/// connectivities or permutations. Snapshots are intended for many
+/// short runs on the same mesh, and are not portable: they must be read
+/// on the same number of processes and on a machine with the same byte
+/// order.
+///
+/// The snapshot is a directory with one file per process. Each file
+/// consists of a table of contents followed by the arrays, each aligned
+/// to 64 bytes, so that it can be memory mapped and the arrays copied
+/// directly into the mesh data structures.
+///
+/// @note Collective.
+/// @note Only meshes with a single cell type are supported.
+/// @param[in] mesh The mesh.
+/// @param[in] dir Directory to write the snapshot to. It is created if
+/// it does not exist.
+template <std::floating_point T>
+void write_mesh_snapshot(const mesh::Mesh<T>& mesh,
+                         const std::filesystem::path& dir);
+
+/// @brief Read a mesh from a snapshot written by write_mesh_snapshot.
+///
+/// Each process maps its file into memory and creates the mesh data
+/// structures from the arrays. The only communication is the creation
+/// of the communicators of the mesh and its index maps.
+///
+/// @note Collective.
+/// @param[in] comm MPI communicator. It must have the same size as the
+/// communicator of the mesh that was written.
+/// @param[in] dir Directory of the snapshot.
+/// @return The mesh.
+template <std::floating_point T>
+mesh::Mesh<T> read_mesh_snapshot(MPI_Comm comm,
+                                 const std::filesystem::path& dir);
+
+} // namespace dolfinx::io
@@ -6,6 +6,7 @@
 
 #include "vtk_utils.h"
 #include "cells.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -36,10 +37,17 @@ io::extract_vtk_connectivity(
   const std::size_t num_cells = dofmap_x.extent(0);
 
   // Build mesh connectivity
-
-  // Loop over cells
   std::array<std::size_t, 2> shape = {num_cells, num_nodes};
   std::vector<std::int64_t> topology(shape[0] * shape[1]);
+
+  // The DOLFINx and VTK orderings are the same for some cell types
+  if (io::cells::is_identity(vtkmap))
+  {
+    std::copy_n(dofmap_x.data_handle(), topology.size(), topology.begin());
+    return {std::move(topology), shape};
+  }
+
+  // Loop over cells
   for (std::size_t c = 0; c < num_cells; ++c)
   {
     // For each cell, get the 'nodes' and place in VTK order
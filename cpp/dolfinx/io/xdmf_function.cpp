@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "xdmf_function.h"
+#include "vtk_utils.h"
 #include "xdmf_mesh.h"
 #include "xdmf_utils.h"
 #include <basix/mdspan.hpp>
@@ -41,13 +42,118 @@ std::string shape_to_string(std::span<const std::size_t> shape)
 }
 } // namespace
 
+//-----------------------------------------------------------------------------
+template <std::floating_point U>
+bool xdmf_function::has_mesh_layout(const fem::FunctionSpace<U>& V)
+{
+  std::shared_ptr<const fem::FiniteElement<U>> element = V.element();
+  assert(element);
+  const int cell_dim = element->space_dimension() / element->block_size();
+  if (cell_dim == 1)
+    return true;
+
+  assert(V.mesh());
+  const fem::CoordinateElement<U>& cmap = V.mesh()->geometry().cmap();
+  assert(V.dofmap());
+  if (cmap.dim() != cell_dim
+      or V.dofmap()->element_dof_layout() != cmap.create_dof_layout())
+  {
+    return false;
+  }
+
+  return cmap.degree() <= 2
+         or element->basix_element().lagrange_variant() == cmap.variant();
+}
+//-----------------------------------------------------------------------------
+template <std::floating_point U>
+void xdmf_function::add_dof_mesh(MPI_Comm comm, const fem::FunctionSpace<U>& V,
+                                 pugi::xml_node& xml_node, hid_t h5_id,
+                                 std::string path_prefix,
+                                 const hdf5::DatasetOptions& options)
+{
+  DOLFINX_LOG_INFO("Adding dof mesh to node \"{}\"", xml_node.path('/'));
+
+  assert(V.element());
+  if (!V.element()->interpolation_ident())
+  {
+    throw std::runtime_error("Only Lagrange functions are supported. "
+                             "Interpolate Functions before output.");
+  }
+
+  auto mesh = V.mesh();
+  assert(mesh);
+  auto topology = mesh->topology();
+  assert(topology);
+  auto map_c = topology->index_map(topology->dim());
+  assert(map_c);
+  auto map_dofs = V.dofmap()->index_map;
+  assert(map_dofs);
+
+  // Dof coordinates and the VTK-ordered dofs of each cell. Owned cells
+  // come first.
+  const auto [x, xshape, x_id, x_ghost, cells, cshape]
+      = io::vtk_mesh_from_space(V);
+  const std::int32_t num_cells = map_c->size_local();
+  const int num_nodes = cshape[1];
+
+  const bool use_mpi_io = dolfinx::MPI::size(comm) > 1;
+
+  // Topology, with the global indices of the dofs
+  {
+    std::vector<std::int64_t> topology_data(num_cells * num_nodes);
+    std::transform(cells.begin(),
+                   std::next(cells.begin(), topology_data.size()),
+                   topology_data.begin(), [&x_id](auto d) { return x_id[d]; });
+
+    pugi::xml_node topology_node = xml_node.append_child("Topology");
+    assert(topology_node);
+    topology_node.append_attribute("TopologyType")
+        = xdmf_utils::vtk_cell_type_str(topology->cell_type(), num_nodes)
+              .c_str();
+    const std::int64_t num_cells_global = map_c->size_global();
+    topology_node.append_attribute("NumberOfElements")
+        = std::to_string(num_cells_global).c_str();
+    topology_node.append_attribute("NodesPerElement") = num_nodes;
+
+    const std::int64_t offset = map_c->local_range()[0];
+    xdmf_utils::add_data_item(
+        topology_node, h5_id, path_prefix + std::string("/topology"),
+        std::span<const std::int64_t>(topology_data), offset,
+        {num_cells_global, num_nodes}, "Int", use_mpi_io, options);
+  }
+
+  // Geometry, with the coordinates of the owned dofs
+  {
+    const int gdim = mesh->geometry().dim();
+    const int width = (gdim == 1) ? 2 : gdim;
+    const std::int32_t num_dofs = map_dofs->size_local();
+    std::vector<U> geometry_data(num_dofs * width, 0);
+    for (std::int32_t i = 0; i < num_dofs; ++i)
+    {
+      std::copy_n(std::next(x.begin(), 3 * i), gdim,
+                  std::next(geometry_data.begin(), width * i));
+    }
+
+    pugi::xml_node geometry_node = xml_node.append_child("Geometry");
+    assert(geometry_node);
+    geometry_node.append_attribute("GeometryType")
+        = (gdim == 3) ? "XYZ" : "XY";
+
+    const std::int64_t offset = map_dofs->local_range()[0];
+    xdmf_utils::add_data_item(
+        geometry_node, h5_id, path_prefix + std::string("/geometry"),
+        std::span<const U>(geometry_data), offset,
+        {map_dofs->size_global(), width}, "", use_mpi_io, options);
+  }
+}
 //-----------------------------------------------------------------------------
 template <dolfinx::scalar T, std::floating_point U>
 void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
                                  double t, pugi::xml_node& xml_node,
-                                 hid_t h5_id)
+                                 hid_t h5_id,
+                                 const hdf5::DatasetOptions& options)
 {
-  spdlog::info("Adding function to node \"{}\"", xml_node.path('/'));
+  DOLFINX_LOG_INFO("Adding function to node \"{}\"", xml_node.path('/'));
 
   assert(u.function_space());
   auto mesh = u.function_space()->mesh();
@@ -90,7 +196,22 @@ void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
 
   const bool cell_centred
       = element->space_dimension() / element->block_size() == 1;
-  if (cell_centred)
+  const bool mesh_layout = has_mesh_layout(*u.function_space());
+  std::int64_t num_values = 0;
+  if (!mesh_layout)
+  {
+    // One value per owned dof, on the Grid of the dofs (see
+    // add_dof_mesh)
+    auto map_dofs = dofmap->index_map;
+    assert(map_dofs);
+    const std::int32_t num_dofs = map_dofs->size_local();
+    data_values.resize(num_dofs * num_components, 0);
+    for (std::int32_t i = 0; i < num_dofs; ++i)
+      for (int j = 0; j < bs; ++j)
+        data_values[num_components * i + j] = x[bs * i + j];
+    num_values = map_dofs->size_global();
+  }
+  else if (cell_centred)
   {
     // Get dof array and pack into array (padded where appropriate)
     const std::int32_t num_local_cells = map_c->size_local();
@@ -106,31 +227,7 @@ void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
   }
   else
   {
-    // Get number of geometry nodes per cell
     const auto& geometry = mesh->geometry();
-    auto& cmap = geometry.cmap();
-    int cmap_dim = cmap.dim();
-    int cell_dim = element->space_dimension() / element->block_size();
-    if (cmap_dim != cell_dim)
-    {
-      throw std::runtime_error(
-          "Degree of output Function must be same as mesh degree. Maybe the "
-          "Function needs to be interpolated?");
-    }
-
-    // Check that dofmap layouts are equal and check Lagrange variants
-    if (dofmap->element_dof_layout() != cmap.create_dof_layout())
-    {
-      throw std::runtime_error("Function and Mesh dof layouts do not match. "
-                               "Maybe the Function needs to be interpolated?");
-    }
-    if (cmap.degree() > 2
-        and element->basix_element().lagrange_variant() != cmap.variant())
-    {
-      throw std::runtime_error("Mis-match in Lagrange family. Maybe the "
-                               "Function needs to be interpolated?");
-    }
-
     std::int32_t num_cells = map_c->size_local() + map_c->num_ghosts();
     std::int32_t num_local_points = map_x->size_local();
 
@@ -155,8 +252,8 @@ void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
   }
 
   // Global size
-  const std::int64_t num_values
-      = cell_centred ? map_c->size_global() : map_x->size_global();
+  if (mesh_layout)
+    num_values = cell_centred ? map_c->size_global() : map_x->size_global();
 
   const std::int64_t num_local = data_values.size() / num_components;
   std::int64_t offset = 0;
@@ -181,7 +278,8 @@ void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
     attr_node.append_attribute("Name") = attr_name.c_str();
     attr_node.append_attribute("AttributeType")
         = shape_to_string(value_shape).c_str();
-    attr_node.append_attribute("Center") = cell_centred ? "Cell" : "Node";
+    attr_node.append_attribute("Center")
+        = (mesh_layout and cell_centred) ? "Cell" : "Node";
 
     std::span<const scalar_value_type_t<T>> u;
     std::vector<scalar_value_type_t<T>> _data;
@@ -206,26 +304,41 @@ void xdmf_function::add_function(MPI_Comm comm, const fem::Function<T, U>& u,
 
     // -- Real case, add data item
     xdmf_utils::add_data_item(attr_node, h5_id, dataset_name, u, offset,
-                              {num_values, num_components}, "", use_mpi_io);
+                              {num_values, num_components}, "", use_mpi_io,
+                              options);
   }
 }
 //-----------------------------------------------------------------------------
 // Instantiation for different types
 /// @cond
+template bool xdmf_function::has_mesh_layout(const fem::FunctionSpace<float>&);
+template bool xdmf_function::has_mesh_layout(const fem::FunctionSpace<double>&);
+template void xdmf_function::add_dof_mesh(MPI_Comm,
+                                          const fem::FunctionSpace<float>&,
+                                          pugi::xml_node&, hid_t, std::string,
+                                          const hdf5::DatasetOptions&);
+template void xdmf_function::add_dof_mesh(MPI_Comm,
+                                          const fem::FunctionSpace<double>&,
+                                          pugi::xml_node&, hid_t, std::string,
+                                          const hdf5::DatasetOptions&);
 template void xdmf_function::add_function(MPI_Comm,
                                           const fem::Function<float, float>&,
-                                          double, pugi::xml_node&, hid_t);
+                                          double, pugi::xml_node&, hid_t,
+                                          const hdf5::DatasetOptions&);
 template void xdmf_function::add_function(MPI_Comm,
                                           const fem::Function<double, double>&,
-                                          double, pugi::xml_node&, hid_t);
+                                          double, pugi::xml_node&, hid_t,
+                                          const hdf5::DatasetOptions&);
 template void
 xdmf_function::add_function(MPI_Comm,
                             const fem::Function<std::complex<float>, float>&,
-                            double, pugi::xml_node&, hid_t);
+                            double, pugi::xml_node&, hid_t,
+                            const hdf5::DatasetOptions&);
 template void
 xdmf_function::add_function(MPI_Comm,
                             const fem::Function<std::complex<double>, double>&,
-                            double, pugi::xml_node&, hid_t);
+                            double, pugi::xml_node&, hid_t,
+                            const hdf5::DatasetOptions&);
 
 /// @endcond
 //-----------------------------------------------------------------------------
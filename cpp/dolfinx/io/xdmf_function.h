@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include "HDF5Interface.h"
 #include <complex>
 #include <concepts>
 #include <dolfinx/common/types.h>
 #include <hdf5.h>
 #include <mpi.h>
+#include <string>
 
 namespace pugi
 {
@@ -23,15 +25,47 @@ namespace fem
 {
 template <dolfinx::scalar T, std::floating_point U>
 class Function;
-}
+template <std::floating_point T>
+class FunctionSpace;
+} // namespace fem
 
 /// Low-level methods for reading/writing XDMF files
 namespace io::xdmf_function
 {
 
-/// Write a fem::Function to XDMF
+/// @brief Check if the values of a Function on a space can be
+/// attached to the Grid of its mesh.
+///
+/// This is the case for lowest-order (P0) discontinuous Lagrange
+/// spaces, which are written at cell centres, and for Lagrange spaces
+/// whose dofs are the nodes of the mesh geometry.
+template <std::floating_point U>
+bool has_mesh_layout(const fem::FunctionSpace<U>& V);
+
+/// @brief Add Topology and Geometry nodes for the dofs of a Lagrange
+/// space.
+///
+/// The Geometry holds the coordinates of the owned dofs and the
+/// Topology the dofs of each owned cell, using the XDMF cell type of
+/// the degree of the space, so that a Function on the space can be
+/// written with one value per dof. Used for spaces that do not have
+/// the mesh layout (see has_mesh_layout).
+template <std::floating_point U>
+void add_dof_mesh(MPI_Comm comm, const fem::FunctionSpace<U>& V,
+                  pugi::xml_node& xml_node, const hid_t h5_id,
+                  std::string path_prefix,
+                  const hdf5::DatasetOptions& options = {});
+
+/// @brief Write a fem::Function to XDMF, creating the HDF5 datasets
+/// with `options`.
+///
+/// If the space of `u` has the mesh layout (see has_mesh_layout), the
+/// values are attached to the mesh Grid. Otherwise one value per owned
+/// dof is written, and `xml_node` must refer to the Grid created by
+/// add_dof_mesh.
 template <dolfinx::scalar T, std::floating_point U>
 void add_function(MPI_Comm comm, const fem::Function<T, U>& u, double t,
-                  pugi::xml_node& xml_node, const hid_t h5_id);
+                  pugi::xml_node& xml_node, const hid_t h5_id,
+                  const hdf5::DatasetOptions& options = {});
 } // namespace io::xdmf_function
 } // namespace dolfinx
@@ -7,26 +7,72 @@
 #include "xdmf_mesh.h"
 #include "cells.h"
 #include "xdmf_utils.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <optional>
 #include <pugixml.hpp>
 #include <vector>
 
 using namespace dolfinx;
 using namespace dolfinx::io;
 
+namespace
+{
+/// Read the rows of a HDF5 DataItem that belong to this process in
+/// blocks of at most `buffer_size` bytes. Each block is transformed
+/// into its position in the returned array by `f(block, out)`, where
+/// `block` and `out` have the same size. Returns an empty optional if
+/// `buffer_size` is zero or the DataItem is not stored as a HDF5
+/// dataset with the shape of the DataItem.
+template <typename T, typename F>
+std::optional<std::vector<T>> read_blocks(MPI_Comm comm,
+                                          const pugi::xml_node& data_node,
+                                          hid_t h5_id, std::size_t buffer_size,
+                                          F f)
+{
+  pugi::xml_attribute format = data_node.attribute("Format");
+  if (buffer_size == 0 or !format or std::string(format.as_string()) != "HDF")
+    return std::nullopt;
+
+  std::array<std::string, 2> paths = xdmf_utils::get_hdf5_paths(data_node);
+  const std::vector shape = hdf5::get_dataset_shape(h5_id, paths[1]);
+  if (shape.empty() or shape != xdmf_utils::get_dataset_shape(data_node))
+    return std::nullopt;
+
+  const std::size_t row_size = std::reduce(
+      std::next(shape.begin()), shape.end(), 1, std::multiplies{});
+  const std::array<std::int64_t, 2> range = dolfinx::MPI::local_range(
+      dolfinx::MPI::rank(comm), shape[0], dolfinx::MPI::size(comm));
+  std::vector<T> data((range[1] - range[0]) * row_size);
+
+  hid_t dset_id = hdf5::open_dataset(h5_id, paths[1]);
+  if (dset_id == H5I_INVALID_HID)
+    throw std::runtime_error("Failed to open HDF5 global dataset.");
+  hdf5::read_dataset_blocks<T>(
+      dset_id, range, buffer_size,
+      [&data, &f, row_size](std::span<const T> block, std::int64_t row)
+      { f(block, std::span(data).subspan(row * row_size, block.size())); });
+  if (herr_t err = H5Dclose(dset_id); err < 0)
+    throw std::runtime_error("Failed to close HDF5 global dataset.");
+
+  return data;
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 template <std::floating_point U>
 void xdmf_mesh::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, std::string path_prefix,
                                   const mesh::Topology& topology,
                                   const mesh::Geometry<U>& geometry, int dim,
-                                  std::span<const std::int32_t> entities)
+                                  std::span<const std::int32_t> entities,
+                                  const hdf5::DatasetOptions& options)
 {
-  spdlog::info("Adding topology data to node {}", xml_node.path('/'));
+  DOLFINX_LOG_INFO("Adding topology data to node {}", xml_node.path('/'));
 
   const int tdim = topology.dim();
 
@@ -153,15 +199,17 @@ void xdmf_mesh::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
   xdmf_utils::add_data_item(topology_node, h5_id, h5_path,
                             std::span<const std::int64_t>(topology_data),
-                            offset, shape, number_type, use_mpi_io);
+                            offset, shape, number_type, use_mpi_io,
+                            options);
 }
 //-----------------------------------------------------------------------------
 template <std::floating_point U>
 void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, std::string path_prefix,
-                                  const mesh::Geometry<U>& geometry)
+                                  const mesh::Geometry<U>& geometry,
+                                  const hdf5::DatasetOptions& options)
 {
-  spdlog::info("Adding geometry data to node \"{}\"", xml_node.path('/'));
+  DOLFINX_LOG_INFO("Adding geometry data to node \"{}\"", xml_node.path('/'));
   auto map = geometry.index_map();
   assert(map);
 
@@ -207,14 +255,15 @@ void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
   xdmf_utils::add_data_item(geometry_node, h5_id, h5_path,
                             std::span<const U>(x), offset, shape, "",
-                            use_mpi_io);
+                            use_mpi_io, options);
 }
 //----------------------------------------------------------------------------
 template <std::floating_point U>
 void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
-                         const mesh::Mesh<U>& mesh, const std::string& name)
+                         const mesh::Mesh<U>& mesh, const std::string& name,
+                         bool partition, const hdf5::DatasetOptions& options)
 {
-  spdlog::info("Adding mesh to node \"{}\"", xml_node.path('/'));
+  DOLFINX_LOG_INFO("Adding mesh to node \"{}\"", xml_node.path('/'));
 
   // Add grid node and attributes
   pugi::xml_node grid_node = xml_node.append_child("Grid");
@@ -236,23 +285,51 @@ void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
 
   add_topology_data(comm, grid_node, h5_id, path_prefix, *mesh.topology(),
                     mesh.geometry(), tdim,
-                    std::span<std::int32_t>(cells.data(), num_cells));
+                    std::span<std::int32_t>(cells.data(), num_cells),
+                    options);
 
   // Add geometry node and attributes (including writing data)
-  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry());
+  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry(),
+                    options);
+
+  if (partition)
+  {
+    // Add owning rank of each cell
+    pugi::xml_node attribute_node = grid_node.append_child("Attribute");
+    assert(attribute_node);
+    attribute_node.append_attribute("Name") = "partition";
+    attribute_node.append_attribute("AttributeType") = "Scalar";
+    attribute_node.append_attribute("Center") = "Cell";
+
+    const int rank = dolfinx::MPI::rank(comm);
+    const int size = dolfinx::MPI::size(comm);
+    const std::vector<std::int32_t> owners(num_cells, rank);
+    const bool use_mpi_io = size > 1;
+    xdmf_utils::add_data_item(
+        attribute_node, h5_id, path_prefix + std::string("/partition"),
+        std::span<const std::int32_t>(owners), map->local_range()[0],
+        {map->size_global(), 1}, "", use_mpi_io, options);
+
+    pugi::xml_node info_node = grid_node.append_child("Information");
+    assert(info_node);
+    info_node.append_attribute("Name") = "num_partitions";
+    info_node.append_attribute("Value") = std::to_string(size).c_str();
+  }
 }
 /// @cond
 template void xdmf_mesh::add_mesh(MPI_Comm, pugi::xml_node&, hid_t,
-                                  const mesh::Mesh<float>&, const std::string&);
+                                  const mesh::Mesh<float>&, const std::string&,
+                                  bool, const hdf5::DatasetOptions&);
 template void xdmf_mesh::add_mesh(MPI_Comm, pugi::xml_node&, hid_t,
-                                  const mesh::Mesh<double>&,
-                                  const std::string&);
+                                  const mesh::Mesh<double>&, const std::string&,
+                                  bool, const hdf5::DatasetOptions&);
 /// @endcond
 //----------------------------------------------------------------------------
 std::pair<std::variant<std::vector<float>, std::vector<double>>,
           std::array<std::size_t, 2>>
 xdmf_mesh::read_geometry_data(MPI_Comm comm, hid_t h5_id,
-                              const pugi::xml_node& node)
+                              const pugi::xml_node& node,
+                              std::size_t buffer_size)
 {
   // Get geometry node
   pugi::xml_node geometry_node = node.child("Geometry");
@@ -283,8 +360,18 @@ xdmf_mesh::read_geometry_data(MPI_Comm comm, hid_t h5_id,
   assert(gdims[1] == (int)gdim);
 
   // Read geometry data
-  std::vector geometry_data
-      = xdmf_utils::get_dataset<double>(comm, geometry_data_node, h5_id);
+  std::vector<double> geometry_data;
+  if (auto x = read_blocks<double>(
+          comm, geometry_data_node, h5_id, buffer_size,
+          [](auto block, auto out) { std::ranges::copy(block, out.begin()); }))
+  {
+    geometry_data = std::move(*x);
+  }
+  else
+  {
+    geometry_data
+        = xdmf_utils::get_dataset<double>(comm, geometry_data_node, h5_id);
+  }
   const std::size_t num_local_nodes = geometry_data.size() / gdim;
   std::array<std::size_t, 2> shape = {num_local_nodes, gdim};
   return {std::move(geometry_data), shape};
@@ -292,7 +379,8 @@ xdmf_mesh::read_geometry_data(MPI_Comm comm, hid_t h5_id,
 //----------------------------------------------------------------------------
 std::pair<std::vector<std::int64_t>, std::array<std::size_t, 2>>
 xdmf_mesh::read_topology_data(MPI_Comm comm, hid_t h5_id,
-                              const pugi::xml_node& node)
+                              const pugi::xml_node& node,
+                              std::size_t buffer_size)
 {
   // Get topology node
   pugi::xml_node topology_node = node.child("Topology");
@@ -311,6 +399,28 @@ xdmf_mesh::read_topology_data(MPI_Comm comm, hid_t h5_id,
   const std::vector tdims = xdmf_utils::get_dataset_shape(topology_data_node);
   const std::size_t npoint_per_cell = tdims[1];
 
+  // Read topology data in blocks, permuting each block from VTK to
+  // DOLFINx ordering as it is read
+  const std::vector<std::uint16_t> perm
+      = io::cells::perm_vtk(cell_type, npoint_per_cell);
+  if (auto cells = read_blocks<std::int64_t>(
+          comm, topology_data_node, h5_id, buffer_size,
+          [&perm, npoint_per_cell](std::span<const std::int64_t> block,
+                                   std::span<std::int64_t> out)
+          {
+            for (std::size_t c = 0; c < block.size() / npoint_per_cell; ++c)
+            {
+              auto in_c = block.subspan(c * npoint_per_cell, npoint_per_cell);
+              for (std::size_t i = 0; i < npoint_per_cell; ++i)
+                out[c * npoint_per_cell + i] = in_c[perm[i]];
+            }
+          }))
+  {
+    std::array<std::size_t, 2> shape
+        = {cells->size() / npoint_per_cell, npoint_per_cell};
+    return {std::move(*cells), shape};
+  }
+
   // Read topology data
   std::vector<std::int64_t> topology_data
       = xdmf_utils::get_dataset<std::int64_t>(comm, topology_data_node, h5_id);
@@ -318,8 +428,25 @@ xdmf_mesh::read_topology_data(MPI_Comm comm, hid_t h5_id,
 
   //  Permute cells from VTK to DOLFINx ordering
   std::array<std::size_t, 2> shape = {num_local_cells, npoint_per_cell};
-  std::vector<std::int64_t> cells = io::cells::apply_permutation(
-      topology_data, shape, io::cells::perm_vtk(cell_type, shape[1]));
-  return {std::move(cells), shape};
+  io::cells::apply_permutation_inplace(topology_data, npoint_per_cell, perm);
+  return {std::move(topology_data), shape};
+}
+//----------------------------------------------------------------------------
+std::pair<std::vector<std::int32_t>, int>
+xdmf_mesh::read_partition(MPI_Comm comm, hid_t h5_id,
+                          const pugi::xml_node& node)
+{
+  pugi::xml_node info_node
+      = node.select_node("Information[@Name='num_partitions']").node();
+  pugi::xml_node data_node = node.select_node("Attribute[@Name='partition']")
+                                 .node()
+                                 .child("DataItem");
+  if (!info_node or !data_node)
+    return {std::vector<std::int32_t>(), 0};
+
+  // The rows are distributed as for read_topology_data
+  std::vector<std::int32_t> owners
+      = xdmf_utils::get_dataset<std::int32_t>(comm, data_node, h5_id);
+  return {std::move(owners), info_node.attribute("Value").as_int()};
 }
 //----------------------------------------------------------------------------
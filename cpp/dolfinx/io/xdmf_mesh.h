@@ -46,10 +46,16 @@ namespace io::xdmf_mesh
 /// Add Mesh to xml node
 ///
 /// Creates new Grid with Topology and Geometry xml nodes for mesh. In
-/// HDF file data is stored under path prefix.
+/// HDF file data is stored under path prefix. If `partition` is true,
+/// the owning rank of each cell is added as a cell Attribute named
+/// `partition`, and the number of ranks as an Information node named
+/// `num_partitions`. See read_partition. The HDF5 datasets are created
+/// with `options`.
 template <std::floating_point U>
 void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
-              const mesh::Mesh<U>& mesh, const std::string& path_prefix);
+              const mesh::Mesh<U>& mesh, const std::string& path_prefix,
+              bool partition = false,
+              const hdf5::DatasetOptions& options = {});
 
 /// Add Topology xml node
 /// @param[in] comm
@@ -61,44 +67,66 @@ void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
 /// @param[in] cell_dim Dimension of mesh entities to save
 /// @param[in] entities Local-to-process indices of mesh entities
 /// whose topology will be saved. This is used to save subsets of Mesh.
+/// @param[in] options HDF5 dataset creation options
 template <std::floating_point U>
 void add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
                        std::string path_prefix, const mesh::Topology& topology,
                        const mesh::Geometry<U>& geometry, int cell_dim,
-                       std::span<const std::int32_t> entities);
+                       std::span<const std::int32_t> entities,
+                       const hdf5::DatasetOptions& options = {});
 
 /// Add Geometry xml node
 template <std::floating_point U>
 void add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node, hid_t h5_id,
                        std::string path_prefix,
-                       const mesh::Geometry<U>& geometry);
+                       const mesh::Geometry<U>& geometry,
+                       const hdf5::DatasetOptions& options = {});
 
 /// @brief Read geometry (coordinate) data.
 ///
+/// @param[in] buffer_size If greater than zero, the maximum size
+/// (bytes) of the transient buffer used to read blocks of HDF5 data. If
+/// zero, the data of this process is read in one block.
 /// @returns The coordinates of each 'node'. The returned data is (0) an
 /// array holding the coordinates (row-major storage) and (1) the shape
 /// of the coordinate array. The shape is `(num_nodes, geometric
 /// dimension)`.
 std::pair<std::variant<std::vector<float>, std::vector<double>>,
           std::array<std::size_t, 2>>
-read_geometry_data(MPI_Comm comm, hid_t h5_id, const pugi::xml_node& node);
+read_geometry_data(MPI_Comm comm, hid_t h5_id, const pugi::xml_node& node,
+                   std::size_t buffer_size = 0);
 
 /// @brief Read topology (cell connectivity) data.
 ///
+/// @param[in] buffer_size If greater than zero, the maximum size
+/// (bytes) of the transient buffer used to read blocks of HDF5 data.
+/// Each block is permuted into the returned array as it is read, so
+/// that the complete topology data of the process is not held twice.
 /// @returns Mesh topology in DOLFINx ordering, where data row `i` lists
 /// the 'nodes' of cell `i`. The returned data is (0) an array holding
 /// the topology data (row-major storage) and (1) the shape of the
 /// topology array. The shape is `(num_cells, num_nodes_per_cell)`
 std::pair<std::vector<std::int64_t>, std::array<std::size_t, 2>>
-read_topology_data(MPI_Comm comm, hid_t h5_id, const pugi::xml_node& node);
+read_topology_data(MPI_Comm comm, hid_t h5_id, const pugi::xml_node& node,
+                   std::size_t buffer_size = 0);
+
+/// @brief Read the cell partition stored by add_mesh.
+///
+/// @returns (0) The owning rank of each cell returned by
+/// read_topology_data on this process, and (1) the number of ranks the
+/// mesh was partitioned across. If the Grid has no stored partition,
+/// the owners are empty and the number of ranks is zero.
+std::pair<std::vector<std::int32_t>, int>
+read_partition(MPI_Comm comm, hid_t h5_id, const pugi::xml_node& node);
 
 /// Add mesh tags to XDMF file
 template <typename T, std::floating_point U>
 void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
                   const mesh::Geometry<U>& geometry, pugi::xml_node& xml_node,
-                  hid_t h5_id, const std::string& name)
+                  hid_t h5_id, const std::string& name,
+                  const hdf5::DatasetOptions& options = {})
 {
-  spdlog::info("XDMF: add meshtags ({})", name.c_str());
+  DOLFINX_LOG_INFO("XDMF: add meshtags ({})", name.c_str());
   // Get mesh
   const int dim = meshtags.dim();
   std::shared_ptr<const common::IndexMap> entity_map
@@ -118,7 +146,8 @@ void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
   xdmf_mesh::add_topology_data(
       comm, xml_node, h5_id, path_prefix, *meshtags.topology(), geometry, dim,
       std::span<const std::int32_t>(meshtags.indices().data(),
-                                    num_active_entities));
+                                    num_active_entities),
+      options);
 
   // Add attribute node with values
   pugi::xml_node attribute_node = xml_node.append_child("Attribute");
@@ -138,7 +167,7 @@ void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
   xdmf_utils::add_data_item(
       attribute_node, h5_id, path_prefix + std::string("/Values"),
       std::span<const T>(meshtags.values().data(), num_active_entities), offset,
-      {global_num_values, 1}, "", use_mpi_io);
+      {global_num_values, 1}, "", use_mpi_io, options);
 }
 } // namespace io::xdmf_mesh
 } // namespace dolfinx
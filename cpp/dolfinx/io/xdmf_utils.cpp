@@ -25,6 +25,7 @@
 #include <map>
 #include <pugixml.hpp>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 using namespace dolfinx;
@@ -228,7 +229,7 @@ xdmf_utils::distribute_entity_data(
     std::span<const T> data)
 {
   assert(entities.extent(0) == data.size());
-  spdlog::info("XDMF distribute entity data");
+  DOLFINX_LOG_INFO("XDMF distribute entity data");
   mesh::CellType cell_type = topology.cell_type();
 
   // Get layout of dofs on 0th cell entity of dimension entity_dim
@@ -282,359 +283,265 @@ xdmf_utils::distribute_entity_data(
   mdspan_t<const std::int64_t, 2> entities_v(entities_v_b.data(), shapev);
 
   MPI_Comm comm = topology.comm();
-  MPI_Datatype compound_type;
-  MPI_Type_contiguous(entities_v.extent(1), MPI_INT64_T, &compound_type);
-  MPI_Type_commit(&compound_type);
-
-  // -- B. Send entities and entity data to postmaster
-  auto send_entities_to_postmaster
-      = [](MPI_Comm comm, MPI_Datatype compound_type, std::int64_t num_nodes_g,
-           auto entities, std::span<const T> data)
+  const int size = dolfinx::MPI::size(comm);
+  const std::size_t num_vert_per_e = entities_v.extent(1);
+
+  // -- B. Build list of (input global index, local vertex) pairs for the
+  // vertices of the local cells, sorted by the input index. Only
+  // vertex nodes can appear in the vertex entities, so the other
+  // geometry nodes are not needed.
+  auto c_to_v = topology.connectivity(topology.dim(), 0);
+  if (!c_to_v)
+    throw std::runtime_error("Missing cell-vertex connectivity.");
+  std::vector<std::pair<std::int64_t, std::int32_t>> vertex_nodes;
+  vertex_nodes.reserve(c_to_v->array().size());
+  for (int c = 0; c < c_to_v->num_nodes(); ++c)
   {
-    const int size = dolfinx::MPI::size(comm);
-
-    // Determine destination by index of first vertex
-    std::vector<int> dest0;
-    for (std::size_t e = 0; e < entities.extent(0); ++e)
+    auto vertices = c_to_v->links(c);
+    for (std::size_t v = 0; v < vertices.size(); ++v)
     {
-      dest0.push_back(
-          dolfinx::MPI::index_owner(size, entities(e, 0), num_nodes_g));
-    }
-    std::vector<int> perm(dest0.size());
-    std::iota(perm.begin(), perm.end(), 0);
-    std::ranges::sort(perm, [&dest0](auto x0, auto x1)
-                      { return dest0[x0] < dest0[x1]; });
-
-    // Note: dest[perm[i]] is ordered with increasing i
-    // Build list of neighbour dest ranks and count number of entities to
-    // send to each post office
-    std::vector<int> dest;
-    std::vector<std::int32_t> num_items_send;
-    {
-      auto it = perm.begin();
-      while (it != perm.end())
-      {
-        dest.push_back(dest0[*it]);
-        auto it1
-            = std::find_if(it, perm.end(), [&dest0, r = dest.back()](auto idx)
-                           { return dest0[idx] != r; });
-        num_items_send.push_back(std::distance(it, it1));
-        it = it1;
-      }
+      vertex_nodes.emplace_back(nodes_g[xdofmap(c, cell_vertex_dofs[v])],
+                                vertices[v]);
     }
+  }
+  std::ranges::sort(vertex_nodes);
+  {
+    auto [it0, it1] = std::ranges::unique(vertex_nodes);
+    vertex_nodes.erase(it0, it1);
+  }
 
-    // Compute send displacements
-    std::vector<int> send_disp(num_items_send.size() + 1, 0);
-    std::partial_sum(num_items_send.begin(), num_items_send.end(),
-                     std::next(send_disp.begin()));
-
-    // Determine src ranks. Sort ranks so that ownership determination is
-    // deterministic for a given number of ranks.
-    std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
-    std::ranges::sort(src);
-
-    // Create neighbourhood communicator for sending data to post
-    // offices
-    MPI_Comm comm0;
-    int err = MPI_Dist_graph_create_adjacent(
-        comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
-        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    // Send number of items to post offices (destinations)
-    std::vector<int> num_items_recv(src.size());
-    num_items_send.reserve(1);
-    num_items_recv.reserve(1);
-    MPI_Neighbor_alltoall(num_items_send.data(), 1, MPI_INT,
-                          num_items_recv.data(), 1, MPI_INT, comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    // Compute receive displacements
-    std::vector<int> recv_disp(num_items_recv.size() + 1, 0);
-    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                     std::next(recv_disp.begin()));
-
-    // Prepare send buffer
-    std::vector<std::int64_t> send_buffer;
-    std::vector<T> send_values_buffer;
-    send_buffer.reserve(entities.size());
-    send_values_buffer.reserve(data.size());
-    for (std::size_t e = 0; e < entities.extent(0); ++e)
+  // -- C. Send entities (by first vertex) and entity data, and the
+  // input indices of the local vertices, to the post offices. The
+  // entities and the vertices are sent in one exchange over one
+  // neighbourhood, which is also used (reversed) to send the entities
+  // back from the post offices.
+  std::vector<int> dest_e(entities_v.extent(0));
+  for (std::size_t e = 0; e < entities_v.extent(0); ++e)
+    dest_e[e] = dolfinx::MPI::index_owner(size, entities_v(e, 0), num_nodes_g);
+  std::vector<int> dest_v(vertex_nodes.size());
+  std::ranges::transform(vertex_nodes, dest_v.begin(),
+                         [size, num_nodes_g](auto x) {
+                           return dolfinx::MPI::index_owner(size, x.first,
+                                                            num_nodes_g);
+                         });
+
+  // Build list of neighbour dest ranks (post offices)
+  std::vector<int> dest(dest_e);
+  dest.insert(dest.end(), dest_v.begin(), dest_v.end());
+  {
+    std::ranges::sort(dest);
+    auto [it0, it1] = std::ranges::unique(dest);
+    dest.erase(it0, it1);
+  }
+
+  // Map from rank to position in the neighbourhood
+  auto nbr = [&dest](int r)
+  { return std::distance(dest.begin(), std::ranges::lower_bound(dest, r)); };
+  std::ranges::transform(dest_e, dest_e.begin(), nbr);
+  std::ranges::transform(dest_v, dest_v.begin(), nbr);
+
+  // Determine src ranks. Sort ranks so that ownership determination is
+  // deterministic for a given number of ranks.
+  std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+  std::ranges::sort(src);
+
+  // Create neighbourhood communicators for sending data to post offices
+  // (forward) and from post offices (reverse)
+  MPI_Comm comm_fwd, comm_rev;
+  int err = MPI_Dist_graph_create_adjacent(
+      comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
+      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm_fwd);
+  dolfinx::MPI::check_error(comm, err);
+  err = MPI_Dist_graph_create_adjacent(
+      comm, dest.size(), dest.data(), MPI_UNWEIGHTED, src.size(), src.data(),
+      MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm_rev);
+  dolfinx::MPI::check_error(comm, err);
+
+  // Send number of entities and number of vertices to post offices
+  std::vector<int> num_send(2 * dest.size(), 0);
+  for (auto p : dest_e)
+    ++num_send[2 * p];
+  for (auto p : dest_v)
+    ++num_send[2 * p + 1];
+  std::vector<int> num_recv(2 * src.size());
+  num_send.reserve(1);
+  num_recv.reserve(1);
+  err = MPI_Neighbor_alltoall(num_send.data(), 2, MPI_INT, num_recv.data(), 2,
+                              MPI_INT, comm_fwd);
+  dolfinx::MPI::check_error(comm, err);
+
+  // Compute send and receive sizes and displacements. For each
+  // neighbour, the message holds the entities followed by the vertex
+  // input indices.
+  auto sizes = [num_vert_per_e](std::span<const int> num)
+  {
+    std::vector<int> size_i(num.size() / 2), size_v(num.size() / 2);
+    for (std::size_t i = 0; i < size_i.size(); ++i)
     {
-      auto idx = perm[e];
-      auto it = std::next(entities.data_handle(), idx * entities.extent(1));
-      send_buffer.insert(send_buffer.end(), it, it + entities.extent(1));
-      send_values_buffer.push_back(data[idx]);
+      size_i[i] = num_vert_per_e * num[2 * i] + num[2 * i + 1];
+      size_v[i] = num[2 * i];
     }
-
-    std::vector<std::int64_t> recv_buffer(recv_disp.back()
-                                          * entities.extent(1));
-    err = MPI_Neighbor_alltoallv(send_buffer.data(), num_items_send.data(),
-                                 send_disp.data(), compound_type,
-                                 recv_buffer.data(), num_items_recv.data(),
-                                 recv_disp.data(), compound_type, comm0);
-    dolfinx::MPI::check_error(comm, err);
-    std::vector<T> recv_values_buffer(recv_disp.back());
-    err = MPI_Neighbor_alltoallv(
-        send_values_buffer.data(), num_items_send.data(), send_disp.data(),
-        dolfinx::MPI::mpi_type<T>(), recv_values_buffer.data(),
-        num_items_recv.data(), recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
-        comm0);
-    dolfinx::MPI::check_error(comm, err);
-    err = MPI_Comm_free(&comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    std::array shape{recv_buffer.size() / (entities.extent(1)),
-                     (entities.extent(1))};
-    return std::tuple<std::vector<std::int64_t>, std::vector<T>,
-                      std::array<std::size_t, 2>>(
-        std::move(recv_buffer), std::move(recv_values_buffer), shape);
+    std::vector<int> disp_i(size_i.size() + 1, 0), disp_v(size_v.size() + 1, 0);
+    std::partial_sum(size_i.begin(), size_i.end(), std::next(disp_i.begin()));
+    std::partial_sum(size_v.begin(), size_v.end(), std::next(disp_v.begin()));
+    return std::tuple(std::move(size_i), std::move(disp_i), std::move(size_v),
+                      std::move(disp_v));
   };
-  const auto [entitiesp_b, entitiesp_v, shapep] = send_entities_to_postmaster(
-      comm, compound_type, num_nodes_g, entities_v, data);
-  mdspan_t<const std::int64_t, 2> entitiesp(entitiesp_b.data(), shapep);
+  auto [send_sizes, send_disp, send_sizes_v, send_disp_v] = sizes(num_send);
+  auto [recv_sizes, recv_disp, recv_sizes_v, recv_disp_v] = sizes(num_recv);
 
-  // -- C. Send mesh global indices to postmaster
-  auto indices_to_postoffice = [](MPI_Comm comm, std::int64_t num_nodes,
-                                  std::span<const std::int64_t> indices)
+  // Pack send buffers
+  std::vector<std::int64_t> send_buffer(send_disp.back());
+  std::vector<T> send_values(send_disp_v.back());
   {
-    int size = dolfinx::MPI::size(comm);
-    std::vector<std::pair<int, std::int64_t>> dest_to_index;
-    std::ranges::transform(
-        indices, std::back_inserter(dest_to_index),
-        [size, num_nodes](auto n) {
-          return std::pair(dolfinx::MPI::index_owner(size, n, num_nodes), n);
-        });
-    std::ranges::sort(dest_to_index);
-
-    // Build list of neighbour dest ranks and count number of indices to
-    // send to each post office
-    std::vector<int> dest;
-    std::vector<std::int32_t> num_items_send;
+    std::vector<int> pos_e(send_disp.begin(), std::prev(send_disp.end()));
+    std::vector<int> pos_v(dest.size());
+    for (std::size_t i = 0; i < dest.size(); ++i)
+      pos_v[i] = send_disp[i] + num_vert_per_e * num_send[2 * i];
+    std::vector<int> pos_d(send_disp_v.begin(), std::prev(send_disp_v.end()));
+    for (std::size_t e = 0; e < entities_v.extent(0); ++e)
     {
-      auto it = dest_to_index.begin();
-      while (it != dest_to_index.end())
-      {
-        dest.push_back(it->first);
-        auto it1
-            = std::find_if(it, dest_to_index.end(), [r = dest.back()](auto idx)
-                           { return idx.first != r; });
-        num_items_send.push_back(std::distance(it, it1));
-        it = it1;
-      }
+      int p = dest_e[e];
+      for (std::size_t i = 0; i < num_vert_per_e; ++i)
+        send_buffer[pos_e[p]++] = entities_v(e, i);
+      send_values[pos_d[p]++] = data[e];
     }
+    for (std::size_t i = 0; i < vertex_nodes.size(); ++i)
+      send_buffer[pos_v[dest_v[i]]++] = vertex_nodes[i].first;
+  }
 
-    // Compute send displacements
-    std::vector<int> send_disp(num_items_send.size() + 1, 0);
-    std::partial_sum(num_items_send.begin(), num_items_send.end(),
-                     std::next(send_disp.begin()));
-
-    // Determine src ranks. Sort ranks so that ownership determination is
-    // deterministic for a given number of ranks.
-    std::vector<int> src = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
-    std::ranges::sort(src);
-
-    // Create neighbourhood communicator for sending data to post offices
-    MPI_Comm comm0;
-    int err = MPI_Dist_graph_create_adjacent(
-        comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
-        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    // Send number of items to post offices (destination) that I will be
-    // sending
-    std::vector<int> num_items_recv(src.size());
-    num_items_send.reserve(1);
-    num_items_recv.reserve(1);
-    MPI_Neighbor_alltoall(num_items_send.data(), 1, MPI_INT,
-                          num_items_recv.data(), 1, MPI_INT, comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    // Compute receive displacements
-    std::vector<int> recv_disp(num_items_recv.size() + 1, 0);
-    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                     std::next(recv_disp.begin()));
-
-    // Prepare send buffer
-    std::vector<std::int64_t> send_buffer;
-    send_buffer.reserve(indices.size());
-    std::ranges::transform(dest_to_index, std::back_inserter(send_buffer),
-                           [](auto x) { return x.second; });
-
-    std::vector<std::int64_t> recv_buffer(recv_disp.back());
-    err = MPI_Neighbor_alltoallv(send_buffer.data(), num_items_send.data(),
-                                 send_disp.data(), MPI_INT64_T,
-                                 recv_buffer.data(), num_items_recv.data(),
-                                 recv_disp.data(), MPI_INT64_T, comm0);
-    dolfinx::MPI::check_error(comm, err);
-    err = MPI_Comm_free(&comm0);
-    dolfinx::MPI::check_error(comm, err);
-    return std::tuple(std::move(recv_buffer), std::move(recv_disp),
-                      std::move(src), std::move(dest));
-  };
-  const auto [nodes_g_p, recv_disp, src, dest]
-      = indices_to_postoffice(comm, num_nodes_g, nodes_g);
-
-  // D. Send entities to possible owners, based on first entity index
-  auto candidate_ranks
-      = [](MPI_Comm comm, MPI_Datatype compound_type,
-           std::span<const std::int64_t> indices_recv,
-           std::span<const int> indices_recv_disp, std::span<const int> src,
-           std::span<const int> dest, auto entities, std::span<const T> data)
+  std::vector<std::int64_t> recv_buffer(recv_disp.back());
+  err = MPI_Neighbor_alltoallv(send_buffer.data(), send_sizes.data(),
+                               send_disp.data(), MPI_INT64_T,
+                               recv_buffer.data(), recv_sizes.data(),
+                               recv_disp.data(), MPI_INT64_T, comm_fwd);
+  dolfinx::MPI::check_error(comm, err);
+  std::vector<T> recv_values(recv_disp_v.back());
+  err = MPI_Neighbor_alltoallv(
+      send_values.data(), send_sizes_v.data(), send_disp_v.data(),
+      dolfinx::MPI::mpi_type<T>(), recv_values.data(), recv_sizes_v.data(),
+      recv_disp_v.data(), dolfinx::MPI::mpi_type<T>(), comm_fwd);
+  dolfinx::MPI::check_error(comm, err);
+
+  // -- D. Post office: send entities to possible owners, i.e. the ranks
+  // that have the first vertex of the entity
+  std::vector<std::pair<std::int64_t, int>> node_to_rank;
+  for (std::size_t i = 0; i < src.size(); ++i)
   {
-    // Build map from received global node indices to neighbourhood
-    // ranks that have the node
-    std::multimap<std::int64_t, int> node_to_rank;
-    for (std::size_t i = 0; i < indices_recv_disp.size() - 1; ++i)
-      for (int j = indices_recv_disp[i]; j < indices_recv_disp[i + 1]; ++j)
-        node_to_rank.insert({indices_recv[j], i});
-
-    std::vector<std::vector<std::int64_t>> send_data(dest.size());
-    std::vector<std::vector<T>> send_values(dest.size());
-    for (std::size_t e = 0; e < entities.extent(0); ++e)
+    auto v0 = std::next(recv_buffer.begin(),
+                        recv_disp[i] + num_vert_per_e * num_recv[2 * i]);
+    auto v1 = std::next(recv_buffer.begin(), recv_disp[i + 1]);
+    for (auto it = v0; it != v1; ++it)
+      node_to_rank.emplace_back(*it, i);
+  }
+  std::ranges::sort(node_to_rank);
+
+  // Apply function to each (received entity, candidate rank) pair
+  auto for_each_candidate = [&](auto&& f)
+  {
+    for (std::size_t i = 0; i < src.size(); ++i)
     {
-      std::span e_recv(entities.data_handle() + e * entities.extent(1),
-                       entities.extent(1));
-      auto [it0, it1] = node_to_rank.equal_range(entities(e, 0));
-      for (auto it = it0; it != it1; ++it)
+      for (int e = 0; e < num_recv[2 * i]; ++e)
       {
-        int p = it->second;
-        send_data[p].insert(send_data[p].end(), e_recv.begin(), e_recv.end());
-        send_values[p].push_back(data[e]);
+        std::span entity(recv_buffer.data() + recv_disp[i]
+                             + e * num_vert_per_e,
+                         num_vert_per_e);
+        auto [it0, it1] = std::ranges::equal_range(
+            node_to_rank, entity.front(), std::ranges::less(),
+            [](auto x) { return x.first; });
+        for (auto it = it0; it != it1; ++it)
+          f(it->second, entity, recv_values[recv_disp_v[i] + e]);
       }
     }
-
-    MPI_Comm comm0;
-    int err = MPI_Dist_graph_create_adjacent(
-        comm, src.size(), src.data(), MPI_UNWEIGHTED, dest.size(), dest.data(),
-        MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    std::vector<int> num_items_send;
-    for (auto& x : send_data)
-      num_items_send.push_back(x.size() / entities.extent(1));
-
-    std::vector<int> num_items_recv(src.size());
-    num_items_send.reserve(1);
-    num_items_recv.reserve(1);
-    err = MPI_Neighbor_alltoall(num_items_send.data(), 1, MPI_INT,
-                                num_items_recv.data(), 1, MPI_INT, comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    // Compute send displacements
-    std::vector<std::int32_t> send_disp(num_items_send.size() + 1, 0);
-    std::partial_sum(num_items_send.begin(), num_items_send.end(),
-                     std::next(send_disp.begin()));
-
-    // Compute receive displacements
-    std::vector<std::int32_t> recv_disp(num_items_recv.size() + 1, 0);
-    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                     std::next(recv_disp.begin()));
-
-    // Prepare send buffers
-    std::vector<std::int64_t> send_buffer;
-    std::vector<T> send_values_buffer;
-    for (auto& x : send_data)
-      send_buffer.insert(send_buffer.end(), x.begin(), x.end());
-    for (auto& v : send_values)
-      send_values_buffer.insert(send_values_buffer.end(), v.begin(), v.end());
-    std::vector<std::int64_t> recv_buffer(entities.extent(1)
-                                          * recv_disp.back());
-    err = MPI_Neighbor_alltoallv(send_buffer.data(), num_items_send.data(),
-                                 send_disp.data(), compound_type,
-                                 recv_buffer.data(), num_items_recv.data(),
-                                 recv_disp.data(), compound_type, comm0);
-
-    dolfinx::MPI::check_error(comm, err);
-
-    std::vector<T> recv_values_buffer(recv_disp.back());
-    err = MPI_Neighbor_alltoallv(
-        send_values_buffer.data(), num_items_send.data(), send_disp.data(),
-        dolfinx::MPI::mpi_type<T>(), recv_values_buffer.data(),
-        num_items_recv.data(), recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
-        comm0);
-
-    dolfinx::MPI::check_error(comm, err);
-
-    err = MPI_Comm_free(&comm0);
-    dolfinx::MPI::check_error(comm, err);
-
-    std::array shape{recv_buffer.size() / entities.extent(1),
-                     entities.extent(1)};
-    return std::tuple<std::vector<std::int64_t>, std::vector<T>,
-                      std::array<std::size_t, 2>>(
-        std::move(recv_buffer), std::move(recv_values_buffer), shape);
   };
-  // NOTE: src and dest are transposed here because we're reversing the
-  // direction of communication
-  const auto [entities_data_b, entities_values, shape_eb]
-      = candidate_ranks(comm, compound_type, nodes_g_p, recv_disp, dest, src,
-                        entitiesp, std::span(entitiesp_v));
-  mdspan_t<const std::int64_t, 2> entities_data(entities_data_b.data(),
-                                                shape_eb);
 
-  // -- E. From the received (key, value) data, determine which keys
-  //    (entities) are on this process.
-  //
-  // TODO: We have already received possibly tagged entities from other
-  //       ranks, so we could use the received data to avoid creating
-  //       the std::map for *all* entities and just for candidate
-  //       entities.
-  auto select_entities
-      = [](const mesh::Topology& topology, auto xdofmap,
-           std::span<const std::int64_t> nodes_g,
-           std::span<const int> cell_vertex_dofs, auto entities_data,
-           std::span<const T> entities_values)
+  std::vector<int> num_send1(src.size(), 0);
+  for_each_candidate([&num_send1](int p, auto, auto) { ++num_send1[p]; });
+  std::vector<int> num_recv1(dest.size());
+  num_send1.reserve(1);
+  num_recv1.reserve(1);
+  err = MPI_Neighbor_alltoall(num_send1.data(), 1, MPI_INT, num_recv1.data(), 1,
+                              MPI_INT, comm_rev);
+  dolfinx::MPI::check_error(comm, err);
+
+  std::vector<int> send_disp1(src.size() + 1, 0);
+  std::partial_sum(num_send1.begin(), num_send1.end(),
+                   std::next(send_disp1.begin()));
+  std::vector<int> recv_disp1(dest.size() + 1, 0);
+  std::partial_sum(num_recv1.begin(), num_recv1.end(),
+                   std::next(recv_disp1.begin()));
+
+  std::vector<std::int64_t> send_buffer1(num_vert_per_e * send_disp1.back());
+  std::vector<T> send_values1(send_disp1.back());
   {
-    spdlog::info("XDMF build map");
-    auto c_to_v = topology.connectivity(topology.dim(), 0);
-    if (!c_to_v)
-      throw std::runtime_error("Missing cell-vertex connectivity.");
+    std::vector<int> pos(send_disp1.begin(), std::prev(send_disp1.end()));
+    for_each_candidate(
+        [&](int p, auto entity, T value)
+        {
+          std::ranges::copy(entity,
+                            std::next(send_buffer1.begin(),
+                                      pos[p] * num_vert_per_e));
+          send_values1[pos[p]++] = value;
+        });
+  }
 
-    std::map<std::int64_t, std::int32_t> input_idx_to_vertex;
-    for (int c = 0; c < c_to_v->num_nodes(); ++c)
-    {
-      auto vertices = c_to_v->links(c);
-      std::span xdofs(xdofmap.data_handle() + c * xdofmap.extent(1),
-                      xdofmap.extent(1));
-      for (std::size_t v = 0; v < vertices.size(); ++v)
-        input_idx_to_vertex[nodes_g[xdofs[cell_vertex_dofs[v]]]] = vertices[v];
-    }
+  MPI_Datatype compound_type;
+  MPI_Type_contiguous(num_vert_per_e, MPI_INT64_T, &compound_type);
+  MPI_Type_commit(&compound_type);
+  std::vector<std::int64_t> entities_data(num_vert_per_e * recv_disp1.back());
+  err = MPI_Neighbor_alltoallv(send_buffer1.data(), num_send1.data(),
+                               send_disp1.data(), compound_type,
+                               entities_data.data(), num_recv1.data(),
+                               recv_disp1.data(), compound_type, comm_rev);
+  dolfinx::MPI::check_error(comm, err);
+  MPI_Type_free(&compound_type);
+  std::vector<T> entities_values(recv_disp1.back());
+  err = MPI_Neighbor_alltoallv(
+      send_values1.data(), num_send1.data(), send_disp1.data(),
+      dolfinx::MPI::mpi_type<T>(), entities_values.data(), num_recv1.data(),
+      recv_disp1.data(), dolfinx::MPI::mpi_type<T>(), comm_rev);
+  dolfinx::MPI::check_error(comm, err);
+
+  err = MPI_Comm_free(&comm_fwd);
+  dolfinx::MPI::check_error(comm, err);
+  err = MPI_Comm_free(&comm_rev);
+  dolfinx::MPI::check_error(comm, err);
 
-    std::vector<std::int32_t> entities;
-    std::vector<T> data;
-    std::vector<std::int32_t> entity(entities_data.extent(1));
-    for (std::size_t e = 0; e < entities_data.extent(0); ++e)
+  // -- E. From the received (key, value) data, determine which keys
+  //    (entities) are on this process. The input index to vertex map
+  //    is a hash map built from the (unique) vertex nodes.
+  DOLFINX_LOG_INFO("XDMF build map");
+  std::unordered_map<std::int64_t, std::int32_t> input_idx_to_vertex(
+      vertex_nodes.begin(), vertex_nodes.end());
+  std::vector<std::int32_t> entities_new;
+  std::vector<T> data_new;
+  std::vector<std::int32_t> entity(num_vert_per_e);
+  for (std::size_t e = 0; e < entities_values.size(); ++e)
+  {
+    bool entity_found = true;
+    for (std::size_t i = 0; i < num_vert_per_e; ++i)
     {
-      bool entity_found = true;
-      for (std::size_t i = 0; i < entities_data.extent(1); ++i)
-      {
-        if (auto it = input_idx_to_vertex.find(entities_data(e, i));
-            it == input_idx_to_vertex.end())
-        {
-          // As soon as this received index is not in locally owned
-          // input global indices skip the entire entity
-          entity_found = false;
-          break;
-        }
-        else
-          entity[i] = it->second;
-      }
-
-      if (entity_found)
+      if (auto it = input_idx_to_vertex.find(
+              entities_data[e * num_vert_per_e + i]);
+          it == input_idx_to_vertex.end())
       {
-        entities.insert(entities.end(), entity.begin(), entity.end());
-        data.push_back(entities_values[e]);
+        // As soon as this received index is not in locally owned
+        // input global indices skip the entire entity
+        entity_found = false;
+        break;
       }
+      else
+        entity[i] = it->second;
     }
 
-    return std::pair(std::move(entities), std::move(data));
-  };
-
-  MPI_Type_free(&compound_type);
+    if (entity_found)
+    {
+      entities_new.insert(entities_new.end(), entity.begin(), entity.end());
+      data_new.push_back(entities_values[e]);
+    }
+  }
 
-  return select_entities(topology, xdofmap, nodes_g, cell_vertex_dofs,
-                         entities_data, std::span(entities_values));
+  return {std::move(entities_new), std::move(data_new)};
 }
 //-----------------------------------------------------------------------------
 /// @cond
@@ -124,7 +124,8 @@ template <typename T>
 void add_data_item(pugi::xml_node& xml_node, hid_t h5_id,
                    const std::string& h5_path, std::span<const T> x,
                    std::int64_t offset, const std::vector<std::int64_t>& shape,
-                   const std::string& number_type, bool use_mpi_io)
+                   const std::string& number_type, bool use_mpi_io,
+                   const hdf5::DatasetOptions& options = {})
 {
   // Add DataItem node
   assert(xml_node);
@@ -179,7 +180,7 @@ void add_data_item(pugi::xml_node& xml_node, hid_t h5_id,
 
     const std::array local_range{offset, offset + local_shape0};
     io::hdf5::write_dataset(h5_id, h5_path, x.data(), local_range, shape,
-                            use_mpi_io, false);
+                            use_mpi_io, options);
 
     // Add partitioning attribute to dataset
     // std::vector<std::size_t> partitions;
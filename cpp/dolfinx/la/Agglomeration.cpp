@@ -0,0 +1,63 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "Agglomeration.h"
+#include <numeric>
+#include <stdexcept>
+
+using namespace dolfinx;
+
+//-----------------------------------------------------------------------------
+la::Agglomeration::Agglomeration(std::shared_ptr<const common::IndexMap> map,
+                                 int size)
+    : _map(map), _size(size), _group_comm(MPI_COMM_NULL, false),
+      _comm(MPI_COMM_NULL, false)
+{
+  assert(map);
+  MPI_Comm comm = map->comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const int comm_size = dolfinx::MPI::size(comm);
+  if (size < 1 or size > comm_size)
+    throw std::runtime_error("Invalid size of the sub-communicator.");
+
+  // Groups of consecutive ranks, with the first rank as the leader
+  const int g = group(rank);
+  const bool leader = dolfinx::MPI::local_range(g, comm_size, size)[0] == rank;
+  MPI_Comm group_comm;
+  int err = MPI_Comm_split(comm, g, rank, &group_comm);
+  dolfinx::MPI::check_error(comm, err);
+  _group_comm = dolfinx::MPI::Comm(group_comm, false);
+
+  MPI_Comm sub_comm;
+  err = MPI_Comm_split(comm, leader ? 0 : MPI_UNDEFINED, rank, &sub_comm);
+  dolfinx::MPI::check_error(comm, err);
+  _comm = dolfinx::MPI::Comm(sub_comm, false);
+
+  // Number of owned indices of each process of the group
+  const int local_size = map->size_local();
+  if (leader)
+    _counts.resize(dolfinx::MPI::size(group_comm));
+  err = MPI_Gather(&local_size, 1, MPI_INT, _counts.data(), 1, MPI_INT, 0,
+                   group_comm);
+  dolfinx::MPI::check_error(comm, err);
+
+  if (leader)
+  {
+    _offsets.resize(_counts.size() + 1, 0);
+    std::partial_sum(_counts.begin(), _counts.end(),
+                     std::next(_offsets.begin()));
+    _agglomerated_map
+        = std::make_shared<common::IndexMap>(sub_comm, _offsets.back());
+    assert(_agglomerated_map->local_range()[0] == map->local_range()[0]);
+  }
+}
+//-----------------------------------------------------------------------------
+int la::Agglomeration::group(int rank) const
+{
+  return dolfinx::MPI::index_owner(_size, rank,
+                                   dolfinx::MPI::size(_map->comm()));
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,279 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "SparsityPattern.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::la
+{
+/// @brief Agglomeration of distributed vectors and matrices onto fewer
+/// processes, e.g. for the coarse levels of multigrid.
+///
+/// The processes of the communicator of an index map are split into
+/// `size` groups of consecutive ranks. The first process of each group
+/// (the leader) owns, on the sub-communicator of the leaders, the
+/// indices owned by all processes of its group. The global numbering of
+/// the indices is unchanged, since the indices owned by consecutive
+/// ranks are contiguous.
+///
+/// gather() sends the owned entries of a vector to the leaders, e.g.
+/// to restrict a residual to a coarse problem on the sub-communicator,
+/// and scatter() sends them back, e.g. to prolongate the coarse
+/// solution. agglomerate() sends the owned rows of an assembled matrix
+/// to the leaders. Coarse problems with a few indices per process can
+/// then be solved on fewer processes, with less latency.
+///
+/// @note Only block size one is supported.
+class Agglomeration
+{
+public:
+  /// @brief Create the agglomeration of an index map.
+  /// @note Collective.
+  /// @param[in] map Index map of the distributed data.
+  /// @param[in] size Number of processes of the sub-communicator, at
+  /// most the size of the communicator of `map`.
+  Agglomeration(std::shared_ptr<const common::IndexMap> map, int size);
+
+  // Copy constructor (deleted)
+  Agglomeration(const Agglomeration&) = delete;
+
+  /// Move constructor
+  Agglomeration(Agglomeration&&) = default;
+
+  /// Destructor
+  ~Agglomeration() = default;
+
+  // Copy assignment (deleted)
+  Agglomeration& operator=(const Agglomeration&) = delete;
+
+  /// Move assignment
+  Agglomeration& operator=(Agglomeration&&) = default;
+
+  /// @brief Check if the caller is a process of the sub-communicator.
+  bool is_leader() const { return _comm.comm() != MPI_COMM_NULL; }
+
+  /// @brief The sub-communicator of the leaders.
+  /// @return The communicator on the leaders, and `MPI_COMM_NULL` on the
+  /// other processes.
+  MPI_Comm comm() const { return _comm.comm(); }
+
+  /// @brief The index map of the distributed data.
+  std::shared_ptr<const common::IndexMap> index_map() const { return _map; }
+
+  /// @brief The agglomerated index map (without ghosts) on the
+  /// sub-communicator.
+  /// @return The index map on the leaders, and `nullptr` on the other
+  /// processes.
+  std::shared_ptr<const common::IndexMap> agglomerated_index_map() const
+  {
+    return _agglomerated_map;
+  }
+
+  /// @brief Send the owned entries of a vector to the leaders.
+  /// @note Collective.
+  /// @param[in] x The owned entries, of size
+  /// `index_map()->size_local()`.
+  /// @param[out] y The owned entries on the sub-communicator, of size
+  /// `agglomerated_index_map()->size_local()` on the leaders and empty
+  /// on the other processes.
+  template <typename T>
+  void gather(std::span<const T> x, std::span<T> y) const
+  {
+    assert(x.size() >= std::size_t(_map->size_local()));
+    MPI_Gatherv(x.data(), _map->size_local(), dolfinx::MPI::mpi_type<T>(),
+                y.data(), _counts.data(), _offsets.data(),
+                dolfinx::MPI::mpi_type<T>(), 0, _group_comm.comm());
+  }
+
+  /// @brief Send the owned entries of a vector on the sub-communicator
+  /// back to the processes that own them, i.e. the inverse of gather().
+  /// @note Collective.
+  /// @param[in] y The owned entries on the sub-communicator (leaders).
+  /// @param[out] x The owned entries, of size
+  /// `index_map()->size_local()`.
+  template <typename T>
+  void scatter(std::span<const T> y, std::span<T> x) const
+  {
+    assert(x.size() >= std::size_t(_map->size_local()));
+    MPI_Scatterv(y.data(), _counts.data(), _offsets.data(),
+                 dolfinx::MPI::mpi_type<T>(), x.data(), _map->size_local(),
+                 dolfinx::MPI::mpi_type<T>(), 0, _group_comm.comm());
+  }
+
+  /// @brief Send the owned rows of a matrix to the leaders.
+  ///
+  /// The matrix must be assembled, i.e. the ghost rows must have been
+  /// sent to their owners (MatrixCSR::scatter_rev). The rows of the
+  /// agglomerated matrix are the indices of agglomerated_index_map(),
+  /// and its column index map has ghosts for the columns owned by other
+  /// groups.
+  ///
+  /// @note Collective.
+  /// @param[in] A Matrix whose row index map has the owned indices of
+  /// index_map(), with block size one.
+  /// @return The agglomerated matrix on the leaders, and `nullptr` on
+  /// the other processes.
+  template <typename T>
+  std::shared_ptr<MatrixCSR<T>> agglomerate(const MatrixCSR<T>& A) const
+  {
+    if (A.block_size() != std::array{1, 1})
+      throw std::runtime_error("Agglomeration requires block size one.");
+    if (A.num_owned_rows() != _map->size_local())
+      throw std::runtime_error("Matrix rows do not match the index map.");
+
+    // Owned rows with global column indices
+    const std::int32_t num_rows = A.num_owned_rows();
+    auto& row_ptr = A.row_ptr();
+    std::shared_ptr<const common::IndexMap> col_map = A.index_map(1);
+    std::vector<std::int32_t> row_sizes(num_rows);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+      row_sizes[i] = row_ptr[i + 1] - row_ptr[i];
+    const std::size_t nnz = row_ptr[num_rows];
+    std::vector<std::int64_t> cols(nnz);
+    col_map->local_to_global(std::span(A.cols().data(), nnz), cols);
+
+    // Ghost columns and the group of their owner, which is the owner on
+    // the sub-communicator
+    std::span<const std::int64_t> ghosts = col_map->ghosts();
+    std::vector<int> ghost_owners(ghosts.size());
+    std::ranges::transform(col_map->owners(), ghost_owners.begin(),
+                           [this](int r) { return group(r); });
+
+    std::vector<std::int32_t> all_row_sizes = gatherv(
+        std::span<const std::int32_t>(row_sizes), MPI_INT32_T);
+    std::vector<std::int64_t> all_cols
+        = gatherv(std::span<const std::int64_t>(cols), MPI_INT64_T);
+    std::vector<T> all_values = gatherv(
+        std::span<const T>(A.values().data(), nnz),
+        dolfinx::MPI::mpi_type<T>());
+    std::vector<std::int64_t> all_ghosts = gatherv(ghosts, MPI_INT64_T);
+    std::vector<int> all_owners
+        = gatherv(std::span<const int>(ghost_owners), MPI_INT);
+    if (!is_leader())
+      return nullptr;
+
+    // Columns that are not owned by the group, with their owners
+    std::array<std::int64_t, 2> range = _agglomerated_map->local_range();
+    std::vector<std::int64_t> off_group;
+    std::ranges::copy_if(all_cols, std::back_inserter(off_group),
+                         [range](auto c)
+                         { return c < range[0] or c >= range[1]; });
+    std::ranges::sort(off_group);
+    auto [last, end] = std::ranges::unique(off_group);
+    off_group.erase(last, end);
+
+    std::vector<std::int32_t> perm(all_ghosts.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    std::ranges::sort(perm, std::less<>{},
+                      [&all_ghosts](auto i) { return all_ghosts[i]; });
+    std::vector<int> owners(off_group.size());
+    for (std::size_t i = 0; i < off_group.size(); ++i)
+    {
+      auto it = std::ranges::lower_bound(
+          perm, off_group[i], std::less<>{},
+          [&all_ghosts](auto j) { return all_ghosts[j]; });
+      assert(it != perm.end() and all_ghosts[*it] == off_group[i]);
+      owners[i] = all_owners[*it];
+    }
+
+    auto map = std::make_shared<common::IndexMap>(
+        _comm.comm(), range[1] - range[0], off_group, owners);
+
+    // Sparsity pattern
+    SparsityPattern pattern(_comm.comm(), {map, map}, {1, 1});
+    std::vector<std::int32_t> local_cols(all_cols.size());
+    map->global_to_local(all_cols, local_cols);
+    std::int64_t offset = 0;
+    for (std::size_t i = 0; i < all_row_sizes.size(); ++i)
+    {
+      std::int32_t row = i;
+      pattern.insert(std::span(&row, 1),
+                     std::span(local_cols.data() + offset, all_row_sizes[i]));
+      offset += all_row_sizes[i];
+    }
+    pattern.finalize();
+
+    // Matrix, with the column indices of its own column map
+    auto Ac = std::make_shared<MatrixCSR<T>>(pattern);
+    Ac->index_map(1)->global_to_local(all_cols, local_cols);
+    offset = 0;
+    for (std::size_t i = 0; i < all_row_sizes.size(); ++i)
+    {
+      std::int32_t row = i;
+      for (std::int32_t j = 0; j < all_row_sizes[i]; ++j)
+      {
+        Ac->template add<1, 1>(
+            std::span<const T>(all_values.data() + offset + j, 1),
+            std::span(&row, 1), std::span(local_cols.data() + offset + j, 1));
+      }
+      offset += all_row_sizes[i];
+    }
+
+    return Ac;
+  }
+
+private:
+  // Group of a rank of the communicator of the index map
+  int group(int rank) const;
+
+  // Gather arrays of the processes of the group on the leader, in rank
+  // order. Returns an empty array on the other processes.
+  template <typename T>
+  std::vector<T> gatherv(std::span<const T> x, MPI_Datatype type) const
+  {
+    MPI_Comm comm = _group_comm.comm();
+    const int n = x.size();
+    std::vector<int> counts, offsets(1, 0);
+    if (is_leader())
+      counts.resize(dolfinx::MPI::size(comm));
+    MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+    std::partial_sum(counts.begin(), counts.end(),
+                     std::back_inserter(offsets));
+
+    std::vector<T> y(is_leader() ? offsets.back() : 0);
+    MPI_Gatherv(x.data(), n, type, y.data(), counts.data(), offsets.data(),
+                type, 0, comm);
+    return y;
+  }
+
+  // Index map of the distributed data
+  std::shared_ptr<const common::IndexMap> _map;
+
+  // Number of groups
+  int _size;
+
+  // Communicator of the processes of the group, with the leader as
+  // rank 0
+  dolfinx::MPI::Comm _group_comm;
+
+  // Sub-communicator of the leaders (MPI_COMM_NULL on the other
+  // processes)
+  dolfinx::MPI::Comm _comm;
+
+  // Number of owned indices of each process of the group, and their
+  // offsets (leaders only)
+  std::vector<int> _counts, _offsets;
+
+  // Agglomerated index map (leaders only)
+  std::shared_ptr<const common::IndexMap> _agglomerated_map;
+};
+} // namespace dolfinx::la
@@ -0,0 +1,241 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "SparsityPattern.h"
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/memory.h>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// @brief A matrix made of a grid of MatrixCSR blocks, e.g. for the
+/// fields of a multi-field (Stokes-type) problem.
+///
+/// Each block is a separate MatrixCSR, with the row index map of its
+/// block row and the column layout of its block column, so that a
+/// block can be assembled into, applied or passed to a field-split
+/// solver directly, without copying. Blocks may be empty (zero). The
+/// blocks of a block row share the row index map.
+///
+/// @tparam Matrix The matrix type of the blocks.
+template <typename Matrix = MatrixCSR<double>>
+class BlockMatrixCSR
+{
+public:
+  /// Scalar type
+  using value_type = typename Matrix::value_type;
+
+  /// Block type
+  using matrix_type = Matrix;
+
+  /// @brief Create a block matrix.
+  /// @param[in] patterns The finalised sparsity pattern of each block,
+  /// `patterns[i][j]` for block row `i` and block column `j`. A null
+  /// pointer denotes an empty block. Each block row and block column
+  /// must contain at least one non-empty block.
+  /// @param[in] mode Block mode of the blocks (see MatrixCSR).
+  BlockMatrixCSR(
+      const std::vector<std::vector<const SparsityPattern*>>& patterns,
+      BlockMode mode = BlockMode::compact)
+      : _shape({patterns.size(), patterns.empty() ? 0 : patterns[0].size()})
+  {
+    _blocks.reserve(_shape[0] * _shape[1]);
+    for (auto& row : patterns)
+    {
+      if (row.size() != _shape[1])
+        throw std::runtime_error("Block rows have different lengths.");
+      for (const SparsityPattern* p : row)
+      {
+        if (p)
+          _blocks.emplace_back(std::in_place, *p, mode);
+        else
+          _blocks.emplace_back();
+      }
+    }
+
+    // Row index maps must be shared by the blocks of a block row, and
+    // the blocks of a block column must have the same number of owned
+    // columns
+    _maps[0].resize(_shape[0]);
+    _maps[1].resize(_shape[1]);
+    for (std::size_t i = 0; i < _shape[0]; ++i)
+    {
+      for (std::size_t j = 0; j < _shape[1]; ++j)
+      {
+        if (!has_block(i, j))
+          continue;
+        const Matrix& A = block(i, j);
+        if (!_maps[0][i])
+          _maps[0][i] = A.index_map(0);
+        else if (_maps[0][i] != A.index_map(0))
+          throw std::runtime_error("Blocks in a row have different rows.");
+
+        if (!_maps[1][j])
+          _maps[1][j] = A.index_map(1);
+        else if (_maps[1][j]->size_local() != A.index_map(1)->size_local())
+        {
+          throw std::runtime_error(
+              "Blocks in a column have different columns.");
+        }
+      }
+    }
+
+    for (auto& maps : _maps)
+    {
+      if (std::ranges::any_of(maps, [](auto& m) { return !m; }))
+        throw std::runtime_error("Block row or column with no blocks.");
+    }
+  }
+
+  /// Move constructor
+  BlockMatrixCSR(BlockMatrixCSR&& A) = default;
+
+  /// @brief Number of block rows (0) or block columns (1).
+  std::size_t num_blocks(int dim) const { return _shape.at(dim); }
+
+  /// @brief Check if a block is non-empty.
+  bool has_block(std::size_t i, std::size_t j) const
+  {
+    return _blocks.at(i * _shape[1] + j).has_value();
+  }
+
+  /// @brief Access a block.
+  /// @param[in] i Block row.
+  /// @param[in] j Block column.
+  /// @return The matrix of the block. Throws if the block is empty.
+  Matrix& block(std::size_t i, std::size_t j)
+  {
+    std::optional<Matrix>& A = _blocks.at(i * _shape[1] + j);
+    if (!A)
+      throw std::runtime_error("Block is empty.");
+    return *A;
+  }
+
+  /// @brief Access a block (const version).
+  const Matrix& block(std::size_t i, std::size_t j) const
+  {
+    const std::optional<Matrix>& A = _blocks.at(i * _shape[1] + j);
+    if (!A)
+      throw std::runtime_error("Block is empty.");
+    return *A;
+  }
+
+  /// @brief Row index map of a block row (dim = 0) or column index map
+  /// of a block column (dim = 1).
+  ///
+  /// The column index map is that of the first non-empty block in the
+  /// column. The blocks of a column have the same owned columns but
+  /// may have different ghost columns.
+  std::shared_ptr<const common::IndexMap> index_map(int dim,
+                                                    std::size_t i) const
+  {
+    return _maps.at(dim).at(i);
+  }
+
+  /// @brief Set all non-zero local entries of the blocks to a value,
+  /// including entries in ghost rows.
+  void set(value_type x)
+  {
+    for (auto& A : _blocks)
+      if (A)
+        A->set(x);
+  }
+
+  /// @brief Transfer ghost row data of the blocks to the owning ranks,
+  /// accumulating the received values on the owned rows.
+  /// @note MPI Collective
+  void scatter_rev()
+  {
+    for (auto& A : _blocks)
+      if (A)
+        A->scatter_rev();
+  }
+
+  /// @brief Compute the block matrix-vector product `y = Ax`.
+  ///
+  /// The ghost values of the blocks of `x` are updated during the
+  /// product. Only the owned entries of `y` are computed.
+  ///
+  /// @note MPI Collective
+  /// @param[in,out] x Blocks of the vector to apply the matrix to, one
+  /// for each block column.
+  /// @param[out] y Blocks of the vector to hold the product, one for
+  /// each block row.
+  template <typename V>
+  void mult(std::span<V* const> x, std::span<V* const> y)
+  {
+    if (x.size() != _shape[1] or y.size() != _shape[0])
+      throw std::runtime_error("Number of vector blocks does not match.");
+
+    for (std::size_t i = 0; i < _shape[0]; ++i)
+    {
+      std::fill_n(y[i]->mutable_array().begin(),
+                  _maps[0][i]->size_local() * block_size(i),
+                  typename V::value_type(0));
+      for (std::size_t j = 0; j < _shape[1]; ++j)
+        if (has_block(i, j))
+          block(i, j).mult_add(*x[j], *y[i]);
+    }
+  }
+
+  /// @brief Compute the Frobenius norm squared across all processes.
+  /// @note MPI Collective
+  double squared_norm() const
+  {
+    double norm = 0;
+    for (auto& A : _blocks)
+      if (A)
+        norm += A->squared_norm();
+    return norm;
+  }
+
+  /// @brief Memory used by the block matrix.
+  /// @return Memory usage, with the blocks as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"BlockMatrixCSR", sizeof(*this), {}};
+    usage.add("blocks", common::capacity_bytes(_blocks));
+    for (auto& A : _blocks)
+      if (A)
+        usage.add(A->memory_usage());
+    return usage;
+  }
+
+private:
+  // Row block size of the blocks in block row i
+  int block_size(std::size_t i) const
+  {
+    for (std::size_t j = 0; j < _shape[1]; ++j)
+      if (has_block(i, j))
+        return block(i, j).block_size()[0];
+    return 1;
+  }
+
+  // Number of block rows and columns
+  std::array<std::size_t, 2> _shape;
+
+  // Blocks, row-major
+  std::vector<std::optional<Matrix>> _blocks;
+
+  // Row index maps of the block rows and column index maps of the
+  // block columns
+  std::array<std::vector<std::shared_ptr<const common::IndexMap>>, 2> _maps;
+};
+
+} // namespace dolfinx::la
@@ -7,14 +7,22 @@
 #pragma once
 
 #include "SparsityPattern.h"
+#include "Vector.h"
 #include "matrix_csr_impl.h"
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <limits>
+#include <memory>
 #include <mpi.h>
 #include <numeric>
 #include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -30,6 +38,57 @@ enum class BlockMode : int
                /// matrix has a block size of (1, 1).
 };
 
+/// @brief Sparsity and parallel layout of a MatrixCSR.
+///
+/// The layout is the output of the symbolic phase of matrix creation:
+/// the row and column index maps, the CSR structure and the data for
+/// sending ghost rows to their owners. It does not depend on the
+/// matrix entries and can be shared by matrices with the same
+/// structure, e.g. the matrices of the steps of a time-dependent or
+/// nonlinear problem, which can then be created without computing a
+/// sparsity pattern (see MatrixCSR::layout).
+///
+/// @tparam ColContainer Column index container type
+/// @tparam RowPtrContainer Row pointer container type
+template <class ColContainer = std::vector<std::int32_t>,
+          class RowPtrContainer = std::vector<std::int64_t>>
+struct MatrixLayout
+{
+  /// Row (0) and column (1) index maps
+  std::array<std::shared_ptr<const common::IndexMap>, 2> index_maps;
+
+  /// Block mode
+  BlockMode block_mode = BlockMode::compact;
+
+  /// Row and column block sizes
+  std::array<int, 2> bs = {1, 1};
+
+  /// Column indices of each row, including ghost rows
+  ColContainer cols;
+
+  /// Row pointers, including ghost rows
+  RowPtrContainer row_ptr;
+
+  /// Start of the off-diagonal (unowned) columns on each row
+  RowPtrContainer off_diagonal_offset;
+
+  /// Neighbourhood communicator for sending ghost rows to their owners
+  dolfinx::MPI::Comm comm{MPI_COMM_NULL};
+
+  /// Position in the owned rows of each received ghost row entry
+  std::vector<int> unpack_pos;
+
+  /// Displacements of the ghost row values sent to each neighbour
+  std::vector<int> val_send_disp;
+
+  /// Displacements of the ghost row values received from each
+  /// neighbour
+  std::vector<int> val_recv_disp;
+
+  /// Neighbour rank that owns each ghost row
+  std::vector<int> ghost_row_to_rank;
+};
+
 /// @brief Distributed sparse matrix.
 ///
 /// The matrix storage format is compressed sparse row. The matrix is
@@ -64,6 +123,9 @@ public:
   /// Row pointer container type
   using rowptr_container_type = RowPtrContainer;
 
+  /// Sparsity and parallel layout type
+  using layout_type = MatrixLayout<ColContainer, RowPtrContainer>;
+
   static_assert(std::is_same_v<value_type, typename container_type::value_type>,
                 "Scalar type and container value type must be the same.");
 
@@ -87,13 +149,16 @@ public:
   ///
   /// @tparam BS0 Row block size of data for insertion
   /// @tparam BS1 Column block size of data for insertion
+  /// @tparam X Scalar type of the data. If it differs from `value_type`,
+  /// e.g. element matrices computed by `float` kernels inserted into a
+  /// `double` matrix, the values are converted on insertion.
   ///
   /// @return Function for inserting values into `A`
-  template <int BS0 = 1, int BS1 = 1>
+  template <int BS0 = 1, int BS1 = 1, dolfinx::scalar X = value_type>
   auto mat_set_values()
   {
-    if ((BS0 != _bs[0] and BS0 > 1 and _bs[0] > 1)
-        or (BS1 != _bs[1] and BS1 > 1 and _bs[1] > 1))
+    if ((BS0 != _layout->bs[0] and BS0 > 1 and _layout->bs[0] > 1)
+        or (BS1 != _layout->bs[1] and BS1 > 1 and _layout->bs[1] > 1))
     {
       throw std::runtime_error(
           "Cannot insert blocks of different size than matrix block size");
@@ -101,9 +166,16 @@ public:
 
     return [&](std::span<const std::int32_t> rows,
                std::span<const std::int32_t> cols,
-               std::span<const value_type> data) -> int
+               std::span<const X> data) -> int
     {
-      this->set<BS0, BS1>(data, rows, cols);
+      if constexpr (std::is_same_v<X, value_type>)
+        this->set<BS0, BS1>(data, rows, cols);
+      else
+      {
+        auto set_fn = [](value_type& y, const X& x)
+        { y = static_cast<value_type>(x); };
+        this->insert<BS0, BS1>(data, rows, cols, set_fn);
+      }
       return 0;
     };
   }
@@ -128,23 +200,123 @@ public:
   ///
   /// @tparam BS0 Row block size of data for insertion
   /// @tparam BS1 Column block size of data for insertion
+  /// @tparam X Scalar type of the data. If it differs from `value_type`,
+  /// e.g. element matrices computed by `float` kernels inserted into a
+  /// `double` matrix, the values are converted on insertion.
   ///
   /// @return Function for inserting values into `A`
-  template <int BS0 = 1, int BS1 = 1>
+  template <int BS0 = 1, int BS1 = 1, dolfinx::scalar X = value_type>
   auto mat_add_values()
   {
-    if ((BS0 != _bs[0] and BS0 > 1 and _bs[0] > 1)
-        or (BS1 != _bs[1] and BS1 > 1 and _bs[1] > 1))
+    if ((BS0 != _layout->bs[0] and BS0 > 1 and _layout->bs[0] > 1)
+        or (BS1 != _layout->bs[1] and BS1 > 1 and _layout->bs[1] > 1))
     {
       throw std::runtime_error(
           "Cannot insert blocks of different size than matrix block size");
     }
 
     return [&](std::span<const std::int32_t> rows,
+               std::span<const std::int32_t> cols,
+               std::span<const X> data) -> int
+    {
+      if constexpr (std::is_same_v<X, value_type>)
+        this->add<BS0, BS1>(data, rows, cols);
+      else
+      {
+        auto add_fn = [](value_type& y, const X& x)
+        { y += static_cast<value_type>(x); };
+        this->insert<BS0, BS1>(data, rows, cols, add_fn);
+      }
+      return 0;
+    };
+  }
+
+  /// @brief Insertion functor for adding values to a matrix that also
+  /// records the position in values() of each inserted entry.
+  ///
+  /// The returned function behaves as the function returned by
+  /// mat_add_values(). In addition, for each entry of `data` it appends
+  /// to `offsets` the position in values() that the entry is added to.
+  /// After an assembly pass, `offsets` can be passed to
+  /// mat_add_values(std::span<const std::int64_t>) to repeat the same
+  /// assembly without searching the sparsity pattern.
+  ///
+  /// @note The function is not safe for concurrent use, e.g. with
+  /// threaded assembly.
+  ///
+  /// @tparam BS0 Row block size of data for insertion
+  /// @tparam BS1 Column block size of data for insertion
+  /// @param[in,out] offsets Positions of the inserted entries in
+  /// values(). New positions are appended.
+  /// @return Function for inserting values into `A`
+  template <int BS0 = 1, int BS1 = 1>
+  auto mat_add_values_record(std::vector<std::int64_t>& offsets)
+  {
+    if ((BS0 != _layout->bs[0] and BS0 > 1 and _layout->bs[0] > 1)
+        or (BS1 != _layout->bs[1] and BS1 > 1 and _layout->bs[1] > 1))
+    {
+      throw std::runtime_error(
+          "Cannot insert blocks of different size than matrix block size");
+    }
+
+    // Scratch buffer of entry positions 0, 1, 2, ..., grown on demand
+    // and shared by all calls (and copies) of the returned function
+    return [&, p = std::make_shared<std::vector<std::int32_t>>()](
+               std::span<const std::int32_t> rows,
                std::span<const std::int32_t> cols,
                std::span<const value_type> data) -> int
     {
-      this->add<BS0, BS1>(data, rows, cols);
+      // Insert the position of each entry in data, and use it to add
+      // the value and record the position of the matrix entry
+      std::vector<std::int32_t>& idx = *p;
+      if (std::size_t n = idx.size(); n < data.size())
+      {
+        idx.resize(data.size());
+        std::iota(std::next(idx.begin(), n), idx.end(),
+                  static_cast<std::int32_t>(n));
+      }
+      std::span<const std::int32_t> pos(idx.data(), data.size());
+
+      std::size_t offset = offsets.size();
+      offsets.resize(offset + data.size());
+      auto add_fn = [&](value_type& y, std::int32_t i)
+      {
+        y += data[i];
+        offsets[offset + i] = std::distance(_data.data(), &y);
+      };
+      this->insert<BS0, BS1>(pos, rows, cols, add_fn);
+      return 0;
+    };
+  }
+
+  /// @brief Insertion functor for adding values to a matrix at
+  /// precomputed positions.
+  ///
+  /// The returned function ignores the row and column indices and adds
+  /// `data` to the entries of values() at the positions in `offsets`.
+  /// Successive calls use successive positions, so the function must be
+  /// called with the same sequence of (`rows`, `cols`) as the function
+  /// returned by mat_add_values_record() that computed `offsets`. This
+  /// is the case when re-assembling a form with the same integration
+  /// domains and the same matrix.
+  ///
+  /// @note The function is not safe for concurrent use, e.g. with
+  /// threaded assembly.
+  ///
+  /// @param[in] offsets Positions in values() of the entries, as
+  /// computed by mat_add_values_record().
+  /// @return Function for inserting values into `A`
+  auto mat_add_values(std::span<const std::int64_t> offsets)
+  {
+    return [&, offsets, p = std::make_shared<std::size_t>(0)](
+               std::span<const std::int32_t>, std::span<const std::int32_t>,
+               std::span<const value_type> data) -> int
+    {
+      std::size_t& pos = *p;
+      assert(pos + data.size() <= offsets.size());
+      for (std::size_t i = 0; i < data.size(); ++i)
+        _data[offsets[pos + i]] += data[i];
+      pos += data.size();
       return 0;
     };
   }
@@ -176,6 +348,50 @@ public:
   /// the matrix is set to (1, 1).
   MatrixCSR(const SparsityPattern& p, BlockMode mode = BlockMode::compact);
 
+  /// @brief Create a matrix with the layout of another matrix.
+  ///
+  /// The layout is shared, not copied, and the entries are
+  /// zero-initialised. Creating a matrix from the layout of an existing
+  /// matrix with the same sparsity skips the construction of the
+  /// sparsity pattern and of the ghost row communication data.
+  ///
+  /// @param[in] layout Sparsity and parallel layout (see
+  /// MatrixCSR::layout).
+  explicit MatrixCSR(std::shared_ptr<const layout_type> layout)
+      : _layout(layout),
+        _data(layout->cols.size() * layout->bs[0] * layout->bs[1], 0)
+  {
+  }
+
+  /// @brief Create a matrix with the layout of another matrix and the
+  /// entries allocated by an allocator.
+  ///
+  /// For example, with a `std::pmr::vector` container and a
+  /// common::FirstTouchResource, the pages of the entries are placed on
+  /// the NUMA nodes of the threads that work on them.
+  ///
+  /// @param[in] layout Sparsity and parallel layout (see
+  /// MatrixCSR::layout).
+  /// @param[in] alloc Allocator for the entries
+  template <typename Allocator>
+  MatrixCSR(std::shared_ptr<const layout_type> layout, const Allocator& alloc)
+      : _layout(layout),
+        _data(layout->cols.size() * layout->bs[0] * layout->bs[1], 0, alloc)
+  {
+  }
+
+  /// @brief Create a copy of a matrix with a different scalar type.
+  ///
+  /// The sparsity and parallel layout are copied and the entries are
+  /// converted to `value_type`. This can be used to store a matrix in
+  /// reduced precision, e.g. for a preconditioner or the inner solve of
+  /// iterative refinement, which reduces the memory traffic of
+  /// matrix-vector products.
+  ///
+  /// @param[in] A Matrix to copy
+  template <typename U0, typename V0, typename W0, typename X0>
+  explicit MatrixCSR(const MatrixCSR<U0, V0, W0, X0>& A);
+
   /// Move constructor
   /// @todo Check handling of MPI_Request
   MatrixCSR(MatrixCSR&& A) = default;
@@ -206,27 +422,28 @@ public:
   {
     auto set_fn = [](value_type& y, const value_type& x) { y = x; };
 
+    const layout_type& L = *_layout;
     std::int32_t num_rows
-        = _index_maps[0]->size_local() + _index_maps[0]->num_ghosts();
+        = L.index_maps[0]->size_local() + L.index_maps[0]->num_ghosts();
     assert(x.size() == rows.size() * cols.size() * BS0 * BS1);
-    if (_bs[0] == BS0 and _bs[1] == BS1)
+    if (L.bs[0] == BS0 and L.bs[1] == BS1)
     {
-      impl::insert_csr<BS0, BS1>(_data, _cols, _row_ptr, x, rows, cols, set_fn,
-                                 num_rows);
+      impl::insert_csr<BS0, BS1>(_data, L.cols, L.row_ptr, x, rows, cols,
+                                 set_fn, num_rows);
     }
-    else if (_bs[0] == 1 and _bs[1] == 1)
+    else if (L.bs[0] == 1 and L.bs[1] == 1)
     {
       // Set blocked data in a regular CSR matrix (_bs[0]=1, _bs[1]=1) with
       // correct sparsity
-      impl::insert_blocked_csr<BS0, BS1>(_data, _cols, _row_ptr, x, rows, cols,
-                                         set_fn, num_rows);
+      impl::insert_blocked_csr<BS0, BS1>(_data, L.cols, L.row_ptr, x, rows,
+                                         cols, set_fn, num_rows);
     }
     else
     {
       assert(BS0 == 1 and BS1 == 1);
       // Set non-blocked data in a blocked CSR matrix (BS0=1, BS1=1)
-      impl::insert_nonblocked_csr(_data, _cols, _row_ptr, x, rows, cols, set_fn,
-                                  num_rows, _bs[0], _bs[1]);
+      impl::insert_nonblocked_csr(_data, L.cols, L.row_ptr, x, rows, cols,
+                                  set_fn, num_rows, L.bs[0], L.bs[1]);
     }
   }
 
@@ -250,33 +467,17 @@ public:
            std::span<const std::int32_t> cols)
   {
     auto add_fn = [](value_type& y, const value_type& x) { y += x; };
-
-    assert(x.size() == rows.size() * cols.size() * BS0 * BS1);
-    if (_bs[0] == BS0 and _bs[1] == BS1)
-    {
-      impl::insert_csr<BS0, BS1>(_data, _cols, _row_ptr, x, rows, cols, add_fn,
-                                 _row_ptr.size());
-    }
-    else if (_bs[0] == 1 and _bs[1] == 1)
-    {
-      // Add blocked data to a regular CSR matrix (_bs[0]=1, _bs[1]=1)
-      impl::insert_blocked_csr<BS0, BS1>(_data, _cols, _row_ptr, x, rows, cols,
-                                         add_fn, _row_ptr.size());
-    }
-    else
-    {
-      assert(BS0 == 1 and BS1 == 1);
-      // Add non-blocked data to a blocked CSR matrix (BS0=1, BS1=1)
-      impl::insert_nonblocked_csr(_data, _cols, _row_ptr, x, rows, cols, add_fn,
-                                  _row_ptr.size(), _bs[0], _bs[1]);
-    }
+    insert<BS0, BS1>(x, rows, cols, add_fn);
   }
 
   /// Number of local rows excluding ghost rows
-  std::int32_t num_owned_rows() const { return _index_maps[0]->size_local(); }
+  std::int32_t num_owned_rows() const
+  {
+    return _layout->index_maps[0]->size_local();
+  }
 
   /// Number of local rows including ghost rows
-  std::int32_t num_all_rows() const { return _row_ptr.size() - 1; }
+  std::int32_t num_all_rows() const { return _layout->row_ptr.size() - 1; }
 
   /// Copy to a dense matrix
   /// @note This function is typically used for debugging and not used
@@ -314,6 +515,115 @@ public:
   /// zeroed.
   void scatter_rev_end();
 
+  /// @brief Compute the matrix-vector product `y = Ax`.
+  ///
+  /// The ghost values of `x` are updated during the product. The
+  /// communication is overlapped with the product of the owned-column
+  /// block of the matrix, after which the ghost-column block is
+  /// applied. Only the owned entries of `y` are computed.
+  ///
+  /// @note MPI Collective
+  /// @param[in,out] x Vector to apply the matrix to. Its layout must
+  /// match the column index map of the matrix.
+  /// @param[out] y Vector to hold the product. Its layout must match the
+  /// row index map of the matrix.
+  ///
+  /// The scalar type `S` of the vectors may differ from the scalar type
+  /// of the matrix, e.g. a matrix stored in single precision can be
+  /// applied to vectors in double precision. The matrix entries are
+  /// converted on the fly and the product is accumulated in `S`.
+  template <typename S, typename C0, typename C1>
+  void mult(Vector<S, C0>& x, Vector<S, C1>& y)
+  {
+    const std::int32_t size = num_owned_rows() * _layout->bs[0];
+    std::fill_n(y.mutable_array().begin(), size, S(0));
+    mult_add(x, y);
+  }
+
+  /// @brief Compute the matrix-vector product `y += Ax`.
+  ///
+  /// See MatrixCSR::mult.
+  ///
+  /// @note MPI Collective
+  /// @param[in,out] x Vector to apply the matrix to.
+  /// @param[in,out] y Vector to add the product to.
+  template <typename S, typename C0, typename C1>
+  void mult_add(Vector<S, C0>& x, Vector<S, C1>& y);
+
+  /// @brief Zero the rows and columns of a square matrix for a list of
+  /// degrees-of-freedom, e.g. with Dirichlet boundary conditions, and
+  /// set the diagonal entries of the rows.
+  ///
+  /// The degrees-of-freedom are marked on the owned columns and sent to
+  /// the ghost columns on other processes, so each process only needs
+  /// to know its owned degrees-of-freedom. The matrix is modified in a
+  /// single pass over the owned rows, which avoids re-assembly when the
+  /// set of degrees-of-freedom changes. Ghost rows are not modified.
+  ///
+  /// @note MPI Collective
+  /// @note This should be called after MatrixCSR::scatter_rev.
+  /// @param[in] dofs Local indices of the (unblocked) rows and columns
+  /// to zero, i.e. for block size `bs` the index of component `c` of
+  /// block row `i` is `i * bs + c`. Indices of ghost rows are ignored.
+  /// @param[in] diagonal Value to set on the diagonal of the zeroed
+  /// rows. The diagonal entries must be in the sparsity pattern.
+  void zero_rows_columns(std::span<const std::int32_t> dofs,
+                         value_type diagonal = 1)
+  {
+    Vector<value_type> marker(_layout->index_maps[1], _layout->bs[1]);
+    zero_rows_columns(dofs, diagonal, marker, {}, {});
+  }
+
+  /// @brief Zero the rows and columns of a square matrix for a list of
+  /// degrees-of-freedom and compute the corresponding right-hand side.
+  ///
+  /// See MatrixCSR::zero_rows_columns. The right-hand side `b` is
+  /// modified such that the solution of the modified system is equal
+  /// to `g` for the zeroed degrees-of-freedom, i.e.
+  ///
+  ///     b_i = diagonal * g_i  for dofs i,
+  ///     b_i -= sum_j A_ij g_j for other rows i, with j in dofs,
+  ///
+  /// where `A` is the matrix before it is modified (the lifting of the
+  /// boundary values).
+  ///
+  /// @note MPI Collective
+  /// @param[in] dofs Local indices of the rows and columns to zero.
+  /// @param[in] diagonal Value to set on the diagonal of the zeroed
+  /// rows.
+  /// @param[in,out] g Values of the degrees-of-freedom in `dofs`. The
+  /// layout must match the column index map of the matrix. Its ghost
+  /// values are updated.
+  /// @param[in,out] b Right-hand side. The layout must match the row
+  /// index map. Only the owned entries are modified.
+  template <typename C0, typename C1>
+  void zero_rows_columns(std::span<const std::int32_t> dofs,
+                         value_type diagonal, Vector<value_type, C0>& g,
+                         Vector<value_type, C1>& b)
+  {
+    g.scatter_fwd();
+    Vector<value_type> marker(g);
+    zero_rows_columns(dofs, diagonal, marker, g.array(), b.mutable_array());
+  }
+
+  /// @brief Create a compressed representation of the column indices,
+  /// which is used by matrix-vector products.
+  ///
+  /// The owned-column and ghost-column parts of each row (see
+  /// off_diag_offset) store the column indices as a per-row base index
+  /// and 16-bit offsets. This reduces the data read per non-zero in
+  /// MatrixCSR::mult by two bytes. Parts of rows whose column range does
+  /// not fit in 16 bits use the full column indices.
+  ///
+  /// The compressed indices are stored in addition to cols(), which is
+  /// still used for insertion. They remain valid when the values of the
+  /// matrix change.
+  void compress_columns();
+
+  /// @brief Check if the column indices have been compressed.
+  /// @return `true` if MatrixCSR::compress_columns has been called.
+  bool compressed_columns() const { return !_col_offsets.empty(); }
+
   /// @brief Compute the Frobenius norm squared across all processes.
   /// @note MPI Collective
   double squared_norm() const;
@@ -327,7 +637,7 @@ public:
   /// @return Row (0) or column (1) index maps
   std::shared_ptr<const common::IndexMap> index_map(int dim) const
   {
-    return _index_maps.at(dim);
+    return _layout->index_maps.at(dim);
   }
 
   /// Get local data values
@@ -340,11 +650,11 @@ public:
 
   /// Get local row pointers
   /// @note Includes pointers to ghost rows
-  const rowptr_container_type& row_ptr() const { return _row_ptr; }
+  const rowptr_container_type& row_ptr() const { return _layout->row_ptr; }
 
   /// Get local column indices
   /// @note Includes columns in ghost rows
-  const column_container_type& cols() const { return _cols; }
+  const column_container_type& cols() const { return _layout->cols; }
 
   /// Get the start of off-diagonal (unowned columns) on each row,
   /// allowing the matrix to be split (virtually) into two parts.
@@ -355,50 +665,103 @@ public:
   /// not required.
   const rowptr_container_type& off_diag_offset() const
   {
-    return _off_diagonal_offset;
+    return _layout->off_diagonal_offset;
   }
 
   /// Block size
   /// @return block sizes for rows and columns
-  std::array<int, 2> block_size() const { return _bs; }
+  std::array<int, 2> block_size() const { return _layout->bs; }
+
+  /// @brief Sparsity and parallel layout of the matrix.
+  ///
+  /// The layout may be shared with other matrices, and can be used to
+  /// create matrices with the same structure.
+  std::shared_ptr<const layout_type> layout() const { return _layout; }
+
+  /// @brief Memory used by the matrix.
+  ///
+  /// The index maps, which are shared with the dofmaps, are not
+  /// included.
+  /// @return Memory usage, with the values, the sparsity (column
+  /// indices and row pointers) and the ghost row communication data as
+  /// parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"MatrixCSR", sizeof(*this), {}};
+    usage.add("values", common::capacity_bytes(_data));
+    const layout_type& L = *_layout;
+    usage.add("sparsity", common::capacity_bytes(L.cols)
+                              + common::capacity_bytes(L.row_ptr)
+                              + common::capacity_bytes(L.off_diagonal_offset)
+                              + common::capacity_bytes(_col_base[0])
+                              + common::capacity_bytes(_col_base[1])
+                              + common::capacity_bytes(_col_offsets));
+    usage.add("ghost rows",
+              common::capacity_bytes(L.unpack_pos)
+                  + common::capacity_bytes(L.val_send_disp)
+                  + common::capacity_bytes(L.val_recv_disp)
+                  + common::capacity_bytes(L.ghost_row_to_rank)
+                  + common::capacity_bytes(_ghost_value_data)
+                  + common::capacity_bytes(_ghost_value_data_in));
+    return usage;
+  }
 
 private:
-  // Maps for the distribution of the ows and columns
-  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+  template <typename, typename, typename, typename>
+  friend class MatrixCSR;
+
+  // Apply op(A_ij, x_k) to the matrix entries A_ij for the dense block x
+  // with row indices `rows` and column indices `cols`
+  template <int BS0, int BS1, typename X, typename OP>
+  void insert(const X& x, std::span<const std::int32_t> rows,
+              std::span<const std::int32_t> cols, OP op)
+  {
+    assert(x.size() == rows.size() * cols.size() * BS0 * BS1);
+    const layout_type& L = *_layout;
+    if (L.bs[0] == BS0 and L.bs[1] == BS1)
+    {
+      impl::insert_csr<BS0, BS1>(_data, L.cols, L.row_ptr, x, rows, cols, op,
+                                 L.row_ptr.size());
+    }
+    else if (L.bs[0] == 1 and L.bs[1] == 1)
+    {
+      // Add blocked data to a regular CSR matrix (_bs[0]=1, _bs[1]=1)
+      impl::insert_blocked_csr<BS0, BS1>(_data, L.cols, L.row_ptr, x, rows,
+                                         cols, op, L.row_ptr.size());
+    }
+    else
+    {
+      assert(BS0 == 1 and BS1 == 1);
+      // Add non-blocked data to a blocked CSR matrix (BS0=1, BS1=1)
+      impl::insert_nonblocked_csr(_data, L.cols, L.row_ptr, x, rows, cols, op,
+                                  L.row_ptr.size(), L.bs[0], L.bs[1]);
+    }
+  }
 
-  // Block mode (compact or expanded)
-  BlockMode _block_mode;
+  // Zero rows and columns for zero_rows_columns, using `marker` (with
+  // the layout of the column index map) to mark the columns. The
+  // lifting is computed if `b` is not empty.
+  void zero_rows_columns(std::span<const std::int32_t> dofs,
+                         value_type diagonal, Vector<value_type>& marker,
+                         std::span<const value_type> g,
+                         std::span<value_type> b);
 
-  // Block sizes
-  std::array<int, 2> _bs;
+  // Sparsity and parallel layout, possibly shared with other matrices
+  std::shared_ptr<const layout_type> _layout;
 
   // Matrix data
   container_type _data;
-  column_container_type _cols;
-  rowptr_container_type _row_ptr;
 
-  // Start of off-diagonal (unowned columns) on each row
-  rowptr_container_type _off_diagonal_offset;
-
-  // Neighborhood communicator (ghost->owner communicator for rows)
-  dolfinx::MPI::Comm _comm;
-
-  // -- Precomputed data for scatter_rev/update
+  // Compressed column indices of the owned rows: the base for the
+  // owned-column (0) and ghost-column (1) part of each row, or -1 if
+  // the part is not compressed, and the offset from the base for each
+  // entry
+  std::array<std::vector<std::int32_t>, 2> _col_base;
+  std::vector<std::uint16_t> _col_offsets;
 
   // Request in non-blocking communication
   MPI_Request _request;
 
-  // Position in _data to add received data
-  std::vector<int> _unpack_pos;
-
-  // Displacements for alltoall for each neighbor when sending and
-  // receiving
-  std::vector<int> _val_send_disp, _val_recv_disp;
-
-  // Ownership of each row, by neighbor (for the neighbourhood defined
-  // on _comm)
-  std::vector<int> _ghost_row_to_rank;
-
   // Temporary stores for data during non-blocking communication
   container_type _ghost_value_data;
   container_type _ghost_value_data_in;
@@ -406,21 +769,24 @@ private:
 //-----------------------------------------------------------------------------
 template <class U, class V, class W, class X>
 MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
-    : _index_maps({p.index_map(0),
-                   std::make_shared<common::IndexMap>(p.column_index_map())}),
-      _block_mode(mode), _bs({p.block_size(0), p.block_size(1)}),
-      _data(p.num_nonzeros() * _bs[0] * _bs[1], 0),
-      _cols(p.graph().first.begin(), p.graph().first.end()),
-      _row_ptr(p.graph().second.begin(), p.graph().second.end()),
-      _comm(MPI_COMM_NULL)
+    : _data(p.num_nonzeros() * p.block_size(0) * p.block_size(1), 0)
 {
-  if (_block_mode == BlockMode::expanded)
+  auto layout = std::make_shared<layout_type>();
+  layout_type& L = *layout;
+  L.index_maps = {p.index_map(0),
+                  std::make_shared<common::IndexMap>(p.column_index_map())};
+  L.block_mode = mode;
+  L.bs = {p.block_size(0), p.block_size(1)};
+  L.cols.assign(p.graph().first.begin(), p.graph().first.end());
+  L.row_ptr.assign(p.graph().second.begin(), p.graph().second.end());
+
+  if (L.block_mode == BlockMode::expanded)
   {
     // Rebuild IndexMaps
     for (int i = 0; i < 2; ++i)
     {
-      const auto im = _index_maps[i];
-      const int size_local = im->size_local() * _bs[i];
+      const auto im = L.index_maps[i];
+      const int size_local = im->size_local() * L.bs[i];
       std::span ghost_i = im->ghosts();
       std::vector<std::int64_t> ghosts;
       const std::vector<int> ghost_owner_i(im->owners().begin(),
@@ -428,19 +794,19 @@ MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
       std::vector<int> src_rank;
       for (std::size_t j = 0; j < ghost_i.size(); ++j)
       {
-        for (int k = 0; k < _bs[i]; ++k)
+        for (int k = 0; k < L.bs[i]; ++k)
         {
-          ghosts.push_back(ghost_i[j] * _bs[i] + k);
+          ghosts.push_back(ghost_i[j] * L.bs[i] + k);
           src_rank.push_back(ghost_owner_i[j]);
         }
       }
       const std::array<std::vector<int>, 2> src_dest0
-          = {std::vector(_index_maps[i]->src().begin(),
-                         _index_maps[i]->src().end()),
-             std::vector(_index_maps[i]->dest().begin(),
-                         _index_maps[i]->dest().end())};
-      _index_maps[i] = std::make_shared<common::IndexMap>(
-          _index_maps[i]->comm(), size_local, src_dest0, ghosts, src_rank);
+          = {std::vector(L.index_maps[i]->src().begin(),
+                         L.index_maps[i]->src().end()),
+             std::vector(L.index_maps[i]->dest().begin(),
+                         L.index_maps[i]->dest().end())};
+      L.index_maps[i] = std::make_shared<common::IndexMap>(
+          L.index_maps[i]->comm(), size_local, src_dest0, ghosts, src_rank);
     }
 
     // Convert sparsity pattern and set _bs to 1
@@ -448,98 +814,99 @@ MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
     column_container_type new_cols;
     new_cols.reserve(_data.size());
     rowptr_container_type new_row_ptr = {0};
-    new_row_ptr.reserve(_row_ptr.size() * _bs[0]);
+    new_row_ptr.reserve(L.row_ptr.size() * L.bs[0]);
     std::span<const std::int32_t> num_diag_nnz = p.off_diagonal_offsets();
-    for (std::size_t i = 0; i < _row_ptr.size() - 1; ++i)
+    for (std::size_t i = 0; i < L.row_ptr.size() - 1; ++i)
     {
       // Repeat row _bs[0] times
-      for (int q0 = 0; q0 < _bs[0]; ++q0)
+      for (int q0 = 0; q0 < L.bs[0]; ++q0)
       {
-        _off_diagonal_offset.push_back(new_row_ptr.back()
-                                       + num_diag_nnz[i] * _bs[1]);
-        for (auto j = _row_ptr[i]; j < _row_ptr[i + 1]; ++j)
+        L.off_diagonal_offset.push_back(new_row_ptr.back()
+                                       + num_diag_nnz[i] * L.bs[1]);
+        for (auto j = L.row_ptr[i]; j < L.row_ptr[i + 1]; ++j)
         {
-          for (int q1 = 0; q1 < _bs[1]; ++q1)
-            new_cols.push_back(_cols[j] * _bs[1] + q1);
+          for (int q1 = 0; q1 < L.bs[1]; ++q1)
+            new_cols.push_back(L.cols[j] * L.bs[1] + q1);
         }
         new_row_ptr.push_back(new_cols.size());
       }
     }
-    _cols = new_cols;
-    _row_ptr = new_row_ptr;
-    _bs[0] = 1;
-    _bs[1] = 1;
+    L.cols = new_cols;
+    L.row_ptr = new_row_ptr;
+    L.bs[0] = 1;
+    L.bs[1] = 1;
   }
   else
   {
     // Compute off-diagonal offset for each row (compact)
     std::span<const std::int32_t> num_diag_nnz = p.off_diagonal_offsets();
-    _off_diagonal_offset.reserve(num_diag_nnz.size());
-    std::ranges::transform(num_diag_nnz, _row_ptr,
-                           std::back_inserter(_off_diagonal_offset),
+    L.off_diagonal_offset.reserve(num_diag_nnz.size());
+    std::ranges::transform(num_diag_nnz, L.row_ptr,
+                           std::back_inserter(L.off_diagonal_offset),
                            std::plus{});
   }
 
   // Some short-hand
   const std::array local_size
-      = {_index_maps[0]->size_local(), _index_maps[1]->size_local()};
+      = {L.index_maps[0]->size_local(), L.index_maps[1]->size_local()};
   const std::array local_range
-      = {_index_maps[0]->local_range(), _index_maps[1]->local_range()};
-  std::span ghosts1 = _index_maps[1]->ghosts();
+      = {L.index_maps[0]->local_range(), L.index_maps[1]->local_range()};
+  std::span ghosts1 = L.index_maps[1]->ghosts();
 
-  std::span ghosts0 = _index_maps[0]->ghosts();
-  std::span src_ranks = _index_maps[0]->src();
-  std::span dest_ranks = _index_maps[0]->dest();
+  std::span ghosts0 = L.index_maps[0]->ghosts();
+  std::span src_ranks = L.index_maps[0]->src();
+  std::span dest_ranks = L.index_maps[0]->dest();
 
   // Create neighbourhood communicator (owner <- ghost)
   MPI_Comm comm;
-  MPI_Dist_graph_create_adjacent(_index_maps[0]->comm(), dest_ranks.size(),
+  MPI_Dist_graph_create_adjacent(L.index_maps[0]->comm(), dest_ranks.size(),
                                  dest_ranks.data(), MPI_UNWEIGHTED,
                                  src_ranks.size(), src_ranks.data(),
                                  MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
-  _comm = dolfinx::MPI::Comm(comm, false);
+  L.comm = dolfinx::MPI::Comm(comm, false);
 
   // Build map from ghost row index position to owning (neighborhood)
   // rank
-  _ghost_row_to_rank.reserve(_index_maps[0]->owners().size());
-  for (int r : _index_maps[0]->owners())
+  L.ghost_row_to_rank.reserve(L.index_maps[0]->owners().size());
+  for (int r : L.index_maps[0]->owners())
   {
     auto it = std::ranges::lower_bound(src_ranks, r);
     assert(it != src_ranks.end() and *it == r);
     int pos = std::distance(src_ranks.begin(), it);
-    _ghost_row_to_rank.push_back(pos);
+    L.ghost_row_to_rank.push_back(pos);
   }
 
   // Compute size of data to send to each neighbor
   std::vector<std::int32_t> data_per_proc(src_ranks.size(), 0);
-  for (std::size_t i = 0; i < _ghost_row_to_rank.size(); ++i)
+  for (std::size_t i = 0; i < L.ghost_row_to_rank.size(); ++i)
   {
-    assert(_ghost_row_to_rank[i] < data_per_proc.size());
+    assert(L.ghost_row_to_rank[i] < data_per_proc.size());
     std::size_t pos = local_size[0] + i;
-    data_per_proc[_ghost_row_to_rank[i]] += _row_ptr[pos + 1] - _row_ptr[pos];
+    data_per_proc[L.ghost_row_to_rank[i]]
+        += L.row_ptr[pos + 1] - L.row_ptr[pos];
   }
 
   // Compute send displacements
-  _val_send_disp.resize(src_ranks.size() + 1, 0);
+  L.val_send_disp.resize(src_ranks.size() + 1, 0);
   std::partial_sum(data_per_proc.begin(), data_per_proc.end(),
-                   std::next(_val_send_disp.begin()));
+                   std::next(L.val_send_disp.begin()));
 
   // For each ghost row, pack and send indices to neighborhood
-  std::vector<std::int64_t> ghost_index_data(2 * _val_send_disp.back());
+  std::vector<std::int64_t> ghost_index_data(2 * L.val_send_disp.back());
   {
-    std::vector<int> insert_pos = _val_send_disp;
-    for (std::size_t i = 0; i < _ghost_row_to_rank.size(); ++i)
+    std::vector<int> insert_pos = L.val_send_disp;
+    for (std::size_t i = 0; i < L.ghost_row_to_rank.size(); ++i)
     {
-      const int rank = _ghost_row_to_rank[i];
+      const int rank = L.ghost_row_to_rank[i];
       int row_id = local_size[0] + i;
-      for (int j = _row_ptr[row_id]; j < _row_ptr[row_id + 1]; ++j)
+      for (int j = L.row_ptr[row_id]; j < L.row_ptr[row_id + 1]; ++j)
       {
         // Get position in send buffer
         const std::int32_t idx_pos = 2 * insert_pos[rank];
 
         // Pack send data (row, col) as global indices
         ghost_index_data[idx_pos] = ghosts0[i];
-        if (std::int32_t col_local = _cols[j]; col_local < local_size[1])
+        if (std::int32_t col_local = L.cols[j]; col_local < local_size[1])
           ghost_index_data[idx_pos + 1] = col_local + local_range[1][0];
         else
           ghost_index_data[idx_pos + 1] = ghosts1[col_local - local_size[1]];
@@ -561,7 +928,7 @@ MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
     send_sizes.reserve(1);
     recv_sizes.reserve(1);
     MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1,
-                          MPI_INT, _comm.comm());
+                          MPI_INT, L.comm.comm());
 
     // Build send/recv displacement
     std::vector<int> send_disp = {0};
@@ -575,16 +942,16 @@ MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
     MPI_Neighbor_alltoallv(ghost_index_data.data(), send_sizes.data(),
                            send_disp.data(), MPI_INT64_T,
                            ghost_index_array.data(), recv_sizes.data(),
-                           recv_disp.data(), MPI_INT64_T, _comm.comm());
+                           recv_disp.data(), MPI_INT64_T, L.comm.comm());
   }
 
   // Store receive displacements for future use, when transferring
   // data values
-  _val_recv_disp.resize(recv_disp.size());
-  const int bs2 = _bs[0] * _bs[1];
-  std::ranges::transform(recv_disp, _val_recv_disp.begin(),
+  L.val_recv_disp.resize(recv_disp.size());
+  const int bs2 = L.bs[0] * L.bs[1];
+  std::ranges::transform(recv_disp, L.val_recv_disp.begin(),
                          [&bs2](auto d) { return bs2 * d / 2; });
-  std::ranges::transform(_val_send_disp, _val_send_disp.begin(),
+  std::ranges::transform(L.val_send_disp, L.val_send_disp.begin(),
                          [&bs2](auto d) { return d * bs2; });
 
   // Global-to-local map for ghost columns
@@ -613,33 +980,36 @@ MatrixCSR<U, V, W, X>::MatrixCSR(const SparsityPattern& p, BlockMode mode)
              and it->first == ghost_index_array[i + 1]);
       local_col = it->second;
     }
-    auto cit0 = std::next(_cols.begin(), _row_ptr[local_row]);
-    auto cit1 = std::next(_cols.begin(), _row_ptr[local_row + 1]);
+    auto cit0 = std::next(L.cols.begin(), L.row_ptr[local_row]);
+    auto cit1 = std::next(L.cols.begin(), L.row_ptr[local_row + 1]);
 
     // Find position of column index and insert data
     auto cit = std::lower_bound(cit0, cit1, local_col);
     assert(cit != cit1);
     assert(*cit == local_col);
-    std::size_t d = std::distance(_cols.begin(), cit);
-    _unpack_pos.push_back(d);
+    std::size_t d = std::distance(L.cols.begin(), cit);
+    L.unpack_pos.push_back(d);
   }
+
+  _layout = layout;
 }
 //-----------------------------------------------------------------------------
 template <typename U, typename V, typename W, typename X>
 std::vector<typename MatrixCSR<U, V, W, X>::value_type>
 MatrixCSR<U, V, W, X>::to_dense() const
 {
+  const layout_type& L = *_layout;
   const std::size_t nrows = num_all_rows();
   const std::size_t ncols
-      = _index_maps[1]->size_local() + _index_maps[1]->num_ghosts();
-  std::vector<value_type> A(nrows * ncols * _bs[0] * _bs[1], 0.0);
+      = L.index_maps[1]->size_local() + L.index_maps[1]->num_ghosts();
+  std::vector<value_type> A(nrows * ncols * L.bs[0] * L.bs[1], 0.0);
   for (std::size_t r = 0; r < nrows; ++r)
-    for (std::int32_t j = _row_ptr[r]; j < _row_ptr[r + 1]; ++j)
-      for (int i0 = 0; i0 < _bs[0]; ++i0)
-        for (int i1 = 0; i1 < _bs[1]; ++i1)
+    for (std::int32_t j = L.row_ptr[r]; j < L.row_ptr[r + 1]; ++j)
+      for (int i0 = 0; i0 < L.bs[0]; ++i0)
+        for (int i1 = 0; i1 < L.bs[1]; ++i1)
         {
-          A[(r * _bs[1] + i0) * ncols * _bs[0] + _cols[j] * _bs[1] + i1]
-              = _data[j * _bs[0] * _bs[1] + i0 * _bs[1] + i1];
+          A[(r * L.bs[1] + i0) * ncols * L.bs[0] + L.cols[j] * L.bs[1] + i1]
+              = _data[j * L.bs[0] * L.bs[1] + i0 * L.bs[1] + i1];
         }
 
   return A;
@@ -648,49 +1018,51 @@ MatrixCSR<U, V, W, X>::to_dense() const
 template <typename U, typename V, typename W, typename X>
 void MatrixCSR<U, V, W, X>::scatter_rev_begin()
 {
-  const std::int32_t local_size0 = _index_maps[0]->size_local();
-  const std::int32_t num_ghosts0 = _index_maps[0]->num_ghosts();
-  const int bs2 = _bs[0] * _bs[1];
+  const layout_type& L = *_layout;
+  const std::int32_t local_size0 = L.index_maps[0]->size_local();
+  const std::int32_t num_ghosts0 = L.index_maps[0]->num_ghosts();
+  const int bs2 = L.bs[0] * L.bs[1];
 
   // For each ghost row, pack and send values to send to neighborhood
-  std::vector<int> insert_pos = _val_send_disp;
-  _ghost_value_data.resize(_val_send_disp.back());
+  std::vector<int> insert_pos = L.val_send_disp;
+  _ghost_value_data.resize(L.val_send_disp.back());
   for (int i = 0; i < num_ghosts0; ++i)
   {
-    const int rank = _ghost_row_to_rank[i];
+    const int rank = L.ghost_row_to_rank[i];
 
     // Get position in send buffer to place data to send to this
     // neighbour
     const std::int32_t val_pos = insert_pos[rank];
-    std::copy(std::next(_data.data(), _row_ptr[local_size0 + i] * bs2),
-              std::next(_data.data(), _row_ptr[local_size0 + i + 1] * bs2),
+    std::copy(std::next(_data.data(), L.row_ptr[local_size0 + i] * bs2),
+              std::next(_data.data(), L.row_ptr[local_size0 + i + 1] * bs2),
               std::next(_ghost_value_data.begin(), val_pos));
     insert_pos[rank]
-        += bs2 * (_row_ptr[local_size0 + i + 1] - _row_ptr[local_size0 + i]);
+        += bs2 * (L.row_ptr[local_size0 + i + 1] - L.row_ptr[local_size0 + i]);
   }
 
-  _ghost_value_data_in.resize(_val_recv_disp.back());
+  _ghost_value_data_in.resize(L.val_recv_disp.back());
 
   // Compute data sizes for send and receive from displacements
-  std::vector<int> val_send_count(_val_send_disp.size() - 1);
-  std::adjacent_difference(std::next(_val_send_disp.begin()),
-                           _val_send_disp.end(), val_send_count.begin());
+  std::vector<int> val_send_count(L.val_send_disp.size() - 1);
+  std::adjacent_difference(std::next(L.val_send_disp.begin()),
+                           L.val_send_disp.end(), val_send_count.begin());
 
-  std::vector<int> val_recv_count(_val_recv_disp.size() - 1);
-  std::adjacent_difference(std::next(_val_recv_disp.begin()),
-                           _val_recv_disp.end(), val_recv_count.begin());
+  std::vector<int> val_recv_count(L.val_recv_disp.size() - 1);
+  std::adjacent_difference(std::next(L.val_recv_disp.begin()),
+                           L.val_recv_disp.end(), val_recv_count.begin());
 
   int status = MPI_Ineighbor_alltoallv(
-      _ghost_value_data.data(), val_send_count.data(), _val_send_disp.data(),
+      _ghost_value_data.data(), val_send_count.data(), L.val_send_disp.data(),
       dolfinx::MPI::mpi_type<value_type>(), _ghost_value_data_in.data(),
-      val_recv_count.data(), _val_recv_disp.data(),
-      dolfinx::MPI::mpi_type<value_type>(), _comm.comm(), &_request);
+      val_recv_count.data(), L.val_recv_disp.data(),
+      dolfinx::MPI::mpi_type<value_type>(), L.comm.comm(), &_request);
   assert(status == MPI_SUCCESS);
 }
 //-----------------------------------------------------------------------------
 template <typename U, typename V, typename W, typename X>
 void MatrixCSR<U, V, W, X>::scatter_rev_end()
 {
+  const layout_type& L = *_layout;
   int status = MPI_Wait(&_request, MPI_STATUS_IGNORE);
   assert(status == MPI_SUCCESS);
 
@@ -698,32 +1070,222 @@ void MatrixCSR<U, V, W, X>::scatter_rev_end()
   _ghost_value_data.shrink_to_fit();
 
   // Add to local rows
-  const int bs2 = _bs[0] * _bs[1];
-  assert(_ghost_value_data_in.size() == _unpack_pos.size() * bs2);
-  for (std::size_t i = 0; i < _unpack_pos.size(); ++i)
+  const int bs2 = L.bs[0] * L.bs[1];
+  assert(_ghost_value_data_in.size() == L.unpack_pos.size() * bs2);
+  for (std::size_t i = 0; i < L.unpack_pos.size(); ++i)
     for (int j = 0; j < bs2; ++j)
-      _data[_unpack_pos[i] * bs2 + j] += _ghost_value_data_in[i * bs2 + j];
+      _data[L.unpack_pos[i] * bs2 + j] += _ghost_value_data_in[i * bs2 + j];
 
   _ghost_value_data_in.clear();
   _ghost_value_data_in.shrink_to_fit();
 
   // Set ghost row data to zero
-  const std::int32_t local_size0 = _index_maps[0]->size_local();
-  std::fill(std::next(_data.begin(), _row_ptr[local_size0] * bs2), _data.end(),
+  const std::int32_t local_size0 = L.index_maps[0]->size_local();
+  std::fill(std::next(_data.begin(), L.row_ptr[local_size0] * bs2), _data.end(),
             0);
 }
 //-----------------------------------------------------------------------------
 template <typename U, typename V, typename W, typename X>
+template <typename U0, typename V0, typename W0, typename X0>
+MatrixCSR<U, V, W, X>::MatrixCSR(const MatrixCSR<U0, V0, W0, X0>& A)
+    : _data(A._data.size()), _col_base(A._col_base),
+      _col_offsets(A._col_offsets)
+{
+  using layout0_type = typename MatrixCSR<U0, V0, W0, X0>::layout_type;
+  if constexpr (std::is_same_v<layout_type, layout0_type>)
+    _layout = A._layout;
+  else
+  {
+    const layout0_type& L0 = *A._layout;
+    auto layout = std::make_shared<layout_type>();
+    layout_type& L = *layout;
+    L.index_maps = L0.index_maps;
+    L.block_mode = L0.block_mode;
+    L.bs = L0.bs;
+    L.cols = column_container_type(L0.cols.begin(), L0.cols.end());
+    L.row_ptr = rowptr_container_type(L0.row_ptr.begin(), L0.row_ptr.end());
+    L.off_diagonal_offset = rowptr_container_type(
+        L0.off_diagonal_offset.begin(), L0.off_diagonal_offset.end());
+    L.comm = dolfinx::MPI::Comm(L0.comm.comm());
+    L.unpack_pos = L0.unpack_pos;
+    L.val_send_disp = L0.val_send_disp;
+    L.val_recv_disp = L0.val_recv_disp;
+    L.ghost_row_to_rank = L0.ghost_row_to_rank;
+    _layout = layout;
+  }
+
+  std::ranges::transform(A._data, _data.begin(), [](auto x)
+                         { return static_cast<value_type>(x); });
+}
+//-----------------------------------------------------------------------------
+template <typename U, typename V, typename W, typename X>
+template <typename S, typename C0, typename C1>
+void MatrixCSR<U, V, W, X>::mult_add(Vector<S, C0>& x, Vector<S, C1>& y)
+{
+  const layout_type& L = *_layout;
+  // Start update of ghost values
+  x.scatter_fwd_begin();
+
+  const std::int32_t num_rows = num_owned_rows();
+  std::span<const std::int64_t> row_begin(L.row_ptr.data(), num_rows);
+  std::span<const std::int64_t> row_end(L.row_ptr.data() + 1, num_rows);
+  std::span<const std::int64_t> off_diag(L.off_diagonal_offset.data(),
+                                         num_rows);
+  std::span<const value_type> values(_data.data(), _data.size());
+  std::span<const std::int32_t> cols(L.cols.data(), L.cols.size());
+  std::span<const S> _x = x.array();
+  std::span<S> _y = y.mutable_array();
+
+  auto spmv = [&](auto row_begin, auto row_end, int part)
+  {
+    if (compressed_columns())
+    {
+      std::span<const std::int32_t> base(_col_base[part]);
+      std::span<const std::uint16_t> offsets(_col_offsets);
+      if (L.bs[1] == 1)
+      {
+        impl::spmv_compressed<value_type, 1>(values, row_begin, row_end, base,
+                                             offsets, cols, _x, _y, L.bs[0],
+                                             1);
+      }
+      else
+      {
+        impl::spmv_compressed<value_type, -1>(values, row_begin, row_end,
+                                              base, offsets, cols, _x, _y,
+                                              L.bs[0], L.bs[1]);
+      }
+    }
+    else if (L.bs[1] == 1)
+    {
+      impl::spmv<value_type, 1>(values, row_begin, row_end, cols, _x, _y,
+                                L.bs[0], 1);
+    }
+    else
+    {
+      impl::spmv<value_type, -1>(values, row_begin, row_end, cols, _x, _y,
+                                 L.bs[0], L.bs[1]);
+    }
+  };
+
+  // Owned columns
+  spmv(row_begin, off_diag, 0);
+
+  // Finish update of ghost values and apply ghost columns
+  x.scatter_fwd_end();
+  spmv(off_diag, row_end, 1);
+}
+//-----------------------------------------------------------------------------
+template <typename U, typename V, typename W, typename X>
+void MatrixCSR<U, V, W, X>::zero_rows_columns(
+    std::span<const std::int32_t> dofs, value_type diagonal,
+    Vector<value_type>& marker, std::span<const value_type> g,
+    std::span<value_type> b)
+{
+  const layout_type& L = *_layout;
+  if (L.bs[0] != L.bs[1]
+      or L.index_maps[0]->size_local() != L.index_maps[1]->size_local())
+  {
+    throw std::runtime_error("Cannot zero rows and columns of a matrix that "
+                             "is not square.");
+  }
+
+  // Mark owned rows/columns and update the ghost columns
+  const int bs = L.bs[0];
+  const std::int32_t num_rows = num_owned_rows();
+  std::span<value_type> m = marker.mutable_array();
+  std::ranges::fill(m, value_type(0));
+  for (std::int32_t dof : dofs)
+  {
+    if (dof < num_rows * bs)
+      m[dof] = 1;
+  }
+  marker.scatter_fwd();
+
+  for (std::int32_t i = 0; i < num_rows; ++i)
+  {
+    for (int c0 = 0; c0 < bs; ++c0)
+    {
+      const std::int32_t row = i * bs + c0;
+      const bool zero_row = m[row] != value_type(0);
+      if (!b.empty() and zero_row)
+        b[row] = diagonal * g[row];
+
+      bool diagonal_set = !zero_row;
+      for (std::int64_t k = L.row_ptr[i]; k < L.row_ptr[i + 1]; ++k)
+      {
+        for (int c1 = 0; c1 < bs; ++c1)
+        {
+          const std::int32_t col = L.cols[k] * bs + c1;
+          value_type& a = _data[(k * bs + c0) * bs + c1];
+          if (col == row and zero_row)
+          {
+            a = diagonal;
+            diagonal_set = true;
+          }
+          else if (zero_row)
+            a = 0;
+          else if (m[col] != value_type(0))
+          {
+            if (!b.empty())
+              b[row] -= a * g[col];
+            a = 0;
+          }
+        }
+      }
+
+      if (!diagonal_set)
+      {
+        throw std::runtime_error(
+            "Diagonal entry of a zeroed row is not in the sparsity pattern.");
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename U, typename V, typename W, typename X>
+void MatrixCSR<U, V, W, X>::compress_columns()
+{
+  const layout_type& L = *_layout;
+  const std::int32_t num_rows = num_owned_rows();
+  _col_offsets.assign(L.row_ptr[num_rows], 0);
+  for (int part = 0; part < 2; ++part)
+  {
+    _col_base[part].assign(num_rows, 0);
+    for (std::int32_t r = 0; r < num_rows; ++r)
+    {
+      auto begin = part == 0 ? L.row_ptr[r] : L.off_diagonal_offset[r];
+      auto end = part == 0 ? L.off_diagonal_offset[r] : L.row_ptr[r + 1];
+      if (begin == end)
+        continue;
+
+      auto [c0, c1] = std::minmax_element(std::next(L.cols.begin(), begin),
+                                          std::next(L.cols.begin(), end));
+      if (*c1 - *c0 > std::numeric_limits<std::uint16_t>::max())
+        _col_base[part][r] = -1;
+      else
+      {
+        _col_base[part][r] = *c0;
+        for (auto j = begin; j < end; ++j)
+          _col_offsets[j] = L.cols[j] - *c0;
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename U, typename V, typename W, typename X>
 double MatrixCSR<U, V, W, X>::squared_norm() const
 {
-  const std::size_t num_owned_rows = _index_maps[0]->size_local();
-  const int bs2 = _bs[0] * _bs[1];
-  assert(num_owned_rows < _row_ptr.size());
+  const layout_type& L = *_layout;
+  const std::size_t num_owned_rows = L.index_maps[0]->size_local();
+  const int bs2 = L.bs[0] * L.bs[1];
+  assert(num_owned_rows < L.row_ptr.size());
   double norm_sq_local = std::accumulate(
-      _data.cbegin(), std::next(_data.cbegin(), _row_ptr[num_owned_rows] * bs2),
+      _data.cbegin(),
+      std::next(_data.cbegin(), L.row_ptr[num_owned_rows] * bs2),
       double(0), [](auto norm, value_type y) { return norm + std::norm(y); });
   double norm_sq;
-  MPI_Allreduce(&norm_sq_local, &norm_sq, 1, MPI_DOUBLE, MPI_SUM, _comm.comm());
+  MPI_Allreduce(&norm_sq_local, &norm_sq, 1, MPI_DOUBLE, MPI_SUM,
+                L.comm.comm());
   return norm_sq;
 }
 //-----------------------------------------------------------------------------
@@ -0,0 +1,263 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::la
+{
+namespace impl
+{
+/// @brief Sparse matrix-vector product `y += Ax` for a matrix in
+/// sliced ELLPACK storage.
+///
+/// The rows are stored in chunks of `C` rows. Within a chunk, the
+/// entries are stored column-major, i.e. entry `j` of lane `r` in
+/// chunk `k` is at position `slice_ptr[k] + j * C + r`, and all rows in
+/// a chunk are padded to the same length with zero entries.
+///
+/// @tparam T Scalar type
+/// @tparam C Chunk size
+/// @param[in] values Matrix entries
+/// @param[in] cols Column indices
+/// @param[in] slice_ptr Offset of each chunk in `values` and `cols`
+/// @param[in] rows Row in `y` for each lane of each chunk
+/// @param[in] x The vector to apply the matrix to
+/// @param[in,out] y The vector to add the product to
+template <typename T, int C>
+void spmv_sell(std::span<const T> values, std::span<const std::int32_t> cols,
+               std::span<const std::int64_t> slice_ptr,
+               std::span<const std::int32_t> rows, std::span<const T> x,
+               std::span<T> y)
+{
+  const std::int32_t num_rows = rows.size();
+  for (std::size_t k = 0; k < slice_ptr.size() - 1; ++k)
+  {
+    const T* v = values.data() + slice_ptr[k];
+    const std::int32_t* c = cols.data() + slice_ptr[k];
+    const std::int64_t width = (slice_ptr[k + 1] - slice_ptr[k]) / C;
+
+    // Lanes are independent, which allows the compiler to vectorise
+    // the inner loop
+    std::array<T, C> acc{};
+    for (std::int64_t j = 0; j < width; ++j)
+      for (int r = 0; r < C; ++r)
+        acc[r] += v[j * C + r] * x[c[j * C + r]];
+
+    const std::int32_t r1 = std::min(C, num_rows - std::int32_t(k * C));
+    for (std::int32_t r = 0; r < r1; ++r)
+      y[rows[k * C + r]] += acc[r];
+  }
+}
+} // namespace impl
+
+/// @brief Distributed sparse matrix in sliced ELLPACK (SELL-C-σ)
+/// storage.
+///
+/// The owned rows of a MatrixCSR are grouped into chunks of `C` rows.
+/// Within each chunk the rows are padded with zero entries to the
+/// length of the longest row, and entries are stored column-major so
+/// that the rows of a chunk can be processed in SIMD lanes. To reduce
+/// padding, rows are sorted by decreasing length within windows of
+/// `sigma` rows before being grouped into chunks.
+///
+/// As for MatrixCSR, each row is split into a part with owned columns
+/// and a part with ghost columns, which are stored separately. This
+/// allows the communication of ghost values to be overlapped with the
+/// product of the owned part of the matrix.
+///
+/// @note The matrix is a copy and does not change if the MatrixCSR it
+/// was created from changes.
+///
+/// @tparam T Scalar type of matrix entries
+/// @tparam C Chunk size (number of rows processed together)
+template <typename T, int C = 8>
+class MatrixSELL
+{
+public:
+  /// Scalar type
+  using value_type = T;
+
+  /// Chunk size
+  static constexpr int chunk_size = C;
+
+  /// @brief Create a matrix in sliced ELLPACK storage from a CSR
+  /// matrix.
+  ///
+  /// Ghost rows of `A` are not copied, so `A.scatter_rev()` should be
+  /// called before creating the sliced matrix.
+  ///
+  /// @param[in] A CSR matrix. The block size must be one (use
+  /// BlockMode::expanded for blocked sparsity patterns).
+  /// @param[in] sigma Size of the windows within which rows are sorted
+  /// by length. If `sigma <= 1` rows are not sorted, and if it is
+  /// greater than or equal to the number of rows, all rows are sorted.
+  template <typename V, typename W, typename X>
+  explicit MatrixSELL(const MatrixCSR<T, V, W, X>& A, int sigma = 256)
+      : _index_maps({A.index_map(0), A.index_map(1)})
+  {
+    if (A.block_size()[0] != 1 or A.block_size()[1] != 1)
+    {
+      throw std::runtime_error(
+          "MatrixSELL requires a CSR matrix with block size 1.");
+    }
+
+    const std::int32_t num_rows = A.num_owned_rows();
+    auto& row_ptr = A.row_ptr();
+    auto& off_diag = A.off_diag_offset();
+    auto& cols = A.cols();
+    auto& values = A.values();
+
+    // Sort rows by decreasing length within each window
+    _rows.resize(num_rows);
+    std::iota(_rows.begin(), _rows.end(), 0);
+    if (sigma > 1)
+    {
+      for (std::int32_t r0 = 0; r0 < num_rows; r0 += sigma)
+      {
+        std::int32_t r1 = std::min(r0 + sigma, num_rows);
+        std::stable_sort(std::next(_rows.begin(), r0),
+                         std::next(_rows.begin(), r1),
+                         [&row_ptr](auto a, auto b)
+                         {
+                           return row_ptr[a + 1] - row_ptr[a]
+                                  > row_ptr[b + 1] - row_ptr[b];
+                         });
+      }
+    }
+
+    // Pack owned (p = 0) and ghost (p = 1) column parts of each row
+    const std::size_t num_chunks = (num_rows + C - 1) / C;
+    for (int p = 0; p < 2; ++p)
+    {
+      auto row_begin = [&](std::int32_t r)
+      { return p == 0 ? row_ptr[r] : off_diag[r]; };
+      auto row_end = [&](std::int32_t r)
+      { return p == 0 ? off_diag[r] : row_ptr[r + 1]; };
+
+      std::vector<std::int64_t>& slice_ptr = _slice_ptr[p];
+      slice_ptr.assign(num_chunks + 1, 0);
+      for (std::size_t k = 0; k < num_chunks; ++k)
+      {
+        std::int64_t width = 0;
+        std::int32_t r1 = std::min<std::int32_t>((k + 1) * C, num_rows);
+        for (std::int32_t r = k * C; r < r1; ++r)
+          width = std::max(width, row_end(_rows[r]) - row_begin(_rows[r]));
+        slice_ptr[k + 1] = slice_ptr[k] + width * C;
+      }
+
+      _cols[p].assign(slice_ptr.back(), 0);
+      _values[p].assign(slice_ptr.back(), 0);
+      for (std::int32_t i = 0; i < num_rows; ++i)
+      {
+        const std::int32_t row = _rows[i];
+        const std::int64_t offset = slice_ptr[i / C] + i % C;
+        for (auto j = row_begin(row); j < row_end(row); ++j)
+        {
+          const std::int64_t pos = offset + (j - row_begin(row)) * C;
+          _cols[p][pos] = cols[j];
+          _values[p][pos] = values[j];
+        }
+      }
+    }
+  }
+
+  /// @brief Compute the matrix-vector product `y = Ax`.
+  ///
+  /// The ghost values of `x` are updated during the product, and the
+  /// communication is overlapped with the product of the owned-column
+  /// part of the matrix. Only the owned entries of `y` are computed.
+  ///
+  /// @note MPI Collective
+  /// @param[in,out] x Vector to apply the matrix to. Its layout must
+  /// match the column index map of the matrix.
+  /// @param[out] y Vector to hold the product. Its layout must match the
+  /// row index map of the matrix.
+  template <typename C0, typename C1>
+  void mult(Vector<value_type, C0>& x, Vector<value_type, C1>& y)
+  {
+    std::fill_n(y.mutable_array().begin(), num_owned_rows(), value_type(0));
+    mult_add(x, y);
+  }
+
+  /// @brief Compute the matrix-vector product `y += Ax`.
+  ///
+  /// See MatrixSELL::mult.
+  ///
+  /// @note MPI Collective
+  /// @param[in,out] x Vector to apply the matrix to.
+  /// @param[in,out] y Vector to add the product to.
+  template <typename C0, typename C1>
+  void mult_add(Vector<value_type, C0>& x, Vector<value_type, C1>& y)
+  {
+    x.scatter_fwd_begin();
+    impl::spmv_sell<value_type, C>(_values[0], _cols[0], _slice_ptr[0],
+                                   _rows, x.array(), y.mutable_array());
+    x.scatter_fwd_end();
+    impl::spmv_sell<value_type, C>(_values[1], _cols[1], _slice_ptr[1],
+                                   _rows, x.array(), y.mutable_array());
+  }
+
+  /// Number of local rows (excluding ghost rows)
+  std::int32_t num_owned_rows() const { return _rows.size(); }
+
+  /// @brief Index maps for the row and column space.
+  /// @return Row (0) or column (1) index maps
+  std::shared_ptr<const common::IndexMap> index_map(int dim) const
+  {
+    return _index_maps.at(dim);
+  }
+
+  /// @brief Row of the CSR matrix for each lane of each chunk, i.e.
+  /// the order in which the rows are stored.
+  const std::vector<std::int32_t>& rows() const { return _rows; }
+
+  /// @brief Offset of each chunk into the entries.
+  /// @param[in] part Owned-column (0) or ghost-column (1) part
+  const std::vector<std::int64_t>& slice_ptr(int part) const
+  {
+    return _slice_ptr.at(part);
+  }
+
+  /// @brief Column indices, including padding.
+  /// @param[in] part Owned-column (0) or ghost-column (1) part
+  const std::vector<std::int32_t>& cols(int part) const
+  {
+    return _cols.at(part);
+  }
+
+  /// @brief Matrix entries, including padding.
+  /// @param[in] part Owned-column (0) or ghost-column (1) part
+  const std::vector<value_type>& values(int part) const
+  {
+    return _values.at(part);
+  }
+
+private:
+  // Maps for the distribution of the rows and columns
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // CSR row for each lane of each chunk
+  std::vector<std::int32_t> _rows;
+
+  // Storage for the owned-column (0) and ghost-column (1) parts
+  std::array<std::vector<std::int64_t>, 2> _slice_ptr;
+  std::array<std::vector<std::int32_t>, 2> _cols;
+  std::array<std::vector<value_type>, 2> _values;
+};
+
+} // namespace dolfinx::la
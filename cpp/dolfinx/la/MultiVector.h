@@ -0,0 +1,448 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/types.h>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// @brief Set of distributed vectors that share a parallel layout.
+///
+/// The vectors are stored interleaved, i.e. entry `i` of vector `j` is
+/// at position `i * num_vectors() + j` in the array, where `i` is the
+/// local index of the entry in a single vector (including the block
+/// component). Ghost updates communicate all vectors with one message
+/// per neighbouring rank, rather than one message per vector and rank.
+///
+/// @tparam T Scalar type
+/// @tparam Container data container type
+template <typename T, typename Container = std::vector<T>>
+class MultiVector
+{
+public:
+  /// Scalar type
+  using value_type = T;
+
+  /// Container type
+  using container_type = Container;
+
+  /// Create a set of distributed vectors
+  /// @param map IndexMap for parallel distribution of the data
+  /// @param bs Block size of each vector
+  /// @param num_vectors Number of vectors
+  /// @param type MPI communication pattern used for ghost updates
+  MultiVector(
+      std::shared_ptr<const common::IndexMap> map, int bs, int num_vectors,
+      common::Scatterer<>::type type = common::Scatterer<>::type::neighbor)
+      : _bs(bs), _num_vectors(num_vectors),
+        _x(map, bs * num_vectors, type)
+  {
+  }
+
+  /// Set all entries (including ghosts)
+  /// @param[in] v The value to set all entries to (on calling rank)
+  void set(value_type v) { _x.set(v); }
+
+  /// Begin scatter of local data from owner to ghosts on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd_begin() { _x.scatter_fwd_begin(); }
+
+  /// End scatter of local data from owner to ghosts on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd_end() { _x.scatter_fwd_end(); }
+
+  /// Scatter local data to ghost positions on other ranks
+  /// @note Collective MPI operation
+  void scatter_fwd() { _x.scatter_fwd(); }
+
+  /// Start scatter of ghost data to owner
+  /// @note Collective MPI operation
+  void scatter_rev_begin() { _x.scatter_rev_begin(); }
+
+  /// End scatter of ghost data to owner
+  /// @param op The operation to perform when adding/setting received
+  /// values (add or insert)
+  /// @note Collective MPI operation
+  template <class BinaryOperation>
+  void scatter_rev_end(BinaryOperation op)
+  {
+    _x.scatter_rev_end(op);
+  }
+
+  /// Scatter ghost data to owner
+  /// @param op IndexMap operation (add or insert)
+  /// @note Collective MPI operation
+  template <class BinaryOperation>
+  void scatter_rev(BinaryOperation op)
+  {
+    _x.scatter_rev(op);
+  }
+
+  /// Get IndexMap
+  std::shared_ptr<const common::IndexMap> index_map() const
+  {
+    return _x.index_map();
+  }
+
+  /// Get block size of each vector
+  constexpr int bs() const { return _bs; }
+
+  /// Get number of vectors
+  constexpr int num_vectors() const { return _num_vectors; }
+
+  /// Get local part of the vectors (const version), including ghosts
+  std::span<const value_type> array() const { return _x.array(); }
+
+  /// Get local part of the vectors, including ghosts
+  std::span<value_type> mutable_array() { return _x.mutable_array(); }
+
+  /// @brief Copy a vector into the set, including ghost entries.
+  /// @param[in] j Index of the vector in the set
+  /// @param[in] x Vector with the same layout as the vectors in the set
+  template <typename C>
+  void copy_from(int j, const Vector<value_type, C>& x)
+  {
+    std::span<const value_type> _x_in = x.array();
+    std::span<value_type> data = _x.mutable_array();
+    if (_x_in.size() * _num_vectors != data.size())
+      throw std::runtime_error("Incompatible vector sizes.");
+    for (std::size_t i = 0; i < _x_in.size(); ++i)
+      data[i * _num_vectors + j] = _x_in[i];
+  }
+
+  /// @brief Copy a vector from the set, including ghost entries.
+  /// @param[in] j Index of the vector in the set
+  /// @param[out] x Vector with the same layout as the vectors in the
+  /// set
+  template <typename C>
+  void copy_to(int j, Vector<value_type, C>& x) const
+  {
+    std::span<const value_type> data = _x.array();
+    std::span<value_type> _x_out = x.mutable_array();
+    if (_x_out.size() * _num_vectors != data.size())
+      throw std::runtime_error("Incompatible vector sizes.");
+    for (std::size_t i = 0; i < _x_out.size(); ++i)
+      _x_out[i] = data[i * _num_vectors + j];
+  }
+
+private:
+  // Block size of each vector
+  int _bs;
+
+  // Number of vectors
+  int _num_vectors;
+
+  // Interleaved storage, as a vector with block size bs * num_vectors
+  Vector<value_type, container_type> _x;
+};
+
+/// @brief Start the computation of the inner products `a_i^{H} b_j` of
+/// all vectors in two sets, using a single non-blocking reduction.
+/// @note Collective MPI operation
+/// @param[in] a A set of vectors
+/// @param[in] b A set of vectors with the same parallel layout as `a`
+/// @return Reduction that gives the inner products, with `a_i^{H} b_j`
+/// at position `i * b.num_vectors() + j`
+template <typename T, typename C>
+Reduction<T> inner_products_begin(const MultiVector<T, C>& a,
+                                  const MultiVector<T, C>& b)
+{
+  const std::int32_t local_size = a.bs() * a.index_map()->size_local();
+  if (local_size != b.bs() * b.index_map()->size_local())
+    throw std::runtime_error("Incompatible vector sizes");
+
+  const int na = a.num_vectors();
+  const int nb = b.num_vectors();
+  std::span<const T> x_a = a.array();
+  std::span<const T> x_b = b.array();
+  std::vector<T> local(na * nb, 0);
+  for (std::int32_t k = 0; k < local_size; ++k)
+  {
+    for (int i = 0; i < na; ++i)
+    {
+      const T ai = impl::conj(x_a[k * na + i]);
+      for (int j = 0; j < nb; ++j)
+        local[i * nb + j] += ai * x_b[k * nb + j];
+    }
+  }
+
+  return Reduction<T>(std::move(local), a.index_map()->comm());
+}
+
+/// @brief Compute the inner products `a_i^{H} b_j` of all vectors in
+/// two sets, using a single reduction.
+/// @note Collective MPI operation
+/// @param[in] a A set of vectors
+/// @param[in] b A set of vectors with the same parallel layout as `a`
+/// @return The inner products, with `a_i^{H} b_j` at position
+/// `i * b.num_vectors() + j`
+template <typename T, typename C>
+std::vector<T> inner_products(const MultiVector<T, C>& a,
+                              const MultiVector<T, C>& b)
+{
+  return inner_products_begin(a, b).wait();
+}
+
+/// @brief Compute `Y = X B` for a small dense matrix `B`.
+///
+/// The product is computed for all local entries, including ghosts, so
+/// no communication is required and ghost values remain consistent if
+/// they were up-to-date in `X`.
+///
+/// @param[in] X A set of `m` vectors
+/// @param[in] B Dense `m x n` matrix (row-major)
+/// @param[out] Y A set of `n` vectors with the same parallel layout as
+/// `X`
+template <typename T, typename C>
+void mult(const MultiVector<T, C>& X, std::span<const T> B,
+          MultiVector<T, C>& Y)
+{
+  const int m = X.num_vectors();
+  const int n = Y.num_vectors();
+  std::span<const T> x = X.array();
+  std::span<T> y = Y.mutable_array();
+  if (x.size() / m != y.size() / n)
+    throw std::runtime_error("Incompatible vector sizes");
+  if (B.size() != std::size_t(m * n))
+    throw std::runtime_error("Incompatible matrix size");
+
+  const std::size_t num_rows = x.size() / m;
+  for (std::size_t k = 0; k < num_rows; ++k)
+  {
+    std::span<T> yk = y.subspan(k * n, n);
+    std::ranges::fill(yk, T(0));
+    for (int i = 0; i < m; ++i)
+    {
+      const T xki = x[k * m + i];
+      for (int j = 0; j < n; ++j)
+        yk[j] += xki * B[i * n + j];
+    }
+  }
+}
+
+namespace impl
+{
+/// @brief Compute the Cholesky factor `R` of a dense Hermitian matrix,
+/// with `A = R^{H} R` and `R` upper triangular.
+/// @param[in,out] A Dense `n x n` matrix (row-major). On return holds
+/// `R`, with zeros below the diagonal.
+/// @param[in] n Size of the matrix
+/// @param[in] eps Tolerance for the pivots, relative to the largest
+/// diagonal entry of `A`
+/// @return `false` if a pivot is smaller than the tolerance, i.e. `A`
+/// is not (numerically) positive definite
+template <typename T>
+bool cholesky(std::span<T> A, int n, dolfinx::scalar_value_type_t<T> eps)
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  U scale = 0;
+  for (int i = 0; i < n; ++i)
+    scale = std::max(scale, std::abs(A[i * n + i]));
+
+  for (int j = 0; j < n; ++j)
+  {
+    U d = std::real(A[j * n + j]);
+    for (int i = 0; i < j; ++i)
+      d -= std::norm(A[i * n + j]);
+    if (d <= eps * scale)
+      return false;
+    d = std::sqrt(d);
+    A[j * n + j] = d;
+
+    for (int k = j + 1; k < n; ++k)
+    {
+      T r = A[j * n + k];
+      for (int i = 0; i < j; ++i)
+        r -= conj(A[i * n + j]) * A[i * n + k];
+      A[j * n + k] = r / d;
+    }
+    for (int k = 0; k < j; ++k)
+      A[j * n + k] = 0;
+  }
+
+  return true;
+}
+} // namespace impl
+
+/// @brief Orthonormalise a set of vectors.
+///
+/// Uses CholQR2: the Gram matrix `G = X^{H} X` is computed with a
+/// single reduction, `X` is replaced by `X R^{-1}` where `G = R^{H} R`
+/// is the Cholesky factorisation, and the procedure is repeated once to
+/// recover orthogonality lost to rounding. This requires two
+/// reductions in total, independent of the number of vectors, rather
+/// than the two per vector of la::orthonormalize for a set of
+/// la::Vector.
+///
+/// All local entries, including ghosts, are transformed.
+///
+/// @note Collective MPI operation
+/// @param[in,out] X The set of vectors to orthonormalise
+/// @return Upper triangular `R` (row-major) such that the original
+/// vectors are `X R`
+template <typename T, typename C>
+std::vector<T> orthonormalize(MultiVector<T, C>& X)
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  const int n = X.num_vectors();
+  std::span<T> x = X.mutable_array();
+  const std::size_t num_rows = x.size() / n;
+
+  std::vector<T> R(n * n, 0);
+  for (int i = 0; i < n; ++i)
+    R[i * n + i] = 1;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    std::vector<T> G = inner_products(X, X);
+    if (!impl::cholesky(std::span(G), n,
+                        10 * n * std::numeric_limits<U>::epsilon()))
+    {
+      throw std::runtime_error(
+          "Linear dependency detected. Cannot orthogonalize.");
+    }
+
+    // x_k <- x_k R_p^{-1} for each row k (triangular solve)
+    for (std::size_t k = 0; k < num_rows; ++k)
+    {
+      std::span<T> xk = x.subspan(k * n, n);
+      for (int j = 0; j < n; ++j)
+      {
+        T v = xk[j];
+        for (int i = 0; i < j; ++i)
+          v -= xk[i] * G[i * n + j];
+        xk[j] = v / G[j * n + j];
+      }
+    }
+
+    // R <- R_p R
+    std::vector<T> R0 = R;
+    std::ranges::fill(R, T(0));
+    for (int i = 0; i < n; ++i)
+      for (int k = i; k < n; ++k)
+        for (int j = k; j < n; ++j)
+          R[i * n + j] += G[i * n + k] * R0[k * n + j];
+  }
+
+  return R;
+}
+
+/// @brief Scatter local data of several vectors to ghost positions on
+/// other ranks, with one message per neighbouring rank.
+///
+/// The vectors must share the same index map and block size `bs`. The
+/// scatterer must be created for the index map with block size
+/// `x.size() * bs`, and can be re-used for all scatters of the vectors.
+///
+/// @note Collective MPI operation
+/// @param[in,out] x Vectors to update the ghost entries of
+/// @param[in] scatterer Scatterer for the aggregated data
+template <typename V>
+void scatter_fwd(const std::vector<std::reference_wrapper<V>>& x,
+                 const common::Scatterer<>& scatterer)
+{
+  using T = typename V::value_type;
+  if (x.empty())
+    return;
+
+  const int n = x.size();
+  const int bs = x.front().get().bs();
+  auto map = x.front().get().index_map();
+  if (scatterer.bs() != n * bs)
+    throw std::runtime_error("Incompatible scatterer block size.");
+  const std::int32_t local_size = bs * map->size_local();
+
+  // Entry i of vector j is at position i * n + j in the aggregated
+  // layout
+  std::vector<T> send(scatterer.local_buffer_size());
+  std::span<const std::int32_t> local_inds = scatterer.local_indices();
+  for (std::size_t i = 0; i < local_inds.size(); ++i)
+  {
+    const std::int32_t k = local_inds[i] / n;
+    const int j = local_inds[i] % n;
+    send[i] = x[j].get().array()[k];
+  }
+
+  std::vector<T> recv(scatterer.remote_buffer_size());
+  std::vector<MPI_Request> requests = scatterer.create_request_vector();
+  scatterer.scatter_fwd_begin(std::span<const T>(send), std::span<T>(recv),
+                              std::span<MPI_Request>(requests));
+  scatterer.scatter_fwd_end(std::span<MPI_Request>(requests));
+
+  std::span<const std::int32_t> remote_inds = scatterer.remote_indices();
+  for (std::size_t i = 0; i < remote_inds.size(); ++i)
+  {
+    const std::int32_t k = remote_inds[i] / n;
+    const int j = remote_inds[i] % n;
+    x[j].get().mutable_array()[local_size + k] = recv[i];
+  }
+}
+
+/// @brief Scatter ghost data of several vectors to the owners, with one
+/// message per neighbouring rank.
+///
+/// See scatter_fwd for the requirements on the vectors and scatterer.
+///
+/// @note Collective MPI operation
+/// @param[in,out] x Vectors to update the owned entries of
+/// @param[in] scatterer Scatterer for the aggregated data
+/// @param[in] op The operation to perform when adding/setting received
+/// values (add or insert)
+template <typename V, class BinaryOperation>
+void scatter_rev(const std::vector<std::reference_wrapper<V>>& x,
+                 const common::Scatterer<>& scatterer, BinaryOperation op)
+{
+  using T = typename V::value_type;
+  if (x.empty())
+    return;
+
+  const int n = x.size();
+  const int bs = x.front().get().bs();
+  auto map = x.front().get().index_map();
+  if (scatterer.bs() != n * bs)
+    throw std::runtime_error("Incompatible scatterer block size.");
+  const std::int32_t local_size = bs * map->size_local();
+
+  std::vector<T> send(scatterer.remote_buffer_size());
+  std::span<const std::int32_t> remote_inds = scatterer.remote_indices();
+  for (std::size_t i = 0; i < remote_inds.size(); ++i)
+  {
+    const std::int32_t k = remote_inds[i] / n;
+    const int j = remote_inds[i] % n;
+    send[i] = x[j].get().array()[local_size + k];
+  }
+
+  std::vector<T> recv(scatterer.local_buffer_size());
+  std::vector<MPI_Request> requests = scatterer.create_request_vector();
+  scatterer.scatter_rev_begin(std::span<const T>(send), std::span<T>(recv),
+                              std::span<MPI_Request>(requests));
+  scatterer.scatter_rev_end(std::span<MPI_Request>(requests));
+
+  std::span<const std::int32_t> local_inds = scatterer.local_indices();
+  for (std::size_t i = 0; i < local_inds.size(); ++i)
+  {
+    const std::int32_t k = local_inds[i] / n;
+    const int j = local_inds[i] % n;
+    T& xk = x[j].get().mutable_array()[k];
+    xk = op(xk, recv[i]);
+  }
+}
+
+} // namespace dolfinx::la
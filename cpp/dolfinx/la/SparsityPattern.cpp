@@ -11,10 +11,36 @@
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <map>
+#include <numeric>
+#include <span>
 
 using namespace dolfinx;
 using namespace dolfinx::la;
 
+namespace
+{
+/// @brief Append column indices to a row of the insertion cache.
+///
+/// Cells that share a degree-of-freedom insert the same column indices
+/// many times. When the storage of a row is full, duplicates are
+/// removed before the storage is grown, which keeps the memory of the
+/// cache close to the number of unique entries. The storage is grown if
+/// less than half of it is free after removing the duplicates, so that
+/// the cost of removing duplicates is amortised.
+void append(std::vector<std::int32_t>& row,
+            std::span<const std::int32_t> cols)
+{
+  if (row.size() + cols.size() > row.capacity() and row.size() >= 16)
+  {
+    std::ranges::sort(row);
+    row.erase(std::ranges::unique(row).begin(), row.end());
+    if (2 * (row.size() + cols.size()) > row.capacity())
+      row.reserve(2 * (row.size() + cols.size()));
+  }
+  row.insert(row.end(), cols.begin(), cols.end());
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(
     MPI_Comm comm,
@@ -158,7 +184,7 @@ void SparsityPattern::insert(std::int32_t row, std::int32_t col)
         "Cannot insert rows that do not exist in the IndexMap.");
   }
 
-  _row_cache[row].push_back(col);
+  append(_row_cache[row], std::span(&col, 1));
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::insert(std::span<const std::int32_t> rows,
@@ -181,7 +207,7 @@ void SparsityPattern::insert(std::span<const std::int32_t> rows,
       throw std::runtime_error(
           "Cannot insert rows that do not exist in the IndexMap.");
     }
-    _row_cache[row].insert(_row_cache[row].end(), cols.begin(), cols.end());
+    append(_row_cache[row], cols);
   }
 }
 //-----------------------------------------------------------------------------
@@ -205,7 +231,7 @@ void SparsityPattern::insert_diagonal(std::span<const std::int32_t> rows)
           "Cannot insert rows that do not exist in the IndexMap.");
     }
 
-    _row_cache[row].push_back(row);
+    append(_row_cache[row], std::span(&row, 1));
   }
 }
 //-----------------------------------------------------------------------------
@@ -357,7 +383,7 @@ void SparsityPattern::finalize()
     {
       // Convert to local column index
       const std::int32_t J = col - local_range1[0];
-      _row_cache[row_local].push_back(J);
+      append(_row_cache[row_local], std::span(&J, 1));
     }
     else
     {
@@ -371,27 +397,36 @@ void SparsityPattern::finalize()
       }
 
       const std::int32_t col_local = it.first->second;
-      _row_cache[row_local].push_back(col_local);
+      append(_row_cache[row_local], std::span(&col_local, 1));
     }
   }
 
-  // Sort and remove duplicate column indices in each row
+  // Sort and remove duplicate column indices in each row, and count
+  // the entries
   std::vector<std::int32_t> adj_counts(local_size0 + owners0.size(), 0);
   _off_diagonal_offsets.resize(local_size0 + owners0.size());
   for (std::size_t i = 0; i < local_size0 + owners0.size(); ++i)
   {
     std::vector<std::int32_t>& row = _row_cache[i];
     std::ranges::sort(row);
-    auto it_end = std::ranges::unique(row).begin();
+    row.erase(std::ranges::unique(row).begin(), row.end());
 
     // Find position of first "off-diagonal" column
     _off_diagonal_offsets[i] = std::distance(
-        row.begin(), std::lower_bound(row.begin(), it_end, local_size1));
+        row.begin(), std::ranges::lower_bound(row, local_size1));
+    adj_counts[i] = row.size();
+  }
 
-    _edges.insert(_edges.end(), row.begin(), it_end);
-    adj_counts[i] += std::distance(row.begin(), it_end);
+  // Copy rows into the adjacency list, releasing the memory of each row
+  // after it has been copied, so that the peak memory is close to the
+  // size of the final pattern
+  _edges.reserve(std::accumulate(adj_counts.begin(), adj_counts.end(),
+                                 std::int64_t(0)));
+  for (std::size_t i = 0; i < local_size0 + owners0.size(); ++i)
+  {
+    _edges.insert(_edges.end(), _row_cache[i].begin(), _row_cache[i].end());
+    std::vector<std::int32_t>().swap(_row_cache[i]);
   }
-  // Clear cache
   std::vector<std::vector<std::int32_t>>().swap(_row_cache);
 
   // Compute offsets for adjacency list
@@ -401,8 +436,8 @@ void SparsityPattern::finalize()
   _edges.shrink_to_fit();
 
   // Column count increased due to received rows from other processes
-  spdlog::info("Column ghost size increased from {} to {}",
-               _index_maps[1]->ghosts().size(), _col_ghosts.size());
+  DOLFINX_LOG_INFO("Column ghost size increased from {} to {}",
+                   _index_maps[1]->ghosts().size(), _col_ghosts.size());
 }
 //-----------------------------------------------------------------------------
 std::int64_t SparsityPattern::num_nonzeros() const
@@ -443,3 +478,15 @@ std::span<const std::int32_t> SparsityPattern::off_diagonal_offsets() const
 //-----------------------------------------------------------------------------
 MPI_Comm SparsityPattern::comm() const { return _comm.comm(); }
 //-----------------------------------------------------------------------------
+common::MemoryUsage SparsityPattern::memory_usage() const
+{
+  common::MemoryUsage usage{"SparsityPattern", sizeof(*this), {}};
+  usage.add("row cache", common::capacity_bytes(_row_cache));
+  usage.add("graph", common::capacity_bytes(_edges)
+                         + common::capacity_bytes(_offsets)
+                         + common::capacity_bytes(_off_diagonal_offsets));
+  usage.add("ghost columns", common::capacity_bytes(_col_ghosts)
+                                 + common::capacity_bytes(_col_ghost_owners));
+  return usage;
+}
+//-----------------------------------------------------------------------------
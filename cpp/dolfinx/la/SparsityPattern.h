@@ -7,6 +7,7 @@
 #pragma once
 
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
 #include <memory>
 #include <span>
 #include <utility>
@@ -80,6 +81,7 @@ public:
   ///
   /// @param[in] rows list of the local row indices 
   /// @param[in] cols list of the local column indices
+  /// @note Concurrent calls that insert into distinct rows are safe.
   void insert(std::span<const std::int32_t> rows,
               std::span<const std::int32_t> cols);
 
@@ -147,6 +149,14 @@ public:
   /// Return MPI communicator
   MPI_Comm comm() const;
 
+  /// @brief Memory used by the sparsity pattern.
+  ///
+  /// The index maps, which are shared with the dofmaps, are not
+  /// included.
+  /// @return Memory usage, with the row cache (unassembled entries),
+  /// the graph and the ghost columns as parts
+  common::MemoryUsage memory_usage() const;
+
 private:
   // MPI communicator
   dolfinx::MPI::Comm _comm;
@@ -6,18 +6,28 @@
 
 #pragma once
 
+#include "scatter_tuning.h"
 #include "utils.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/types.h>
 #include <limits>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <span>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::la
@@ -42,109 +52,368 @@ public:
   static_assert(std::is_same_v<value_type, typename container_type::value_type>,
                 "Scalar type and container value type must be the same.");
 
-  /// Create a distributed vector
+  /// @brief Create a distributed vector with the default communication
+  /// pattern for ghost updates.
+  ///
+  /// The pattern is common::Scatterer::type::neighbor, or the fastest
+  /// pattern for the index map and block size if autotuning is enabled
+  /// (see set_scatter_autotuning and tune_scatter_type).
+  ///
   /// @param map IndexMap for parallel distribution of the data
   /// @param bs Block size
   Vector(std::shared_ptr<const common::IndexMap> map, int bs)
-      : _map(map), _scatterer(std::make_shared<common::Scatterer<>>(*_map, bs)),
-        _bs(bs), _buffer_local(_scatterer->local_buffer_size()),
+      : Vector(map, bs, default_type(map, bs))
+  {
+  }
+
+  /// Create a distributed vector
+  /// @param map IndexMap for parallel distribution of the data
+  /// @param bs Block size
+  /// @param type MPI communication pattern used for ghost updates. With
+  /// common::Scatterer::type::persistent the MPI requests for the
+  /// ghost update buffers of the vector are created once and re-used.
+  /// With common::Scatterer::type::shared the data is allocated in a
+  /// shared memory window (common::SharedWindow), and ghost updates
+  /// with ranks on the same node read the data of the other rank
+  /// directly. This requires a `std::pmr::vector` container.
+  Vector(std::shared_ptr<const common::IndexMap> map, int bs,
+         common::Scatterer<>::type type)
+      : _map(map), _scatterer(create_scatterer(*_map, bs, type)), _bs(bs),
+        _type(type), _buffer_local(_scatterer->local_buffer_size()),
         _buffer_remote(_scatterer->remote_buffer_size()),
-        _x(bs * (map->size_local() + map->num_ghosts()))
+        _window(create_window(*_map, bs, type)),
+        _x(create_data(bs * (map->size_local() + map->num_ghosts())))
   {
+    create_requests();
   }
 
-  /// Copy constructor
+  /// @brief Create a distributed vector with the data and ghost update
+  /// buffers allocated by an allocator.
+  ///
+  /// For example, a vector with a `std::pmr::vector` container can
+  /// allocate from a pool, from memory that is registered with MPI or
+  /// from memory that is placed on the NUMA nodes of the threads that
+  /// work on it (common::FirstTouchResource), see common/memory.h.
+  ///
+  /// @param map IndexMap for parallel distribution of the data
+  /// @param bs Block size
+  /// @param type MPI communication pattern used for ghost updates.
+  /// @param alloc Allocator for the container
+  template <typename Allocator>
+  Vector(std::shared_ptr<const common::IndexMap> map, int bs,
+         common::Scatterer<>::type type, const Allocator& alloc)
+      : _map(map), _scatterer(create_scatterer(*_map, bs, type)), _bs(bs),
+        _type(type), _buffer_local(_scatterer->local_buffer_size(), alloc),
+        _buffer_remote(_scatterer->remote_buffer_size(), alloc),
+        _window(create_window(*_map, bs, type)),
+        _x(create_data(bs * (map->size_local() + map->num_ghosts()), alloc))
+  {
+    create_requests();
+  }
+
+  /// @brief Copy constructor.
+  /// @note Collective for vectors with
+  /// common::Scatterer::type::shared, which allocate a new window.
   Vector(const Vector& x)
-      : _map(x._map), _scatterer(x._scatterer), _bs(x._bs),
-        _request(1, MPI_REQUEST_NULL), _buffer_local(x._buffer_local),
-        _buffer_remote(x._buffer_remote), _x(x._x)
+      : _map(x._map), _scatterer(x._scatterer), _bs(x._bs), _type(x._type),
+        _buffer_local(x._buffer_local), _buffer_remote(x._buffer_remote),
+        _window(create_window(*_map, _bs, _type)),
+        _x(_window ? create_data(x._x.size()) : container_type(x._x)),
+        _modified(x._modified)
+  {
+    if (_window)
+      std::ranges::copy(x._x, _x.begin());
+    create_requests();
+  }
+
+  /// @brief Create a copy of a vector with a different scalar type.
+  ///
+  /// The values are converted to `T`. The index map and scatterer are
+  /// shared with `x`, so no communication is required to create the
+  /// vector. This supports mixed precision computations, e.g. ghost
+  /// updates in reduced precision.
+  /// @param[in] x Vector to copy
+  template <typename S, typename C>
+  explicit Vector(const Vector<S, C>& x)
+      : _map(x._map), _scatterer(x._scatterer), _bs(x._bs), _type(x._type),
+        _buffer_local(_scatterer->local_buffer_size()),
+        _buffer_remote(_scatterer->remote_buffer_size()),
+        _window(create_window(*_map, _bs, _type)),
+        _x(create_data(x._x.size()))
   {
+    std::ranges::transform(x._x, _x.begin(),
+                           [](auto v) { return static_cast<T>(v); });
+    create_requests();
   }
 
   /// Move constructor
   Vector(Vector&& x)
       : _map(std::move(x._map)), _scatterer(std::move(x._scatterer)),
-        _bs(std::move(x._bs)),
+        _bs(std::move(x._bs)), _type(x._type),
         _request(std::exchange(x._request, {MPI_REQUEST_NULL})),
+        _request_rev(std::move(x._request_rev)),
+        _request_fwd(std::move(x._request_fwd)),
         _buffer_local(std::move(x._buffer_local)),
-        _buffer_remote(std::move(x._buffer_remote)), _x(std::move(x._x))
+        _buffer_remote(std::move(x._buffer_remote)),
+        _window(std::move(x._window)), _x(std::move(x._x)),
+        _modified(std::move(x._modified))
   {
   }
 
+  /// Destructor
+  ~Vector() { free_requests(); }
+
   // Assignment operator (disabled)
   Vector& operator=(const Vector& x) = delete;
 
   /// Move Assignment operator
-  Vector& operator=(Vector&& x) = default;
+  Vector& operator=(Vector&& x)
+  {
+    free_requests();
+    _map = std::move(x._map);
+    _scatterer = std::move(x._scatterer);
+    _bs = x._bs;
+    _type = x._type;
+    _request = std::exchange(x._request, {MPI_REQUEST_NULL});
+    _request_rev = std::move(x._request_rev);
+    _request_fwd = std::move(x._request_fwd);
+    _buffer_local = std::move(x._buffer_local);
+    _buffer_remote = std::move(x._buffer_remote);
+    if (_window or x._window)
+    {
+      // The data of a vector in a shared memory window must stay in the
+      // window, so the container is move constructed, which keeps the
+      // allocator, rather than move assigned
+      std::destroy_at(&_x);
+      std::construct_at(&_x, std::move(x._x));
+    }
+    else
+      _x = std::move(x._x);
+    _window = std::move(x._window);
+    _modified = std::move(x._modified);
+    return *this;
+  }
 
   /// Set all entries (including ghosts)
   /// @param[in] v The value to set all entries to (on calling rank)
-  void set(value_type v) { std::ranges::fill(_x, v); }
+  void set(value_type v)
+  {
+    std::ranges::fill(_x, v);
+    ++_version;
+  }
 
-  /// Begin scatter of local data from owner to ghosts on other ranks
+  /// @brief Begin scatter of local data from owner to ghosts on other
+  /// ranks, using a function to pack the send buffer.
+  ///
+  /// The function is called as `pack(x, indices, buffer)`, where `x` is
+  /// the owned part of the vector, and must set `buffer[i] =
+  /// x[indices[i]]`. This allows the buffer to be packed by a device
+  /// kernel when the container holds device memory, in which case the
+  /// indices (Scatterer::local_indices) should be copied to the device
+  /// once by the function object. The buffers are passed directly to MPI,
+  /// which then needs to support device memory (GPU-aware MPI).
+  ///
   /// @note Collective MPI operation
-  void scatter_fwd_begin()
+  /// @param[in] pack Function to pack the send buffer.
+  template <typename Pack>
+  void scatter_fwd_begin(Pack pack)
   {
     const std::int32_t local_size = _bs * _map->size_local();
-    std::span<const value_type> x_local(_x.data(), local_size);
+    pack(std::span<const value_type>(_x.data(), local_size),
+         std::span<const std::int32_t>(_scatterer->local_indices()),
+         std::span<value_type>(_buffer_local));
+    _scatterer->scatter_fwd_begin(std::span<const value_type>(_buffer_local),
+                                  std::span<value_type>(_buffer_remote),
+                                  std::span<MPI_Request>(_request), _type);
+  }
 
+  /// @brief End scatter of local data from owner to ghosts on other
+  /// ranks, using a function to unpack the received data.
+  ///
+  /// The function is called as `unpack(buffer, indices, x)`, where `x`
+  /// is the ghost part of the vector, and must set `x[indices[i]] =
+  /// buffer[i]`. See Vector::scatter_fwd_begin(Pack).
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] unpack Function to unpack the receive buffer.
+  template <typename Unpack>
+  void scatter_fwd_end(Unpack unpack)
+  {
+    const std::int32_t local_size = _bs * _map->size_local();
+    const std::int32_t num_ghosts = _bs * _map->num_ghosts();
+    _scatterer->scatter_fwd_end(std::span<MPI_Request>(_request));
+    unpack(std::span<const value_type>(_buffer_remote),
+           std::span<const std::int32_t>(_scatterer->remote_indices()),
+           std::span<value_type>(_x.data() + local_size, num_ghosts));
+    ++_version;
+  }
+
+  /// @brief Begin scatter of local data from owner to ghosts on other
+  /// ranks.
+  ///
+  /// The data can be communicated in a different (usually lower)
+  /// precision `W`, e.g. `float` for a vector of `double`, which reduces
+  /// the size of the messages. The received values are converted back
+  /// to `value_type`. Scatters with `W` different from `value_type` use
+  /// non-persistent communication.
+  ///
+  /// @note Collective MPI operation
+  /// @tparam W Scalar type used for the communication.
+  template <typename W = value_type>
+  void scatter_fwd_begin()
+  {
     auto pack = [](auto&& in, auto&& idx, auto&& out)
     {
+      using U = std::decay_t<decltype(out[0])>;
       for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
+        out[i] = static_cast<U>(in[idx[i]]);
     };
-    pack(x_local, _scatterer->local_indices(), _buffer_local);
 
-    _scatterer->scatter_fwd_begin(std::span<const value_type>(_buffer_local),
-                                  std::span<value_type>(_buffer_remote),
-                                  std::span<MPI_Request>(_request));
+    if constexpr (std::is_same_v<W, value_type>)
+    {
+      if (_window)
+      {
+        const std::int32_t local_size = _bs * _map->size_local();
+        _scatterer->scatter_fwd_begin(
+            std::span<const value_type>(_x.data(), local_size),
+            std::span<value_type>(_buffer_local),
+            std::span<value_type>(_buffer_remote), *_window,
+            std::span<MPI_Request>(_request));
+      }
+      else
+        scatter_fwd_begin(pack);
+    }
+    else
+    {
+      const std::int32_t local_size = _bs * _map->size_local();
+      std::span<const value_type> x_local(_x.data(), local_size);
+      auto [send, recv] = buffers<W>();
+      pack(x_local, _scatterer->local_indices(), send);
+      _scatterer->scatter_fwd_begin(std::span<const W>(send), recv,
+                                    std::span<MPI_Request>(request_fwd()),
+                                    request_fwd_type());
+    }
   }
 
-  /// End scatter of local data from owner to ghosts on other ranks
+  /// @brief End scatter of local data from owner to ghosts on other
+  /// ranks.
   /// @note Collective MPI operation
+  /// @tparam W Scalar type used for the communication, which must be
+  /// the type passed to Vector::scatter_fwd_begin.
+  template <typename W = value_type>
   void scatter_fwd_end()
   {
-    const std::int32_t local_size = _bs * _map->size_local();
-    const std::int32_t num_ghosts = _bs * _map->num_ghosts();
-    std::span<value_type> x_remote(_x.data() + local_size, num_ghosts);
-    _scatterer->scatter_fwd_end(std::span<MPI_Request>(_request));
-
-    auto unpack = [](auto&& in, auto&& idx, auto&& out, auto op)
+    auto unpack = [](auto&& in, auto&& idx, auto&& out)
     {
       for (std::size_t i = 0; i < idx.size(); ++i)
-        out[idx[i]] = op(out[idx[i]], in[i]);
+        out[idx[i]] = static_cast<value_type>(in[i]);
     };
 
-    unpack(_buffer_remote, _scatterer->remote_indices(), x_remote,
-           [](auto /*a*/, auto b) { return b; });
+    if constexpr (std::is_same_v<W, value_type>)
+    {
+      if (_window)
+      {
+        const std::int32_t local_size = _bs * _map->size_local();
+        const std::int32_t num_ghosts = _bs * _map->num_ghosts();
+        _scatterer->scatter_fwd_end(
+            std::span<const value_type>(_buffer_remote),
+            std::span<value_type>(_x.data() + local_size, num_ghosts),
+            *_window, std::span<MPI_Request>(_request));
+        ++_version;
+      }
+      else
+        scatter_fwd_end(unpack);
+    }
+    else
+    {
+      const std::int32_t local_size = _bs * _map->size_local();
+      const std::int32_t num_ghosts = _bs * _map->num_ghosts();
+      std::span<value_type> x_remote(_x.data() + local_size, num_ghosts);
+      _scatterer->scatter_fwd_end(std::span<MPI_Request>(request_fwd()));
+      unpack(buffers<W>()[1], _scatterer->remote_indices(), x_remote);
+      ++_version;
+    }
   }
 
-  /// Scatter local data to ghost positions on other ranks
+  /// @brief Scatter local data to ghost positions on other ranks.
   /// @note Collective MPI operation
+  /// @tparam W Scalar type used for the communication, see
+  /// Vector::scatter_fwd_begin.
+  template <typename W = value_type>
   void scatter_fwd()
   {
-    this->scatter_fwd_begin();
-    this->scatter_fwd_end();
+    this->template scatter_fwd_begin<W>();
+    this->template scatter_fwd_end<W>();
   }
 
-  /// Start scatter of  ghost data to owner
+  /// @brief Start scatter of ghost data to owner, using a function to
+  /// pack the send buffer.
+  ///
+  /// The function is called as `pack(x, indices, buffer)`, where `x` is
+  /// the ghost part of the vector, and must set `buffer[i] =
+  /// x[indices[i]]`. See Vector::scatter_fwd_begin(Pack).
+  ///
   /// @note Collective MPI operation
-  void scatter_rev_begin()
+  /// @param[in] pack Function to pack the send buffer.
+  template <typename Pack>
+  void scatter_rev_begin(Pack pack)
   {
     const std::int32_t local_size = _bs * _map->size_local();
     const std::int32_t num_ghosts = _bs * _map->num_ghosts();
-    std::span<value_type> x_remote(_x.data() + local_size, num_ghosts);
+    pack(std::span<const value_type>(_x.data() + local_size, num_ghosts),
+         std::span<const std::int32_t>(_scatterer->remote_indices()),
+         std::span<value_type>(_buffer_remote));
+    _scatterer->scatter_rev_begin(std::span<const value_type>(_buffer_remote),
+                                  std::span<value_type>(_buffer_local),
+                                  std::span<MPI_Request>(request_rev()),
+                                  _type);
+  }
 
-    auto pack = [](auto&& in, auto&& idx, auto&& out)
+  /// Start scatter of  ghost data to owner
+  /// @note Collective MPI operation
+  void scatter_rev_begin()
+  {
+    if (_window)
     {
-      for (std::size_t i = 0; i < idx.size(); ++i)
-        out[i] = in[idx[i]];
-    };
-    pack(x_remote, _scatterer->remote_indices(), _buffer_remote);
+      const std::int32_t local_size = _bs * _map->size_local();
+      const std::int32_t num_ghosts = _bs * _map->num_ghosts();
+      _scatterer->scatter_rev_begin(
+          std::span<const value_type>(_x.data() + local_size, num_ghosts),
+          std::span<value_type>(_buffer_remote),
+          std::span<value_type>(_buffer_local), *_window,
+          std::span<MPI_Request>(_request));
+      return;
+    }
 
-    _scatterer->scatter_rev_begin(std::span<const value_type>(_buffer_remote),
-                                  std::span<value_type>(_buffer_local),
-                                  _request);
+    scatter_rev_begin(
+        [](auto&& in, auto&& idx, auto&& out)
+        {
+          for (std::size_t i = 0; i < idx.size(); ++i)
+            out[i] = in[idx[i]];
+        });
+  }
+
+  /// @brief End scatter of ghost data to owner, using a function to
+  /// unpack the received data.
+  ///
+  /// The function is called as `unpack(buffer, indices, x, op)`, where
+  /// `x` is the owned part of the vector, and must set `x[indices[i]] =
+  /// op(x[indices[i]], buffer[i])` in order of `i`, as an index can
+  /// appear more than once. See Vector::scatter_fwd_begin(Pack).
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] unpack Function to unpack the receive buffer.
+  /// @param[in] op The operation to perform when adding/setting received
+  /// values (add or insert)
+  template <typename Unpack, class BinaryOperation>
+  void scatter_rev_end(Unpack unpack, BinaryOperation op)
+  {
+    const std::int32_t local_size = _bs * _map->size_local();
+    _scatterer->scatter_rev_end(std::span<MPI_Request>(request_rev()));
+    unpack(std::span<const value_type>(_buffer_local),
+           std::span<const std::int32_t>(_scatterer->local_indices()),
+           std::span<value_type>(_x.data(), local_size), op);
+    ++_version;
   }
 
   /// End scatter of ghost data to owner. This process may receive data
@@ -156,16 +425,23 @@ public:
   template <class BinaryOperation>
   void scatter_rev_end(BinaryOperation op)
   {
-    const std::int32_t local_size = _bs * _map->size_local();
-    std::span<value_type> x_local(_x.data(), local_size);
-    _scatterer->scatter_rev_end(_request);
+    if (_window)
+    {
+      const std::int32_t local_size = _bs * _map->size_local();
+      _scatterer->scatter_rev_end(
+          std::span<const value_type>(_buffer_local),
+          std::span<value_type>(_x.data(), local_size), op, *_window,
+          std::span<MPI_Request>(_request));
+      ++_version;
+      return;
+    }
 
     auto unpack = [](auto&& in, auto&& idx, auto&& out, auto op)
     {
       for (std::size_t i = 0; i < idx.size(); ++i)
         out[idx[i]] = op(out[idx[i]], in[i]);
     };
-    unpack(_buffer_local, _scatterer->local_indices(), x_local, op);
+    scatter_rev_end(unpack, op);
   }
 
   /// Scatter ghost data to owner. This process may receive data from
@@ -192,10 +468,223 @@ public:
     return std::span<const value_type>(_x);
   }
 
-  /// Get local part of the vector
-  std::span<value_type> mutable_array() { return std::span(_x); }
+  /// @brief Get local part of the vector.
+  ///
+  /// Increments the version of the vector, see Vector::version.
+  std::span<value_type> mutable_array()
+  {
+    ++_version;
+    return std::span(_x);
+  }
+
+  /// @brief Modification counter of the vector.
+  ///
+  /// The counter is incremented when the entries can be modified
+  /// through the vector interface, i.e. by Vector::set, Vector::mutable_array
+  /// and the ghost scatters. Data that is cached from the vector, e.g.
+  /// packed coefficients, is up to date if the version is unchanged.
+  /// Modifying the entries through a span that was obtained with
+  /// Vector::mutable_array before the version was recorded is not
+  /// detected.
+  std::uint64_t version() const { return _version; }
+
+  /// @brief Increment the version of the vector.
+  ///
+  /// Call after modifying the entries through a span that was obtained
+  /// with Vector::mutable_array before the version was last recorded,
+  /// so that data cached from the vector is invalidated.
+  void mark_modified() { ++_version; }
+
+  /// @brief Mark owned entries as modified for the next delta ghost
+  /// update (see Vector::scatter_fwd_delta).
+  ///
+  /// Also increments the version of the vector.
+  /// @param[in] indices Owned (block) indices whose entries have been
+  /// modified. Ghost indices are ignored.
+  void mark_modified(std::span<const std::int32_t> indices)
+  {
+    const std::int32_t size_local = _map->size_local();
+    _modified.resize(size_local, 0);
+    for (std::int32_t i : indices)
+    {
+      if (i < size_local)
+        _modified[i] = 1;
+    }
+    ++_version;
+  }
+
+  /// @brief Scatter the modified owned entries to the ghost positions on
+  /// other ranks (delta scatter).
+  ///
+  /// Only the entries marked with Vector::mark_modified since the last
+  /// delta scatter are sent (see common::Scatterer::scatter_fwd_delta),
+  /// so the communication volume follows the modified entries. The
+  /// markers are cleared. The ghost entries of unmodified indices must
+  /// be up to date, e.g. from a previous Vector::scatter_fwd.
+  ///
+  /// @note Collective MPI operation
+  /// @param[in] threshold Fraction of modified shared entries for a
+  /// neighbour above which all entries for the neighbour are sent.
+  void scatter_fwd_delta(double threshold = 0.5)
+  {
+    const std::int32_t local_size = _bs * _map->size_local();
+    const std::int32_t num_ghosts = _bs * _map->num_ghosts();
+    _modified.resize(_map->size_local(), 0);
+    _scatterer->scatter_fwd_delta(
+        std::span<const value_type>(_x.data(), local_size),
+        std::span<value_type>(_x.data() + local_size, num_ghosts),
+        std::span<const std::int8_t>(_modified), threshold);
+    std::ranges::fill(_modified, 0);
+    ++_version;
+  }
+
+  /// @brief Memory used by the vector.
+  ///
+  /// The index map, which is shared with the dofmap, is not included.
+  /// The scatterer, which may be shared with copies of the vector, is
+  /// included.
+  /// @return Memory usage, with the values, the scatter buffers and
+  /// the scatterer as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"Vector", sizeof(*this), {}};
+    usage.add("values", common::capacity_bytes(_x));
+    usage.add("scatter buffers", common::capacity_bytes(_buffer_local)
+                                     + common::capacity_bytes(_buffer_remote)
+                                     + common::capacity_bytes(_buffer_bytes));
+    if (_scatterer)
+      usage.add(_scatterer->memory_usage());
+    return usage;
+  }
 
 private:
+  template <typename, typename>
+  friend class Vector;
+
+  // Default communication pattern for ghost updates
+  static common::Scatterer<>::type
+  default_type(const std::shared_ptr<const common::IndexMap>& map, int bs)
+  {
+    if (scatter_autotuning())
+      return tune_scatter_type(map, bs, sizeof(T));
+    else
+      return common::Scatterer<>::type::neighbor;
+  }
+
+  // Create the scatterer, with the positions of ghost data on other
+  // ranks of the node for shared memory ghost updates
+  static std::shared_ptr<const common::Scatterer<>>
+  create_scatterer(const common::IndexMap& map, int bs,
+                   common::Scatterer<>::type type)
+  {
+    return std::make_shared<common::Scatterer<>>(
+        map, bs, std::allocator<std::int32_t>(),
+        type == common::Scatterer<>::type::shared);
+  }
+
+  // Create the shared memory window for the data of a vector with
+  // shared memory ghost updates, otherwise return nullptr
+  static std::shared_ptr<common::SharedWindow>
+  create_window(const common::IndexMap& map, int bs,
+                common::Scatterer<>::type type)
+  {
+    if (type != common::Scatterer<>::type::shared)
+      return nullptr;
+    if constexpr (!std::is_same_v<container_type, std::pmr::vector<T>>)
+    {
+      throw std::runtime_error("Shared memory ghost updates require a "
+                               "std::pmr::vector container");
+    }
+    else
+    {
+      const std::size_t n = bs * (map.size_local() + map.num_ghosts());
+      return std::make_shared<common::SharedWindow>(map.comm(),
+                                                    n * sizeof(T));
+    }
+  }
+
+  // Create the container for the vector data, in the shared memory
+  // window if there is one
+  template <typename... Allocator>
+  container_type create_data(std::size_t n, const Allocator&... alloc) const
+  {
+    if constexpr (std::is_same_v<container_type, std::pmr::vector<T>>)
+    {
+      if (_window)
+        return container_type(n, _window.get());
+    }
+    return container_type(n, alloc...);
+  }
+
+  // Create the MPI requests for ghost updates
+  void create_requests()
+  {
+    if (_type == common::Scatterer<>::type::persistent)
+    {
+      _request = _scatterer->create_persistent_fwd_requests(
+          std::span<const value_type>(_buffer_local),
+          std::span<value_type>(_buffer_remote));
+      _request_rev = _scatterer->create_persistent_rev_requests(
+          std::span<const value_type>(_buffer_remote),
+          std::span<value_type>(_buffer_local));
+    }
+    else
+      _request = _scatterer->create_request_vector(_type);
+  }
+
+  // Free persistent MPI requests
+  void free_requests()
+  {
+    if (_type == common::Scatterer<>::type::persistent)
+    {
+      common::Scatterer<>::free_requests(_request);
+      common::Scatterer<>::free_requests(_request_rev);
+    }
+  }
+
+  // Requests for reverse scatters
+  std::vector<MPI_Request>& request_rev()
+  {
+    return _type == common::Scatterer<>::type::persistent ? _request_rev
+                                                          : _request;
+  }
+
+  // Communication pattern for forward scatters in a precision other
+  // than value_type
+  common::Scatterer<>::type request_fwd_type() const
+  {
+    return _type == common::Scatterer<>::type::persistent
+                   or _type == common::Scatterer<>::type::shared
+               ? common::Scatterer<>::type::neighbor
+               : _type;
+  }
+
+  // Requests for forward scatters in a precision other than
+  // value_type
+  std::vector<MPI_Request>& request_fwd()
+  {
+    if (_type != common::Scatterer<>::type::persistent
+        and _type != common::Scatterer<>::type::shared)
+    {
+      return _request;
+    }
+    if (_request_fwd.empty())
+      _request_fwd = _scatterer->create_request_vector(request_fwd_type());
+    return _request_fwd;
+  }
+
+  // Send (0) and receive (1) buffers for forward scatters in precision
+  // W, stored in _buffer_bytes
+  template <typename W>
+  std::array<std::span<W>, 2> buffers()
+  {
+    const std::size_t n0 = _buffer_local.size();
+    const std::size_t n1 = _buffer_remote.size();
+    _buffer_bytes.resize((n0 + n1) * sizeof(W));
+    W* data = reinterpret_cast<W*>(_buffer_bytes.data());
+    return {std::span<W>(data, n0), std::span<W>(data + n0, n1)};
+  }
+
   // Map describing the data layout
   std::shared_ptr<const common::IndexMap> _map;
 
@@ -205,14 +694,131 @@ private:
   // Block size
   int _bs;
 
-  // MPI request handle
+  // Communication pattern for ghost updates
+  common::Scatterer<>::type _type;
+
+  // MPI request handles. For persistent communication, _request is
+  // used for forward and _request_rev for reverse scatters.
   std::vector<MPI_Request> _request = {MPI_REQUEST_NULL};
+  std::vector<MPI_Request> _request_rev;
+
+  // Requests for forward scatters in a different precision when
+  // _request holds persistent requests
+  std::vector<MPI_Request> _request_fwd;
 
   // Buffers for ghost scatters
   container_type _buffer_local, _buffer_remote;
 
+  // Buffers for forward scatters in a different precision
+  std::vector<std::byte> _buffer_bytes;
+
+  // Shared memory window that holds the vector data, for shared memory
+  // ghost updates. It must be declared before _x, which uses it.
+  std::shared_ptr<common::SharedWindow> _window;
+
   // Vector data
   container_type _x;
+
+  // Modification counter
+  std::uint64_t _version = 0;
+
+  // Markers of the owned indices modified since the last delta scatter
+  std::vector<std::int8_t> _modified;
+};
+
+namespace impl
+{
+/// Complex conjugate, preserving the type for real scalars
+template <typename T>
+T conj(T x)
+{
+  if constexpr (std::is_floating_point_v<T>)
+    return x;
+  else
+    return std::conj(x);
+}
+
+/// Compute `a^{H} b` for the owned entries on the calling rank
+template <class V>
+typename V::value_type local_inner_product(const V& a, const V& b)
+{
+  using T = typename V::value_type;
+  const std::int32_t local_size = a.bs() * a.index_map()->size_local();
+  if (local_size != b.bs() * b.index_map()->size_local())
+    throw std::runtime_error("Incompatible vector sizes");
+  std::span<const T> x_a = a.array().subspan(0, local_size);
+  std::span<const T> x_b = b.array().subspan(0, local_size);
+  return std::transform_reduce(x_a.begin(), x_a.end(), x_b.begin(),
+                               static_cast<T>(0), std::plus{},
+                               [](T a, T b) -> T { return conj(a) * b; });
+}
+} // namespace impl
+
+/// @brief Non-blocking sum of values across processes.
+///
+/// The reduction is started on construction and is completed by
+/// Reduction::wait. This allows the latency of the reduction to be
+/// hidden behind other work, e.g. a matrix-vector product. Reductions
+/// are created by the `*_begin` functions, e.g. inner_products_begin.
+///
+/// @tparam T Scalar type
+template <typename T>
+class Reduction
+{
+public:
+  /// @brief Start the sum of values across processes.
+  /// @param[in] local Values on the calling process.
+  /// @param[in] comm Communicator to sum over.
+  /// @note Collective MPI operation
+  Reduction(std::vector<T> local, MPI_Comm comm)
+      : _local(std::move(local)), _global(_local.size())
+  {
+    MPI_Iallreduce(_local.data(), _global.data(), _local.size(),
+                   dolfinx::MPI::mpi_type<T>(), MPI_SUM, comm, &_request);
+  }
+
+  /// Move constructor
+  Reduction(Reduction&& r)
+      : _local(std::move(r._local)), _global(std::move(r._global)),
+        _request(std::exchange(r._request, MPI_REQUEST_NULL))
+  {
+  }
+
+  // Copy constructor (deleted)
+  Reduction(const Reduction& r) = delete;
+
+  /// Destructor. Waits for completion if the reduction is pending.
+  ~Reduction()
+  {
+    if (_request != MPI_REQUEST_NULL)
+      MPI_Wait(&_request, MPI_STATUS_IGNORE);
+  }
+
+  // Assignment operator (deleted)
+  Reduction& operator=(const Reduction& r) = delete;
+
+  /// @brief Check if the reduction has completed.
+  /// @return `true` if the result is available.
+  bool test()
+  {
+    int flag = 1;
+    if (_request != MPI_REQUEST_NULL)
+      MPI_Test(&_request, &flag, MPI_STATUS_IGNORE);
+    return flag;
+  }
+
+  /// @brief Wait for the reduction to complete.
+  /// @return The sum of the values across processes.
+  const std::vector<T>& wait()
+  {
+    if (_request != MPI_REQUEST_NULL)
+      MPI_Wait(&_request, MPI_STATUS_IGNORE);
+    return _global;
+  }
+
+private:
+  std::vector<T> _local, _global;
+  MPI_Request _request = MPI_REQUEST_NULL;
 };
 
 /// Compute the inner product of two vectors. The two vectors must have
@@ -225,28 +831,111 @@ template <class V>
 auto inner_product(const V& a, const V& b)
 {
   using T = typename V::value_type;
-  const std::int32_t local_size = a.bs() * a.index_map()->size_local();
-  if (local_size != b.bs() * b.index_map()->size_local())
+  const T local = impl::local_inner_product(a, b);
+  T result;
+  MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                a.index_map()->comm());
+  return result;
+}
+
+/// @brief Start the computation of the inner products of a vector with
+/// a set of vectors, using a single non-blocking reduction.
+/// @note Collective MPI operation
+/// @param[in] a A vector
+/// @param[in] b Vectors with the same parallel layout as `a`
+/// @return Reduction that gives `a^{H} b_i` for each `b_i`
+template <class V>
+Reduction<typename V::value_type>
+inner_products_begin(const V& a,
+                     const std::vector<std::reference_wrapper<const V>>& b)
+{
+  using T = typename V::value_type;
+  std::vector<T> local(b.size());
+  std::ranges::transform(b, local.begin(), [&a](auto& bi)
+                         { return impl::local_inner_product(a, bi.get()); });
+  return Reduction<T>(std::move(local), a.index_map()->comm());
+}
+
+/// @brief Compute the inner products of a vector with a set of
+/// vectors, using a single reduction.
+/// @note Collective MPI operation
+/// @param[in] a A vector
+/// @param[in] b Vectors with the same parallel layout as `a`
+/// @return `a^{H} b_i` for each `b_i`
+template <class V>
+std::vector<typename V::value_type>
+inner_products(const V& a,
+               const std::vector<std::reference_wrapper<const V>>& b)
+{
+  return inner_products_begin(a, b).wait();
+}
+
+/// @brief Compute `y = y + alpha x` and the L2 norm of the result in a
+/// single pass over the data.
+/// @note Collective MPI operation
+/// @param[in,out] y Vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x Vector with the same parallel layout as `y`
+/// @return The norm of the updated `y`
+template <class V>
+auto axpy_and_norm(V& y, typename V::value_type alpha, const V& x)
+{
+  using T = typename V::value_type;
+  using U = typename dolfinx::scalar_value_type_t<T>;
+  const std::int32_t local_size = y.bs() * y.index_map()->size_local();
+  if (local_size != x.bs() * x.index_map()->size_local())
     throw std::runtime_error("Incompatible vector sizes");
-  std::span<const T> x_a = a.array().subspan(0, local_size);
-  std::span<const T> x_b = b.array().subspan(0, local_size);
+  std::span<T> _y = y.mutable_array();
+  std::span<const T> _x = x.array();
+  U local = 0;
+  for (std::int32_t i = 0; i < local_size; ++i)
+  {
+    _y[i] += alpha * _x[i];
+    local += std::norm(_y[i]);
+  }
 
-  const T local = std::transform_reduce(
-      x_a.begin(), x_a.end(), x_b.begin(), static_cast<T>(0), std::plus{},
-      [](T a, T b) -> T
-      {
-        if constexpr (std::is_same<T, std::complex<double>>::value
-                      or std::is_same<T, std::complex<float>>::value)
-        {
-          return std::conj(a) * b;
-        }
-        else
-          return a * b;
-      });
+  U result;
+  MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<U>(), MPI_SUM,
+                y.index_map()->comm());
+  return std::sqrt(result);
+}
+
+/// @brief Compute `w = alpha x + beta y` and the inner product `z^{H} w`
+/// in a single pass over the data.
+/// @note Collective MPI operation
+/// @param[out] w Vector to hold the result
+/// @param[in] alpha Scalar
+/// @param[in] x Vector
+/// @param[in] beta Scalar
+/// @param[in] y Vector
+/// @param[in] z Vector
+/// @return The inner product `z^{H} w`
+/// @note All vectors must have the same parallel layout. `w` may be
+/// the same vector as `x` or `y`.
+template <class V>
+auto waxpby_dot(V& w, typename V::value_type alpha, const V& x,
+                typename V::value_type beta, const V& y, const V& z)
+{
+  using T = typename V::value_type;
+  const std::int32_t local_size = w.bs() * w.index_map()->size_local();
+  for (const V* v : {&x, &y, &z})
+  {
+    if (local_size != v->bs() * v->index_map()->size_local())
+      throw std::runtime_error("Incompatible vector sizes");
+  }
+
+  std::span<T> _w = w.mutable_array();
+  std::span<const T> _x = x.array(), _y = y.array(), _z = z.array();
+  T local = 0;
+  for (std::int32_t i = 0; i < local_size; ++i)
+  {
+    _w[i] = alpha * _x[i] + beta * _y[i];
+    local += impl::conj(_z[i]) * _w[i];
+  }
 
   T result;
   MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
-                a.index_map()->comm());
+                w.index_map()->comm());
   return result;
 }
 
@@ -302,7 +991,369 @@ auto norm(const V& x, Norm type = Norm::l2)
   }
 }
 
+/// @brief Summation scheme of the threaded reductions, e.g.
+/// inner_product(const V&, const V&, Summation, int).
+///
+/// The owned entries are split into blocks of a fixed size that does
+/// not depend on the number of threads. The blocks are summed
+/// concurrently and the block sums are then added in a fixed order, so
+/// the result on a process is the same for any number of threads.
+enum class Summation
+{
+  pairwise, ///< Pairwise (cascade) summation
+  kahan     ///< Kahan compensated summation, more accurate but slower
+};
+
+namespace impl
+{
+/// Number of entries of the blocks of the threaded vector operations
+constexpr std::int64_t vector_block_size = 4096;
+
+/// @brief Number of owned entries of vectors, which must be the same
+/// for all vectors.
+template <class V, class... W>
+std::int32_t owned_size(const V& a, const W&... b)
+{
+  const std::int32_t n = a.bs() * a.index_map()->size_local();
+  if (((n != b.bs() * b.index_map()->size_local()) or ...))
+    throw std::runtime_error("Incompatible vector sizes");
+  return n;
+}
+
+/// @brief Call `f(i0, i1)` for the blocks of `[0, n)`, in parallel.
+template <typename F>
+void for_each_block(std::int64_t n, const F& f, int num_threads)
+{
+  const std::int64_t nb = (n + vector_block_size - 1) / vector_block_size;
+  common::parallel_for(nb, num_threads,
+                       [&f, n](std::int64_t b0, std::int64_t b1)
+                       {
+                         f(b0 * vector_block_size,
+                           std::min(n, b1 * vector_block_size));
+                       });
+}
+
+/// @brief Pairwise sum of `f(i)` for `i0 <= i < i1`.
+///
+/// Short ranges are summed with interleaved partial sums, which the
+/// compiler can vectorize.
+template <typename R, typename F>
+R pairwise_sum(std::int64_t i0, std::int64_t i1, const F& f)
+{
+  constexpr std::int64_t lanes = 8;
+  if (i1 - i0 > 16 * lanes)
+  {
+    const std::int64_t mid = i0 + (i1 - i0) / 2;
+    return pairwise_sum<R>(i0, mid, f) + pairwise_sum<R>(mid, i1, f);
+  }
+
+  std::array<R, lanes> s{};
+  std::int64_t i = i0;
+  for (; i + lanes <= i1; i += lanes)
+  {
+    for (std::int64_t l = 0; l < lanes; ++l)
+      s[l] += f(i + l);
+  }
+  for (std::int64_t l = 0; i < i1; ++i, ++l)
+    s[l] += f(i);
+  for (std::int64_t w = lanes / 2; w > 0; w /= 2)
+  {
+    for (std::int64_t l = 0; l < w; ++l)
+      s[l] += s[l + w];
+  }
+  return s[0];
+}
+
+/// @brief Kahan compensated sum of `f(i)` for `i0 <= i < i1`.
+/// @note The compensation is removed by value-unsafe optimisations,
+/// e.g. `-ffast-math`.
+template <typename R, typename F>
+R kahan_sum(std::int64_t i0, std::int64_t i1, const F& f)
+{
+  R s(0), c(0);
+  for (std::int64_t i = i0; i < i1; ++i)
+  {
+    R y = f(i) - c;
+    R t = s + y;
+    c = (t - s) - y;
+    s = t;
+  }
+  return s;
+}
+
+/// @brief Sum of `f(i)` for `0 <= i < n`, computed in parallel over
+/// blocks of a fixed size.
+///
+/// `f` is called once for each `i`, and may modify entry `i` of a
+/// vector.
+template <typename R, typename F>
+R reduce(std::int64_t n, const F& f, Summation summation, int num_threads)
+{
+  auto sum = [summation](std::int64_t i0, std::int64_t i1, const auto& g)
+  {
+    return summation == Summation::kahan ? kahan_sum<R>(i0, i1, g)
+                                         : pairwise_sum<R>(i0, i1, g);
+  };
+
+  const std::int64_t nb = (n + vector_block_size - 1) / vector_block_size;
+  std::vector<R> partial(nb);
+  common::parallel_for(nb, num_threads,
+                       [&](std::int64_t b0, std::int64_t b1)
+                       {
+                         for (std::int64_t b = b0; b < b1; ++b)
+                         {
+                           partial[b] = sum(
+                               b * vector_block_size,
+                               std::min(n, (b + 1) * vector_block_size), f);
+                         }
+                       });
+  return sum(0, nb, [&partial](std::int64_t b) { return partial[b]; });
+}
+} // namespace impl
+
+/// @brief Compute `x = alpha x` for the owned entries, using threads.
+/// @param[in,out] x Vector to scale
+/// @param[in] alpha Scalar
+/// @param[in] num_threads Number of threads. If zero or negative, the
+/// default number of threads is used (see common::num_threads).
+template <class V>
+void scale(V& x, typename V::value_type alpha, int num_threads = 1)
+{
+  const std::int32_t n = impl::owned_size(x);
+  auto _x = x.mutable_array().data();
+  impl::for_each_block(
+      n,
+      [_x, alpha](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int64_t i = i0; i < i1; ++i)
+          _x[i] *= alpha;
+      },
+      num_threads);
+}
+
+/// @brief Compute `y = y + alpha x` for the owned entries, using
+/// threads.
+/// @param[in,out] y Vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x Vector with the same parallel layout as `y`
+/// @param[in] num_threads Number of threads (see scale)
+template <class V>
+void axpy(V& y, typename V::value_type alpha, const V& x,
+          int num_threads = 1)
+{
+  const std::int32_t n = impl::owned_size(y, x);
+  auto _y = y.mutable_array().data();
+  auto _x = x.array().data();
+  impl::for_each_block(
+      n,
+      [_y, _x, alpha](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int64_t i = i0; i < i1; ++i)
+          _y[i] += alpha * _x[i];
+      },
+      num_threads);
+}
+
+/// @brief Compute `y = alpha x + beta y` for the owned entries, using
+/// threads.
+/// @param[in,out] y Vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x Vector with the same parallel layout as `y`
+/// @param[in] beta Scalar
+/// @param[in] num_threads Number of threads (see scale)
+template <class V>
+void axpby(V& y, typename V::value_type alpha, const V& x,
+           typename V::value_type beta, int num_threads = 1)
+{
+  const std::int32_t n = impl::owned_size(y, x);
+  auto _y = y.mutable_array().data();
+  auto _x = x.array().data();
+  impl::for_each_block(
+      n,
+      [_y, _x, alpha, beta](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int64_t i = i0; i < i1; ++i)
+          _y[i] = alpha * _x[i] + beta * _y[i];
+      },
+      num_threads);
+}
+
+/// @brief Compute the pointwise product `w_i = x_i y_i` of the owned
+/// entries, using threads.
+/// @param[out] w Vector to hold the result. It may be `x` or `y`.
+/// @param[in] x Vector
+/// @param[in] y Vector
+/// @param[in] num_threads Number of threads (see scale)
+/// @note All vectors must have the same parallel layout.
+template <class V>
+void pointwise_mult(V& w, const V& x, const V& y, int num_threads = 1)
+{
+  const std::int32_t n = impl::owned_size(w, x, y);
+  auto _w = w.mutable_array().data();
+  auto _x = x.array().data();
+  auto _y = y.array().data();
+  impl::for_each_block(
+      n,
+      [_w, _x, _y](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int64_t i = i0; i < i1; ++i)
+          _w[i] = _x[i] * _y[i];
+      },
+      num_threads);
+}
+
+/// @brief Compute the pointwise quotient `w_i = x_i / y_i` of the owned
+/// entries, using threads.
+/// @param[out] w Vector to hold the result. It may be `x` or `y`.
+/// @param[in] x Vector
+/// @param[in] y Vector
+/// @param[in] num_threads Number of threads (see scale)
+/// @note All vectors must have the same parallel layout.
+template <class V>
+void pointwise_divide(V& w, const V& x, const V& y, int num_threads = 1)
+{
+  const std::int32_t n = impl::owned_size(w, x, y);
+  auto _w = w.mutable_array().data();
+  auto _x = x.array().data();
+  auto _y = y.array().data();
+  impl::for_each_block(
+      n,
+      [_w, _x, _y](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int64_t i = i0; i < i1; ++i)
+          _w[i] = _x[i] / _y[i];
+      },
+      num_threads);
+}
+
+/// @brief Compute the inner product of two vectors, using threads and
+/// a summation order that does not depend on the number of threads.
+/// @note Collective MPI operation
+/// @param[in] a A vector
+/// @param[in] b A vector with the same parallel layout as `a`
+/// @param[in] summation Summation scheme of the owned entries
+/// @param[in] num_threads Number of threads (see scale)
+/// @return `a^{H} b` (`a^{T} b` if `a` and `b` are real)
+template <class V>
+auto inner_product(const V& a, const V& b, Summation summation,
+                   int num_threads = 1)
+{
+  using T = typename V::value_type;
+  const std::int32_t n = impl::owned_size(a, b);
+  auto _a = a.array().data();
+  auto _b = b.array().data();
+  const T local = impl::reduce<T>(
+      n, [_a, _b](std::int64_t i) { return impl::conj(_a[i]) * _b[i]; },
+      summation, num_threads);
+  T result;
+  MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                a.index_map()->comm());
+  return result;
+}
+
+/// @brief Compute the norm of a vector, using threads and a summation
+/// order that does not depend on the number of threads.
+/// @note Collective MPI operation
+/// @param[in] x A vector
+/// @param[in] type Norm type
+/// @param[in] summation Summation scheme of the owned entries (not used
+/// for Norm::linf)
+/// @param[in] num_threads Number of threads (see scale)
+template <class V>
+auto norm(const V& x, Norm type, Summation summation, int num_threads = 1)
+{
+  using T = typename V::value_type;
+  using U = typename dolfinx::scalar_value_type_t<T>;
+  const std::int32_t n = impl::owned_size(x);
+  auto _x = x.array().data();
+  MPI_Comm comm = x.index_map()->comm();
+  switch (type)
+  {
+  case Norm::l1:
+  {
+    U local = impl::reduce<U>(
+        n, [_x](std::int64_t i) { return std::abs(_x[i]); }, summation,
+        num_threads);
+    U l1;
+    MPI_Allreduce(&local, &l1, 1, dolfinx::MPI::mpi_type<U>(), MPI_SUM, comm);
+    return l1;
+  }
+  case Norm::l2:
+  {
+    U local = impl::reduce<U>(
+        n, [_x](std::int64_t i) { return std::norm(_x[i]); }, summation,
+        num_threads);
+    U l2;
+    MPI_Allreduce(&local, &l2, 1, dolfinx::MPI::mpi_type<U>(), MPI_SUM, comm);
+    return std::sqrt(l2);
+  }
+  case Norm::linf:
+  {
+    const std::int64_t nb
+        = (n + impl::vector_block_size - 1) / impl::vector_block_size;
+    std::vector<U> partial(nb, 0);
+    common::parallel_for(
+        nb, num_threads,
+        [&partial, _x, n](std::int64_t b0, std::int64_t b1)
+        {
+          for (std::int64_t b = b0; b < b1; ++b)
+          {
+            const std::int64_t i1
+                = std::min<std::int64_t>(n, (b + 1) * impl::vector_block_size);
+            for (std::int64_t i = b * impl::vector_block_size; i < i1; ++i)
+              partial[b] = std::max<U>(partial[b], std::abs(_x[i]));
+          }
+        });
+    U local = partial.empty() ? U(0) : std::ranges::max(partial);
+    U linf;
+    MPI_Allreduce(&local, &linf, 1, dolfinx::MPI::mpi_type<U>(), MPI_MAX,
+                  comm);
+    return linf;
+  }
+  default:
+    throw std::runtime_error("Norm type not supported");
+  }
+}
+
+/// @brief Compute `y = y + alpha x` and the L2 norm of the result in a
+/// single pass over the data, using threads and a summation order that
+/// does not depend on the number of threads.
+/// @note Collective MPI operation
+/// @param[in,out] y Vector to update
+/// @param[in] alpha Scalar
+/// @param[in] x Vector with the same parallel layout as `y`
+/// @param[in] summation Summation scheme of the owned entries
+/// @param[in] num_threads Number of threads (see scale)
+/// @return The norm of the updated `y`
+template <class V>
+auto axpy_and_norm(V& y, typename V::value_type alpha, const V& x,
+                   Summation summation, int num_threads = 1)
+{
+  using T = typename V::value_type;
+  using U = typename dolfinx::scalar_value_type_t<T>;
+  const std::int32_t n = impl::owned_size(y, x);
+  auto _y = y.mutable_array().data();
+  auto _x = x.array().data();
+  const U local = impl::reduce<U>(
+      n,
+      [_y, _x, alpha](std::int64_t i)
+      {
+        _y[i] += alpha * _x[i];
+        return std::norm(_y[i]);
+      },
+      summation, num_threads);
+  U result;
+  MPI_Allreduce(&local, &result, 1, dolfinx::MPI::mpi_type<U>(), MPI_SUM,
+                y.index_map()->comm());
+  return std::sqrt(result);
+}
+
 /// Orthonormalize a set of vectors
+///
+/// Classical Gram-Schmidt with re-orthogonalisation is used, so that
+/// the inner products with the previous vectors are computed with a
+/// single reduction per pass.
+///
 /// @param[in,out] basis The set of vectors to orthonormalise. The
 /// vectors must have identical parallel layouts. The vectors are
 /// modified in-place.
@@ -314,20 +1365,24 @@ void orthonormalize(std::vector<std::reference_wrapper<V>> basis)
   using U = typename dolfinx::scalar_value_type_t<T>;
 
   // Loop over each vector in basis
+  std::vector<std::reference_wrapper<const V>> prev;
   for (std::size_t i = 0; i < basis.size(); ++i)
   {
     // Orthogonalize vector i with respect to previously orthonormalized
-    // vectors
+    // vectors (twice, for stability)
     V& bi = basis[i].get();
-    for (std::size_t j = 0; j < i; ++j)
+    for (int pass = 0; pass < 2 and i > 0; ++pass)
     {
-      const V& bj = basis[j].get();
-
-      // basis_i <- basis_i - dot_ij  basis_j
-      auto dot_ij = inner_product(bi, bj);
-      std::ranges::transform(bj.array(), bi.array(), bi.mutable_array().begin(),
-                             [dot_ij](auto xj, auto xi)
-                             { return xi - dot_ij * xj; });
+      // basis_i <- basis_i - (basis_j^H basis_i) basis_j
+      std::vector<T> dot = inner_products(bi, prev);
+      for (std::size_t j = 0; j < i; ++j)
+      {
+        T dot_ij = impl::conj(dot[j]);
+        std::ranges::transform(prev[j].get().array(), bi.array(),
+                               bi.mutable_array().begin(),
+                               [dot_ij](auto xj, auto xi)
+                               { return xi - dot_ij * xj; });
+      }
     }
 
     // Normalise basis function
@@ -339,6 +1394,7 @@ void orthonormalize(std::vector<std::reference_wrapper<V>> basis)
     }
     std::ranges::transform(bi.array(), bi.mutable_array().begin(),
                            [norm](auto x) { return x / norm; });
+    prev.push_back(bi);
   }
 }
 
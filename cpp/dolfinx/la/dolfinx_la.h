@@ -9,9 +9,11 @@ namespace dolfinx::la
 
 // DOLFINx la interface
 
+#include <dolfinx/la/Agglomeration.h>
 #include <dolfinx/la/SparsityPattern.h>
 #ifdef HAS_PETSC
 #include <dolfinx/la/petsc.h>
 #endif
+#include <dolfinx/la/scatter_tuning.h>
 #include <dolfinx/la/slepc.h>
 #include <dolfinx/la/utils.h>
@@ -0,0 +1,598 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/types.h>
+#include <mpi.h>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @file krylov.h
+/// @brief Krylov solvers for la::Vector.
+///
+/// The solvers work with any operator and preconditioner that can be
+/// called as
+///
+///     A(x, y);  // y = A x
+///     M(r, z);  // z = M r (approximately A^{-1} r)
+///
+/// where `x`, `y`, `r` and `z` are vectors with the same layout as the
+/// solution vector. The arguments `x` and `r` are not modified, except
+/// for their ghost values which the operator may update. Only the owned
+/// entries of `y` and `z` need to be set. For a la::MatrixCSR `A`, the
+/// operator is `[&A](auto& x, auto& y) { A.mult(x, y); }`.
+
+namespace dolfinx::la
+{
+/// @brief Outcome of an iterative solve.
+/// @tparam U Real scalar type
+template <typename U>
+struct KrylovResult
+{
+  /// Number of iterations performed
+  int iterations = 0;
+
+  /// Norm of the final residual. For CG and BiCGStab this is the norm
+  /// of the recursively updated residual.
+  U residual_norm = 0;
+
+  /// `true` if the convergence criterion was satisfied
+  bool converged = false;
+};
+
+/// @brief Preconditioner that applies the identity.
+struct IdentityPreconditioner
+{
+  /// @brief Apply the preconditioner, i.e. copy `r` into `z`.
+  /// @param[in] r Vector to apply the preconditioner to.
+  /// @param[out] z Result.
+  template <class V>
+  void operator()(const V& r, V& z) const
+  {
+    const std::int32_t size = r.bs() * r.index_map()->size_local();
+    std::copy_n(r.array().begin(), size, z.mutable_array().begin());
+  }
+};
+
+namespace impl
+{
+/// Owned entries of a vector
+template <class V>
+std::span<const typename V::value_type> owned(const V& x)
+{
+  return x.array().first(x.bs() * x.index_map()->size_local());
+}
+
+/// Owned entries of a vector (non-const)
+template <class V>
+std::span<typename V::value_type> owned(V& x)
+{
+  return x.mutable_array().first(x.bs() * x.index_map()->size_local());
+}
+
+/// @brief Compute several inner products with a single reduction.
+/// @param[in] pairs Vectors `(a, b)` for each product `a^{H} b`.
+/// @return The inner products.
+template <class V, std::size_t N>
+std::array<typename V::value_type, N>
+inner_products(const std::array<std::pair<const V*, const V*>, N>& pairs)
+{
+  using T = typename V::value_type;
+  std::array<T, N> local, global;
+  for (std::size_t i = 0; i < N; ++i)
+    local[i] = local_inner_product(*pairs[i].first, *pairs[i].second);
+  MPI_Allreduce(local.data(), global.data(), N, dolfinx::MPI::mpi_type<T>(),
+                MPI_SUM, pairs[0].first->index_map()->comm());
+  return global;
+}
+
+/// Compute `y = a * x + b * y` for the owned entries
+template <class V, typename T>
+void axpby(T a, const V& x, T b, V& y)
+{
+  std::span<const T> _x = owned(x);
+  std::span<T> _y = owned(y);
+  for (std::size_t i = 0; i < _y.size(); ++i)
+    _y[i] = a * _x[i] + b * _y[i];
+}
+
+/// Compute `r = b - A x` for the owned entries
+template <class V, typename Op>
+void residual(Op&& A, V& x, const V& b, V& r)
+{
+  using T = typename V::value_type;
+  A(x, r);
+  axpby(T(1), b, T(-1), r);
+}
+
+/// Square root of the real part of a scalar, clamped at zero
+template <typename T>
+auto sqrt_real(T x)
+{
+  return std::sqrt(std::max(std::real(x), decltype(std::real(x))(0)));
+}
+} // namespace impl
+
+/// @brief Solve `Ax = b` using the preconditioned conjugate gradient
+/// method.
+///
+/// The operator and preconditioner must be Hermitian and positive
+/// definite. The residual norm and the inner product for the next
+/// search direction are computed with a single reduction per
+/// iteration.
+///
+/// @param[in] A Operator.
+/// @param[in] M Preconditioner.
+/// @param[in,out] x Initial guess on input, solution on output.
+/// @param[in] b Right-hand side.
+/// @param[in] rtol Relative tolerance for the residual norm.
+/// @param[in] atol Absolute tolerance for the residual norm.
+/// @param[in] max_it Maximum number of iterations.
+/// @return Outcome of the solve.
+template <class V, typename Op, typename Prec>
+KrylovResult<dolfinx::scalar_value_type_t<typename V::value_type>>
+cg(Op&& A, Prec&& M, V& x, const V& b,
+   dolfinx::scalar_value_type_t<typename V::value_type> rtol = 1e-8,
+   dolfinx::scalar_value_type_t<typename V::value_type> atol = 0,
+   int max_it = 1000)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  V r(b.index_map(), b.bs()), z(b.index_map(), b.bs()),
+      p(b.index_map(), b.bs()), q(b.index_map(), b.bs());
+
+  const U tol = std::max(rtol * la::norm(b), atol);
+  impl::residual(A, x, b, r);
+  M(r, z);
+  std::ranges::copy(impl::owned(z), p.mutable_array().begin());
+  std::array<T, 2> rz_rr = impl::inner_products<V, 2>({{{&r, &z}, {&r, &r}}});
+  T rz = rz_rr[0], rr = rz_rr[1];
+
+  KrylovResult<U> result;
+  for (result.iterations = 0; result.iterations < max_it; ++result.iterations)
+  {
+    result.residual_norm = impl::sqrt_real(rr);
+    if (result.residual_norm <= tol)
+    {
+      result.converged = true;
+      return result;
+    }
+
+    A(p, q);
+    const T alpha = rz / impl::inner_products<V, 1>({{{&p, &q}}})[0];
+    impl::axpby(alpha, p, T(1), x);
+    impl::axpby(-alpha, q, T(1), r);
+    M(r, z);
+
+    const T rz0 = rz;
+    rz_rr = impl::inner_products<V, 2>({{{&r, &z}, {&r, &r}}});
+    rz = rz_rr[0];
+    rr = rz_rr[1];
+    impl::axpby(T(1), z, rz / rz0, p);
+  }
+
+  result.residual_norm = impl::sqrt_real(rr);
+  result.converged = result.residual_norm <= tol;
+  return result;
+}
+
+/// @brief Solve `Ax = b` using the pipelined preconditioned conjugate
+/// gradient method.
+///
+/// Uses the pipelined variant of Ghysels and Vanroose (2014), in which
+/// the single reduction per iteration is non-blocking and overlapped
+/// with the application of the preconditioner and the operator. This
+/// needs more vectors and is less stable than cg, but can be faster at
+/// scale when reductions dominate.
+///
+/// @param[in] A Operator.
+/// @param[in] M Preconditioner.
+/// @param[in,out] x Initial guess on input, solution on output.
+/// @param[in] b Right-hand side.
+/// @param[in] rtol Relative tolerance for the residual norm.
+/// @param[in] atol Absolute tolerance for the residual norm.
+/// @param[in] max_it Maximum number of iterations.
+/// @return Outcome of the solve.
+template <class V, typename Op, typename Prec>
+KrylovResult<dolfinx::scalar_value_type_t<typename V::value_type>>
+pipelined_cg(Op&& A, Prec&& M, V& x, const V& b,
+             dolfinx::scalar_value_type_t<typename V::value_type> rtol = 1e-8,
+             dolfinx::scalar_value_type_t<typename V::value_type> atol = 0,
+             int max_it = 1000)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  auto map = b.index_map();
+  const int bs = b.bs();
+  V r(map, bs), u(map, bs), w(map, bs), m(map, bs), n(map, bs), z(map, bs),
+      q(map, bs), s(map, bs), p(map, bs);
+
+  const U tol = std::max(rtol * la::norm(b), atol);
+  impl::residual(A, x, b, r);
+  M(r, u);
+  A(u, w);
+
+  T alpha = 0, gamma0 = 0;
+  KrylovResult<U> result;
+  for (result.iterations = 0; result.iterations < max_it; ++result.iterations)
+  {
+    // Start reduction of (r, u), (w, u) and (r, r)
+    la::Reduction<T> reduction(
+        {impl::local_inner_product(r, u), impl::local_inner_product(w, u),
+         impl::local_inner_product(r, r)},
+        map->comm());
+    M(w, m);
+    A(m, n);
+    const std::vector<T>& global = reduction.wait();
+
+    const T gamma = global[0], delta = global[1], rr = global[2];
+    result.residual_norm = impl::sqrt_real(rr);
+    if (result.residual_norm <= tol)
+    {
+      result.converged = true;
+      return result;
+    }
+
+    T beta = 0;
+    if (result.iterations > 0)
+    {
+      beta = gamma / gamma0;
+      alpha = gamma / (delta - beta * gamma / alpha);
+    }
+    else
+      alpha = gamma / delta;
+    gamma0 = gamma;
+
+    impl::axpby(T(1), n, beta, z);
+    impl::axpby(T(1), m, beta, q);
+    impl::axpby(T(1), w, beta, s);
+    impl::axpby(T(1), u, beta, p);
+    impl::axpby(alpha, p, T(1), x);
+    impl::axpby(-alpha, s, T(1), r);
+    impl::axpby(-alpha, q, T(1), u);
+    impl::axpby(-alpha, z, T(1), w);
+  }
+
+  result.residual_norm = la::norm(r);
+  result.converged = result.residual_norm <= tol;
+  return result;
+}
+
+/// @brief Solve `Ax = b` using the restarted generalised minimal
+/// residual method with right preconditioning.
+///
+/// The Arnoldi process uses classical Gram-Schmidt, such that the
+/// inner products with the basis and the norm of the new vector are
+/// computed with a single reduction per iteration. A second
+/// orthogonalisation pass is performed if cancellation is detected.
+/// The preconditioner must be linear.
+///
+/// @param[in] A Operator.
+/// @param[in] M Preconditioner.
+/// @param[in,out] x Initial guess on input, solution on output.
+/// @param[in] b Right-hand side.
+/// @param[in] restart Number of iterations between restarts.
+/// @param[in] rtol Relative tolerance for the residual norm.
+/// @param[in] atol Absolute tolerance for the residual norm.
+/// @param[in] max_it Maximum number of iterations.
+/// @return Outcome of the solve.
+template <class V, typename Op, typename Prec>
+KrylovResult<dolfinx::scalar_value_type_t<typename V::value_type>>
+gmres(Op&& A, Prec&& M, V& x, const V& b, int restart = 30,
+      dolfinx::scalar_value_type_t<typename V::value_type> rtol = 1e-8,
+      dolfinx::scalar_value_type_t<typename V::value_type> atol = 0,
+      int max_it = 1000)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  if (restart < 1)
+    throw std::runtime_error("GMRES restart must be positive.");
+
+  auto map = b.index_map();
+  const int bs = b.bs();
+  std::vector<V> v;
+  v.reserve(restart + 1);
+  for (int i = 0; i < restart + 1; ++i)
+    v.emplace_back(map, bs);
+  V r(map, bs), z(map, bs);
+
+  // Hessenberg matrix (column-major), Givens rotations and rotated
+  // right-hand side
+  std::vector<T> H((restart + 1) * restart), sn(restart), g(restart + 1);
+  std::vector<U> cs(restart);
+
+  // Orthogonalise w against v[0], ..., v[k] and return the norm of the
+  // result
+  auto orthogonalise = [&v](V& w, int k, std::span<T> h)
+  {
+    std::vector<T> local(k + 2), global(k + 2);
+    for (int i = 0; i <= k; ++i)
+      local[i] = impl::local_inner_product(v[i], w);
+    local[k + 1] = impl::local_inner_product(w, w);
+    MPI_Allreduce(local.data(), global.data(), k + 2,
+                  dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                  w.index_map()->comm());
+
+    U hh = 0;
+    for (int i = 0; i <= k; ++i)
+    {
+      impl::axpby(-global[i], v[i], T(1), w);
+      h[i] += global[i];
+      hh += std::norm(global[i]);
+    }
+
+    return std::pair(std::real(global[k + 1]), std::real(global[k + 1]) - hh);
+  };
+
+  const U tol = std::max(rtol * la::norm(b), atol);
+  KrylovResult<U> result;
+  impl::residual(A, x, b, r);
+  result.residual_norm = la::norm(r);
+  while (result.residual_norm > tol and result.iterations < max_it)
+  {
+    impl::axpby(T(1) / result.residual_norm, r, T(0), v[0]);
+    std::ranges::fill(H, 0);
+    std::ranges::fill(g, 0);
+    g[0] = result.residual_norm;
+
+    int k = 0;
+    for (; k < restart and result.iterations < max_it; ++result.iterations)
+    {
+      std::span<T> h(H.data() + k * (restart + 1), restart + 1);
+      M(v[k], z);
+      A(z, v[k + 1]);
+
+      // Orthogonalise, repeating once if there is cancellation. If
+      // there is still large cancellation the norm is computed directly.
+      auto [ww, hn2] = orthogonalise(v[k + 1], k, h);
+      if (hn2 < U(0.5) * ww)
+      {
+        std::tie(ww, hn2) = orthogonalise(v[k + 1], k, h);
+        if (hn2 < U(0.5) * ww)
+          hn2 = la::squared_norm(v[k + 1]);
+      }
+      const U hn = std::sqrt(std::max(hn2, U(0)));
+      h[k + 1] = hn;
+      if (hn > 0)
+        impl::axpby(T(1) / hn, v[k + 1], T(0), v[k + 1]);
+
+      // Apply previous rotations and compute new rotation
+      for (int i = 0; i < k; ++i)
+      {
+        T h0 = h[i];
+        h[i] = cs[i] * h0 + sn[i] * h[i + 1];
+        h[i + 1] = -impl::conj(sn[i]) * h0 + cs[i] * h[i + 1];
+      }
+
+      const U a = std::abs(h[k]);
+      const U d = std::sqrt(a * a + hn * hn);
+      if (a == 0)
+      {
+        cs[k] = 0;
+        sn[k] = 1;
+      }
+      else
+      {
+        cs[k] = a / d;
+        sn[k] = (h[k] / a) * hn / d;
+      }
+      h[k] = cs[k] * h[k] + sn[k] * h[k + 1];
+      h[k + 1] = 0;
+      g[k + 1] = -impl::conj(sn[k]) * g[k];
+      g[k] = cs[k] * g[k];
+
+      result.residual_norm = std::abs(g[k + 1]);
+      ++k;
+      if (result.residual_norm <= tol or hn == 0)
+      {
+        ++result.iterations;
+        break;
+      }
+    }
+
+    // Solve the triangular system and update the solution
+    std::vector<T> y(g.begin(), std::next(g.begin(), k));
+    for (int i = k - 1; i >= 0; --i)
+    {
+      for (int j = i + 1; j < k; ++j)
+        y[i] -= H[j * (restart + 1) + i] * y[j];
+      y[i] /= H[i * (restart + 1) + i];
+    }
+
+    std::ranges::fill(r.mutable_array(), 0);
+    for (int i = 0; i < k; ++i)
+      impl::axpby(y[i], v[i], T(1), r);
+    M(r, z);
+    impl::axpby(T(1), z, T(1), x);
+
+    // Recompute the residual, which is used for the restart and to
+    // check convergence
+    impl::residual(A, x, b, r);
+    result.residual_norm = la::norm(r);
+  }
+
+  result.converged = result.residual_norm <= tol;
+  return result;
+}
+
+/// @brief Solve `Ax = b` using the stabilised biconjugate gradient
+/// method with right preconditioning.
+///
+/// The inner products are grouped such that there are three
+/// reductions per iteration.
+///
+/// @param[in] A Operator.
+/// @param[in] M Preconditioner.
+/// @param[in,out] x Initial guess on input, solution on output.
+/// @param[in] b Right-hand side.
+/// @param[in] rtol Relative tolerance for the residual norm.
+/// @param[in] atol Absolute tolerance for the residual norm.
+/// @param[in] max_it Maximum number of iterations.
+/// @return Outcome of the solve. The solve stops without convergence
+/// if the method breaks down.
+template <class V, typename Op, typename Prec>
+KrylovResult<dolfinx::scalar_value_type_t<typename V::value_type>>
+bicgstab(Op&& A, Prec&& M, V& x, const V& b,
+         dolfinx::scalar_value_type_t<typename V::value_type> rtol = 1e-8,
+         dolfinx::scalar_value_type_t<typename V::value_type> atol = 0,
+         int max_it = 1000)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  auto map = b.index_map();
+  const int bs = b.bs();
+  V r(map, bs), r0(map, bs), p(map, bs), v(map, bs), s(map, bs), t(map, bs),
+      phat(map, bs), shat(map, bs);
+
+  const U tol = std::max(rtol * la::norm(b), atol);
+  impl::residual(A, x, b, r);
+  std::ranges::copy(impl::owned(r), r0.mutable_array().begin());
+  std::array<T, 2> rho_rr
+      = impl::inner_products<V, 2>({{{&r0, &r}, {&r, &r}}});
+  T rho = rho_rr[0], rr = rho_rr[1];
+
+  T alpha = 1, omega = 1, rho0 = 1;
+  KrylovResult<U> result;
+  for (result.iterations = 0; result.iterations < max_it; ++result.iterations)
+  {
+    result.residual_norm = impl::sqrt_real(rr);
+    if (result.residual_norm <= tol)
+    {
+      result.converged = true;
+      return result;
+    }
+
+    if (rho == T(0) or omega == T(0))
+      return result;
+
+    // p = r + beta * (p - omega * v)
+    const T beta = (rho / rho0) * (alpha / omega);
+    impl::axpby(-omega, v, T(1), p);
+    impl::axpby(T(1), r, beta, p);
+    M(p, phat);
+    A(phat, v);
+
+    const T r0v = impl::inner_products<V, 1>({{{&r0, &v}}})[0];
+    if (r0v == T(0))
+      return result;
+    alpha = rho / r0v;
+
+    // s = r - alpha * v
+    std::ranges::copy(impl::owned(r), s.mutable_array().begin());
+    impl::axpby(-alpha, v, T(1), s);
+    M(s, shat);
+    A(shat, t);
+
+    auto [ts, tt, ss]
+        = impl::inner_products<V, 3>({{{&t, &s}, {&t, &t}, {&s, &s}}});
+    impl::axpby(alpha, phat, T(1), x);
+    if (impl::sqrt_real(ss) <= tol or tt == T(0))
+    {
+      ++result.iterations;
+      result.residual_norm = impl::sqrt_real(ss);
+      result.converged = result.residual_norm <= tol;
+      return result;
+    }
+
+    omega = ts / tt;
+    impl::axpby(omega, shat, T(1), x);
+
+    // r = s - omega * t
+    std::ranges::copy(impl::owned(s), r.mutable_array().begin());
+    impl::axpby(-omega, t, T(1), r);
+
+    rho0 = rho;
+    rho_rr = impl::inner_products<V, 2>({{{&r0, &r}, {&r, &r}}});
+    rho = rho_rr[0];
+    rr = rho_rr[1];
+  }
+
+  result.residual_norm = impl::sqrt_real(rr);
+  result.converged = result.residual_norm <= tol;
+  return result;
+}
+
+/// @brief Solve `Ax = b` by iterative refinement, with the correction
+/// computed in a different (typically lower) precision.
+///
+/// Each iteration computes the residual `r = b - Ax` in the precision
+/// of `x`, converts it to scalar type `W`, approximately solves `A d =
+/// r` in precision `W` with `solve(r, d)`, and updates `x = x + d`. The
+/// inner solver can use a copy of the matrix in reduced precision (see
+/// the converting constructor of MatrixCSR), which reduces the memory
+/// traffic of matrix-vector products, while the final accuracy is that
+/// of the residual computation. The vectors passed to `solve` share the
+/// scatterer of `b`, so their ghost updates are in precision `W`. The
+/// correction `d` is zero on entry to `solve`.
+///
+/// @tparam W Scalar type of the inner solve.
+/// @param[in] A Operator in the precision of `x`.
+/// @param[in] solve Inner solver, called as `solve(r, d)`.
+/// @param[in,out] x Initial guess on input, solution on output.
+/// @param[in] b Right-hand side.
+/// @param[in] rtol Relative tolerance for the residual norm.
+/// @param[in] atol Absolute tolerance for the residual norm.
+/// @param[in] max_it Maximum number of refinement iterations.
+/// @return Outcome of the solve. The number of iterations is the number
+/// of inner solves.
+template <typename W, class V, typename Op, typename Solver>
+KrylovResult<dolfinx::scalar_value_type_t<typename V::value_type>>
+iterative_refinement(
+    Op&& A, Solver&& solve, V& x, const V& b,
+    dolfinx::scalar_value_type_t<typename V::value_type> rtol = 1e-8,
+    dolfinx::scalar_value_type_t<typename V::value_type> atol = 0,
+    int max_it = 50)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  V r(b.index_map(), b.bs());
+  la::Vector<W> rw(b), dw(b);
+
+  const U tol = std::max(rtol * la::norm(b), atol);
+  KrylovResult<U> result;
+  for (result.iterations = 0; result.iterations < max_it; ++result.iterations)
+  {
+    impl::residual(A, x, b, r);
+    result.residual_norm = la::norm(r);
+    if (result.residual_norm <= tol)
+    {
+      result.converged = true;
+      return result;
+    }
+
+    std::ranges::transform(impl::owned(r), rw.mutable_array().begin(),
+                           [](auto v) { return static_cast<W>(v); });
+    dw.set(0);
+    solve(rw, dw);
+    std::ranges::transform(impl::owned(dw), impl::owned(x),
+                           impl::owned(x).begin(),
+                           [](auto d, auto xi) { return xi + static_cast<T>(d); });
+  }
+
+  impl::residual(A, x, b, r);
+  result.residual_norm = la::norm(r);
+  result.converged = result.residual_norm <= tol;
+  return result;
+}
+
+} // namespace dolfinx::la
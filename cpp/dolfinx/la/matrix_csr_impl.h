@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <numeric>
 #include <span>
@@ -100,6 +102,61 @@ void insert_nonblocked_csr(U&& data, const V& cols, const W& row_ptr,
                            const X& x, const Y& xrows, const Y& xcols, OP op,
                            typename Y::value_type num_rows, int bs0, int bs1);
 
+/// @brief Sparse matrix-vector product `y += Ax` for a range of
+/// entries in each row.
+///
+/// For row `i` the product is computed using the entries in positions
+/// `row_begin[i]` to `row_end[i]`. This allows the diagonal (owned
+/// columns) and off-diagonal (ghost columns) parts of a distributed
+/// matrix to be applied separately.
+///
+/// @tparam T Scalar type of the matrix
+/// @tparam BS1 Column block size. If -1, the block size `bs1` is used.
+/// @tparam S Scalar type of the vectors. Matrix entries are converted
+/// to `S` and the product is accumulated in `S`.
+/// @param[in] values The CSR matrix data (blocks stored row-major)
+/// @param[in] row_begin Position of the first entry in each row
+/// @param[in] row_end Position one past the last entry in each row
+/// @param[in] indices The CSR (block) column indices
+/// @param[in] x The vector to apply the matrix to
+/// @param[in,out] y The vector to add the product to
+/// @param[in] bs0 Row block size
+/// @param[in] bs1 Column block size
+template <typename T, int BS1, typename S = T>
+void spmv(std::span<const T> values, std::span<const std::int64_t> row_begin,
+          std::span<const std::int64_t> row_end,
+          std::span<const std::int32_t> indices, std::span<const S> x,
+          std::span<S> y, int bs0, int bs1);
+
+/// @brief Sparse matrix-vector product `y += Ax` for a range of
+/// entries in each row, with compressed column indices.
+///
+/// As spmv, but the column index of entry `j` of row `i` is `base[i] +
+/// offsets[j]`. Rows with `base[i] < 0` could not be compressed, and
+/// the column indices `indices[j]` are used instead.
+///
+/// @tparam T Scalar type of the matrix
+/// @tparam BS1 Column block size. If -1, the block size `bs1` is used.
+/// @tparam S Scalar type of the vectors
+/// @param[in] values The CSR matrix data (blocks stored row-major)
+/// @param[in] row_begin Position of the first entry in each row
+/// @param[in] row_end Position one past the last entry in each row
+/// @param[in] base Smallest column index in the range of each row
+/// @param[in] offsets Column index offsets from the row base
+/// @param[in] indices The CSR (block) column indices
+/// @param[in] x The vector to apply the matrix to
+/// @param[in,out] y The vector to add the product to
+/// @param[in] bs0 Row block size
+/// @param[in] bs1 Column block size
+template <typename T, int BS1, typename S = T>
+void spmv_compressed(std::span<const T> values,
+                     std::span<const std::int64_t> row_begin,
+                     std::span<const std::int64_t> row_end,
+                     std::span<const std::int32_t> base,
+                     std::span<const std::uint16_t> offsets,
+                     std::span<const std::int32_t> indices,
+                     std::span<const S> x, std::span<S> y, int bs0, int bs1);
+
 } // namespace impl
 
 //-----------------------------------------------------------------------------
@@ -237,4 +294,79 @@ void impl::insert_nonblocked_csr(U&& data, const V& cols, const W& row_ptr,
   }
 }
 //-----------------------------------------------------------------------------
+template <typename T, int BS1, typename S>
+void impl::spmv(std::span<const T> values,
+                std::span<const std::int64_t> row_begin,
+                std::span<const std::int64_t> row_end,
+                std::span<const std::int32_t> indices, std::span<const S> x,
+                std::span<S> y, int bs0, int bs1)
+{
+  assert(row_begin.size() == row_end.size());
+  if constexpr (BS1 > 0)
+  {
+    assert(bs1 == BS1);
+    bs1 = BS1;
+  }
+
+  for (std::size_t i = 0; i < row_begin.size(); ++i)
+  {
+    for (int k0 = 0; k0 < bs0; ++k0)
+    {
+      S vi = 0;
+      for (std::int64_t j = row_begin[i]; j < row_end[i]; ++j)
+      {
+        const T* Aj = values.data() + (j * bs0 + k0) * bs1;
+        const S* xj = x.data() + indices[j] * bs1;
+        for (int k1 = 0; k1 < bs1; ++k1)
+          vi += static_cast<S>(Aj[k1]) * xj[k1];
+      }
+      y[i * bs0 + k0] += vi;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T, int BS1, typename S>
+void impl::spmv_compressed(std::span<const T> values,
+                           std::span<const std::int64_t> row_begin,
+                           std::span<const std::int64_t> row_end,
+                           std::span<const std::int32_t> base,
+                           std::span<const std::uint16_t> offsets,
+                           std::span<const std::int32_t> indices,
+                           std::span<const S> x, std::span<S> y, int bs0,
+                           int bs1)
+{
+  assert(row_begin.size() == row_end.size());
+  assert(row_begin.size() == base.size());
+  if constexpr (BS1 > 0)
+  {
+    assert(bs1 == BS1);
+    bs1 = BS1;
+  }
+
+  for (std::size_t i = 0; i < row_begin.size(); ++i)
+  {
+    // Column index for each entry of the row
+    auto product = [&](auto col)
+    {
+      for (int k0 = 0; k0 < bs0; ++k0)
+      {
+        S vi = 0;
+        for (std::int64_t j = row_begin[i]; j < row_end[i]; ++j)
+        {
+          const T* Aj = values.data() + (j * bs0 + k0) * bs1;
+          const S* xj = x.data() + col(j) * bs1;
+          for (int k1 = 0; k1 < bs1; ++k1)
+            vi += static_cast<S>(Aj[k1]) * xj[k1];
+        }
+        y[i * bs0 + k0] += vi;
+      }
+    };
+
+    if (const std::int32_t b = base[i]; b >= 0)
+      product([b, &offsets](auto j) { return b + offsets[j]; });
+    else
+      product([&indices](auto j) { return indices[j]; });
+  }
+}
+//-----------------------------------------------------------------------------
 } // namespace dolfinx::la
@@ -0,0 +1,259 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "SparsityPattern.h"
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/// @file matrix_products.h
+/// @brief Distributed sparse matrix transpose and products for
+/// MatrixCSR.
+///
+/// The products are computed row-by-row of the shared row space as sums
+/// of outer products, i.e. `X^T B = sum_r X(r, :)^T B(r, :)`. Entries
+/// of the result in rows owned by another process are stored in ghost
+/// rows and sent to the owner with MatrixCSR::scatter_rev, in the same
+/// way as for finite element assembly, and the sparsity pattern is
+/// built with SparsityPattern. No other communication is required.
+///
+/// Each operation has a symbolic version, which creates the result
+/// matrix, and a numeric version which computes the entries of an
+/// existing result matrix. The numeric version can be used when the
+/// entries of the input matrices change but their sparsity does not.
+///
+/// All matrices must have block size one. Ghost rows of the input
+/// matrices are ignored, so MatrixCSR::scatter_rev should be called on
+/// assembled input matrices.
+
+namespace dolfinx::la
+{
+namespace impl
+{
+/// Check that a matrix has block size one
+template <typename T>
+void check_unblocked(const MatrixCSR<T>& A)
+{
+  if (A.block_size()[0] != 1 or A.block_size()[1] != 1)
+  {
+    throw std::runtime_error(
+        "Sparse matrix products require matrices with block size 1.");
+  }
+}
+
+/// Owned row `r` of a matrix: column indices and entries
+template <typename T>
+std::pair<std::span<const std::int32_t>, std::span<const T>>
+row(const MatrixCSR<T>& A, std::int32_t r)
+{
+  const std::int64_t offset = A.row_ptr()[r];
+  const std::int64_t size = A.row_ptr()[r + 1] - offset;
+  return {std::span(A.cols().data() + offset, size),
+          std::span(A.values().data() + offset, size)};
+}
+} // namespace impl
+
+/// @brief Compute the entries of the transpose `A^T` of a matrix.
+///
+/// The transpose is not conjugated for complex matrices.
+///
+/// @note MPI Collective
+/// @param[in] A Matrix to transpose
+/// @param[in,out] At Matrix created by transpose(A) for a matrix with the
+/// same sparsity as `A`. On return holds `A^T`.
+template <typename T>
+void transpose(const MatrixCSR<T>& A, MatrixCSR<T>& At)
+{
+  impl::check_unblocked(A);
+  At.set(0);
+  for (std::int32_t r = 0; r < A.num_owned_rows(); ++r)
+  {
+    auto [cols, values] = impl::row(A, r);
+    for (std::size_t k = 0; k < cols.size(); ++k)
+      At.add(values.subspan(k, 1), cols.subspan(k, 1), std::span(&r, 1));
+  }
+  At.scatter_rev();
+}
+
+/// @brief Create the transpose `A^T` of a matrix.
+///
+/// The row index map of `A^T` is the column index map of `A`, and the
+/// transpose is not conjugated for complex matrices.
+///
+/// @note MPI Collective
+/// @param[in] A Matrix to transpose
+/// @return The transpose
+template <typename T>
+MatrixCSR<T> transpose(const MatrixCSR<T>& A)
+{
+  common::Timer timer("Sparse matrix transpose");
+  impl::check_unblocked(A);
+  std::shared_ptr<const common::IndexMap> map0 = A.index_map(0);
+  std::shared_ptr<const common::IndexMap> map1 = A.index_map(1);
+
+  SparsityPattern p(map0->comm(), {map1, map0}, {1, 1});
+  for (std::int32_t r = 0; r < A.num_owned_rows(); ++r)
+    p.insert(impl::row(A, r).first, std::span(&r, 1));
+  p.finalize();
+
+  MatrixCSR<T> At(p);
+  transpose(A, At);
+  return At;
+}
+
+/// @brief Compute the entries of the product `C = X^T B`.
+///
+/// @note MPI Collective
+/// @param[in] X Matrix
+/// @param[in] B Matrix with the same parallel distribution of rows as
+/// `X`
+/// @param[in,out] C Matrix created by transpose_matmult(X, B) for
+/// matrices with the same sparsity as `X` and `B`. On return holds
+/// `X^T B`.
+template <typename T>
+void transpose_matmult(const MatrixCSR<T>& X, const MatrixCSR<T>& B,
+                       MatrixCSR<T>& C)
+{
+  impl::check_unblocked(X);
+  impl::check_unblocked(B);
+  if (X.num_owned_rows() != B.num_owned_rows())
+    throw std::runtime_error("Incompatible matrix row distributions.");
+
+  C.set(0);
+  std::vector<T> block;
+  for (std::int32_t r = 0; r < X.num_owned_rows(); ++r)
+  {
+    auto [xcols, xvalues] = impl::row(X, r);
+    auto [bcols, bvalues] = impl::row(B, r);
+    block.resize(xcols.size() * bcols.size());
+    for (std::size_t i = 0; i < xcols.size(); ++i)
+      for (std::size_t j = 0; j < bcols.size(); ++j)
+        block[i * bcols.size() + j] = xvalues[i] * bvalues[j];
+    C.add(block, xcols, bcols);
+  }
+  C.scatter_rev();
+}
+
+/// @brief Create the product `C = X^T B`.
+///
+/// The row index map of `C` is the column index map of `X`, and the
+/// column index map of `C` has the distribution of the column index map
+/// of `B`. `X` is not conjugated for complex matrices.
+///
+/// @note MPI Collective
+/// @param[in] X Matrix
+/// @param[in] B Matrix with the same parallel distribution of rows as
+/// `X`
+/// @return The product
+template <typename T>
+MatrixCSR<T> transpose_matmult(const MatrixCSR<T>& X, const MatrixCSR<T>& B)
+{
+  common::Timer timer("Sparse matrix product");
+  impl::check_unblocked(X);
+  impl::check_unblocked(B);
+  if (X.index_map(0)->local_range() != B.index_map(0)->local_range())
+    throw std::runtime_error("Incompatible matrix row distributions.");
+
+  SparsityPattern p(X.index_map(0)->comm(),
+                    {X.index_map(1), B.index_map(1)}, {1, 1});
+  for (std::int32_t r = 0; r < X.num_owned_rows(); ++r)
+    p.insert(impl::row(X, r).first, impl::row(B, r).first);
+  p.finalize();
+
+  MatrixCSR<T> C(p);
+  transpose_matmult(X, B, C);
+  return C;
+}
+
+/// @brief Create the product `C = A B`.
+///
+/// The product is computed as `(A^T)^T B`. To re-compute the product
+/// when only the entries of `A` and `B` change, create `At =
+/// transpose(A)` and `C = transpose_matmult(At, B)` and update these with
+/// the numeric versions.
+///
+/// @note MPI Collective
+/// @param[in] A Matrix
+/// @param[in] B Matrix with the parallel distribution of rows equal to
+/// the distribution of the columns of `A`
+/// @return The product
+template <typename T>
+MatrixCSR<T> matmult(const MatrixCSR<T>& A, const MatrixCSR<T>& B)
+{
+  return transpose_matmult(transpose(A), B);
+}
+
+/// @brief Galerkin triple product `P^T A P`, e.g. for the coarse
+/// operator of a multigrid method with prolongation `P`.
+///
+/// The constructor computes the sparsity and entries of the product and
+/// of the intermediate matrices `A^T` and `A P`, which are kept such
+/// that the product can be re-computed with PtAP::update when the
+/// entries (but not the sparsity) of `P` or `A` change.
+///
+/// @tparam T Scalar type
+template <typename T>
+class PtAP
+{
+public:
+  /// @brief Compute the product `P^T A P`.
+  /// @note MPI Collective
+  /// @param[in] P Prolongation matrix
+  /// @param[in] A Square matrix with the row distribution of `P`
+  PtAP(const MatrixCSR<T>& P, const MatrixCSR<T>& A)
+      : _At(transpose(A)), _AP(transpose_matmult(_At, P)),
+        _C(transpose_matmult(P, _AP))
+  {
+  }
+
+  /// @brief Re-compute the product for matrices with the same sparsity
+  /// as the matrices passed to the constructor.
+  /// @note MPI Collective
+  /// @param[in] P Prolongation matrix
+  /// @param[in] A Square matrix with the row distribution of `P`
+  void update(const MatrixCSR<T>& P, const MatrixCSR<T>& A)
+  {
+    common::Timer timer("Sparse matrix Galerkin product (numeric)");
+    transpose(A, _At);
+    transpose_matmult(_At, P, _AP);
+    transpose_matmult(P, _AP, _C);
+  }
+
+  /// The product `P^T A P`
+  const MatrixCSR<T>& matrix() const { return _C; }
+
+  /// The product `P^T A P`
+  MatrixCSR<T>& matrix() { return _C; }
+
+private:
+  // Intermediate matrices A^T and A P
+  MatrixCSR<T> _At, _AP;
+
+  // The product
+  MatrixCSR<T> _C;
+};
+
+/// @brief Create the Galerkin triple product `P^T A P`.
+///
+/// See PtAP for re-computing the product when the entries change.
+///
+/// @note MPI Collective
+/// @param[in] P Prolongation matrix
+/// @param[in] A Square matrix with the row distribution of `P`
+/// @return The product
+template <typename T>
+MatrixCSR<T> ptap(const MatrixCSR<T>& P, const MatrixCSR<T>& A)
+{
+  return transpose_matmult(P, matmult(A, P));
+}
+
+} // namespace dolfinx::la
@@ -8,6 +8,7 @@
 #ifdef HAS_PETSC
 
 #include "petsc.h"
+#include "MatrixCSR.h"
 #include "SparsityPattern.h"
 #include "Vector.h"
 #include "utils.h"
@@ -17,11 +18,23 @@
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 using namespace dolfinx;
 using namespace dolfinx::la;
 
+namespace
+{
+/// Storage of a MATMPIAIJ matrix created from split arrays, which
+/// must be kept alive for the lifetime of the matrix
+struct SplitArrays
+{
+  std::vector<PetscInt> i, j, oi, oj;
+  std::vector<PetscScalar> a, oa;
+};
+} // namespace
+
 //-----------------------------------------------------------------------------
 #define CHECK_ERROR(NAME)                                                      \
   do                                                                           \
@@ -39,9 +52,9 @@ void la::petsc::error(int error_code, std::string filename,
   PetscErrorMessage(error_code, &desc, nullptr);
 
   // Log detailed error info
-  spdlog::info("PETSc error in '{}', '{}'", filename.c_str(),
-               petsc_function.c_str());
-  spdlog::info("PETSc error code '{}' '{}'", error_code, desc);
+  DOLFINX_LOG_INFO("PETSc error in '{}', '{}'", filename.c_str(),
+                   petsc_function.c_str());
+  DOLFINX_LOG_INFO("PETSc error code '{}' '{}'", error_code, desc);
   throw std::runtime_error("Failed to successfully call PETSc function '"
                            + petsc_function + "'. PETSc error code is: "
                            + std ::to_string(error_code) + ", "
@@ -359,6 +372,134 @@ Mat la::petsc::create_matrix(MPI_Comm comm, const SparsityPattern& sp,
   return A;
 }
 //-----------------------------------------------------------------------------
+Mat la::petsc::create_matrix_wrap(la::MatrixCSR<PetscScalar>&& A)
+{
+  if (A.block_size()[0] != 1 or A.block_size()[1] != 1)
+  {
+    throw std::runtime_error(
+        "Wrapping a MatrixCSR as a PETSc matrix requires block size 1.");
+  }
+
+  std::shared_ptr<const common::IndexMap> map0 = A.index_map(0);
+  std::shared_ptr<const common::IndexMap> map1 = A.index_map(1);
+  const std::int32_t m = map0->size_local();
+  const std::int32_t n = map1->size_local();
+  auto& row_ptr = A.row_ptr();
+  auto& off_diag = A.off_diag_offset();
+  auto& cols = A.cols();
+  std::span ghosts = map1->ghosts();
+
+  // Number of entries in the owned rows of the diagonal and
+  // off-diagonal blocks
+  std::size_t nnz_diag = 0;
+  for (std::int32_t r = 0; r < m; ++r)
+    nnz_diag += off_diag[r] - row_ptr[r];
+  const std::size_t nnz_offdiag = row_ptr[m] - nnz_diag;
+
+  auto data = std::make_unique<SplitArrays>();
+  data->a = std::move(A.values());
+
+  // Copy the off-diagonal block, with global column indices sorted
+  // within each row
+  data->oi.resize(m + 1, 0);
+  data->oj.reserve(nnz_offdiag);
+  data->oa.reserve(nnz_offdiag);
+  std::vector<std::int64_t> perm;
+  for (std::int32_t r = 0; r < m; ++r)
+  {
+    perm.resize(row_ptr[r + 1] - off_diag[r]);
+    std::iota(perm.begin(), perm.end(), off_diag[r]);
+    std::ranges::sort(perm, [&](auto p0, auto p1)
+                      { return ghosts[cols[p0] - n] < ghosts[cols[p1] - n]; });
+    for (auto p : perm)
+    {
+      data->oj.push_back(ghosts[cols[p] - n]);
+      data->oa.push_back(data->a[p]);
+    }
+    data->oi[r + 1] = data->oj.size();
+  }
+
+  // Compact the diagonal block in-place. Entries only move towards the
+  // front of the array, so no entry is overwritten before it is moved.
+  data->i.resize(m + 1, 0);
+  data->j.resize(nnz_diag);
+  std::size_t pos = 0;
+  for (std::int32_t r = 0; r < m; ++r)
+  {
+    for (auto k = row_ptr[r]; k < off_diag[r]; ++k, ++pos)
+    {
+      data->a[pos] = data->a[k];
+      data->j[pos] = cols[k];
+    }
+    data->i[r + 1] = pos;
+  }
+  assert(pos == nnz_diag);
+
+  // Release the storage of the off-diagonal entries and ghost rows
+  data->a.resize(nnz_diag);
+  data->a.shrink_to_fit();
+
+  Mat mat;
+  PetscErrorCode ierr = MatCreateMPIAIJWithSplitArrays(
+      map0->comm(), m, n, map0->size_global(), map1->size_global(),
+      data->i.data(), data->j.data(), data->a.data(), data->oi.data(),
+      data->oj.data(), data->oa.data(), &mat);
+  CHECK_ERROR("MatCreateMPIAIJWithSplitArrays");
+
+  // Attach the arrays to the matrix so that they are freed with it
+  PetscContainer container;
+  ierr = PetscContainerCreate(PETSC_COMM_SELF, &container);
+  CHECK_ERROR("PetscContainerCreate");
+  ierr = PetscContainerSetPointer(container, data.release());
+  CHECK_ERROR("PetscContainerSetPointer");
+#if PETSC_VERSION_GE(3, 23, 0)
+  ierr = PetscContainerSetCtxDestroy(container,
+                                     [](void** ctx) -> PetscErrorCode
+                                     {
+                                       delete static_cast<SplitArrays*>(*ctx);
+                                       return 0;
+                                     });
+#else
+  ierr = PetscContainerSetUserDestroy(container,
+                                      [](void* ctx) -> PetscErrorCode
+                                      {
+                                        delete static_cast<SplitArrays*>(ctx);
+                                        return 0;
+                                      });
+#endif
+  CHECK_ERROR("PetscContainerSetUserDestroy");
+  ierr = PetscObjectCompose((PetscObject)mat, "dolfinx_split_arrays",
+                            (PetscObject)container);
+  CHECK_ERROR("PetscObjectCompose");
+  ierr = PetscContainerDestroy(&container);
+  CHECK_ERROR("PetscContainerDestroy");
+
+  // Create PETSc local-to-global maps for insertion with local indices
+  std::array<ISLocalToGlobalMapping, 2> local_to_global;
+  for (int d = 0; d < 2; ++d)
+  {
+    const std::vector map = A.index_map(d)->global_indices();
+    const std::vector<PetscInt> _map(map.begin(), map.end());
+    ierr = ISLocalToGlobalMappingCreate(MPI_COMM_SELF, 1, _map.size(),
+                                        _map.data(), PETSC_COPY_VALUES,
+                                        &local_to_global[d]);
+    CHECK_ERROR("ISLocalToGlobalMappingCreate");
+  }
+  ierr = MatSetLocalToGlobalMapping(mat, local_to_global[0],
+                                    local_to_global[1]);
+  CHECK_ERROR("MatSetLocalToGlobalMapping");
+  for (auto& l2g : local_to_global)
+  {
+    ierr = ISLocalToGlobalMappingDestroy(&l2g);
+    CHECK_ERROR("ISLocalToGlobalMappingDestroy");
+  }
+
+  ierr = MatSetOption(mat, MAT_NEW_NONZERO_LOCATION_ERR, PETSC_TRUE);
+  CHECK_ERROR("MatSetOption");
+
+  return mat;
+}
+//-----------------------------------------------------------------------------
 MatNullSpace la::petsc::create_nullspace(MPI_Comm comm,
                                          std::span<const Vec> basis)
 {
@@ -657,7 +798,11 @@ petsc::KrylovSolver::KrylovSolver(KSP ksp, bool inc_ref_count) : _ksp(ksp)
 }
 //-----------------------------------------------------------------------------
 petsc::KrylovSolver::KrylovSolver(KrylovSolver&& solver)
-    : _ksp(std::exchange(solver._ksp, nullptr))
+    : _ksp(std::exchange(solver._ksp, nullptr)), _reuse_pc(solver._reuse_pc),
+      _max_solves(solver._max_solves),
+      _iteration_growth(solver._iteration_growth),
+      _rebuild_pc(solver._rebuild_pc), _pc_age(solver._pc_age),
+      _pc_iterations(solver._pc_iterations)
 {
   // Do nothing
 }
@@ -671,6 +816,12 @@ petsc::KrylovSolver::~KrylovSolver()
 petsc::KrylovSolver& petsc::KrylovSolver::operator=(KrylovSolver&& solver)
 {
   std::swap(_ksp, solver._ksp);
+  std::swap(_reuse_pc, solver._reuse_pc);
+  std::swap(_max_solves, solver._max_solves);
+  std::swap(_iteration_growth, solver._iteration_growth);
+  std::swap(_rebuild_pc, solver._rebuild_pc);
+  std::swap(_pc_age, solver._pc_age);
+  std::swap(_pc_iterations, solver._pc_iterations);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -698,8 +849,20 @@ int petsc::KrylovSolver::solve(Vec x, const Vec b, bool transpose) const
 
   PetscErrorCode ierr;
 
+  // Keep or rebuild the preconditioner
+  bool rebuild = false;
+  if (_reuse_pc)
+  {
+    rebuild = _rebuild_pc or (_max_solves > 0 and _pc_age >= _max_solves);
+    ierr = KSPSetReusePreconditioner(_ksp, rebuild ? PETSC_FALSE : PETSC_TRUE);
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "KSPSetReusePreconditioner");
+    if (rebuild)
+      DOLFINX_LOG_INFO("Rebuilding preconditioner after {} solves.", _pc_age);
+  }
+
   // Solve linear system
-  spdlog::info("PETSc Krylov solver starting to solve system.");
+  DOLFINX_LOG_INFO("PETSc Krylov solver starting to solve system.");
 
   // Solve system
   if (!transpose)
@@ -727,6 +890,25 @@ int petsc::KrylovSolver::solve(Vec x, const Vec b, bool transpose) const
   ierr = KSPGetConvergedReason(_ksp, &reason);
   if (ierr != 0)
     petsc::error(ierr, __FILE__, "KSPGetConvergedReason");
+
+  // Update the state of the reused preconditioner
+  if (_reuse_pc)
+  {
+    if (rebuild)
+    {
+      _rebuild_pc = false;
+      _pc_age = 0;
+      _pc_iterations = num_iterations;
+    }
+    ++_pc_age;
+    if (reason < 0
+        or (_iteration_growth > 0
+            and num_iterations
+                    > _iteration_growth * std::max(_pc_iterations, 1)))
+    {
+      _rebuild_pc = true;
+    }
+  }
   if (reason < 0)
   {
     /*
@@ -763,6 +945,20 @@ int petsc::KrylovSolver::solve(Vec x, const Vec b, bool transpose) const
   return num_iterations;
 }
 //-----------------------------------------------------------------------------
+void petsc::KrylovSolver::set_reuse_preconditioner(bool reuse, int max_solves,
+                                                   double iteration_growth)
+{
+  _reuse_pc = reuse;
+  _max_solves = max_solves;
+  _iteration_growth = iteration_growth;
+  _rebuild_pc = true;
+  _pc_age = 0;
+}
+//-----------------------------------------------------------------------------
+void petsc::KrylovSolver::rebuild_preconditioner() { _rebuild_pc = true; }
+//-----------------------------------------------------------------------------
+int petsc::KrylovSolver::preconditioner_age() const { return _pc_age; }
+//-----------------------------------------------------------------------------
 void petsc::KrylovSolver::set_options_prefix(std::string options_prefix)
 {
   // Set options prefix
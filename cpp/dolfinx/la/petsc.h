@@ -9,10 +9,14 @@
 
 #ifdef HAS_PETSC
 
+#include "MatrixCSR.h"
 #include "Vector.h"
 #include "utils.h"
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <array>
 #include <functional>
+#include <memory>
 #include <petscksp.h>
 #include <petscmat.h>
 #include <petscoptions.h>
@@ -120,6 +124,111 @@ void scatter_local_vectors(
 Mat create_matrix(MPI_Comm comm, const SparsityPattern& sp,
                   std::string type = std::string());
 
+/// @brief Create a PETSc MATMPIAIJ matrix that takes over the storage
+/// of a MatrixCSR.
+///
+/// The entries of the diagonal block are compacted in-place into the
+/// split diagonal/off-diagonal block layout used by PETSc, and the
+/// value array is then shrunk to the size of the diagonal block. The
+/// off-diagonal (ghost column) entries and the column indices are
+/// copied into arrays of the exact size, since PETSc requires global
+/// ghost column indices of type `PetscInt`. The storage is released
+/// when the PETSc matrix is destroyed.
+///
+/// Ghost rows of `A` are discarded, so `A.scatter_rev()` should be
+/// called before creating the PETSc matrix. The sparsity of the PETSc
+/// matrix is fixed.
+///
+/// @param[in] A Matrix with block size 1 (use BlockMode::expanded for
+/// blocked sparsity patterns). The matrix entries are moved out of
+/// `A`, and `A` should not be used afterwards.
+/// @return A PETSc Mat object that holds the entries of `A`. The caller
+/// is responsible for destroying the returned object.
+Mat create_matrix_wrap(la::MatrixCSR<PetscScalar>&& A);
+
+/// @brief Create a matrix-free PETSc shell matrix (MATSHELL) that
+/// applies a MatrixCSR.
+///
+/// The product (`MatMult`) of the shell matrix uses MatrixCSR::mult,
+/// with the input and output copied between the PETSc vectors and
+/// ghosted la::Vector work vectors. This allows the native sparse
+/// matrix-vector product to be used by PETSc/SLEPc solvers that only
+/// need the action of an operator, e.g. Krylov solvers with no or a
+/// shell preconditioner and eigensolvers with a shift spectral
+/// transform.
+///
+/// @note The matrix `A` is referenced and not copied, and must outlive
+/// the shell matrix.
+/// @note Caller is responsible for destroying the returned object.
+///
+/// @param[in] A The matrix to apply. Its row and column layouts define
+/// the layout of the shell matrix.
+/// @return The shell matrix
+template <class M>
+Mat create_matrix_shell(M& A)
+{
+  // Work vectors for the product
+  struct Context
+  {
+    M* A;
+    la::Vector<PetscScalar> x, y;
+  };
+  std::array<int, 2> bs = A.block_size();
+  auto ctx = new Context{&A, la::Vector<PetscScalar>(A.index_map(1), bs[1]),
+                         la::Vector<PetscScalar>(A.index_map(0), bs[0])};
+
+  const common::IndexMap& map0 = *A.index_map(0);
+  const common::IndexMap& map1 = *A.index_map(1);
+  Mat S;
+  PetscErrorCode ierr = MatCreateShell(
+      map0.comm(), map0.size_local() * bs[0], map1.size_local() * bs[1],
+      PETSC_DETERMINE, PETSC_DETERMINE, ctx, &S);
+  if (ierr != 0)
+  {
+    delete ctx;
+    petsc::error(ierr, __FILE__, "MatCreateShell");
+  }
+
+  auto mult = [](Mat S, Vec x, Vec y) -> PetscErrorCode
+  {
+    Context* ctx = nullptr;
+    PetscErrorCode ierr = MatShellGetContext(S, &ctx);
+    if (ierr != 0)
+      return ierr;
+
+    const PetscScalar* _x = nullptr;
+    if (ierr = VecGetArrayRead(x, &_x); ierr != 0)
+      return ierr;
+    std::size_t nx = ctx->x.index_map()->size_local() * ctx->x.bs();
+    std::copy_n(_x, nx, ctx->x.mutable_array().begin());
+    if (ierr = VecRestoreArrayRead(x, &_x); ierr != 0)
+      return ierr;
+
+    ctx->A->mult(ctx->x, ctx->y);
+
+    PetscScalar* _y = nullptr;
+    if (ierr = VecGetArray(y, &_y); ierr != 0)
+      return ierr;
+    std::size_t ny = ctx->y.index_map()->size_local() * ctx->y.bs();
+    std::copy_n(ctx->y.array().begin(), ny, _y);
+    return VecRestoreArray(y, &_y);
+  };
+
+  auto destroy = [](Mat S) -> PetscErrorCode
+  {
+    Context* ctx = nullptr;
+    PetscErrorCode ierr = MatShellGetContext(S, &ctx);
+    delete ctx;
+    return ierr;
+  };
+
+  using mult_fn = PetscErrorCode (*)(Mat, Vec, Vec);
+  using destroy_fn = PetscErrorCode (*)(Mat);
+  MatShellSetOperation(S, MATOP_MULT, (void (*)(void))(mult_fn)mult);
+  MatShellSetOperation(S, MATOP_DESTROY, (void (*)(void))(destroy_fn)destroy);
+  return S;
+}
+
 /// Create PETSc MatNullSpace. Caller is responsible for destruction
 /// returned object.
 /// @param [in] comm The MPI communicator
@@ -485,6 +594,40 @@ public:
   /// = b if transpose is true)
   int solve(Vec x, const Vec b, bool transpose = false) const;
 
+  /// @brief Set the preconditioner reuse policy.
+  ///
+  /// By default PETSc rebuilds the preconditioner at a solve whenever
+  /// the operator values have changed since the last setup. With reuse
+  /// enabled the preconditioner is kept across operator changes, e.g.
+  /// the time steps of a transient problem, (`KSPSetReusePreconditioner`)
+  /// and only rebuilt when
+  /// - it has been used for `max_solves` solves (if `max_solves > 0`),
+  /// - the number of iterations of a solve exceeds `iteration_growth`
+  ///   times the number of iterations of the first solve after the last
+  ///   rebuild (if `iteration_growth > 0`),
+  /// - a solve did not converge, or
+  /// - a rebuild is requested with rebuild_preconditioner().
+  ///
+  /// A rebuild caused by the iteration count or a failed solve applies
+  /// to the next solve.
+  ///
+  /// @param[in] reuse Reuse the preconditioner across operator changes.
+  /// If false, the reuse flag of the KSP is not changed by the solver.
+  /// @param[in] max_solves Maximum number of solves with the same
+  /// preconditioner.
+  /// @param[in] iteration_growth Growth factor of the number of
+  /// iterations that causes a rebuild.
+  void set_reuse_preconditioner(bool reuse, int max_solves = 0,
+                                double iteration_growth = 0);
+
+  /// @brief Rebuild the preconditioner at the next solve, when the
+  /// preconditioner is reused (see set_reuse_preconditioner).
+  void rebuild_preconditioner();
+
+  /// @brief Number of solves with the current preconditioner, when the
+  /// preconditioner is reused (see set_reuse_preconditioner).
+  int preconditioner_age() const;
+
   /// Sets the prefix used by PETSc when searching the PETSc options
   /// database
   void set_options_prefix(std::string options_prefix);
@@ -502,6 +645,16 @@ public:
 private:
   // PETSc solver pointer
   KSP _ksp;
+
+  // Preconditioner reuse policy
+  bool _reuse_pc = false;
+  int _max_solves = 0;
+  double _iteration_growth = 0;
+
+  // State of the reused preconditioner, updated by solve
+  mutable bool _rebuild_pc = true;
+  mutable int _pc_age = 0;
+  mutable int _pc_iterations = 0;
 };
 } // namespace petsc
 } // namespace dolfinx::la
@@ -0,0 +1,584 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "MatrixCSR.h"
+#include "krylov.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/ordering.h>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/// @file preconditioners.h
+/// @brief Preconditioners and smoothers for la::MatrixCSR.
+///
+/// The preconditioners can be passed to the solvers in krylov.h and
+/// are applied as `M(r, z)`, which sets the owned entries of `z`. They
+/// are local to each process, i.e. the coupling to ghost columns is
+/// ignored (except by the l1-Jacobi diagonal), and need no
+/// communication. Chebyshev needs the communication of the operator it
+/// is applied with.
+///
+/// The matrices must be square with the same row and column
+/// distribution, so that the diagonal of owned row `i` is in column
+/// `i`, and have a block mode of BlockMode::compact when they are
+/// blocked.
+
+namespace dolfinx::la
+{
+namespace impl
+{
+/// Check that a matrix is square with equal row and column block sizes
+template <typename T>
+void check_square(const MatrixCSR<T>& A)
+{
+  if (A.block_size()[0] != A.block_size()[1]
+      or A.index_map(0)->size_local() != A.index_map(1)->size_local())
+  {
+    throw std::runtime_error("Preconditioners require a square matrix with "
+                             "square blocks.");
+  }
+}
+
+/// Position in values() (in blocks) of the diagonal block of owned row
+/// `i`, or -1 if the block is not in the sparsity pattern
+template <typename T>
+std::int64_t diagonal_position(const MatrixCSR<T>& A, std::int32_t i)
+{
+  auto begin = std::next(A.cols().begin(), A.row_ptr()[i]);
+  auto end = std::next(A.cols().begin(), A.off_diag_offset()[i]);
+  auto it = std::lower_bound(begin, end, i);
+  return (it != end and *it == i) ? std::distance(A.cols().begin(), it) : -1;
+}
+
+/// Invert a dense `n x n` row-major matrix in place using Gauss-Jordan
+/// elimination with partial pivoting
+template <typename T>
+void invert(std::span<T> A, int n)
+{
+  std::vector<int> perm(n);
+  for (int k = 0; k < n; ++k)
+  {
+    int p = k;
+    for (int i = k + 1; i < n; ++i)
+      if (std::abs(A[i * n + k]) > std::abs(A[p * n + k]))
+        p = i;
+    if (A[p * n + k] == T(0))
+      throw std::runtime_error("Singular diagonal block.");
+    perm[k] = p;
+    for (int j = 0; j < n; ++j)
+      std::swap(A[k * n + j], A[p * n + j]);
+
+    const T d = T(1) / A[k * n + k];
+    A[k * n + k] = 1;
+    for (int j = 0; j < n; ++j)
+      A[k * n + j] *= d;
+    for (int i = 0; i < n; ++i)
+    {
+      if (i == k)
+        continue;
+      const T f = A[i * n + k];
+      A[i * n + k] = 0;
+      for (int j = 0; j < n; ++j)
+        A[i * n + j] -= f * A[k * n + j];
+    }
+  }
+
+  // Undo the row interchanges by swapping the columns in reverse order
+  for (int k = n - 1; k >= 0; --k)
+    for (int i = 0; i < n; ++i)
+      std::swap(A[i * n + k], A[i * n + perm[k]]);
+}
+
+/// @brief Largest eigenvalue of a real symmetric tridiagonal matrix.
+///
+/// Computed by bisection using the Sturm sequence count of eigenvalues
+/// less than a shift.
+///
+/// @param[in] a Diagonal.
+/// @param[in] b Off-diagonal, of size `a.size() - 1`.
+template <typename U>
+U max_eigenvalue_tridiagonal(std::span<const U> a, std::span<const U> b)
+{
+  const std::size_t m = a.size();
+  auto count = [&](U x)
+  {
+    std::size_t c = 0;
+    U q = 1;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      q = a[i] - x - (i > 0 ? b[i - 1] * b[i - 1] / q : U(0));
+      if (q == 0)
+        q = std::numeric_limits<U>::epsilon() * (std::abs(x) + 1);
+      c += q < 0;
+    }
+    return c;
+  };
+
+  // Gershgorin bounds
+  U lo = std::numeric_limits<U>::max(), hi = std::numeric_limits<U>::lowest();
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    U r = (i > 0 ? std::abs(b[i - 1]) : 0) + (i + 1 < m ? std::abs(b[i]) : 0);
+    lo = std::min(lo, a[i] - r);
+    hi = std::max(hi, a[i] + r);
+  }
+
+  const U eps = std::numeric_limits<U>::epsilon();
+  for (int k = 0; k < 100; ++k)
+  {
+    if (hi - lo <= eps * std::max(std::abs(lo), std::abs(hi)))
+      break;
+    const U mid = (lo + hi) / 2;
+    if (count(mid) == m)
+      hi = mid;
+    else
+      lo = mid;
+  }
+  return hi;
+}
+} // namespace impl
+
+/// @brief Extract the diagonal of a matrix.
+///
+/// @param[in] A Square matrix.
+/// @return Diagonal entries of the owned rows, with `bs` entries per
+/// (block) row. Entries that are not in the sparsity pattern are zero.
+template <typename T>
+std::vector<T> diagonal(const MatrixCSR<T>& A)
+{
+  impl::check_square(A);
+  const int bs = A.block_size()[0];
+  std::vector<T> d(A.num_owned_rows() * bs, 0);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+  {
+    if (std::int64_t k = impl::diagonal_position(A, i); k >= 0)
+    {
+      for (int c = 0; c < bs; ++c)
+        d[i * bs + c] = A.values()[k * bs * bs + c * bs + c];
+    }
+  }
+  return d;
+}
+
+/// @brief Extract the diagonal blocks of a blocked matrix.
+///
+/// @param[in] A Square matrix with block size `bs`.
+/// @return The `bs x bs` diagonal blocks of the owned rows, each stored
+/// row-major, i.e. entry `(i0, i1)` of block `i` is at `i * bs * bs + i0
+/// * bs + i1`. Blocks that are not in the sparsity pattern are zero.
+template <typename T>
+std::vector<T> block_diagonal(const MatrixCSR<T>& A)
+{
+  impl::check_square(A);
+  const int bs2 = A.block_size()[0] * A.block_size()[1];
+  std::vector<T> d(A.num_owned_rows() * bs2, 0);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+  {
+    if (std::int64_t k = impl::diagonal_position(A, i); k >= 0)
+    {
+      std::copy_n(std::next(A.values().begin(), k * bs2), bs2,
+                  std::next(d.begin(), i * bs2));
+    }
+  }
+  return d;
+}
+
+/// @brief Jacobi (diagonal) preconditioner, `z = D^{-1} r`.
+///
+/// The l1 variant adds the sum of the absolute values of the entries
+/// of each row in the ghost columns to the diagonal, which makes the
+/// process-local preconditioner convergent as a smoother for
+/// Hermitian positive definite matrices (Baker et al., 2011,
+/// https://doi.org/10.1137/100798806).
+///
+/// @tparam T Scalar type
+template <typename T>
+class Jacobi
+{
+public:
+  /// @brief Create a Jacobi preconditioner.
+  /// @param[in] A Square matrix.
+  /// @param[in] l1 Use the l1-Jacobi diagonal.
+  explicit Jacobi(const MatrixCSR<T>& A, bool l1 = false) : _dinv(diagonal(A))
+  {
+    const int bs = A.block_size()[0];
+    const std::int32_t num_rows = A.num_owned_rows();
+    if (l1)
+    {
+      for (std::int32_t i = 0; i < num_rows; ++i)
+      {
+        for (std::int64_t k = A.off_diag_offset()[i]; k < A.row_ptr()[i + 1];
+             ++k)
+        {
+          const T* Ak = A.values().data() + k * bs * bs;
+          for (int c0 = 0; c0 < bs; ++c0)
+            for (int c1 = 0; c1 < bs; ++c1)
+              _dinv[i * bs + c0] += std::abs(Ak[c0 * bs + c1]);
+        }
+      }
+    }
+
+    for (T& d : _dinv)
+    {
+      if (d == T(0))
+        throw std::runtime_error("Zero diagonal entry in Jacobi.");
+      d = T(1) / d;
+    }
+  }
+
+  /// @brief Apply the preconditioner.
+  /// @param[in] r Vector to apply the preconditioner to.
+  /// @param[out] z Result.
+  template <class V>
+  void operator()(const V& r, V& z) const
+  {
+    std::span<const T> _r = impl::owned(r);
+    std::span<T> _z = impl::owned(z);
+    for (std::size_t i = 0; i < _z.size(); ++i)
+      _z[i] = _dinv[i] * _r[i];
+  }
+
+private:
+  // Inverse diagonal
+  std::vector<T> _dinv;
+};
+
+/// @brief Point-block Jacobi preconditioner, which applies the inverse
+/// of the diagonal blocks of a blocked matrix.
+///
+/// For block size one this is the Jacobi preconditioner.
+///
+/// @tparam T Scalar type
+template <typename T>
+class BlockJacobi
+{
+public:
+  /// @brief Create a block Jacobi preconditioner.
+  ///
+  /// Throws an exception if a diagonal block is singular.
+  ///
+  /// @param[in] A Square blocked matrix.
+  explicit BlockJacobi(const MatrixCSR<T>& A)
+      : _bs(A.block_size()[0]), _dinv(block_diagonal(A))
+  {
+    for (std::size_t i = 0; i < _dinv.size(); i += _bs * _bs)
+      impl::invert(std::span(_dinv.data() + i, _bs * _bs), _bs);
+  }
+
+  /// @brief Apply the preconditioner.
+  /// @param[in] r Vector to apply the preconditioner to.
+  /// @param[out] z Result.
+  template <class V>
+  void operator()(const V& r, V& z) const
+  {
+    std::span<const T> _r = impl::owned(r);
+    std::span<T> _z = impl::owned(z);
+    const std::size_t num_blocks = _z.size() / _bs;
+    for (std::size_t i = 0; i < num_blocks; ++i)
+    {
+      const T* Dinv = _dinv.data() + i * _bs * _bs;
+      for (int c0 = 0; c0 < _bs; ++c0)
+      {
+        T zi = 0;
+        for (int c1 = 0; c1 < _bs; ++c1)
+          zi += Dinv[c0 * _bs + c1] * _r[i * _bs + c1];
+        _z[i * _bs + c0] = zi;
+      }
+    }
+  }
+
+private:
+  // Block size
+  int _bs;
+
+  // Inverse diagonal blocks (row-major)
+  std::vector<T> _dinv;
+};
+
+/// @brief Symmetric Gauss-Seidel preconditioner.
+///
+/// Applies a forward and a backward Gauss-Seidel sweep starting from
+/// `z = 0` to the process-local part of the matrix (the owned rows
+/// and columns), i.e. the coupling to ghost columns is ignored (hybrid
+/// Gauss-Seidel). The rows are visited in the order of a greedy
+/// colouring, where rows with the same colour do not couple. The rows
+/// of a colour are therefore independent and can be processed by
+/// several threads, and the result does not depend on the number of
+/// threads. The preconditioner is symmetric when the matrix is.
+///
+/// @tparam T Scalar type
+template <typename T>
+class SymmetricGaussSeidel
+{
+public:
+  /// @brief Create a symmetric Gauss-Seidel preconditioner.
+  /// @param[in] A Square matrix with block size one. The matrix must
+  /// outlive the preconditioner.
+  /// @param[in] num_threads Number of threads to use for each sweep.
+  explicit SymmetricGaussSeidel(const MatrixCSR<T>& A, int num_threads = 1)
+      : _A(A), _num_threads(num_threads), _colours(0)
+  {
+    impl::check_square(A);
+    if (A.block_size()[0] != 1)
+    {
+      throw std::runtime_error(
+          "Symmetric Gauss-Seidel requires a matrix with block size 1.");
+    }
+    if (num_threads < 1)
+      throw std::runtime_error("Number of threads must be positive.");
+
+    // Rows that share a column (including the diagonal) conflict, so
+    // coupled rows get different colours
+    const std::int32_t num_rows = A.num_owned_rows();
+    std::vector<std::int32_t> links, offsets(1, 0);
+    _diag.resize(num_rows);
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      links.push_back(i);
+      for (std::int64_t k = A.row_ptr()[i]; k < A.off_diag_offset()[i]; ++k)
+        if (A.cols()[k] != i)
+          links.push_back(A.cols()[k]);
+      offsets.push_back(links.size());
+
+      std::int64_t k = impl::diagonal_position(A, i);
+      if (k < 0 or A.values()[k] == T(0))
+        throw std::runtime_error("Zero diagonal entry in Gauss-Seidel.");
+      _diag[i] = k;
+    }
+    _colours = graph::colour_greedy(graph::AdjacencyList<std::int32_t>(
+        std::move(links), std::move(offsets)));
+  }
+
+  /// @brief Apply the preconditioner.
+  /// @param[in] r Vector to apply the preconditioner to.
+  /// @param[out] z Result.
+  template <class V>
+  void operator()(const V& r, V& z) const
+  {
+    std::span<const T> _r = impl::owned(r);
+    std::span<T> _z = impl::owned(z);
+    std::ranges::fill(_z, T(0));
+
+    // Update the rows in `rows` in order
+    auto update = [&](std::span<const std::int32_t> rows)
+    {
+      for (std::int32_t i : rows)
+      {
+        T s = _r[i];
+        for (std::int64_t k = _A.row_ptr()[i]; k < _A.off_diag_offset()[i];
+             ++k)
+        {
+          if (k != _diag[i])
+            s -= _A.values()[k] * _z[_A.cols()[k]];
+        }
+        _z[i] = s / _A.values()[_diag[i]];
+      }
+    };
+
+    auto sweep = [&](std::int32_t c)
+    {
+      std::span<const std::int32_t> rows = _colours.links(c);
+      common::parallel_for(rows.size(), _num_threads,
+                           [&](std::int64_t r0, std::int64_t r1)
+                           { update(rows.subspan(r0, r1 - r0)); });
+    };
+
+    for (std::int32_t c = 0; c < _colours.num_nodes(); ++c)
+      sweep(c);
+    for (std::int32_t c = _colours.num_nodes() - 1; c >= 0; --c)
+      sweep(c);
+  }
+
+private:
+  // The matrix
+  const MatrixCSR<T>& _A;
+
+  // Number of threads
+  int _num_threads;
+
+  // Rows of each colour
+  graph::AdjacencyList<std::int32_t> _colours;
+
+  // Position of the diagonal entry of each row in values()
+  std::vector<std::int64_t> _diag;
+};
+
+/// @brief Estimate the largest eigenvalue of the preconditioned
+/// operator `M A`.
+///
+/// Runs a few preconditioned conjugate gradient iterations and computes
+/// the largest eigenvalue of the Lanczos tridiagonal matrix assembled
+/// from the CG coefficients. The estimate is a lower bound that
+/// converges quickly to the largest eigenvalue. The operator and
+/// preconditioner must be Hermitian positive definite.
+///
+/// @param[in] A Operator.
+/// @param[in] M Preconditioner.
+/// @param[in] x0 Starting vector, which should not be orthogonal to
+/// the eigenvector, e.g. a random vector.
+/// @param[in] num_steps Number of Lanczos steps.
+/// @return The eigenvalue estimate.
+template <class V, typename Op, typename Prec>
+dolfinx::scalar_value_type_t<typename V::value_type>
+estimate_max_eigenvalue(Op&& A, Prec&& M, const V& x0, int num_steps = 10)
+{
+  using T = typename V::value_type;
+  using U = dolfinx::scalar_value_type_t<T>;
+
+  V r(x0.index_map(), x0.bs()), z(x0.index_map(), x0.bs()),
+      p(x0.index_map(), x0.bs()), q(x0.index_map(), x0.bs());
+  std::ranges::copy(impl::owned(x0), r.mutable_array().begin());
+  M(r, z);
+  std::ranges::copy(impl::owned(z), p.mutable_array().begin());
+  T rz = impl::inner_products<V, 1>({{{&r, &z}}})[0];
+  const U rz0 = std::real(rz);
+
+  // CG coefficients
+  std::vector<U> alpha, beta;
+  for (int j = 0; j < num_steps and std::real(rz) > 0; ++j)
+  {
+    A(p, q);
+    const T pq = impl::inner_products<V, 1>({{{&p, &q}}})[0];
+    if (std::real(pq) <= 0)
+      break;
+    const T a = rz / pq;
+    alpha.push_back(std::real(a));
+
+    impl::axpby(-a, q, T(1), r);
+    M(r, z);
+    const T rz1 = impl::inner_products<V, 1>({{{&r, &z}}})[0];
+    if (std::real(rz1) <= std::numeric_limits<U>::epsilon() * rz0)
+      break;
+    beta.push_back(std::real(rz1 / rz));
+    impl::axpby(T(1), z, rz1 / rz, p);
+    rz = rz1;
+  }
+
+  if (alpha.empty())
+    throw std::runtime_error("Eigenvalue estimate failed.");
+
+  // Lanczos tridiagonal matrix
+  const std::size_t m = alpha.size();
+  std::vector<U> diag(m), off(m - 1);
+  diag[0] = 1 / alpha[0];
+  for (std::size_t j = 1; j < m; ++j)
+  {
+    diag[j] = 1 / alpha[j] + beta[j - 1] / alpha[j - 1];
+    off[j - 1] = std::sqrt(beta[j - 1]) / alpha[j - 1];
+  }
+
+  return impl::max_eigenvalue_tridiagonal<U>(diag, off);
+}
+
+/// @brief Chebyshev polynomial preconditioner and smoother.
+///
+/// Applies a fixed number of Chebyshev iterations for `A z = r` with
+/// preconditioner `M`, starting from `z = 0` (Saad, Iterative Methods
+/// for Sparse Linear Systems, 2003, Algorithm 12.1). The iteration
+/// damps the error components with eigenvalues of `M A` in `[lmin,
+/// lmax]`. For smoothing, `lmax` is typically a small multiple (e.g.
+/// 1.1) of the largest eigenvalue, see estimate_max_eigenvalue, and
+/// `lmin` a fraction (e.g. 0.1) of `lmax`.
+///
+/// As the result is a fixed polynomial in `M A` applied to `M r`, the
+/// preconditioner is symmetric when `A` and `M` are, and can be used
+/// with cg.
+///
+/// @tparam V Vector type
+template <class V>
+class Chebyshev
+{
+public:
+  /// Real scalar type
+  using U = dolfinx::scalar_value_type_t<typename V::value_type>;
+
+  /// @brief Create a Chebyshev preconditioner.
+  /// @param[in] A Operator.
+  /// @param[in] M Preconditioner.
+  /// @param[in] lmin Lower bound of the eigenvalue interval.
+  /// @param[in] lmax Upper bound of the eigenvalue interval.
+  /// @param[in] num_iterations Number of iterations, i.e. number of
+  /// applications of the preconditioner.
+  Chebyshev(std::function<void(V&, V&)> A,
+            std::function<void(const V&, V&)> M, U lmin, U lmax,
+            int num_iterations)
+      : _A(A), _M(M), _lmin(lmin), _lmax(lmax), _num_iterations(num_iterations)
+  {
+    if (lmin < 0 or lmax <= lmin)
+      throw std::runtime_error("Invalid Chebyshev eigenvalue interval.");
+    if (num_iterations < 1)
+      throw std::runtime_error("Number of iterations must be positive.");
+  }
+
+  /// @brief Apply the preconditioner.
+  /// @param[in] r Vector to apply the preconditioner to.
+  /// @param[out] z Result.
+  void operator()(const V& r, V& z)
+  {
+    using T = typename V::value_type;
+
+    // Residual, search direction and work vector
+    if (_work.empty())
+    {
+      _work.reserve(3);
+      for (int i = 0; i < 3; ++i)
+        _work.emplace_back(r.index_map(), r.bs());
+    }
+    V& res = _work[0];
+    V& d = _work[1];
+    V& w = _work[2];
+
+    const U theta = (_lmax + _lmin) / 2;
+    const U delta = (_lmax - _lmin) / 2;
+    const U sigma = theta / delta;
+    U rho = 1 / sigma;
+
+    std::ranges::copy(impl::owned(r), res.mutable_array().begin());
+    _M(res, w);
+    impl::axpby(T(1 / theta), w, T(0), d);
+    std::ranges::fill(impl::owned(z), T(0));
+    for (int k = 0; k < _num_iterations; ++k)
+    {
+      impl::axpby(T(1), d, T(1), z);
+      if (k == _num_iterations - 1)
+        break;
+
+      _A(d, w);
+      impl::axpby(T(-1), w, T(1), res);
+      const U rho1 = 1 / (2 * sigma - rho);
+      _M(res, w);
+      impl::axpby(T(2 * rho1 / delta), w, T(rho1 * rho), d);
+      rho = rho1;
+    }
+  }
+
+private:
+  // Operator and preconditioner
+  std::function<void(V&, V&)> _A;
+  std::function<void(const V&, V&)> _M;
+
+  // Eigenvalue interval
+  U _lmin, _lmax;
+
+  // Number of iterations
+  int _num_iterations;
+
+  // Work vectors, created on first application
+  std::vector<V> _work;
+};
+
+} // namespace dolfinx::la
@@ -0,0 +1,162 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "scatter_tuning.h"
+#include "Vector.h"
+#include <algorithm>
+#include <atomic>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/log.h>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Cached timing of a communication pattern
+struct Timing
+{
+  std::weak_ptr<const common::IndexMap> map;
+  std::size_t bytes;
+  common::Scatterer<>::type type;
+  double time;
+};
+
+std::atomic<bool> autotuning_enabled = false;
+std::mutex timings_mutex;
+
+std::vector<Timing>& timings()
+{
+  static std::vector<Timing> t;
+  return t;
+}
+
+/// Name of a communication pattern
+std::string type_name(common::Scatterer<>::type type)
+{
+  switch (type)
+  {
+  case common::Scatterer<>::type::neighbor:
+    return "neighbor";
+  case common::Scatterer<>::type::p2p:
+    return "p2p";
+  case common::Scatterer<>::type::persistent:
+    return "persistent";
+  case common::Scatterer<>::type::shared:
+    return "shared";
+  default:
+    return "unknown";
+  }
+}
+
+/// Time a forward and a reverse scatter of a vector
+double time_scatter(std::shared_ptr<const common::IndexMap> map, int bs,
+                    common::Scatterer<>::type type, int repeats)
+{
+  MPI_Comm comm = map->comm();
+  la::Vector<double, std::pmr::vector<double>> x(map, bs, type);
+  x.set(1.0);
+
+  // Warm-up, which also sets up lazily created MPI state
+  x.scatter_fwd();
+  x.scatter_rev(std::plus<double>());
+
+  double tmin = std::numeric_limits<double>::max();
+  for (int r = 0; r < repeats; ++r)
+  {
+    MPI_Barrier(comm);
+    const double t0 = MPI_Wtime();
+    x.scatter_fwd();
+    x.scatter_rev(std::plus<double>());
+    double t = MPI_Wtime() - t0;
+    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, comm);
+    tmin = std::min(tmin, t);
+  }
+
+  return tmin;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+void la::set_scatter_autotuning(bool enable) { autotuning_enabled = enable; }
+//-----------------------------------------------------------------------------
+bool la::scatter_autotuning() { return autotuning_enabled; }
+//-----------------------------------------------------------------------------
+std::vector<double>
+la::scatter_times(std::shared_ptr<const common::IndexMap> map, int bs,
+                  std::size_t value_size,
+                  const std::vector<common::Scatterer<>::type>& types,
+                  int repeats)
+{
+  const std::size_t bytes = bs * value_size;
+  const int bs_double = (bytes + sizeof(double) - 1) / sizeof(double);
+
+  std::vector<double> times;
+  for (auto type : types)
+  {
+    // All processes have the same cache entries, since the timings are
+    // computed collectively
+    double time = -1;
+    {
+      std::scoped_lock lock(timings_mutex);
+      std::erase_if(timings(), [](auto& t) { return t.map.expired(); });
+      auto it = std::ranges::find_if(timings(),
+                                     [&](auto& t)
+                                     {
+                                       return t.map.lock() == map
+                                              and t.bytes == bytes
+                                              and t.type == type;
+                                     });
+      if (it != timings().end())
+        time = it->time;
+    }
+
+    if (time < 0)
+    {
+      time = time_scatter(map, bs_double, type, repeats);
+      std::scoped_lock lock(timings_mutex);
+      timings().push_back({map, bytes, type, time});
+    }
+    times.push_back(time);
+  }
+
+  return times;
+}
+//-----------------------------------------------------------------------------
+common::Scatterer<>::type
+la::tune_scatter_type(std::shared_ptr<const common::IndexMap> map, int bs,
+                      std::size_t value_size,
+                      const std::vector<common::Scatterer<>::type>& types,
+                      int repeats)
+{
+  if (dolfinx::MPI::size(map->comm()) == 1 or types.empty())
+    return common::Scatterer<>::type::neighbor;
+
+  std::int64_t num_ghosts = map->num_ghosts();
+  MPI_Allreduce(MPI_IN_PLACE, &num_ghosts, 1, MPI_INT64_T, MPI_SUM,
+                map->comm());
+  if (num_ghosts == 0)
+    return common::Scatterer<>::type::neighbor;
+
+  std::vector<double> times
+      = scatter_times(map, bs, value_size, types, repeats);
+  auto type = types[std::distance(times.begin(),
+                                  std::ranges::min_element(times))];
+  DOLFINX_LOG_INFO("Selected scatter type {} for {} bytes per index",
+                   type_name(type), bs * value_size);
+  return type;
+}
+//-----------------------------------------------------------------------------
+void la::clear_scatter_timings()
+{
+  std::scoped_lock lock(timings_mutex);
+  timings().clear();
+}
+//-----------------------------------------------------------------------------
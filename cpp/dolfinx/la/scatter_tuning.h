@@ -0,0 +1,97 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Scatterer.h>
+#include <memory>
+#include <vector>
+
+/// @file scatter_tuning.h
+/// @brief Selection of the fastest ghost update pattern for an index
+/// map.
+///
+/// Which Scatterer::type gives the fastest ghost updates depends on the
+/// MPI implementation, the message sizes and the number of neighbours.
+/// The functions in this file time forward and reverse scatters of a
+/// vector with each pattern, and cache the timings for each index map
+/// and block size. When autotuning is enabled, la::Vector objects that
+/// are created without a communication pattern use the fastest one.
+
+namespace dolfinx::la
+{
+/// @brief Enable or disable the selection of the ghost update pattern
+/// of la::Vector by timing (see tune_scatter_type).
+///
+/// Autotuning is disabled by default, in which case vectors use
+/// Scatterer::type::neighbor. When enabled, the first vector that is
+/// created for an index map and block size times the patterns, which
+/// takes a number of ghost updates.
+///
+/// @param[in] enable True to enable autotuning.
+void set_scatter_autotuning(bool enable);
+
+/// @brief Check if the ghost update pattern of la::Vector is selected
+/// by timing.
+/// @return True if autotuning is enabled.
+bool scatter_autotuning();
+
+/// @brief Time a forward and a reverse scatter for communication
+/// patterns.
+///
+/// The timings are cached for each index map, number of bytes per
+/// index and pattern, and only patterns without a cached timing are
+/// timed. Each pattern is timed for a vector with block size
+/// `ceil(bs * value_size / sizeof(double))` holding `double` values,
+/// which has the same message sizes. The timing is the minimum over
+/// `repeats` repetitions of the maximum over processes, so the timings
+/// are the same on all processes.
+///
+/// @note Collective.
+/// @param[in] map Index map.
+/// @param[in] bs Block size.
+/// @param[in] value_size Size of a value in bytes, e.g. `sizeof(T)`.
+/// @param[in] types Communication patterns to time. The pattern
+/// common::Scatterer<>::type::shared allocates shared memory windows.
+/// @param[in] repeats Number of timed repetitions.
+/// @return Time (seconds) of a forward and a reverse scatter for each
+/// pattern in `types`.
+std::vector<double>
+scatter_times(std::shared_ptr<const common::IndexMap> map, int bs,
+              std::size_t value_size,
+              const std::vector<common::Scatterer<>::type>& types,
+              int repeats = 10);
+
+/// @brief Select the fastest communication pattern for ghost updates.
+///
+/// If the index map has one process, or no process has ghosts,
+/// common::Scatterer<>::type::neighbor is returned without timing.
+/// Otherwise the patterns are timed with scatter_times. The same
+/// pattern is returned on all processes.
+///
+/// @note Collective.
+/// @param[in] map Index map.
+/// @param[in] bs Block size.
+/// @param[in] value_size Size of a value in bytes.
+/// @param[in] types Communication patterns to select from.
+/// @param[in] repeats Number of timed repetitions.
+/// @return The fastest pattern.
+common::Scatterer<>::type
+tune_scatter_type(std::shared_ptr<const common::IndexMap> map, int bs,
+                  std::size_t value_size = sizeof(double),
+                  const std::vector<common::Scatterer<>::type>& types
+                  = {common::Scatterer<>::type::neighbor,
+                     common::Scatterer<>::type::p2p,
+                     common::Scatterer<>::type::persistent},
+                  int repeats = 10);
+
+/// @brief Discard the cached timings of scatter_times.
+/// @note Must be called on all processes that share index maps, so
+/// that the caches on the processes stay the same.
+void clear_scatter_timings();
+} // namespace dolfinx::la
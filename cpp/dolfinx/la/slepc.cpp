@@ -9,6 +9,7 @@
 #include "slepc.h"
 #include "petsc.h"
 #include "utils.h"
+#include <algorithm>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
 #include <petscmat.h>
@@ -35,7 +36,9 @@ SLEPcEigenSolver::SLEPcEigenSolver(EPS eps, bool inc_ref_count) : _eps(eps)
 }
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver::SLEPcEigenSolver(SLEPcEigenSolver&& solver)
-    : _eps(std::exchange(solver._eps, nullptr))
+    : _eps(std::exchange(solver._eps, nullptr)),
+      _warm_start(solver._warm_start),
+      _initial_space(std::move(solver._initial_space))
 {
   // Do nothing
 }
@@ -44,11 +47,15 @@ SLEPcEigenSolver::~SLEPcEigenSolver()
 {
   if (_eps)
     EPSDestroy(&_eps);
+  for (Vec& v : _initial_space)
+    VecDestroy(&v);
 }
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver& SLEPcEigenSolver::operator=(SLEPcEigenSolver&& solver)
 {
   std::swap(_eps, solver._eps);
+  std::swap(_warm_start, solver._warm_start);
+  std::swap(_initial_space, solver._initial_space);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -58,6 +65,33 @@ void SLEPcEigenSolver::set_operators(const Mat A, const Mat B)
   EPSSetOperators(_eps, A, B);
 }
 //-----------------------------------------------------------------------------
+void SLEPcEigenSolver::set_warm_start(bool warm_start)
+{
+  _warm_start = warm_start;
+  if (!warm_start)
+  {
+    for (Vec& v : _initial_space)
+      VecDestroy(&v);
+    _initial_space.clear();
+  }
+}
+//-----------------------------------------------------------------------------
+void SLEPcEigenSolver::set_reuse_factorisation(bool reuse)
+{
+  assert(_eps);
+  ST st;
+  PetscErrorCode ierr = EPSGetST(_eps, &st);
+  if (ierr != 0)
+    petsc::error(ierr, __FILE__, "EPSGetST");
+  KSP ksp;
+  ierr = STGetKSP(st, &ksp);
+  if (ierr != 0)
+    petsc::error(ierr, __FILE__, "STGetKSP");
+  ierr = KSPSetReusePreconditioner(ksp, reuse ? PETSC_TRUE : PETSC_FALSE);
+  if (ierr != 0)
+    petsc::error(ierr, __FILE__, "KSPSetReusePreconditioner");
+}
+//-----------------------------------------------------------------------------
 void SLEPcEigenSolver::solve()
 {
   // Get operators
@@ -90,9 +124,38 @@ void SLEPcEigenSolver::solve(std::int64_t n)
   // Set any options from the PETSc database
   EPSSetFromOptions(_eps);
 
+  // Start from the eigenvectors of the previous solve
+  if (_warm_start and !_initial_space.empty())
+  {
+    PetscErrorCode ierr = EPSSetInitialSpace(_eps, _initial_space.size(),
+                                             _initial_space.data());
+    if (ierr != 0)
+      petsc::error(ierr, __FILE__, "EPSSetInitialSpace");
+  }
+
   // Solve eigenvalue problem
   EPSSolve(_eps);
 
+  // Keep the converged eigenvectors for the next solve
+  if (_warm_start)
+  {
+    for (Vec& v : _initial_space)
+      VecDestroy(&v);
+    _initial_space.clear();
+
+    Mat A, B;
+    EPSGetOperators(_eps, &A, &B);
+    PetscInt num_converged = 0;
+    EPSGetConverged(_eps, &num_converged);
+    for (PetscInt i = 0; i < std::min<PetscInt>(num_converged, n); ++i)
+    {
+      Vec v;
+      MatCreateVecs(A, &v, nullptr);
+      EPSGetEigenvector(_eps, i, v, nullptr);
+      _initial_space.push_back(v);
+    }
+  }
+
   // Check for convergence
   EPSConvergedReason reason;
   EPSGetConvergedReason(_eps, &reason);
@@ -105,8 +168,8 @@ void SLEPcEigenSolver::solve(std::int64_t n)
 
   EPSType eps_type = nullptr;
   EPSGetType(_eps, &eps_type);
-  spdlog::info("Eigenvalue solver ({}) converged in {} iterations.", eps_type,
-               num_iterations);
+  DOLFINX_LOG_INFO("Eigenvalue solver ({}) converged in {} iterations.",
+                   eps_type, num_iterations);
 }
 //-----------------------------------------------------------------------------
 std::complex<PetscReal> SLEPcEigenSolver::get_eigenvalue(int i) const
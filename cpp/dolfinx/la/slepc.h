@@ -14,12 +14,17 @@
 #include <petscvec.h>
 #include <slepceps.h>
 #include <string>
+#include <vector>
 
 namespace dolfinx::la
 {
 
 /// @brief This class provides an eigenvalue solver for PETSc matrices.
 /// It is a wrapper for the SLEPc eigenvalue solver.
+///
+/// For repeated solves of nearby problems see set_warm_start and
+/// set_reuse_factorisation. Matrix-free operators that apply a
+/// MatrixCSR can be created with la::petsc::create_matrix_shell.
 class SLEPcEigenSolver
 {
 public:
@@ -48,6 +53,34 @@ public:
   /// problems)
   void set_operators(const Mat A, const Mat B);
 
+  /// @brief Start each solve from the eigenvectors of the previous
+  /// solve.
+  ///
+  /// When enabled, the converged eigenvectors of a solve are kept and
+  /// passed as the initial space (`EPSSetInitialSpace`) of the next
+  /// solve. For a sequence of nearby eigenproblems, e.g. in a parametric
+  /// study, this typically reduces the number of iterations
+  /// substantially. The operators of the next solve must have the same
+  /// parallel layout.
+  /// @param[in] warm_start Use warm starts. If false, the kept
+  /// eigenvectors are discarded.
+  void set_warm_start(bool warm_start);
+
+  /// @brief Reuse the factorisation of the spectral transformation
+  /// between solves.
+  ///
+  /// With a shift-and-invert (or Cayley) spectral transformation the
+  /// linear solver of the transformation normally refactors the shifted
+  /// matrix \f$A - \sigma B\f$ when the operators change. If the
+  /// factorisation is reused, the factorisation of the first solve is
+  /// kept (`KSPSetReusePreconditioner` on the transformation solver).
+  /// This is exact when the shifted matrix does not change, e.g. a
+  /// zero shift where only B changes, and otherwise turns the
+  /// factorisation into a preconditioner for an iterative
+  /// transformation solver.
+  /// @param[in] reuse Reuse the factorisation.
+  void set_reuse_factorisation(bool reuse);
+
   /// Compute all eigenpairs of the matrix A (solve \f$A x = \lambda x\f$)
   void solve();
 
@@ -88,6 +121,12 @@ public:
 private:
   // SLEPc solver pointer
   EPS _eps;
+
+  // Use the eigenvectors of the previous solve as the initial space
+  bool _warm_start = false;
+
+  // Eigenvectors of the previous solve
+  std::vector<Vec> _initial_space;
 };
 } // namespace dolfinx::la
 #endif
@@ -9,6 +9,7 @@
 #include "Topology.h"
 #include <algorithm>
 #include <basix/mdspan.hpp>
+#include <cassert>
 #include <concepts>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
@@ -22,12 +23,80 @@
 #include <functional>
 #include <memory>
 #include <span>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
 namespace dolfinx::mesh
 {
 
+/// @brief Compact copy of the coordinates of a geometry.
+///
+/// Geometry stores three components for each point. A compact copy
+/// stores only the first `gdim` components of each point, in the
+/// (possibly lower) precision `S`. Gathering the coordinates of a cell
+/// from a compact copy moves less data for meshes with `gdim < 3`
+/// and/or when `S` is smaller than the geometry type.
+///
+/// @tparam S Floating point type used to store the coordinates.
+template <std::floating_point S>
+class CompactCoordinates
+{
+public:
+  /// @brief Create a compact copy of point coordinates.
+  /// @param[in] x Point coordinates, flattened row-major with shape
+  /// `(num_points, 3)`.
+  /// @param[in] gdim Number of components to store for each point
+  /// (`0 < gdim <= 3`).
+  template <std::floating_point T>
+  CompactCoordinates(std::span<const T> x, int gdim)
+      : _gdim(gdim), _x(x.size() / 3 * gdim)
+  {
+    if (gdim < 1 or gdim > 3)
+      throw std::runtime_error("Invalid geometric dimension.");
+    assert(x.size() % 3 == 0);
+    for (std::size_t i = 0; i < x.size() / 3; ++i)
+      for (int j = 0; j < gdim; ++j)
+        _x[i * gdim + j] = static_cast<S>(x[3 * i + j]);
+  }
+
+  /// Number of components stored for each point
+  int gdim() const { return _gdim; }
+
+  /// @brief Point coordinates.
+  /// @return Flattened row-major coordinates with shape `(num_points,
+  /// gdim)`.
+  std::span<const S> x() const { return _x; }
+
+  /// @brief Gather the coordinates of points.
+  /// @param[in] points Point indices.
+  /// @param[out] coordinate_dofs Coordinates of `points`, flattened
+  /// row-major with shape `(points.size(), 3)`. Components that are not
+  /// stored are set to zero.
+  template <std::floating_point U>
+  void gather(std::span<const std::int32_t> points,
+              std::span<U> coordinate_dofs) const
+  {
+    assert(coordinate_dofs.size() >= 3 * points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      const S* xp = _x.data() + _gdim * points[i];
+      int j = 0;
+      for (; j < _gdim; ++j)
+        coordinate_dofs[3 * i + j] = xp[j];
+      for (; j < 3; ++j)
+        coordinate_dofs[3 * i + j] = 0;
+    }
+  }
+
+private:
+  // Number of components per point
+  int _gdim;
+
+  // Coordinates, row-major with shape (num_points, _gdim)
+  std::vector<S> _x;
+};
+
 /// @brief Geometry stores the geometry imposed on a mesh.
 template <std::floating_point T>
 class Geometry
@@ -171,9 +240,32 @@ public:
   /// @brief Access geometry degrees-of-freedom data (non-const
   /// version).
   ///
+  /// Each call increments the value returned by x_version().
+  ///
   /// @return The flattened row-major geometry data, where the shape is
   /// (num_points, 3)
-  std::span<value_type> x() { return _x; }
+  std::span<value_type> x()
+  {
+    ++_x_version;
+    return _x;
+  }
+
+  /// @brief Version of the geometry data.
+  ///
+  /// The version is incremented every time mutable access to the
+  /// geometry data is requested via the non-const version of x(). Data
+  /// computed from the geometry, e.g. cached cell coordinates, is
+  /// valid while the version is unchanged.
+  ///
+  /// @return Version of the geometry data.
+  std::uint64_t x_version() const { return _x_version; }
+
+  /// @brief Increment the version of the geometry data.
+  ///
+  /// Call after modifying the geometry data through a span that was
+  /// obtained from x() before the version was last recorded, so
+  /// that data computed from the geometry is invalidated.
+  void mark_modified() { ++_x_version; }
 
   /// @brief The element that describes the geometry map.
   ///
@@ -204,6 +296,21 @@ public:
     return _input_global_indices;
   }
 
+  /// @brief Memory used by the geometry.
+  /// @return Memory usage, with the coordinates, dofmaps, index map and
+  /// input global indices as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"Geometry", sizeof(*this), {}};
+    usage.add("x", common::capacity_bytes(_x));
+    usage.add("dofmaps", common::capacity_bytes(_dofmaps));
+    if (_index_map)
+      usage.add(_index_map->memory_usage()).name = "index map";
+    usage.add("input global indices",
+              common::capacity_bytes(_input_global_indices));
+    return usage;
+  }
+
 private:
   // Geometric dimension
   int _dim;
@@ -221,6 +328,9 @@ private:
   // column size = 3)
   std::vector<value_type> _x;
 
+  // Incremented on every mutable access to _x
+  std::uint64_t _x_version = 0;
+
   // Global indices as provided on Geometry creation
   std::vector<std::int64_t> _input_global_indices;
 };
@@ -271,7 +381,7 @@ create_geometry(
         reorder_fn
     = nullptr)
 {
-  spdlog::info("Create Geometry (multiple)");
+  DOLFINX_LOG_INFO("Create Geometry (multiple)");
 
   assert(std::ranges::is_sorted(nodes));
   using T = typename std::remove_reference_t<typename U::value_type>;
@@ -286,7 +396,7 @@ create_geometry(
   for (const auto& el : elements)
     dof_layouts.push_back(el.create_dof_layout());
 
-  spdlog::info("Got {} dof layouts", dof_layouts.size());
+  DOLFINX_LOG_INFO("Got {} dof layouts", dof_layouts.size());
 
   //  Build 'geometry' dofmap on the topology
   auto [_dof_index_map, bs, dofmaps]
@@ -310,14 +420,14 @@ create_geometry(
     }
   }
 
-  spdlog::info("Calling compute_local_to_global");
+  DOLFINX_LOG_INFO("Calling compute_local_to_global");
   // Compute local-to-global map from local indices in dofmap to the
   // corresponding global indices in cells, and pass to function to
   // compute local (dof) to local (position in coords) map from (i)
   // local-to-global for dofs and (ii) local-to-global for entries in
   // coords
 
-  spdlog::info("xdofs.size = {}", xdofs.size());
+  DOLFINX_LOG_INFO("xdofs.size = {}", xdofs.size());
   std::vector<std::int32_t> all_dofmaps;
   std::stringstream s;
   for (auto q : dofmaps)
@@ -325,9 +435,9 @@ create_geometry(
     s << q.size() << " ";
     all_dofmaps.insert(all_dofmaps.end(), q.begin(), q.end());
   }
-  spdlog::info("dofmap sizes = {}", s.str());
-  spdlog::info("all_dofmaps.size = {}", all_dofmaps.size());
-  spdlog::info("nodes.size = {}", nodes.size());
+  DOLFINX_LOG_INFO("dofmap sizes = {}", s.str());
+  DOLFINX_LOG_INFO("all_dofmaps.size = {}", all_dofmaps.size());
+  DOLFINX_LOG_INFO("nodes.size = {}", nodes.size());
 
   const std::vector<std::int32_t> l2l = graph::build::compute_local_to_local(
       graph::build::compute_local_to_global(xdofs, all_dofmaps), nodes);
@@ -348,7 +458,7 @@ create_geometry(
                 std::next(xg.begin(), 3 * i));
   }
 
-  spdlog::info("Creating geometry with {} dofmaps", dof_layouts.size());
+  DOLFINX_LOG_INFO("Creating geometry with {} dofmaps", dof_layouts.size());
 
   return Geometry(dof_index_map, std::move(dofmaps), elements, std::move(xg),
                   dim, std::move(igi));
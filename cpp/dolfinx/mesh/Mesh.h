@@ -83,6 +83,17 @@ public:
   /// @return The communicator on which the mesh is distributed
   MPI_Comm comm() const { return _comm.comm(); }
 
+  /// @brief Memory used by the mesh.
+  /// @return Memory usage, with the topology and geometry as parts
+  common::MemoryUsage memory_usage() const
+  {
+    common::MemoryUsage usage{"Mesh", sizeof(*this), {}};
+    if (_topology)
+      usage.add(_topology->memory_usage());
+    usage.add(_geometry.memory_usage());
+    return usage;
+  }
+
   /// Name
   std::string name = "mesh";
 
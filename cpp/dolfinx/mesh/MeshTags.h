@@ -8,12 +8,15 @@
 
 #include "Topology.h"
 #include <algorithm>
+#include <atomic>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/io/cells.h>
 #include <memory>
+#include <numeric>
 #include <span>
 #include <utility>
 #include <vector>
@@ -85,15 +88,35 @@ public:
   /// @return Indices of tagged entities. The indices are sorted.
   std::vector<std::int32_t> find(const T value) const
   {
-    std::size_t n = std::count(_values.begin(), _values.end(), value);
-    std::vector<std::int32_t> indices;
-    indices.reserve(n);
-    for (std::int32_t i = 0; i < _values.size(); ++i)
+    std::span<const std::int32_t> e = indices(value);
+    return std::vector<std::int32_t>(e.begin(), e.end());
+  }
+
+  /// @brief Entities with a given tag value.
+  ///
+  /// On the first call an index from the tag values to the entities is
+  /// built (a sort of the distinct values and a counting sort of the
+  /// entities), which is shared by copies of the tags. Later lookups
+  /// cost O(log(number of distinct values) + size of the result). Safe
+  /// to call concurrently.
+  ///
+  /// @param[in] value The value
+  /// @return Indices of tagged entities. The indices are sorted.
+  std::span<const std::int32_t> indices(const T value) const
+  {
+    std::shared_ptr<const value_index> index = std::atomic_load(&_index);
+    if (!index)
     {
-      if (_values[i] == value)
-        indices.push_back(_indices[i]);
+      index = std::make_shared<const value_index>(_indices, _values);
+      std::atomic_store(&_index, index);
     }
-    return indices;
+
+    auto it = std::ranges::lower_bound(index->values, value);
+    if (it == index->values.end() or *it != value)
+      return {};
+    std::size_t i = std::distance(index->values.begin(), it);
+    return std::span(index->entities)
+        .subspan(index->offsets[i], index->offsets[i + 1] - index->offsets[i]);
   }
 
   /// Indices of tagged topology entities (local-to-process). The
@@ -113,6 +136,44 @@ public:
   std::string name = "mesh_tags";
 
 private:
+  // Entities grouped by tag value, in CSR format
+  struct value_index
+  {
+    value_index(std::span<const std::int32_t> indices,
+                std::span<const T> tag_values)
+        : values(tag_values.begin(), tag_values.end())
+    {
+      std::ranges::sort(values);
+      auto [unique_end, range_end] = std::ranges::unique(values);
+      values.erase(unique_end, range_end);
+
+      // Counting sort of the entities by value, keeping the sorted
+      // order of the entities for each value
+      std::vector<std::int32_t> pos(tag_values.size());
+      offsets.assign(values.size() + 1, 0);
+      for (std::size_t i = 0; i < tag_values.size(); ++i)
+      {
+        pos[i] = std::distance(values.begin(),
+                               std::ranges::lower_bound(values, tag_values[i]));
+        ++offsets[pos[i] + 1];
+      }
+      std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+      entities.resize(indices.size());
+      std::vector<std::int32_t> next(offsets.begin(), std::prev(offsets.end()));
+      for (std::size_t i = 0; i < indices.size(); ++i)
+        entities[next[pos[i]]++] = indices[i];
+    }
+
+    // Distinct tag values, sorted
+    std::vector<T> values;
+
+    // Offsets into entities for each value
+    std::vector<std::int32_t> offsets;
+
+    // Tagged entities, grouped by value
+    std::vector<std::int32_t> entities;
+  };
+
   // Associated topology
   std::shared_ptr<const Topology> _topology;
 
@@ -124,6 +185,10 @@ private:
 
   // Values attached to entities
   std::vector<T> _values;
+
+  // Index from values to entities, created on demand and accessed
+  // atomically
+  mutable std::shared_ptr<const value_index> _index;
 };
 
 /// @brief Create MeshTags from arrays
@@ -139,7 +204,7 @@ MeshTags<T> create_meshtags(std::shared_ptr<const Topology> topology, int dim,
                             const graph::AdjacencyList<std::int32_t>& entities,
                             std::span<const T> values)
 {
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Building MeshTags object from tagged entities (defined by vertices).");
 
   // Compute the indices of the topology entities (index is set to -1 if
@@ -166,4 +231,93 @@ MeshTags<T> create_meshtags(std::shared_ptr<const Topology> topology, int dim,
   return MeshTags<T>(topology, dim, std::move(indices_sorted),
                      std::move(values_sorted));
 }
+
+/// @brief Migrate MeshTags to a redistributed mesh.
+///
+/// The tags of each entity are sent with the cells that are incident
+/// to the entity, see mesh::redistribute.
+///
+/// @note This function is collective.
+///
+/// @param[in] tags Tags on the mesh that was redistributed. The
+/// cell-to-entity connectivity of its topology must have been created.
+/// @param[in] topology Topology of the redistributed mesh.
+/// @param[in] cell_map Global index of each cell (owned and ghost) of
+/// `topology` in the cell index map of the topology of `tags`, as
+/// returned by mesh::redistribute.
+/// @return Tags on the redistributed mesh.
+template <typename T>
+MeshTags<T> migrate_meshtags(const MeshTags<T>& tags,
+                             std::shared_ptr<Topology> topology,
+                             std::span<const std::int64_t> cell_map)
+{
+  std::shared_ptr<const Topology> topology0 = tags.topology();
+  assert(topology0);
+  assert(topology);
+  const int tdim = topology0->dim();
+  const int dim = tags.dim();
+  const int num_cell_entities
+      = cell_num_entities(topology0->cell_type(), dim);
+  auto c_to_e0 = topology0->connectivity(tdim, dim);
+  if (dim != tdim and !c_to_e0)
+    throw std::runtime_error("Missing cell-to-entity connectivity.");
+
+  // Mark the entities with tags
+  auto entity_map = topology0->index_map(dim);
+  assert(entity_map);
+  const std::int32_t num_entities
+      = entity_map->size_local() + entity_map->num_ghosts();
+  std::vector<std::int8_t> marked(num_entities, 0);
+  std::vector<T> values(num_entities, T());
+  for (std::size_t i = 0; i < tags.indices().size(); ++i)
+  {
+    marked[tags.indices()[i]] = 1;
+    values[tags.indices()[i]] = tags.values()[i];
+  }
+
+  // Tags of the local entities of each owned cell
+  const std::int32_t num_cells = topology0->index_map(tdim)->size_local();
+  std::vector<std::int8_t> cell_marked(num_cells * num_cell_entities);
+  std::vector<T> cell_values(num_cells * num_cell_entities);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    for (int k = 0; k < num_cell_entities; ++k)
+    {
+      std::int32_t e = dim == tdim ? c : c_to_e0->links(c)[k];
+      cell_marked[c * num_cell_entities + k] = marked[e];
+      cell_values[c * num_cell_entities + k] = values[e];
+    }
+  }
+
+  // Fetch the entity tags of the cells of the redistributed mesh
+  MPI_Comm comm = topology->comm();
+  std::vector<std::int8_t> cell_marked1 = dolfinx::MPI::distribute_data(
+      comm, cell_map, comm, cell_marked, num_cell_entities);
+  std::vector<T> cell_values1 = dolfinx::MPI::distribute_data(
+      comm, cell_map, comm, cell_values, num_cell_entities);
+
+  // Entities of the redistributed mesh are identified by their local
+  // index in the cells, which have the same vertex ordering in both
+  // meshes
+  if (dim != tdim)
+    topology->create_entities(dim);
+  auto c_to_e1 = topology->connectivity(tdim, dim);
+  std::vector<std::int32_t> indices1;
+  std::vector<T> values1;
+  for (std::int32_t c = 0; c < (std::int32_t)cell_map.size(); ++c)
+  {
+    for (int k = 0; k < num_cell_entities; ++k)
+    {
+      if (cell_marked1[c * num_cell_entities + k])
+      {
+        indices1.push_back(dim == tdim ? c : c_to_e1->links(c)[k]);
+        values1.push_back(cell_values1[c * num_cell_entities + k]);
+      }
+    }
+  }
+
+  auto [indices_sorted, values_sorted] = common::sort_unique(indices1, values1);
+  return MeshTags<T>(topology, dim, std::move(indices_sorted),
+                     std::move(values_sorted));
+}
 } // namespace dolfinx::mesh
@@ -0,0 +1,269 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace dolfinx::mesh
+{
+
+/// @brief Implicit topology of a structured grid of quadrilateral
+/// (`tdim = 2`) or hexahedral (`tdim = 3`) cells.
+///
+/// The connectivity of a structured grid follows from index
+/// arithmetic, so it is computed on the fly rather than stored. Cells
+/// and vertices are numbered lexicographically (the first direction
+/// varies fastest), as for the meshes created by create_rectangle and
+/// create_box. Facets are numbered first by their normal direction and
+/// then lexicographically.
+///
+/// The local ordering of the vertices and facets of a cell follows the
+/// DOLFINx reference cells.
+///
+/// @tparam tdim Topological dimension
+template <int tdim>
+  requires(tdim == 2 or tdim == 3)
+class StructuredGrid
+{
+public:
+  /// Number of vertices per cell
+  static constexpr int num_cell_vertices = 1 << tdim;
+
+  /// Number of facets per cell
+  static constexpr int num_cell_facets = 2 * tdim;
+
+  /// Number of vertices per facet
+  static constexpr int num_facet_vertices = 1 << (tdim - 1);
+
+  /// @brief Create a structured grid.
+  /// @param[in] n Number of cells in each direction
+  explicit StructuredGrid(std::array<std::int64_t, tdim> n) : _n(n)
+  {
+    for (std::int64_t ni : n)
+      if (ni < 1)
+        throw std::runtime_error("Structured grid must have cells.");
+  }
+
+  /// Number of cells in each direction
+  std::array<std::int64_t, tdim> shape() const { return _n; }
+
+  /// Number of cells
+  std::int64_t num_cells() const { return size(_n); }
+
+  /// Number of vertices
+  std::int64_t num_vertices() const
+  {
+    std::array<std::int64_t, tdim> nv = _n;
+    for (auto& ni : nv)
+      ++ni;
+    return size(nv);
+  }
+
+  /// Number of facets
+  std::int64_t num_facets() const
+  {
+    std::int64_t num = 0;
+    for (int d = 0; d < tdim; ++d)
+      num += size(facet_shape(d));
+    return num;
+  }
+
+  /// @brief Vertices of a cell.
+  /// @param[in] c Cell index
+  /// @return Vertex indices
+  std::array<std::int64_t, num_cell_vertices>
+  cell_vertices(std::int64_t c) const
+  {
+    assert(c >= 0 and c < num_cells());
+    std::array<std::int64_t, tdim> i = position(c, _n);
+    std::array<std::int64_t, tdim> nv = _n;
+    for (auto& ni : nv)
+      ++ni;
+
+    // Reference cell vertex k is at offset (k & 1, (k >> 1) & 1, k >> 2)
+    std::array<std::int64_t, num_cell_vertices> v;
+    for (int k = 0; k < num_cell_vertices; ++k)
+    {
+      std::array<std::int64_t, tdim> j = i;
+      for (int d = 0; d < tdim; ++d)
+        j[d] += (k >> d) & 1;
+      v[k] = index(j, nv);
+    }
+    return v;
+  }
+
+  /// @brief Facets of a cell.
+  /// @param[in] c Cell index
+  /// @return Facet indices
+  std::array<std::int64_t, num_cell_facets> cell_facets(std::int64_t c) const
+  {
+    assert(c >= 0 and c < num_cells());
+    std::array<std::int64_t, tdim> i = position(c, _n);
+    std::array<std::int64_t, num_cell_facets> f;
+    for (int k = 0; k < num_cell_facets; ++k)
+    {
+      auto [d, side] = reference_facet(k);
+      std::array<std::int64_t, tdim> j = i;
+      j[d] += side;
+      f[k] = facet_offset(d) + index(j, facet_shape(d));
+    }
+    return f;
+  }
+
+  /// @brief Cells that share the facets of a cell.
+  /// @param[in] c Cell index
+  /// @return Index of the cell across each facet of the cell, or -1 for
+  /// facets on the boundary
+  std::array<std::int64_t, num_cell_facets>
+  cell_neighbours(std::int64_t c) const
+  {
+    assert(c >= 0 and c < num_cells());
+    std::array<std::int64_t, tdim> i = position(c, _n);
+    std::array<std::int64_t, num_cell_facets> nbrs;
+    for (int k = 0; k < num_cell_facets; ++k)
+    {
+      auto [d, side] = reference_facet(k);
+      std::array<std::int64_t, tdim> j = i;
+      j[d] += side == 0 ? -1 : 1;
+      nbrs[k] = (j[d] < 0 or j[d] >= _n[d]) ? -1 : index(j, _n);
+    }
+    return nbrs;
+  }
+
+  /// @brief Vertices of a facet.
+  ///
+  /// The vertices are ordered as in the reference facet of the cell.
+  /// @param[in] f Facet index
+  /// @return Vertex indices
+  std::array<std::int64_t, num_facet_vertices>
+  facet_vertices(std::int64_t f) const
+  {
+    auto [d, i] = facet_position(f);
+    std::array<std::int64_t, tdim> nv = _n;
+    for (auto& ni : nv)
+      ++ni;
+
+    // Vertices vary in the directions tangential to the facet
+    std::array<std::int64_t, num_facet_vertices> v;
+    for (int k = 0; k < num_facet_vertices; ++k)
+    {
+      std::array<std::int64_t, tdim> j = i;
+      for (int e = 0, bit = 0; e < tdim; ++e)
+        if (e != d)
+          j[e] += (k >> bit++) & 1;
+      v[k] = index(j, nv);
+    }
+    return v;
+  }
+
+  /// @brief Cells that are incident to a facet.
+  /// @param[in] f Facet index
+  /// @return The two cells of the facet, with -1 for the missing cell
+  /// of a boundary facet. The first cell is on the side of the lower
+  /// coordinate.
+  std::array<std::int64_t, 2> facet_cells(std::int64_t f) const
+  {
+    auto [d, i] = facet_position(f);
+    std::array<std::int64_t, 2> cells = {-1, -1};
+    if (i[d] > 0)
+    {
+      std::array<std::int64_t, tdim> j = i;
+      --j[d];
+      cells[0] = index(j, _n);
+    }
+    if (i[d] < _n[d])
+      cells[1] = index(i, _n);
+    return cells;
+  }
+
+private:
+  // Number of entries of a lexicographic grid
+  static std::int64_t size(std::array<std::int64_t, tdim> n)
+  {
+    std::int64_t s = 1;
+    for (std::int64_t ni : n)
+      s *= ni;
+    return s;
+  }
+
+  // Lexicographic index of a grid position
+  static std::int64_t index(std::array<std::int64_t, tdim> i,
+                            std::array<std::int64_t, tdim> n)
+  {
+    std::int64_t idx = 0;
+    for (int d = tdim - 1; d >= 0; --d)
+      idx = idx * n[d] + i[d];
+    return idx;
+  }
+
+  // Grid position of a lexicographic index
+  static std::array<std::int64_t, tdim>
+  position(std::int64_t idx, std::array<std::int64_t, tdim> n)
+  {
+    std::array<std::int64_t, tdim> i;
+    for (int d = 0; d < tdim; ++d)
+    {
+      i[d] = idx % n[d];
+      idx /= n[d];
+    }
+    return i;
+  }
+
+  // (Normal direction, side) of facet k of the reference cell
+  static constexpr std::pair<int, int> reference_facet(int k)
+  {
+    if constexpr (tdim == 2)
+    {
+      constexpr std::array<std::pair<int, int>, 4> f
+          = {{{1, 0}, {0, 0}, {0, 1}, {1, 1}}};
+      return f[k];
+    }
+    else
+    {
+      constexpr std::array<std::pair<int, int>, 6> f
+          = {{{2, 0}, {1, 0}, {0, 0}, {0, 1}, {1, 1}, {2, 1}}};
+      return f[k];
+    }
+  }
+
+  // Grid of the facets with normal direction d
+  std::array<std::int64_t, tdim> facet_shape(int d) const
+  {
+    std::array<std::int64_t, tdim> n = _n;
+    ++n[d];
+    return n;
+  }
+
+  // Index of the first facet with normal direction d
+  std::int64_t facet_offset(int d) const
+  {
+    std::int64_t offset = 0;
+    for (int e = 0; e < d; ++e)
+      offset += size(facet_shape(e));
+    return offset;
+  }
+
+  // (Normal direction, grid position) of a facet
+  std::pair<int, std::array<std::int64_t, tdim>>
+  facet_position(std::int64_t f) const
+  {
+    assert(f >= 0 and f < num_facets());
+    int d = 0;
+    while (f >= size(facet_shape(d)))
+      f -= size(facet_shape(d++));
+    return {d, position(f, facet_shape(d))};
+  }
+
+  // Number of cells in each direction
+  std::array<std::int64_t, tdim> _n;
+};
+
+} // namespace dolfinx::mesh
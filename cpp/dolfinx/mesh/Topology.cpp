@@ -710,6 +710,17 @@ std::vector<std::int32_t> convert_to_local_indexing(
 
   return data;
 }
+//-----------------------------------------------------------------------------
+
+/// Memory used by a connectivity (bytes)
+std::size_t
+num_bytes(const std::shared_ptr<graph::AdjacencyList<std::int32_t>>& c)
+{
+  if (!c)
+    return 0;
+  return (c->array().capacity() + c->offsets().capacity())
+         * sizeof(std::int32_t);
+}
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -718,7 +729,10 @@ Topology::Topology(MPI_Comm comm, CellType cell_type)
       _connectivity(
           cell_dim(cell_type) + 1,
           std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>(
-              cell_dim(cell_type) + 1))
+              cell_dim(cell_type) + 1)),
+      _connectivity_cache(cell_dim(cell_type) + 1,
+                          std::vector<ConnectivityCacheEntry>(
+                              cell_dim(cell_type) + 1))
 {
   std::int8_t tdim = cell_dim(cell_type);
 
@@ -789,6 +803,8 @@ Topology::Topology(MPI_Comm comm, const std::vector<CellType>& cell_types)
   _connectivity.resize(conn_size);
   for (auto& c : _connectivity)
     c.resize(conn_size);
+  _connectivity_cache.resize(conn_size,
+                             std::vector<ConnectivityCacheEntry>(conn_size));
 }
 //-----------------------------------------------------------------------------
 int Topology::dim() const noexcept { return _entity_type_offsets.size() - 2; }
@@ -801,6 +817,8 @@ void Topology::set_index_map(int dim,
   if (_entity_type_offsets[dim + 1] - _entity_type_offsets[dim] != 1)
     throw std::runtime_error("Cannot set IndexMap on mixed topology mesh");
   _index_map[_entity_type_offsets[dim]] = map;
+  clear_exterior_facets(dim);
+  ++_version;
 }
 //-----------------------------------------------------------------------------
 void Topology::set_index_map(std::int8_t dim, std::int8_t i,
@@ -810,6 +828,8 @@ void Topology::set_index_map(std::int8_t dim, std::int8_t i,
   assert(i < (_entity_type_offsets[dim + 1] - _entity_type_offsets[dim]));
 
   _index_map[_entity_type_offsets[dim] + i] = map;
+  clear_exterior_facets(dim);
+  ++_version;
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const common::IndexMap> Topology::index_map(int dim) const
@@ -828,7 +848,8 @@ Topology::index_maps(std::int8_t dim) const
   return maps;
 }
 //-----------------------------------------------------------------------------
-std::int32_t Topology::create_entities(int dim)
+std::int32_t Topology::create_entities(int dim, EntityComputation method,
+                                       int num_threads)
 {
   // TODO: is this check sufficient/correct? Does not catch the cell_entity
   // entity case. Should there also be a check for
@@ -837,12 +858,38 @@ std::int32_t Topology::create_entities(int dim)
   if (connectivity(dim, 0))
     return -1;
 
-  for (std::size_t index = 0; index < this->entity_types(dim).size(); ++index)
+  create_entities(std::vector{dim}, method, num_threads);
+  return this->index_maps(dim)[0]->size_local();
+}
+//-----------------------------------------------------------------------------
+void Topology::create_entities(std::span<const int> dims,
+                               EntityComputation method, int num_threads)
+{
+  // Entity types of the dimensions that have not been computed
+  std::vector<int> _dims(dims.begin(), dims.end());
+  std::ranges::sort(_dims);
+  auto [unique_end, range_end] = std::ranges::unique(_dims);
+  _dims.erase(unique_end, range_end);
+  std::vector<std::pair<int, int>> entities;
+  for (int dim : _dims)
   {
-    // Create local entities
-    auto [cell_entity, entity_vertex, index_map, interprocess_entities]
-        = compute_entities(_comm.comm(), *this, dim, index);
+    if (connectivity(dim, 0))
+      continue;
+    for (std::size_t index = 0; index < this->entity_types(dim).size();
+         ++index)
+    {
+      entities.emplace_back(dim, index);
+    }
+  }
 
+  // Create local entities
+  auto data
+      = compute_entities(_comm.comm(), *this, entities, method, num_threads);
+  for (std::size_t i = 0; i < entities.size(); ++i)
+  {
+    auto [dim, index] = entities[i];
+    auto& [cell_entity, entity_vertex, index_map, interprocess_entities]
+        = data[i];
     for (std::size_t k = 0; k < cell_entity.size(); ++k)
     {
       if (cell_entity[k])
@@ -860,11 +907,11 @@ std::int32_t Topology::create_entities(int dim)
     if (dim == this->dim() - 1)
     {
       std::ranges::sort(interprocess_entities);
-      assert(index < _interprocess_facets.size());
+      assert(index < (int)_interprocess_facets.size());
       _interprocess_facets[index] = std::move(interprocess_entities);
+      ++_version;
     }
   }
-  return this->index_maps(dim)[0]->size_local();
 }
 //-----------------------------------------------------------------------------
 void Topology::create_connectivity(int d0, int d1)
@@ -898,16 +945,31 @@ void Topology::create_connectivity(int d0, int d1)
       // Concerning the note above: Provide an overload
       // create_connectivity(std::vector<std::pair<int, int>>)?
 
-      // Attach connectivities
+      // Attach connectivities, marking them as derived such that they
+      // can be evicted
+      const std::int8_t j0 = _entity_type_offsets[d0] + i0;
+      const std::int8_t j1 = _entity_type_offsets[d1] + i1;
       if (c_d0_d1)
+      {
         set_connectivity(c_d0_d1, {d0, i0}, {d1, i1});
+        _connectivity_cache[j0][j1].derived = true;
+      }
       if (c_d1_d0)
+      {
         set_connectivity(c_d1_d0, {d1, i1}, {d0, i0});
+        _connectivity_cache[j1][j0].derived = true;
+      }
+
+      if (_connectivity_budget < std::numeric_limits<std::size_t>::max())
+      {
+        _connectivity_cache[j0][j1].last_access = ++_access_count;
+        evict_connectivities(j0, j1);
+      }
     }
   }
 }
 //-----------------------------------------------------------------------------
-void Topology::create_entity_permutations()
+void Topology::create_entity_permutations(int num_threads)
 {
   if (!_cell_permutations.empty())
     return;
@@ -918,13 +980,29 @@ void Topology::create_entity_permutations()
   // local version? This call does quite a lot of parallel work
   // Create all mesh entities
 
-  for (int d = 0; d < tdim; ++d)
-    create_entities(d);
+  std::vector<int> dims(tdim);
+  std::iota(dims.begin(), dims.end(), 0);
+  create_entities(dims, EntityComputation::sort, num_threads);
 
   auto [facet_permutations, cell_permutations]
-      = compute_entity_permutations(*this);
+      = compute_entity_permutations(*this, num_threads);
+  _facet_permutations = std::move(facet_permutations);
+  _cell_permutations = std::move(cell_permutations);
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+void Topology::set_entity_permutations(
+    std::vector<std::uint8_t> facet_permutations,
+    std::vector<std::uint32_t> cell_permutations)
+{
   _facet_permutations = std::move(facet_permutations);
   _cell_permutations = std::move(cell_permutations);
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+bool Topology::has_entity_permutations() const
+{
+  return !_cell_permutations.empty();
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
@@ -933,7 +1011,8 @@ Topology::connectivity(int d0, int d1) const
   // Just return the first connectivity between (d0, d1) - compatibility
   assert(d0 < (int)_entity_type_offsets.size() - 1);
   assert(d1 < (int)_entity_type_offsets.size() - 1);
-  return _connectivity[_entity_type_offsets[d0]][_entity_type_offsets[d1]];
+  return cached_connectivity(_entity_type_offsets[d0],
+                             _entity_type_offsets[d1]);
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
@@ -948,8 +1027,8 @@ Topology::connectivity(std::pair<std::int8_t, std::int8_t> d0,
   assert(dim1 < (std::int8_t)_entity_type_offsets.size() - 1);
   assert(d1.second
          < (_entity_type_offsets[dim1 + 1] - _entity_type_offsets[dim1]));
-  return _connectivity[_entity_type_offsets[dim0] + d0.second]
-                      [_entity_type_offsets[dim1] + d1.second];
+  return cached_connectivity(_entity_type_offsets[dim0] + d0.second,
+                             _entity_type_offsets[dim1] + d1.second);
 }
 //-----------------------------------------------------------------------------
 void Topology::set_connectivity(
@@ -959,6 +1038,10 @@ void Topology::set_connectivity(
   assert(d0 < (int)_entity_type_offsets.size() - 1);
   assert(d1 < (int)_entity_type_offsets.size() - 1);
   _connectivity[_entity_type_offsets[d0]][_entity_type_offsets[d1]] = c;
+  _connectivity_cache[_entity_type_offsets[d0]][_entity_type_offsets[d1]]
+      = ConnectivityCacheEntry();
+  clear_exterior_facets(d0, d1);
+  ++_version;
 }
 //-----------------------------------------------------------------------------
 void Topology::set_connectivity(
@@ -976,6 +1059,109 @@ void Topology::set_connectivity(
   _connectivity[_entity_type_offsets[dim0] + i0]
                [_entity_type_offsets[dim1] + i1]
       = c;
+  _connectivity_cache[_entity_type_offsets[dim0] + i0]
+                     [_entity_type_offsets[dim1] + i1]
+      = ConnectivityCacheEntry();
+  clear_exterior_facets(dim0, dim1);
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+void Topology::set_connectivity_budget(std::size_t bytes)
+{
+  _connectivity_budget = bytes;
+  evict_connectivities(-1, -1);
+}
+//-----------------------------------------------------------------------------
+std::size_t Topology::connectivity_budget() const
+{
+  return _connectivity_budget;
+}
+//-----------------------------------------------------------------------------
+std::size_t
+Topology::connectivity_bytes(std::pair<std::int8_t, std::int8_t> d0,
+                             std::pair<std::int8_t, std::int8_t> d1) const
+{
+  return num_bytes(_connectivity[_entity_type_offsets[d0.first] + d0.second]
+                                [_entity_type_offsets[d1.first] + d1.second]);
+}
+//-----------------------------------------------------------------------------
+std::size_t Topology::connectivity_bytes() const
+{
+  std::size_t bytes = 0;
+  for (auto& c0 : _connectivity)
+    for (auto& c : c0)
+      bytes += num_bytes(c);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
+Topology::cached_connectivity(std::int8_t i, std::int8_t j) const
+{
+  ConnectivityCacheEntry& entry = _connectivity_cache[i][j];
+  if (entry.evicted)
+  {
+    // (dimension, index) of flattened entity type
+    auto entity_type = [&offsets = _entity_type_offsets](std::int8_t k)
+    {
+      auto it = std::ranges::upper_bound(offsets, k);
+      const std::int8_t dim = std::distance(offsets.begin(), it) - 1;
+      return std::pair<std::int8_t, std::int8_t>(dim, k - offsets[dim]);
+    };
+
+    DOLFINX_LOG_INFO("Re-computing evicted connectivity ({}, {})", i, j);
+    entry.evicted = false;
+    auto [c_ij, c_ji]
+        = compute_connectivity(*this, entity_type(i), entity_type(j));
+    _connectivity[i][j] = c_ij;
+    if (c_ji and !_connectivity[j][i])
+    {
+      _connectivity[j][i] = c_ji;
+      _connectivity_cache[j][i] = {true, false, 0};
+    }
+  }
+
+  if (_connectivity_budget < std::numeric_limits<std::size_t>::max())
+  {
+    entry.last_access = ++_access_count;
+    evict_connectivities(i, j);
+  }
+
+  return _connectivity[i][j];
+}
+//-----------------------------------------------------------------------------
+void Topology::evict_connectivities(std::int8_t i, std::int8_t j) const
+{
+  std::size_t bytes = connectivity_bytes();
+  while (bytes > _connectivity_budget)
+  {
+    // Find the least recently used derived connectivity
+    std::pair<int, int> lru(-1, -1);
+    std::uint64_t last_access = std::numeric_limits<std::uint64_t>::max();
+    for (std::size_t k0 = 0; k0 < _connectivity.size(); ++k0)
+    {
+      for (std::size_t k1 = 0; k1 < _connectivity[k0].size(); ++k1)
+      {
+        const ConnectivityCacheEntry& entry = _connectivity_cache[k0][k1];
+        if (_connectivity[k0][k1] and entry.derived
+            and entry.last_access < last_access
+            and !((int)k0 == i and (int)k1 == j))
+        {
+          lru = {k0, k1};
+          last_access = entry.last_access;
+        }
+      }
+    }
+
+    // Return if no connectivity can be evicted
+    if (lru.first == -1)
+      return;
+
+    auto [k0, k1] = lru;
+    DOLFINX_LOG_INFO("Evicting connectivity ({}, {})", k0, k1);
+    bytes -= num_bytes(_connectivity[k0][k1]);
+    _connectivity[k0][k1] = nullptr;
+    _connectivity_cache[k0][k1].evicted = true;
+  }
 }
 //-----------------------------------------------------------------------------
 const std::vector<std::uint32_t>& Topology::get_cell_permutation_info() const
@@ -1018,6 +1204,107 @@ Topology::interprocess_facets(std::int8_t index) const
   return _interprocess_facets.at(index);
 }
 //-----------------------------------------------------------------------------
+void Topology::set_interprocess_facets(std::int8_t index,
+                                       std::vector<std::int32_t> facets)
+{
+  _interprocess_facets.at(index) = std::move(facets);
+  clear_exterior_facets(this->dim() - 1);
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+std::uint64_t Topology::version() const { return _version; }
+//-----------------------------------------------------------------------------
+void Topology::mark_modified() { ++_version; }
+//-----------------------------------------------------------------------------
+std::vector<Topology::DofMapCacheEntry>& Topology::dofmap_cache()
+{
+  return _dofmap_cache;
+}
+//-----------------------------------------------------------------------------
+const std::vector<Topology::DofMapCacheEntry>& Topology::dofmap_cache() const
+{
+  return _dofmap_cache;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const std::vector<std::int32_t>>
+Topology::exterior_facets() const
+{
+  if (auto facets = _exterior_facets.ptr.load())
+    return facets;
+
+  const int tdim = this->dim();
+  auto f_to_c = this->connectivity(tdim - 1, tdim);
+  if (!f_to_c)
+  {
+    throw std::runtime_error(
+        "Facet to cell connectivity has not been computed.");
+  }
+
+  // Find all owned facets (not ghost) with only one attached cell
+  auto facet_map = this->index_map(tdim - 1);
+  assert(facet_map);
+  std::vector<std::int32_t> boundary_facets;
+  for (std::int32_t f = 0; f < facet_map->size_local(); ++f)
+  {
+    if (f_to_c->num_links(f) == 1)
+      boundary_facets.push_back(f);
+  }
+
+  // Remove facets on internal inter-process boundary
+  auto facets = std::make_shared<std::vector<std::int32_t>>();
+  std::ranges::set_difference(boundary_facets, _interprocess_facets[0],
+                              std::back_inserter(*facets));
+
+  _exterior_facets.ptr.store(facets);
+  return facets;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const std::vector<std::int32_t>>
+Topology::exterior_facet_pairs() const
+{
+  // Compute the exterior facets first, so that the pairs are never
+  // older than the facets
+  std::shared_ptr<const std::vector<std::int32_t>> facets
+      = this->exterior_facets();
+  if (auto pairs = _exterior_facet_pairs.ptr.load())
+    return pairs;
+
+  const int tdim = this->dim();
+  auto f_to_c = this->connectivity(tdim - 1, tdim);
+  auto c_to_f = this->connectivity(tdim, tdim - 1);
+  assert(f_to_c);
+  if (!c_to_f)
+  {
+    throw std::runtime_error(
+        "Cell to facet connectivity has not been computed.");
+  }
+
+  auto pairs = std::make_shared<std::vector<std::int32_t>>();
+  pairs->reserve(2 * facets->size());
+  for (std::int32_t f : *facets)
+  {
+    const std::int32_t c = f_to_c->links(f).front();
+    auto cell_facets = c_to_f->links(c);
+    auto it = std::ranges::find(cell_facets, f);
+    assert(it != cell_facets.end());
+    pairs->insert(pairs->end(),
+                  {c, (std::int32_t)std::distance(cell_facets.begin(), it)});
+  }
+
+  _exterior_facet_pairs.ptr.store(pairs);
+  return pairs;
+}
+//-----------------------------------------------------------------------------
+void Topology::clear_exterior_facets(int dim0, int dim1)
+{
+  const int tdim = this->dim();
+  if (dim0 == tdim - 1 or dim1 == tdim - 1)
+  {
+    _exterior_facets.ptr.store(nullptr);
+    _exterior_facet_pairs.ptr.store(nullptr);
+  }
+}
+//-----------------------------------------------------------------------------
 mesh::CellType Topology::cell_type() const { return _entity_types.back(); }
 //-----------------------------------------------------------------------------
 std::vector<CellType> Topology::entity_types(std::int8_t dim) const
@@ -1028,6 +1315,45 @@ std::vector<CellType> Topology::entity_types(std::int8_t dim) const
       std::next(_entity_types.begin(), _entity_type_offsets[dim + 1]));
 }
 //-----------------------------------------------------------------------------
+common::MemoryUsage Topology::memory_usage() const
+{
+  common::MemoryUsage usage{"Topology", sizeof(*this), {}};
+  for (std::size_t i = 0; i < _entity_types.size(); ++i)
+  {
+    if (_index_map[i])
+    {
+      common::MemoryUsage& m = usage.add(_index_map[i]->memory_usage());
+      m.name = "index map (" + to_string(_entity_types[i]) + ")";
+    }
+  }
+
+  for (std::size_t i = 0; i < _connectivity.size(); ++i)
+  {
+    for (std::size_t j = 0; j < _connectivity[i].size(); ++j)
+    {
+      if (_connectivity[i][j])
+      {
+        common::MemoryUsage& c = usage.add(_connectivity[i][j]->memory_usage());
+        c.name = "connectivity (" + to_string(_entity_types[i]) + ", "
+                 + to_string(_entity_types[j]) + ")";
+      }
+    }
+  }
+
+  usage.add("facet permutations", common::capacity_bytes(_facet_permutations));
+  usage.add("cell permutations", common::capacity_bytes(_cell_permutations));
+  usage.add("interprocess facets",
+            common::capacity_bytes(_interprocess_facets));
+  std::size_t exterior_bytes = 0;
+  if (auto facets = _exterior_facets.ptr.load())
+    exterior_bytes += common::capacity_bytes(*facets);
+  if (auto pairs = _exterior_facet_pairs.ptr.load())
+    exterior_bytes += common::capacity_bytes(*pairs);
+  usage.add("exterior facets", exterior_bytes);
+  usage.add("original cell index", common::capacity_bytes(original_cell_index));
+  return usage;
+}
+//-----------------------------------------------------------------------------
 MPI_Comm Topology::comm() const { return _comm.comm(); }
 //-----------------------------------------------------------------------------
 Topology mesh::create_topology(
@@ -1043,7 +1369,7 @@ Topology mesh::create_topology(
   assert(ghost_owners.size() == cells.size());
   assert(original_cell_index.size() == cells.size());
 
-  spdlog::info("Create topology (generalised)");
+  DOLFINX_LOG_INFO("Create topology (generalised)");
   // Check cell data consistency and compile spans of owned and ghost cells
   std::vector<std::int32_t> num_local_cells(cell_type.size());
   std::vector<std::span<const std::int64_t>> owned_cells;
@@ -1321,7 +1647,7 @@ mesh::create_topology(MPI_Comm comm, std::span<const std::int64_t> cells,
                       std::span<const int> ghost_owners, CellType cell_type,
                       std::span<const std::int64_t> boundary_vertices)
 {
-  spdlog::info("Create topology (single cell type)");
+  DOLFINX_LOG_INFO("Create topology (single cell type)");
 
   return create_topology(comm, {cell_type}, {cells}, {original_cell_index},
                          {ghost_owners}, boundary_vertices);
@@ -1386,27 +1712,20 @@ mesh::create_subtopology(const Topology& topology, int dim,
   sub_e_to_v_vec.reserve(subentities.size() * num_vertices_per_entity);
   std::vector<std::int32_t> sub_e_to_v_offsets(1, 0);
   sub_e_to_v_offsets.reserve(subentities.size() + 1);
-
-  // Create vertex-to-subvertex vertex map (i.e. the inverse of
-  // subvertex_to_vertex)
-  // NOTE: Depending on the sub-topology, this may be densely or sparsely
-  // populated. Is a different data structure more appropriate?
-  std::vector<std::int32_t> vertex_to_subvertex(
-      map0->size_local() + map0->num_ghosts(), -1);
-  for (std::size_t i = 0; i < subvertices0.size(); ++i)
-    vertex_to_subvertex[subvertices0[i]] = i;
-
   for (std::int32_t e : subentities)
   {
-    for (std::int32_t v : e_to_v->links(e))
-    {
-      std::int32_t v_sub = vertex_to_subvertex[v];
-      assert(v_sub != -1);
-      sub_e_to_v_vec.push_back(v_sub);
-    }
+    auto vertices = e_to_v->links(e);
+    sub_e_to_v_vec.insert(sub_e_to_v_vec.end(), vertices.begin(),
+                          vertices.end());
     sub_e_to_v_offsets.push_back(sub_e_to_v_vec.size());
   }
 
+  // Renumber the entity vertices to sub-topology vertices (the inverse
+  // of subvertex_to_vertex)
+  impl::parent_to_sub_indices(subvertices0,
+                              map0->size_local() + map0->num_ghosts(),
+                              sub_e_to_v_vec);
+
   auto sub_e_to_v = std::make_shared<graph::AdjacencyList<std::int32_t>>(
       std::move(sub_e_to_v_vec), std::move(sub_e_to_v_offsets));
 
@@ -1425,7 +1744,8 @@ std::vector<std::int32_t>
 mesh::entities_to_index(const Topology& topology, int dim,
                         std::span<const std::int32_t> entities)
 {
-  spdlog::info("Build list of mesh entity indices from the entity vertices.");
+  DOLFINX_LOG_INFO(
+      "Build list of mesh entity indices from the entity vertices.");
 
   // Tagged entity topological dimension
   auto map_e = topology.index_map(dim);
@@ -6,12 +6,18 @@
 
 #pragma once
 
+#include "topologycomputation.h"
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <limits>
 #include <memory>
 #include <span>
 #include <tuple>
+#include <typeindex>
 #include <vector>
 
 namespace dolfinx::common
@@ -19,10 +25,9 @@ namespace dolfinx::common
 class IndexMap;
 }
 
-namespace dolfinx::graph
+namespace dolfinx::fem
 {
-template <typename T>
-class AdjacencyList;
+class DofMap;
 }
 
 namespace dolfinx::mesh
@@ -37,9 +42,19 @@ enum class CellType;
 /// where dim is the topological dimension and i is the index of the
 /// entity within that topological dimension.
 ///
-/// @todo Rework memory management and associated API. Currently, there
-/// is no clear caching policy implemented and no way of discarding
-/// cached data.
+/// Connectivities that are computed by create_connectivity are cached.
+/// A memory budget for the connectivities can be set with
+/// set_connectivity_budget, in which case the least recently used
+/// cached connectivities are evicted when the budget is exceeded and
+/// re-computed when they are next requested.
+///
+/// The exterior facets, and their (cell, local facet) pairs, are
+/// computed on first use and cached until the facet index map or the
+/// facet-cell connectivity is changed.
+///
+/// The dofmaps of elements on the topology created by
+/// fem::create_shared_dofmap are held by the topology, and are
+/// destroyed with it.
 class Topology
 {
 public:
@@ -148,6 +163,47 @@ public:
                         std::pair<std::int8_t, std::int8_t> d0,
                         std::pair<std::int8_t, std::int8_t> d1);
 
+  /// @brief Set the memory budget for the connectivities.
+  ///
+  /// If the memory used by the connectivities exceeds the budget, the
+  /// least recently used connectivities that were computed by
+  /// create_connectivity are evicted. An evicted connectivity is
+  /// re-computed when it is requested by connectivity(). Connectivities
+  /// that are created by create_entities, e.g. cell-to-vertex and
+  /// cell-to-facet, or set by set_connectivity are never evicted, so the
+  /// budget may not be met.
+  ///
+  /// @note When a budget is set, connectivity() records the access to
+  /// the connectivity and may re-compute or evict connectivities, so it
+  /// must not be called concurrently from different threads.
+  /// @param[in] bytes Budget in bytes. The default is no limit.
+  void set_connectivity_budget(std::size_t bytes);
+
+  /// @brief Memory budget for the connectivities in bytes.
+  std::size_t connectivity_budget() const;
+
+  /// @brief Memory used by the connectivity from entities of dimension
+  /// `d0` to entities of dimension `d1`.
+  /// @param d0 Pair of (topological dimension of entities, index of
+  /// entity type within topological dimension)
+  /// @param d1 Pair of (topological dimension of incident entities,
+  /// index of incident entity type within topological dimension)
+  /// @return Bytes used by the connectivity, or zero if the
+  /// connectivity has not been computed or has been evicted.
+  std::size_t connectivity_bytes(std::pair<std::int8_t, std::int8_t> d0,
+                                 std::pair<std::int8_t, std::int8_t> d1) const;
+
+  /// @brief Memory used by all connectivities in bytes.
+  std::size_t connectivity_bytes() const;
+
+  /// @brief Memory used by the topology.
+  ///
+  /// Index maps that are shared with other data structures are
+  /// included.
+  /// @return Memory usage, with the index maps, connectivities,
+  /// permutation data and inter-process facets as parts
+  common::MemoryUsage memory_usage() const;
+
   /// @brief Returns the permutation information
   const std::vector<std::uint32_t>& get_cell_permutation_info() const;
 
@@ -176,9 +232,30 @@ public:
 
   /// @brief Create entities of given topological dimension.
   /// @param[in] dim Topological dimension
+  /// @param[in] method Algorithm used to identify the entities, see
+  /// compute_entities
+  /// @param[in] num_threads Number of threads
   /// @return Number of newly created entities, returns -1 if entities
   /// already existed
-  std::int32_t create_entities(int dim);
+  std::int32_t create_entities(int dim,
+                               EntityComputation method
+                               = EntityComputation::sort,
+                               int num_threads = 1);
+
+  /// @brief Create entities of several topological dimensions.
+  ///
+  /// The entities are the same as created by create_entities for each
+  /// dimension. If `num_threads` is greater than one, the dimensions are
+  /// computed concurrently (see compute_entities), e.g. the edges and
+  /// faces of a hexahedral mesh for an N1curl space of degree two.
+  /// @param[in] dims Topological dimensions. Dimensions whose entities
+  /// exist are skipped.
+  /// @param[in] method Algorithm used to identify the entities, see
+  /// compute_entities
+  /// @param[in] num_threads Number of threads
+  void create_entities(std::span<const int> dims,
+                       EntityComputation method = EntityComputation::sort,
+                       int num_threads = 1);
 
   /// @brief Create connectivity between given pair of dimensions, `d0
   /// -> d1`.
@@ -187,7 +264,22 @@ public:
   void create_connectivity(int d0, int d1);
 
   /// @brief Compute entity permutations and reflections.
-  void create_entity_permutations();
+  /// @param[in] num_threads Number of threads
+  void create_entity_permutations(int num_threads = 1);
+
+  /// @brief Set the entity permutations and reflections, e.g. when
+  /// they were computed by create_entity_permutations for a topology
+  /// that was stored.
+  /// @param[in] facet_permutations Facet permutations, see
+  /// get_facet_permutations
+  /// @param[in] cell_permutations Cell permutation info, see
+  /// get_cell_permutation_info
+  void set_entity_permutations(std::vector<std::uint8_t> facet_permutations,
+                               std::vector<std::uint32_t> cell_permutations);
+
+  /// @brief Check if the entity permutations have been computed or
+  /// set.
+  bool has_entity_permutations() const;
 
   /// @brief List of inter-process facets, if facet topology has been
   /// computed.
@@ -199,6 +291,56 @@ public:
   /// @param index Index of facet type
   const std::vector<std::int32_t>& interprocess_facets(std::int8_t index) const;
 
+  /// @brief Set the inter-process facets of the facet type in
+  /// `Topology::entity_types` identified by index, e.g. when the facets
+  /// were set with set_index_map and set_connectivity.
+  /// @param[in] index Index of facet type
+  /// @param[in] facets Sorted list of the inter-process facets
+  void set_interprocess_facets(std::int8_t index,
+                               std::vector<std::int32_t> facets);
+
+  /// @brief Owned exterior facets.
+  ///
+  /// An exterior facet is connected globally to only one cell. The
+  /// facets are computed on first use and cached. The cache is
+  /// discarded when the facet index map or the facet-cell connectivity
+  /// is set. Only the first facet type is considered.
+  ///
+  /// @pre Facet-to-cell connectivity must have been computed.
+  /// @return Sorted list of the owned exterior facets. The list is
+  /// shared with the cache and remains valid after the cache is
+  /// discarded.
+  std::shared_ptr<const std::vector<std::int32_t>> exterior_facets() const;
+
+  /// @brief The (cell, local facet) pair of each owned exterior facet.
+  ///
+  /// The pairs are in the order of exterior_facets(), flattened, and
+  /// are cached in the same way.
+  ///
+  /// @pre Facet-to-cell and cell-to-facet connectivity must have been
+  /// computed.
+  /// @return Flattened list of (cell, local facet index) pairs.
+  std::shared_ptr<const std::vector<std::int32_t>>
+  exterior_facet_pairs() const;
+
+  /// @brief Version of the topology.
+  ///
+  /// The version is incremented when the topology is changed, i.e. when
+  /// an index map, a connectivity, the entity permutations or the
+  /// inter-process facets are set or computed. Re-computation of an
+  /// evicted connectivity does not change the version. Data computed
+  /// from the topology, e.g. lists of entities, is valid while the
+  /// version is unchanged.
+  ///
+  /// @return Version of the topology.
+  std::uint64_t version() const;
+
+  /// @brief Increment the version of the topology.
+  ///
+  /// Call after modifying topology data that is not tracked by
+  /// version(), e.g. original_cell_index.
+  void mark_modified();
+
   /// Original cell index for each cell type
   std::vector<std::vector<std::int64_t>> original_cell_index;
 
@@ -206,7 +348,61 @@ public:
   /// @return The communicator on which the topology is distributed
   MPI_Comm comm() const;
 
+  /// @brief A dofmap of an element on the topology (see
+  /// fem::create_shared_dofmap).
+  struct DofMapCacheEntry
+  {
+    /// Type of the element
+    std::type_index type;
+
+    /// The element
+    std::shared_ptr<const void> element;
+
+    /// Dofmap of the element on the topology
+    std::shared_ptr<const fem::DofMap> dofmap;
+  };
+
+  /// @brief Dofmaps that are shared by function spaces with identical
+  /// elements on the topology.
+  ///
+  /// The dofmaps are added by fem::create_shared_dofmap and are held
+  /// until the topology is destroyed or the list is cleared. The list
+  /// is not thread-safe.
+  std::vector<DofMapCacheEntry>& dofmap_cache();
+
+  /// @brief Dofmaps that are shared by function spaces with identical
+  /// elements on the topology.
+  const std::vector<DofMapCacheEntry>& dofmap_cache() const;
+
 private:
+  // Cache state of a connectivity
+  struct ConnectivityCacheEntry
+  {
+    // True if the connectivity was computed by create_connectivity, in
+    // which case it can be evicted and re-computed
+    bool derived = false;
+
+    // True if the connectivity has been evicted
+    bool evicted = false;
+
+    // Time of the last access, used to find the least recently used
+    // connectivity
+    std::uint64_t last_access = 0;
+  };
+
+  // Discard the cached exterior facets if facet data of dimension
+  // dim0 or dim1 is changed
+  void clear_exterior_facets(int dim0, int dim1 = -1);
+
+  // Connectivity between flattened entity types (i, j), re-computing it
+  // if it has been evicted and recording the access if a budget is set
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
+  cached_connectivity(std::int8_t i, std::int8_t j) const;
+
+  // Evict least recently used derived connectivities, other than
+  // connectivity (i, j), until the budget is met
+  void evict_connectivities(std::int8_t i, std::int8_t j) const;
+
   // MPI communicator
   dolfinx::MPI::Comm _comm;
 
@@ -229,10 +425,21 @@ private:
   // increasing in topological dimension. There may be multiple types in each
   // dimension, e.g. triangle and quadrilateral facets.
   // Connectivity between different entity types of same dimension will always
-  // be nullptr.
-  std::vector<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>>
+  // be nullptr. Mutable because evicted connectivities are re-computed
+  // on access.
+  mutable std::vector<
+      std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>>
       _connectivity;
 
+  // Cache state for each connectivity, in the layout of _connectivity
+  mutable std::vector<std::vector<ConnectivityCacheEntry>> _connectivity_cache;
+
+  // Counter for connectivity accesses
+  mutable std::uint64_t _access_count = 0;
+
+  // Memory budget for the connectivities (bytes)
+  std::size_t _connectivity_budget = std::numeric_limits<std::size_t>::max();
+
   // The facet permutations (local facet, cell))
   // [cell0_0, cell0_1, ,cell0_2, cell1_0, cell1_1, ,cell1_2, ...,
   // celln_0, celln_1, ,celln_2,]
@@ -244,6 +451,31 @@ private:
 
   // List of facets that are on the inter-process boundary for each facet type
   std::vector<std::vector<std::int32_t>> _interprocess_facets;
+
+  // Incremented on every change of the topology
+  std::uint64_t _version = 0;
+
+  // Atomic shared pointer that is copied with the topology
+  struct AtomicCache
+  {
+    AtomicCache() = default;
+    AtomicCache(const AtomicCache& c) : ptr(c.ptr.load()) {}
+    AtomicCache& operator=(const AtomicCache& c)
+    {
+      ptr.store(c.ptr.load());
+      return *this;
+    }
+    std::atomic<std::shared_ptr<const std::vector<std::int32_t>>> ptr;
+  };
+
+  // Cached owned exterior facets and their (cell, local facet) pairs.
+  // Computed on first use. Accessed atomically so that the const
+  // accessors can be called concurrently.
+  mutable AtomicCache _exterior_facets;
+  mutable AtomicCache _exterior_facet_pairs;
+
+  // Dofmaps created by fem::create_shared_dofmap
+  std::vector<DofMapCacheEntry> _dofmap_cache;
 };
 
 /// @brief Create a mesh topology.
@@ -13,6 +13,7 @@
 #include <cfloat>
 #include <concepts>
 #include <cstddef>
+#include <dolfinx/common/sort.h>
 #include <limits>
 #include <mpi.h>
 #include <vector>
@@ -65,6 +66,11 @@ Mesh<T> build_prism(MPI_Comm comm, MPI_Comm subcomm,
                     std::array<std::array<double, 3>, 2> p,
                     std::array<std::int64_t, 3> n,
                     const CellPartitionFunction& partitioner);
+
+template <std::floating_point T>
+Mesh<T> build_blocked(MPI_Comm comm, std::array<std::array<double, 3>, 2> p,
+                      std::array<std::int64_t, 3> n, CellType celltype,
+                      GhostMode ghost_mode);
 } // namespace impl
 
 /// @brief Create a uniform mesh::Mesh over rectangular prism spanned by
@@ -133,6 +139,41 @@ Mesh<T> create_box(MPI_Comm comm, std::array<std::array<double, 3>, 2> p,
   return create_box<T>(comm, comm, p, n, celltype, partitioner);
 }
 
+/// @brief Create a uniform mesh::Mesh over rectangular prism spanned by
+/// the two points `p`, with each process creating the cells of its own
+/// block of the box.
+///
+/// The box is divided into blocks of cells by a Cartesian grid of
+/// processes (as computed by `MPI_Dims_create`), and each process
+/// creates the cells, ghost cells and vertex coordinates of its block
+/// directly. No graph partitioning and no re-distribution of cells or
+/// coordinates is performed, which makes the creation of very large
+/// meshes cheap. The cells are ordered lexicographically on each
+/// process.
+///
+/// The mesh is the same as the mesh created by create_box, but with a
+/// different parallel distribution of the cells.
+///
+/// @param[in] comm MPI communicator to build the mesh on.
+/// @param[in] p Corner of the box.
+/// @param[in] n Number of cells in each direction. Must be at least the
+/// number of processes in the same direction of the process grid.
+/// @param[in] celltype Cell shape (tetrahedron or hexahedron).
+/// @param[in] ghost_mode Ghost cells to create. Cells of neighbouring
+/// blocks are ghosted if their cuboid shares a facet (`shared_facet`)
+/// or a vertex (`shared_vertex`) with the block.
+/// @return Mesh
+template <std::floating_point T = double>
+Mesh<T> create_box_blocked(MPI_Comm comm,
+                           std::array<std::array<double, 3>, 2> p,
+                           std::array<std::int64_t, 3> n, CellType celltype,
+                           GhostMode ghost_mode = GhostMode::none)
+{
+  if (celltype != CellType::tetrahedron and celltype != CellType::hexahedron)
+    throw std::runtime_error("Generate blocked box mesh. Wrong cell type");
+  return impl::build_blocked<T>(comm, p, n, celltype, ghost_mode);
+}
+
 /// @brief Create a uniform mesh::Mesh over the rectangle spanned by the
 /// two points `p`.
 ///
@@ -420,6 +461,172 @@ mesh::Mesh<T> build_hex(MPI_Comm comm, MPI_Comm subcomm,
                      {x.size() / 3, 3}, partitioner);
 }
 
+template <std::floating_point T>
+Mesh<T> build_blocked(MPI_Comm comm, std::array<std::array<double, 3>, 2> p,
+                      std::array<std::int64_t, 3> n, CellType celltype,
+                      GhostMode ghost_mode)
+{
+  common::Timer timer("Build blocked BoxMesh");
+
+  std::array<double, 3> x0, x1;
+  for (int d = 0; d < 3; ++d)
+  {
+    x0[d] = std::min(p[0][d], p[1][d]);
+    x1[d] = std::max(p[0][d], p[1][d]);
+    if (x1[d] - x0[d] < 2.0 * std::numeric_limits<double>::epsilon())
+    {
+      throw std::runtime_error(
+          "Box seems to have zero width, height or depth. Check dimensions");
+    }
+  }
+
+  // Process grid, with the largest number of processes in the
+  // direction with the most cells
+  const int size = dolfinx::MPI::size(comm);
+  const int rank = dolfinx::MPI::rank(comm);
+  std::array<int, 3> dims = {0, 0, 0};
+  MPI_Dims_create(size, 3, dims.data());
+  std::array<int, 3> dirs = {0, 1, 2};
+  std::ranges::sort(dirs, [&n](int a, int b) { return n[a] > n[b]; });
+  std::array<int, 3> pdims;
+  for (int d = 0; d < 3; ++d)
+  {
+    pdims[dirs[d]] = dims[d];
+    if (n[dirs[d]] < dims[d])
+    {
+      throw std::runtime_error(
+          "Number of cells in blocked BoxMesh smaller than process grid");
+    }
+  }
+
+  // Process grid position, block of owned cuboids ([c0, c1) in each
+  // direction) and the block with the ghost layer ([g0, g1))
+  const std::array<int, 3> r
+      = {rank % pdims[0], (rank / pdims[0]) % pdims[1],
+         rank / (pdims[0] * pdims[1])};
+  std::array<std::int64_t, 3> c0, c1, g0, g1;
+  for (int d = 0; d < 3; ++d)
+  {
+    auto [r0, r1] = dolfinx::MPI::local_range(r[d], n[d], pdims[d]);
+    c0[d] = r0;
+    c1[d] = r1;
+    const std::int64_t layer = ghost_mode == GhostMode::none ? 0 : 1;
+    g0[d] = std::max<std::int64_t>(c0[d] - layer, 0);
+    g1[d] = std::min<std::int64_t>(c1[d] + layer, n[d]);
+  }
+
+  const std::int64_t nx = n[0];
+  const std::int64_t ny = n[1];
+  const int cells_per_cuboid = celltype == CellType::tetrahedron ? 6 : 1;
+
+  // Add the cells of a cuboid
+  std::vector<std::int64_t> cells, original_index;
+  auto add_cuboid = [&](std::int64_t ix, std::int64_t iy, std::int64_t iz)
+  {
+    const std::int64_t v0 = (iz * (ny + 1) + iy) * (nx + 1) + ix;
+    const std::int64_t v1 = v0 + 1;
+    const std::int64_t v2 = v0 + (nx + 1);
+    const std::int64_t v3 = v1 + (nx + 1);
+    const std::int64_t v4 = v0 + (nx + 1) * (ny + 1);
+    const std::int64_t v5 = v1 + (nx + 1) * (ny + 1);
+    const std::int64_t v6 = v2 + (nx + 1) * (ny + 1);
+    const std::int64_t v7 = v3 + (nx + 1) * (ny + 1);
+    if (celltype == CellType::tetrahedron)
+    {
+      cells.insert(cells.end(),
+                   {v0, v1, v3, v7, v0, v1, v7, v5, v0, v5, v7, v4,
+                    v0, v3, v2, v7, v0, v6, v4, v7, v0, v2, v6, v7});
+    }
+    else
+      cells.insert(cells.end(), {v0, v1, v2, v3, v4, v5, v6, v7});
+
+    const std::int64_t c = (iz * ny + iy) * nx + ix;
+    for (int k = 0; k < cells_per_cuboid; ++k)
+      original_index.push_back(c * cells_per_cuboid + k);
+  };
+
+  // Owned cells
+  for (std::int64_t iz = c0[2]; iz < c1[2]; ++iz)
+    for (std::int64_t iy = c0[1]; iy < c1[1]; ++iy)
+      for (std::int64_t ix = c0[0]; ix < c1[0]; ++ix)
+        add_cuboid(ix, iy, iz);
+
+  // Ghost cells, with the owning rank computed from the position of the
+  // cuboid in the process grid
+  std::vector<int> ghost_owners;
+  for (std::int64_t iz = g0[2]; iz < g1[2]; ++iz)
+  {
+    for (std::int64_t iy = g0[1]; iy < g1[1]; ++iy)
+    {
+      for (std::int64_t ix = g0[0]; ix < g1[0]; ++ix)
+      {
+        const std::array<std::int64_t, 3> i = {ix, iy, iz};
+        int num_outside = 0;
+        for (int d = 0; d < 3; ++d)
+          num_outside += (i[d] < c0[d] or i[d] >= c1[d]);
+        if (num_outside == 0
+            or (ghost_mode == GhostMode::shared_facet and num_outside > 1))
+        {
+          continue;
+        }
+
+        add_cuboid(ix, iy, iz);
+        std::array<int, 3> q;
+        for (int d = 0; d < 3; ++d)
+          q[d] = dolfinx::MPI::index_owner(pdims[d], i[d], n[d]);
+        ghost_owners.insert(ghost_owners.end(), cells_per_cuboid,
+                            (q[2] * pdims[1] + q[1]) * pdims[0] + q[0]);
+      }
+    }
+  }
+
+  // Vertices on the boundary of the block of owned cells
+  std::vector<std::int64_t> boundary_v;
+  for (std::int64_t iz = c0[2]; iz <= c1[2]; ++iz)
+  {
+    for (std::int64_t iy = c0[1]; iy <= c1[1]; ++iy)
+    {
+      for (std::int64_t ix = c0[0]; ix <= c1[0]; ++ix)
+      {
+        if (ix == c0[0] or ix == c1[0] or iy == c0[1] or iy == c1[1]
+            or iz == c0[2] or iz == c1[2])
+        {
+          boundary_v.push_back((iz * (ny + 1) + iy) * (nx + 1) + ix);
+        }
+      }
+    }
+  }
+
+  Topology topology = create_topology(comm, cells, original_index,
+                                      ghost_owners, celltype, boundary_v);
+
+  // Vertex coordinates of the owned and ghost cells
+  std::vector<std::int64_t> nodes = cells;
+  dolfinx::radix_sort(nodes);
+  auto [unique_end, range_end] = std::ranges::unique(nodes);
+  nodes.erase(unique_end, range_end);
+  std::vector<T> x;
+  x.reserve(3 * nodes.size());
+  for (std::int64_t v : nodes)
+  {
+    const std::array<std::int64_t, 3> i
+        = {v % (nx + 1), (v / (nx + 1)) % (ny + 1), v / ((nx + 1) * (ny + 1))};
+    for (int d = 0; d < 3; ++d)
+    {
+      const T a = x0[d];
+      const T b = x1[d];
+      const T h = (b - a) / static_cast<T>(n[d]);
+      x.push_back(a + h * static_cast<T>(i[d]));
+    }
+  }
+
+  fem::CoordinateElement<T> element(celltype, 1);
+  Geometry geometry = create_geometry(topology, element, nodes, cells, x, 3);
+
+  return Mesh<T>(comm, std::make_shared<Topology>(std::move(topology)),
+                 std::move(geometry));
+}
+
 template <std::floating_point T>
 Mesh<T> build_prism(MPI_Comm comm, MPI_Comm subcomm,
                     std::array<std::array<double, 3>, 2> p,
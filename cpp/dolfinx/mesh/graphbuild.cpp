@@ -12,6 +12,8 @@
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/sort.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <limits>
+#include <numeric>
 #include <span>
 #include <utility>
 #include <vector>
@@ -21,6 +23,31 @@ using namespace dolfinx;
 namespace
 {
 //-----------------------------------------------------------------------------
+/// @brief Mix the bits of a 64-bit integer (finaliser of the SplitMix64
+/// generator).
+constexpr std::uint64_t mix(std::uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+//-----------------------------------------------------------------------------
+/// @brief Compute a hash of the sorted vertices of a facet.
+///
+/// Negative (padding) values at the end of `v` are ignored, so the
+/// hash of a facet does not depend on the padding.
+std::uint64_t facet_hash(std::span<const std::int64_t> v)
+{
+  std::uint64_t h = 0;
+  for (std::int64_t x : v)
+  {
+    if (x < 0)
+      break;
+    h = mix(h + std::uint64_t(x));
+  }
+  return h;
+}
+//-----------------------------------------------------------------------------
 /// @brief Build nonlocal part of dual graph for mesh and return number
 /// of non-local edges.
 ///
@@ -29,6 +56,13 @@ namespace
 /// @note graphbuild::compute_local_dual_graph should be called
 /// before this function is called.
 ///
+/// Facets are sent to a 'post office' rank, which is determined by the
+/// first facet vertex, as the key `(v0, h)`, where `v0` is the first
+/// vertex and `h` is the second vertex for facets with at most two
+/// vertices and a hash of the remaining vertices otherwise. Three
+/// 64-bit integers (the key and the cell) are sent per facet. Facets
+/// can be exchanged in several rounds to reduce the peak memory use.
+///
 /// @param[in] comm MPI communicator
 /// @param[in] facets Facets on this rank that are shared by only on
 /// cell on this rank, i.e. candidates for possibly residing on other
@@ -41,24 +75,24 @@ namespace
 /// @param[in] cells Attached cell (local index) for each facet in
 /// `facet`.
 /// @param[in] local_graph The dual graph for cells on this MPI rank
+/// @param[in] round_size Maximum number of facets (approximately) that
+/// a rank sends in one round of the exchange. If zero, all facets are
+/// sent in one round.
 /// @return (0) Extended dual graph to include ghost edges (edges to
 /// off-procss cells) and (1) the number of ghost edges
 graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
     const MPI_Comm comm, std::span<const std::int64_t> facets,
     std::size_t shape1, std::span<const std::int32_t> cells,
-    const graph::AdjacencyList<std::int32_t>& local_graph)
+    const graph::AdjacencyList<std::int32_t>& local_graph,
+    std::size_t round_size)
 {
-  spdlog::info("Build nonlocal part of mesh dual graph");
+  DOLFINX_LOG_INFO("Build nonlocal part of mesh dual graph");
   common::Timer timer("Compute non-local part of mesh dual graph");
 
-  // TODO: Two possible straightforward optimisations:
+  // TODO: Possible optimisations:
   // 1. Do not send owned data to self via MPI.
   // 2. Modify MPI::index_owner to use a subset of ranks as post offices.
-  // 3. Find the max buffer row size for the neighbourhood rather than
-  //    globally.
-  //
-  // Less straightforward optimisations:
-  // 4. After matching, send back matches only, (and only to ranks with
+  // 3. After matching, send back matches only, (and only to ranks with
   //    a match) (Note: this would complicate the communication and
   //    handling of buffers)
 
@@ -85,13 +119,16 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
                 &request_cell_offset);
   }
 
-  // Find (max_vert_per_facet, min_vertex_index, max_vertex_index)
-  // across all processes. Use first facet vertex for min/max index.
+  // Find (max_vert_per_facet, min_vertex_index, max_vertex_index,
+  // max_num_facets) across all processes. Use first facet vertex for
+  // min/max index.
   std::int32_t fshape1 = -1;
   std::array<std::int64_t, 2> vrange;
+  int num_rounds = 1;
   {
-    std::array<std::int64_t, 3> send_buffer_r
-        = {std::int64_t(shape1), std::numeric_limits<std::int64_t>::min(), -1};
+    std::array<std::int64_t, 4> send_buffer_r
+        = {std::int64_t(shape1), std::numeric_limits<std::int64_t>::min(), -1,
+           std::int64_t(shape0)};
     for (std::size_t i = 0; i < facets.size(); i += shape1)
     {
       send_buffer_r[1] = std::max(send_buffer_r[1], -facets[i]);
@@ -99,44 +136,73 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
     }
 
     // Compute reductions
-    std::array<std::int64_t, 3> recv_buffer_r;
-    MPI_Allreduce(send_buffer_r.data(), recv_buffer_r.data(), 3, MPI_INT64_T,
+    std::array<std::int64_t, 4> recv_buffer_r;
+    MPI_Allreduce(send_buffer_r.data(), recv_buffer_r.data(), 4, MPI_INT64_T,
                   MPI_MAX, comm);
     assert(recv_buffer_r[1] != std::numeric_limits<std::int64_t>::min());
     assert(recv_buffer_r[2] != -1);
     fshape1 = recv_buffer_r[0];
     vrange = {-recv_buffer_r[1], recv_buffer_r[2] + 1};
+    if (round_size > 0)
+    {
+      num_rounds = std::max<std::int64_t>(
+          1, (recv_buffer_r[3] + round_size - 1) / round_size);
+    }
 
-    spdlog::debug("Max. vertices per facet={}", fshape1);
+    DOLFINX_LOG_DEBUG("Max. vertices per facet={}", fshape1);
   }
-  const std::int32_t buffer_shape1 = fshape1 + 1;
 
-  // Build list of dest ranks and count number of items (facets) to send
-  // to each dest post office (by neighbourhood rank)
-  std::vector<int> dest;
-  std::vector<std::int32_t> num_items_per_dest, pos_to_neigh_rank(shape0, -1);
+  // Compute the key of each facet
+  std::vector<std::int64_t> keys(2 * shape0);
+  for (std::size_t i = 0; i < shape0; ++i)
   {
-    // Build {dest, pos} list for each facet, and sort (dest is the post
-    // office rank)
+    std::span f = facets.subspan(i * shape1, shape1);
+    keys[2 * i] = f[0];
+    if (fshape1 == 1)
+      keys[2 * i + 1] = 0;
+    else if (fshape1 == 2)
+      keys[2 * i + 1] = f[1];
+    else
+      keys[2 * i + 1] = facet_hash(f.subspan(1));
+  }
+
+  // Wait for the MPI_Iexscan to complete (before using cell_offset)
+  MPI_Wait(&request_cell_offset, MPI_STATUS_IGNORE);
+
+  // Global index of the cell across each facet, or -1 if the facet is
+  // not shared
+  std::vector<std::int64_t> remote_cells(shape0, -1);
+
+  // Exchange the facets in rounds. The round of a facet is determined
+  // by its first vertex, so matching facets are exchanged in the same
+  // round.
+  constexpr int buffer_shape1 = 3;
+  std::size_t bytes_sent = 0, bytes_received = 0;
+  const std::int64_t range = vrange[1] - vrange[0];
+  for (int round = 0; round < num_rounds; ++round)
+  {
+    // Build {dest, pos} list for each facet in this round, and sort
+    // (dest is the post office rank)
     std::vector<std::array<std::int32_t, 2>> dest_to_index;
-    dest_to_index.reserve(shape0);
-    std::int64_t range = vrange[1] - vrange[0];
     for (std::size_t i = 0; i < shape0; ++i)
     {
-      std::int64_t v0 = facets[i * shape1] - vrange[0];
-      dest_to_index.push_back({dolfinx::MPI::index_owner(num_ranks, v0, range),
-                               static_cast<int>(i)});
+      std::int64_t v0 = keys[2 * i];
+      if (num_rounds > 1 and int(mix(v0) % num_rounds) != round)
+        continue;
+      dest_to_index.push_back(
+          {dolfinx::MPI::index_owner(num_ranks, v0 - vrange[0], range),
+           static_cast<int>(i)});
     }
     std::ranges::sort(dest_to_index);
 
     // Build list of dest ranks and count number of items (facets) to
     // send to each dest post office (by neighbourhood rank)
+    std::vector<int> dest;
+    std::vector<std::int32_t> num_items_per_dest;
     {
       auto it = dest_to_index.begin();
       while (it != dest_to_index.end())
       {
-        const int neigh_rank = dest.size();
-
         // Store global rank
         dest.push_back((*it)[0]);
 
@@ -148,154 +214,140 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
         // Store number of items for current rank
         num_items_per_dest.push_back(std::distance(it, it1));
 
-        // Set entry in map from local facet row index (position) to local
-        // destination rank
-        for (auto e = it; e != it1; ++e)
-          pos_to_neigh_rank[(*e)[1]] = neigh_rank;
-
         // Advance iterator
         it = it1;
       }
     }
-  }
-
-  // Determine source ranks
-  const std::vector<int> src
-      = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
-  spdlog::info("Number of destination and source ranks in non-local dual graph "
-               "construction, and ratio to total number of ranks: {}, {}, "
-               "{}, {}",
-               dest.size(), src.size(),
-               static_cast<double>(dest.size()) / num_ranks,
-               static_cast<double>(src.size()) / num_ranks);
-
-  // Create neighbourhood communicator for sending data to
-  // post offices
-  MPI_Comm neigh_comm0;
-  MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(), MPI_UNWEIGHTED,
-                                 dest.size(), dest.data(), MPI_UNWEIGHTED,
-                                 MPI_INFO_NULL, false, &neigh_comm0);
-
-  // Compute send displacements
-  std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
-  std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
-                   std::next(send_disp.begin()));
 
-  // Wait for the MPI_Iexscan to complete (before using cell_offset)
-  MPI_Wait(&request_cell_offset, MPI_STATUS_IGNORE);
-
-  // Pack send buffer
-  std::vector<std::int32_t> send_indx_to_pos(send_disp.back());
-  std::vector<std::int64_t> send_buffer(buffer_shape1 * send_disp.back(), -1);
-  {
-    std::vector<std::int32_t> send_offsets = send_disp;
-    for (std::size_t i = 0; i < shape0; ++i)
+    // Determine source ranks
+    const std::vector<int> src
+        = dolfinx::MPI::compute_graph_edges_nbx(comm, dest);
+    DOLFINX_LOG_INFO(
+        "Number of destination and source ranks in non-local dual graph "
+        "construction, and ratio to total number of ranks: {}, {}, "
+        "{}, {}",
+        dest.size(), src.size(), static_cast<double>(dest.size()) / num_ranks,
+        static_cast<double>(src.size()) / num_ranks);
+
+    // Create neighbourhood communicator for sending data to
+    // post offices
+    MPI_Comm neigh_comm0;
+    MPI_Dist_graph_create_adjacent(comm, src.size(), src.data(),
+                                   MPI_UNWEIGHTED, dest.size(), dest.data(),
+                                   MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                   &neigh_comm0);
+
+    // Compute send displacements
+    std::vector<std::int32_t> send_disp(num_items_per_dest.size() + 1, 0);
+    std::partial_sum(num_items_per_dest.begin(), num_items_per_dest.end(),
+                     std::next(send_disp.begin()));
+
+    // Pack send buffer (facets are sorted by destination)
+    std::vector<std::int64_t> send_buffer(buffer_shape1 * send_disp.back());
+    for (std::size_t pos = 0; pos < dest_to_index.size(); ++pos)
     {
-      int neigh_dest = pos_to_neigh_rank[i];
-      std::size_t pos = send_offsets[neigh_dest];
-      send_indx_to_pos[pos] = i;
-
-      // Copy facet data into buffer
-      std::copy_n(std::next(facets.begin(), i * shape1), shape1,
-                  std::next(send_buffer.begin(), buffer_shape1 * pos));
-      send_buffer[buffer_shape1 * pos + fshape1] = cells[i] + cell_offset;
-      ++send_offsets[neigh_dest];
+      std::int32_t i = dest_to_index[pos][1];
+      send_buffer[buffer_shape1 * pos] = keys[2 * i];
+      send_buffer[buffer_shape1 * pos + 1] = keys[2 * i + 1];
+      send_buffer[buffer_shape1 * pos + 2] = cells[i] + cell_offset;
     }
-  }
 
-  // Send number of send items to post offices
-  std::vector<int> num_items_recv(src.size());
-  num_items_per_dest.reserve(1);
-  num_items_recv.reserve(1);
-  MPI_Neighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
-                        num_items_recv.data(), 1, MPI_INT, neigh_comm0);
-
-  // Prepare receive displacement and buffers
-  std::vector<std::int32_t> recv_disp(num_items_recv.size() + 1, 0);
-  std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
-                   std::next(recv_disp.begin()));
-
-  // Send/receive data facet
-  MPI_Datatype compound_type;
-  MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
-  MPI_Type_commit(&compound_type);
-  std::vector<std::int64_t> recv_buffer(buffer_shape1 * recv_disp.back());
-  MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
-                         send_disp.data(), compound_type, recv_buffer.data(),
-                         num_items_recv.data(), recv_disp.data(), compound_type,
-                         neigh_comm0);
-
-  MPI_Type_free(&compound_type);
-  MPI_Comm_free(&neigh_comm0);
-
-  // Search for consecutive facets (-> dual graph edge between cells)
-  // and pack into send buffer
-  std::vector<std::int64_t> send_buffer1(recv_disp.back(), -1);
-  {
-    // Compute sort permutation for received data
-    std::vector<int> sort_order(recv_buffer.size() / buffer_shape1);
-    std::iota(sort_order.begin(), sort_order.end(), 0);
-    std::ranges::sort(
-        sort_order,
-        [&recv_buffer, buffer_shape1, fshape1](auto f0, auto f1)
-        {
-          auto it0 = std::next(recv_buffer.begin(), f0 * buffer_shape1);
-          auto it1 = std::next(recv_buffer.begin(), f1 * buffer_shape1);
-          return std::lexicographical_compare(it0, std::next(it0, fshape1), it1,
-                                              std::next(it1, fshape1));
-        });
-
-    auto it = sort_order.begin();
-    while (it != sort_order.end())
+    // Send number of send items to post offices
+    std::vector<int> num_items_recv(src.size());
+    num_items_per_dest.reserve(1);
+    num_items_recv.reserve(1);
+    MPI_Neighbor_alltoall(num_items_per_dest.data(), 1, MPI_INT,
+                          num_items_recv.data(), 1, MPI_INT, neigh_comm0);
+
+    // Prepare receive displacement and buffers
+    std::vector<std::int32_t> recv_disp(num_items_recv.size() + 1, 0);
+    std::partial_sum(num_items_recv.begin(), num_items_recv.end(),
+                     std::next(recv_disp.begin()));
+
+    // Send/receive data facet
+    MPI_Datatype compound_type;
+    MPI_Type_contiguous(buffer_shape1, MPI_INT64_T, &compound_type);
+    MPI_Type_commit(&compound_type);
+    std::vector<std::int64_t> recv_buffer(buffer_shape1 * recv_disp.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), num_items_per_dest.data(),
+                           send_disp.data(), compound_type, recv_buffer.data(),
+                           num_items_recv.data(), recv_disp.data(),
+                           compound_type, neigh_comm0);
+
+    MPI_Type_free(&compound_type);
+    MPI_Comm_free(&neigh_comm0);
+
+    // Search for consecutive facets (-> dual graph edge between cells)
+    // and pack into send buffer
+    std::vector<std::int64_t> send_buffer1(recv_disp.back(), -1);
     {
-      std::size_t offset0 = (*it) * buffer_shape1;
-      auto f0 = std::next(recv_buffer.data(), offset0);
-
-      // Find iterator to next facet different from f0
-      auto it1 = std::find_if_not(
-          it, sort_order.end(),
-          [f0, &recv_buffer, buffer_shape1, fshape1](auto idx) -> bool
-          {
-            std::size_t offset1 = idx * buffer_shape1;
-            auto f1 = std::next(recv_buffer.data(), offset1);
-            return std::equal(f0, std::next(f0, fshape1), f1);
-          });
-
-      std::size_t num_matches = std::distance(it, it1);
-      if (num_matches > 2)
+      // Compute sort permutation for received data
+      std::vector<int> sort_order(recv_disp.back());
+      std::iota(sort_order.begin(), sort_order.end(), 0);
+      auto key = [&recv_buffer](auto f)
       {
-        throw std::runtime_error(
-            "A facet is connected to more than two cells.");
-      }
+        return std::pair(recv_buffer[f * buffer_shape1],
+                         recv_buffer[f * buffer_shape1 + 1]);
+      };
+      std::ranges::sort(sort_order, std::less{}, key);
 
-      // TODO: generalise for more than matches and log warning (maybe
-      // with an option?). Would need to send back multiple values.
-      if (num_matches == 2)
+      auto it = sort_order.begin();
+      while (it != sort_order.end())
       {
-        // Store the global cell index from the other rank
-        send_buffer1[*it] = recv_buffer[*(it + 1) * buffer_shape1 + fshape1];
-        send_buffer1[*(it + 1)] = recv_buffer[*it * buffer_shape1 + fshape1];
-      }
+        // Find iterator to next facet different from f0
+        auto it1 = std::find_if_not(it, sort_order.end(),
+                                    [k0 = key(*it), &key](auto idx) -> bool
+                                    { return key(idx) == k0; });
 
-      // Advance iterator and increment entity
-      it = it1;
+        std::size_t num_matches = std::distance(it, it1);
+        if (num_matches > 2)
+        {
+          throw std::runtime_error(
+              "A facet is connected to more than two cells.");
+        }
+
+        // TODO: generalise for more than matches and log warning (maybe
+        // with an option?). Would need to send back multiple values.
+        if (num_matches == 2)
+        {
+          // Store the global cell index from the other rank
+          send_buffer1[*it] = recv_buffer[*(it + 1) * buffer_shape1 + 2];
+          send_buffer1[*(it + 1)] = recv_buffer[*it * buffer_shape1 + 2];
+        }
+
+        // Advance iterator and increment entity
+        it = it1;
+      }
     }
+
+    // Create neighbourhood communicator for sending data from post
+    // offices
+    MPI_Comm neigh_comm1;
+    MPI_Dist_graph_create_adjacent(comm, dest.size(), dest.data(),
+                                   MPI_UNWEIGHTED, src.size(), src.data(),
+                                   MPI_UNWEIGHTED, MPI_INFO_NULL, false,
+                                   &neigh_comm1);
+
+    // Send back data
+    std::vector<std::int64_t> recv_buffer1(send_disp.back());
+    MPI_Neighbor_alltoallv(send_buffer1.data(), num_items_recv.data(),
+                           recv_disp.data(), MPI_INT64_T, recv_buffer1.data(),
+                           num_items_per_dest.data(), send_disp.data(),
+                           MPI_INT64_T, neigh_comm1);
+    MPI_Comm_free(&neigh_comm1);
+
+    for (std::size_t pos = 0; pos < dest_to_index.size(); ++pos)
+      remote_cells[dest_to_index[pos][1]] = recv_buffer1[pos];
+
+    bytes_sent += sizeof(std::int64_t)
+                  * (send_buffer.size() + send_buffer1.size());
+    bytes_received += sizeof(std::int64_t)
+                      * (recv_buffer.size() + recv_buffer1.size());
   }
 
-  // Create neighbourhood communicator for sending data from post
-  // offices
-  MPI_Comm neigh_comm1;
-  MPI_Dist_graph_create_adjacent(comm, dest.size(), dest.data(), MPI_UNWEIGHTED,
-                                 src.size(), src.data(), MPI_UNWEIGHTED,
-                                 MPI_INFO_NULL, false, &neigh_comm1);
-
-  // Send back data
-  std::vector<std::int64_t> recv_buffer1(send_disp.back());
-  MPI_Neighbor_alltoallv(send_buffer1.data(), num_items_recv.data(),
-                         recv_disp.data(), MPI_INT64_T, recv_buffer1.data(),
-                         num_items_per_dest.data(), send_disp.data(),
-                         MPI_INT64_T, neigh_comm1);
-  MPI_Comm_free(&neigh_comm1);
+  DOLFINX_LOG_INFO("Non-local dual graph exchange (rounds, bytes sent, bytes "
+                   "received): {}, {}, {}",
+                   num_rounds, bytes_sent, bytes_received);
 
   // --- Build new graph
 
@@ -303,14 +355,10 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
   std::vector<std::int32_t> num_edges(local_graph.num_nodes(), 0);
   std::adjacent_difference(std::next(local_graph.offsets().begin()),
                            local_graph.offsets().end(), num_edges.begin());
-  for (std::size_t i = 0; i < recv_buffer1.size(); ++i)
+  for (std::size_t i = 0; i < shape0; ++i)
   {
-    if (recv_buffer1[i] >= 0)
-    {
-      std::size_t pos = send_indx_to_pos[i];
-      std::size_t cell = cells[pos];
-      num_edges[cell] += 1;
-    }
+    if (remote_cells[i] >= 0)
+      num_edges[cells[i]] += 1;
   }
 
   // Compute adjacency list offsets
@@ -333,14 +381,10 @@ graph::AdjacencyList<std::int64_t> compute_nonlocal_dual_graph(
     }
 
     // Add non-local data
-    for (std::size_t i = 0; i < recv_buffer1.size(); ++i)
+    for (std::size_t i = 0; i < shape0; ++i)
     {
-      if (recv_buffer1[i] >= 0)
-      {
-        std::size_t pos = send_indx_to_pos[i];
-        std::size_t cell = cells[pos];
-        data[disp[cell]++] = recv_buffer1[i];
-      }
+      if (remote_cells[i] >= 0)
+        data[disp[cells[i]]++] = remote_cells[i];
     }
   }
 
@@ -353,9 +397,9 @@ std::tuple<graph::AdjacencyList<std::int32_t>, std::vector<std::int64_t>,
            std::size_t, std::vector<std::int32_t>>
 mesh::build_local_dual_graph(
     std::span<const CellType> celltypes,
-    const std::vector<std::span<const std::int64_t>>& cells)
+    const std::vector<std::span<const std::int64_t>>& cells, int num_threads)
 {
-  spdlog::info("Build local part of mesh dual graph (mixed)");
+  DOLFINX_LOG_INFO("Build local part of mesh dual graph (mixed)");
   common::Timer timer("Compute local part of mesh dual graph (mixed)");
 
   std::size_t ncells_local
@@ -431,17 +475,37 @@ mesh::build_local_dual_graph(
     }
   }
 
-  // Sort facets by vertex key
-  std::vector<std::size_t> perm(facets.size() / shape1, 0);
+  // Sort facets by a hash of the vertices, and then sort facets with
+  // the same hash by vertex key so that equal facets are consecutive
+  const std::size_t num_facets = facets.size() / shape1;
+  std::vector<std::uint64_t> hash(num_facets);
+  for (std::size_t f = 0; f < num_facets; ++f)
+  {
+    hash[f] = facet_hash(
+        std::span(facets.data() + f * shape1, max_vertices_per_facet));
+  }
+  std::vector<std::int32_t> perm(num_facets);
   std::iota(perm.begin(), perm.end(), 0);
-  std::sort(perm.begin(), perm.end(),
-            [&facets, shape1](auto f0, auto f1)
-            {
-              auto it0 = std::next(facets.begin(), f0 * shape1);
-              auto it1 = std::next(facets.begin(), f1 * shape1);
-              return std::lexicographical_compare(it0, std::next(it0, shape1),
-                                                  it1, std::next(it1, shape1));
-            });
+  dolfinx::radix_sort(perm, [&hash](auto f) { return hash[f]; },
+                      num_threads);
+  for (auto it = perm.begin(); it != perm.end();)
+  {
+    auto it1 = std::find_if(it, perm.end(), [h = hash[*it], &hash](auto f)
+                            { return hash[f] != h; });
+    if (std::distance(it, it1) > 1)
+    {
+      std::sort(it, it1,
+                [&facets, shape1](auto f0, auto f1)
+                {
+                  auto it0 = std::next(facets.begin(), f0 * shape1);
+                  auto it1 = std::next(facets.begin(), f1 * shape1);
+                  return std::lexicographical_compare(
+                      it0, std::next(it0, shape1), it1,
+                      std::next(it1, shape1));
+                });
+    }
+    it = it1;
+  }
 
   // Iterate over sorted list of facets. Facets shared by more than one
   // cell lead to a graph edge to be added. Facets that are not shared
@@ -515,22 +579,23 @@ mesh::build_local_dual_graph(
 //-----------------------------------------------------------------------------
 graph::AdjacencyList<std::int64_t>
 mesh::build_dual_graph(MPI_Comm comm, std::span<const CellType> celltypes,
-                       const std::vector<std::span<const std::int64_t>>& cells)
+                       const std::vector<std::span<const std::int64_t>>& cells,
+                       int num_threads, std::size_t round_size)
 {
-  spdlog::info("Building mesh dual graph");
+  DOLFINX_LOG_INFO("Building mesh dual graph");
 
   // Compute local part of dual graph (cells are graph nodes, and edges
   // are connections by facet)
   auto [local_graph, facets, shape1, fcells]
-      = mesh::build_local_dual_graph(celltypes, cells);
+      = mesh::build_local_dual_graph(celltypes, cells, num_threads);
 
   // Extend with nonlocal edges and convert to global indices
-  graph::AdjacencyList graph
-      = compute_nonlocal_dual_graph(comm, facets, shape1, fcells, local_graph);
+  graph::AdjacencyList graph = compute_nonlocal_dual_graph(
+      comm, facets, shape1, fcells, local_graph, round_size);
 
-  spdlog::info("Graph edges (local: {}, non-local: {})",
-               local_graph.offsets().back(),
-               graph.offsets().back() - local_graph.offsets().back());
+  DOLFINX_LOG_INFO("Graph edges (local: {}, non-local: {})",
+                   local_graph.offsets().back(),
+                   graph.offsets().back() - local_graph.offsets().back());
 
   return graph;
 }
@@ -7,17 +7,12 @@
 #pragma once
 
 #include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <mpi.h>
 #include <span>
 #include <tuple>
 #include <vector>
 
-namespace dolfinx::graph
-{
-template <typename T>
-class AdjacencyList;
-}
-
 namespace dolfinx::mesh
 {
 enum class CellType;
@@ -28,6 +23,7 @@ enum class CellType;
 /// @param[in] celltypes List of cell types.
 /// @param[in] cells Lists of cell vertices (stored as flattened lists, one for
 /// each cell type).
+/// @param[in] num_threads Number of threads used to sort the facets.
 /// @return
 /// 1. Local dual graph
 /// 2. Facets, defined by their vertices, that are shared by only one
@@ -46,7 +42,8 @@ enum class CellType;
 std::tuple<graph::AdjacencyList<std::int32_t>, std::vector<std::int64_t>,
            std::size_t, std::vector<std::int32_t>>
 build_local_dual_graph(std::span<const CellType> celltypes,
-                       const std::vector<std::span<const std::int64_t>>& cells);
+                       const std::vector<std::span<const std::int64_t>>& cells,
+                       int num_threads = 1);
 
 /// @brief Build distributed mesh dual graph (cell-cell connections via
 /// facets) from minimal mesh data.
@@ -60,10 +57,17 @@ build_local_dual_graph(std::span<const CellType> celltypes,
 /// @param[in] cells Collections of cells, defined by the cell vertices
 /// from which to build the dual graph, as flattened arrays for each cell type
 /// in `celltypes`.
+/// @param[in] num_threads Number of threads used to sort the local
+/// facets.
+/// @param[in] round_size Maximum number of facets (approximately) that
+/// a rank sends to other ranks in one round of communication. Sending
+/// the facets in several rounds reduces the peak memory use. If zero,
+/// all facets are sent in one round.
 /// @note `cells` and `celltypes` must have the same size.
 /// @return The dual graph
 graph::AdjacencyList<std::int64_t>
 build_dual_graph(MPI_Comm comm, std::span<const CellType> celltypes,
-                 const std::vector<std::span<const std::int64_t>>& cells);
+                 const std::vector<std::span<const std::int64_t>>& cells,
+                 int num_threads = 1, std::size_t round_size = 0);
 
 } // namespace dolfinx::mesh
@@ -8,24 +8,23 @@
 #include "Topology.h"
 #include "cell_types.h"
 #include <algorithm>
-#include <bitset>
+#include <array>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
-
-namespace
-{
-constexpr int _BITSETSIZE = 32;
-} // namespace
+#include <numeric>
+#include <span>
 
 using namespace dolfinx;
 
 namespace
 {
 std::pair<std::int8_t, std::int8_t>
-compute_triangle_rot_reflect(const std::vector<std::int32_t>& e_vertices,
-                             const std::vector<std::int64_t>& vertices)
+compute_triangle_rot_reflect(std::span<const std::int32_t> e_vertices,
+                             std::span<const std::int64_t> vertices)
 {
 
   // Number of rotations
@@ -45,11 +44,11 @@ compute_triangle_rot_reflect(const std::vector<std::int32_t>& e_vertices,
 
   // g_pre is the (global) number of the next vertex clockwise from the lowest
   // numbered vertex
-  const int g_pre = vertices[(g_min_v + 2) % 3];
+  const std::int64_t g_pre = vertices[(g_min_v + 2) % 3];
 
   // g_post is the (global) number of the next vertex anticlockwise from the
   // lowest numbered vertex
-  const int g_post = vertices[(g_min_v + 1) % 3];
+  const std::int64_t g_post = vertices[(g_min_v + 1) % 3];
 
   std::uint8_t rots = 0;
   if (g_post > g_pre)
@@ -61,8 +60,8 @@ compute_triangle_rot_reflect(const std::vector<std::int32_t>& e_vertices,
 }
 //-----------------------------------------------------------------------------
 std::pair<std::int8_t, std::int8_t>
-compute_quad_rot_reflect(const std::vector<std::int32_t>& e_vertices,
-                         const std::vector<std::int64_t>& vertices)
+compute_quad_rot_reflect(std::span<const std::int32_t> e_vertices,
+                         std::span<const std::int64_t> vertices)
 {
   // Find minimum local cell vertex on facet
   std::uint8_t min_v
@@ -118,225 +117,149 @@ compute_quad_rot_reflect(const std::vector<std::int32_t>& e_vertices,
   return {(post > pre) == (g_post < g_pre), rots};
 }
 //-----------------------------------------------------------------------------
-template <int BITSETSIZE>
-std::vector<std::bitset<BITSETSIZE>>
-compute_triangle_quad_face_permutations(const mesh::Topology& topology,
-                                        int cell_index)
+
+// Local vertices of the sub-entities of a cell type, used to compute
+// the permutations of each cell without looking up the entities
+struct CellEntityTables
 {
-  std::vector<mesh::CellType> cell_types = topology.entity_types(3);
-  mesh::CellType cell_type = cell_types.at(cell_index);
-
-  // Get face types of the cell and mesh
-  std::vector<mesh::CellType> mesh_face_types = topology.entity_types(2);
-  std::vector<mesh::CellType> cell_face_types(
-      mesh::cell_num_entities(cell_type, 2));
-  for (std::size_t i = 0; i < cell_face_types.size(); ++i)
-    cell_face_types[i] = mesh::cell_facet_type(cell_type, i);
-
-  // Connectivity for each face type
-  std::vector<std::shared_ptr<const graph::AdjacencyList<std::int32_t>>> c_to_f;
-  std::vector<std::shared_ptr<const graph::AdjacencyList<std::int32_t>>> f_to_v;
-
-  // Create mapping for each face type to cell-local face index
-  int tdim = topology.dim();
-  std::vector<std::vector<int>> face_type_indices(mesh_face_types.size());
-  for (std::size_t i = 0; i < mesh_face_types.size(); ++i)
+  // Cell-local vertices of each edge, lowest first
+  std::vector<std::array<std::int32_t, 2>> edges;
+
+  // Cell-local vertices of each face, in reference order, and the
+  // number of vertices of each face (3 or 4)
+  std::vector<std::array<std::int32_t, 4>> faces;
+  std::vector<int> face_size;
+};
+//-----------------------------------------------------------------------------
+CellEntityTables create_tables(mesh::CellType cell_type)
+{
+  CellEntityTables tables;
+  const int tdim = mesh::cell_dim(cell_type);
+  if (tdim > 1)
   {
-    for (std::size_t j = 0; j < cell_face_types.size(); ++j)
+    graph::AdjacencyList<int> edges = mesh::get_entity_vertices(cell_type, 1);
+    for (int e = 0; e < edges.num_nodes(); ++e)
     {
-      if (mesh_face_types[i] == cell_face_types[j])
-        face_type_indices[i].push_back(j);
+      auto v = edges.links(e);
+      tables.edges.push_back({std::min(v[0], v[1]), std::max(v[0], v[1])});
     }
-    c_to_f.push_back(topology.connectivity({tdim, cell_index}, {2, i}));
-    f_to_v.push_back(topology.connectivity({2, i}, {0, 0}));
   }
 
-  auto c_to_v = topology.connectivity({tdim, cell_index}, {0, 0});
-  assert(c_to_v);
-
-  const std::int32_t num_cells = c_to_v->num_nodes();
-  std::vector<std::bitset<BITSETSIZE>> face_perm(num_cells, 0);
-  std::vector<std::int64_t> cell_vertices, vertices;
-  std::vector<std::int32_t> e_vertices;
-  auto im = topology.index_map(0);
-
-  for (std::size_t t = 0; t < face_type_indices.size(); ++t)
+  if (tdim > 2)
   {
-    spdlog::info("Computing permutations for face type {}", t);
-    if (!face_type_indices[t].empty())
+    graph::AdjacencyList<int> faces = mesh::get_entity_vertices(cell_type, 2);
+    for (int f = 0; f < faces.num_nodes(); ++f)
     {
-      auto compute_refl_rots = (mesh_face_types[t] == mesh::CellType::triangle)
-                                   ? compute_triangle_rot_reflect
-                                   : compute_quad_rot_reflect;
-      for (int c = 0; c < num_cells; ++c)
-      {
-        cell_vertices.resize(c_to_v->links(c).size());
-        im->local_to_global(c_to_v->links(c), cell_vertices);
-
-        auto cell_faces = c_to_f[t]->links(c);
-        for (std::size_t i = 0; i < cell_faces.size(); ++i)
-        {
-          // Get the face
-          const int face = cell_faces[i];
-          e_vertices.resize(f_to_v[t]->num_links(face));
-          vertices.resize(f_to_v[t]->num_links(face));
-          im->local_to_global(f_to_v[t]->links(face), vertices);
-
-          // Orient that triangle or quadrilateral so the lowest numbered
-          // vertex is the origin, and the next vertex anticlockwise from
-          // the lowest has a lower number than the next vertex clockwise.
-          // Find the index of the lowest numbered vertex.
-
-          // Find iterators pointing to cell vertex given a vertex on facet
-          for (std::size_t j = 0; j < vertices.size(); ++j)
-          {
-            auto it = std::find(cell_vertices.begin(), cell_vertices.end(),
-                                vertices[j]);
-            // Get the actual local vertex indices
-            e_vertices[j] = std::distance(cell_vertices.begin(), it);
-          }
-
-          // Compute reflections and rotations for this face type
-          auto [refl, rots] = compute_refl_rots(e_vertices, vertices);
-
-          // Store bits for this face
-          int fi = face_type_indices[t][i];
-          face_perm[c][3 * fi] = refl;
-          face_perm[c][3 * fi + 1] = rots % 2;
-          face_perm[c][3 * fi + 2] = rots / 2;
-        }
-      }
+      auto v = faces.links(f);
+      std::array<std::int32_t, 4> fv{};
+      std::ranges::copy(v, fv.begin());
+      tables.faces.push_back(fv);
+      tables.face_size.push_back(v.size());
     }
   }
 
-  return face_perm;
+  return tables;
 }
 //-----------------------------------------------------------------------------
-template <int BITSETSIZE>
-std::vector<std::bitset<BITSETSIZE>>
-compute_edge_reflections(const mesh::Topology& topology)
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::pair<std::vector<std::uint8_t>, std::vector<std::uint32_t>>
+mesh::compute_entity_permutations(const mesh::Topology& topology,
+                                  int num_threads)
 {
-  mesh::CellType cell_type = topology.cell_type();
+  common::Timer t_perm("Compute entity permutations");
   const int tdim = topology.dim();
-  const int edges_per_cell = cell_num_entities(cell_type, 1);
-
-  const std::int32_t num_cells = topology.connectivity(tdim, 0)->num_nodes();
+  CellType cell_type = topology.cell_type();
+  if (tdim > 2 and topology.entity_types(3).size() > 1)
+  {
+    throw std::runtime_error(
+        "Cannot compute permutations for mixed topology mesh.");
+  }
+  if (tdim > 2 and !topology.index_map(2))
+    throw std::runtime_error("Faces have not been computed.");
 
   auto c_to_v = topology.connectivity(tdim, 0);
   assert(c_to_v);
-  auto c_to_e = topology.connectivity(tdim, 1);
-  assert(c_to_e);
-  auto e_to_v = topology.connectivity(1, 0);
-  assert(e_to_v);
+  const std::int32_t num_cells = c_to_v->num_nodes();
+  const int facets_per_cell = cell_num_entities(cell_type, tdim - 1);
 
+  // Reflections and rotations depend only on the global indices of the
+  // cell vertices and the cell-local vertices of each sub-entity
+  const CellEntityTables tables = create_tables(cell_type);
   auto im = topology.index_map(0);
   assert(im);
-
-  std::vector<std::bitset<BITSETSIZE>> edge_perm(num_cells, 0);
-  std::vector<std::int64_t> cell_vertices, vertices;
-  for (int c = 0; c < c_to_v->num_nodes(); ++c)
-  {
-    cell_vertices.resize(c_to_v->num_links(c));
-    im->local_to_global(c_to_v->links(c), cell_vertices);
-    auto cell_edges = c_to_e->links(c);
-    for (int i = 0; i < edges_per_cell; ++i)
-    {
-      vertices.resize(e_to_v->links(cell_edges[i]).size());
-      im->local_to_global(e_to_v->links(cell_edges[i]), vertices);
-
-      // If the entity is an interval, it should be oriented pointing
-      // from the lowest numbered vertex to the highest numbered vertex.
-
-      // Find iterators pointing to cell vertex given a vertex on facet
-      auto it0
-          = std::find(cell_vertices.begin(), cell_vertices.end(), vertices[0]);
-      auto it1
-          = std::find(cell_vertices.begin(), cell_vertices.end(), vertices[1]);
-
-      // The number of reflections. Comparing iterators directly instead
-      // of values they point to is sufficient here.
-      edge_perm[c][i] = (it1 < it0) == (vertices[1] > vertices[0]);
-    }
-  }
-
-  return edge_perm;
-}
-//-----------------------------------------------------------------------------
-template <int BITSETSIZE>
-std::vector<std::bitset<BITSETSIZE>>
-compute_face_permutations(const mesh::Topology& topology)
-{
-  if (topology.entity_types(3).size() > 1)
+  std::vector<std::int64_t> global_vertices(im->size_local()
+                                            + im->num_ghosts());
   {
-    throw std::runtime_error(
-        "Cannot compute permutations for mixed topology mesh.");
+    std::vector<std::int32_t> local(global_vertices.size());
+    std::iota(local.begin(), local.end(), 0);
+    im->local_to_global(local, global_vertices);
   }
 
-  [[maybe_unused]] const int tdim = topology.dim();
-  assert(tdim > 2);
-  if (!topology.index_map(2))
-    throw std::runtime_error("Faces have not been computed.");
-
-  // Compute face permutations for first cell type in the topology
-  return compute_triangle_quad_face_permutations<BITSETSIZE>(topology, 0);
-}
-//-----------------------------------------------------------------------------
-} // namespace
-
-//-----------------------------------------------------------------------------
-std::pair<std::vector<std::uint8_t>, std::vector<std::uint32_t>>
-mesh::compute_entity_permutations(const mesh::Topology& topology)
-{
-  common::Timer t_perm("Compute entity permutations");
-  const int tdim = topology.dim();
-  CellType cell_type = topology.cell_type();
-  const std::int32_t num_cells = topology.connectivity(tdim, 0)->num_nodes();
-  const int facets_per_cell = cell_num_entities(cell_type, tdim - 1);
+  // Currently, 3 bits are used for each face. If faces with more than
+  // 4 sides are implemented, this will need to be increased.
+  const int num_faces = tables.faces.size();
+  const int num_edges = tables.edges.size();
+  assert(3 * num_faces + num_edges < 32);
 
   std::vector<std::uint32_t> cell_permutation_info(num_cells, 0);
   std::vector<std::uint8_t> facet_permutations(num_cells * facets_per_cell);
-  std::int32_t used_bits = 0;
-  if (tdim > 2)
+  auto compute = [&](std::int32_t c0, std::int32_t c1)
   {
-    spdlog::info("Compute face permutations");
-    const int faces_per_cell = cell_num_entities(cell_type, 2);
-    const auto face_perm = compute_face_permutations<_BITSETSIZE>(topology);
-    for (int c = 0; c < num_cells; ++c)
-      cell_permutation_info[c] = face_perm[c].to_ulong();
-
-    // Currently, 3 bits are used for each face. If faces with more than
-    // 4 sides are implemented, this will need to be increased.
-    used_bits += faces_per_cell * 3;
-    assert(tdim == 3);
-    for (int c = 0; c < num_cells; ++c)
+    std::array<std::int64_t, 8> cell_vertices;
+    std::array<std::int64_t, 4> vertices;
+    for (std::int32_t c = c0; c < c1; ++c)
     {
-      for (int i = 0; i < facets_per_cell; ++i)
+      auto cv = c_to_v->links(c);
+      assert(cv.size() <= cell_vertices.size());
+      for (std::size_t i = 0; i < cv.size(); ++i)
+        cell_vertices[i] = global_vertices[cv[i]];
+
+      std::uint32_t info = 0;
+      for (int i = 0; i < num_faces; ++i)
       {
-        facet_permutations[c * facets_per_cell + i]
-            = (cell_permutation_info[c] >> (3 * i)) & 7;
+        // Orient the triangle or quadrilateral so the lowest numbered
+        // vertex is the origin, and the next vertex anticlockwise from
+        // the lowest has a lower number than the next vertex clockwise
+        const int n = tables.face_size[i];
+        std::span<const std::int32_t> e_vertices(tables.faces[i].data(), n);
+        for (int j = 0; j < n; ++j)
+          vertices[j] = cell_vertices[e_vertices[j]];
+        auto [refl, rots]
+            = n == 3 ? compute_triangle_rot_reflect(
+                           e_vertices, std::span(vertices.data(), 3))
+                     : compute_quad_rot_reflect(e_vertices,
+                                                std::span(vertices.data(), 4));
+        info |= std::uint32_t(refl | ((rots % 2) << 1) | ((rots / 2) << 2))
+                << (3 * i);
       }
-    }
-  }
 
-  if (tdim > 1)
-  {
-    spdlog::info("Compute edge permutations");
-    const int edges_per_cell = cell_num_entities(cell_type, 1);
-    const auto edge_perm = compute_edge_reflections<_BITSETSIZE>(topology);
-    for (int c = 0; c < num_cells; ++c)
-      cell_permutation_info[c] |= edge_perm[c].to_ulong() << used_bits;
-
-    used_bits += edges_per_cell;
-    if (tdim == 2)
-    {
-      for (int c = 0; c < num_cells; ++c)
+      // An edge is reflected if it points from the higher numbered to
+      // the lower numbered vertex
+      for (int i = 0; i < num_edges; ++i)
+      {
+        auto [v0, v1] = tables.edges[i];
+        if (cell_vertices[v0] > cell_vertices[v1])
+          info |= std::uint32_t(1) << (3 * num_faces + i);
+      }
+      cell_permutation_info[c] = info;
+
+      if (tdim == 3)
       {
         for (int i = 0; i < facets_per_cell; ++i)
-          facet_permutations[c * facets_per_cell + i] = edge_perm[c][i];
+          facet_permutations[c * facets_per_cell + i] = (info >> (3 * i)) & 7;
+      }
+      else if (tdim == 2)
+      {
+        for (int i = 0; i < facets_per_cell; ++i)
+          facet_permutations[c * facets_per_cell + i] = (info >> i) & 1;
       }
     }
-  }
-  assert(used_bits < _BITSETSIZE);
+  };
+
+  DOLFINX_LOG_INFO("Compute entity permutations");
+  common::parallel_for(num_cells, num_threads, compute);
 
   return {std::move(facet_permutations), std::move(cell_permutation_info)};
 }
@@ -66,8 +66,15 @@ class Topology;
 ///    This data is used to correct the direction of vector function
 ///    on permuted facets.
 ///
+/// The permutations are computed in one pass over the cells from the
+/// global indices of the cell vertices and the cell-local vertices of
+/// each sub-entity of the reference cell.
+///
+/// @param[in] topology The mesh topology. The faces must have been
+/// computed for 3D cells.
+/// @param[in] num_threads Number of threads.
 /// @return Facet permutation and cells permutations
 std::pair<std::vector<std::uint8_t>, std::vector<std::uint32_t>>
-compute_entity_permutations(const Topology& topology);
+compute_entity_permutations(const Topology& topology, int num_threads = 1);
 
 } // namespace dolfinx::mesh
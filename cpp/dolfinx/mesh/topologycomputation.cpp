@@ -8,17 +8,25 @@
 #include "Topology.h"
 #include "cell_types.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <exception>
 #include <boost/unordered_map.hpp>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/sort.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -439,28 +447,205 @@ get_local_indexing(MPI_Comm comm, const common::IndexMap& vertex_map,
 }
 //-----------------------------------------------------------------------------
 
-/// Compute entities of dimension d
+
+/// @brief Number cell entities by sorting their vertex keys.
 ///
-/// @param[in] comm MPI communicator (TODO: full or neighbor hood?)
-/// @param[in] cells Adjacency list for cell-vertex connectivity
-/// @param[in] shared_vertices TODO
-/// @param[in] cell_type Cell type
-/// @param[in] dim Topological dimension of the entities to be computed
-/// @return Returns the (cell-entity connectivity, entity-vertex
-/// connectivity, index map for the entity distribution across
-/// processes, shared entities)
-std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
-           graph::AdjacencyList<std::int32_t>, common::IndexMap,
-           std::vector<std::int32_t>>
-compute_entities_by_key_matching(
-    MPI_Comm comm,
-    std::vector<
-        std::tuple<mesh::CellType,
-                   std::shared_ptr<const graph::AdjacencyList<std::int32_t>>,
-                   std::shared_ptr<const common::IndexMap>>>
-        cell_lists,
-    const common::IndexMap& vertex_index_map, mesh::CellType entity_type,
-    int dim)
+/// @param[in] entity_list Vertices of each cell entity (row-major)
+/// @param[in] num_vertices_per_entity Number of vertices per entity
+/// @return (index of each cell entity, number of unique entities)
+std::pair<std::vector<std::int32_t>, std::int32_t>
+number_entities_by_sort(std::span<const std::int32_t> entity_list,
+                        int num_vertices_per_entity)
+{
+  std::vector<std::int32_t> entity_index(entity_list.size()
+                                         / num_vertices_per_entity);
+  std::int32_t entity_count = 0;
+
+  // Copy list and sort vertices of each entity into (reverse) order
+  std::vector<std::int32_t> entity_list_sorted(entity_list.begin(),
+                                               entity_list.end());
+  for (std::size_t j = 0; j < entity_index.size(); ++j)
+  {
+    auto it
+        = std::next(entity_list_sorted.begin(), j * num_vertices_per_entity);
+    std::sort(it, std::next(it, num_vertices_per_entity), std::less<>());
+  }
+
+  // Sort the list and label uniquely
+  const std::vector<std::int32_t> sort_order
+      = dolfinx::sort_by_perm<std::int32_t>(entity_list_sorted,
+                                            num_vertices_per_entity);
+
+  auto it = sort_order.begin();
+  while (it != sort_order.end())
+  {
+    // First entity in new index range
+    std::size_t offset = (*it) * num_vertices_per_entity;
+    std::span e0(entity_list_sorted.data() + offset, num_vertices_per_entity);
+
+    // Find iterator to next entity
+    auto it1 = std::find_if_not(
+        it, sort_order.end(),
+        [e0, &entity_list_sorted, num_vertices_per_entity](auto idx) -> bool
+        {
+          std::size_t offset = idx * num_vertices_per_entity;
+          return std::equal(e0.begin(), e0.end(),
+                            std::next(entity_list_sorted.begin(), offset));
+        });
+
+    // Set entity unique index
+    std::for_each(it, it1, [&entity_index, entity_count](auto idx)
+                  { entity_index[idx] = entity_count; });
+
+    // Advance iterator and increment entity
+    it = it1;
+    ++entity_count;
+  }
+
+  return {std::move(entity_index), entity_count};
+}
+//-----------------------------------------------------------------------------
+
+/// @brief Number cell entities by inserting their vertex keys into a
+/// concurrent hash table.
+///
+/// The table uses open addressing with linear probing. Each slot holds
+/// the lowest index of the cell entities with the slot key, which is
+/// updated with atomic compare-and-swap operations, so the table can be
+/// filled by several threads. The entities are numbered in the order
+/// of their first appearance in `entity_list`, which does not depend on
+/// the number of threads.
+///
+/// Compared to number_entities_by_sort, no sorted copy of the entity
+/// list and no sort permutation are created.
+///
+/// @param[in] entity_list Vertices of each cell entity (row-major)
+/// @param[in] num_vertices_per_entity Number of vertices per entity
+/// @param[in] num_threads Number of threads
+/// @return (index of each cell entity, number of unique entities)
+std::pair<std::vector<std::int32_t>, std::int32_t>
+number_entities_by_hash(std::span<const std::int32_t> entity_list,
+                        int num_vertices_per_entity, int num_threads)
+{
+  constexpr int max_vertices = 8;
+  if (num_vertices_per_entity > max_vertices)
+    throw std::runtime_error("Too many vertices per entity.");
+  const std::int32_t n = entity_list.size() / num_vertices_per_entity;
+
+  // Key of a cell entity: its sorted vertices, padded with -1
+  auto key = [entity_list, num_vertices_per_entity](std::int32_t e)
+  {
+    std::array<std::int32_t, max_vertices> k;
+    k.fill(-1);
+    std::copy_n(std::next(entity_list.begin(),
+                          std::size_t(e) * num_vertices_per_entity),
+                num_vertices_per_entity, k.begin());
+    std::sort(k.begin(), std::next(k.begin(), num_vertices_per_entity));
+    return k;
+  };
+
+  // Table with empty slots set to -1. The capacity bounds the load
+  // factor by 2/3 when all cell entities are different.
+  const std::size_t capacity = std::bit_ceil(std::size_t(n) + n / 2 + 1);
+  std::vector<std::int32_t> table(capacity, -1);
+
+  // Insert the cell entities, storing the slot of each cell entity
+  std::vector<std::int32_t> entity_index(n);
+  common::parallel_for(
+      n, num_threads,
+      [&](std::int64_t i0, std::int64_t i1)
+      {
+        for (std::int32_t i = i0; i < i1; ++i)
+        {
+          const std::array<std::int32_t, max_vertices> k = key(i);
+
+          // FNV-1a hash with the MurmurHash3 finaliser
+          std::uint64_t h = 0xcbf29ce484222325;
+          for (std::int32_t v : k)
+            h = (h ^ std::uint32_t(v)) * 0x100000001b3;
+          h ^= h >> 33;
+          h *= 0xff51afd7ed558ccd;
+          h ^= h >> 33;
+
+          for (std::size_t s = h & (capacity - 1);;
+               s = (s + 1) & (capacity - 1))
+          {
+            std::atomic_ref slot(table[s]);
+            std::int32_t e = slot.load(std::memory_order_relaxed);
+            if (e == -1 and slot.compare_exchange_strong(e, i))
+            {
+              entity_index[i] = s;
+              break;
+            }
+
+            // Slot is occupied (e holds the occupant)
+            if (key(e) == k)
+            {
+              while (i < e and !slot.compare_exchange_weak(e, i))
+                ;
+              entity_index[i] = s;
+              break;
+            }
+          }
+        }
+      });
+
+  // Number the entities in the order of first appearance. The first
+  // cell entity with a key (slot value) precedes all others with the
+  // same key, so it is numbered before the others are visited.
+  std::int32_t entity_count = 0;
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    const std::int32_t e = table[entity_index[i]];
+    entity_index[i] = e == i ? entity_count++ : entity_index[e];
+  }
+
+  return {std::move(entity_index), entity_count};
+}
+//-----------------------------------------------------------------------------
+
+/// Lists of the cells of each cell type, with the (cell type,
+/// cell-vertex connectivity, cell index map)
+using cell_lists_t = std::vector<
+    std::tuple<mesh::CellType,
+               std::shared_ptr<const graph::AdjacencyList<std::int32_t>>,
+               std::shared_ptr<const common::IndexMap>>>;
+
+/// Entities of one type identified from the cells on this process,
+/// before the ownership of the entities is determined
+struct local_entities
+{
+  // Local indices of the entities of each cell type that have the
+  // entity type, and offset of each cell type in entity_list
+  std::vector<std::vector<std::int32_t>> cell_type_entities;
+  std::vector<std::int32_t> cell_type_offsets;
+
+  // Vertices of the entity of each cell (row-major) and its initial
+  // (local) entity index
+  int num_vertices_per_entity;
+  std::vector<std::int32_t> entity_list;
+  std::vector<std::int32_t> entity_index;
+  std::int32_t entity_count;
+
+  // 0 if the entity is only in ghost cells, 1 otherwise
+  std::vector<std::int8_t> ghost_status;
+};
+
+/// Identify the entities of type `entity_type` in the cells. No
+/// communication is performed.
+///
+/// @param[in] cell_lists The cells of each cell type
+/// @param[in] vertex_index_map Index map for the vertices
+/// @param[in] entity_type Entity type
+/// @param[in] dim Topological dimension of the entities
+/// @param[in] method Algorithm used to identify the entities
+/// @param[in] num_threads Number of threads (hash algorithm only)
+/// @return The entities of the cells and their initial numbering
+local_entities identify_entities(const cell_lists_t& cell_lists,
+                                 const common::IndexMap& vertex_index_map,
+                                 mesh::CellType entity_type, int dim,
+                                 mesh::EntityComputation method,
+                                 int num_threads)
 {
   if (dim == 0)
   {
@@ -470,9 +655,6 @@ compute_entities_by_key_matching(
 
   assert(cell_dim(entity_type) == dim);
 
-  // Start timer
-  common::Timer timer("Compute entities of dim = " + std::to_string(dim));
-
   std::vector<std::vector<std::int32_t>> cell_type_entities(cell_lists.size());
   std::vector<std::int32_t> cell_type_offsets = {0};
   for (std::size_t k = 0; k < cell_lists.size(); ++k)
@@ -509,105 +691,75 @@ compute_entities_by_key_matching(
 
     const std::size_t num_cells = cells->num_nodes();
     int num_entities_per_cell = cell_type_entities[k].size();
-    for (std::size_t c = 0; c < num_cells; ++c)
+    auto create_entity_list = [&](std::int64_t c0, std::int64_t c1)
     {
-      // Get vertices from each cell
-      auto vertices = cells->links(c);
-
-      for (int i = 0; i < num_entities_per_cell; ++i)
+      for (std::int64_t c = c0; c < c1; ++c)
       {
-        const std::int32_t idx = c * num_entities_per_cell + i;
-        auto ev = e_vertices.links(cell_type_entities[k][i]);
-
-        // Get entity vertices. Padded with -1 if fewer than
-        // max_vertices_per_entity
-        // NOTE Entity orientation is determined by vertex ordering. The
-        // orientation of an entity with respect to the cell may differ from its
-        // global mesh orientation. Hence, we reorder the vertices so that
-        // each entity's orientation agrees with their global orientation.
-        // FIXME This might be better below when the entity to vertex
-        // connectivity is computed
-        std::vector<std::int32_t> entity_vertices(ev.size());
-        for (std::size_t j = 0; j < ev.size(); ++j)
-          entity_vertices[j] = vertices[ev[j]];
-
-        // Orient the entities. Simply sort according to global vertex index
-        // for simplices
-        std::vector<std::int64_t> global_vertices(entity_vertices.size());
-        vertex_index_map.local_to_global(entity_vertices, global_vertices);
-
-        std::vector<std::size_t> perm(global_vertices.size());
-        std::iota(perm.begin(), perm.end(), 0);
-        std::ranges::sort(perm,
-                          [&global_vertices](std::size_t i0, std::size_t i1) {
-                            return global_vertices[i0] < global_vertices[i1];
-                          });
-        // For quadrilaterals, the vertex opposite the lowest vertex should
-        // be last
-        if (entity_type == mesh::CellType::quadrilateral)
+        // Get vertices from each cell
+        auto vertices = cells->links(c);
+
+        for (int i = 0; i < num_entities_per_cell; ++i)
         {
-          std::size_t min_vertex_idx = perm[0];
-          std::size_t opposite_vertex_index = 3 - min_vertex_idx;
-          auto it = std::find(perm.begin(), perm.end(), opposite_vertex_index);
-          assert(it != perm.end());
-          std::rotate(it, it + 1, perm.end());
-        }
+          const std::int32_t idx = c * num_entities_per_cell + i;
+          auto ev = e_vertices.links(cell_type_entities[k][i]);
+
+          // Get entity vertices. Padded with -1 if fewer than
+          // max_vertices_per_entity
+          // NOTE Entity orientation is determined by vertex ordering. The
+          // orientation of an entity with respect to the cell may differ
+          // from its global mesh orientation. Hence, we reorder the
+          // vertices so that each entity's orientation agrees with their
+          // global orientation.
+          // FIXME This might be better below when the entity to vertex
+          // connectivity is computed
+          std::vector<std::int32_t> entity_vertices(ev.size());
+          for (std::size_t j = 0; j < ev.size(); ++j)
+            entity_vertices[j] = vertices[ev[j]];
+
+          // Orient the entities. Simply sort according to global vertex
+          // index for simplices
+          std::vector<std::int64_t> global_vertices(entity_vertices.size());
+          vertex_index_map.local_to_global(entity_vertices, global_vertices);
+
+          std::vector<std::size_t> perm(global_vertices.size());
+          std::iota(perm.begin(), perm.end(), 0);
+          std::ranges::sort(
+              perm, [&global_vertices](std::size_t i0, std::size_t i1)
+              { return global_vertices[i0] < global_vertices[i1]; });
+          // For quadrilaterals, the vertex opposite the lowest vertex
+          // should be last
+          if (entity_type == mesh::CellType::quadrilateral)
+          {
+            std::size_t min_vertex_idx = perm[0];
+            std::size_t opposite_vertex_index = 3 - min_vertex_idx;
+            auto it
+                = std::find(perm.begin(), perm.end(), opposite_vertex_index);
+            assert(it != perm.end());
+            std::rotate(it, it + 1, perm.end());
+          }
 
-        for (std::size_t j = 0; j < ev.size(); ++j)
-          entity_list[(cell_type_offsets[k] + idx) * num_vertices_per_entity
-                      + j]
-              = entity_vertices[perm[j]];
+          for (std::size_t j = 0; j < ev.size(); ++j)
+          {
+            entity_list[(cell_type_offsets[k] + idx) * num_vertices_per_entity
+                        + j]
+                = entity_vertices[perm[j]];
+          }
+        }
       }
-    }
+    };
+
+    // Build the entity list on threads for the hash-based computation
+    common::parallel_for(
+        num_cells, method == mesh::EntityComputation::hash ? num_threads : 1,
+        create_entity_list);
   }
 
   // Start numbering entities
-  std::vector<std::int32_t> entity_index(cell_type_offsets.back());
-
-  std::int32_t entity_count = 0;
-  {
-    // Copy list and sort vertices of each entity into (reverse) order
-    std::vector<std::int32_t> entity_list_sorted = entity_list;
-    for (std::size_t j = 0; j < entity_index.size(); ++j)
-    {
-      auto it
-          = std::next(entity_list_sorted.begin(), j * num_vertices_per_entity);
-      std::sort(it, std::next(it, num_vertices_per_entity), std::less<>());
-    }
-
-    // Sort the list and label uniquely
-    const std::vector<std::int32_t> sort_order
-        = dolfinx::sort_by_perm<std::int32_t>(entity_list_sorted,
-                                              num_vertices_per_entity);
-
-    std::vector<std::int32_t> entity(num_vertices_per_entity),
-        entity0(num_vertices_per_entity);
-    auto it = sort_order.begin();
-    while (it != sort_order.end())
-    {
-      // First entity in new index range
-      std::size_t offset = (*it) * num_vertices_per_entity;
-      std::span e0(entity_list_sorted.data() + offset, num_vertices_per_entity);
-
-      // Find iterator to next entity
-      auto it1 = std::find_if_not(
-          it, sort_order.end(),
-          [e0, &entity_list_sorted, num_vertices_per_entity](auto idx) -> bool
-          {
-            std::size_t offset = idx * num_vertices_per_entity;
-            return std::equal(e0.begin(), e0.end(),
-                              std::next(entity_list_sorted.begin(), offset));
-          });
-
-      // Set entity unique index
-      std::for_each(it, it1, [&entity_index, entity_count](auto idx)
-                    { entity_index[idx] = entity_count; });
-
-      // Advance iterator and increment entity
-      it = it1;
-      ++entity_count;
-    }
-  }
+  auto [entity_index, entity_count]
+      = method == mesh::EntityComputation::hash
+            ? number_entities_by_hash(entity_list, num_vertices_per_entity,
+                                      num_threads)
+            : number_entities_by_sort(entity_list, num_vertices_per_entity);
 
   //---------
   // Set ghost status array values
@@ -632,10 +784,38 @@ compute_entities_by_key_matching(
     }
   }
 
+  return {std::move(cell_type_entities),
+          std::move(cell_type_offsets),
+          num_vertices_per_entity,
+          std::move(entity_list),
+          std::move(entity_index),
+          entity_count,
+          std::move(ghost_status)};
+}
+//-----------------------------------------------------------------------------
+
+/// Number the entities identified by identify_entities across
+/// processes
+///
+/// @param[in] comm MPI communicator
+/// @param[in] vertex_index_map Index map for the vertices
+/// @param[in] entities The entities on this process
+/// @return Returns the (cell-entity connectivity, entity-vertex
+/// connectivity, index map for the entity distribution across
+/// processes, shared entities)
+std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
+           graph::AdjacencyList<std::int32_t>, common::IndexMap,
+           std::vector<std::int32_t>>
+number_entities(MPI_Comm comm, const common::IndexMap& vertex_index_map,
+                const local_entities& entities)
+{
+  const auto& [cell_type_entities, cell_type_offsets, num_vertices_per_entity,
+               entity_list, entity_index, entity_count, ghost_status]
+      = entities;
+
   // Communicate with other processes to find out which entities are
   // ghosted and shared. Remap the numbering so that ghosts are at the
   // end.
-
   auto [local_index, index_map, interprocess_entities]
       = get_local_indexing(comm, vertex_index_map, entity_list,
                            num_vertices_per_entity, ghost_status, entity_index);
@@ -651,8 +831,8 @@ compute_entities_by_key_matching(
   }
 
   std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>> ce(
-      cell_lists.size());
-  for (std::size_t k = 0; k < cell_lists.size(); ++k)
+      cell_type_entities.size());
+  for (std::size_t k = 0; k < cell_type_entities.size(); ++k)
   {
 
     if (!cell_type_entities[k].empty())
@@ -670,6 +850,54 @@ compute_entities_by_key_matching(
 }
 //-----------------------------------------------------------------------------
 
+/// Compute entities of dimension d
+///
+/// @param[in] comm MPI communicator
+/// @param[in] cell_lists The cells of each cell type
+/// @param[in] vertex_index_map Index map for the vertices
+/// @param[in] entity_type Entity type
+/// @param[in] dim Topological dimension of the entities to be computed
+/// @param[in] method Algorithm used to identify the entities
+/// @param[in] num_threads Number of threads (hash algorithm only)
+/// @return Returns the (cell-entity connectivity, entity-vertex
+/// connectivity, index map for the entity distribution across
+/// processes, shared entities)
+std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
+           graph::AdjacencyList<std::int32_t>, common::IndexMap,
+           std::vector<std::int32_t>>
+compute_entities_by_key_matching(MPI_Comm comm, const cell_lists_t& cell_lists,
+                                 const common::IndexMap& vertex_index_map,
+                                 mesh::CellType entity_type, int dim,
+                                 mesh::EntityComputation method,
+                                 int num_threads)
+{
+  common::Timer timer("Compute entities of dim = " + std::to_string(dim));
+  return number_entities(comm, vertex_index_map,
+                         identify_entities(cell_lists, vertex_index_map,
+                                           entity_type, dim, method,
+                                           num_threads));
+}
+
+/// Lists of the cells of each cell type of a topology
+cell_lists_t create_cell_lists(const mesh::Topology& topology)
+{
+  const int tdim = topology.dim();
+  std::vector<mesh::CellType> cell_types = topology.entity_types(tdim);
+  cell_lists_t cell_lists(cell_types.size());
+  auto cell_index_maps = topology.index_maps(tdim);
+  for (std::size_t i = 0; i < cell_types.size(); ++i)
+  {
+    auto cell_map = cell_index_maps[i];
+    assert(cell_map);
+    auto cells = topology.connectivity({tdim, i}, {0, 0});
+    if (!cells)
+      throw std::runtime_error("Cell connectivity missing.");
+    cell_lists[i] = {cell_types[i], cells, cell_map};
+  }
+  return cell_lists;
+}
+//-----------------------------------------------------------------------------
+
 /// Compute connectivity from entities of dimension d0 to entities of
 /// dimension d1 using the transpose connectivity (d1 -> d0)
 ///
@@ -765,10 +993,9 @@ std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
            std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>
 mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim,
-                       int index)
+                       int index, EntityComputation method, int num_threads)
 {
-  spdlog::info("Computing mesh entities of dimension {}", dim);
-  const int tdim = topology.dim();
+  DOLFINX_LOG_INFO("Computing mesh entities of dimension {}", dim);
 
   // Vertices must always exist
   if (dim == 0)
@@ -785,27 +1012,9 @@ mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim,
   assert(vertex_map);
 
   CellType entity_type = topology.entity_types(dim)[index];
-
-  // Lists of all cells by cell type
-  std::vector<CellType> cell_types = topology.entity_types(tdim);
-  std::vector<std::tuple<
-      mesh::CellType, std::shared_ptr<const graph::AdjacencyList<std::int32_t>>,
-      std::shared_ptr<const common::IndexMap>>>
-      cell_lists(cell_types.size());
-
-  auto cell_index_maps = topology.index_maps(tdim);
-  for (std::size_t i = 0; i < cell_types.size(); ++i)
-  {
-    auto cell_map = cell_index_maps[i];
-    assert(cell_map);
-    auto cells = topology.connectivity({tdim, i}, {0, 0});
-    if (!cells)
-      throw std::runtime_error("Cell connectivity missing.");
-    cell_lists[i] = {cell_types[i], cells, cell_map};
-  }
-
   auto [d0, d1, im, interprocess_facets] = compute_entities_by_key_matching(
-      comm, cell_lists, *vertex_map, entity_type, dim);
+      comm, create_cell_lists(topology), *vertex_map, entity_type, dim,
+      method, num_threads);
 
   return {d0,
           std::make_shared<graph::AdjacencyList<std::int32_t>>(std::move(d1)),
@@ -813,14 +1022,117 @@ mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim,
           std::move(interprocess_facets)};
 }
 //-----------------------------------------------------------------------------
+std::vector<
+    std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
+               std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
+               std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>>
+mesh::compute_entities(MPI_Comm comm, const Topology& topology,
+                       std::span<const std::pair<int, int>> entities,
+                       EntityComputation method, int num_threads)
+{
+  using result_t = std::tuple<
+      std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
+      std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
+      std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>;
+
+  // Entity types that need to be computed
+  std::vector<std::size_t> pos;
+  for (std::size_t i = 0; i < entities.size(); ++i)
+  {
+    auto [dim, index] = entities[i];
+    if (dim > 0 and !topology.connectivity({dim, index}, {0, 0}))
+      pos.push_back(i);
+  }
+
+  std::vector<result_t> results(entities.size());
+  if (num_threads <= 1 or pos.size() <= 1)
+  {
+    for (std::size_t i : pos)
+    {
+      auto [dim, index] = entities[i];
+      results[i] = compute_entities(comm, topology, dim, index, method,
+                                    num_threads);
+    }
+    return results;
+  }
+
+  common::Timer timer("Compute entities of several types");
+  auto vertex_map = topology.index_map(0);
+  assert(vertex_map);
+  const cell_lists_t cell_lists = create_cell_lists(topology);
+
+  // The entities of each type are identified by task i + 1. Task 0
+  // runs on the calling thread and numbers the entities of each type
+  // across processes, in order, as soon as they have been identified,
+  // which overlaps the communication with the identification of the
+  // remaining types.
+  const int n = pos.size();
+  const int nt = std::max(1, num_threads / n);
+  std::vector<local_entities> local(n);
+  std::vector<std::exception_ptr> errors(n);
+  std::vector<std::int8_t> done(n, 0);
+  std::mutex mutex;
+  std::condition_variable cv;
+  common::run_tasks(
+      n + 1,
+      [&](int t)
+      {
+        if (t > 0)
+        {
+          auto [dim, index] = entities[pos[t - 1]];
+          try
+          {
+            DOLFINX_LOG_INFO("Computing mesh entities of dimension {}", dim);
+            local[t - 1] = identify_entities(
+                cell_lists, *vertex_map, topology.entity_types(dim)[index],
+                dim, method, nt);
+          }
+          catch (...)
+          {
+            errors[t - 1] = std::current_exception();
+          }
+
+          {
+            std::scoped_lock lock(mutex);
+            done[t - 1] = 1;
+          }
+          cv.notify_one();
+          return;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+          {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&done, i] { return done[i] == 1; });
+          }
+
+          if (errors[i])
+            std::rethrow_exception(errors[i]);
+
+          auto [d0, d1, im, interprocess_facets]
+              = number_entities(comm, *vertex_map, local[i]);
+          local[i] = local_entities();
+          results[pos[i]]
+              = {d0,
+                 std::make_shared<graph::AdjacencyList<std::int32_t>>(
+                     std::move(d1)),
+                 std::make_shared<common::IndexMap>(std::move(im)),
+                 std::move(interprocess_facets)};
+        }
+      });
+
+  return results;
+}
+//-----------------------------------------------------------------------------
 std::array<std::shared_ptr<graph::AdjacencyList<std::int32_t>>, 2>
 mesh::compute_connectivity(const Topology& topology,
                            std::pair<std::int8_t, std::int8_t> d0,
                            std::pair<std::int8_t, std::int8_t> d1)
 {
-  spdlog::info("Requesting connectivity ({}, {}) - ({}, {})",
-               std::to_string(d0.first), std::to_string(d0.second),
-               std::to_string(d1.first), std::to_string(d1.second));
+  DOLFINX_LOG_INFO("Requesting connectivity ({}, {}) - ({}, {})",
+                   std::to_string(d0.first), std::to_string(d0.second),
+                   std::to_string(d1.first), std::to_string(d1.second));
 
   // Return if connectivity has already been computed
   if (topology.connectivity(d0, d1))
@@ -878,8 +1190,8 @@ mesh::compute_connectivity(const Topology& topology,
       auto c_d1_d0 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_map(*c_d1_0, *c_d0_0));
 
-      spdlog::info("Computing mesh connectivity {}-{} from transpose.",
-                   d0.first, d1.first);
+      DOLFINX_LOG_INFO("Computing mesh connectivity {}-{} from transpose.",
+                       d0.first, d1.first);
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_transpose(*c_d1_d0, c_d0_0->num_nodes()));
       return {c_d0_d1, c_d1_d0};
@@ -889,8 +1201,8 @@ mesh::compute_connectivity(const Topology& topology,
       assert(c_d0_0);
       assert(topology.connectivity(d1, d0));
 
-      spdlog::info("Computing mesh connectivity {}-{} from transpose.",
-                   std::to_string(d0.first), std::to_string(d1.first));
+      DOLFINX_LOG_INFO("Computing mesh connectivity {}-{} from transpose.",
+                       std::to_string(d0.first), std::to_string(d1.first));
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_transpose(*topology.connectivity(d1, d0),
                                  c_d0_0->num_nodes()));
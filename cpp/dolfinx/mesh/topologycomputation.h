@@ -8,9 +8,12 @@
 
 #include <array>
 #include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <memory>
 #include <mpi.h>
+#include <span>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::common
@@ -18,16 +21,18 @@ namespace dolfinx::common
 class IndexMap;
 }
 
-namespace dolfinx::graph
-{
-template <typename T>
-class AdjacencyList;
-}
-
 namespace dolfinx::mesh
 {
 class Topology;
 
+/// @brief Algorithm used by compute_entities to identify the entities
+/// that appear in more than one cell.
+enum class EntityComputation : int
+{
+  sort, ///< Sort the vertex keys of all cell entities
+  hash  ///< Insert the vertex keys into a concurrent hash table
+};
+
 /// @brief Compute mesh entities of given topological dimension by
 /// computing entity-to-vertex connectivity `(dim, 0)`, and cell-to-entity
 /// connectivity `(tdim, dim)`.
@@ -39,6 +44,12 @@ class Topology;
 /// @param[in] dim The dimension of the entities to create
 /// @param[in] index Index of entity in dimension `dim` as listed in
 /// `Topology::entity_types(dim)`.
+/// @param[in] method Algorithm used to identify the entities. The
+/// `hash` algorithm requires less memory than `sort`, and can use
+/// threads. The local (pre-ownership) entity numbering differs between
+/// the algorithms, but is independent of the number of threads.
+/// @param[in] num_threads Number of threads used to build and identify
+/// the cell entities. Only used by the `hash` algorithm.
 /// @return Tuple of (cell-entity connectivity, entity-vertex
 /// connectivity, index map, list of interprocess entities).
 /// Interprocess entities lie on the "true" boundary between owned cells of each
@@ -47,7 +58,36 @@ class Topology;
 std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
            std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>
-compute_entities(MPI_Comm comm, const Topology& topology, int dim, int index);
+compute_entities(MPI_Comm comm, const Topology& topology, int dim, int index,
+                 EntityComputation method = EntityComputation::sort,
+                 int num_threads = 1);
+
+/// @brief Compute mesh entities of several entity types.
+///
+/// The result for each entity type is the same as computed by
+/// compute_entities. If `num_threads` is greater than one, the entities
+/// of the different types are identified concurrently on threads. The
+/// numbering of the entities across processes, which requires
+/// communication, is performed by the calling thread for one type
+/// while the entities of the following types are being identified.
+/// Worker threads do not call MPI.
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] topology Mesh topology
+/// @param[in] entities Dimension and index (see
+/// `Topology::entity_types(dim)`) of each entity type
+/// @param[in] method Algorithm used to identify the entities
+/// @param[in] num_threads Number of threads. The threads are shared
+/// between the entity types.
+/// @return The result of compute_entities for each entity type
+std::vector<
+    std::tuple<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>,
+               std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
+               std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>>
+compute_entities(MPI_Comm comm, const Topology& topology,
+                 std::span<const std::pair<int, int>> entities,
+                 EntityComputation method = EntityComputation::sort,
+                 int num_threads = 1);
 
 /// @brief Compute connectivity (d0 -> d1) for given pair of entity types, given
 /// by topological dimension and index, as found in `Topology::entity_types()`
@@ -11,19 +11,67 @@
 #include "cell_types.h"
 #include "graphbuild.h"
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/math.h>
+#include <dolfinx/common/sort.h>
 #include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/graph/partition.h>
+#include <limits>
+#include <numeric>
 #include <span>
 #include <stdexcept>
 #include <vector>
 
 using namespace dolfinx;
 
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+mesh::space_filling_curve_order(std::span<const double> x,
+                                SpaceFillingCurve curve, int num_threads)
+{
+  const std::size_t num_points = x.size() / 3;
+
+  // Bounding box of the points
+  std::array<double, 3> x0, x1;
+  x0.fill(std::numeric_limits<double>::max());
+  x1.fill(std::numeric_limits<double>::lowest());
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      x0[j] = std::min(x0[j], x[3 * p + j]);
+      x1[j] = std::max(x1[j], x[3 * p + j]);
+    }
+  }
+  std::vector<std::uint64_t> keys
+      = graph::space_filling_curve_index(x, {x0, x1}, curve);
+
+  // Sort points by their index along the curve
+  std::vector<std::int32_t> perm(num_points);
+  std::iota(perm.begin(), perm.end(), 0);
+  dolfinx::radix_sort(perm, [&keys](auto p) { return keys[p]; },
+                      num_threads);
+
+  std::vector<std::int32_t> order(num_points);
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    order[perm[i]] = i;
+  return order;
+}
+//-----------------------------------------------------------------------------
+mesh::CellReorderFunction mesh::create_cell_reorderer(SpaceFillingCurve curve,
+                                                      int num_threads)
+{
+  return [curve, num_threads](const graph::AdjacencyList<std::int32_t>&,
+                              std::span<const double> midpoints)
+  {
+    DOLFINX_LOG_INFO("Re-order cells along space-filling curve");
+    return space_filling_curve_order(midpoints, curve, num_threads);
+  };
+}
 //-----------------------------------------------------------------------------
 std::vector<std::int64_t>
 mesh::extract_topology(CellType cell_type, const fem::ElementDofLayout& layout,
@@ -57,50 +105,139 @@ mesh::extract_topology(CellType cell_type, const fem::ElementDofLayout& layout,
 //-----------------------------------------------------------------------------
 std::vector<std::int32_t> mesh::exterior_facet_indices(const Topology& topology)
 {
-  const int tdim = topology.dim();
-  auto f_to_c = topology.connectivity(tdim - 1, tdim);
-  if (!f_to_c)
-  {
-    throw std::runtime_error(
-        "Facet to cell connectivity has not been computed.");
-  }
-  // Find all owned facets (not ghost) with only one attached cell
-  auto facet_map = topology.index_map(tdim - 1);
-  const int num_facets = facet_map->size_local();
-  std::vector<std::int32_t> facets;
-  for (std::int32_t f = 0; f < num_facets; ++f)
+  return *topology.exterior_facets();
+}
+//------------------------------------------------------------------------------
+mesh::CellPartitionFunction
+mesh::create_cell_partitioner(mesh::GhostMode ghost_mode,
+                              const graph::partition_fn& partfn,
+                              int ghost_layers)
+{
+  return [partfn, ghost_mode, ghost_layers](
+             MPI_Comm comm, int nparts, const std::vector<CellType>& cell_types,
+             const std::vector<std::span<const std::int64_t>>& cells)
+             -> graph::AdjacencyList<std::int32_t>
   {
-    if (f_to_c->num_links(f) == 1)
-      facets.push_back(f);
-  }
+    DOLFINX_LOG_INFO("Compute partition of cells across ranks");
 
-  // Remove facets on internal inter-process boundary
-  std::vector<std::int32_t> ext_facets;
-  std::ranges::set_difference(facets, topology.interprocess_facets(),
-                              std::back_inserter(ext_facets));
-  return ext_facets;
+    // Compute distributed dual graph (for the cells on this process)
+    const graph::AdjacencyList dual_graph
+        = build_dual_graph(comm, cell_types, cells);
+
+    // Just flag any kind of ghosting for now
+    bool ghosting = (ghost_mode != GhostMode::none);
+
+    // Compute partition
+    graph::AdjacencyList<std::int32_t> dest
+        = partfn(comm, nparts, dual_graph, ghosting);
+    if (ghosting and ghost_layers > 1)
+    {
+      return graph::extend_ghost_layers(comm, dual_graph, dest,
+                                        ghost_layers - 1);
+    }
+    else
+      return dest;
+  };
 }
-//------------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
 mesh::CellPartitionFunction
 mesh::create_cell_partitioner(mesh::GhostMode ghost_mode,
-                              const graph::partition_fn& partfn)
+                              const graph::weighted_partition_fn& partfn,
+                              const CellWeightFunction& weight_fn,
+                              int ghost_layers)
 {
-  return [partfn, ghost_mode](
+  return [partfn, weight_fn, ghost_mode, ghost_layers](
              MPI_Comm comm, int nparts, const std::vector<CellType>& cell_types,
              const std::vector<std::span<const std::int64_t>>& cells)
              -> graph::AdjacencyList<std::int32_t>
   {
-    spdlog::info("Compute partition of cells across ranks");
+    DOLFINX_LOG_INFO("Compute weighted partition of cells across ranks");
 
     // Compute distributed dual graph (for the cells on this process)
     const graph::AdjacencyList dual_graph
         = build_dual_graph(comm, cell_types, cells);
 
+    // Compute cell weights
+    std::vector<std::int32_t> weights = weight_fn(cell_types, cells);
+    if ((std::int32_t)weights.size() != dual_graph.num_nodes())
+      throw std::runtime_error("Number of cell weights and cells differ.");
+
     // Just flag any kind of ghosting for now
     bool ghosting = (ghost_mode != GhostMode::none);
 
     // Compute partition
-    return partfn(comm, nparts, dual_graph, ghosting);
+    graph::AdjacencyList<std::int32_t> dest
+        = partfn(comm, nparts, dual_graph, weights, ghosting);
+    if (ghosting and ghost_layers > 1)
+    {
+      return graph::extend_ghost_layers(comm, dual_graph, dest,
+                                        ghost_layers - 1);
+    }
+    else
+      return dest;
+  };
+}
+//-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+mesh::create_precomputed_cell_partitioner(mesh::GhostMode ghost_mode,
+                                          std::vector<std::int32_t> owners)
+{
+  return [owners = std::move(owners), ghost_mode](
+             MPI_Comm comm, int nparts, const std::vector<CellType>& cell_types,
+             const std::vector<std::span<const std::int64_t>>& cells)
+             -> graph::AdjacencyList<std::int32_t>
+  {
+    DOLFINX_LOG_INFO("Send cells to precomputed ranks");
+
+    std::size_t num_cells = 0;
+    for (std::size_t i = 0; i < cells.size(); ++i)
+      num_cells += cells[i].size() / num_cell_vertices(cell_types[i]);
+    if (owners.size() != num_cells)
+      throw std::runtime_error("Number of cell owners and cells differ.");
+    if (std::ranges::any_of(owners, [nparts](auto r)
+                            { return r < 0 or r >= nparts; }))
+    {
+      throw std::runtime_error("Cell owner is not a valid rank.");
+    }
+
+    if (ghost_mode == GhostMode::none)
+      return graph::regular_adjacency_list(owners, 1);
+
+    // Fetch the owners of the (unique) neighbours of the cells in the
+    // distributed dual graph
+    const graph::AdjacencyList dual_graph
+        = build_dual_graph(comm, cell_types, cells);
+    std::vector<std::int64_t> nbrs(dual_graph.array().begin(),
+                                   dual_graph.array().end());
+    std::ranges::sort(nbrs);
+    auto [unique_end, range_end] = std::ranges::unique(nbrs);
+    nbrs.erase(unique_end, range_end);
+    const std::vector<std::int32_t> nbr_owners
+        = dolfinx::MPI::distribute_data(comm, nbrs, comm, owners, 1);
+
+    // Owner, followed by the ghost destinations of each cell
+    std::vector<std::int32_t> dest, offsets(1, 0);
+    dest.reserve(owners.size());
+    offsets.reserve(owners.size() + 1);
+    for (std::int32_t c = 0; c < dual_graph.num_nodes(); ++c)
+    {
+      dest.push_back(owners[c]);
+      const std::size_t pos = dest.size();
+      for (std::int64_t e : dual_graph.links(c))
+      {
+        auto it = std::ranges::lower_bound(nbrs, e);
+        std::int32_t r = nbr_owners[std::distance(nbrs.begin(), it)];
+        if (r != owners[c])
+          dest.push_back(r);
+      }
+      std::sort(std::next(dest.begin(), pos), dest.end());
+      dest.erase(std::unique(std::next(dest.begin(), pos), dest.end()),
+                 dest.end());
+      offsets.push_back(dest.size());
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(dest),
+                                              std::move(offsets));
   };
 }
 //-----------------------------------------------------------------------------
@@ -12,12 +12,17 @@
 #include <algorithm>
 #include <basix/mdspan.hpp>
 #include <concepts>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/graph/ordering.h>
 #include <dolfinx/graph/partition.h>
+#include <dolfinx/graph/partitioners.h>
 #include <functional>
 #include <mpi.h>
 #include <span>
+#include <vector>
 
 /// @file utils.h
 /// @brief Functions supporting mesh operations
@@ -39,6 +44,34 @@ enum class GhostMode : int
   shared_vertex
 };
 
+/// @brief Options for the data that create_mesh computes when the mesh
+/// is created.
+///
+/// By default only the data that is required to create the mesh is
+/// computed, i.e. the cells and vertices, and the entities and entity
+/// permutations that the coordinate element requires. The other
+/// entities, connectivities and the entity permutations are computed
+/// on demand, e.g. by Topology::create_entities when a function space
+/// or an integration domain needs them. Entities that are known to be
+/// needed can be created eagerly with create_mesh, and the memory of
+/// the original cell indices can be released if they are not needed.
+struct MeshSetupOptions
+{
+  /// @brief Topological dimensions of the entities to create, e.g.
+  /// `tdim - 1` to create the facets (and the inter-process facets).
+  std::vector<int> entities = {};
+
+  /// @brief Compute the entity permutations (see
+  /// Topology::create_entity_permutations).
+  bool entity_permutations = false;
+
+  /// @brief Keep the input index of each cell (see
+  /// Topology::original_cell_index). The indices are required to read
+  /// mesh tags and functions, e.g. by io::XDMFFile and io::ADIOS2, and
+  /// by refinement.
+  bool original_cell_index = true;
+};
+
 namespace impl
 {
 /// Re-order an adjacency list of fixed degree
@@ -151,6 +184,51 @@ compute_vertex_coords_boundary(const mesh::Mesh<T>& mesh, int dim,
   return {std::move(entities), std::move(x_vertices), std::move(vertex_to_pos)};
 }
 
+/// @brief Replace parent indices by their index in a subset.
+///
+/// The inverse of `sub_to_parent` is stored densely, with one entry
+/// per parent index, only if the subset is not small compared to the
+/// parent. Otherwise the indices are located in the sorted subset, so
+/// that extracting a small subset (e.g. an interface of a large mesh)
+/// does not allocate and initialise an array of the parent size.
+///
+/// @param[in] sub_to_parent Parent index of each index in the subset.
+/// Must not contain duplicates.
+/// @param[in] num_parent Number of parent indices.
+/// @param[in,out] indices Parent indices, which must be in the subset,
+/// replaced by their index in the subset.
+inline void parent_to_sub_indices(std::span<const std::int32_t> sub_to_parent,
+                                  std::int32_t num_parent,
+                                  std::span<std::int32_t> indices)
+{
+  if (16 * sub_to_parent.size() >= std::size_t(num_parent))
+  {
+    std::vector<std::int32_t> parent_to_sub(num_parent, -1);
+    for (std::size_t i = 0; i < sub_to_parent.size(); ++i)
+      parent_to_sub[sub_to_parent[i]] = i;
+    for (std::int32_t& i : indices)
+    {
+      assert(parent_to_sub[i] != -1);
+      i = parent_to_sub[i];
+    }
+  }
+  else
+  {
+    std::vector<std::pair<std::int32_t, std::int32_t>> parent_sub;
+    parent_sub.reserve(sub_to_parent.size());
+    for (std::size_t i = 0; i < sub_to_parent.size(); ++i)
+      parent_sub.emplace_back(sub_to_parent[i], i);
+    std::ranges::sort(parent_sub);
+    for (std::int32_t& i : indices)
+    {
+      auto it = std::ranges::lower_bound(parent_sub, i, std::less{},
+                                         [](auto& p) { return p.first; });
+      assert(it != parent_sub.end() and it->first == i);
+      i = it->second;
+    }
+  }
+}
+
 } // namespace impl
 
 /// @brief Compute the indices of all exterior facets that are owned by
@@ -159,7 +237,8 @@ compute_vertex_coords_boundary(const mesh::Mesh<T>& mesh, int dim,
 /// An exterior facet (co-dimension 1) is one that is connected globally
 /// to only one cell of co-dimension 0).
 ///
-/// @note Collective
+/// @note Returns a copy of Topology::exterior_facets, which is cached
+/// by the topology.
 ///
 /// @param[in] topology Mesh topology
 /// @return Sorted list of owned facet indices that are exterior facets
@@ -186,6 +265,62 @@ using CellPartitionFunction = std::function<graph::AdjacencyList<std::int32_t>(
     MPI_Comm comm, int nparts, const std::vector<CellType>& cell_types,
     const std::vector<std::span<const std::int64_t>>& cells)>;
 
+/// @brief Signature for functions that compute the weights of cells
+/// for weighted partitioning.
+///
+/// @param[in] cell_types Cell types in the mesh.
+/// @param[in] cells Cells on this process for each cell type, as passed
+/// to a CellPartitionFunction.
+/// @return Weight of each cell, e.g. its computational cost, ordered by
+/// cell type and then by cell.
+using CellWeightFunction = std::function<std::vector<std::int32_t>(
+    const std::vector<CellType>& cell_types,
+    const std::vector<std::span<const std::int64_t>>& cells)>;
+
+/// @brief Signature for the cell re-ordering function. The function
+/// computes a re-ordering of the cells owned by a process to improve
+/// data locality.
+///
+/// @param[in] graph Local dual graph of the owned cells.
+/// @param[in] midpoints Midpoints of the owned cells (row-major, shape
+/// `(num_cells, 3)`).
+/// @return New index of each cell.
+using CellReorderFunction = std::function<std::vector<std::int32_t>(
+    const graph::AdjacencyList<std::int32_t>& graph,
+    std::span<const double> midpoints)>;
+
+/// Space-filling curves for ordering points
+using SpaceFillingCurve = graph::SpaceFillingCurve;
+
+/// @brief Compute the order of points along a space-filling curve.
+///
+/// The points are mapped to an integer grid in the directions in which
+/// the bounding box of the points has a non-zero extent, with `2^31`
+/// points per direction in one and two dimensions and `2^21` in three
+/// dimensions, and sorted by their index along the curve with a radix
+/// sort.
+///
+/// @param[in] x Points (row-major, shape `(num_points, 3)`).
+/// @param[in] curve The space-filling curve.
+/// @param[in] num_threads Number of threads used to sort the points.
+/// @return New index of each point.
+std::vector<std::int32_t>
+space_filling_curve_order(std::span<const double> x, SpaceFillingCurve curve,
+                          int num_threads = 1);
+
+/// @brief Create a function that re-orders cells along a space-filling
+/// curve through the cell midpoints.
+///
+/// This is cheaper to compute than a bandwidth-reducing reordering of
+/// the dual graph, e.g. graph::reorder_gps, and gives a good locality of
+/// the cell geometry and degree-of-freedom data.
+///
+/// @param[in] curve The space-filling curve.
+/// @param[in] num_threads Number of threads used to sort the cells.
+/// @return Function that computes the new index of each cell.
+CellReorderFunction create_cell_reorderer(SpaceFillingCurve curve,
+                                          int num_threads = 1);
+
 /// @brief Extract topology from cell data, i.e. extract cell vertices.
 /// @param[in] cell_type The cell shape
 /// @param[in] layout The layout of geometry 'degrees-of-freedom' on the
@@ -199,179 +334,307 @@ std::vector<std::int64_t> extract_topology(CellType cell_type,
                                            const fem::ElementDofLayout& layout,
                                            std::span<const std::int64_t> cells);
 
-/// @brief Compute greatest distance between any two vertices of the
-/// mesh entities (`h`).
+namespace impl
+{
+/// @brief Call a function with the geometry nodes of each entity in a
+/// list.
+///
+/// The nodes of an entity are the geometry nodes of its closure, in the
+/// order of entities_to_geometry. With more than one thread the
+/// entities are split into one chunk per thread and `fn` is called
+/// concurrently on the chunks. The node buffer is re-used for the
+/// entities of a chunk.
+///
 /// @param[in] mesh Mesh that the entities belong to.
-/// @param[in] entities Indices (local to process) of entities to
-/// compute `h` for.
 /// @param[in] dim Topological dimension of the entities.
-/// @returns Greatest distance between any two vertices, `h[i]`
-/// corresponds to the entity `entities[i]`.
-template <std::floating_point T>
-std::vector<T> h(const Mesh<T>& mesh, std::span<const std::int32_t> entities,
-                 int dim)
+/// @param[in] entities Entity indices (local to process).
+/// @param[in] permute If `true`, permute the nodes such that they are
+/// consistent with the orientation of `dim`-dimensional mesh entities.
+/// @param[in] num_threads Number of threads.
+/// @param[in] fn Function called as `fn(i, nodes)` for the entity
+/// `entities[i]`.
+template <std::floating_point T, typename Fn>
+void for_each_entity_geometry(const Mesh<T>& mesh, int dim,
+                              std::span<const std::int32_t> entities,
+                              bool permute, int num_threads, Fn fn)
 {
   if (entities.empty())
-    return std::vector<T>();
-  if (dim == 0)
-    return std::vector<T>(entities.size(), 0);
+    return;
 
-  // Get the geometry dofs for the vertices of each entity
-  const std::vector<std::int32_t> vertex_xdofs
-      = entities_to_geometry(mesh, dim, entities, false);
-  assert(!entities.empty());
-  const std::size_t num_vertices = vertex_xdofs.size() / entities.size();
+  auto topology = mesh.topology();
+  assert(topology);
+  CellType cell_type = topology->cell_type();
+  if (cell_type == CellType::prism and dim == 2)
+    throw std::runtime_error("More work needed for prism cells");
 
-  // Get the  geometry coordinate
-  std::span<const T> x = mesh.geometry().x();
+  const int tdim = topology->dim();
+  const Geometry<T>& geometry = mesh.geometry();
+  auto xdofs = geometry.dofmap();
 
-  // Function to compute the length of (p0 - p1)
-  auto delta_norm = [](auto&& p0, auto&& p1)
-  {
-    T norm = 0;
-    for (std::size_t i = 0; i < 3; ++i)
-      norm += (p0[i] - p1[i]) * (p0[i] - p1[i]);
-    return std::sqrt(norm);
-  };
+  // Get the element's closure DOFs
+  const fem::CoordinateElement<T>& coord_ele = geometry.cmap();
+  const fem::ElementDofLayout layout = coord_ele.create_dof_layout();
+  const std::vector<std::vector<std::vector<int>>>& closure_dofs_all
+      = layout.entity_closure_dofs_all();
 
-  // Compute greatest distance between any to vertices
-  assert(dim > 0);
-  std::vector<T> h(entities.size(), 0);
-  for (std::size_t e = 0; e < entities.size(); ++e)
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> e_to_c, c_to_e;
+  std::span<const std::uint32_t> cell_info;
+  if (dim != tdim)
   {
-    // Get geometry 'dof' for each vertex of entity e
-    std::span<const std::int32_t> e_vertices(
-        vertex_xdofs.data() + e * num_vertices, num_vertices);
+    e_to_c = topology->connectivity(dim, tdim);
+    if (!e_to_c)
+    {
+      throw std::runtime_error(
+          "Entity-to-cell connectivity has not been computed. Missing dims "
+          + std::to_string(dim) + "->" + std::to_string(tdim));
+    }
+
+    c_to_e = topology->connectivity(tdim, dim);
+    if (!c_to_e)
+    {
+      throw std::runtime_error(
+          "Cell-to-entity connectivity has not been computed. Missing dims "
+          + std::to_string(tdim) + "->" + std::to_string(dim));
+    }
 
-    // Compute maximum distance between any two vertices
-    for (std::size_t i = 0; i < e_vertices.size(); ++i)
+    // Get the cell info, which is needed to permute the closure dofs
+    if (permute)
+      cell_info = std::span(topology->get_cell_permutation_info());
+  }
+
+  // Visit the entities in range [i0, i1)
+  auto compute = [&](std::size_t i0, std::size_t i1)
+  {
+    std::vector<std::int32_t> closure_dofs, nodes;
+    for (std::size_t i = i0; i < i1; ++i)
     {
-      std::span<const T, 3> p0(x.data() + 3 * e_vertices[i], 3);
-      for (std::size_t j = i + 1; j < e_vertices.size(); ++j)
+      std::int32_t c = entities[i];
+      if (dim == tdim)
+      {
+        closure_dofs.assign(closure_dofs_all[tdim][0].begin(),
+                            closure_dofs_all[tdim][0].end());
+      }
+      else
       {
-        std::span<const T, 3> p1(x.data() + 3 * e_vertices[j], 3);
-        h[e] = std::max(h[e], delta_norm(p0, p1));
+        // Get a cell connected to the entity
+        const std::int32_t e = entities[i];
+        assert(!e_to_c->links(e).empty());
+        c = e_to_c->links(e).front();
+
+        // Get the local index of the entity
+        std::span<const std::int32_t> cell_entities = c_to_e->links(c);
+        auto it = std::ranges::find(cell_entities, e);
+        assert(it != cell_entities.end());
+        std::size_t local_entity = std::distance(cell_entities.begin(), it);
+        closure_dofs.assign(closure_dofs_all[dim][local_entity].begin(),
+                            closure_dofs_all[dim][local_entity].end());
+
+        // Cell sub-entities must be permuted so that their local
+        // orientation agrees with their global orientation
+        if (permute)
+        {
+          mesh::CellType entity_type
+              = mesh::cell_entity_type(cell_type, dim, local_entity);
+          coord_ele.permute_subentity_closure(closure_dofs, cell_info[c],
+                                              entity_type, local_entity);
+        }
       }
+
+      nodes.resize(closure_dofs.size());
+      for (std::size_t k = 0; k < closure_dofs.size(); ++k)
+        nodes[k] = xdofs(c, closure_dofs[k]);
+      fn(i, std::span<const std::int32_t>(nodes));
     }
+  };
+
+  common::parallel_for(entities.size(), num_threads, compute);
+}
+} // namespace impl
+
+/// @brief Compute greatest distance between any two vertices of the
+/// mesh entities (`h`).
+/// @param[in] mesh Mesh that the entities belong to.
+/// @param[in] entities Indices (local to process) of entities to
+/// compute `h` for.
+/// @param[in] dim Topological dimension of the entities.
+/// @param[out] h Greatest distance between any two vertices, `h[i]`
+/// corresponds to the entity `entities[i]`. The size must be the
+/// number of entities.
+/// @param[in] num_threads Number of threads.
+template <std::floating_point T>
+void h(const Mesh<T>& mesh, std::span<const std::int32_t> entities, int dim,
+       std::span<T> h, int num_threads = 1)
+{
+  if (h.size() != entities.size())
+    throw std::runtime_error("Output array has the wrong size.");
+  if (dim == 0)
+  {
+    std::ranges::fill(h, 0);
+    return;
   }
 
+  // Compute greatest distance between any two geometry nodes of each
+  // entity
+  std::span<const T> x = mesh.geometry().x();
+  impl::for_each_entity_geometry(
+      mesh, dim, entities, false, num_threads,
+      [&](std::size_t e, std::span<const std::int32_t> nodes)
+      {
+        T h2 = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+          std::span<const T, 3> p0(x.data() + 3 * nodes[i], 3);
+          for (std::size_t j = i + 1; j < nodes.size(); ++j)
+          {
+            std::span<const T, 3> p1(x.data() + 3 * nodes[j], 3);
+            T d2 = 0;
+            for (std::size_t k = 0; k < 3; ++k)
+              d2 += (p0[k] - p1[k]) * (p0[k] - p1[k]);
+            h2 = std::max(h2, d2);
+          }
+        }
+        h[e] = std::sqrt(h2);
+      });
+}
+
+/// @brief Compute greatest distance between any two vertices of the
+/// mesh entities (`h`).
+/// @param[in] mesh Mesh that the entities belong to.
+/// @param[in] entities Indices (local to process) of entities to
+/// compute `h` for.
+/// @param[in] dim Topological dimension of the entities.
+/// @returns Greatest distance between any two vertices, `h[i]`
+/// corresponds to the entity `entities[i]`.
+template <std::floating_point T>
+std::vector<T> h(const Mesh<T>& mesh, std::span<const std::int32_t> entities,
+                 int dim)
+{
+  std::vector<T> h(entities.size());
+  mesh::h(mesh, entities, dim, std::span(h));
   return h;
 }
 
 /// @brief Compute normal to given cell (viewed as embedded in 3D)
-/// @returns The entity normals. The shape is `(entities.size(), 3)` and
-/// the storage is row-major.
+/// @param[in] mesh Mesh that the entities belong to.
+/// @param[in] dim Topological dimension of the entities.
+/// @param[in] entities Indices (local to process) of the entities.
+/// @param[out] n The entity normals. The shape is `(entities.size(),
+/// 3)` and the storage is row-major.
+/// @param[in] num_threads Number of threads.
 template <std::floating_point T>
-std::vector<T> cell_normals(const Mesh<T>& mesh, int dim,
-                            std::span<const std::int32_t> entities)
+void cell_normals(const Mesh<T>& mesh, int dim,
+                  std::span<const std::int32_t> entities, std::span<T> n,
+                  int num_threads = 1)
 {
   auto topology = mesh.topology();
   assert(topology);
 
+  if (n.size() != 3 * entities.size())
+    throw std::runtime_error("Output array has the wrong size.");
   if (entities.empty())
-    return std::vector<T>();
+    return;
 
   if (topology->cell_type() == CellType::prism and dim == 2)
     throw std::runtime_error("More work needed for prism cell");
 
   const int gdim = mesh.geometry().dim();
   const CellType type = cell_entity_type(topology->cell_type(), dim, 0);
-
-  // Find geometry nodes for topology entities
-  std::span<const T> x = mesh.geometry().x();
-  std::vector<std::int32_t> geometry_entities
-      = entities_to_geometry(mesh, dim, entities, false);
-
-  const std::size_t shape1 = geometry_entities.size() / entities.size();
-  std::vector<T> n(entities.size() * 3);
   switch (type)
   {
   case CellType::interval:
-  {
     if (gdim > 2)
       throw std::invalid_argument("Interval cell normal undefined in 3D");
-    for (std::size_t i = 0; i < entities.size(); ++i)
-    {
-      // Get the two vertices as points
-      std::array vertices{geometry_entities[i * shape1],
-                          geometry_entities[i * shape1 + 1]};
-      std::array p = {std::span<const T, 3>(x.data() + 3 * vertices[0], 3),
-                      std::span<const T, 3>(x.data() + 3 * vertices[1], 3)};
-
-      // Define normal by rotating tangent counter-clockwise
-      std::array<T, 3> t;
-      std::ranges::transform(p[1], p[0], t.begin(),
-                             [](auto x, auto y) { return x - y; });
-
-      T norm = std::sqrt(t[0] * t[0] + t[1] * t[1]);
-      std::span<T, 3> ni(n.data() + 3 * i, 3);
-      ni[0] = -t[1] / norm;
-      ni[1] = t[0] / norm;
-      ni[2] = 0.0;
-    }
-    return n;
-  }
+    break;
   case CellType::triangle:
-  {
-    for (std::size_t i = 0; i < entities.size(); ++i)
-    {
-      // Get the three vertices as points
-      std::array vertices = {geometry_entities[i * shape1 + 0],
-                             geometry_entities[i * shape1 + 1],
-                             geometry_entities[i * shape1 + 2]};
-      std::array p = {std::span<const T, 3>(x.data() + 3 * vertices[0], 3),
-                      std::span<const T, 3>(x.data() + 3 * vertices[1], 3),
-                      std::span<const T, 3>(x.data() + 3 * vertices[2], 3)};
-
-      // Compute (p1 - p0) and (p2 - p0)
-      std::array<T, 3> dp1, dp2;
-      std::ranges::transform(p[1], p[0], dp1.begin(),
-                             [](auto x, auto y) { return x - y; });
-      std::ranges::transform(p[2], p[0], dp2.begin(),
-                             [](auto x, auto y) { return x - y; });
-
-      // Define cell normal via cross product of first two edges
-      std::array<T, 3> ni = math::cross(dp1, dp2);
-      T norm = std::sqrt(ni[0] * ni[0] + ni[1] * ni[1] + ni[2] * ni[2]);
-      std::ranges::transform(ni, std::next(n.begin(), 3 * i),
-                             [norm](auto x) { return x / norm; });
-    }
-
-    return n;
-  }
   case CellType::quadrilateral:
-  {
-    // TODO: check
-    for (std::size_t i = 0; i < entities.size(); ++i)
-    {
-      // Get the three vertices as points
-      std::array vertices = {geometry_entities[i * shape1 + 0],
-                             geometry_entities[i * shape1 + 1],
-                             geometry_entities[i * shape1 + 2]};
-      std::array p = {std::span<const T, 3>(x.data() + 3 * vertices[0], 3),
-                      std::span<const T, 3>(x.data() + 3 * vertices[1], 3),
-                      std::span<const T, 3>(x.data() + 3 * vertices[2], 3)};
-
-      // Compute (p1 - p0) and (p2 - p0)
-      std::array<T, 3> dp1, dp2;
-      std::ranges::transform(p[1], p[0], dp1.begin(),
-                             [](auto x, auto y) { return x - y; });
-      std::ranges::transform(p[2], p[0], dp2.begin(),
-                             [](auto x, auto y) { return x - y; });
-
-      // Define cell normal via cross product of first two edges
-      std::array<T, 3> ni = math::cross(dp1, dp2);
-      T norm = std::sqrt(ni[0] * ni[0] + ni[1] * ni[1] + ni[2] * ni[2]);
-      std::ranges::transform(ni, std::next(n.begin(), 3 * i),
-                             [norm](auto x) { return x / norm; });
-    }
-
-    return n;
-  }
+    break;
   default:
     throw std::invalid_argument(
         "cell_normal not supported for this cell type.");
   }
+
+  std::span<const T> x = mesh.geometry().x();
+  impl::for_each_entity_geometry(
+      mesh, dim, entities, false, num_threads,
+      [&](std::size_t i, std::span<const std::int32_t> nodes)
+      {
+        std::span<T, 3> ni(n.data() + 3 * i, 3);
+        std::span<const T, 3> p0(x.data() + 3 * nodes[0], 3);
+        std::span<const T, 3> p1(x.data() + 3 * nodes[1], 3);
+        if (type == CellType::interval)
+        {
+          // Define normal by rotating tangent counter-clockwise
+          std::array<T, 3> t;
+          std::ranges::transform(p1, p0, t.begin(),
+                                 [](auto x, auto y) { return x - y; });
+
+          T norm = std::sqrt(t[0] * t[0] + t[1] * t[1]);
+          ni[0] = -t[1] / norm;
+          ni[1] = t[0] / norm;
+          ni[2] = 0.0;
+        }
+        else
+        {
+          // Compute (p1 - p0) and (p2 - p0)
+          std::span<const T, 3> p2(x.data() + 3 * nodes[2], 3);
+          std::array<T, 3> dp1, dp2;
+          std::ranges::transform(p1, p0, dp1.begin(),
+                                 [](auto x, auto y) { return x - y; });
+          std::ranges::transform(p2, p0, dp2.begin(),
+                                 [](auto x, auto y) { return x - y; });
+
+          // Define cell normal via cross product of first two edges
+          std::array<T, 3> c = math::cross(dp1, dp2);
+          T norm = std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+          std::ranges::transform(c, ni.begin(),
+                                 [norm](auto x) { return x / norm; });
+        }
+      });
+}
+
+/// @brief Compute normal to given cell (viewed as embedded in 3D)
+/// @returns The entity normals. The shape is `(entities.size(), 3)` and
+/// the storage is row-major.
+template <std::floating_point T>
+std::vector<T> cell_normals(const Mesh<T>& mesh, int dim,
+                            std::span<const std::int32_t> entities)
+{
+  std::vector<T> n(entities.size() * 3);
+  cell_normals(mesh, dim, entities, std::span(n));
+  return n;
+}
+
+/// @brief Compute the midpoints for mesh entities of a given dimension.
+/// @param[in] mesh Mesh that the entities belong to.
+/// @param[in] dim Topological dimension of the entities.
+/// @param[in] entities Indices (local to process) of the entities.
+/// @param[out] x_mid The entity midpoints. The shape is
+/// `(entities.size(), 3)` and the storage is row-major.
+/// @param[in] num_threads Number of threads.
+template <std::floating_point T>
+void compute_midpoints(const Mesh<T>& mesh, int dim,
+                       std::span<const std::int32_t> entities,
+                       std::span<T> x_mid, int num_threads = 1)
+{
+  if (x_mid.size() != 3 * entities.size())
+    throw std::runtime_error("Output array has the wrong size.");
+
+  // FIXME: This assumes a linear geometry.
+  std::span<const T> x = mesh.geometry().x();
+  impl::for_each_entity_geometry(
+      mesh, dim, entities, false, num_threads,
+      [&](std::size_t e, std::span<const std::int32_t> nodes)
+      {
+        std::span<T, 3> p(x_mid.data() + 3 * e, 3);
+        std::ranges::fill(p, 0);
+        for (auto node : nodes)
+        {
+          std::span<const T, 3> xg(x.data() + 3 * node, 3);
+          std::ranges::transform(p, xg, p.begin(),
+                                 [size = nodes.size()](auto x, auto y)
+                                 { return x + y / size; });
+        }
+      });
 }
 
 /// @brief Compute the midpoints for mesh entities of a given dimension.
@@ -381,32 +644,154 @@ template <std::floating_point T>
 std::vector<T> compute_midpoints(const Mesh<T>& mesh, int dim,
                                  std::span<const std::int32_t> entities)
 {
-  if (entities.empty())
-    return std::vector<T>();
+  std::vector<T> x_mid(entities.size() * 3, 0);
+  compute_midpoints(mesh, dim, entities, std::span(x_mid));
+  return x_mid;
+}
 
-  std::span<const T> x = mesh.geometry().x();
+/// @brief Compute the size `h`, the volume and the midpoint of mesh
+/// entities in one pass over the entities.
+///
+/// `h` and the midpoint are the same as computed by mesh::h and
+/// compute_midpoints. The volume (length, area) is computed from the
+/// entity vertices. For simplices it is computed from the affine map
+/// of the vertices. For quadrilaterals and hexahedra it is computed
+/// with a 2-point (per direction) Gauss rule for the multilinear map
+/// of the vertices, which is exact if the geometric and topological
+/// dimensions are equal.
+///
+/// @param[in] mesh Mesh that the entities belong to.
+/// @param[in] dim Topological dimension of the entities. Must be
+/// greater than zero.
+/// @param[in] entities Indices (local to process) of the entities.
+/// @param[out] h Greatest distance between any two vertices of each
+/// entity. The size must be the number of entities.
+/// @param[out] volume Volume of each entity. The size must be the
+/// number of entities.
+/// @param[out] x_mid The entity midpoints. The shape is
+/// `(entities.size(), 3)` and the storage is row-major.
+/// @param[in] num_threads Number of threads.
+template <std::floating_point T>
+void geometry_summary(const Mesh<T>& mesh, int dim,
+                      std::span<const std::int32_t> entities,
+                      std::span<T> h, std::span<T> volume,
+                      std::span<T> x_mid, int num_threads = 1)
+{
+  if (h.size() != entities.size() or volume.size() != entities.size()
+      or x_mid.size() != 3 * entities.size())
+  {
+    throw std::runtime_error("Output array has the wrong size.");
+  }
+  if (dim == 0)
+    throw std::runtime_error("Geometry summary not defined for vertices.");
 
-  // Build map from entity -> geometry dof
-  // FIXME: This assumes a linear geometry.
-  const std::vector<std::int32_t> e_to_g
-      = entities_to_geometry(mesh, dim, entities, false);
-  std::size_t shape1 = e_to_g.size() / entities.size();
+  auto topology = mesh.topology();
+  assert(topology);
+  const CellType type = cell_entity_type(topology->cell_type(), dim, 0);
+  const bool simplex = is_simplex(type);
+  if (!simplex and type != CellType::quadrilateral
+      and type != CellType::hexahedron)
+  {
+    throw std::runtime_error("Geometry summary not supported for "
+                             + to_string(type) + " entities.");
+  }
+  const int num_vertices = num_cell_vertices(type);
 
-  std::vector<T> x_mid(entities.size() * 3, 0);
-  for (std::size_t e = 0; e < entities.size(); ++e)
+  // Determinant of the Gram matrix J^T J of the columns of J
+  auto gram_det = [dim](const std::array<std::array<T, 3>, 3>& J) -> T
   {
-    std::span<T, 3> p(x_mid.data() + 3 * e, 3);
-    std::span<const std::int32_t> rows(e_to_g.data() + e * shape1, shape1);
-    for (auto row : rows)
+    std::array<T, 9> G{};
+    for (int a = 0; a < dim; ++a)
+      for (int b = 0; b < dim; ++b)
+        for (std::size_t k = 0; k < 3; ++k)
+          G[3 * a + b] += J[a][k] * J[b][k];
+    switch (dim)
     {
-      std::span<const T, 3> xg(x.data() + 3 * row, 3);
-      std::ranges::transform(p, xg, p.begin(),
-                             [size = rows.size()](auto x, auto y)
-                             { return x + y / size; });
+    case 1:
+      return G[0];
+    case 2:
+      return G[0] * G[4] - G[1] * G[3];
+    default:
+      return G[0] * (G[4] * G[8] - G[5] * G[7])
+             - G[1] * (G[3] * G[8] - G[5] * G[6])
+             + G[2] * (G[3] * G[7] - G[4] * G[6]);
     }
-  }
+  };
 
-  return x_mid;
+  // Gauss points on [0, 1]
+  const std::array<T, 2> gp = {0.5 - 0.5 / std::sqrt(T(3)),
+                               0.5 + 0.5 / std::sqrt(T(3))};
+  const T factorial = dim == 1 ? 1 : (dim == 2 ? 2 : 6);
+
+  std::span<const T> x = mesh.geometry().x();
+  impl::for_each_entity_geometry(
+      mesh, dim, entities, false, num_threads,
+      [&](std::size_t e, std::span<const std::int32_t> nodes)
+      {
+        // Size and midpoint from all geometry nodes
+        T h2 = 0;
+        std::span<T, 3> p(x_mid.data() + 3 * e, 3);
+        std::ranges::fill(p, 0);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+          std::span<const T, 3> p0(x.data() + 3 * nodes[i], 3);
+          for (std::size_t k = 0; k < 3; ++k)
+            p[k] += p0[k] / nodes.size();
+          for (std::size_t j = i + 1; j < nodes.size(); ++j)
+          {
+            std::span<const T, 3> p1(x.data() + 3 * nodes[j], 3);
+            T d2 = 0;
+            for (std::size_t k = 0; k < 3; ++k)
+              d2 += (p0[k] - p1[k]) * (p0[k] - p1[k]);
+            h2 = std::max(h2, d2);
+          }
+        }
+        h[e] = std::sqrt(h2);
+
+        // Volume from the vertices, which are the first nodes
+        auto vertex = [&](int v)
+        { return std::span<const T, 3>(x.data() + 3 * nodes[v], 3); };
+        std::array<std::array<T, 3>, 3> J{};
+        if (simplex)
+        {
+          for (int a = 0; a < dim; ++a)
+            for (std::size_t k = 0; k < 3; ++k)
+              J[a][k] = vertex(a + 1)[k] - vertex(0)[k];
+          volume[e] = std::sqrt(std::abs(gram_det(J))) / factorial;
+        }
+        else
+        {
+          // Vertex v of the reference cell is at the point with
+          // coordinate m given by bit m of v
+          volume[e] = 0;
+          for (int q = 0; q < (1 << dim); ++q)
+          {
+            std::array<T, 3> xi{};
+            for (int m = 0; m < dim; ++m)
+              xi[m] = gp[(q >> m) & 1];
+
+            J = {};
+            for (int v = 0; v < num_vertices; ++v)
+            {
+              for (int a = 0; a < dim; ++a)
+              {
+                T dN = 1;
+                for (int m = 0; m < dim; ++m)
+                {
+                  const bool upper = (v >> m) & 1;
+                  if (m == a)
+                    dN *= upper ? 1 : -1;
+                  else
+                    dN *= upper ? xi[m] : 1 - xi[m];
+                }
+                for (std::size_t k = 0; k < 3; ++k)
+                  J[a][k] += dN * vertex(v)[k];
+              }
+            }
+            volume[e] += std::sqrt(std::abs(gram_det(J))) / (1 << dim);
+          }
+        }
+      });
 }
 
 namespace impl
@@ -477,11 +862,15 @@ concept MarkerFn = std::is_invocable_r<
 /// considered.
 /// @param[in] marker Marking function, returns `true` for a point that
 /// is 'marked', and `false` otherwise.
+/// @param[in] num_threads Number of threads to evaluate the marker
+/// with. With more than one thread, the vertices are split into one
+/// chunk per thread and the marker is called concurrently on each
+/// chunk, so it must be thread-safe.
 /// @returns List of marked entity indices, including any ghost indices
 /// (indices local to the process)
 template <std::floating_point T, MarkerFn<T> U>
 std::vector<std::int32_t> locate_entities(const Mesh<T>& mesh, int dim,
-                                          U marker)
+                                          U marker, int num_threads = 1)
 {
   using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
       const T,
@@ -490,10 +879,39 @@ std::vector<std::int32_t> locate_entities(const Mesh<T>& mesh, int dim,
 
   // Run marker function on vertex coordinates
   const auto [xdata, xshape] = impl::compute_vertex_coords(mesh);
-  cmdspan3x_t x(xdata.data(), xshape);
-  const std::vector<std::int8_t> marked = marker(x);
-  if (marked.size() != x.extent(1))
-    throw std::runtime_error("Length of array of markers is wrong.");
+  const std::size_t num_vertices = xshape[1];
+  std::vector<std::int8_t> marked;
+  const int nt = std::min<std::size_t>(std::max(num_threads, 1),
+                                       std::max<std::size_t>(num_vertices, 1));
+  if (nt == 1)
+  {
+    cmdspan3x_t x(xdata.data(), xshape);
+    marked = marker(x);
+    if (marked.size() != num_vertices)
+      throw std::runtime_error("Length of array of markers is wrong.");
+  }
+  else
+  {
+    // Evaluate the marker on a copy of each chunk of vertices
+    marked.resize(num_vertices);
+    auto mark_range = [&](std::size_t v0, std::size_t v1)
+    {
+      std::vector<T> x_t(3 * (v1 - v0));
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        std::copy(std::next(xdata.begin(), j * num_vertices + v0),
+                  std::next(xdata.begin(), j * num_vertices + v1),
+                  std::next(x_t.begin(), j * (v1 - v0)));
+      }
+      const std::vector<std::int8_t> marked_t
+          = marker(cmdspan3x_t(x_t.data(), 3, v1 - v0));
+      if (marked_t.size() != v1 - v0)
+        throw std::runtime_error("Length of array of markers is wrong.");
+      std::ranges::copy(marked_t, std::next(marked.begin(), v0));
+    };
+
+    common::parallel_for(num_vertices, nt, mark_range);
+  }
 
   auto topology = mesh.topology();
   assert(topology);
@@ -568,8 +986,8 @@ std::vector<std::int32_t> locate_entities_boundary(const Mesh<T>& mesh, int dim,
   // Compute list of boundary facets
   mesh.topology_mutable()->create_entities(tdim - 1);
   mesh.topology_mutable()->create_connectivity(tdim - 1, tdim);
-  const std::vector<std::int32_t> boundary_facets
-      = exterior_facet_indices(*topology);
+  std::shared_ptr<const std::vector<std::int32_t>> boundary_facets
+      = topology->exterior_facets();
 
   using cmdspan3x_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
       const T,
@@ -578,7 +996,7 @@ std::vector<std::int32_t> locate_entities_boundary(const Mesh<T>& mesh, int dim,
 
   // Run marker function on the vertex coordinates
   const auto [facet_entities, xdata, vertex_to_pos]
-      = impl::compute_vertex_coords_boundary(mesh, dim, boundary_facets);
+      = impl::compute_vertex_coords_boundary(mesh, dim, *boundary_facets);
   cmdspan3x_t x(xdata.data(), 3, xdata.size() / 3);
   const std::vector<std::int8_t> marked = marker(x);
   if (marked.size() != x.extent(1))
@@ -611,6 +1029,44 @@ std::vector<std::int32_t> locate_entities_boundary(const Mesh<T>& mesh, int dim,
   return entities;
 }
 
+/// @brief Compute the geometry degrees of freedom associated with
+/// the closure of a given set of cell entities.
+///
+/// @param[in] mesh The mesh.
+/// @param[in] dim Topological dimension of the entities of interest.
+/// @param[in] entities Entity indices (local to process).
+/// @param[out] entity_xdofs The geometry DOFs associated with the
+/// closure of each entity in `entities`. The shape is `(num_entities,
+/// num_xdofs_per_entity)` and the storage is row-major.
+/// @param[in] permute If `true`, permute the DOFs such that they are
+/// consistent with the orientation of `dim`-dimensional mesh entities.
+/// This requires `create_entity_permutations` to be called first.
+/// @param[in] num_threads Number of threads.
+///
+/// @pre The mesh connectivities `dim -> mesh.topology().dim()` and
+/// `mesh.topology().dim() -> dim` must have been computed. Otherwise an
+/// exception is thrown.
+template <std::floating_point T>
+void entities_to_geometry(const Mesh<T>& mesh, int dim,
+                          std::span<const std::int32_t> entities,
+                          std::span<std::int32_t> entity_xdofs,
+                          bool permute = false, int num_threads = 1)
+{
+  const fem::ElementDofLayout layout
+      = mesh.geometry().cmap().create_dof_layout();
+  const std::size_t num_entity_dofs = layout.num_entity_closure_dofs(dim);
+  if (entity_xdofs.size() != entities.size() * num_entity_dofs)
+    throw std::runtime_error("Output array has the wrong size.");
+
+  impl::for_each_entity_geometry(
+      mesh, dim, entities, permute, num_threads,
+      [&](std::size_t i, std::span<const std::int32_t> nodes)
+      {
+        std::ranges::copy(nodes,
+                          std::next(entity_xdofs.begin(), i * num_entity_dofs));
+      });
+}
+
 /// @brief Compute the geometry degrees of freedom associated with
 /// the closure of a given set of cell entities.
 ///
@@ -635,109 +1091,133 @@ entities_to_geometry(const Mesh<T>& mesh, int dim,
                      std::span<const std::int32_t> entities,
                      bool permute = false)
 {
-  auto topology = mesh.topology();
-  assert(topology);
-  CellType cell_type = topology->cell_type();
-  if (cell_type == CellType::prism and dim == 2)
-    throw std::runtime_error("More work needed for prism cells");
-
-  const int tdim = topology->dim();
-  const Geometry<T>& geometry = mesh.geometry();
-  auto xdofs = geometry.dofmap();
-
-  // Get the DOF layout and the number of DOFs per entity
-  const fem::CoordinateElement<T>& coord_ele = geometry.cmap();
-  const fem::ElementDofLayout layout = coord_ele.create_dof_layout();
-  const std::size_t num_entity_dofs = layout.num_entity_closure_dofs(dim);
-  std::vector<std::int32_t> entity_xdofs;
-  entity_xdofs.reserve(entities.size() * num_entity_dofs);
-
-  // Get the element's closure DOFs
-  const std::vector<std::vector<std::vector<int>>>& closure_dofs_all
-      = layout.entity_closure_dofs_all();
-
-  // Special case when dim == tdim (cells)
-  if (dim == tdim)
-  {
-    for (std::size_t i = 0; i < entities.size(); ++i)
-    {
-      const std::int32_t c = entities[i];
-      // Extract degrees of freedom
-      auto x_c = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-          xdofs, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-      for (std::int32_t entity_dof : closure_dofs_all[tdim][0])
-        entity_xdofs.push_back(x_c[entity_dof]);
-    }
-    return entity_xdofs;
-  }
-
-  assert(dim != tdim);
-
-  auto e_to_c = topology->connectivity(dim, tdim);
-  if (!e_to_c)
-  {
-    throw std::runtime_error(
-        "Entity-to-cell connectivity has not been computed. Missing dims "
-        + std::to_string(dim) + "->" + std::to_string(tdim));
-  }
-
-  auto c_to_e = topology->connectivity(tdim, dim);
-  if (!c_to_e)
-  {
-    throw std::runtime_error(
-        "Cell-to-entity connectivity has not been computed. Missing dims "
-        + std::to_string(tdim) + "->" + std::to_string(dim));
-  }
-
-  // Get the cell info, which is needed to permute the closure dofs
-  std::span<const std::uint32_t> cell_info;
-  if (permute)
-    cell_info = std::span(mesh.topology()->get_cell_permutation_info());
-
-  for (std::size_t i = 0; i < entities.size(); ++i)
-  {
-    const std::int32_t e = entities[i];
-
-    // Get a cell connected to the entity
-    assert(!e_to_c->links(e).empty());
-    std::int32_t c = e_to_c->links(e).front();
-
-    // Get the local index of the entity
-    std::span<const std::int32_t> cell_entities = c_to_e->links(c);
-    auto it = std::find(cell_entities.begin(), cell_entities.end(), e);
-    assert(it != cell_entities.end());
-    std::size_t local_entity = std::distance(cell_entities.begin(), it);
-
-    std::vector<std::int32_t> closure_dofs(closure_dofs_all[dim][local_entity]);
-
-    // Cell sub-entities must be permuted so that their local orientation agrees
-    // with their global orientation
-    if (permute)
-    {
-      mesh::CellType entity_type
-          = mesh::cell_entity_type(cell_type, dim, local_entity);
-      coord_ele.permute_subentity_closure(closure_dofs, cell_info[c],
-                                          entity_type, local_entity);
-    }
-
-    // Extract degrees of freedom
-    auto x_c = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        xdofs, c, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    for (std::int32_t entity_dof : closure_dofs)
-      entity_xdofs.push_back(x_c[entity_dof]);
-  }
-
+  const fem::ElementDofLayout layout
+      = mesh.geometry().cmap().create_dof_layout();
+  std::vector<std::int32_t> entity_xdofs(
+      entities.size() * layout.num_entity_closure_dofs(dim));
+  entities_to_geometry(mesh, dim, entities, std::span(entity_xdofs), permute);
   return entity_xdofs;
 }
 
 /// Create a function that computes destination rank for mesh cells in
 /// this rank by applying the default graph partitioner to the dual
 /// graph of the mesh
+/// @param[in] ghost_mode Type of cell ghosting.
+/// @param[in] partfn Graph partitioner.
+/// @param[in] ghost_layers Number of layers of ghost cells when
+/// ghosting. Cells within `ghost_layers` facet-neighbour steps of an
+/// owned cell are ghosted (see graph::extend_ghost_layers).
 /// @return Function that computes the destination ranks for each cell
 CellPartitionFunction create_cell_partitioner(mesh::GhostMode ghost_mode
                                               = mesh::GhostMode::none,
                                               const graph::partition_fn& partfn
-                                              = &graph::partition_graph);
+                                              = &graph::partition_graph,
+                                              int ghost_layers = 1);
+
+/// @brief Create a function that computes destination ranks for mesh
+/// cells by applying a weighted graph partitioner to the dual graph of
+/// the mesh.
+///
+/// The weights of the cells are the node weights of the dual graph.
+/// A cost model can weight cells by, for example, their cell type and
+/// the degree of the finite element that is used on them.
+///
+/// @param[in] ghost_mode Type of cell ghosting.
+/// @param[in] partfn Graph partitioner with node weights.
+/// @param[in] weight_fn Function that computes the weight of each cell.
+/// @param[in] ghost_layers Number of layers of ghost cells when
+/// ghosting.
+/// @return Function that computes the destination ranks for each cell
+CellPartitionFunction
+create_cell_partitioner(mesh::GhostMode ghost_mode,
+                        const graph::weighted_partition_fn& partfn,
+                        const CellWeightFunction& weight_fn,
+                        int ghost_layers = 1);
+
+/// @brief Create a function that sends mesh cells to precomputed
+/// owning ranks, e.g. a partition stored with the mesh in a file.
+///
+/// No graph partitioning is performed. When ghosting, the ghost
+/// destinations of a cell are the owning ranks of its neighbours in
+/// the dual graph.
+///
+/// @param[in] ghost_mode Type of cell ghosting.
+/// @param[in] owners Owning rank of each cell on the calling process,
+/// in the order of the cells passed to the partitioner.
+/// @return Function that computes the destination ranks for each cell
+CellPartitionFunction
+create_precomputed_cell_partitioner(GhostMode ghost_mode,
+                                    std::vector<std::int32_t> owners);
+
+/// @brief Create a function that computes destination ranks for mesh
+/// cells by splitting a Hilbert curve through the cell midpoints.
+///
+/// No graph partitioning library is required, and the partitioner is
+/// much cheaper than a graph partitioner at large process counts, e.g.
+/// to compute an initial distribution that is improved by
+/// redistribute. See graph::geometric::partition.
+///
+/// The cell midpoints are computed from the coordinates of the cell
+/// vertices, which are fetched from the input node coordinates that
+/// are passed to create_mesh.
+///
+/// @param[in] ghost_mode Type of cell ghosting.
+/// @param[in] x Input node coordinates (row-major), distributed across
+/// the same communicator as the cells. The data must remain valid
+/// while the partitioner is used.
+/// @param[in] xshape Shape of `x`.
+/// @return Function that computes the destination ranks for each cell
+template <std::floating_point T>
+CellPartitionFunction
+create_geometric_cell_partitioner(GhostMode ghost_mode, std::span<const T> x,
+                                  std::array<std::size_t, 2> xshape)
+{
+  return [ghost_mode, x, gdim = xshape[1]](
+             MPI_Comm comm, int nparts, const std::vector<CellType>& cell_types,
+             const std::vector<std::span<const std::int64_t>>& cells)
+             -> graph::AdjacencyList<std::int32_t>
+  {
+    DOLFINX_LOG_INFO("Compute geometric partition of cells across ranks");
+
+    // Fetch the coordinates of the cell vertices
+    std::vector<std::int64_t> vertices;
+    for (auto c : cells)
+      vertices.insert(vertices.end(), c.begin(), c.end());
+    std::ranges::sort(vertices);
+    auto [unique_end, range_end] = std::ranges::unique(vertices);
+    vertices.erase(unique_end, range_end);
+    std::vector<T> xv
+        = dolfinx::MPI::distribute_data(comm, vertices, comm, x, gdim);
+
+    // Compute the cell midpoints
+    std::vector<double> midpoints;
+    for (std::size_t i = 0; i < cells.size(); ++i)
+    {
+      const std::size_t num_vertices = num_cell_vertices(cell_types[i]);
+      for (std::size_t c = 0; c < cells[i].size(); c += num_vertices)
+      {
+        std::array<double, 3> m = {0, 0, 0};
+        for (std::int64_t v : cells[i].subspan(c, num_vertices))
+        {
+          auto it = std::ranges::lower_bound(vertices, v);
+          std::size_t pos = std::distance(vertices.begin(), it);
+          for (std::size_t j = 0; j < gdim; ++j)
+            m[j] += xv[pos * gdim + j];
+        }
+        for (double mj : m)
+          midpoints.push_back(mj / num_vertices);
+      }
+    }
+
+    // The dual graph is only required to compute ghost destinations
+    bool ghosting = ghost_mode != GhostMode::none;
+    graph::AdjacencyList<std::int64_t> dual_graph
+        = ghosting ? build_dual_graph(comm, cell_types, cells)
+                   : graph::AdjacencyList<std::int64_t>(0);
+    return graph::geometric::partition(comm, nparts, midpoints, {},
+                                       dual_graph, ghosting);
+  };
+}
 
 /// @brief Compute incident indices
 /// @param[in] topology The topology
@@ -779,6 +1259,13 @@ compute_incident_entities(const Topology& topology,
 /// @param[in] xshape Shape of the `x` data.
 /// @param[in] partitioner Graph partitioner that computes the owning
 /// rank for each cell. If not callable, cells are not redistributed.
+/// @param[in] reorder_fn Function that re-orders the owned cells on each
+/// process, e.g. create_cell_reorderer. The default applies
+/// graph::reorder_gps to the local dual graph. If not callable, cells
+/// are not re-ordered. The geometry nodes are numbered by iterating
+/// over the cells, so they follow the cell ordering.
+/// @param[in] options Entities and data to compute when the mesh is
+/// created. Everything else is computed on demand.
 /// @return A mesh distributed on the communicator `comm`.
 template <typename U>
 Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
@@ -786,8 +1273,13 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
     const fem::CoordinateElement<
         typename std::remove_reference_t<typename U::value_type>>& element,
     MPI_Comm commg, const U& x, std::array<std::size_t, 2> xshape,
-    const CellPartitionFunction& partitioner)
+    const CellPartitionFunction& partitioner,
+    const CellReorderFunction& reorder_fn
+    = [](const graph::AdjacencyList<std::int32_t>& g, std::span<const double>)
+    { return graph::reorder_gps(g); },
+    const MeshSetupOptions& options = {})
 {
+  common::MemoryTracker memory_tracker("Create mesh");
   CellType celltype = element.cell_shape();
   const fem::ElementDofLayout doflayout = element.create_dof_layout();
 
@@ -807,7 +1299,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
   std::vector<int> ghost_owners;
   if (partitioner)
   {
-    spdlog::info("Using partitioner with {} cell data", cells.size());
+    DOLFINX_LOG_INFO("Using partitioner with {} cell data", cells.size());
     graph::AdjacencyList<std::int32_t> dest(0);
     if (commt != MPI_COMM_NULL)
     {
@@ -822,7 +1314,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
     std::size_t num_cells = cells.size() / num_cell_nodes;
     std::tie(cells1, original_idx1, ghost_owners) = graph::build::distribute(
         comm, cells, {num_cells, num_cell_nodes}, dest);
-    spdlog::debug("Got {} cells from distribution", cells1.size());
+    DOLFINX_LOG_DEBUG("Got {} cells from distribution", cells1.size());
   }
   else
   {
@@ -839,8 +1331,18 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
   // and discard any 'higher-order' nodes
   std::vector<std::int64_t> cells1_v
       = extract_topology(celltype, doflayout, cells1);
-  spdlog::info("Extract basic topology: {}->{}", cells1.size(),
-               cells1_v.size());
+  DOLFINX_LOG_INFO("Extract basic topology: {}->{}", cells1.size(),
+                   cells1_v.size());
+
+  // Build list of unique (global) node indices from cells1 and
+  // distribute coordinate data
+  std::vector<std::int64_t> nodes1 = cells1;
+  dolfinx::radix_sort(nodes1);
+  auto [unique_end, range_end] = std::ranges::unique(nodes1);
+  nodes1.erase(unique_end, range_end);
+
+  std::vector coords
+      = dolfinx::MPI::distribute_data(comm, nodes1, commg, x, xshape[1]);
 
   // Build local dual graph for owned cells to (i) get list of vertices
   // on the process boundary and (ii) apply re-ordering to cells for
@@ -852,12 +1354,34 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
     std::vector<std::int32_t> cell_offsets(num_owned_cells + 1, 0);
     for (std::size_t i = 1; i < cell_offsets.size(); ++i)
       cell_offsets[i] = cell_offsets[i - 1] + num_cell_vertices;
-    spdlog::info("Build local dual graph");
+    DOLFINX_LOG_INFO("Build local dual graph");
     auto [graph, unmatched_facets, max_v, facet_attached_cells]
         = build_local_dual_graph(
             std::vector{celltype},
             {std::span(cells1_v.data(), num_owned_cells * num_cell_vertices)});
-    const std::vector<int> remap = graph::reorder_gps(graph);
+    std::vector<std::int32_t> remap(num_owned_cells);
+    if (reorder_fn)
+    {
+      // Compute cell midpoints from the cell nodes
+      std::vector<double> midpoints(3 * num_owned_cells, 0);
+      for (std::int32_t c = 0; c < num_owned_cells; ++c)
+      {
+        for (std::size_t i = 0; i < num_cell_nodes; ++i)
+        {
+          auto it = std::ranges::lower_bound(nodes1,
+                                             cells1[c * num_cell_nodes + i]);
+          std::size_t pos = std::distance(nodes1.begin(), it);
+          for (std::size_t j = 0; j < xshape[1]; ++j)
+            midpoints[3 * c + j] += coords[pos * xshape[1] + j];
+        }
+      }
+      std::ranges::transform(midpoints, midpoints.begin(),
+                             [num_cell_nodes](auto x)
+                             { return x / num_cell_nodes; });
+      remap = reorder_fn(graph, midpoints);
+    }
+    else
+      std::iota(remap.begin(), remap.end(), 0);
 
     // Create re-ordered cell lists (leaves ghosts unchanged)
     std::vector<std::int64_t> _original_idx(original_idx1.size());
@@ -889,22 +1413,19 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
                                       ghost_owners, celltype, boundary_v);
 
   // Create connectivities required higher-order geometries for creating
-  // a Geometry object
+  // a Geometry object, and the requested entities
   for (int e = 1; e < topology.dim(); ++e)
     if (doflayout.num_entity_dofs(e) > 0)
       topology.create_entities(e);
-  if (element.needs_dof_permutations())
+  for (int e : options.entities)
+    topology.create_entities(e);
+  if (element.needs_dof_permutations() or options.entity_permutations)
     topology.create_entity_permutations();
-
-  // Build list of unique (global) node indices from cells1 and
-  // distribute coordinate data
-  std::vector<std::int64_t> nodes1 = cells1;
-  dolfinx::radix_sort(nodes1);
-  auto [unique_end, range_end] = std::ranges::unique(nodes1);
-  nodes1.erase(unique_end, range_end);
-
-  std::vector coords
-      = dolfinx::MPI::distribute_data(comm, nodes1, commg, x, xshape[1]);
+  if (!options.original_cell_index)
+  {
+    for (auto& idx : topology.original_cell_index)
+      std::vector<std::int64_t>().swap(idx);
+  }
 
   // Create geometry object
   Geometry geometry
@@ -926,6 +1447,11 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
 /// @note This is an experimental specialised version of `create_mesh` for mixed
 /// topology meshes, and does not include cell reordering.
 ///
+/// The cells of each type are numbered contiguously, with the index map
+/// `Topology::index_maps(tdim)[i]` for cell type `i`, and the geometry
+/// dofmap `Geometry::dofmap(i)` has the same cell order. Assemblers can
+/// therefore execute one loop for each cell type (see fem::CellGroup).
+///
 /// @param[in] comm Communicator to build the mesh on.
 /// @param[in] commt Communicator that the topology data (`cells`) is
 /// distributed on. This should be `MPI_COMM_NULL` for ranks that should
@@ -957,6 +1483,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
     MPI_Comm commg, const U& x, std::array<std::size_t, 2> xshape,
     const CellPartitionFunction& partitioner)
 {
+  common::MemoryTracker memory_tracker("Create mesh");
   assert(cells.size() == elements.size());
   std::int32_t num_cell_types = cells.size();
   std::vector<CellType> celltypes;
@@ -979,8 +1506,8 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
   std::vector<std::vector<int>> ghost_owners(num_cell_types);
   if (partitioner)
   {
-    spdlog::info("Using partitioner with cell data ({} cell types)",
-                 num_cell_types);
+    DOLFINX_LOG_INFO("Using partitioner with cell data ({} cell types)",
+                     num_cell_types);
     graph::AdjacencyList<std::int32_t> dest(0);
     if (commt != MPI_COMM_NULL)
     {
@@ -1020,7 +1547,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
       std::tie(cells1[i], original_idx1[i], ghost_owners[i])
           = graph::build::distribute(comm, cells[i],
                                      {num_cells, num_cell_nodes}, dest_i);
-      spdlog::debug("Got {} cells from distribution", cells1[i].size());
+      DOLFINX_LOG_DEBUG("Got {} cells from distribution", cells1[i].size());
     }
   }
   else
@@ -1052,8 +1579,8 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
   for (std::int32_t i = 0; i < num_cell_types; ++i)
   {
     cells1_v[i] = extract_topology(celltypes[i], doflayouts[i], cells1[i]);
-    spdlog::info("Extract basic topology: {}->{}", cells1[i].size(),
-                 cells1_v[i].size());
+    DOLFINX_LOG_INFO("Extract basic topology: {}->{}", cells1[i].size(),
+                     cells1_v[i].size());
   }
 
   // Build local dual graph for owned cells to (i) get list of vertices
@@ -1071,7 +1598,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
       cells1_v_local_cells.push_back(
           std::span(cells1_v[i].data(), num_owned_cells * num_cell_vertices));
     }
-    spdlog::info("Build local dual graph");
+    DOLFINX_LOG_INFO("Build local dual graph");
     auto [graph, unmatched_facets, max_v, facet_attached_cells]
         = build_local_dual_graph(celltypes, cells1_v_local_cells);
 
@@ -1090,7 +1617,7 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
       boundary_v.erase(boundary_v.begin());
   }
 
-  spdlog::debug("Got {} boundary vertices", boundary_v.size());
+  DOLFINX_LOG_DEBUG("Got {} boundary vertices", boundary_v.size());
 
   // Create Topology
 
@@ -1159,23 +1686,150 @@ Mesh<typename std::remove_reference_t<typename U::value_type>> create_mesh(
 /// for a detailed description.
 /// @param[in] xshape The shape of `x`. It should be `(num_points, gdim)`.
 /// @param[in] ghost_mode The requested type of cell ghosting/overlap
+/// @param[in] options Entities and data to compute when the mesh is
+/// created. Everything else is computed on demand.
 /// @return A mesh distributed on the communicator `comm`.
 template <typename U>
 Mesh<typename std::remove_reference_t<typename U::value_type>>
 create_mesh(MPI_Comm comm, std::span<const std::int64_t> cells,
             const fem::CoordinateElement<
                 std::remove_reference_t<typename U::value_type>>& elements,
-            const U& x, std::array<std::size_t, 2> xshape, GhostMode ghost_mode)
+            const U& x, std::array<std::size_t, 2> xshape, GhostMode ghost_mode,
+            const MeshSetupOptions& options = {})
 {
+  auto reorder_fn
+      = [](const graph::AdjacencyList<std::int32_t>& g, std::span<const double>)
+  { return graph::reorder_gps(g); };
   if (dolfinx::MPI::size(comm) == 1)
-    return create_mesh(comm, comm, cells, elements, comm, x, xshape, nullptr);
+  {
+    return create_mesh(comm, comm, cells, elements, comm, x, xshape, nullptr,
+                       reorder_fn, options);
+  }
   else
   {
     return create_mesh(comm, comm, cells, elements, comm, x, xshape,
-                       create_cell_partitioner(ghost_mode));
+                       create_cell_partitioner(ghost_mode), reorder_fn,
+                       options);
   }
 }
 
+/// @brief Redistribute a mesh across processes using cell weights.
+///
+/// The dual graph of the owned cells is partitioned using a graph
+/// partitioner with the cell weights as node weights, and a new mesh is
+/// created with the cells and geometry migrated to their new owning
+/// ranks. The original cell indices and the input global indices of
+/// the geometry nodes of `mesh` are preserved.
+///
+/// Cell data, e.g. mesh::MeshTags (see mesh::migrate_meshtags) or
+/// cell-wise Function data, can be migrated to the new mesh using the
+/// returned cell map with MPI::distribute_data.
+///
+/// @note This function is collective.
+/// @note Only meshes with a single cell type are supported.
+///
+/// @param[in] mesh Mesh to redistribute.
+/// @param[in] cell_weights Weight of each owned cell of `mesh`, e.g.
+/// the computational cost of the cell.
+/// @param[in] ghost_mode Ghost mode of the redistributed mesh.
+/// @param[in] partfn Graph partitioner with node weights.
+/// @return The redistributed mesh and, for each cell (owned and ghost)
+/// of the redistributed mesh, the global index of the cell in the cell
+/// index map of `mesh`.
+template <std::floating_point T>
+std::pair<Mesh<T>, std::vector<std::int64_t>>
+redistribute(const Mesh<T>& mesh, std::span<const std::int32_t> cell_weights,
+             GhostMode ghost_mode = GhostMode::none,
+             const graph::weighted_partition_fn& partfn
+             = &graph::partition_graph_weighted)
+{
+  std::shared_ptr<const Topology> topology = mesh.topology();
+  assert(topology);
+  if (topology->entity_types(topology->dim()).size() != 1)
+  {
+    throw std::runtime_error(
+        "Redistribution of mixed-topology meshes is not supported.");
+  }
+
+  const int tdim = topology->dim();
+  const std::int32_t num_cells = topology->index_map(tdim)->size_local();
+  if ((std::int32_t)cell_weights.size() != num_cells)
+    throw std::runtime_error("Number of cell weights and cells differ.");
+
+  // Define the owned cells by the global indices of their geometry
+  // nodes
+  const Geometry<T>& geometry = mesh.geometry();
+  auto x_map = geometry.index_map();
+  auto x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.extent(1);
+  std::vector<std::int64_t> cells(num_cells * num_dofs_g);
+  x_map->local_to_global(
+      std::span(x_dofmap.data_handle(), num_cells * num_dofs_g), cells);
+
+  // Coordinates of the owned geometry nodes, in the order of their
+  // global indices
+  const int gdim = geometry.dim();
+  const std::int32_t num_nodes = x_map->size_local();
+  std::span<const T> x = geometry.x();
+  std::vector<T> x_owned(num_nodes * gdim);
+  for (std::int32_t i = 0; i < num_nodes; ++i)
+    for (int j = 0; j < gdim; ++j)
+      x_owned[i * gdim + j] = x[3 * i + j];
+
+  // The input cells passed to the partitioner are the owned cells, so
+  // the weights of the owned cells are the cell weights
+  CellPartitionFunction partitioner = create_cell_partitioner(
+      ghost_mode, partfn,
+      [cell_weights](const std::vector<CellType>&,
+                     const std::vector<std::span<const std::int64_t>>&)
+      { return std::vector<std::int32_t>(cell_weights.begin(),
+                                         cell_weights.end()); });
+
+  MPI_Comm comm = mesh.comm();
+  Mesh<T> mesh1 = create_mesh(
+      comm, comm, cells, geometry.cmap(), comm, x_owned,
+      {static_cast<std::size_t>(num_nodes), static_cast<std::size_t>(gdim)},
+      partitioner);
+
+  // The 'original' index of a cell of the new mesh is the position of
+  // the cell in the input data, which is the global index of the cell
+  // in `mesh`
+  std::shared_ptr<Topology> topology1 = mesh1.topology_mutable();
+  std::vector<std::int64_t> cell_map = topology1->original_cell_index.front();
+
+  // Restore the original cell indices of `mesh`
+  if (!topology->original_cell_index.empty()
+      and (std::int32_t)topology->original_cell_index.front().size()
+              >= num_cells)
+  {
+    std::vector<std::int64_t> original_idx(
+        topology->original_cell_index.front().begin(),
+        std::next(topology->original_cell_index.front().begin(), num_cells));
+    topology1->original_cell_index.front() = dolfinx::MPI::distribute_data(
+        comm, cell_map, comm, original_idx, 1);
+  }
+
+  // Restore the input global indices of the geometry nodes of `mesh`
+  const Geometry<T>& geometry1 = mesh1.geometry();
+  std::vector<std::int64_t> igi(
+      geometry.input_global_indices().begin(),
+      std::next(geometry.input_global_indices().begin(), num_nodes));
+  std::vector<std::int64_t> igi1 = dolfinx::MPI::distribute_data(
+      comm, geometry1.input_global_indices(), comm, igi, 1);
+  auto x_dofmap1 = geometry1.dofmap();
+  Geometry<T> geometry2(
+      geometry1.index_map(),
+      std::vector<std::int32_t>(x_dofmap1.data_handle(),
+                                x_dofmap1.data_handle() + x_dofmap1.size()),
+      geometry1.cmap(),
+      std::vector<T>(geometry1.x().begin(), geometry1.x().end()), gdim,
+      std::move(igi1));
+
+  Mesh<T> mesh2(comm, topology1, std::move(geometry2));
+  mesh2.name = mesh.name;
+  return {std::move(mesh2), std::move(cell_map)};
+}
+
 /// @brief Create a sub-geometry from a mesh and a subset of mesh entities to
 /// be included. A sub-geometry is simply a `Geometry` object containing only
 /// the geometric information for the subset of entities. The entities may
@@ -1229,21 +1883,12 @@ create_subgeometry(const Mesh<T>& mesh, int dim,
                 std::next(sub_x.begin(), 3 * i));
   }
 
-  // Create geometry to sub-geometry  map
-  std::vector<std::int32_t> x_to_subx_dof_map(
-      x_index_map->size_local() + x_index_map->num_ghosts(), -1);
-  for (std::size_t i = 0; i < subx_to_x_dofmap.size(); ++i)
-    x_to_subx_dof_map[subx_to_x_dofmap[i]] = i;
-
-  // Create sub-geometry dofmap
-  std::vector<std::int32_t> sub_x_dofmap;
-  sub_x_dofmap.reserve(x_indices.size());
-  std::ranges::transform(x_indices, std::back_inserter(sub_x_dofmap),
-                         [&x_to_subx_dof_map](auto x_dof)
-                         {
-                           assert(x_to_subx_dof_map[x_dof] != -1);
-                           return x_to_subx_dof_map[x_dof];
-                         });
+  // Create sub-geometry dofmap by renumbering the geometry dofs of the
+  // entities in place
+  std::vector<std::int32_t> sub_x_dofmap = std::move(x_indices);
+  impl::parent_to_sub_indices(
+      subx_to_x_dofmap, x_index_map->size_local() + x_index_map->num_ghosts(),
+      sub_x_dofmap);
 
   // Create sub-geometry coordinate element
   CellType sub_coord_cell
@@ -0,0 +1,434 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace dolfinx::nls
+{
+
+/// @brief Line search strategies for NewtonSolver.
+enum class LineSearch : int
+{
+  none = 0,           /*!< Full (relaxed) Newton step */
+  backtracking = 1,   /*!< Backtracking until the residual norm decreases
+                         sufficiently (Armijo condition) */
+  critical_point = 2, /*!< Secant iterations for a critical point of
+                         \f$\|F(x - \lambda \delta x)\|^{2}\f$ */
+};
+
+/// @brief A Newton solver for nonlinear systems of equations of the
+/// form \f$F(x) = 0\f$ that does not depend on PETSc.
+///
+/// The solver works with la::Vector (or a vector type with the same
+/// interface), any Jacobian operator type and a user-provided linear
+/// solver. For example, the Jacobian may be a la::MatrixCSR assembled
+/// with fem::assemble_matrix, and the linear solver may be one of the
+/// Krylov solvers in la/krylov.h. It can be used with single
+/// precision types.
+///
+/// @tparam V Vector type
+/// @tparam Mat Jacobian operator type
+template <class V, class Mat = la::MatrixCSR<typename V::value_type>>
+class NewtonSolver
+{
+public:
+  /// Scalar type
+  using value_type = typename V::value_type;
+
+  /// Real type of the norms
+  using real_type = dolfinx::scalar_value_type_t<value_type>;
+
+  /// @brief Create a nonlinear solver.
+  NewtonSolver() = default;
+
+  /// @brief Set the function for computing the residual and the vector
+  /// to assemble the residual into.
+  /// @param[in] F Function to compute the residual vector b (x, b)
+  /// @param[in] b The vector to assemble the residual into. It must
+  /// outlive the solver.
+  void setF(std::function<void(const V&, V&)> F, V& b)
+  {
+    _fnF = F;
+    _b = &b;
+  }
+
+  /// @brief Set the function for computing the Jacobian (dF/dx) and the
+  /// operator to assemble the Jacobian into.
+  /// @param[in] J Function to compute the Jacobian (x, J)
+  /// @param[in] Jmat The Jacobian operator. It must outlive the
+  /// solver.
+  void setJ(std::function<void(const V&, Mat&)> J, Mat& Jmat)
+  {
+    _fnJ = J;
+    _matJ = &Jmat;
+  }
+
+  /// @brief Set the linear solver for the Newton updates.
+  /// @param[in] solver Function that solves `J dx = b` for `dx`
+  /// (J, b, dx) and returns the number of iterations (0 for a direct
+  /// solver). `dx` holds the previous update on entry.
+  void set_linear_solver(std::function<int(Mat&, const V&, V&)> solver)
+  {
+    _solver = solver;
+  }
+
+  /// @brief Set the function that is called before the residual or
+  /// Jacobian are computed. It is commonly used to update ghost values.
+  /// @param[in] form The function to call. It takes the latest solution
+  /// vector `x` as an argument.
+  void set_form(std::function<void(V&)> form) { _system = form; }
+
+  /// @brief Set function that is called at the end of each Newton
+  /// iteration to test for convergence.
+  /// @param[in] c The function that tests for convergence
+  void set_convergence_check(
+      std::function<std::pair<real_type, bool>(const NewtonSolver&, const V&)>
+          c)
+  {
+    _converged = c;
+  }
+
+  /// @brief Set function that is called after each Newton iteration to
+  /// update the solution.
+  ///
+  /// With a line search, the function is called with the update
+  /// scaled by the line search step and with `x` reset to the solution
+  /// at the start of the iteration.
+  ///
+  /// @param[in] update The function that updates the solution
+  void set_update(
+      std::function<void(const NewtonSolver& solver, const V&, V&)> update)
+  {
+    _update_solution = update;
+  }
+
+  /// @brief Solve the nonlinear problem \f$F(x) = 0\f$ for given
+  /// \f$F\f$ and Jacobian \f$\dfrac{\partial F}{\partial x}\f$.
+  ///
+  /// @param[in,out] x The vector
+  /// @return (number of Newton iterations, whether iteration converged)
+  std::pair<int, bool> solve(V& x)
+  {
+    // Reset iteration counts
+    _iteration = 0;
+    _krylov_iterations = 0;
+    _residual = -1;
+    _residual0 = 0;
+
+    if (!_fnF)
+    {
+      throw std::runtime_error("Function for computing residual vector has "
+                               "not been provided to the NewtonSolver.");
+    }
+    if (!_fnJ)
+    {
+      throw std::runtime_error("Function for computing Jacobian has not "
+                               "been provided to the NewtonSolver.");
+    }
+    if (!_solver)
+    {
+      throw std::runtime_error(
+          "Linear solver has not been provided to the NewtonSolver.");
+    }
+    if (convergence_criterion != "residual"
+        and convergence_criterion != "incremental")
+    {
+      throw std::runtime_error("Unknown convergence criterion: "
+                               + convergence_criterion);
+    }
+
+    assert(_b);
+    if (!_dx)
+      _dx.emplace(_b->index_map(), _b->bs());
+    if (line_search != LineSearch::none and !_x0)
+    {
+      _x0.emplace(x.index_map(), x.bs());
+      _dx_s.emplace(_b->index_map(), _b->bs());
+    }
+
+    if (_system)
+      _system(x);
+    _fnF(x, *_b);
+
+    // Check convergence
+    bool newton_converged = false;
+    if (convergence_criterion == "residual")
+    {
+      _residual0 = la::norm(*_b);
+      std::tie(_residual, newton_converged) = _converged(*this, *_b);
+    }
+
+    // Start iterations
+    while (!newton_converged and _iteration < max_it)
+    {
+      // Compute Jacobian
+      assert(_matJ);
+      _fnJ(x, *_matJ);
+
+      // Perform linear solve and update total number of Krylov
+      // iterations
+      _krylov_iterations += _solver(*_matJ, *_b, *_dx);
+
+      // Update solution and compute F
+      switch (line_search)
+      {
+      case LineSearch::none:
+        _update_solution(*this, *_dx, x);
+        if (_system)
+          _system(x);
+        _fnF(x, *_b);
+        break;
+      case LineSearch::backtracking:
+        backtracking(x);
+        break;
+      case LineSearch::critical_point:
+        critical_point(x);
+        break;
+      }
+
+      // Increment iteration count
+      ++_iteration;
+
+      // Test for convergence
+      if (convergence_criterion == "residual")
+        std::tie(_residual, newton_converged) = _converged(*this, *_b);
+      else
+      {
+        // Initialize _residual0 with the first update
+        if (_iteration == 1)
+        {
+          _residual0 = la::norm(*_dx);
+          _residual = 1.0;
+        }
+        else
+          std::tie(_residual, newton_converged) = _converged(*this, *_dx);
+      }
+    }
+
+    if (newton_converged)
+    {
+      if (dolfinx::MPI::rank(x.index_map()->comm()) == 0)
+      {
+        DOLFINX_LOG_INFO("Newton solver finished in {} iterations and {} "
+                         "linear solver iterations.",
+                         _iteration, _krylov_iterations);
+      }
+    }
+    else
+    {
+      if (error_on_nonconvergence)
+      {
+        if (_iteration == max_it)
+        {
+          throw std::runtime_error("Newton solver did not converge because "
+                                   "maximum number of iterations reached");
+        }
+        else
+          throw std::runtime_error("Newton solver did not converge");
+      }
+      else
+        spdlog::warn("Newton solver did not converge.");
+    }
+
+    return {_iteration, newton_converged};
+  }
+
+  /// @brief The number of Newton iterations. It can can called by
+  /// functions that check for convergence during a solve.
+  /// @return The number of Newton iterations performed
+  int iteration() const { return _iteration; }
+
+  /// @brief Get number of linear solver iterations elapsed since solve
+  /// started.
+  /// @return Number of iterations.
+  int krylov_iterations() const { return _krylov_iterations; }
+
+  /// @brief Get current residual.
+  /// @return Current residual
+  real_type residual() const { return _residual; }
+
+  /// @brief Return initial residual, \f$\|F(x_{0})\|\f$ for the
+  /// residual criterion and the norm of the first update for the
+  /// incremental criterion.
+  /// @return Initial residual
+  real_type residual0() const { return _residual0; }
+
+  /// Maximum number of iterations
+  int max_it = 50;
+
+  /// Relative tolerance
+  real_type rtol = 1e-9;
+
+  /// Absolute tolerance
+  real_type atol = 1e-10;
+
+  /// Convergence criterion, "residual" or "incremental"
+  std::string convergence_criterion = "residual";
+
+  /// Monitor convergence
+  bool report = true;
+
+  /// Throw error if solver fails to converge
+  bool error_on_nonconvergence = true;
+
+  /// Relaxation parameter
+  real_type relaxation_parameter = 1.0;
+
+  /// Line search strategy
+  LineSearch line_search = LineSearch::none;
+
+  /// Maximum number of line search iterations
+  int line_search_max_it = 10;
+
+  /// Sufficient decrease parameter of the backtracking line search
+  real_type line_search_c = 1e-4;
+
+  /// Smallest step of the backtracking line search, and relative
+  /// change of the step at which the critical point line search stops
+  real_type line_search_min_step = 1.0 / 1024;
+
+private:
+  // Default convergence test: the pair (residual norm, converged)
+  static std::pair<real_type, bool> converged(const NewtonSolver& solver,
+                                              const V& r)
+  {
+    const real_type residual = la::norm(r);
+    const real_type relative_residual = residual / solver.residual0();
+    if (solver.report
+        and dolfinx::MPI::rank(r.index_map()->comm()) == 0)
+    {
+      DOLFINX_LOG_INFO("Newton iteration {}"
+                       ": r (abs) = {} (tol = {}), r (rel) = {} (tol = {})",
+                       solver.iteration(), residual, solver.atol,
+                       relative_residual, solver.rtol);
+    }
+    return {residual, relative_residual < solver.rtol
+                          or residual < solver.atol};
+  }
+
+  // Default update, x -= relaxation_parameter * dx
+  static void update_solution(const NewtonSolver& solver, const V& dx, V& x)
+  {
+    const std::size_t n = x.bs() * x.index_map()->size_local();
+    std::span<value_type> _x = x.mutable_array();
+    std::span<const value_type> _dx = dx.array();
+    for (std::size_t i = 0; i < n; ++i)
+      _x[i] -= solver.relaxation_parameter * _dx[i];
+    x.scatter_fwd();
+  }
+
+  // Set x to x0 updated by the step lambda * dx, and compute F(x)
+  void step(real_type lambda, V& x)
+  {
+    std::ranges::copy(_x0->array(), x.mutable_array().begin());
+    std::ranges::transform(_dx->array(), _dx_s->mutable_array().begin(),
+                           [lambda](auto v) { return lambda * v; });
+    _update_solution(*this, *_dx_s, x);
+    if (_system)
+      _system(x);
+    _fnF(x, *_b);
+  }
+
+  // Halve the step until the residual norm decreases sufficiently
+  void backtracking(V& x)
+  {
+    std::ranges::copy(x.array(), _x0->mutable_array().begin());
+    const real_type norm0 = la::norm(*_b);
+    real_type lambda = 1;
+    for (int i = 0; i < line_search_max_it; ++i)
+    {
+      step(lambda, x);
+      if (la::norm(*_b) <= (1 - line_search_c * lambda) * norm0
+          or lambda / 2 < line_search_min_step)
+      {
+        break;
+      }
+      lambda /= 2;
+    }
+    std::ranges::copy(_dx_s->array(), _dx->mutable_array().begin());
+  }
+
+  // Secant iterations for a root of g(lambda) = F(x - lambda dx) . dx
+  void critical_point(V& x)
+  {
+    std::ranges::copy(x.array(), _x0->mutable_array().begin());
+    real_type lambda0 = 0, lambda = 1;
+    real_type g0 = std::real(la::inner_product(*_dx, *_b));
+    for (int i = 0; i < line_search_max_it; ++i)
+    {
+      // The solution and residual always correspond to lambda on exit
+      step(lambda, x);
+      if (i + 1 == line_search_max_it)
+        break;
+      const real_type g = std::real(la::inner_product(*_dx, *_b));
+      if (g == g0)
+        break;
+      const real_type lambda_new = lambda - g * (lambda - lambda0) / (g - g0);
+      if (!std::isfinite(lambda_new) or lambda_new <= 0
+          or std::abs(lambda_new - lambda) < line_search_min_step * lambda)
+      {
+        break;
+      }
+      lambda0 = lambda;
+      g0 = g;
+      lambda = lambda_new;
+    }
+    std::ranges::copy(_dx_s->array(), _dx->mutable_array().begin());
+  }
+
+  // Function for computing the residual vector
+  std::function<void(const V& x, V& b)> _fnF;
+
+  // Function for computing the Jacobian operator
+  std::function<void(const V& x, Mat& J)> _fnJ;
+
+  // Linear solver (J, b, dx)
+  std::function<int(Mat& J, const V& b, V& dx)> _solver;
+
+  // Function called before the residual and Jacobian function at each
+  // iteration
+  std::function<void(V& x)> _system;
+
+  // Function to check for convergence
+  std::function<std::pair<real_type, bool>(const NewtonSolver& solver,
+                                           const V& r)>
+      _converged = converged;
+
+  // Function to update the solution
+  std::function<void(const NewtonSolver& solver, const V& dx, V& x)>
+      _update_solution = update_solution;
+
+  // Residual vector and Jacobian (not owned)
+  V* _b = nullptr;
+  Mat* _matJ = nullptr;
+
+  // Update, solution at the start of an iteration and scaled update
+  std::optional<V> _dx, _x0, _dx_s;
+
+  // Accumulated number of linear solver iterations since solve began
+  int _krylov_iterations = 0;
+
+  // Number of iterations
+  int _iteration = 0;
+
+  // Most recent residual and initial residual
+  real_type _residual = 0, _residual0 = 0;
+};
+
+} // namespace dolfinx::nls
@@ -10,6 +10,8 @@
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/la/petsc.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 using namespace dolfinx;
@@ -35,10 +37,10 @@ std::pair<double, bool> converged(const nls::petsc::NewtonSolver& solver,
   // Output iteration number and residual
   if (solver.report and dolfinx::MPI::rank(solver.comm()) == 0)
   {
-    spdlog::info("Newton iteration {}"
-                 ": r (abs) = {} (tol = {}), r (rel) = {} (tol = {})",
-                 solver.iteration(), residual, solver.atol, relative_residual,
-                 solver.rtol);
+    DOLFINX_LOG_INFO("Newton iteration {}"
+                     ": r (abs) = {} (tol = {}), r (rel) = {} (tol = {})",
+                     solver.iteration(), residual, solver.atol,
+                     relative_residual, solver.rtol);
   }
 
   // Return true if convergence criterion is met
@@ -68,7 +70,8 @@ void update_solution(const nls::petsc::NewtonSolver& solver, const Vec dx,
 //-----------------------------------------------------------------------------
 nls::petsc::NewtonSolver::NewtonSolver(MPI_Comm comm)
     : _converged(converged), _update_solution(update_solution),
-      _krylov_iterations(0), _iteration(0), _residual(0.0), _residual0(0.0),
+      _krylov_iterations(0), _jacobian_evaluations(0), _iteration(0),
+      _residual(0.0), _residual0(0.0),
       _solver(comm), _dx(nullptr), _comm(comm)
 {
   // Create linear solver if not already created. Default to LU.
@@ -106,6 +109,26 @@ void nls::petsc::NewtonSolver::setJ(std::function<void(const Vec, Mat)> J,
   PetscObjectReference((PetscObject)_matJ);
 }
 //-----------------------------------------------------------------------------
+void nls::petsc::NewtonSolver::setFJ(
+    std::function<void(const Vec, Vec, Mat)> FJ, Vec b, Mat Jmat)
+{
+  _fnFJ = FJ;
+  if (_b != b)
+  {
+    if (_b)
+      VecDestroy(&_b);
+    _b = b;
+    PetscObjectReference((PetscObject)_b);
+  }
+  if (_matJ != Jmat)
+  {
+    if (_matJ)
+      MatDestroy(&_matJ);
+    _matJ = Jmat;
+    PetscObjectReference((PetscObject)_matJ);
+  }
+}
+//-----------------------------------------------------------------------------
 void nls::petsc::NewtonSolver::setP(std::function<void(const Vec, Mat)> P,
                                     Mat Pmat)
 {
@@ -147,24 +170,48 @@ std::pair<int, bool> nls::petsc::NewtonSolver::solve(Vec x)
   // Reset iteration counts
   _iteration = 0;
   _krylov_iterations = 0;
+  _jacobian_evaluations = 0;
   _residual = -1;
 
-  if (!_fnF)
+  if (jacobian_lag < 1 or preconditioner_lag < 1)
+  {
+    throw std::runtime_error(
+        "Jacobian and preconditioner lags must be positive.");
+  }
+
+  if (!_fnF and !_fnFJ)
   {
     throw std::runtime_error("Function for computing residual vector has not "
                              "been provided to the NewtonSolver.");
   }
 
-  if (!_fnJ)
+  if (!_fnJ and !_fnFJ)
   {
     throw std::runtime_error("Function for computing Jacobian has not "
                              "been provided to the NewtonSolver.");
   }
 
-  if (_system)
-    _system(x);
-  assert(_b);
-  _fnF(x, _b);
+  // Compute F, together with the Jacobian if it is required next and a
+  // fused function is available. Returns true if the Jacobian was
+  // computed.
+  auto compute_residual = [&](bool need_jacobian)
+  {
+    if (_system)
+      _system(x);
+    assert(_b);
+    if (_fnFJ and (need_jacobian or !_fnF))
+    {
+      assert(_matJ);
+      _fnFJ(x, _b, _matJ);
+      return true;
+    }
+    else
+    {
+      _fnF(x, _b);
+      return false;
+    }
+  };
+  bool jacobian_current = compute_residual(true);
 
   // Check convergence
   bool newton_converged = false;
@@ -192,15 +239,55 @@ std::pair<int, bool> nls::petsc::NewtonSolver::solve(Vec x)
   if (!_dx)
     MatCreateVecs(_matJ, &_dx, nullptr);
 
+  // Norm of F, needed to decide on Jacobian reuse and for the
+  // Eisenstat-Walker tolerances
+  const bool track_residual = jacobian_lag > 1 or eisenstat_walker;
+  PetscReal normF = 0.0;
+  double contraction = 0.0;
+  if (track_residual)
+    VecNorm(_b, NORM_2, &normF);
+
+  // Krylov solver tolerance, restored after the solve
+  KSP ksp = _solver.ksp();
+  PetscReal ksp_rtol, ksp_atol, ksp_dtol;
+  PetscInt ksp_maxits;
+  KSPGetTolerances(ksp, &ksp_rtol, &ksp_atol, &ksp_dtol, &ksp_maxits);
+  double ew_rtol = ew_rtol0;
+
   // Start iterations
+  int jacobian_age = 0;
   while (!newton_converged and _iteration < max_it)
   {
-    // Compute Jacobian
-    assert(_matJ);
-    _fnJ(x, _matJ);
+    // Compute Jacobian, unless the previous Jacobian can be reused
+    if (_iteration == 0 or jacobian_age >= jacobian_lag
+        or contraction > jacobian_rebuild_contraction)
+    {
+      if (!jacobian_current)
+      {
+        assert(_matJ);
+        if (_fnJ)
+          _fnJ(x, _matJ);
+        else
+        {
+          if (_system)
+            _system(x);
+          _fnFJ(x, _b, _matJ);
+        }
+      }
+
+      if (_fnP)
+        _fnP(x, _matP);
 
-    if (_fnP)
-      _fnP(x, _matP);
+      // Rebuild the preconditioner every preconditioner_lag Jacobians
+      const bool reuse_pc = _jacobian_evaluations % preconditioner_lag != 0;
+      KSPSetReusePreconditioner(ksp, reuse_pc ? PETSC_TRUE : PETSC_FALSE);
+      ++_jacobian_evaluations;
+      jacobian_age = 0;
+    }
+    ++jacobian_age;
+
+    if (eisenstat_walker)
+      KSPSetTolerances(ksp, ew_rtol, ksp_atol, ksp_dtol, ksp_maxits);
 
     // Perform linear solve and update total number of Krylov iterations
     _krylov_iterations += _solver.solve(_dx, _b);
@@ -214,10 +301,25 @@ std::pair<int, bool> nls::petsc::NewtonSolver::solve(Vec x)
     // FIXME: This step is not needed if residual is based on dx and
     //        this has converged.
     // FIXME: But, this function call may update internal variables, etc.
-    // Compute F
-    if (_system)
-      _system(x);
-    _fnF(x, _b);
+    // Compute F, and J if it will not be reused
+    jacobian_current = compute_residual(jacobian_age >= jacobian_lag);
+
+    if (track_residual)
+    {
+      const PetscReal normF_old = normF;
+      VecNorm(_b, NORM_2, &normF);
+      contraction = normF_old > 0.0 ? normF / normF_old : 0.0;
+      if (eisenstat_walker)
+      {
+        // Choice 2 of Eisenstat and Walker (1996), with safeguard
+        double rtol = ew_gamma * std::pow(contraction, ew_alpha);
+        const double rtol_safe = ew_gamma * std::pow(ew_rtol, ew_alpha);
+        if (rtol_safe > 0.1)
+          rtol = std::max(rtol, rtol_safe);
+        ew_rtol = std::min(rtol, ew_rtol_max);
+      }
+    }
+
     // Initialize _residual0
     if (_iteration == 1)
     {
@@ -245,13 +347,17 @@ std::pair<int, bool> nls::petsc::NewtonSolver::solve(Vec x)
       throw std::runtime_error("Unknown convergence criterion string.");
   }
 
+  KSPSetReusePreconditioner(ksp, PETSC_FALSE);
+  if (eisenstat_walker)
+    KSPSetTolerances(ksp, ksp_rtol, ksp_atol, ksp_dtol, ksp_maxits);
+
   if (newton_converged)
   {
     if (dolfinx::MPI::rank(_comm.comm()) == 0)
     {
-      spdlog::info("Newton solver finished in {} iterations and {} linear "
-                   "solver iterations.",
-                   _iteration, _krylov_iterations);
+      DOLFINX_LOG_INFO("Newton solver finished in {} iterations, {} Jacobian "
+                       "computations and {} linear solver iterations.",
+                       _iteration, _jacobian_evaluations, _krylov_iterations);
     }
   }
   else
@@ -278,6 +384,11 @@ int nls::petsc::NewtonSolver::krylov_iterations() const
   return _krylov_iterations;
 }
 //-----------------------------------------------------------------------------
+int nls::petsc::NewtonSolver::jacobian_evaluations() const
+{
+  return _jacobian_evaluations;
+}
+//-----------------------------------------------------------------------------
 int nls::petsc::NewtonSolver::iteration() const { return _iteration; }
 //-----------------------------------------------------------------------------
 double nls::petsc::NewtonSolver::residual() const { return _residual; }
@@ -64,6 +64,24 @@ public:
   /// @param[in] Jmat The matrix to assemble the Jacobian into
   void setJ(std::function<void(const Vec, Mat)> J, Mat Jmat);
 
+  /// @brief Set the function for computing the residual and the
+  /// Jacobian in one evaluation, and the vector and matrix to assemble
+  /// into (optional).
+  ///
+  /// The function is used when the residual and the Jacobian are both
+  /// required at the same solution, typically with a fused assembler
+  /// such as fem::assemble_system, which traverses the cells once. It
+  /// replaces setF and setJ if these are not provided. Since
+  /// convergence is tested after the residual is computed, the
+  /// Jacobian is computed with the last residual even if it is not
+  /// used.
+  ///
+  /// @param[in] FJ Function to compute the residual vector and the
+  /// Jacobian matrix (x, b, J)
+  /// @param[in] b The vector to assemble the residual into
+  /// @param[in] Jmat The matrix to assemble the Jacobian into
+  void setFJ(std::function<void(const Vec, Vec, Mat)> FJ, Vec b, Mat Jmat);
+
   /// @brief Set the function for computing the preconditioner matrix
   /// (optional).
   /// @param[in] P Function to compute the preconditioner matrix b (x, P)
@@ -121,6 +139,10 @@ public:
   /// @return Number of iterations.
   int krylov_iterations() const;
 
+  /// @brief Get number of Jacobian computations since solve started.
+  /// @return Number of Jacobian computations
+  int jacobian_evaluations() const;
+
   /// @brief Get current residual.
   /// @return Current residual
   double residual() const;
@@ -154,6 +176,37 @@ public:
   /// Relaxation parameter
   double relaxation_parameter = 1.0;
 
+  /// Maximum number of Newton iterations for which the Jacobian (and
+  /// the preconditioner matrix) is reused before it is recomputed. The
+  /// default (1) recomputes the Jacobian at every iteration.
+  int jacobian_lag = 1;
+
+  /// A reused Jacobian is recomputed before `jacobian_lag` iterations
+  /// if the residual contraction $\|F(x_{k})\| / \|F(x_{k-1})\|$
+  /// exceeds this value
+  double jacobian_rebuild_contraction = 0.5;
+
+  /// Number of Jacobian computations for which the preconditioner is
+  /// reused before it is rebuilt. The default (1) rebuilds the
+  /// preconditioner whenever the Jacobian is recomputed.
+  int preconditioner_lag = 1;
+
+  /// Adapt the relative tolerance of the Krylov solver at each
+  /// iteration using the Eisenstat-Walker criterion (choice 2)
+  bool eisenstat_walker = false;
+
+  /// Eisenstat-Walker relative tolerance for the first iteration
+  double ew_rtol0 = 0.3;
+
+  /// Eisenstat-Walker maximum relative tolerance
+  double ew_rtol_max = 0.9;
+
+  /// Eisenstat-Walker $\gamma$ parameter
+  double ew_gamma = 1.0;
+
+  /// Eisenstat-Walker $lpha$ parameter
+  double ew_alpha = 1.618033988749895;
+
 private:
   // Function for computing the residual vector. The first argument is
   // the latest solution vector x and the second argument is the
@@ -165,6 +218,10 @@ private:
   // the matrix operator.
   std::function<void(const Vec x, Mat J)> _fnJ;
 
+  // Function for computing the residual vector and the Jacobian
+  // matrix operator at the same solution vector x.
+  std::function<void(const Vec x, Vec b, Mat J)> _fnFJ;
+
   // Function for computing the preconditioner matrix operator. The
   // first argument is the latest solution vector x and the second
   // argument is the matrix operator.
@@ -192,6 +249,9 @@ private:
   // Accumulated number of Krylov iterations since solve began
   int _krylov_iterations;
 
+  // Number of Jacobian computations since solve began
+  int _jacobian_evaluations;
+
   // Number of iterations
   int _iteration;
 
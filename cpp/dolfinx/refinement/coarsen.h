@@ -0,0 +1,191 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "plaza.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace dolfinx::refinement
+{
+/// @brief Coarsen a refined mesh by merging marked child cells back
+/// into their parent cells.
+///
+/// The coarsened mesh is created by refining the parent mesh again,
+/// with only the edges that are split in the refined mesh and that
+/// belong to a parent cell that remains refined. A parent cell is
+/// restored if all of its child cells are marked. The refinement rules
+/// may keep further edges split, so that the coarsened mesh is
+/// conforming.
+///
+/// The parent data returned by this function relates the coarsened
+/// mesh to `mesh0`, as for plaza::refine. Together with the parent
+/// data of `mesh1`, it can be used to transfer data from the refined
+/// to the coarsened mesh.
+///
+/// @note The refined mesh must have been created from `mesh0` by
+/// plaza::refine, without redistribution. The mesh geometry must be
+/// affine.
+///
+/// @param[in] mesh0 Parent mesh. Its edges must have been created.
+/// @param[in] mesh1 Mesh refined from `mesh0`
+/// @param[in] parent_cell Parent cell of each cell of `mesh1`, as
+/// returned by plaza::refine
+/// @param[in] cells Cells of `mesh1` (local indices) that are marked
+/// for coarsening. Ghost cells are ignored.
+/// @param[in] redistribute If `true`, the coarsened mesh is
+/// re-partitioned across MPI ranks
+/// @param[in] option Control the computation of parent facets and
+/// parent cells (with respect to `mesh0`)
+/// @return Coarsened mesh and optional parent cell index, parent facet
+/// indices
+template <std::floating_point T>
+std::tuple<mesh::Mesh<T>, std::vector<std::int32_t>, std::vector<std::int8_t>>
+coarsen(const mesh::Mesh<T>& mesh0, const mesh::Mesh<T>& mesh1,
+        std::span<const std::int32_t> parent_cell,
+        std::span<const std::int32_t> cells, bool redistribute,
+        plaza::Option option)
+{
+  common::Timer timer("Refinement: coarsen");
+  auto topology0 = mesh0.topology();
+  assert(topology0);
+  auto topology1 = mesh1.topology();
+  assert(topology1);
+  const int tdim = topology0->dim();
+  if (topology0->cell_type() != mesh::CellType::triangle
+      and topology0->cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Coarsening only defined for simplices");
+  }
+  if (mesh0.geometry().cmap().degree() != 1
+      or mesh1.geometry().cmap().degree() != 1)
+  {
+    throw std::runtime_error("Coarsening requires an affine geometry");
+  }
+
+  // Parent of each owned refined cell
+  const std::vector<std::int32_t> parent1
+      = compute_parent_cells(*topology1, parent_cell);
+
+  // Count the children, and the marked children, of each parent cell
+  auto map_c0 = topology0->index_map(tdim);
+  assert(map_c0);
+  const std::int32_t num_cells0 = map_c0->size_local() + map_c0->num_ghosts();
+  std::vector<std::int32_t> num_children(num_cells0, 0);
+  for (std::int32_t p : parent1)
+    ++num_children[p];
+  std::vector<std::int32_t> num_marked(num_cells0, 0);
+  {
+    std::vector<std::int8_t> marked(parent1.size(), false);
+    for (std::int32_t c : cells)
+    {
+      if (c < static_cast<std::int32_t>(parent1.size()) and !marked[c])
+      {
+        marked[c] = true;
+        ++num_marked[parent1[c]];
+      }
+    }
+  }
+
+  // Children of each parent cell
+  std::vector<std::int32_t> offsets(num_cells0 + 1, 0);
+  std::partial_sum(num_children.begin(), num_children.end(),
+                   std::next(offsets.begin()));
+  std::vector<std::int32_t> children(parent1.size());
+  {
+    std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+    for (std::size_t c = 0; c < parent1.size(); ++c)
+      children[pos[parent1[c]]++] = c;
+  }
+
+  mesh0.topology_mutable()->create_connectivity(tdim, 1);
+  mesh0.topology_mutable()->create_connectivity(1, 0);
+  auto c_to_v = topology0->connectivity(tdim, 0);
+  assert(c_to_v);
+  auto c_to_e = topology0->connectivity(tdim, 1);
+  assert(c_to_e);
+  auto e_to_v = topology0->connectivity(1, 0);
+  assert(e_to_v);
+  auto x_dofmap0 = mesh0.geometry().dofmap();
+  auto x_dofmap1 = mesh1.geometry().dofmap();
+  std::span<const T> x0 = mesh0.geometry().x();
+  std::span<const T> x1 = mesh1.geometry().x();
+
+  // Keep the split edges of each parent cell that remains refined. An
+  // edge is split if its midpoint is a vertex of a child cell.
+  std::vector<std::int32_t> edges;
+  for (std::int32_t p = 0; p < num_cells0; ++p)
+  {
+    if (num_children[p] < 2 or num_marked[p] == num_children[p])
+      continue;
+
+    auto cell_vertices = c_to_v->links(p);
+    for (std::int32_t e : c_to_e->links(p))
+    {
+      // Edge end points and midpoint
+      auto ev = e_to_v->links(e);
+      std::array<const T*, 2> xe;
+      for (int i = 0; i < 2; ++i)
+      {
+        auto it = std::find(cell_vertices.begin(), cell_vertices.end(), ev[i]);
+        assert(it != cell_vertices.end());
+        std::size_t local = std::distance(cell_vertices.begin(), it);
+        xe[i] = x0.data() + 3 * x_dofmap0(p, local);
+      }
+      std::array<T, 3> xm;
+      T h2 = 0;
+      for (int j = 0; j < 3; ++j)
+      {
+        xm[j] = 0.5 * (xe[0][j] + xe[1][j]);
+        h2 += (xe[1][j] - xe[0][j]) * (xe[1][j] - xe[0][j]);
+      }
+
+      bool split = false;
+      for (std::int32_t i = offsets[p]; i < offsets[p + 1] and !split; ++i)
+      {
+        for (std::size_t k = 0; k < x_dofmap1.extent(1) and !split; ++k)
+        {
+          const T* xv = x1.data() + 3 * x_dofmap1(children[i], k);
+          T d2 = 0;
+          for (int j = 0; j < 3; ++j)
+            d2 += (xv[j] - xm[j]) * (xv[j] - xm[j]);
+          split = d2 < 1e-12 * h2;
+        }
+      }
+      if (split)
+        edges.push_back(e);
+    }
+  }
+  std::ranges::sort(edges);
+  auto [unique_end, range_end] = std::ranges::unique(edges);
+  edges.erase(unique_end, range_end);
+
+  auto [mesh2, parent_cell2, parent_facet2]
+      = plaza::refine(mesh0, edges, redistribute, option);
+
+  const std::int64_t n1 = topology1->index_map(tdim)->size_global();
+  const std::int64_t n2 = mesh2.topology()->index_map(tdim)->size_global();
+  DOLFINX_LOG_INFO("Number of cells decreased from {} to {}.", n1, n2);
+
+  return {std::move(mesh2), std::move(parent_cell2), std::move(parent_facet2)};
+}
+
+} // namespace dolfinx::refinement
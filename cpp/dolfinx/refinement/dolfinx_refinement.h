@@ -3,7 +3,7 @@
 /// @brief Mesh refinement algorithms.
 ///
 /// Methods for refining meshes uniformly, or with markers, using edge
-/// bisection.
+/// bisection, and for coarsening refined meshes.
 namespace dolfinx::refinement
 {
 }
@@ -11,4 +11,6 @@ namespace dolfinx::refinement
 // DOLFINx refinement interface
 
 #include <dolfinx/refinement/refine.h>
+#include <dolfinx/refinement/coarsen.h>
 #include <dolfinx/refinement/interval.h>
+#include <dolfinx/refinement/transfer.h>
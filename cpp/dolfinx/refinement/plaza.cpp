@@ -183,11 +183,10 @@ get_tetrahedra(std::span<const std::int64_t> indices,
 } // namespace
 
 //-----------------------------------------------------------------------------
-void plaza::impl::enforce_rules(MPI_Comm comm,
-                                const graph::AdjacencyList<int>& shared_edges,
-                                std::span<std::int8_t> marked_edges,
-                                const mesh::Topology& topology,
-                                std::span<const std::int32_t> long_edge)
+plaza::impl::PropagationStatistics plaza::impl::enforce_rules(
+    MPI_Comm comm, const graph::AdjacencyList<int>& shared_edges,
+    std::span<std::int8_t> marked_edges, const mesh::Topology& topology,
+    std::span<const std::int32_t> long_edge)
 {
   common::Timer t0("PLAZA: Enforce rules");
 
@@ -198,11 +197,28 @@ void plaza::impl::enforce_rules(MPI_Comm comm,
   assert(map_e);
   auto map_f = topology.index_map(2);
   assert(map_f);
+  const std::int32_t num_edges = map_e->size_local() + map_e->num_ghosts();
   const std::int32_t num_faces = map_f->size_local() + map_f->num_ghosts();
 
   auto f_to_e = topology.connectivity(2, 1);
   assert(f_to_e);
 
+  // Build the faces of each edge, so that only the faces of newly
+  // marked edges are visited
+  std::vector<std::int32_t> e_to_f_offsets(num_edges + 1, 0);
+  for (std::int32_t e : f_to_e->array())
+    ++e_to_f_offsets[e + 1];
+  std::partial_sum(e_to_f_offsets.begin(), e_to_f_offsets.end(),
+                   e_to_f_offsets.begin());
+  std::vector<std::int32_t> e_to_f(e_to_f_offsets.back());
+  {
+    std::vector<std::int32_t> pos(e_to_f_offsets.begin(),
+                                  std::prev(e_to_f_offsets.end()));
+    for (std::int32_t f = 0; f < num_faces; ++f)
+      for (std::int32_t e : f_to_e->links(f))
+        e_to_f[pos[e]++] = f;
+  }
+
   // Get number of neighbors
   int indegree(-1), outdegree(-2), weighted(-1);
   MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
@@ -210,42 +226,58 @@ void plaza::impl::enforce_rules(MPI_Comm comm,
   const int num_neighbors = indegree;
   std::vector<std::vector<std::int32_t>> marked_for_update(num_neighbors);
 
-  std::int32_t update_count = 1;
-  while (update_count > 0)
-  {
-    update_count = 0;
-    update_logical_edgefunction(comm, marked_for_update, marked_edges, *map_e);
-    for (int i = 0; i < num_neighbors; ++i)
-      marked_for_update[i].clear();
+  // Marked edges with faces that have not been checked
+  std::vector<std::int32_t> work;
+  for (std::int32_t e = 0; e < num_edges; ++e)
+    if (marked_edges[e])
+      work.push_back(e);
 
-    for (int f = 0; f < num_faces; ++f)
+  PropagationStatistics stats;
+  while (true)
+  {
+    // Apply the rule locally until no more edges are marked
+    while (!work.empty())
     {
-      const std::int32_t long_e = long_edge[f];
-      if (marked_edges[long_e])
-        continue;
-
-      bool any_marked = false;
-      for (auto edge : f_to_e->links(f))
-        any_marked = any_marked or marked_edges[edge];
-
-      if (any_marked)
+      const std::int32_t e = work.back();
+      work.pop_back();
+      for (std::int32_t i = e_to_f_offsets[e]; i < e_to_f_offsets[e + 1]; ++i)
       {
+        const std::int32_t long_e = long_edge[e_to_f[i]];
         if (!marked_edges[long_e])
         {
           marked_edges[long_e] = true;
+          work.push_back(long_e);
 
           // Add sharing neighbors to update set
           for (int rank : shared_edges.links(long_e))
             marked_for_update[rank].push_back(long_e);
         }
-        ++update_count;
       }
     }
 
-    const std::int32_t update_count_old = update_count;
-    MPI_Allreduce(&update_count_old, &update_count, 1, MPI_INT32_T, MPI_SUM,
-                  comm);
+    // Propagation has finished when no process has newly marked shared
+    // edges. Check this while the edges are exchanged.
+    std::int64_t num_sent = 0;
+    for (auto& edges : marked_for_update)
+      num_sent += edges.size();
+    std::int64_t num_sent_global = 0;
+    MPI_Request request;
+    MPI_Iallreduce(&num_sent, &num_sent_global, 1, MPI_INT64_T, MPI_SUM, comm,
+                   &request);
+
+    work = update_logical_edgefunction(comm, marked_for_update, marked_edges,
+                                       *map_e);
+    for (auto& edges : marked_for_update)
+      edges.clear();
+    ++stats.rounds;
+    stats.bytes_sent += num_sent * sizeof(std::int64_t);
+
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    if (num_sent_global == 0)
+      break;
   }
+
+  return stats;
 }
 //-----------------------------------------------------------------------------
 std::pair<std::array<std::int32_t, 32>, std::size_t>
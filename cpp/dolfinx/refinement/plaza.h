@@ -9,11 +9,14 @@
 #include <cmath>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/utils.h>
+#include <functional>
 #include <span>
 #include <tuple>
 #include <utility>
@@ -137,12 +140,29 @@ get_simplices(std::span<const std::int64_t> indices,
               std::span<const std::int32_t> longest_edge, int tdim,
               bool uniform);
 
-/// Propagate edge markers according to rules (longest edge of each
-/// face must be marked, if any edge of face is marked)
-void enforce_rules(MPI_Comm comm, const graph::AdjacencyList<int>& shared_edges,
-                   std::span<std::int8_t> marked_edges,
-                   const mesh::Topology& topology,
-                   std::span<const std::int32_t> long_edge);
+/// @brief Statistics of the edge marker propagation in enforce_rules.
+struct PropagationStatistics
+{
+  /// Number of rounds of communication
+  int rounds = 0;
+
+  /// Number of bytes of edge markers sent by the calling process
+  std::int64_t bytes_sent = 0;
+};
+
+/// @brief Propagate edge markers according to rules (longest edge of
+/// each face must be marked, if any edge of face is marked).
+///
+/// The rules are applied locally to a fixed point before each exchange
+/// with the neighbouring processes, and only the shared edges that were
+/// marked since the last exchange are sent. The global termination
+/// check overlaps with the exchange.
+///
+/// @return Propagation statistics
+PropagationStatistics enforce_rules(
+    MPI_Comm comm, const graph::AdjacencyList<int>& shared_edges,
+    std::span<std::int8_t> marked_edges, const mesh::Topology& topology,
+    std::span<const std::int32_t> long_edge);
 
 /// @brief Get the longest edge of each face (using local mesh index)
 ///
@@ -151,11 +171,13 @@ void enforce_rules(MPI_Comm comm, const graph::AdjacencyList<int>& shared_edges,
 /// 3D an empty array is returned
 ///
 /// @param[in] mesh The mesh
+/// @param[in] num_threads Number of threads used to compute the edge
+/// lengths and longest edges
 /// @return A tuple (longest edge, edge ratio ok) where longest edge gives the
 /// local index of the longest edge for each face.
 template <std::floating_point T>
 std::pair<std::vector<std::int32_t>, std::vector<std::int8_t>>
-face_long_edge(const mesh::Mesh<T>& mesh)
+face_long_edge(const mesh::Mesh<T>& mesh, int num_threads = 1)
 {
   const int tdim = mesh.topology()->dim();
   // FIXME: cleanup these calls? Some of the happen internally again.
@@ -191,36 +213,40 @@ face_long_edge(const mesh::Mesh<T>& mesh)
   auto map_e = mesh.topology()->index_map(1);
   assert(map_e);
   std::vector<T> edge_length(map_e->size_local() + map_e->num_ghosts());
-  for (std::size_t e = 0; e < edge_length.size(); ++e)
+  auto compute_edge_lengths = [&](std::int32_t e0, std::int32_t e1)
   {
-    // Get first attached cell
-    auto cells = e_to_c->links(e);
-    assert(!cells.empty());
-    auto cell_vertices = c_to_v->links(cells.front());
-    auto edge_vertices = e_to_v->links(e);
-
-    // Find local index of edge vertices in the cell geometry map
-    auto it0 = std::find(cell_vertices.begin(), cell_vertices.end(),
-                         edge_vertices[0]);
-    assert(it0 != cell_vertices.end());
-    const std::size_t local0 = std::distance(cell_vertices.begin(), it0);
-    auto it1 = std::find(cell_vertices.begin(), cell_vertices.end(),
-                         edge_vertices[1]);
-    assert(it1 != cell_vertices.end());
-    const std::size_t local1 = std::distance(cell_vertices.begin(), it1);
-
-    auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
-        x_dofmap, cells.front(), MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
-    std::span<const T, 3> x0(mesh.geometry().x().data() + 3 * x_dofs[local0],
-                             3);
-    std::span<const T, 3> x1(mesh.geometry().x().data() + 3 * x_dofs[local1],
-                             3);
-
-    // Compute length of edge between vertex x0 and x1
-    edge_length[e] = std::sqrt(std::transform_reduce(
-        x0.begin(), x0.end(), x1.begin(), 0.0, std::plus<>(),
-        [](auto x0, auto x1) { return (x0 - x1) * (x0 - x1); }));
-  }
+    for (std::int32_t e = e0; e < e1; ++e)
+    {
+      // Get first attached cell
+      auto cells = e_to_c->links(e);
+      assert(!cells.empty());
+      auto cell_vertices = c_to_v->links(cells.front());
+      auto edge_vertices = e_to_v->links(e);
+
+      // Find local index of edge vertices in the cell geometry map
+      auto it0 = std::find(cell_vertices.begin(), cell_vertices.end(),
+                           edge_vertices[0]);
+      assert(it0 != cell_vertices.end());
+      const std::size_t local0 = std::distance(cell_vertices.begin(), it0);
+      auto it1 = std::find(cell_vertices.begin(), cell_vertices.end(),
+                           edge_vertices[1]);
+      assert(it1 != cell_vertices.end());
+      const std::size_t local1 = std::distance(cell_vertices.begin(), it1);
+
+      auto x_dofs = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+          x_dofmap, cells.front(),
+          MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent);
+      std::span<const T, 3> x0(
+          mesh.geometry().x().data() + 3 * x_dofs[local0], 3);
+      std::span<const T, 3> x1(
+          mesh.geometry().x().data() + 3 * x_dofs[local1], 3);
+
+      // Compute length of edge between vertex x0 and x1
+      edge_length[e] = std::sqrt(std::transform_reduce(
+          x0.begin(), x0.end(), x1.begin(), 0.0, std::plus<>(),
+          [](auto x0, auto x1) { return (x0 - x1) * (x0 - x1); }));
+    }
+  };
 
   // Get longest edge of each face
   auto f_to_v = mesh.topology()->connectivity(2, 0);
@@ -229,42 +255,50 @@ face_long_edge(const mesh::Mesh<T>& mesh)
   assert(f_to_e);
   const std::vector global_indices
       = mesh.topology()->index_map(0)->global_indices();
-  for (int f = 0; f < f_to_v->num_nodes(); ++f)
+  auto compute_long_edges = [&](std::int32_t f0, std::int32_t f1)
   {
-    auto face_edges = f_to_e->links(f);
+    for (std::int32_t f = f0; f < f1; ++f)
+    {
+      auto face_edges = f_to_e->links(f);
 
-    std::int32_t imax = 0;
-    T max_len = 0.0;
-    T min_len = std::numeric_limits<T>::max();
+      std::int32_t imax = 0;
+      T max_len = 0.0;
+      T min_len = std::numeric_limits<T>::max();
 
-    for (int i = 0; i < 3; ++i)
-    {
-      const T e_len = edge_length[face_edges[i]];
-      min_len = std::min(e_len, min_len);
-      if (e_len > max_len)
-      {
-        max_len = e_len;
-        imax = i;
-      }
-      else if (tdim == 3 and e_len == max_len)
+      for (int i = 0; i < 3; ++i)
       {
-        // If edges are the same length, compare global index of
-        // opposite vertex.  Only important so that tetrahedral faces
-        // have a matching refinement pattern across processes.
-        auto vertices = f_to_v->links(f);
-        const int vmax = vertices[imax];
-        const int vi = vertices[i];
-        if (global_indices[vi] > global_indices[vmax])
+        const T e_len = edge_length[face_edges[i]];
+        min_len = std::min(e_len, min_len);
+        if (e_len > max_len)
+        {
+          max_len = e_len;
           imax = i;
+        }
+        else if (tdim == 3 and e_len == max_len)
+        {
+          // If edges are the same length, compare global index of
+          // opposite vertex.  Only important so that tetrahedral faces
+          // have a matching refinement pattern across processes.
+          auto vertices = f_to_v->links(f);
+          const int vmax = vertices[imax];
+          const int vi = vertices[i];
+          if (global_indices[vi] > global_indices[vmax])
+            imax = i;
+        }
       }
-    }
 
-    // Only save edge ratio in 2D
-    if (tdim == 2)
-      edge_ratio_ok[f] = (min_len / max_len >= min_ratio);
+      // Only save edge ratio in 2D
+      if (tdim == 2)
+        edge_ratio_ok[f] = (min_len / max_len >= min_ratio);
 
-    long_edge[f] = face_edges[imax];
-  }
+      long_edge[f] = face_edges[imax];
+    }
+  };
+
+  // Edges, and then faces, are processed in contiguous ranges on
+  // different threads. Each entity is written by one thread only.
+  common::parallel_for(edge_length.size(), num_threads, compute_edge_lengths);
+  common::parallel_for(f_to_v->num_nodes(), num_threads, compute_long_edges);
 
   return std::pair(std::move(long_edge), std::move(edge_ratio_ok));
 }
@@ -290,6 +324,8 @@ face_long_edge(const mesh::Mesh<T>& mesh)
 /// than sqrt(2)/2
 /// @param[in] option Option to compute additional information relating refined
 /// and original mesh entities
+/// @param[in] num_threads Number of threads used to subdivide the cells.
+/// The output does not depend on the number of threads.
 /// @return (0) The new mesh topology, (1) the new flattened mesh geometry, (3)
 /// Shape of the new geometry_shape, (4) Map from new cells to parent cells
 /// and (5) map from refined facets to parent facets.
@@ -303,7 +339,7 @@ compute_refinement(MPI_Comm neighbor_comm,
                    const mesh::Mesh<T>& mesh,
                    std::span<const std::int32_t> long_edge,
                    std::span<const std::int8_t> edge_ratio_ok,
-                   plaza::Option option)
+                   plaza::Option option, int num_threads = 1)
 {
   int tdim = mesh.topology()->dim();
   int num_cell_edges = tdim * 3 - 3;
@@ -317,10 +353,6 @@ compute_refinement(MPI_Comm neighbor_comm,
   const auto [new_vertex_map, new_vertex_coords, xshape]
       = create_new_vertices(neighbor_comm, shared_edges, mesh, marked_edges);
 
-  std::vector<std::int32_t> parent_cell;
-  std::vector<std::int8_t> parent_facet;
-  std::vector<std::int64_t> indices(num_cell_vertices + num_cell_edges);
-  std::vector<std::int32_t> simplex_set;
 
   auto map_c = mesh.topology()->index_map(tdim);
   assert(map_c);
@@ -340,106 +372,153 @@ compute_refinement(MPI_Comm neighbor_comm,
 
   const std::int32_t num_cells = map_c->size_local();
 
-  // Iterate over all cells, and refine if cell has a marked edge
-  std::vector<std::int64_t> cell_topology;
-  for (int c = 0; c < num_cells; ++c)
+  // Refine cells [c0, c1) if they have a marked edge, appending the
+  // new cells to cell_topology and their parent data to parent_cell and
+  // parent_facet
+  auto refine_cells
+      = [&](std::int32_t c0, std::int32_t c1,
+            std::vector<std::int64_t>& cell_topology,
+            std::vector<std::int32_t>& parent_cell,
+            std::vector<std::int8_t>& parent_facet)
   {
-    // Create vector of indices in the order [vertices][edges], 3+3 in
-    // 2D, 4+6 in 3D
-
-    // Copy vertices
-    auto vertices = c_to_v->links(c);
-    for (std::size_t v = 0; v < vertices.size(); ++v)
-      indices[v] = global_indices[vertices[v]];
-
-    // Get cell-local indices of marked edges
-    auto edges = c_to_e->links(c);
-    bool no_edge_marked = true;
-    for (std::size_t ei = 0; ei < edges.size(); ++ei)
-    {
-      if (marked_edges[edges[ei]])
-      {
-        no_edge_marked = false;
-        auto it = new_vertex_map.find(edges[ei]);
-        assert(it != new_vertex_map.end());
-        indices[num_cell_vertices + ei] = it->second;
-      }
-      else
-        indices[num_cell_vertices + ei] = -1;
-    }
-
-    if (no_edge_marked)
-    {
-      // Copy over existing cell to new topology
-      for (auto v : vertices)
-        cell_topology.push_back(global_indices[v]);
-
-      if (compute_parent_cell)
-        parent_cell.push_back(c);
-
-      if (compute_facets)
-      {
-        if (tdim == 3)
-          parent_facet.insert(parent_facet.end(), {0, 1, 2, 3});
-        else
-          parent_facet.insert(parent_facet.end(), {0, 1, 2});
-      }
-    }
-    else
+    std::vector<std::int64_t> indices(num_cell_vertices + num_cell_edges);
+    for (std::int32_t c = c0; c < c1; ++c)
     {
-      // Need longest edges of each face in cell local indexing. NB in
-      // 2D the face is the cell itself, and there is just one entry.
-      std::vector<std::int32_t> longest_edge;
-      for (auto f : c_to_f->links(c))
-        longest_edge.push_back(long_edge[f]);
-
-      // Convert to cell local index
-      for (std::int32_t& p : longest_edge)
-      {
-        for (std::size_t ej = 0; ej < edges.size(); ++ej)
+        // Create vector of indices in the order [vertices][edges], 3+3 in
+        // 2D, 4+6 in 3D
+
+        // Copy vertices
+        auto vertices = c_to_v->links(c);
+        for (std::size_t v = 0; v < vertices.size(); ++v)
+          indices[v] = global_indices[vertices[v]];
+
+        // Get cell-local indices of marked edges
+        auto edges = c_to_e->links(c);
+        bool no_edge_marked = true;
+        for (std::size_t ei = 0; ei < edges.size(); ++ei)
         {
-          if (p == edges[ej])
+          if (marked_edges[edges[ei]])
           {
-            p = ej;
-            break;
+            no_edge_marked = false;
+            auto it = new_vertex_map.find(edges[ei]);
+            assert(it != new_vertex_map.end());
+            indices[num_cell_vertices + ei] = it->second;
           }
+          else
+            indices[num_cell_vertices + ei] = -1;
         }
-      }
 
-      const bool uniform = (tdim == 2) ? edge_ratio_ok[c] : false;
-      const auto [simplex_set_b, simplex_set_size]
-          = get_simplices(indices, longest_edge, tdim, uniform);
-      std::span<const std::int32_t> simplex_set(simplex_set_b.data(),
-                                                simplex_set_size);
+        if (no_edge_marked)
+        {
+          // Copy over existing cell to new topology
+          for (auto v : vertices)
+            cell_topology.push_back(global_indices[v]);
 
-      // Save parent index
-      const std::int32_t ncells = simplex_set.size() / num_cell_vertices;
-      if (compute_parent_cell)
-      {
-        for (std::int32_t i = 0; i < ncells; ++i)
-          parent_cell.push_back(c);
-      }
+          if (compute_parent_cell)
+            parent_cell.push_back(c);
 
-      if (compute_facets)
-      {
-        if (tdim == 3)
-        {
-          auto npf = compute_parent_facets<3>(simplex_set);
-          parent_facet.insert(parent_facet.end(), npf.begin(),
-                              std::next(npf.begin(), simplex_set.size()));
+          if (compute_facets)
+          {
+            if (tdim == 3)
+              parent_facet.insert(parent_facet.end(), {0, 1, 2, 3});
+            else
+              parent_facet.insert(parent_facet.end(), {0, 1, 2});
+          }
         }
         else
         {
-          auto npf = compute_parent_facets<2>(simplex_set);
-          parent_facet.insert(parent_facet.end(), npf.begin(),
-                              std::next(npf.begin(), simplex_set.size()));
-        }
-      }
+          // Need longest edges of each face in cell local indexing. NB in
+          // 2D the face is the cell itself, and there is just one entry.
+          std::vector<std::int32_t> longest_edge;
+          for (auto f : c_to_f->links(c))
+            longest_edge.push_back(long_edge[f]);
+
+          // Convert to cell local index
+          for (std::int32_t& p : longest_edge)
+          {
+            for (std::size_t ej = 0; ej < edges.size(); ++ej)
+            {
+              if (p == edges[ej])
+              {
+                p = ej;
+                break;
+              }
+            }
+          }
+
+          const bool uniform = (tdim == 2) ? edge_ratio_ok[c] : false;
+          const auto [simplex_set_b, simplex_set_size]
+              = get_simplices(indices, longest_edge, tdim, uniform);
+          std::span<const std::int32_t> simplex_set(simplex_set_b.data(),
+                                                    simplex_set_size);
+
+          // Save parent index
+          const std::int32_t ncells = simplex_set.size() / num_cell_vertices;
+          if (compute_parent_cell)
+          {
+            for (std::int32_t i = 0; i < ncells; ++i)
+              parent_cell.push_back(c);
+          }
+
+          if (compute_facets)
+          {
+            if (tdim == 3)
+            {
+              auto npf = compute_parent_facets<3>(simplex_set);
+              parent_facet.insert(parent_facet.end(), npf.begin(),
+                                  std::next(npf.begin(), simplex_set.size()));
+            }
+            else
+            {
+              auto npf = compute_parent_facets<2>(simplex_set);
+              parent_facet.insert(parent_facet.end(), npf.begin(),
+                                  std::next(npf.begin(), simplex_set.size()));
+            }
+          }
 
-      // Convert from cell local index to mesh index and add to cells
-      for (std::int32_t v : simplex_set)
-        cell_topology.push_back(indices[v]);
+          // Convert from cell local index to mesh index and add to cells
+          for (std::int32_t v : simplex_set)
+            cell_topology.push_back(indices[v]);
+        }
     }
+  };
+
+  std::vector<std::int64_t> cell_topology;
+  std::vector<std::int32_t> parent_cell;
+  std::vector<std::int8_t> parent_facet;
+  const int nt = std::max(std::min(num_threads, num_cells), 1);
+  if (nt == 1)
+    refine_cells(0, num_cells, cell_topology, parent_cell, parent_facet);
+  else
+  {
+    // Each thread refines a contiguous range of cells into its own
+    // arrays, which are then concatenated in order (the offset of each
+    // range is the prefix sum of the preceding range sizes). The output
+    // is therefore identical to the serial output.
+    std::vector<std::vector<std::int64_t>> cell_topology_t(nt);
+    std::vector<std::vector<std::int32_t>> parent_cell_t(nt);
+    std::vector<std::vector<std::int8_t>> parent_facet_t(nt);
+    common::run_tasks(nt,
+                      [&](int t)
+                      {
+                        std::array<std::int64_t, 2> range
+                            = dolfinx::MPI::local_range(t, num_cells, nt);
+                        refine_cells(range[0], range[1], cell_topology_t[t],
+                                     parent_cell_t[t], parent_facet_t[t]);
+                      });
+
+    auto concatenate = [](auto& data_t, auto& data)
+    {
+      std::size_t size = 0;
+      for (auto& d : data_t)
+        size += d.size();
+      data.reserve(size);
+      for (auto& d : data_t)
+        data.insert(data.end(), d.begin(), d.end());
+    };
+    concatenate(cell_topology_t, cell_topology);
+    concatenate(parent_cell_t, parent_cell);
+    concatenate(parent_facet_t, parent_facet);
   }
 
   assert(cell_topology.size() % num_cell_vertices == 0);
@@ -462,14 +541,17 @@ compute_refinement(MPI_Comm neighbor_comm,
 /// redistribute after refinement
 /// @param[in] option Control the computation of parent facets, parent
 /// cells. If an option is unselected, an empty list is returned.
+/// @param[in] num_threads Number of threads used to compute the
+/// process-local refinement
 /// @return Refined mesh and optional parent cell index, parent facet
 /// indices
 template <std::floating_point T>
 std::tuple<mesh::Mesh<T>, std::vector<std::int32_t>, std::vector<std::int8_t>>
-refine(const mesh::Mesh<T>& mesh, bool redistribute, Option option)
+refine(const mesh::Mesh<T>& mesh, bool redistribute, Option option,
+       int num_threads = 1)
 {
   auto [cell_adj, new_coords, xshape, parent_cell, parent_facet]
-      = compute_refinement_data(mesh, option);
+      = compute_refinement_data(mesh, option, num_threads);
 
   if (dolfinx::MPI::size(mesh.comm()) == 1)
   {
@@ -509,14 +591,16 @@ refine(const mesh::Mesh<T>& mesh, bool redistribute, Option option)
 /// redistribute after refinement
 /// @param[in] option Control the computation of parent facets, parent
 /// cells. If an option is unselected, an empty list is returned.
+/// @param[in] num_threads Number of threads used to compute the
+/// process-local refinement
 /// @return New Mesh and optional parent cell index, parent facet indices
 template <std::floating_point T>
 std::tuple<mesh::Mesh<T>, std::vector<std::int32_t>, std::vector<std::int8_t>>
 refine(const mesh::Mesh<T>& mesh, std::span<const std::int32_t> edges,
-       bool redistribute, Option option)
+       bool redistribute, Option option, int num_threads = 1)
 {
   auto [cell_adj, new_vertex_coords, xshape, parent_cell, parent_facet]
-      = compute_refinement_data(mesh, edges, option);
+      = compute_refinement_data(mesh, edges, option, num_threads);
 
   if (dolfinx::MPI::size(mesh.comm()) == 1)
   {
@@ -552,6 +636,8 @@ refine(const mesh::Mesh<T>& mesh, std::span<const std::int32_t> edges,
 /// @param[in] mesh Input mesh to be refined
 /// @param[in] option Control computation of parent facets and parent
 /// cells. If an option is unselected, an empty list is returned.
+/// @param[in] num_threads Number of threads used to compute the
+/// longest edges and to subdivide the cells
 /// @return New mesh data: cell topology, vertex coordinates, vertex
 /// coordinates shape, and optional parent cell index, and parent facet
 /// indices.
@@ -559,7 +645,8 @@ template <std::floating_point T>
 std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<T>,
            std::array<std::size_t, 2>, std::vector<std::int32_t>,
            std::vector<std::int8_t>>
-compute_refinement_data(const mesh::Mesh<T>& mesh, Option option)
+compute_refinement_data(const mesh::Mesh<T>& mesh, Option option,
+                        int num_threads = 1)
 {
   common::Timer t0("PLAZA: refine");
   auto topology = mesh.topology();
@@ -599,13 +686,14 @@ compute_refinement_data(const mesh::Mesh<T>& mesh, Option option)
                                  MPI_UNWEIGHTED, ranks.size(), ranks.data(),
                                  MPI_UNWEIGHTED, MPI_INFO_NULL, false, &comm);
 
-  const auto [long_edge, edge_ratio_ok] = impl::face_long_edge(mesh);
+  const auto [long_edge, edge_ratio_ok]
+      = impl::face_long_edge(mesh, num_threads);
   auto [cell_adj, new_vertex_coords, xshape, parent_cell, parent_facet]
       = impl::compute_refinement(
           comm,
           std::vector<std::int8_t>(map_e->size_local() + map_e->num_ghosts(),
                                    true),
-          edge_ranks, mesh, long_edge, edge_ratio_ok, option);
+          edge_ranks, mesh, long_edge, edge_ratio_ok, option, num_threads);
   MPI_Comm_free(&comm);
 
   return {std::move(cell_adj), std::move(new_vertex_coords), xshape,
@@ -619,6 +707,8 @@ compute_refinement_data(const mesh::Mesh<T>& mesh, Option option)
 /// refinement
 /// @param[in] option Control the computation of parent facets, parent
 /// cells. If an option is unselected, an empty list is returned.
+/// @param[in] num_threads Number of threads used to compute the
+/// longest edges and to subdivide the cells
 /// @return New mesh data: cell topology, vertex coordinates and parent
 /// cell index, and stored parent facet indices (if requested).
 template <std::floating_point T>
@@ -626,7 +716,8 @@ std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<T>,
            std::array<std::size_t, 2>, std::vector<std::int32_t>,
            std::vector<std::int8_t>>
 compute_refinement_data(const mesh::Mesh<T>& mesh,
-                        std::span<const std::int32_t> edges, Option option)
+                        std::span<const std::int32_t> edges, Option option,
+                        int num_threads = 1)
 {
   common::Timer t0("PLAZA: refine");
   auto topology = mesh.topology();
@@ -687,12 +778,17 @@ compute_refinement_data(const mesh::Mesh<T>& mesh,
 
   // Enforce rules about refinement (i.e. if any edge is marked in a
   // triangle, then the longest edge must also be marked).
-  const auto [long_edge, edge_ratio_ok] = impl::face_long_edge(mesh);
-  impl::enforce_rules(comm, edge_ranks, marked_edges, *topology, long_edge);
+  const auto [long_edge, edge_ratio_ok]
+      = impl::face_long_edge(mesh, num_threads);
+  impl::PropagationStatistics stats = impl::enforce_rules(
+      comm, edge_ranks, marked_edges, *topology, long_edge);
+  DOLFINX_LOG_INFO("PLAZA: marker propagation in {} rounds ({} bytes sent).",
+                   stats.rounds, stats.bytes_sent);
 
   auto [cell_adj, new_vertex_coords, xshape, parent_cell, parent_facet]
       = impl::compute_refinement(comm, marked_edges, edge_ranks, mesh,
-                                 long_edge, edge_ratio_ok, option);
+                                 long_edge, edge_ratio_ok, option,
+                                 num_threads);
   MPI_Comm_free(&comm);
 
   return {std::move(cell_adj), std::move(new_vertex_coords), xshape,
@@ -9,9 +9,12 @@
 #include "plaza.h"
 #include "refine.h"
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <utility>
+#include <vector>
 
 namespace dolfinx::refinement
 {
@@ -40,7 +43,7 @@ mesh::Mesh<T> refine(const mesh::Mesh<T>& mesh, bool redistribute = true)
   const int D = topology->dim();
   const std::int64_t n0 = topology->index_map(D)->size_global();
   const std::int64_t n1 = refined_mesh.topology()->index_map(D)->size_global();
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Number of cells increased from {} to {} ({}% increase).", n0, n1,
       100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0));
 
@@ -77,11 +80,74 @@ mesh::Mesh<T> refine(const mesh::Mesh<T>& mesh,
   const int D = topology->dim();
   const std::int64_t n0 = topology->index_map(D)->size_global();
   const std::int64_t n1 = refined_mesh.topology()->index_map(D)->size_global();
-  spdlog::info(
+  DOLFINX_LOG_INFO(
       "Number of cells increased from {} to {} ({}% increase).", n0, n1,
       100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0));
 
   return refined_mesh;
 }
 
+/// @brief Create a hierarchy of uniformly refined meshes, e.g. for
+/// geometric multigrid.
+///
+/// Each level is refined from the previous level without
+/// redistribution, so that refined cells remain on the process that
+/// owns their parent. The partition of the input mesh is therefore
+/// shared by all levels, and communication between levels (e.g. by
+/// Transfer) is limited to the ghost region. The edges that are
+/// required for refinement are created once on each intermediate level.
+///
+/// @param[in] mesh Coarsest mesh (level 0). Its edges must have been
+/// created.
+/// @param[in] levels Number of refinements
+/// @param[in] num_threads Number of threads used to compute the
+/// process-local refinement of each level
+/// @return (0) The refined meshes, where entry `i` is level `i + 1`,
+/// and (1) for each refined mesh, the parent cell (in the previous
+/// level) of each cell. The parent cells can be used to create
+/// Transfer operators between levels.
+template <std::floating_point T>
+std::pair<std::vector<mesh::Mesh<T>>, std::vector<std::vector<std::int32_t>>>
+create_hierarchy(const mesh::Mesh<T>& mesh, int levels, int num_threads = 1)
+{
+  common::Timer timer("Refinement: create hierarchy");
+  auto topology = mesh.topology();
+  assert(topology);
+  if (topology->cell_type() != mesh::CellType::triangle
+      and topology->cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Refinement only defined for simplices");
+  }
+  if (levels < 0)
+    throw std::runtime_error("Number of levels must be non-negative.");
+
+  std::vector<mesh::Mesh<T>> meshes;
+  meshes.reserve(levels);
+  std::vector<std::vector<std::int32_t>> parent_cells;
+  parent_cells.reserve(levels);
+  for (int l = 0; l < levels; ++l)
+  {
+    const mesh::Mesh<T>& mesh0 = l == 0 ? mesh : meshes.back();
+    auto [mesh1, parent_cell, parent_facet]
+        = plaza::refine(mesh0, false, plaza::Option::parent_cell, num_threads);
+
+    // Edges are needed to refine the next level
+    if (l + 1 < levels)
+      mesh1.topology_mutable()->create_entities(1);
+
+    meshes.push_back(std::move(mesh1));
+    parent_cells.push_back(std::move(parent_cell));
+  }
+
+  const int D = topology->dim();
+  const std::int64_t n0 = topology->index_map(D)->size_global();
+  const std::int64_t n1
+      = levels > 0 ? meshes.back().topology()->index_map(D)->size_global()
+                   : n0;
+  DOLFINX_LOG_INFO("Created mesh hierarchy with {} levels, {} to {} cells.",
+                   levels + 1, n0, n1);
+
+  return {std::move(meshes), std::move(parent_cells)};
+}
+
 } // namespace dolfinx::refinement
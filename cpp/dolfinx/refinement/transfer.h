@@ -0,0 +1,359 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <basix/finite-element.h>
+#include <basix/mdspan.hpp>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/sparsitybuild.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::refinement
+{
+
+/// @brief Transfer operators between a finite element space on a mesh
+/// and a finite element space on a mesh refined from it.
+///
+/// The prolongation operator \f$P\f$ interpolates a function in the
+/// space \f$V_0\f$ on the parent (coarse) mesh into the space \f$V_1\f$
+/// on the refined (fine) mesh, i.e. \f$u_1 = P u_0\f$. The restriction
+/// operator is \f$P^{T}\f$, e.g. for restricting residuals in geometric
+/// multigrid.
+///
+/// The operators are built from the parent cell of each refined cell.
+/// The interpolation points of a refined cell are mapped into the
+/// reference cell of its parent, so no point ownership computation or
+/// collision detection is required. The element matrices are computed
+/// once, on construction, and are used to assemble \f$P\f$ or to apply
+/// \f$P\f$ and \f$P^{T}\f$ matrix-free.
+///
+/// @note The elements must be defined by point evaluations, e.g.
+/// (discontinuous) Lagrange elements, and not require DOF
+/// transformations. The spaces must have the same block size and the
+/// parent mesh must be affine. The refined mesh must not have been
+/// redistributed during refinement.
+template <std::floating_point T>
+class Transfer
+{
+public:
+  /// @brief Compute the transfer element matrices.
+  /// @param[in] V0 Space on the parent mesh
+  /// @param[in] V1 Space on the refined mesh
+  /// @param[in] parent_cell Parent cell of each cell of the refined
+  /// mesh, as returned by plaza::refine with Option::parent_cell
+  Transfer(std::shared_ptr<const fem::FunctionSpace<T>> V0,
+           std::shared_ptr<const fem::FunctionSpace<T>> V1,
+           std::span<const std::int32_t> parent_cell)
+      : _V0(V0), _V1(V1)
+  {
+    assert(V0);
+    assert(V1);
+    auto mesh0 = V0->mesh();
+    assert(mesh0);
+    auto mesh1 = V1->mesh();
+    assert(mesh1);
+    auto e0 = V0->element();
+    assert(e0);
+    auto e1 = V1->element();
+    assert(e1);
+
+    if (e0->is_mixed() or e1->is_mixed())
+      throw std::runtime_error("Transfer of mixed spaces is not supported.");
+    if (e0->needs_dof_transformations() or e1->needs_dof_transformations())
+    {
+      throw std::runtime_error("Transfer of spaces with elements that require "
+                               "DOF transformations is not supported.");
+    }
+    if (!e1->interpolation_ident()
+        or e0->map_type() != basix::maps::type::identity)
+    {
+      throw std::runtime_error(
+          "Transfer is only supported for point evaluation elements.");
+    }
+    _bs = e0->block_size();
+    if (e1->block_size() != _bs or e0->reference_value_size() != _bs
+        or e1->reference_value_size() != _bs)
+    {
+      throw std::runtime_error("Transfer spaces have incompatible values.");
+    }
+
+    const fem::CoordinateElement<T>& cmap0 = mesh0->geometry().cmap();
+    const fem::CoordinateElement<T>& cmap1 = mesh1->geometry().cmap();
+    if (!cmap0.is_affine())
+      throw std::runtime_error("Transfer requires an affine parent mesh.");
+
+    // Parent of each owned refined cell
+    const int tdim = mesh1->topology()->dim();
+    _cells0 = compute_parent_cells(*mesh1->topology(), parent_cell);
+    _cells1.resize(_cells0.size());
+    std::iota(_cells1.begin(), _cells1.end(), 0);
+
+    // Interpolation points of V1 on the reference cell
+    const auto [X1, X1shape] = e1->interpolation_points();
+    _num_points = X1shape[0];
+    _dim0 = e0->space_dimension() / _bs;
+    assert(_num_points * _bs == std::size_t(e1->space_dimension()));
+
+    using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+    using cmdspan4_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        const T, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 4>>;
+
+    // Refined cell geometry basis at the interpolation points
+    std::array<std::size_t, 4> phi1_shape
+        = cmap1.tabulate_shape(0, _num_points);
+    std::vector<T> phi1_b(std::reduce(phi1_shape.begin(), phi1_shape.end(),
+                                      1, std::multiplies{}));
+    cmap1.tabulate(0, X1, X1shape, phi1_b);
+    cmdspan4_t phi1_full(phi1_b.data(), phi1_shape);
+    auto phi1 = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        phi1_full, 0, MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+
+    // Parent cell geometry basis derivatives (constant for an affine
+    // map)
+    std::vector<T> X0_origin(tdim, 0);
+    std::array<std::size_t, 4> phi0_shape = cmap0.tabulate_shape(1, 1);
+    std::vector<T> phi0_b(std::reduce(phi0_shape.begin(), phi0_shape.end(),
+                                      1, std::multiplies{}));
+    cmap0.tabulate(1, X0_origin, {1, std::size_t(tdim)}, phi0_b);
+    cmdspan4_t phi0_full(phi0_b.data(), phi0_shape);
+    auto dphi0 = MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+        phi0_full, std::pair(1, tdim + 1), 0,
+        MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent, 0);
+
+    // Geometry data
+    const int gdim = mesh1->geometry().dim();
+    auto x_dofmap0 = mesh0->geometry().dofmap();
+    auto x_dofmap1 = mesh1->geometry().dofmap();
+    std::span<const T> x_g0 = mesh0->geometry().x();
+    std::span<const T> x_g1 = mesh1->geometry().x();
+
+    // Working arrays
+    std::vector<T> coord_dofs0_b(cmap0.dim() * gdim);
+    mdspan2_t coord_dofs0(coord_dofs0_b.data(), cmap0.dim(), gdim);
+    std::vector<T> coord_dofs1_b(cmap1.dim() * gdim);
+    mdspan2_t coord_dofs1(coord_dofs1_b.data(), cmap1.dim(), gdim);
+    std::vector<T> x_b(_num_points * gdim);
+    mdspan2_t x(x_b.data(), _num_points, gdim);
+    std::vector<T> X0_b(_num_points * tdim);
+    mdspan2_t X0(X0_b.data(), _num_points, tdim);
+    std::vector<T> J_b(gdim * tdim);
+    mdspan2_t J(J_b.data(), gdim, tdim);
+    std::vector<T> K_b(tdim * gdim);
+    mdspan2_t K(K_b.data(), tdim, gdim);
+    std::vector<T> basis_b(_num_points * _dim0);
+
+    auto copy_coords = [](auto x_dofs, std::span<const T> x_g, auto&& coords)
+    {
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+        for (std::size_t j = 0; j < coords.extent(1); ++j)
+          coords(i, j) = x_g[3 * x_dofs[i] + j];
+    };
+
+    // Element matrix of each refined cell: the parent basis functions
+    // evaluated at the interpolation points of the refined cell
+    _A.resize(_cells1.size() * _num_points * _dim0);
+    for (std::size_t i = 0; i < _cells1.size(); ++i)
+    {
+      // Physical interpolation points of the refined cell
+      copy_coords(MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+                      x_dofmap1, _cells1[i],
+                      MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent),
+                  x_g1, coord_dofs1);
+      cmap1.push_forward(x, coord_dofs1, phi1);
+
+      // Pull back to the reference cell of the parent
+      copy_coords(MDSPAN_IMPL_STANDARD_NAMESPACE::submdspan(
+                      x_dofmap0, _cells0[i],
+                      MDSPAN_IMPL_STANDARD_NAMESPACE::full_extent),
+                  x_g0, coord_dofs0);
+      std::ranges::fill(J_b, 0);
+      cmap0.compute_jacobian(dphi0, coord_dofs0, J);
+      cmap0.compute_jacobian_inverse(J, K);
+      std::array<T, 3> x0 = {0, 0, 0};
+      for (int j = 0; j < gdim; ++j)
+        x0[j] = coord_dofs0(0, j);
+      cmap0.pull_back_affine(X0, K, x0, x);
+
+      // Evaluate the parent basis. Values below round-off are removed
+      // to keep the operator sparse.
+      e0->tabulate(basis_b, X0_b, {_num_points, std::size_t(tdim)}, 0,
+                   false);
+      std::ranges::transform(basis_b,
+                             std::next(_A.begin(), i * basis_b.size()),
+                             [atol = 1e-14](auto v)
+                             { return std::abs(v) < atol ? T(0) : v; });
+    }
+  }
+
+  /// @brief Build the sparsity pattern of the prolongation matrix
+  /// (collective).
+  ///
+  /// The rows of the pattern correspond to the degrees-of-freedom of
+  /// \f$V_1\f$ and the columns to those of \f$V_0\f$.
+  /// @return The finalised sparsity pattern
+  la::SparsityPattern create_sparsity_pattern() const
+  {
+    auto dofmap0 = _V0->dofmap();
+    auto dofmap1 = _V1->dofmap();
+    la::SparsityPattern pattern(
+        _V1->mesh()->comm(), {dofmap1->index_map, dofmap0->index_map},
+        {dofmap1->index_map_bs(), dofmap0->index_map_bs()});
+    fem::sparsitybuild::cells(pattern, {_cells1, _cells0},
+                              {*dofmap1, *dofmap0});
+    pattern.finalize();
+    return pattern;
+  }
+
+  /// @brief Assemble the prolongation matrix.
+  ///
+  /// Rows that are shared by refined cells are set more than once, with
+  /// the same values. The matrix should therefore be initialised with
+  /// create_sparsity_pattern and `mat_set` must insert (not add)
+  /// values. Owned rows are complete after assembly, so ghost rows
+  /// must not be accumulated (scattered in reverse).
+  ///
+  /// @param[in] mat_set A functor that sets values in a matrix, with
+  /// the blocked degrees-of-freedom of \f$V_1\f$ (rows) and \f$V_0\f$
+  /// (columns) of a cell and the dense cell matrix
+  template <dolfinx::scalar U>
+  void assemble(auto&& mat_set) const
+  {
+    auto dofmap0 = _V0->dofmap();
+    auto dofmap1 = _V1->dofmap();
+    const std::size_t ncols = _dim0 * _bs;
+    std::vector<U> Ab(_num_points * _bs * ncols, 0);
+    for (std::size_t i = 0; i < _cells1.size(); ++i)
+    {
+      std::span<const T> A(_A.data() + i * _num_points * _dim0,
+                           _num_points * _dim0);
+      for (std::size_t p = 0; p < _num_points; ++p)
+        for (std::size_t j = 0; j < _dim0; ++j)
+          for (int k = 0; k < _bs; ++k)
+            Ab[(p * _bs + k) * ncols + j * _bs + k] = A[p * _dim0 + j];
+      mat_set(dofmap1->cell_dofs(_cells1[i]), dofmap0->cell_dofs(_cells0[i]),
+              Ab);
+    }
+  }
+
+  /// @brief Apply the prolongation operator, `x1 = P x0` (collective).
+  /// @param[in] x0 Vector on \f$V_0\f$. The ghost values must be up to
+  /// date.
+  /// @param[out] x1 Vector on \f$V_1\f$. The ghost values are updated.
+  template <dolfinx::scalar U>
+  void apply_prolongation(const la::Vector<U>& x0, la::Vector<U>& x1) const
+  {
+    auto dofmap0 = _V0->dofmap();
+    auto dofmap1 = _V1->dofmap();
+    std::span<const U> a0 = x0.array();
+    std::span<U> a1 = x1.mutable_array();
+    for (std::size_t i = 0; i < _cells1.size(); ++i)
+    {
+      std::span<const T> A(_A.data() + i * _num_points * _dim0,
+                           _num_points * _dim0);
+      auto dofs0 = dofmap0->cell_dofs(_cells0[i]);
+      auto dofs1 = dofmap1->cell_dofs(_cells1[i]);
+      for (std::size_t p = 0; p < _num_points; ++p)
+      {
+        for (int k = 0; k < _bs; ++k)
+        {
+          U v = 0;
+          for (std::size_t j = 0; j < _dim0; ++j)
+            v += A[p * _dim0 + j] * a0[dofs0[j] * _bs + k];
+          a1[dofs1[p] * _bs + k] = v;
+        }
+      }
+    }
+    x1.scatter_fwd();
+  }
+
+  /// @brief Apply the restriction operator, `x0 = P^T x1` (collective).
+  /// @param[in] x1 Vector on \f$V_1\f$
+  /// @param[out] x0 Vector on \f$V_0\f$. The ghost values are updated.
+  template <dolfinx::scalar U>
+  void apply_restriction(const la::Vector<U>& x1, la::Vector<U>& x0) const
+  {
+    auto dofmap0 = _V0->dofmap();
+    auto dofmap1 = _V1->dofmap();
+    std::span<const U> a1 = x1.array();
+    std::span<U> a0 = x0.mutable_array();
+    std::ranges::fill(a0, 0);
+
+    // Each owned row of P contributes once
+    const std::int32_t num_owned1 = dofmap1->index_map->size_local();
+    std::vector<std::int8_t> visited(num_owned1, false);
+    for (std::size_t i = 0; i < _cells1.size(); ++i)
+    {
+      std::span<const T> A(_A.data() + i * _num_points * _dim0,
+                           _num_points * _dim0);
+      auto dofs0 = dofmap0->cell_dofs(_cells0[i]);
+      auto dofs1 = dofmap1->cell_dofs(_cells1[i]);
+      for (std::size_t p = 0; p < _num_points; ++p)
+      {
+        const std::int32_t d1 = dofs1[p];
+        if (d1 >= num_owned1 or visited[d1])
+          continue;
+        visited[d1] = true;
+        for (int k = 0; k < _bs; ++k)
+        {
+          const U v = a1[d1 * _bs + k];
+          for (std::size_t j = 0; j < _dim0; ++j)
+            a0[dofs0[j] * _bs + k] += A[p * _dim0 + j] * v;
+        }
+      }
+    }
+
+    x0.scatter_rev(std::plus<U>());
+    x0.scatter_fwd();
+  }
+
+  /// @brief The space on the parent mesh.
+  std::shared_ptr<const fem::FunctionSpace<T>> V0() const { return _V0; }
+
+  /// @brief The space on the refined mesh.
+  std::shared_ptr<const fem::FunctionSpace<T>> V1() const { return _V1; }
+
+private:
+  // Spaces on the parent and refined mesh
+  std::shared_ptr<const fem::FunctionSpace<T>> _V0, _V1;
+
+  // Owned refined cells and their parent cells
+  std::vector<std::int32_t> _cells1, _cells0;
+
+  // Block size, number of interpolation points of V1 and number of
+  // scalar basis functions of V0
+  int _bs;
+  std::size_t _num_points, _dim0;
+
+  // Element matrices (num_points x dim0) for each refined cell
+  std::vector<T> _A;
+};
+
+} // namespace dolfinx::refinement
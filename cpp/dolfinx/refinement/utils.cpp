@@ -44,7 +44,7 @@ std::int64_t refinement::impl::local_to_global(std::int32_t local_index,
   }
 }
 //---------------------------------------------------------------------------------
-void refinement::update_logical_edgefunction(
+std::vector<std::int32_t> refinement::update_logical_edgefunction(
     MPI_Comm comm,
     const std::vector<std::vector<std::int32_t>>& marked_for_update,
     std::span<std::int8_t> marked_edges, const common::IndexMap& map)
@@ -92,11 +92,18 @@ void refinement::update_logical_edgefunction(
   // Flatten received values and set marked_edges at each index received
   std::vector<std::int32_t> local_indices(data_to_recv.size());
   map.global_to_local(data_to_recv, local_indices);
+  std::vector<std::int32_t> new_marked;
   for (std::int32_t local_index : local_indices)
   {
     assert(local_index != -1);
-    marked_edges[local_index] = true;
+    if (!marked_edges[local_index])
+    {
+      marked_edges[local_index] = true;
+      new_marked.push_back(local_index);
+    }
   }
+
+  return new_marked;
 }
 //-----------------------------------------------------------------------------
 std::vector<std::int64_t>
@@ -365,3 +372,36 @@ refinement::transfer_cell_meshtag(const mesh::MeshTags<std::int32_t>& tags0,
   return {std::move(sorted_cell_indices), std::move(sorted_tag_values)};
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+refinement::compute_parent_cells(const mesh::Topology& topology1,
+                                 std::span<const std::int32_t> parent_cell)
+{
+  const int tdim = topology1.dim();
+  auto cell_map = topology1.index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells = cell_map->size_local();
+  if (parent_cell.size() != std::size_t(num_cells))
+  {
+    throw std::runtime_error("Number of parent cells does not match the "
+                             "number of cells in the refined mesh. The mesh "
+                             "must not be redistributed during refinement.");
+  }
+
+  // The global index of each refined cell, before reordering in Mesh
+  // construction, is the offset of this process plus the position in
+  // parent_cell
+  const std::vector<std::int64_t>& original_cell_index
+      = topology1.original_cell_index[0];
+  const std::int64_t global_offset = cell_map->local_range()[0];
+  std::vector<std::int32_t> parents(num_cells);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    const std::int64_t pos = original_cell_index[c] - global_offset;
+    if (pos < 0 or pos >= num_cells)
+      throw std::runtime_error("Refined mesh has been redistributed.");
+    parents[c] = parent_cell[pos];
+  }
+
+  return parents;
+}
+//-----------------------------------------------------------------------------
@@ -127,7 +127,9 @@ std::pair<std::vector<T>, std::array<std::size_t, 2>> create_new_geometry(
 /// @param[in, out] marked_edges Marker for each edge on the calling
 /// process
 /// @param[in] map Index map for the mesh edges
-void update_logical_edgefunction(
+/// @return Indices of the received edges that were not marked before
+/// the update
+std::vector<std::int32_t> update_logical_edgefunction(
     MPI_Comm comm,
     const std::vector<std::vector<std::int32_t>>& marked_for_update,
     std::span<std::int8_t> marked_edges, const common::IndexMap& map);
@@ -350,4 +352,20 @@ transfer_cell_meshtag(const mesh::MeshTags<std::int32_t>& tags0,
                       const mesh::Topology& topology1,
                       std::span<const std::int32_t> parent_cell);
 
+/// @brief Compute the parent cell of each owned cell of a refined
+/// mesh, in the cell numbering of the refined mesh.
+///
+/// @note The refined mesh must not have been redistributed during
+/// refinement.
+///
+/// @param[in] topology1 Refined mesh topology
+/// @param[in] parent_cell Parent cell of each cell in refined mesh, in
+/// the order in which the refined cells were created, as returned by
+/// plaza::refine
+/// @return Parent cell (local index in the parent mesh) of each owned
+/// cell of the refined mesh
+std::vector<std::int32_t>
+compute_parent_cells(const mesh::Topology& topology1,
+                     std::span<const std::int32_t> parent_cell);
+
 } // namespace dolfinx::refinement
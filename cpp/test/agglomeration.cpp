@@ -0,0 +1,155 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the agglomeration of vectors and matrices onto a
+// sub-communicator
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/Agglomeration.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Distributed matrix of the 1D Laplacian, [-1, 2, -1], with 3 rows on
+/// each process
+la::MatrixCSR<double> create_laplacian(MPI_Comm comm)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  const std::int64_t n = 3;
+  const std::int64_t N = n * size;
+  const std::int64_t r0 = n * rank;
+
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (rank > 0)
+  {
+    ghosts.push_back(r0 - 1);
+    owners.push_back(rank - 1);
+  }
+  if (rank < size - 1)
+  {
+    ghosts.push_back(r0 + n);
+    owners.push_back(rank + 1);
+  }
+  auto map = std::make_shared<common::IndexMap>(comm, n, ghosts, owners);
+
+  std::vector<std::int64_t> global(n + ghosts.size());
+  for (std::int64_t i = 0; i < n; ++i)
+    global[i] = r0 + i;
+  std::ranges::copy(ghosts, global.begin() + n);
+  std::vector<std::int32_t> local(global.size());
+
+  la::SparsityPattern pattern(comm, {map, map}, {1, 1});
+  auto stencil = [N](std::int64_t i)
+  {
+    std::vector<std::int64_t> cols;
+    for (std::int64_t j = std::max<std::int64_t>(i - 1, 0);
+         j <= std::min(i + 1, N - 1); ++j)
+    {
+      cols.push_back(j);
+    }
+    return cols;
+  };
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    std::vector<std::int64_t> cols = stencil(r0 + i);
+    std::vector<std::int32_t> lcols(cols.size());
+    map->global_to_local(cols, lcols);
+    pattern.insert(std::span(&i, 1), lcols);
+  }
+  pattern.finalize();
+
+  la::MatrixCSR<double> A(pattern);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    std::vector<std::int64_t> cols = stencil(r0 + i);
+    std::vector<std::int32_t> lcols(cols.size());
+    A.index_map(1)->global_to_local(cols, lcols);
+    for (std::size_t j = 0; j < cols.size(); ++j)
+    {
+      double v = cols[j] == r0 + i ? 2.0 : -1.0;
+      A.add(std::span(&v, 1), std::span(&i, 1), std::span(&lcols[j], 1));
+    }
+  }
+
+  return A;
+}
+} // namespace
+
+TEST_CASE("Agglomeration", "[la_agglomeration]")
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const int size = dolfinx::MPI::size(comm);
+  la::MatrixCSR<double> A = create_laplacian(comm);
+  auto map = A.index_map(0);
+  const int num_leaders = (size + 1) / 2;
+  la::Agglomeration agg(map, num_leaders);
+  CHECK(agg.index_map() == map);
+
+  // The vector x = (0, 1, 2, ...) and y = A x
+  la::Vector<double> x(A.index_map(1), 1), y(map, 1);
+  const std::int64_t r0 = map->local_range()[0];
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    x.mutable_array()[i] = r0 + i;
+  A.mult(x, y);
+
+  std::shared_ptr<la::MatrixCSR<double>> Ac = agg.agglomerate(A);
+  CHECK(agg.is_leader() == (Ac != nullptr));
+  if (agg.is_leader())
+  {
+    REQUIRE(agg.comm() != MPI_COMM_NULL);
+    CHECK(dolfinx::MPI::size(agg.comm()) == num_leaders);
+    auto cmap = agg.agglomerated_index_map();
+    CHECK(cmap->size_global() == map->size_global());
+    CHECK(cmap->local_range()[0] == r0);
+    CHECK(Ac->index_map(0)->size_local() == cmap->size_local());
+  }
+  else
+  {
+    CHECK(agg.comm() == MPI_COMM_NULL);
+    CHECK(!agg.agglomerated_index_map());
+  }
+
+  // Restrict x and y to the sub-communicator
+  std::int32_t nc = agg.is_leader() ? Ac->index_map(0)->size_local() : 0;
+  std::vector<double> xc(nc), yc(nc);
+  agg.gather(std::span<const double>(x.array()), std::span(xc));
+  agg.gather(std::span<const double>(y.array()), std::span(yc));
+
+  // The agglomerated matrix gives the same product
+  std::vector<double> zc(nc);
+  if (agg.is_leader())
+  {
+    const std::int64_t c0 = agg.agglomerated_index_map()->local_range()[0];
+    for (std::int32_t i = 0; i < nc; ++i)
+      CHECK(xc[i] == c0 + i);
+
+    la::Vector<double> u(Ac->index_map(1), 1), v(Ac->index_map(0), 1);
+    std::ranges::copy(xc, u.mutable_array().begin());
+    Ac->mult(u, v);
+    for (std::int32_t i = 0; i < nc; ++i)
+      CHECK(v.array()[i] == yc[i]);
+    std::ranges::copy(v.array().first(nc), zc.begin());
+  }
+
+  // Prolongate the product back to all processes
+  std::vector<double> z(map->size_local(), -1);
+  agg.scatter(std::span<const double>(zc), std::span(z));
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    CHECK(z[i] == y.array()[i]);
+
+  CHECK_THROWS(la::Agglomeration(map, size + 1));
+}
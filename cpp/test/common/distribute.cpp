@@ -0,0 +1,191 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the distribution of data with direct and node routing
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/partition.h>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Route items via node leaders", "[distribute]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size = dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  // Send r + 1 items to each rank r, in decreasing order of rank
+  std::vector<int> dest;
+  std::vector<std::int64_t> data;
+  for (int r = size - 1; r >= 0; --r)
+  {
+    for (int j = 0; j <= r; ++j)
+    {
+      dest.push_back(r);
+      data.push_back(1000 * rank + 10 * r + j);
+    }
+  }
+
+  auto [src, recv] = dolfinx::MPI::route_via_nodes(
+      MPI_COMM_WORLD, dest, std::as_bytes(std::span(data)),
+      sizeof(std::int64_t));
+  REQUIRE(src.size() == std::size_t(size * (rank + 1)));
+  REQUIRE(recv.size() == src.size() * sizeof(std::int64_t));
+  for (std::size_t i = 0; i < src.size(); ++i)
+  {
+    const int s = i / (rank + 1);
+    const int j = i % (rank + 1);
+    std::int64_t value;
+    std::memcpy(&value, recv.data() + i * sizeof(std::int64_t),
+                sizeof(std::int64_t));
+    CHECK(src[i] == s);
+    CHECK(value == 1000 * s + 10 * rank + j);
+  }
+}
+
+TEST_CASE("Distribute data with node routing", "[distribute]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size = dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  // Rows (i, -i) for global row index i
+  const std::int64_t num_rows = 3 + rank;
+  std::int64_t offset = 0;
+  MPI_Exscan(&num_rows, &offset, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+  std::vector<std::int64_t> x;
+  for (std::int64_t i = offset; i < offset + num_rows; ++i)
+    x.insert(x.end(), {i, -i});
+
+  const std::int64_t shape0 = size * 3 + size * (size - 1) / 2;
+  std::vector<std::int64_t> indices;
+  for (std::int64_t j = 0; j < 20; ++j)
+    indices.push_back((7 * rank + 5 * j) % shape0);
+
+  std::vector<std::int64_t> x_direct = dolfinx::MPI::distribute_data(
+      MPI_COMM_WORLD, indices, MPI_COMM_WORLD, x, 2,
+      dolfinx::MPI::Routing::direct);
+  std::vector<std::int64_t> x_node = dolfinx::MPI::distribute_data(
+      MPI_COMM_WORLD, indices, MPI_COMM_WORLD, x, 2,
+      dolfinx::MPI::Routing::node);
+  CHECK(x_node == x_direct);
+  REQUIRE(x_node.size() == 2 * indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    CHECK(x_node[2 * i] == indices[i]);
+    CHECK(x_node[2 * i + 1] == -indices[i]);
+  }
+
+  // Default routing
+  dolfinx::MPI::set_default_routing(dolfinx::MPI::Routing::node);
+  CHECK(dolfinx::MPI::default_routing() == dolfinx::MPI::Routing::node);
+  std::vector<std::int64_t> x_default = dolfinx::MPI::distribute_data(
+      MPI_COMM_WORLD, indices, MPI_COMM_WORLD, x, 2);
+  dolfinx::MPI::set_default_routing(dolfinx::MPI::Routing::direct);
+  CHECK(x_default == x_direct);
+}
+
+TEST_CASE("Distribute graph with node routing", "[distribute]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size = dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  // Node i has i % 3 + 1 edges, and is owned by rank (i + rank) % size
+  // and ghosted on the next rank
+  std::vector<std::int64_t> data;
+  std::vector<std::int32_t> offsets = {0};
+  std::vector<std::int32_t> dest_data;
+  std::vector<std::int32_t> dest_offsets = {0};
+  for (int i = 0; i < 10; ++i)
+  {
+    for (int j = 0; j <= i % 3; ++j)
+      data.push_back(100 * rank + 10 * i + j);
+    offsets.push_back(data.size());
+    dest_data.push_back((i + rank) % size);
+    if (size > 1)
+      dest_data.push_back((i + rank + 1) % size);
+    dest_offsets.push_back(dest_data.size());
+  }
+  graph::AdjacencyList<std::int64_t> list(data, offsets);
+  graph::AdjacencyList<std::int32_t> destinations(dest_data, dest_offsets);
+
+  auto [list0, src0, indices0, owners0] = graph::build::distribute(
+      MPI_COMM_WORLD, list, destinations, dolfinx::MPI::Routing::direct);
+  auto [list1, src1, indices1, owners1] = graph::build::distribute(
+      MPI_COMM_WORLD, list, destinations, dolfinx::MPI::Routing::node);
+  CHECK(list1.array() == list0.array());
+  CHECK(list1.offsets() == list0.offsets());
+  CHECK(src1 == src0);
+  CHECK(indices1 == indices0);
+  CHECK(owners1 == owners0);
+
+  // Fixed size rows
+  std::vector<std::int64_t> rows(2 * 10);
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    rows[i] = 100 * rank + i;
+  auto [x0, gi0, o0] = graph::build::distribute(
+      MPI_COMM_WORLD, rows, {10, 2}, destinations,
+      dolfinx::MPI::Routing::direct);
+  auto [x1, gi1, o1] = graph::build::distribute(
+      MPI_COMM_WORLD, rows, {10, 2}, destinations,
+      dolfinx::MPI::Routing::node);
+  CHECK(x1 == x0);
+  CHECK(gi1 == gi0);
+  CHECK(o1 == o0);
+}
+
+TEST_CASE("Distribute graph in rounds", "[distribute]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size = dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  // Node i has i % 3 + 1 edges, and is owned by rank (i + rank) % size
+  // and ghosted on the next rank if i is odd
+  const int num_nodes = 10 + 3 * rank;
+  std::vector<std::int64_t> data;
+  std::vector<std::int32_t> offsets = {0};
+  std::vector<std::int32_t> dest_data;
+  std::vector<std::int32_t> dest_offsets = {0};
+  for (int i = 0; i < num_nodes; ++i)
+  {
+    for (int j = 0; j <= i % 3; ++j)
+      data.push_back(100 * rank + 10 * i + j);
+    offsets.push_back(data.size());
+    dest_data.push_back((i + rank) % size);
+    if (size > 1 and i % 2 == 1)
+      dest_data.push_back((i + rank + 1) % size);
+    dest_offsets.push_back(dest_data.size());
+  }
+  graph::AdjacencyList<std::int64_t> list(data, offsets);
+  graph::AdjacencyList<std::int32_t> destinations(dest_data, dest_offsets);
+
+  auto [list0, src0, indices0, owners0] = graph::build::distribute(
+      MPI_COMM_WORLD, list, destinations, dolfinx::MPI::Routing::direct);
+  std::vector<std::int64_t> rows(2 * num_nodes);
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    rows[i] = 100 * rank + i;
+  const std::array<std::size_t, 2> shape = {(std::size_t)num_nodes, 2};
+  auto [x0, gi0, o0] = graph::build::distribute(
+      MPI_COMM_WORLD, rows, shape, destinations, dolfinx::MPI::Routing::direct);
+  for (std::int32_t max_rows : {1, 3, 100})
+  {
+    auto [list1, src1, indices1, owners1] = graph::build::distribute(
+        MPI_COMM_WORLD, list, destinations, max_rows);
+    CHECK(list1 == list0);
+    CHECK(src1 == src0);
+    CHECK(indices1 == indices0);
+    CHECK(owners1 == owners0);
+
+    auto [x1, gi1, o1] = graph::build::distribute(MPI_COMM_WORLD, rows, shape,
+                                                  destinations, max_rows);
+    CHECK(x1 == x0);
+    CHECK(gi1 == gi0);
+    CHECK(o1 == o0);
+  }
+}
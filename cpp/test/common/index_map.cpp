@@ -128,6 +128,52 @@ void test_scatter_rev()
   CHECK(sum == 2 * n * value * num_ghosts);
 }
 
+void test_scatter_subset(int n)
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 100;
+
+  // Create some ghost entries on next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+  std::vector<int> global_ghost_owner(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  const common::IndexMap idx_map(MPI_COMM_WORLD, size_local, ghosts,
+                                 global_ghost_owner);
+
+  // Scatterer for every other ghost (and an owned index, which is
+  // ignored)
+  std::vector<std::int32_t> subset = {0};
+  for (int i = 0; i < num_ghosts; i += 2)
+    subset.push_back(size_local + i);
+  common::Scatterer<> sct(idx_map, n, subset);
+  CHECK(sct.remote_indices().size() == n * ((num_ghosts + 1) / 2));
+
+  // Only the ghosts in the subset are updated
+  const std::int64_t val = 11;
+  std::vector<std::int64_t> data_local(n * size_local, val * mpi_rank);
+  std::vector<std::int64_t> data_ghost(n * num_ghosts, -1);
+  sct.scatter_fwd<std::int64_t>(data_local, data_ghost);
+  for (int i = 0; i < num_ghosts; ++i)
+  {
+    for (int k = 0; k < n; ++k)
+    {
+      CHECK(data_ghost[i * n + k]
+            == (i % 2 == 0 ? val * ((mpi_rank + 1) % mpi_size) : -1));
+    }
+  }
+
+  // Only the values of the ghosts in the subset are sent to the owner
+  std::ranges::fill(data_local, 0);
+  std::ranges::fill(data_ghost, 1);
+  sct.scatter_rev<std::int64_t>(data_local, data_ghost,
+                                std::plus<std::int64_t>());
+  std::int64_t sum = std::reduce(data_local.begin(), data_local.end(), 0);
+  CHECK(sum == n * ((num_ghosts + 1) / 2));
+}
+
 void test_consensus_exchange()
 {
   const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
@@ -157,6 +203,97 @@ void test_consensus_exchange()
 
   CHECK(dest_ranks0 == dest_ranks1);
 }
+
+void test_sub_index_map(bool allow_owner_change)
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 10;
+
+  // Ghost the even indices of the next process
+  const int owner = (mpi_rank + 1) % mpi_size;
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> ghost_owners;
+  if (mpi_size > 1)
+  {
+    for (int i = 0; i < size_local; i += 2)
+    {
+      ghosts.push_back(owner * size_local + i);
+      ghost_owners.push_back(owner);
+    }
+  }
+  common::IndexMap map(MPI_COMM_WORLD, size_local, ghosts, ghost_owners);
+
+  // Pick the owned indices that are multiples of four, and all ghosts.
+  // Ghosts that are not picked by their owner are only valid if the
+  // owner can change.
+  std::vector<std::int32_t> indices;
+  for (int i = 0; i < size_local; i += 4)
+    indices.push_back(i);
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    if (allow_owner_change or (ghosts[i] - owner * size_local) % 4 == 0)
+      indices.push_back(size_local + i);
+  }
+
+  auto [submap, sub_to_parent] = common::create_sub_index_map(
+      map, indices, common::IndexMapOrder::any, allow_owner_change);
+  CHECK(sub_to_parent.size()
+        == std::size_t(submap.size_local() + submap.num_ghosts()));
+
+  const int num_moved = allow_owner_change and mpi_size > 1 ? 2 : 0;
+  CHECK(submap.size_local() == 3 + num_moved);
+  CHECK(submap.num_ghosts() == (mpi_size > 1 ? 3 : 0));
+  CHECK(submap.size_global() == mpi_size * (3 + num_moved));
+
+  // Every owned index that is ghosted is shared with the previous
+  // process
+  graph::AdjacencyList<int> dest_ranks = submap.index_to_dest_ranks();
+  CHECK(dest_ranks.num_nodes() == submap.size_local() + submap.num_ghosts());
+  for (std::int32_t i : submap.shared_indices())
+  {
+    REQUIRE(dest_ranks.links(i).size() == 1);
+    CHECK(dest_ranks.links(i).front() == (mpi_rank + mpi_size - 1) % mpi_size);
+  }
+}
+
+void test_global_to_local(int num_threads)
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 10;
+
+  // Ghost the odd indices of the next process, in reverse order
+  const int owner = (mpi_rank + 1) % mpi_size;
+  std::vector<std::int64_t> ghosts;
+  if (mpi_size > 1)
+  {
+    for (int i = size_local - 1; i > 0; i -= 2)
+      ghosts.push_back(owner * size_local + i);
+  }
+  std::vector<int> ghost_owners(ghosts.size(), owner);
+  common::IndexMap map(MPI_COMM_WORLD, size_local, ghosts, ghost_owners);
+
+  // Owned, ghost and unknown global indices
+  const std::int64_t offset = map.local_range()[0];
+  std::vector<std::int64_t> global = {offset + 3, offset};
+  std::vector<std::int32_t> expected = {3, 0};
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    global.push_back(ghosts[i]);
+    expected.push_back(size_local + i);
+    global.push_back(ghosts[i] - 1);
+    expected.push_back(-1);
+  }
+
+  // The ghost lookup built by the first call is re-used
+  for (int k = 0; k < 2; ++k)
+  {
+    std::vector<std::int32_t> local(global.size());
+    map.global_to_local(global, local, num_threads);
+    CHECK(local == expected);
+  }
+}
 } // namespace
 
 TEST_CASE("Scatter forward using IndexMap", "[index_map_scatter_fwd]")
@@ -170,8 +307,26 @@ TEST_CASE("Scatter reverse using IndexMap", "[index_map_scatter_rev]")
   CHECK_NOTHROW(test_scatter_rev());
 }
 
+TEST_CASE("Scatter a subset of the ghosts", "[index_map_scatter_subset]")
+{
+  auto n = GENERATE(1, 3);
+  CHECK_NOTHROW(test_scatter_subset(n));
+}
+
 TEST_CASE("Communication graph edges via consensus exchange",
           "[consensus_exchange]")
 {
   CHECK_NOTHROW(test_consensus_exchange());
 }
+
+TEST_CASE("Create sub index map", "[index_map_submap]")
+{
+  auto allow_owner_change = GENERATE(false, true);
+  CHECK_NOTHROW(test_sub_index_map(allow_owner_change));
+}
+
+TEST_CASE("Global to local index map", "[index_map_global_to_local]")
+{
+  auto num_threads = GENERATE(1, 3);
+  CHECK_NOTHROW(test_global_to_local(num_threads));
+}
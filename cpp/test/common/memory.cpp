@@ -0,0 +1,125 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the memory accounting of data structures
+
+#include <algorithm>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Find a part of a memory usage tree by name
+const common::MemoryUsage* find(const common::MemoryUsage& usage,
+                                const std::string& name)
+{
+  for (const common::MemoryUsage& c : usage.children)
+  {
+    if (c.name == name)
+      return &c;
+  }
+  return nullptr;
+}
+} // namespace
+
+TEST_CASE("Memory usage tree", "[memory]")
+{
+  common::MemoryUsage usage{"root", 8, {}};
+  usage.add("a", 16);
+  common::MemoryUsage& b = usage.add("b", 4);
+  b.add("c", 32);
+  CHECK(usage.total() == 60);
+  CHECK(b.total() == 36);
+
+  std::vector<std::vector<double>> x(3, std::vector<double>(5));
+  CHECK(common::capacity_bytes(x)
+        >= 3 * sizeof(std::vector<double>) + 15 * sizeof(double));
+
+  Table table = common::memory_report(MPI_COMM_WORLD, usage);
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    const double size = dolfinx::MPI::size(MPI_COMM_WORLD);
+    CHECK(std::get<double>(table.get("root / b", "max"))
+          == Catch::Approx(36e-6));
+    CHECK(std::get<double>(table.get("root", "sum"))
+          == Catch::Approx(size * 60e-6));
+  }
+}
+
+TEST_CASE("Mesh and vector memory usage", "[memory]")
+{
+  common::enable_memory_tracking(true);
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0.0, 0.0}, {1.0, 1.0}}},
+                                     {16, 16}, mesh::CellType::triangle));
+  common::enable_memory_tracking(false);
+
+  common::MemoryUsage usage = mesh->memory_usage();
+  const common::MemoryUsage* geometry = find(usage, "Geometry");
+  REQUIRE(geometry);
+  const common::MemoryUsage* x = find(*geometry, "x");
+  REQUIRE(x);
+  CHECK(x->bytes >= mesh->geometry().x().size() * sizeof(double));
+  REQUIRE(find(usage, "Topology"));
+  CHECK(find(*find(usage, "Topology"), "connectivity (triangle, point)"));
+
+  std::size_t bytes = usage.total();
+  mesh->topology_mutable()->create_connectivity(1, 0);
+  CHECK(mesh->memory_usage().total() > bytes);
+
+  la::Vector<double> v(mesh->topology()->index_map(0), 2);
+  common::MemoryUsage vusage = v.memory_usage();
+  REQUIRE(find(vusage, "values"));
+  CHECK(find(vusage, "values")->bytes >= v.array().size() * sizeof(double));
+  CHECK(find(vusage, "Scatterer"));
+
+  Table hwm = common::memory_high_water_marks(MPI_COMM_WORLD);
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+    CHECK(std::get<int>(hwm.get("Create mesh", "calls")) >= 1);
+  common::reset_memory_high_water_marks();
+}
+
+TEST_CASE("First touch resource", "[memory]")
+{
+  common::FirstTouchResource resource(4, 1 << 16, true);
+
+  // Small allocations are passed to the upstream resource
+  std::pmr::vector<double> small(16, 1.0, &resource);
+  CHECK(resource.num_touched() == 0);
+
+  // Large allocations are zero-filled and aligned to huge pages
+  const std::size_t n = 3 * common::FirstTouchResource::huge_page_size;
+  void* p = resource.allocate(n, alignof(std::max_align_t));
+  CHECK(resource.num_touched() == 1);
+  CHECK(reinterpret_cast<std::uintptr_t>(p)
+            % common::FirstTouchResource::huge_page_size
+        == 0);
+  std::span<const std::byte> bytes(static_cast<std::byte*>(p), n);
+  CHECK(std::ranges::all_of(bytes, [](auto b) { return b == std::byte(0); }));
+  resource.deallocate(p, n, alignof(std::max_align_t));
+
+  // Vector data is allocated from the resource
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, 1 << 16);
+  la::Vector<double, std::pmr::vector<double>> v(
+      map, 1, common::Scatterer<>::type::neighbor,
+      std::pmr::polymorphic_allocator<double>(&resource));
+  CHECK(resource.num_touched() == 2);
+  CHECK(std::ranges::all_of(v.array(), [](auto x) { return x == 0.0; }));
+}
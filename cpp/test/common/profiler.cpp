@@ -0,0 +1,218 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the profiler
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/profiler.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Number of times a region was entered, or -1 if it was not recorded
+std::int64_t count(const std::string& path)
+{
+  std::vector<common::profiler::Region> regions
+      = common::profiler::regions();
+  auto it = std::ranges::find(regions, path, &common::profiler::Region::path);
+  return it == regions.end() ? -1 : it->count;
+}
+} // namespace
+
+TEST_CASE("Profiler regions", "[profiler]")
+{
+  common::profiler::reset();
+  {
+    common::ScopedRegion outer("test outer");
+    for (int i = 0; i < 10; ++i)
+      common::ScopedRegion inner("test inner");
+
+    // Regions on other threads are recorded as top-level regions
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 3; ++t)
+    {
+      threads.emplace_back(
+          []
+          {
+            common::ScopedRegion region("test thread");
+            common::ScopedRegion inner("test inner");
+          });
+    }
+    threads.clear();
+
+    // Timers nest like regions
+    common::Timer timer("test timer");
+    {
+      common::ScopedRegion inner("test inner");
+    }
+    timer.stop();
+  }
+
+  CHECK(count("test outer") == 1);
+  CHECK(count("test outer / test inner") == 10);
+  CHECK(count("test thread") == 3);
+  CHECK(count("test thread / test inner") == 3);
+  CHECK(count("test outer / test timer") == 1);
+  CHECK(count("test outer / test timer / test inner") == 1);
+
+  // Children follow their parent
+  std::vector<common::profiler::Region> regions = common::profiler::regions();
+  for (std::size_t i = 1; i < regions.size(); ++i)
+  {
+    if (regions[i].depth > 0)
+      CHECK(regions[i - 1].depth >= regions[i].depth - 1);
+  }
+
+  // Disabled recording
+  common::profiler::enable(false);
+  {
+    common::ScopedRegion outer("test outer");
+  }
+  common::profiler::enable(true);
+  CHECK(count("test outer") == 1);
+
+  common::profiler::reset();
+  CHECK(count("test outer") == -1);
+}
+
+TEST_CASE("Profiler trace", "[profiler]")
+{
+  common::profiler::reset();
+  common::profiler::enable_trace(true);
+  {
+    common::ScopedRegion outer("test \"trace\"");
+    common::ScopedRegion inner("test inner");
+  }
+  common::profiler::enable_trace(false);
+
+  const std::string filename = "profiler_trace.json";
+  common::profiler::write_trace(MPI_COMM_WORLD, filename);
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string trace = ss.str();
+    CHECK(trace.starts_with("{\"traceEvents\": ["));
+    CHECK(trace.find("\"name\": \"test \\\"trace\\\"\"") != std::string::npos);
+    CHECK(trace.find("\"name\": \"test inner\"") != std::string::npos);
+    std::filesystem::remove(filename);
+  }
+
+  Table table = common::profiler::summary(MPI_COMM_WORLD);
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    CHECK(std::get<int>(table.get("test \"trace\" / test inner", "reps"))
+          == 1);
+  }
+  common::profiler::reset();
+}
+
+TEST_CASE("Profiler log events", "[profiler]")
+{
+  common::profiler::reset();
+  common::profiler::enable_trace(true);
+  {
+    common::ScopedRegion outer("test outer");
+    for (int i = 0; i < 3; ++i)
+      DOLFINX_LOG_EVENT("test event", 42 + i);
+  }
+  common::profiler::enable_trace(false);
+
+  // Events are compiled out above log level debug
+#if DOLFINX_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+  CHECK(count("test outer / test event") == 3);
+
+  const std::string filename = "profiler_events.json";
+  common::profiler::write_trace(MPI_COMM_WORLD, filename);
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string trace = ss.str();
+    CHECK(trace.find("\"ph\": \"i\"") != std::string::npos);
+    CHECK(trace.find("{\"value\": 44}") != std::string::npos);
+    std::filesystem::remove(filename);
+  }
+#else
+  CHECK(count("test outer / test event") == -1);
+#endif
+
+  // Messages below the run-time level are not formatted and their
+  // arguments are not evaluated
+  const spdlog::level::level_enum level = spdlog::get_level();
+  spdlog::set_level(spdlog::level::warn);
+  int evaluated = 0;
+  DOLFINX_LOG_INFO("Not logged {}", ++evaluated);
+  CHECK(evaluated == 0);
+  spdlog::set_level(level);
+
+  common::profiler::reset();
+}
+
+TEST_CASE("Profiler communication", "[profiler]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size = dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  // Each rank ghosts the first index owned by the next rank
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (size > 1)
+  {
+    ghosts.push_back(((rank + 1) % size) * 10);
+    owners.push_back((rank + 1) % size);
+  }
+  common::IndexMap map(MPI_COMM_WORLD, 10, ghosts, owners);
+  common::Scatterer<> scatterer(map, 1);
+
+  common::profiler::reset();
+  common::profiler::enable_comm(true);
+  {
+    common::ScopedRegion region("test comm");
+    std::vector<double> local(10, rank), remote(ghosts.size());
+    scatterer.scatter_fwd(std::span<const double>(local),
+                          std::span<double>(remote));
+    if (size > 1)
+      CHECK(remote[0] == (rank + 1) % size);
+  }
+  common::profiler::enable_comm(false);
+
+  Table table = common::profiler::comm_summary(MPI_COMM_WORLD);
+  const std::string filename = "profiler_comm.csv";
+  common::profiler::write_comm_matrix(MPI_COMM_WORLD, filename);
+  if (rank == 0)
+  {
+    // The scatter does not communicate if there are no neighbours
+    if (size > 1)
+    {
+      const std::string row = "test comm / Scatterer::scatter_fwd";
+      CHECK(std::get<int>(table.get(row, "calls")) == 1);
+      CHECK(std::get<double>(table.get(row, "bytes max")) == sizeof(double));
+    }
+
+    std::ifstream file(filename);
+    std::string header;
+    std::getline(file, header);
+    CHECK(header == "rank,dest,messages,bytes");
+    std::filesystem::remove(filename);
+  }
+  common::profiler::reset();
+}
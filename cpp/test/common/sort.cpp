@@ -35,6 +35,37 @@ TEMPLATE_TEST_CASE("Test radix sort", "[vector][template]", std::int32_t,
   REQUIRE(std::ranges::is_sorted(vec));
 }
 
+TEMPLATE_TEST_CASE("Test threaded radix sort", "[radix]", std::int32_t,
+                   std::int64_t)
+{
+  auto vec_size = GENERATE(1, 5, 1000, 100000);
+  auto num_threads = GENERATE(2, 3, 8);
+
+  // Keys that need an odd and an even number of passes
+  for (TestType max : {TestType(1000), TestType(100000000)})
+  {
+    std::uniform_int_distribution<TestType> distribution(0, max);
+    std::mt19937 engine;
+    std::vector<TestType> vec(vec_size);
+    std::ranges::generate(vec, [&]() { return distribution(engine); });
+
+    std::vector<TestType> ref = vec;
+    std::ranges::sort(ref);
+    dolfinx::radix_sort(vec, std::identity{}, num_threads);
+    CHECK(vec == ref);
+
+    // Argsort is stable
+    std::vector<std::int32_t> perm(vec_size), perm_ref(vec_size);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::iota(perm_ref.begin(), perm_ref.end(), 0);
+    std::ranges::generate(vec, [&]() { return distribution(engine) % 50; });
+    auto proj = [&vec](auto i) { return vec[i]; };
+    dolfinx::radix_sort(perm, proj, num_threads);
+    std::ranges::stable_sort(perm_ref, std::less{}, proj);
+    CHECK(perm == perm_ref);
+  }
+}
+
 TEMPLATE_TEST_CASE("Test radix sort (projection)", "[radix]", std::int16_t,
                    std::int32_t, std::int64_t)
 {
@@ -79,6 +110,9 @@ TEST_CASE("Test argsort bitset")
       = dolfinx::sort_by_perm<std::int32_t>(arr, shape1);
   REQUIRE((int)perm.size() == shape0);
 
+  // Threaded sort gives the same (stable) permutation
+  CHECK(dolfinx::sort_by_perm<std::int32_t>(arr, shape1, 4) == perm);
+
   // Sort by perm using to std::lexicographical_compare
   std::vector<int> index(shape0);
   std::iota(index.begin(), index.end(), 0);
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the thread pool
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Thread pool parallel_for", "[thread_pool]")
+{
+  for (int nt : {1, 2, 3, 8})
+  {
+    // Chunks cover the range once, in the order of MPI::local_range
+    std::vector<int> x(1001, 0);
+    common::parallel_for(x.size(), nt,
+                         [&x](std::int64_t i0, std::int64_t i1)
+                         {
+                           for (std::int64_t i = i0; i < i1; ++i)
+                             x[i] += 1;
+                         });
+    CHECK(std::reduce(x.begin(), x.end()) == 1001);
+
+    std::vector<std::int64_t> starts(nt, -1);
+    common::parallel_for(x.size(), nt,
+                         [&](std::int64_t i0, std::int64_t)
+                         {
+                           for (int t = 0; t < nt; ++t)
+                           {
+                             if (dolfinx::MPI::local_range(t, x.size(), nt)[0]
+                                 == i0)
+                             {
+                               starts[t] = i0;
+                             }
+                           }
+                         });
+    CHECK(std::ranges::count(starts, -1) == 0);
+  }
+
+  // Empty range
+  int calls = 0;
+  common::parallel_for(0, 4, [&calls](std::int64_t, std::int64_t) { ++calls; });
+  CHECK(calls == 0);
+}
+
+TEST_CASE("Thread pool nested tasks", "[thread_pool]")
+{
+  // Tasks that run groups of tasks complete without deadlock
+  std::vector<std::vector<int>> x(6, std::vector<int>(100, 0));
+  common::run_tasks(x.size(),
+                    [&x](int t)
+                    {
+                      common::parallel_for(
+                          x[t].size(), 4,
+                          [&x, t](std::int64_t i0, std::int64_t i1)
+                          {
+                            for (std::int64_t i = i0; i < i1; ++i)
+                              x[t][i] = t;
+                          });
+                    });
+  for (std::size_t t = 0; t < x.size(); ++t)
+    CHECK(std::ranges::count(x[t], t) == 100);
+}
+
+TEST_CASE("Thread pool exceptions", "[thread_pool]")
+{
+  std::vector<int> done(5, 0);
+  bool thrown = false;
+  try
+  {
+    common::run_tasks(5,
+                      [&done](int t)
+                      {
+                        done[t] = 1;
+                        if (t == 3)
+                          throw std::runtime_error("task failed");
+                      });
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  CHECK(thrown);
+  CHECK(std::ranges::count(done, 1) == 5);
+}
+
+TEST_CASE("Thread pool default number of threads", "[thread_pool]")
+{
+  const int n = common::num_threads();
+  common::set_num_threads(3);
+  CHECK(common::num_threads() == 3);
+
+  std::vector<int> chunks;
+  std::mutex mutex;
+  common::parallel_for(10, 0,
+                       [&](std::int64_t i0, std::int64_t)
+                       {
+                         std::scoped_lock lock(mutex);
+                         chunks.push_back(i0);
+                       });
+  CHECK(chunks.size() == 3);
+  common::set_num_threads(n);
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for asynchronous assembly
+
+#include "forms.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/AssemblyHandle.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel for the cell vector (1, 2, 3)
+void kernel_L0(double* b, const double*, const double*, const double*,
+               const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    b[i] += i + 1;
+}
+
+/// Kernel for the cell vector with entries 0.5
+void kernel_L1(double* b, const double*, const double*, const double*,
+               const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    b[i] += 0.5;
+}
+} // namespace
+
+TEST_CASE("Asynchronous assembly", "[assembly_handle]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0, 0}, {1, 1}}},
+                                     {6, 5}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh);
+  auto map = V->dofmap()->index_map;
+
+  // Cell matrix I + J, where J is the matrix of ones
+  fem::Form<double> a
+      = test::create_cell_form<double>({V, V}, test::kernel_IJ<double, 1, 1>);
+  fem::Form<double> L0 = test::create_cell_form<double>({V}, kernel_L0);
+  fem::Form<double> L1 = test::create_cell_form<double>({V}, kernel_L1);
+
+  // Reference vectors and matrix
+  auto assemble = [&map](const fem::Form<double>& L)
+  {
+    la::Vector<double> b(map, 1);
+    fem::assemble_vector(b.mutable_array(), L);
+    b.scatter_rev(std::plus<double>());
+    return b;
+  };
+  la::Vector<double> b0 = assemble(L0);
+  la::Vector<double> b1 = assemble(L1);
+  la::SparsityPattern pattern = fem::create_sparsity_pattern(a);
+  pattern.finalize();
+  la::MatrixCSR<double> A(pattern);
+  fem::assemble_matrix(A.mat_add_values(), a, {});
+  A.scatter_rev();
+
+  for (int num_threads : {1, 3})
+  {
+    la::Vector<double> c0(map, 1), c1(map, 1);
+    la::MatrixCSR<double> B(pattern);
+    std::vector<fem::AssemblyHandle> handles;
+    handles.push_back(fem::assemble_vector_async(c0, L0, num_threads));
+    handles.push_back(fem::assemble_matrix_async(B, a, {}, num_threads));
+    handles.push_back(fem::assemble_vector_async(c1, L1, num_threads));
+    fem::wait_all(handles);
+    for (auto& h : handles)
+      CHECK(h.done());
+
+    const std::int32_t n = map->size_local();
+    for (std::int32_t i = 0; i < n; ++i)
+    {
+      CHECK(c0.array()[i] == b0.array()[i]);
+      CHECK(c1.array()[i] == b1.array()[i]);
+    }
+    CHECK(B.values() == A.values());
+  }
+
+  // A single handle
+  la::Vector<double> c(map, 1);
+  fem::AssemblyHandle h = fem::assemble_vector_async(c, L0);
+  h.wait();
+  CHECK(h.ready());
+  CHECK(h.done());
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    CHECK(c.array()[i] == b0.array()[i]);
+
+  // A started handle completes the communication when destroyed
+  la::Vector<double> d(map, 1);
+  {
+    fem::AssemblyHandle hd = fem::assemble_vector_async(d, L0);
+    hd.start();
+  }
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    CHECK(d.array()[i] == b0.array()[i]);
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the roofline estimates of the assembly counters
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/Table.h>
+#include <dolfinx/fem/assembly_profiling.h>
+#include <string>
+#include <variant>
+
+using namespace dolfinx;
+
+TEST_CASE("Kernel cost estimate", "[assembly_profiling]")
+{
+  // P1 matrix on a tetrahedron with a coefficient of 4 values
+  fem::KernelCost cost
+      = fem::impl::kernel_cost<double, double>(100, 1, {{4, 1}, {4, 1}}, 4, 4);
+  CHECK(cost.flops == 100);
+  CHECK(cost.bytes
+        == 4 * 8 + 4 * (4 + 3 * 8) + 2 * 4 * 4 + 2 * 16 * 8);
+
+  // Blocked vector on an interior facet
+  cost = fem::impl::kernel_cost<double, float>(0, 2, {{3, 2}}, 0, 3);
+  CHECK(cost.bytes == 2 * 3 * (4 + 3 * 4) + 2 * 3 * 4 + 2 * 12 * 8);
+
+  // Functional
+  cost = fem::impl::kernel_cost<float, float>(0, 1, {}, 2, 3);
+  CHECK(cost.bytes == 2 * 4 + 3 * (4 + 3 * 4));
+}
+
+TEST_CASE("Roofline columns", "[assembly_profiling]")
+{
+  fem::reset_assembly_profile();
+  fem::impl::add_assembly_profile("matrix: cell -1", 1000, 2.0, 1.0, 0.0, 0.5,
+                                  {4e6, 1e6});
+  fem::impl::add_assembly_profile("matrix: cell -1", 1000, 2.0, 1.0, 0.0, 0.5,
+                                  {4e6, 1e6});
+  Table table = fem::assembly_profile();
+  auto value = [&](const std::string& col)
+  { return std::get<double>(table.get("matrix: cell -1", col)); };
+  CHECK(std::abs(value("GFLOP/s") - 2.0) < 1e-12);
+  CHECK(std::abs(value("GB/s") - 0.5) < 1e-12);
+  CHECK(std::abs(value("flop/byte") - 4.0) < 1e-12);
+  fem::reset_assembly_profile();
+}
@@ -0,0 +1,522 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests comparing the specialised assembly paths with standard
+// assembly
+
+#include <algorithm>
+#include <array>
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/DirichletBC.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assemble_threaded_impl.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+using integrals_t
+    = std::map<fem::IntegralType, std::vector<fem::integral_data<double>>>;
+
+/// Area of the triangle with vertex coordinates `x`
+double area(const double* x)
+{
+  return 0.5
+         * std::abs((x[3] - x[0]) * (x[7] - x[1])
+                    - (x[6] - x[0]) * (x[4] - x[1]));
+}
+
+/// Length of facet `f` (opposite vertex `f`) of the triangle with
+/// vertex coordinates `x`
+double facet_length(const double* x, int f)
+{
+  const int v0 = (f + 1) % 3;
+  const int v1 = (f + 2) % 3;
+  return std::hypot(x[3 * v0] - x[3 * v1], x[3 * v0 + 1] - x[3 * v1 + 1]);
+}
+
+// Kernels for P1 on triangles with a P1 coefficient w, mimicking a
+// weighted mass matrix, a boundary mass matrix and a jump term on
+// interior facets
+
+void a_cell(double* A, const double* w, const double*, const double* x,
+            const int*, const std::uint8_t*)
+{
+  const double s = area(x) * (w[0] + w[1] + w[2]) / 36;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      A[3 * i + j] += s * (i == j ? 2 : 1);
+}
+
+void L_cell(double* b, const double* w, const double*, const double* x,
+            const int*, const std::uint8_t*)
+{
+  const double s = area(x) / 12;
+  for (int i = 0; i < 3; ++i)
+    b[i] += s * (w[i] + w[0] + w[1] + w[2]);
+}
+
+void a_exterior(double* A, const double*, const double*, const double* x,
+                const int* e, const std::uint8_t*)
+{
+  const double s = facet_length(x, e[0]) / 6;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      if (i != e[0] and j != e[0])
+        A[3 * i + j] += s * (i == j ? 2 : 1);
+}
+
+void L_exterior(double* b, const double* w, const double*, const double* x,
+                const int* e, const std::uint8_t*)
+{
+  const double s = facet_length(x, e[0]) / 2;
+  for (int i = 0; i < 3; ++i)
+    if (i != e[0])
+      b[i] += s * w[i];
+}
+
+void a_interior(double* A, const double* w, const double*, const double* x,
+                const int* e, const std::uint8_t*)
+{
+  // Rows and columns 0-2 are the dofs of cell 0, 3-5 of cell 1
+  const double s = facet_length(x, e[0]) * (1 + w[0] * w[3]) / 4;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      if (i != e[0] and j != e[1])
+      {
+        A[6 * i + 3 + j] -= s;
+        A[6 * (3 + j) + i] -= 2 * s;
+      }
+      if (i != e[0] and j != e[0])
+        A[6 * i + j] += s;
+      if (i != e[1] and j != e[1])
+        A[6 * (3 + i) + 3 + j] += 3 * s;
+    }
+  }
+}
+
+void L_interior(double* b, const double* w, const double*, const double* x,
+                const int* e, const std::uint8_t*)
+{
+  const double s = facet_length(x, e[0]) / 2;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (i != e[0])
+      b[i] += s * w[i];
+    if (i != e[1])
+      b[3 + i] -= 2 * s * w[3 + i];
+  }
+}
+
+/// Batched kernel for `N` cells (see fem::integral_data::batch_kernel)
+/// that calls the kernel `kernel` for each cell, where `size` is the
+/// size of the element tensor and the coefficient data has `cstride`
+/// values per cell
+auto batch(auto kernel, int size, int cstride, int N)
+{
+  return [=](double* A, const double* w, const double* c, const double* x,
+             const int* e, const std::uint8_t* p)
+  {
+    std::vector<double> Ab(size), wb(cstride), xb(9);
+    for (int b = 0; b < N; ++b)
+    {
+      std::ranges::fill(Ab, 0);
+      for (int i = 0; i < cstride; ++i)
+        wb[i] = w[i * N + b];
+      for (int i = 0; i < 9; ++i)
+        xb[i] = x[i * N + b];
+      kernel(Ab.data(), wb.data(), c, xb.data(), e, p);
+      for (int i = 0; i < size; ++i)
+        A[i * N + b] += Ab[i];
+    }
+  };
+}
+
+/// Mesh, P1 space and a coefficient in the space
+struct Problem
+{
+  std::shared_ptr<mesh::Mesh<double>> mesh;
+  std::shared_ptr<fem::FunctionSpace<double>> V;
+  std::shared_ptr<fem::Function<double>> w;
+};
+
+/// Create the problem on an n x n mesh. When run in parallel, cells
+/// that share a facet are ghosted.
+Problem create_problem(MPI_Comm comm = MPI_COMM_SELF, int n = 4)
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(
+          comm, {{{0, 0}, {1, 1}}}, {n, n}, mesh::CellType::triangle,
+          mesh::create_cell_partitioner(mesh::GhostMode::shared_facet)));
+  auto V = test::create_p1_space(mesh);
+  auto w = std::make_shared<fem::Function<double>>(V);
+  std::span<double> _w = w->x()->mutable_array();
+  for (std::size_t i = 0; i < _w.size(); ++i)
+    _w[i] = 1 + (i % 5) * 0.25;
+  return {mesh, V, w};
+}
+
+/// Integration entities of all cells or facets of a mesh
+std::vector<std::int32_t> entities(const mesh::Mesh<double>& mesh,
+                                   fem::IntegralType type)
+{
+  auto topology = mesh.topology_mutable();
+  const int tdim = topology->dim();
+  const int dim = type == fem::IntegralType::cell ? tdim : tdim - 1;
+  topology->create_connectivity(tdim - 1, tdim);
+  topology->create_connectivity(tdim, tdim - 1);
+  std::vector<std::int32_t> e(topology->index_map(dim)->size_local());
+  std::iota(e.begin(), e.end(), 0);
+  return fem::compute_integration_domains(type, *topology, e, dim);
+}
+
+/// Bilinear (rank 2) or linear (rank 1) form with a cell integral and,
+/// if `facets` is true, exterior and interior facet integrals. If
+/// `batch_size` is not zero, the cell integral has a batched kernel.
+fem::Form<double> create_form(const Problem& p, int rank, bool facets,
+                              int batch_size = 0)
+{
+  const bool a = rank == 2;
+  integrals_t integrals;
+  fem::integral_data<double>& cell = integrals[fem::IntegralType::cell]
+      .emplace_back(-1, a ? a_cell : L_cell,
+                    entities(*p.mesh, fem::IntegralType::cell),
+                    std::vector<int>{0});
+  if (batch_size > 0)
+  {
+    cell.batch_kernel = batch(a ? a_cell : L_cell, a ? 9 : 3, 3, batch_size);
+    cell.batch_size = batch_size;
+  }
+  if (facets)
+  {
+    integrals[fem::IntegralType::exterior_facet].emplace_back(
+        -1, a ? a_exterior : L_exterior,
+        entities(*p.mesh, fem::IntegralType::exterior_facet),
+        std::vector<int>{0});
+    integrals[fem::IntegralType::interior_facet].emplace_back(
+        -1, a ? a_interior : L_interior,
+        entities(*p.mesh, fem::IntegralType::interior_facet),
+        std::vector<int>{0});
+  }
+
+  std::vector<std::shared_ptr<const fem::FunctionSpace<double>>> V(rank,
+                                                                    p.V);
+  return fem::Form<double>(V, integrals, {p.w}, {}, false, {}, p.mesh);
+}
+
+/// Boundary condition on the exterior facets with non-zero values
+std::shared_ptr<const fem::DirichletBC<double>> create_bc(const Problem& p)
+{
+  auto topology = p.mesh->topology_mutable();
+  const int tdim = topology->dim();
+  topology->create_connectivity(tdim - 1, tdim);
+  std::vector<std::int32_t> facets = mesh::exterior_facet_indices(*topology);
+  auto g = std::make_shared<fem::Function<double>>(p.V);
+  std::span<double> _g = g->x()->mutable_array();
+  for (std::size_t i = 0; i < _g.size(); ++i)
+    _g[i] = 0.5 + (i % 3);
+  return std::make_shared<const fem::DirichletBC<double>>(
+      g, fem::locate_dofs_topological(*topology, *p.V->dofmap(), tdim - 1,
+                                      facets));
+}
+
+/// Number of (owned and ghost) dofs of a space
+std::size_t num_dofs(const fem::FunctionSpace<double>& V)
+{
+  auto map = V.dofmap()->index_map;
+  return V.dofmap()->index_map_bs() * (map->size_local() + map->num_ghosts());
+}
+
+/// Insertion function for a dense row-major matrix with n columns
+auto dense_mat_add(std::vector<double>& A, std::size_t n)
+{
+  return [&A, n](std::span<const std::int32_t> rows,
+                 std::span<const std::int32_t> cols,
+                 std::span<const double> vals)
+  {
+    for (std::size_t i = 0; i < rows.size(); ++i)
+      for (std::size_t j = 0; j < cols.size(); ++j)
+        A[n * rows[i] + cols[j]] += vals[i * cols.size() + j];
+    return 0;
+  };
+}
+
+/// Matrix of a bilinear form assembled with standard assembly
+std::vector<double> assemble_dense(const fem::Form<double>& a)
+{
+  const std::size_t n = num_dofs(*a.function_spaces()[0]);
+  std::vector<double> A(n * n, 0);
+  fem::assemble_matrix(dense_mat_add(A, n), a, {});
+  return A;
+}
+
+/// Vector of a linear form assembled with standard assembly
+std::vector<double> assemble_dense_vector(const fem::Form<double>& L)
+{
+  std::vector<double> b(num_dofs(*L.function_spaces()[0]), 0);
+  fem::assemble_vector(std::span(b), L);
+  return b;
+}
+
+void check_equal(std::span<const double> x, std::span<const double> y)
+{
+  REQUIRE(x.size() == y.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+    CHECK(x[i] == Catch::Approx(y[i]).margin(1e-12));
+}
+} // namespace
+
+TEST_CASE("Threaded assembly", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  fem::Form<double> a = create_form(p, 2, true);
+  fem::Form<double> L = create_form(p, 1, true);
+  const std::size_t n = num_dofs(*p.V);
+  std::vector<double> A0 = assemble_dense(a);
+  std::vector<double> b0 = assemble_dense_vector(L);
+
+  // Assemble twice, where the second call uses the cached colourings
+  for (int k = 0; k < 2; ++k)
+  {
+    std::vector<double> A(n * n, 0);
+    fem::assemble_matrix(dense_mat_add(A, n), a, {}, 3);
+    check_equal(A, A0);
+
+    std::vector<double> b(n, 0);
+    fem::assemble_vector(std::span(b), L, 3);
+    check_equal(b, b0);
+  }
+
+  // The colourings are cached on the forms
+  for (auto type : {fem::IntegralType::cell, fem::IntegralType::exterior_facet,
+                    fem::IntegralType::interior_facet})
+  {
+    const std::size_t num_entities
+        = a.domain(type, -1).size() / fem::impl::entity_stride(type);
+    bool computed = false;
+    auto colour = [&computed]()
+    {
+      computed = true;
+      return graph::AdjacencyList<std::int32_t>(0);
+    };
+    a.entity_colouring(type, -1, num_entities, colour);
+    L.entity_colouring(type, -1, num_entities, colour);
+    CHECK(!computed);
+  }
+}
+
+TEST_CASE("Batched cell kernels", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  std::vector<double> A0 = assemble_dense(create_form(p, 2, true));
+  std::vector<double> b0 = assemble_dense_vector(create_form(p, 1, true));
+
+  // The number of cells (32) is not a multiple of 5, so the last batch
+  // is padded
+  for (int batch_size : {4, 5})
+  {
+    fem::Form<double> a = create_form(p, 2, true, batch_size);
+    fem::Form<double> L = create_form(p, 1, true, batch_size);
+    REQUIRE(a.batch_kernel(fem::IntegralType::cell, -1).second
+            == batch_size);
+    check_equal(assemble_dense(a), A0);
+    check_equal(assemble_dense_vector(L), b0);
+  }
+}
+
+TEST_CASE("Vector assembly overlapping the ghost scatter",
+          "[assembly_variants]")
+{
+  Problem p = create_problem(MPI_COMM_WORLD, 6);
+  fem::Form<double> L = create_form(p, 1, true);
+  auto map = p.V->dofmap()->index_map;
+  const int bs = p.V->dofmap()->index_map_bs();
+
+  la::Vector<double> b0(map, bs);
+  fem::assemble_vector(b0.mutable_array(), L);
+  b0.scatter_rev(std::plus<double>());
+
+  // The partition orders the entities of each integral
+  auto partition = fem::compute_interface_partition(L);
+  for (auto& [key, part] : partition)
+  {
+    auto& [perm, num_interface] = part;
+    std::vector<std::int32_t> sorted = perm;
+    std::ranges::sort(sorted);
+    std::vector<std::int32_t> all(
+        L.domain(key.first, key.second).size()
+        / fem::impl::entity_stride(key.first));
+    std::iota(all.begin(), all.end(), 0);
+    CHECK(sorted == all);
+    CHECK(num_interface <= (std::int32_t)perm.size());
+  }
+
+  auto coefficients = fem::allocate_coefficient_storage(L);
+  fem::pack_coefficients(L, coefficients);
+  la::Vector<double> b(map, bs);
+  fem::assemble_vector_overlap(b, L, L.packed_constants(),
+                               fem::make_coefficients_span(coefficients),
+                               partition);
+  const std::size_t size = bs * map->size_local();
+  check_equal(b.array().first(size), b0.array().first(size));
+}
+
+TEST_CASE("Reassembly of a subset of cells", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  fem::Form<double> a = create_form(p, 2, true);
+  const std::size_t n = num_dofs(*p.V);
+  std::vector<double> A = assemble_dense(a);
+
+  // Cells with the coefficient dof that is changed
+  const std::int32_t dof = 7;
+  auto dofmap = p.V->dofmap()->map();
+  std::vector<std::int32_t> cells;
+  for (std::size_t c = 0; c < dofmap.extent(0); ++c)
+    for (std::size_t i = 0; i < dofmap.extent(1); ++i)
+      if (dofmap(c, i) == dof)
+        cells.push_back(c);
+  REQUIRE(!cells.empty());
+
+  // Subtract the contributions of the cells, change the coefficient
+  // and add the new contributions
+  fem::reassemble_matrix(dense_mat_add(A, n), a, std::span(cells), -1.0, {});
+  p.w->x()->mutable_array()[dof] += 3;
+  fem::reassemble_matrix(dense_mat_add(A, n), a, std::span(cells), 1.0, {});
+
+  check_equal(A, assemble_dense(a));
+}
+
+TEST_CASE("Fused system assembly", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  auto a = std::make_shared<const fem::Form<double>>(create_form(p, 2, true));
+  auto L = std::make_shared<const fem::Form<double>>(create_form(p, 1, true));
+  std::vector<std::shared_ptr<const fem::DirichletBC<double>>> bcs
+      = {create_bc(p)};
+  const std::size_t n = num_dofs(*p.V);
+  std::vector<double> x0(n);
+  for (std::size_t i = 0; i < n; ++i)
+    x0[i] = 0.1 * (i % 7);
+  const double scale = -1.5;
+
+  // Reference, from separate matrix assembly, vector assembly and
+  // lifting
+  std::vector<double> A0(n * n, 0);
+  fem::assemble_matrix(dense_mat_add(A0, n), *a, bcs);
+  std::vector<double> b0 = assemble_dense_vector(*L);
+  fem::apply_lifting<double, double>(b0, {a}, {bcs},
+                                     {std::span<const double>(x0)}, scale);
+
+  std::vector<double> A(n * n, 0), b(n, 0);
+  fem::assemble_system(dense_mat_add(A, n), std::span(b), *a, *L, bcs,
+                       std::span<const double>(x0), scale);
+  check_equal(A, A0);
+  check_equal(b, b0);
+}
+
+TEST_CASE("Assembly for several sets of coefficients", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  fem::Form<double> L = create_form(p, 1, true);
+  const std::size_t n = num_dofs(*p.V);
+
+  // Pack the coefficients of each set
+  const int k = 3;
+  std::vector<decltype(fem::allocate_coefficient_storage(L))> c(k);
+  std::vector<decltype(fem::make_coefficients_span(c[0]))> coeffs;
+  std::vector<std::vector<double>> b0(k, std::vector<double>(n, 0));
+  for (int j = 0; j < k; ++j)
+  {
+    std::span<double> w = p.w->x()->mutable_array();
+    for (std::size_t i = 0; i < w.size(); ++i)
+      w[i] = 1 + j + 0.5 * ((i + j) % 4);
+    c[j] = fem::allocate_coefficient_storage(L);
+    fem::pack_coefficients(L, c[j]);
+    coeffs.push_back(fem::make_coefficients_span(c[j]));
+
+    // Reference, assembled for each set in turn
+    fem::assemble_vector(std::span(b0[j]), L, L.packed_constants(),
+                         coeffs.back());
+  }
+
+  std::vector<double> b(n * k, 0);
+  fem::assemble_vectors(std::span(b), L, L.packed_constants(), coeffs);
+  for (int j = 0; j < k; ++j)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(b[i * k + j] == Catch::Approx(b0[j][i]).margin(1e-12));
+  }
+}
+
+TEST_CASE("Cached cell coordinate dofs", "[assembly_variants]")
+{
+  Problem p = create_problem();
+  fem::Form<double> a = create_form(p, 2, true);
+  fem::Form<double> a_ref = create_form(p, 2, true);
+  a.set_geometry_cache(1 << 20);
+  check_equal(assemble_dense(a), assemble_dense(a_ref));
+  REQUIRE(!a.coordinate_dofs(-1).empty());
+
+  // Check that the cached data holds the current coordinates
+  auto check_cache = [&]()
+  {
+    std::span<const double> x_cached = a.coordinate_dofs(-1);
+    std::span<const std::int32_t> cells = a.domain(fem::IntegralType::cell, -1);
+    const mesh::Geometry<double>& geometry = p.mesh->geometry();
+    std::span<const double> x = geometry.x();
+    auto x_dofmap = geometry.dofmap();
+    const std::size_t num_dofs_g = x_dofmap.extent(1);
+    REQUIRE(x_cached.size() == 3 * num_dofs_g * cells.size());
+    for (std::size_t c = 0; c < cells.size(); ++c)
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
+        for (int k = 0; k < 3; ++k)
+        {
+          CHECK(x_cached[3 * (c * num_dofs_g + i) + k]
+                == x[3 * x_dofmap(cells[c], i) + k]);
+        }
+  };
+
+  // Move the mesh through a newly acquired span
+  {
+    std::span<double> x = p.mesh->geometry().x();
+    for (std::size_t i = 0; i < x.size(); i += 3)
+      x[i] *= 2;
+  }
+  check_cache();
+  check_equal(assemble_dense(a), assemble_dense(a_ref));
+
+  // Move the mesh through a span that was acquired before the cache
+  // was last updated, and mark the geometry as modified
+  std::span<double> x = p.mesh->geometry().x();
+  check_equal(assemble_dense(a), assemble_dense(a_ref));
+  for (std::size_t i = 1; i < x.size(); i += 3)
+    x[i] += 0.5 * x[i] * x[i];
+  p.mesh->geometry().mark_modified();
+  check_cache();
+  check_equal(assemble_dense(a), assemble_dense(a_ref));
+}
@@ -0,0 +1,94 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for assembly over cell groups of different cell types
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/assembler.h>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel that adds the coefficient value to each entry
+void kernel(double* A, const double* w, const double*, const double*,
+            const int*, const std::uint8_t*, int size)
+{
+  for (int i = 0; i < size; ++i)
+    A[i] += w[0];
+}
+} // namespace
+
+TEST_CASE("Cell group assembly", "[cell_groups]")
+{
+  using mdspan2_t = fem::CellGroup<double>::mdspan2_t;
+
+  // A quadrilateral and a triangle that share the dofs 1 and 3, with
+  // one dof per vertex
+  std::vector<double> x(3 * 5, 0);
+  std::vector<std::int32_t> quad = {0, 1, 2, 3};
+  std::vector<std::int32_t> tri = {1, 4, 3};
+
+  std::vector<fem::CellGroup<double>> groups(2);
+  std::array<std::vector<double>, 2> coeffs = {{{1.0}, {2.0}}};
+  std::array<int, 2> sizes;
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    fem::CellGroup<double>& g = groups[i];
+    std::vector<std::int32_t>& dofs = i == 0 ? quad : tri;
+    const int n = dofs.size();
+    g.x_dofmap = mdspan2_t(dofs.data(), 1, n);
+    g.dofmaps = {mdspan2_t(dofs.data(), 1, n), mdspan2_t(dofs.data(), 1, n)};
+    g.cells = {0};
+    g.coeffs = coeffs[i];
+    g.cstride = 1;
+    g.kernel = [&sizes, i](double* A, const double* w, const double* c,
+                           const double* xc, const int* e,
+                           const std::uint8_t* p)
+    { kernel(A, w, c, xc, e, p, sizes[i]); };
+  }
+
+  SECTION("vector")
+  {
+    sizes = {4, 3};
+
+    std::vector<double> b(5, 0);
+    fem::assemble_vector(std::span(b), groups, std::span<const double>(x),
+                         std::span<const double>());
+    std::vector<double> expected = {1, 3, 1, 3, 2};
+    CHECK(b == expected);
+  }
+
+  SECTION("matrix")
+  {
+    sizes = {16, 9};
+
+    std::vector<double> A(25, 0);
+    auto mat_add = [&A](std::span<const std::int32_t> rows,
+                        std::span<const std::int32_t> cols,
+                        std::span<const double> vals)
+    {
+      for (std::size_t i = 0; i < rows.size(); ++i)
+        for (std::size_t j = 0; j < cols.size(); ++j)
+          A[5 * rows[i] + cols[j]] += vals[i * cols.size() + j];
+      return 0;
+    };
+
+    // Zero row 4
+    std::vector<std::int8_t> bc0 = {0, 0, 0, 0, 1};
+    fem::assemble_matrix(mat_add, groups, std::span<const double>(x),
+                         std::span<const double>(), bc0, {});
+    CHECK(A[5 * 0 + 0] == 1);
+    CHECK(A[5 * 1 + 3] == 3);
+    CHECK(A[5 * 3 + 4] == 2);
+    CHECK(A[5 * 4 + 1] == 0);
+    CHECK(A[5 * 0 + 4] == 0);
+  }
+}
@@ -0,0 +1,117 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the precomputed DOF transformations
+
+#include <algorithm>
+#include <basix/finite-element.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+std::shared_ptr<const fem::FiniteElement<double>>
+create_element(basix::element::family family, int degree)
+{
+  return std::make_shared<const fem::FiniteElement<double>>(
+      basix::create_element<double>(family, basix::cell::type::tetrahedron,
+                                    degree,
+                                    basix::element::lagrange_variant::legendre,
+                                    basix::element::dpc_variant::unset, false),
+      1);
+}
+
+/// Check the precomputed transformations of `element` against the
+/// transformations returned by dof_transformation_fn() and
+/// dof_transformation_right_fn() for the data layouts used in
+/// interior facet assembly, where the element tensor holds the
+/// dofs of two cells
+void check_transformations(const fem::FiniteElement<double>& element,
+                           std::span<const std::uint32_t> cell_info)
+{
+  REQUIRE(element.needs_dof_transformations());
+  const int dim = element.space_dimension();
+  const int num_cells = cell_info.size();
+
+  auto T = element.dof_transformation_fn<double>(fem::doftransform::standard);
+  auto P = element.precomputed_dof_transformation_fn<double>(
+      fem::doftransform::standard, cell_info);
+  auto Tt = element.dof_transformation_right_fn<double>(
+      fem::doftransform::transpose);
+  auto Pt = element.precomputed_dof_transformation_right_fn<double>(
+      fem::doftransform::transpose, cell_info);
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  // Element tensor of an interior facet integral of shape
+  // (2 * dim, 2 * dim)
+  const int n = 2 * dim;
+  std::vector<double> A(n * n);
+  for (int c0 = 0; c0 < num_cells; ++c0)
+  {
+    const int c1 = (c0 + 1) % num_cells;
+    std::ranges::generate(A, [&]() { return dist(rng); });
+    std::vector<double> B = A;
+
+    // Left transformations of the rows of the two cells
+    T(std::span(A).first(dim * n), cell_info, c0, n);
+    T(std::span(A).subspan(dim * n), cell_info, c1, n);
+    P(std::span(B).first(dim * n), cell_info, c0, n);
+    P(std::span(B).subspan(dim * n), cell_info, c1, n);
+    for (std::size_t i = 0; i < A.size(); ++i)
+      CHECK(B[i] == Catch::Approx(A[i]).margin(1e-12));
+
+    // Right transformations of the columns of the two cells. The rows
+    // have stride 2 * dim.
+    Tt(A, cell_info, c0, n);
+    Pt(B, cell_info, c0, n);
+    for (int row = 0; row < n; ++row)
+    {
+      Tt(std::span(A).subspan(row * n + dim, dim), cell_info, c1, 1);
+      Pt(std::span(B).subspan(row * n + dim, dim), cell_info, c1, 1);
+    }
+    for (std::size_t i = 0; i < A.size(); ++i)
+      CHECK(B[i] == Catch::Approx(A[i]).margin(1e-12));
+  }
+}
+} // namespace
+
+TEST_CASE("Precomputed DOF transformations", "[dof_transformations]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0, 0, 0}, {1, 1, 1}}}, {2, 2, 1},
+      mesh::CellType::tetrahedron));
+  mesh->topology_mutable()->create_entity_permutations();
+  const std::vector<std::uint32_t>& cell_info
+      = mesh->topology()->get_cell_permutation_info();
+
+  SECTION("N1curl")
+  {
+    auto element = create_element(basix::element::family::N1E, 2);
+    check_transformations(*element, cell_info);
+  }
+
+  SECTION("RT x N1curl")
+  {
+    fem::FiniteElement<double> element(
+        std::vector<std::shared_ptr<const fem::FiniteElement<double>>>{
+            create_element(basix::element::family::RT, 2),
+            create_element(basix::element::family::N1E, 1)});
+    check_transformations(element, cell_info);
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the cached interior facet data of forms
+
+#include "forms.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel that adds the local dof index plus one to each entry
+void kernel(double* b, const double*, const double*, const double*,
+            const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 6; ++i)
+    b[i] += i + 1;
+}
+} // namespace
+
+TEST_CASE("Interior facet data", "[facet_pairs]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {2, 1}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh, true);
+
+  // Interior facets of the mesh
+  auto topology = mesh->topology();
+  const int tdim = topology->dim();
+  mesh->topology_mutable()->create_connectivity(tdim - 1, tdim);
+  auto f_to_c = topology->connectivity(tdim - 1, tdim);
+  std::vector<std::int32_t> interior;
+  for (std::int32_t f = 0; f < f_to_c->num_nodes(); ++f)
+    if (f_to_c->num_links(f) == 2)
+      interior.push_back(f);
+  std::vector<std::int32_t> facets = fem::compute_integration_domains(
+      fem::IntegralType::interior_facet, *topology, interior, tdim - 1);
+
+  std::map<fem::IntegralType, std::vector<fem::integral_data<double>>>
+      integrals;
+  integrals[fem::IntegralType::interior_facet].emplace_back(
+      -1, kernel, facets, std::vector<int>{});
+  fem::Form<double> L({V}, integrals, {}, {}, false, {}, mesh);
+
+  const fem::integral_group& group
+      = L.integral_groups(fem::IntegralType::interior_facet).front();
+  CHECK(L.facet_pairs(group) == nullptr);
+
+  std::vector<double> b0(V->dofmap()->index_map->size_local(), 0);
+  fem::assemble_vector(std::span(b0), L);
+
+  L.set_facet_pair_cache(true);
+  const fem::facet_pair_data* pairs = L.facet_pairs(group);
+  REQUIRE(pairs);
+  CHECK(L.facet_pairs(group) == pairs);
+  CHECK(pairs->dofs[1].empty());
+  CHECK(pairs->perms.empty());
+
+  // The dofs of the two cells of each facet are stored contiguously
+  std::vector<std::int32_t> dofs;
+  for (std::size_t i = 0; i < facets.size(); i += 2)
+  {
+    auto cell_dofs = V->dofmap()->cell_dofs(facets[i]);
+    dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+  }
+  CHECK(pairs->dofs[0] == dofs);
+
+  // Assembly with the cached data gives the same vector
+  std::vector<double> b1(b0.size(), 0);
+  fem::assemble_vector(std::span(b1), L);
+  CHECK(b1 == b0);
+
+  L.set_facet_pair_cache(false);
+  CHECK(L.facet_pairs(group) == nullptr);
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// P1 spaces on triangles and forms with hand-written cell kernels
+
+#pragma once
+
+#include <basix/finite-element.h>
+#include <concepts>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/types.h>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/traits.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace dolfinx::test
+{
+/// Create the (discontinuous) P1 space on a triangle mesh
+template <std::floating_point T>
+std::shared_ptr<fem::FunctionSpace<T>>
+create_p1_space(std::shared_ptr<mesh::Mesh<T>> mesh,
+                bool discontinuous = false)
+{
+  auto element = basix::create_element<T>(
+      basix::element::family::P, basix::cell::type::triangle, 1,
+      basix::element::lagrange_variant::unset,
+      basix::element::dpc_variant::unset, discontinuous);
+  return std::make_shared<fem::FunctionSpace<T>>(
+      fem::create_functionspace<T>(mesh, element, {}));
+}
+
+/// Kernel for the 3x3 matrix a I + b J, where J is the matrix of ones
+template <typename T, int a, int b>
+void kernel_IJ(T* A, const T*, const T*, const scalar_value_type_t<T>*,
+               const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      A[3 * i + j] += (i == j ? a : 0) + b;
+}
+
+/// Create a form on the spaces `V` with the single cell integral
+/// `kernel` over all owned cells
+template <dolfinx::scalar T, std::floating_point U = scalar_value_type_t<T>>
+fem::Form<T, U> create_cell_form(
+    const std::vector<std::shared_ptr<const fem::FunctionSpace<U>>>& V,
+    fem::FEkernel<T> auto kernel,
+    const std::vector<std::shared_ptr<const fem::Constant<T>>>& constants
+    = {})
+{
+  auto mesh = V[0]->mesh();
+  const int tdim = mesh->topology()->dim();
+  std::vector<std::int32_t> cells(
+      mesh->topology()->index_map(tdim)->size_local());
+  std::iota(cells.begin(), cells.end(), 0);
+  std::map<fem::IntegralType, std::vector<fem::integral_data<T, U>>>
+      integrals;
+  integrals[fem::IntegralType::cell].emplace_back(-1, kernel, cells,
+                                                  std::vector<int>{});
+  return fem::Form<T, U>(V, integrals, {}, constants, false, {}, mesh);
+}
+} // namespace dolfinx::test
@@ -4,6 +4,7 @@
 //
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 
 #include <basix/finite-element.h>
@@ -28,3 +29,105 @@ TEST_CASE("Create Function Space (mismatch of elements)", "[functionspace]")
 
   CHECK_THROWS(fem::create_functionspace<double>(mesh, element, {}));
 }
+
+TEST_CASE("Shared dofmaps of identical elements", "[functionspace]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      dolfinx::mesh::create_rectangle<double>(
+          MPI_COMM_SELF, {{{0, 0}, {1, 1}}}, {2, 2}, mesh::CellType::triangle));
+
+  auto element = [](int degree)
+  {
+    return basix::create_element<double>(
+        basix::element::family::P, basix::cell::type::triangle, degree,
+        basix::element::lagrange_variant::gll_warped,
+        basix::element::dpc_variant::unset, false);
+  };
+
+  auto V0 = fem::create_functionspace<double>(mesh, element(1), {});
+  auto V1 = fem::create_functionspace<double>(mesh, element(1), {});
+  auto V2 = fem::create_functionspace<double>(mesh, element(2), {});
+  auto V3 = fem::create_functionspace<double>(mesh, element(1), {2});
+  CHECK(V0.dofmap() == V1.dofmap());
+  CHECK(V0.dofmap()->index_map == V1.dofmap()->index_map);
+  CHECK(V0.dofmap() != V2.dofmap());
+  CHECK(V0.dofmap() != V3.dofmap());
+
+  // Spaces on another mesh do not share the dofmap
+  auto mesh1 = std::make_shared<mesh::Mesh<double>>(
+      dolfinx::mesh::create_rectangle<double>(
+          MPI_COMM_SELF, {{{0, 0}, {1, 1}}}, {2, 2}, mesh::CellType::triangle));
+  auto W = fem::create_functionspace<double>(mesh1, element(1), {});
+  CHECK(V0.dofmap() != W.dofmap());
+
+  // The dofmaps are held by the topology
+  CHECK(mesh->topology()->dofmap_cache().size() == 3);
+  CHECK(mesh1->topology()->dofmap_cache().size() == 1);
+
+  // A dofmap is created after the cache is cleared
+  fem::clear_dofmap_cache(*mesh->topology_mutable());
+  CHECK(mesh->topology()->dofmap_cache().empty());
+  auto V4 = fem::create_functionspace<double>(mesh, element(1), {});
+  CHECK(V0.dofmap() != V4.dofmap());
+}
+
+TEST_CASE("Degree-1 dofmaps share the mesh topology", "[functionspace]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      dolfinx::mesh::create_rectangle<double>(
+          MPI_COMM_SELF, {{{0, 0}, {1, 1}}}, {2, 2}, mesh::CellType::triangle));
+  auto topology = mesh->topology();
+  auto c_to_v = topology->connectivity(2, 0);
+
+  auto element = [](int degree)
+  {
+    return basix::create_element<double>(
+        basix::element::family::P, basix::cell::type::triangle, degree,
+        basix::element::lagrange_variant::gll_warped,
+        basix::element::dpc_variant::unset, false);
+  };
+
+  // Scalar and blocked degree-1 dofmaps are the cell-to-vertex
+  // connectivity
+  for (auto value_shape : {std::vector<std::size_t>{},
+                           std::vector<std::size_t>{2}})
+  {
+    auto V = fem::create_functionspace<double>(mesh, element(1), value_shape);
+    CHECK(V.dofmap()->index_map == topology->index_map(0));
+    CHECK(V.dofmap()->map().data_handle() == c_to_v->array().data());
+    CHECK(V.dofmap()->bs() == (value_shape.empty() ? 1 : 2));
+    for (std::int32_t c = 0; c < c_to_v->num_nodes(); ++c)
+    {
+      std::span<const std::int32_t> dofs = V.dofmap()->cell_dofs(c);
+      CHECK(std::ranges::equal(dofs, c_to_v->links(c)));
+    }
+  }
+
+  // Higher degree dofmaps are built
+  auto V2 = fem::create_functionspace<double>(mesh, element(2), {});
+  CHECK(V2.dofmap()->index_map != topology->index_map(0));
+  CHECK(V2.dofmap()->map().data_handle() != c_to_v->array().data());
+}
+
+TEST_CASE("Collapsed subspaces share the dofmap", "[functionspace]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      dolfinx::mesh::create_rectangle<double>(
+          MPI_COMM_SELF, {{{0, 0}, {1, 1}}}, {2, 2}, mesh::CellType::triangle));
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::triangle, 2,
+      basix::element::lagrange_variant::gll_warped,
+      basix::element::dpc_variant::unset, false);
+  auto V = fem::create_functionspace<double>(mesh, element, {2});
+
+  // The collapsed dofmap is computed once for each component
+  auto [V0, map0] = V.sub({0}).collapse();
+  auto [V0b, map0b] = V.sub({0}).collapse();
+  auto [V1, map1] = V.sub({1}).collapse();
+  CHECK(V0.dofmap() == V0b.dofmap());
+  CHECK(map0 == map0b);
+  CHECK(V0.dofmap() != V1.dofmap());
+  CHECK(map0 != map1);
+  for (std::size_t i = 0; i < map0.size(); ++i)
+    CHECK(map0[i] % 2 == 0);
+}
@@ -0,0 +1,137 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the grouping of integrals with the same kernel
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/assemble_threaded_impl.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+void kernel(double*, const double*, const double*, const double*, const int*,
+            const std::uint8_t*)
+{
+}
+} // namespace
+
+TEST_CASE("Integral groups", "[integral_groups]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {1, 1}, mesh::CellType::triangle));
+
+  // Exterior facet integrals 1 and 2 share a kernel, integral 3 has a
+  // different kernel. Cell integrals are not grouped.
+  using data_t = fem::integral_data<double>;
+  auto other = [](double*, const double*, const double*, const double*,
+                  const int*, const std::uint8_t*) {};
+  std::map<fem::IntegralType, std::vector<data_t>> integrals;
+  integrals[fem::IntegralType::exterior_facet].emplace_back(
+      1, kernel, std::vector<std::int32_t>{0, 1}, std::vector<int>{});
+  integrals[fem::IntegralType::exterior_facet].emplace_back(
+      2, kernel, std::vector<std::int32_t>{1, 0, 1, 2}, std::vector<int>{});
+  integrals[fem::IntegralType::exterior_facet].emplace_back(
+      3, other, std::vector<std::int32_t>{0, 2}, std::vector<int>{});
+  integrals[fem::IntegralType::cell].emplace_back(
+      1, kernel, std::vector<std::int32_t>{0}, std::vector<int>{});
+  integrals[fem::IntegralType::cell].emplace_back(
+      2, kernel, std::vector<std::int32_t>{1}, std::vector<int>{});
+  fem::Form<double> form({}, integrals, {}, {}, false, {}, mesh);
+
+  const std::vector<fem::integral_group>& groups
+      = form.integral_groups(fem::IntegralType::exterior_facet);
+  REQUIRE(groups.size() == 2);
+  std::vector<int> ids0 = {1, 2}, ids1 = {3};
+  CHECK(groups[0].ids == ids0);
+  CHECK(groups[1].ids == ids1);
+
+  std::span<const std::int32_t> e
+      = form.domain(fem::IntegralType::exterior_facet, groups[0]);
+  std::vector<std::int32_t> expected = {0, 1, 1, 0, 1, 2};
+  CHECK(std::vector(e.begin(), e.end()) == expected);
+  CHECK(std::ranges::equal(
+      form.domain(fem::IntegralType::exterior_facet, groups[0], *mesh),
+      expected));
+  CHECK(form.domain(fem::IntegralType::exterior_facet, groups[1]).data()
+        == form.domain(fem::IntegralType::exterior_facet, 3).data());
+
+  CHECK(form.integral_groups(fem::IntegralType::cell).size() == 2);
+
+  // Coefficients of the integrals in a group are concatenated
+  std::vector<double> c1 = {1, 2}, c2 = {3, 4, 5, 6}, c3 = {7, 8};
+  std::map<std::pair<fem::IntegralType, int>,
+           std::pair<std::span<const double>, int>>
+      coeffs = {{{fem::IntegralType::exterior_facet, 1}, {c1, 2}},
+                {{fem::IntegralType::exterior_facet, 2}, {c2, 2}},
+                {{fem::IntegralType::exterior_facet, 3}, {c3, 2}}};
+  std::vector<double> storage;
+  auto [c, cstride] = fem::impl::group_coefficients(
+      fem::IntegralType::exterior_facet, groups[0], coeffs, storage);
+  std::vector<double> c12 = {1, 2, 3, 4, 5, 6};
+  CHECK(cstride == 2);
+  CHECK(std::vector(c.begin(), c.end()) == c12);
+  std::span<const double> c_3
+      = fem::impl::group_coefficients(fem::IntegralType::exterior_facet,
+                                      groups[1], coeffs, storage)
+            .first;
+  CHECK(c_3.data() == c3.data());
+}
+
+TEST_CASE("Integral entities in another mesh", "[integral_groups]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {1, 1}, mesh::CellType::triangle));
+  auto mesh1 = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {1, 1}, mesh::CellType::triangle));
+
+  // Cell i of mesh is cell 1 - i of mesh1
+  using data_t = fem::integral_data<double>;
+  std::map<fem::IntegralType, std::vector<data_t>> integrals;
+  integrals[fem::IntegralType::cell].emplace_back(
+      1, kernel, std::vector<std::int32_t>{0, 1}, std::vector<int>{});
+  integrals[fem::IntegralType::exterior_facet].emplace_back(
+      1, kernel, std::vector<std::int32_t>{0, 1}, std::vector<int>{});
+  integrals[fem::IntegralType::exterior_facet].emplace_back(
+      2, kernel, std::vector<std::int32_t>{1, 2}, std::vector<int>{});
+  std::vector<std::int32_t> map = {1, 0};
+  fem::Form<double> form({}, integrals, {}, {}, false,
+                         {{mesh1, std::span<const std::int32_t>(map)}},
+                         mesh);
+
+  // The translated entities are computed once and are not copied
+  std::span<const std::int32_t> cells
+      = form.domain(fem::IntegralType::cell, 1, *mesh1);
+  CHECK(std::ranges::equal(cells, std::vector<std::int32_t>{1, 0}));
+  CHECK(form.domain(fem::IntegralType::cell, 1, *mesh1).data()
+        == cells.data());
+  CHECK(form.domain(fem::IntegralType::cell, 1, *mesh).data()
+        == form.domain(fem::IntegralType::cell, 1).data());
+
+  CHECK(std::ranges::equal(
+      form.domain(fem::IntegralType::exterior_facet, 2, *mesh1),
+      std::vector<std::int32_t>{0, 2}));
+  const std::vector<fem::integral_group>& groups
+      = form.integral_groups(fem::IntegralType::exterior_facet);
+  REQUIRE(groups.size() == 1);
+  CHECK(std::ranges::equal(
+      form.domain(fem::IntegralType::exterior_facet, groups[0], *mesh1),
+      std::vector<std::int32_t>{1, 1, 0, 2}));
+}
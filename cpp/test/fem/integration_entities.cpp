@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the ordering of integration entities
+
+#include <algorithm>
+#include "forms.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel that adds the local facet index plus one to each entry
+void kernel(double* b, const double*, const double*, const double*,
+            const int* local_facet, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    b[i] += local_facet[0] + 1;
+}
+} // namespace
+
+TEST_CASE("Sort integration entities", "[integration_entities]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {4, 3}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh);
+
+  auto topology = mesh->topology_mutable();
+  const int tdim = topology->dim();
+  topology->create_connectivity(tdim - 1, tdim);
+  topology->create_connectivity(tdim, tdim - 1);
+  std::vector<std::int32_t> bfacets = mesh::exterior_facet_indices(*topology);
+
+  std::vector<std::int32_t> facets0 = fem::compute_integration_domains(
+      fem::IntegralType::exterior_facet, *topology, bfacets, tdim - 1);
+  std::vector<std::int32_t> facets1 = fem::compute_integration_domains(
+      fem::IntegralType::exterior_facet, *topology, bfacets, tdim - 1, true);
+  REQUIRE(facets1.size() == facets0.size());
+  for (std::size_t i = 2; i < facets1.size(); i += 2)
+    CHECK(facets1[i - 2] <= facets1[i]);
+
+  // The permutation maps the sorted entities to the input entities
+  std::vector<std::int32_t> facets2 = facets0;
+  std::vector<std::int32_t> perm = fem::sort_integration_entities(
+      fem::IntegralType::exterior_facet, facets2);
+  CHECK(facets2 == facets1);
+  REQUIRE(perm.size() == facets0.size() / 2);
+  for (std::size_t i = 0; i < perm.size(); ++i)
+  {
+    CHECK(facets2[2 * i] == facets0[2 * perm[i]]);
+    CHECK(facets2[2 * i + 1] == facets0[2 * perm[i] + 1]);
+  }
+
+  // Interior facets are sorted by the first cell
+  std::vector<std::int32_t> interior;
+  auto f_to_c = topology->connectivity(tdim - 1, tdim);
+  for (std::int32_t f = 0; f < f_to_c->num_nodes(); ++f)
+    if (f_to_c->num_links(f) == 2)
+      interior.push_back(f);
+  std::vector<std::int32_t> ifacets = fem::compute_integration_domains(
+      fem::IntegralType::interior_facet, *topology, interior, tdim - 1, true);
+  REQUIRE(ifacets.size() == 4 * interior.size());
+  for (std::size_t i = 4; i < ifacets.size(); i += 4)
+    CHECK(ifacets[i - 4] <= ifacets[i]);
+
+  // Assembly does not depend on the order
+  auto assemble = [&](const std::vector<std::int32_t>& facets)
+  {
+    std::map<fem::IntegralType, std::vector<fem::integral_data<double>>>
+        integrals;
+    integrals[fem::IntegralType::exterior_facet].emplace_back(
+        -1, kernel, facets, std::vector<int>{});
+    fem::Form<double> L({V}, integrals, {}, {}, false, {}, mesh);
+    std::vector<double> b(V->dofmap()->index_map->size_local(), 0);
+    fem::assemble_vector(std::span(b), L);
+    return b;
+  };
+  CHECK(assemble(facets1) == assemble(facets0));
+
+  CHECK_THROWS(fem::sort_integration_entities(
+      fem::IntegralType::exterior_facet, std::span(facets2).first(3)));
+}
@@ -0,0 +1,133 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the matrix-free interpolation operator
+
+#include <basix/finite-element.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/InterpolationOperator.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+std::shared_ptr<fem::FunctionSpace<double>>
+create_space(std::shared_ptr<mesh::Mesh<double>> mesh, int degree)
+{
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::triangle, degree,
+      basix::element::lagrange_variant::gll_warped,
+      basix::element::dpc_variant::unset, false);
+  return std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace<double>(mesh, element, {}));
+}
+
+/// Vector with the values of f at the dof coordinates of V
+la::Vector<double> interpolate(const fem::FunctionSpace<double>& V,
+                               auto&& f)
+{
+  la::Vector<double> u(V.dofmap()->index_map, 1);
+  std::vector<double> x = V.tabulate_dof_coordinates(false);
+  std::span<double> _u = u.mutable_array();
+  for (std::size_t i = 0; i < _u.size(); ++i)
+    _u[i] = f(x[3 * i], x[3 * i + 1]);
+  return u;
+}
+} // namespace
+
+TEST_CASE("Interpolation operator", "[interpolation_operator]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0, 0}, {1, 1}}},
+                                     {3, 2}, mesh::CellType::triangle));
+  auto V1 = create_space(mesh, 1);
+  auto V4 = create_space(mesh, 4);
+  fem::InterpolationOperator<double> A(V1, V4);
+  CHECK(A.matrix().second[0] == 15);
+  CHECK(A.matrix().second[1] == 3);
+
+  // Linear functions are interpolated exactly
+  auto f = [](double x, double y) { return 1 + x + 2 * y; };
+  la::Vector<double> u1 = interpolate(*V1, f);
+  la::Vector<double> u4(V4->dofmap()->index_map, 1);
+  A.apply(u1, u4);
+  la::Vector<double> u4_exact = interpolate(*V4, f);
+  for (std::size_t i = 0; i < u4.array().size(); ++i)
+    CHECK(u4.array()[i] == Catch::Approx(u4_exact.array()[i]));
+
+  // (A u1, r4) = (u1, A^T r4)
+  la::Vector<double> r4
+      = interpolate(*V4, [](double x, double y) { return x * x - 3 * y; });
+  la::Vector<double> r1(V1->dofmap()->index_map, 1);
+  A.apply_transpose(r4, r1);
+  r1.scatter_fwd();
+  CHECK(la::inner_product(u4, r4)
+        == Catch::Approx(la::inner_product(u1, r1)));
+}
+
+TEST_CASE("Interpolation operator with nonmatching maps",
+          "[interpolation_operator]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0, 0}, {1, 1}}},
+                                     {3, 2}, mesh::CellType::triangle));
+  auto V0 = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace<double>(
+          mesh,
+          basix::create_element<double>(
+              basix::element::family::N1E, basix::cell::type::triangle, 2,
+              basix::element::lagrange_variant::legendre,
+              basix::element::dpc_variant::unset, false),
+          {}));
+  auto V1 = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace<double>(
+          mesh,
+          basix::create_element<double>(
+              basix::element::family::P, basix::cell::type::triangle, 2,
+              basix::element::lagrange_variant::gll_warped,
+              basix::element::dpc_variant::unset, true),
+          {2}));
+  fem::InterpolationOperator<double> A(V0, V1);
+  CHECK(A.nonmatching_maps());
+  CHECK(A.matrix().second[0] == 12);
+  CHECK(A.matrix().second[1] == 8);
+
+  fem::Function<double> u0(V0);
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::ranges::generate(u0.x()->mutable_array(), [&]() { return dist(rng); });
+  u0.x()->scatter_fwd();
+
+  // The cell matrices are recomputed when the mesh moves
+  for (int step = 0; step < 2; ++step)
+  {
+    fem::Function<double> u1(V1);
+    u1.interpolate(u0);
+    la::Vector<double> v1(V1->dofmap()->index_map, V1->dofmap()->bs());
+    A.apply(*u0.x(), v1);
+    for (std::size_t i = 0; i < v1.array().size(); ++i)
+    {
+      CHECK(v1.array()[i]
+            == Catch::Approx(u1.x()->array()[i]).margin(1e-12));
+    }
+
+    std::span<double> x = mesh->geometry().x();
+    for (std::size_t i = 0; i < x.size(); i += 3)
+      x[i] += 0.1 * x[i + 1] * x[i + 1];
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for block diagonal and lumped inverse mass matrices
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/InverseMass.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+std::shared_ptr<const fem::Form<double>>
+create_form(std::shared_ptr<fem::FunctionSpace<double>> V)
+{
+  // Cell matrix 2I + J, where J is the matrix of ones
+  return std::make_shared<const fem::Form<double>>(
+      test::create_cell_form<double>({V, V}, test::kernel_IJ<double, 2, 1>));
+}
+} // namespace
+
+TEST_CASE("Inverse mass", "[inverse_mass]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {2, 2}, mesh::CellType::triangle));
+  const int num_cells = mesh->topology()->index_map(2)->size_local();
+
+  SECTION("cell blocks")
+  {
+    auto V = test::create_p1_space(mesh, true);
+    auto dofmap = V->dofmap();
+    fem::InverseMass<double> Minv(*create_form(V));
+    REQUIRE(Minv.num_cells() == std::size_t(num_cells));
+    CHECK(Minv.diagonal().empty());
+
+    // (2I + J)^{-1} x = (x - sum(x) / 5) / 2 on each cell
+    la::Vector<double> x(dofmap->index_map, dofmap->index_map_bs());
+    std::iota(x.mutable_array().begin(), x.mutable_array().end(), 1.0);
+    std::vector<double> x0(x.array().begin(), x.array().end());
+    std::vector<double> y(x0.size(), 0);
+    Minv.apply(x0, y, 2);
+    Minv.apply(x);
+    for (std::int32_t c = 0; c < num_cells; ++c)
+    {
+      auto dofs = dofmap->cell_dofs(c);
+      double sum = 0;
+      for (std::int32_t dof : dofs)
+        sum += x0[dof];
+      for (std::int32_t dof : dofs)
+      {
+        CHECK(y[dof] == Catch::Approx((x0[dof] - sum / 5) / 2));
+        CHECK(x.array()[dof] == Catch::Approx(y[dof]));
+      }
+    }
+  }
+
+  SECTION("shared dofs")
+  {
+    auto V = test::create_p1_space(mesh, false);
+    CHECK_THROWS(fem::InverseMass<double>(*create_form(V)));
+  }
+
+  SECTION("lumped")
+  {
+    auto V = test::create_p1_space(mesh, false);
+    auto dofmap = V->dofmap();
+    std::vector<int> num_dof_cells(dofmap->index_map->size_local(), 0);
+    for (std::int32_t c = 0; c < num_cells; ++c)
+      for (std::int32_t dof : dofmap->cell_dofs(c))
+        ++num_dof_cells[dof];
+
+    // Row sums are 5 and diagonal entries 3 on each cell
+    for (auto [lumping, entry] :
+         {std::pair{fem::MassLumping::row_sum, 5.0},
+          std::pair{fem::MassLumping::diagonal, 3.0}})
+    {
+      fem::InverseMass<double> Minv(*create_form(V), lumping);
+      CHECK(Minv.num_cells() == 0);
+      std::span<const double> d = Minv.diagonal();
+      REQUIRE(d.size() == num_dof_cells.size());
+      la::Vector<double> x(dofmap->index_map, dofmap->index_map_bs());
+      std::ranges::fill(x.mutable_array(), 2.0);
+      Minv.apply(x, 2);
+      for (std::size_t i = 0; i < d.size(); ++i)
+      {
+        CHECK(d[i] == Catch::Approx(1 / (entry * num_dof_cells[i])));
+        CHECK(x.array()[i] == Catch::Approx(2 * d[i]));
+      }
+    }
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for assembly of kernels without a Form
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Kernel assembly", "[kernel_assembly]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {2, 2}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh);
+  const int num_cells = mesh->topology()->index_map(2)->size_local();
+  std::vector<std::int32_t> cells(num_cells);
+  std::iota(cells.begin(), cells.end(), 0);
+
+  // Kernel that adds the x-coordinate of each vertex times a
+  // coefficient to the entries of the element tensor
+  auto kernel = [](double* A, const double* w, const double*,
+                   const double* x, const int*, const std::uint8_t*)
+  {
+    for (int i = 0; i < 3; ++i)
+      A[i] += w[0] * x[3 * i];
+  };
+  std::vector<double> coeffs(num_cells);
+  std::iota(coeffs.begin(), coeffs.end(), 1.0);
+
+  // Reference, using a Form
+  fem::Form<double> L = test::create_cell_form<double>({V}, kernel);
+  const std::size_t n = V->dofmap()->index_map->size_local();
+  std::vector<double> b0(n, 0);
+  fem::assemble_vector(
+      std::span(b0), L, std::span<const double>(),
+      {{{fem::IntegralType::cell, -1}, {std::span<const double>(coeffs), 1}}});
+
+  SECTION("vector")
+  {
+    std::vector<double> b(n, 0);
+    fem::assemble_vector<double>(b, kernel, mesh->geometry(), cells,
+                                 *V->dofmap(), {}, coeffs, 1);
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(b[i] == Catch::Approx(b0[i]));
+  }
+
+  SECTION("matrix")
+  {
+    // Kernel for the matrix with the vector kernel values on the
+    // diagonal
+    auto kernel_a = [&kernel](double* A, const double* w, const double* c,
+                              const double* x, const int* e,
+                              const std::uint8_t* p)
+    {
+      std::array<double, 3> d = {0, 0, 0};
+      kernel(d.data(), w, c, x, e, p);
+      for (int i = 0; i < 3; ++i)
+        A[4 * i] += d[i];
+    };
+
+    std::vector<double> A(n * n, 0);
+    auto mat_add = [&A, n](std::span<const std::int32_t> rows,
+                           std::span<const std::int32_t> cols,
+                           std::span<const double> vals)
+    {
+      for (std::size_t i = 0; i < rows.size(); ++i)
+        for (std::size_t j = 0; j < cols.size(); ++j)
+          A[n * rows[i] + cols[j]] += vals[i * cols.size() + j];
+      return 0;
+    };
+    fem::assemble_matrix<double>(mat_add, kernel_a, mesh->geometry(), cells,
+                                 *V->dofmap(), *V->dofmap(), {}, {}, {},
+                                 coeffs, 1);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      CHECK(A[n * i + i] == Catch::Approx(b0[i]));
+      for (std::size_t j = 0; j < n; ++j)
+        if (j != i)
+          CHECK(A[n * i + j] == 0);
+    }
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the cell-local solver
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/LocalSolver.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+double f(const double* x) { return 1 + x[0] + 2 * x[1]; }
+
+double area(const double* x)
+{
+  return 0.5
+         * std::abs((x[3] - x[0]) * (x[7] - x[1])
+                    - (x[6] - x[0]) * (x[4] - x[1]));
+}
+
+/// P1 mass matrix, |K| (I + J) / 12
+void mass(double* A, const double*, const double*, const double* x,
+          const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      A[3 * i + j] += area(x) * ((i == j ? 1 : 0) + 1) / 12;
+}
+
+/// Right-hand side of the projection of the linear function f
+void rhs(double* b, const double*, const double*, const double* x,
+         const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      b[i] += area(x) * ((i == j ? 1 : 0) + 1) / 12 * f(x + 3 * j);
+}
+
+std::shared_ptr<const fem::Form<double>>
+create_form(std::vector<std::shared_ptr<const fem::FunctionSpace<double>>> V,
+            fem::FEkernel<double> auto kernel)
+{
+  return std::make_shared<const fem::Form<double>>(
+      test::create_cell_form<double>(V, kernel));
+}
+} // namespace
+
+TEST_CASE("Local solver", "[local_solver]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0, 0}, {1, 1}}},
+                                     {3, 2}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh, true);
+  auto a = create_form({V, V}, mass);
+  auto L = create_form({V}, rhs);
+
+  // The projection of a linear function is exact
+  fem::Function<double> u(V);
+  fem::local_solve(a, *L, u);
+  std::vector<double> x = V->tabulate_dof_coordinates(false);
+  const std::int32_t num_owned = V->dofmap()->index_map->size_local();
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    CHECK(u.x()->array()[i] == Catch::Approx(f(x.data() + 3 * i)));
+
+  // Dofs that are shared between cells are not supported
+  auto W = test::create_p1_space(mesh);
+  CHECK_THROWS(fem::LocalSolver<double>(create_form({W, W}, mass)));
+}
@@ -0,0 +1,99 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the cache of assembled matrices
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/MatrixCache.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel for the 3x3 matrix c (I + J), where J is the matrix of ones
+void kernel(double* A, const double*, const double* c, const double*,
+            const int*, const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      A[3 * i + j] += c[0] * ((i == j ? 1 : 0) + 1);
+}
+
+std::shared_ptr<const fem::Form<double>>
+create_form(std::shared_ptr<fem::FunctionSpace<double>> V,
+            std::shared_ptr<const fem::Constant<double>> c)
+{
+  return std::make_shared<const fem::Form<double>>(
+      test::create_cell_form<double>({V, V}, kernel, {c}));
+}
+} // namespace
+
+TEST_CASE("Matrix cache", "[matrix_cache]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {2, 2}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh);
+  auto c = std::make_shared<fem::Constant<double>>(1.0);
+  auto a = create_form(V, c);
+
+  fem::MatrixCache<double> cache;
+
+  // The second assembly returns the cached matrix
+  auto A0 = cache.assemble(a);
+  CHECK(cache.assemble(a) == A0);
+  CHECK(cache.num_hits() == 1);
+  CHECK(cache.num_misses() == 1);
+  CHECK(cache.size() == 1);
+  CHECK(cache.bytes() > 0);
+
+  // A changed constant value leads to re-assembly
+  c->value[0] = 2.0;
+  auto A1 = cache.assemble(a);
+  CHECK(A1 != A0);
+  CHECK(cache.num_misses() == 2);
+  CHECK(cache.size() == 1);
+  REQUIRE(A1->values().size() == A0->values().size());
+  for (std::size_t i = 0; i < A0->values().size(); ++i)
+    CHECK(A1->values()[i] == Catch::Approx(2 * A0->values()[i]));
+
+  // Modified geometry leads to re-assembly
+  mesh->geometry().mark_modified();
+  CHECK(cache.assemble(a) != A1);
+  CHECK(cache.assemble(a) == cache.assemble(a));
+
+  // The least recently used matrix is evicted to meet the budget
+  auto b = create_form(V, c);
+  cache.assemble(b);
+  CHECK(cache.size() == 2);
+  cache.set_budget(cache.bytes() - 1);
+  CHECK(cache.size() == 1);
+  const std::size_t num_misses = cache.num_misses();
+  cache.assemble(b);
+  CHECK(cache.num_misses() == num_misses);
+  cache.assemble(a);
+  CHECK(cache.num_misses() == num_misses + 1);
+
+  // Matrices of destroyed forms are discarded
+  cache.set_budget(std::numeric_limits<std::size_t>::max());
+  b.reset();
+  cache.assemble(a);
+  cache.clear();
+  CHECK(cache.size() == 0);
+  CHECK(cache.bytes() == 0);
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for assembly into matrices and vectors of another
+// precision than the form
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel for the cell vector with entries 0.1
+template <typename T>
+void kernel_L(T* b, const T*, const T*, const T*, const int*,
+              const std::uint8_t*)
+{
+  for (int i = 0; i < 3; ++i)
+    b[i] += T(0.1);
+}
+
+template <typename T>
+std::shared_ptr<fem::FunctionSpace<T>> create_space()
+{
+  auto mesh = std::make_shared<mesh::Mesh<T>>(mesh::create_rectangle<T>(
+      MPI_COMM_SELF, {{{0, 0}, {1, 1}}}, {4, 4}, mesh::CellType::triangle));
+  return test::create_p1_space(mesh);
+}
+} // namespace
+
+TEST_CASE("Mixed-precision matrix assembly", "[mixed_precision]")
+{
+  auto V32 = create_space<float>();
+  auto V64 = create_space<double>();
+  // Cell matrix I + J, where J is the matrix of ones
+  fem::Form<float> a32
+      = test::create_cell_form<float>({V32, V32}, test::kernel_IJ<float, 1, 1>);
+  fem::Form<double> a64 = test::create_cell_form<double>(
+      {V64, V64}, test::kernel_IJ<double, 1, 1>);
+
+  la::SparsityPattern p32 = fem::create_sparsity_pattern(a32);
+  p32.finalize();
+  la::SparsityPattern p64 = fem::create_sparsity_pattern(a64);
+  p64.finalize();
+
+  // float kernels accumulated in a double matrix, and double kernels
+  // stored in a float matrix
+  la::MatrixCSR<double> A64(p32);
+  fem::assemble_matrix(A64.mat_add_values<1, 1, float>(), a32, {});
+  la::MatrixCSR<float> A32(p64);
+  fem::assemble_matrix(A32.mat_add_values<1, 1, double>(), a64, {});
+
+  la::MatrixCSR<double> A(p64);
+  fem::assemble_matrix(A.mat_add_values(), a64, {});
+  REQUIRE(A64.values().size() == A.values().size());
+  REQUIRE(A32.values().size() == A.values().size());
+  for (std::size_t i = 0; i < A.values().size(); ++i)
+  {
+    CHECK(A64.values()[i] == A.values()[i]);
+    CHECK(A32.values()[i] == static_cast<float>(A.values()[i]));
+  }
+
+  // Converting set
+  std::vector<std::int32_t> dofs{0};
+  std::vector<float> one{1.5f};
+  A64.mat_set_values<1, 1, float>()(dofs, dofs, one);
+  CHECK(A64.to_dense()[0] == 1.5);
+}
+
+TEST_CASE("Mixed-precision vector assembly", "[mixed_precision]")
+{
+  auto V = create_space<float>();
+  fem::Form<float> L = test::create_cell_form<float>({V}, kernel_L<float>);
+  auto dofmap = V->dofmap();
+
+  // Number of cells sharing each dof
+  std::vector<int> count(dofmap->index_map->size_local()
+                             + dofmap->index_map->num_ghosts(),
+                         0);
+  const int num_cells = V->mesh()->topology()->index_map(2)->size_local();
+  for (int c = 0; c < num_cells; ++c)
+    for (std::int32_t dof : dofmap->cell_dofs(c))
+      ++count[dof];
+
+  // The float cell vectors are accumulated in double
+  la::Vector<double> b(dofmap->index_map, 1);
+  fem::assemble_vector(b.mutable_array(), L);
+  for (std::size_t i = 0; i < count.size(); ++i)
+  {
+    CHECK(b.array()[i]
+          == Catch::Approx(count[i] * static_cast<double>(0.1f))
+                 .epsilon(1e-14));
+  }
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for quadrature point data
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Quadrature data", "[quadrature_data]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {2, 2}, mesh::CellType::triangle));
+  const int num_cells = mesh->topology()->index_map(2)->size_local();
+
+  // Every other cell, with 3 points and 2 values per point
+  std::vector<std::int32_t> cells;
+  for (std::int32_t c = 0; c < num_cells; c += 2)
+    cells.push_back(c);
+  fem::QuadratureData<double> q(cells, 3, 2, 1.0);
+  REQUIRE(q.cells().size() == cells.size());
+  REQUIRE(q.stride() == 6);
+  REQUIRE(q.values().size() == 6 * cells.size());
+
+  // Increment the first value at each point by the coefficient and set
+  // the second to the x-coordinate of the point's vertex
+  std::vector<double> w(cells.size());
+  std::iota(w.begin(), w.end(), 0.0);
+  auto kernel = [](double* v, const double* w, const double*,
+                   const double* x, const int*, const std::uint8_t*)
+  {
+    for (int p = 0; p < 3; ++p)
+    {
+      v[2 * p] += w[0];
+      v[2 * p + 1] = x[3 * p];
+    }
+  };
+  q.update(kernel, mesh->geometry(), {}, w, 1, 2);
+  q.update(kernel, mesh->geometry(), {}, w, 1);
+
+  auto x_dofmap = mesh->geometry().dofmap();
+  std::span<const double> x = mesh->geometry().x();
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    std::span<const double> v = q.values(i);
+    for (int p = 0; p < 3; ++p)
+    {
+      CHECK(v[2 * p] == Catch::Approx(1 + 2 * w[i]));
+      CHECK(v[2 * p + 1] == Catch::Approx(x[3 * x_dofmap(cells[i], p)]));
+    }
+  }
+
+  // Pack into coefficients with another coefficient before the data
+  const int cstride = 1 + q.stride();
+  std::vector<double> c(cells.size() * cstride, -1);
+  q.pack(c, cstride, 1);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    CHECK(c[i * cstride] == -1);
+    for (int j = 0; j < q.stride(); ++j)
+      CHECK(c[i * cstride + 1 + j] == q.values(i)[j]);
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the sparsity pattern of forms with cell and interior
+// facet integrals
+
+#include "forms.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/sparsitybuild.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel that is not called when building sparsity patterns
+void kernel(double*, const double*, const double*, const double*,
+            const int*, const std::uint8_t*)
+{
+}
+
+/// Sparsity graph, with sorted columns on each row
+std::vector<std::vector<std::int32_t>>
+sparsity_graph(la::SparsityPattern& pattern)
+{
+  pattern.finalize();
+  auto [edges, offsets] = pattern.graph();
+  std::vector<std::vector<std::int32_t>> rows;
+  for (std::size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    rows.emplace_back(std::next(edges.begin(), offsets[i]),
+                      std::next(edges.begin(), offsets[i + 1]));
+  }
+  return rows;
+}
+} // namespace
+
+TEST_CASE("Sparsity of cell and interior facet integrals",
+          "[sparsity_build]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {4, 3}, mesh::CellType::triangle));
+  auto V = test::create_p1_space(mesh, true);
+
+  // Cells and interior facets of the mesh
+  auto topology = mesh->topology();
+  const int tdim = topology->dim();
+  mesh->topology_mutable()->create_connectivity(tdim - 1, tdim);
+  auto f_to_c = topology->connectivity(tdim - 1, tdim);
+  std::vector<std::int32_t> cells(topology->index_map(tdim)->size_local());
+  std::iota(cells.begin(), cells.end(), 0);
+  std::vector<std::int32_t> interior;
+  for (std::int32_t f = 0; f < f_to_c->num_nodes(); ++f)
+    if (f_to_c->num_links(f) == 2)
+      interior.push_back(f);
+  std::vector<std::int32_t> facets = fem::compute_integration_domains(
+      fem::IntegralType::interior_facet, *topology, interior, tdim - 1);
+
+  std::map<fem::IntegralType, std::vector<fem::integral_data<double>>>
+      integrals;
+  integrals[fem::IntegralType::cell].emplace_back(-1, kernel, cells,
+                                                  std::vector<int>{});
+  integrals[fem::IntegralType::interior_facet].emplace_back(
+      -1, kernel, facets, std::vector<int>{});
+  fem::Form<double> a({V, V}, integrals, {}, {}, false, {}, mesh);
+
+  // Reference pattern, inserted integral by integral
+  const fem::DofMap& dofmap = *V->dofmap();
+  la::SparsityPattern p0(MPI_COMM_SELF, {dofmap.index_map, dofmap.index_map},
+                         {1, 1});
+  fem::sparsitybuild::cells(p0, {cells, cells}, {dofmap, dofmap});
+  std::vector<std::int32_t> facet_cells;
+  for (std::size_t i = 0; i < facets.size(); i += 2)
+    facet_cells.push_back(facets[i]);
+  fem::sparsitybuild::interior_facets(p0, {facet_cells, facet_cells},
+                                      {dofmap, dofmap});
+  const std::vector<std::vector<std::int32_t>> rows0 = sparsity_graph(p0);
+
+  for (int num_threads : {1, 3})
+  {
+    la::SparsityPattern p1 = fem::create_sparsity_pattern(a, num_threads);
+    CHECK(sparsity_graph(p1) == rows0);
+  }
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for static condensation of block forms
+
+#include "forms.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/StaticCondensation.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Static condensation", "[static_condensation]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(MPI_COMM_SELF, {{{0, 0}, {1, 1}}},
+                                     {1, 1}, mesh::CellType::triangle));
+  auto V0 = test::create_p1_space(mesh, true);
+  auto V1 = test::create_p1_space(mesh);
+  const int num_cells = mesh->topology()->index_map(2)->size_local();
+  std::vector<std::int32_t> cells(num_cells);
+  std::iota(cells.begin(), cells.end(), 0);
+
+  // A00 = 2I, A01 = A10 = J and A11 = 4I
+  auto form = [](auto V, auto W, auto k)
+  {
+    return std::make_shared<const fem::Form<double>>(
+        test::create_cell_form<double>({V, W}, k));
+  };
+  std::array<std::array<std::shared_ptr<const fem::Form<double>>, 2>, 2> a
+      = {{{form(V0, V0, test::kernel_IJ<double, 2, 0>),
+           form(V0, V1, test::kernel_IJ<double, 0, 1>)},
+          {form(V1, V0, test::kernel_IJ<double, 0, 1>),
+           form(V1, V1, test::kernel_IJ<double, 4, 0>)}}};
+  fem::StaticCondensation<double> condensation(a);
+
+  // Condensed matrix S = sum_c (4I - 3/2 J)
+  const std::size_t n1 = V1->dofmap()->index_map->size_local();
+  std::vector<double> S(n1 * n1, 0), expected(n1 * n1, 0);
+  condensation.assemble_matrix(
+      [&S, n1](std::span<const std::int32_t> rows,
+               std::span<const std::int32_t> cols,
+               std::span<const double> vals)
+      {
+        for (std::size_t i = 0; i < rows.size(); ++i)
+          for (std::size_t j = 0; j < cols.size(); ++j)
+            S[n1 * rows[i] + cols[j]] += vals[i * cols.size() + j];
+        return 0;
+      });
+  REQUIRE(condensation.num_cells() == std::size_t(num_cells));
+  for (std::int32_t c : cells)
+  {
+    auto dofs = V1->dofmap()->cell_dofs(c);
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        expected[n1 * dofs[i] + dofs[j]] += (i == j ? 4 : 0) - 1.5;
+  }
+  for (std::size_t i = 0; i < S.size(); ++i)
+    CHECK(S[i] == Catch::Approx(expected[i]));
+
+  // Condensed right-hand side b1 - J (b0 / 2) with b0 = 1 and b1 = 0
+  const std::size_t n0 = V0->dofmap()->index_map->size_local();
+  std::vector<double> b0(n0, 1), b1(n1, 0), expected_b1(n1, 0);
+  condensation.condense_vector(b0, b1);
+  for (std::int32_t c : cells)
+    for (std::int32_t dof : V1->dofmap()->cell_dofs(c))
+      expected_b1[dof] -= 1.5;
+  for (std::size_t i = 0; i < n1; ++i)
+    CHECK(b1[i] == Catch::Approx(expected_b1[i]));
+
+  // Back substitution u0 = (b0 - J u1) / 2
+  std::vector<double> u1(n1), u0(n0, 0);
+  std::iota(u1.begin(), u1.end(), 1.0);
+  condensation.back_substitute(b0, u1, u0);
+  for (std::int32_t c : cells)
+  {
+    double sum = 0;
+    for (std::int32_t dof : V1->dofmap()->cell_dofs(c))
+      sum += u1[dof];
+    for (std::int32_t dof : V0->dofmap()->cell_dofs(c))
+      CHECK(u0[dof] == Catch::Approx((1 - sum) / 2));
+  }
+}
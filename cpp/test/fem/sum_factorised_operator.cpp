@@ -0,0 +1,201 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the sum-factorised operator
+
+#include "forms.h"
+#include <array>
+#include <basix/finite-element.h>
+#include <basix/mdspan.hpp>
+#include <basix/quadrature.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/math.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/SumFactorisedOperator.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Kernel for the element matrix of kappa (grad u, grad v) + mu (u, v),
+/// computed with the full element tables at the tensor-product
+/// Gauss-Jacobi points of degree `qdegree` that are used by
+/// SumFactorisedOperator
+auto create_kernel(const fem::FunctionSpace<double>& V, double kappa,
+                   double mu, int qdegree)
+{
+  const int tdim = V.mesh()->topology()->dim();
+  const fem::CoordinateElement<double>& cmap = V.mesh()->geometry().cmap();
+  const basix::FiniteElement<double>& e = V.element()->basix_element();
+  const int bs = V.dofmap()->bs();
+
+  auto [xq, wq] = basix::quadrature::make_quadrature<double>(
+      basix::quadrature::type::gauss_jacobi, basix::cell::type::interval,
+      basix::polyset::type::standard, qdegree);
+  std::size_t nq = 1;
+  for (int k = 0; k < tdim; ++k)
+    nq *= wq.size();
+  std::vector<double> X(nq * tdim), weights(nq, 1);
+  for (std::size_t q = 0; q < nq; ++q)
+  {
+    std::size_t r = q;
+    for (int k = 0; k < tdim; ++k)
+    {
+      X[q * tdim + k] = xq[r % wq.size()];
+      weights[q] *= wq[r % wq.size()];
+      r /= wq.size();
+    }
+  }
+
+  // Tables with shape (tdim + 1, nq, num dofs)
+  auto tab = e.tabulate(1, X, {nq, std::size_t(tdim)});
+  std::vector<double> phi = std::move(tab.first);
+  std::array<std::size_t, 4> gshape = cmap.tabulate_shape(1, nq);
+  std::vector<double> phi_g(gshape[0] * gshape[1] * gshape[2] * gshape[3]);
+  cmap.tabulate(1, X, {nq, std::size_t(tdim)}, phi_g);
+
+  const int nd = tab.second[2];
+  const int ng = gshape[2];
+  return [=](double* A, const double*, const double*, const double* x,
+             const int*, const std::uint8_t*)
+  {
+    using mdspan2_t = MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+        double, MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>;
+    std::array<double, 9> J_b, K_b;
+    mdspan2_t J(J_b.data(), tdim, tdim), K(K_b.data(), tdim, tdim);
+    std::vector<double> grad(tdim * nd);
+    for (std::size_t q = 0; q < nq; ++q)
+    {
+      for (int i = 0; i < tdim; ++i)
+      {
+        for (int j = 0; j < tdim; ++j)
+        {
+          J(i, j) = 0;
+          for (int n = 0; n < ng; ++n)
+            J(i, j) += x[3 * n + i] * phi_g[((j + 1) * nq + q) * ng + n];
+        }
+      }
+      math::inv(J, K);
+      const double scale = std::abs(math::det(J)) * weights[q];
+
+      // Physical gradients of the basis functions
+      for (int i = 0; i < nd; ++i)
+      {
+        for (int k = 0; k < tdim; ++k)
+        {
+          grad[i * tdim + k] = 0;
+          for (int j = 0; j < tdim; ++j)
+            grad[i * tdim + k] += K(j, k) * phi[((j + 1) * nq + q) * nd + i];
+        }
+      }
+
+      for (int i = 0; i < nd; ++i)
+      {
+        for (int j = 0; j < nd; ++j)
+        {
+          double a = mu * phi[q * nd + i] * phi[q * nd + j];
+          for (int k = 0; k < tdim; ++k)
+            a += kappa * grad[i * tdim + k] * grad[j * tdim + k];
+          for (int c = 0; c < bs; ++c)
+            A[(i * bs + c) * nd * bs + j * bs + c] += scale * a;
+        }
+      }
+    }
+  };
+}
+
+/// Compare the action of SumFactorisedOperator with the product of the
+/// assembled matrix
+void test_operator(mesh::CellType cell_type, int degree, bool blocked)
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      cell_type == mesh::CellType::quadrilateral
+          ? mesh::create_rectangle<double>(MPI_COMM_WORLD, {{{0, 0}, {1, 1}}},
+                                           {6, 5}, cell_type)
+          : mesh::create_box<double>(MPI_COMM_WORLD,
+                                     {{{0, 0, 0}, {1, 1, 1}}}, {3, 3, 4},
+                                     cell_type));
+
+  // Make the cells non-affine. The perturbation depends only on the
+  // point, so it is the same for shared nodes on all processes.
+  std::span<double> x = mesh->geometry().x();
+  for (std::size_t i = 0; i < x.size(); i += 3)
+    x[i] += 0.1 * x[i + 1] * x[i + 1];
+
+  const int tdim = mesh->topology()->dim();
+  auto element = basix::create_element<double>(
+      basix::element::family::P, mesh::cell_type_to_basix_type(cell_type),
+      degree, basix::element::lagrange_variant::gll_warped,
+      basix::element::dpc_variant::unset, false);
+  std::vector<std::size_t> value_shape;
+  if (blocked)
+    value_shape = {std::size_t(tdim)};
+  auto V = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace<double>(mesh, element, value_shape));
+
+  constexpr double kappa = 2.0;
+  constexpr double mu = 3.0;
+  fem::SumFactorisedOperator<double> op(V, kappa, mu);
+
+  // Assembled operator
+  fem::Form<double> a = test::create_cell_form<double>(
+      {V, V}, create_kernel(*V, kappa, mu, 2 * degree));
+  la::SparsityPattern pattern = fem::create_sparsity_pattern(a);
+  pattern.finalize();
+  la::MatrixCSR<double> A(pattern);
+  fem::assemble_matrix(A.mat_add_values(), a, {});
+  A.scatter_rev();
+
+  auto map = V->dofmap()->index_map;
+  const int bs = V->dofmap()->bs();
+  la::Vector<double> u(map, bs), y0(map, bs), y1(map, bs);
+  const std::int64_t offset = bs * map->local_range()[0];
+  const std::int32_t num_owned = bs * map->size_local();
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    u.mutable_array()[i] = std::sin(0.1 * (offset + i));
+
+  A.mult(u, y0);
+  op.apply(u, y1);
+  for (std::int32_t i = 0; i < num_owned; ++i)
+    CHECK(y1.array()[i] == Catch::Approx(y0.array()[i]).margin(1e-12));
+  CHECK(la::norm(y0) > 0);
+}
+} // namespace
+
+TEST_CASE("Sum-factorised operator", "[sum_factorised_operator]")
+{
+  SECTION("quadrilateral")
+  {
+    for (bool blocked : {false, true})
+    {
+      CHECK_NOTHROW(test_operator(mesh::CellType::quadrilateral, 2, blocked));
+      CHECK_NOTHROW(test_operator(mesh::CellType::quadrilateral, 3, blocked));
+    }
+  }
+
+  SECTION("hexahedron")
+  {
+    for (bool blocked : {false, true})
+      CHECK_NOTHROW(test_operator(mesh::CellType::hexahedron, 2, blocked));
+  }
+}
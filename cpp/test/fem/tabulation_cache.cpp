@@ -0,0 +1,80 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the cache of basis function tables
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <dolfinx/fem/TabulationCache.h>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Tabulation cache", "[tabulation_cache]")
+{
+  fem::impl::TabulationCache<double> cache(2, 4);
+  int calls = 0;
+  auto tabulate = [&calls](std::span<double> basis)
+  {
+    ++calls;
+    std::ranges::fill(basis, calls);
+  };
+
+  std::vector<double> X0 = {0.25, 0.25}, X1 = {0.5, 0.25};
+  std::array<std::size_t, 2> shape = {1, 2};
+  std::vector<double> basis(3);
+
+  // The second tabulation at the same points is copied from the cache
+  cache.tabulate(0, X0, shape, basis, tabulate);
+  cache.tabulate(0, X0, shape, basis, tabulate);
+  CHECK(calls == 1);
+  CHECK(basis == std::vector<double>(3, 1));
+  CHECK(cache.size() == 1);
+
+  // Other points or derivative orders are tabulated
+  cache.tabulate(0, X1, shape, basis, tabulate);
+  CHECK(calls == 2);
+  std::vector<double> basis1(9);
+  cache.tabulate(1, X0, shape, basis1, tabulate);
+  CHECK(calls == 3);
+
+  // The least recently used table is discarded when the cache is full
+  CHECK(cache.size() == 2);
+  cache.tabulate(0, X0, shape, basis, tabulate);
+  CHECK(calls == 4);
+
+  // A hit makes the table the most recently used
+  cache.tabulate(1, X0, shape, basis1, tabulate);
+  CHECK(calls == 4);
+  cache.tabulate(0, X1, shape, basis, tabulate);
+  CHECK(calls == 5);
+  cache.tabulate(1, X0, shape, basis1, tabulate);
+  CHECK(calls == 5);
+
+  // Pinned tables are not discarded
+  std::vector<double> Xp = {0.0, 0.0};
+  cache.pin(0, Xp, shape, basis.size(), tabulate);
+  CHECK(calls == 6);
+  CHECK(cache.num_pinned() == 1);
+  cache.tabulate(0, X0, shape, basis, tabulate);
+  cache.tabulate(0, X1, shape, basis, tabulate);
+  cache.tabulate(0, X0, shape, basis, tabulate);
+  CHECK(calls == 8);
+  cache.tabulate(0, Xp, shape, basis, tabulate);
+  CHECK(calls == 8);
+  CHECK(basis == std::vector<double>(3, 6));
+  CHECK(cache.size() == 2);
+
+  // Large point sets are not cached
+  std::vector<double> X(10, 0.1);
+  std::vector<double> basis2(15);
+  cache.tabulate(0, X, {5, 2}, basis2, tabulate);
+  cache.tabulate(0, X, {5, 2}, basis2, tabulate);
+  CHECK(calls == 10);
+  CHECK(cache.size() == 2);
+}
@@ -0,0 +1,302 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for bounding box trees
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/WideBoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/generation.h>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Random boxes with a non-zero extent in the first gdim directions
+template <typename T>
+std::vector<std::pair<std::array<T, 6>, std::int32_t>>
+random_boxes(std::size_t n, int gdim, unsigned seed = 3)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<T> x(0, 1), h(0, 0.05);
+  std::vector<std::pair<std::array<T, 6>, std::int32_t>> boxes(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    auto& [b, e] = boxes[i];
+    b.fill(0);
+    for (int j = 0; j < gdim; ++j)
+    {
+      b[j] = x(rng);
+      b[3 + j] = b[j] + h(rng);
+    }
+    e = 2 * i + 1;
+  }
+  return boxes;
+}
+
+// Check the layout of a tree built from leaf boxes: nodes are stored
+// in post-order with the root last, each leaf stores one entity and
+// the box of a node contains the boxes of its children
+template <typename T>
+void check_tree(
+    const std::vector<std::pair<std::array<T, 6>, std::int32_t>>& leaves,
+    const std::vector<std::int32_t>& bboxes, const std::vector<T>& x)
+{
+  const std::size_t num_nodes = bboxes.size() / 2;
+  REQUIRE(num_nodes == 2 * leaves.size() - 1);
+  REQUIRE(x.size() == 6 * num_nodes);
+
+  std::vector<std::int32_t> entities;
+  for (std::size_t i = 0; i < num_nodes; ++i)
+  {
+    std::int32_t c0 = bboxes[2 * i], c1 = bboxes[2 * i + 1];
+    if (c0 == c1)
+    {
+      entities.push_back(c0);
+      continue;
+    }
+
+    REQUIRE(c0 < static_cast<std::int32_t>(i));
+    REQUIRE(c1 < static_cast<std::int32_t>(i));
+    for (std::int32_t c : {c0, c1})
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        CHECK(x[6 * i + j] <= x[6 * c + j]);
+        CHECK(x[6 * i + 3 + j] >= x[6 * c + 3 + j]);
+      }
+    }
+  }
+
+  std::vector<std::int32_t> expected;
+  for (auto& [b, e] : leaves)
+    expected.push_back(e);
+  std::ranges::sort(entities);
+  std::ranges::sort(expected);
+  CHECK(entities == expected);
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("Build bounding box tree from leaves", "[bbtree]", float,
+                   double)
+{
+  for (int gdim : {0, 1, 2, 3})
+  {
+    for (std::size_t n : {1, 2, 7, 5000})
+    {
+      auto leaves = random_boxes<TestType>(n, gdim);
+      auto leaves1 = leaves;
+      auto [bboxes, x] = geometry::impl_bb::build_from_leaf(leaves);
+      check_tree(leaves, bboxes, x);
+
+      // Threaded construction gives the same tree
+      auto [bboxes1, x1] = geometry::impl_bb::build_from_leaf(leaves1, 4);
+      CHECK(bboxes1 == bboxes);
+      CHECK(x1 == x);
+    }
+  }
+}
+
+namespace
+{
+template <int W>
+void test_wide_tree()
+{
+  auto mesh = mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {6, 5, 4},
+      mesh::CellType::tetrahedron);
+  const int tdim = mesh.topology()->dim();
+  geometry::BoundingBoxTree<double> tree(mesh, tdim);
+  geometry::WideBoundingBoxTree<double, W> wide_tree(tree);
+  CHECK(wide_tree.num_nodes() < tree.num_bboxes() / 2);
+
+  // Point collisions are the same as for the binary tree, including
+  // points on the boundary of cells and outside the mesh
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> dist(-0.1, 1.1);
+  std::vector<double> points(3 * 500);
+  std::ranges::generate(points, [&]() { return dist(rng); });
+  points.insert(points.end(), {0.5, 0.4, 0.25, 1.0, 1.0, 1.0});
+  graph::AdjacencyList<std::int32_t> c0
+      = geometry::compute_collisions(tree, std::span<const double>(points));
+  graph::AdjacencyList<std::int32_t> c1 = geometry::compute_collisions(
+      wide_tree, std::span<const double>(points));
+  CHECK(c1.offsets() == c0.offsets());
+  CHECK(c1.array() == c0.array());
+
+  // Tree collisions are the same as for the binary trees, up to order
+  auto mesh1 = mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.45, 0.3, 0.2}, {1.5, 1.2, 1.1}}}, {3, 4, 5},
+      mesh::CellType::hexahedron);
+  geometry::BoundingBoxTree<double> tree1(mesh1, tdim);
+  geometry::WideBoundingBoxTree<double, W> wide_tree1(tree1);
+  auto pairs = [](const std::vector<std::int32_t>& c)
+  {
+    std::vector<std::array<std::int32_t, 2>> p;
+    for (std::size_t i = 0; i < c.size(); i += 2)
+      p.push_back({c[i], c[i + 1]});
+    std::ranges::sort(p);
+    return p;
+  };
+  auto p0 = pairs(geometry::compute_collisions(tree, tree1));
+  auto p1 = pairs(geometry::compute_collisions(wide_tree, wide_tree1));
+  CHECK(!p0.empty());
+  CHECK(p1 == p0);
+}
+} // namespace
+
+TEST_CASE("Threaded tree collisions", "[bbtree]")
+{
+  for (std::size_t n : {1, 10, 3000})
+  {
+    geometry::BoundingBoxTree<double> tree0(random_boxes<double>(n, 3, 1));
+    geometry::BoundingBoxTree<double> tree1(random_boxes<double>(2000, 3, 2));
+    std::vector<std::int32_t> c = geometry::compute_collisions(tree0, tree1);
+    for (int num_threads : {2, 3, 8})
+      CHECK(geometry::compute_collisions(tree0, tree1, num_threads) == c);
+  }
+}
+
+TEST_CASE("Distributed tree collisions", "[bbtree]")
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  // Boxes of tree1 on each process are in a slab, so that processes
+  // only collide with some of the others
+  auto leaves0 = random_boxes<double>(500, 3, 2 * rank + 1);
+  auto leaves1 = random_boxes<double>(400, 3, 2 * rank + 2);
+  for (auto& [b, e] : leaves1)
+  {
+    b[0] = (b[0] + rank) / size;
+    b[3] = (b[3] + rank) / size;
+  }
+  geometry::BoundingBoxTree<double> tree0(leaves0);
+  geometry::BoundingBoxTree<double> tree1(leaves1);
+  auto [entities, collisions] = geometry::compute_distributed_collisions(
+      comm, tree0, tree1, 2, 2);
+
+  // Compare with all pairs of boxes
+  std::vector<double> x1(6 * leaves1.size());
+  for (std::size_t i = 0; i < leaves1.size(); ++i)
+    std::ranges::copy(leaves1[i].first, std::next(x1.begin(), 6 * i));
+  std::vector<double> x1_all(size * x1.size());
+  MPI_Allgather(x1.data(), x1.size(), MPI_DOUBLE, x1_all.data(), x1.size(),
+                MPI_DOUBLE, comm);
+  std::vector<std::int32_t> expected_entities;
+  std::vector<std::vector<std::int32_t>> expected;
+  for (auto& [b0, e0] : leaves0)
+  {
+    std::vector<std::int32_t> links;
+    for (int r = 0; r < size; ++r)
+    {
+      for (std::size_t i = 0; i < leaves1.size(); ++i)
+      {
+        std::span<const double, 6> b1(
+            x1_all.data() + 6 * (r * leaves1.size() + i), 6);
+        if (geometry::impl::bbox_in_bbox<double>(b0, b1))
+          links.insert(links.end(), {r, leaves1[i].second});
+      }
+    }
+    if (!links.empty())
+    {
+      expected_entities.push_back(e0);
+      expected.push_back(links);
+    }
+  }
+  CHECK(!expected.empty());
+  CHECK(entities == expected_entities);
+  REQUIRE(collisions.num_nodes() == (std::int32_t)expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    auto links = collisions.links(i);
+    CHECK(std::vector(links.begin(), links.end()) == expected[i]);
+  }
+}
+
+TEST_CASE("Wide bounding box tree", "[bbtree]")
+{
+  test_wide_tree<4>();
+  test_wide_tree<8>();
+}
+
+TEST_CASE("Refit bounding box tree", "[bbtree]")
+{
+  auto mesh = mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {6, 5, 4},
+      mesh::CellType::tetrahedron);
+  const int tdim = mesh.topology()->dim();
+  geometry::BoundingBoxTree<double> tree(mesh, tdim, 0.01);
+  geometry::BoundingBoxTree<double> tree1(mesh, tdim, 0.01);
+  const double cost = tree.sah_cost();
+  CHECK(cost > 0);
+
+  // A translation does not change the cost
+  std::span<double> x = mesh.geometry().x();
+  for (std::size_t i = 0; i < x.size(); i += 3)
+    x[i] += 2.0;
+  CHECK(std::abs(tree.refit(mesh) - 1.0) < 1e-10);
+
+  // Deform the mesh
+  for (std::size_t i = 0; i < x.size(); i += 3)
+    x[i + 1] += 0.2 * x[i + 2] * x[i + 2];
+  tree.refit(mesh);
+  tree1.refit(mesh, 3);
+
+  // Threaded refit gives the same boxes
+  for (std::int32_t i = 0; i < tree.num_bboxes(); ++i)
+    CHECK(tree1.get_bbox(i) == tree.get_bbox(i));
+
+  // Leaf boxes are the padded entity boxes and the box of a node is the
+  // bounding box of its children
+  for (std::int32_t i = 0; i < tree.num_bboxes(); ++i)
+  {
+    std::array<std::int32_t, 2> c = tree.bbox(i);
+    std::array<double, 6> b = tree.get_bbox(i);
+    if (c[0] == c[1])
+    {
+      CHECK(b
+            == geometry::impl_bb::compute_bbox_of_entity(mesh, tdim, c[0],
+                                                         0.01));
+    }
+    else
+    {
+      std::array<double, 6> b0 = tree.get_bbox(c[0]);
+      std::array<double, 6> b1 = tree.get_bbox(c[1]);
+      for (int j = 0; j < 3; ++j)
+      {
+        CHECK(b[j] == std::min(b0[j], b1[j]));
+        CHECK(b[3 + j] == std::max(b0[3 + j], b1[3 + j]));
+      }
+    }
+  }
+
+  // Collisions agree with a new tree
+  geometry::BoundingBoxTree<double> tree2(mesh, tdim, 0.01);
+  std::vector<double> points = {2.5, 0.5, 0.5, 2.1, 0.9, 0.8, 0.0, 0.0, 0.0};
+  auto c0 = geometry::compute_collisions(tree, std::span<const double>(points));
+  auto c2
+      = geometry::compute_collisions(tree2, std::span<const double>(points));
+  for (std::int32_t p = 0; p < c0.num_nodes(); ++p)
+  {
+    std::vector<std::int32_t> e0(c0.links(p).begin(), c0.links(p).end());
+    std::vector<std::int32_t> e2(c2.links(p).begin(), c2.links(p).end());
+    std::ranges::sort(e0);
+    std::ranges::sort(e2);
+    CHECK(e0 == e2);
+  }
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the GJK distance algorithm
+
+#include <array>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dolfinx/geometry/gjk.h>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Check the batched distances against pairwise GJK for random points
+// and bodies created by `body`
+template <typename T, typename F>
+void check_batch(std::size_t num_body_points, F body)
+{
+  constexpr std::size_t n = 200;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<T> dist(-1, 1);
+  std::vector<T> p(3 * n), q(3 * num_body_points * n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    for (std::size_t k = 0; k < 3; ++k)
+      p[3 * i + k] = dist(rng);
+    body(std::span(q.data() + 3 * num_body_points * i, 3 * num_body_points),
+         rng);
+  }
+
+  std::vector<T> d(3 * n);
+  geometry::compute_distances_gjk<T>(p, q, d);
+  // GJK iteration stops at this relative tolerance
+  constexpr T tol = 1e4 * std::numeric_limits<T>::epsilon();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    std::array<T, 3> d0 = geometry::compute_distance_gjk<T>(
+        std::span<const T>(p.data() + 3 * i, 3),
+        std::span<const T>(q.data() + 3 * num_body_points * i,
+                           3 * num_body_points));
+    for (std::size_t k = 0; k < 3; ++k)
+      CHECK(std::abs(d[3 * i + k] - d0[k]) < tol);
+  }
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("Batched GJK distance to simplices", "[gjk]", float,
+                   double)
+{
+  using T = TestType;
+  for (std::size_t m = 1; m <= 4; ++m)
+  {
+    check_batch<T>(m,
+                   [](std::span<T> x, auto& rng)
+                   {
+                     std::uniform_real_distribution<T> dist(-0.5, 0.5);
+                     for (auto& xi : x)
+                       xi = dist(rng);
+                   });
+  }
+}
+
+TEMPLATE_TEST_CASE("Batched GJK distance to non-simplex cells", "[gjk]",
+                   float, double)
+{
+  using T = TestType;
+
+  // Planar quadrilaterals, whose four points are not a tetrahedron
+  check_batch<T>(4,
+                 [](std::span<T> x, auto& rng)
+                 {
+                   std::uniform_real_distribution<T> dist(-0.5, 0.5);
+                   std::array<T, 3> x0 = {dist(rng), dist(rng), dist(rng)};
+                   std::array<T, 3> a = {dist(rng), dist(rng), dist(rng)};
+                   std::array<T, 3> b = {dist(rng), dist(rng), dist(rng)};
+                   constexpr T c[4][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+                   for (std::size_t i = 0; i < 4; ++i)
+                     for (std::size_t k = 0; k < 3; ++k)
+                       x[3 * i + k] = x0[k] + c[i][0] * a[k] + c[i][1] * b[k];
+                 });
+
+  // Boxes
+  check_batch<T>(8,
+                 [](std::span<T> x, auto& rng)
+                 {
+                   std::uniform_real_distribution<T> dist(-0.5, 0.5),
+                       h(0.1, 0.5);
+                   std::array<T, 3> x0 = {dist(rng), dist(rng), dist(rng)};
+                   std::array<T, 3> dx = {h(rng), h(rng), h(rng)};
+                   for (std::size_t i = 0; i < 8; ++i)
+                     for (std::size_t k = 0; k < 3; ++k)
+                       x[3 * i + k] = x0[k] + ((i >> k) & 1) * dx[k];
+                 });
+}
+
+TEST_CASE("Batched GJK distance to a point inside a tetrahedron", "[gjk]")
+{
+  const std::vector<double> q = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+  const std::vector<double> p = {0.1, 0.2, 0.3};
+  std::vector<double> d(3);
+  geometry::compute_distances_gjk<double>(p, q, d);
+  CHECK(d == std::vector<double>{0, 0, 0});
+
+  // Point outside of two facets, nearest to an edge
+  const std::vector<double> p1 = {-1, -1, 0.5};
+  geometry::compute_distances_gjk<double>(p1, q, d);
+  CHECK(std::abs(d[0] + 1) < 1e-12);
+  CHECK(std::abs(d[1] + 1) < 1e-12);
+  CHECK(std::abs(d[2]) < 1e-12);
+}
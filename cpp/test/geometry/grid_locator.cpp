@@ -0,0 +1,93 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the uniform grid point locator
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/GridLocator.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/generation.h>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Check that the grid finds the same candidate entities as the tree
+void check_collisions(const mesh::Mesh<double>& mesh, int dim,
+                      double padding, int num_threads)
+{
+  geometry::BoundingBoxTree<double> tree(mesh, dim, padding);
+  geometry::GridLocator<double> grid(mesh, dim, padding, num_threads);
+  CHECK(grid.num_entities() == (tree.num_bboxes() + 1) / 2);
+
+  // Random points, some outside of the mesh, and the mesh vertices,
+  // which are on the boundary of the bounding boxes
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> dist(-0.1, 1.1);
+  std::vector<double> points(3 * 500);
+  std::ranges::generate(points, [&]() { return dist(rng); });
+  if (mesh.geometry().dim() == 2)
+    for (std::size_t i = 0; i < points.size(); i += 3)
+      points[i + 2] = 0;
+  std::span<const double> x = mesh.geometry().x();
+  points.insert(points.end(), x.begin(), x.end());
+
+  graph::AdjacencyList<std::int32_t> c0
+      = geometry::compute_collisions(tree, std::span<const double>(points));
+  graph::AdjacencyList<std::int32_t> c1
+      = geometry::compute_collisions(grid, std::span<const double>(points));
+  REQUIRE(c0.num_nodes() == c1.num_nodes());
+  for (std::int32_t p = 0; p < c0.num_nodes(); ++p)
+  {
+    std::vector<std::int32_t> e0(c0.links(p).begin(), c0.links(p).end());
+    std::ranges::sort(e0);
+    auto e1 = c1.links(p);
+    CHECK(std::ranges::equal(e0, e1));
+  }
+}
+} // namespace
+
+TEST_CASE("Grid locator collisions", "[grid_locator]")
+{
+  auto mesh2 = mesh::create_rectangle<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0}, {1.0, 1.0}}}, {12, 7},
+      mesh::CellType::triangle);
+  check_collisions(mesh2, 2, 0, 1);
+  check_collisions(mesh2, 1, 0, 1);
+  check_collisions(mesh2, 2, 0.05, 3);
+
+  auto mesh3 = mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 5, 3},
+      mesh::CellType::hexahedron);
+  check_collisions(mesh3, 3, 0, 2);
+  check_collisions(mesh3, 0, 0, 1);
+}
+
+TEST_CASE("Point ownership with grid search", "[grid_locator]")
+{
+  auto mesh = mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {6, 5, 4},
+      mesh::CellType::tetrahedron);
+
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double> points(3 * 100);
+  std::ranges::generate(points, [&]() { return dist(rng); });
+
+  auto d0 = geometry::determine_point_ownership<double>(mesh, points, 1e-10);
+  auto d1 = geometry::determine_point_ownership<double>(
+      mesh, points, 1e-10, geometry::CellSearch::grid);
+  CHECK(d0.src_owner == d1.src_owner);
+  CHECK(d0.dest_owners == d1.dest_owners);
+  CHECK(d0.dest_points == d1.dest_points);
+  CHECK(d0.dest_cells == d1.dest_cells);
+}
@@ -0,0 +1,94 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for locating entities in a region with a bounding box tree
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Check that the tree search finds the same entities as
+// mesh::locate_entities
+void check_locate(const mesh::Mesh<double>& mesh, int dim)
+{
+  geometry::BoundingBoxTree<double> tree(mesh, dim);
+
+  // Entities in a box
+  std::array<double, 6> box = {0.2, 0.1, -1.0, 0.6, 0.5, 1.0};
+  auto in_box = [&box](auto x)
+  {
+    std::vector<std::int8_t> marked(x.extent(1), true);
+    for (std::size_t i = 0; i < x.extent(1); ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        marked[i] &= x(j, i) >= box[j] and x(j, i) <= box[3 + j];
+    return marked;
+  };
+  std::vector<std::int32_t> e0 = mesh::locate_entities(mesh, dim, in_box);
+  CHECK(!e0.empty());
+  CHECK(geometry::locate_entities(mesh, tree, box) == e0);
+  CHECK(geometry::locate_entities(mesh, tree, box, in_box) == e0);
+  CHECK(mesh::locate_entities(mesh, dim, in_box, 3) == e0);
+
+  // Entities on the plane x = 0
+  std::array<double, 6> plane = {0.0, -1.0, -1.0, 0.0, 2.0, 2.0};
+  auto on_plane = [](auto x)
+  {
+    std::vector<std::int8_t> marked(x.extent(1));
+    for (std::size_t i = 0; i < x.extent(1); ++i)
+      marked[i] = std::abs(x(0, i)) < 1e-10;
+    return marked;
+  };
+  std::vector<std::int32_t> e1 = mesh::locate_entities(mesh, dim, on_plane);
+  CHECK(geometry::locate_entities(mesh, tree, plane, on_plane) == e1);
+
+  // Entities inside a sphere of radius 0.3 at (0.5, 0.5, 0.5)
+  auto distance = [](std::span<const double, 3> x)
+  {
+    return std::sqrt((x[0] - 0.5) * (x[0] - 0.5) + (x[1] - 0.5) * (x[1] - 0.5)
+                     + (x[2] - 0.5) * (x[2] - 0.5))
+           - 0.3;
+  };
+  auto in_sphere = [&distance](auto x)
+  {
+    std::vector<std::int8_t> marked(x.extent(1));
+    for (std::size_t i = 0; i < x.extent(1); ++i)
+    {
+      std::array<double, 3> p = {x(0, i), x(1, i), x(2, i)};
+      marked[i] = distance(p) <= 0;
+    }
+    return marked;
+  };
+  std::array<double, 6> sphere = {0.2, 0.2, 0.2, 0.8, 0.8, 0.8};
+  std::vector<std::int32_t> e2 = mesh::locate_entities(mesh, dim, in_sphere);
+  CHECK(geometry::locate_entities(mesh, tree, sphere, distance, 0.0) == e2);
+}
+} // namespace
+
+TEST_CASE("Locate entities with a bounding box tree", "[locate_entities]")
+{
+  auto mesh2 = mesh::create_rectangle<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0}, {1.0, 1.0}}}, {12, 7},
+      mesh::CellType::triangle);
+  for (int dim : {2, 1, 0})
+    check_locate(mesh2, dim);
+
+  auto mesh3 = mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 5, 3},
+      mesh::CellType::hexahedron);
+  for (int dim : {3, 2})
+    check_locate(mesh3, dim);
+}
@@ -0,0 +1,162 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for particles in the cells of a mesh
+
+#include <algorithm>
+#include <basix/finite-element.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/geometry/Particles.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+std::shared_ptr<const fem::FunctionSpace<double>>
+create_space(std::shared_ptr<mesh::Mesh<double>> mesh, int degree)
+{
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::triangle, degree,
+      basix::element::lagrange_variant::unset,
+      basix::element::dpc_variant::unset, degree == 0);
+  return std::make_shared<const fem::FunctionSpace<double>>(
+      fem::create_functionspace<double>(mesh, element, {}));
+}
+
+/// Total number of particles on all processes
+std::int64_t num_global(const geometry::Particles<double>& particles)
+{
+  std::int64_t n = particles.num_particles();
+  MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+  return n;
+}
+
+/// Check that each particle is in its cell, and that the cells are
+/// sorted
+void check_cells(const geometry::Particles<double>& particles)
+{
+  const mesh::Mesh<double>& mesh = *particles.mesh();
+  const int tdim = mesh.topology()->dim();
+  std::span<const std::int32_t> cells = particles.cells();
+  CHECK(std::ranges::is_sorted(cells));
+  std::span<const std::int32_t> offsets = particles.cell_offsets();
+  CHECK(offsets.size()
+        == std::size_t(mesh.topology()->index_map(tdim)->size_local() + 1));
+  CHECK(std::size_t(offsets.back()) == cells.size());
+  for (std::size_t p = 0; p < cells.size(); ++p)
+  {
+    CHECK(p >= std::size_t(offsets[cells[p]]));
+    CHECK(p < std::size_t(offsets[cells[p] + 1]));
+    std::vector<double> d2 = geometry::squared_distance<double>(
+        mesh, tdim, cells.subspan(p, 1), particles.x().subspan(3 * p, 3));
+    CHECK(d2.front() < 1e-12);
+  }
+}
+} // namespace
+
+TEST_CASE("Particles", "[particles]")
+{
+  const int rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_rectangle<double>(
+          MPI_COMM_WORLD, {{{0, 0}, {1, 1}}}, {8, 7}, mesh::CellType::triangle,
+          mesh::create_cell_partitioner(mesh::GhostMode::shared_facet)));
+
+  // Random particles created on each process, anywhere in the domain
+  std::mt19937 rng(17 + rank);
+  std::uniform_real_distribution<double> dist(0.05, 0.95);
+  constexpr int num_points = 300;
+  std::vector<double> points(3 * num_points, 0);
+  for (int p = 0; p < num_points; ++p)
+    for (int j = 0; j < 2; ++j)
+      points[3 * p + j] = dist(rng);
+
+  geometry::Particles<double> particles(mesh, points);
+  const std::int64_t num = num_global(particles);
+  CHECK(num == num_points * dolfinx::MPI::size(MPI_COMM_WORLD));
+  check_cells(particles);
+
+  // The field values move with the particles
+  particles.add_field("x0", 3);
+  CHECK(particles.field_value_size("x0") == 3);
+  CHECK_THROWS(particles.add_field("x0", 1));
+  CHECK_THROWS(particles.field("v"));
+  std::ranges::copy(particles.x(), particles.field("x0").begin());
+  const std::array<double, 3> dx = {0.04, -0.03, 0};
+  for (int step = 0; step < 3; ++step)
+  {
+    std::span<double> x = particles.x();
+    for (std::size_t p = 0; p < particles.num_particles(); ++p)
+      for (int j = 0; j < 3; ++j)
+        x[3 * p + j] += dx[j];
+    particles.relocate();
+    CHECK(num_global(particles) == num);
+    check_cells(particles);
+  }
+  std::span<const double> x0 = particles.field("x0");
+  for (std::size_t p = 0; p < particles.num_particles(); ++p)
+  {
+    for (int j = 0; j < 3; ++j)
+      CHECK(particles.x()[3 * p + j] - x0[3 * p + j]
+            == Catch::Approx(3 * dx[j]).margin(1e-12));
+  }
+
+  // Evaluate a linear function at the particles
+  auto V1 = create_space(mesh, 1);
+  fem::Function<double> u(V1);
+  u.interpolate(
+      [](auto x) -> std::pair<std::vector<double>, std::vector<std::size_t>>
+      {
+        std::vector<double> f(x.extent(1));
+        for (std::size_t p = 0; p < x.extent(1); ++p)
+          f[p] = x(0, p) + 2 * x(1, p);
+        return {f, {f.size()}};
+      });
+  std::vector<double> values(particles.num_particles());
+  particles.eval(u, std::span(values));
+  for (std::size_t p = 0; p < values.size(); ++p)
+  {
+    std::span<const double> x = particles.x().subspan(3 * p, 3);
+    CHECK(values[p] == Catch::Approx(x[0] + 2 * x[1]));
+  }
+
+  // Deposit one per particle onto a piecewise constant function gives
+  // the number of particles in each cell
+  auto V0 = create_space(mesh, 0);
+  fem::Function<double> n(V0);
+  std::vector<double> ones(particles.num_particles(), 1);
+  particles.scatter_rev(std::span<const double>(ones), n);
+  std::span<const std::int32_t> offsets = particles.cell_offsets();
+  for (std::size_t c = 0; c + 1 < offsets.size(); ++c)
+  {
+    std::int32_t dof = V0->dofmap()->cell_dofs(c).front();
+    CHECK(n.x()->array()[dof] == offsets[c + 1] - offsets[c]);
+  }
+
+  // Particles that leave the domain are removed
+  std::span<double> x = particles.x();
+  for (std::size_t p = 0; p < particles.num_particles(); p += 2)
+    x[3 * p] += 2;
+  std::int64_t num_removed = (particles.num_particles() + 1) / 2;
+  MPI_Allreduce(MPI_IN_PLACE, &num_removed, 1, MPI_INT64_T, MPI_SUM,
+                MPI_COMM_WORLD);
+  particles.relocate();
+  CHECK(num_global(particles) == num - num_removed);
+  check_cells(particles);
+}
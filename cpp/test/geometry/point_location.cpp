@@ -0,0 +1,84 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for locating points in mesh cells
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/generation.h>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+void test_locate_points(mesh::CellType cell_type)
+{
+  auto mesh = mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {5, 4, 6},
+      cell_type);
+  const int tdim = mesh.topology()->dim();
+  geometry::BoundingBoxTree<double> tree(mesh, tdim);
+
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<double> dist(0.01, 0.99);
+  std::vector<double> points(3 * 200);
+  std::ranges::generate(points, [&]() { return dist(rng); });
+
+  // Check that the cell located for each point contains the point
+  auto check_cells = [&](const std::vector<std::int32_t>& cells)
+  {
+    for (std::size_t p = 0; p < cells.size(); ++p)
+    {
+      REQUIRE(cells[p] >= 0);
+      std::vector<double> d2 = geometry::squared_distance<double>(
+          mesh, tdim, std::span(&cells[p], 1),
+          std::span<const double>(points.data() + 3 * p, 3));
+      CHECK(d2.front() < 1e-12);
+    }
+  };
+
+  // Without guesses the tree is used
+  std::vector<std::int32_t> guesses(points.size() / 3, -1);
+  auto [cells, status] = geometry::locate_points<double>(
+      mesh, tree, points, guesses);
+  check_cells(cells);
+  CHECK(std::ranges::all_of(status, [](auto s)
+                            { return s == geometry::PointLocation::tree; }));
+
+  // Move the points by less than a cell and walk from the previous
+  // cells
+  for (std::size_t i = 0; i < points.size(); ++i)
+    points[i] = std::clamp(points[i] + 0.3 * (dist(rng) - 0.5), 0.01, 0.99);
+  auto [cells1, status1]
+      = geometry::locate_points<double>(mesh, tree, points, cells);
+  check_cells(cells1);
+  CHECK(std::ranges::count(status1, geometry::PointLocation::tree)
+        < static_cast<long>(status1.size() / 10));
+  CHECK(std::ranges::any_of(
+      status1, [](auto s) { return s == geometry::PointLocation::walk; }));
+
+  // Points outside the mesh
+  std::vector<double> outside = {1.5, 0.5, 0.5, 0.5, -0.2, 0.5};
+  std::vector<std::int32_t> guess_outside = {cells1[0], -1};
+  auto [cells2, status2]
+      = geometry::locate_points<double>(mesh, tree, outside, guess_outside);
+  CHECK(cells2 == std::vector<std::int32_t>{-1, -1});
+  CHECK(std::ranges::all_of(
+      status2, [](auto s) { return s == geometry::PointLocation::not_found; }));
+}
+} // namespace
+
+TEST_CASE("Locate points with cell walking", "[point_location]")
+{
+  test_locate_points(mesh::CellType::tetrahedron);
+  test_locate_points(mesh::CellType::hexahedron);
+}
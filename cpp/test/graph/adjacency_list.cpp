@@ -0,0 +1,72 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for adjacency lists with 64-bit offsets and compressed
+// adjacency lists
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/CompressedAdjacencyList.h>
+#include <type_traits>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("AdjacencyList with 64-bit offsets", "[adjacency_list]")
+{
+  std::vector<std::int64_t> array = {3, 1, 4, 1, 5, 9, 2, 6};
+  std::vector<std::int64_t> offsets = {0, 3, 3, 8};
+  graph::AdjacencyList list(array, offsets);
+  static_assert(std::is_same_v<decltype(list),
+                               graph::AdjacencyList<std::int64_t,
+                                                    std::int64_t>>);
+  CHECK(list.num_nodes() == 3);
+  CHECK(list.num_links(0) == 3);
+  CHECK(list.num_links(1) == 0);
+  CHECK(list.links(2)[2] == 9);
+  CHECK(list.offsets() == offsets);
+
+  graph::AdjacencyList<std::int64_t> list32(
+      array, std::vector<std::int32_t>{0, 3, 3, 8});
+  CHECK(list32.num_links(2) == list.num_links(2));
+}
+
+TEST_CASE("Compressed AdjacencyList", "[adjacency_list]")
+{
+  // Links with negative and positive differences, large values and an
+  // empty node
+  std::vector<std::vector<std::int64_t>> data
+      = {{10, 11, 12, 13},
+         {},
+         {1000000, 5, 1ll << 40, -7},
+         {0},
+         {std::int64_t(1) << 62, -(std::int64_t(1) << 62)}};
+  graph::AdjacencyList<std::int64_t> list(data);
+
+  graph::CompressedAdjacencyList compressed(list);
+  REQUIRE(compressed.num_nodes() == list.num_nodes());
+  std::vector<std::int64_t> links;
+  for (std::int32_t n = 0; n < list.num_nodes(); ++n)
+  {
+    CHECK(compressed.num_links(n) == list.num_links(n));
+    compressed.links(n, links);
+    CHECK(links == data[n]);
+  }
+
+  CHECK(compressed.decompress() == list);
+  CHECK(compressed.decompress<std::int64_t>().offsets().back()
+        == (std::int64_t)list.array().size());
+
+  // Numerically close links are stored in fewer bytes
+  std::vector<std::int32_t> cells(4000);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    cells[i] = i / 2 + i % 4;
+  auto c = graph::regular_adjacency_list(cells, 4);
+  graph::CompressedAdjacencyList cc(c);
+  CHECK(cc.decompress() == c);
+  CHECK(cc.memory_usage().total() < c.memory_usage().total());
+}
@@ -0,0 +1,131 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for graph re-ordering
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/ordering.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Graph of a n x n grid of nodes (plus an isolated node and a detached
+// pair of nodes), with the nodes randomly numbered
+graph::AdjacencyList<std::int32_t> create_grid_graph(std::int32_t n)
+{
+  const std::int32_t num_nodes = n * n + 3;
+  std::vector<std::int32_t> perm(num_nodes);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::mt19937 rng(7);
+  std::ranges::shuffle(perm, rng);
+
+  std::vector<std::vector<std::int32_t>> links(num_nodes);
+  auto add_edge = [&](std::int32_t a, std::int32_t b)
+  {
+    links[perm[a]].push_back(perm[b]);
+    links[perm[b]].push_back(perm[a]);
+  };
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    for (std::int32_t j = 0; j < n; ++j)
+    {
+      if (i + 1 < n)
+        add_edge(i * n + j, (i + 1) * n + j);
+      if (j + 1 < n)
+        add_edge(i * n + j, i * n + j + 1);
+    }
+  }
+  add_edge(n * n + 1, n * n + 2);
+
+  return graph::AdjacencyList<std::int32_t>(links);
+}
+
+// Graph of `num_layers` layers of `width` nodes, with node i of each
+// layer linked to two nodes of the next layer, randomly numbered. The
+// level structures of the graph are wide.
+graph::AdjacencyList<std::int32_t> create_layered_graph(std::int32_t width,
+                                                        int num_layers)
+{
+  const std::int32_t num_nodes = width * num_layers;
+  std::vector<std::int32_t> perm(num_nodes);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::mt19937 rng(11);
+  std::ranges::shuffle(perm, rng);
+
+  std::vector<std::vector<std::int32_t>> links(num_nodes);
+  auto add_edge = [&](std::int32_t a, std::int32_t b)
+  {
+    links[perm[a]].push_back(perm[b]);
+    links[perm[b]].push_back(perm[a]);
+  };
+  for (int l = 0; l + 1 < num_layers; ++l)
+  {
+    for (std::int32_t i = 0; i < width; ++i)
+    {
+      add_edge(l * width + i, (l + 1) * width + i);
+      add_edge(l * width + i, (l + 1) * width + (7 * i + 3) % width);
+    }
+  }
+
+  return graph::AdjacencyList<std::int32_t>(links);
+}
+
+// Bandwidth of a graph after re-ordering
+std::int32_t bandwidth(const graph::AdjacencyList<std::int32_t>& graph,
+                       const std::vector<std::int32_t>& map)
+{
+  std::int32_t bw = 0;
+  for (std::int32_t i = 0; i < graph.num_nodes(); ++i)
+    for (std::int32_t j : graph.links(i))
+      bw = std::max(bw, std::abs(map[i] - map[j]));
+  return bw;
+}
+} // namespace
+
+TEST_CASE("Reverse Cuthill-McKee reordering", "[ordering]")
+{
+  const std::int32_t n = 40;
+  graph::AdjacencyList<std::int32_t> graph = create_grid_graph(n);
+
+  std::vector<std::int32_t> map = graph::reorder_rcm(graph);
+
+  // Re-ordering is a permutation
+  std::vector<std::int32_t> sorted = map;
+  std::ranges::sort(sorted);
+  std::vector<std::int32_t> range(graph.num_nodes());
+  std::iota(range.begin(), range.end(), 0);
+  CHECK(sorted == range);
+
+  // Bandwidth is of the order of the grid width
+  std::vector<std::int32_t> identity = range;
+  CHECK(bandwidth(graph, identity) > 10 * n);
+  CHECK(bandwidth(graph, map) <= 2 * n);
+
+  // Threaded ordering is identical
+  CHECK(graph::reorder_rcm(graph, 4) == map);
+}
+
+TEST_CASE("Threaded reverse Cuthill-McKee reordering", "[ordering]")
+{
+  graph::AdjacencyList<std::int32_t> graph = create_layered_graph(20000, 6);
+  std::vector<std::int32_t> map = graph::reorder_rcm(graph);
+  std::vector<std::int32_t> sorted = map;
+  std::ranges::sort(sorted);
+  std::vector<std::int32_t> range(graph.num_nodes());
+  std::iota(range.begin(), range.end(), 0);
+  REQUIRE(sorted == range);
+
+  CHECK(graph::reorder_rcm(graph, 3) == map);
+  CHECK(graph::reorder_rcm(graph, 4) == map);
+}
@@ -4,10 +4,322 @@
 //
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
-#ifdef HAS_ADIOS2
-
 #include <algorithm>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/ElementDofLayout.h>
+#include <dolfinx/io/cells.h>
+#include <dolfinx/io/gmsh.h>
+#include <dolfinx/io/snapshot.h>
+#include <dolfinx/io/xdmf_utils.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mpi.h>
+#include <numeric>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("In-place cell permutation")
+{
+  for (auto [type, num_nodes] :
+       {std::pair{mesh::CellType::triangle, 10},
+        std::pair{mesh::CellType::quadrilateral, 9},
+        std::pair{mesh::CellType::tetrahedron, 20},
+        std::pair{mesh::CellType::hexahedron, 27}})
+  {
+    const std::vector<std::uint16_t> p = io::cells::perm_vtk(type, num_nodes);
+    const std::size_t num_cells = 5;
+    std::vector<std::int64_t> cells(num_cells * num_nodes);
+    std::iota(cells.begin(), cells.end(), 0);
+    std::vector<std::int64_t> cells_p = io::cells::apply_permutation(
+        cells, {num_cells, std::size_t(num_nodes)}, p);
+    io::cells::apply_permutation_inplace(cells, num_nodes, p);
+    CHECK(cells == cells_p);
+  }
+}
+
+namespace
+{
+/// Write values in binary to a stream
+template <typename... U>
+void write_binary(std::ofstream& f, U... v)
+{
+  (f.write(reinterpret_cast<const char*>(&v), sizeof(v)), ...);
+}
+} // namespace
+
+TEST_CASE("Read Gmsh mesh")
+{
+  // Unit square with two triangles (physical group 7) and two boundary
+  // lines, of which one is in physical group 3. The nodes are in two
+  // blocks and not sorted by tag.
+  using u64 = std::uint64_t;
+  const std::filesystem::path filename = "test_square.msh";
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    std::ofstream f(filename, std::ios::binary);
+    f << "$MeshFormat\n4.1 1 8\n";
+    write_binary(f, 1);
+    f << "\n$EndMeshFormat\n";
+    f << "$PhysicalNames\n2\n1 3 \"bottom\"\n2 7 \"domain\"\n"
+      << "$EndPhysicalNames\n";
+
+    f << "$Entities\n";
+    write_binary(f, u64(0), u64(2), u64(1), u64(0));
+    write_binary(f, 1, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, u64(1), 3, u64(0));
+    write_binary(f, 2, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0, u64(0), u64(0));
+    write_binary(f, 1, 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, u64(1), 7, u64(1), 1);
+    f << "\n$EndEntities\n";
+
+    f << "$Nodes\n";
+    write_binary(f, u64(2), u64(4), u64(1), u64(4));
+    write_binary(f, 0, 1, 0, u64(2), u64(1), u64(2));
+    write_binary(f, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+    write_binary(f, 2, 1, 0, u64(2), u64(4), u64(3));
+    write_binary(f, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0);
+    f << "\n$EndNodes\n";
+
+    f << "$Elements\n";
+    write_binary(f, u64(3), u64(4), u64(1), u64(4));
+    write_binary(f, 1, 1, 1, u64(1), u64(1), u64(1), u64(2));
+    write_binary(f, 1, 2, 1, u64(1), u64(2), u64(2), u64(3));
+    write_binary(f, 2, 1, 2, u64(2), u64(3), u64(1), u64(2), u64(3));
+    write_binary(f, u64(4), u64(1), u64(3), u64(4));
+    f << "\n$EndElements\n";
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  auto [mesh, cell_tags, facet_tags]
+      = io::gmsh::read_mesh<double>(MPI_COMM_WORLD, filename, 2);
+  CHECK(mesh.geometry().dim() == 2);
+  CHECK(mesh.topology()->index_map(2)->size_global() == 2);
+  CHECK(mesh.topology()->index_map(0)->size_global() == 4);
+
+  // Count the owned tagged entities
+  auto count = [](const mesh::MeshTags<std::int32_t>& tags, int value)
+  {
+    auto map = tags.topology()->index_map(tags.dim());
+    std::int32_t n = 0;
+    for (std::size_t i = 0; i < tags.indices().size(); ++i)
+    {
+      if (tags.indices()[i] < map->size_local() and tags.values()[i] == value)
+        ++n;
+    }
+    std::int32_t n_global = 0;
+    MPI_Allreduce(&n, &n_global, 1, MPI_INT32_T, MPI_SUM, MPI_COMM_WORLD);
+    return n_global;
+  };
+  CHECK(count(cell_tags, 7) == 2);
+  CHECK(count(facet_tags, 3) == 1);
+
+  // The tagged facet is the bottom edge
+  std::vector<double> x
+      = mesh::compute_midpoints(mesh, 1, facet_tags.indices());
+  for (std::size_t i = 0; i < x.size(); i += 3)
+  {
+    CHECK(x[i] == Catch::Approx(0.5));
+    CHECK(x[i + 1] == Catch::Approx(0.0).margin(1e-12));
+  }
+}
+
+TEST_CASE("Mesh snapshot")
+{
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::shared_facet);
+  mesh::Mesh<double> mesh0 = mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {3, 4, 2},
+      mesh::CellType::tetrahedron, part);
+  mesh0.name = "box";
+  auto topology0 = mesh0.topology();
+  topology0->create_connectivity(2, 3);
+  topology0->create_entity_permutations();
+
+  const std::filesystem::path dir = "test_mesh_snapshot";
+  io::write_mesh_snapshot(mesh0, dir);
+  mesh::Mesh<double> mesh1
+      = io::read_mesh_snapshot<double>(MPI_COMM_WORLD, dir);
+  auto topology1 = mesh1.topology();
+
+  CHECK(mesh1.name == "box");
+  for (int d = 0; d <= 3; ++d)
+  {
+    auto map0 = topology0->index_map(d);
+    auto map1 = topology1->index_map(d);
+    REQUIRE(map1);
+    CHECK(map1->local_range() == map0->local_range());
+    CHECK(map1->size_global() == map0->size_global());
+    CHECK(std::ranges::equal(map1->ghosts(), map0->ghosts()));
+    CHECK(std::ranges::equal(map1->owners(), map0->owners()));
+    CHECK(std::ranges::equal(map1->dest(), map0->dest()));
+    for (int d1 = 0; d1 <= 3; ++d1)
+    {
+      auto c0 = topology0->connectivity(d, d1);
+      auto c1 = topology1->connectivity(d, d1);
+      REQUIRE((c0 == nullptr) == (c1 == nullptr));
+      if (c0)
+        CHECK(*c0 == *c1);
+    }
+  }
+  CHECK(topology1->get_cell_permutation_info()
+        == topology0->get_cell_permutation_info());
+  CHECK(topology1->get_facet_permutations()
+        == topology0->get_facet_permutations());
+  CHECK(topology1->interprocess_facets() == topology0->interprocess_facets());
+  CHECK(topology1->original_cell_index == topology0->original_cell_index);
+  CHECK(*topology1->exterior_facets() == *topology0->exterior_facets());
+
+  CHECK(std::ranges::equal(mesh1.geometry().x(), mesh0.geometry().x()));
+  CHECK(mesh1.geometry().dofmap().extent(0)
+        == mesh0.geometry().dofmap().extent(0));
+  CHECK(std::ranges::equal(
+      std::span(mesh1.geometry().dofmap().data_handle(),
+                mesh1.geometry().dofmap().size()),
+      std::span(mesh0.geometry().dofmap().data_handle(),
+                mesh0.geometry().dofmap().size())));
+  CHECK(mesh1.geometry().input_global_indices()
+        == mesh0.geometry().input_global_indices());
+  CHECK(mesh1.geometry().cmap().degree() == mesh0.geometry().cmap().degree());
+}
+
+namespace
+{
+/// Tag of an entity, computed from the sorted input indices of its
+/// vertices
+std::int32_t entity_tag(std::vector<std::int64_t> nodes)
+{
+  std::ranges::sort(nodes);
+  std::int64_t tag = 0;
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+    tag += (i + 1) * nodes[i];
+  return tag;
+}
+
+/// Tag the entities of dimension `dim` owned by each process, pass them
+/// by input index to the next process, and check that
+/// distribute_entity_data returns every local entity with its tag,
+/// including entities with vertices owned by other processes
+void test_distribute_entity_data(int dim)
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  mesh::Mesh<double> mesh = mesh::create_box<double>(
+      comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 3, 3},
+      mesh::CellType::tetrahedron);
+  auto topology = mesh.topology();
+  const int tdim = topology->dim();
+  topology->create_connectivity(dim, 0);
+
+  const mesh::Geometry<double>& geometry = mesh.geometry();
+  const fem::ElementDofLayout layout = geometry.cmap().create_dof_layout();
+  auto xdofmap = geometry.dofmap();
+  std::span<const std::int64_t> nodes_g = geometry.input_global_indices();
+
+  // Input index of each vertex
+  auto c_to_v = topology->connectivity(tdim, 0);
+  auto vmap = topology->index_map(0);
+  std::vector<std::int64_t> vertex_nodes(vmap->size_local()
+                                         + vmap->num_ghosts());
+  for (std::int32_t c = 0; c < c_to_v->num_nodes(); ++c)
+  {
+    auto vertices = c_to_v->links(c);
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+      const int dof = layout.entity_dofs(0, i).front();
+      vertex_nodes[vertices[i]] = nodes_g[xdofmap(c, dof)];
+    }
+  }
+  auto nodes = [&vertex_nodes](auto vertices)
+  {
+    std::vector<std::int64_t> n;
+    for (std::int32_t v : vertices)
+      n.push_back(vertex_nodes[v]);
+    return n;
+  };
+
+  // Owned entities by input index, with their tags
+  auto e_to_v = topology->connectivity(dim, 0);
+  auto emap = topology->index_map(dim);
+  const int num_vertices = mesh::cell_num_entities(
+      mesh::cell_entity_type(topology->cell_type(), dim, 0), 0);
+  std::vector<std::int64_t> entities0;
+  std::vector<std::int32_t> tags0;
+  for (std::int32_t e = 0; e < emap->size_local(); ++e)
+  {
+    std::vector<std::int64_t> n = nodes(e_to_v->links(e));
+    entities0.insert(entities0.end(), n.begin(), n.end());
+    tags0.push_back(entity_tag(n));
+  }
+
+  // Pass the entities to the next process, which in general does not
+  // have all of them
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  const int dest = (rank + 1) % size;
+  const int src = (rank + size - 1) % size;
+  int num_send = tags0.size();
+  int num_recv = 0;
+  MPI_Sendrecv(&num_send, 1, MPI_INT, dest, 0, &num_recv, 1, MPI_INT, src, 0,
+               comm, MPI_STATUS_IGNORE);
+  std::vector<std::int64_t> entities1(num_recv * num_vertices);
+  std::vector<std::int32_t> tags1(num_recv);
+  MPI_Sendrecv(entities0.data(), entities0.size(), MPI_INT64_T, dest, 1,
+               entities1.data(), entities1.size(), MPI_INT64_T, src, 1, comm,
+               MPI_STATUS_IGNORE);
+  MPI_Sendrecv(tags0.data(), tags0.size(), MPI_INT32_T, dest, 2,
+               tags1.data(), tags1.size(), MPI_INT32_T, src, 2, comm,
+               MPI_STATUS_IGNORE);
+
+  auto [entities, tags] = io::xdmf_utils::distribute_entity_data<std::int32_t>(
+      *topology, nodes_g, geometry.index_map()->size_global(), layout,
+      xdofmap, dim,
+      MDSPAN_IMPL_STANDARD_NAMESPACE::mdspan<
+          const std::int64_t,
+          MDSPAN_IMPL_STANDARD_NAMESPACE::dextents<std::size_t, 2>>(
+          entities1.data(), num_recv, num_vertices),
+      std::span<const std::int32_t>(tags1));
+  REQUIRE(entities.size() == tags.size() * num_vertices);
+
+  // Each returned entity is returned once, with the tag of its vertices
+  std::map<std::vector<std::int32_t>, std::int32_t> received;
+  for (std::size_t i = 0; i < tags.size(); ++i)
+  {
+    std::vector<std::int32_t> vertices(
+        std::next(entities.begin(), i * num_vertices),
+        std::next(entities.begin(), (i + 1) * num_vertices));
+    CHECK(tags[i] == entity_tag(nodes(vertices)));
+    std::ranges::sort(vertices);
+    CHECK(received.emplace(vertices, tags[i]).second);
+  }
+
+  // Every local entity, owned or ghost, is returned
+  for (std::int32_t e = 0; e < emap->size_local() + emap->num_ghosts(); ++e)
+  {
+    auto links = e_to_v->links(e);
+    std::vector<std::int32_t> vertices(links.begin(), links.end());
+    std::ranges::sort(vertices);
+    CHECK(received.contains(vertices));
+  }
+}
+} // namespace
+
+TEST_CASE("Distribute mesh entity data")
+{
+  CHECK_NOTHROW(test_distribute_entity_data(2));
+  CHECK_NOTHROW(test_distribute_entity_data(1));
+}
+
+#ifdef HAS_ADIOS2
+
 #include <concepts>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
@@ -17,8 +329,6 @@
 #include <dolfinx/mesh/generation.h>
 #include <mpi.h>
 
-using namespace dolfinx;
-
 namespace
 {
 
@@ -0,0 +1,217 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the Krylov solvers
+
+#include "tridiagonal.h"
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/la/krylov.h>
+#include <dolfinx/la/preconditioners.h>
+#include <numeric>
+
+using namespace dolfinx;
+
+namespace
+{
+template <typename T>
+void test_krylov()
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  const U rtol = std::is_same_v<U, float> ? 1e-5 : 1e-10;
+
+  auto check = [rtol](auto& A, auto&& solve)
+  {
+    auto map = A.index_map(0);
+    auto col_map = A.index_map(1);
+    la::Vector<T> x(col_map, 1), b(col_map, 1), r(col_map, 1);
+    std::span _b = b.mutable_array();
+    for (std::int32_t i = 0; i < map->size_local(); ++i)
+      _b[i] = std::cos(static_cast<U>(map->local_range()[0] + i));
+
+    auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+    auto result = solve(op, x, b);
+    CHECK(result.converged);
+
+    A.mult(x, r);
+    for (std::int32_t i = 0; i < map->size_local(); ++i)
+      r.mutable_array()[i] -= b.array()[i];
+    CHECK(la::norm(r) <= 10 * rtol * la::norm(b));
+  };
+
+  // Jacobi preconditioner
+  auto jacobi = [](const la::Vector<T>& r, la::Vector<T>& z)
+  {
+    const std::int32_t n = r.index_map()->size_local();
+    for (std::int32_t i = 0; i < n; ++i)
+      z.mutable_array()[i] = r.array()[i] / T(2.1);
+  };
+
+  // Symmetric positive definite
+  la::MatrixCSR<T> A = test::create_tridiagonal<T>(MPI_COMM_WORLD, 2.1, 0);
+  check(A, [&](auto& op, auto& x, auto& b)
+        { return la::cg(op, la::IdentityPreconditioner(), x, b, rtol); });
+  check(A, [&](auto& op, auto& x, auto& b)
+        { return la::cg(op, jacobi, x, b, rtol); });
+  check(A, [&](auto& op, auto& x, auto& b)
+        { return la::pipelined_cg(op, jacobi, x, b, rtol); });
+
+  // Non-symmetric
+  la::MatrixCSR<T> B = test::create_tridiagonal<T>(MPI_COMM_WORLD, 2.1, 0.4);
+  check(B, [&](auto& op, auto& x, auto& b)
+        { return la::gmres(op, jacobi, x, b, 10, rtol); });
+  check(B, [&](auto& op, auto& x, auto& b)
+        { return la::bicgstab(op, jacobi, x, b, rtol); });
+}
+
+template <typename T>
+void test_preconditioners()
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  const U rtol = std::is_same_v<U, float> ? 1e-5 : 1e-10;
+
+  // Symmetric positive definite with eigenvalues in (0.1, 4.1)
+  la::MatrixCSR<T> A = test::create_tridiagonal<T>(MPI_COMM_WORLD, 2.1, 0);
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+  auto map = A.index_map(0);
+
+  std::vector<T> d = la::diagonal(A);
+  CHECK(d.size() == std::size_t(map->size_local()));
+  CHECK(std::ranges::all_of(d, [](auto di) { return di == T(2.1); }));
+
+  auto check = [&](auto&& M)
+  {
+    la::Vector<T> x(A.index_map(1), 1), b(A.index_map(1), 1),
+        r(A.index_map(1), 1);
+    std::span _b = b.mutable_array();
+    for (std::int32_t i = 0; i < map->size_local(); ++i)
+      _b[i] = std::cos(static_cast<U>(map->local_range()[0] + i));
+
+    auto result = la::cg(op, M, x, b, rtol);
+    CHECK(result.converged);
+    A.mult(x, r);
+    for (std::int32_t i = 0; i < map->size_local(); ++i)
+      r.mutable_array()[i] -= b.array()[i];
+    CHECK(la::norm(r) <= 10 * rtol * la::norm(b));
+    return result.iterations;
+  };
+
+  la::Jacobi<T> jacobi(A);
+  check(jacobi);
+  check(la::Jacobi<T>(A, true));
+  check(la::BlockJacobi<T>(A));
+  check(la::SymmetricGaussSeidel<T>(A));
+  check(la::SymmetricGaussSeidel<T>(A, 3));
+
+  // Largest eigenvalue of the Jacobi preconditioned operator
+  la::Vector<T> x0(A.index_map(1), 1);
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    x0.mutable_array()[i] = 1 + std::sin(static_cast<U>(i));
+  using V = la::Vector<T>;
+  const U lmax = la::estimate_max_eigenvalue(op, jacobi, x0, 20);
+  CHECK(lmax > U(1.8));
+  CHECK(lmax <= U(4.1 / 2.1) * (1 + 10 * rtol));
+
+  // An accurate Chebyshev preconditioner reduces the number of CG
+  // iterations
+  la::Chebyshev<V> chebyshev(op, jacobi, U(0.1 / 2.1), U(1.1) * lmax, 4);
+  CHECK(check(chebyshev) < check(jacobi));
+}
+
+/// Block Jacobi for a matrix with 2 x 2 diagonal blocks is a direct
+/// solver
+template <typename T>
+void test_block_jacobi()
+{
+  constexpr std::int32_t n = 10;
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, n);
+  la::SparsityPattern p(MPI_COMM_WORLD, {map, map}, {2, 2});
+  for (std::int32_t i = 0; i < n; ++i)
+    p.insert(std::span(&i, 1), std::span(&i, 1));
+  p.finalize();
+
+  la::MatrixCSR<T> A(p);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    // Needs pivoting for even rows
+    std::vector<T> block = {T(i % 2), 4, 2, T(10 + i)};
+    A.template add<2, 2>(block, std::vector{i}, std::vector{i});
+  }
+
+  std::vector<T> d = la::diagonal(A);
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    CHECK(d[2 * i] == T(i % 2));
+    CHECK(d[2 * i + 1] == T(10 + i));
+  }
+
+  la::Vector<T> r(map, 2), z(map, 2), y(map, 2);
+  std::ranges::fill(r.mutable_array(), T(1));
+  la::BlockJacobi<T>{A}(r, z);
+  A.mult(z, y);
+  for (auto yi : y.array())
+    CHECK(std::abs(yi - T(1)) < 1e-5);
+
+  std::vector<T> singular = {1, 2, 2, 4};
+  A.template set<2, 2>(singular, std::vector{0}, std::vector{0});
+  CHECK_THROWS(la::BlockJacobi<T>{A});
+}
+
+/// Iterative refinement with inner solves in single precision
+template <typename T, typename W>
+void test_iterative_refinement()
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  la::MatrixCSR<T> A = test::create_tridiagonal<T>(MPI_COMM_WORLD, 2.1, 0);
+  la::MatrixCSR<W> Aw(A);
+
+  auto map = A.index_map(0);
+  la::Vector<T> x(A.index_map(1), 1), b(A.index_map(1), 1);
+  std::span _b = b.mutable_array();
+  for (std::int32_t i = 0; i < map->size_local(); ++i)
+    _b[i] = std::cos(static_cast<U>(map->local_range()[0] + i));
+
+  auto op = [&A](auto& x, auto& y) { A.mult(x, y); };
+  auto solve = [&Aw](auto& r, auto& d)
+  {
+    auto op = [&Aw](auto& x, auto& y) { Aw.mult(x, y); };
+    la::cg(op, la::IdentityPreconditioner(), d, r, 1e-4);
+  };
+  auto result = la::iterative_refinement<W>(op, solve, x, b, 1e-12);
+  CHECK(result.converged);
+  CHECK(result.residual_norm <= 1e-12 * la::norm(b));
+  CHECK(result.iterations > 1);
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Krylov solvers", "[la_krylov]", float, double,
+                   std::complex<double>)
+{
+  CHECK_NOTHROW(test_krylov<TestType>());
+}
+
+TEMPLATE_TEST_CASE("Preconditioners", "[la_krylov]", float, double,
+                   std::complex<double>)
+{
+  CHECK_NOTHROW(test_preconditioners<TestType>());
+  CHECK_NOTHROW(test_block_jacobi<TestType>());
+}
+
+TEST_CASE("Mixed precision iterative refinement", "[la_krylov]")
+{
+  CHECK_NOTHROW(test_iterative_refinement<double, float>());
+  CHECK_NOTHROW(
+      (test_iterative_refinement<std::complex<double>, std::complex<float>>()));
+}
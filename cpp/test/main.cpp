@@ -8,8 +8,10 @@ int main(int argc, char* argv[])
   dolfinx::init_logging(argc, argv);
 
   // Parallel tests require MPI initialization before any tests run and
-  // termination only after all tests complete.
-  MPI_Init(&argc, &argv);
+  // termination only after all tests complete. Threaded functions need
+  // threads that do not call MPI.
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
   int result = Catch::Session().run(argc, argv);
   MPI_Finalize();
   return result;
@@ -13,96 +13,17 @@
 #include <catch2/catch_test_macros.hpp>
 #include <dolfinx.h>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/BlockMatrixCSR.h>
 #include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/MatrixSELL.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/la/Vector.h>
+#include <numeric>
 
 using namespace dolfinx;
 
 namespace
 {
-/// Computes y += A*x for a local CSR matrix A and local dense vectors x,y
-/// @param[in] values Nonzero values of A
-/// @param[in] row_begin First index of each row in the arrays values and
-/// indices.
-/// @param[in] row_end Last index of each row in the arrays values and indices.
-/// @param[in] indices Column indices for each non-zero element of the matrix A
-/// @param[in] x Input vector
-/// @param[in, out] x Output vector
-template <typename T>
-void spmv_impl(std::span<const T> values,
-               std::span<const std::int64_t> row_begin,
-               std::span<const std::int64_t> row_end,
-               std::span<const std::int32_t> indices, std::span<const T> x,
-               std::span<T> y)
-{
-  assert(row_begin.size() == row_end.size());
-  for (std::size_t i = 0; i < row_begin.size(); i++)
-  {
-    double vi{0};
-    for (std::int32_t j = row_begin[i]; j < row_end[i]; j++)
-      vi += values[j] * x[indices[j]];
-    y[i] += vi;
-  }
-}
-
-// The matrix A is distributed across P  processes by blocks of rows:
-//  A = |   A_0  |
-//      |   A_1  |
-//      |   ...  |
-//      |  A_P-1 |
-//
-// Each submatrix A_i is owned by a single process "i" and can be further
-// decomposed into diagonal (Ai[0]) and off diagonal (Ai[1]) blocks:
-//  Ai = |Ai[0] Ai[1]|
-//
-// If A is square, the diagonal block Ai[0] is also square and contains
-// only owned columns and rows. The block Ai[1] contains ghost columns
-// (unowned dofs).
-
-// Likewise, a local vector x can be decomposed into owned and ghost blocks:
-// xi = |   x[0]  |
-//      |   x[1]  |
-//
-// So the product y = Ax can be computed into two separate steps:
-//  y[0] = |Ai[0] Ai[1]| |   x[0]  | = Ai[0] x[0] + Ai[1] x[1]
-//                       |   x[1]  |
-//
-/// Computes y += A*x for a parallel CSR matrix A and parallel dense vectors x,y
-/// @param[in] A Parallel CSR matrix
-/// @param[in] x Input vector
-/// @param[in, out] y Output vector
-template <typename T>
-void spmv(la::MatrixCSR<T>& A, la::Vector<T>& x, la::Vector<T>& y)
-{
-  // start communication (update ghosts)
-  x.scatter_fwd_begin();
-
-  const std::int32_t nrowslocal = A.num_owned_rows();
-  std::span<const std::int64_t> row_ptr(A.row_ptr().data(), nrowslocal + 1);
-  std::span<const std::int32_t> cols(A.cols().data(), row_ptr[nrowslocal]);
-  std::span<const std::int64_t> off_diag_offset(A.off_diag_offset().data(),
-                                                nrowslocal);
-  std::span<const T> values(A.values().data(), row_ptr[nrowslocal]);
-
-  std::span<const T> _x = x.array();
-  std::span<T> _y = y.mutable_array();
-
-  std::span<const std::int64_t> row_begin(row_ptr.data(), nrowslocal);
-  std::span<const std::int64_t> row_end(row_ptr.data() + 1, nrowslocal);
-
-  // First stage:  spmv - diagonal
-  // yi[0] += Ai[0] * xi[0]
-  spmv_impl<T>(values, row_begin, off_diag_offset, cols, _x, _y);
-
-  // finalize ghost update
-  x.scatter_fwd_end();
-
-  // Second stage:  spmv - off-diagonal
-  // yi[0] += Ai[1] * xi[1]
-  spmv_impl<T>(values, off_diag_offset, row_end, cols, _x, _y);
-}
-
 /// @brief Create a matrix operator
 /// @param comm The communicator to builf the matrix on
 /// @return The assembled matrix
@@ -191,10 +112,173 @@ la::MatrixCSR<double> create_operator(MPI_Comm comm)
 
   // Matrix A represents the action of the Laplace operator, so when
   // applied to a constant vector the result should be zero
-  spmv(A, x, y);
+  A.mult(x, y);
 
-  std::ranges::for_each(y.array(),
+  std::ranges::for_each(y.array().first(A.num_owned_rows()),
                         [](auto a) { REQUIRE(std::abs(a) < 1e-13); });
+
+  // y += Ax with a non-constant x should match computing the product
+  // row-by-row from the full CSR data
+  std::span xa = x.mutable_array();
+  for (std::size_t i = 0; i < xa.size(); ++i)
+    xa[i] = std::sin(static_cast<double>(col_map->local_range()[0] + i));
+  x.scatter_fwd();
+  std::vector<double> y_ref(A.num_owned_rows(), 1);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    for (std::int64_t j = A.row_ptr()[i]; j < A.row_ptr()[i + 1]; ++j)
+      y_ref[i] += A.values()[j] * x.array()[A.cols()[j]];
+
+  std::ranges::fill(y.mutable_array(), 1);
+  A.mult_add(x, y);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    CHECK(y.array()[i] == Catch::Approx(y_ref[i]).margin(1e-12));
+
+  // Sliced ELLPACK storage should give the same product
+  la::MatrixSELL<double> S(A, 64);
+  std::ranges::fill(y.mutable_array(), 1);
+  S.mult_add(x, y);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    CHECK(y.array()[i] == Catch::Approx(y_ref[i]).margin(1e-12));
+
+  // Compressed column indices should give the same product
+  A.compress_columns();
+  CHECK(A.compressed_columns());
+  std::ranges::fill(y.mutable_array(), 1);
+  A.mult_add(x, y);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    CHECK(y.array()[i] == Catch::Approx(y_ref[i]).margin(1e-12));
+
+  // Single precision matrix applied to double precision vectors
+  la::MatrixCSR<float> Af(A);
+  std::ranges::fill(y.mutable_array(), 1);
+  Af.mult_add(x, y);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    CHECK(y.array()[i] == Catch::Approx(y_ref[i]).margin(1e-5));
+
+  // Single precision vectors share the scatterer
+  la::Vector<float> xf(x), yf(y);
+  Af.mult(xf, yf);
+  A.mult(x, y);
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+    CHECK(yf.array()[i] == Catch::Approx(y.array()[i]).margin(1e-4));
+}
+
+[[maybe_unused]] void test_matrix_insertion_offsets()
+{
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::none);
+  auto mesh = std::make_shared<mesh::Mesh<double>>(mesh::create_box(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+      mesh::CellType::tetrahedron, part));
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::tetrahedron, 2,
+      basix::element::lagrange_variant::unset,
+      basix::element::dpc_variant::unset, false);
+  auto V = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace(mesh, element, {}));
+  auto kappa = std::make_shared<fem::Constant<double>>(2.0);
+  auto a = std::make_shared<fem::Form<double, double>>(
+      fem::create_form<double, double>(*form_poisson_a, {V, V}, {},
+                                       {{"kappa", kappa}}, {}, {}));
+
+  la::SparsityPattern sp = fem::create_sparsity_pattern(*a);
+  sp.finalize();
+
+  // Assemble and record insertion positions
+  la::MatrixCSR<double> A(sp);
+  std::vector<std::int64_t> offsets;
+  fem::assemble_matrix(A.mat_add_values_record(offsets), *a, {});
+  const std::vector<double> A0(A.values().begin(), A.values().end());
+
+  // Re-assemble using recorded positions
+  A.set(0.0);
+  fem::assemble_matrix(A.mat_add_values(std::span(offsets)), *a, {});
+  CHECK(std::ranges::equal(A.values(), A0));
+}
+
+[[maybe_unused]] void test_matrix_overlap()
+{
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::none);
+  auto mesh = std::make_shared<mesh::Mesh<double>>(mesh::create_box(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+      mesh::CellType::tetrahedron, part));
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::tetrahedron, 1,
+      basix::element::lagrange_variant::unset,
+      basix::element::dpc_variant::unset, false);
+  auto V = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace(mesh, element, {}));
+  auto kappa = std::make_shared<fem::Constant<double>>(2.0);
+  auto a = std::make_shared<fem::Form<double, double>>(
+      fem::create_form<double, double>(*form_poisson_a, {V, V}, {},
+                                       {{"kappa", kappa}}, {}, {}));
+
+  la::SparsityPattern sp = fem::create_sparsity_pattern(*a);
+  sp.finalize();
+  la::MatrixCSR<double> A(sp);
+  fem::assemble_matrix(A.mat_add_values(), *a, {});
+  A.scatter_rev();
+
+  // Overlapped assembly gives the same owned rows
+  la::MatrixCSR<double> B(A.layout());
+  auto coeffs = fem::allocate_coefficient_storage(*a);
+  fem::assemble_matrix_overlap(B, *a, a->packed_constants(),
+                               fem::make_coefficients_span(coeffs), {},
+                               fem::compute_interface_partition(*a));
+  const std::int64_t num_values = A.row_ptr()[A.num_owned_rows()];
+  for (std::int64_t k = 0; k < num_values; ++k)
+    CHECK(B.values()[k] == Catch::Approx(A.values()[k]).margin(1e-12));
+}
+
+[[maybe_unused]] void test_matrix_zero_rows_columns()
+{
+  la::MatrixCSR<double> A = create_operator(MPI_COMM_WORLD);
+  auto map0 = A.index_map(0);
+  auto col_map = A.index_map(1);
+  const std::int64_t offset = map0->local_range()[0];
+
+  // Global index of each local column
+  std::vector<std::int64_t> col_global(col_map->size_local()
+                                       + col_map->num_ghosts());
+  std::iota(col_global.begin(),
+            std::next(col_global.begin(), col_map->size_local()), offset);
+  std::ranges::copy(col_map->ghosts(),
+                    std::next(col_global.begin(), col_map->size_local()));
+  auto is_bc = [](std::int64_t dof) { return dof % 7 == 0; };
+
+  // Right-hand side b = A u and boundary values g = u on the dofs
+  la::Vector<double> u(col_map, 1), g(col_map, 1), b(col_map, 1);
+  std::vector<std::int32_t> dofs;
+  for (std::int32_t i = 0; i < map0->size_local(); ++i)
+  {
+    u.mutable_array()[i] = std::cos(static_cast<double>(offset + i));
+    if (is_bc(offset + i))
+    {
+      dofs.push_back(i);
+      g.mutable_array()[i] = u.array()[i];
+    }
+  }
+  A.mult(u, b);
+
+  // u solves the modified system
+  A.zero_rows_columns(dofs, 1.0, g, b);
+  la::Vector<double> y(col_map, 1);
+  A.mult(u, y);
+  for (std::int32_t i = 0; i < map0->size_local(); ++i)
+    CHECK(y.array()[i] == Catch::Approx(b.array()[i]).margin(1e-12));
+
+  // Rows and columns of the dofs, including ghost columns, are zero
+  // apart from the diagonal
+  for (std::int32_t i = 0; i < A.num_owned_rows(); ++i)
+  {
+    for (std::int64_t k = A.row_ptr()[i]; k < A.row_ptr()[i + 1]; ++k)
+    {
+      const std::int64_t j = col_global[A.cols()[k]];
+      if (j == offset + i and is_bc(j))
+        CHECK(A.values()[k] == 1.0);
+      else if (is_bc(offset + i) or is_bc(j))
+        CHECK(A.values()[k] == 0.0);
+    }
+  }
 }
 
 void test_matrix()
@@ -234,6 +318,72 @@ void test_matrix()
   CHECK(Adense(4, 4) != Aref(4, 4));
 }
 
+void test_block_matrix()
+{
+  // 2x2 block matrix with blocks of sizes 3 and 2 and an empty (1, 0)
+  // block
+  auto map0 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 3);
+  auto map1 = std::make_shared<common::IndexMap>(MPI_COMM_SELF, 2);
+  la::SparsityPattern p00(MPI_COMM_SELF, {map0, map0}, {1, 1});
+  la::SparsityPattern p01(MPI_COMM_SELF, {map0, map1}, {1, 1});
+  la::SparsityPattern p11(MPI_COMM_SELF, {map1, map1}, {1, 1});
+  for (std::int32_t i = 0; i < 3; ++i)
+    p00.insert(i, i);
+  p01.insert(0, 1);
+  p11.insert(1, 0);
+  for (auto p : {&p00, &p01, &p11})
+    p->finalize();
+
+  using T = double;
+  la::BlockMatrixCSR<la::MatrixCSR<T>> A({{&p00, &p01}, {nullptr, &p11}});
+  CHECK(A.num_blocks(0) == 2);
+  CHECK(A.has_block(0, 1));
+  CHECK(!A.has_block(1, 0));
+  CHECK_THROWS(A.block(1, 0));
+  CHECK(A.index_map(0, 1) == map1);
+
+  for (std::int32_t i = 0; i < 3; ++i)
+    A.block(0, 0).add(std::vector<T>{T(i + 1)}, std::vector{i}, std::vector{i});
+  A.block(0, 1).add(std::vector<T>{5}, std::vector{0}, std::vector{1});
+  A.block(1, 1).add(std::vector<T>{7}, std::vector{1}, std::vector{0});
+  CHECK(A.squared_norm() == 1 + 4 + 9 + 25 + 49);
+
+  // y = A x with x = ([1, 1, 1], [2, 3])
+  la::Vector<T> x0(map0, 1), x1(map1, 1), y0(map0, 1), y1(map1, 1);
+  x0.set(1);
+  std::ranges::copy(std::vector<T>{2, 3}, x1.mutable_array().begin());
+  std::vector<la::Vector<T>*> x = {&x0, &x1}, y = {&y0, &y1};
+  A.mult<la::Vector<T>>(x, y);
+  std::vector<T> y0_ref = {1 + 5 * 3, 2, 3}, y1_ref = {0, 7 * 2};
+  CHECK(std::ranges::equal(y0.array(), y0_ref));
+  CHECK(std::ranges::equal(y1.array(), y1_ref));
+}
+
+void test_matrix_shared_layout()
+{
+  la::MatrixCSR<double> A = create_operator(MPI_COMM_WORLD);
+
+  // A matrix created from the layout of A shares the layout but not the
+  // entries
+  la::MatrixCSR<double> B(A.layout());
+  CHECK(B.layout() == A.layout());
+  CHECK(B.cols().data() == A.cols().data());
+  CHECK(B.index_map(0) == A.index_map(0));
+  CHECK(B.values().size() == A.values().size());
+  CHECK(std::ranges::all_of(B.values(), [](auto x) { return x == 0.0; }));
+
+  std::ranges::copy(A.values(), B.values().begin());
+  B.scatter_rev();
+  A.scatter_rev();
+  CHECK(B.squared_norm() == Catch::Approx(A.squared_norm()));
+  B.set(1.0);
+  CHECK(A.squared_norm() != Catch::Approx(B.squared_norm()));
+
+  // Converting copies with the same index types share the layout
+  la::MatrixCSR<float> C(A);
+  CHECK(C.layout() == A.layout());
+}
+
 } // namespace
 
 TEST_CASE("Linear Algebra CSR Matrix", "[la_matrix]")
@@ -241,4 +391,9 @@ TEST_CASE("Linear Algebra CSR Matrix", "[la_matrix]")
   CHECK_NOTHROW(test_matrix());
   CHECK_NOTHROW(test_matrix_apply());
   CHECK_NOTHROW(test_matrix_norm());
+  CHECK_NOTHROW(test_matrix_insertion_offsets());
+  CHECK_NOTHROW(test_matrix_zero_rows_columns());
+  CHECK_NOTHROW(test_matrix_overlap());
+  CHECK_NOTHROW(test_block_matrix());
+  CHECK_NOTHROW(test_matrix_shared_layout());
 }
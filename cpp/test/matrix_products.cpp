@@ -0,0 +1,195 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for sparse matrix transpose and products
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <complex>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/matrix_products.h>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Dense global matrix with `m` rows and `n` columns (row-major)
+template <typename T>
+struct Dense
+{
+  std::int64_t m, n;
+  std::vector<T> data;
+  T operator()(std::int64_t i, std::int64_t j) const { return data[i * n + j]; }
+};
+
+template <typename T>
+Dense<T> dense_product(const Dense<T>& A, const Dense<T>& B, bool transpose_A)
+{
+  const std::int64_t m = transpose_A ? A.n : A.m;
+  const std::int64_t k = transpose_A ? A.m : A.n;
+  Dense<T> C{m, B.n, std::vector<T>(m * B.n, 0)};
+  for (std::int64_t i = 0; i < m; ++i)
+    for (std::int64_t l = 0; l < k; ++l)
+      for (std::int64_t j = 0; j < B.n; ++j)
+        C.data[i * B.n + j] += (transpose_A ? A(l, i) : A(i, l)) * B(l, j);
+  return C;
+}
+
+/// Create a distributed matrix with `m` owned rows and `n` owned
+/// columns on each process from a dense global matrix
+template <typename T>
+la::MatrixCSR<T> create_matrix(MPI_Comm comm, std::int32_t m, std::int32_t n,
+                               const Dense<T>& A)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  auto map0 = std::make_shared<common::IndexMap>(comm, m);
+
+  // Ghost columns and their owners
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  for (std::int64_t j = 0; j < A.n; ++j)
+  {
+    if (j / n == rank)
+      continue;
+    for (std::int64_t i = rank * m; i < (rank + 1) * m; ++i)
+    {
+      if (A(i, j) != T(0))
+      {
+        ghosts.push_back(j);
+        owners.push_back(j / n);
+        break;
+      }
+    }
+  }
+  auto map1 = std::make_shared<common::IndexMap>(comm, n, ghosts, owners);
+
+  auto local_col = [&](std::int64_t j) -> std::int32_t
+  {
+    if (j / n == rank)
+      return j - rank * n;
+    return n + std::distance(ghosts.begin(), std::ranges::find(ghosts, j));
+  };
+
+  la::SparsityPattern p(comm, {map0, map1}, {1, 1});
+  for (std::int32_t i = 0; i < m; ++i)
+    for (std::int64_t j = 0; j < A.n; ++j)
+      if (A(rank * m + i, j) != T(0))
+        p.insert(std::vector{i}, std::vector{local_col(j)});
+  p.finalize();
+
+  la::MatrixCSR<T> B(p);
+  for (std::int32_t i = 0; i < m; ++i)
+    for (std::int64_t j = 0; j < A.n; ++j)
+      if (A(rank * m + i, j) != T(0))
+        B.add(std::vector{A(rank * m + i, j)}, std::vector{i},
+              std::vector{local_col(j)});
+  return B;
+}
+
+/// Check that the owned rows of a distributed matrix match a dense
+/// global matrix
+template <typename T>
+void check_matrix(const la::MatrixCSR<T>& A, const Dense<T>& ref)
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  auto map0 = A.index_map(0);
+  auto map1 = A.index_map(1);
+  CHECK(map0->size_global() == ref.m);
+  CHECK(map1->size_global() == ref.n);
+
+  std::vector<std::int64_t> col_global(map1->size_local()
+                                       + map1->num_ghosts());
+  std::iota(col_global.begin(),
+            std::next(col_global.begin(), map1->size_local()),
+            map1->local_range()[0]);
+  std::ranges::copy(map1->ghosts(),
+                    std::next(col_global.begin(), map1->size_local()));
+
+  for (std::int32_t r = 0; r < A.num_owned_rows(); ++r)
+  {
+    const std::int64_t gr = map0->local_range()[0] + r;
+    std::vector<T> row(ref.n, 0);
+    for (std::int64_t k = A.row_ptr()[r]; k < A.row_ptr()[r + 1]; ++k)
+      row[col_global[A.cols()[k]]] += A.values()[k];
+    for (std::int64_t j = 0; j < ref.n; ++j)
+      CHECK(std::abs(row[j] - ref(gr, j)) < U(1e-12));
+  }
+}
+
+template <typename T>
+void test_products()
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  const int size = dolfinx::MPI::size(comm);
+  constexpr std::int32_t n = 8, nc = 4;
+  const std::int64_t N = n * size, Nc = nc * size;
+
+  // Non-symmetric tridiagonal fine grid operator
+  Dense<T> A{N, N, std::vector<T>(N * N, 0)};
+  for (std::int64_t i = 0; i < N; ++i)
+  {
+    A.data[i * N + i] = 2.5;
+    if (i > 0)
+      A.data[i * N + i - 1] = -1.25;
+    if (i < N - 1)
+      A.data[i * N + i + 1] = -0.75;
+  }
+
+  // Linear interpolation from the coarse grid, which couples to coarse
+  // points on neighbouring processes
+  Dense<T> P{N, Nc, std::vector<T>(N * Nc, 0)};
+  for (std::int64_t i = 0; i < N; ++i)
+  {
+    const std::int64_t j = i / 2;
+    if (i % 2 == 0)
+      P.data[i * Nc + j] = 1;
+    else
+    {
+      P.data[i * Nc + j] = 0.5;
+      P.data[i * Nc + (j + 1) % Nc] = 0.5;
+    }
+  }
+
+  la::MatrixCSR<T> A_csr = create_matrix(comm, n, n, A);
+  la::MatrixCSR<T> P_csr = create_matrix(comm, n, nc, P);
+
+  Dense<T> At{N, N, std::vector<T>(N * N)};
+  for (std::int64_t i = 0; i < N; ++i)
+    for (std::int64_t j = 0; j < N; ++j)
+      At.data[j * N + i] = A(i, j);
+  check_matrix(la::transpose(A_csr), At);
+
+  Dense<T> AP = dense_product(A, P, false);
+  check_matrix(la::matmult(A_csr, P_csr), AP);
+
+  Dense<T> PtAP = dense_product(P, AP, true);
+  check_matrix(la::ptap(P_csr, A_csr), PtAP);
+
+  // Re-use the sparsity when the entries change
+  la::PtAP<T> galerkin(P_csr, A_csr);
+  check_matrix(galerkin.matrix(), PtAP);
+  std::ranges::transform(A_csr.values(), A_csr.values().begin(),
+                         [](auto a) { return T(2) * a; });
+  galerkin.update(P_csr, A_csr);
+  std::ranges::transform(PtAP.data, PtAP.data.begin(),
+                         [](auto a) { return T(2) * a; });
+  check_matrix(galerkin.matrix(), PtAP);
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Sparse matrix products", "[la_matrix_products]", double,
+                   std::complex<double>)
+{
+  CHECK_NOTHROW(test_products<TestType>());
+}
@@ -15,6 +15,8 @@
 #include <dolfinx/io/XDMFFile.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <dolfinx/mesh/graphbuild.h>
+#include <dolfinx/mesh/permutationcomputation.h>
+#include <limits>
 #include <memory>
 
 using namespace dolfinx;
@@ -84,6 +86,322 @@ constexpr int N = 8;
   MPI_Comm_free(&comm);
 }
 
+/// Check that the hash-based entity computation creates the same
+/// entities as the sort-based computation
+void test_entity_computation(mesh::CellType cell_type)
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  auto part = mesh::create_cell_partitioner(mesh::GhostMode::shared_facet);
+  auto create = [&]()
+  {
+    return mesh::create_box(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                            {5, 4, 3}, cell_type, part);
+  };
+
+  // Sorted global vertices of the owned entities of dimension dim
+  auto entities = [](const mesh::Topology& topology, int dim)
+  {
+    auto e_to_v = topology.connectivity(dim, 0);
+    auto vmap = topology.index_map(0);
+    std::vector<std::vector<std::int64_t>> e;
+    for (std::int32_t i = 0; i < topology.index_map(dim)->size_local(); ++i)
+    {
+      auto v = e_to_v->links(i);
+      std::vector<std::int64_t> gv(v.size());
+      vmap->local_to_global(v, gv);
+      std::ranges::sort(gv);
+      e.push_back(gv);
+    }
+    std::ranges::sort(e);
+    return e;
+  };
+
+  mesh::Mesh<double> mesh0 = create();
+  mesh::Mesh<double> mesh1 = create();
+  for (int dim = 1; dim < 3; ++dim)
+  {
+    auto t0 = mesh0.topology();
+    auto t1 = mesh1.topology();
+    t0->create_entities(dim);
+    t1->create_entities(dim, mesh::EntityComputation::hash, 3);
+    CHECK(t0->index_map(dim)->size_local() == t1->index_map(dim)->size_local());
+    CHECK(t0->index_map(dim)->num_ghosts() == t1->index_map(dim)->num_ghosts());
+    CHECK(entities(*t0, dim) == entities(*t1, dim));
+  }
+}
+
+/// Check that evicted connectivities are re-computed on access
+void test_connectivity_budget()
+{
+  auto mesh = mesh::create_box(MPI_COMM_WORLD,
+                               {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+                               mesh::CellType::tetrahedron);
+  auto topology = mesh.topology();
+  topology->create_connectivity(2, 3);
+  topology->create_connectivity(1, 2);
+  const graph::AdjacencyList<std::int32_t> f_to_c
+      = *topology->connectivity(2, 3);
+  const graph::AdjacencyList<std::int32_t> e_to_f
+      = *topology->connectivity(1, 2);
+
+  // Budget that only fits the connectivities that cannot be evicted
+  const std::size_t bytes = topology->connectivity_bytes();
+  topology->set_connectivity_budget(0);
+  CHECK(topology->connectivity_bytes() < bytes);
+  CHECK(topology->connectivity_bytes({2, 0}, {3, 0}) == 0);
+  CHECK(topology->connectivity(3, 0));
+  CHECK(topology->connectivity(3, 2));
+
+  // Evicted connectivities are re-computed when requested
+  CHECK(*topology->connectivity(2, 3) == f_to_c);
+  CHECK(*topology->connectivity(1, 2) == e_to_f);
+
+  topology->set_connectivity_budget(std::numeric_limits<std::size_t>::max());
+  CHECK(topology->connectivity(2, 3));
+  CHECK(topology->connectivity(1, 2));
+}
+
+/// Check the threaded entity permutations against the edge orientation
+/// computed from the edge-to-vertex connectivity
+void test_entity_permutations(mesh::CellType cell_type)
+{
+  auto mesh = mesh::create_box(MPI_COMM_WORLD,
+                               {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {3, 4, 2},
+                               cell_type);
+  auto topology = mesh.topology();
+  topology->create_entities(1);
+  topology->create_entities(2);
+  const auto [facet_perm0, cell_info0]
+      = mesh::compute_entity_permutations(*topology);
+  const auto [facet_perm1, cell_info1]
+      = mesh::compute_entity_permutations(*topology, 3);
+  CHECK(facet_perm1 == facet_perm0);
+  CHECK(cell_info1 == cell_info0);
+
+  // An edge is reflected if its lowest numbered cell-local vertex has
+  // the highest global index
+  topology->create_connectivity(3, 1);
+  auto c_to_v = topology->connectivity(3, 0);
+  auto c_to_e = topology->connectivity(3, 1);
+  auto e_to_v = topology->connectivity(1, 0);
+  auto vmap = topology->index_map(0);
+  const int num_faces = mesh::cell_num_entities(cell_type, 2);
+  for (std::int32_t c = 0; c < c_to_v->num_nodes(); ++c)
+  {
+    auto cv = c_to_v->links(c);
+    auto edges = c_to_e->links(c);
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+      auto ev = e_to_v->links(edges[i]);
+      auto it0 = std::ranges::find(cv, ev[0]);
+      auto it1 = std::ranges::find(cv, ev[1]);
+      std::array<std::int64_t, 2> g;
+      vmap->local_to_global(ev, g);
+      const bool reflected = (it1 < it0) == (g[1] > g[0]);
+      CHECK(((cell_info0[c] >> (3 * num_faces + i)) & 1) == reflected);
+    }
+  }
+}
+
+/// Check the cached exterior facets of a box mesh
+void test_exterior_facets()
+{
+  auto mesh = mesh::create_box(MPI_COMM_WORLD,
+                               {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 4, 4},
+                               mesh::CellType::tetrahedron);
+  auto topology = mesh.topology();
+  topology->create_connectivity(2, 3);
+  topology->create_connectivity(3, 2);
+
+  // Each side of the box has 4 x 4 squares of 2 triangles
+  std::shared_ptr<const std::vector<std::int32_t>> facets
+      = topology->exterior_facets();
+  std::int64_t num_facets = facets->size();
+  MPI_Allreduce(MPI_IN_PLACE, &num_facets, 1, MPI_INT64_T, MPI_SUM,
+                mesh.comm());
+  CHECK(num_facets == 6 * 4 * 4 * 2);
+  CHECK(topology->exterior_facets() == facets);
+  CHECK(mesh::exterior_facet_indices(*topology) == *facets);
+
+  // Each (cell, local facet) pair is the exterior facet
+  std::shared_ptr<const std::vector<std::int32_t>> pairs
+      = topology->exterior_facet_pairs();
+  REQUIRE(pairs->size() == 2 * facets->size());
+  auto c_to_f = topology->connectivity(3, 2);
+  for (std::size_t i = 0; i < facets->size(); ++i)
+  {
+    CHECK(c_to_f->links((*pairs)[2 * i])[(*pairs)[2 * i + 1]]
+          == (*facets)[i]);
+  }
+
+  // Setting the facet-cell connectivity discards the cache, but the
+  // returned list remains valid
+  topology->set_connectivity(
+      std::make_shared<graph::AdjacencyList<std::int32_t>>(
+          *topology->connectivity(2, 3)),
+      2, 3);
+  std::shared_ptr<const std::vector<std::int32_t>> facets1
+      = topology->exterior_facets();
+  CHECK(facets1 != facets);
+  CHECK(*facets1 == *facets);
+}
+
+/// Check that consecutive points of a grid ordered along the Hilbert
+/// curve are neighbours
+void test_space_filling_curve()
+{
+  constexpr int m = 8;
+  std::vector<double> x;
+  std::vector<std::array<int, 3>> grid;
+  for (int k = 0; k < m; ++k)
+    for (int j = 0; j < m; ++j)
+      for (int i = 0; i < m; ++i)
+      {
+        grid.push_back({i, j, k});
+        x.insert(x.end(), {0.1 * i, 0.1 * j, 0.1 * k});
+      }
+
+  for (auto curve :
+       {mesh::SpaceFillingCurve::hilbert, mesh::SpaceFillingCurve::morton})
+  {
+    std::vector<std::int32_t> order
+        = mesh::space_filling_curve_order(x, curve, 2);
+    std::vector<std::int32_t> points(order.size(), -1);
+    for (std::size_t p = 0; p < order.size(); ++p)
+      points[order[p]] = p;
+    CHECK(std::ranges::find(points, -1) == points.end());
+
+    if (curve == mesh::SpaceFillingCurve::hilbert)
+    {
+      for (std::size_t i = 1; i < points.size(); ++i)
+      {
+        int d = 0;
+        for (int j = 0; j < 3; ++j)
+          d += std::abs(grid[points[i]][j] - grid[points[i - 1]][j]);
+        CHECK(d == 1);
+      }
+    }
+  }
+
+  // Create mesh with cells re-ordered along the Hilbert curve
+  auto mesh0 = mesh::create_box(MPI_COMM_WORLD,
+                                {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                                {4, 4, 4}, mesh::CellType::hexahedron);
+  auto cmap = mesh0.geometry().cmap();
+  std::vector<std::int64_t> cells(mesh0.geometry().dofmap().data_handle(),
+                                  mesh0.geometry().dofmap().data_handle()
+                                      + mesh0.geometry().dofmap().size());
+  auto dmap = mesh0.geometry().index_map();
+  std::vector<std::int64_t> gcells(cells.size());
+  dmap->local_to_global(
+      std::vector<std::int32_t>(cells.begin(), cells.end()), gcells);
+  std::int32_t num_owned = mesh0.topology()->index_map(3)->size_local();
+  gcells.resize(num_owned * 8);
+  std::vector<double> gx(mesh0.geometry().x().begin(),
+                         std::next(mesh0.geometry().x().begin(),
+                                   3 * dmap->size_local()));
+  auto mesh1 = mesh::create_mesh(
+      MPI_COMM_WORLD, MPI_COMM_WORLD, gcells, cmap, MPI_COMM_WORLD, gx,
+      {gx.size() / 3, 3},
+      mesh::create_cell_partitioner(mesh::GhostMode::none),
+      mesh::create_cell_reorderer(mesh::SpaceFillingCurve::hilbert));
+  CHECK(mesh1.topology()->index_map(3)->size_global() == 64);
+}
+
+void test_dual_graph_rounds()
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  auto mesh = mesh::create_box(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                               {4, 4, 4}, mesh::CellType::tetrahedron);
+  auto dofmap = mesh.geometry().dofmap();
+  std::int32_t num_owned = mesh.topology()->index_map(3)->size_local();
+  std::vector<std::int32_t> cells(dofmap.data_handle(),
+                                  dofmap.data_handle() + num_owned * 4);
+  std::vector<std::int64_t> gcells(cells.size());
+  mesh.geometry().index_map()->local_to_global(cells, gcells);
+
+  std::vector<mesh::CellType> cell_types{mesh::CellType::tetrahedron};
+  std::vector<std::span<const std::int64_t>> c{gcells};
+  auto g0 = mesh::build_dual_graph(comm, cell_types, c);
+  auto g1 = mesh::build_dual_graph(comm, cell_types, c, 2, 10);
+  REQUIRE(g0.num_nodes() == g1.num_nodes());
+  for (std::int32_t i = 0; i < g0.num_nodes(); ++i)
+  {
+    std::vector<std::int64_t> e0(g0.links(i).begin(), g0.links(i).end());
+    std::vector<std::int64_t> e1(g1.links(i).begin(), g1.links(i).end());
+    std::ranges::sort(e0);
+    std::ranges::sort(e1);
+    CHECK(e0 == e1);
+  }
+}
+
+void test_geometric_partitioner(mesh::GhostMode ghost_mode)
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  auto mesh0 = mesh::create_box(comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                                {4, 4, 4}, mesh::CellType::hexahedron);
+  auto cmap = mesh0.geometry().cmap();
+  std::vector<std::int64_t> cells(mesh0.geometry().dofmap().data_handle(),
+                                  mesh0.geometry().dofmap().data_handle()
+                                      + mesh0.geometry().dofmap().size());
+  auto dmap = mesh0.geometry().index_map();
+  std::vector<std::int64_t> gcells(cells.size());
+  dmap->local_to_global(
+      std::vector<std::int32_t>(cells.begin(), cells.end()), gcells);
+  std::int32_t num_owned = mesh0.topology()->index_map(3)->size_local();
+  gcells.resize(num_owned * 8);
+  std::vector<double> gx(mesh0.geometry().x().begin(),
+                         std::next(mesh0.geometry().x().begin(),
+                                   3 * dmap->size_local()));
+
+  std::array<std::size_t, 2> xshape = {gx.size() / 3, 3};
+  auto mesh1 = mesh::create_mesh(
+      comm, comm, gcells, cmap, comm, gx, xshape,
+      mesh::create_geometric_cell_partitioner<double>(ghost_mode, gx,
+                                                      xshape));
+  auto cell_map = mesh1.topology()->index_map(3);
+  CHECK(cell_map->size_global() == 64);
+
+  // Cells are balanced across ranks
+  const int size = dolfinx::MPI::size(comm);
+  std::int32_t num_cells = cell_map->size_local();
+  std::array<std::int32_t, 2> range = {-num_cells, num_cells};
+  MPI_Allreduce(MPI_IN_PLACE, range.data(), 2, MPI_INT32_T, MPI_MAX, comm);
+  CHECK(-range[0] >= 64 / size - 1);
+  CHECK(range[1] <= 64 / size + 1);
+  if (ghost_mode == mesh::GhostMode::none)
+    CHECK(cell_map->num_ghosts() == 0);
+}
+
+/// Check that a blocked box mesh matches the box mesh created by
+/// partitioning
+void test_create_box_blocked(mesh::CellType cell_type,
+                             mesh::GhostMode ghost_mode)
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  std::array<std::array<double, 3>, 2> p
+      = {{{0.0, 0.0, 0.0}, {1.0, 2.0, 3.0}}};
+  std::array<std::int64_t, 3> n = {5, 6, 7};
+  mesh::Mesh<double> mesh0 = mesh::create_box(comm, p, n, cell_type);
+  mesh::Mesh<double> mesh1
+      = mesh::create_box_blocked(comm, p, n, cell_type, ghost_mode);
+
+  auto t0 = mesh0.topology();
+  auto t1 = mesh1.topology();
+  for (int dim : {0, 3})
+  {
+    CHECK(t0->index_map(dim)->size_global()
+          == t1->index_map(dim)->size_global());
+  }
+  t0->create_entities(2);
+  t1->create_entities(2);
+  CHECK(t0->index_map(2)->size_global() == t1->index_map(2)->size_global());
+  CHECK(mesh1.geometry().index_map()->size_global()
+        == mesh0.geometry().index_map()->size_global());
+  if (dolfinx::MPI::size(comm) > 1 and ghost_mode != mesh::GhostMode::none)
+    CHECK(t1->index_map(3)->num_ghosts() > 0);
+}
+
 void test_distributed_mesh(mesh::CellPartitionFunction partitioner)
 {
   using T = double;
@@ -154,6 +472,159 @@ void test_distributed_mesh(mesh::CellPartitionFunction partitioner)
   if (subset_comm != MPI_COMM_NULL)
     MPI_Comm_free(&subset_comm);
 }
+void test_compact_coordinates()
+{
+  mesh::Mesh<double> mesh = mesh::create_rectangle<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0}, {1.0, 1.0}}}, {N, N},
+      mesh::CellType::quadrilateral);
+  const mesh::Geometry<double>& geometry = mesh.geometry();
+  std::span<const double> x = geometry.x();
+  mesh::CompactCoordinates<float> x_compact(x, geometry.dim());
+  CHECK(x_compact.gdim() == 2);
+  CHECK(x_compact.x().size() == 2 * x.size() / 3);
+
+  // Gathered coordinates are padded to three components
+  auto x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.extent(1);
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  for (std::size_t c = 0; c < x_dofmap.extent(0); ++c)
+  {
+    std::span dofs(x_dofmap.data_handle() + c * num_dofs_g, num_dofs_g);
+    x_compact.gather(dofs, std::span(coordinate_dofs));
+    for (std::size_t i = 0; i < num_dofs_g; ++i)
+      for (int j = 0; j < 3; ++j)
+        CHECK(std::abs(coordinate_dofs[3 * i + j] - x[3 * dofs[i] + j])
+              < 1e-6);
+  }
+}
+void test_weighted_cell_partitioner()
+{
+  // Weight cells by their number of vertices
+  auto weight_fn = [](const std::vector<mesh::CellType>& cell_types,
+                      const std::vector<std::span<const std::int64_t>>& cells)
+  {
+    std::vector<std::int32_t> weights;
+    for (std::size_t i = 0; i < cell_types.size(); ++i)
+    {
+      int num_vertices = mesh::num_cell_vertices(cell_types[i]);
+      weights.insert(weights.end(), cells[i].size() / num_vertices,
+                     num_vertices);
+    }
+    return weights;
+  };
+
+  mesh::Mesh<double> mesh = mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {N, N, N},
+      mesh::CellType::tetrahedron,
+      mesh::create_cell_partitioner(mesh::GhostMode::none,
+                                    &graph::partition_graph_weighted,
+                                    weight_fn));
+  auto cell_map = mesh.topology()->index_map(3);
+  CHECK(cell_map->size_global() == 6 * N * N * N);
+}
+
+void test_ghost_layers()
+{
+  auto create = [](int ghost_layers)
+  {
+    return mesh::create_rectangle<double>(
+        MPI_COMM_WORLD, {{{0.0, 0.0}, {1.0, 1.0}}}, {N, N},
+        mesh::CellType::triangle,
+        mesh::create_cell_partitioner(mesh::GhostMode::shared_facet,
+                                      &graph::partition_graph, ghost_layers));
+  };
+  mesh::Mesh<double> mesh1 = create(1);
+  mesh::Mesh<double> mesh2 = create(2);
+  auto map1 = mesh1.topology()->index_map(2);
+  auto map2 = mesh2.topology()->index_map(2);
+  CHECK(map2->size_global() == map1->size_global());
+
+  // A second layer adds ghosts on ranks that have any
+  std::int32_t num_ghosts1 = map1->num_ghosts();
+  std::int32_t num_ghosts2 = map2->num_ghosts();
+  CHECK(num_ghosts2 >= num_ghosts1);
+  if (num_ghosts1 > 0)
+    CHECK(num_ghosts2 > num_ghosts1);
+}
+
+void test_redistribute()
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  mesh::Mesh<double> mesh = mesh::create_box<double>(
+      comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {N, N, N},
+      mesh::CellType::tetrahedron);
+  auto topology = mesh.topology_mutable();
+  const int tdim = topology->dim();
+  topology->create_entities(tdim - 1);
+  topology->create_connectivity(tdim - 1, tdim);
+
+  // Tag the facets on the boundary x = 0
+  std::vector<std::int32_t> facets = mesh::locate_entities_boundary(
+      mesh, tdim - 1,
+      [](auto x)
+      {
+        std::vector<std::int8_t> marker(x.extent(1), false);
+        for (std::size_t p = 0; p < x.extent(1); ++p)
+          marker[p] = std::abs(x(0, p)) < 1.0e-8;
+        return marker;
+      });
+  mesh::MeshTags<std::int32_t> tags(
+      topology, tdim - 1, facets, std::vector<std::int32_t>(facets.size(), 1));
+
+  // Cells with x < 0.5 are more expensive
+  const std::int32_t num_cells = topology->index_map(tdim)->size_local();
+  std::vector<std::int32_t> cells(num_cells);
+  std::iota(cells.begin(), cells.end(), 0);
+  std::vector<double> midpoints = mesh::compute_midpoints(mesh, tdim, cells);
+  std::vector<std::int32_t> weights(num_cells);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+    weights[c] = midpoints[3 * c] < 0.5 ? 4 : 1;
+
+  auto [mesh1, cell_map]
+      = mesh::redistribute(mesh, weights, mesh::GhostMode::shared_facet);
+  auto topology1 = mesh1.topology_mutable();
+  auto cell_map1 = topology1->index_map(tdim);
+  CHECK(cell_map1->size_global() == topology->index_map(tdim)->size_global());
+  CHECK((int)cell_map.size()
+        == cell_map1->size_local() + cell_map1->num_ghosts());
+  CHECK(mesh1.geometry().index_map()->size_global()
+        == mesh.geometry().index_map()->size_global());
+
+  // Cell data follows the cells
+  const std::int32_t num_cells1 = cell_map1->size_local();
+  std::vector<std::int32_t> cells1(num_cells1);
+  std::iota(cells1.begin(), cells1.end(), 0);
+  std::vector<double> midpoints1 = mesh::compute_midpoints(mesh1, tdim, cells1);
+  std::vector<double> midpoints0 = dolfinx::MPI::distribute_data(
+      comm, std::span(cell_map.data(), num_cells1), comm, midpoints, 3);
+  for (std::size_t i = 0; i < midpoints1.size(); ++i)
+    CHECK(std::abs(midpoints1[i] - midpoints0[i]) < 1.0e-12);
+
+  std::vector<std::int32_t> weights1 = dolfinx::MPI::distribute_data(
+      comm, std::span(cell_map.data(), num_cells1), comm, weights, 1);
+  std::array<std::int64_t, 2> w
+      = {std::reduce(weights.begin(), weights.end(), std::int64_t(0)),
+         std::reduce(weights1.begin(), weights1.end(), std::int64_t(0))};
+  MPI_Allreduce(MPI_IN_PLACE, w.data(), 2, MPI_INT64_T, MPI_SUM, comm);
+  CHECK(w[0] == w[1]);
+
+  // Tags are migrated to the facets on x = 0
+  mesh::MeshTags<std::int32_t> tags1
+      = mesh::migrate_meshtags(tags, topology1, cell_map);
+  auto count_owned = [](const mesh::MeshTags<std::int32_t>& t)
+  {
+    auto map = t.topology()->index_map(t.dim());
+    std::int64_t n = std::ranges::count_if(
+        t.indices(), [&map](auto e) { return e < map->size_local(); });
+    MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_INT64_T, MPI_SUM, map->comm());
+    return n;
+  };
+  CHECK(count_owned(tags1) == count_owned(tags));
+  std::vector<double> facet_midpoints
+      = mesh::compute_midpoints(mesh1, tdim - 1, tags1.indices());
+  for (std::size_t i = 0; i < tags1.indices().size(); ++i)
+    CHECK(std::abs(facet_midpoints[3 * i]) < 1.0e-10);
+}
 } // namespace
 
 /// Create a mesh on even ranks and distribute to all ranks in mpi_comm
@@ -174,6 +645,89 @@ TEST_CASE("Create box", "[create_box]")
   // #endif
 }
 
+TEST_CASE("Hierarchical partitioner", "[cell_partitioner]")
+{
+  // Group pairs of ranks as nodes
+  CHECK_NOTHROW(test_create_box(mesh::create_cell_partitioner(
+      mesh::GhostMode::none,
+      graph::hierarchical::partitioner(&graph::partition_graph,
+                                       &graph::partition_graph, 2))));
+  CHECK_NOTHROW(test_create_box(mesh::create_cell_partitioner(
+      mesh::GhostMode::shared_facet, graph::hierarchical::partitioner())));
+}
+
+TEST_CASE("Hash-based entity computation", "[entity_computation]")
+{
+  CHECK_NOTHROW(test_entity_computation(mesh::CellType::tetrahedron));
+  CHECK_NOTHROW(test_entity_computation(mesh::CellType::hexahedron));
+}
+
+TEST_CASE("Connectivity budget", "[connectivity_budget]")
+{
+  CHECK_NOTHROW(test_connectivity_budget());
+}
+
+TEST_CASE("Entity permutations", "[entity_permutations]")
+{
+  CHECK_NOTHROW(test_entity_permutations(mesh::CellType::tetrahedron));
+  CHECK_NOTHROW(test_entity_permutations(mesh::CellType::hexahedron));
+}
+
+TEST_CASE("Exterior facets", "[exterior_facets]")
+{
+  CHECK_NOTHROW(test_exterior_facets());
+}
+
+TEST_CASE("Space-filling curve ordering", "[space_filling_curve]")
+{
+  CHECK_NOTHROW(test_space_filling_curve());
+}
+
+TEST_CASE("Create blocked box", "[create_box_blocked]")
+{
+  for (auto cell_type :
+       {mesh::CellType::tetrahedron, mesh::CellType::hexahedron})
+  {
+    for (auto ghost_mode :
+         {mesh::GhostMode::none, mesh::GhostMode::shared_facet,
+          mesh::GhostMode::shared_vertex})
+    {
+      CHECK_NOTHROW(test_create_box_blocked(cell_type, ghost_mode));
+    }
+  }
+}
+
+TEST_CASE("Compact geometry coordinates", "[compact_coordinates]")
+{
+  CHECK_NOTHROW(test_compact_coordinates());
+}
+
+TEST_CASE("Dual graph in rounds", "[dual_graph]")
+{
+  CHECK_NOTHROW(test_dual_graph_rounds());
+}
+
+TEST_CASE("Geometric partitioner", "[cell_partitioner]")
+{
+  CHECK_NOTHROW(test_geometric_partitioner(mesh::GhostMode::none));
+  CHECK_NOTHROW(test_geometric_partitioner(mesh::GhostMode::shared_facet));
+}
+
+TEST_CASE("Weighted cell partitioner", "[cell_partitioner]")
+{
+  CHECK_NOTHROW(test_weighted_cell_partitioner());
+}
+
+TEST_CASE("Ghost layers", "[cell_partitioner]")
+{
+  CHECK_NOTHROW(test_ghost_layers());
+}
+
+TEST_CASE("Weighted redistribution", "[redistribute]")
+{
+  CHECK_NOTHROW(test_redistribute());
+}
+
 TEST_CASE("Distributed Mesh", "[distributed_mesh]")
 {
   MPI_Barrier(MPI_COMM_WORLD);
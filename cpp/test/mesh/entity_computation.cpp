@@ -0,0 +1,52 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the concurrent computation of mesh entities
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/generation.h>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Concurrent entity computation", "[entity_computation]")
+{
+  auto create = []
+  {
+    return mesh::create_box<double>(MPI_COMM_WORLD,
+                                    {{{0, 0, 0}, {1, 1, 1}}}, {3, 4, 2},
+                                    mesh::CellType::hexahedron);
+  };
+
+  // Entities created one dimension at a time
+  mesh::Mesh<double> mesh0 = create();
+  auto topology0 = mesh0.topology_mutable();
+  topology0->create_entities(1);
+  topology0->create_entities(2);
+
+  // Entities of both dimensions created concurrently
+  mesh::Mesh<double> mesh1 = create();
+  auto topology1 = mesh1.topology_mutable();
+  topology1->create_entities(std::vector{1, 2}, mesh::EntityComputation::sort,
+                             4);
+
+  for (int d : {1, 2})
+  {
+    CHECK(topology1->index_map(d)->size_local()
+          == topology0->index_map(d)->size_local());
+    CHECK(std::ranges::equal(topology1->index_map(d)->ghosts(),
+                             topology0->index_map(d)->ghosts()));
+    CHECK(topology1->connectivity(d, 0)->array()
+          == topology0->connectivity(d, 0)->array());
+    CHECK(topology1->connectivity(3, d)->array()
+          == topology0->connectivity(3, d)->array());
+  }
+  CHECK(topology1->interprocess_facets() == topology0->interprocess_facets());
+}
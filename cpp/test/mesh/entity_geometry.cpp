@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the geometric quantities of mesh entities
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/mesh/utils.h>
+#include <numeric>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Check the threaded and single-pass computations against the serial
+// functions, and that the cell volumes sum to the volume of the
+// domain
+void check_entity_geometry(mesh::Mesh<double>& mesh, int dim)
+{
+  auto topology = mesh.topology_mutable();
+  const int tdim = topology->dim();
+  topology->create_connectivity(dim, tdim);
+  topology->create_connectivity(tdim, dim);
+  auto map = topology->index_map(dim);
+  std::vector<std::int32_t> entities(map->size_local());
+  std::iota(entities.begin(), entities.end(), 0);
+
+  const std::vector<double> h0 = mesh::h(mesh, entities, dim);
+  const std::vector<double> x0 = mesh::compute_midpoints(mesh, dim, entities);
+  const std::vector<std::int32_t> g0
+      = mesh::entities_to_geometry(mesh, dim, entities);
+
+  std::vector<double> h1(entities.size()), x1(3 * entities.size());
+  std::vector<std::int32_t> g1(g0.size());
+  mesh::h(mesh, entities, dim, std::span(h1), 3);
+  mesh::compute_midpoints(mesh, dim, entities, std::span(x1), 3);
+  mesh::entities_to_geometry(mesh, dim, entities, std::span(g1), false, 3);
+  CHECK(h1 == h0);
+  CHECK(x1 == x0);
+  CHECK(g1 == g0);
+
+  std::vector<double> h2(entities.size()), v(entities.size()),
+      x2(3 * entities.size());
+  mesh::geometry_summary(mesh, dim, entities, std::span(h2), std::span(v),
+                         std::span(x2), 2);
+  for (std::size_t i = 0; i < entities.size(); ++i)
+  {
+    CHECK(h2[i] == Catch::Approx(h0[i]));
+    for (std::size_t k = 0; k < 3; ++k)
+      CHECK(x2[3 * i + k] == Catch::Approx(x0[3 * i + k]).margin(1e-12));
+  }
+
+  if (dim == tdim)
+  {
+    double volume = std::accumulate(v.begin(), v.end(), 0.0);
+    MPI_Allreduce(MPI_IN_PLACE, &volume, 1, MPI_DOUBLE, MPI_SUM, mesh.comm());
+    CHECK(volume == Catch::Approx(2.0));
+  }
+}
+} // namespace
+
+TEST_CASE("Entity geometry", "[entity_geometry]")
+{
+  for (auto cell_type :
+       {mesh::CellType::triangle, mesh::CellType::quadrilateral})
+  {
+    auto mesh = mesh::create_rectangle<double>(
+        MPI_COMM_WORLD, {{{0.0, 0.0}, {2.0, 1.0}}}, {7, 5}, cell_type);
+    check_entity_geometry(mesh, 2);
+    check_entity_geometry(mesh, 1);
+
+    // Normals of the cells of a planar mesh
+    std::vector<std::int32_t> cells = {0, 1};
+    std::vector<double> n0 = mesh::cell_normals(mesh, 2, cells);
+    std::vector<double> n1(6);
+    mesh::cell_normals(mesh, 2, cells, std::span(n1), 2);
+    CHECK(n1 == n0);
+    CHECK(std::abs(n0[2]) == Catch::Approx(1.0));
+  }
+
+  for (auto cell_type :
+       {mesh::CellType::tetrahedron, mesh::CellType::hexahedron})
+  {
+    auto mesh = mesh::create_box<double>(
+        MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {2.0, 1.0, 1.0}}}, {3, 2, 4},
+        cell_type);
+    check_entity_geometry(mesh, 3);
+    check_entity_geometry(mesh, 2);
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the options of the data computed by create_mesh
+
+#include <basix/finite-element.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/utils.h>
+#include <memory>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Create a mesh of the unit square with 2 x 2 x 2 triangles, with the
+// input data on rank 0
+mesh::Mesh<double> create_mesh(const mesh::MeshSetupOptions& options)
+{
+  auto e = std::make_shared<basix::FiniteElement<double>>(
+      basix::create_element<double>(
+          basix::element::family::P, basix::cell::type::triangle, 1,
+          basix::element::lagrange_variant::unset,
+          basix::element::dpc_variant::unset, false));
+  fem::CoordinateElement<double> cmap(e);
+
+  std::vector<double> x;
+  std::vector<std::int64_t> cells;
+  if (dolfinx::MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    for (int j = 0; j < 3; ++j)
+      for (int i = 0; i < 3; ++i)
+        x.insert(x.end(), {0.5 * i, 0.5 * j});
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        std::int64_t v0 = 3 * j + i;
+        cells.insert(cells.end(), {v0, v0 + 1, v0 + 4, v0, v0 + 3, v0 + 4});
+      }
+    }
+  }
+
+  return mesh::create_mesh(MPI_COMM_WORLD, cells, cmap, x,
+                           {x.size() / 2, 2}, mesh::GhostMode::none, options);
+}
+} // namespace
+
+TEST_CASE("Mesh setup options", "[mesh_setup_options]")
+{
+  // By default only the cells and vertices are created
+  {
+    mesh::Mesh<double> mesh = create_mesh({});
+    auto topology = mesh.topology();
+    CHECK(topology->index_map(2)->size_global() == 8);
+    CHECK(!topology->connectivity(1, 0));
+    CHECK(!topology->has_entity_permutations());
+    CHECK(topology->original_cell_index.front().size()
+          == static_cast<std::size_t>(topology->index_map(2)->size_local()));
+  }
+
+  // Eagerly created facets and permutations, without the original cell
+  // indices
+  {
+    mesh::MeshSetupOptions options;
+    options.entities = {1};
+    options.entity_permutations = true;
+    options.original_cell_index = false;
+    mesh::Mesh<double> mesh = create_mesh(options);
+    auto topology = mesh.topology();
+    REQUIRE(topology->connectivity(1, 0));
+    CHECK(topology->index_map(1)->size_global() == 16);
+    CHECK(topology->has_entity_permutations());
+    CHECK(topology->original_cell_index.front().empty());
+  }
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the implicit topology of structured grids
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dolfinx/mesh/StructuredGrid.h>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+// Reference facet-to-vertex connectivity of the quadrilateral and
+// hexahedron
+template <int tdim>
+constexpr auto reference_facet_vertices()
+{
+  if constexpr (tdim == 2)
+    return std::array<std::array<int, 2>, 4>{
+        {{0, 1}, {0, 2}, {1, 3}, {2, 3}}};
+  else
+  {
+    return std::array<std::array<int, 4>, 6>{{{0, 1, 2, 3},
+                                              {0, 1, 4, 5},
+                                              {0, 2, 4, 6},
+                                              {1, 3, 5, 7},
+                                              {2, 3, 6, 7},
+                                              {4, 5, 6, 7}}};
+  }
+}
+
+template <int tdim>
+void test_grid(std::array<std::int64_t, tdim> n)
+{
+  mesh::StructuredGrid<tdim> grid(n);
+  constexpr auto ref = reference_facet_vertices<tdim>();
+
+  std::int64_t num_cells = 1, num_vertices = 1;
+  for (int d = 0; d < tdim; ++d)
+  {
+    num_cells *= n[d];
+    num_vertices *= n[d] + 1;
+  }
+  std::int64_t num_facets = 0;
+  for (int d = 0; d < tdim; ++d)
+    num_facets += (num_cells / n[d]) * (n[d] + 1);
+
+  CHECK(grid.num_cells() == num_cells);
+  CHECK(grid.num_vertices() == num_vertices);
+  CHECK(grid.num_facets() == num_facets);
+
+  // Count the cells that are incident to each facet
+  std::vector<int> facet_count(num_facets, 0);
+  for (std::int64_t c = 0; c < grid.num_cells(); ++c)
+  {
+    auto cv = grid.cell_vertices(c);
+    for (std::int64_t v : cv)
+      CHECK((v >= 0 and v < num_vertices));
+    std::vector<std::int64_t> sorted(cv.begin(), cv.end());
+    std::ranges::sort(sorted);
+    CHECK(std::ranges::adjacent_find(sorted) == sorted.end());
+
+    auto cf = grid.cell_facets(c);
+    auto nbrs = grid.cell_neighbours(c);
+    for (std::size_t k = 0; k < cf.size(); ++k)
+    {
+      std::int64_t f = cf[k];
+      REQUIRE((f >= 0 and f < num_facets));
+      ++facet_count[f];
+
+      // Facet vertices are the reference facet vertices of the cell
+      auto fv = grid.facet_vertices(f);
+      for (std::size_t i = 0; i < fv.size(); ++i)
+        CHECK(fv[i] == cv[ref[k][i]]);
+
+      // The facet is shared with the neighbour across it
+      auto fc = grid.facet_cells(f);
+      CHECK(std::ranges::find(fc, c) != fc.end());
+      std::int64_t other = fc[0] == c ? fc[1] : fc[0];
+      CHECK(other == nbrs[k]);
+    }
+  }
+
+  // Interior facets have two cells, boundary facets have one
+  for (std::int64_t f = 0; f < num_facets; ++f)
+  {
+    auto fc = grid.facet_cells(f);
+    int num_incident = (fc[0] >= 0) + (fc[1] >= 0);
+    CHECK(num_incident == facet_count[f]);
+    CHECK(num_incident >= 1);
+  }
+}
+} // namespace
+
+TEST_CASE("Structured quadrilateral grid", "[structured_grid]")
+{
+  test_grid<2>({1, 1});
+  test_grid<2>({3, 2});
+  test_grid<2>({4, 7});
+}
+
+TEST_CASE("Structured hexahedral grid", "[structured_grid]")
+{
+  test_grid<3>({1, 1, 1});
+  test_grid<3>({2, 3, 4});
+  test_grid<3>({5, 1, 3});
+}
@@ -0,0 +1,94 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the PETSc-free Newton solver
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/la/krylov.h>
+#include <dolfinx/nls/Newton.h>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Solve the componentwise problem F_i(x) = atan(x_i - a_i) = 0, for
+/// which the full Newton step diverges if |x_i - a_i| is large
+template <typename T>
+void test_newton(nls::LineSearch line_search, T dx0, bool converges)
+{
+  constexpr std::int32_t n = 20;
+  auto map = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, n);
+  la::SparsityPattern p(MPI_COMM_WORLD, {map, map}, {1, 1});
+  for (std::int32_t i = 0; i < n; ++i)
+    p.insert(std::span(&i, 1), std::span(&i, 1));
+  p.finalize();
+
+  using V = la::Vector<T>;
+  la::MatrixCSR<T> J(p);
+  V x(map, 1), b(map, 1);
+  auto a = [](std::int32_t i) { return T(1 + i % 5); };
+
+  nls::NewtonSolver<V> solver;
+  solver.setF(
+      [&a](const V& x, V& b)
+      {
+        for (std::int32_t i = 0; i < n; ++i)
+          b.mutable_array()[i] = std::atan(x.array()[i] - a(i));
+      },
+      b);
+  solver.setJ(
+      [&a](const V& x, la::MatrixCSR<T>& J)
+      {
+        // One entry per row of the diagonal Jacobian
+        for (std::int32_t i = 0; i < n; ++i)
+        {
+          T d = x.array()[i] - a(i);
+          J.values()[i] = 1 / (1 + d * d);
+        }
+      },
+      J);
+  solver.set_linear_solver(
+      [](la::MatrixCSR<T>& J, const V& b, V& dx)
+      {
+        auto op = [&J](auto& x, auto& y) { J.mult(x, y); };
+        return la::cg(op, la::IdentityPreconditioner(), dx, b, T(1e-6))
+            .iterations;
+      });
+  solver.line_search = line_search;
+  solver.rtol = 1e-5;
+  solver.atol = 1e-6;
+  solver.max_it = 30;
+  solver.error_on_nonconvergence = false;
+
+  for (std::int32_t i = 0; i < n; ++i)
+    x.mutable_array()[i] = a(i) + dx0;
+  auto [it, converged] = solver.solve(x);
+  CHECK(converged == converges);
+  if (converges)
+  {
+    CHECK(it < solver.max_it);
+    CHECK(solver.krylov_iterations() >= it);
+    for (std::int32_t i = 0; i < n; ++i)
+      CHECK(std::abs(x.array()[i] - a(i)) < 1e-4);
+  }
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("Newton solver", "[nls_newton]", float, double)
+{
+  using T = TestType;
+  using nls::LineSearch;
+  CHECK_NOTHROW(test_newton<T>(LineSearch::none, 0.5, true));
+  CHECK_NOTHROW(test_newton<T>(LineSearch::none, 2, false));
+  CHECK_NOTHROW(test_newton<T>(LineSearch::backtracking, 2, true));
+  CHECK_NOTHROW(test_newton<T>(LineSearch::critical_point, 2, true));
+}
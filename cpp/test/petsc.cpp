@@ -0,0 +1,146 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the PETSc matrix wrappers
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef HAS_PETSC
+#include "poisson.h"
+#include <algorithm>
+#include <basix/finite-element.h>
+#include <cmath>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/Constant.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/petsc.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <memory>
+#include <petscmat.h>
+#include <span>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Compare a PETSc matrix that takes over the storage of a MatrixCSR
+/// with a PETSc matrix assembled entry by entry
+void test_matrix_wrap()
+{
+  PetscBool initialized;
+  PetscInitialized(&initialized);
+  if (!initialized)
+    PetscInitializeNoArguments();
+
+  auto mesh = std::make_shared<mesh::Mesh<double>>(
+      mesh::create_box(MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}},
+                       {5, 4, 3}, mesh::CellType::tetrahedron));
+  auto element = basix::create_element<double>(
+      basix::element::family::P, basix::cell::type::tetrahedron, 2,
+      basix::element::lagrange_variant::unset,
+      basix::element::dpc_variant::unset, false);
+  auto V = std::make_shared<fem::FunctionSpace<double>>(
+      fem::create_functionspace(mesh, element, {}));
+  auto kappa = std::make_shared<fem::Constant<double>>(2.0);
+  auto a = std::make_shared<fem::Form<double, double>>(
+      fem::create_form<double, double>(*form_poisson_a, {V, V}, {},
+                                       {{"kappa", kappa}}, {}, {}));
+
+  la::SparsityPattern sp = fem::create_sparsity_pattern(*a);
+  sp.finalize();
+  la::MatrixCSR<double> A(sp);
+  fem::assemble_matrix(A.mat_add_values(), *a, {});
+  A.scatter_rev();
+
+  // Reference matrix, with the owned rows of A set row by row
+  Mat P = la::petsc::create_matrix(MPI_COMM_WORLD, sp);
+  const std::int32_t m = A.index_map(0)->size_local();
+  const auto& row_ptr = A.row_ptr();
+  const auto& cols = A.cols();
+  const auto& values = A.values();
+  for (std::int32_t r = 0; r < m; ++r)
+  {
+    PetscInt row = r;
+    std::vector<PetscInt> _cols(std::next(cols.begin(), row_ptr[r]),
+                                std::next(cols.begin(), row_ptr[r + 1]));
+    std::vector<PetscScalar> _values(
+        std::next(values.begin(), row_ptr[r]),
+        std::next(values.begin(), row_ptr[r + 1]));
+    MatSetValuesLocal(P, 1, &row, _cols.size(), _cols.data(), _values.data(),
+                      INSERT_VALUES);
+  }
+  MatAssemblyBegin(P, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(P, MAT_FINAL_ASSEMBLY);
+
+  // Wrap a copy of A. The copy goes out of scope, so the entries must
+  // be held by the PETSc matrix.
+  Mat W;
+  {
+    la::MatrixCSR<PetscScalar> B(A.layout());
+    std::ranges::copy(values, B.values().begin());
+    W = la::petsc::create_matrix_wrap(std::move(B));
+  }
+
+  // The entries of the owned rows are the same
+  const std::int64_t offset = A.index_map(0)->local_range()[0];
+  for (std::int32_t r = 0; r < m; ++r)
+  {
+    std::span<const std::int32_t> lcols(cols.data() + row_ptr[r],
+                                        row_ptr[r + 1] - row_ptr[r]);
+    std::vector<std::int64_t> gcols(lcols.size());
+    A.index_map(1)->local_to_global(lcols, gcols);
+    std::vector<PetscInt> _cols(gcols.begin(), gcols.end());
+    std::vector<PetscScalar> _values(_cols.size());
+    PetscInt row = offset + r;
+    MatGetValues(W, 1, &row, _cols.size(), _cols.data(), _values.data());
+    for (std::size_t k = 0; k < _values.size(); ++k)
+    {
+      PetscScalar v = values[row_ptr[r] + k];
+      CHECK(std::abs(_values[k] - v) < 1e-12);
+    }
+  }
+
+  // The products are the same
+  Vec x, yP, yW;
+  MatCreateVecs(P, &x, &yP);
+  VecDuplicate(yP, &yW);
+  PetscInt r0, r1;
+  VecGetOwnershipRange(x, &r0, &r1);
+  for (PetscInt i = r0; i < r1; ++i)
+    VecSetValue(x, i, PetscScalar(1 + i % 7), INSERT_VALUES);
+  VecAssemblyBegin(x);
+  VecAssemblyEnd(x);
+  MatMult(P, x, yP);
+  MatMult(W, x, yW);
+  PetscReal norm;
+  VecNorm(yP, NORM_2, &norm);
+  VecAXPY(yW, -1.0, yP);
+  PetscReal error;
+  VecNorm(yW, NORM_2, &error);
+  CHECK(norm > 0.0);
+  CHECK(error < 1e-12 * norm);
+
+  VecDestroy(&x);
+  VecDestroy(&yP);
+  VecDestroy(&yW);
+  MatDestroy(&W);
+  MatDestroy(&P);
+}
+} // namespace
+
+TEST_CASE("PETSc matrix wrapping a MatrixCSR", "[petsc_matrix_wrap]")
+{
+  CHECK_NOTHROW(test_matrix_wrap());
+}
+#endif
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/generation.h>
+#include <dolfinx/refinement/plaza.h>
+#include <mpi.h>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Plaza refinement is independent of the number of threads",
+          "[refinement][plaza]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(mesh::create_box<double>(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {4, 3, 5},
+      mesh::CellType::tetrahedron));
+  mesh->topology()->create_entities(1);
+
+  // Mark the edges of every second cell
+  const int tdim = mesh->topology()->dim();
+  mesh->topology()->create_connectivity(tdim, 1);
+  auto c_to_e = mesh->topology()->connectivity(tdim, 1);
+  std::vector<std::int32_t> edges;
+  for (std::int32_t c = 0; c < c_to_e->num_nodes(); c += 2)
+  {
+    auto e = c_to_e->links(c);
+    edges.insert(edges.end(), e.begin(), e.end());
+  }
+
+  for (bool uniform : {true, false})
+  {
+    auto refine = [&](int num_threads)
+    {
+      auto option = refinement::plaza::Option::parent_cell_and_facet;
+      return uniform ? refinement::plaza::compute_refinement_data(
+                 *mesh, option, num_threads)
+                     : refinement::plaza::compute_refinement_data(
+                         *mesh, edges, option, num_threads);
+    };
+
+    auto [cells0, x0, xshape0, parent_cell0, parent_facet0] = refine(1);
+    for (int num_threads : {2, 3, 7})
+    {
+      auto [cells1, x1, xshape1, parent_cell1, parent_facet1]
+          = refine(num_threads);
+      CHECK(std::ranges::equal(cells0.array(), cells1.array()));
+      CHECK(std::ranges::equal(cells0.offsets(), cells1.offsets()));
+      CHECK(std::ranges::equal(x0, x1));
+      CHECK(xshape0 == xshape1);
+      CHECK(std::ranges::equal(parent_cell0, parent_cell1));
+      CHECK(std::ranges::equal(parent_facet0, parent_facet1));
+    }
+  }
+}
+
+TEST_CASE("Plaza marker propagation", "[refinement][plaza]")
+{
+  auto mesh = std::make_shared<mesh::Mesh<double>>(mesh::create_box<double>(
+      MPI_COMM_SELF, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {3, 4, 2},
+      mesh::CellType::tetrahedron));
+  auto topology = mesh->topology();
+  topology->create_entities(1);
+  auto [long_edge, edge_ratio_ok]
+      = refinement::plaza::impl::face_long_edge(*mesh);
+
+  // Mark a single edge and propagate
+  auto map_e = topology->index_map(1);
+  std::vector<std::int8_t> marked_edges(map_e->size_local(), false);
+  marked_edges[0] = true;
+  MPI_Comm comm;
+  MPI_Dist_graph_create_adjacent(MPI_COMM_SELF, 0, nullptr, MPI_UNWEIGHTED,
+                                 0, nullptr, MPI_UNWEIGHTED, MPI_INFO_NULL,
+                                 false, &comm);
+  auto stats = refinement::plaza::impl::enforce_rules(
+      comm, map_e->index_to_dest_ranks(), marked_edges, *topology, long_edge);
+  MPI_Comm_free(&comm);
+  CHECK(stats.rounds == 1);
+  CHECK(stats.bytes_sent == 0);
+
+  // The longest edge of each face with a marked edge must be marked
+  auto f_to_e = topology->connectivity(2, 1);
+  for (std::int32_t f = 0; f < f_to_e->num_nodes(); ++f)
+  {
+    auto edges = f_to_e->links(f);
+    bool any_marked = std::ranges::any_of(
+        edges, [&marked_edges](auto e) { return marked_edges[e]; });
+    CHECK((!any_marked or marked_edges[long_edge[f]]));
+  }
+  CHECK(std::reduce(marked_edges.begin(), marked_edges.end(), 0) > 1);
+}
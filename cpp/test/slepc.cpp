@@ -0,0 +1,158 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the SLEPc eigenvalue solver
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef HAS_SLEPC
+#include "tridiagonal.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/petsc.h>
+#include <dolfinx/la/slepc.h>
+#include <petscksp.h>
+#include <petscmat.h>
+#include <slepceps.h>
+#include <utility>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+/// Solver for the smallest eigenvalues of A x = lambda B x, by
+/// shift-and-invert with zero shift and a CG transformation solver
+la::SLEPcEigenSolver create_solver(Mat A, Mat B, bool shell = false)
+{
+  la::SLEPcEigenSolver solver(MPI_COMM_WORLD);
+  solver.set_operators(A, B);
+  EPS eps = solver.eps();
+  EPSSetProblemType(eps, EPS_GHEP);
+  EPSSetWhichEigenpairs(eps, EPS_TARGET_MAGNITUDE);
+  EPSSetTarget(eps, 0.0);
+  EPSSetTolerances(eps, 1e-12, 1000);
+  ST st;
+  EPSGetST(eps, &st);
+  STSetType(st, STSINVERT);
+  KSP ksp;
+  STGetKSP(st, &ksp);
+  KSPSetType(ksp, KSPCG);
+  KSPSetTolerances(ksp, 1e-14, 1e-50, 1e5, 10000);
+  PC pc;
+  KSPGetPC(ksp, &pc);
+  PCSetType(pc, shell ? PCNONE : PCJACOBI);
+  return solver;
+}
+
+/// Eigenvalues and normalised eigenvectors of the first n eigenpairs
+std::pair<std::vector<PetscScalar>, std::vector<Vec>>
+eigenpairs(const la::SLEPcEigenSolver& solver, Mat A, int n)
+{
+  REQUIRE(solver.get_number_converged() >= n);
+  std::vector<PetscScalar> values;
+  std::vector<Vec> vectors;
+  for (int i = 0; i < n; ++i)
+  {
+    PetscScalar lr, lc;
+    Vec r;
+    MatCreateVecs(A, &r, nullptr);
+    solver.get_eigenpair(lr, lc, r, nullptr, i);
+    VecNormalize(r, nullptr);
+    values.push_back(lr);
+    vectors.push_back(r);
+  }
+  return {std::move(values), std::move(vectors)};
+}
+
+/// Check that two eigenpairs agree, with the eigenvectors compared up
+/// to a scalar factor
+void check_eigenpairs(
+    const std::pair<std::vector<PetscScalar>, std::vector<Vec>>& e0,
+    const std::pair<std::vector<PetscScalar>, std::vector<Vec>>& e1)
+{
+  for (std::size_t i = 0; i < e0.first.size(); ++i)
+  {
+    CHECK(std::abs(e0.first[i] - e1.first[i]) < 1e-8 * std::abs(e0.first[i]));
+    PetscScalar dot;
+    VecDot(e0.second[i], e1.second[i], &dot);
+    CHECK(std::abs(std::abs(dot) - 1.0) < 1e-6);
+  }
+}
+
+void destroy(std::pair<std::vector<PetscScalar>, std::vector<Vec>>& e)
+{
+  for (Vec& v : e.second)
+    VecDestroy(&v);
+}
+
+/// Solve a sequence of two generalised eigenproblems with warm starts
+/// and factorisation reuse, and compare with cold solves
+void test_warm_start()
+{
+  PetscBool initialized;
+  SlepcInitialized(&initialized);
+  if (!initialized)
+    SlepcInitializeNoArguments();
+
+  // The shifted operator A - 0 B does not change when B changes, so
+  // reusing the factorisation is exact
+  la::MatrixCSR<PetscScalar> A_csr
+      = test::create_tridiagonal<PetscScalar>(MPI_COMM_WORLD, 2, 0);
+  la::MatrixCSR<PetscScalar> A_copy(A_csr.layout());
+  std::ranges::copy(A_csr.values(), A_copy.values().begin());
+  Mat A = la::petsc::create_matrix_wrap(std::move(A_copy));
+  Mat B0 = la::petsc::create_matrix_wrap(
+      test::create_tridiagonal<PetscScalar>(MPI_COMM_WORLD, 3, 0));
+  Mat B1 = la::petsc::create_matrix_wrap(
+      test::create_tridiagonal<PetscScalar>(MPI_COMM_WORLD, 4, 0));
+
+  constexpr int n = 4;
+
+  // Cold solves
+  la::SLEPcEigenSolver cold0 = create_solver(A, B0);
+  cold0.solve(n);
+  auto e0 = eigenpairs(cold0, A, n);
+  la::SLEPcEigenSolver cold1 = create_solver(A, B1);
+  cold1.solve(n);
+  auto e1 = eigenpairs(cold1, A, n);
+
+  // Warm solves, the second starting from the eigenvectors of the first
+  la::SLEPcEigenSolver warm = create_solver(A, B0);
+  warm.set_warm_start(true);
+  warm.set_reuse_factorisation(true);
+  warm.solve(n);
+  auto w0 = eigenpairs(warm, A, n);
+  check_eigenpairs(e0, w0);
+  warm.set_operators(A, B1);
+  warm.solve(n);
+  auto w1 = eigenpairs(warm, A, n);
+  check_eigenpairs(e1, w1);
+
+  // A matrix-free operator gives the same eigenpairs
+  Mat S = la::petsc::create_matrix_shell(A_csr);
+  la::SLEPcEigenSolver shell = create_solver(S, B1, true);
+  shell.solve(n);
+  auto s1 = eigenpairs(shell, A, n);
+  check_eigenpairs(e1, s1);
+
+  for (auto e : {&e0, &e1, &w0, &w1, &s1})
+    destroy(*e);
+  MatDestroy(&S);
+  MatDestroy(&B1);
+  MatDestroy(&B0);
+  MatDestroy(&A);
+}
+} // namespace
+
+TEST_CASE("SLEPc eigenvalue solver warm start", "[slepc_warm_start]")
+{
+  CHECK_NOTHROW(test_warm_start());
+}
+#endif
@@ -0,0 +1,87 @@
+// Copyright (C) 2024 The FEniCS Project
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Distributed tridiagonal test matrix
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace dolfinx::test
+{
+/// Create the distributed tridiagonal matrix with diagonal `d`,
+/// super-diagonal `-1 + c` and sub-diagonal `-1 - c`
+template <typename T>
+la::MatrixCSR<T> create_tridiagonal(MPI_Comm comm, T d, T c)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+  constexpr std::int32_t n = 50;
+
+  // The first and last rows couple to the neighbouring processes
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (rank > 0)
+  {
+    ghosts.push_back(rank * n - 1);
+    owners.push_back(rank - 1);
+  }
+  if (rank < size - 1)
+  {
+    ghosts.push_back((rank + 1) * n);
+    owners.push_back(rank + 1);
+  }
+  auto map = std::make_shared<common::IndexMap>(comm, n, ghosts, owners);
+
+  // Local column indices of row i
+  auto columns = [&](std::int32_t i)
+  {
+    std::vector<std::int32_t> cols;
+    if (i > 0)
+      cols.push_back(i - 1);
+    else if (rank > 0)
+      cols.push_back(n);
+    cols.push_back(i);
+    if (i < n - 1)
+      cols.push_back(i + 1);
+    else if (rank < size - 1)
+      cols.push_back(n + ghosts.size() - 1);
+    return cols;
+  };
+
+  la::SparsityPattern p(comm, {map, map}, {1, 1});
+  for (std::int32_t i = 0; i < n; ++i)
+    p.insert(std::span(&i, 1), columns(i));
+  p.finalize();
+
+  // Global column indices distinguish the sub- and super-diagonals
+  la::MatrixCSR<T> A(p);
+  const std::int64_t offset = map->local_range()[0];
+  std::vector<std::int64_t> global(n + ghosts.size());
+  std::iota(global.begin(), std::next(global.begin(), n), offset);
+  std::ranges::copy(ghosts, std::next(global.begin(), n));
+  for (std::int32_t i = 0; i < n; ++i)
+  {
+    for (std::int32_t j : columns(i))
+    {
+      std::int64_t gi = offset + i, gj = global[j];
+      T v = gi == gj ? d : (gj > gi ? T(-1) + c : T(-1) - c);
+      A.add(std::vector{v}, std::vector{i}, std::vector{j});
+    }
+  }
+
+  return A;
+}
+} // namespace dolfinx::test
@@ -7,12 +7,19 @@
 // Unit tests for Distributed la::Vector
 
 #include <algorithm>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <complex>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Scatterer.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/la/MultiVector.h>
 #include <dolfinx/la/Vector.h>
+#include <dolfinx/la/scatter_tuning.h>
+#include <memory_resource>
+#include <type_traits>
 
 using namespace dolfinx;
 
@@ -55,10 +62,631 @@ void test_vector()
   CHECK(la::norm(v, la::Norm::linf) == static_cast<T>(mpi_size - 1));
 }
 
+template <typename T>
+void test_scatter_persistent()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Ghost the first entries on the next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+  const std::vector<int> owners(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // Repeated forward scatters re-use the same requests
+  la::Vector<T> v(index_map, 1, common::Scatterer<>::type::persistent);
+  for (int k = 0; k < 3; ++k)
+  {
+    std::ranges::fill(v.mutable_array(), mpi_rank + k);
+    v.scatter_fwd();
+    std::span<const T> x = v.array();
+    for (int i = 0; i < num_ghosts; ++i)
+      CHECK(x[size_local + i] == T((mpi_rank + 1) % mpi_size + k));
+  }
+
+  // Reverse scatter, and a moved vector keeps valid requests
+  la::Vector<T> w = std::move(v);
+  std::ranges::fill(w.mutable_array(), 1);
+  w.scatter_rev(std::plus<T>());
+  std::span<const T> x = w.array();
+  for (int i = 0; i < size_local; ++i)
+    CHECK(x[i] == T(i < num_ghosts ? 2 : 1));
+
+  // Copies get their own requests
+  la::Vector<T> u(w);
+  u.scatter_fwd();
+  CHECK(la::norm(u) == la::norm(w));
+}
+
+template <typename T>
+void test_scatter_reduced_precision()
+{
+  using W = std::conditional_t<std::is_same_v<T, double>, float,
+                               std::complex<float>>;
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Ghost the first entries on the next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+  const std::vector<int> owners(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // Ghost values are the owned values rounded to single precision
+  for (auto type : {common::Scatterer<>::type::neighbor,
+                    common::Scatterer<>::type::p2p,
+                    common::Scatterer<>::type::persistent})
+  {
+    la::Vector<T> v(index_map, 2, type);
+    std::span<T> x = v.mutable_array();
+    auto value = [](std::int64_t i) { return T(1) / T(3 + i); };
+    for (int i = 0; i < 2 * size_local; ++i)
+      x[i] = value(2 * index_map->local_range()[0] + i);
+    v.template scatter_fwd<W>();
+    for (int i = 0; i < 2 * num_ghosts; ++i)
+    {
+      const T ref = value(2 * ghosts[i / 2] + i % 2);
+      CHECK(x[2 * size_local + i] == T(static_cast<W>(ref)));
+      CHECK(std::abs(x[2 * size_local + i] - ref) < 1e-7 * std::abs(ref));
+    }
+
+    // Full precision scatter
+    v.scatter_fwd();
+    for (int i = 0; i < 2 * num_ghosts; ++i)
+      CHECK(x[2 * size_local + i] == value(2 * ghosts[i / 2] + i % 2));
+  }
+}
+
+template <typename T>
+void test_vector_memory_resource()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  for (int i = 0; i < 3 and mpi_size > 1; ++i)
+  {
+    ghosts.push_back((mpi_rank + 1) % mpi_size * size_local + i);
+    owners.push_back((mpi_rank + 1) % mpi_size);
+  }
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // Data and buffers are allocated from the resource, and ghost updates
+  // do not allocate
+  common::CountingResource counter;
+  using V = la::Vector<T, std::pmr::vector<T>>;
+  {
+    V v(index_map, 1, common::Scatterer<>::type::persistent, &counter);
+    CHECK(counter.num_allocations() > 0);
+    CHECK(counter.bytes_allocated() >= v.array().size() * sizeof(T));
+    counter.reset();
+    for (int k = 0; k < 3; ++k)
+    {
+      std::ranges::fill(v.mutable_array(), T(mpi_rank + k));
+      v.scatter_fwd();
+      for (std::size_t i = 0; i < ghosts.size(); ++i)
+        CHECK(v.array()[size_local + i] == T(owners[i] + k));
+    }
+    CHECK(counter.num_allocations() == 0);
+  }
+  CHECK(counter.bytes_allocated() == 0);
+
+  // Memory allocated with MPI_Alloc_mem
+  common::MPIResource mpi_resource;
+  V w(index_map, 1, common::Scatterer<>::type::neighbor, &mpi_resource);
+  std::ranges::fill(w.mutable_array(), T(mpi_rank));
+  w.scatter_fwd();
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+    CHECK(w.array()[size_local + i] == T(owners[i]));
+}
+
+template <typename T>
+void test_scatter_shared_memory()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Ghost the first entries on the next process and the last entries
+  // on the previous process
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  if (mpi_size > 1)
+  {
+    const int next = (mpi_rank + 1) % mpi_size;
+    const int prev = (mpi_rank + mpi_size - 1) % mpi_size;
+    for (int i = 0; i < 3; ++i)
+    {
+      ghosts.push_back(next * size_local + i);
+      owners.push_back(next);
+    }
+    for (int i = size_local - 2; i < size_local and prev != next; ++i)
+    {
+      ghosts.push_back(prev * size_local + i);
+      owners.push_back(prev);
+    }
+  }
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // Ghost data on the same node is read from the window of the owner
+  using V = la::Vector<T, std::pmr::vector<T>>;
+  V v(index_map, 2, common::Scatterer<>::type::shared);
+  auto value = [](std::int64_t i) { return T(1) / T(3 + i); };
+  for (int k = 0; k < 2; ++k)
+  {
+    std::span<T> x = v.mutable_array();
+    for (int i = 0; i < 2 * size_local; ++i)
+      x[i] = value(2 * index_map->local_range()[0] + i) + T(k);
+    v.scatter_fwd();
+    for (std::size_t i = 0; i < 2 * ghosts.size(); ++i)
+    {
+      CHECK(x[2 * size_local + i]
+            == value(2 * ghosts[i / 2] + i % 2) + T(k));
+    }
+  }
+
+  // Reverse scatter, also for a copy and a moved vector
+  V u(v);
+  V w = std::move(v);
+  for (V* y : {&u, &w})
+  {
+    std::ranges::fill(y->mutable_array(), T(1));
+    y->scatter_rev(std::plus<T>());
+    std::span<const T> x = y->array();
+    for (int i = 0; i < 2 * size_local; ++i)
+    {
+      int count = 1;
+      if (mpi_size > 1 and i < 2 * 3)
+        ++count;
+      if (mpi_size > 2 and i >= 2 * (size_local - 2))
+        ++count;
+      CHECK(x[i] == T(count));
+    }
+  }
+
+  // Reduced precision scatters use messages
+  using W = std::conditional_t<std::is_same_v<T, double>, float,
+                               std::complex<float>>;
+  std::ranges::fill(w.mutable_array(), T(mpi_rank));
+  w.template scatter_fwd<W>();
+  for (std::size_t i = 0; i < 2 * ghosts.size(); ++i)
+    CHECK(w.array()[2 * size_local + i] == T(owners[i / 2]));
+
+  // Shared memory requires a container with a memory resource
+  CHECK_THROWS(la::Vector<T>(index_map, 1, common::Scatterer<>::type::shared));
+}
+
+/// Forward scatter of only the entries marked as modified
+template <typename T>
+void test_scatter_delta()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  for (int i = 0; i < 10 and mpi_size > 1; ++i)
+  {
+    ghosts.push_back((mpi_rank + 1) % mpi_size * size_local + i);
+    owners.push_back((mpi_rank + 1) % mpi_size);
+  }
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  la::Vector<T> v(index_map, 2);
+  std::ranges::fill(v.mutable_array(), T(0));
+  v.scatter_fwd();
+
+  // Only the marked entries are sent. Entry 4 is changed but not
+  // marked.
+  std::span<T> x = v.mutable_array();
+  x[2 * 3] = x[2 * 3 + 1] = T(1);
+  x[2 * 4] = T(2);
+  std::vector<std::int32_t> marked = {3};
+  v.mark_modified(marked);
+  v.scatter_fwd_delta();
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    CHECK(v.array()[2 * (size_local + i)] == T(i == 3 ? 1 : 0));
+    CHECK(v.array()[2 * (size_local + i) + 1] == T(i == 3 ? 1 : 0));
+  }
+
+  // The markers are cleared
+  x[2 * 3] = T(5);
+  v.scatter_fwd_delta();
+  if (!ghosts.empty())
+    CHECK(v.array()[2 * (size_local + 3)] == T(1));
+
+  // Above the threshold all entries are sent
+  marked = {0, 1, 2, 3, 4, 5, 6};
+  v.mark_modified(marked);
+  v.scatter_fwd_delta(0.5);
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    CHECK(v.array()[2 * (size_local + i)]
+          == T(i == 3 ? 5 : (i == 4 ? 2 : 0)));
+  }
+}
+
+/// Ghost updates with user-provided pack and unpack functions, e.g.
+/// device kernels
+template <typename T>
+void test_scatter_pack()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> owners;
+  for (int i = 0; i < 3 and mpi_size > 1; ++i)
+  {
+    ghosts.push_back((mpi_rank + 1) % mpi_size * size_local + i);
+    owners.push_back((mpi_rank + 1) % mpi_size);
+  }
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  int num_calls = 0;
+  auto pack = [&num_calls](std::span<const T> in,
+                           std::span<const std::int32_t> idx, std::span<T> out)
+  {
+    ++num_calls;
+    for (std::size_t i = 0; i < idx.size(); ++i)
+      out[i] = in[idx[i]];
+  };
+
+  la::Vector<T> v(index_map, 1);
+  std::ranges::fill(v.mutable_array(), T(mpi_rank));
+  v.scatter_fwd_begin(pack);
+  v.scatter_fwd_end(
+      [&num_calls](std::span<const T> in, std::span<const std::int32_t> idx,
+                   std::span<T> out)
+      {
+        ++num_calls;
+        for (std::size_t i = 0; i < idx.size(); ++i)
+          out[idx[i]] = in[i];
+      });
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+    CHECK(v.array()[size_local + i] == T(owners[i]));
+
+  v.scatter_rev_begin(pack);
+  v.scatter_rev_end(
+      [&num_calls](std::span<const T> in, std::span<const std::int32_t> idx,
+                   std::span<T> out, auto op)
+      {
+        ++num_calls;
+        for (std::size_t i = 0; i < idx.size(); ++i)
+          out[idx[i]] = op(out[idx[i]], in[i]);
+      },
+      std::plus<T>());
+  for (int i = 0; i < size_local; ++i)
+  {
+    const int num_copies = (mpi_size > 1 and i < 3) ? 2 : 1;
+    CHECK(v.array()[i] == T(num_copies * mpi_rank));
+  }
+  CHECK(num_calls == 4);
+}
+
+template <typename T>
+void test_fused_reductions()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+  auto index_map
+      = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, size_local);
+
+  la::Vector<T> u(index_map, 1), v(index_map, 1), w(index_map, 1);
+  std::ranges::fill(u.mutable_array(), 1.0);
+  std::ranges::fill(v.mutable_array(), 2.0);
+  std::ranges::fill(w.mutable_array(), 3.0);
+
+  // Single reduction for several inner products
+  std::vector<T> dots = la::inner_products(u, {v, w});
+  CHECK(dots.size() == 2);
+  CHECK(dots[0] == la::inner_product(u, v));
+  CHECK(dots[1] == la::inner_product(u, w));
+
+  // Non-blocking reduction
+  auto reduction = la::inner_products_begin(v, {w});
+  CHECK(reduction.wait()[0] == T(6.0 * mpi_size * size_local));
+
+  // u <- u + 2 v = 5
+  auto norm = la::axpy_and_norm(u, T(2), v);
+  CHECK(norm == Catch::Approx(5 * std::sqrt(mpi_size * size_local)));
+  CHECK(la::norm(u) == Catch::Approx(norm));
+
+  // w <- 2 u - v = 8, w^H v = 16 N
+  T dot = la::waxpby_dot(w, T(2), u, T(-1), v, v);
+  CHECK(dot == T(16.0 * mpi_size * size_local));
+  CHECK(la::norm(w, la::Norm::linf) == Catch::Approx(8));
+}
+
+template <typename T>
+void test_threaded_kernels()
+{
+  // Several blocks of the threaded operations on each process
+  constexpr int size_local = 10000;
+  auto index_map
+      = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, size_local);
+  const std::int64_t offset = index_map->local_range()[0];
+
+  la::Vector<T> x(index_map, 1), y(index_map, 1);
+  std::span _x = x.mutable_array();
+  for (std::int32_t i = 0; i < size_local; ++i)
+    _x[i] = std::cos(double(offset + i));
+  std::ranges::fill(y.mutable_array(), 1.0);
+
+  // The reductions do not depend on the number of threads, and agree
+  // with the serial reductions
+  for (auto summation : {la::Summation::pairwise, la::Summation::kahan})
+  {
+    T dot = la::inner_product(x, y, summation, 1);
+    CHECK(std::real(dot)
+          == Catch::Approx(std::real(la::inner_product(x, y))));
+    for (auto type : {la::Norm::l1, la::Norm::l2, la::Norm::linf})
+    {
+      auto n1 = la::norm(x, type, summation, 1);
+      CHECK(n1 == Catch::Approx(la::norm(x, type)));
+      for (int num_threads : {2, 3, 4})
+      {
+        CHECK(la::inner_product(x, y, summation, num_threads) == dot);
+        CHECK(la::norm(x, type, summation, num_threads) == n1);
+      }
+    }
+  }
+
+  const std::span<const T> x0(x.array().data(), size_local);
+  std::vector<T> ref(x0.begin(), x0.end());
+  for (int num_threads : {1, 3})
+  {
+    // z <- 2 x, z <- z - x = x, z <- 4 x - 2 z = 2 x
+    la::Vector<T> z(index_map, 1);
+    std::ranges::copy(x0, z.mutable_array().begin());
+    la::scale(z, T(2), num_threads);
+    la::axpy(z, T(-1), x, num_threads);
+    la::axpby(z, T(4), x, T(-2), num_threads);
+    for (std::int32_t i = 0; i < size_local; ++i)
+      CHECK(z.array()[i] == T(2) * ref[i]);
+
+    // w <- x * y = x,  w <- w / y = x
+    la::Vector<T> w(index_map, 1);
+    la::pointwise_mult(w, x, y, num_threads);
+    la::pointwise_divide(w, w, y, num_threads);
+    for (std::int32_t i = 0; i < size_local; ++i)
+      CHECK(w.array()[i] == ref[i]);
+
+    // z <- z - 2 x = 0
+    auto norm = la::axpy_and_norm(z, T(-2), x, la::Summation::kahan,
+                                  num_threads);
+    CHECK(norm == 0);
+  }
+
+  la::Vector<T> v(std::make_shared<common::IndexMap>(MPI_COMM_WORLD, 10), 1);
+  CHECK_THROWS(la::axpy(x, T(1), v));
+}
+
+template <typename T>
+void test_orthonormalize()
+{
+  auto index_map = std::make_shared<common::IndexMap>(MPI_COMM_WORLD, 20);
+  const std::int64_t offset = index_map->local_range()[0];
+  std::vector<la::Vector<T>> basis;
+  for (int i = 0; i < 4; ++i)
+  {
+    la::Vector<T>& b = basis.emplace_back(index_map, 1);
+    std::span x = b.mutable_array();
+    for (std::size_t j = 0; j < x.size(); ++j)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+        x[j] = std::cos(double((i + 1) * (offset + j)));
+      else
+        x[j] = T(std::cos(double((i + 1) * (offset + j))), 0.5 * i);
+    }
+  }
+
+  la::orthonormalize(std::vector<std::reference_wrapper<la::Vector<T>>>(
+      basis.begin(), basis.end()));
+  CHECK(la::is_orthonormal(
+      std::vector<std::reference_wrapper<const la::Vector<T>>>(basis.begin(),
+                                                               basis.end()),
+      1e-12));
+}
+
+template <typename T>
+void test_multivector()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 50;
+  constexpr int bs = 2;
+  constexpr int num_vectors = 3;
+
+  // Ghost the first entries on the next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+  const std::vector<int> owners(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // Value of entry i of vector j on the given rank
+  auto value = [](int rank, int i, int j) { return T(100 * rank + 10 * j + i); };
+
+  // Forward scatter of the interleaved vectors
+  la::MultiVector<T> X(index_map, bs, num_vectors);
+  X.set(-1);
+  std::span<T> x = X.mutable_array();
+  for (int i = 0; i < bs * size_local; ++i)
+    for (int j = 0; j < num_vectors; ++j)
+      x[i * num_vectors + j] = value(mpi_rank, i, j);
+  X.scatter_fwd();
+
+  const int owner = (mpi_rank + 1) % mpi_size;
+  la::Vector<T> v(index_map, bs);
+  for (int j = 0; j < num_vectors; ++j)
+  {
+    X.copy_to(j, v);
+    for (int i = 0; i < bs * num_ghosts; ++i)
+      CHECK(v.array()[bs * size_local + i] == value(owner, i, j));
+  }
+
+  // Gram matrix of the set with itself
+  std::vector<T> G = la::inner_products(X, X);
+  for (int i = 0; i < num_vectors; ++i)
+  {
+    X.copy_to(i, v);
+    for (int j = 0; j < num_vectors; ++j)
+    {
+      la::Vector<T> w(index_map, bs);
+      X.copy_to(j, w);
+      CHECK(std::abs(G[i * num_vectors + j] - la::inner_product(v, w))
+            <= 1e-10 * std::abs(G[i * num_vectors + j]));
+    }
+  }
+
+  // Aggregated scatters of separate vectors
+  std::vector<la::Vector<T>> u;
+  for (int j = 0; j < num_vectors; ++j)
+  {
+    u.emplace_back(index_map, bs);
+    u.back().set(-1);
+    X.copy_to(j, u.back());
+    std::fill_n(std::next(u.back().mutable_array().begin(), bs * size_local),
+                bs * num_ghosts, T(-1));
+  }
+  std::vector<std::reference_wrapper<la::Vector<T>>> u_ref(u.begin(),
+                                                           u.end());
+  common::Scatterer<> scatterer(*index_map, bs * num_vectors);
+  la::scatter_fwd(u_ref, scatterer);
+  for (int j = 0; j < num_vectors; ++j)
+    for (int i = 0; i < bs * num_ghosts; ++i)
+      CHECK(u[j].array()[bs * size_local + i] == value(owner, i, j));
+
+  for (auto& uj : u)
+    std::ranges::fill(uj.mutable_array(), 1);
+  la::scatter_rev(u_ref, scatterer, std::plus<T>());
+  for (int j = 0; j < num_vectors; ++j)
+    for (int i = 0; i < bs * size_local; ++i)
+      CHECK(u[j].array()[i] == T(i < bs * num_ghosts ? 2 : 1));
+}
+
+template <typename T>
+void test_multivector_orthonormalize()
+{
+  using U = dolfinx::scalar_value_type_t<T>;
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 40;
+  constexpr int n = 4;
+  auto index_map = std::make_shared<common::IndexMap>(MPI_COMM_WORLD,
+                                                      size_local);
+
+  la::MultiVector<T> X(index_map, 1, n);
+  std::span<T> x = X.mutable_array();
+  for (int i = 0; i < size_local; ++i)
+    for (int j = 0; j < n; ++j)
+      x[i * n + j] = std::cos(U(1 + mpi_rank * size_local + i) * (j + 1));
+  la::MultiVector<T> X0 = X;
+
+  // Q^H Q = I
+  std::vector<T> R = la::orthonormalize(X);
+  std::vector<T> G = la::inner_products(X, X);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      CHECK(std::abs(G[i * n + j] - T(i == j ? 1 : 0)) < 1e-12);
+      if (j < i)
+        CHECK(R[i * n + j] == T(0));
+    }
+  }
+
+  // Q R = X
+  la::MultiVector<T> Y(index_map, 1, n);
+  la::mult(X, std::span<const T>(R), Y);
+  for (std::size_t i = 0; i < x.size(); ++i)
+    CHECK(std::abs(Y.array()[i] - X0.array()[i]) < 1e-12);
+
+  // Linearly dependent vectors
+  for (int i = 0; i < size_local; ++i)
+    x[i * n + n - 1] = x[i * n];
+  CHECK_THROWS(la::orthonormalize(X));
+}
+
+template <typename T>
+void test_scatter_autotuning()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Ghost the first entries on the next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+  const std::vector<int> owners(ghosts.size(), (mpi_rank + 1) % mpi_size);
+  auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local, ghosts, owners);
+
+  // The timings are cached, and the selected pattern is the fastest
+  using type = common::Scatterer<>::type;
+  const std::vector<type> types = {type::neighbor, type::p2p, type::shared};
+  la::clear_scatter_timings();
+  std::vector<double> times
+      = la::scatter_times(index_map, 2, sizeof(T), types, 2);
+  REQUIRE(times.size() == types.size());
+  CHECK(la::scatter_times(index_map, 2, sizeof(T), types, 2) == times);
+  type fastest = la::tune_scatter_type(index_map, 2, sizeof(T), types, 2);
+  if (mpi_size > 1)
+  {
+    CHECK(fastest
+          == types[std::distance(times.begin(),
+                                 std::ranges::min_element(times))]);
+  }
+  else
+    CHECK(fastest == type::neighbor);
+
+  // Vectors created with the default pattern use the tuned pattern
+  la::set_scatter_autotuning(true);
+  la::Vector<T> v(index_map, 2);
+  la::set_scatter_autotuning(false);
+  std::ranges::fill(v.mutable_array(), mpi_rank);
+  v.scatter_fwd();
+  std::span<const T> x = v.array();
+  for (int i = 0; i < 2 * num_ghosts; ++i)
+    CHECK(x[2 * size_local + i] == T((mpi_rank + 1) % mpi_size));
+  la::clear_scatter_timings();
+}
+
 } // namespace
 
 TEMPLATE_TEST_CASE("Linear Algebra Vector", "[la_vector]", double,
                    std::complex<double>)
 {
   CHECK_NOTHROW(test_vector<TestType>());
+  CHECK_NOTHROW(test_scatter_persistent<TestType>());
+  CHECK_NOTHROW(test_scatter_reduced_precision<TestType>());
+  CHECK_NOTHROW(test_vector_memory_resource<TestType>());
+  CHECK_NOTHROW(test_scatter_shared_memory<TestType>());
+  CHECK_NOTHROW(test_scatter_pack<TestType>());
+  CHECK_NOTHROW(test_scatter_delta<TestType>());
+  CHECK_NOTHROW(test_scatter_autotuning<TestType>());
+  CHECK_NOTHROW(test_fused_reductions<TestType>());
+  CHECK_NOTHROW(test_threaded_kernels<TestType>());
+  CHECK_NOTHROW(test_orthonormalize<TestType>());
+  CHECK_NOTHROW(test_multivector<TestType>());
+  CHECK_NOTHROW(test_multivector_orthonormalize<TestType>());
 }
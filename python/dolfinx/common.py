@@ -47,6 +47,50 @@ def list_timings(comm, timing_types: list, reduction=Reduction.max):
     _cpp.common.list_timings(comm, timing_types, reduction)
 
 
+def enable_profile_trace(state: bool = True):
+    """Enable or disable the recording of a trace of the profiled
+    regions, including named Timers. Tracing is disabled by default."""
+    _cpp.common.enable_profile_trace(state)
+
+
+def write_profile_trace(comm, filename: str):
+    """Write the trace of the profiled regions on all processes to a
+    file in the Chrome trace event (JSON) format, which can be viewed
+    with Perfetto. Collective."""
+    _cpp.common.write_profile_trace(comm, filename)
+
+
+def enable_comm_profiling(state: bool = True):
+    """Enable or disable the recording of MPI communication statistics
+    (messages, bytes, neighbours and wait times) of the scatterers and
+    the data distribution functions. A summary is printed by
+    :func:`list_timings`. Recording is disabled by default."""
+    _cpp.common.enable_comm_profiling(state)
+
+
+def write_comm_matrix(comm, filename: str):
+    """Write the number of messages and bytes sent between each pair of
+    ranks to a CSV file with columns ``rank,dest,messages,bytes``.
+    Collective."""
+    _cpp.common.write_comm_matrix(comm, filename)
+
+
+def set_num_threads(num_threads: int):
+    """Set the default number of threads of the threaded functions.
+
+    The default is used when a function is passed ``num_threads=0``, and
+    is initialised from the environment variable ``DOLFINX_NUM_THREADS``
+    (1 if not set). Threads run on a shared pool and do not call MPI,
+    which requires MPI to provide at least ``MPI_THREAD_FUNNELED``."""
+    _cpp.common.set_num_threads(num_threads)
+
+
+def num_threads() -> int:
+    """The default number of threads of the threaded functions (see
+    :func:`set_num_threads`)."""
+    return _cpp.common.num_threads()
+
+
 class Timer:
     """A timer can be used for timing tasks. The basic usage is::
 
@@ -5,9 +5,12 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 """Tools for assembling and manipulating finite element forms."""
 
+import typing
+
 import numpy as np
 import numpy.typing as npt
 
+from dolfinx import cpp as _cpp
 from dolfinx.cpp.fem import IntegralType, transpose_dofmap
 from dolfinx.cpp.fem import compute_integration_domains as _compute_integration_domains
 from dolfinx.cpp.fem import create_interpolation_data as _create_interpolation_data
@@ -17,8 +20,10 @@ from dolfinx.cpp.fem import interpolation_matrix as _interpolation_matrix
 from dolfinx.cpp.mesh import Topology
 from dolfinx.fem.assemble import (
     apply_lifting,
+    assemble_diagonal,
     assemble_matrix,
     assemble_scalar,
+    assemble_scalars,
     assemble_vector,
     create_matrix,
     create_vector,
@@ -29,6 +34,7 @@ from dolfinx.fem.bcs import (
     bcs_by_block,
     dirichletbc,
     locate_dofs_geometrical,
+    locate_dofs_tagged,
     locate_dofs_topological,
 )
 from dolfinx.fem.dofmap import DofMap
@@ -51,13 +57,15 @@ from dolfinx.fem.function import (
 )
 from dolfinx.geometry import PointOwnershipData as _PointOwnershipData
 from dolfinx.la import MatrixCSR as _MatrixCSR
+from dolfinx.la import Vector as _Vector
 
 
-def create_sparsity_pattern(a: Form):
+def create_sparsity_pattern(a: Form, num_threads: int = 1):
     """Create a sparsity pattern from a bilinear form.
 
     Args:
         a: Bilinear form to build a sparsity pattern for.
+        num_threads: Number of threads to use for inserting the entries.
 
     Returns:
         Sparsity pattern for the form ``a``.
@@ -66,7 +74,7 @@ def create_sparsity_pattern(a: Form):
         The pattern is not finalised, i.e. the caller is responsible for
         calling ``assemble`` on the sparsity pattern.
     """
-    return _create_sparsity_pattern(a._cpp_object)
+    return _create_sparsity_pattern(a._cpp_object, num_threads)
 
 
 def create_interpolation_data(
@@ -96,6 +104,129 @@ def create_interpolation_data(
     )
 
 
+def create_interpolation_plan(V_from: FunctionSpace, interpolation_data: _PointOwnershipData):
+    """Create a plan for repeatedly interpolating functions across different meshes.
+
+    The plan caches the reference coordinates of the interpolation
+    points, the basis values of ``V_from`` at the points and the
+    communication pattern, so that only function evaluation and the
+    exchange of values is performed when interpolating with
+    :meth:`dolfinx.fem.Function.interpolate_nonmatching`.
+
+    Args:
+        V_from: Function space to interpolate from
+        interpolation_data: Data created by
+            :func:`dolfinx.fem.create_interpolation_data` for ``V_from``.
+
+    Returns:
+        Interpolation plan.
+    """
+    dtype = V_from.mesh.geometry.x.dtype
+    if np.issubdtype(dtype, np.float32):
+        plan = _cpp.fem.NonmatchingInterpolationPlan_float32
+    elif np.issubdtype(dtype, np.float64):
+        plan = _cpp.fem.NonmatchingInterpolationPlan_float64
+    else:
+        raise NotImplementedError(f"Type {dtype} not supported.")
+    return plan(V_from._cpp_object, interpolation_data._cpp_object)
+
+
+def create_evaluation_plan(
+    V: FunctionSpace, x: npt.NDArray[np.floating], cells: npt.NDArray[np.int32]
+):
+    """Create a plan for repeatedly evaluating functions at points.
+
+    The plan caches the basis values of ``V`` at the points, so that
+    :meth:`dolfinx.fem.Function.eval_with` only contracts the cached
+    values with the degrees-of-freedom. The mesh must not move while
+    the plan is in use.
+
+    Args:
+        V: Function space of the functions to evaluate.
+        x: Points to evaluate at, ``shape=(num_points, 3)``.
+        cells: Cell containing each point. Points with a negative cell
+            index are not evaluated.
+
+    Returns:
+        Evaluation plan.
+    """
+    dtype = V.mesh.geometry.x.dtype
+    if np.issubdtype(dtype, np.float32):
+        plan = _cpp.fem.EvaluationPlan_float32
+    elif np.issubdtype(dtype, np.float64):
+        plan = _cpp.fem.EvaluationPlan_float64
+    else:
+        raise NotImplementedError(f"Type {dtype} not supported.")
+    x = np.asarray(x, dtype=dtype).reshape(-1, 3)
+    return plan(V._cpp_object, x, np.asarray(cells, dtype=np.int32))
+
+
+def create_distributed_evaluation_plan(
+    V: FunctionSpace, x: npt.NDArray[np.floating], padding: float = 1e-14
+):
+    """Create a plan for repeatedly evaluating functions at points on any process.
+
+    Each process passes its own points, without the cells that contain
+    them. The owning process of each point is computed once, and the
+    basis values at the points are cached on the owners. Evaluating a
+    function with :meth:`dolfinx.fem.Function.eval_with` is collective
+    and returns the values at the points passed by each process, in
+    their input order. The mesh must not move while the plan is in use.
+
+    Args:
+        V: Function space of the functions to evaluate.
+        x: Points to evaluate at on this process, ``shape=(num_points, 3)``.
+        padding: Padding of the cell bounding boxes used to locate the
+            points.
+
+    Returns:
+        Evaluation plan. Its ``owners`` property is the rank that owns
+        each point, or -1 for points that are not in the mesh.
+    """
+    dtype = V.mesh.geometry.x.dtype
+    if np.issubdtype(dtype, np.float32):
+        plan = _cpp.fem.DistributedEvaluationPlan_float32
+    elif np.issubdtype(dtype, np.float64):
+        plan = _cpp.fem.DistributedEvaluationPlan_float64
+    else:
+        raise NotImplementedError(f"Type {dtype} not supported.")
+    x = np.ascontiguousarray(x, dtype=dtype).reshape(-1, 3)
+    return plan(V._cpp_object, x, padding)
+
+
+def create_interpolator(V: FunctionSpace, cells: typing.Optional[npt.NDArray[np.int32]] = None):
+    """Create cached operators for repeatedly interpolating expressions into a space.
+
+    The interpolator caches the physical interpolation points and, for
+    each cell, the operator that maps values at the interpolation
+    points to the degrees-of-freedom, including the pull-back and the
+    degree-of-freedom transformations. Interpolating with
+    :meth:`dolfinx.fem.Function.interpolate_with`, e.g. time-dependent
+    boundary data at each time step, then skips the per-cell geometry
+    computations. The mesh must not move while the interpolator is in
+    use.
+
+    Args:
+        V: Function space to interpolate into.
+        cells: Cells to interpolate on. If ``None``, all cells
+            (owned and ghosted) are used.
+
+    Returns:
+        Interpolator.
+    """
+    if cells is None:
+        map = V.mesh.topology.index_map(V.mesh.topology.dim)
+        cells = np.arange(map.size_local + map.num_ghosts, dtype=np.int32)
+    dtype = V.mesh.geometry.x.dtype
+    if np.issubdtype(dtype, np.float32):
+        interpolator = _cpp.fem.Interpolator_float32
+    elif np.issubdtype(dtype, np.float64):
+        interpolator = _cpp.fem.Interpolator_float64
+    else:
+        raise NotImplementedError(f"Type {dtype} not supported.")
+    return interpolator(V._cpp_object, cells)
+
+
 def discrete_gradient(space0: FunctionSpace, space1: FunctionSpace) -> _MatrixCSR:
     """Assemble a discrete gradient operator.
 
@@ -113,21 +244,94 @@ def discrete_gradient(space0: FunctionSpace, space1: FunctionSpace) -> _MatrixCS
     return _discrete_gradient(space0._cpp_object, space1._cpp_object)
 
 
-def interpolation_matrix(space0: FunctionSpace, space1: FunctionSpace) -> _MatrixCSR:
+def interpolation_matrix(
+    space0: FunctionSpace, space1: FunctionSpace, num_threads: int = 1
+) -> _MatrixCSR:
     """Assemble an interpolation matrix for two function spaces on the same mesh.
 
     Args:
         space0: space to interpolate from
         space1: space to interpolate into
+        num_threads: Number of threads used to compute the cell matrices
 
     Returns:
         Interpolation matrix
     """
-    return _MatrixCSR(_interpolation_matrix(space0._cpp_object, space1._cpp_object))
+    return _MatrixCSR(
+        _interpolation_matrix(space0._cpp_object, space1._cpp_object, num_threads)
+    )
+
+
+class RefinementTransfer:
+    """Transfer operators between spaces on a parent and a refined mesh.
+
+    The prolongation operator :math:`P` interpolates a function on the
+    parent (coarse) mesh into a space on the refined (fine) mesh. The
+    restriction operator is :math:`P^{T}`. The operators are computed
+    from the parent cell of each refined cell, which avoids a point
+    search.
+
+    Note:
+        The spaces must use point evaluation elements (e.g. Lagrange)
+        with the same block size, the parent mesh must be affine, and
+        the refined mesh must not be redistributed during refinement.
+    """
+
+    def __init__(
+        self, space0: FunctionSpace, space1: FunctionSpace, parent_cell: npt.NDArray[np.int32]
+    ):
+        """Create transfer operators.
+
+        Args:
+            space0: Space on the parent mesh.
+            space1: Space on the refined mesh.
+            parent_cell: Parent cell of each refined cell, as returned
+                by :func:`dolfinx.mesh.refine_plaza` with
+                ``RefinementOption.parent_cell``.
+        """
+        dtype = space0.mesh.geometry.x.dtype
+        if np.issubdtype(dtype, np.float32):
+            cls = _cpp.refinement.Transfer_float32
+        elif np.issubdtype(dtype, np.float64):
+            cls = _cpp.refinement.Transfer_float64
+        else:
+            raise NotImplementedError(f"Type {dtype} not supported.")
+        self._cpp_object = cls(space0._cpp_object, space1._cpp_object, parent_cell)
+
+    def prolongation_matrix(self) -> _MatrixCSR:
+        """Assemble the prolongation matrix.
+
+        Returns:
+            Prolongation matrix, with rows for the space on the refined
+            mesh and columns for the space on the parent mesh.
+        """
+        return _MatrixCSR(self._cpp_object.prolongation_matrix())
+
+    def prolong(self, x0: _Vector, x1: _Vector):
+        """Compute ``x1 = P x0`` matrix-free (collective).
+
+        Args:
+            x0: Vector on the parent mesh space, with up-to-date ghosts.
+            x1: Vector on the refined mesh space. Ghosts are updated.
+        """
+        self._cpp_object.apply_prolongation(x0._cpp_object, x1._cpp_object)
+
+    def restrict(self, x1: _Vector, x0: _Vector):
+        """Compute ``x0 = P^T x1`` matrix-free (collective).
+
+        Args:
+            x1: Vector on the refined mesh space.
+            x0: Vector on the parent mesh space. Ghosts are updated.
+        """
+        self._cpp_object.apply_restriction(x1._cpp_object, x0._cpp_object)
 
 
 def compute_integration_domains(
-    integral_type: IntegralType, topology: Topology, entities: np.ndarray, dim: int
+    integral_type: IntegralType,
+    topology: Topology,
+    entities: np.ndarray,
+    dim: int,
+    sort: bool = False,
 ):
     """Given an integral type and a set of entities compute integration entities.
 
@@ -151,11 +355,14 @@ def compute_integration_domains(
         topology: Mesh topology
         entities: List of mesh entities
         dim: Topological dimension of entities
+        sort: If ``True``, order the integration entities by cell index
+            to improve data locality in assembly. Interior facets are
+            ordered by their first cell.
 
     Returns:
         List of integration entities
     """
-    return _compute_integration_domains(integral_type, topology, entities, dim)
+    return _compute_integration_domains(integral_type, topology, entities, dim, sort)
 
 
 __all__ = [
@@ -169,8 +376,11 @@ __all__ = [
     "FunctionSpace",
     "create_sparsity_pattern",
     "discrete_gradient",
+    "RefinementTransfer",
     "assemble_scalar",
+    "assemble_scalars",
     "assemble_matrix",
+    "assemble_diagonal",
     "assemble_vector",
     "apply_lifting",
     "set_bc",
@@ -183,10 +393,15 @@ __all__ = [
     "IntegralType",
     "create_vector",
     "locate_dofs_geometrical",
+    "locate_dofs_tagged",
     "locate_dofs_topological",
     "extract_function_spaces",
     "transpose_dofmap",
     "create_interpolation_data",
+    "create_evaluation_plan",
+    "create_distributed_evaluation_plan",
+    "create_interpolation_plan",
+    "create_interpolator",
     "CoordinateElement",
     "coordinate_element",
     "form_cpp_class",
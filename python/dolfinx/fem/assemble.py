@@ -11,6 +11,8 @@ import collections
 import functools
 import typing
 
+from mpi4py import MPI
+
 import numpy as np
 
 import dolfinx
@@ -53,7 +55,9 @@ def pack_constants(
     return _pack(form)
 
 
-def pack_coefficients(form: typing.Union[Form, typing.Sequence[Form]]):
+def pack_coefficients(
+    form: typing.Union[Form, typing.Sequence[Form]], num_threads: int = 1, out=None
+):
     """Compute form coefficients.
 
     Pack the `coefficients` that appear in forms. The packed
@@ -66,21 +70,73 @@ def pack_coefficients(form: typing.Union[Form, typing.Sequence[Form]]):
 
     Args:
         form: A single form or array of forms to pack the constants for.
+        num_threads: Number of threads to use for packing.
+        out: Coefficients returned by a previous call for the same
+            form(s). If provided, the coefficients are packed into the
+            arrays of ``out`` and no new arrays are allocated.
 
     Returns:
         Coefficients for each form.
 
     """
 
-    def _pack(form):
+    def _pack(form, out):
         if form is None:
             return {}
         elif isinstance(form, collections.abc.Iterable):
-            return list(map(lambda sub_form: _pack(sub_form), form))
+            if out is None:
+                out = [None] * len(form)
+            return [_pack(sub_form, c) for sub_form, c in zip(form, out)]
+        elif out is None:
+            return _pack_coefficients(form, num_threads)
         else:
-            return _pack_coefficients(form)
+            _pack_coefficients(form, out, num_threads)
+            return out
+
+    return _pack(form, out)
+
+
+def create_coefficient_cache(form: Form, num_threads: int = 1):
+    """Create packed form coefficients that are repacked only when they change.
+
+    The cache records the version of the vector of each coefficient
+    when it is packed. Calling ``update`` on the cache repacks only the
+    coefficients whose vector has been modified since. The
+    ``coefficients`` of the cache can be passed to an assembler.
+
+    Warning:
+        The version of a vector is incremented only when its array is
+        accessed through :attr:`dolfinx.la.Vector.array` or when
+        :meth:`dolfinx.la.Vector.mark_modified` is called. Changes made
+        through the PETSc vector that wraps the array (e.g.
+        :attr:`dolfinx.la.Vector.petsc_vec` or
+        :func:`dolfinx.la.create_petsc_vector_wrap`), or through a
+        NumPy view of the array held from before, are not detected and
+        ``update`` keeps the stale coefficients. This is the case for
+        the solution of a PETSc Newton solver, which updates the
+        solution through the wrapped PETSc vector. Call
+        ``mark_modified`` on the vector of the coefficient after such
+        changes.
 
-    return _pack(form)
+    Args:
+        form: The form to pack the coefficients for.
+        num_threads: Number of threads to use for packing.
+
+    Returns:
+        The coefficient cache.
+
+    """
+    if np.issubdtype(form.dtype, np.float32):
+        cache = _cpp.fem.CoefficientCache_float32
+    elif np.issubdtype(form.dtype, np.float64):
+        cache = _cpp.fem.CoefficientCache_float64
+    elif np.issubdtype(form.dtype, np.complex64):
+        cache = _cpp.fem.CoefficientCache_complex64
+    elif np.issubdtype(form.dtype, np.complex128):
+        cache = _cpp.fem.CoefficientCache_complex128
+    else:
+        raise NotImplementedError(f"Type {form.dtype} not supported.")
+    return cache(form._cpp_object, num_threads)
 
 
 # -- Vector and matrix instantiation -----------------------------------------
@@ -141,6 +197,27 @@ def assemble_scalar(M: Form, constants=None, coeffs=None):
     return _cpp.fem.assemble_scalar(M._cpp_object, constants, coeffs)
 
 
+def assemble_scalars(M: list[Form], comm=None) -> np.ndarray:
+    """Assemble several functionals in one pass.
+
+    The cell integrals of functionals over the same cells are evaluated
+    in one pass over the cells.
+
+    Args:
+        M: The functionals to compute.
+        comm: If provided, the values are summed across the processes
+            of the communicator with a single reduction. Otherwise the
+            returned values are local.
+
+    Returns:
+        The computed values, one for each functional.
+    """
+    values = _cpp.fem.assemble_scalars([form._cpp_object for form in M])
+    if comm is not None:
+        comm.Allreduce(MPI.IN_PLACE, values, op=MPI.SUM)
+    return values
+
+
 # -- Vector assembly ---------------------------------------------------------
 
 
@@ -212,6 +289,35 @@ def _assemble_vector_array(b: np.ndarray, L: Form, constants=None, coeffs=None):
     return b
 
 
+@assemble_vector.register(la.Vector)
+def _assemble_vector_vector(b: la.Vector, L: Form, constants=None, coeffs=None) -> la.Vector:
+    """Assemble linear form into an existing Vector.
+
+    The entries of ``b``, including the ghost entries, are set to zero
+    before assembly. Re-using ``b`` avoids allocating a new vector when
+    a form is assembled in a loop.
+
+    Args:
+        b: The vector to assemble into, e.g. created by
+            :func:`dolfinx.fem.create_vector`.
+        L: The linear form assemble.
+        constants: Constants that appear in the form. If not provided,
+            any required constants will be computed.
+        coeffs: Coefficients that appear in the form. If not provided,
+            any required coefficients will be computed.
+
+    Returns:
+        The vector ``b``.
+
+    Note:
+        The vector is not finalised, i.e. ghost values are not
+        accumulated on the owning processes.
+    """
+    b.array[:] = 0
+    _assemble_vector_array(b.array, L, constants, coeffs)
+    return b
+
+
 # -- Matrix assembly ---------------------------------------------------------
 
 
@@ -293,6 +399,121 @@ def _assemble_matrix_csr(
     return A
 
 
+def assemble_diagonal(
+    a: Form,
+    bcs: typing.Optional[list[DirichletBC]] = None,
+    diagonal: float = 1.0,
+    d: typing.Optional[la.Vector] = None,
+    num_threads: int = 1,
+) -> la.Vector:
+    """Assemble the diagonal of the matrix of a bilinear form, without
+    assembling the matrix.
+
+    The diagonal is that of the matrix returned by
+    :func:`assemble_matrix` with the same boundary conditions, after
+    the ghost contributions are accumulated, e.g. for Jacobi smoothing
+    in matrix-free solvers. Collective.
+
+    Args:
+        a: The bilinear form. The test and trial spaces must be the
+            same.
+        bcs: Boundary conditions. The diagonal entries of
+            degrees-of-freedom constrained by a boundary condition are
+            set to ``diagonal``.
+        diagonal: The value of the diagonal entries of constrained
+            degrees-of-freedom.
+        d: Vector to assemble into. If not provided, a vector is
+            created. The vector is zeroed first.
+        num_threads: Number of threads to use for assembly.
+
+    Returns:
+        Vector with the owned entries of the diagonal. Ghost entries
+        are not updated.
+    """
+    bcs = [] if bcs is None else [bc._cpp_object for bc in bcs]
+    if d is None:
+        dofmap = a.function_spaces[0].dofmap
+        d = la.vector(dofmap.index_map, dofmap.index_map_bs, dtype=a.dtype)
+    _cpp.fem.assemble_diagonal(d._cpp_object, a._cpp_object, bcs, diagonal, num_threads)
+    return d
+
+
+class AssemblyPlan:
+    """Data for repeated assembly of a bilinear form into a MatrixCSR.
+
+    The plan holds the boundary condition dof markers, the packed
+    coefficients, which are repacked only when a coefficient changes,
+    and the position in the matrix values of each entry added by the
+    assembler. The positions are recorded by the first assembly into a
+    matrix, and later assemblies into the same matrix only execute the
+    kernels and add the element matrices at the recorded positions.
+    This reduces the overhead of assembling small forms in a loop.
+
+    Note:
+        The plan is created for the given boundary conditions. Create
+        a new plan if the boundary conditions change.
+    """
+
+    def __init__(
+        self,
+        a: Form,
+        bcs: typing.Optional[list[DirichletBC]] = None,
+        num_threads: int = 1,
+    ):
+        """Create an assembly plan.
+
+        Args:
+            a: The bilinear form.
+            bcs: Boundary conditions that affect the assembled matrix.
+            num_threads: Number of threads to use for packing
+                coefficients.
+        """
+        if np.issubdtype(a.dtype, np.float32):
+            plan = _cpp.fem.AssemblyPlan_float32
+        elif np.issubdtype(a.dtype, np.float64):
+            plan = _cpp.fem.AssemblyPlan_float64
+        elif np.issubdtype(a.dtype, np.complex64):
+            plan = _cpp.fem.AssemblyPlan_complex64
+        elif np.issubdtype(a.dtype, np.complex128):
+            plan = _cpp.fem.AssemblyPlan_complex128
+        else:
+            raise NotImplementedError(f"Type {a.dtype} not supported.")
+        bcs = [] if bcs is None else [bc._cpp_object for bc in bcs]
+        self._cpp_object = plan(a._cpp_object, bcs, num_threads)
+
+    def assemble(self, A: la.MatrixCSR, diagonal: float = 1.0) -> la.MatrixCSR:
+        """Assemble the form into a matrix.
+
+        Degrees-of-freedom constrained by a boundary condition have
+        their rows/columns zeroed and, if the test and trial spaces are
+        the same, the value ``diagonal`` set on the matrix diagonal.
+
+        Args:
+            A: The matrix to assemble into, created by
+                :func:`dolfinx.fem.create_matrix`. The matrix is not
+                zeroed.
+            diagonal: The value to set on the diagonal of constrained
+                rows.
+
+        Returns:
+            The matrix ``A``.
+
+        Note:
+            The returned matrix is not finalised, i.e. ghost values are
+            not accumulated.
+        """
+        self._cpp_object.assemble(A._cpp_object, diagonal)
+        return A
+
+    def reset(self) -> None:
+        """Discard the recorded matrix entry positions.
+
+        Call this before assembling into a new matrix that may reuse
+        the memory of a deleted matrix.
+        """
+        self._cpp_object.reset()
+
+
 # -- Modifiers for Dirichlet conditions ---------------------------------------
 
 
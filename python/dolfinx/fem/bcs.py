@@ -15,6 +15,7 @@ import numpy.typing
 
 if typing.TYPE_CHECKING:
     from dolfinx.fem.function import Constant, Function
+    from dolfinx.mesh import MeshTags
 
 import numpy as np
 
@@ -25,6 +26,7 @@ from dolfinx import cpp as _cpp
 def locate_dofs_geometrical(
     V: typing.Union[dolfinx.fem.FunctionSpace, typing.Iterable[dolfinx.fem.FunctionSpace]],
     marker: typing.Callable,
+    cells: typing.Optional[numpy.typing.NDArray[np.int32]] = None,
 ) -> np.ndarray:
     """Locate degrees-of-freedom geometrically using a marker function.
 
@@ -35,6 +37,10 @@ def locate_dofs_geometrical(
             shape ``(gdim, num_points)`` and returns an array of
             booleans of length ``num_points``, evaluating to ``True``
             for entities whose degree-of-freedom should be returned.
+        cells: Cells (local to process) in which to search for
+            degrees-of-freedom. If not supplied, all cells are searched.
+            Searching only the cells attached to the boundary is much
+            cheaper when locating boundary degrees-of-freedom.
 
     Returns:
         An array of degree-of-freedom indices (local to the process) for
@@ -47,11 +53,12 @@ def locate_dofs_geometrical(
         Returned degree-of-freedom indices are unique and ordered by the
         first column.
     """
+    args = () if cells is None else (np.asarray(cells, dtype=np.int32),)
     try:
-        return _cpp.fem.locate_dofs_geometrical(V._cpp_object, marker)  # type: ignore
+        return _cpp.fem.locate_dofs_geometrical(V._cpp_object, marker, *args)  # type: ignore
     except AttributeError:
         _V = [space._cpp_object for space in V]
-        return _cpp.fem.locate_dofs_geometrical(_V, marker)
+        return _cpp.fem.locate_dofs_geometrical(_V, marker, *args)
 
 
 def locate_dofs_topological(
@@ -90,6 +97,36 @@ def locate_dofs_topological(
         return _cpp.fem.locate_dofs_topological(_V, entity_dim, _entities, remote)
 
 
+def locate_dofs_tagged(
+    V: dolfinx.fem.FunctionSpace,
+    tags: MeshTags,
+    values: typing.Iterable[int],
+    remote: bool = True,
+) -> list[np.ndarray]:
+    """Locate degrees-of-freedom belonging to tagged mesh entities topologically.
+
+    The mesh tags are traversed once and the degrees-of-freedom for all
+    values are located together, which is cheaper than calling
+    :func:`locate_dofs_topological` for each value.
+
+    Args:
+        V: Function space in which to search for degree-of-freedom
+            indices.
+        tags: Mesh tags.
+        values: Tag values to locate degrees-of-freedom for. Values must
+            be unique.
+        remote: True to return also "remotely located" degree-of-freedom
+            indices.
+
+    Returns:
+        For each value in ``values``, an array of degree-of-freedom
+        indices (local to the process) for degrees-of-freedom
+        topologically belonging to mesh entities with the value.
+    """
+    _values = np.asarray(values, dtype=np.int32)
+    return _cpp.fem.locate_dofs_topological(V._cpp_object, tags._cpp_object, _values, remote)
+
+
 class DirichletBC:
     _cpp_object: typing.Union[
         _cpp.fem.DirichletBC_complex64,
@@ -132,6 +169,39 @@ class DirichletBC:
         """The function space on which the boundary condition is defined"""
         return self._cpp_object.function_space
 
+    @property
+    def dof_coordinates(self) -> numpy.typing.NDArray[np.floating]:
+        """Coordinates of the constrained dofs, with shape ``(3, num_points)``.
+
+        The coordinates are computed on first access from the cells
+        that contain constrained dofs and cached.
+        """
+        return self._cpp_object.dof_coordinates
+
+    def interpolate(
+        self, f: typing.Callable[[numpy.typing.NDArray[np.floating]], numpy.typing.ArrayLike]
+    ):
+        """Set the boundary values by evaluating a function at the dof coordinates.
+
+        Only the constrained dofs are evaluated, which makes updating
+        time-dependent boundary values much cheaper than interpolating
+        into the boundary value function. The values replace the values
+        of the boundary value function or constant, which is not
+        modified, until :meth:`reset_values` is called.
+
+        Args:
+            f: Callable that takes points with shape ``(3, num_points)``
+                and returns the values with shape ``(num_points,)`` or
+                ``(block_size, num_points)``.
+        """
+        dtype = self._cpp_object.value.dtype
+        values = np.ascontiguousarray(f(self.dof_coordinates), dtype=dtype)
+        self._cpp_object.set_values(values)
+
+    def reset_values(self):
+        """Use the values of the boundary value function or constant again."""
+        self._cpp_object.reset_values()
+
 
 def dirichletbc(
     value: typing.Union[Function, Constant, np.ndarray],
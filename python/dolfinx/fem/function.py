@@ -198,6 +198,8 @@ class Expression:
         mesh: Mesh,
         entities: np.ndarray,
         values: typing.Optional[np.ndarray] = None,
+        tile_size: int = 1024,
+        num_threads: int = 1,
     ) -> np.ndarray:
         """Evaluate Expression on entities.
 
@@ -210,6 +212,10 @@ class Expression:
                 storage will be allocated. Otherwise must have shape
                 ``(num_entities, num_points * value_size *
                 num_all_argument_dofs)``
+            tile_size: Number of entities for which coefficients are
+                packed at a time. Limits the memory used for packing.
+            num_threads: Number of threads to use. Tiles of entities
+                are distributed between the threads.
 
         Returns:
             Expression evaluated at points for `entities`.
@@ -241,7 +247,7 @@ class Expression:
                 raise TypeError("Passed array values does not have correct shape.")
             if values.dtype != self.dtype:
                 raise TypeError("Passed array values does not have correct dtype.")
-        self._cpp_object.eval(mesh._cpp_object, _entities, values)
+        self._cpp_object.eval(mesh._cpp_object, _entities, values, tile_size, num_threads)
         return values
 
     def X(self) -> np.ndarray:
@@ -394,8 +400,36 @@ class Function(ufl.Coefficient):
             u = np.reshape(u, (-1,))
         return u
 
+    def eval_with(
+        self, plan: typing.Any, num_threads: int = 1, u: typing.Optional[np.ndarray] = None
+    ) -> np.ndarray:
+        """Evaluate Function at points using an evaluation plan.
+
+        Args:
+            plan: Evaluation plan for the function space of ``self``,
+                created by :func:`dolfinx.fem.create_evaluation_plan`,
+                or by :func:`dolfinx.fem.create_distributed_evaluation_plan`
+                (collective).
+            num_threads: Number of threads to use.
+            u: Array to write the values to, with
+                ``shape=(num_points, value_size)``. If not provided, a
+                new array is returned.
+
+        Returns:
+            Values at the points of the plan, ``shape=(num_points,
+            value_size)``. Values at points with a negative cell index
+            are zero.
+        """
+        if u is None:
+            u = np.empty((plan.num_points, self._V.value_size), self.dtype)
+        self._cpp_object.eval(plan, u, num_threads)  # type: ignore
+        return u
+
     def interpolate_nonmatching(
-        self, u0: Function, cells: npt.NDArray[np.int32], interpolation_data: PointOwnershipData
+        self,
+        u0: Function,
+        cells: npt.NDArray[np.int32],
+        interpolation_data: typing.Union[PointOwnershipData, typing.Any],
     ) -> None:
         """Interpolate a Function defined on one mesh to a function defined on a different mesh.
 
@@ -405,9 +439,14 @@ class Function(ufl.Coefficient):
                 cells are interpolated over.
             interpolation_data: Data needed to interpolate functions
                 defined on other meshes. Created by
-                :func:`dolfinx.fem.create_interpolation_data`.
+                :func:`dolfinx.fem.create_interpolation_data`, or a
+                plan created by
+                :func:`dolfinx.fem.create_interpolation_plan` for
+                repeated interpolation from the space of ``u0``.
         """
-        self._cpp_object.interpolate(u0._cpp_object, cells, interpolation_data._cpp_object)  # type: ignore
+        if isinstance(interpolation_data, PointOwnershipData):
+            interpolation_data = interpolation_data._cpp_object
+        self._cpp_object.interpolate(u0._cpp_object, cells, interpolation_data)  # type: ignore
 
     def interpolate(
         self,
@@ -464,6 +503,22 @@ class Function(ufl.Coefficient):
             x = _cpp.fem.interpolation_coords(self._V.element, self._V.mesh.geometry, cells0)
             self._cpp_object.interpolate(np.asarray(u0(x), dtype=self.dtype), cells0)  # type: ignore
 
+    def interpolate_with(self, u0: typing.Callable, interpolator: typing.Any) -> None:
+        """Interpolate an expression using cached interpolation operators.
+
+        Args:
+            u0: Callable function to interpolate. It is evaluated at the
+                interpolation points stored by ``interpolator`` and must
+                return an array of shape ``(value_size, num_points)``
+                or ``(num_points,)``.
+            interpolator: Interpolator for the function space of
+                ``self``, created by
+                :func:`dolfinx.fem.create_interpolator`.
+        """
+        values = np.asarray(u0(interpolator.points), dtype=self.dtype)
+        values = values.reshape(-1, interpolator.points.shape[1])
+        self._cpp_object.interpolate(values, interpolator)  # type: ignore
+
     def copy(self) -> Function:
         """Create a copy of the Function.
 
@@ -814,9 +869,14 @@ class FunctionSpace(ufl.FunctionSpace):
         V = FunctionSpace(self._mesh, self.ufl_element(), cpp_space)
         return V, dofs
 
-    def tabulate_dof_coordinates(self) -> npt.NDArray[np.float64]:
+    def tabulate_dof_coordinates(self, out=None) -> npt.NDArray[np.float64]:
         """Tabulate the coordinates of the degrees-of-freedom in the function space.
 
+        Args:
+            out: Array to write the coordinates to, with
+                ``shape=(num_dofs, 3)``. If not provided, a new array is
+                returned.
+
         Returns:
             Coordinates of the degrees-of-freedom.
 
@@ -824,4 +884,7 @@ class FunctionSpace(ufl.FunctionSpace):
             This method is only for elements with point evaluation
             degrees-of-freedom.
         """
-        return self._cpp_object.tabulate_dof_coordinates()  # type: ignore
+        if out is None:
+            return self._cpp_object.tabulate_dof_coordinates()  # type: ignore
+        self._cpp_object.tabulate_dof_coordinates(out)  # type: ignore
+        return out
@@ -51,6 +51,8 @@ __all__ = [
     "assemble_matrix",
     "assemble_matrix_nest",
     "assemble_matrix_block",
+    "MatrixCOOAssembler",
+    "assemble_system",
     "apply_lifting",
     "apply_lifting_nest",
     "set_bc",
@@ -622,6 +624,93 @@ def _assemble_matrix_block_mat(
     return A
 
 
+class MatrixCOOAssembler:
+    """Assemble a bilinear form into PETSc matrices using the PETSc COO
+    interface (``MatSetPreallocationCOO``/``MatSetValuesCOO``).
+
+    The (row, column) indices of the matrix entries are recorded once,
+    when the assembler is created. Each assembly then sets all values
+    with one call, which avoids per-cell insertion and suits device
+    matrix types such as ``aijcusparse`` and ``aijkokkos``.
+    """
+
+    def __init__(self, a: Form, bcs: list[DirichletBC] = [], diagonal: float = 1.0):
+        """Record the matrix entries of a bilinear form.
+
+        Args:
+            a: Bilinear form.
+            bcs: Dirichlet boundary conditions applied to the system.
+            diagonal: Value to set on matrix diagonal for Dirichlet
+                boundary condition constrained degrees-of-freedom.
+        """
+        self._a = a
+        self._cpp_object = _cpp.fem.petsc.MatrixCOOAssembler(
+            a._cpp_object, [bc._cpp_object for bc in bcs], diagonal
+        )
+
+    def assemble(self, A: typing.Optional[PETSc.Mat] = None) -> PETSc.Mat:
+        """Assemble the form into a matrix.
+
+        The matrix is ready for use on return, i.e. ghost contributions
+        have been accumulated.
+
+        Args:
+            A: Matrix to assemble into. If not given, a matrix is
+                created.
+
+        Returns:
+            The assembled matrix.
+        """
+        if A is None:
+            A = _cpp.fem.petsc.create_matrix(self._a._cpp_object)
+        self._cpp_object.assemble(A)
+        return A
+
+    def reset(self):
+        """Pass the matrix entries again at the next assembly."""
+        self._cpp_object.reset()
+
+
+# -- System assembly ----------------------------------------------------------
+
+
+def assemble_system(
+    A: PETSc.Mat,  # type: ignore
+    b: PETSc.Vec,  # type: ignore
+    a: Form,
+    L: Form,
+    bcs: list[DirichletBC] = [],
+    x0: typing.Optional[PETSc.Vec] = None,  # type: ignore
+    scale: float = 1.0,
+    diagonal: float = 1.0,
+) -> tuple[PETSc.Mat, PETSc.Vec]:  # type: ignore
+    """Assemble a bilinear form into a matrix and a linear form into a
+    vector in one pass over the cells.
+
+    The result is the same as from :func:`assemble_matrix_mat` with
+    ``bcs`` and ``diagonal``, :func:`assemble_vector` and
+    :func:`apply_lifting` with ``x0`` and ``scale``. Neither the matrix
+    nor the vector are zeroed or finalised, i.e. ghost values are not
+    accumulated, and the boundary condition values are not inserted
+    into ``b`` (see :func:`set_bc`).
+    """
+    _bcs = [bc._cpp_object for bc in bcs]
+    with contextlib.ExitStack() as stack:
+        b_local = stack.enter_context(b.localForm())
+        if x0 is None:
+            x0_r = np.zeros(0, dtype=PETSc.ScalarType)  # type: ignore
+        else:
+            x0_r = stack.enter_context(x0.localForm()).array_r
+        _cpp.fem.petsc.assemble_system(
+            A, b_local.array_w, a._cpp_object, L._cpp_object, _bcs, x0_r, scale
+        )
+    if a.function_spaces[0] is a.function_spaces[1]:
+        A.assemblyBegin(PETSc.Mat.AssemblyType.FLUSH)  # type: ignore
+        A.assemblyEnd(PETSc.Mat.AssemblyType.FLUSH)  # type: ignore
+        _cpp.fem.petsc.insert_diagonal(A, a.function_spaces[0], _bcs, diagonal)
+    return A, b
+
+
 # -- Modifiers for Dirichlet conditions ---------------------------------------
 
 
@@ -949,6 +1038,23 @@ class NonlinearProblem:
         assemble_matrix_mat(A, self._a, self.bcs)
         A.assemble()
 
+    def FJ(self, x: PETSc.Vec, b: PETSc.Vec, A: PETSc.Mat) -> None:
+        """Assemble the residual F into the vector b and the Jacobian
+        matrix in one pass over the cells.
+
+        Args:
+            x: The vector containing the latest solution
+            b: Vector to assemble the residual into
+            A: Matrix to assemble the Jacobian into
+        """
+        with b.localForm() as b_local:
+            b_local.set(0.0)
+        A.zeroEntries()
+        assemble_system(A, b, self._a, self._L, self.bcs, x0=x, scale=-1.0)
+        A.assemble()
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        set_bc(b, self.bcs, x, -1.0)
+
 
 def discrete_gradient(space0: _FunctionSpace, space1: _FunctionSpace) -> PETSc.Mat:
     """Assemble a discrete gradient operator.
@@ -25,6 +25,8 @@ __all__ = [
     "compute_colliding_cells",
     "squared_distance",
     "compute_closest_entity",
+    "compute_nearest_entities",
+    "compute_entities_in_radius",
     "compute_collisions_trees",
     "compute_collisions_points",
     "compute_distance_gjk",
@@ -96,8 +98,46 @@ class BoundingBoxTree:
         """
         return self._cpp_object.get_bbox(i)
 
-    def create_global_tree(self, comm) -> BoundingBoxTree:
-        return BoundingBoxTree(self._cpp_object.create_global_tree(comm))
+    @property
+    def sah_cost(self) -> float:
+        """Surface area heuristic cost of the tree, lower for trees with less
+        overlap between nodes."""
+        return self._cpp_object.sah_cost
+
+    def refit(self, mesh: Mesh, num_threads: int = 1) -> float:
+        """Update the bounding boxes for new mesh coordinates.
+
+        The hierarchy of the tree is kept and only the bounding boxes are
+        recomputed, which is cheaper than building a new tree when the mesh
+        geometry changes but the topology does not.
+
+        Args:
+            mesh: The mesh that the tree was built for, with updated geometry.
+            num_threads: Number of threads to use.
+
+        Returns:
+            Ratio of the SAH cost of the refitted tree to the cost when the
+            tree was built. A new tree should be built when this is large.
+
+        """
+        return self._cpp_object.refit(mesh._cpp_object, num_threads)
+
+    def create_global_tree(self, comm, num_boxes: int = 1) -> BoundingBoxTree:
+        """Create a tree of the bounding boxes of the processes (collective).
+
+        Args:
+            comm: MPI communicator.
+            num_boxes: Maximum number of boxes per process. More boxes
+                give fewer false positive processes for non-convex
+                partitions, but a process can then appear more than once
+                in the collisions of a point.
+
+        Returns:
+            Tree where the leaves are (parts of) processes, with the rank
+            of the process as the leaf index.
+
+        """
+        return BoundingBoxTree(self._cpp_object.create_global_tree(comm, num_boxes))
 
 
 def bb_tree(
@@ -105,6 +145,7 @@ def bb_tree(
     dim: int,
     entities: typing.Optional[npt.NDArray[np.int32]] = None,
     padding: float = 0.0,
+    num_threads: int = 1,
 ) -> BoundingBoxTree:
     """Create a bounding box tree for use in collision detection.
 
@@ -114,6 +155,7 @@ def bb_tree(
         entities: List of entity indices (local to process). If not
             supplied, all owned and ghosted entities are used.
         padding: Padding for each bounding box.
+        num_threads: Number of threads used to build the tree.
 
     Returns:
         Bounding box tree.
@@ -128,31 +170,39 @@ def bb_tree(
     dtype = mesh.geometry.x.dtype
     if np.issubdtype(dtype, np.float32):
         return BoundingBoxTree(
-            _cpp.geometry.BoundingBoxTree_float32(mesh._cpp_object, dim, entities, padding)
+            _cpp.geometry.BoundingBoxTree_float32(
+                mesh._cpp_object, dim, entities, padding, num_threads
+            )
         )
     elif np.issubdtype(dtype, np.float64):
         return BoundingBoxTree(
-            _cpp.geometry.BoundingBoxTree_float64(mesh._cpp_object, dim, entities, padding)
+            _cpp.geometry.BoundingBoxTree_float64(
+                mesh._cpp_object, dim, entities, padding, num_threads
+            )
         )
     else:
         raise NotImplementedError(f"Type {dtype} not supported.")
 
 
 def compute_collisions_trees(
-    tree0: BoundingBoxTree, tree1: BoundingBoxTree
+    tree0: BoundingBoxTree, tree1: BoundingBoxTree, num_threads: int = 1
 ) -> npt.NDArray[np.int32]:
     """Compute all collisions between two bounding box trees.
 
     Args:
         tree0: First bounding box tree.
         tree1: Second bounding box tree.
+        num_threads: Number of threads for the tree traversal. The
+            result does not depend on the number of threads.
 
     Returns:
         List of pairs of intersecting box indices from each tree. Shape
         is ``(num_collisions, 2)``.
 
     """
-    return _cpp.geometry.compute_collisions_trees(tree0._cpp_object, tree1._cpp_object)
+    return _cpp.geometry.compute_collisions_trees(
+        tree0._cpp_object, tree1._cpp_object, num_threads
+    )
 
 
 def compute_collisions_points(
@@ -200,6 +250,58 @@ def compute_closest_entity(
     )
 
 
+def compute_nearest_entities(
+    tree: BoundingBoxTree,
+    mesh: Mesh,
+    points: npt.NDArray[np.floating],
+    k: int,
+    num_threads: int = 1,
+) -> _cpp.graph.AdjacencyList_int32:
+    """Compute the ``k`` closest mesh entities to points.
+
+    Args:
+        tree: Bounding box tree for the entities.
+        mesh: The mesh.
+        points: The points, ``shape=(num_points, 3)``.
+        k: Number of entities to find for each point.
+        num_threads: Number of threads to use.
+
+    Returns:
+        For each point, the ``k`` closest entities (fewer if the tree has
+        less than ``k`` entities), sorted by increasing distance.
+
+    """
+    return _cpp.geometry.compute_nearest_entities(
+        tree._cpp_object, mesh._cpp_object, points, k, num_threads
+    )
+
+
+def compute_entities_in_radius(
+    tree: BoundingBoxTree,
+    mesh: Mesh,
+    points: npt.NDArray[np.floating],
+    radius: float,
+    num_threads: int = 1,
+) -> _cpp.graph.AdjacencyList_int32:
+    """Compute the mesh entities within a distance of points.
+
+    Args:
+        tree: Bounding box tree for the entities.
+        mesh: The mesh.
+        points: The points, ``shape=(num_points, 3)``.
+        radius: The distance.
+        num_threads: Number of threads to use.
+
+    Returns:
+        For each point, the entities with distance less than or equal to
+        ``radius``, sorted by increasing distance.
+
+    """
+    return _cpp.geometry.compute_entities_in_radius(
+        tree._cpp_object, mesh._cpp_object, points, radius, num_threads
+    )
+
+
 def create_midpoint_tree(mesh: Mesh, dim: int, entities: npt.NDArray[np.int32]) -> BoundingBoxTree:
     """Create a bounding box tree for the midpoints of a subset of entities.
 
@@ -10,7 +10,7 @@ from __future__ import annotations
 import numpy as np
 
 from dolfinx import cpp as _cpp
-from dolfinx.cpp.graph import partitioner
+from dolfinx.cpp.graph import partitioner, partitioner_hierarchical
 
 # Import graph partitioners, which may or may not be available
 # (dependent on build configuration)
@@ -28,7 +28,7 @@ except ImportError:
     pass
 
 
-__all__ = ["adjacencylist", "partitioner"]
+__all__ = ["adjacencylist", "partitioner", "partitioner_hierarchical"]
 
 
 def adjacencylist(data: np.ndarray, offsets=None):
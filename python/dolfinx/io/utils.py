@@ -18,12 +18,23 @@ import basix
 import basix.ufl
 import ufl
 from dolfinx import cpp as _cpp
+from dolfinx.cpp.io import Aggregator, HDF5DatasetOptions, HDF5FileOptions, HDF5Filter
 from dolfinx.cpp.io import perm_gmsh as cell_perm_gmsh
 from dolfinx.cpp.io import perm_vtk as cell_perm_vtk
 from dolfinx.fem import Function
 from dolfinx.mesh import GhostMode, Mesh, MeshTags
 
-__all__ = ["VTKFile", "XDMFFile", "cell_perm_gmsh", "cell_perm_vtk", "distribute_entity_data"]
+__all__ = [
+    "VTKFile",
+    "XDMFFile",
+    "Aggregator",
+    "HDF5DatasetOptions",
+    "HDF5FileOptions",
+    "HDF5Filter",
+    "cell_perm_gmsh",
+    "cell_perm_vtk",
+    "distribute_entity_data",
+]
 
 
 def _extract_cpp_objects(functions: typing.Union[Mesh, Function, tuple[Function], list[Function]]):
@@ -36,9 +47,21 @@ def _extract_cpp_objects(functions: typing.Union[Mesh, Function, tuple[Function]
 
 # FidesWriter and VTXWriter require ADIOS2
 if _cpp.common.has_adios2:
-    from dolfinx.cpp.io import FidesMeshPolicy, VTXMeshPolicy  # F401
-
-    __all__ = [*__all__, "FidesWriter", "VTXWriter", "FidesMeshPolicy", "VTXMeshPolicy"]
+    from dolfinx.cpp.io import FidesMeshPolicy, VTXMeshPolicy, VTXOutputOptions  # F401
+
+    __all__ = [
+        *__all__,
+        "FidesWriter",
+        "VTXWriter",
+        "FidesMeshPolicy",
+        "VTXMeshPolicy",
+        "VTXOutputOptions",
+        "write_checkpoint",
+        "read_checkpoint_mesh",
+        "read_checkpoint_function",
+        "CheckpointWriter",
+        "CheckpointReader",
+    ]
 
     class VTXWriter:
         """Writer for VTX files, using ADIOS2 to create the files.
@@ -59,6 +82,8 @@ if _cpp.common.has_adios2:
             output: typing.Union[Mesh, Function, list[Function], tuple[Function]],
             engine: str = "BPFile",
             mesh_policy: VTXMeshPolicy = VTXMeshPolicy.update,
+            num_aggregators: int = 0,
+            engine_parameters: typing.Optional[dict[str, str]] = None,
         ):
             """Initialize a writer for outputting data in the VTX format.
 
@@ -75,6 +100,14 @@ if _cpp.common.has_adios2:
                     written to file, or is re-written (updated) at each
                     time step. Has an effect only for ``Function``
                     output.
+                num_aggregators: Number of ranks per node that write
+                    data to file. Data of the other ranks on a node is
+                    aggregated onto these ranks by the ADIOS2 engine. If
+                    ``0``, the engine default is used.
+                engine_parameters: ADIOS2 engine parameters, e.g.
+                    ``{"RendezvousReaderCount": "0", "QueueFullPolicy":
+                    "Discard"}`` for in-situ streaming with the ``SST``
+                    engine without waiting for readers.
 
             Note:
                 All Functions for output must share the same mesh and
@@ -94,13 +127,22 @@ if _cpp.common.has_adios2:
             elif np.issubdtype(dtype, np.float64):
                 _vtxwriter = _cpp.io.VTXWriter_float64
 
+            engine_parameters = {} if engine_parameters is None else engine_parameters
             try:
                 # Input is a mesh
-                self._cpp_object = _vtxwriter(comm, filename, output._cpp_object, engine)  # type: ignore[union-attr]
+                self._cpp_object = _vtxwriter(
+                    comm, filename, output._cpp_object, engine, num_aggregators, engine_parameters
+                )  # type: ignore[union-attr]
             except (NotImplementedError, TypeError, AttributeError):
                 # Input is a single function or a list of functions
                 self._cpp_object = _vtxwriter(
-                    comm, filename, _extract_cpp_objects(output), engine, mesh_policy
+                    comm,
+                    filename,
+                    _extract_cpp_objects(output),
+                    engine,
+                    mesh_policy,
+                    num_aggregators,
+                    engine_parameters,
                 )  # type: ignore[arg-type]
 
         def __enter__(self):
@@ -115,6 +157,56 @@ if _cpp.common.has_adios2:
         def close(self):
             self._cpp_object.close()
 
+        @property
+        def asynchronous(self) -> bool:
+            """Asynchronous output.
+
+            When ``True``, the end of each output step (flushing data to
+            file) is performed by a background thread and :func:`write`
+            returns once the data has been copied. Requires MPI with
+            ``MPI_THREAD_MULTIPLE`` support; otherwise output stays
+            synchronous.
+            """
+            return self._cpp_object.asynchronous
+
+        @asynchronous.setter
+        def asynchronous(self, value: bool):
+            self._cpp_object.asynchronous = value
+
+        @property
+        def nonblocking(self) -> bool:
+            """Non-blocking output steps.
+
+            When ``True``, an output step that the engine cannot accept
+            immediately, e.g. because the reader of an ``SST`` stream
+            lags behind, is dropped and :func:`write` returns without
+            writing data.
+            """
+            return self._cpp_object.nonblocking
+
+        @nonblocking.setter
+        def nonblocking(self, value: bool):
+            self._cpp_object.nonblocking = value
+
+        @property
+        def num_dropped_steps(self) -> int:
+            """Number of output steps dropped in non-blocking mode."""
+            return self._cpp_object.num_dropped_steps
+
+        @property
+        def output_options(self) -> VTXOutputOptions:
+            """Options to reduce the size of the output.
+
+            Single precision function values, 32-bit connectivity and
+            ADIOS2 compression operators can be selected. The options
+            must be set before the first call to :func:`write`.
+            """
+            return self._cpp_object.output_options
+
+        @output_options.setter
+        def output_options(self, options: VTXOutputOptions):
+            self._cpp_object.output_options = options
+
     class FidesWriter:
         """Writer for Fides files, using ADIOS2 to create the files.
 
@@ -135,6 +227,8 @@ if _cpp.common.has_adios2:
             output: typing.Union[Mesh, list[Function], Function],
             engine: str = "BPFile",
             mesh_policy: FidesMeshPolicy = FidesMeshPolicy.update,
+            num_aggregators: int = 0,
+            engine_parameters: typing.Optional[dict[str, str]] = None,
         ):
             """Initialize a writer for outputting a mesh, a single Lagrange
             function or list of Lagrange functions sharing the same
@@ -152,6 +246,14 @@ if _cpp.common.has_adios2:
                     written to file, or is re-written (updated) at each
                     time step. Has an effect only for ``Function``
                     output.
+                num_aggregators: Number of ranks per node that write
+                    data to file. Data of the other ranks on a node is
+                    aggregated onto these ranks by the ADIOS2 engine. If
+                    ``0``, the engine default is used.
+                engine_parameters: ADIOS2 engine parameters, e.g.
+                    ``{"RendezvousReaderCount": "0", "QueueFullPolicy":
+                    "Discard"}`` for in-situ streaming with the ``SST``
+                    engine without waiting for readers.
             """
             # Get geometry type
             try:
@@ -167,11 +269,20 @@ if _cpp.common.has_adios2:
             elif np.issubdtype(dtype, np.float64):
                 _fides_writer = _cpp.io.FidesWriter_float64
 
+            engine_parameters = {} if engine_parameters is None else engine_parameters
             try:
-                self._cpp_object = _fides_writer(comm, filename, output._cpp_object, engine)  # type: ignore
+                self._cpp_object = _fides_writer(
+                    comm, filename, output._cpp_object, engine, num_aggregators, engine_parameters
+                )  # type: ignore
             except (NotImplementedError, TypeError, AttributeError):
                 self._cpp_object = _fides_writer(
-                    comm, filename, _extract_cpp_objects(output), engine, mesh_policy
+                    comm,
+                    filename,
+                    _extract_cpp_objects(output),
+                    engine,
+                    mesh_policy,
+                    num_aggregators,
+                    engine_parameters,
                 )  # type: ignore[arg-type]
 
         def __enter__(self):
@@ -186,6 +297,302 @@ if _cpp.common.has_adios2:
         def close(self):
             self._cpp_object.close()
 
+        @property
+        def asynchronous(self) -> bool:
+            """Asynchronous output.
+
+            When ``True``, the end of each output step (flushing data to
+            file) is performed by a background thread and :func:`write`
+            returns once the data has been copied. Requires MPI with
+            ``MPI_THREAD_MULTIPLE`` support; otherwise output stays
+            synchronous.
+            """
+            return self._cpp_object.asynchronous
+
+        @asynchronous.setter
+        def asynchronous(self, value: bool):
+            self._cpp_object.asynchronous = value
+
+        @property
+        def nonblocking(self) -> bool:
+            """Non-blocking output steps.
+
+            When ``True``, an output step that the engine cannot accept
+            immediately, e.g. because the reader of an ``SST`` stream
+            lags behind, is dropped and :func:`write` returns without
+            writing data.
+            """
+            return self._cpp_object.nonblocking
+
+        @nonblocking.setter
+        def nonblocking(self, value: bool):
+            self._cpp_object.nonblocking = value
+
+        @property
+        def num_dropped_steps(self) -> int:
+            """Number of output steps dropped in non-blocking mode."""
+            return self._cpp_object.num_dropped_steps
+
+    def _checkpoint_mesh(msh) -> Mesh:
+        """Create a mesh with a UFL domain from a C++ checkpoint mesh."""
+        domain = ufl.Mesh(
+            basix.ufl.element(
+                "Lagrange",
+                msh.topology.cell_name(),
+                msh.geometry.cmap.degree,
+                basix.LagrangeVariant(msh.geometry.cmap.variant),
+                shape=(msh.geometry.dim,),
+                dtype=msh.geometry.x.dtype,
+            )
+        )
+        return Mesh(msh, domain)
+
+    def write_checkpoint(
+        comm: _MPI.Comm,
+        filename: typing.Union[str, Path],
+        mesh: Mesh,
+        functions: typing.Union[Function, list[Function], tuple[Function]] = (),
+        engine: str = "BPFile",
+        num_aggregators: int = 0,
+    ):
+        """Write a mesh and functions defined on it to a checkpoint.
+
+        The checkpoint stores the mesh and the function data in the
+        native DOLFINx layout, and can be read on the same or on a
+        different number of processes using :func:`read_checkpoint_mesh`
+        and :func:`read_checkpoint_function`.
+
+        Args:
+            comm: The MPI communicator.
+            filename: The checkpoint file name.
+            mesh: The mesh.
+            functions: Functions on ``mesh`` to write. The elements must
+                not require DOF transformations, e.g. (discontinuous)
+                Lagrange elements, and the function names must be unique.
+            engine: ADIOS2 engine to use.
+            num_aggregators: Number of ranks per node that write data to
+                file. If ``0``, the engine default is used.
+        """
+        _cpp.io.write_checkpoint(
+            comm,
+            filename,
+            mesh._cpp_object,
+            _extract_cpp_objects(functions),
+            engine,
+            num_aggregators,
+        )
+
+    def read_checkpoint_mesh(
+        comm: _MPI.Comm,
+        filename: typing.Union[str, Path],
+        ghost_mode: GhostMode = GhostMode.shared_facet,
+        dtype: npt.DTypeLike = np.float64,
+        engine: str = "BPFile",
+    ) -> Mesh:
+        """Read a mesh from a checkpoint.
+
+        When read on the same number of processes as it was written on,
+        the mesh is not repartitioned.
+
+        Args:
+            comm: The MPI communicator.
+            filename: The checkpoint file name.
+            ghost_mode: The type of cell ghosting.
+            dtype: Float type of the mesh geometry.
+            engine: ADIOS2 engine to use.
+
+        Returns:
+            The mesh.
+        """
+        if np.issubdtype(dtype, np.float32):
+            msh = _cpp.io.read_checkpoint_mesh_float32(comm, filename, ghost_mode, engine)
+        elif np.issubdtype(dtype, np.float64):
+            msh = _cpp.io.read_checkpoint_mesh_float64(comm, filename, ghost_mode, engine)
+        else:
+            raise NotImplementedError(f"Type {dtype} not supported.")
+        return _checkpoint_mesh(msh)
+
+    def read_checkpoint_function(
+        filename: typing.Union[str, Path], u: Function, name: str, engine: str = "BPFile"
+    ):
+        """Read function values from a checkpoint.
+
+        Args:
+            filename: The checkpoint file name.
+            u: The function to read the values into. The function space
+                must use the element of the written function, on a mesh
+                with the cells of the written mesh, e.g. a mesh read with
+                :func:`read_checkpoint_mesh`.
+            name: Name of the function in the checkpoint.
+            engine: ADIOS2 engine to use.
+        """
+        _cpp.io.read_checkpoint_function(filename, u._cpp_object, name, engine)
+
+    class CheckpointWriter:
+        """Writer of a sequence of checkpoints, one per ADIOS2 step.
+
+        Each call to :func:`write` writes a mesh and functions on it as
+        a new step. With the ``SST`` engine the steps are streamed to a
+        concurrently running consumer, e.g. an in-situ analysis job on a
+        smaller number of processes, which reads them with
+        :class:`CheckpointReader`.
+        """
+
+        def __init__(
+            self,
+            comm: _MPI.Comm,
+            filename: typing.Union[str, Path],
+            engine: str = "BPFile",
+            num_aggregators: int = 0,
+            engine_parameters: typing.Optional[dict[str, str]] = None,
+        ):
+            """Open a checkpoint file or stream for writing.
+
+            Args:
+                comm: The MPI communicator.
+                filename: The checkpoint file or stream name.
+                engine: ADIOS2 engine to use.
+                num_aggregators: Number of ranks per node that write data
+                    to file. If ``0``, the engine default is used.
+                engine_parameters: ADIOS2 engine parameters.
+            """
+            engine_parameters = {} if engine_parameters is None else engine_parameters
+            self._cpp_object = _cpp.io.CheckpointWriter(
+                comm, filename, engine, num_aggregators, engine_parameters
+            )
+
+        def __enter__(self):
+            return self
+
+        def __exit__(self, exception_type, exception_value, traceback):
+            self.close()
+
+        def write(
+            self,
+            mesh: Mesh,
+            functions: typing.Union[Function, list[Function], tuple[Function]] = (),
+        ):
+            """Write a mesh and functions defined on it as a new step.
+
+            Args:
+                mesh: The mesh.
+                functions: Functions on ``mesh`` to write, see
+                    :func:`write_checkpoint`.
+            """
+            self._cpp_object.write(mesh._cpp_object, _extract_cpp_objects(functions))
+
+        def close(self):
+            self._cpp_object.close()
+
+        @property
+        def nonblocking(self) -> bool:
+            """Non-blocking output steps.
+
+            When ``True``, a step that the engine cannot accept
+            immediately is dropped.
+            """
+            return self._cpp_object.nonblocking
+
+        @nonblocking.setter
+        def nonblocking(self, value: bool):
+            self._cpp_object.nonblocking = value
+
+        @property
+        def num_dropped_steps(self) -> int:
+            """Number of steps dropped in non-blocking mode."""
+            return self._cpp_object.num_dropped_steps
+
+    class CheckpointReader:
+        """Reader of a sequence of checkpoints written by
+        :class:`CheckpointWriter`.
+
+        The mesh and functions of a step can be read on a different
+        number of processes than they were written on.
+        """
+
+        def __init__(
+            self,
+            comm: _MPI.Comm,
+            filename: typing.Union[str, Path],
+            engine: str = "BPFile",
+            engine_parameters: typing.Optional[dict[str, str]] = None,
+        ):
+            """Open a checkpoint file or stream for reading.
+
+            Args:
+                comm: The MPI communicator.
+                filename: The checkpoint file or stream name.
+                engine: ADIOS2 engine to use.
+                engine_parameters: ADIOS2 engine parameters.
+            """
+            engine_parameters = {} if engine_parameters is None else engine_parameters
+            self._cpp_object = _cpp.io.CheckpointReader(comm, filename, engine, engine_parameters)
+
+        def __enter__(self):
+            return self
+
+        def __exit__(self, exception_type, exception_value, traceback):
+            self.close()
+
+        def begin_step(self, timeout: float = -1.0) -> bool:
+            """Begin reading the next step.
+
+            Args:
+                timeout: Time in seconds to wait for the next step. If
+                    negative, wait until a step is available or the
+                    stream ends.
+
+            Returns:
+                ``True`` if a step has begun, ``False`` at the end of
+                the stream (see :attr:`end_of_stream`) or if no step
+                became available within ``timeout``.
+            """
+            return self._cpp_object.begin_step(timeout)
+
+        def end_step(self):
+            """End reading the current step."""
+            self._cpp_object.end_step()
+
+        @property
+        def end_of_stream(self) -> bool:
+            """``True`` if the end of the stream has been reached."""
+            return self._cpp_object.end_of_stream
+
+        def read_mesh(
+            self,
+            ghost_mode: GhostMode = GhostMode.shared_facet,
+            dtype: npt.DTypeLike = np.float64,
+        ) -> Mesh:
+            """Read the mesh of the current step.
+
+            Args:
+                ghost_mode: The type of cell ghosting.
+                dtype: Float type of the mesh geometry.
+
+            Returns:
+                The mesh.
+            """
+            if np.issubdtype(dtype, np.float32):
+                msh = self._cpp_object.read_mesh_float32(ghost_mode)
+            elif np.issubdtype(dtype, np.float64):
+                msh = self._cpp_object.read_mesh_float64(ghost_mode)
+            else:
+                raise NotImplementedError(f"Type {dtype} not supported.")
+            return _checkpoint_mesh(msh)
+
+        def read_function(self, u: Function, name: str):
+            """Read function values of the current step.
+
+            Args:
+                u: The function to read the values into, see
+                    :func:`read_checkpoint_function`.
+                name: Name of the function in the checkpoint.
+            """
+            self._cpp_object.read_function(u._cpp_object, name)
+
+        def close(self):
+            self._cpp_object.close()
+
 
 class VTKFile(_cpp.io.VTKFile):
     """Interface to VTK files.
@@ -218,9 +625,17 @@ class XDMFFile(_cpp.io.XDMFFile):
     def __exit__(self, exception_type, exception_value, traceback):
         self.close()
 
-    def write_mesh(self, mesh: Mesh, xpath: str = "/Xdmf/Domain") -> None:
-        """Write mesh to file"""
-        super().write_mesh(mesh._cpp_object, xpath)
+    def write_mesh(self, mesh: Mesh, xpath: str = "/Xdmf/Domain", partition: bool = False) -> None:
+        """Write mesh to file.
+
+        Args:
+            mesh: The mesh to write.
+            xpath: XPath where the mesh Grid will be written.
+            partition: If ``True``, store the owning rank of each cell.
+                :func:`read_mesh` then skips graph partitioning when the
+                mesh is read on the same number of processes.
+        """
+        super().write_mesh(mesh._cpp_object, xpath, partition)
 
     def write_meshtags(
         self,
@@ -238,10 +653,12 @@ class XDMFFile(_cpp.io.XDMFFile):
         """Write function to file for a given time.
 
         Note:
-            Function is interpolated onto the mesh nodes, as a Nth order
-            Lagrange function, where N is the order of the coordinate
-            map. If the Function is a cell-wise constant, it is saved as
-            a cell-wise constant.
+            The Function must be a (discontinuous) Lagrange function. If
+            its dofs are the mesh nodes, its values are attached to the
+            mesh, and if it is a cell-wise constant, it is saved as a
+            cell-wise constant. Otherwise one value per dof is saved on
+            a grid of the dofs, with a cell type of the degree of the
+            Function, which is written with the first time step.
 
         Args:
             u: Function to write to file.
@@ -259,11 +676,15 @@ class XDMFFile(_cpp.io.XDMFFile):
         cells = super().read_topology_data(name, xpath)
         x = super().read_geometry_data(name, xpath)
 
-        # Build the mesh
+        # Build the mesh, using the stored partition if the number of
+        # processes is unchanged
+        owners, num_parts = super().read_partition(name, xpath)
+        if num_parts == self.comm.size:
+            partitioner = _cpp.mesh.create_precomputed_cell_partitioner(ghost_mode, owners)
+        else:
+            partitioner = _cpp.mesh.create_cell_partitioner(ghost_mode)
         cmap = _cpp.fem.CoordinateElement_float64(cell_shape, cell_degree)
-        msh = _cpp.mesh.create_mesh(
-            self.comm, cells, cmap, x, _cpp.mesh.create_cell_partitioner(ghost_mode)
-        )
+        msh = _cpp.mesh.create_mesh(self.comm, cells, cmap, x, partitioner)
         msh.name = name
         domain = ufl.Mesh(
             basix.ufl.element(
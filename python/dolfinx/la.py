@@ -256,6 +256,24 @@ class Vector:
         """Local representation of the vector."""
         return self._cpp_object.array
 
+    @property
+    def version(self) -> int:
+        """Modification counter of the vector.
+
+        The counter is incremented when the vector entries can be
+        modified, e.g. when :attr:`array` is accessed.
+        """
+        return self._cpp_object.version
+
+    def mark_modified(self) -> None:
+        """Increment the version of the vector.
+
+        Call after modifying entries through an array that was obtained
+        before the version was last recorded, or through the PETSc
+        vector that wraps the array.
+        """
+        self._cpp_object.mark_modified()
+
     @property
     def petsc_vec(self):
         """PETSc vector holding the entries of the vector.
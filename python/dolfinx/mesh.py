@@ -62,6 +62,8 @@ __all__ = [
     "to_string",
     "refine_interval",
     "refine_plaza",
+    "create_hierarchy",
+    "coarsen",
     "transfer_meshtag",
     "entities_to_geometry",
 ]
@@ -371,6 +373,7 @@ def refine_plaza(
     edges: typing.Optional[np.ndarray] = None,
     redistribute: bool = True,
     option: RefinementOption = RefinementOption.none,
+    num_threads: int = 1,
 ) -> tuple[Mesh, npt.NDArray[np.int32], npt.NDArray[np.int32]]:
     """Refine a mesh.
 
@@ -382,19 +385,88 @@ def refine_plaza(
             Refined mesh is re-partitioned if ``True``.
         option:
             Control computation of the parent-refined mesh data.
+        num_threads:
+            Number of threads used to compute the process-local
+            refinement. The result does not depend on the number of
+            threads.
 
     Returns:
        Refined mesh, list of parent cell for each refine cell, and list
     """
     if edges is None:
-        mesh1, cells, facets = _cpp.refinement.refine_plaza(mesh._cpp_object, redistribute, option)
+        mesh1, cells, facets = _cpp.refinement.refine_plaza(
+            mesh._cpp_object, redistribute, option, num_threads
+        )
     else:
         mesh1, cells, facets = _cpp.refinement.refine_plaza(
-            mesh._cpp_object, edges, redistribute, option
+            mesh._cpp_object, edges, redistribute, option, num_threads
         )
     return Mesh(mesh1, mesh._ufl_domain), cells, facets
 
 
+def coarsen(
+    mesh0: Mesh,
+    mesh1: Mesh,
+    parent_cell: npt.NDArray[np.int32],
+    cells: npt.NDArray[np.int32],
+    redistribute: bool = True,
+    option: RefinementOption = RefinementOption.none,
+) -> tuple[Mesh, npt.NDArray[np.int32], npt.NDArray[np.int8]]:
+    """Coarsen a refined mesh by merging marked cells into their parents.
+
+    A parent cell is restored if all of its child cells are marked. The
+    coarsened mesh is created by refining ``mesh0`` again with fewer
+    edges, so it is conforming.
+
+    Args:
+        mesh0: Parent mesh.
+        mesh1: Mesh refined from ``mesh0`` by :func:`refine_plaza`
+            without redistribution.
+        parent_cell: Parent cell of each cell of ``mesh1``.
+        cells: Cells of ``mesh1`` marked for coarsening.
+        redistribute: Coarsened mesh is re-partitioned if ``True``.
+        option: Control computation of the parent data with respect to
+            ``mesh0``.
+
+    Returns:
+        Coarsened mesh, parent cell of each coarsened cell in ``mesh0``
+        and parent facets.
+    """
+    mesh2, cells2, facets2 = _cpp.refinement.coarsen(
+        mesh0._cpp_object,
+        mesh1._cpp_object,
+        parent_cell,
+        np.asarray(cells, dtype=np.int32),
+        redistribute,
+        option,
+    )
+    return Mesh(mesh2, mesh0._ufl_domain), cells2, facets2
+
+
+def create_hierarchy(
+    mesh: Mesh, levels: int, num_threads: int = 1
+) -> tuple[list[Mesh], list[npt.NDArray[np.int32]]]:
+    """Create a hierarchy of uniformly refined meshes.
+
+    Each level is refined from the previous level without
+    redistribution, so refined cells stay on the process of their
+    parent cell.
+
+    Args:
+        mesh: Coarsest mesh. Its edges must have been created.
+        levels: Number of refinements.
+        num_threads: Number of threads used to refine each level.
+
+    Returns:
+        All meshes from coarsest (``mesh``) to finest, and for each
+        refined mesh the parent cell of each cell in the previous level,
+        e.g. for creating :class:`dolfinx.fem.RefinementTransfer`
+        operators.
+    """
+    meshes, parent_cells = _cpp.refinement.create_hierarchy(mesh._cpp_object, levels, num_threads)
+    return [mesh] + [Mesh(m, mesh._ufl_domain) for m in meshes], list(parent_cells)
+
+
 def create_mesh(
     comm: _MPI.Comm,
     cells: npt.NDArray[np.int64],
@@ -25,8 +25,18 @@ __all__ = ["NewtonSolver"]
 
 
 class NewtonSolver(_cpp.nls.petsc.NewtonSolver):
-    def __init__(self, comm: MPI.Intracomm, problem: NonlinearProblem):
-        """A Newton solver for non-linear problems."""
+    def __init__(
+        self, comm: MPI.Intracomm, problem: NonlinearProblem, fused_assembly: bool = False
+    ):
+        """A Newton solver for non-linear problems.
+
+        Args:
+            comm: The MPI communicator
+            problem: The non-linear problem
+            fused_assembly: If ``True``, the residual and Jacobian are
+                assembled in one pass over the cells when both are
+                required (uses ``problem.FJ``).
+        """
         super().__init__(comm)
 
         # Create matrix and vector to be used for assembly
@@ -35,6 +45,8 @@ class NewtonSolver(_cpp.nls.petsc.NewtonSolver):
         self.setJ(problem.J, self._A)
         self._b = create_vector(problem.L)
         self.setF(problem.F, self._b)
+        if fused_assembly:
+            self.setFJ(problem.FJ, self._b, self._A)
         self.set_form(problem.form)
 
     def __del__(self):
@@ -10,6 +10,8 @@
 #include <complex>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/AssemblyPlan.h>
+#include <dolfinx/fem/CoefficientCache.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -83,7 +85,7 @@ void declare_discrete_operators(nb::module_& m)
 {
   m.def("interpolation_matrix",
         [](const dolfinx::fem::FunctionSpace<U>& V0,
-           const dolfinx::fem::FunctionSpace<U>& V1)
+           const dolfinx::fem::FunctionSpace<U>& V1, int num_threads)
         {
           // Create sparsity
           auto sp = create_sparsity(V0, V1);
@@ -95,37 +97,37 @@ void declare_discrete_operators(nb::module_& m)
           if (bs0 == 1 and bs1 == 1)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<1, 1>());
+                V0, V1, A.template mat_set_values<1, 1>(), num_threads);
           }
           else if (bs0 == 2 and bs1 == 1)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<2, 1>());
+                V0, V1, A.template mat_set_values<2, 1>(), num_threads);
           }
           else if (bs0 == 1 and bs1 == 2)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<1, 2>());
+                V0, V1, A.template mat_set_values<1, 2>(), num_threads);
           }
           else if (bs0 == 2 and bs1 == 2)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<2, 2>());
+                V0, V1, A.template mat_set_values<2, 2>(), num_threads);
           }
           else if (bs0 == 3 and bs1 == 1)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<3, 1>());
+                V0, V1, A.template mat_set_values<3, 1>(), num_threads);
           }
           else if (bs0 == 1 and bs1 == 3)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<1, 3>());
+                V0, V1, A.template mat_set_values<1, 3>(), num_threads);
           }
           else if (bs0 == 3 and bs1 == 3)
           {
             dolfinx::fem::interpolation_matrix<T, U>(
-                V0, V1, A.template mat_set_values<3, 3>());
+                V0, V1, A.template mat_set_values<3, 3>(), num_threads);
           }
           else
           {
@@ -135,23 +137,16 @@ void declare_discrete_operators(nb::module_& m)
           }
 
           return A;
-        });
+        },
+        nb::arg("V0"), nb::arg("V1"), nb::arg("num_threads") = 1,
+        nb::call_guard<nb::gil_scoped_release>());
 
   m.def(
       "discrete_gradient",
       [](const dolfinx::fem::FunctionSpace<U>& V0,
          const dolfinx::fem::FunctionSpace<U>& V1)
-      {
-        auto sp = create_sparsity(V0, V1);
-
-        // Build operator
-        dolfinx::la::MatrixCSR<T> A(sp);
-        dolfinx::fem::discrete_gradient<T, U>(
-            *V0.mesh()->topology_mutable(), {*V0.element(), *V0.dofmap()},
-            {*V1.element(), *V1.dofmap()}, A.mat_set_values());
-        return A;
-      },
-      nb::arg("V0"), nb::arg("V1"));
+      { return dolfinx::fem::discrete_gradient<T, U>(V0, V1); },
+      nb::arg("V0"), nb::arg("V1"), nb::call_guard<nb::gil_scoped_release>());
 }
 
 // Declare assembler function that have multiple scalar types
@@ -161,14 +156,17 @@ void declare_assembly_functions(nb::module_& m)
   // Coefficient/constant packing
   m.def(
       "pack_coefficients",
-      [](const dolfinx::fem::Form<T, U>& form)
+      [](const dolfinx::fem::Form<T, U>& form, int num_threads)
       {
         using Key_t = typename std::pair<dolfinx::fem::IntegralType, int>;
 
         // Pack coefficients
-        std::map<Key_t, std::pair<std::vector<T>, int>> coeffs
-            = dolfinx::fem::allocate_coefficient_storage(form);
-        dolfinx::fem::pack_coefficients(form, coeffs);
+        std::map<Key_t, std::pair<std::vector<T>, int>> coeffs;
+        {
+          nb::gil_scoped_release release;
+          coeffs = dolfinx::fem::allocate_coefficient_storage(form);
+          dolfinx::fem::pack_coefficients(form, coeffs, num_threads);
+        }
 
         // Move into NumPy data structures
         std::map<Key_t, nb::ndarray<T, nb::numpy>> c;
@@ -190,7 +188,41 @@ void declare_assembly_functions(nb::module_& m)
 
         return c;
       },
-      nb::arg("form"), "Pack coefficients for a Form.");
+      nb::arg("form"), nb::arg("num_threads") = 1,
+      "Pack coefficients for a Form.");
+  m.def(
+      "pack_coefficients",
+      [](const dolfinx::fem::Form<T, U>& form,
+         std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                  nb::ndarray<T, nb::ndim<2>, nb::c_contig>>& coeffs,
+         int num_threads)
+      {
+        // Check the arrays before releasing the GIL
+        std::map<std::pair<dolfinx::fem::IntegralType, int>,
+                 std::pair<std::span<T>, int>>
+            c;
+        for (auto& [key, array] : coeffs)
+        {
+          auto [type, id] = key;
+          auto [num_ents, cstride]
+              = dolfinx::fem::coefficient_storage_shape(form, type, id);
+          if (array.shape(0) != num_ents or array.shape(1) != cstride)
+          {
+            throw std::runtime_error("Coefficient array has the wrong shape.");
+          }
+          c.emplace(key, std::pair(std::span(array.data(), array.size()),
+                                   static_cast<int>(cstride)));
+        }
+
+        nb::gil_scoped_release release;
+        for (auto& [key, val] : c)
+        {
+          dolfinx::fem::pack_coefficients(form, key.first, key.second,
+                                          val.first, val.second, num_threads);
+        }
+      },
+      nb::arg("form"), nb::arg("coeffs"), nb::arg("num_threads") = 1,
+      "Pack coefficients for a Form into preallocated arrays.");
   m.def(
       "pack_constants",
       [](const dolfinx::fem::Form<T, U>& form) {
@@ -216,8 +248,22 @@ void declare_assembly_functions(nb::module_& m)
             py_to_cpp_coeffs(coefficients));
       },
       nb::arg("M"), nb::arg("constants"), nb::arg("coefficients"),
+      nb::call_guard<nb::gil_scoped_release>(),
       "Assemble functional over mesh with provided constants and "
       "coefficients");
+  m.def(
+      "assemble_scalars",
+      [](const std::vector<std::shared_ptr<const dolfinx::fem::Form<T, U>>>&
+             forms)
+      {
+        std::vector<const dolfinx::fem::Form<T, U>*> M;
+        for (auto& form : forms)
+          M.push_back(form.get());
+        return dolfinx_wrappers::as_nbarray(
+            dolfinx::fem::assemble_scalars<T, U>(M));
+      },
+      nb::arg("forms"), nb::call_guard<nb::gil_scoped_release>(),
+      "Assemble several functionals over mesh in one pass.");
   // Vector
   m.def(
       "assemble_vector",
@@ -234,6 +280,7 @@ void declare_assembly_functions(nb::module_& m)
             py_to_cpp_coeffs(coefficients));
       },
       nb::arg("b"), nb::arg("L"), nb::arg("constants"), nb::arg("coeffs"),
+      nb::call_guard<nb::gil_scoped_release>(),
       "Assemble linear form into an existing vector with pre-packed constants "
       "and coefficients");
   // MatrixCSR
@@ -322,7 +369,18 @@ void declare_assembly_functions(nb::module_& m)
           throw std::runtime_error("Block size not supported in Python");
       },
       nb::arg("A"), nb::arg("a"), nb::arg("constants"), nb::arg("coeffs"),
-      nb::arg("bcs"), "Experimental.");
+      nb::arg("bcs"), nb::call_guard<nb::gil_scoped_release>(),
+      "Experimental.");
+  m.def(
+      "assemble_diagonal",
+      [](dolfinx::la::Vector<T>& diag, const dolfinx::fem::Form<T, U>& a,
+         const std::vector<
+             std::shared_ptr<const dolfinx::fem::DirichletBC<T, U>>>& bcs,
+         T diagonal, int num_threads)
+      { dolfinx::fem::assemble_diagonal(diag, a, bcs, diagonal, num_threads); },
+      nb::arg("diag"), nb::arg("a"), nb::arg("bcs"), nb::arg("diagonal"),
+      nb::arg("num_threads") = 1, nb::call_guard<nb::gil_scoped_release>(),
+      "Assemble the diagonal of a bilinear form into a vector.");
   m.def(
       "insert_diagonal",
       [](dolfinx::la::MatrixCSR<T>& A, const dolfinx::fem::FunctionSpace<U>& V,
@@ -411,6 +469,7 @@ void declare_assembly_functions(nb::module_& m)
       },
       nb::arg("b").noconvert(), nb::arg("a"), nb::arg("constants"),
       nb::arg("coeffs"), nb::arg("bcs1"), nb::arg("x0"), nb::arg("scale"),
+      nb::call_guard<nb::gil_scoped_release>(),
       "Modify vector for lifted boundary conditions");
   m.def(
       "set_bc",
@@ -423,7 +482,7 @@ void declare_assembly_functions(nb::module_& m)
                                 std::span(x0.data(), x0.shape(0)), scale);
       },
       nb::arg("b").noconvert(), nb::arg("bcs"), nb::arg("x0").noconvert(),
-      nb::arg("scale"));
+      nb::arg("scale"), nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "set_bc",
       [](nb::ndarray<T, nb::ndim<1>, nb::c_contig> b,
@@ -431,7 +490,8 @@ void declare_assembly_functions(nb::module_& m)
              std::shared_ptr<const dolfinx::fem::DirichletBC<T, U>>>& bcs,
          T scale)
       { dolfinx::fem::set_bc<T>(std::span(b.data(), b.size()), bcs, scale); },
-      nb::arg("b").noconvert(), nb::arg("bcs"), nb::arg("scale"));
+      nb::arg("b").noconvert(), nb::arg("bcs"), nb::arg("scale"),
+      nb::call_guard<nb::gil_scoped_release>());
 }
 
 } // namespace
@@ -439,6 +499,65 @@ void declare_assembly_functions(nb::module_& m)
 namespace dolfinx_wrappers
 {
 
+template <typename T, typename U>
+void declare_coefficient_cache(nb::module_& m, std::string type)
+{
+  using cache_t = dolfinx::fem::CoefficientCache<T, U>;
+  std::string pyclass_name = std::string("CoefficientCache_") + type;
+  nb::class_<cache_t>(m, pyclass_name.c_str(),
+                      "Packed form coefficients that are repacked only "
+                      "when the coefficients change")
+      .def(nb::init<std::shared_ptr<const dolfinx::fem::Form<T, U>>, int>(),
+           nb::arg("form"), nb::arg("num_threads") = 1)
+      .def("update", &cache_t::update, nb::arg("num_threads") = 1,
+           nb::call_guard<nb::gil_scoped_release>(),
+           "Repack the coefficients that have changed. Returns the number "
+           "of repacked coefficients.")
+      .def_prop_ro(
+          "coefficients",
+          [](const cache_t& self)
+          {
+            // Views into the cache data, which keep the cache alive
+            using Key_t = typename std::pair<dolfinx::fem::IntegralType, int>;
+            std::map<Key_t, nb::ndarray<T, nb::numpy>> c;
+            nb::handle owner = nb::find(&self);
+            for (auto& [key, val] : self.data())
+            {
+              std::size_t num_ents
+                  = val.first.empty() ? 0 : val.first.size() / val.second;
+              c.emplace(key,
+                        nb::ndarray<T, nb::numpy>(
+                            const_cast<T*>(val.first.data()),
+                            {num_ents, static_cast<std::size_t>(val.second)},
+                            owner));
+            }
+            return c;
+          })
+      .def_prop_ro("form", &cache_t::form);
+}
+
+template <typename T, typename U>
+void declare_assembly_plan(nb::module_& m, std::string type)
+{
+  using plan_t = dolfinx::fem::AssemblyPlan<T, U>;
+  std::string pyclass_name = std::string("AssemblyPlan_") + type;
+  nb::class_<plan_t>(m, pyclass_name.c_str(),
+                     "Data for repeated assembly of a bilinear form into a "
+                     "MatrixCSR")
+      .def(nb::init<std::shared_ptr<const dolfinx::fem::Form<T, U>>,
+                    const std::vector<std::shared_ptr<
+                        const dolfinx::fem::DirichletBC<T, U>>>&,
+                    int>(),
+           nb::arg("form"), nb::arg("bcs"), nb::arg("num_threads") = 1)
+      .def("assemble", &plan_t::assemble, nb::arg("A"),
+           nb::arg("diagonal") = T(1),
+           nb::call_guard<nb::gil_scoped_release>(),
+           "Assemble the form into a matrix.")
+      .def("reset", &plan_t::reset,
+           "Discard the recorded matrix entry positions.")
+      .def_prop_ro("form", &plan_t::form);
+}
+
 void assemble(nb::module_& m)
 {
   // dolfinx::fem::assemble
@@ -447,6 +566,16 @@ void assemble(nb::module_& m)
   declare_assembly_functions<std::complex<float>, float>(m);
   declare_assembly_functions<std::complex<double>, double>(m);
 
+  declare_coefficient_cache<float, float>(m, "float32");
+  declare_coefficient_cache<double, double>(m, "float64");
+  declare_coefficient_cache<std::complex<float>, float>(m, "complex64");
+  declare_coefficient_cache<std::complex<double>, double>(m, "complex128");
+
+  declare_assembly_plan<float, float>(m, "float32");
+  declare_assembly_plan<double, double>(m, "float64");
+  declare_assembly_plan<std::complex<float>, float>(m, "complex64");
+  declare_assembly_plan<std::complex<double>, double>(m, "complex128");
+
   declare_discrete_operators<float, float>(m);
   declare_discrete_operators<double, double>(m);
   declare_discrete_operators<std::complex<float>, float>(m);
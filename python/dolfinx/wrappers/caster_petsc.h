@@ -10,6 +10,7 @@
 
 #include <nanobind/nanobind.h>
 #include <petsc4py/petsc4py.h>
+#include <petscksp.h>
 #include <petscmat.h>
 #include <petscvec.h>
 
@@ -80,5 +81,6 @@ namespace nanobind::detail
 {
 PETSC_CASTER_MACRO(Mat, Mat, mat);
 PETSC_CASTER_MACRO(Vec, Vec, vec);
+PETSC_CASTER_MACRO(KSP, KSP, ksp);
 } // namespace nanobind::detail
 #endif
@@ -24,7 +24,9 @@
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/Scatterer.h>
 #include <dolfinx/common/Table.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
+#include <dolfinx/common/profiler.h>
 #include <dolfinx/common/timing.h>
 #include <dolfinx/common/utils.h>
 
@@ -177,6 +179,27 @@ void common(nb::module_& m)
       },
       nb::arg("comm"), nb::arg("type"), nb::arg("reduction"));
 
+  m.def("enable_profile_trace", &dolfinx::common::profiler::enable_trace,
+        nb::arg("state"));
+  m.def("reset_profile", &dolfinx::common::profiler::reset);
+  m.def(
+      "write_profile_trace",
+      [](MPICommWrapper comm, const std::string& filename)
+      { dolfinx::common::profiler::write_trace(comm.get(), filename); },
+      nb::arg("comm"), nb::arg("filename"));
+  m.def("enable_comm_profiling", &dolfinx::common::profiler::enable_comm,
+        nb::arg("state"));
+  m.def(
+      "write_comm_matrix",
+      [](MPICommWrapper comm, const std::string& filename)
+      { dolfinx::common::profiler::write_comm_matrix(comm.get(), filename); },
+      nb::arg("comm"), nb::arg("filename"));
+
+  m.def("set_num_threads", &dolfinx::common::set_num_threads,
+        nb::arg("num_threads"));
+  m.def("num_threads", &dolfinx::common::num_threads);
+  m.def("check_mpi_thread_level", &dolfinx::common::check_mpi_thread_level);
+
   m.def(
       "init_logging",
       [](std::vector<std::string> args)
@@ -98,7 +98,19 @@ void declare_function_space(nb::module_& m, std::string type)
                std::vector x = self.tabulate_dof_coordinates(false);
                return dolfinx_wrappers::as_nbarray(std::move(x),
                                                    {x.size() / 3, 3});
-             });
+             })
+        .def(
+            "tabulate_dof_coordinates",
+            [](const dolfinx::fem::FunctionSpace<T>& self,
+               nb::ndarray<T, nb::ndim<2>, nb::c_contig> out)
+            {
+              nb::gil_scoped_release release;
+              std::vector x = self.tabulate_dof_coordinates(false);
+              if (out.shape(0) != x.size() / 3 or out.shape(1) != 3)
+                throw std::runtime_error("Array has the wrong shape.");
+              std::ranges::copy(x, out.data());
+            },
+            nb::arg("out"));
   }
 
   {
@@ -366,7 +378,23 @@ void declare_objects(nb::module_& m, const std::string& type)
            })
       .def_prop_ro("function_space",
                    &dolfinx::fem::DirichletBC<T, U>::function_space)
-      .def_prop_ro("value", &dolfinx::fem::DirichletBC<T, U>::value);
+      .def_prop_ro("value", &dolfinx::fem::DirichletBC<T, U>::value)
+      .def_prop_ro(
+          "dof_coordinates",
+          [](const dolfinx::fem::DirichletBC<T, U>& self)
+          {
+            std::span<const U> x = self.dof_coordinates();
+            return nb::ndarray<const U, nb::numpy>(x.data(), {3, x.size() / 3},
+                                                   nb::handle());
+          },
+          nb::rv_policy::reference_internal)
+      .def(
+          "set_values",
+          [](dolfinx::fem::DirichletBC<T, U>& self,
+             nb::ndarray<const T, nb::c_contig> values)
+          { self.set_values(std::span(values.data(), values.size())); },
+          nb::arg("values"))
+      .def("reset_values", &dolfinx::fem::DirichletBC<T, U>::reset_values);
 
   // dolfinx::fem::Function
   std::string pyclass_name_function = std::string("Function_") + type;
@@ -391,7 +419,9 @@ void declare_objects(nb::module_& m, const std::string& type)
                                       {1, f.size()},
                                       std::span(cells.data(), cells.size()));
           },
-          nb::arg("f"), nb::arg("cells"), "Interpolate an expression function")
+          nb::arg("f"), nb::arg("cells"),
+          nb::call_guard<nb::gil_scoped_release>(),
+          "Interpolate an expression function")
       .def(
           "interpolate",
           [](dolfinx::fem::Function<T, U>& self,
@@ -402,7 +432,9 @@ void declare_objects(nb::module_& m, const std::string& type)
                                       {f.shape(0), f.shape(1)},
                                       std::span(cells.data(), cells.size()));
           },
-          nb::arg("f"), nb::arg("cells"), "Interpolate an expression function")
+          nb::arg("f"), nb::arg("cells"),
+          nb::call_guard<nb::gil_scoped_release>(),
+          "Interpolate an expression function")
       .def(
           "interpolate",
           [](dolfinx::fem::Function<T, U>& self,
@@ -414,6 +446,7 @@ void declare_objects(nb::module_& m, const std::string& type)
                              std::span(cells1.data(), cells1.size()));
           },
           nb::arg("u"), nb::arg("cells0"), nb::arg("cells1"),
+          nb::call_guard<nb::gil_scoped_release>(),
           "Interpolate a finite element function")
       .def(
           "interpolate",
@@ -426,7 +459,32 @@ void declare_objects(nb::module_& m, const std::string& type)
                              interpolation_data);
           },
           nb::arg("u"), nb::arg("cells"), nb::arg("interpolation_data"),
+          nb::call_guard<nb::gil_scoped_release>(),
           "Interpolate a finite element function on non-matching meshes")
+      .def(
+          "interpolate",
+          [](dolfinx::fem::Function<T, U>& self,
+             dolfinx::fem::Function<T, U>& u,
+             nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells,
+             const dolfinx::fem::NonmatchingInterpolationPlan<U>& plan)
+          { self.interpolate(u, std::span(cells.data(), cells.size()), plan); },
+          nb::arg("u"), nb::arg("cells"), nb::arg("plan"),
+          nb::call_guard<nb::gil_scoped_release>(),
+          "Interpolate a finite element function on non-matching meshes "
+          "using an interpolation plan")
+      .def(
+          "interpolate",
+          [](dolfinx::fem::Function<T, U>& self,
+             nb::ndarray<const T, nb::ndim<2>, nb::c_contig> f,
+             const dolfinx::fem::Interpolator<U>& interpolator)
+          {
+            dolfinx::fem::interpolate(self, std::span(f.data(), f.size()),
+                                      {f.shape(0), f.shape(1)}, interpolator);
+          },
+          nb::arg("f"), nb::arg("interpolator"),
+          nb::call_guard<nb::gil_scoped_release>(),
+          "Interpolate an expression function using cached interpolation "
+          "operators")
       .def(
           "interpolate_ptr",
           [](dolfinx::fem::Function<T, U>& self, std::uintptr_t addr,
@@ -469,6 +527,7 @@ void declare_objects(nb::module_& m, const std::string& type)
                              std::span(cells1.data(), cells1.size()));
           },
           nb::arg("e0"), nb::arg("cells0"), nb::arg("cells1"),
+          nb::call_guard<nb::gil_scoped_release>(),
           "Interpolate an Expression on a set of cells")
       .def_prop_ro(
           "x", nb::overload_cast<>(&dolfinx::fem::Function<T, U>::x),
@@ -488,6 +547,27 @@ void declare_objects(nb::module_& m, const std::string& type)
           },
           nb::arg("x"), nb::arg("cells"), nb::arg("values"),
           "Evaluate Function")
+      .def(
+          "eval",
+          [](const dolfinx::fem::Function<T, U>& self,
+             const dolfinx::fem::EvaluationPlan<U>& plan,
+             nb::ndarray<T, nb::ndim<2>, nb::c_contig> u, int num_threads)
+          {
+            self.eval(plan, std::span<T>(u.data(), u.size()), num_threads);
+          },
+          nb::arg("plan"), nb::arg("values"), nb::arg("num_threads"),
+          "Evaluate Function using an evaluation plan")
+      .def(
+          "eval",
+          [](const dolfinx::fem::Function<T, U>& self,
+             const dolfinx::fem::DistributedEvaluationPlan<U>& plan,
+             nb::ndarray<T, nb::ndim<2>, nb::c_contig> u, int num_threads)
+          {
+            self.eval(plan, std::span<T>(u.data(), u.size()), num_threads);
+          },
+          nb::arg("plan"), nb::arg("values"), nb::arg("num_threads"),
+          "Evaluate Function at points on any process using an evaluation "
+          "plan")
       .def_prop_ro("function_space",
                    &dolfinx::fem::Function<T, U>::function_space);
 
@@ -552,13 +632,16 @@ void declare_objects(nb::module_& m, const std::string& type)
           [](const dolfinx::fem::Expression<T, U>& self,
              const dolfinx::mesh::Mesh<U>& mesh,
              nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells,
-             nb::ndarray<T, nb::ndim<2>, nb::c_contig> values)
+             nb::ndarray<T, nb::ndim<2>, nb::c_contig> values,
+             std::size_t tile_size, int num_threads)
           {
             std::span<T> foo(values.data(), values.size());
             self.eval(mesh, std::span(cells.data(), cells.size()), foo,
-                      {values.shape(0), values.shape(1)});
+                      {values.shape(0), values.shape(1)}, tile_size,
+                      num_threads);
           },
-          nb::arg("mesh"), nb::arg("active_cells"), nb::arg("values"))
+          nb::arg("mesh"), nb::arg("active_cells"), nb::arg("values"),
+          nb::arg("tile_size") = 1024, nb::arg("num_threads") = 1)
       .def("X",
            [](const dolfinx::fem::Expression<T, U>& self)
            {
@@ -833,6 +916,7 @@ void declare_form(nb::module_& m, std::string type)
 
   m.def("create_sparsity_pattern",
         &dolfinx::fem ::create_sparsity_pattern<T, U>, nb::arg("a"),
+        nb::arg("num_threads") = 1,
         "Create a sparsity pattern.");
 }
 
@@ -972,20 +1056,21 @@ void declare_real_functions(nb::module_& m)
       "create_dofmap",
       [](const dolfinx_wrappers::MPICommWrapper comm,
          dolfinx::mesh::Topology& topology,
-         const dolfinx::fem::FiniteElement<T>& element)
+         std::shared_ptr<const dolfinx::fem::FiniteElement<T>> element)
       {
         dolfinx::fem::ElementDofLayout layout
-            = dolfinx::fem::create_element_dof_layout(element);
+            = dolfinx::fem::create_element_dof_layout(*element);
 
         std::function<void(std::span<std::int32_t>, std::uint32_t)> permute_inv
             = nullptr;
-        if (element.needs_dof_permutations())
-          permute_inv = element.dof_permutation_fn(true, true);
-        return dolfinx::fem::create_dofmap(comm.get(), layout, topology,
-                                           permute_inv, nullptr);
+        if (element->needs_dof_permutations())
+          permute_inv = element->dof_permutation_fn(true, true);
+        return dolfinx::fem::create_shared_dofmap(comm.get(), topology, element,
+                                                  layout, permute_inv);
       },
       nb::arg("comm"), nb::arg("topology"), nb::arg("element"),
-      "Create DofMap object from an element.");
+      "Create DofMap object from an element, shared with identical "
+      "elements on the same topology.");
   m.def(
       "create_dofmaps",
       [](const dolfinx_wrappers::MPICommWrapper comm,
@@ -1090,6 +1175,77 @@ void declare_real_functions(nb::module_& m)
             dolfinx::fem::locate_dofs_geometrical(V, _marker));
       },
       nb::arg("V"), nb::arg("marker"));
+  m.def(
+      "locate_dofs_geometrical",
+      [](const std::vector<
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>>>& V,
+         std::function<nb::ndarray<bool, nb::ndim<1>, nb::c_contig>(
+             nb::ndarray<const T, nb::ndim<2>, nb::numpy>)>
+             marker,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells)
+      {
+        if (V.size() != 2)
+          throw std::runtime_error("Expected two function spaces.");
+
+        auto _marker = [&marker](auto x)
+        {
+          nb::ndarray<const T, nb::ndim<2>, nb::numpy> x_view(
+              x.data_handle(), {x.extent(0), x.extent(1)}, nb::handle());
+          auto marked = marker(x_view);
+          return std::vector<std::int8_t>(marked.data(),
+                                          marked.data() + marked.size());
+        };
+
+        std::array<std::vector<std::int32_t>, 2> dofs
+            = dolfinx::fem::locate_dofs_geometrical<T>(
+                {*V[0], *V[1]}, _marker,
+                std::span(cells.data(), cells.size()));
+        return std::array<nb::ndarray<std::int32_t, nb::numpy>, 2>(
+            {dolfinx_wrappers::as_nbarray(std::move(dofs[0])),
+             dolfinx_wrappers::as_nbarray(std::move(dofs[1]))});
+      },
+      nb::arg("V"), nb::arg("marker"), nb::arg("cells"));
+  m.def(
+      "locate_dofs_geometrical",
+      [](const dolfinx::fem::FunctionSpace<T>& V,
+         std::function<nb::ndarray<bool, nb::ndim<1>, nb::c_contig>(
+             nb::ndarray<const T, nb::ndim<2>, nb::numpy>)>
+             marker,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells)
+      {
+        auto _marker = [&marker](auto x)
+        {
+          nb::ndarray<const T, nb::ndim<2>, nb::numpy> x_view(
+              x.data_handle(), {x.extent(0), x.extent(1)}, nb::handle());
+          auto marked = marker(x_view);
+          return std::vector<std::int8_t>(marked.data(),
+                                          marked.data() + marked.size());
+        };
+
+        return dolfinx_wrappers::as_nbarray(
+            dolfinx::fem::locate_dofs_geometrical(
+                V, _marker, std::span(cells.data(), cells.size())));
+      },
+      nb::arg("V"), nb::arg("marker"), nb::arg("cells"));
+  m.def(
+      "locate_dofs_topological",
+      [](const dolfinx::fem::FunctionSpace<T>& V,
+         const dolfinx::mesh::MeshTags<std::int32_t>& tags,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> values,
+         bool remote)
+      {
+        std::vector<std::vector<std::int32_t>> dofs
+            = dolfinx::fem::locate_dofs_topological(
+                *V.mesh()->topology_mutable(), *V.dofmap(), tags,
+                std::span(values.data(), values.size()), remote);
+        std::vector<nb::ndarray<std::int32_t, nb::numpy>> out;
+        out.reserve(dofs.size());
+        for (auto& d : dofs)
+          out.push_back(dolfinx_wrappers::as_nbarray(std::move(d)));
+        return out;
+      },
+      nb::arg("V"), nb::arg("tags"), nb::arg("values"),
+      nb::arg("remote") = true);
 
   m.def(
       "interpolation_coords",
@@ -1117,6 +1273,109 @@ void declare_real_functions(nb::module_& m)
       },
       nb::arg("geometry0"), nb::arg("element0"), nb::arg("mesh1"),
       nb::arg("cells"), nb ::arg("padding"));
+
+  using plan_t = dolfinx::fem::NonmatchingInterpolationPlan<T>;
+  std::string pyclass_name_plan
+      = std::string("NonmatchingInterpolationPlan_")
+        + (std::is_same_v<T, float> ? "float32" : "float64");
+  nb::class_<plan_t>(
+      m, pyclass_name_plan.c_str(),
+      "Plan for repeated interpolation between non-matching meshes")
+      .def(nb::init<std::shared_ptr<const dolfinx::fem::FunctionSpace<T>>,
+                    const dolfinx::geometry::PointOwnershipData<T>&>(),
+           nb::arg("V"), nb::arg("interpolation_data"))
+      .def_prop_ro("function_space", &plan_t::function_space)
+      .def_prop_ro("num_points", &plan_t::num_points);
+
+  using evaluation_plan_t = dolfinx::fem::EvaluationPlan<T>;
+  std::string pyclass_name_evaluation_plan
+      = std::string("EvaluationPlan_")
+        + (std::is_same_v<T, float> ? "float32" : "float64");
+  nb::class_<evaluation_plan_t>(
+      m, pyclass_name_evaluation_plan.c_str(),
+      "Plan for repeated evaluation of functions at points")
+      .def(
+          "__init__",
+          [](evaluation_plan_t* self,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>> V,
+             nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig> x,
+             nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells)
+          {
+            new (self)
+                evaluation_plan_t(V, std::span(x.data(), x.size()),
+                                  std::span(cells.data(), cells.size()));
+          },
+          nb::arg("V"), nb::arg("x"), nb::arg("cells"))
+      .def_prop_ro("function_space", &evaluation_plan_t::function_space)
+      .def_prop_ro("num_points", &evaluation_plan_t::num_points);
+
+  using distributed_plan_t = dolfinx::fem::DistributedEvaluationPlan<T>;
+  std::string pyclass_name_distributed_plan
+      = std::string("DistributedEvaluationPlan_")
+        + (std::is_same_v<T, float> ? "float32" : "float64");
+  nb::class_<distributed_plan_t>(
+      m, pyclass_name_distributed_plan.c_str(),
+      "Plan for repeated evaluation of functions at points on any process")
+      .def(
+          "__init__",
+          [](distributed_plan_t* self,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>> V,
+             nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig> x,
+             T padding)
+          {
+            new (self)
+                distributed_plan_t(V, std::span(x.data(), x.size()), padding);
+          },
+          nb::arg("V"), nb::arg("x"), nb::arg("padding"))
+      .def_prop_ro("function_space", &distributed_plan_t::function_space)
+      .def_prop_ro("num_points", &distributed_plan_t::num_points)
+      .def_prop_ro(
+          "owners",
+          [](const distributed_plan_t& self)
+          {
+            std::span<const int> owners = self.owners();
+            return nb::ndarray<const int, nb::numpy>(owners.data(),
+                                                     {owners.size()},
+                                                     nb::handle());
+          },
+          nb::rv_policy::reference_internal);
+
+  using interpolator_t = dolfinx::fem::Interpolator<T>;
+  std::string pyclass_name_interpolator
+      = std::string("Interpolator_")
+        + (std::is_same_v<T, float> ? "float32" : "float64");
+  nb::class_<interpolator_t>(
+      m, pyclass_name_interpolator.c_str(),
+      "Cached operators for repeated interpolation into a function space")
+      .def(
+          "__init__",
+          [](interpolator_t* self,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>> V,
+             nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells)
+          {
+            new (self)
+                interpolator_t(V, std::span(cells.data(), cells.size()));
+          },
+          nb::arg("V"), nb::arg("cells"))
+      .def_prop_ro("function_space", &interpolator_t::function_space)
+      .def_prop_ro(
+          "cells",
+          [](const interpolator_t& self)
+          {
+            std::span<const std::int32_t> cells = self.cells();
+            return nb::ndarray<const std::int32_t, nb::numpy>(
+                cells.data(), {cells.size()}, nb::handle());
+          },
+          nb::rv_policy::reference_internal)
+      .def_prop_ro(
+          "points",
+          [](const interpolator_t& self)
+          {
+            std::span<const T> x = self.points();
+            return nb::ndarray<const T, nb::numpy>(x.data(), {3, x.size() / 3},
+                                                   nb::handle());
+          },
+          nb::rv_policy::reference_internal);
 }
 
 } // namespace
@@ -1154,6 +1413,10 @@ void fem(nb::module_& m)
       },
       nb::arg("comm"), nb::arg("topology"), nb::arg("layout"),
       "Build a dofmap on a mesh.");
+  m.def("clear_dofmap_cache", &dolfinx::fem::clear_dofmap_cache,
+        nb::arg("topology"),
+        "Release the dofmaps of a topology held by the cache of shared "
+        "dofmaps.");
   m.def(
       "transpose_dofmap",
       [](nb::ndarray<const std::int32_t, nb::ndim<2>, nb::c_contig> dofmap,
@@ -1173,14 +1436,27 @@ void fem(nb::module_& m)
          const dolfinx::mesh::Topology& topology,
          const nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig>
              entities,
-         int dim)
+         int dim, bool sort)
       {
         auto integration_entities = dolfinx::fem::compute_integration_domains(
-            type, topology, std::span(entities.data(), entities.size()), dim);
+            type, topology, std::span(entities.data(), entities.size()), dim,
+            sort);
         return dolfinx_wrappers::as_nbarray(std::move(integration_entities));
       },
       nb::arg("integral_type"), nb::arg("topology"), nb::arg("entities"),
-      nb::arg("dim"));
+      nb::arg("dim"), nb::arg("sort") = false);
+  m.def(
+      "sort_integration_entities",
+      [](dolfinx::fem::IntegralType type,
+         nb::ndarray<std::int32_t, nb::ndim<1>, nb::c_contig> entities)
+      {
+        return dolfinx_wrappers::as_nbarray(
+            dolfinx::fem::sort_integration_entities(
+                type, std::span(entities.data(), entities.size())));
+      },
+      nb::arg("integral_type"), nb::arg("entities"),
+      "Sort integration entities in-place by cell index. Returns the "
+      "permutation from the sorted to the input order.");
 
   // dolfinx::fem::ElementDofLayout
   nb::class_<dolfinx::fem::ElementDofLayout>(
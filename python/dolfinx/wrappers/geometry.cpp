@@ -35,17 +35,23 @@ void declare_bbtree(nb::module_& m, std::string type)
              const dolfinx::mesh::Mesh<T>& mesh, int dim,
              nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig>
                  entities,
-             double padding)
+             double padding, int num_threads)
           {
             new (bbt) dolfinx::geometry::BoundingBoxTree<T>(
                 mesh, dim,
                 std::span<const std::int32_t>(entities.data(), entities.size()),
-                padding);
+                padding, num_threads);
           },
           nb::arg("mesh"), nb::arg("dim"), nb::arg("entities"),
-          nb::arg("padding") = 0.0)
+          nb::arg("padding") = 0.0, nb::arg("num_threads") = 1,
+          nb::call_guard<nb::gil_scoped_release>())
       .def_prop_ro("num_bboxes",
                    &dolfinx::geometry::BoundingBoxTree<T>::num_bboxes)
+      .def("refit", &dolfinx::geometry::BoundingBoxTree<T>::refit,
+           nb::arg("mesh"), nb::arg("num_threads") = 1,
+           nb::call_guard<nb::gil_scoped_release>())
+      .def_prop_ro("sah_cost",
+                   &dolfinx::geometry::BoundingBoxTree<T>::sah_cost)
       .def(
           "get_bbox",
           [](const dolfinx::geometry::BoundingBoxTree<T>& self,
@@ -59,9 +65,10 @@ void declare_bbtree(nb::module_& m, std::string type)
       .def(
           "create_global_tree",
           [](const dolfinx::geometry::BoundingBoxTree<T>& self,
-             const dolfinx_wrappers::MPICommWrapper comm)
-          { return self.create_global_tree(comm.get()); },
-          nb::arg("comm"));
+             const dolfinx_wrappers::MPICommWrapper comm, int num_boxes)
+          { return self.create_global_tree(comm.get(), num_boxes); },
+          nb::arg("comm"), nb::arg("num_boxes") = 1,
+          nb::call_guard<nb::gil_scoped_release>());
 
   m.def(
       "compute_collisions_points",
@@ -71,7 +78,8 @@ void declare_bbtree(nb::module_& m, std::string type)
         return dolfinx::geometry::compute_collisions<T>(
             tree, std::span(points.data(), 3));
       },
-      nb::arg("tree"), nb::arg("points"));
+      nb::arg("tree"), nb::arg("points"),
+      nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "compute_collisions_points",
       [](const dolfinx::geometry::BoundingBoxTree<T>& tree,
@@ -80,18 +88,23 @@ void declare_bbtree(nb::module_& m, std::string type)
         return dolfinx::geometry::compute_collisions<T>(
             tree, std::span(points.data(), points.size()));
       },
-      nb::arg("tree"), nb::arg("points"));
+      nb::arg("tree"), nb::arg("points"),
+      nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "compute_collisions_trees",
       [](const dolfinx::geometry::BoundingBoxTree<T>& treeA,
-         const dolfinx::geometry::BoundingBoxTree<T>& treeB)
+         const dolfinx::geometry::BoundingBoxTree<T>& treeB, int num_threads)
       {
-        std::vector coll
-            = dolfinx::geometry::compute_collisions<T>(treeA, treeB);
+        std::vector<std::int32_t> coll;
+        {
+          nb::gil_scoped_release release;
+          coll = dolfinx::geometry::compute_collisions<T>(treeA, treeB,
+                                                          num_threads);
+        }
         return dolfinx_wrappers::as_nbarray(std::move(coll),
                                             {coll.size() / 2, 2});
       },
-      nb::arg("tree0"), nb::arg("tree1"));
+      nb::arg("tree0"), nb::arg("tree1"), nb::arg("num_threads") = 1);
   m.def(
       "compute_closest_entity",
       [](const dolfinx::geometry::BoundingBoxTree<T>& tree,
@@ -99,10 +112,14 @@ void declare_bbtree(nb::module_& m, std::string type)
          const dolfinx::mesh::Mesh<T>& mesh,
          nb::ndarray<const T, nb::shape<3>, nb::c_contig> points)
       {
-        return dolfinx_wrappers::as_nbarray(
-            dolfinx::geometry::compute_closest_entity<T>(
-                tree, midpoint_tree, mesh,
-                std::span(points.data(), points.size())));
+        std::vector<std::int32_t> entities;
+        {
+          nb::gil_scoped_release release;
+          entities = dolfinx::geometry::compute_closest_entity<T>(
+              tree, midpoint_tree, mesh,
+              std::span(points.data(), points.size()));
+        }
+        return dolfinx_wrappers::as_nbarray(std::move(entities));
       },
       nb::arg("tree"), nb::arg("midpoint_tree"), nb::arg("mesh"),
       nb::arg("points"));
@@ -113,13 +130,43 @@ void declare_bbtree(nb::module_& m, std::string type)
          const dolfinx::mesh::Mesh<T>& mesh,
          nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig> points)
       {
-        return dolfinx_wrappers::as_nbarray(
-            dolfinx::geometry::compute_closest_entity<T>(
-                tree, midpoint_tree, mesh,
-                std::span(points.data(), points.size())));
+        std::vector<std::int32_t> entities;
+        {
+          nb::gil_scoped_release release;
+          entities = dolfinx::geometry::compute_closest_entity<T>(
+              tree, midpoint_tree, mesh,
+              std::span(points.data(), points.size()));
+        }
+        return dolfinx_wrappers::as_nbarray(std::move(entities));
       },
       nb::arg("tree"), nb::arg("midpoint_tree"), nb::arg("mesh"),
       nb::arg("points"));
+  m.def(
+      "compute_nearest_entities",
+      [](const dolfinx::geometry::BoundingBoxTree<T>& tree,
+         const dolfinx::mesh::Mesh<T>& mesh,
+         nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig> points, int k,
+         int num_threads)
+      {
+        return dolfinx::geometry::compute_nearest_entities<T>(
+            tree, mesh, std::span(points.data(), points.size()), k,
+            num_threads);
+      },
+      nb::arg("tree"), nb::arg("mesh"), nb::arg("points"), nb::arg("k"),
+      nb::arg("num_threads") = 1, nb::call_guard<nb::gil_scoped_release>());
+  m.def(
+      "compute_entities_in_radius",
+      [](const dolfinx::geometry::BoundingBoxTree<T>& tree,
+         const dolfinx::mesh::Mesh<T>& mesh,
+         nb::ndarray<const T, nb::shape<-1, 3>, nb::c_contig> points,
+         T radius, int num_threads)
+      {
+        return dolfinx::geometry::compute_entities_in_radius<T>(
+            tree, mesh, std::span(points.data(), points.size()), radius,
+            num_threads);
+      },
+      nb::arg("tree"), nb::arg("mesh"), nb::arg("points"), nb::arg("radius"),
+      nb::arg("num_threads") = 1, nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "create_midpoint_tree",
       [](const dolfinx::mesh::Mesh<T>& mesh, int tdim,
@@ -129,7 +176,8 @@ void declare_bbtree(nb::module_& m, std::string type)
             mesh, tdim,
             std::span<const std::int32_t>(entities.data(), entities.size()));
       },
-      nb::arg("mesh"), nb::arg("tdim"), nb::arg("entities"));
+      nb::arg("mesh"), nb::arg("tdim"), nb::arg("entities"),
+      nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "compute_colliding_cells",
       [](const dolfinx::mesh::Mesh<T>& mesh,
@@ -139,7 +187,8 @@ void declare_bbtree(nb::module_& m, std::string type)
         return dolfinx::geometry::compute_colliding_cells<T>(
             mesh, candidate_cells, std::span(points.data(), points.size()));
       },
-      nb::arg("mesh"), nb::arg("candidate_cells"), nb::arg("points"));
+      nb::arg("mesh"), nb::arg("candidate_cells"), nb::arg("points"),
+      nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "compute_colliding_cells",
       [](const dolfinx::mesh::Mesh<T>& mesh,
@@ -149,7 +198,8 @@ void declare_bbtree(nb::module_& m, std::string type)
         return dolfinx::geometry::compute_colliding_cells<T>(
             mesh, candidate_cells, std::span(points.data(), points.size()));
       },
-      nb::arg("mesh"), nb::arg("candidate_cells"), nb::arg("points"));
+      nb::arg("mesh"), nb::arg("candidate_cells"), nb::arg("points"),
+      nb::call_guard<nb::gil_scoped_release>());
 
   m.def(
       "compute_distance_gjk",
@@ -178,15 +228,20 @@ void declare_bbtree(nb::module_& m, std::string type)
                 mesh, dim, std::span(indices.data(), indices.size()), _p));
       },
       nb::arg("mesh"), nb::arg("dim"), nb::arg("indices"), nb::arg("points"));
-  m.def("determine_point_ownership",
-        [](const dolfinx::mesh::Mesh<T>& mesh,
-           nb::ndarray<const T, nb::c_contig> points, const T padding)
-        {
-          const std::size_t p_s0 = points.ndim() == 1 ? 1 : points.shape(0);
-          std::span<const T> _p(points.data(), 3 * p_s0);
-          return dolfinx::geometry::determine_point_ownership<T>(mesh, _p,
-                                                                 padding);
-        });
+  m.def(
+      "determine_point_ownership",
+      [](const dolfinx::mesh::Mesh<T>& mesh,
+         nb::ndarray<const T, nb::c_contig> points, const T padding,
+         dolfinx::geometry::CellSearch search)
+      {
+        const std::size_t p_s0 = points.ndim() == 1 ? 1 : points.shape(0);
+        std::span<const T> _p(points.data(), 3 * p_s0);
+        return dolfinx::geometry::determine_point_ownership<T>(mesh, _p,
+                                                               padding, search);
+      },
+      nb::arg("mesh"), nb::arg("points"), nb::arg("padding"),
+      nb::arg("search") = dolfinx::geometry::CellSearch::bounding_box_tree,
+      nb::call_guard<nb::gil_scoped_release>());
 
   std::string pod_pyclass_name = "PointOwnershipData_" + type;
   nb::class_<dolfinx::geometry::PointOwnershipData<T>>(m,
@@ -251,6 +306,11 @@ namespace dolfinx_wrappers
 {
 void geometry(nb::module_& m)
 {
+  nb::enum_<dolfinx::geometry::CellSearch>(m, "CellSearch")
+      .value("bounding_box_tree",
+             dolfinx::geometry::CellSearch::bounding_box_tree)
+      .value("grid", dolfinx::geometry::CellSearch::grid);
+
   declare_bbtree<float>(m, "float32");
   declare_bbtree<double>(m, "float64");
 }
@@ -161,6 +161,19 @@ void graph(nb::module_& m)
       nb::arg("suppress_output") = true, "KaHIP graph partitioner");
 #endif
 
+  m.def(
+      "partitioner_hierarchical",
+      [](int ranks_per_node) -> partition_fn
+      {
+        return create_partitioner_py(dolfinx::graph::hierarchical::partitioner(
+            &dolfinx::graph::partition_graph, &dolfinx::graph::partition_graph,
+            ranks_per_node));
+      },
+      nb::arg("ranks_per_node") = 0,
+      "Node-aware two-level graph partitioner");
+
   m.def("reorder_gps", &dolfinx::graph::reorder_gps, nb::arg("graph"));
+  m.def("reorder_rcm", &dolfinx::graph::reorder_rcm, nb::arg("graph"),
+        nb::arg("num_threads") = 1);
 }
 } // namespace dolfinx_wrappers
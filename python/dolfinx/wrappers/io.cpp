@@ -13,7 +13,9 @@
 #include <dolfinx/io/ADIOS2Writers.h>
 #include <dolfinx/io/VTKFile.h>
 #include <dolfinx/io/XDMFFile.h>
+#include <dolfinx/io/aggregation.h>
 #include <dolfinx/io/cells.h>
+#include <dolfinx/io/checkpointing.h>
 #include <dolfinx/io/vtk_utils.h>
 #include <dolfinx/io/xdmf_utils.h>
 #include <dolfinx/mesh/Mesh.h>
@@ -22,8 +24,11 @@
 #include <memory>
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
+#include <nanobind/stl/array.h>
 #include <nanobind/stl/complex.h>
 #include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/map.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/pair.h>
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
@@ -48,8 +53,10 @@ void xdmf_real_fn(auto&& m)
   m.def(
       "write_mesh",
       [](dolfinx::io::XDMFFile& self, const dolfinx::mesh::Mesh<T>& mesh,
-         std::string xpath) { self.write_mesh(mesh, xpath); },
-      nb::arg("mesh"), nb::arg("xpath") = "/Xdmf/Domain");
+         std::string xpath, bool partition)
+      { self.write_mesh(mesh, xpath, partition); },
+      nb::arg("mesh"), nb::arg("xpath") = "/Xdmf/Domain",
+      nb::arg("partition") = false, nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "write_meshtags",
       [](dolfinx::io::XDMFFile& self,
@@ -58,7 +65,8 @@ void xdmf_real_fn(auto&& m)
          std::string xpath)
       { self.write_meshtags(meshtags, x, geometry_xpath, xpath); },
       nb::arg("meshtags"), nb::arg("x"), nb::arg("geometry_xpath"),
-      nb::arg("xpath") = "/Xdmf/Domain");
+      nb::arg("xpath") = "/Xdmf/Domain",
+      nb::call_guard<nb::gil_scoped_release>());
 }
 
 template <typename T, typename U>
@@ -70,7 +78,8 @@ void xdmf_scalar_fn(auto&& m)
          double t, std::string mesh_xpath)
       { self.write_function(u, t, mesh_xpath); },
       nb::arg("u"), nb::arg("t"),
-      nb::arg("mesh_xpath") = "/Xdmf/Domain/Grid[@GridType='Uniform'][1]");
+      nb::arg("mesh_xpath") = "/Xdmf/Domain/Grid[@GridType='Uniform'][1]",
+      nb::call_guard<nb::gil_scoped_release>());
 }
 
 template <typename T>
@@ -80,7 +89,8 @@ void vtk_real_fn(auto&& m)
       "write",
       [](dolfinx::io::VTKFile& self, const dolfinx::mesh::Mesh<T>& mesh,
          double t) { self.write(mesh, t); },
-      nb::arg("mesh"), nb::arg("t") = 0.0);
+      nb::arg("mesh"), nb::arg("t") = 0.0,
+      nb::call_guard<nb::gil_scoped_release>());
 }
 
 template <typename T, typename U>
@@ -100,9 +110,64 @@ void vtk_scalar_fn(auto&& m)
 
         self.write(u, t);
       },
-      nb::arg("u"), nb::arg("t") = 0.0);
+      nb::arg("u"), nb::arg("t") = 0.0,
+      nb::call_guard<nb::gil_scoped_release>());
+}
+
+#ifdef HAS_ADIOS2
+template <typename T, typename U>
+void declare_read_checkpoint_function(nb::module_& m)
+{
+  m.def(
+      "read_checkpoint_function",
+      [](std::filesystem::path filename, dolfinx::fem::Function<T, U>& u,
+         std::string name, std::string engine)
+      { dolfinx::io::checkpointing::read_function(filename, u, name, engine); },
+      nb::arg("filename"), nb::arg("u"), nb::arg("name"),
+      nb::arg("engine") = "BPFile");
+}
+
+template <typename T, typename U>
+void declare_checkpoint_read_function(
+    nb::class_<dolfinx::io::checkpointing::Reader>& reader)
+{
+  reader.def(
+      "read_function",
+      [](dolfinx::io::checkpointing::Reader& self,
+         dolfinx::fem::Function<T, U>& u, std::string name)
+      { self.read_function(u, name); }, nb::arg("u"), nb::arg("name"));
 }
 
+template <typename T>
+void declare_checkpoint_stream(
+    nb::class_<dolfinx::io::checkpointing::Writer>& writer,
+    nb::class_<dolfinx::io::checkpointing::Reader>& reader, std::string type)
+{
+  writer.def(
+      "write",
+      [](dolfinx::io::checkpointing::Writer& self,
+         const dolfinx::mesh::Mesh<T>& mesh,
+         const std::vector<std::variant<
+             std::shared_ptr<const dolfinx::fem::Function<float, T>>,
+             std::shared_ptr<const dolfinx::fem::Function<double, T>>,
+             std::shared_ptr<
+                 const dolfinx::fem::Function<std::complex<float>, T>>,
+             std::shared_ptr<const dolfinx::fem::Function<
+                 std::complex<double>, T>>>>& u) { self.write(mesh, u); },
+      nb::arg("mesh"), nb::arg("u"), nb::call_guard<nb::gil_scoped_release>());
+  reader.def(
+      ("read_mesh_" + type).c_str(),
+      [](dolfinx::io::checkpointing::Reader& self,
+         dolfinx::mesh::GhostMode ghost_mode)
+      { return self.read_mesh<T>(ghost_mode); }, nb::arg("ghost_mode"));
+
+  declare_checkpoint_read_function<float, T>(reader);
+  declare_checkpoint_read_function<double, T>(reader);
+  declare_checkpoint_read_function<std::complex<float>, T>(reader);
+  declare_checkpoint_read_function<std::complex<double>, T>(reader);
+}
+#endif
+
 template <typename T>
 void declare_vtx_writer(nb::module_& m, std::string type)
 {
@@ -115,12 +180,17 @@ void declare_vtx_writer(nb::module_& m, std::string type)
             [](dolfinx::io::VTXWriter<T>* self, MPICommWrapper comm,
                std::filesystem::path filename,
                std::shared_ptr<const dolfinx::mesh::Mesh<T>> mesh,
-               std::string engine) {
-              new (self)
-                  dolfinx::io::VTXWriter<T>(comm.get(), filename, mesh, engine);
+               std::string engine, int num_aggregators,
+               const std::map<std::string, std::string>& engine_parameters)
+            {
+              new (self) dolfinx::io::VTXWriter<T>(comm.get(), filename, mesh,
+                                                   engine, num_aggregators,
+                                                   engine_parameters);
             },
             nb::arg("comm"), nb::arg("filename"), nb::arg("mesh"),
-            nb::arg("engine"))
+            nb::arg("engine"), nb::arg("num_aggregators") = 0,
+            nb::arg("engine_parameters")
+            = std::map<std::string, std::string>{})
         .def(
             "__init__",
             [](dolfinx::io::VTXWriter<T>* self, MPICommWrapper comm,
@@ -132,18 +202,43 @@ void declare_vtx_writer(nb::module_& m, std::string type)
                        const dolfinx::fem::Function<std::complex<float>, T>>,
                    std::shared_ptr<const dolfinx::fem::Function<
                        std::complex<double>, T>>>>& u,
-               std::string engine, dolfinx::io::VTXMeshPolicy policy)
+               std::string engine, dolfinx::io::VTXMeshPolicy policy,
+               int num_aggregators,
+               const std::map<std::string, std::string>& engine_parameters)
             {
-              new (self) dolfinx::io::VTXWriter<T>(comm.get(), filename, u,
-                                                   engine, policy);
+              new (self) dolfinx::io::VTXWriter<T>(
+                  comm.get(), filename, u, engine, policy, num_aggregators,
+                  engine_parameters);
             },
             nb::arg("comm"), nb::arg("filename"), nb::arg("u"),
             nb::arg("engine") = "BPFile",
-            nb::arg("policy") = dolfinx::io::VTXMeshPolicy::update)
+            nb::arg("policy") = dolfinx::io::VTXMeshPolicy::update,
+            nb::arg("num_aggregators") = 0,
+            nb::arg("engine_parameters")
+            = std::map<std::string, std::string>{})
         .def("close", [](dolfinx::io::VTXWriter<T>& self) { self.close(); })
+        .def_prop_rw(
+            "asynchronous",
+            [](const dolfinx::io::VTXWriter<T>& self)
+            { return self.asynchronous(); },
+            [](dolfinx::io::VTXWriter<T>& self, bool async)
+            { self.set_asynchronous(async); })
+        .def_prop_rw(
+            "nonblocking",
+            [](const dolfinx::io::VTXWriter<T>& self)
+            { return self.nonblocking(); },
+            [](dolfinx::io::VTXWriter<T>& self, bool nonblocking)
+            { self.set_nonblocking(nonblocking); })
+        .def_prop_ro("num_dropped_steps",
+                     [](const dolfinx::io::VTXWriter<T>& self)
+                     { return self.num_dropped_steps(); })
+        .def_prop_rw("output_options",
+                     &dolfinx::io::VTXWriter<T>::output_options,
+                     &dolfinx::io::VTXWriter<T>::set_output_options)
         .def(
             "write", [](dolfinx::io::VTXWriter<T>& self, double t)
-            { self.write(t); }, nb::arg("t"));
+            { self.write(t); }, nb::arg("t"),
+            nb::call_guard<nb::gil_scoped_release>());
   }
 
   {
@@ -155,12 +250,18 @@ void declare_vtx_writer(nb::module_& m, std::string type)
             [](dolfinx::io::FidesWriter<T>* self, MPICommWrapper comm,
                std::filesystem::path filename,
                std::shared_ptr<const dolfinx::mesh::Mesh<T>> mesh,
-               std::string engine) {
-              new (self) dolfinx::io::FidesWriter<T>(comm.get(), filename, mesh,
-                                                     engine);
+               std::string engine, int num_aggregators,
+               const std::map<std::string, std::string>& engine_parameters)
+            {
+              new (self) dolfinx::io::FidesWriter<T>(comm.get(), filename,
+                                                     mesh, engine,
+                                                     num_aggregators,
+                                                     engine_parameters);
             },
             nb::arg("comm"), nb::arg("filename"), nb::arg("mesh"),
-            nb::arg("engine") = "BPFile")
+            nb::arg("engine") = "BPFile", nb::arg("num_aggregators") = 0,
+            nb::arg("engine_parameters")
+            = std::map<std::string, std::string>{})
         .def(
             "__init__",
             [](dolfinx::io::FidesWriter<T>* self, MPICommWrapper comm,
@@ -172,19 +273,76 @@ void declare_vtx_writer(nb::module_& m, std::string type)
                        const dolfinx::fem::Function<std::complex<float>, T>>,
                    std::shared_ptr<const dolfinx::fem::Function<
                        std::complex<double>, T>>>>& u,
-               std::string engine, dolfinx::io::FidesMeshPolicy policy)
+               std::string engine, dolfinx::io::FidesMeshPolicy policy,
+               int num_aggregators,
+               const std::map<std::string, std::string>& engine_parameters)
             {
-              new (self) dolfinx::io::FidesWriter<T>(comm.get(), filename, u,
-                                                     engine, policy);
+              new (self) dolfinx::io::FidesWriter<T>(
+                  comm.get(), filename, u, engine, policy, num_aggregators,
+                  engine_parameters);
             },
             nb::arg("comm"), nb::arg("filename"), nb::arg("u"),
             nb::arg("engine") = "BPFile",
-            nb::arg("policy") = dolfinx::io::FidesMeshPolicy::update)
+            nb::arg("policy") = dolfinx::io::FidesMeshPolicy::update,
+            nb::arg("num_aggregators") = 0,
+            nb::arg("engine_parameters")
+            = std::map<std::string, std::string>{})
         .def("close", [](dolfinx::io::FidesWriter<T>& self) { self.close(); })
+        .def_prop_rw(
+            "asynchronous",
+            [](const dolfinx::io::FidesWriter<T>& self)
+            { return self.asynchronous(); },
+            [](dolfinx::io::FidesWriter<T>& self, bool async)
+            { self.set_asynchronous(async); })
+        .def_prop_rw(
+            "nonblocking",
+            [](const dolfinx::io::FidesWriter<T>& self)
+            { return self.nonblocking(); },
+            [](dolfinx::io::FidesWriter<T>& self, bool nonblocking)
+            { self.set_nonblocking(nonblocking); })
+        .def_prop_ro("num_dropped_steps",
+                     [](const dolfinx::io::FidesWriter<T>& self)
+                     { return self.num_dropped_steps(); })
         .def(
             "write", [](dolfinx::io::FidesWriter<T>& self, double t)
-            { self.write(t); }, nb::arg("t"));
+            { self.write(t); }, nb::arg("t"),
+            nb::call_guard<nb::gil_scoped_release>());
   }
+
+  m.def(
+      "write_checkpoint",
+      [](MPICommWrapper comm, std::filesystem::path filename,
+         const dolfinx::mesh::Mesh<T>& mesh,
+         const std::vector<std::variant<
+             std::shared_ptr<const dolfinx::fem::Function<float, T>>,
+             std::shared_ptr<const dolfinx::fem::Function<double, T>>,
+             std::shared_ptr<
+                 const dolfinx::fem::Function<std::complex<float>, T>>,
+             std::shared_ptr<const dolfinx::fem::Function<
+                 std::complex<double>, T>>>>& u,
+         std::string engine, int num_aggregators)
+      {
+        dolfinx::io::checkpointing::write(comm.get(), filename, mesh, u,
+                                          engine, num_aggregators);
+      },
+      nb::arg("comm"), nb::arg("filename"), nb::arg("mesh"), nb::arg("u"),
+      nb::arg("engine") = "BPFile", nb::arg("num_aggregators") = 0,
+      nb::call_guard<nb::gil_scoped_release>());
+  m.def(
+      ("read_checkpoint_mesh_" + type).c_str(),
+      [](MPICommWrapper comm, std::filesystem::path filename,
+         dolfinx::mesh::GhostMode ghost_mode, std::string engine)
+      {
+        return dolfinx::io::checkpointing::read_mesh<T>(comm.get(), filename,
+                                                        ghost_mode, engine);
+      },
+      nb::arg("comm"), nb::arg("filename"), nb::arg("ghost_mode"),
+      nb::arg("engine") = "BPFile");
+
+  declare_read_checkpoint_function<float, T>(m);
+  declare_read_checkpoint_function<double, T>(m);
+  declare_read_checkpoint_function<std::complex<float>, T>(m);
+  declare_read_checkpoint_function<std::complex<double>, T>(m);
 #endif
 }
 
@@ -264,6 +422,46 @@ void io(nb::module_& m)
         "Permutation array to map from Gmsh to DOLFINx node ordering");
 
   // dolfinx::io::XDMFFile
+  // dolfinx::io::hdf5 options
+  nb::enum_<dolfinx::io::hdf5::Filter>(m, "HDF5Filter")
+      .value("none", dolfinx::io::hdf5::Filter::none)
+      .value("deflate", dolfinx::io::hdf5::Filter::deflate)
+      .value("zstd", dolfinx::io::hdf5::Filter::zstd)
+      .value("blosc", dolfinx::io::hdf5::Filter::blosc)
+      .value("sz", dolfinx::io::hdf5::Filter::sz)
+      .value("zfp", dolfinx::io::hdf5::Filter::zfp);
+
+  nb::class_<dolfinx::io::Aggregator>(m, "Aggregator",
+                                      "Aggregation of output data")
+      .def(
+          "__init__",
+          [](dolfinx::io::Aggregator* self, MPICommWrapper comm,
+             int num_aggregators)
+          { new (self) dolfinx::io::Aggregator(comm.get(), num_aggregators); },
+          nb::arg("comm"), nb::arg("num_aggregators"))
+      .def_prop_ro("is_aggregator", &dolfinx::io::Aggregator::is_aggregator)
+      .def_prop_ro("num_aggregators",
+                   &dolfinx::io::Aggregator::num_aggregators);
+
+  nb::class_<dolfinx::io::hdf5::DatasetOptions>(m, "HDF5DatasetOptions",
+                                                "HDF5 dataset options")
+      .def(nb::init<>())
+      .def_rw("chunking", &dolfinx::io::hdf5::DatasetOptions::chunking)
+      .def_rw("chunk_shape", &dolfinx::io::hdf5::DatasetOptions::chunk_shape)
+      .def_rw("filter", &dolfinx::io::hdf5::DatasetOptions::filter)
+      .def_rw("filter_parameters",
+              &dolfinx::io::hdf5::DatasetOptions::filter_parameters)
+      .def_rw("shuffle", &dolfinx::io::hdf5::DatasetOptions::shuffle)
+      .def_rw("aggregator", &dolfinx::io::hdf5::DatasetOptions::aggregator,
+              nb::arg("aggregator").none());
+
+  nb::class_<dolfinx::io::hdf5::FileOptions>(m, "HDF5FileOptions",
+                                             "HDF5 file access options")
+      .def(nb::init<>())
+      .def_rw("alignment", &dolfinx::io::hdf5::FileOptions::alignment)
+      .def_rw("collective_metadata",
+              &dolfinx::io::hdf5::FileOptions::collective_metadata);
+
   nb::class_<dolfinx::io::XDMFFile> xdmf_file(m, "XDMFFile");
 
   // dolfinx::io::XDMFFile::Encoding enums
@@ -277,16 +475,28 @@ void io(nb::module_& m)
           "__init__",
           [](dolfinx::io::XDMFFile* x, MPICommWrapper comm,
              std::filesystem::path filename, std::string file_mode,
-             dolfinx::io::XDMFFile::Encoding encoding) {
+             dolfinx::io::XDMFFile::Encoding encoding,
+             const dolfinx::io::hdf5::FileOptions& file_options)
+          {
             new (x) dolfinx::io::XDMFFile(comm.get(), filename, file_mode,
-                                          encoding);
+                                          encoding, file_options);
           },
           nb::arg("comm"), nb::arg("filename"), nb::arg("file_mode"),
-          nb::arg("encoding") = dolfinx::io::XDMFFile::Encoding::HDF5)
+          nb::arg("encoding") = dolfinx::io::XDMFFile::Encoding::HDF5,
+          nb::arg("file_options") = dolfinx::io::hdf5::FileOptions())
       .def("close", &dolfinx::io::XDMFFile::close)
+      .def_prop_rw("dataset_options",
+                   &dolfinx::io::XDMFFile::dataset_options,
+                   &dolfinx::io::XDMFFile::set_dataset_options,
+                   "HDF5 dataset creation options used by writes")
+      .def_prop_rw("read_buffer_size",
+                   &dolfinx::io::XDMFFile::read_buffer_size,
+                   &dolfinx::io::XDMFFile::set_read_buffer_size,
+                   "Maximum size (bytes) of the buffer for reading mesh data")
       .def("write_geometry", &dolfinx::io::XDMFFile::write_geometry,
            nb::arg("geometry"), nb::arg("name") = "geometry",
-           nb::arg("xpath") = "/Xdmf/Domain")
+           nb::arg("xpath") = "/Xdmf/Domain",
+           nb::call_guard<nb::gil_scoped_release>())
       .def(
           "read_topology_data",
           [](dolfinx::io::XDMFFile& self, std::string name, std::string xpath)
@@ -306,6 +516,14 @@ void io(nb::module_& m)
           nb::arg("name") = "mesh", nb::arg("xpath") = "/Xdmf/Domain")
       .def("read_geometry_data", &dolfinx::io::XDMFFile::read_geometry_data,
            nb::arg("name") = "mesh", nb::arg("xpath") = "/Xdmf/Domain")
+      .def(
+          "read_partition",
+          [](dolfinx::io::XDMFFile& self, std::string name, std::string xpath)
+          {
+            auto [owners, num_parts] = self.read_partition(name, xpath);
+            return std::pair(as_nbarray(std::move(owners)), num_parts);
+          },
+          nb::arg("name") = "mesh", nb::arg("xpath") = "/Xdmf/Domain")
       .def("read_cell_type", &dolfinx::io::XDMFFile::read_cell_type,
            nb::arg("name") = "mesh", nb::arg("xpath") = "/Xdmf/Domain")
       .def("read_meshtags", &dolfinx::io::XDMFFile::read_meshtags,
@@ -327,13 +545,28 @@ void io(nb::module_& m)
 
   // dolfinx::io::VTKFile
   nb::class_<dolfinx::io::VTKFile> vtk_file(m, "VTKFile");
+
+  // dolfinx::io::VTKFile::Encoding enums
+  nb::enum_<dolfinx::io::VTKFile::Encoding>(vtk_file, "Encoding")
+      .value("ASCII", dolfinx::io::VTKFile::Encoding::ASCII,
+             "Plain text encoding")
+      .value("Base64", dolfinx::io::VTKFile::Encoding::Base64,
+             "Base64 encoded binary data")
+      .value("Raw", dolfinx::io::VTKFile::Encoding::Raw,
+             "Raw binary data appended to the file");
+
   vtk_file
       .def(
           "__init__",
           [](dolfinx::io::VTKFile* v, MPICommWrapper comm,
-             std::filesystem::path filename, std::string mode)
-          { new (v) dolfinx::io::VTKFile(comm.get(), filename, mode); },
-          nb::arg("comm"), nb::arg("filename"), nb::arg("mode"))
+             std::filesystem::path filename, std::string mode,
+             dolfinx::io::VTKFile::Encoding encoding)
+          {
+            new (v)
+                dolfinx::io::VTKFile(comm.get(), filename, mode, encoding);
+          },
+          nb::arg("comm"), nb::arg("filename"), nb::arg("mode"),
+          nb::arg("encoding") = dolfinx::io::VTKFile::default_encoding)
       .def("close", &dolfinx::io::VTKFile::close);
 
   vtk_real_fn<float>(vtk_file);
@@ -351,6 +584,79 @@ void io(nb::module_& m)
   nb::enum_<dolfinx::io::VTXMeshPolicy>(m, "VTXMeshPolicy")
       .value("update", dolfinx::io::VTXMeshPolicy::update)
       .value("reuse", dolfinx::io::VTXMeshPolicy::reuse);
+
+  nb::class_<dolfinx::io::VTXOutputOptions>(m, "VTXOutputOptions",
+                                            "Options to reduce VTX output")
+      .def(nb::init<>())
+      .def_rw("float32_fields",
+              &dolfinx::io::VTXOutputOptions::float32_fields)
+      .def_rw("int32_connectivity",
+              &dolfinx::io::VTXOutputOptions::int32_connectivity)
+      .def_rw("field_operators",
+              &dolfinx::io::VTXOutputOptions::field_operators)
+      .def_rw("connectivity_operators",
+              &dolfinx::io::VTXOutputOptions::connectivity_operators)
+      .def_rw("cells", &dolfinx::io::VTXOutputOptions::cells);
+
+  nb::class_<dolfinx::io::checkpointing::Writer> checkpoint_writer(
+      m, "CheckpointWriter", "Writer of a sequence of checkpoints");
+  checkpoint_writer
+      .def(
+          "__init__",
+          [](dolfinx::io::checkpointing::Writer* self, MPICommWrapper comm,
+             std::filesystem::path filename, std::string engine,
+             int num_aggregators,
+             const std::map<std::string, std::string>& engine_parameters)
+          {
+            new (self) dolfinx::io::checkpointing::Writer(
+                comm.get(), filename, engine, num_aggregators,
+                engine_parameters);
+          },
+          nb::arg("comm"), nb::arg("filename"), nb::arg("engine") = "BPFile",
+          nb::arg("num_aggregators") = 0,
+          nb::arg("engine_parameters") = std::map<std::string, std::string>{})
+      .def("close",
+           [](dolfinx::io::checkpointing::Writer& self) { self.close(); })
+      .def_prop_rw(
+          "asynchronous",
+          [](const dolfinx::io::checkpointing::Writer& self)
+          { return self.asynchronous(); },
+          [](dolfinx::io::checkpointing::Writer& self, bool async)
+          { self.set_asynchronous(async); })
+      .def_prop_rw(
+          "nonblocking",
+          [](const dolfinx::io::checkpointing::Writer& self)
+          { return self.nonblocking(); },
+          [](dolfinx::io::checkpointing::Writer& self, bool nonblocking)
+          { self.set_nonblocking(nonblocking); })
+      .def_prop_ro("num_dropped_steps",
+                   [](const dolfinx::io::checkpointing::Writer& self)
+                   { return self.num_dropped_steps(); });
+
+  nb::class_<dolfinx::io::checkpointing::Reader> checkpoint_reader(
+      m, "CheckpointReader", "Reader of a sequence of checkpoints");
+  checkpoint_reader
+      .def(
+          "__init__",
+          [](dolfinx::io::checkpointing::Reader* self, MPICommWrapper comm,
+             std::filesystem::path filename, std::string engine,
+             const std::map<std::string, std::string>& engine_parameters)
+          {
+            new (self) dolfinx::io::checkpointing::Reader(
+                comm.get(), filename, engine, engine_parameters);
+          },
+          nb::arg("comm"), nb::arg("filename"), nb::arg("engine") = "BPFile",
+          nb::arg("engine_parameters") = std::map<std::string, std::string>{})
+      .def("begin_step", &dolfinx::io::checkpointing::Reader::begin_step,
+           nb::arg("timeout") = -1.0f)
+      .def("end_step", &dolfinx::io::checkpointing::Reader::end_step)
+      .def_prop_ro("end_of_stream",
+                   &dolfinx::io::checkpointing::Reader::end_of_stream)
+      .def("close", &dolfinx::io::checkpointing::Reader::close);
+  declare_checkpoint_stream<float>(checkpoint_writer, checkpoint_reader,
+                                   "float32");
+  declare_checkpoint_stream<double>(checkpoint_writer, checkpoint_reader,
+                                    "float64");
 #endif
 
   declare_vtx_writer<float>(m, "float32");
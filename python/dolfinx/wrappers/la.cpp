@@ -51,6 +51,8 @@ void declare_objects(nb::module_& m, const std::string& type)
                    { return dolfinx_wrappers::numpy_dtype<T>(); })
       .def_prop_ro("index_map", &dolfinx::la::Vector<T>::index_map)
       .def_prop_ro("bs", &dolfinx::la::Vector<T>::bs)
+      .def_prop_ro("version", &dolfinx::la::Vector<T>::version)
+      .def("mark_modified", &dolfinx::la::Vector<T>::mark_modified)
       .def_prop_ro(
           "array",
           [](dolfinx::la::Vector<T>& self)
@@ -60,7 +62,8 @@ void declare_objects(nb::module_& m, const std::string& type)
                                              nb::handle());
           },
           nb::rv_policy::reference_internal)
-      .def("scatter_forward", &dolfinx::la::Vector<T>::scatter_fwd)
+      .def("scatter_forward",
+           [](dolfinx::la::Vector<T>& self) { self.scatter_fwd(); })
       .def(
           "scatter_reverse",
           [](dolfinx::la::Vector<T>& self, PyInsertMode mode)
@@ -38,7 +38,8 @@ namespace nb = nanobind;
 
 namespace
 {
-/// Wrap a Python graph partitioning function as a C++ function
+/// Wrap a Python graph partitioning function as a C++ function. The
+/// GIL is acquired for the call, since mesh creation releases it.
 template <typename Functor>
 auto create_partitioner_cpp(Functor p)
 {
@@ -46,6 +47,7 @@ auto create_partitioner_cpp(Functor p)
              const dolfinx::graph::AdjacencyList<std::int64_t>& local_graph,
              bool ghosting)
   {
+    nb::gil_scoped_acquire acquire;
     return p(dolfinx_wrappers::MPICommWrapper(comm), nparts, local_graph,
              ghosting);
   };
@@ -78,7 +80,8 @@ using CppCellPartitionFunction
         MPI_Comm, int, const std::vector<dolfinx::mesh::CellType>& q,
         const std::vector<std::span<const std::int64_t>>&)>;
 
-/// Wrap a Python cell graph partitioning function as a C++ function
+/// Wrap a Python cell graph partitioning function as a C++ function.
+/// The GIL is acquired for the call, since mesh creation releases it.
 CppCellPartitionFunction
 create_cell_partitioner_cpp(const PythonCellPartitionFunction& p)
 {
@@ -88,6 +91,7 @@ create_cell_partitioner_cpp(const PythonCellPartitionFunction& p)
                const std::vector<dolfinx::mesh::CellType>& cell_types,
                const std::vector<std::span<const std::int64_t>>& cells)
     {
+      nb::gil_scoped_acquire acquire;
       std::vector<nb::ndarray<const std::int64_t, nb::numpy>> cells_nb;
       std::ranges::transform(
           cells, std::back_inserter(cells_nb),
@@ -202,6 +206,10 @@ void declare_mesh(nb::module_& m, std::string type)
           nb::rv_policy::reference_internal,
           "Return coordinates of all geometry points. Each row is the "
           "coordinate of a point.")
+      .def_prop_ro("x_version", &dolfinx::mesh::Geometry<T>::x_version,
+                   "Version of the geometry data")
+      .def("mark_modified", &dolfinx::mesh::Geometry<T>::mark_modified,
+           "Increment the version of the geometry data")
       .def_prop_ro(
           "cmap", [](dolfinx::mesh::Geometry<T>& self) { return self.cmap(); },
           "The coordinate map")
@@ -249,7 +257,7 @@ void declare_mesh(nb::module_& m, std::string type)
             comm.get(), n, p, ghost_mode, create_cell_partitioner_cpp(part));
       },
       nb::arg("comm"), nb::arg("n"), nb::arg("p"), nb::arg("ghost_mode"),
-      nb::arg("partitioner").none());
+      nb::arg("partitioner").none(), nb::call_guard<nb::gil_scoped_release>());
 
   std::string create_rectangle("create_rectangle_" + type);
   m.def(
@@ -264,7 +272,8 @@ void declare_mesh(nb::module_& m, std::string type)
             diagonal);
       },
       nb::arg("comm"), nb::arg("p"), nb::arg("n"), nb::arg("celltype"),
-      nb::arg("partitioner").none(), nb::arg("diagonal"));
+      nb::arg("partitioner").none(), nb::arg("diagonal"),
+      nb::call_guard<nb::gil_scoped_release>());
 
   std::string create_box("create_box_" + type);
   m.def(
@@ -278,7 +287,18 @@ void declare_mesh(nb::module_& m, std::string type)
                                             create_cell_partitioner_cpp(part));
       },
       nb::arg("comm"), nb::arg("p"), nb::arg("n"), nb::arg("celltype"),
-      nb::arg("partitioner").none());
+      nb::arg("partitioner").none(), nb::call_guard<nb::gil_scoped_release>());
+  m.def(
+      std::string("create_box_blocked_" + type).c_str(),
+      [](MPICommWrapper comm, std::array<std::array<double, 3>, 2> p,
+         std::array<std::int64_t, 3> n, dolfinx::mesh::CellType celltype,
+         dolfinx::mesh::GhostMode ghost_mode)
+      {
+        return dolfinx::mesh::create_box_blocked<T>(comm.get(), p, n,
+                                                    celltype, ghost_mode);
+      },
+      nb::arg("comm"), nb::arg("p"), nb::arg("n"), nb::arg("celltype"),
+      nb::arg("ghost_mode"), nb::call_guard<nb::gil_scoped_release>());
 
   m.def("create_mesh",
         [](MPICommWrapper comm,
@@ -302,6 +322,7 @@ void declare_mesh(nb::module_& m, std::string type)
                       const std::vector<dolfinx::mesh::CellType>& cell_types,
                       const std::vector<std::span<const std::int64_t>>& cells)
             {
+              nb::gil_scoped_acquire acquire;
               std::vector<nb::ndarray<const std::int64_t, nb::numpy>> cells_nb;
               std::ranges::transform(
                   cells, std::back_inserter(cells_nb),
@@ -320,7 +341,8 @@ void declare_mesh(nb::module_& m, std::string type)
             return dolfinx::mesh::create_mesh(
                 comm.get(), comm.get(), cells, elements, comm.get(),
                 std::span(x.data(), x.size()), {x.shape(0), shape1}, nullptr);
-        });
+        },
+        nb::call_guard<nb::gil_scoped_release>());
 
   m.def(
       "create_mesh",
@@ -338,6 +360,7 @@ void declare_mesh(nb::module_& m, std::string type)
                     const std::vector<dolfinx::mesh::CellType>& cell_types,
                     const std::vector<std::span<const std::int64_t>>& cells)
           {
+            nb::gil_scoped_acquire acquire;
             std::vector<nb::ndarray<const std::int64_t, nb::numpy>> cells_nb;
             std::ranges::transform(
                 cells, std::back_inserter(cells_nb),
@@ -363,6 +386,7 @@ void declare_mesh(nb::module_& m, std::string type)
       },
       nb::arg("comm"), nb::arg("cells"), nb::arg("element"),
       nb::arg("x").noconvert(), nb::arg("partitioner").none(),
+      nb::call_guard<nb::gil_scoped_release>(),
       "Helper function for creating meshes.");
   m.def(
       "create_submesh",
@@ -559,6 +583,9 @@ void mesh(nb::module_& m)
       .value("shared_vertex", dolfinx::mesh::GhostMode::shared_vertex);
 
   // dolfinx::mesh::TopologyComputation
+  nb::enum_<dolfinx::mesh::EntityComputation>(m, "EntityComputation")
+      .value("sort", dolfinx::mesh::EntityComputation::sort)
+      .value("hash", dolfinx::mesh::EntityComputation::hash);
   m.def(
       "compute_entities",
       [](MPICommWrapper comm, const dolfinx::mesh::Topology& topology, int dim,
@@ -589,10 +616,31 @@ void mesh(nb::module_& m)
                              std::shared_ptr<const dolfinx::common::IndexMap>>(
                &dolfinx::mesh::Topology::set_index_map),
            nb::arg("dim"), nb::arg("map"))
-      .def("create_entities", &dolfinx::mesh::Topology::create_entities,
-           nb::arg("dim"))
+      .def("create_entities",
+           nb::overload_cast<int, dolfinx::mesh::EntityComputation, int>(
+               &dolfinx::mesh::Topology::create_entities),
+           nb::arg("dim"),
+           nb::arg("method") = dolfinx::mesh::EntityComputation::sort,
+           nb::arg("num_threads") = 1)
+      .def(
+          "create_entities",
+          [](dolfinx::mesh::Topology& self, const std::vector<int>& dims,
+             dolfinx::mesh::EntityComputation method, int num_threads)
+          { self.create_entities(dims, method, num_threads); },
+          nb::arg("dims"),
+          nb::arg("method") = dolfinx::mesh::EntityComputation::sort,
+          nb::arg("num_threads") = 1)
       .def("create_entity_permutations",
-           &dolfinx::mesh::Topology::create_entity_permutations)
+           &dolfinx::mesh::Topology::create_entity_permutations,
+           nb::arg("num_threads") = 1)
+      .def("set_connectivity_budget",
+           &dolfinx::mesh::Topology::set_connectivity_budget,
+           nb::arg("bytes"))
+      .def(
+          "connectivity_bytes",
+          [](const dolfinx::mesh::Topology& self)
+          { return self.connectivity_bytes(); },
+          "Memory used by all connectivities in bytes")
       .def("create_connectivity", &dolfinx::mesh::Topology::create_connectivity,
            nb::arg("d0"), nb::arg("d1"))
       .def(
@@ -616,6 +664,10 @@ void mesh(nb::module_& m)
           nb::rv_policy::reference_internal)
       .def_prop_ro("dim", &dolfinx::mesh::Topology::dim,
                    "Topological dimension")
+      .def_prop_ro("version", &dolfinx::mesh::Topology::version,
+                   "Version of the topology")
+      .def("mark_modified", &dolfinx::mesh::Topology::mark_modified,
+           "Increment the version of the topology")
       .def_prop_ro(
           "original_cell_index",
           [](const dolfinx::mesh::Topology& self)
@@ -694,11 +746,14 @@ void mesh(nb::module_& m)
 
   m.def(
       "create_cell_partitioner",
-      [](dolfinx::mesh::GhostMode gm) -> PythonCellPartitionFunction
+      [](dolfinx::mesh::GhostMode gm,
+         int ghost_layers) -> PythonCellPartitionFunction
       {
         return create_cell_partitioner_py(
-            dolfinx::mesh::create_cell_partitioner(gm));
+            dolfinx::mesh::create_cell_partitioner(
+                gm, &dolfinx::graph::partition_graph, ghost_layers));
       },
+      nb::arg("ghost_mode"), nb::arg("ghost_layers") = 1,
       "Create default cell partitioner.");
   m.def(
       "create_cell_partitioner",
@@ -707,14 +762,61 @@ void mesh(nb::module_& m)
              const dolfinx::graph::AdjacencyList<std::int64_t>& local_graph,
              bool ghosting)>
              part,
-         dolfinx::mesh::GhostMode ghost_mode) -> PythonCellPartitionFunction
+         dolfinx::mesh::GhostMode ghost_mode,
+         int ghost_layers) -> PythonCellPartitionFunction
       {
         return create_cell_partitioner_py(
             dolfinx::mesh::create_cell_partitioner(
-                ghost_mode, create_partitioner_cpp(part)));
+                ghost_mode, create_partitioner_cpp(part), ghost_layers));
       },
       nb::arg("part"), nb::arg("ghost_mode") = dolfinx::mesh::GhostMode::none,
+      nb::arg("ghost_layers") = 1,
       "Create a cell partitioner from a graph partitioning function.");
+  m.def(
+      "create_precomputed_cell_partitioner",
+      [](dolfinx::mesh::GhostMode ghost_mode,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> owners)
+          -> PythonCellPartitionFunction
+      {
+        return create_cell_partitioner_py(
+            dolfinx::mesh::create_precomputed_cell_partitioner(
+                ghost_mode, std::vector<std::int32_t>(
+                                owners.data(), owners.data() + owners.size())));
+      },
+      nb::arg("ghost_mode"), nb::arg("owners"),
+      "Create a cell partitioner that sends cells to precomputed ranks.");
+  m.def(
+      "create_weighted_cell_partitioner",
+      [](std::function<nb::ndarray<const std::int32_t, nb::ndim<1>,
+                                   nb::c_contig>(
+             const std::vector<dolfinx::mesh::CellType>& cell_types,
+             const std::vector<nb::ndarray<const std::int64_t, nb::numpy>>&
+                 cells)>
+             weight_fn,
+         dolfinx::mesh::GhostMode ghost_mode) -> PythonCellPartitionFunction
+      {
+        auto weights
+            = [weight_fn](
+                  const std::vector<dolfinx::mesh::CellType>& cell_types,
+                  const std::vector<std::span<const std::int64_t>>& cells)
+        {
+          std::vector<nb::ndarray<const std::int64_t, nb::numpy>> cells_nb;
+          for (auto c : cells)
+          {
+            cells_nb.push_back(nb::ndarray<const std::int64_t, nb::numpy>(
+                c.data(), {c.size()}, nb::handle()));
+          }
+          auto w = weight_fn(cell_types, cells_nb);
+          return std::vector<std::int32_t>(w.data(), w.data() + w.size());
+        };
+        return create_cell_partitioner_py(
+            dolfinx::mesh::create_cell_partitioner(
+                ghost_mode, &dolfinx::graph::partition_graph_weighted,
+                weights));
+      },
+      nb::arg("weight_fn"),
+      nb::arg("ghost_mode") = dolfinx::mesh::GhostMode::none,
+      "Create a cell partitioner that balances the sum of cell weights.");
 
   m.def(
       "exterior_facet_indices",
@@ -130,6 +130,32 @@ void petsc_la_module(nb::module_& m)
 {
   import_petsc4py();
 
+  using dolfinx::la::petsc::KrylovSolver;
+  nb::class_<KrylovSolver>(m, "KrylovSolver")
+      .def(
+          "__init__", [](KrylovSolver* self, KSP ksp)
+          { new (self) KrylovSolver(ksp, true); }, nb::arg("ksp"),
+          "Wrap a PETSc KSP.")
+      .def("set_operator", &KrylovSolver::set_operator, nb::arg("A"))
+      .def("set_operators", &KrylovSolver::set_operators, nb::arg("A"),
+           nb::arg("P"))
+      .def("solve", &KrylovSolver::solve, nb::arg("x"), nb::arg("b"),
+           nb::arg("transpose") = false,
+           "Solve and return the number of iterations.")
+      .def("set_reuse_preconditioner", &KrylovSolver::set_reuse_preconditioner,
+           nb::arg("reuse"), nb::arg("max_solves") = 0,
+           nb::arg("iteration_growth") = 0.0,
+           "Set the preconditioner reuse policy.")
+      .def("rebuild_preconditioner", &KrylovSolver::rebuild_preconditioner,
+           "Rebuild the reused preconditioner at the next solve.")
+      .def_prop_ro("preconditioner_age", &KrylovSolver::preconditioner_age)
+      .def_prop_ro("ksp",
+                   [](const KrylovSolver& self)
+                   {
+                     PyObject* obj = PyPetscKSP_New(self.ksp());
+                     return nb::steal(obj);
+                   });
+
   m.def(
       "create_matrix",
       [](dolfinx_wrappers::MPICommWrapper comm,
@@ -258,6 +284,20 @@ void petsc_fem_module(nb::module_& m)
         nb::arg("types") = std::vector<std::vector<std::string>>(),
         "Create nested sparse matrix for bilinear forms.");
 
+  using Form_t = dolfinx::fem::Form<PetscScalar, PetscReal>;
+  using DirichletBC_t = dolfinx::fem::DirichletBC<PetscScalar, PetscReal>;
+  using COOAssembler = dolfinx::fem::petsc::MatrixCOOAssembler<PetscReal>;
+  nb::class_<COOAssembler>(m, "MatrixCOOAssembler")
+      .def(nb::init<std::shared_ptr<const Form_t>,
+                    const std::vector<std::shared_ptr<const DirichletBC_t>>&,
+                    PetscScalar>(),
+           nb::arg("a"), nb::arg("bcs"), nb::arg("diagonal") = 1.0,
+           "Record the COO entries of a bilinear form.")
+      .def("assemble", &COOAssembler::assemble, nb::arg("A"),
+           "Assemble the form into a matrix using MatSetValuesCOO.")
+      .def("reset", &COOAssembler::reset)
+      .def_prop_ro("num_entries", &COOAssembler::num_entries);
+
   // PETSc Matrices
   m.def(
       "assemble_matrix",
@@ -322,6 +362,25 @@ void petsc_fem_module(nb::module_& m)
       },
       nb::arg("A"), nb::arg("a"), nb::arg("constants"), nb::arg("coeffs"),
       nb::arg("rows0"), nb::arg("rows1"), nb::arg("unrolled") = false);
+  m.def(
+      "assemble_system",
+      [](Mat A, nb::ndarray<PetscScalar, nb::ndim<1>, nb::c_contig> b,
+         const dolfinx::fem::Form<PetscScalar, PetscReal>& a,
+         const dolfinx::fem::Form<PetscScalar, PetscReal>& L,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar, PetscReal>>>& bcs,
+         nb::ndarray<const PetscScalar, nb::ndim<1>, nb::c_contig> x0,
+         PetscScalar scale)
+      {
+        dolfinx::fem::assemble_system(
+            dolfinx::la::petsc::Matrix::set_block_fn(A, ADD_VALUES),
+            std::span(b.data(), b.size()), a, L, bcs,
+            std::span(x0.data(), x0.size()), scale);
+      },
+      nb::arg("A"), nb::arg("b"), nb::arg("a"), nb::arg("L"), nb::arg("bcs"),
+      nb::arg("x0"), nb::arg("scale"),
+      "Assemble bilinear and linear forms into an existing PETSc matrix "
+      "and vector in one pass");
   m.def(
       "insert_diagonal",
       [](Mat A, const dolfinx::fem::FunctionSpace<PetscReal>& V,
@@ -359,6 +418,8 @@ void petsc_nls_module(nb::module_& m)
            nb::arg("b"))
       .def("setJ", &dolfinx::nls::petsc::NewtonSolver::setJ, nb::arg("J"),
            nb::arg("Jmat"))
+      .def("setFJ", &dolfinx::nls::petsc::NewtonSolver::setFJ,
+           nb::arg("FJ"), nb::arg("b"), nb::arg("Jmat"))
       .def("setP", &dolfinx::nls::petsc::NewtonSolver::setP, nb::arg("P"),
            nb::arg("Pmat"))
       .def(
@@ -392,7 +453,33 @@ void petsc_nls_module(nb::module_& m)
       .def_rw("convergence_criterion",
               &dolfinx::nls::petsc::NewtonSolver::convergence_criterion,
               "Convergence criterion, either 'residual' (default) or "
-              "'incremental'");
+              "'incremental'")
+      .def_rw("jacobian_lag", &dolfinx::nls::petsc::NewtonSolver::jacobian_lag,
+              "Maximum number of iterations for which the Jacobian is reused")
+      .def_rw(
+          "jacobian_rebuild_contraction",
+          &dolfinx::nls::petsc::NewtonSolver::jacobian_rebuild_contraction,
+          "Residual contraction above which a reused Jacobian is recomputed")
+      .def_rw("preconditioner_lag",
+              &dolfinx::nls::petsc::NewtonSolver::preconditioner_lag,
+              "Number of Jacobians for which the preconditioner is reused")
+      .def_rw("eisenstat_walker",
+              &dolfinx::nls::petsc::NewtonSolver::eisenstat_walker,
+              "Use Eisenstat-Walker adaptive linear solver tolerances")
+      .def_rw("ew_rtol0", &dolfinx::nls::petsc::NewtonSolver::ew_rtol0,
+              "Eisenstat-Walker initial relative tolerance")
+      .def_rw("ew_rtol_max", &dolfinx::nls::petsc::NewtonSolver::ew_rtol_max,
+              "Eisenstat-Walker maximum relative tolerance")
+      .def_rw("ew_gamma", &dolfinx::nls::petsc::NewtonSolver::ew_gamma,
+              "Eisenstat-Walker gamma parameter")
+      .def_rw("ew_alpha", &dolfinx::nls::petsc::NewtonSolver::ew_alpha,
+              "Eisenstat-Walker alpha parameter")
+      .def_prop_ro("jacobian_evaluations",
+                   &dolfinx::nls::petsc::NewtonSolver::jacobian_evaluations,
+                   "Number of Jacobian computations in the last solve")
+      .def_prop_ro("krylov_iterations",
+                   &dolfinx::nls::petsc::NewtonSolver::krylov_iterations,
+                   "Number of Krylov iterations in the last solve");
 }
 
 } // namespace
@@ -5,12 +5,18 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "array.h"
+#include <complex>
 #include <concepts>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/Vector.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
+#include <dolfinx/refinement/coarsen.h>
 #include <dolfinx/refinement/interval.h>
 #include <dolfinx/refinement/plaza.h>
 #include <dolfinx/refinement/refine.h>
+#include <dolfinx/refinement/transfer.h>
 #include <dolfinx/refinement/utils.h>
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
@@ -18,19 +24,91 @@
 #include <nanobind/stl/tuple.h>
 #include <nanobind/stl/vector.h>
 #include <optional>
+#include <string>
 
 namespace nb = nanobind;
 
 namespace dolfinx_wrappers
 {
 
+template <typename T, std::floating_point U>
+void declare_transfer_apply(
+    nb::class_<dolfinx::refinement::Transfer<U>>& transfer)
+{
+  using Transfer = dolfinx::refinement::Transfer<U>;
+  transfer
+      .def(
+          "apply_prolongation",
+          [](const Transfer& self, const dolfinx::la::Vector<T>& x0,
+             dolfinx::la::Vector<T>& x1)
+          { self.template apply_prolongation<T>(x0, x1); },
+          nb::arg("x0"), nb::arg("x1"),
+          nb::call_guard<nb::gil_scoped_release>())
+      .def(
+          "apply_restriction",
+          [](const Transfer& self, const dolfinx::la::Vector<T>& x1,
+             dolfinx::la::Vector<T>& x0)
+          { self.template apply_restriction<T>(x1, x0); },
+          nb::arg("x1"), nb::arg("x0"),
+          nb::call_guard<nb::gil_scoped_release>());
+}
+
+template <std::floating_point T>
+void declare_transfer(nb::module_& m, const std::string& type)
+{
+  using Transfer = dolfinx::refinement::Transfer<T>;
+  std::string pyclass_name = "Transfer_" + type;
+  nb::class_<Transfer> transfer(m, pyclass_name.c_str(),
+                                "Refinement transfer operators");
+  transfer
+      .def(
+          "__init__",
+          [](Transfer* self,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>> V0,
+             std::shared_ptr<const dolfinx::fem::FunctionSpace<T>> V1,
+             nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig>
+                 parent_cell)
+          {
+            new (self) Transfer(
+                V0, V1, std::span(parent_cell.data(), parent_cell.size()));
+          },
+          nb::arg("V0"), nb::arg("V1"), nb::arg("parent_cell"),
+          nb::call_guard<nb::gil_scoped_release>())
+      .def(
+          "prolongation_matrix",
+          [](const Transfer& self)
+          {
+            dolfinx::la::MatrixCSR<T> A(self.create_sparsity_pattern());
+            auto [bs0, bs1] = A.block_size();
+            if (bs0 == 1 and bs1 == 1)
+              self.template assemble<T>(A.template mat_set_values<1, 1>());
+            else if (bs0 == 2 and bs1 == 2)
+              self.template assemble<T>(A.template mat_set_values<2, 2>());
+            else if (bs0 == 3 and bs1 == 3)
+              self.template assemble<T>(A.template mat_set_values<3, 3>());
+            else
+            {
+              throw std::runtime_error(
+                  "Prolongation matrix not supported for block size "
+                  + std::to_string(bs0));
+            }
+            return A;
+          },
+          nb::call_guard<nb::gil_scoped_release>())
+      .def_prop_ro("V0", &Transfer::V0)
+      .def_prop_ro("V1", &Transfer::V1);
+  declare_transfer_apply<T, T>(transfer);
+  declare_transfer_apply<std::complex<T>, T>(transfer);
+}
+
 template <std::floating_point T>
 void export_refinement_with_variable_mesh_type(nb::module_& m)
 {
   m.def("refine",
         nb::overload_cast<const dolfinx::mesh::Mesh<T>&, bool>(
             &dolfinx::refinement::refine<T>),
-        nb::arg("mesh"), nb::arg("redistribute") = true);
+        nb::arg("mesh"), nb::arg("redistribute") = true,
+        nb::call_guard<nb::gil_scoped_release>());
   m.def(
       "refine",
       [](const dolfinx::mesh::Mesh<T>& mesh,
@@ -40,15 +118,20 @@ void export_refinement_with_variable_mesh_type(nb::module_& m)
         return dolfinx::refinement::refine(
             mesh, std::span(edges.data(), edges.size()), redistribute);
       },
-      nb::arg("mesh"), nb::arg("edges"), nb::arg("redistribute") = true);
+      nb::arg("mesh"), nb::arg("edges"), nb::arg("redistribute") = true,
+      nb::call_guard<nb::gil_scoped_release>());
 
   m.def(
       "refine_interval",
       [](const dolfinx::mesh::Mesh<T>& mesh, bool redistribute,
          dolfinx::mesh::GhostMode ghost_mode)
       {
-        auto [mesh_refined, parent_cells] = dolfinx::refinement::refine_interval(
-            mesh, std::nullopt, redistribute, ghost_mode);
+        auto [mesh_refined, parent_cells] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::refine_interval(mesh, std::nullopt,
+                                                      redistribute, ghost_mode);
+        }();
         return std::tuple(std::move(mesh_refined),
                           as_nbarray(std::move(parent_cells)));
       },
@@ -60,10 +143,13 @@ void export_refinement_with_variable_mesh_type(nb::module_& m)
          nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells,
          bool redistribute, dolfinx::mesh::GhostMode ghost_mode)
       {
-        auto [mesh_refined, parent_cells]
-            = dolfinx::refinement::refine_interval(
-                mesh, std::make_optional(std::span(cells.data(), cells.size())),
-                redistribute, ghost_mode);
+        auto [mesh_refined, parent_cells] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::refine_interval(
+              mesh, std::make_optional(std::span(cells.data(), cells.size())),
+              redistribute, ghost_mode);
+        }();
         return std::tuple(std::move(mesh_refined),
                           as_nbarray(std::move(parent_cells)));
       },
@@ -73,35 +159,85 @@ void export_refinement_with_variable_mesh_type(nb::module_& m)
   m.def(
       "refine_plaza",
       [](const dolfinx::mesh::Mesh<T>& mesh0, bool redistribute,
-         dolfinx::refinement::plaza::Option option)
+         dolfinx::refinement::plaza::Option option, int num_threads)
       {
-        auto [mesh1, cell, facet]
-            = dolfinx::refinement::plaza::refine(mesh0, redistribute, option);
+        auto [mesh1, cell, facet] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::plaza::refine(mesh0, redistribute,
+                                                    option, num_threads);
+        }();
         return std::tuple{std::move(mesh1), as_nbarray(std::move(cell)),
                           as_nbarray(std::move(facet))};
       },
-      nb::arg("mesh"), nb::arg("redistribute"), nb::arg("option"));
+      nb::arg("mesh"), nb::arg("redistribute"), nb::arg("option"),
+      nb::arg("num_threads") = 1);
 
   m.def(
       "refine_plaza",
       [](const dolfinx::mesh::Mesh<T>& mesh0,
          nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> edges,
-         bool redistribute, dolfinx::refinement::plaza::Option option)
+         bool redistribute, dolfinx::refinement::plaza::Option option,
+         int num_threads)
       {
-        auto [mesh1, cell, facet] = dolfinx::refinement::plaza::refine(
-            mesh0, std::span<const std::int32_t>(edges.data(), edges.size()),
-            redistribute, option);
+        auto [mesh1, cell, facet] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::plaza::refine(
+              mesh0, std::span<const std::int32_t>(edges.data(), edges.size()),
+              redistribute, option, num_threads);
+        }();
         return std::tuple{std::move(mesh1), as_nbarray(std::move(cell)),
                           as_nbarray(std::move(facet))};
       },
       nb::arg("mesh"), nb::arg("edges"), nb::arg("redistribute"),
-      nb::arg("option"));
+      nb::arg("option"), nb::arg("num_threads") = 1);
+
+  m.def(
+      "coarsen",
+      [](const dolfinx::mesh::Mesh<T>& mesh0,
+         const dolfinx::mesh::Mesh<T>& mesh1,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> parent_cell,
+         nb::ndarray<const std::int32_t, nb::ndim<1>, nb::c_contig> cells,
+         bool redistribute, dolfinx::refinement::plaza::Option option)
+      {
+        auto [mesh2, cell, facet] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::coarsen(
+              mesh0, mesh1, std::span(parent_cell.data(), parent_cell.size()),
+              std::span(cells.data(), cells.size()), redistribute, option);
+        }();
+        return std::tuple{std::move(mesh2), as_nbarray(std::move(cell)),
+                          as_nbarray(std::move(facet))};
+      },
+      nb::arg("mesh0"), nb::arg("mesh1"), nb::arg("parent_cell"),
+      nb::arg("cells"), nb::arg("redistribute"), nb::arg("option"));
+
+  m.def(
+      "create_hierarchy",
+      [](const dolfinx::mesh::Mesh<T>& mesh, int levels, int num_threads)
+      {
+        auto [meshes, parent_cells] = [&]
+        {
+          nb::gil_scoped_release release;
+          return dolfinx::refinement::create_hierarchy(mesh, levels,
+                                                       num_threads);
+        }();
+        std::vector<nb::ndarray<std::int32_t, nb::numpy>> cells;
+        for (auto& c : parent_cells)
+          cells.push_back(as_nbarray(std::move(c)));
+        return std::tuple(std::move(meshes), std::move(cells));
+      },
+      nb::arg("mesh"), nb::arg("levels"), nb::arg("num_threads") = 1);
 }
 
 void refinement(nb::module_& m)
 {
   export_refinement_with_variable_mesh_type<float>(m);
   export_refinement_with_variable_mesh_type<double>(m);
+  declare_transfer<float>(m, "float32");
+  declare_transfer<double>(m, "float64");
 
   nb::enum_<dolfinx::refinement::plaza::Option>(m, "RefinementOption")
       .value("none", dolfinx::refinement::plaza::Option::none)
@@ -6,9 +6,13 @@
 #
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 
+import json
 from time import sleep
 
-from dolfinx import common
+from mpi4py import MPI
+
+from dolfinx import common, la
+from dolfinx.mesh import create_unit_square
 
 
 def test_context_manager_named():
@@ -32,3 +36,52 @@ def test_context_manager_anonymous():
     with common.Timer() as t:
         sleep(0.05)
         assert t.elapsed()[0] > 0.035
+
+
+def test_profile_trace(tempdir):
+    """Test that named Timers are recorded in the profile trace"""
+    common.enable_profile_trace(True)
+    with common.Timer("test_profile_trace_outer"):
+        with common.Timer("test_profile_trace_inner"):
+            pass
+    common.enable_profile_trace(False)
+
+    filename = f"{tempdir}/trace.json"
+    common.write_profile_trace(MPI.COMM_WORLD, filename)
+    if MPI.COMM_WORLD.rank == 0:
+        with open(filename) as f:
+            events = json.load(f)["traceEvents"]
+        names = [e["name"] for e in events]
+        assert "test_profile_trace_outer" in names
+        assert "test_profile_trace_inner" in names
+        for e in events:
+            assert e["ph"] == "X" and e["dur"] >= 0
+
+
+def test_comm_matrix(tempdir):
+    """Test that the communication of a ghost update is recorded"""
+    comm = MPI.COMM_WORLD
+    mesh = create_unit_square(comm, 8, 8)
+    x = la.vector(mesh.topology.index_map(0))
+    filename = f"{tempdir}/comm.csv"
+    common.enable_comm_profiling(True)
+    x.scatter_forward()
+    common.enable_comm_profiling(False)
+    common.write_comm_matrix(comm, filename)
+    if comm.rank == 0:
+        with open(filename) as f:
+            lines = f.read().splitlines()
+        assert lines[0] == "rank,dest,messages,bytes"
+        if comm.size > 1:
+            assert len(lines) > 1
+
+
+def test_num_threads():
+    """Test setting the default number of threads"""
+    n = common.num_threads()
+    assert n >= 1
+    common.set_num_threads(3)
+    assert common.num_threads() == 3
+    common.set_num_threads(0)
+    assert common.num_threads() == 1
+    common.set_num_threads(n)
@@ -22,6 +22,7 @@ from dolfinx.fem import (
     Constant,
     Function,
     assemble_scalar,
+    assemble_scalars,
     bcs_by_block,
     dirichletbc,
     extract_function_spaces,
@@ -80,6 +81,24 @@ def test_assemble_functional_ds(mode, dtype):
     assert value == pytest.approx(4.0, 1e-6)
 
 
+@dtype_parametrize
+def test_assemble_functionals(dtype):
+    xtype = dtype(0).real.dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 12, 12, dtype=xtype)
+    x = ufl.SpatialCoordinate(mesh)
+    M = [
+        form(1.0 * dx(domain=mesh), dtype=dtype),
+        form(x[0] * dx(domain=mesh), dtype=dtype),
+        form(x[0] * x[1] * dx(domain=mesh) + 1.0 * ds(domain=mesh), dtype=dtype),
+    ]
+    local = assemble_scalars(M)
+    for value, Mi in zip(local, M):
+        assert value == pytest.approx(assemble_scalar(Mi), rel=1e-5, abs=1e-8)
+
+    values = assemble_scalars(M, comm=mesh.comm)
+    assert values == pytest.approx([1.0, 0.5, 4.25], rel=1e-5)
+
+
 @dtype_parametrize
 def test_assemble_derivatives(dtype):
     """This test checks the original_coefficient_positions, which may change
@@ -203,6 +222,78 @@ class TestPETScAssemblers:
         assert np.sqrt(A0.squared_norm()) == pytest.approx(A1.norm(), rel=1.0e-8, abs=1.0e-5)
         A1.destroy()
 
+    @pytest.mark.parametrize("mode", [GhostMode.none, GhostMode.shared_facet])
+    def test_matrix_coo_assembler(self, mode):
+        from petsc4py import PETSc
+
+        from dolfinx.fem.petsc import MatrixCOOAssembler
+        from dolfinx.fem.petsc import assemble_matrix as petsc_assemble_matrix
+
+        mesh = create_unit_square(MPI.COMM_WORLD, 12, 12, ghost_mode=mode)
+        gdim = mesh.geometry.dim
+        for shape in [None, (gdim,)]:
+            V = functionspace(mesh, ("Lagrange", 1, shape) if shape else ("Lagrange", 1))
+            u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+            a = form(inner(u, v) * dx + inner(u, v) * ds)
+            bdofs = locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0))
+            bc = dirichletbc(np.zeros(shape, dtype=PETSc.ScalarType), bdofs, V)
+
+            A0 = petsc_assemble_matrix(a, bcs=[bc], diagonal=2.0)
+            A0.assemble()
+
+            assembler = MatrixCOOAssembler(a, [bc], diagonal=2.0)
+            A1 = assembler.assemble()
+            assert A1.norm() == pytest.approx(A0.norm(), rel=1.0e-8, abs=1.0e-5)
+
+            # Re-assembly into the same matrix replaces the values
+            assembler.assemble(A1)
+            A1.axpy(-1.0, A0)
+            assert A1.norm() == pytest.approx(0.0, abs=1.0e-8)
+            A0.destroy()
+            A1.destroy()
+
+    def test_krylov_solver_reuse_preconditioner(self):
+        from petsc4py import PETSc
+
+        from dolfinx.fem.petsc import assemble_matrix as petsc_assemble_matrix
+        from dolfinx.fem.petsc import create_vector as petsc_create_vector
+
+        mesh = create_unit_square(MPI.COMM_WORLD, 8, 8)
+        V = functionspace(mesh, ("Lagrange", 1))
+        u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+        a = form(inner(u, v) * dx)
+        L = form(inner(1.0, v) * dx)
+        A = petsc_assemble_matrix(a)
+        A.assemble()
+        b = petsc_create_vector(L)
+        b.set(1.0)
+        x = b.duplicate()
+
+        ksp = PETSc.KSP().create(mesh.comm)
+        ksp.setType("cg")
+        ksp.getPC().setType("jacobi")
+        solver = _cpp.la.petsc.KrylovSolver(ksp)
+        solver.set_operator(A)
+        solver.set_reuse_preconditioner(True, max_solves=2)
+
+        # The preconditioner is rebuilt every second solve, although the
+        # operator changes at each solve
+        ages = []
+        for i in range(5):
+            A.scale(2.0)
+            solver.solve(x, b)
+            ages.append(solver.preconditioner_age)
+        assert ages == [1, 2, 1, 2, 1]
+
+        solver.rebuild_preconditioner()
+        solver.solve(x, b)
+        assert solver.preconditioner_age == 1
+
+        A.destroy()
+        b.destroy()
+        x.destroy()
+        ksp.destroy()
+
     @pytest.mark.parametrize("mode", [GhostMode.none, GhostMode.shared_facet])
     def test_assembly_bcs(self, mode):
         from petsc4py import PETSc
@@ -1256,3 +1347,148 @@ def test_vector_types():
 
     assert np.linalg.norm(x0.array - x1.array) == pytest.approx(0.0)
     assert np.linalg.norm(x0.array - x2.array) == pytest.approx(0.0, abs=1e-7)
+
+
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_coefficient_cache(dtype):
+    """Test that cached coefficients are repacked when they change."""
+    from dolfinx.fem.assemble import create_coefficient_cache
+
+    xtype = dtype(0).real.dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 7, dtype=xtype)
+    V = functionspace(mesh, ("Lagrange", 2))
+    u, w = Function(V, dtype=dtype), Function(V, dtype=dtype)
+    u.interpolate(lambda x: x[0])
+    w.interpolate(lambda x: 1 + x[1])
+    v = ufl.TestFunction(V)
+    L = form(inner(u * w, v) * dx + inner(u, v) * ds, dtype=dtype)
+
+    cache = create_coefficient_cache(L, num_threads=2)
+    assert cache.update() == 0
+
+    def check():
+        b0 = fem.assemble_vector(L)
+        b1 = fem.assemble_vector(L, coeffs=cache.coefficients)
+        assert np.allclose(b0.array, b1.array)
+
+    check()
+    u.x.array[:] *= 3
+    assert cache.update(num_threads=3) == 1
+    check()
+    assert cache.update() == 0
+
+    coeffs = _cpp.fem.pack_coefficients(L._cpp_object, 2)
+    for key, c in coeffs.items():
+        assert np.allclose(c, cache.coefficients[key])
+
+
+def test_assemble_threads():
+    """Test assembly from several Python threads, with the GIL released
+    by the assemblers."""
+    from concurrent.futures import ThreadPoolExecutor
+
+    mesh = create_unit_square(MPI.COMM_WORLD, 16, 16)
+    V = functionspace(mesh, ("Lagrange", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = form(inner(u, v) * dx)
+    L = form(inner(1.0, v) * dx)
+
+    A0 = fem.assemble_matrix(a)
+    b0 = fem.assemble_vector(L)
+
+    def assemble(_):
+        return fem.assemble_matrix(a), fem.assemble_vector(L)
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = list(pool.map(assemble, range(8)))
+    for A, b in results:
+        assert np.allclose(A.data, A0.data)
+        assert np.allclose(b.array, b0.array)
+
+
+def test_assemble_out():
+    """Test packing and assembly into preallocated arrays."""
+    from dolfinx.fem.assemble import pack_coefficients
+
+    mesh = create_unit_square(MPI.COMM_WORLD, 5, 4)
+    V = functionspace(mesh, ("Lagrange", 2))
+    u = Function(V)
+    u.interpolate(lambda x: x[0] + x[1])
+    v = ufl.TestFunction(V)
+    L = form(inner(u, v) * dx + inner(u * u, v) * ds)
+
+    coeffs = pack_coefficients(L._cpp_object)
+    data = {key: c.ctypes.data for key, c in coeffs.items()}
+    u.x.array[:] *= 2
+    assert pack_coefficients(L._cpp_object, out=coeffs) is coeffs
+    for key, c in _cpp.fem.pack_coefficients(L._cpp_object).items():
+        assert coeffs[key].ctypes.data == data[key]
+        assert np.allclose(coeffs[key], c)
+
+    b = fem.create_vector(L)
+    b.array[:] = 1
+    assert fem.assemble_vector(b, L, coeffs=coeffs) is b
+    assert np.allclose(b.array, fem.assemble_vector(L).array)
+
+    x = np.empty_like(V.tabulate_dof_coordinates())
+    assert V.tabulate_dof_coordinates(out=x) is x
+    assert np.allclose(x, V.tabulate_dof_coordinates())
+    with pytest.raises(RuntimeError):
+        V.tabulate_dof_coordinates(out=np.empty((1, 3)))
+
+
+@pytest.mark.parametrize("dtype", [np.float32, np.float64, np.complex128])
+def test_assembly_plan(dtype):
+    """Test repeated matrix assembly with an assembly plan."""
+    from dolfinx.fem.assemble import AssemblyPlan
+
+    xtype = dtype(0).real.dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5, dtype=xtype)
+    V = functionspace(mesh, ("Lagrange", 2, (2,)))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = Function(V, dtype=dtype)
+    f.interpolate(lambda x: np.vstack((x[0], 1 + x[1])))
+    a = form(inner(f[0] * u, v) * dx + inner(u, v) * ds, dtype=dtype)
+    dofs = locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0))
+    bc = dirichletbc(np.zeros(2, dtype=dtype), dofs, V)
+
+    plan = AssemblyPlan(a, bcs=[bc])
+    A = fem.create_matrix(a)
+    for i in range(3):
+        f.x.array[:] *= 2
+        A.set_value(0)
+        assert plan.assemble(A, diagonal=3) is A
+        A0 = fem.assemble_matrix(a, bcs=[bc], diagonal=3)
+        assert np.allclose(A.data, A0.data, rtol=1e-5)
+
+    # Assembly into a different matrix records the entry positions again
+    A1 = fem.create_matrix(a)
+    plan.assemble(A1, diagonal=3)
+    assert np.allclose(A1.data, A.data, rtol=1e-5)
+
+
+@pytest.mark.parametrize("dtype", [np.float32, np.float64, np.complex128])
+@pytest.mark.parametrize("shape", [(), (2,)])
+def test_assemble_diagonal(dtype, shape):
+    """Test assembly of the diagonal of a bilinear form against the
+    diagonal of the assembled matrix."""
+    xtype = dtype(0).real.dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5, dtype=xtype)
+    V = functionspace(mesh, ("Lagrange", 2, shape))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = form(inner(ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds, dtype=dtype)
+    dofs = locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0))
+    bc = dirichletbc(np.zeros(shape, dtype=dtype), dofs, V)
+
+    A = fem.assemble_matrix(a, bcs=[bc], diagonal=2)
+    A.scatter_reverse()
+    size = V.dofmap.index_map.size_local * V.dofmap.index_map_bs
+    diag0 = A.to_scipy().diagonal()[:size]
+
+    d = fem.assemble_diagonal(a, bcs=[bc], diagonal=2)
+    assert np.allclose(d.array[:size], diag0, rtol=1e-5)
+
+    # Assembly into an existing vector, with threads
+    d.array[:] = 1
+    fem.assemble_diagonal(a, bcs=[bc], diagonal=2, d=d, num_threads=3)
+    assert np.allclose(d.array[:size], diag0, rtol=1e-5)
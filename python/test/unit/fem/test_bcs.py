@@ -24,10 +24,20 @@ from dolfinx.fem import (
     form,
     functionspace,
     locate_dofs_geometrical,
+    locate_dofs_tagged,
     locate_dofs_topological,
     set_bc,
 )
-from dolfinx.mesh import CellType, create_unit_cube, create_unit_square, exterior_facet_indices
+from dolfinx.mesh import (
+    CellType,
+    compute_incident_entities,
+    create_unit_cube,
+    create_unit_square,
+    exterior_facet_indices,
+    locate_entities,
+    locate_entities_boundary,
+    meshtags,
+)
 from ufl import dx, inner
 
 
@@ -67,6 +77,35 @@ def test_locate_dofs_geometrical():
         assert np.isclose(coords_V[dofs[0][1]], [0, 0, 0]).all()
 
 
+def test_locate_dofs_boundary_cells():
+    """Test that locating dofs geometrically in the boundary cells and
+    topologically for tag values gives the same dofs as the default
+    functions."""
+    mesh = create_unit_square(MPI.COMM_WORLD, 8, 8)
+    V = functionspace(mesh, ("Lagrange", 2))
+    tdim = mesh.topology.dim
+    mesh.topology.create_connectivity(tdim - 1, tdim)
+    mesh.topology.create_connectivity(0, tdim)
+
+    def left(x):
+        return np.isclose(x[0], 0.0)
+
+    # Cells that touch the left boundary
+    vertices = locate_entities(mesh, 0, left)
+    cells = compute_incident_entities(mesh.topology, vertices, 0, tdim)
+    dofs = locate_dofs_geometrical(V, left)
+    dofs_cells = locate_dofs_geometrical(V, left, cells)
+    assert np.array_equal(np.sort(dofs), np.sort(dofs_cells))
+
+    facets = exterior_facet_indices(mesh.topology)
+    left_facets = locate_entities_boundary(mesh, tdim - 1, left)
+    values = np.where(np.isin(facets, left_facets), 1, 2).astype(np.int32)
+    tags = meshtags(mesh, tdim - 1, facets, values)
+    dofs_tagged = locate_dofs_tagged(V, tags, [2, 1])
+    for v, d in zip([2, 1], dofs_tagged):
+        assert np.array_equal(d, locate_dofs_topological(V, tdim - 1, facets[values == v]))
+
+
 def test_overlapping_bcs():
     """Test that, when boundaries condition overlap, the last provided
     boundary condition is applied"""
@@ -360,3 +399,50 @@ def test_mixed_blocked_constant():
     with pytest.raises(RuntimeError):
         dofs1 = locate_dofs_topological(W.sub(1), tdim - 1, boundary_facets)
         dirichletbc(c1, dofs1, W.sub(1))
+
+
+@pytest.mark.parametrize("shape", [(), (2,)])
+def test_bc_interpolate(shape):
+    """Test setting boundary values by evaluation at the dof coordinates."""
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5)
+    V = functionspace(mesh, ("Lagrange", 2, shape))
+    bs = V.dofmap.index_map_bs
+    tdim = mesh.topology.dim
+    mesh.topology.create_connectivity(tdim - 1, tdim)
+    facets = exterior_facet_indices(mesh.topology)
+    dofs = locate_dofs_topological(V, tdim - 1, facets)
+
+    def f(t):
+        def g(x):
+            values = np.vstack([t * x[0] + x[1], t * x[1] - x[0]])
+            return values[:bs] if shape else values[0]
+
+        return g
+
+    # Reference, by interpolation into the whole boundary function
+    g = Function(V)
+    g.interpolate(f(0.5))
+    u0 = Function(V)
+    set_bc(u0.x.array, [dirichletbc(g, dofs)])
+
+    # Boundary values evaluated at the dofs of the boundary condition
+    bc = dirichletbc(Function(V), dofs)
+    assert bc.dof_coordinates.shape == (3, len(dofs))
+    for t in [1.0, 0.5]:
+        bc.interpolate(f(t))
+    u1 = Function(V)
+    set_bc(u1.x.array, [bc])
+    assert np.allclose(u1.x.array, u0.x.array)
+
+    bc.reset_values()
+    u1.x.array[:] = 1
+    set_bc(u1.x.array, [bc])
+    assert np.allclose(u1.x.array[bc._cpp_object.dof_indices()[0]], 0)
+
+    # Constant boundary value
+    c = Constant(mesh, np.zeros(shape, dtype=default_scalar_type))
+    bc = dirichletbc(c, dofs, V)
+    bc.interpolate(f(0.5))
+    u1.x.array[:] = 0
+    set_bc(u1.x.array, [bc])
+    assert np.allclose(u1.x.array, u0.x.array)
@@ -256,3 +256,32 @@ def test_interpolation_matrix(cell_type, p, q, from_lagrange):
 
     atol = 100 * np.finfo(default_real_type).resolution
     assert np.allclose(w_vec.x.array, w.x.array, atol=atol)
+
+
+@pytest.mark.parametrize("cell_type", [CellType.triangle, CellType.tetrahedron])
+def test_interpolation_matrix_threaded(cell_type):
+    """Test that the threaded interpolation matrix is the same as the serial matrix."""
+    from dolfinx.fem import interpolation_matrix
+
+    comm = MPI.COMM_WORLD
+    if cell_type == CellType.triangle:
+        mesh = create_unit_square(comm, 7, 5, cell_type=cell_type)
+    else:
+        mesh = create_unit_cube(comm, 3, 2, 2, cell_type=cell_type)
+    V = functionspace(mesh, ("Lagrange", 2, (mesh.geometry.dim,)))
+    W = functionspace(mesh, ("Nedelec 1st kind H(curl)", 2))
+    G0 = interpolation_matrix(V, W).to_scipy()
+    G1 = interpolation_matrix(V, W, num_threads=3).to_scipy()
+    assert np.allclose((G0 - G1).data, 0.0)
+
+
+def test_gradient_lowest_order_pattern():
+    """Test that the lowest-order discrete gradient has two entries per owned row."""
+    mesh = create_unit_cube(MPI.COMM_WORLD, 3, 4, 2, ghost_mode=GhostMode.shared_facet)
+    V = functionspace(mesh, ("Lagrange", 1))
+    W = functionspace(mesh, ("Nedelec 1st kind H(curl)", 1))
+    G = discrete_gradient(V, W)
+    nrlocal = G.index_map(0).size_local
+    assert np.all(np.diff(G.indptr[: nrlocal + 1]) == 2)
+    assert np.allclose(np.abs(G.data[: G.indptr[nrlocal]]), 1.0)
+    assert np.allclose(G.data[: G.indptr[nrlocal]].reshape(-1, 2).sum(axis=1), 0.0)
@@ -373,6 +373,28 @@ def test_expression_eval_cells_subset(dtype):
     assert np.allclose(u_.ravel(), cells)
 
 
+@pytest.mark.parametrize("tile_size,num_threads", [(1, 1), (5, 1), (5, 3), (1000, 2)])
+def test_expression_eval_tiled(tile_size, num_threads):
+    mesh = dolfinx.mesh.create_unit_cube(MPI.COMM_WORLD, 3, 2, 2)
+    V = functionspace(mesh, ("Lagrange", 2))
+    u = Function(V)
+    u.interpolate(lambda x: x[0] ** 2 + x[1] * x[2])
+    Q = functionspace(mesh, ("N1curl", 1))
+    v = ufl.TestFunction(Q)
+    points = basix.make_quadrature(basix.CellType.tetrahedron, 2)[0]
+    x = ufl.SpatialCoordinate(mesh)
+    cells_imap = mesh.topology.index_map(mesh.topology.dim)
+    cells = np.arange(cells_imap.size_local - 1, -1, -1, dtype=np.int32)
+
+    # Tiled and threaded evaluation gives the same values, also with an
+    # argument that needs dof transformations
+    for f in [ufl.grad(u), ufl.inner(u * x, v)]:
+        e = Expression(f, points.astype(mesh.geometry.x.dtype))
+        values = e.eval(mesh, cells)
+        values_tiled = e.eval(mesh, cells, tile_size=tile_size, num_threads=num_threads)
+        assert np.allclose(values_tiled, values)
+
+
 @pytest.mark.parametrize(
     "dtype",
     [
@@ -16,9 +16,14 @@ import pytest
 import ufl
 from basix.ufl import element, mixed_element
 from dolfinx import default_real_type, la
-from dolfinx.fem import Function, functionspace
+from dolfinx.fem import (
+    Function,
+    create_distributed_evaluation_plan,
+    create_evaluation_plan,
+    functionspace,
+)
 from dolfinx.geometry import bb_tree, compute_colliding_cells, compute_collisions_points
-from dolfinx.mesh import create_mesh, create_unit_cube
+from dolfinx.mesh import CellType, create_mesh, create_unit_cube
 
 
 @pytest.fixture
@@ -98,6 +103,65 @@ def test_eval(V, W, Q, mesh):
     assert np.allclose(u3.eval(x0, first_cell)[:3], u2.eval(x0, first_cell), rtol=1e-15, atol=1e-15)
 
 
+@pytest.mark.parametrize("cell_type", [CellType.tetrahedron, CellType.hexahedron])
+@pytest.mark.parametrize("family,degree,shape", [("Lagrange", 2, (3,)), ("N1curl", 1, None)])
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_eval_plan(cell_type, family, degree, shape, num_threads):
+    mesh = create_unit_cube(MPI.COMM_WORLD, 2, 3, 2, cell_type=cell_type)
+    V = functionspace(mesh, (family, degree) if shape is None else (family, degree, shape))
+    u = Function(V)
+
+    # Several points per cell, in random order, and a point that is not
+    # evaluated
+    rng = np.random.default_rng(7)
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    x = np.zeros((0, 3), dtype=default_real_type)
+    cells = np.zeros(0, dtype=np.int32)
+    for c in range(num_cells):
+        nodes = mesh.geometry.x[mesh.geometry.dofmap[c]]
+        w = rng.random((3, len(nodes)))
+        w /= w.sum(axis=1)[:, None]
+        x = np.vstack([x, w @ nodes])
+        cells = np.append(cells, np.full(3, c, dtype=np.int32))
+    perm = rng.permutation(len(cells))
+    x, cells = x[perm], cells[perm]
+    if len(cells) > 0:
+        cells[0] = -1
+
+    plan = create_evaluation_plan(V, x, cells)
+    assert plan.num_points == len(cells)
+    for t in range(2):
+        u.interpolate(lambda x: np.vstack([x[1] + t, x[0] * x[2], t * x[0] ** 2]))
+        values = u.eval_with(plan, num_threads)
+        located = cells >= 0
+        assert np.allclose(values[located], u.eval(x[located], cells[located]))
+        assert np.allclose(values[~located], 0)
+
+
+@pytest.mark.parametrize("num_threads", [1, 2])
+def test_eval_distributed_plan(num_threads):
+    mesh = create_unit_cube(MPI.COMM_WORLD, 3, 2, 2)
+    V = functionspace(mesh, ("Lagrange", 1, (2,)))
+    u = Function(V)
+
+    # Each process passes different points, and the last point is not
+    # in the mesh
+    rng = np.random.default_rng(mesh.comm.rank)
+    x = rng.random((5 + mesh.comm.rank, 3)).astype(default_real_type)
+    x = np.vstack([x, np.array([[2.0, 0.5, 0.5]], dtype=default_real_type)])
+    plan = create_distributed_evaluation_plan(V, x)
+    assert plan.num_points == len(x)
+    assert np.all(plan.owners[:-1] >= 0)
+    assert plan.owners[-1] == -1
+
+    for t in range(2):
+        u.interpolate(lambda x: np.vstack([x[0] + t * x[1], 2 * x[2]]))
+        values = u.eval_with(plan, num_threads)
+        assert np.allclose(values[:-1, 0], x[:-1, 0] + t * x[:-1, 1], atol=1e-5)
+        assert np.allclose(values[:-1, 1], 2 * x[:-1, 2], atol=1e-5)
+        assert np.allclose(values[-1], 0)
+
+
 @pytest.mark.skip_in_parallel
 def test_eval_manifold():
     # Simple two-triangle surface in 3d
@@ -161,6 +161,16 @@ def test_not_equal(W, V, W2, V2):
     assert W2 != V2
 
 
+def test_shared_dofmap(mesh):
+    V0 = functionspace(mesh, ("Lagrange", 1))
+    V1 = functionspace(mesh, ("Lagrange", 1))
+    V2 = functionspace(mesh, ("Lagrange", 2))
+    W = functionspace(mesh, ("Lagrange", 1, (mesh.geometry.dim,)))
+    assert V0.dofmap.index_map is V1.dofmap.index_map
+    assert V0.dofmap.index_map is not V2.dofmap.index_map
+    assert V0.dofmap.index_map is not W.dofmap.index_map
+
+
 def test_clone(W):
     assert W.clone() is not W
 
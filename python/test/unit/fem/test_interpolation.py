@@ -21,6 +21,8 @@ from dolfinx.fem import (
     Function,
     assemble_scalar,
     create_interpolation_data,
+    create_interpolation_plan,
+    create_interpolator,
     form,
     functionspace,
 )
@@ -948,6 +950,59 @@ def test_nonmatching_mesh_interpolation(xtype, cell_type0, cell_type1):
     assert np.isclose(assemble_scalar(form(residual, dtype=xtype)), 0)
 
 
+@pytest.mark.parametrize("xtype", [np.float64])
+@pytest.mark.parametrize("family,degree", [("Lagrange", 2), ("N1curl", 1)])
+def test_nonmatching_mesh_interpolation_plan(xtype, family, degree):
+    mesh0 = create_unit_square(MPI.COMM_WORLD, 5, 7, cell_type=CellType.triangle, dtype=xtype)
+    mesh1 = create_unit_square(MPI.COMM_WORLD, 4, 3, cell_type=CellType.quadrilateral, dtype=xtype)
+    V0 = functionspace(mesh0, (family, degree, (2,)) if family == "Lagrange" else (family, degree))
+    V1 = functionspace(mesh1, ("Lagrange", 1, (2,)))
+
+    cell_map1 = mesh1.topology.index_map(mesh1.topology.dim)
+    cells1 = np.arange(cell_map1.size_local + cell_map1.num_ghosts, dtype=np.int32)
+    interpolation_data = create_interpolation_data(V1, V0, cells1, padding=1e-14)
+    plan = create_interpolation_plan(V0, interpolation_data)
+
+    # Interpolating with the plan is the same as with the interpolation
+    # data, also after changing the function to interpolate from
+    u0 = Function(V0, dtype=xtype)
+    for a in range(3):
+        u0.interpolate(lambda x: (x[1] + a, a * x[0]))
+        u1 = Function(V1, dtype=xtype)
+        u1.interpolate_nonmatching(u0, cells1, interpolation_data)
+        u1_plan = Function(V1, dtype=xtype)
+        u1_plan.interpolate_nonmatching(u0, cells1, plan)
+        assert np.allclose(u1_plan.x.array, u1.x.array)
+
+
+@pytest.mark.parametrize(
+    "family,degree,shape",
+    [("Lagrange", 2, ()), ("Lagrange", 1, (3,)), ("N1curl", 2, None), ("RT", 1, None)],
+)
+@pytest.mark.parametrize("cell_type", [CellType.tetrahedron, CellType.hexahedron])
+def test_interpolator(family, degree, shape, cell_type):
+    mesh = create_unit_cube(MPI.COMM_WORLD, 2, 3, 2, cell_type=cell_type)
+    V = functionspace(mesh, (family, degree) if shape is None else (family, degree, shape))
+    tdim = mesh.topology.dim
+    cells = locate_entities(mesh, tdim, lambda x: x[0] < 0.6)
+    interpolator = create_interpolator(V, cells)
+    assert np.allclose(interpolator.cells, cells)
+
+    # Interpolating with the interpolator is the same as interpolating
+    # on the cells, also for changing data
+    for t in range(3):
+
+        def f(x):
+            values = np.vstack([x[1] + t * x[0], x[2] ** 2, t * x[0] * x[2]])
+            return values[0] if shape == () else values
+
+        u = Function(V)
+        u.interpolate(f, cells)
+        u_cached = Function(V)
+        u_cached.interpolate_with(f, interpolator)
+        assert np.allclose(u_cached.x.array, u.x.array)
+
+
 @pytest.mark.parametrize("xtype", [np.float64])
 def test_nonmatching_mesh_single_cell_overlap_interpolation(xtype):
     # mesh2 is contained by a single cell of mesh1. Here we test
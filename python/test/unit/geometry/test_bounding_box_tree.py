@@ -18,7 +18,10 @@ from dolfinx.geometry import (
     compute_collisions_points,
     compute_collisions_trees,
     compute_distance_gjk,
+    compute_entities_in_radius,
+    compute_nearest_entities,
     create_midpoint_tree,
+    squared_distance,
 )
 from dolfinx.mesh import (
     CellType,
@@ -355,6 +358,33 @@ def test_compute_closest_entity_3d(dim, dtype):
             assert np.isin(closest_entities[0], colliding_entity_bboxes.links(0))
 
 
+@pytest.mark.parametrize("dim", [0, 2, 3])
+@pytest.mark.parametrize("num_threads", [1, 3])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_nearest_entities_and_radius(dim, num_threads, dtype):
+    """Compare k-nearest and radius queries with a brute force search"""
+    mesh = create_unit_cube(MPI.COMM_WORLD, 4, 3, 5, dtype=dtype)
+    mesh.topology.create_entities(dim)
+    num_entities = mesh.topology.index_map(dim).size_local + mesh.topology.index_map(dim).num_ghosts
+    entities = np.arange(num_entities, dtype=np.int32)
+    tree = bb_tree(mesh, dim)
+
+    rng = np.random.default_rng(7)
+    points = rng.uniform(-0.2, 1.2, size=(10, 3)).astype(dtype)
+    k, radius = 4, 0.3
+    nearest = compute_nearest_entities(tree, mesh, points, k, num_threads)
+    in_radius = compute_entities_in_radius(tree, mesh, points, radius, num_threads)
+    tol = 1e3 * np.finfo(dtype).eps
+    for i, p in enumerate(points):
+        d2 = squared_distance(mesh, dim, entities, np.tile(p, (num_entities, 1)))
+        d2_sorted = np.sort(d2)
+        assert len(nearest.links(i)) == min(k, num_entities)
+        assert np.allclose(d2[nearest.links(i)], d2_sorted[:k], atol=tol)
+        assert np.all(np.diff(d2[in_radius.links(i)]) >= -tol)
+        assert np.all(d2[in_radius.links(i)] <= radius**2 + tol)
+        assert set(in_radius.links(i)) >= set(entities[d2 < radius**2 - tol])
+
+
 @pytest.mark.parametrize("dim", [1, 2, 3])
 @pytest.mark.parametrize("dtype", [np.float32, np.float64])
 def test_compute_closest_sub_entity(dim, dtype):
@@ -450,6 +480,27 @@ def test_serial_global_bb_tree(dtype, comm):
         assert len(tree_col.links(1)) > 0
 
 
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_global_bb_tree_num_boxes(dtype):
+    """Test that a global tree with more boxes per process finds a subset
+    of the processes, which includes the processes with collisions"""
+    mesh = create_unit_cube(MPI.COMM_WORLD, 5, 4, 3, dtype=dtype)
+    tree = bb_tree(mesh, mesh.topology.dim)
+    global_tree = tree.create_global_tree(mesh.comm)
+    global_tree4 = tree.create_global_tree(mesh.comm, num_boxes=4)
+    assert global_tree4.num_bboxes >= global_tree.num_bboxes
+
+    rng = np.random.default_rng(0)
+    x = rng.uniform(-0.1, 1.1, size=(50, 3)).astype(dtype)
+    col = compute_collisions_points(global_tree, x)
+    col4 = compute_collisions_points(global_tree4, x)
+    local_col = compute_collisions_points(tree, x)
+    for i in range(x.shape[0]):
+        assert set(col4.links(i)).issubset(col.links(i))
+        if len(local_col.links(i)) > 0:
+            assert mesh.comm.rank in col4.links(i)
+
+
 @pytest.mark.parametrize("ct", [CellType.hexahedron, CellType.tetrahedron])
 @pytest.mark.parametrize("N", [7, 13])
 @pytest.mark.parametrize("dtype", [np.float32, np.float64])
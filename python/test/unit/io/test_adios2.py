@@ -16,7 +16,14 @@ from basix.ufl import element
 from dolfinx import default_real_type, default_scalar_type
 from dolfinx.fem import Function, functionspace
 from dolfinx.graph import adjacencylist
-from dolfinx.mesh import CellType, create_mesh, create_unit_cube, create_unit_square
+from dolfinx.mesh import (
+    CellType,
+    GhostMode,
+    create_mesh,
+    create_unit_cube,
+    create_unit_square,
+    meshtags,
+)
 
 
 def generate_mesh(dim: int, simplex: bool, N: int = 5, dtype=None):
@@ -238,6 +245,102 @@ class TestVTX:
 
         f.close()
 
+    def test_vtx_asynchronous(self, tempdir):
+        """Test asynchronous output, modifying the data between writes."""
+        from dolfinx.io import VTXWriter
+
+        mesh = generate_mesh(2, True)
+        V = functionspace(mesh, ("Lagrange", 2))
+        u = Function(V)
+
+        filename = Path(tempdir, "v_async.bp")
+        with VTXWriter(mesh.comm, filename, [u]) as f:
+            f.asynchronous = True
+            if MPI.Query_thread() < MPI.THREAD_MULTIPLE:
+                assert not f.asynchronous
+            else:
+                assert f.asynchronous
+            for t in [0.1, 0.2, 0.3]:
+                u.interpolate(lambda x: t * x[0])
+                f.write(t)
+                u.x.array[:] = -1
+            f.asynchronous = False
+            assert not f.asynchronous
+            f.write(0.4)
+
+    @pytest.mark.parametrize("dtype", [np.float64, np.complex128])
+    def test_vtx_output_options(self, tempdir, dtype):
+        """Test single precision values and 32-bit connectivity."""
+        from dolfinx.io import VTXOutputOptions, VTXWriter
+
+        adios2 = pytest.importorskip("adios2")
+
+        mesh = generate_mesh(2, True)
+        V = functionspace(mesh, ("Lagrange", 2))
+        u = Function(V, dtype=dtype)
+        u.interpolate(lambda x: x[0] + x[1])
+        u.name = "u"
+
+        filename = Path(tempdir, "v_options.bp")
+        options = VTXOutputOptions()
+        options.float32_fields = True
+        options.int32_connectivity = True
+        with VTXWriter(mesh.comm, filename, u, "BP4") as f:
+            f.output_options = options
+            assert f.output_options.float32_fields
+            f.write(0.0)
+            f.write(1.0)
+
+        # backwards compatibility adios2 < 2.10.0
+        try:
+            adios_file = adios2.open(str(filename), "r", comm=mesh.comm, engine_type="BP4")
+        except AttributeError:
+            adios = adios2.Adios(comm=mesh.comm)
+            io = adios.declare_io("TestData")
+            io.set_engine("BP4")
+            adios_file = adios2.Stream(io, str(filename), "r", mesh.comm)
+
+        variables = adios_file.available_variables()
+        assert variables["connectivity"]["Type"] == "int32_t"
+        names = ["u"] if np.issubdtype(dtype, np.floating) else ["u_real", "u_imag"]
+        for name in names:
+            assert variables[name]["Type"] == "float"
+        adios_file.close()
+
+    def test_vtx_output_cells(self, tempdir):
+        """Test writing a subset of the cells and non-blocking steps."""
+        from dolfinx.io import VTXOutputOptions, VTXWriter
+
+        mesh = generate_mesh(2, False)
+        V = functionspace(mesh, ("Lagrange", 1))
+        u = Function(V)
+        u.name = "u"
+
+        num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+        options = VTXOutputOptions()
+        options.cells = np.arange(num_cells // 2, dtype=np.int32)
+        filename = Path(tempdir, "v_cells.bp")
+        with VTXWriter(mesh.comm, filename, u, "BP4", engine_parameters={}) as f:
+            f.output_options = options
+            f.nonblocking = True
+            assert f.nonblocking
+            for t in [0.1, 0.2]:
+                u.interpolate(lambda x: t * x[0])
+                f.write(t)
+            assert f.num_dropped_steps == 0
+
+        # Cell-wise constant function on the cells of a subdomain
+        cells = np.arange(num_cells // 2, dtype=np.int32)
+        ct = meshtags(mesh, mesh.topology.dim, cells, np.ones_like(cells))
+        options.cells = ct.find(1)
+        v = Function(functionspace(mesh, ("Discontinuous Lagrange", 0)))
+        v.name = "v"
+        with VTXWriter(mesh.comm, Path(tempdir, "v_cells_dg0.bp"), v, "BP4") as f:
+            f.output_options = options
+            for t in [0.1, 0.2]:
+                v.x.array[:] = t
+                f.write(t)
+
     def test_save_vtkx_cell_point(self, tempdir):
         """Test writing point-wise data."""
         from dolfinx.io import VTXWriter
@@ -332,3 +435,84 @@ class TestVTX:
             else:
                 assert int(var["AvailableStepsCount"]) == target_all
         adios_file.close()
+
+
+@pytest.mark.adios2
+@pytest.mark.parametrize("dtype", [np.float64, np.complex128])
+@pytest.mark.parametrize("ghost_mode", [GhostMode.none, GhostMode.shared_facet])
+def test_checkpoint(tempdir, dtype, ghost_mode):
+    """Test writing and reading back a mesh and functions."""
+    from dolfinx.io import read_checkpoint_function, read_checkpoint_mesh, write_checkpoint
+
+    xtype = np.real(dtype(0)).dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 6, 5, dtype=xtype)
+
+    def f(x):
+        return x[0] + 2 * x[1] ** 2
+
+    def g(x):
+        return (x[1], -x[0])
+
+    u = Function(functionspace(mesh, ("Lagrange", 2)), dtype=dtype, name="u")
+    u.interpolate(f)
+    v = Function(functionspace(mesh, ("DG", 1, (2,))), dtype=dtype, name="v")
+    v.interpolate(g)
+
+    filename = Path(tempdir, "checkpoint.bp")
+    write_checkpoint(mesh.comm, filename, mesh, [u, v])
+
+    mesh1 = read_checkpoint_mesh(mesh.comm, filename, ghost_mode, dtype=xtype)
+    tdim = mesh1.topology.dim
+    assert mesh1.topology.index_map(tdim).size_global == mesh.topology.index_map(tdim).size_global
+    assert mesh1.geometry.index_map().size_global == mesh.geometry.index_map().size_global
+
+    # Input global indices are restored with the node coordinates
+    def gather_nodes(msh):
+        n = msh.geometry.index_map().size_local
+        idx = np.concatenate(msh.comm.allgather(msh.geometry.input_global_indices[:n]))
+        x = np.concatenate(msh.comm.allgather(msh.geometry.x[:n]))
+        return idx[np.argsort(idx)], x[np.argsort(idx)]
+
+    idx0, x0 = gather_nodes(mesh)
+    idx1, x1 = gather_nodes(mesh1)
+    assert np.array_equal(idx0, idx1)
+    assert np.allclose(x0, x1)
+
+    for w, fn, space in [(u, f, ("Lagrange", 2)), (v, g, ("DG", 1, (2,)))]:
+        w1 = Function(functionspace(mesh1, space), dtype=dtype)
+        read_checkpoint_function(filename, w1, w.name)
+        w_ref = Function(w1.function_space, dtype=dtype)
+        w_ref.interpolate(fn)
+        assert np.allclose(w1.x.array, w_ref.x.array)
+
+
+@pytest.mark.adios2
+@pytest.mark.parametrize("dtype", [np.float64, np.complex128])
+def test_checkpoint_steps(tempdir, dtype):
+    """Test writing and reading back a sequence of checkpoints."""
+    from dolfinx.io import CheckpointReader, CheckpointWriter
+
+    xtype = np.real(dtype(0)).dtype
+    mesh = create_unit_square(MPI.COMM_WORLD, 5, 4, dtype=xtype)
+    u = Function(functionspace(mesh, ("Lagrange", 2)), dtype=dtype, name="u")
+
+    filename = Path(tempdir, "checkpoint_steps.bp")
+    times = [0.5, 1.0, 2.0]
+    with CheckpointWriter(mesh.comm, filename, "BP4") as f:
+        for t in times:
+            u.interpolate(lambda x: t * x[0] + x[1])
+            f.write(mesh, [u])
+        assert f.num_dropped_steps == 0
+
+    with CheckpointReader(mesh.comm, filename, "BP4") as f:
+        for t in times:
+            assert f.begin_step()
+            mesh1 = f.read_mesh(GhostMode.none, dtype=xtype)
+            u1 = Function(functionspace(mesh1, ("Lagrange", 2)), dtype=dtype)
+            f.read_function(u1, "u")
+            f.end_step()
+            u_ref = Function(u1.function_space, dtype=dtype)
+            u_ref.interpolate(lambda x: t * x[0] + x[1])
+            assert np.allclose(u1.x.array, u_ref.x.array)
+        assert not f.begin_step()
+        assert f.end_of_stream
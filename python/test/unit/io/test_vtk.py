@@ -48,6 +48,30 @@ def test_save_2d_mesh(tempdir, cell_type):
         vtk.write_mesh(mesh, 2.0)
 
 
+@pytest.mark.parametrize(
+    "encoding", [VTKFile.Encoding.ASCII, VTKFile.Encoding.Base64, VTKFile.Encoding.Raw]
+)
+def test_save_encoding(tempdir, encoding):
+    mesh = create_unit_square(MPI.COMM_WORLD, 8, 8)
+    V = functionspace(mesh, ("Lagrange", 2, (2,)))
+    u = Function(V)
+    u.interpolate(lambda x: np.vstack((x[0], x[1])))
+    filename = Path(tempdir, f"u_{encoding.name}.pvd")
+    with VTKFile(MPI.COMM_WORLD, filename, "w", encoding=encoding) as vtk:
+        vtk.write_mesh(mesh, 0.0)
+        vtk.write_function(u, 1.0)
+
+    vtu = Path(tempdir, f"u_{encoding.name}_p{MPI.COMM_WORLD.rank}_000000.vtu")
+    data = vtu.read_bytes()
+    if encoding == VTKFile.Encoding.Raw:
+        assert b'<AppendedData encoding="raw">_' in data
+        assert b'format="ascii"' not in data
+    elif encoding == VTKFile.Encoding.Base64:
+        assert b'format="binary"' in data
+    else:
+        assert b'format="ascii"' in data
+
+
 @pytest.mark.parametrize("cell_type", cell_types_3D)
 def test_save_3d_mesh(tempdir, cell_type):
     mesh = create_unit_cube(MPI.COMM_WORLD, 8, 8, 8, cell_type=cell_type)
@@ -50,10 +50,11 @@ def test_save_1d_scalar(tempdir, encoding, dtype, use_pathlib):
     u = Function(V, dtype=dtype)
     u.x.array[:] = 1.0 + (1j if np.issubdtype(dtype, np.complexfloating) else 0)
 
-    with pytest.raises(RuntimeError):
-        with XDMFFile(mesh.comm, filename2, "w", encoding=encoding) as file:
-            file.write_mesh(mesh)
-            file.write_function(u)
+    # Written on the dofs of V
+    with XDMFFile(mesh.comm, filename2, "w", encoding=encoding) as file:
+        file.write_mesh(mesh)
+        file.write_function(u)
+        file.write_function(u, 1.0)
 
     V1 = functionspace(mesh, ("Lagrange", 1))
     u1 = Function(V1, dtype=dtype)
@@ -88,13 +89,12 @@ def test_save_2d_scalar(tempdir, encoding, dtype, cell_type):
         file.write_mesh(mesh)
         file.write_function(u)
 
-    # Discontinuous (degree > 0) should raise exception
+    # Discontinuous (degree > 0), written on the dofs of V
     V = functionspace(mesh, ("Discontinuous Lagrange", 1))
     u = Function(V, dtype=dtype)
-    with pytest.raises(RuntimeError):
-        with XDMFFile(mesh.comm, filename, "w", encoding=encoding) as file:
-            file.write_mesh(mesh)
-            file.write_function(u)
+    with XDMFFile(mesh.comm, filename, "w", encoding=encoding) as file:
+        file.write_mesh(mesh)
+        file.write_function(u)
 
 
 @pytest.mark.parametrize("cell_type", celltypes_3D)
@@ -296,26 +296,24 @@ def test_higher_order_function(tempdir):
         file.write_mesh(msh)
         file.write_function(u)
 
-    # Write P2 Function (exception expected)
+    # Write P2 Function (on the dofs of the space)
     u = Function(functionspace(msh, ("Lagrange", 2, (gdim,))))
     filename = Path(tempdir, "u3D_P2.xdmf")
-    with pytest.raises(RuntimeError):
-        with XDMFFile(msh.comm, filename, "w") as file:
-            file.write_mesh(msh)
-            file.write_function(u)
+    with XDMFFile(msh.comm, filename, "w") as file:
+        file.write_mesh(msh)
+        file.write_function(u)
 
     # -- Degree 2 mesh (tet)
     msh = gmsh_tet_model(2)
     gdim = msh.geometry.dim
     assert msh.geometry.cmap.degree == 2
 
-    # Write P1 Function (exception expected)
+    # Write P1 Function (on the dofs of the space)
     u = Function(functionspace(msh, ("Lagrange", 1, (gdim,))))
-    with pytest.raises(RuntimeError):
-        filename = Path(tempdir, "u3D_P1.xdmf")
-        with XDMFFile(msh.comm, filename, "w") as file:
-            file.write_mesh(msh)
-            file.write_function(u)
+    filename = Path(tempdir, "u3D_P1.xdmf")
+    with XDMFFile(msh.comm, filename, "w") as file:
+        file.write_mesh(msh)
+        file.write_function(u)
 
     # Write P2 Function
     u = Function(functionspace(msh, ("Lagrange", 2, (gdim,))))
@@ -330,15 +328,14 @@ def test_higher_order_function(tempdir):
     gdim = msh.geometry.dim
     assert msh.geometry.cmap.degree == 3
 
-    # Write P2 Function (exception expected)
+    # Write P2 Function (on the dofs of the space)
     u = Function(functionspace(msh, ("Lagrange", 2, (gdim,))))
-    with pytest.raises(RuntimeError):
-        filename = Path(tempdir, "u3D_P3.xdmf")
-        with XDMFFile(msh.comm, filename, "w") as file:
-            file.write_mesh(msh)
-            file.write_function(u)
+    filename = Path(tempdir, "u3D_P3.xdmf")
+    with XDMFFile(msh.comm, filename, "w") as file:
+        file.write_mesh(msh)
+        file.write_function(u)
 
-    # Write P3 GLL Function (exception expected)
+    # Write P3 GLL Function (on the dofs of the space)
     ufl_e = basix.ufl.element(
         basix.ElementFamily.P,
         basix.CellType.tetrahedron,
@@ -347,11 +344,10 @@ def test_higher_order_function(tempdir):
         dtype=default_real_type,
     )
     u = Function(functionspace(msh, ufl_e))
-    with pytest.raises(RuntimeError):
-        filename = Path(tempdir, "u3D_P3.xdmf")
-        with XDMFFile(msh.comm, filename, "w") as file:
-            file.write_mesh(msh)
-            file.write_function(u)
+    filename = Path(tempdir, "u3D_P3.xdmf")
+    with XDMFFile(msh.comm, filename, "w") as file:
+        file.write_mesh(msh)
+        file.write_function(u)
 
     # Write P3 equispaced Function
     ufl_e = basix.ufl.element(
@@ -373,13 +369,12 @@ def test_higher_order_function(tempdir):
     gdim = msh.geometry.dim
     assert msh.geometry.cmap.degree == 2
 
-    # Write Q1 Function (exception expected)
+    # Write Q1 Function (on the dofs of the space)
     u = Function(functionspace(msh, ("Lagrange", 1, (gdim,))))
-    with pytest.raises(RuntimeError):
-        filename = Path(tempdir, "u3D_Q1.xdmf")
-        with XDMFFile(msh.comm, filename, "w") as file:
-            file.write_mesh(msh)
-            file.write_function(u)
+    filename = Path(tempdir, "u3D_Q1.xdmf")
+    with XDMFFile(msh.comm, filename, "w") as file:
+        file.write_mesh(msh)
+        file.write_function(u)
 
     # Write Q2 Function
     u = Function(functionspace(msh, ("Lagrange", 2, (gdim,))))
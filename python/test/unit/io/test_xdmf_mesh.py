@@ -14,6 +14,7 @@ import pytest
 from dolfinx import cpp as _cpp
 from dolfinx import default_real_type
 from dolfinx.io import XDMFFile
+from dolfinx.io.utils import Aggregator, HDF5DatasetOptions, HDF5FileOptions, HDF5Filter
 from dolfinx.io.gmshio import cell_perm_array, ufl_mesh
 from dolfinx.mesh import (
     CellType,
@@ -61,6 +62,107 @@ def test_save_and_load_1d_mesh(tempdir, encoding):
     )
 
 
+@pytest.mark.skipif(default_real_type != np.float64, reason="float32 not supported yet")
+@pytest.mark.parametrize("ghost_mode", [GhostMode.none, GhostMode.shared_facet])
+@pytest.mark.parametrize("encoding", encodings)
+def test_save_and_load_mesh_partition(tempdir, encoding, ghost_mode):
+    """Test that a mesh written with its partition is read back on the
+    same cells on each process."""
+    filename = Path(tempdir, "mesh_partition.xdmf")
+    mesh = create_unit_square(MPI.COMM_WORLD, 12, 9)
+    with XDMFFile(mesh.comm, filename, "w", encoding=encoding) as file:
+        file.write_mesh(mesh, partition=True)
+
+    with XDMFFile(MPI.COMM_WORLD, filename, "r", encoding=encoding) as file:
+        owners, num_parts = file.read_partition()
+        mesh2 = file.read_mesh(ghost_mode)
+
+    assert num_parts == MPI.COMM_WORLD.size
+    assert np.all((owners >= 0) & (owners < num_parts))
+
+    # Cells are written in the order of the cell index map, so the owned
+    # cells of the read mesh should be the owned cells of the written mesh
+    tdim = mesh.topology.dim
+    map0, map1 = mesh.topology.index_map(tdim), mesh2.topology.index_map(tdim)
+    assert map1.size_local == map0.size_local
+    cells = np.sort(mesh2.topology.original_cell_index[: map1.size_local])
+    assert np.array_equal(cells, np.arange(*map0.local_range))
+    if ghost_mode == GhostMode.shared_facet and MPI.COMM_WORLD.size > 1:
+        assert map1.num_ghosts > 0
+
+
+@pytest.mark.skipif(default_real_type != np.float64, reason="float32 not supported yet")
+@pytest.mark.parametrize("chunk_shape", [[], [64, 2]])
+def test_save_and_load_mesh_compressed(tempdir, chunk_shape):
+    filename = Path(tempdir, "mesh_compressed.xdmf")
+    mesh = create_unit_square(MPI.COMM_WORLD, 12, 9)
+    file_options = HDF5FileOptions()
+    file_options.alignment = [1024, 4096]
+    file_options.collective_metadata = True
+    options = HDF5DatasetOptions()
+    options.chunking = True
+    options.chunk_shape = chunk_shape
+    options.filter = HDF5Filter.deflate
+    options.filter_parameters = [6]
+    options.shuffle = True
+    with XDMFFile(mesh.comm, filename, "w", file_options=file_options) as file:
+        file.dataset_options = options
+        assert file.dataset_options.filter == HDF5Filter.deflate
+        file.write_mesh(mesh)
+
+    with XDMFFile(MPI.COMM_WORLD, filename, "r") as file:
+        mesh2 = file.read_mesh()
+
+    tdim = mesh.topology.dim
+    assert mesh.topology.index_map(0).size_global == mesh2.topology.index_map(0).size_global
+    assert (
+        mesh.topology.index_map(tdim).size_global == mesh2.topology.index_map(tdim).size_global
+    )
+
+
+
+@pytest.mark.parametrize("num_aggregators", [1, 2])
+def test_save_and_load_mesh_aggregated(tempdir, num_aggregators):
+    filename = Path(tempdir, "mesh_aggregated.xdmf")
+    mesh = create_unit_square(MPI.COMM_WORLD, 12, 9)
+    aggregator = Aggregator(mesh.comm, num_aggregators)
+    assert 1 <= aggregator.num_aggregators <= mesh.comm.size
+    options = HDF5DatasetOptions()
+    options.aggregator = aggregator
+    with XDMFFile(mesh.comm, filename, "w") as file:
+        file.dataset_options = options
+        file.write_mesh(mesh)
+
+    with XDMFFile(MPI.COMM_WORLD, filename, "r") as file:
+        mesh2 = file.read_mesh()
+
+    tdim = mesh.topology.dim
+    assert mesh.topology.index_map(0).size_global == mesh2.topology.index_map(0).size_global
+    assert (
+        mesh.topology.index_map(tdim).size_global == mesh2.topology.index_map(tdim).size_global
+    )
+
+
+@pytest.mark.parametrize("buffer_size", [1, 100, 4096])
+def test_read_mesh_buffered(tempdir, buffer_size):
+    filename = Path(tempdir, "mesh_buffered.xdmf")
+    mesh = create_unit_cube(MPI.COMM_WORLD, 4, 3, 5)
+    with XDMFFile(mesh.comm, filename, "w") as file:
+        file.write_mesh(mesh)
+
+    with XDMFFile(MPI.COMM_WORLD, filename, "r") as file:
+        cells_ref = file.read_topology_data("mesh", "/Xdmf/Domain")
+        x_ref = file.read_geometry_data("mesh", "/Xdmf/Domain")
+        file.read_buffer_size = buffer_size
+        assert file.read_buffer_size == buffer_size
+        cells = file.read_topology_data("mesh", "/Xdmf/Domain")
+        x = file.read_geometry_data("mesh", "/Xdmf/Domain")
+        mesh2 = file.read_mesh()
+
+    assert np.array_equal(cells, cells_ref)
+    assert np.array_equal(x, x_ref)
+    assert mesh.topology.index_map(3).size_global == mesh2.topology.index_map(3).size_global
+
 @pytest.mark.skipif(default_real_type != np.float64, reason="float32 not supported yet")
 @pytest.mark.parametrize("cell_type", celltypes_2D)
 @pytest.mark.parametrize("encoding", encodings)
@@ -716,3 +716,23 @@ def test_mesh_create_cmap(dtype):
     msh = _mesh.create_mesh(MPI.COMM_WORLD, cells, x, domain)
     assert msh.geometry.cmap.dim == 3
     assert msh.ufl_domain() is None
+
+
+def test_versions():
+    msh = create_unit_square(MPI.COMM_WORLD, 4, 4)
+    topology, geometry = msh.topology, msh.geometry
+
+    v = topology.version
+    topology.create_entities(1)
+    assert topology.version > v
+    v = topology.version
+    topology.create_entities(1)
+    assert topology.version == v
+    topology.mark_modified()
+    assert topology.version == v + 1
+
+    v = geometry.x_version
+    geometry.mark_modified()
+    assert geometry.x_version == v + 1
+    geometry.x[0, 0] += 0.0
+    assert geometry.x_version > v + 1
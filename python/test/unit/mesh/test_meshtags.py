@@ -10,7 +10,13 @@ import numpy as np
 import pytest
 
 from dolfinx.graph import adjacencylist
-from dolfinx.mesh import CellType, create_unit_cube, locate_entities, meshtags_from_entities
+from dolfinx.mesh import (
+    CellType,
+    create_unit_cube,
+    locate_entities,
+    meshtags,
+    meshtags_from_entities,
+)
 from ufl import Measure
 
 celltypes_3D = [CellType.tetrahedron, CellType.hexahedron]
@@ -48,3 +54,15 @@ def test_ufl_id():
     ds = Measure("ds", domain=msh, subdomain_data=ft, subdomain_id=(2, 3))
     a = 1 * ds
     assert isinstance(a.subdomain_data(), dict)
+
+
+def test_find():
+    msh = create_unit_cube(MPI.COMM_WORLD, 3, 3, 3)
+    tdim = msh.topology.dim
+    num_cells = msh.topology.index_map(tdim).size_local
+    cells = np.arange(num_cells, dtype=np.int32)
+    values = (cells % 3).astype(np.int32)
+    mt = meshtags(msh, tdim, cells, values)
+    for value in range(3):
+        assert np.array_equal(mt.find(value), cells[values == value])
+    assert mt.find(4).size == 0
@@ -11,13 +11,25 @@ import pytest
 from numpy import isclose
 
 import ufl
-from dolfinx.fem import assemble_matrix, form, functionspace
+from dolfinx import default_scalar_type
+from dolfinx.fem import (
+    Constant,
+    Function,
+    RefinementTransfer,
+    assemble_matrix,
+    assemble_scalar,
+    form,
+    functionspace,
+)
 from dolfinx.mesh import (
     CellType,
     DiagonalType,
     GhostMode,
     RefinementOption,
+    coarsen,
     compute_incident_entities,
+    compute_midpoints,
+    create_hierarchy,
     create_unit_cube,
     create_unit_square,
     locate_entities,
@@ -229,3 +241,101 @@ def test_refine_cell_meshtag(tdim, refine_plaza_wrapper):
     new_meshtag = transfer_meshtag(meshtag, fine_mesh, parent_cell)
     assert sum(new_meshtag.values) == (tdim * 4 - 4) * sum(meshtag.values)
     assert len(new_meshtag.indices) == (tdim * 4 - 4) * len(meshtag.indices)
+
+
+@pytest.mark.parametrize("tdim", [2, 3])
+@pytest.mark.parametrize("degree", [1, 2])
+def test_refinement_transfer(tdim, degree):
+    if tdim == 3:
+        mesh = create_unit_cube(MPI.COMM_WORLD, 2, 3, 2, CellType.tetrahedron)
+    else:
+        mesh = create_unit_square(MPI.COMM_WORLD, 3, 5, CellType.triangle)
+    mesh.topology.create_entities(1)
+    fine_mesh, parent_cell, _ = refine_plaza(mesh, None, False, RefinementOption.parent_cell)
+
+    V0 = functionspace(mesh, ("Lagrange", degree, (2,)))
+    V1 = functionspace(fine_mesh, ("Lagrange", degree, (2,)))
+    transfer = RefinementTransfer(V0, V1, parent_cell)
+
+    def f(x):
+        return np.vstack((x[0] ** degree + 2 * x[1], x[1] - x[tdim - 1] ** degree))
+
+    u0, u1, u1_ref = Function(V0), Function(V1), Function(V1)
+    u0.interpolate(f)
+    u1_ref.interpolate(f)
+
+    # Matrix-free prolongation reproduces the fine interpolant
+    transfer.prolong(u0.x, u1.x)
+    assert np.allclose(u1.x.array, u1_ref.x.array)
+
+    # Assembled prolongation matches the matrix-free operator
+    n1 = V1.dofmap.index_map.size_local * V1.dofmap.index_map_bs
+    n0 = V0.dofmap.index_map.size_local * V0.dofmap.index_map_bs
+    Pd = transfer.prolongation_matrix().to_dense()
+    assert np.allclose((Pd @ u0.x.array)[:n1], u1_ref.x.array[:n1])
+
+    # Restriction is the transpose of prolongation
+    if MPI.COMM_WORLD.size == 1:
+        u1.x.array[:] = np.random.default_rng(0).random(u1.x.array.size)
+        transfer.restrict(u1.x, u0.x)
+        assert np.allclose(u0.x.array[:n0], Pd.T @ u1.x.array[:n1])
+
+
+def test_create_hierarchy():
+    mesh = create_unit_square(MPI.COMM_WORLD, 3, 4, ghost_mode=GhostMode.none)
+    mesh.topology.create_entities(1)
+    meshes, parent_cells = create_hierarchy(mesh, 3)
+    assert len(meshes) == 4
+    assert len(parent_cells) == 3
+    for i, (msh, cells) in enumerate(zip(meshes[1:], parent_cells)):
+        num_cells = msh.topology.index_map(2).size_global
+        assert num_cells == 4 ** (i + 1) * mesh.topology.index_map(2).size_global
+        assert len(cells) == msh.topology.index_map(2).size_local
+
+    # Prolongation through the hierarchy is exact for linears
+    V = [functionspace(msh, ("Lagrange", 1)) for msh in meshes]
+    u = Function(V[0])
+    u.interpolate(lambda x: 1 + x[0] - 2 * x[1])
+    for V0, V1, cells in zip(V[:-1], V[1:], parent_cells):
+        u1 = Function(V1)
+        RefinementTransfer(V0, V1, cells).prolong(u.x, u1.x)
+        u = u1
+    u_ref = Function(V[-1])
+    u_ref.interpolate(lambda x: 1 + x[0] - 2 * x[1])
+    assert np.allclose(u.x.array, u_ref.x.array)
+
+
+@pytest.mark.parametrize("tdim", [2, 3])
+def test_coarsen(tdim):
+    if tdim == 3:
+        mesh = create_unit_cube(MPI.COMM_WORLD, 3, 2, 2, ghost_mode=GhostMode.none)
+    else:
+        mesh = create_unit_square(MPI.COMM_WORLD, 4, 3, ghost_mode=GhostMode.none)
+    mesh.topology.create_entities(1)
+    fine_mesh, parent_cell, _ = refine_plaza(mesh, None, False, RefinementOption.parent_cell)
+    num_cells0 = mesh.topology.index_map(tdim).size_global
+    num_cells1 = fine_mesh.topology.index_map(tdim).size_global
+
+    # Coarsening all cells recovers the parent mesh
+    all_cells = np.arange(fine_mesh.topology.index_map(tdim).size_local, dtype=np.int32)
+    mesh2, parent2, _ = coarsen(
+        mesh, fine_mesh, parent_cell, all_cells, False, RefinementOption.parent_cell
+    )
+    assert mesh2.topology.index_map(tdim).size_global == num_cells0
+    assert len(parent2) == mesh2.topology.index_map(tdim).size_local
+
+    # Coarsening no cells keeps the refined mesh
+    mesh2, _, _ = coarsen(mesh, fine_mesh, parent_cell, np.zeros(0, dtype=np.int32), False)
+    assert mesh2.topology.index_map(tdim).size_global == num_cells1
+
+    # Coarsening the children of some parents gives a conforming mesh in between
+    midpoints = compute_midpoints(fine_mesh, tdim, all_cells)
+    cells = all_cells[midpoints[:, 0] < 0.5]
+    mesh2, _, _ = coarsen(mesh, fine_mesh, parent_cell, cells, False)
+    num_cells2 = mesh2.topology.index_map(tdim).size_global
+    assert num_cells0 < num_cells2 < num_cells1
+
+    # Hanging nodes would create exterior facets in the interior
+    one = Constant(mesh2, default_scalar_type(1))
+    area = mesh2.comm.allreduce(assemble_scalar(form(one * ufl.ds)), op=MPI.SUM)
+    assert np.isclose(area, 2 * tdim)
@@ -54,6 +54,20 @@ class NonlinearPDEProblem:
         assemble_matrix(A, self.a, bcs=[self.bc])
         A.assemble()
 
+    def FJ(self, x, b, A):
+        """Assemble residual vector and Jacobian matrix in one pass."""
+        from petsc4py import PETSc
+
+        from dolfinx.fem.petsc import assemble_system, set_bc
+
+        with b.localForm() as b_local:
+            b_local.set(0.0)
+        A.zeroEntries()
+        assemble_system(A, b, self.a, self.L, bcs=[self.bc], x0=x, scale=-1.0)
+        A.assemble()
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        set_bc(b, [self.bc], x, -1.0)
+
     def matrix(self):
         from dolfinx.fem.petsc import create_matrix
 
@@ -187,6 +201,112 @@ class TestNLS:
         assert converged
         assert n > 0 and n < 6
 
+    @pytest.mark.parametrize("eisenstat_walker", [False, True])
+    def test_nonlinear_pde_jacobian_reuse(self, eisenstat_walker):
+        """Test Newton solver with Jacobian and preconditioner reuse"""
+        from petsc4py import PETSc
+
+        mesh = create_unit_square(MPI.COMM_WORLD, 12, 5)
+        V = functionspace(mesh, ("Lagrange", 1))
+        u = Function(V)
+        v = TestFunction(V)
+        F = inner(5.0, v) * dx - ufl.sqrt(u * u) * inner(grad(u), grad(v)) * dx - inner(u, v) * dx
+
+        bc = dirichletbc(
+            PETSc.ScalarType(1.0),
+            locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0) | np.isclose(x[0], 1.0)),
+            V,
+        )
+        problem = NonlinearPDEProblem(F, u, bc)
+
+        def solve(jacobian_lag, preconditioner_lag):
+            u.x.array[:] = 0.9
+            solver = _cpp.nls.petsc.NewtonSolver(MPI.COMM_WORLD)
+            solver.setF(problem.F, problem.vector())
+            solver.setJ(problem.J, problem.matrix())
+            solver.set_form(problem.form)
+            solver.atol = 1.0e-8
+            solver.rtol = 1.0e-8
+            solver.jacobian_lag = jacobian_lag
+            solver.jacobian_rebuild_contraction = 0.5
+            solver.preconditioner_lag = preconditioner_lag
+            solver.eisenstat_walker = eisenstat_walker
+            ksp = solver.krylov_solver
+            ksp.setType("gmres")
+            ksp.getPC().setType("jacobi")
+            ksp.setTolerances(rtol=1.0e-10)
+            n, converged = solver.solve(u.x.petsc_vec)
+            assert converged
+            assert ksp.getTolerances()[0] == pytest.approx(1.0e-10)
+            return n, solver.jacobian_evaluations, u.x.array.copy()
+
+        n0, nj0, u0 = solve(1, 1)
+        assert nj0 == n0
+        n1, nj1, u1 = solve(3, 2)
+        assert nj1 < n1
+        assert np.allclose(u0, u1, atol=1.0e-6)
+
+    @pytest.mark.parametrize("separate", [False, True])
+    def test_nonlinear_pde_fused(self, separate):
+        """Test Newton solver with fused residual and Jacobian assembly"""
+        from petsc4py import PETSc
+
+        mesh = create_unit_square(MPI.COMM_WORLD, 12, 5)
+        V = functionspace(mesh, ("Lagrange", 1))
+        u = Function(V)
+        v = TestFunction(V)
+        F = inner(5.0, v) * dx - ufl.sqrt(u * u) * inner(grad(u), grad(v)) * dx - inner(u, v) * dx
+
+        bc = dirichletbc(
+            PETSc.ScalarType(1.0),
+            locate_dofs_geometrical(V, lambda x: np.isclose(x[0], 0.0) | np.isclose(x[0], 1.0)),
+            V,
+        )
+        problem = NonlinearPDEProblem(F, u, bc)
+        b, A = problem.vector(), problem.matrix()
+
+        def solve(fused, jacobian_lag=1):
+            calls = {"F": 0, "J": 0, "FJ": 0}
+
+            def count(name, fn):
+                def f(*args):
+                    calls[name] += 1
+                    fn(*args)
+
+                return f
+
+            u.x.array[:] = 0.9
+            solver = _cpp.nls.petsc.NewtonSolver(MPI.COMM_WORLD)
+            if separate or not fused:
+                solver.setF(count("F", problem.F), b)
+                solver.setJ(count("J", problem.J), A)
+            if fused:
+                solver.setFJ(count("FJ", problem.FJ), b, A)
+            solver.set_form(problem.form)
+            solver.atol = 1.0e-8
+            solver.rtol = 1.0e2 * np.finfo(default_real_type).eps
+            solver.jacobian_lag = jacobian_lag
+            n, converged = solver.solve(u.x.petsc_vec)
+            assert converged
+            return n, calls, u.x.array.copy()
+
+        n0, calls0, u0 = solve(False)
+        assert calls0 == {"F": n0 + 1, "J": n0, "FJ": 0}
+        n1, calls1, u1 = solve(True)
+        assert n1 == n0
+        assert calls1 == {"F": 0, "J": 0, "FJ": n0 + 1}
+        assert np.allclose(u0, u1)
+
+        # With Jacobian reuse, only the residual is assembled when the
+        # Jacobian is not required
+        n2, calls2, u2 = solve(True, 3)
+        if separate:
+            assert calls2["FJ"] < n2 + 1
+            assert calls2["F"] == n2 + 1 - calls2["FJ"]
+        else:
+            assert calls2["FJ"] >= n2 + 1
+        assert np.allclose(u0, u2, atol=1.0e-6)
+
     def test_nonlinear_pde_snes(self):
         """Test Newton solver for a simple nonlinear PDE"""
         from petsc4py import PETSc